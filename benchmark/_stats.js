@@ -0,0 +1,126 @@
+'use strict';
+
+// Statistics used by compare-stats.js to analyse the output of compare.js,
+// mirroring the Welch t-test that compare.R performs with R.
+
+function mean(values) {
+  let sum = 0;
+  for (const value of values)
+    sum += value;
+  return sum / values.length;
+}
+
+// Unbiased sample variance.
+function variance(values) {
+  const mu = mean(values);
+  let sum = 0;
+  for (const value of values)
+    sum += (value - mu) ** 2;
+  return sum / (values.length - 1);
+}
+
+// Lanczos approximation of log(gamma(x)) for x > 0.
+const lanczos = [
+  76.18009172947146, -86.50532032941677, 24.01409824083091,
+  -1.231739572450155, 0.1208650973866179e-2, -0.5395239384953e-5,
+];
+function logGamma(x) {
+  let y = x;
+  const tmp = x + 5.5 - (x + 0.5) * Math.log(x + 5.5);
+  let series = 1.000000000190015;
+  for (const coefficient of lanczos)
+    series += coefficient / ++y;
+  return -tmp + Math.log(2.5066282746310005 * series / x);
+}
+
+// Continued fraction for the incomplete beta function, evaluated with the
+// modified Lentz method.
+function betaContinuedFraction(x, a, b) {
+  const kTiny = 1e-300;
+  let c = 1;
+  let d = 1 - (a + b) * x / (a + 1);
+  if (Math.abs(d) < kTiny) d = kTiny;
+  d = 1 / d;
+  let h = d;
+  for (let m = 1; m <= 300; m++) {
+    const m2 = 2 * m;
+    let aa = m * (b - m) * x / ((a + m2 - 1) * (a + m2));
+    d = 1 + aa * d;
+    if (Math.abs(d) < kTiny) d = kTiny;
+    c = 1 + aa / c;
+    if (Math.abs(c) < kTiny) c = kTiny;
+    d = 1 / d;
+    h *= d * c;
+    aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1));
+    d = 1 + aa * d;
+    if (Math.abs(d) < kTiny) d = kTiny;
+    c = 1 + aa / c;
+    if (Math.abs(c) < kTiny) c = kTiny;
+    d = 1 / d;
+    const delta = d * c;
+    h *= delta;
+    if (Math.abs(delta - 1) < 1e-15)
+      break;
+  }
+  return h;
+}
+
+// Regularized incomplete beta function I_x(a, b).
+function incompleteBeta(x, a, b) {
+  if (x <= 0) return 0;
+  if (x >= 1) return 1;
+  const front = Math.exp(logGamma(a + b) - logGamma(a) - logGamma(b) +
+                         a * Math.log(x) + b * Math.log(1 - x));
+  if (x < (a + 1) / (a + b + 2))
+    return front * betaContinuedFraction(x, a, b) / a;
+  return 1 - front * betaContinuedFraction(1 - x, b, a) / b;
+}
+
+// Cumulative distribution function of Student's t distribution.
+function studentTCdf(t, df) {
+  const tail = incompleteBeta(df / (df + t * t), df / 2, 0.5) / 2;
+  return t > 0 ? 1 - tail : tail;
+}
+
+// Inverse of studentTCdf(), found by bisection. This is only used for a few
+// quantiles per comparison, so there is no need for anything faster.
+function studentTQuantile(p, df) {
+  if (p === 0.5) return 0;
+  if (p < 0.5) return -studentTQuantile(1 - p, df);
+  let low = 0;
+  let high = 1;
+  while (studentTCdf(high, df) < p)
+    high *= 2;
+  for (let i = 0; i < 200 && high - low > 1e-12 * high; i++) {
+    const middle = (low + high) / 2;
+    if (studentTCdf(middle, df) < p)
+      low = middle;
+    else
+      high = middle;
+  }
+  return (low + high) / 2;
+}
+
+// Welch's unequal variances t-test, as performed by R's t.test(). Returns the
+// shared standard error, the degrees of freedom and the two-sided p-value.
+function welchTTest(a, b) {
+  const aSeSquared = variance(a) / a.length;
+  const bSeSquared = variance(b) / b.length;
+  const se = Math.sqrt(aSeSquared + bSeSquared);
+  const df = (aSeSquared + bSeSquared) ** 2 /
+             (aSeSquared ** 2 / (a.length - 1) +
+              bSeSquared ** 2 / (b.length - 1));
+  const t = (mean(a) - mean(b)) / se;
+  const p = se === 0 ? (t === 0 || Number.isNaN(t) ? 1 : 0) :
+    2 * studentTCdf(-Math.abs(t), df);
+  return { t, df, p, se };
+}
+
+module.exports = {
+  mean,
+  variance,
+  incompleteBeta,
+  studentTCdf,
+  studentTQuantile,
+  welchTTest,
+};
@@ -9,12 +9,15 @@ const bench = common.createBenchmark(main, {
     'fill(400)',
     'fill("t")',
     'fill("test")',
+    'fill("abc")',
+    'fill("abcdefgh")',
     'fill("t", "utf8")',
     'fill("t", 0, "utf8")',
     'fill("t", 0)',
     'fill(Buffer.alloc(1), 0)',
+    'fill(Buffer.alloc(16, 1), 0)',
   ],
-  size: [2 ** 13, 2 ** 16],
+  size: [2 ** 13, 2 ** 16, 2 ** 20],
   n: [2e4]
 });
 
@@ -5,7 +5,7 @@ const common = require('../common.js');
 const bench = common.createBenchmark(main, {
   aligned: ['true', 'false'],
   method: ['swap16', 'swap32', 'swap64'/* , 'htons', 'htonl', 'htonll' */],
-  len: [64, 256, 768, 1024, 2056, 8192],
+  len: [64, 256, 768, 1024, 2056, 8192, 65536],
   n: [1e6]
 });
 
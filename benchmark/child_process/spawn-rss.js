@@ -0,0 +1,34 @@
+'use strict';
+const common = require('../common.js');
+const bench = common.createBenchmark(main, {
+  rss: [0, 256, 1024],
+  n: [100]
+});
+
+const spawn = require('child_process').spawn;
+
+// Keeps the buffers alive so that the parent process stays large while the
+// children are spawned.
+const retained = [];
+
+function main({ n, rss }) {
+  // Touch every page, so that it is really part of the resident set.
+  for (let i = 0; i < rss; i++)
+    retained.push(Buffer.alloc(1024 * 1024, 1));
+
+  bench.start();
+  go(n, n);
+}
+
+function go(n, left) {
+  if (left-- === 0)
+    return bench.end(n);
+
+  const child = spawn('echo', ['hello']);
+  child.on('exit', (code) => {
+    if (code)
+      process.exit(code);
+    else
+      go(n, left);
+  });
+}
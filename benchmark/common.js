@@ -5,6 +5,17 @@ const http_benchmarkers = require('./_http-benchmarkers.js');
 
 exports.buildType = process.features.debug ? 'Debug' : 'Release';
 
+// The number of runs of a configuration that are reported by a single process,
+// and the number of runs before those that are discarded to warm up the JIT
+// and caches.
+const kRuns = Math.max(1, parseInt(process.env.NODE_BENCHMARK_RUNS, 10) || 1);
+const kWarmup =
+  Math.max(0, parseInt(process.env.NODE_BENCHMARK_WARMUP, 10) || 0);
+// Whether to report the hardware counters per operation along with the rate.
+const kCounters = !!process.env.NODE_BENCHMARK_COUNTERS;
+const kCounterNames = ['instructions', 'cacheMisses', 'branchMisses'];
+exports.counterNames = kCounterNames;
+
 exports.createBenchmark = function(fn, configs, options) {
   return new Benchmark(fn, configs, options);
 };
@@ -29,11 +40,23 @@ function Benchmark(fn, configs, options) {
     const flags = process.env.NODE_BENCHMARK_FLAGS.split(/\s+/);
     this.flags = this.flags.concat(flags);
   }
+  // The counters are read through an internal binding.
+  if (kCounters) {
+    this.flags.push('--expose-internals');
+  }
   // Holds process.hrtime value
   this._time = [0, 0];
   // Used to make sure a benchmark only start a timer once
   this._started = false;
   this._ended = false;
+  // Number of runs of the configuration in this process so far
+  this._runs = 0;
+  this._fn = fn;
+  // Counter group and the values read by start() and end(). This stays
+  // undefined until the counters are opened, and is null if that failed.
+  this._counters = undefined;
+  this._countersAtStart = null;
+  this._countersAtEnd = null;
 
   // this._run will use fork() to create a new process for each configuration
   // combination.
@@ -145,7 +168,7 @@ Benchmark.prototype._run = function() {
     process.send({
       type: 'config',
       name: this.name,
-      queueLength: this.queue.length,
+      queueLength: this.queue.length * kRuns,
     });
   }
 
@@ -188,12 +211,47 @@ Benchmark.prototype.start = function() {
     throw new Error('Called start more than once in a single benchmark');
   }
   this._started = true;
+  if (kCounters) {
+    this._readCounters(this._countersAtStart);
+  }
   this._time = process.hrtime();
 };
 
+Benchmark.prototype._openCounters = function() {
+  const binding = exports.binding('performance');
+  // Binaries that predate the counters can still be compared by rate.
+  const fds = typeof binding.openCpuCounters === 'function' ?
+    binding.openCpuCounters() : 'not supported';
+  if (!Array.isArray(fds)) {
+    console.error(`Hardware counters are not available (${fds})`);
+    this._counters = null;
+    return;
+  }
+  this._counters = { binding, fds };
+  this._countersAtStart = new Float64Array(kCounterNames.length);
+  this._countersAtEnd = new Float64Array(kCounterNames.length);
+  process.on('exit', () => binding.closeCpuCounters(fds));
+};
+
+Benchmark.prototype._readCounters = function(values) {
+  if (this._counters === undefined) {
+    this._openCounters();
+  }
+  if (this._counters) {
+    const { binding, fds } = this._counters;
+    const err = binding.readCpuCounters(fds[0], values);
+    if (err !== 0) {
+      throw new Error(`Reading hardware counters failed (error ${err})`);
+    }
+  }
+};
+
 Benchmark.prototype.end = function(operations) {
   // Get elapsed time now and do error checking later for accuracy.
   const elapsed = process.hrtime(this._time);
+  if (kCounters && this._started && !this._ended) {
+    this._readCounters(this._countersAtEnd);
+  }
 
   if (!this._started) {
     throw new Error('called end without start');
@@ -217,7 +275,15 @@ Benchmark.prototype.end = function(operations) {
   this._ended = true;
   const time = elapsed[0] + elapsed[1] / 1e9;
   const rate = operations / time;
-  this.report(rate, elapsed);
+  let counters;
+  if (this._counters) {
+    counters = {};
+    kCounterNames.forEach((name, i) => {
+      const delta = this._countersAtEnd[i] - this._countersAtStart[i];
+      counters[name] = delta / operations;
+    });
+  }
+  this.report(rate, elapsed, { counters });
 };
 
 function formatResult(data) {
@@ -230,7 +296,19 @@ function formatResult(data) {
   var rate = data.rate.toString().split('.');
   rate[0] = rate[0].replace(/(\d)(?=(?:\d\d\d)+(?!\d))/g, '$1,');
   rate = (rate[1] ? rate.join('.') : rate[0]);
-  return `${data.name}${conf}: ${rate}`;
+  let counters = '';
+  if (data.counters) {
+    for (const name of kCounterNames) {
+      counters += ` ${name}/op=${data.counters[name].toFixed(2)}`;
+    }
+  }
+  let metrics = '';
+  if (data.metrics) {
+    for (const name of Object.keys(data.metrics)) {
+      metrics += ` ${name}=${data.metrics[name].toFixed(2)}`;
+    }
+  }
+  return `${data.name}${conf}: ${rate}${counters}${metrics}`;
 }
 
 function sendResult(data) {
@@ -244,14 +322,29 @@ function sendResult(data) {
 }
 exports.sendResult = sendResult;
 
-Benchmark.prototype.report = function(rate, elapsed) {
-  sendResult({
-    name: this.name,
-    conf: this.config,
-    rate: rate,
-    time: elapsed[0] + elapsed[1] / 1e9,
-    type: 'report',
-  });
+// `extra` can contain the `counters` per operation, and `metrics`, an object
+// with other measurements of the run, like latency percentiles.
+Benchmark.prototype.report = function(rate, elapsed, extra) {
+  this._runs++;
+  if (this._runs > kWarmup) {
+    sendResult({
+      name: this.name,
+      conf: this.config,
+      rate: rate,
+      time: elapsed[0] + elapsed[1] / 1e9,
+      ...extra,
+      type: 'report',
+    });
+  }
+
+  // Run the configuration again in the same process until enough runs have
+  // been reported. The benchmark function has to be able to run more than once
+  // for this, i.e. clean up everything it creates before calling end().
+  if (this._runs < kWarmup + kRuns) {
+    this._started = false;
+    this._ended = false;
+    setImmediate(() => this._fn(this.config));
+  }
 };
 
 exports.binding = function(bindingName) {
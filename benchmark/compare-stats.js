@@ -0,0 +1,110 @@
+'use strict';
+
+const { mean, studentTQuantile, welchTTest } = require('./_stats.js');
+
+if (process.argv.length > 2) {
+  console.error(`usage: cat file.csv | ./node compare-stats.js
+  Analyse the csv output of compare.js, like compare.R does but without
+  requiring R. When the csv contains hardware counters (compare.js
+  --counters), the change of each counter per operation is shown as well.`);
+  process.exit(1);
+}
+
+// Splits a line of the csv written by compare.js into its fields.
+function parseLine(line) {
+  const fields = [];
+  const fieldRE = /\s*(?:"((?:[^"]|"")*)"|([^,]*))\s*(?:,|$)/y;
+  while (fieldRE.lastIndex < line.length) {
+    const match = fieldRE.exec(line);
+    if (match === null)
+      throw new Error(`Invalid csv line: ${line}`);
+    fields.push(match[1] !== undefined ? match[1].replace(/""/g, '"') :
+      match[2]);
+  }
+  return fields;
+}
+
+function analyse(input) {
+  const lines = input.split('\n').filter((line) => line.trim() !== '');
+  const header = parseLine(lines.shift());
+  const counters = header.slice(5);
+
+  // Group the samples by benchmark configuration and binary.
+  const benchmarks = new Map();
+  for (const line of lines) {
+    const fields = parseLine(line);
+    const name = `${fields[1]} ${fields[2]}`;
+    if (!benchmarks.has(name))
+      benchmarks.set(name, { old: [], new: [] });
+    benchmarks.get(name)[fields[0]].push(fields.slice(3).map(Number));
+  }
+
+  const columns = ['', 'confidence', 'improvement', 'accuracy (*)', '(**)',
+                   '(***)', ...counters];
+  const rows = [];
+  for (const [name, { old: oldSamples, new: newSamples }] of benchmarks) {
+    const oldRate = oldSamples.map((sample) => sample[0]);
+    const newRate = newSamples.map((sample) => sample[0]);
+    const oldMu = mean(oldRate);
+    const improvement = (mean(newRate) - oldMu) / oldMu * 100;
+    const row = [name, 'NA', `${improvement.toFixed(2)} %`, 'NA', 'NA', 'NA'];
+
+    // Check if there is enough data to calculate the p-value.
+    if (oldRate.length > 1 && newRate.length > 1) {
+      const { df, p, se } = welchTTest(newRate, oldRate);
+      // Add user friendly stars to the table. There should be at least one
+      // star before you can say that there is an improvement.
+      row[1] = p < 0.001 ? '***' : p < 0.01 ? '**' : p < 0.05 ? '*' : '';
+      // The confidence interval is relative to the old mean, which is what
+      // the improvement is calculated relative to.
+      [0.05, 0.01, 0.001].forEach((risk, i) => {
+        const interval = studentTQuantile(1 - risk / 2, df) * se;
+        row[3 + i] = `±${(interval / oldMu * 100).toFixed(2)}%`;
+      });
+    }
+
+    // Counters are costs per operation, so a negative change is better.
+    counters.forEach((_, i) => {
+      const counterOf = (sample) => sample[2 + i];
+      const oldCounter = oldSamples.map(counterOf).filter(Number.isFinite);
+      const newCounter = newSamples.map(counterOf).filter(Number.isFinite);
+      if (oldCounter.length === 0 || newCounter.length === 0) {
+        row.push('NA');
+        return;
+      }
+      const oldCounterMu = mean(oldCounter);
+      const change = (mean(newCounter) - oldCounterMu) / oldCounterMu * 100;
+      row.push(`${change.toFixed(2)} %`);
+    });
+    rows.push(row);
+  }
+
+  // Print the table with the benchmark names left aligned, and the other
+  // columns right aligned.
+  const widths = columns.map((column, i) => {
+    return Math.max(column.length, ...rows.map((row) => row[i].length));
+  });
+  const format = (row) => row.map((cell, i) => {
+    return i === 0 ? cell.padEnd(widths[i]) : cell.padStart(widths[i]);
+  }).join(' ');
+  console.log(format(columns));
+  for (const row of rows)
+    console.log(format(row));
+
+  const n = rows.length;
+  console.log(`
+Be aware that when doing many comparisons the risk of a false-positive
+result increases. In this case there are ${n} comparisons, you can thus
+expect the following amount of false-positive results:
+  ${(n * 0.05).toFixed(2)} false positives, when considering a   5% risk \
+acceptance (*, **, ***),
+  ${(n * 0.01).toFixed(2)} false positives, when considering a   1% risk \
+acceptance (**, ***),
+  ${(n * 0.001).toFixed(2)} false positives, when considering a 0.1% risk \
+acceptance (***)`);
+}
+
+let input = '';
+process.stdin.setEncoding('utf8');
+process.stdin.on('data', (chunk) => input += chunk);
+process.stdin.on('end', () => analyse(input));
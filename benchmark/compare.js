@@ -13,18 +13,27 @@ const cli = CLI(`usage: ./node compare.js [options] [--] <category> ...
   Run each benchmark in the <category> directory many times using two different
   node versions. More than one <category> directory can be specified.
   The output is formatted as csv, which can be processed using for
-  example 'compare.R'.
+  example 'compare.R' or 'compare-stats.js'.
 
   --new      ./new-node-binary  new node binary (required)
   --old      ./old-node-binary  old node binary (required)
   --runs     30                 number of samples
+  --warmup   0                  number of runs of each configuration that are
+                                discarded before a sample is taken
+  --in-process                  take all samples of a configuration in one
+                                process instead of one process per sample
+  --counters                    add the hardware counters per operation to the
+                                output (Linux only)
   --filter   pattern            includes only benchmark scripts matching
                                 <pattern> (can be repeated)
   --exclude  pattern            excludes scripts matching <pattern> (can be
                                 repeated)
   --set      variable=value     set benchmark variable (can be repeated)
   --no-progress                 don't show benchmark progress indicator
-`, { arrayArgs: ['set', 'filter', 'exclude'], boolArgs: ['no-progress'] });
+`, {
+  arrayArgs: ['set', 'filter', 'exclude'],
+  boolArgs: ['no-progress', 'in-process', 'counters']
+});
 
 if (!cli.optional.new || !cli.optional.old) {
   cli.abort(cli.usage);
@@ -32,6 +41,20 @@ if (!cli.optional.new || !cli.optional.old) {
 
 const binaries = ['old', 'new'];
 const runs = cli.optional.runs ? parseInt(cli.optional.runs, 10) : 30;
+const inProcess = !!cli.optional['in-process'];
+const counters = !!cli.optional.counters;
+const { counterNames } = require('./common.js');
+
+const childEnv = { ...process.env };
+if (cli.optional.warmup) {
+  childEnv.NODE_BENCHMARK_WARMUP = cli.optional.warmup;
+}
+if (inProcess) {
+  childEnv.NODE_BENCHMARK_RUNS = `${runs}`;
+}
+if (counters) {
+  childEnv.NODE_BENCHMARK_COUNTERS = '1';
+}
 const benchmarks = cli.benchmarks();
 
 if (benchmarks.length === 0) {
@@ -41,13 +64,14 @@ if (benchmarks.length === 0) {
 }
 
 // Create queue from the benchmarks list such both node versions are tested
-// `runs` amount of times each.
+// `runs` amount of times each. With --in-process, each process takes all the
+// samples instead.
 // Note: BenchmarkProgress relies on this order to estimate
 // how much runs remaining for a file. All benchmarks generated from
 // the same file must be run consecutively.
 const queue = [];
 for (const filename of benchmarks) {
-  for (let iter = 0; iter < runs; iter++) {
+  for (let iter = 0; iter < (inProcess ? 1 : runs); iter++) {
     for (const binary of binaries) {
       queue.push({ binary, filename, iter });
     }
@@ -56,7 +80,11 @@ for (const filename of benchmarks) {
 // queue.length = binary.length * runs * benchmarks.length
 
 // Print csv header
-console.log('"binary", "filename", "configuration", "rate", "time"');
+let header = '"binary", "filename", "configuration", "rate", "time"';
+if (counters) {
+  header += counterNames.map((name) => `, "${name}"`).join('');
+}
+console.log(header);
 
 const kStartOfQueue = 0;
 
@@ -71,7 +99,8 @@ if (showProgress) {
   const job = queue[i];
 
   const child = fork(path.resolve(__dirname, job.filename), cli.optional.set, {
-    execPath: cli.optional[job.binary]
+    execPath: cli.optional[job.binary],
+    env: childEnv
   });
 
   child.on('message', (data) => {
@@ -85,8 +114,14 @@ if (showProgress) {
       // Escape quotes (") for correct csv formatting
       conf = conf.replace(/"/g, '""');
 
-      console.log(`"${job.binary}", "${job.filename}", "${conf}", ` +
-                  `${data.rate}, ${data.time}`);
+      let line = `"${job.binary}", "${job.filename}", "${conf}", ` +
+                 `${data.rate}, ${data.time}`;
+      if (counters) {
+        for (const name of counterNames) {
+          line += `, ${data.counters ? data.counters[name] : 'NA'}`;
+        }
+      }
+      console.log(line);
       if (showProgress) {
         // One item in the subqueue has been completed.
         progress.completeConfig(data);
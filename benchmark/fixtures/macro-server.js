@@ -0,0 +1,188 @@
+'use strict';
+
+// Servers for the benchmark/macro benchmarks. benchmark/macro/_load.js forks
+// this file with the name of a workload and its options as JSON, so that the
+// load generator and the server do not share an event loop. The server reports
+// its port once it listens, and its peak RSS when it is asked to stop.
+
+const fs = require('fs');
+const http = require('http');
+const os = require('os');
+const path = require('path');
+
+const workload = process.argv[2];
+const options = JSON.parse(process.argv[3]);
+
+// A table of records of roughly 500 bytes each as JSON, served by the JSON API.
+const users = [];
+for (let id = 0; id < 1000; id++) {
+  users.push({
+    id,
+    name: `User ${id}`,
+    email: `user${id}@example.com`,
+    roles: id % 10 === 0 ? ['admin', 'writer', 'reader'] : ['reader'],
+    created: new Date(1.5e12 + id * 864e5).toISOString(),
+    profile: {
+      bio: 'Lorem ipsum dolor sit amet, consectetur adipiscing elit. '
+        .repeat(4),
+      followers: id * 37 % 1009,
+      verified: id % 3 === 0
+    }
+  });
+}
+
+function sendJSON(res, statusCode, value) {
+  const body = JSON.stringify(value);
+  res.writeHead(statusCode, {
+    'Content-Type': 'application/json',
+    'Content-Length': Buffer.byteLength(body)
+  });
+  res.end(body);
+}
+
+// GET /users/<id> returns a record, POST /users validates and stores a new
+// one, and returns it with its new id.
+function jsonApi(req, res) {
+  if (req.method === 'POST') {
+    let body = '';
+    req.setEncoding('utf8');
+    req.on('data', (chunk) => body += chunk);
+    req.on('end', () => {
+      const user = JSON.parse(body);
+      if (typeof user.name !== 'string' || typeof user.email !== 'string')
+        return sendJSON(res, 400, { error: 'invalid user' });
+      user.id = users.length;
+      user.created = new Date().toISOString();
+      sendJSON(res, 201, user);
+    });
+    return;
+  }
+  const user = users[+req.url.slice('/users/'.length)];
+  if (user === undefined)
+    return sendJSON(res, 404, { error: 'not found' });
+  sendJSON(res, 200, user);
+}
+
+const servers = {
+  'json-api'() {
+    return http.createServer(jsonApi);
+  },
+
+  'tls-json-api'() {
+    const fixtures = require('../../test/common/fixtures');
+    return require('https').createServer({
+      key: fixtures.readKey('rsa_private.pem'),
+      cert: fixtures.readKey('rsa_cert.crt'),
+      ciphers: options.ciphers.join(':'),
+      maxVersion: 'TLSv1.2'
+    }, jsonApi);
+  },
+
+  // gRPC style calls: requests and responses are length prefixed messages,
+  // and the status is sent in the trailers. A unary call echoes the request
+  // message once, a server streaming call `messages` times.
+  'grpc'() {
+    const server = require('http2').createServer();
+    server.on('stream', (stream, headers) => {
+      const chunks = [];
+      stream.on('data', (chunk) => chunks.push(chunk));
+      stream.on('end', () => {
+        const message = Buffer.concat(chunks);
+        const count = headers[':path'] === '/bench.Echo/ServerStream' ?
+          options.messages : 1;
+        stream.respond({
+          ':status': 200,
+          'content-type': 'application/grpc'
+        }, { waitForTrailers: true });
+        stream.on('wantTrailers', () => {
+          stream.sendTrailers({ 'grpc-status': '0' });
+        });
+        for (let i = 0; i < count; i++)
+          stream.write(message);
+        stream.end();
+      });
+      stream.on('error', () => {});
+    });
+    return server;
+  },
+
+  'static'() {
+    const file = path.join(os.tmpdir(), `node-benchmark-static-${process.pid}`);
+    fs.writeFileSync(file, Buffer.alloc(options.size, 'x'));
+    process.on('exit', () => fs.unlinkSync(file));
+    if (options.method === 'pipeTo') {
+      // The body is sent from the file to the socket with sendfile(2), where
+      // filehandle.pipeTo() supports that.
+      return http.createServer(async (req, res) => {
+        let filehandle;
+        try {
+          filehandle = await fs.promises.open(file, 'r');
+          const stats = await filehandle.stat();
+          res.writeHead(200, {
+            'Content-Type': 'application/octet-stream',
+            'Content-Length': stats.size
+          });
+          res.flushHeaders();
+          await filehandle.pipeTo(res.socket);
+          res.end();
+        } catch {
+          res.destroy();
+        } finally {
+          if (filehandle !== undefined)
+            await filehandle.close();
+        }
+      });
+    }
+    return http.createServer((req, res) => {
+      fs.stat(file, (err, stats) => {
+        if (err) {
+          res.statusCode = 500;
+          return res.end();
+        }
+        res.writeHead(200, {
+          'Content-Type': 'application/octet-stream',
+          'Content-Length': stats.size
+        });
+        fs.createReadStream(file).pipe(res);
+      });
+    });
+  },
+
+  // A reverse proxy in front of a json-api server that runs in another
+  // process.
+  'proxy'() {
+    const agent = new http.Agent({
+      keepAlive: true,
+      maxSockets: options.connections
+    });
+    return http.createServer((req, res) => {
+      const proxyReq = http.request({
+        port: options.backendPort,
+        method: req.method,
+        path: req.url,
+        headers: req.headers,
+        agent
+      }, (proxyRes) => {
+        res.writeHead(proxyRes.statusCode, proxyRes.headers);
+        proxyRes.pipe(res);
+      });
+      proxyReq.on('error', () => {
+        res.statusCode = 502;
+        res.end();
+      });
+      req.pipe(proxyReq);
+    });
+  }
+};
+
+const server = servers[workload]();
+server.listen(0, () => {
+  process.send({ type: 'listening', port: server.address().port });
+});
+
+process.on('message', (message) => {
+  if (message.type === 'stop') {
+    const maxRSS = process.resourceUsage().maxRSS * 1024;
+    process.send({ type: 'stopped', maxRSS }, () => process.exit(0));
+  }
+});
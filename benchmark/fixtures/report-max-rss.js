@@ -0,0 +1,7 @@
+'use strict';
+
+// Preloaded by benchmark/misc/startup.js to report the peak RSS of the
+// process, in kilobytes, once it exits.
+process.on('exit', () => {
+  process.stdout.write(`\n${process.resourceUsage().maxRSS}\n`);
+});
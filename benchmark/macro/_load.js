@@ -0,0 +1,139 @@
+'use strict';
+
+// Closed-loop load generator for the macro benchmarks. The server under test
+// runs in its own process (see fixtures/macro-server.js), and `connections`
+// clients each send a request as soon as their previous one completed. Besides
+// the rate of requests, every run reports the 50th and 99th latency
+// percentiles in milliseconds and the peak RSS of the server in megabytes.
+
+const { fork } = require('child_process');
+const path = require('path');
+
+const serverPath = path.resolve(__dirname, '../fixtures/macro-server.js');
+
+function startServer(workload, options, callback) {
+  const child = fork(serverPath, [workload, JSON.stringify(options)]);
+  child.once('message', (message) => callback(child, message.port));
+}
+
+function stopServer(child, callback) {
+  child.once('message', (message) => {
+    child.once('exit', () => callback(message.maxRSS));
+  });
+  child.send({ type: 'stop' });
+}
+
+function percentile(sorted, p) {
+  return sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))];
+}
+
+// Runs the benchmark. `options` contains:
+// - workload: the server in fixtures/macro-server.js
+// - server: options for the server
+// - backend: a workload to start first, whose port is passed to the server
+//   as `backendPort`
+// - dur: duration in seconds
+// - connections: number of concurrent clients
+// - createClient(port): returns an object with a `request(callback)` method
+//   that sends one request, and a `close()` method
+exports.run = function(bench, options) {
+  const { dur, connections } = options;
+
+  function withBackend(callback) {
+    if (!options.backend)
+      return callback(null, undefined);
+    startServer(options.backend, {}, callback);
+  }
+
+  withBackend((backend, backendPort) => {
+    const serverOptions = { ...options.server, connections, backendPort };
+    startServer(options.workload, serverOptions, (server, port) => {
+      const client = options.createClient(port);
+      const latencies = [];
+      let stopped = false;
+      let active = connections;
+
+      const start = process.hrtime();
+      setTimeout(() => stopped = true, dur * 1000);
+      for (let i = 0; i < connections; i++)
+        next();
+
+      function next() {
+        if (stopped) {
+          if (--active === 0)
+            finish();
+          return;
+        }
+        const requestStart = process.hrtime();
+        client.request((err) => {
+          if (err)
+            throw err;
+          const [seconds, nanoseconds] = process.hrtime(requestStart);
+          latencies.push(seconds * 1e3 + nanoseconds / 1e6);
+          next();
+        });
+      }
+
+      function finish() {
+        const elapsed = process.hrtime(start);
+        client.close();
+        stopServer(server, (maxRSS) => {
+          if (backend)
+            backend.kill();
+          latencies.sort((a, b) => a - b);
+          const time = elapsed[0] + elapsed[1] / 1e9;
+          bench.report(latencies.length / time, elapsed, {
+            metrics: {
+              p50_ms: percentile(latencies, 0.5),
+              p99_ms: percentile(latencies, 0.99),
+              rss_mb: maxRSS / (1024 * 1024)
+            }
+          });
+        });
+      }
+    });
+  });
+};
+
+const newUser = JSON.stringify({
+  name: 'New User',
+  email: 'new.user@example.com',
+  roles: ['reader'],
+  profile: { bio: 'Lorem ipsum dolor sit amet.', followers: 0 }
+});
+
+// A client for the JSON API: three out of four requests read a record, the
+// fourth creates one. With `tls`, the requests are spread over `ciphers`.
+exports.createJSONClient = function(port, options) {
+  const { connections, keepalive, tls, ciphers } = options;
+  const protocol = require(tls ? 'https' : 'http');
+  const agent = new protocol.Agent({
+    keepAlive: !!keepalive,
+    maxSockets: connections,
+    rejectUnauthorized: false
+  });
+  let count = 0;
+
+  return {
+    request(callback) {
+      const id = count++;
+      const create = id % 4 === 3;
+      const req = protocol.request({
+        port,
+        agent,
+        method: create ? 'POST' : 'GET',
+        path: create ? '/users' : `/users/${id % 1000}`,
+        headers: create ? { 'Content-Type': 'application/json' } : {},
+        ciphers: tls ? ciphers[id % ciphers.length] : undefined
+      }, (res) => {
+        res.resume();
+        res.on('end', () => callback(null));
+      });
+      req.on('error', callback);
+      req.end(create ? newUser : undefined);
+    },
+    close() {
+      agent.destroy();
+    }
+  };
+};
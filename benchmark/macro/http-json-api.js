@@ -0,0 +1,23 @@
+'use strict';
+
+// A JSON API over HTTP/1.1, see fixtures/macro-server.js.
+
+const common = require('../common.js');
+const load = require('./_load.js');
+
+const bench = common.createBenchmark(main, {
+  connections: [1, 50],
+  keepalive: [1, 0],
+  dur: [5]
+});
+
+function main({ connections, keepalive, dur }) {
+  load.run(bench, {
+    workload: 'json-api',
+    dur,
+    connections,
+    createClient(port) {
+      return load.createJSONClient(port, { connections, keepalive });
+    }
+  });
+}
@@ -0,0 +1,24 @@
+'use strict';
+
+// The JSON API behind a reverse proxy. Both run in their own process, and the
+// reported RSS is that of the proxy.
+
+const common = require('../common.js');
+const load = require('./_load.js');
+
+const bench = common.createBenchmark(main, {
+  connections: [1, 50],
+  dur: [5]
+});
+
+function main({ connections, dur }) {
+  load.run(bench, {
+    workload: 'proxy',
+    backend: 'json-api',
+    dur,
+    connections,
+    createClient(port) {
+      return load.createJSONClient(port, { connections, keepalive: 1 });
+    }
+  });
+}
@@ -0,0 +1,42 @@
+'use strict';
+
+// Serving a file with fs.createReadStream(), or with filehandle.pipeTo() on
+// the socket, see fixtures/macro-server.js.
+
+const common = require('../common.js');
+const load = require('./_load.js');
+
+const bench = common.createBenchmark(main, {
+  method: ['stream', 'pipeTo'],
+  size: [1024, 64 * 1024, 1024 * 1024],
+  connections: [1, 50],
+  dur: [5]
+});
+
+function main({ method, size, connections, dur }) {
+  const http = require('http');
+  load.run(bench, {
+    workload: 'static',
+    server: { method, size },
+    dur,
+    connections,
+    createClient(port) {
+      const agent = new http.Agent({
+        keepAlive: true,
+        maxSockets: connections
+      });
+      return {
+        request(callback) {
+          const req = http.get({ port, agent, path: '/file' }, (res) => {
+            res.resume();
+            res.on('end', () => callback(null));
+          });
+          req.on('error', callback);
+        },
+        close() {
+          agent.destroy();
+        }
+      };
+    }
+  });
+}
@@ -0,0 +1,64 @@
+'use strict';
+
+// gRPC style unary and server streaming calls over a single HTTP/2 session.
+// The latency of a streaming call is the time until its last message arrived.
+
+const common = require('../common.js');
+const load = require('./_load.js');
+
+const bench = common.createBenchmark(main, {
+  call: ['unary', 'stream'],
+  size: [100, 16 * 1024],
+  messages: [10],
+  connections: [1, 50],
+  dur: [5]
+}, { flags: ['--no-warnings'] });
+
+function main({ call, size, messages, connections, dur }) {
+  const http2 = require('http2');
+  // A length prefixed message, as in the gRPC wire format.
+  const message = Buffer.alloc(5 + size, 'x');
+  message[0] = 0;
+  message.writeUInt32BE(size, 1);
+  const path = call === 'unary' ?
+    '/bench.Echo/Unary' : '/bench.Echo/ServerStream';
+
+  load.run(bench, {
+    workload: 'grpc',
+    server: { messages },
+    dur,
+    connections,
+    createClient(port) {
+      const session = http2.connect(`http://localhost:${port}`);
+      return {
+        request(callback) {
+          const stream = session.request({
+            ':method': 'POST',
+            ':path': path,
+            'content-type': 'application/grpc',
+            'te': 'trailers'
+          });
+          let status;
+          stream.on('trailers', (trailers) => {
+            status = trailers['grpc-status'];
+          });
+          // Errors are reported through the close code instead.
+          stream.on('error', () => {});
+          stream.on('close', () => {
+            if (stream.rstCode !== http2.constants.NGHTTP2_NO_ERROR)
+              callback(new Error(`stream reset with ${stream.rstCode}`));
+            else if (status !== '0')
+              callback(new Error(`grpc-status ${status}`));
+            else
+              callback(null);
+          });
+          stream.resume();
+          stream.end(message);
+        },
+        close() {
+          session.close();
+        }
+      };
+    }
+  });
+}
@@ -0,0 +1,41 @@
+'use strict';
+
+// The JSON API over TLS 1.2, with the clients spread over the ciphers of a
+// typical server configuration.
+
+const common = require('../common.js');
+const load = require('./_load.js');
+
+const ciphers = {
+  mixed: [
+    'ECDHE-RSA-AES128-GCM-SHA256',
+    'ECDHE-RSA-AES256-GCM-SHA384',
+    'ECDHE-RSA-CHACHA20-POLY1305',
+  ],
+  aes128: ['ECDHE-RSA-AES128-GCM-SHA256'],
+  chacha20: ['ECDHE-RSA-CHACHA20-POLY1305']
+};
+
+const bench = common.createBenchmark(main, {
+  ciphers: Object.keys(ciphers),
+  connections: [1, 50],
+  keepalive: [1, 0],
+  dur: [5]
+});
+
+function main({ connections, keepalive, dur, ...conf }) {
+  load.run(bench, {
+    workload: 'tls-json-api',
+    server: { ciphers: ciphers[conf.ciphers] },
+    dur,
+    connections,
+    createClient(port) {
+      return load.createJSONClient(port, {
+        connections,
+        keepalive,
+        tls: true,
+        ciphers: ciphers[conf.ciphers]
+      });
+    }
+  });
+}
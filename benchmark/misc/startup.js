@@ -7,18 +7,34 @@ let Worker;  // Lazy loaded in main
 
 const bench = common.createBenchmark(main, {
   dur: [1],
-  script: ['benchmark/fixtures/require-cachable', 'test/fixtures/semicolon'],
-  mode: ['process', 'worker']
+  script: [
+    'benchmark/fixtures/require-cachable',
+    'benchmark/fixtures/require-http',
+    'test/fixtures/semicolon',
+  ],
+  // In `rss` mode, processes are started one after another like in `process`
+  // mode, but the result is their average peak RSS in kilobytes instead of
+  // the number of startups per second.
+  mode: ['process', 'worker', 'rss']
 }, {
   flags: ['--expose-internals']
 });
 
+const reportMaxRss =
+  path.resolve(__dirname, '../fixtures/report-max-rss.js');
+
 function spawnProcess(script) {
   const cmd = process.execPath || process.argv[0];
   const argv = ['--expose-internals', script];
   return spawn(cmd, argv);
 }
 
+function spawnProcessReportingRss(script) {
+  const cmd = process.execPath || process.argv[0];
+  const argv = ['--expose-internals', '--require', reportMaxRss, script];
+  return spawn(cmd, argv);
+}
+
 function spawnWorker(script) {
   return new Worker(script, { stderr: true, stdout: true });
 }
@@ -36,7 +52,9 @@ function start(state, script, bench, getNode) {
     stderr += data;
   });
 
-  node.on('exit', (code) => {
+  // The peak RSS is written to stdout, which is only complete on 'close'.
+  const event = state.rss === undefined ? 'exit' : 'close';
+  node.on(event, (code) => {
     if (code !== 0) {
       console.error('------ stdout ------');
       console.error(stdout);
@@ -45,15 +63,22 @@ function start(state, script, bench, getNode) {
       throw new Error(`Error during node startup, exit code ${code}`);
     }
     state.throughput++;
-
-    if (state.go) {
-      start(state, script, bench, getNode);
-    } else {
-      bench.end(state.throughput);
-    }
+    if (state.rss !== undefined)
+      state.rss += Number(stdout.trim().split('\n').pop());
+    next(state, script, bench, getNode);
   });
 }
 
+function next(state, script, bench, getNode) {
+  if (state.go) {
+    start(state, script, bench, getNode);
+  } else if (state.rss !== undefined) {
+    bench.report(state.rss / state.throughput, process.hrtime(state.time));
+  } else {
+    bench.end(state.throughput);
+  }
+}
+
 function main({ dur, script, mode }) {
   const state = {
     go: true,
@@ -69,6 +94,10 @@ function main({ dur, script, mode }) {
     Worker = require('worker_threads').Worker;
     bench.start();
     start(state, script, bench, spawnWorker);
+  } else if (mode === 'rss') {
+    state.rss = 0;
+    state.time = process.hrtime();
+    start(state, script, bench, spawnProcessReportingRss);
   } else {
     bench.start();
     start(state, script, bench, spawnProcess);
@@ -0,0 +1,28 @@
+'use strict';
+const common = require('../common.js');
+const querystring = require('querystring');
+
+// Form-encoded bodies, as sent by browsers and ad-serving clients.
+const values = {
+  plain: (i) => `value${i}`,
+  plus: (i) => `some+words+for+field+${i}`,
+  percent: (i) => `caf%C3%A9%2C+%E2%9C%93+${i}%40example.com`,
+};
+
+const bench = common.createBenchmark(main, {
+  fields: [5, 50],
+  encoding: Object.keys(values),
+  n: [1e5],
+});
+
+function main({ fields, encoding, n }) {
+  const pairs = [];
+  for (let i = 0; i < fields; i++)
+    pairs.push(`field${i}=${values[encoding](i)}`);
+  const input = pairs.join('&');
+
+  bench.start();
+  for (let i = 0; i < n; i += 1)
+    querystring.parse(input);
+  bench.end(n);
+}
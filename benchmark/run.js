@@ -63,7 +63,14 @@ if (format === 'csv') {
       var rate = data.rate.toString().split('.');
       rate[0] = rate[0].replace(/(\d)(?=(?:\d\d\d)+(?!\d))/g, '$1,');
       rate = (rate[1] ? rate.join('.') : rate[0]);
-      console.log(`${data.name} ${conf}: ${rate}`);
+      // Append the measurements that some benchmarks report besides the rate.
+      let extra = '';
+      for (const values of [data.counters, data.metrics]) {
+        for (const key of Object.keys(values || {})) {
+          extra += ` ${key}=${values[key].toFixed(2)}`;
+        }
+      }
+      console.log(`${data.name} ${conf}: ${rate}${extra}`);
     }
   });
 
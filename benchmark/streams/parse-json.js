@@ -0,0 +1,44 @@
+'use strict';
+
+const common = require('../common.js');
+const { Readable, parseJSON } = require('stream');
+
+const bench = common.createBenchmark(main, {
+  method: ['JSON.parse', 'parseJSON'],
+  items: [1e4],
+  n: [20]
+});
+
+function main({ method, items, n }) {
+  const array = [];
+  for (let i = 0; i < items; i++)
+    array.push({ id: i, name: `item ${i}`, tags: ['a', 'b'], score: i / 3 });
+  const text = Buffer.from(JSON.stringify(array));
+  const chunks = [];
+  for (let i = 0; i < text.length; i += 16384)
+    chunks.push(text.slice(i, i + 16384));
+
+  async function run() {
+    let count = 0;
+    if (method === 'JSON.parse') {
+      let body = '';
+      for await (const chunk of Readable.from(chunks))
+        body += chunk;
+      count = JSON.parse(body).length;
+    } else {
+      for await (const value of parseJSON(Readable.from(chunks))) {
+        if (value !== undefined)
+          count++;
+      }
+    }
+    if (count !== items)
+      throw new Error(`expected ${items} items, got ${count}`);
+  }
+
+  (async () => {
+    bench.start();
+    for (let i = 0; i < n; i++)
+      await run();
+    bench.end(n);
+  })();
+}
@@ -0,0 +1,29 @@
+'use strict';
+
+const common = require('../common');
+const Readable = require('stream').Readable;
+
+const bench = common.createBenchmark(main, {
+  batch: ['false', 'true'],
+  n: [1e6]
+});
+
+function main({ batch, n }) {
+  const s = new Readable({ objectMode: true, read() {} });
+  for (let i = 0; i < n; ++i)
+    s.push(i);
+  s.push(null);
+
+  (async function() {
+    let count = 0;
+    bench.start();
+    if (batch === 'true') {
+      for await (const chunks of s.iterator({ batch: true }))
+        count += chunks.length;
+    } else {
+      for await (const chunk of s) // eslint-disable-line no-unused-vars
+        count++;
+    }
+    bench.end(count);
+  })();
+}
@@ -0,0 +1,25 @@
+'use strict';
+const common = require('../common.js');
+const timers = require('timers');
+
+// Inserts and cancels timers with distinct delays, as with request timeouts
+// that add random jitter.
+const bench = common.createBenchmark(main, {
+  n: [5e5],
+  jitter: [1000],
+  method: ['setTimeout', 'setCoarseTimeout']
+});
+
+function main({ n, jitter, method }) {
+  const fn = timers[method];
+  const timersList = [];
+
+  bench.start();
+  for (let i = 0; i < n; i++)
+    timersList.push(fn(cb, 30000 + (i % jitter)));
+  for (let i = 0; i < n; i++)
+    clearTimeout(timersList[i]);
+  bench.end(n);
+}
+
+function cb() {}
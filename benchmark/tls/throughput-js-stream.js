@@ -0,0 +1,49 @@
+// Test the throughput of TLS over a JS Duplex stream, which is wrapped in a
+// JSStream handle.
+'use strict';
+const common = require('../common.js');
+const bench = common.createBenchmark(main, {
+  dur: [5],
+  size: [2, 1024, 1024 * 1024]
+});
+
+const fixtures = require('../../test/common/fixtures');
+const makeDuplexPair = require('../../test/common/duplexpair');
+const tls = require('tls');
+
+function main({ dur, size }) {
+  const chunk = Buffer.alloc(size, 'b');
+  const { clientSide, serverSide } = makeDuplexPair();
+
+  const server = new tls.TLSSocket(serverSide, {
+    isServer: true,
+    key: fixtures.readKey('rsa_private.pem'),
+    cert: fixtures.readKey('rsa_cert.crt'),
+    ciphers: 'AES256-GCM-SHA384'
+  });
+  let received = 0;
+  server.on('data', (chunk) => {
+    received += chunk.length;
+  });
+
+  const client = tls.connect({
+    socket: clientSide,
+    rejectUnauthorized: false
+  }, () => {
+    setTimeout(done, dur * 1000);
+    bench.start();
+    client.on('drain', write);
+    write();
+  });
+
+  function write() {
+    while (false !== client.write(chunk));
+  }
+
+  function done() {
+    const mbits = (received * 8) / (1024 * 1024);
+    bench.end(mbits);
+    client.destroy();
+    server.destroy();
+  }
+}
@@ -0,0 +1,30 @@
+'use strict';
+
+const common = require('../common.js');
+const v8 = require('v8');
+
+const bench = common.createBenchmark(main, {
+  api: ['serialize', 'serializeMany'],
+  count: [10, 1000],
+  n: [1e3]
+});
+
+function main({ api, count, n }) {
+  const values = [];
+  for (let i = 0; i < count; i++)
+    values.push({ id: i, name: `value ${i}`, tags: ['a', 'b'] });
+
+  if (api === 'serialize') {
+    bench.start();
+    for (let i = 0; i < n; i++) {
+      values.map(v8.serialize).map(v8.deserialize);
+    }
+    bench.end(n);
+  } else {
+    bench.start();
+    for (let i = 0; i < n; i++) {
+      [...v8.deserializeMany(v8.serializeMany(values))];
+    }
+    bench.end(n);
+  }
+}
@@ -3,7 +3,8 @@
 const common = require('../common.js');
 
 const bench = common.createBenchmark(main, {
-  n: [100]
+  n: [100],
+  ownGlobal: [0, 1]
 });
 
 const vm = require('vm');
@@ -13,11 +14,16 @@ const ctxFn = new vm.Script(`
   var c = a + b;
 `);
 
-function main({ n }) {
+function main({ n, ownGlobal }) {
   bench.start();
   let context;
   for (let i = 0; i < n; i++) {
-    context = vm.createContext({ a: 'a' });
+    if (ownGlobal) {
+      context = vm.createContext(undefined, { ownGlobal: true });
+      context.a = 'a';
+    } else {
+      context = vm.createContext({ a: 'a' });
+    }
   }
   bench.end(n);
   ctxFn.runInContext(context);
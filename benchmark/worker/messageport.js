@@ -1,9 +1,10 @@
 'use strict';
 
 const common = require('../common.js');
-const { MessageChannel } = require('worker_threads');
+const { MessageChannel, Worker } = require('worker_threads');
 const bench = common.createBenchmark(main, {
   payload: ['string', 'object'],
+  sender: ['same-thread', 'worker'],
   n: [1e6]
 });
 
@@ -24,6 +25,31 @@ function main(conf) {
 
   const { port1, port2 } = new MessageChannel();
 
+  if (conf.sender === 'worker') {
+    // A worker posts all messages as fast as it can, while this thread is
+    // receiving them, so that both threads access the queue concurrently.
+    let messages = 0;
+    port2.onmessage = () => {
+      if (++messages === n) {
+        bench.end(n);
+        port2.close();
+      }
+    };
+    bench.start();
+    const source = `
+      const { workerData: { port, payload, n } } = require('worker_threads');
+      for (let i = 0; i < n; i++)
+        port.postMessage(payload);
+    `;
+    const worker = new Worker(source, {
+      eval: true,
+      workerData: { port: port1, payload, n },
+      transferList: [port1]
+    });
+    worker.unref();
+    return;
+  }
+
   let messages = 0;
   port2.onmessage = () => {
     if (messages++ === n) {
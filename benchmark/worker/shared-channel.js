@@ -0,0 +1,66 @@
+'use strict';
+
+const common = require('../common.js');
+const {
+  MessageChannel, Worker, createChannel, openChannel
+} = require('worker_threads');
+const bench = common.createBenchmark(main, {
+  transport: ['channel', 'messageport'],
+  len: [1024, 64 * 1024],
+  n: [1e5]
+});
+
+// A worker sends `n` chunks of `len` bytes to this thread as fast as it can.
+function main({ transport, len, n }) {
+  let received = 0;
+  const total = len * n;
+  function onData(chunk) {
+    received += chunk.length;
+    if (received === total)
+      bench.end(total / (1024 * 1024 * 1024));
+  }
+
+  bench.start();
+  if (transport === 'channel') {
+    const [mine, theirs] = createChannel({ size: 4 * 1024 * 1024 });
+    const channel = openChannel(mine);
+    channel.on('data', onData);
+    channel.on('end', () => channel.destroy());
+    const source = `
+      const { workerData: { endpoint, len, n }, openChannel } =
+        require('worker_threads');
+      const channel = openChannel(endpoint);
+      const chunk = Buffer.alloc(len, 'x');
+      let i = 0;
+      (function write() {
+        while (i++ < n) {
+          if (!channel.write(chunk))
+            return channel.once('drain', write);
+        }
+        channel.end();
+      })();
+    `;
+    new Worker(source, {
+      eval: true,
+      workerData: { endpoint: theirs, len, n }
+    });
+  } else {
+    const { port1, port2 } = new MessageChannel();
+    port2.on('message', (chunk) => {
+      onData(chunk);
+      if (received === total)
+        port2.close();
+    });
+    const source = `
+      const { workerData: { port, len, n } } = require('worker_threads');
+      const chunk = Buffer.alloc(len, 'x');
+      for (let i = 0; i < n; i++)
+        port.postMessage(chunk);
+    `;
+    new Worker(source, {
+      eval: true,
+      workerData: { port: port1, len, n },
+      transferList: [port1]
+    });
+  }
+}
@@ -402,7 +402,8 @@ parser.add_option('--with-mips-float-abi',
 parser.add_option('--with-dtrace',
     action='store_true',
     dest='with_dtrace',
-    help='build with DTrace (default is true on sunos and darwin)')
+    help='build with DTrace (default is true on sunos and darwin, and on '
+         'linux when the systemtap dtrace tool and sys/sdt.h are found)')
 
 parser.add_option('--with-etw',
     action='store_true',
@@ -830,6 +831,25 @@ def check_compiler(o):
     o['variables']['gas_version'] = get_gas_version(CC)
 
 
+def has_systemtap_sdt(include_dir):
+  """Checks for the systemtap dtrace tool and <sys/sdt.h>, which are needed
+  to build the USDT probes on Linux."""
+  if not which('dtrace'):
+    return False
+  cmd = shlex.split(CC) + ['-E', '-x', 'c', '-']
+  if include_dir:
+    cmd += ['-I', include_dir]
+  try:
+    proc = subprocess.Popen(cmd,
+                            stdin=subprocess.PIPE,
+                            stdout=subprocess.PIPE,
+                            stderr=subprocess.PIPE)
+  except OSError:
+    return False
+  proc.communicate(b'#include <sys/sdt.h>\n')
+  return proc.returncode == 0
+
+
 def cc_macros(cc=None):
   """Checks predefined macros using the C compiler command."""
 
@@ -1065,9 +1085,12 @@ def configure_node(o):
 
   if flavor in ('solaris', 'mac', 'linux', 'freebsd'):
     use_dtrace = not options.without_dtrace
-    # Don't enable by default on linux and freebsd
-    if flavor in ('linux', 'freebsd'):
+    # Don't enable by default on freebsd, nor on linux unless the probes can
+    # be built there
+    if flavor == 'freebsd':
       use_dtrace = options.with_dtrace
+    elif flavor == 'linux' and use_dtrace and not options.with_dtrace:
+      use_dtrace = has_systemtap_sdt(options.systemtap_includes)
 
     if flavor == 'linux':
       if options.systemtap_includes:
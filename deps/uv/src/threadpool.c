@@ -26,24 +26,50 @@
 #endif
 
 #include <stdlib.h>
+#include <string.h>
 
 #define MAX_THREADPOOL_SIZE 1024
+#define MAX_THREADPOOL_NAME 32
+#define MAX_NAMED_THREADPOOLS 16
+
+/* All pools share `mutex`, which keeps uv__work_cancel() independent of the
+ * pool a work request was posted to.  Each pool has its own threads, queues
+ * and slow I/O accounting.
+ */
+struct uv__threadpool {
+  uv_cond_t cond;
+  unsigned int idle_threads;
+  unsigned int slow_io_work_running;
+  unsigned int nthreads;
+  uv_thread_t* threads;
+  QUEUE exit_message;
+  QUEUE wq;
+  QUEUE run_slow_work_message;
+  QUEUE slow_io_pending_wq;
+};
+
+/* Maps a pool name to its pool.  `pool` points to `default_pool` when the
+ * UV_THREADPOOL_SIZE_<NAME> environment variable is not set.
+ */
+struct uv__threadpool_name {
+  char name[MAX_THREADPOOL_NAME];
+  struct uv__threadpool* pool;
+};
+
+struct uv__worker_arg {
+  uv_sem_t sem;
+  struct uv__threadpool* pool;
+};
 
 static uv_once_t once = UV_ONCE_INIT;
-static uv_cond_t cond;
 static uv_mutex_t mutex;
-static unsigned int idle_threads;
-static unsigned int slow_io_work_running;
-static unsigned int nthreads;
-static uv_thread_t* threads;
 static uv_thread_t default_threads[4];
-static QUEUE exit_message;
-static QUEUE wq;
-static QUEUE run_slow_work_message;
-static QUEUE slow_io_pending_wq;
+static struct uv__threadpool default_pool;
+static struct uv__threadpool_name named_pools[MAX_NAMED_THREADPOOLS];
+static unsigned int nnamed_pools;
 
-static unsigned int slow_work_thread_threshold(void) {
-  return (nthreads + 1) / 2;
+static unsigned int slow_work_thread_threshold(struct uv__threadpool* pool) {
+  return (pool->nthreads + 1) / 2;
 }
 
 static void uv__cancelled(struct uv__work* w) {
@@ -55,11 +81,13 @@ static void uv__cancelled(struct uv__work* w) {
  * never holds the global mutex and the loop-local mutex at the same time.
  */
 static void worker(void* arg) {
+  struct uv__threadpool* pool;
   struct uv__work* w;
   QUEUE* q;
   int is_slow_work;
 
-  uv_sem_post((uv_sem_t*) arg);
+  pool = ((struct uv__worker_arg*) arg)->pool;
+  uv_sem_post(&((struct uv__worker_arg*) arg)->sem);
   arg = NULL;
 
   uv_mutex_lock(&mutex);
@@ -68,18 +96,18 @@ static void worker(void* arg) {
 
     /* Keep waiting while either no work is present or only slow I/O
        and we're at the threshold for that. */
-    while (QUEUE_EMPTY(&wq) ||
-           (QUEUE_HEAD(&wq) == &run_slow_work_message &&
-            QUEUE_NEXT(&run_slow_work_message) == &wq &&
-            slow_io_work_running >= slow_work_thread_threshold())) {
-      idle_threads += 1;
-      uv_cond_wait(&cond, &mutex);
-      idle_threads -= 1;
+    while (QUEUE_EMPTY(&pool->wq) ||
+           (QUEUE_HEAD(&pool->wq) == &pool->run_slow_work_message &&
+            QUEUE_NEXT(&pool->run_slow_work_message) == &pool->wq &&
+            pool->slow_io_work_running >= slow_work_thread_threshold(pool))) {
+      pool->idle_threads += 1;
+      uv_cond_wait(&pool->cond, &mutex);
+      pool->idle_threads -= 1;
     }
 
-    q = QUEUE_HEAD(&wq);
-    if (q == &exit_message) {
-      uv_cond_signal(&cond);
+    q = QUEUE_HEAD(&pool->wq);
+    if (q == &pool->exit_message) {
+      uv_cond_signal(&pool->cond);
       uv_mutex_unlock(&mutex);
       break;
     }
@@ -88,31 +116,31 @@ static void worker(void* arg) {
     QUEUE_INIT(q);  /* Signal uv_cancel() that the work req is executing. */
 
     is_slow_work = 0;
-    if (q == &run_slow_work_message) {
+    if (q == &pool->run_slow_work_message) {
       /* If we're at the slow I/O threshold, re-schedule until after all
          other work in the queue is done. */
-      if (slow_io_work_running >= slow_work_thread_threshold()) {
-        QUEUE_INSERT_TAIL(&wq, q);
+      if (pool->slow_io_work_running >= slow_work_thread_threshold(pool)) {
+        QUEUE_INSERT_TAIL(&pool->wq, q);
         continue;
       }
 
       /* If we encountered a request to run slow I/O work but there is none
          to run, that means it's cancelled => Start over. */
-      if (QUEUE_EMPTY(&slow_io_pending_wq))
+      if (QUEUE_EMPTY(&pool->slow_io_pending_wq))
         continue;
 
       is_slow_work = 1;
-      slow_io_work_running++;
+      pool->slow_io_work_running++;
 
-      q = QUEUE_HEAD(&slow_io_pending_wq);
+      q = QUEUE_HEAD(&pool->slow_io_pending_wq);
       QUEUE_REMOVE(q);
       QUEUE_INIT(q);
 
       /* If there is more slow I/O work, schedule it to be run as well. */
-      if (!QUEUE_EMPTY(&slow_io_pending_wq)) {
-        QUEUE_INSERT_TAIL(&wq, &run_slow_work_message);
-        if (idle_threads > 0)
-          uv_cond_signal(&cond);
+      if (!QUEUE_EMPTY(&pool->slow_io_pending_wq)) {
+        QUEUE_INSERT_TAIL(&pool->wq, &pool->run_slow_work_message);
+        if (pool->idle_threads > 0)
+          uv_cond_signal(&pool->cond);
       }
     }
 
@@ -133,102 +161,217 @@ static void worker(void* arg) {
     uv_mutex_lock(&mutex);
     if (is_slow_work) {
       /* `slow_io_work_running` is protected by `mutex`. */
-      slow_io_work_running--;
+      pool->slow_io_work_running--;
+    }
+  }
+}
+
+
+static unsigned int threadpool_size(const char* name, unsigned int fallback) {
+  const char* val;
+
+  val = getenv(name);
+  if (val == NULL)
+    return fallback;
+
+  return atoi(val);
+}
+
+
+/* Starts `nthreads` worker threads for `pool`.  `threads` is used when it is
+ * large enough, otherwise storage is allocated.  Returns the number of
+ * threads that were started, 0 if allocating the storage failed.
+ */
+static unsigned int init_pool(struct uv__threadpool* pool,
+                              unsigned int nthreads,
+                              uv_thread_t* threads,
+                              unsigned int nthreads_max) {
+  struct uv__worker_arg arg;
+  unsigned int i;
+
+  if (nthreads > MAX_THREADPOOL_SIZE)
+    nthreads = MAX_THREADPOOL_SIZE;
+
+  if (nthreads > nthreads_max) {
+    threads = uv__malloc(nthreads * sizeof(threads[0]));
+    if (threads == NULL)
+      return 0;
+  }
+
+  pool->idle_threads = 0;
+  pool->slow_io_work_running = 0;
+  pool->nthreads = nthreads;
+  pool->threads = threads;
+
+  if (uv_cond_init(&pool->cond))
+    abort();
+
+  QUEUE_INIT(&pool->wq);
+  QUEUE_INIT(&pool->slow_io_pending_wq);
+  QUEUE_INIT(&pool->run_slow_work_message);
+
+  if (uv_sem_init(&arg.sem, 0))
+    abort();
+
+  arg.pool = pool;
+  for (i = 0; i < nthreads; i++)
+    if (uv_thread_create(threads + i, worker, &arg))
+      abort();
+
+  for (i = 0; i < nthreads; i++)
+    uv_sem_wait(&arg.sem);
+
+  uv_sem_destroy(&arg.sem);
+
+  return nthreads;
+}
+
+
+/* Looks up the pool called `name`, creating it the first time it is asked
+ * for.  A pool only gets its own threads when UV_THREADPOOL_SIZE_<NAME> is
+ * set to a positive number; otherwise its work runs on the default pool.
+ * `mutex` must be held.
+ */
+static struct uv__threadpool* find_pool(const char* name) {
+  struct uv__threadpool_name* entry;
+  struct uv__threadpool* pool;
+  char var[sizeof("UV_THREADPOOL_SIZE_") + MAX_THREADPOOL_NAME];
+  unsigned int nthreads;
+  unsigned int i;
+  size_t len;
+
+  if (name == NULL)
+    return &default_pool;
+
+  len = strlen(name);
+  if (len == 0 || len >= MAX_THREADPOOL_NAME)
+    return &default_pool;
+
+  for (i = 0; i < nnamed_pools; i++)
+    if (strcmp(named_pools[i].name, name) == 0)
+      return named_pools[i].pool;
+
+  if (nnamed_pools == ARRAY_SIZE(named_pools))
+    return &default_pool;
+
+  memcpy(var, "UV_THREADPOOL_SIZE_", sizeof("UV_THREADPOOL_SIZE_") - 1);
+  for (i = 0; i < len; i++) {
+    var[sizeof("UV_THREADPOOL_SIZE_") - 1 + i] =
+        (name[i] >= 'a' && name[i] <= 'z') ? name[i] - 'a' + 'A' : name[i];
+  }
+  var[sizeof("UV_THREADPOOL_SIZE_") - 1 + len] = '\0';
+
+  pool = &default_pool;
+  nthreads = threadpool_size(var, 0);
+  if (nthreads > 0) {
+    pool = uv__malloc(sizeof(*pool));
+    if (pool == NULL) {
+      pool = &default_pool;
+    } else if (init_pool(pool, nthreads, NULL, 0) == 0) {
+      uv__free(pool);
+      pool = &default_pool;
     }
   }
+
+  entry = &named_pools[nnamed_pools++];
+  memcpy(entry->name, name, len + 1);
+  entry->pool = pool;
+
+  return pool;
 }
 
 
-static void post(QUEUE* q, enum uv__work_kind kind) {
+static void post(QUEUE* q, enum uv__work_kind kind, const char* name) {
+  struct uv__threadpool* pool;
+
   uv_mutex_lock(&mutex);
+  pool = find_pool(name);
   if (kind == UV__WORK_SLOW_IO) {
     /* Insert into a separate queue. */
-    QUEUE_INSERT_TAIL(&slow_io_pending_wq, q);
-    if (!QUEUE_EMPTY(&run_slow_work_message)) {
+    QUEUE_INSERT_TAIL(&pool->slow_io_pending_wq, q);
+    if (!QUEUE_EMPTY(&pool->run_slow_work_message)) {
       /* Running slow I/O tasks is already scheduled => Nothing to do here.
          The worker that runs said other task will schedule this one as well. */
       uv_mutex_unlock(&mutex);
       return;
     }
-    q = &run_slow_work_message;
+    q = &pool->run_slow_work_message;
   }
 
-  QUEUE_INSERT_TAIL(&wq, q);
-  if (idle_threads > 0)
-    uv_cond_signal(&cond);
+  QUEUE_INSERT_TAIL(&pool->wq, q);
+  if (pool->idle_threads > 0)
+    uv_cond_signal(&pool->cond);
   uv_mutex_unlock(&mutex);
 }
 
 
 #ifndef _WIN32
-UV_DESTRUCTOR(static void cleanup(void)) {
+static void cleanup_pool(struct uv__threadpool* pool) {
   unsigned int i;
 
-  if (nthreads == 0)
-    return;
-
-  post(&exit_message, UV__WORK_CPU);
+  uv_mutex_lock(&mutex);
+  QUEUE_INSERT_TAIL(&pool->wq, &pool->exit_message);
+  uv_cond_signal(&pool->cond);
+  uv_mutex_unlock(&mutex);
 
-  for (i = 0; i < nthreads; i++)
-    if (uv_thread_join(threads + i))
+  for (i = 0; i < pool->nthreads; i++)
+    if (uv_thread_join(pool->threads + i))
       abort();
 
-  if (threads != default_threads)
-    uv__free(threads);
+  if (pool->threads != default_threads)
+    uv__free(pool->threads);
 
-  uv_mutex_destroy(&mutex);
-  uv_cond_destroy(&cond);
+  uv_cond_destroy(&pool->cond);
 
-  threads = NULL;
-  nthreads = 0;
+  pool->threads = NULL;
+  pool->nthreads = 0;
 }
-#endif
 
 
-static void init_threads(void) {
+UV_DESTRUCTOR(static void cleanup(void)) {
   unsigned int i;
-  const char* val;
-  uv_sem_t sem;
 
-  nthreads = ARRAY_SIZE(default_threads);
-  val = getenv("UV_THREADPOOL_SIZE");
-  if (val != NULL)
-    nthreads = atoi(val);
-  if (nthreads == 0)
-    nthreads = 1;
-  if (nthreads > MAX_THREADPOOL_SIZE)
-    nthreads = MAX_THREADPOOL_SIZE;
+  if (default_pool.nthreads == 0)
+    return;
 
-  threads = default_threads;
-  if (nthreads > ARRAY_SIZE(default_threads)) {
-    threads = uv__malloc(nthreads * sizeof(threads[0]));
-    if (threads == NULL) {
-      nthreads = ARRAY_SIZE(default_threads);
-      threads = default_threads;
+  for (i = 0; i < nnamed_pools; i++) {
+    if (named_pools[i].pool != &default_pool) {
+      cleanup_pool(named_pools[i].pool);
+      uv__free(named_pools[i].pool);
     }
   }
+  nnamed_pools = 0;
 
-  if (uv_cond_init(&cond))
-    abort();
+  cleanup_pool(&default_pool);
+
+  uv_mutex_destroy(&mutex);
+}
+#endif
 
-  if (uv_mutex_init(&mutex))
-    abort();
 
-  QUEUE_INIT(&wq);
-  QUEUE_INIT(&slow_io_pending_wq);
-  QUEUE_INIT(&run_slow_work_message);
+static void init_threads(void) {
+  unsigned int nthreads;
 
-  if (uv_sem_init(&sem, 0))
+  if (uv_mutex_init(&mutex))
     abort();
 
-  for (i = 0; i < nthreads; i++)
-    if (uv_thread_create(threads + i, worker, &sem))
-      abort();
+  /* Named pools are created on first use. */
+  nnamed_pools = 0;
 
-  for (i = 0; i < nthreads; i++)
-    uv_sem_wait(&sem);
+  nthreads = threadpool_size("UV_THREADPOOL_SIZE",
+                             ARRAY_SIZE(default_threads));
+  if (nthreads == 0)
+    nthreads = 1;
 
-  uv_sem_destroy(&sem);
+  if (init_pool(&default_pool,
+                nthreads,
+                default_threads,
+                ARRAY_SIZE(default_threads)) == 0) {
+    init_pool(&default_pool,
+              ARRAY_SIZE(default_threads),
+              default_threads,
+              ARRAY_SIZE(default_threads));
+  }
 }
 
 
@@ -253,16 +396,41 @@ static void init_once(void) {
 }
 
 
+/* File system work runs on the "fs" pool and DNS lookups on the "dns" pool.
+ * Both fall back to the default pool unless their size is configured.
+ */
+static const char* uv__work_pool_name(enum uv__work_kind kind) {
+  switch (kind) {
+  case UV__WORK_FAST_IO:
+    return "fs";
+  case UV__WORK_SLOW_IO:
+    return "dns";
+  default:
+    return NULL;
+  }
+}
+
+
+static void uv__work_submit_pool(uv_loop_t* loop,
+                                 struct uv__work* w,
+                                 enum uv__work_kind kind,
+                                 const char* name,
+                                 void (*work)(struct uv__work* w),
+                                 void (*done)(struct uv__work* w, int status)) {
+  uv_once(&once, init_once);
+  w->loop = loop;
+  w->work = work;
+  w->done = done;
+  post(&w->wq, kind, name);
+}
+
+
 void uv__work_submit(uv_loop_t* loop,
                      struct uv__work* w,
                      enum uv__work_kind kind,
                      void (*work)(struct uv__work* w),
                      void (*done)(struct uv__work* w, int status)) {
-  uv_once(&once, init_once);
-  w->loop = loop;
-  w->work = work;
-  w->done = done;
-  post(&w->wq, kind);
+  uv__work_submit_pool(loop, w, kind, uv__work_pool_name(kind), work, done);
 }
 
 
@@ -339,6 +507,15 @@ int uv_queue_work(uv_loop_t* loop,
                   uv_work_t* req,
                   uv_work_cb work_cb,
                   uv_after_work_cb after_work_cb) {
+  return uv_queue_work_pool(loop, req, NULL, work_cb, after_work_cb);
+}
+
+
+int uv_queue_work_pool(uv_loop_t* loop,
+                       uv_work_t* req,
+                       const char* pool,
+                       uv_work_cb work_cb,
+                       uv_after_work_cb after_work_cb) {
   if (work_cb == NULL)
     return UV_EINVAL;
 
@@ -346,11 +523,12 @@ int uv_queue_work(uv_loop_t* loop,
   req->loop = loop;
   req->work_cb = work_cb;
   req->after_work_cb = after_work_cb;
-  uv__work_submit(loop,
-                  &req->work_req,
-                  UV__WORK_CPU,
-                  uv__queue_work,
-                  uv__queue_done);
+  uv__work_submit_pool(loop,
+                       &req->work_req,
+                       UV__WORK_CPU,
+                       pool,
+                       uv__queue_work,
+                       uv__queue_done);
   return 0;
 }
 
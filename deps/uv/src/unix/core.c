@@ -882,15 +882,27 @@ void uv__io_init(uv__io_t* w, uv__io_cb cb, int fd) {
 
 
 void uv__io_start(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
+  unsigned int started;
+
   assert(0 == (events & ~(POLLIN | POLLOUT | UV__POLLRDHUP | UV__POLLPRI)));
   assert(0 != events);
   assert(w->fd >= 0);
   assert(w->fd < INT_MAX);
 
+  started = events & ~w->pevents;
   w->pevents |= events;
   maybe_resize(loop, w->fd + 1);
 
-#if !defined(__sun)
+#if defined(__linux__)
+  /* The epoll backend stops watching events lazily, see uv__io_poll(), so
+   * the kernel may still be watching the events that are started here. An
+   * edge-triggered watcher has to be re-armed anyway when it starts an event
+   * again, or readiness that was reported while it was stopped is lost.
+   */
+  if ((w->pevents & ~w->events) == 0 &&
+      ((w->events & UV__EPOLLET) == 0 || started == 0))
+    return;
+#elif !defined(__sun)
   /* The event ports backend needs to rearm all file descriptors on each and
    * every tick of the event loop but the other backends allow us to
    * short-circuit here if the event mask is unchanged.
@@ -936,8 +948,13 @@ void uv__io_stop(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
       w->events = 0;
     }
   }
+#if !defined(__linux__)
+  /* The epoll backend keeps watching the stopped events until it gets
+   * one of them, see uv__io_poll().
+   */
   else if (QUEUE_EMPTY(&w->watcher_queue))
     QUEUE_INSERT_TAIL(&loop->watcher_queue, &w->watcher_queue);
+#endif
 }
 
 
@@ -957,6 +974,19 @@ void uv__io_feed(uv_loop_t* loop, uv__io_t* w) {
 }
 
 
+/* Edge-triggered watchers are only told about events when the file descriptor
+ * becomes ready again. Callers that stop handling events while it may still
+ * be ready re-arm the watcher, so that they get those events once more.
+ */
+void uv__io_rearm(uv_loop_t* loop, uv__io_t* w) {
+  if ((w->events & UV__EPOLLET) == 0 || w->pevents == 0)
+    return;
+
+  if (QUEUE_EMPTY(&w->watcher_queue))
+    QUEUE_INSERT_TAIL(&loop->watcher_queue, &w->watcher_queue);
+}
+
+
 int uv__io_active(const uv__io_t* w, unsigned int events) {
   assert(0 == (events & ~(POLLIN | POLLOUT | UV__POLLRDHUP | UV__POLLPRI)));
   assert(0 != events);
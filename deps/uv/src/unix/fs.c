@@ -869,6 +869,63 @@ out:
 }
 
 
+#ifdef __linux__
+/* Copies data between two files inside the kernel. Depending on the file
+ * system this can share extents (like FICLONE) or be done server side (NFS,
+ * CIFS) instead of moving the data through the page cache twice. Sets errno
+ * to ENOSYS when sendfile() should be tried instead.
+ */
+static ssize_t uv__fs_try_copy_file_range(int in_fd,
+                                          off_t* off,
+                                          int out_fd,
+                                          size_t len) {
+  static int no_copy_file_range_support;
+  int64_t off64;
+  ssize_t r;
+
+  if (no_copy_file_range_support) {
+    errno = ENOSYS;
+    return -1;
+  }
+
+  off64 = *off;
+  r = uv__copy_file_range(in_fd, &off64, out_fd, NULL, len, 0);
+
+  /* Some kernels return 0 instead of an error for files in pseudo file
+   * systems like procfs, let sendfile() decide whether this really is EOF.
+   */
+  if (r > 0 || (r == 0 && len == 0)) {
+    *off = off64;
+    return r;
+  }
+
+  if (r == 0) {
+    errno = ENOSYS;
+    return -1;
+  }
+
+  switch (errno) {
+  case ENOSYS:
+    /* Not supported by the kernel, don't try again. */
+    no_copy_file_range_support = 1;
+    break;
+  case EINVAL:   /* Not regular files, or out_fd is opened with O_APPEND. */
+  case EBADF:    /* out_fd is opened with O_APPEND on older kernels. */
+  case EXDEV:    /* Different file systems before Linux 5.3. */
+  case EOPNOTSUPP:
+  case EPERM:    /* Spuriously reported by CIFS. */
+  case EACCES:   /* Spuriously reported by CephFS. */
+  case EIO:
+  case ETXTBSY:
+    errno = ENOSYS;
+    break;
+  }
+
+  return -1;
+}
+#endif  /* __linux__ */
+
+
 static ssize_t uv__fs_sendfile(uv_fs_t* req) {
   int in_fd;
   int out_fd;
@@ -882,6 +939,20 @@ static ssize_t uv__fs_sendfile(uv_fs_t* req) {
     ssize_t r;
 
     off = req->off;
+
+#ifdef __linux__
+    r = uv__fs_try_copy_file_range(in_fd, &off, out_fd, req->bufsml[0].len);
+    if (r != -1) {
+      req->off = off;
+      return r;
+    }
+
+    if (errno != ENOSYS)
+      return -1;
+
+    errno = 0;
+#endif  /* __linux__ */
+
     r = sendfile(out_fd, in_fd, &off, req->bufsml[0].len);
 
     /* sendfile() on SunOS returns EINVAL if the target fd is not a socket but
@@ -1311,6 +1382,32 @@ static void uv__to_stat(struct stat* src, uv_stat_t* dst) {
 }
 
 
+#ifdef __linux__
+void uv__statx_to_stat(const struct uv__statx* statxbuf, uv_stat_t* buf) {
+  buf->st_dev = 256 * statxbuf->stx_dev_major + statxbuf->stx_dev_minor;
+  buf->st_mode = statxbuf->stx_mode;
+  buf->st_nlink = statxbuf->stx_nlink;
+  buf->st_uid = statxbuf->stx_uid;
+  buf->st_gid = statxbuf->stx_gid;
+  buf->st_rdev = statxbuf->stx_rdev_major;
+  buf->st_ino = statxbuf->stx_ino;
+  buf->st_size = statxbuf->stx_size;
+  buf->st_blksize = statxbuf->stx_blksize;
+  buf->st_blocks = statxbuf->stx_blocks;
+  buf->st_atim.tv_sec = statxbuf->stx_atime.tv_sec;
+  buf->st_atim.tv_nsec = statxbuf->stx_atime.tv_nsec;
+  buf->st_mtim.tv_sec = statxbuf->stx_mtime.tv_sec;
+  buf->st_mtim.tv_nsec = statxbuf->stx_mtime.tv_nsec;
+  buf->st_ctim.tv_sec = statxbuf->stx_ctime.tv_sec;
+  buf->st_ctim.tv_nsec = statxbuf->stx_ctime.tv_nsec;
+  buf->st_birthtim.tv_sec = statxbuf->stx_btime.tv_sec;
+  buf->st_birthtim.tv_nsec = statxbuf->stx_btime.tv_nsec;
+  buf->st_flags = 0;
+  buf->st_gen = 0;
+}
+#endif /* __linux__ */
+
+
 static int uv__fs_statx(int fd,
                         const char* path,
                         int is_fstat,
@@ -1362,26 +1459,7 @@ static int uv__fs_statx(int fd,
     return UV_ENOSYS;
   }
 
-  buf->st_dev = 256 * statxbuf.stx_dev_major + statxbuf.stx_dev_minor;
-  buf->st_mode = statxbuf.stx_mode;
-  buf->st_nlink = statxbuf.stx_nlink;
-  buf->st_uid = statxbuf.stx_uid;
-  buf->st_gid = statxbuf.stx_gid;
-  buf->st_rdev = statxbuf.stx_rdev_major;
-  buf->st_ino = statxbuf.stx_ino;
-  buf->st_size = statxbuf.stx_size;
-  buf->st_blksize = statxbuf.stx_blksize;
-  buf->st_blocks = statxbuf.stx_blocks;
-  buf->st_atim.tv_sec = statxbuf.stx_atime.tv_sec;
-  buf->st_atim.tv_nsec = statxbuf.stx_atime.tv_nsec;
-  buf->st_mtim.tv_sec = statxbuf.stx_mtime.tv_sec;
-  buf->st_mtim.tv_nsec = statxbuf.stx_mtime.tv_nsec;
-  buf->st_ctim.tv_sec = statxbuf.stx_ctime.tv_sec;
-  buf->st_ctim.tv_nsec = statxbuf.stx_ctime.tv_nsec;
-  buf->st_birthtim.tv_sec = statxbuf.stx_btime.tv_sec;
-  buf->st_birthtim.tv_nsec = statxbuf.stx_btime.tv_nsec;
-  buf->st_flags = 0;
-  buf->st_gen = 0;
+  uv__statx_to_stat(&statxbuf, buf);
 
   return 0;
 #else
@@ -1624,6 +1702,11 @@ int uv_fs_chown(uv_loop_t* loop,
 int uv_fs_close(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
   INIT(CLOSE);
   req->file = file;
+
+  if (cb != NULL)
+    if (uv__iou_fs_close(loop, req))
+      return 0;
+
   POST;
 }
 
@@ -1671,6 +1754,13 @@ int uv_fs_lchown(uv_loop_t* loop,
 int uv_fs_fdatasync(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
   INIT(FDATASYNC);
   req->file = file;
+
+  if (cb != NULL)
+    if (uv__iou_fs_fsync_or_fdatasync(loop,
+                                      req,
+                                      /* IORING_FSYNC_DATASYNC */ 1))
+      return 0;
+
   POST;
 }
 
@@ -1678,6 +1768,11 @@ int uv_fs_fdatasync(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
 int uv_fs_fstat(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
   INIT(FSTAT);
   req->file = file;
+
+  if (cb != NULL)
+    if (uv__iou_fs_statx(loop, req, /* is_fstat */ 1, /* is_lstat */ 0))
+      return 0;
+
   POST;
 }
 
@@ -1685,6 +1780,11 @@ int uv_fs_fstat(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
 int uv_fs_fsync(uv_loop_t* loop, uv_fs_t* req, uv_file file, uv_fs_cb cb) {
   INIT(FSYNC);
   req->file = file;
+
+  if (cb != NULL)
+    if (uv__iou_fs_fsync_or_fdatasync(loop, req, /* no flags */ 0))
+      return 0;
+
   POST;
 }
 
@@ -1718,6 +1818,11 @@ int uv_fs_futime(uv_loop_t* loop,
 int uv_fs_lstat(uv_loop_t* loop, uv_fs_t* req, const char* path, uv_fs_cb cb) {
   INIT(LSTAT);
   PATH;
+
+  if (cb != NULL)
+    if (uv__iou_fs_statx(loop, req, /* is_fstat */ 0, /* is_lstat */ 1))
+      return 0;
+
   POST;
 }
 
@@ -1779,6 +1884,11 @@ int uv_fs_open(uv_loop_t* loop,
   PATH;
   req->flags = flags;
   req->mode = mode;
+
+  if (cb != NULL)
+    if (uv__iou_fs_open(loop, req))
+      return 0;
+
   POST;
 }
 
@@ -1807,6 +1917,11 @@ int uv_fs_read(uv_loop_t* loop, uv_fs_t* req,
   memcpy(req->bufs, bufs, nbufs * sizeof(*bufs));
 
   req->off = off;
+
+  if (cb != NULL)
+    if (uv__iou_fs_read_or_write(loop, req, /* is_read */ 1))
+      return 0;
+
   POST;
 }
 
@@ -1914,6 +2029,11 @@ int uv_fs_sendfile(uv_loop_t* loop,
 int uv_fs_stat(uv_loop_t* loop, uv_fs_t* req, const char* path, uv_fs_cb cb) {
   INIT(STAT);
   PATH;
+
+  if (cb != NULL)
+    if (uv__iou_fs_statx(loop, req, /* is_fstat */ 0, /* is_lstat */ 0))
+      return 0;
+
   POST;
 }
 
@@ -1977,6 +2097,11 @@ int uv_fs_write(uv_loop_t* loop,
   memcpy(req->bufs, bufs, nbufs * sizeof(*bufs));
 
   req->off = off;
+
+  if (cb != NULL)
+    if (uv__iou_fs_read_or_write(loop, req, /* is_read */ 0))
+      return 0;
+
   POST;
 }
 
@@ -125,6 +125,15 @@ int uv__pthread_sigmask(int how, const sigset_t* set, sigset_t* oset);
 # define UV__POLLPRI 0
 #endif
 
+/* Set in uv__io_t.events by the epoll backend for edge-triggered watchers,
+ * see UV_LOOP_EDGE_TRIGGERED. Equal to EPOLLET.
+ */
+#if defined(__linux__)
+# define UV__EPOLLET 0x80000000u
+#else
+# define UV__EPOLLET 0
+#endif
+
 #if !defined(O_CLOEXEC) && defined(__FreeBSD__)
 /*
  * It may be that we are just missing `__POSIX_VISIBLE >= 200809`.
@@ -203,6 +212,7 @@ void uv__io_start(uv_loop_t* loop, uv__io_t* w, unsigned int events);
 void uv__io_stop(uv_loop_t* loop, uv__io_t* w, unsigned int events);
 void uv__io_close(uv_loop_t* loop, uv__io_t* w);
 void uv__io_feed(uv_loop_t* loop, uv__io_t* w);
+void uv__io_rearm(uv_loop_t* loop, uv__io_t* w);
 int uv__io_active(const uv__io_t* w, unsigned int events);
 int uv__io_check_fd(uv_loop_t* loop, int fd);
 void uv__io_poll(uv_loop_t* loop, int timeout); /* in milliseconds or -1 */
@@ -228,6 +238,7 @@ void uv__stream_destroy(uv_stream_t* stream);
 int uv__stream_try_select(uv_stream_t* stream, int* fd);
 #endif /* defined(__APPLE__) */
 void uv__server_io(uv_loop_t* loop, uv__io_t* w, unsigned int events);
+void uv__stream_io(uv_loop_t* loop, uv__io_t* w, unsigned int events);
 int uv__accept(int sockfd);
 int uv__dup2_cloexec(int oldfd, int newfd);
 int uv__open_cloexec(const char* path, int flags);
@@ -319,6 +330,38 @@ UV_UNUSED(static char* uv__basename_r(const char* path)) {
 
 #if defined(__linux__)
 int uv__inotify_fork(uv_loop_t* loop, void* old_watchers);
+
+/* Loop state that does not fit into uv_loop_t without changing its size.
+ * It is allocated on first use and kept in loop->internal_fields until the
+ * loop is closed, so it survives uv_loop_fork().
+ */
+struct uv__loop_internal_fields_s {
+  struct uv__iou* iou;  /* See linux-iouring.c. */
+  uint64_t busy_poll_ns;  /* See UV_LOOP_BUSY_POLL. */
+  int edge_triggered;  /* See UV_LOOP_EDGE_TRIGGERED. */
+};
+struct uv__loop_internal_fields_s* uv__loop_internal_fields(uv_loop_t* loop);
+void uv__loop_internal_fields_delete(uv_loop_t* loop);
+
+/* io_uring */
+void uv__iou_loop_delete(uv_loop_t* loop);
+int uv__iou_fs_close(uv_loop_t* loop, uv_fs_t* req);
+int uv__iou_fs_fsync_or_fdatasync(uv_loop_t* loop,
+                                  uv_fs_t* req,
+                                  uint32_t fsync_flags);
+int uv__iou_fs_open(uv_loop_t* loop, uv_fs_t* req);
+int uv__iou_fs_read_or_write(uv_loop_t* loop, uv_fs_t* req, int is_read);
+int uv__iou_fs_statx(uv_loop_t* loop,
+                     uv_fs_t* req,
+                     int is_fstat,
+                     int is_lstat);
+void uv__statx_to_stat(const struct uv__statx* statxbuf, uv_stat_t* buf);
+#else
+#define uv__iou_fs_close(loop, req) 0
+#define uv__iou_fs_fsync_or_fdatasync(loop, req, fsync_flags) 0
+#define uv__iou_fs_open(loop, req) 0
+#define uv__iou_fs_read_or_write(loop, req, is_read) 0
+#define uv__iou_fs_statx(loop, req, is_fstat, is_lstat) 0
 #endif
 
 typedef int (*uv__peersockfunc)(int, struct sockaddr*, socklen_t*);
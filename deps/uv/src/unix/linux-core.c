@@ -75,6 +75,8 @@
 # define CLOCK_BOOTTIME 7
 #endif
 
+STATIC_ASSERT(UV__EPOLLET == EPOLLET);
+
 static int read_models(unsigned int numcpus, uv_cpu_info_t* ci);
 static int read_times(FILE* statfile_fp,
                       unsigned int numcpus,
@@ -137,6 +139,8 @@ int uv__io_fork(uv_loop_t* loop) {
 
 
 void uv__platform_loop_delete(uv_loop_t* loop) {
+  uv__iou_loop_delete(loop);
+
   if (loop->inotify_fd == -1) return;
   uv__io_stop(loop, &loop->inotify_read_watcher, POLLIN);
   uv__close(loop->inotify_fd);
@@ -144,6 +148,39 @@ void uv__platform_loop_delete(uv_loop_t* loop) {
 }
 
 
+struct uv__loop_internal_fields_s* uv__loop_internal_fields(uv_loop_t* loop) {
+  if (loop->internal_fields == NULL)
+    loop->internal_fields =
+        uv__calloc(1, sizeof(struct uv__loop_internal_fields_s));
+
+  return loop->internal_fields;
+}
+
+
+void uv__loop_internal_fields_delete(uv_loop_t* loop) {
+  uv__free(loop->internal_fields);
+  loop->internal_fields = NULL;
+}
+
+
+/* TCP streams read until the socket is drained and write until EAGAIN, and
+ * re-arm their watcher with uv__io_rearm() when they stop early, so they can
+ * be edge-triggered. A short read that stopped at the end of input is
+ * followed up with EPOLLRDHUP. Pipes and TTYs can't be: a short read doesn't
+ * mean that they're drained when a message carries file descriptors, or when
+ * a TTY is in canonical mode.
+ */
+static int uv__io_can_use_et(uv__io_t* w) {
+  uv_stream_t* stream;
+
+  if (w->cb != uv__stream_io)
+    return 0;
+
+  stream = container_of(w, uv_stream_t, io_watcher);
+  return stream->type == UV_TCP;
+}
+
+
 void uv__platform_invalidate_fd(uv_loop_t* loop, int fd) {
   struct epoll_event* events;
   struct epoll_event dummy;
@@ -210,10 +247,13 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
   static const int max_safe_timeout = 1789569;
   static int no_epoll_pwait;
   static int no_epoll_wait;
+  struct uv__loop_internal_fields_s* fields;
   struct epoll_event events[1024];
   struct epoll_event* pe;
   struct epoll_event e;
   int real_timeout;
+  int poll_timeout;
+  uint64_t spin_until;
   QUEUE* q;
   uv__io_t* w;
   sigset_t sigset;
@@ -233,6 +273,7 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
   }
 
   memset(&e, 0, sizeof(e));
+  fields = loop->internal_fields;
 
   while (!QUEUE_EMPTY(&loop->watcher_queue)) {
     q = QUEUE_HEAD(&loop->watcher_queue);
@@ -247,13 +288,17 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
     e.events = w->pevents;
     e.data.fd = w->fd;
 
+    if (fields != NULL && fields->edge_triggered && uv__io_can_use_et(w))
+      e.events |= EPOLLET | EPOLLRDHUP;
+
     if (w->events == 0)
       op = EPOLL_CTL_ADD;
     else
       op = EPOLL_CTL_MOD;
 
-    /* XXX Future optimization: do EPOLL_CTL_MOD lazily if we stop watching
-     * events, skip the syscall and squelch the events after epoll_wait().
+    /* Stopped events are not removed here, see uv__io_stop(). They are
+     * squelched after epoll_wait() instead, and only removed from the kernel's
+     * interest list when a level-triggered watcher gets one of them.
      */
     if (epoll_ctl(loop->backend_fd, op, w->fd, &e)) {
       if (errno != EEXIST)
@@ -266,7 +311,7 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
         abort();
     }
 
-    w->events = w->pevents;
+    w->events = e.events;
   }
 
   sigmask = 0;
@@ -281,6 +326,13 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
   count = 48; /* Benchmarks suggest this gives the best throughput. */
   real_timeout = timeout;
 
+  /* With UV_LOOP_BUSY_POLL, poll without blocking until the budget is used
+   * up, and only then block for the rest of the timeout.
+   */
+  spin_until = 0;
+  if (fields != NULL && fields->busy_poll_ns != 0 && timeout != 0)
+    spin_until = uv__hrtime(UV_CLOCK_PRECISE) + fields->busy_poll_ns;
+
   for (;;) {
     /* See the comment for max_safe_timeout for an explanation of why
      * this is necessary.  Executive summary: kernel bug workaround.
@@ -288,6 +340,8 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
     if (sizeof(int32_t) == sizeof(long) && timeout >= max_safe_timeout)
       timeout = max_safe_timeout;
 
+    poll_timeout = spin_until != 0 ? 0 : timeout;
+
     if (sigmask != 0 && no_epoll_pwait != 0)
       if (pthread_sigmask(SIG_BLOCK, &sigset, NULL))
         abort();
@@ -300,7 +354,7 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
       nfds = epoll_pwait(loop->backend_fd,
                          events,
                          ARRAY_SIZE(events),
-                         timeout,
+                         poll_timeout,
                          &sigset);
 #endif
       if (nfds == -1 && errno == ENOSYS)
@@ -309,7 +363,7 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
       nfds = epoll_wait(loop->backend_fd,
                         events,
                         ARRAY_SIZE(events),
-                        timeout);
+                        poll_timeout);
       if (nfds == -1 && errno == ENOSYS)
         no_epoll_wait = 1;
     }
@@ -324,6 +378,18 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
      */
     SAVE_ERRNO(uv__update_time(loop));
 
+    if (nfds == 0 && spin_until != 0) {
+      if (uv__hrtime(UV_CLOCK_PRECISE) < spin_until)
+        continue;
+
+      /* The budget is used up, block from now on. */
+      spin_until = 0;
+      if (timeout == -1)
+        continue;
+
+      goto update_timeout;
+    }
+
     if (nfds == 0) {
       assert(timeout != -1);
 
@@ -395,12 +461,26 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
         continue;
       }
 
+      /* Stop watching the events that were stopped since the file descriptor
+       * was last registered, or epoll keeps reporting them. An edge-triggered
+       * watcher gets them only once per edge, so it can keep watching them.
+       */
+      if ((pe->events & ~(w->pevents | POLLERR | POLLHUP)) != 0 &&
+          (w->events & UV__EPOLLET) == 0) {
+        e.events = w->pevents;
+        e.data.fd = fd;
+        if (epoll_ctl(loop->backend_fd, EPOLL_CTL_MOD, fd, &e) == 0)
+          w->events = w->pevents;
+      }
+
       /* Give users only events they're interested in. Prevents spurious
        * callbacks when previous callback invocation in this loop has stopped
        * the current watcher. Also, filters out events that users has not
-       * requested us to watch.
+       * requested us to watch. Edge-triggered streams also get EPOLLRDHUP,
+       * see uv__stream_io().
        */
-      pe->events &= w->pevents | POLLERR | POLLHUP;
+      pe->events &= w->pevents | POLLERR | POLLHUP |
+                    ((w->events & UV__EPOLLET) ? UV__POLLRDHUP : 0);
 
       /* Work around an epoll quirk where it sometimes reports just the
        * EPOLLERR or EPOLLHUP event.  In order to force the event loop to
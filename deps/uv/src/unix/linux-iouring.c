@@ -0,0 +1,551 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/* io_uring submission path for file system requests.
+ *
+ * Asynchronous uv_fs_read(), uv_fs_write(), uv_fs_open(), uv_fs_close(),
+ * uv_fs_fsync(), uv_fs_fdatasync() and the uv_fs_*stat() family are handed
+ * to the kernel through a per-loop submission ring instead of the thread
+ * pool when the kernel is recent enough. The ring file descriptor is watched
+ * by the loop's epoll instance and completions are reaped in uv__io_poll().
+ *
+ * Requests that cannot be submitted (ring full, unsupported flags, old
+ * kernel, UV_USE_IO_URING=0 in the environment) silently take the regular
+ * thread pool route.
+ */
+
+#include "uv.h"
+#include "internal.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/mman.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#define UV__IORING_OP_READV 1u
+#define UV__IORING_OP_WRITEV 2u
+#define UV__IORING_OP_FSYNC 3u
+#define UV__IORING_OP_OPENAT 18u
+#define UV__IORING_OP_CLOSE 19u
+#define UV__IORING_OP_STATX 21u
+
+#define UV__IORING_FEAT_SINGLE_MMAP 1u
+#define UV__IORING_FEAT_NODROP 2u
+#define UV__IORING_FEAT_RW_CUR_POS 8u
+
+#define UV__IORING_OFF_SQ_RING 0x00000000ull
+#define UV__IORING_OFF_SQES 0x10000000ull
+
+#define UV__STATX_BASIC_STATS_AND_BTIME 0xFFFu
+#define UV__AT_EMPTY_PATH 0x1000
+
+/* Number of submission queue entries. The kernel sizes the completion queue
+ * at twice this number and we never have more than this many requests in
+ * flight, so completions cannot overflow.
+ */
+#define UV__IOU_ENTRIES 64
+
+STATIC_ASSERT(40 == sizeof(struct uv__io_sqring_offsets));
+STATIC_ASSERT(40 == sizeof(struct uv__io_cqring_offsets));
+STATIC_ASSERT(120 == sizeof(struct uv__io_uring_params));
+STATIC_ASSERT(64 == sizeof(struct uv__io_uring_sqe));
+STATIC_ASSERT(16 == sizeof(struct uv__io_uring_cqe));
+
+struct uv__iou {
+  uv__io_t io_watcher;
+  uint32_t* sqhead;
+  uint32_t* sqtail;
+  uint32_t* sqarray;
+  uint32_t sqmask;
+  uint32_t sqentries;
+  uint32_t* cqhead;
+  uint32_t* cqtail;
+  uint32_t cqmask;
+  struct uv__io_uring_cqe* cqe;
+  struct uv__io_uring_sqe* sqe;
+  void* ring;
+  size_t ringlen;
+  size_t sqelen;
+  uint32_t features;
+  unsigned int in_flight;
+  int ringfd;
+};
+
+static uv_once_t uv__iou_once = UV_ONCE_INIT;
+static int uv__iou_enabled;
+
+
+static void uv__iou_init_once(void) {
+  struct utsname u;
+  unsigned int major;
+  unsigned int minor;
+  const char* val;
+
+  val = getenv("UV_USE_IO_URING");
+  if (val != NULL && atoi(val) == 0)
+    return;
+
+  /* 5.10 is the first LTS kernel that supports every opcode we use,
+   * IORING_FEAT_RW_CUR_POS included, and doesn't charge the rings against
+   * RLIMIT_MEMLOCK in surprising ways.
+   */
+  if (uname(&u))
+    return;
+
+  if (2 != sscanf(u.release, "%u.%u", &major, &minor))
+    return;
+
+  uv__iou_enabled = major > 5 || (major == 5 && minor >= 10);
+}
+
+
+static void uv__iou_io(uv_loop_t* loop, uv__io_t* w, unsigned int events);
+
+
+static void uv__iou_new(uv_loop_t* loop, struct uv__iou* iou) {
+  struct uv__io_uring_params params;
+  size_t sqelen;
+  size_t sqlen;
+  size_t cqlen;
+  char* ring;
+  char* sqe;
+  int ringfd;
+
+  iou->ringfd = -1;
+
+  memset(&params, 0, sizeof(params));
+  ringfd = uv__io_uring_setup(UV__IOU_ENTRIES, &params);
+  if (ringfd == -1)
+    return;
+
+  /* Refuse kernels that don't map the submission and completion rings in one
+   * go or that can drop completions when the completion ring overflows.
+   */
+  if (!(params.features & UV__IORING_FEAT_SINGLE_MMAP) ||
+      !(params.features & UV__IORING_FEAT_NODROP)) {
+    uv__close(ringfd);
+    return;
+  }
+
+  sqlen = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cqlen = params.cq_off.cqes +
+          params.cq_entries * sizeof(struct uv__io_uring_cqe);
+  if (cqlen > sqlen)
+    sqlen = cqlen;
+
+  ring = mmap(NULL,
+              sqlen,
+              PROT_READ | PROT_WRITE,
+              MAP_SHARED | MAP_POPULATE,
+              ringfd,
+              UV__IORING_OFF_SQ_RING);
+
+  sqelen = params.sq_entries * sizeof(struct uv__io_uring_sqe);
+  sqe = mmap(NULL,
+             sqelen,
+             PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE,
+             ringfd,
+             UV__IORING_OFF_SQES);
+
+  if (ring == MAP_FAILED || sqe == MAP_FAILED) {
+    if (ring != MAP_FAILED)
+      munmap(ring, sqlen);
+    if (sqe != MAP_FAILED)
+      munmap(sqe, sqelen);
+    uv__close(ringfd);
+    return;
+  }
+
+  iou->sqhead = (uint32_t*) (ring + params.sq_off.head);
+  iou->sqtail = (uint32_t*) (ring + params.sq_off.tail);
+  iou->sqarray = (uint32_t*) (ring + params.sq_off.array);
+  iou->sqmask = *(uint32_t*) (ring + params.sq_off.ring_mask);
+  iou->sqentries = *(uint32_t*) (ring + params.sq_off.ring_entries);
+  iou->cqhead = (uint32_t*) (ring + params.cq_off.head);
+  iou->cqtail = (uint32_t*) (ring + params.cq_off.tail);
+  iou->cqmask = *(uint32_t*) (ring + params.cq_off.ring_mask);
+  iou->cqe = (struct uv__io_uring_cqe*) (ring + params.cq_off.cqes);
+  iou->sqe = (struct uv__io_uring_sqe*) sqe;
+  iou->ring = ring;
+  iou->ringlen = sqlen;
+  iou->sqelen = sqelen;
+  iou->features = params.features;
+  iou->in_flight = 0;
+  iou->ringfd = ringfd;
+
+  /* The ring file descriptor is close-on-exec by default. It polls readable
+   * while there are unreaped completions.
+   */
+  uv__io_init(&iou->io_watcher, uv__iou_io, ringfd);
+  uv__io_start(loop, &iou->io_watcher, POLLIN);
+}
+
+
+static struct uv__iou* uv__iou_get(uv_loop_t* loop) {
+  struct uv__loop_internal_fields_s* fields;
+  struct uv__iou* iou;
+
+  uv_once(&uv__iou_once, uv__iou_init_once);
+  if (!uv__iou_enabled)
+    return NULL;
+
+  /* The ring is created lazily so that loops that never touch the file
+   * system don't pay for it. A failed setup is remembered for the lifetime
+   * of the loop.
+   */
+  fields = uv__loop_internal_fields(loop);
+  if (fields == NULL)
+    return NULL;
+
+  iou = fields->iou;
+  if (iou == NULL) {
+    iou = uv__malloc(sizeof(*iou));
+    if (iou == NULL)
+      return NULL;
+
+    uv__iou_new(loop, iou);
+    fields->iou = iou;
+  }
+
+  if (iou->ringfd == -1)
+    return NULL;
+
+  return iou;
+}
+
+
+/* Also called by uv__io_fork(). The child must not share the ring with its
+ * parent, it gets a new one the next time it submits a request. Requests that
+ * were in flight at the time of the fork only complete in the parent.
+ */
+void uv__iou_loop_delete(uv_loop_t* loop) {
+  struct uv__loop_internal_fields_s* fields;
+  struct uv__iou* iou;
+
+  fields = loop->internal_fields;
+  if (fields == NULL || fields->iou == NULL)
+    return;
+
+  iou = fields->iou;
+
+  if (iou->ringfd != -1) {
+    uv__io_stop(loop, &iou->io_watcher, POLLIN);
+    munmap(iou->sqe, iou->sqelen);
+    munmap(iou->ring, iou->ringlen);
+    uv__close(iou->ringfd);
+  }
+
+  uv__free(iou);
+  fields->iou = NULL;
+}
+
+
+static struct uv__io_uring_sqe* uv__iou_get_sqe(struct uv__iou* iou,
+                                                uv_loop_t* loop,
+                                                uv_fs_t* req) {
+  struct uv__io_uring_sqe* sqe;
+  uint32_t head;
+  uint32_t tail;
+  uint32_t slot;
+
+  if (iou->in_flight >= iou->sqentries)
+    return NULL;
+
+  head = __atomic_load_n(iou->sqhead, __ATOMIC_ACQUIRE);
+  tail = *iou->sqtail;
+  if (tail - head >= iou->sqentries)
+    return NULL;
+
+  slot = tail & iou->sqmask;
+  sqe = &iou->sqe[slot];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->user_data = (uintptr_t) req;
+  iou->sqarray[slot] = slot;
+
+  /* Make uv_cancel() return UV_EBUSY, the request can't be taken back once
+   * the kernel owns it.
+   */
+  req->work_req.loop = loop;
+  req->work_req.work = NULL;
+  req->work_req.done = NULL;
+  QUEUE_INIT(&req->work_req.wq);
+
+  uv__req_register(loop, req);
+  iou->in_flight++;
+
+  return sqe;
+}
+
+
+/* Returns 0 if the kernel did not take the entry, the caller then hands the
+ * request to the thread pool. Nothing else would ever submit the entry or
+ * complete the request otherwise, and the loop would wait for it forever.
+ */
+static int uv__iou_submit(struct uv__iou* iou, uv_loop_t* loop, uv_fs_t* req) {
+  uint32_t tail;
+  int rc;
+
+  tail = *iou->sqtail;
+  __atomic_store_n(iou->sqtail, tail + 1, __ATOMIC_RELEASE);
+
+  do
+    rc = uv__io_uring_enter(iou->ringfd, 1, 0, 0);
+  while (rc == -1 && errno == EINTR);
+
+  /* Without IORING_SETUP_SQPOLL the kernel only consumes entries from within
+   * io_uring_enter(). Once it has moved the head past the entry, it posts a
+   * completion for it, even if the call itself failed.
+   */
+  if (rc == 1 || __atomic_load_n(iou->sqhead, __ATOMIC_ACQUIRE) != tail)
+    return 1;
+
+  __atomic_store_n(iou->sqtail, tail, __ATOMIC_RELEASE);
+  uv__req_unregister(loop, req);
+  iou->in_flight--;
+
+  return 0;
+}
+
+
+static void uv__iou_fs_done(uv_fs_t* req, int res) {
+  struct uv__statx* statxbuf;
+
+  uv__req_unregister(req->loop, req);
+  req->result = res;
+
+  switch (req->fs_type) {
+    case UV_FS_CLOSE:
+      if (res == UV__ERR(EINTR) || res == UV__ERR(EINPROGRESS))
+        req->result = 0;  /* The close is in progress, not an error. */
+      break;
+
+    case UV_FS_READ:
+    case UV_FS_WRITE:
+      if (req->bufs != req->bufsml)
+        uv__free(req->bufs);
+      req->bufs = NULL;
+      break;
+
+    case UV_FS_STAT:
+    case UV_FS_LSTAT:
+    case UV_FS_FSTAT:
+      statxbuf = req->ptr;
+      req->ptr = NULL;
+      if (res == 0) {
+        uv__statx_to_stat(statxbuf, &req->statbuf);
+        req->ptr = &req->statbuf;
+      }
+      uv__free(statxbuf);
+      break;
+
+    default:
+      break;
+  }
+
+  req->cb(req);
+}
+
+
+static void uv__iou_io(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
+  struct uv__io_uring_cqe* cqe;
+  struct uv__iou* iou;
+  uv_fs_t* req;
+  uint32_t head;
+  uint32_t tail;
+  int res;
+
+  iou = container_of(w, struct uv__iou, io_watcher);
+
+  for (;;) {
+    head = *iou->cqhead;
+    tail = __atomic_load_n(iou->cqtail, __ATOMIC_ACQUIRE);
+    if (head == tail)
+      break;
+
+    cqe = &iou->cqe[head & iou->cqmask];
+    req = (uv_fs_t*) (uintptr_t) cqe->user_data;
+    res = cqe->res;
+
+    /* Release the slot before running the callback, it may submit more. */
+    __atomic_store_n(iou->cqhead, head + 1, __ATOMIC_RELEASE);
+    iou->in_flight--;
+
+    uv__iou_fs_done(req, res);
+  }
+}
+
+
+int uv__iou_fs_close(uv_loop_t* loop, uv_fs_t* req) {
+  struct uv__io_uring_sqe* sqe;
+  struct uv__iou* iou;
+
+  iou = uv__iou_get(loop);
+  if (iou == NULL)
+    return 0;
+
+  sqe = uv__iou_get_sqe(iou, loop, req);
+  if (sqe == NULL)
+    return 0;
+
+  sqe->fd = req->file;
+  sqe->opcode = UV__IORING_OP_CLOSE;
+
+  return uv__iou_submit(iou, loop, req);
+}
+
+
+int uv__iou_fs_fsync_or_fdatasync(uv_loop_t* loop,
+                                  uv_fs_t* req,
+                                  uint32_t fsync_flags) {
+  struct uv__io_uring_sqe* sqe;
+  struct uv__iou* iou;
+
+  iou = uv__iou_get(loop);
+  if (iou == NULL)
+    return 0;
+
+  sqe = uv__iou_get_sqe(iou, loop, req);
+  if (sqe == NULL)
+    return 0;
+
+  /* Leave sqe->off and sqe->len at zero, that syncs the whole file. */
+  sqe->fd = req->file;
+  sqe->op_flags = fsync_flags;
+  sqe->opcode = UV__IORING_OP_FSYNC;
+
+  return uv__iou_submit(iou, loop, req);
+}
+
+
+int uv__iou_fs_open(uv_loop_t* loop, uv_fs_t* req) {
+  struct uv__io_uring_sqe* sqe;
+  struct uv__iou* iou;
+
+  iou = uv__iou_get(loop);
+  if (iou == NULL)
+    return 0;
+
+  sqe = uv__iou_get_sqe(iou, loop, req);
+  if (sqe == NULL)
+    return 0;
+
+  sqe->addr = (uintptr_t) req->path;
+  sqe->fd = AT_FDCWD;
+  sqe->len = req->mode;
+  sqe->op_flags = req->flags | O_CLOEXEC;
+  sqe->opcode = UV__IORING_OP_OPENAT;
+
+  return uv__iou_submit(iou, loop, req);
+}
+
+
+int uv__iou_fs_read_or_write(uv_loop_t* loop, uv_fs_t* req, int is_read) {
+  struct uv__io_uring_sqe* sqe;
+  struct uv__iou* iou;
+  unsigned int iovmax;
+
+  iou = uv__iou_get(loop);
+  if (iou == NULL)
+    return 0;
+
+  /* Reads and writes at the current file position need kernel support. */
+  if (req->off < 0 && !(iou->features & UV__IORING_FEAT_RW_CUR_POS))
+    return 0;
+
+  /* uv__fs_write_all() splits large vectors into several writes. Leave that
+   * to the thread pool, a single ring entry can't express it.
+   */
+  iovmax = uv__getiovmax();
+  if (req->nbufs > iovmax) {
+    if (!is_read)
+      return 0;
+    req->nbufs = iovmax;
+  }
+
+  sqe = uv__iou_get_sqe(iou, loop, req);
+  if (sqe == NULL)
+    return 0;
+
+  sqe->addr = (uintptr_t) req->bufs;
+  sqe->fd = req->file;
+  sqe->len = req->nbufs;
+  sqe->off = req->off < 0 ? -1 : req->off;
+  sqe->opcode = is_read ? UV__IORING_OP_READV : UV__IORING_OP_WRITEV;
+
+  return uv__iou_submit(iou, loop, req);
+}
+
+
+int uv__iou_fs_statx(uv_loop_t* loop,
+                     uv_fs_t* req,
+                     int is_fstat,
+                     int is_lstat) {
+  struct uv__io_uring_sqe* sqe;
+  struct uv__statx* statxbuf;
+  struct uv__iou* iou;
+
+  iou = uv__iou_get(loop);
+  if (iou == NULL)
+    return 0;
+
+  statxbuf = uv__malloc(sizeof(*statxbuf));
+  if (statxbuf == NULL)
+    return 0;
+
+  sqe = uv__iou_get_sqe(iou, loop, req);
+  if (sqe == NULL) {
+    uv__free(statxbuf);
+    return 0;
+  }
+
+  req->ptr = statxbuf;
+
+  sqe->addr = (uintptr_t) req->path;
+  sqe->off = (uintptr_t) statxbuf;  /* addr2 */
+  sqe->fd = AT_FDCWD;
+  sqe->len = UV__STATX_BASIC_STATS_AND_BTIME;
+  sqe->opcode = UV__IORING_OP_STATX;
+
+  if (is_fstat) {
+    sqe->addr = (uintptr_t) "";
+    sqe->fd = req->file;
+    sqe->op_flags |= UV__AT_EMPTY_PATH;
+  }
+
+  if (is_lstat)
+    sqe->op_flags |= AT_SYMLINK_NOFOLLOW;
+
+  if (!uv__iou_submit(iou, loop, req)) {
+    req->ptr = NULL;
+    uv__free(statxbuf);
+    return 0;
+  }
+
+  return 1;
+}
@@ -179,10 +179,36 @@ void uv__loop_close(uv_loop_t* loop) {
   uv__free(loop->watchers);
   loop->watchers = NULL;
   loop->nwatchers = 0;
+
+#if defined(__linux__)
+  uv__loop_internal_fields_delete(loop);
+#endif
 }
 
 
 int uv__loop_configure(uv_loop_t* loop, uv_loop_option option, va_list ap) {
+#if defined(__linux__)
+  struct uv__loop_internal_fields_s* fields;
+
+  if (option == UV_LOOP_BUSY_POLL) {
+    fields = uv__loop_internal_fields(loop);
+    if (fields == NULL)
+      return UV_ENOMEM;
+
+    fields->busy_poll_ns = (uint64_t) va_arg(ap, unsigned int) * 1000;
+    return 0;
+  }
+
+  if (option == UV_LOOP_EDGE_TRIGGERED) {
+    fields = uv__loop_internal_fields(loop);
+    if (fields == NULL)
+      return UV_ENOMEM;
+
+    fields->edge_triggered = 1;
+    return 0;
+  }
+#endif
+
   if (option != UV_LOOP_BLOCK_SIGNAL)
     return UV_ENOSYS;
 
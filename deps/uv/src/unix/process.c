@@ -44,6 +44,14 @@ extern char **environ;
 # include <grp.h>
 #endif
 
+#if defined(__linux__)
+# include <sched.h>
+# include <signal.h>
+# include <string.h>
+# include <sys/mman.h>
+# define UV__PROCESS_CLONE 1
+#endif
+
 
 static void uv__chld(uv_signal_t* handle, int signum) {
   uv_process_t* process;
@@ -267,15 +275,90 @@ static void uv__write_int(int fd, int val) {
 }
 
 
+#if defined(UV__PROCESS_CLONE)
+/* Like execvp(), but looks up the file in the PATH of `env`, which is what
+ * execvp() does after `environ = env` in a forked child. The child of a
+ * clone(CLONE_VM) shares `environ` with the parent, so it cannot do that.
+ * Scripts without a #! line fail with ENOEXEC instead of being run by
+ * /bin/sh; uv_spawn() retries those with fork().
+ */
+static void uv__execvpe(const char* file, char* const* argv, char* const* env) {
+  char path[4096];
+  char* const* var;
+  const char* search;
+  const char* end;
+  size_t file_len;
+  size_t dir_len;
+  int seen_eacces;
+
+  if (strchr(file, '/') != NULL) {
+    execve(file, argv, env);
+    return;
+  }
+
+  search = "/bin:/usr/bin";
+  for (var = env; *var != NULL; var++) {
+    if (strncmp(*var, "PATH=", 5) == 0) {
+      search = *var + 5;
+      break;
+    }
+  }
+
+  seen_eacces = 0;
+  file_len = strlen(file);
+  for (;; search = end + 1) {
+    end = strchr(search, ':');
+    if (end == NULL)
+      end = search + strlen(search);
+
+    /* An empty entry stands for the current directory. */
+    dir_len = end - search;
+    if (dir_len + file_len + 2 <= sizeof(path)) {
+      memcpy(path, search, dir_len);
+      if (dir_len > 0)
+        path[dir_len++] = '/';
+      memcpy(path + dir_len, file, file_len + 1);
+      execve(path, argv, env);
+
+      switch (errno) {
+        case EACCES:
+          seen_eacces = 1;
+          break;
+        case ENOENT:
+        case ENOTDIR:
+        case ENODEV:
+        case ESTALE:
+        case ETIMEDOUT:
+          break;
+        default:
+          return;
+      }
+    }
+
+    if (*end == '\0')
+      break;
+  }
+
+  if (seen_eacces)
+    errno = EACCES;
+}
+#endif
+
+
 #if !(defined(__APPLE__) && (TARGET_OS_TV || TARGET_OS_WATCH))
 /* execvp is marked __WATCHOS_PROHIBITED __TVOS_PROHIBITED, so must be
  * avoided. Since this isn't called on those targets, the function
  * doesn't even need to be defined for them.
+ *
+ * `shared_vm` is set when the child shares its memory with the parent, see
+ * uv__process_clone(). The child must then not write to anything the parent
+ * uses, and any signal handler it inherits would run on the parent's memory.
  */
 static void uv__process_child_init(const uv_process_options_t* options,
                                    int stdio_count,
                                    int (*pipes)[2],
-                                   int error_fd) {
+                                   int error_fd,
+                                   int shared_vm) {
   sigset_t set;
   int close_fd;
   int use_fd;
@@ -372,7 +455,7 @@ static void uv__process_child_init(const uv_process_options_t* options,
     _exit(127);
   }
 
-  if (options->env != NULL) {
+  if (options->env != NULL && !shared_vm) {
     environ = options->env;
   }
 
@@ -397,6 +480,13 @@ static void uv__process_child_init(const uv_process_options_t* options,
     _exit(127);
   }
 
+#if defined(UV__PROCESS_CLONE)
+  /* The RT signals that glibc reserves come before SIGRTMIN. */
+  if (shared_vm)
+    for (n = SIGRTMIN; n <= SIGRTMAX; n += 1)
+      signal(n, SIG_DFL);
+#endif
+
   /* Reset signal mask. */
   sigemptyset(&set);
   err = pthread_sigmask(SIG_SETMASK, &set, NULL);
@@ -406,65 +496,121 @@ static void uv__process_child_init(const uv_process_options_t* options,
     _exit(127);
   }
 
+#if defined(UV__PROCESS_CLONE)
+  if (shared_vm)
+    uv__execvpe(options->file,
+                options->args,
+                options->env != NULL ? options->env : environ);
+  else
+#endif
   execvp(options->file, options->args);
   uv__write_int(error_fd, UV__ERR(errno));
   _exit(127);
 }
-#endif
 
 
-int uv_spawn(uv_loop_t* loop,
-             uv_process_t* process,
-             const uv_process_options_t* options) {
-#if defined(__APPLE__) && (TARGET_OS_TV || TARGET_OS_WATCH)
-  /* fork is marked __WATCHOS_PROHIBITED __TVOS_PROHIBITED. */
-  return UV_ENOSYS;
-#else
-  int signal_pipe[2] = { -1, -1 };
-  int pipes_storage[8][2];
-  int (*pipes)[2];
+#if defined(UV__PROCESS_CLONE)
+struct uv__process_clone_args {
+  const uv_process_options_t* options;
   int stdio_count;
-  ssize_t r;
-  pid_t pid;
-  int err;
-  int exec_errorno;
-  int i;
-  int status;
+  int (*pipes)[2];
+  int error_fd;
+};
 
-  assert(options->file != NULL);
-  assert(!(options->flags & ~(UV_PROCESS_DETACHED |
-                              UV_PROCESS_SETGID |
-                              UV_PROCESS_SETUID |
-                              UV_PROCESS_WINDOWS_HIDE |
-                              UV_PROCESS_WINDOWS_HIDE_CONSOLE |
-                              UV_PROCESS_WINDOWS_HIDE_GUI |
-                              UV_PROCESS_WINDOWS_VERBATIM_ARGUMENTS)));
 
-  uv__handle_init(loop, (uv_handle_t*)process, UV_PROCESS);
-  QUEUE_INIT(&process->queue);
+static int uv__process_clone_child(void* arg) {
+  struct uv__process_clone_args* args;
 
-  stdio_count = options->stdio_count;
-  if (stdio_count < 3)
-    stdio_count = 3;
+  args = arg;
+  uv__process_child_init(args->options,
+                         args->stdio_count,
+                         args->pipes,
+                         args->error_fd,
+                         1);
+  return 127;
+}
 
-  err = UV_ENOMEM;
-  pipes = pipes_storage;
-  if (stdio_count > (int) ARRAY_SIZE(pipes_storage))
-    pipes = uv__malloc(stdio_count * sizeof(*pipes));
 
-  if (pipes == NULL)
-    goto error;
+/* Setting a uid or gid makes glibc signal every thread of the process, which
+ * the parent's threads would receive. Detached children call setsid(), which
+ * is left to fork() as well to keep that path as it was.
+ */
+static int uv__process_can_clone(const uv_process_options_t* options) {
+  return !(options->flags & (UV_PROCESS_DETACHED |
+                             UV_PROCESS_SETGID |
+                             UV_PROCESS_SETUID));
+}
 
-  for (i = 0; i < stdio_count; i++) {
-    pipes[i][0] = -1;
-    pipes[i][1] = -1;
-  }
 
-  for (i = 0; i < options->stdio_count; i++) {
-    err = uv__process_init_stdio(options->stdio + i, pipes[i]);
-    if (err)
-      goto error;
-  }
+/* Starts the child with clone(CLONE_VM | CLONE_VFORK), which does not copy
+ * the page tables of the parent, unlike fork(). That cost grows with the
+ * size of the parent. The calling thread is suspended until the child has
+ * called execve() or exited. The child runs on a stack of its own and
+ * works on a copy of `pipes`, since uv__process_child_init() changes it.
+ * Returns -1 with errno set if the child could not be created, for example
+ * when a seccomp filter rejects the flags.
+ */
+static pid_t uv__process_clone(const uv_process_options_t* options,
+                               int stdio_count,
+                               int (*pipes)[2],
+                               int error_fd) {
+  struct uv__process_clone_args args;
+  sigset_t signewset;
+  sigset_t sigoldset;
+  size_t pipes_size;
+  size_t size;
+  char* mem;
+  pid_t pid;
+  int err;
+
+  pipes_size = stdio_count * sizeof(*pipes);
+  size = 64 * 1024 + pipes_size;
+  mem = mmap(NULL,
+             size,
+             PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK,
+             -1,
+             0);
+  if (mem == MAP_FAILED)
+    return -1;
+
+  args.options = options;
+  args.stdio_count = stdio_count;
+  args.pipes = (int (*)[2]) mem;
+  args.error_fd = error_fd;
+  memcpy(args.pipes, pipes, pipes_size);
+
+  /* Signals stay blocked until the child has reset their handlers. */
+  sigfillset(&signewset);
+  pthread_sigmask(SIG_SETMASK, &signewset, &sigoldset);
+  pid = clone(uv__process_clone_child,
+              mem + size,
+              CLONE_VM | CLONE_VFORK | SIGCHLD,
+              &args);
+  err = errno;
+  pthread_sigmask(SIG_SETMASK, &sigoldset, NULL);
+
+  munmap(mem, size);
+  errno = err;
+  return pid;
+}
+#endif
+
+
+/* Starts the child and waits until it has called execve(). Sets `*pid`, and
+ * `*exec_errorno` to the error that execve() failed with, if it did.
+ */
+static int uv__process_spawn(uv_loop_t* loop,
+                             const uv_process_options_t* options,
+                             int stdio_count,
+                             int (*pipes)[2],
+                             int use_clone,
+                             pid_t* pid,
+                             int* exec_errorno) {
+  int signal_pipe[2] = { -1, -1 };
+  ssize_t r;
+  int status;
+  int err;
 
   /* This pipe is used by the parent to wait until
    * the child has called `execve()`. We need this
@@ -488,24 +634,28 @@ int uv_spawn(uv_loop_t* loop,
    */
   err = uv__make_pipe(signal_pipe, 0);
   if (err)
-    goto error;
-
-  uv_signal_start(&loop->child_watcher, uv__chld, SIGCHLD);
+    return err;
 
   /* Acquire write lock to prevent opening new fds in worker threads */
   uv_rwlock_wrlock(&loop->cloexec_lock);
-  pid = fork();
+  *pid = -1;
+#if defined(UV__PROCESS_CLONE)
+  if (use_clone)
+    *pid = uv__process_clone(options, stdio_count, pipes, signal_pipe[1]);
+  if (*pid == -1)
+#endif
+  *pid = fork();
 
-  if (pid == -1) {
+  if (*pid == -1) {
     err = UV__ERR(errno);
     uv_rwlock_wrunlock(&loop->cloexec_lock);
     uv__close(signal_pipe[0]);
     uv__close(signal_pipe[1]);
-    goto error;
+    return err;
   }
 
-  if (pid == 0) {
-    uv__process_child_init(options, stdio_count, pipes, signal_pipe[1]);
+  if (*pid == 0) {
+    uv__process_child_init(options, stdio_count, pipes, signal_pipe[1], 0);
     abort();
   }
 
@@ -513,28 +663,117 @@ int uv_spawn(uv_loop_t* loop,
   uv_rwlock_wrunlock(&loop->cloexec_lock);
   uv__close(signal_pipe[1]);
 
-  process->status = 0;
-  exec_errorno = 0;
+  *exec_errorno = 0;
   do
-    r = read(signal_pipe[0], &exec_errorno, sizeof(exec_errorno));
+    r = read(signal_pipe[0], exec_errorno, sizeof(*exec_errorno));
   while (r == -1 && errno == EINTR);
 
   if (r == 0)
     ; /* okay, EOF */
-  else if (r == sizeof(exec_errorno)) {
+  else if (r == sizeof(*exec_errorno)) {
     do
-      err = waitpid(pid, &status, 0); /* okay, read errorno */
+      err = waitpid(*pid, &status, 0); /* okay, read errorno */
     while (err == -1 && errno == EINTR);
-    assert(err == pid);
+    assert(err == *pid);
   } else if (r == -1 && errno == EPIPE) {
     do
-      err = waitpid(pid, &status, 0); /* okay, got EPIPE */
+      err = waitpid(*pid, &status, 0); /* okay, got EPIPE */
     while (err == -1 && errno == EINTR);
-    assert(err == pid);
+    assert(err == *pid);
   } else
     abort();
 
   uv__close_nocheckstdio(signal_pipe[0]);
+  return 0;
+}
+#endif
+
+
+int uv_spawn(uv_loop_t* loop,
+             uv_process_t* process,
+             const uv_process_options_t* options) {
+#if defined(__APPLE__) && (TARGET_OS_TV || TARGET_OS_WATCH)
+  /* fork is marked __WATCHOS_PROHIBITED __TVOS_PROHIBITED. */
+  return UV_ENOSYS;
+#else
+  int pipes_storage[8][2];
+  int (*pipes)[2];
+  int stdio_count;
+  pid_t pid;
+  int err;
+  int exec_errorno;
+  int i;
+
+  assert(options->file != NULL);
+  assert(!(options->flags & ~(UV_PROCESS_DETACHED |
+                              UV_PROCESS_SETGID |
+                              UV_PROCESS_SETUID |
+                              UV_PROCESS_WINDOWS_HIDE |
+                              UV_PROCESS_WINDOWS_HIDE_CONSOLE |
+                              UV_PROCESS_WINDOWS_HIDE_GUI |
+                              UV_PROCESS_WINDOWS_VERBATIM_ARGUMENTS)));
+
+  uv__handle_init(loop, (uv_handle_t*)process, UV_PROCESS);
+  QUEUE_INIT(&process->queue);
+
+  stdio_count = options->stdio_count;
+  if (stdio_count < 3)
+    stdio_count = 3;
+
+  err = UV_ENOMEM;
+  pipes = pipes_storage;
+  if (stdio_count > (int) ARRAY_SIZE(pipes_storage))
+    pipes = uv__malloc(stdio_count * sizeof(*pipes));
+
+  if (pipes == NULL)
+    goto error;
+
+  for (i = 0; i < stdio_count; i++) {
+    pipes[i][0] = -1;
+    pipes[i][1] = -1;
+  }
+
+  for (i = 0; i < options->stdio_count; i++) {
+    err = uv__process_init_stdio(options->stdio + i, pipes[i]);
+    if (err)
+      goto error;
+  }
+
+  uv_signal_start(&loop->child_watcher, uv__chld, SIGCHLD);
+
+#if defined(UV__PROCESS_CLONE)
+  err = uv__process_spawn(loop,
+                          options,
+                          stdio_count,
+                          pipes,
+                          uv__process_can_clone(options),
+                          &pid,
+                          &exec_errorno);
+  /* Leave scripts without a #! line to execvp(), see uv__execvpe(). */
+  if (err == 0 &&
+      exec_errorno == UV__ERR(ENOEXEC) &&
+      uv__process_can_clone(options)) {
+    err = uv__process_spawn(loop,
+                            options,
+                            stdio_count,
+                            pipes,
+                            0,
+                            &pid,
+                            &exec_errorno);
+  }
+#else
+  err = uv__process_spawn(loop,
+                          options,
+                          stdio_count,
+                          pipes,
+                          0,
+                          &pid,
+                          &exec_errorno);
+#endif
+  if (err)
+    goto error;
+
+  process->status = 0;
 
   for (i = 0; i < options->stdio_count; i++) {
     err = uv__process_open_stream(options->stdio + i, pipes[i]);
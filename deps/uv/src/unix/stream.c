@@ -77,7 +77,6 @@ struct uv__stream_select_s {
 static void uv__stream_connect(uv_stream_t*);
 static void uv__write(uv_stream_t* stream);
 static void uv__read(uv_stream_t* stream);
-static void uv__stream_io(uv_loop_t* loop, uv__io_t* w, unsigned int events);
 static void uv__write_callbacks(uv_stream_t* stream);
 static size_t uv__write_req_size(uv_write_t* req);
 
@@ -899,6 +898,11 @@ start:
 
   if (n >= 0 && uv__write_req_update(stream, req, n)) {
     uv__write_req_finish(req);
+    /* The fd is still writable, so an edge-triggered watcher won't be told
+     * about it again.
+     */
+    if (!QUEUE_EMPTY(&stream->write_queue))
+      uv__io_rearm(stream->loop, &stream->io_watcher);
     return;  /* TODO(bnoordhuis) Start trying to write the next request. */
   }
 
@@ -1125,7 +1129,8 @@ static void uv__read(uv_stream_t* stream) {
   stream->flags &= ~UV_HANDLE_READ_PARTIAL;
 
   /* Prevent loop starvation when the data comes in as fast as (or faster than)
-   * we can read it. XXX Need to rearm fd if we switch to edge-triggered I/O.
+   * we can read it. An edge-triggered watcher is re-armed below when that
+   * happens.
    */
   count = 32;
 
@@ -1144,6 +1149,7 @@ static void uv__read(uv_stream_t* stream) {
     if (buf.base == NULL || buf.len == 0) {
       /* User indicates it can't or won't handle the read. */
       stream->read_cb(stream, UV_ENOBUFS, &buf);
+      uv__io_rearm(stream->loop, &stream->io_watcher);
       return;
     }
 
@@ -1238,13 +1244,20 @@ static void uv__read(uv_stream_t* stream) {
 #endif
       stream->read_cb(stream, nread, &buf);
 
-      /* Return if we didn't fill the buffer, there is no more data to read. */
+      /* Return if we didn't fill the buffer, there is no more data to read.
+       * This holds for edge-triggered watchers too: the kernel signals an
+       * edge for every chunk of data that arrives after the buffer has been
+       * drained, so no read() that returns EAGAIN is needed to re-arm them.
+       */
       if (nread < buflen) {
         stream->flags |= UV_HANDLE_READ_PARTIAL;
         return;
       }
     }
   }
+
+  if (count < 0)
+    uv__io_rearm(stream->loop, &stream->io_watcher);
 }
 
 
@@ -1284,7 +1297,7 @@ int uv_shutdown(uv_shutdown_t* req, uv_stream_t* stream, uv_shutdown_cb cb) {
 }
 
 
-static void uv__stream_io(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
+void uv__stream_io(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
   uv_stream_t* stream;
 
   stream = container_of(w, uv_stream_t, io_watcher);
@@ -1313,8 +1326,11 @@ static void uv__stream_io(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
    * flag is set, uv__read() called read_cb with err=UV_EOF and we don't
    * have to do anything. If the partial read flag is not set, we can't
    * report the EOF yet because there is still data to read.
+   *
+   * Edge-triggered watchers get UV__POLLRDHUP when the peer has shut down
+   * its side, and won't be told again that the end of input can be read.
    */
-  if ((events & POLLHUP) &&
+  if ((events & (POLLHUP | UV__POLLRDHUP)) &&
       (stream->flags & UV_HANDLE_READING) &&
       (stream->flags & UV_HANDLE_READ_PARTIAL) &&
       !(stream->flags & UV_HANDLE_READ_EOF)) {
@@ -1375,6 +1391,9 @@ static void uv__stream_connect(uv_stream_t* stream) {
 
   if (error < 0 || QUEUE_EMPTY(&stream->write_queue)) {
     uv__io_stop(stream->loop, &stream->io_watcher, POLLOUT);
+  } else {
+    /* Writable now, the queued writes can start. */
+    uv__io_rearm(stream->loop, &stream->io_watcher);
   }
 
   if (req->cb)
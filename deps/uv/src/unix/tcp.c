@@ -145,6 +145,35 @@ int uv_tcp_init(uv_loop_t* loop, uv_tcp_t* tcp) {
 }
 
 
+/* Only enable SO_REUSEPORT where the kernel load balances connections across
+ * the sockets that share the port. Elsewhere, e.g. on macOS, the option
+ * exists but the last socket to bind receives all the connections, which is
+ * not what the caller asked for.
+ */
+static int uv__tcp_reuseport(int fd) {
+#if defined(__linux__) || defined(__DragonFly__) || \
+    (defined(__FreeBSD__) && defined(SO_REUSEPORT_LB))
+  int on;
+  int opt;
+
+#if defined(__FreeBSD__)
+  opt = SO_REUSEPORT_LB;
+#else
+  opt = SO_REUSEPORT;
+#endif
+
+  on = 1;
+  if (setsockopt(fd, SOL_SOCKET, opt, &on, sizeof(on)))
+    return UV__ERR(errno);
+
+  return 0;
+#else
+  (void) fd;
+  return UV_ENOTSUP;
+#endif
+}
+
+
 int uv__tcp_bind(uv_tcp_t* tcp,
                  const struct sockaddr* addr,
                  unsigned int addrlen,
@@ -164,6 +193,12 @@ int uv__tcp_bind(uv_tcp_t* tcp,
   if (setsockopt(tcp->io_watcher.fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)))
     return UV__ERR(errno);
 
+  if (flags & UV_TCP_REUSEPORT) {
+    err = uv__tcp_reuseport(tcp->io_watcher.fd);
+    if (err)
+      return err;
+  }
+
 #ifndef __OpenBSD__
 #ifdef IPV6_V6ONLY
   if (addr->sa_family == AF_INET6) {
@@ -40,6 +40,26 @@
 # define IPV6_DROP_MEMBERSHIP IPV6_LEAVE_GROUP
 #endif
 
+#define UV__UDP_DGRAM_MAXSIZE (64 * 1024)
+
+#if defined(__linux__)
+# define HAVE_MMSG 1
+# define HAVE_UDP_OFFLOAD 1
+# define UV__MMSG_MAXWIDTH 64
+# ifndef UDP_SEGMENT
+#  define UDP_SEGMENT 103
+# endif
+# ifndef UDP_GRO
+#  define UDP_GRO 104
+# endif
+#endif
+
+#if HAVE_MMSG
+static uv_once_t once = UV_ONCE_INIT;
+static int uv__recvmmsg_avail;
+static int uv__sendmmsg_avail;
+#endif
+
 
 static void uv__udp_run_completed(uv_udp_t* handle);
 static void uv__udp_io(uv_loop_t* loop, uv__io_t* w, unsigned int revents);
@@ -50,6 +70,30 @@ static int uv__udp_maybe_deferred_bind(uv_udp_t* handle,
                                        unsigned int flags);
 
 
+#if HAVE_MMSG
+static void uv__udp_mmsg_init(void) {
+  int ret;
+  int s;
+
+  s = uv__socket(AF_INET, SOCK_DGRAM, 0);
+  if (s < 0)
+    return;
+
+  ret = uv__sendmmsg(s, NULL, 0, 0);
+  if (ret == 0 || errno != ENOSYS) {
+    uv__sendmmsg_avail = 1;
+    uv__recvmmsg_avail = 1;
+  } else {
+    ret = uv__recvmmsg(s, NULL, 0, MSG_DONTWAIT, NULL);
+    if (ret == 0 || errno != ENOSYS)
+      uv__recvmmsg_avail = 1;
+  }
+
+  uv__close(s);
+}
+#endif
+
+
 void uv__udp_close(uv_udp_t* handle) {
   uv__io_close(handle->loop, &handle->io_watcher);
   uv__handle_stop(handle);
@@ -149,9 +193,143 @@ static void uv__udp_io(uv_loop_t* loop, uv__io_t* w, unsigned int revents) {
 }
 
 
+#if HAVE_UDP_OFFLOAD
+union uv__udp_gro_control {
+  char buf[CMSG_SPACE(sizeof(int))];
+  struct cmsghdr align;
+};
+
+
+/* Returns the segment size of a datagram that the kernel coalesced with
+ * UDP_GRO, or 0 if the datagram was not coalesced.
+ */
+static size_t uv__udp_gro_size(struct msghdr* h) {
+  struct cmsghdr* cmsg;
+  int size;
+
+  if (h->msg_control == NULL)
+    return 0;
+
+  for (cmsg = CMSG_FIRSTHDR(h); cmsg != NULL; cmsg = CMSG_NXTHDR(h, cmsg)) {
+    if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO) {
+      memcpy(&size, CMSG_DATA(cmsg), sizeof(size));
+      return size > 0 ? (size_t) size : 0;
+    }
+  }
+
+  return 0;
+}
+
+
+/* Passes each segment of a coalesced datagram to the application as a
+ * UV_UDP_MMSG_CHUNK. The caller passes the whole buffer back afterwards.
+ */
+static void uv__udp_recv_segments(uv_udp_t* handle,
+                                  char* base,
+                                  size_t len,
+                                  size_t segment_size,
+                                  const struct sockaddr* addr,
+                                  unsigned int flags) {
+  uv_buf_t chunk_buf;
+  size_t offset;
+
+  for (offset = 0;
+       offset < len && handle->recv_cb != NULL;
+       offset += segment_size) {
+    chunk_buf = uv_buf_init(base + offset,
+                            len - offset < segment_size ?
+                                len - offset : segment_size);
+    handle->recv_cb(handle,
+                    chunk_buf.len,
+                    &chunk_buf,
+                    addr,
+                    flags | UV_UDP_MMSG_CHUNK);
+  }
+}
+#endif
+
+
+#if HAVE_MMSG
+static int uv__udp_recvmmsg(uv_udp_t* handle, uv_buf_t* buf) {
+  struct sockaddr_storage peers[UV__MMSG_MAXWIDTH];
+  struct iovec iov[UV__MMSG_MAXWIDTH];
+  struct uv__mmsghdr msgs[UV__MMSG_MAXWIDTH];
+  union uv__udp_gro_control control[UV__MMSG_MAXWIDTH];
+  ssize_t nread;
+  uv_buf_t chunk_buf;
+  size_t segment_size;
+  size_t chunks;
+  int flags;
+  size_t k;
+
+  /* prepare structures for recvmmsg */
+  chunks = buf->len / UV__UDP_DGRAM_MAXSIZE;
+  if (chunks > ARRAY_SIZE(iov))
+    chunks = ARRAY_SIZE(iov);
+  for (k = 0; k < chunks; ++k) {
+    iov[k].iov_base = buf->base + k * UV__UDP_DGRAM_MAXSIZE;
+    iov[k].iov_len = UV__UDP_DGRAM_MAXSIZE;
+    memset(&msgs[k].msg_hdr, 0, sizeof(msgs[k].msg_hdr));
+    msgs[k].msg_hdr.msg_iov = iov + k;
+    msgs[k].msg_hdr.msg_iovlen = 1;
+    msgs[k].msg_hdr.msg_name = peers + k;
+    msgs[k].msg_hdr.msg_namelen = sizeof(peers[0]);
+    if (handle->flags & UV_HANDLE_UDP_GRO) {
+      msgs[k].msg_hdr.msg_control = control[k].buf;
+      msgs[k].msg_hdr.msg_controllen = sizeof(control[k].buf);
+    }
+  }
+
+  do
+    nread = uv__recvmmsg(handle->io_watcher.fd, msgs, chunks, 0, NULL);
+  while (nread == -1 && errno == EINTR);
+
+  if (nread < 1) {
+    if (nread == 0 || errno == EAGAIN || errno == EWOULDBLOCK)
+      handle->recv_cb(handle, 0, buf, NULL, 0);
+    else
+      handle->recv_cb(handle, UV__ERR(errno), buf, NULL, 0);
+  } else {
+    /* pass each chunk to the application */
+    for (k = 0; k < (size_t) nread && handle->recv_cb != NULL; k++) {
+      flags = UV_UDP_MMSG_CHUNK;
+      if (msgs[k].msg_hdr.msg_flags & MSG_TRUNC)
+        flags |= UV_UDP_PARTIAL;
+
+      segment_size = uv__udp_gro_size(&msgs[k].msg_hdr);
+      if (segment_size > 0 && msgs[k].msg_len > segment_size) {
+        uv__udp_recv_segments(handle,
+                              iov[k].iov_base,
+                              msgs[k].msg_len,
+                              segment_size,
+                              msgs[k].msg_hdr.msg_name,
+                              flags);
+        continue;
+      }
+
+      chunk_buf = uv_buf_init(iov[k].iov_base, iov[k].iov_len);
+      handle->recv_cb(handle,
+                      msgs[k].msg_len,
+                      &chunk_buf,
+                      msgs[k].msg_hdr.msg_name,
+                      flags);
+    }
+
+    /* one last callback so the original buffer is freed */
+    if (handle->recv_cb != NULL)
+      handle->recv_cb(handle, 0, buf, NULL, 0);
+  }
+  return nread;
+}
+#endif
+
 static void uv__udp_recvmsg(uv_udp_t* handle) {
   struct sockaddr_storage peer;
   struct msghdr h;
+#if HAVE_UDP_OFFLOAD
+  union uv__udp_gro_control control;
+  size_t segment_size;
+#endif
   ssize_t nread;
   uv_buf_t buf;
   int flags;
@@ -167,19 +345,36 @@ static void uv__udp_recvmsg(uv_udp_t* handle) {
 
   do {
     buf = uv_buf_init(NULL, 0);
-    handle->alloc_cb((uv_handle_t*) handle, 64 * 1024, &buf);
+    handle->alloc_cb((uv_handle_t*) handle, UV__UDP_DGRAM_MAXSIZE, &buf);
     if (buf.base == NULL || buf.len == 0) {
       handle->recv_cb(handle, UV_ENOBUFS, &buf, NULL, 0);
       return;
     }
     assert(buf.base != NULL);
 
+#if HAVE_MMSG
+    if ((handle->flags & UV_HANDLE_UDP_RECVMMSG) &&
+        uv__recvmmsg_avail &&
+        buf.len >= 2 * UV__UDP_DGRAM_MAXSIZE) {
+      nread = uv__udp_recvmmsg(handle, &buf);
+      if (nread > 0)
+        count -= nread;
+      continue;
+    }
+#endif
+
     memset(&h, 0, sizeof(h));
     memset(&peer, 0, sizeof(peer));
     h.msg_name = &peer;
     h.msg_namelen = sizeof(peer);
     h.msg_iov = (void*) &buf;
     h.msg_iovlen = 1;
+#if HAVE_UDP_OFFLOAD
+    if (handle->flags & UV_HANDLE_UDP_GRO) {
+      h.msg_control = control.buf;
+      h.msg_controllen = sizeof(control.buf);
+    }
+#endif
 
     do {
       nread = recvmsg(handle->io_watcher.fd, &h, 0);
@@ -197,6 +392,22 @@ static void uv__udp_recvmsg(uv_udp_t* handle) {
       if (h.msg_flags & MSG_TRUNC)
         flags |= UV_UDP_PARTIAL;
 
+#if HAVE_UDP_OFFLOAD
+      segment_size = uv__udp_gro_size(&h);
+      if (segment_size > 0 && (size_t) nread > segment_size) {
+        uv__udp_recv_segments(handle,
+                              buf.base,
+                              nread,
+                              segment_size,
+                              (const struct sockaddr*) &peer,
+                              flags);
+        /* one last callback so the original buffer is freed */
+        if (handle->recv_cb != NULL)
+          handle->recv_cb(handle, 0, &buf, NULL, 0);
+        continue;
+      }
+#endif
+
       handle->recv_cb(handle, nread, &buf, (const struct sockaddr*) &peer, flags);
     }
   }
@@ -208,12 +419,96 @@ static void uv__udp_recvmsg(uv_udp_t* handle) {
 }
 
 
+static void uv__udp_msghdr_init(struct msghdr* h, uv_udp_send_t* req) {
+  memset(h, 0, sizeof(*h));
+  if (req->addr.ss_family == AF_UNSPEC) {
+    h->msg_name = NULL;
+    h->msg_namelen = 0;
+  } else {
+    h->msg_name = &req->addr;
+    if (req->addr.ss_family == AF_INET6)
+      h->msg_namelen = sizeof(struct sockaddr_in6);
+    else if (req->addr.ss_family == AF_INET)
+      h->msg_namelen = sizeof(struct sockaddr_in);
+    else if (req->addr.ss_family == AF_UNIX)
+      h->msg_namelen = sizeof(struct sockaddr_un);
+    else {
+      assert(0 && "unsupported address family");
+      abort();
+    }
+  }
+  h->msg_iov = (struct iovec*) req->bufs;
+  h->msg_iovlen = req->nbufs;
+}
+
+
+#if HAVE_MMSG
+static void uv__udp_sendmmsg(uv_udp_t* handle) {
+  uv_udp_send_t* req;
+  struct uv__mmsghdr h[UV__MMSG_MAXWIDTH];
+  QUEUE* q;
+  ssize_t npkts;
+  size_t pkts;
+  size_t i;
+
+  while (!QUEUE_EMPTY(&handle->write_queue)) {
+    for (pkts = 0, q = QUEUE_HEAD(&handle->write_queue);
+         pkts < UV__MMSG_MAXWIDTH && q != &handle->write_queue;
+         ++pkts, q = QUEUE_NEXT(q)) {
+      req = QUEUE_DATA(q, uv_udp_send_t, queue);
+      uv__udp_msghdr_init(&h[pkts].msg_hdr, req);
+    }
+
+    do
+      npkts = uv__sendmmsg(handle->io_watcher.fd, h, pkts, 0);
+    while (npkts == -1 && errno == EINTR);
+
+    if (npkts < 1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+        return;
+
+      /* sendmmsg() only reports an error when the first datagram could not
+       * be sent. Fail that request and carry on with the rest of the queue.
+       */
+      npkts = 0;
+      q = QUEUE_HEAD(&handle->write_queue);
+      req = QUEUE_DATA(q, uv_udp_send_t, queue);
+      req->status = UV__ERR(errno);
+      QUEUE_REMOVE(&req->queue);
+      QUEUE_INSERT_TAIL(&handle->write_completed_queue, &req->queue);
+    }
+
+    /* Sending a datagram is an atomic operation: either all data is written
+     * or nothing is, so each datagram that sendmmsg() reports as sent gets
+     * completed with its full length.
+     */
+    for (i = 0; i < (size_t) npkts; i++) {
+      q = QUEUE_HEAD(&handle->write_queue);
+      req = QUEUE_DATA(q, uv_udp_send_t, queue);
+      req->status = h[i].msg_len;
+      QUEUE_REMOVE(&req->queue);
+      QUEUE_INSERT_TAIL(&handle->write_completed_queue, &req->queue);
+    }
+
+    uv__io_feed(handle->loop, &handle->io_watcher);
+  }
+}
+#endif
+
+
 static void uv__udp_sendmsg(uv_udp_t* handle) {
   uv_udp_send_t* req;
   QUEUE* q;
   struct msghdr h;
   ssize_t size;
 
+#if HAVE_MMSG
+  if (uv__sendmmsg_avail) {
+    uv__udp_sendmmsg(handle);
+    return;
+  }
+#endif
+
   while (!QUEUE_EMPTY(&handle->write_queue)) {
     q = QUEUE_HEAD(&handle->write_queue);
     assert(q != NULL);
@@ -221,25 +516,7 @@ static void uv__udp_sendmsg(uv_udp_t* handle) {
     req = QUEUE_DATA(q, uv_udp_send_t, queue);
     assert(req != NULL);
 
-    memset(&h, 0, sizeof h);
-    if (req->addr.ss_family == AF_UNSPEC) {
-      h.msg_name = NULL;
-      h.msg_namelen = 0;
-    } else {
-      h.msg_name = &req->addr;
-      if (req->addr.ss_family == AF_INET6)
-        h.msg_namelen = sizeof(struct sockaddr_in6);
-      else if (req->addr.ss_family == AF_INET)
-        h.msg_namelen = sizeof(struct sockaddr_in);
-      else if (req->addr.ss_family == AF_UNIX)
-        h.msg_namelen = sizeof(struct sockaddr_un);
-      else {
-        assert(0 && "unsupported address family");
-        abort();
-      }
-    }
-    h.msg_iov = (struct iovec*) req->bufs;
-    h.msg_iovlen = req->nbufs;
+    uv__udp_msghdr_init(&h, req);
 
     do {
       size = sendmsg(handle->io_watcher.fd, &h, 0);
@@ -559,6 +836,76 @@ int uv__udp_try_send(uv_udp_t* handle,
 }
 
 
+int uv__udp_try_send2(uv_udp_t* handle,
+                      unsigned int count,
+                      uv_buf_t* bufs[],
+                      unsigned int nbufs[],
+                      struct sockaddr* addrs[]) {
+#if HAVE_MMSG
+  struct uv__mmsghdr h[UV__MMSG_MAXWIDTH];
+  struct msghdr* m;
+  ssize_t npkts;
+#endif
+  unsigned int i;
+  int addrlen;
+  int err;
+
+  if (addrs[0] != NULL) {
+    err = uv__udp_maybe_deferred_bind(handle, addrs[0]->sa_family, 0);
+    if (err)
+      return err;
+  }
+
+#if HAVE_MMSG
+  if (uv__sendmmsg_avail) {
+    if (count > ARRAY_SIZE(h))
+      count = ARRAY_SIZE(h);
+
+    for (i = 0; i < count; i++) {
+      addrlen = uv__udp_check_before_send(handle, addrs[i]);
+      if (addrlen < 0) {
+        if (i == 0)
+          return addrlen;
+        count = i;
+        break;
+      }
+
+      m = &h[i].msg_hdr;
+      memset(m, 0, sizeof(*m));
+      m->msg_name = addrs[i];
+      m->msg_namelen = addrlen;
+      m->msg_iov = (struct iovec*) bufs[i];
+      m->msg_iovlen = nbufs[i];
+    }
+
+    do
+      npkts = uv__sendmmsg(handle->io_watcher.fd, h, count, 0);
+    while (npkts == -1 && errno == EINTR);
+
+    if (npkts == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+        return UV_EAGAIN;
+      return UV__ERR(errno);
+    }
+
+    return npkts;
+  }
+#endif
+
+  for (i = 0; i < count; i++) {
+    addrlen = uv__udp_check_before_send(handle, addrs[i]);
+    if (addrlen < 0)
+      return i > 0 ? (int) i : addrlen;
+
+    err = uv__udp_try_send(handle, bufs[i], nbufs[i], addrs[i], addrlen);
+    if (err < 0)
+      return i > 0 ? (int) i : err;
+  }
+
+  return count;
+}
+
+
 static int uv__udp_set_membership4(uv_udp_t* handle,
                                    const struct sockaddr_in* multicast_addr,
                                    const char* interface_addr,
@@ -757,9 +1104,14 @@ int uv_udp_init_ex(uv_loop_t* loop, uv_udp_t* handle, unsigned int flags) {
   if (domain != AF_INET && domain != AF_INET6 && domain != AF_UNSPEC)
     return UV_EINVAL;
 
-  if (flags & ~0xFF)
+  /* Use the higher bits for extra flags */
+  if (flags & ~(0xFF | UV_UDP_RECVMMSG))
     return UV_EINVAL;
 
+#if HAVE_MMSG
+  uv_once(&once, uv__udp_mmsg_init);
+#endif
+
   if (domain != AF_UNSPEC) {
     err = uv__socket(domain, SOCK_DGRAM, 0);
     if (err < 0)
@@ -778,6 +1130,9 @@ int uv_udp_init_ex(uv_loop_t* loop, uv_udp_t* handle, unsigned int flags) {
   QUEUE_INIT(&handle->write_queue);
   QUEUE_INIT(&handle->write_completed_queue);
 
+  if (flags & UV_UDP_RECVMMSG)
+    handle->flags |= UV_HANDLE_UDP_RECVMMSG;
+
   return 0;
 }
 
@@ -942,6 +1297,52 @@ int uv_udp_set_broadcast(uv_udp_t* handle, int on) {
 }
 
 
+int uv_udp_set_segment_size(uv_udp_t* handle, unsigned int size) {
+#if HAVE_UDP_OFFLOAD
+  int val;
+
+  if (size > UINT16_MAX)
+    return UV_EINVAL;
+
+  val = size;
+  if (setsockopt(handle->io_watcher.fd,
+                 IPPROTO_UDP,
+                 UDP_SEGMENT,
+                 &val,
+                 sizeof(val))) {
+    return UV__ERR(errno);
+  }
+
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
+
+int uv_udp_set_gro(uv_udp_t* handle, int on) {
+#if HAVE_UDP_OFFLOAD
+  on = !!on;
+  if (setsockopt(handle->io_watcher.fd,
+                 IPPROTO_UDP,
+                 UDP_GRO,
+                 &on,
+                 sizeof(on))) {
+    return UV__ERR(errno);
+  }
+
+  if (on)
+    handle->flags |= UV_HANDLE_UDP_GRO;
+  else
+    handle->flags &= ~UV_HANDLE_UDP_GRO;
+
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
+
 int uv_udp_set_ttl(uv_udp_t* handle, int ttl) {
   if (ttl < 1 || ttl > 255)
     return UV_EINVAL;
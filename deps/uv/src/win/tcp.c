@@ -298,6 +298,10 @@ static int uv_tcp_try_bind(uv_tcp_t* handle,
   DWORD err;
   int r;
 
+  /* Windows has no load balancing equivalent of SO_REUSEPORT. */
+  if (flags & UV_TCP_REUSEPORT)
+    return ERROR_NOT_SUPPORTED;
+
   if (handle->socket == INVALID_SOCKET) {
     SOCKET sock;
 
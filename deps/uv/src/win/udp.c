@@ -133,7 +133,8 @@ int uv_udp_init_ex(uv_loop_t* loop, uv_udp_t* handle, unsigned int flags) {
   if (domain != AF_INET && domain != AF_INET6 && domain != AF_UNSPEC)
     return UV_EINVAL;
 
-  if (flags & ~0xFF)
+  /* Use the higher bits for extra flags. UV_UDP_RECVMMSG is a no-op here. */
+  if (flags & ~(0xFF | UV_UDP_RECVMMSG))
     return UV_EINVAL;
 
   uv__handle_init(loop, (uv_handle_t*) handle, UV_UDP);
@@ -939,6 +940,16 @@ int uv_udp_set_broadcast(uv_udp_t* handle, int value) {
 }
 
 
+int uv_udp_set_segment_size(uv_udp_t* handle, unsigned int size) {
+  return UV_ENOTSUP;
+}
+
+
+int uv_udp_set_gro(uv_udp_t* handle, int on) {
+  return UV_ENOTSUP;
+}
+
+
 int uv__udp_is_bound(uv_udp_t* handle) {
   struct sockaddr_storage addr;
   int addrlen;
@@ -1183,3 +1194,26 @@ int uv__udp_try_send(uv_udp_t* handle,
 
   return bytes;
 }
+
+
+int uv__udp_try_send2(uv_udp_t* handle,
+                      unsigned int count,
+                      uv_buf_t* bufs[],
+                      unsigned int nbufs[],
+                      struct sockaddr* addrs[]) {
+  unsigned int i;
+  int addrlen;
+  int r;
+
+  for (i = 0; i < count; i++) {
+    addrlen = uv__udp_check_before_send(handle, addrs[i]);
+    if (addrlen < 0)
+      return i > 0 ? i : addrlen;
+
+    r = uv__udp_try_send(handle, bufs[i], nbufs[i], addrs[i], addrlen);
+    if (r < 0)
+      return i > 0 ? i : r;
+  }
+
+  return count;
+}
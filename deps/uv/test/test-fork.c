@@ -676,6 +676,73 @@ TEST_IMPL(fork_threadpool_queue_work_simple) {
 }
 #endif /* !__MVS__ */
 
+
+#ifdef __linux__
+static int fs_cb_count;
+
+
+static void fstat_cb(uv_fs_t* req) {
+  ASSERT(req->result == 0);
+  ASSERT(S_ISREG(req->statbuf.st_mode));
+  uv_fs_req_cleanup(req);
+  fs_cb_count++;
+}
+
+
+static void assert_run_fstat(uv_loop_t* const loop, int fd) {
+  uv_fs_t req;
+
+  fs_cb_count = 0;
+  ASSERT(0 == uv_fs_fstat(loop, &req, fd, fstat_cb));
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+  ASSERT(1 == fs_cb_count);
+}
+
+
+TEST_IMPL(fork_fs_io_uring) {
+  /* File system requests go through io_uring where the kernel supports it,
+   * the child must not keep using the ring it shares with the parent.
+   */
+  uv_fs_t req;
+  pid_t child_pid;
+  uv_loop_t loop;
+  int fd;
+
+  ASSERT(0 == setenv("UV_USE_IO_URING", "1", 1));
+
+  fd = uv_fs_open(NULL, &req, "test_file", O_RDWR | O_CREAT, 0644, NULL);
+  ASSERT(fd >= 0);
+  uv_fs_req_cleanup(&req);
+
+  /* Set up the ring of the default loop. */
+  assert_run_fstat(uv_default_loop(), fd);
+
+  child_pid = fork();
+  ASSERT(child_pid != -1);
+
+  if (child_pid != 0) {
+    /* Parent. */
+    assert_run_fstat(uv_default_loop(), fd);
+    assert_wait_child(child_pid);
+  } else {
+    /* Child. */
+    ASSERT(0 == uv_loop_fork(uv_default_loop()));
+    assert_run_fstat(uv_default_loop(), fd);
+    ASSERT(0 == uv_loop_init(&loop));
+    assert_run_fstat(&loop, fd);
+    ASSERT(0 == uv_loop_close(&loop));
+  }
+
+  uv_fs_close(NULL, &req, fd, NULL);
+  uv_fs_req_cleanup(&req);
+  if (child_pid != 0)
+    unlink("test_file");
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+#endif /* __linux__ */
+
 #else
 
 typedef int file_has_no_tests; /* ISO C forbids an empty translation unit. */
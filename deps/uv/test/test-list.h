@@ -33,6 +33,8 @@ TEST_DECLARE   (loop_stop)
 TEST_DECLARE   (loop_update_time)
 TEST_DECLARE   (loop_backend_timeout)
 TEST_DECLARE   (loop_configure)
+TEST_DECLARE   (loop_configure_busy_poll)
+TEST_DECLARE   (loop_configure_edge_triggered)
 TEST_DECLARE   (default_loop_close)
 TEST_DECLARE   (barrier_1)
 TEST_DECLARE   (barrier_2)
@@ -100,6 +102,8 @@ TEST_DECLARE   (tcp_open_connected)
 TEST_DECLARE   (tcp_connect_error_after_write)
 TEST_DECLARE   (tcp_shutdown_after_write)
 TEST_DECLARE   (tcp_bind_error_addrinuse)
+TEST_DECLARE   (tcp_reuseport)
+TEST_DECLARE   (tcp_reuseport_ipv6only_mismatch)
 TEST_DECLARE   (tcp_bind_error_addrnotavail_1)
 TEST_DECLARE   (tcp_bind_error_addrnotavail_2)
 TEST_DECLARE   (tcp_bind_error_fault)
@@ -150,6 +154,8 @@ TEST_DECLARE   (udp_multicast_join6)
 TEST_DECLARE   (udp_multicast_ttl)
 TEST_DECLARE   (udp_multicast_interface)
 TEST_DECLARE   (udp_multicast_interface6)
+TEST_DECLARE   (udp_mmsg)
+TEST_DECLARE   (udp_segment_offload)
 TEST_DECLARE   (udp_dgram_too_big)
 TEST_DECLARE   (udp_dual_stack)
 TEST_DECLARE   (udp_ipv6_only)
@@ -393,6 +399,8 @@ TEST_DECLARE   (fs_invalid_mkdir_name)
 TEST_DECLARE   (strscpy)
 TEST_DECLARE   (threadpool_queue_work_simple)
 TEST_DECLARE   (threadpool_queue_work_einval)
+TEST_DECLARE   (threadpool_queue_work_pool)
+TEST_DECLARE   (threadpool_queue_work_pool_default)
 TEST_DECLARE   (threadpool_multiple_event_loops)
 TEST_DECLARE   (threadpool_cancel_getaddrinfo)
 TEST_DECLARE   (threadpool_cancel_getnameinfo)
@@ -489,6 +497,9 @@ TEST_DECLARE  (fork_fs_events_file_parent_child)
 #ifndef __MVS__
 TEST_DECLARE  (fork_threadpool_queue_work_simple)
 #endif
+#ifdef __linux__
+TEST_DECLARE  (fork_fs_io_uring)
+#endif
 #endif
 
 TEST_DECLARE  (idna_toascii)
@@ -511,6 +522,8 @@ TASK_LIST_START
   TEST_ENTRY  (loop_update_time)
   TEST_ENTRY  (loop_backend_timeout)
   TEST_ENTRY  (loop_configure)
+  TEST_ENTRY  (loop_configure_busy_poll)
+  TEST_ENTRY  (loop_configure_edge_triggered)
   TEST_ENTRY  (default_loop_close)
   TEST_ENTRY  (barrier_1)
   TEST_ENTRY  (barrier_2)
@@ -622,6 +635,8 @@ TASK_LIST_START
 
   TEST_ENTRY  (tcp_connect_error_after_write)
   TEST_ENTRY  (tcp_bind_error_addrinuse)
+  TEST_ENTRY  (tcp_reuseport)
+  TEST_ENTRY  (tcp_reuseport_ipv6only_mismatch)
   TEST_ENTRY  (tcp_bind_error_addrnotavail_1)
   TEST_ENTRY  (tcp_bind_error_addrnotavail_2)
   TEST_ENTRY  (tcp_bind_error_fault)
@@ -681,6 +696,8 @@ TASK_LIST_START
   TEST_ENTRY  (udp_multicast_join)
   TEST_ENTRY  (udp_multicast_join6)
   TEST_ENTRY  (udp_multicast_ttl)
+  TEST_ENTRY  (udp_mmsg)
+  TEST_ENTRY  (udp_segment_offload)
   TEST_ENTRY  (udp_try_send)
 
   TEST_ENTRY  (udp_open)
@@ -1003,6 +1020,8 @@ TASK_LIST_START
   TEST_ENTRY  (strscpy)
   TEST_ENTRY  (threadpool_queue_work_simple)
   TEST_ENTRY  (threadpool_queue_work_einval)
+  TEST_ENTRY  (threadpool_queue_work_pool)
+  TEST_ENTRY  (threadpool_queue_work_pool_default)
   TEST_ENTRY_CUSTOM (threadpool_multiple_event_loops, 0, 0, 60000)
   TEST_ENTRY  (threadpool_cancel_getaddrinfo)
   TEST_ENTRY  (threadpool_cancel_getnameinfo)
@@ -1046,6 +1065,9 @@ TASK_LIST_START
 #ifndef __MVS__
   TEST_ENTRY  (fork_threadpool_queue_work_simple)
 #endif
+#ifdef __linux__
+  TEST_ENTRY  (fork_fs_io_uring)
+#endif
 #endif
 
   TEST_ENTRY  (utf8_decode1)
@@ -36,3 +36,153 @@ TEST_IMPL(loop_configure) {
   ASSERT(0 == uv_loop_close(&loop));
   return 0;
 }
+
+
+TEST_IMPL(loop_configure_busy_poll) {
+  uv_timer_t timer_handle;
+  uv_loop_t loop;
+  uint64_t start;
+  ASSERT(0 == uv_loop_init(&loop));
+#ifdef __linux__
+  ASSERT(0 == uv_loop_configure(&loop, UV_LOOP_BUSY_POLL, 1000u));
+#else
+  ASSERT(UV_ENOSYS == uv_loop_configure(&loop, UV_LOOP_BUSY_POLL, 1000u));
+#endif
+  /* The timer fires on time whether the loop spins or blocks. */
+  start = uv_now(&loop);
+  ASSERT(0 == uv_timer_init(&loop, &timer_handle));
+  ASSERT(0 == uv_timer_start(&timer_handle, timer_cb, 10, 0));
+  ASSERT(0 == uv_run(&loop, UV_RUN_DEFAULT));
+  ASSERT(uv_now(&loop) - start >= 10);
+  ASSERT(0 == uv_loop_configure(&loop, UV_LOOP_BUSY_POLL, 0u) ||
+         UV_ENOSYS == uv_loop_configure(&loop, UV_LOOP_BUSY_POLL, 0u));
+  ASSERT(0 == uv_loop_close(&loop));
+  return 0;
+}
+
+
+#define ET_WRITES 64
+#define ET_WRITE_SIZE (64 * 1024)
+
+static uv_tcp_t et_server;
+static uv_tcp_t et_client;
+static uv_tcp_t et_peer;
+static uv_connect_t et_connect_req;
+static uv_write_t et_write_reqs[ET_WRITES];
+static uv_timer_t et_timer;
+static char et_write_buf[ET_WRITE_SIZE];
+static char et_read_buf[ET_WRITE_SIZE];
+static size_t et_bytes_read;
+static int et_write_cb_called;
+static int et_pauses;
+
+
+static void et_alloc_cb(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
+  buf->base = et_read_buf;
+  buf->len = sizeof(et_read_buf);
+}
+
+
+static void et_write_cb(uv_write_t* req, int status) {
+  ASSERT(status == 0);
+  et_write_cb_called++;
+}
+
+
+static void et_read_cb(uv_stream_t* stream,
+                       ssize_t nread,
+                       const uv_buf_t* buf);
+
+
+static void et_timer_cb(uv_timer_t* handle) {
+  ASSERT(0 == uv_read_start((uv_stream_t*) &et_peer, et_alloc_cb, et_read_cb));
+}
+
+
+static void et_read_cb(uv_stream_t* stream,
+                       ssize_t nread,
+                       const uv_buf_t* buf) {
+  if (nread == UV_EOF) {
+    uv_close((uv_handle_t*) &et_peer, NULL);
+    uv_close((uv_handle_t*) &et_client, NULL);
+    uv_close((uv_handle_t*) &et_server, NULL);
+    uv_close((uv_handle_t*) &et_timer, NULL);
+    return;
+  }
+
+  ASSERT(nread >= 0);
+  et_bytes_read += nread;
+
+  /* Stop reading while data is still pending now and then, the watcher is
+   * re-armed when reading starts again.
+   */
+  if (nread > 0 && et_pauses < 8) {
+    et_pauses++;
+    ASSERT(0 == uv_read_stop(stream));
+    ASSERT(0 == uv_timer_start(&et_timer, et_timer_cb, 1, 0));
+  }
+}
+
+
+static void et_shutdown_cb(uv_shutdown_t* req, int status) {
+  ASSERT(status == 0);
+}
+
+
+static void et_connection_cb(uv_stream_t* server, int status) {
+  ASSERT(status == 0);
+  ASSERT(0 == uv_tcp_init(server->loop, &et_peer));
+  ASSERT(0 == uv_accept(server, (uv_stream_t*) &et_peer));
+  ASSERT(0 == uv_read_start((uv_stream_t*) &et_peer, et_alloc_cb, et_read_cb));
+}
+
+
+static void et_connect_cb(uv_connect_t* req, int status) {
+  static uv_shutdown_t shutdown_req;
+
+  ASSERT(status == 0);
+  ASSERT(0 == uv_shutdown(&shutdown_req, req->handle, et_shutdown_cb));
+}
+
+
+TEST_IMPL(loop_configure_edge_triggered) {
+  struct sockaddr_in addr;
+  uv_loop_t loop;
+  uv_buf_t buf;
+  int i;
+
+  ASSERT(0 == uv_loop_init(&loop));
+#ifdef __linux__
+  ASSERT(0 == uv_loop_configure(&loop, UV_LOOP_EDGE_TRIGGERED));
+#else
+  ASSERT(UV_ENOSYS == uv_loop_configure(&loop, UV_LOOP_EDGE_TRIGGERED));
+#endif
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+  ASSERT(0 == uv_timer_init(&loop, &et_timer));
+  ASSERT(0 == uv_tcp_init(&loop, &et_server));
+  ASSERT(0 == uv_tcp_bind(&et_server, (const struct sockaddr*) &addr, 0));
+  ASSERT(0 == uv_listen((uv_stream_t*) &et_server, 1, et_connection_cb));
+
+  /* The writes are queued until the connection is established, and then
+   * each one is started when the previous one has finished.
+   */
+  ASSERT(0 == uv_tcp_init(&loop, &et_client));
+  ASSERT(0 == uv_tcp_connect(&et_connect_req,
+                             &et_client,
+                             (const struct sockaddr*) &addr,
+                             et_connect_cb));
+  buf = uv_buf_init(et_write_buf, sizeof(et_write_buf));
+  for (i = 0; i < ET_WRITES; i++)
+    ASSERT(0 == uv_write(&et_write_reqs[i],
+                         (uv_stream_t*) &et_client,
+                         &buf,
+                         1,
+                         et_write_cb));
+
+  ASSERT(0 == uv_run(&loop, UV_RUN_DEFAULT));
+  ASSERT(et_write_cb_called == ET_WRITES);
+  ASSERT(et_bytes_read == (size_t) ET_WRITES * ET_WRITE_SIZE);
+  ASSERT(et_pauses == 8);
+  ASSERT(0 == uv_loop_close(&loop));
+  return 0;
+}
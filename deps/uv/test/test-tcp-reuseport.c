@@ -0,0 +1,130 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+#include <string.h>
+
+static uv_tcp_t server1;
+static uv_tcp_t server2;
+static uv_tcp_t server3;
+static uv_tcp_t client;
+static uv_tcp_t accepted;
+static uv_connect_t connect_req;
+static int connection_cb_called;
+static int connect_cb_called;
+static int close_cb_called;
+
+
+static void close_cb(uv_handle_t* handle) {
+  ASSERT(handle != NULL);
+  close_cb_called++;
+}
+
+
+static void connection_cb(uv_stream_t* server, int status) {
+  ASSERT(status == 0);
+  ASSERT(server == (uv_stream_t*) &server1 ||
+         server == (uv_stream_t*) &server2);
+
+  ASSERT(0 == uv_tcp_init(server->loop, &accepted));
+  ASSERT(0 == uv_accept(server, (uv_stream_t*) &accepted));
+  connection_cb_called++;
+
+  uv_close((uv_handle_t*) &accepted, close_cb);
+  uv_close((uv_handle_t*) &server1, close_cb);
+  uv_close((uv_handle_t*) &server2, close_cb);
+}
+
+
+static void connect_cb(uv_connect_t* req, int status) {
+  ASSERT(req == &connect_req);
+  ASSERT(status == 0);
+  connect_cb_called++;
+  uv_close((uv_handle_t*) req->handle, close_cb);
+}
+
+
+TEST_IMPL(tcp_reuseport) {
+  struct sockaddr_in addr;
+  uv_loop_t* loop;
+  int r;
+
+  loop = uv_default_loop();
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+
+  ASSERT(0 == uv_tcp_init(loop, &server1));
+  r = uv_tcp_bind(&server1, (const struct sockaddr*) &addr, UV_TCP_REUSEPORT);
+  if (r == UV_ENOTSUP) {
+    uv_close((uv_handle_t*) &server1, NULL);
+    uv_run(loop, UV_RUN_DEFAULT);
+    MAKE_VALGRIND_HAPPY();
+    RETURN_SKIP("UV_TCP_REUSEPORT is not supported on this platform");
+  }
+  ASSERT(r == 0);
+
+  ASSERT(0 == uv_tcp_init(loop, &server2));
+  ASSERT(0 == uv_tcp_bind(&server2,
+                          (const struct sockaddr*) &addr,
+                          UV_TCP_REUSEPORT));
+
+  /* A socket that doesn't opt in can't join the group. */
+  ASSERT(0 == uv_tcp_init(loop, &server3));
+  ASSERT(0 == uv_tcp_bind(&server3, (const struct sockaddr*) &addr, 0));
+
+  ASSERT(0 == uv_listen((uv_stream_t*) &server1, 128, connection_cb));
+  ASSERT(0 == uv_listen((uv_stream_t*) &server2, 128, connection_cb));
+  ASSERT(UV_EADDRINUSE == uv_listen((uv_stream_t*) &server3, 128, NULL));
+  uv_close((uv_handle_t*) &server3, close_cb);
+
+  ASSERT(0 == uv_tcp_init(loop, &client));
+  ASSERT(0 == uv_tcp_connect(&connect_req,
+                             &client,
+                             (const struct sockaddr*) &addr,
+                             connect_cb));
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(connection_cb_called == 1);
+  ASSERT(connect_cb_called == 1);
+  ASSERT(close_cb_called == 5);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+TEST_IMPL(tcp_reuseport_ipv6only_mismatch) {
+  struct sockaddr_in addr;
+  uv_tcp_t server;
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+  ASSERT(0 == uv_tcp_init(uv_default_loop(), &server));
+  ASSERT(UV_EINVAL == uv_tcp_bind(&server,
+                                  (const struct sockaddr*) &addr,
+                                  UV_TCP_IPV6ONLY | UV_TCP_REUSEPORT));
+
+  uv_close((uv_handle_t*) &server, NULL);
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
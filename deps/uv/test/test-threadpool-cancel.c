@@ -284,6 +284,13 @@ TEST_IMPL(threadpool_cancel_fs) {
   unsigned n;
   uv_buf_t iov;
 
+#ifdef __linux__
+  /* Requests that go through io_uring are owned by the kernel and can't be
+   * cancelled. Force everything through the thread pool.
+   */
+  setenv("UV_USE_IO_URING", "0", 1);
+#endif
+
   INIT_CANCEL_INFO(&ci, reqs);
   loop = uv_default_loop();
   saturate_threadpool();
@@ -74,3 +74,100 @@ TEST_IMPL(threadpool_queue_work_einval) {
   MAKE_VALGRIND_HAPPY();
   return 0;
 }
+
+
+static uv_work_t pause_req;
+static uv_sem_t pause_sem;
+static uv_fs_t fs_req;
+static int fs_cb_count;
+
+
+static void pause_cb(uv_work_t* req) {
+  uv_sem_wait(&pause_sem);
+}
+
+
+static void after_pause_cb(uv_work_t* req, int status) {
+  ASSERT(status == 0);
+  ASSERT(work_cb_count == 1);
+  ASSERT(fs_cb_count == 1);
+  uv_sem_destroy(&pause_sem);
+}
+
+
+static void fs_cb(uv_fs_t* req) {
+  ASSERT(req == &fs_req);
+  ASSERT(req->result == 0);
+  uv_fs_req_cleanup(req);
+  fs_cb_count++;
+}
+
+
+static void after_pool_work_cb(uv_work_t* req, int status) {
+  after_work_cb(req, status);
+  if (fs_cb_count == 1)
+    uv_sem_post(&pause_sem);
+}
+
+
+static void pool_fs_cb(uv_fs_t* req) {
+  fs_cb(req);
+  if (after_work_cb_count == 1)
+    uv_sem_post(&pause_sem);
+}
+
+
+TEST_IMPL(threadpool_queue_work_pool) {
+  uv_loop_t* loop;
+
+  /* Occupy the only thread of the default pool.  Work on the named pools
+   * must still make progress.
+   */
+  ASSERT(0 == putenv("UV_THREADPOOL_SIZE=1"));
+  ASSERT(0 == putenv("UV_THREADPOOL_SIZE_TEST=1"));
+  ASSERT(0 == putenv("UV_THREADPOOL_SIZE_FS=1"));
+
+  loop = uv_default_loop();
+  ASSERT(0 == uv_sem_init(&pause_sem, 0));
+  ASSERT(0 == uv_queue_work(loop, &pause_req, pause_cb, after_pause_cb));
+
+  work_req.data = &data;
+  ASSERT(0 == uv_queue_work_pool(loop,
+                                 &work_req,
+                                 "test",
+                                 work_cb,
+                                 after_pool_work_cb));
+  ASSERT(0 == uv_fs_stat(loop, &fs_req, ".", pool_fs_cb));
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+
+  ASSERT(work_cb_count == 1);
+  ASSERT(after_work_cb_count == 1);
+  ASSERT(fs_cb_count == 1);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+TEST_IMPL(threadpool_queue_work_pool_default) {
+  /* A pool without a configured size runs on the default pool. */
+  work_req.data = &data;
+  ASSERT(0 == uv_queue_work_pool(uv_default_loop(),
+                                 &work_req,
+                                 "unconfigured",
+                                 work_cb,
+                                 after_work_cb));
+  ASSERT(UV_EINVAL == uv_queue_work_pool(uv_default_loop(),
+                                         &pause_req,
+                                         "unconfigured",
+                                         NULL,
+                                         after_work_cb));
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+
+  ASSERT(work_cb_count == 1);
+  ASSERT(after_work_cb_count == 1);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
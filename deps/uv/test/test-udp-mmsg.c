@@ -0,0 +1,168 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK_HANDLE(handle) \
+  ASSERT((uv_udp_t*)(handle) == &recver || (uv_udp_t*)(handle) == &sender)
+
+#define BUFFER_MULTIPLIER 20
+#define MAX_DGRAM_SIZE (64 * 1024)
+#define NUM_SENDS 8
+#define EXPECTED_MMSG_ALLOCS (NUM_SENDS / BUFFER_MULTIPLIER + 1)
+
+static uv_udp_t recver;
+static uv_udp_t sender;
+static int recv_cb_called;
+static int received_datagrams;
+static int free_cb_called;
+static int close_cb_called;
+static int alloc_cb_called;
+
+
+static void alloc_cb(uv_handle_t* handle,
+                     size_t suggested_size,
+                     uv_buf_t* buf) {
+  size_t buffer_size;
+  CHECK_HANDLE(handle);
+
+  /* Only allocate enough room for multiple dgrams if we can use recvmmsg */
+  buffer_size = MAX_DGRAM_SIZE * BUFFER_MULTIPLIER;
+
+  buf->base = malloc(buffer_size);
+  ASSERT(buf->base != NULL);
+  buf->len = buffer_size;
+  alloc_cb_called++;
+}
+
+
+static void close_cb(uv_handle_t* handle) {
+  CHECK_HANDLE(handle);
+  close_cb_called++;
+}
+
+
+static void recv_cb(uv_udp_t* handle,
+                    ssize_t nread,
+                    const uv_buf_t* rcvbuf,
+                    const struct sockaddr* addr,
+                    unsigned flags) {
+  ASSERT(nread >= 0);
+  recv_cb_called++;
+
+  /* free and return if this is a mmsg free-only callback invocation */
+  if (nread == 0 && addr == NULL) {
+    ASSERT(!(flags & UV_UDP_MMSG_CHUNK));
+    free(rcvbuf->base);
+    free_cb_called++;
+    return;
+  }
+
+  ASSERT(nread == 4);
+  ASSERT(addr != NULL);
+  ASSERT(memcmp("PING", rcvbuf->base, nread) == 0);
+
+  if (flags & UV_UDP_MMSG_CHUNK) {
+#ifndef __linux__
+    ASSERT(0 && "recvmmsg is only used on Linux");
+#endif
+  } else {
+    /* Not a chunk of a larger buffer, so it has to be released here. */
+    free(rcvbuf->base);
+  }
+
+  if (++received_datagrams == NUM_SENDS) {
+    uv_close((uv_handle_t*) handle, close_cb);
+    uv_close((uv_handle_t*) &sender, close_cb);
+  }
+}
+
+
+TEST_IMPL(udp_mmsg) {
+  struct sockaddr_in addr;
+  struct sockaddr* addrs[NUM_SENDS];
+  uv_buf_t bufs[NUM_SENDS];
+  uv_buf_t* bufptrs[NUM_SENDS];
+  unsigned int nbufs[NUM_SENDS];
+  int sent;
+  int i;
+
+  ASSERT(0 == uv_ip4_addr("0.0.0.0", TEST_PORT, &addr));
+  ASSERT(0 == uv_udp_init_ex(uv_default_loop(),
+                             &recver,
+                             AF_UNSPEC | UV_UDP_RECVMMSG));
+  ASSERT(0 == uv_udp_bind(&recver, (const struct sockaddr*) &addr, 0));
+
+  ASSERT(0 == uv_udp_init(uv_default_loop(), &sender));
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+
+  for (i = 0; i < NUM_SENDS; i++) {
+    bufs[i] = uv_buf_init("PING", 4);
+    bufptrs[i] = &bufs[i];
+    nbufs[i] = 1;
+    addrs[i] = (struct sockaddr*) &addr;
+  }
+
+  ASSERT(UV_EINVAL == uv_udp_try_send2(&sender, 0, bufptrs, nbufs, addrs, 0));
+  ASSERT(UV_EINVAL == uv_udp_try_send2(&sender, 1, bufptrs, nbufs, addrs, 1));
+
+  /* Queue the datagrams before reading so that they can be picked up by a
+   * single recvmmsg() call.
+   */
+  for (sent = 0; sent < NUM_SENDS; sent += i) {
+    i = uv_udp_try_send2(&sender,
+                         NUM_SENDS - sent,
+                         bufptrs + sent,
+                         nbufs + sent,
+                         addrs + sent,
+                         0);
+    ASSERT(i > 0);
+  }
+  ASSERT(sent == NUM_SENDS);
+
+  ASSERT(0 == uv_udp_recv_start(&recver, alloc_cb, recv_cb));
+
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+
+  ASSERT(close_cb_called == 2);
+  ASSERT(received_datagrams == NUM_SENDS);
+
+  ASSERT(sender.send_queue_size == 0);
+  ASSERT(recver.send_queue_size == 0);
+
+  printf("%d allocs for %d recvs\n", alloc_cb_called, recv_cb_called);
+
+#ifdef __linux__
+  /* On Linux the datagrams arrive in batches, each with a final
+   * free-only callback.
+   */
+  ASSERT(alloc_cb_called <= EXPECTED_MMSG_ALLOCS + 1);
+  ASSERT(free_cb_called == alloc_cb_called);
+#endif
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -0,0 +1,137 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK_HANDLE(handle) \
+  ASSERT((uv_udp_t*)(handle) == &recver || (uv_udp_t*)(handle) == &sender)
+
+#define SEGMENT_SIZE 1000
+#define NUM_SEGMENTS 4
+#define LAST_SEGMENT_SIZE 500
+#define SEND_SIZE (SEGMENT_SIZE * (NUM_SEGMENTS - 1) + LAST_SEGMENT_SIZE)
+
+static uv_udp_t recver;
+static uv_udp_t sender;
+static char send_data[SEND_SIZE];
+static int close_cb_called;
+static int free_cb_called;
+static int segments_received;
+static size_t bytes_received;
+
+
+static void alloc_cb(uv_handle_t* handle,
+                     size_t suggested_size,
+                     uv_buf_t* buf) {
+  CHECK_HANDLE(handle);
+  buf->base = malloc(suggested_size);
+  ASSERT(buf->base != NULL);
+  buf->len = suggested_size;
+}
+
+
+static void close_cb(uv_handle_t* handle) {
+  CHECK_HANDLE(handle);
+  close_cb_called++;
+}
+
+
+static void recv_cb(uv_udp_t* handle,
+                    ssize_t nread,
+                    const uv_buf_t* rcvbuf,
+                    const struct sockaddr* addr,
+                    unsigned flags) {
+  ASSERT(nread >= 0);
+
+  if (nread == 0 && addr == NULL) {
+    free(rcvbuf->base);
+    free_cb_called++;
+    return;
+  }
+
+  ASSERT(addr != NULL);
+
+  /* The kernel may or may not coalesce the segments; both are fine as long
+   * as every segment is reported separately and in order.
+   */
+  if ((size_t) nread < SEND_SIZE - bytes_received)
+    ASSERT(nread == SEGMENT_SIZE);
+  else
+    ASSERT(nread == LAST_SEGMENT_SIZE);
+  ASSERT(0 == memcmp(rcvbuf->base, send_data + bytes_received, nread));
+
+  if (!(flags & UV_UDP_MMSG_CHUNK))
+    free(rcvbuf->base);
+
+  bytes_received += nread;
+  if (++segments_received == NUM_SEGMENTS) {
+    uv_close((uv_handle_t*) handle, close_cb);
+    uv_close((uv_handle_t*) &sender, close_cb);
+  }
+}
+
+
+TEST_IMPL(udp_segment_offload) {
+  struct sockaddr_in addr;
+  uv_buf_t buf;
+  int r;
+  int i;
+
+  for (i = 0; i < SEND_SIZE; i++)
+    send_data[i] = i % 251;
+
+  ASSERT(0 == uv_ip4_addr("127.0.0.1", TEST_PORT, &addr));
+
+  ASSERT(0 == uv_udp_init_ex(uv_default_loop(), &recver, AF_INET));
+  ASSERT(0 == uv_udp_bind(&recver, (const struct sockaddr*) &addr, 0));
+
+  ASSERT(0 == uv_udp_init_ex(uv_default_loop(), &sender, AF_INET));
+
+  r = uv_udp_set_gro(&recver, 1);
+  if (r == UV_ENOTSUP || r == UV_ENOPROTOOPT) {
+    MAKE_VALGRIND_HAPPY();
+    RETURN_SKIP("UDP segmentation offload not supported");
+  }
+  ASSERT(r == 0);
+
+  ASSERT(UV_EINVAL == uv_udp_set_segment_size(&sender, 65536));
+  ASSERT(0 == uv_udp_set_segment_size(&sender, SEGMENT_SIZE));
+
+  ASSERT(0 == uv_udp_recv_start(&recver, alloc_cb, recv_cb));
+
+  buf = uv_buf_init(send_data, sizeof(send_data));
+  r = uv_udp_try_send(&sender, &buf, 1, (const struct sockaddr*) &addr);
+  ASSERT(r == SEND_SIZE);
+
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+
+  ASSERT(close_cb_called == 2);
+  ASSERT(segments_received == NUM_SEGMENTS);
+  ASSERT(bytes_received == SEND_SIZE);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -130,6 +130,7 @@
         'test-tcp-unexpected-read.c',
         'test-tcp-oob.c',
         'test-tcp-read-stop.c',
+        'test-tcp-reuseport.c',
         'test-tcp-write-queue-order.c',
         'test-threadpool.c',
         'test-threadpool-cancel.c',
@@ -162,6 +163,8 @@
         'test-udp-multicast-ttl.c',
         'test-udp-multicast-interface.c',
         'test-udp-multicast-interface6.c',
+        'test-udp-mmsg.c',
+        'test-udp-segment-offload.c',
         'test-udp-try-send.c',
         'test-uname.c',
       ],
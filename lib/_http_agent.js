@@ -22,6 +22,7 @@
 'use strict';
 
 const {
+  ArrayPrototypeShift,
   ObjectKeys,
   ObjectSetPrototypeOf,
   ObjectValues,
@@ -32,12 +33,19 @@ const net = require('net');
 const EventEmitter = require('events');
 const debug = require('internal/util/debuglog').debuglog('http');
 const { async_id_symbol } = require('internal/async_hooks').symbols;
+const { getLibuvNow } = internalBinding('timers');
+const { setTimeout, clearTimeout } = require('timers');
 const {
   codes: {
     ERR_INVALID_ARG_TYPE,
+    ERR_INVALID_OPT_VALUE,
   },
 } = require('internal/errors');
+const { validateNumber } = require('internal/validators');
 const kOnKeylog = Symbol('onkeylog');
+const kFreeSocketQueue = Symbol('kFreeSocketQueue');
+const kFreeSocketTimer = Symbol('kFreeSocketTimer');
+const kFreeSocketDeadline = Symbol('kFreeSocketDeadline');
 // New Agent code.
 
 // The largest departure from the previous implementation is that
@@ -85,9 +93,19 @@ function Agent(options) {
   this.keepAlive = this.options.keepAlive || false;
   this.maxSockets = this.options.maxSockets || Agent.defaultMaxSockets;
   this.maxFreeSockets = this.options.maxFreeSockets || 256;
+  this.scheduling = this.options.scheduling || 'fifo';
+  if (this.scheduling !== 'fifo' && this.scheduling !== 'lifo')
+    throw new ERR_INVALID_OPT_VALUE('scheduling', this.scheduling);
+  this.freeSocketTimeout = this.options.freeSocketTimeout || 0;
+  validateNumber(this.freeSocketTimeout, 'options.freeSocketTimeout');
+
+  // Free sockets in the order in which their freeSocketTimeout expires.
+  // Sockets that left the pool in the meantime are skipped lazily.
+  this[kFreeSocketQueue] = [];
+  this[kFreeSocketTimer] = null;
 
   this.on('free', (socket, options) => {
-    const name = this.getName(options);
+    const name = getAgentKey(this, options);
     debug('agent.on(free)', name);
 
     if (socket.writable &&
@@ -121,6 +139,8 @@ function Agent(options) {
           socket._httpMessage = null;
           this.removeSocket(socket, options);
           freeSockets.push(socket);
+          if (this.freeSocketTimeout > 0)
+            expireFreeSocket(this, socket);
         } else {
           // Implementation doesn't want to keep socket alive
           socket.destroy();
@@ -152,6 +172,49 @@ function maybeEnableKeylog(eventName) {
   }
 }
 
+// Destroys |socket| once it has been in the free pool for freeSocketTimeout
+// milliseconds. All free sockets of an agent share a single timer, which is
+// armed for the socket that expires first.
+function expireFreeSocket(agent, socket) {
+  const deadline = getLibuvNow() + agent.freeSocketTimeout;
+  socket[kFreeSocketDeadline] = deadline;
+  agent[kFreeSocketQueue].push(socket, deadline);
+  if (agent[kFreeSocketTimer] === null)
+    startFreeSocketTimer(agent, agent.freeSocketTimeout);
+}
+
+function startFreeSocketTimer(agent, delay) {
+  agent[kFreeSocketTimer] = setTimeout(onFreeSocketTimeout, delay, agent);
+  agent[kFreeSocketTimer].unref();
+}
+
+function onFreeSocketTimeout(agent) {
+  agent[kFreeSocketTimer] = null;
+  const queue = agent[kFreeSocketQueue];
+  const now = getLibuvNow();
+  while (queue.length !== 0) {
+    const deadline = queue[1];
+    if (deadline > now) {
+      startFreeSocketTimer(agent, deadline - now);
+      return;
+    }
+    const socket = ArrayPrototypeShift(queue);
+    ArrayPrototypeShift(queue);
+    // The socket has been reused, or freed again, since this entry was added.
+    if (socket[kFreeSocketDeadline] !== deadline)
+      continue;
+    debug('free socket timeout');
+    socket[kFreeSocketDeadline] = undefined;
+    socket.destroy();
+  }
+}
+
+// The key is stored on the options by createSocket(), which saves
+// recomputing it every time one of its sockets is freed or removed.
+function getAgentKey(agent, options) {
+  return options._agentKey || agent.getName(options);
+}
+
 Agent.defaultMaxSockets = Infinity;
 
 Agent.prototype.createConnection = net.createConnection;
@@ -207,7 +270,10 @@ Agent.prototype.addRequest = function addRequest(req, options, port/* legacy */,
 
   if (freeLen) {
     // We have a free socket, so use that.
-    const socket = this.freeSockets[name].shift();
+    const socket = this.scheduling === 'fifo' ?
+      this.freeSockets[name].shift() :
+      this.freeSockets[name].pop();
+    socket[kFreeSocketDeadline] = undefined;
     // Guard against an uninitialized or user supplied Socket.
     const handle = socket._handle;
     if (handle && typeof handle.asyncReset === 'function') {
@@ -337,7 +403,7 @@ function installListeners(agent, s, options) {
 }
 
 Agent.prototype.removeSocket = function removeSocket(s, options) {
-  const name = this.getName(options);
+  const name = getAgentKey(this, options);
   debug('removeSocket', name, 'writable:', s.writable);
   const sets = [this.sockets];
 
@@ -380,6 +446,11 @@ Agent.prototype.reuseSocket = function reuseSocket(socket, req) {
 };
 
 Agent.prototype.destroy = function destroy() {
+  if (this[kFreeSocketTimer] !== null) {
+    clearTimeout(this[kFreeSocketTimer]);
+    this[kFreeSocketTimer] = null;
+  }
+  this[kFreeSocketQueue] = [];
   for (const set of [this.freeSockets, this.sockets]) {
     for (const key of ObjectKeys(set)) {
       for (const setName of set[key]) {
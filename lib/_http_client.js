@@ -692,7 +692,9 @@ function tickOnSocket(req, socket) {
                     new HTTPClientAsyncResource('HTTPINCOMINGMESSAGE', req),
                     req.maxHeaderSize || 0,
                     req.insecureHTTPParser === undefined ?
-                      isLenient() : req.insecureHTTPParser);
+                      isLenient() : req.insecureHTTPParser,
+                    false,
+                    true);  // Deliver small body pieces together.
   parser.socket = socket;
   parser.outgoing = req;
   req.parser = parser;
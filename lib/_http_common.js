@@ -47,6 +47,7 @@ const kOnHeadersComplete = HTTPParser.kOnHeadersComplete | 0;
 const kOnBody = HTTPParser.kOnBody | 0;
 const kOnMessageComplete = HTTPParser.kOnMessageComplete | 0;
 const kOnExecute = HTTPParser.kOnExecute | 0;
+const kOnMessages = HTTPParser.kOnMessages | 0;
 
 const MAX_HEADER_PAIRS = 2000;
 
@@ -154,7 +155,30 @@ function parserOnMessageComplete() {
   readStart(parser.socket);
 }
 
+// Called instead of parserOnHeadersComplete() and parserOnMessageComplete()
+// by parsers that are initialized to batch messages, once for all of the
+// messages that were parsed before the next body chunk or the end of the
+// buffer. `events` is a flat list of callback ids, each one followed by the
+// arguments for that callback.
+function parserOnMessages(events) {
+  for (let i = 0; i < events.length;) {
+    if (events[i] === kOnHeadersComplete) {
+      parserOnHeadersComplete.call(this, events[i + 1], events[i + 2],
+                                   events[i + 3], events[i + 4],
+                                   events[i + 5], events[i + 6],
+                                   events[i + 7], events[i + 8],
+                                   events[i + 9]);
+      i += 10;
+    } else {
+      parserOnMessageComplete.call(this);
+      i += 1;
+    }
+  }
+}
+
 
+// Parsers are kept for reuse up to the recent peak number of parsers in use,
+// see FreeList. `parsers.stats()` reports how well the pool is doing.
 const parsers = new FreeList('parsers', 1000, function parsersCb() {
   const parser = new HTTPParser();
 
@@ -165,9 +189,10 @@ const parsers = new FreeList('parsers', 1000, function parsersCb() {
   parser[kOnHeadersComplete] = parserOnHeadersComplete;
   parser[kOnBody] = parserOnBody;
   parser[kOnMessageComplete] = parserOnMessageComplete;
+  parser[kOnMessages] = parserOnMessages;
 
   return parser;
-});
+}, true);
 
 function closeParserInstance(parser) { parser.close(); }
 
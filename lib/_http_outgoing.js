@@ -37,8 +37,9 @@ const EE = require('events');
 const Stream = require('stream');
 const internalUtil = require('internal/util');
 const { kOutHeaders, utcDate, kNeedDrain } = require('internal/http');
-const { Buffer } = require('buffer');
+const { Buffer, Rope } = require('buffer');
 const common = require('_http_common');
+const { serializeHeaders } = internalBinding('http_parser');
 const checkIsHttpToken = common._checkIsHttpToken;
 const checkInvalidHeaderChar = common._checkInvalidHeaderChar;
 const {
@@ -361,8 +362,10 @@ function _storeHeader(firstLine, headers) {
     date: false,
     expect: false,
     trailer: false,
-    header: firstLine
+    // [name, value, name, value, ...]
+    fields: []
   };
+  let validate = false;
 
   if (headers) {
     if (headers === this[kOutHeaders]) {
@@ -371,10 +374,12 @@ function _storeHeader(firstLine, headers) {
         processHeader(this, state, entry[0], entry[1], false);
       }
     } else if (ArrayIsArray(headers)) {
+      validate = true;
       for (const entry of headers) {
         processHeader(this, state, entry[0], entry[1], true);
       }
     } else {
+      validate = true;
       for (const key in headers) {
         if (ObjectPrototypeHasOwnProperty(headers, key)) {
           processHeader(this, state, key, headers[key], true);
@@ -383,11 +388,11 @@ function _storeHeader(firstLine, headers) {
     }
   }
 
-  let { header } = state;
+  const { fields } = state;
 
   // Date header
   if (this.sendDate && !state.date) {
-    header += 'Date: ' + utcDate() + CRLF;
+    fields.push('Date', utcDate());
   }
 
   // Force the connection to close when the response is a 204 No Content or
@@ -417,10 +422,10 @@ function _storeHeader(firstLine, headers) {
     const shouldSendKeepAlive = this.shouldKeepAlive &&
         (state.contLen || this.useChunkedEncodingByDefault || this.agent);
     if (shouldSendKeepAlive) {
-      header += 'Connection: keep-alive\r\n';
+      fields.push('Connection', 'keep-alive');
     } else {
       this._last = true;
-      header += 'Connection: close\r\n';
+      fields.push('Connection', 'close');
     }
   }
 
@@ -433,9 +438,9 @@ function _storeHeader(firstLine, headers) {
     } else if (!state.trailer &&
                !this._removedContLen &&
                typeof this._contentLength === 'number') {
-      header += 'Content-Length: ' + this._contentLength + CRLF;
+      fields.push('Content-Length', '' + this._contentLength);
     } else if (!this._removedTE) {
-      header += 'Transfer-Encoding: chunked\r\n';
+      fields.push('Transfer-Encoding', 'chunked');
       this.chunkedEncoding = true;
     } else {
       // We should only be able to get here if both Content-Length and
@@ -453,7 +458,7 @@ function _storeHeader(firstLine, headers) {
     throw new ERR_HTTP_TRAILER_INVALID();
   }
 
-  this._header = header + CRLF;
+  this._header = buildHeader(firstLine, fields, validate);
   this._headerSent = false;
 
   // Wait until the first body chunk, or close(), is sent to flush,
@@ -461,8 +466,34 @@ function _storeHeader(firstLine, headers) {
   if (state.expect) this._send('');
 }
 
+// Serializes the header section, validating the fields if `validate` is true.
+function buildHeader(firstLine, fields, validate) {
+  const result = serializeHeaders(firstLine, fields, validate);
+  if (typeof result === 'string')
+    return result;
+
+  if (typeof result === 'number') {
+    // Throw the same errors as setHeader() would.
+    if (result % 2 === 0)
+      validateHeaderName(fields[result]);
+    else
+      validateHeaderValue(fields[result - 1], fields[result]);
+  }
+
+  // Not all of the fields are one-byte strings.
+  let header = firstLine;
+  for (let i = 0; i < fields.length; i += 2) {
+    if (validate) {
+      validateHeaderName(fields[i]);
+      validateHeaderValue(fields[i], fields[i + 1]);
+    }
+    header += fields[i] + ': ' + fields[i + 1] + CRLF;
+  }
+  return header + CRLF;
+}
+
 function processHeader(self, state, key, value, validate) {
-  if (validate)
+  if (validate && (typeof key !== 'string' || !key))
     validateHeaderName(key);
   if (ArrayIsArray(value)) {
     if (value.length < 2 || !isCookieField(key)) {
@@ -478,9 +509,10 @@ function processHeader(self, state, key, value, validate) {
 }
 
 function storeHeader(self, state, key, value, validate) {
-  if (validate)
+  if (validate && value === undefined)
     validateHeaderValue(key, value);
-  state.header += key + ': ' + value + CRLF;
+  // Names and values are checked for invalid characters by buildHeader().
+  state.fields.push(key, '' + value);
   matchHeader(self, state, key, value);
 }
 
@@ -634,6 +666,27 @@ ObjectDefineProperty(OutgoingMessage.prototype, 'writableEnded', {
 
 
 const crlf_buf = Buffer.from('\r\n');
+// Chunks up to this size are framed in a single Buffer, together with their
+// size line and trailing CRLF, so that each of them is a single write.
+const kMaxFramedChunkLength = 2048;
+const kHexDigits = Buffer.from('0123456789abcdef', 'latin1');
+
+function frameChunk(chunk, encoding, len) {
+  const digits = len < 0x10 ? 1 : len < 0x100 ? 2 : 3;
+  const buf = Buffer.allocUnsafe(digits + len + 4);
+  for (let i = digits - 1, n = len; i >= 0; i--, n >>>= 4)
+    buf[i] = kHexDigits[n & 0xf];
+  buf[digits] = 13;
+  buf[digits + 1] = 10;
+  if (typeof chunk === 'string')
+    buf.write(chunk, digits + 2, len, encoding);
+  else
+    buf.set(chunk, digits + 2);
+  buf[digits + len + 2] = 13;
+  buf[digits + len + 3] = 10;
+  return buf;
+}
+
 OutgoingMessage.prototype.write = function write(chunk, encoding, callback) {
   const ret = write_(this, chunk, encoding, callback, false);
   if (!ret)
@@ -669,9 +722,10 @@ function write_(msg, chunk, encoding, callback, fromEnd) {
     return true;
   }
 
-  if (!fromEnd && typeof chunk !== 'string' && !(chunk instanceof Buffer)) {
+  if (!fromEnd && typeof chunk !== 'string' && !(chunk instanceof Buffer) &&
+      !(chunk instanceof Rope)) {
     throw new ERR_INVALID_ARG_TYPE('first argument',
-                                   ['string', 'Buffer'], chunk);
+                                   ['string', 'Buffer', 'Rope'], chunk);
   }
 
   if (!fromEnd && msg.socket && !msg.socket.writableCorked) {
@@ -680,17 +734,22 @@ function write_(msg, chunk, encoding, callback, fromEnd) {
   }
 
   let ret;
-  if (msg.chunkedEncoding && chunk.length !== 0) {
+  if (chunk instanceof Rope) {
+    ret = sendRope(msg, chunk, callback);
+  } else if (msg.chunkedEncoding && chunk.length !== 0) {
     let len;
     if (typeof chunk === 'string')
       len = Buffer.byteLength(chunk, encoding);
     else
       len = chunk.length;
 
-    msg._send(len.toString(16), 'latin1', null);
-    msg._send(crlf_buf, null, null);
-    msg._send(chunk, encoding, null);
-    ret = msg._send(crlf_buf, null, callback);
+    if (len <= kMaxFramedChunkLength) {
+      ret = msg._send(frameChunk(chunk, encoding, len), null, callback);
+    } else {
+      msg._send(len.toString(16) + '\r\n', 'latin1', null);
+      msg._send(chunk, encoding, null);
+      ret = msg._send(crlf_buf, null, callback);
+    }
   } else {
     ret = msg._send(chunk, encoding, callback);
   }
@@ -700,6 +759,23 @@ function write_(msg, chunk, encoding, callback, fromEnd) {
 }
 
 
+// The chunks of a rope are sent as a single chunk of the chunked encoding,
+// and the socket is corked, so they end up in one writev.
+function sendRope(msg, rope, callback) {
+  const chunks = [...rope];
+  if (chunks.length === 0)
+    return msg._send('', 'latin1', callback);
+  if (msg.chunkedEncoding)
+    msg._send(rope.length.toString(16) + '\r\n', 'latin1', null);
+  for (let i = 0; i < chunks.length - 1; i++)
+    msg._send(chunks[i], null, null);
+  if (!msg.chunkedEncoding)
+    return msg._send(chunks[chunks.length - 1], null, callback);
+  msg._send(chunks[chunks.length - 1], null, null);
+  return msg._send(crlf_buf, null, callback);
+}
+
+
 function writeAfterEndNT(msg, err, callback) {
   msg.emit('error', err);
   if (callback) callback(err);
@@ -756,8 +832,10 @@ OutgoingMessage.prototype.end = function end(chunk, encoding, callback) {
   }
 
   if (chunk) {
-    if (typeof chunk !== 'string' && !(chunk instanceof Buffer)) {
-      throw new ERR_INVALID_ARG_TYPE('chunk', ['string', 'Buffer'], chunk);
+    if (typeof chunk !== 'string' && !(chunk instanceof Buffer) &&
+        !(chunk instanceof Rope)) {
+      throw new ERR_INVALID_ARG_TYPE('chunk', ['string', 'Buffer', 'Rope'],
+                                     chunk);
     }
 
     if (this.finished) {
@@ -915,5 +993,7 @@ function(err, event) {
 };
 
 module.exports = {
-  OutgoingMessage
+  OutgoingMessage,
+  validateHeaderName,
+  validateHeaderValue,
 };
@@ -22,9 +22,12 @@
 'use strict';
 
 const {
+  ArrayIsArray,
   Error,
+  MathCeil,
   ObjectKeys,
   ObjectSetPrototypeOf,
+  SafeMap,
   Symbol,
   SymbolFor,
 } = primordials;
@@ -42,28 +45,44 @@ const {
   kIncomingMessage,
   HTTPParser,
   isLenient,
+  methods,
   _checkInvalidHeaderChar: checkInvalidHeaderChar,
   prepareError,
 } = require('_http_common');
-const { OutgoingMessage } = require('_http_outgoing');
+const {
+  OutgoingMessage,
+  validateHeaderName,
+  validateHeaderValue,
+} = require('_http_outgoing');
 const {
   kOutHeaders,
   kNeedDrain,
   nowDate,
-  emitStatistics
+  emitStatistics,
+  utcDate
 } = require('internal/http');
 const {
   defaultTriggerAsyncIdScope,
-  getOrSetAsyncId
+  getOrSetAsyncId,
+  symbols: { owner_symbol }
 } = require('internal/async_hooks');
 const { IncomingMessage } = require('_http_incoming');
 const {
   ERR_HTTP_HEADERS_SENT,
   ERR_HTTP_INVALID_STATUS_CODE,
   ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_ARG_VALUE,
   ERR_INVALID_CHAR
 } = require('internal/errors').codes;
-const { validateInteger } = require('internal/validators');
+const {
+  validateInteger,
+  validateObject,
+  validateString,
+} = require('internal/validators');
+const { isUint8Array } = require('internal/util/types');
+const { StaticResponses } = internalBinding('http_parser');
+const { TIMEOUT_MAX } = require('internal/timers');
+const { TimerWheel } = internalBinding('timers');
 const Buffer = require('buffer').Buffer;
 const {
   DTRACE_HTTP_SERVER_REQUEST,
@@ -74,6 +93,13 @@ const { NODE_PERFORMANCE_ENTRY_TYPE_HTTP } = constants;
 
 const kServerResponse = Symbol('ServerResponse');
 const kServerResponseStatistics = Symbol('ServerResponseStatistics');
+const kKeepAliveTimers = Symbol('kKeepAliveTimers');
+const kStaticResponses = Symbol('kStaticResponses');
+const kStaticResponsesHandle = Symbol('kStaticResponsesHandle');
+
+// Granularity of the keep-alive timer wheel, in milliseconds. Keep-alive
+// timeouts fire at most this much later than requested.
+const kKeepAliveTimerResolution = 100;
 
 const STATUS_CODES = {
   100: 'Continue',
@@ -372,6 +398,100 @@ Server.prototype.setTimeout = function setTimeout(msecs, callback) {
   return this;
 };
 
+// Static responses are serialized once. Keep-alive requests for them are
+// answered by the native parser, without creating an IncomingMessage, see
+// ServeStaticResponse() in src/node_http_parser.cc. parserOnIncoming()
+// answers the other ones through a ServerResponse.
+Server.prototype.setStaticResponse = function setStaticResponse(
+  method, path, response) {
+  validateString(method, 'method');
+  const methodIndex = methods.indexOf(method);
+  if (methodIndex === -1)
+    throw new ERR_INVALID_ARG_VALUE('method', method);
+  validateString(path, 'path');
+  if (path === '' || /[^\u0021-\u007e]/.test(path))
+    throw new ERR_INVALID_ARG_VALUE('path', path);
+
+  const key = `${method} ${path}`;
+  if (response === null) {
+    if (this[kStaticResponses] !== undefined &&
+        this[kStaticResponses].delete(key)) {
+      this[kStaticResponsesHandle].delete(methodIndex, path);
+    }
+    return this;
+  }
+
+  validateObject(response, 'response');
+  const { statusCode = 200, headers = {}, body = '' } = response;
+  validateInteger(statusCode, 'response.statusCode', 200, 599);
+  validateObject(headers, 'response.headers');
+  let bodyBuffer;
+  if (typeof body === 'string') {
+    bodyBuffer = Buffer.from(body);
+  } else if (isUint8Array(body)) {
+    // Copied, so that later changes do not show up in responses.
+    bodyBuffer = Buffer.from(body);
+  } else {
+    throw new ERR_INVALID_ARG_TYPE(
+      'response.body', ['string', 'Buffer', 'Uint8Array'], body);
+  }
+  const hasBody = statusCode !== 204 && statusCode !== 304;
+  if (!hasBody && bodyBuffer.length !== 0) {
+    throw new ERR_INVALID_ARG_VALUE(
+      'response.body', body, `must be empty for status code ${statusCode}`);
+  }
+
+  let head = `HTTP/1.1 ${statusCode} ${STATUS_CODES[statusCode] || 'unknown'}` +
+             CRLF;
+  const fields = {};
+  const names = ObjectKeys(headers);
+  let hasDate = false;
+  for (let i = 0; i < names.length; i++) {
+    const name = names[i];
+    validateHeaderName(name);
+    const lowerName = name.toLowerCase();
+    if (lowerName === 'connection' || lowerName === 'content-length' ||
+        lowerName === 'transfer-encoding') {
+      throw new ERR_INVALID_ARG_VALUE(
+        'response.headers', headers, `must not include ${name}`);
+    }
+    if (lowerName === 'date')
+      hasDate = true;
+    const value = headers[name];
+    const values = ArrayIsArray(value) ? value : [value];
+    for (let j = 0; j < values.length; j++) {
+      validateHeaderValue(name, values[j]);
+      head += `${name}: ${values[j]}${CRLF}`;
+    }
+    fields[name] = value;
+  }
+  // The native parser keeps the value of the Date header current, see
+  // StaticResponses::UpdateDate() in src/node_http_parser.cc.
+  let dateOffset = -1;
+  if (!hasDate) {
+    dateOffset = head.length + 6;
+    head += `Date: ${utcDate()}${CRLF}`;
+  }
+  if (hasBody) {
+    head += `Content-Length: ${bodyBuffer.length}${CRLF}`;
+    fields['Content-Length'] = bodyBuffer.length;
+  }
+  head += `Connection: keep-alive${CRLF}${CRLF}`;
+  const headBuffer = Buffer.from(head, 'latin1');
+
+  if (this[kStaticResponses] === undefined) {
+    this[kStaticResponses] = new SafeMap();
+    this[kStaticResponsesHandle] = new StaticResponses();
+  }
+  this[kStaticResponses].set(key, { statusCode, fields, body: bodyBuffer });
+  this[kStaticResponsesHandle].set(methodIndex,
+                                   path,
+                                   Buffer.concat([headBuffer, bodyBuffer]),
+                                   headBuffer.length,
+                                   dateOffset);
+  return this;
+};
+
 Server.prototype[EE.captureRejectionSymbol] = function(
   err, event, ...args) {
 
@@ -426,6 +546,9 @@ function connectionListenerInternal(server, socket) {
     server.maxHeaderSize || 0,
     server.insecureHTTPParser === undefined ?
       isLenient() : server.insecureHTTPParser,
+    true,  // Deliver pipelined requests in batches.
+    true,  // Deliver small body pieces together.
+    server[kStaticResponsesHandle],
   );
   parser.socket = socket;
 
@@ -450,7 +573,8 @@ function connectionListenerInternal(server, socket) {
     // need to pause TCP socket/HTTP parser, and wait until the data will be
     // sent to the client.
     outgoingData: 0,
-    keepAliveTimeoutSet: false
+    keepAliveTimeoutSet: false,
+    keepAliveTimerId: -1
   };
   state.onData = socketOnData.bind(undefined, server, socket, parser, state);
   state.onEnd = socketOnEnd.bind(undefined, server, socket, parser, state);
@@ -521,6 +645,8 @@ function socketOnTimeout() {
 
 function socketOnClose(socket, state) {
   debug('server socket close');
+  if (state.keepAliveTimerId !== -1)
+    socket.server[kKeepAliveTimers].clear(state);
   // Mark this parser as reusable
   if (socket.parser) {
     freeParser(socket.parser, null, socket);
@@ -568,8 +694,11 @@ function socketOnData(server, socket, parser, state, d) {
   onParserExecuteCommon(server, socket, parser, state, ret, d);
 }
 
-function onParserExecute(server, socket, parser, state, ret) {
+function onParserExecute(server, socket, parser, state, ret, served) {
   socket._unrefTimer();
+  // Requests that got static responses were parsed completely.
+  if (served > 0 && state.incoming.length === 0)
+    parser.parsingHeadersStart = nowDate();
   const start = parser.parsingHeadersStart;
   debug('SERVER socketOnParserExecute %d', ret);
 
@@ -585,6 +714,15 @@ function onParserExecute(server, socket, parser, state, ret) {
   }
 
   onParserExecuteCommon(server, socket, parser, state, ret, undefined);
+
+  // After static responses, the connection is idle in the same way as after
+  // the last response that was sent from JS, see resOnFinish().
+  if (served > 0 && state.incoming.length === 0 &&
+      socket.parser === parser && !state.keepAliveTimeoutSet &&
+      server.keepAliveTimeout && typeof socket.setTimeout === 'function') {
+    setKeepAliveTimeout(server, socket, state);
+    state.keepAliveTimeoutSet = true;
+  }
 }
 
 const noop = () => {};
@@ -679,6 +817,8 @@ function resOnFinish(req, res, socket, state, server) {
 
   state.incoming.shift();
   clearIncoming(req);
+  if (server[kStaticResponsesHandle] !== undefined && socket.parser)
+    socket.parser.finishResponse();
 
   // If the user never called req.read(), and didn't pipe() or
   // .resume() or .on('data'), then we call req._dump() so that the
@@ -698,7 +838,7 @@ function resOnFinish(req, res, socket, state, server) {
     }
   } else if (state.outgoing.length === 0) {
     if (server.keepAliveTimeout && typeof socket.setTimeout === 'function') {
-      socket.setTimeout(server.keepAliveTimeout);
+      setKeepAliveTimeout(server, socket, state);
       state.keepAliveTimeoutSet = true;
     }
   } else {
@@ -786,7 +926,14 @@ function parserOnIncoming(server, socket, state, req, keepAlive) {
       res.end();
     }
   } else {
-    server.emit('request', req, res);
+    const staticResponse = server[kStaticResponses] !== undefined ?
+      server[kStaticResponses].get(`${req.method} ${req.url}`) : undefined;
+    if (staticResponse !== undefined) {
+      res.writeHead(staticResponse.statusCode, staticResponse.fields);
+      res.end(staticResponse.body);
+    } else {
+      server.emit('request', req, res);
+    }
   }
   return 0;  // No special treatment.
 }
@@ -795,10 +942,92 @@ function resetSocketTimeout(server, socket, state) {
   if (!state.keepAliveTimeoutSet)
     return;
 
-  socket.setTimeout(server.timeout || 0);
+  if (state.keepAliveTimerId !== -1) {
+    server[kKeepAliveTimers].clear(state);
+    if (server.timeout)
+      socket.setTimeout(server.timeout);
+  } else {
+    socket.setTimeout(server.timeout || 0);
+  }
   state.keepAliveTimeoutSet = false;
 }
 
+// The keep-alive timeouts of all idle connections of a server share a single
+// native timer wheel instead of each arming a socket timer, which keeps idle
+// connections from creating and re-linking a Timeout object per request.
+// Nothing can refresh a connection's keep-alive period except a new request,
+// which clears it, so a plain deadline is all that has to be tracked.
+function KeepAliveTimers() {
+  this.handle = null;
+  this.sockets = [];
+  this.states = [];
+  this.freeIds = [];
+  this.armed = 0;
+}
+
+KeepAliveTimers.prototype.set = function set(socket, state, msecs) {
+  if (this.handle === null) {
+    this.handle = new TimerWheel(kKeepAliveTimerResolution);
+    this.handle[owner_symbol] = this;
+    this.handle.ontimeout = onKeepAliveTimeout;
+    this.handle.unref();
+  }
+  const id = this.freeIds.length > 0 ? this.freeIds.pop() : this.sockets.length;
+  this.sockets[id] = socket;
+  this.states[id] = state;
+  state.keepAliveTimerId = id;
+  this.armed++;
+  this.handle.set(id, msecs);
+};
+
+KeepAliveTimers.prototype.clear = function clear(state) {
+  this.handle.clear(state.keepAliveTimerId);
+  this.release(state);
+};
+
+KeepAliveTimers.prototype.release = function release(state) {
+  const id = state.keepAliveTimerId;
+  this.sockets[id] = undefined;
+  this.states[id] = undefined;
+  this.freeIds.push(id);
+  state.keepAliveTimerId = -1;
+  // Do not keep a handle around for servers that have gone idle.
+  if (--this.armed === 0) {
+    this.handle.close();
+    this.handle = null;
+  }
+};
+
+function onKeepAliveTimeout(ids) {
+  const timers = this[owner_symbol];
+  for (let i = 0; i < ids.length; i++) {
+    const id = ids[i];
+    const socket = timers.sockets[id];
+    const state = timers.states[id];
+    timers.release(state);
+    debug('keep-alive timeout');
+    socket.emit('timeout');
+  }
+}
+
+function setKeepAliveTimeout(server, socket, state) {
+  const msecs = server.keepAliveTimeout;
+  if (!(msecs > 0 && msecs <= TIMEOUT_MAX)) {
+    // Leave the unusual cases, e.g. `Infinity`, to `socket.setTimeout()`.
+    socket.setTimeout(msecs);
+    return;
+  }
+
+  // The socket's own idle timeout does not apply while waiting for the next
+  // request, in the same way as when `keepAliveTimeout` replaced it.
+  if (socket.timeout)
+    socket.setTimeout(0);
+  let timers = server[kKeepAliveTimers];
+  if (timers === undefined)
+    timers = server[kKeepAliveTimers] = new KeepAliveTimers();
+  timers.set(socket, state, MathCeil(msecs));
+}
+
 function onSocketResume() {
   // It may seem that the socket is resumed, but this is an enemy's trick to
   // deceive us! `resume` is emitted asynchronously, and may be called from
@@ -37,12 +37,18 @@ module.exports = Readable;
 Readable.ReadableState = ReadableState;
 
 const EE = require('events');
+const { kEmitOne } = require('internal/util');
+const emitOne = EE[kEmitOne];
 const Stream = require('stream');
 const { Buffer } = require('buffer');
 
 const debug = require('internal/util/debuglog').debuglog('stream');
 const BufferList = require('internal/streams/buffer_list');
 const destroyImpl = require('internal/streams/destroy');
+const {
+  validateBoolean,
+  validateObject,
+} = require('internal/validators');
 const {
   getHighWaterMark,
   getDefaultHighWaterMark
@@ -294,7 +300,7 @@ function addChunk(stream, state, chunk, addToFront) {
     } else {
       state.awaitDrainWriters = null;
     }
-    stream.emit('data', chunk);
+    emitOne(stream, 'data', chunk);
   } else {
     // Update the buffer info.
     state.length += state.objectMode ? 1 : chunk.length;
@@ -377,7 +383,18 @@ function howMuchToRead(n, state) {
 
 // You can override either this method, or the async _read(n) below.
 Readable.prototype.read = function(n) {
-  debug('read', n);
+  return read(this, n, false);
+};
+
+// Returns all of the buffered chunks as an array, or null if nothing is
+// buffered. The chunks are not concatenated, and in object mode every buffered
+// object is returned at once.
+Readable.prototype.readv = function() {
+  return read(this, undefined, true);
+};
+
+function read(stream, n, all) {
+  debug('read', n, all);
   // Same as parseInt(undefined, 10), however V8 7.3 performance regressed
   // in this scenario, so we are doing it manually.
   if (n === undefined) {
@@ -385,7 +402,7 @@ Readable.prototype.read = function(n) {
   } else if (!NumberIsInteger(n)) {
     n = parseInt(n, 10);
   }
-  const state = this._readableState;
+  const state = stream._readableState;
   const nOrig = n;
 
   // If we're asking for more than the current hwm, then raise the hwm.
@@ -406,18 +423,18 @@ Readable.prototype.read = function(n) {
        state.ended)) {
     debug('read: emitReadable', state.length, state.ended);
     if (state.length === 0 && state.ended)
-      endReadable(this);
+      endReadable(stream);
     else
-      emitReadable(this);
+      emitReadable(stream);
     return null;
   }
 
-  n = howMuchToRead(n, state);
+  n = all ? state.length : howMuchToRead(n, state);
 
   // If we've ended, and we're now clear, then finish it up.
   if (n === 0 && state.ended) {
     if (state.length === 0)
-      endReadable(this);
+      endReadable(stream);
     return null;
   }
 
@@ -467,17 +484,17 @@ Readable.prototype.read = function(n) {
     if (state.length === 0)
       state.needReadable = true;
     // Call internal read method
-    this._read(state.highWaterMark);
+    stream._read(state.highWaterMark);
     state.sync = false;
     // If _read pushed data synchronously, then `reading` will be false,
     // and we need to re-evaluate how much data we can return to the user.
     if (!state.reading)
-      n = howMuchToRead(nOrig, state);
+      n = all ? state.length : howMuchToRead(nOrig, state);
   }
 
   var ret;
   if (n > 0)
-    ret = fromList(n, state);
+    ret = all ? fromListAll(state) : fromList(n, state);
   else
     ret = null;
 
@@ -501,14 +518,20 @@ Readable.prototype.read = function(n) {
 
     // If we tried to read() past the EOF, then emit end on the next tick.
     if (nOrig !== n && state.ended)
-      endReadable(this);
+      endReadable(stream);
   }
 
-  if (ret !== null)
-    this.emit('data', ret);
+  if (ret !== null) {
+    if (!all) {
+      emitOne(stream, 'data', ret);
+    } else if (stream.listenerCount('data') > 0) {
+      for (const chunk of ret)
+        emitOne(stream, 'data', chunk);
+    }
+  }
 
   return ret;
-};
+}
 
 function onEofChunk(stream, state) {
   debug('onEofChunk');
@@ -1054,6 +1077,17 @@ Readable.prototype[SymbolAsyncIterator] = function() {
   return createReadableStreamAsyncIterator(this);
 };
 
+Readable.prototype.iterator = function(options = {}) {
+  validateObject(options, 'options');
+  const { batch = false } = options;
+  validateBoolean(batch, 'options.batch');
+  if (createReadableStreamAsyncIterator === undefined) {
+    createReadableStreamAsyncIterator =
+      require('internal/streams/async_iterator');
+  }
+  return createReadableStreamAsyncIterator(this, batch);
+};
+
 // Making it explicit these properties are not enumerable
 // because otherwise some prototype manipulation in
 // userland will fail
@@ -1172,6 +1206,13 @@ Readable._fromList = fromList;
 // Length is the combined lengths of all the buffers in the list.
 // This function is designed to be inlinable, so please take care when making
 // changes to the function body.
+// Takes all chunks from the buffer.
+function fromListAll(state) {
+  if (state.length === 0)
+    return null;
+  return state.buffer.drain();
+}
+
 function fromList(n, state) {
   // nothing buffered
   if (state.length === 0)
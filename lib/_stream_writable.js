@@ -41,7 +41,7 @@ Writable.WritableState = WritableState;
 
 const EE = require('events');
 const Stream = require('stream');
-const { Buffer } = require('buffer');
+const { Buffer, Rope } = require('buffer');
 const destroyImpl = require('internal/streams/destroy');
 const {
   getHighWaterMark,
@@ -291,9 +291,11 @@ Writable.prototype.write = function(chunk, encoding, cb) {
     } else if (Stream._isUint8Array(chunk)) {
       chunk = Stream._uint8ArrayToBuffer(chunk);
       encoding = 'buffer';
+    } else if (chunk instanceof Rope) {
+      return writeRope(this, chunk, cb);
     } else {
       err = new ERR_INVALID_ARG_TYPE(
-        'chunk', ['string', 'Buffer', 'Uint8Array'], chunk);
+        'chunk', ['string', 'Buffer', 'Uint8Array', 'Rope'], chunk);
     }
   }
 
@@ -307,6 +309,20 @@ Writable.prototype.write = function(chunk, encoding, cb) {
   }
 };
 
+// Writes the chunks of a rope while corked, so that streams that implement
+// _writev() get all of them at once.
+function writeRope(stream, rope, cb) {
+  const chunks = [...rope];
+  if (chunks.length === 0)
+    return stream.write(Buffer.alloc(0), cb);
+  stream.cork();
+  for (let i = 0; i < chunks.length - 1; i++)
+    stream.write(chunks[i]);
+  const ret = stream.write(chunks[chunks.length - 1], cb);
+  stream.uncork();
+  return ret;
+}
+
 Writable.prototype.cork = function() {
   this._writableState.corked++;
 };
@@ -32,6 +32,7 @@ const tls = require('tls');
 const {
   ERR_CRYPTO_CUSTOM_ENGINE_NOT_SUPPORTED,
   ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_CALLBACK,
   ERR_INVALID_OPT_VALUE,
   ERR_TLS_INVALID_PROTOCOL_VERSION,
   ERR_TLS_PROTOCOL_VERSION_CONFLICT,
@@ -43,6 +44,7 @@ const {
   TLS1_2_VERSION,
   TLS1_3_VERSION,
 } = internalBinding('constants').crypto;
+const { AsyncWrap, Providers } = internalBinding('async_wrap');
 
 // Lazily loaded from internal/crypto/util.
 let toBuf = null;
@@ -91,9 +93,13 @@ function validateKeyOrCertOption(name, value) {
 exports.SecureContext = SecureContext;
 
 
-exports.createSecureContext = function createSecureContext(options) {
+exports.createSecureContext = function createSecureContext(options,
+                                                           callback) {
   if (!options) options = {};
 
+  if (callback !== undefined && typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK(callback);
+
   let secureOptions = options.secureOptions;
   if (options.honorCipherOrder)
     secureOptions |= SSL_OP_CIPHER_SERVER_PREFERENCE;
@@ -101,6 +107,11 @@ exports.createSecureContext = function createSecureContext(options) {
   const c = new SecureContext(options.secureProtocol, secureOptions,
                               options.minVersion, options.maxVersion);
 
+  if (callback !== undefined) {
+    loadCredentials(c, options, callback);
+    return;
+  }
+
   // Add CA before the cert to be able to load cert's issuer in C++ code.
   const { ca } = options;
   if (ca) {
@@ -150,6 +161,79 @@ exports.createSecureContext = function createSecureContext(options) {
     }
   }
 
+  configureSecureContext(c, options);
+  return c;
+};
+
+function toArray(value) {
+  return ArrayIsArray(value) ? value : [value];
+}
+
+function validatePassphrase(passphrase) {
+  if (passphrase == null)
+    return undefined;
+  if (typeof passphrase !== 'string')
+    throw new ERR_INVALID_ARG_TYPE('options.passphrase', 'string', passphrase);
+  return passphrase;
+}
+
+// Same as the `ca`, `cert` and `key` handling of createSecureContext(), but
+// the PEM data is parsed on the threadpool. The remaining options are applied
+// once it has been added to the context.
+function loadCredentials(c, options, callback) {
+  const { ca, cert, key, passphrase } = options;
+
+  const cas = [];
+  if (ca) {
+    for (const val of toArray(ca)) {
+      validateKeyOrCertOption('ca', val);
+      cas.push(val);
+    }
+  } else {
+    c.context.addRootCerts();
+  }
+
+  const certs = [];
+  if (cert) {
+    for (const val of toArray(cert)) {
+      validateKeyOrCertOption('cert', val);
+      certs.push(val);
+    }
+  }
+
+  const keys = [];
+  const passphrases = [];
+  if (key) {
+    if (ArrayIsArray(key)) {
+      for (const val of key) {
+        // eslint-disable-next-line eqeqeq
+        const pem = (val != undefined && val.pem !== undefined ? val.pem : val);
+        validateKeyOrCertOption('key', pem);
+        keys.push(pem);
+        passphrases.push(validatePassphrase(val.passphrase || passphrase));
+      }
+    } else {
+      validateKeyOrCertOption('key', key);
+      keys.push(key);
+      passphrases.push(validatePassphrase(passphrase));
+    }
+  }
+
+  const wrap = new AsyncWrap(Providers.SECURECONTEXTLOADREQUEST);
+  wrap.ondone = (err) => {
+    if (err)
+      return callback.call(wrap, err);
+    try {
+      configureSecureContext(c, options);
+    } catch (err) {
+      return callback.call(wrap, err);
+    }
+    callback.call(wrap, null, c);
+  };
+  c.context.loadCredentials(cas, certs, keys, passphrases, wrap);
+}
+
+function configureSecureContext(c, options) {
   const sigalgs = options.sigalgs;
   if (sigalgs !== undefined) {
     if (typeof sigalgs !== 'string') {
@@ -170,7 +254,7 @@ exports.createSecureContext = function createSecureContext(options) {
       throw new ERR_INVALID_OPT_VALUE('privateKeyEngine',
                                       privateKeyEngine);
     }
-    if (key) {
+    if (options.key) {
       // Both data key and engine key can't be set at the same time
       throw new ERR_INVALID_OPT_VALUE('privateKeyIdentifier',
                                       privateKeyIdentifier);
@@ -293,9 +377,7 @@ exports.createSecureContext = function createSecureContext(options) {
                                    ['string', 'null', 'undefined'],
                                    options.clientCertEngine);
   }
-
-  return c;
-};
+}
 
 // Translate some fields from the handle's C-friendly format into more idiomatic
 // javascript object representations before passing them back to the user.  Can
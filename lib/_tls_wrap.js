@@ -22,6 +22,8 @@
 'use strict';
 
 const {
+  MathMax,
+  MathMin,
   ObjectAssign,
   ObjectDefineProperty,
   ObjectSetPrototypeOf,
@@ -37,7 +39,7 @@ const {
 
 assertCrypto();
 
-const { setImmediate } = require('timers');
+const { clearTimeout, setImmediate, setTimeout } = require('timers');
 const assert = require('internal/assert');
 const crypto = require('crypto');
 const EE = require('events');
@@ -70,7 +72,11 @@ const {
 } = codes;
 const { onpskexchange: kOnPskExchange } = internalBinding('symbols');
 const { getOptionValue } = require('internal/options');
-const { validateString, validateBuffer } = require('internal/validators');
+const {
+  validateString,
+  validateBuffer,
+  validateUint32
+} = require('internal/validators');
 const traceTls = getOptionValue('--trace-tls');
 const tlsKeylog = getOptionValue('--tls-keylog');
 const { appendFile } = require('fs');
@@ -80,9 +86,24 @@ const kErrorEmitted = Symbol('error-emitted');
 const kHandshakeTimeout = Symbol('handshake-timeout');
 const kRes = Symbol('res');
 const kSNICallback = Symbol('snicallback');
+const kNativeSNIContexts = Symbol('native-sni-contexts');
 const kEnableTrace = Symbol('enableTrace');
+const kKTLS = Symbol('ktls');
+const kDynamicRecordSize = Symbol('dynamic-record-size');
+const kCoalesceWrites = Symbol('coalesce-writes');
 const kPskCallback = Symbol('pskcallback');
 const kPskIdentityHint = Symbol('pskidentityhint');
+const kOCSPStapleCallback = Symbol('ocspstaplecallback');
+const kOCSPStapleTimer = Symbol('ocspstapletimer');
+// Same as OpenSSL's SSL_SESSION_CACHE_MAX_SIZE_DEFAULT.
+const kDefaultSharedSessionCacheSize = 20 * 1024;
+// Stapled OCSP responses are refreshed halfway to their nextUpdate time, but
+// not sooner than this. Failed refreshes are retried after this delay too.
+const kOCSPStapleRetryDelay = 60 * 1000;
+// For responses that do not have a nextUpdate time.
+const kOCSPStapleRefreshDelay = 60 * 60 * 1000;
+// The largest delay that setTimeout() accepts.
+const kMaxTimerDelay = 2 ** 31 - 1;
 
 const noop = () => {};
 
@@ -180,7 +201,8 @@ function loadSession(hello) {
 function loadSNI(info) {
   const owner = this[owner_symbol];
   const servername = info.servername;
-  if (!servername || !owner._SNICallback)
+  // A context from server.addContext() may have been selected natively.
+  if (!servername || !owner._SNICallback || owner._handle.sni_context)
     return requestOCSP(owner, info);
 
   let once = false;
@@ -465,6 +487,7 @@ function TLSSocket(socket, opts) {
   this.authorized = false;
   this.authorizationError = null;
   this[kRes] = null;
+  this[kCoalesceWrites] = false;
 
   let wrap;
   if ((socket instanceof net.Socket && socket._handle) || !socket) {
@@ -745,11 +768,14 @@ TLSSocket.prototype._init = function(socket, wrap) {
 
   // If custom SNICallback was given, or if
   // there're SNI contexts to perform match against -
-  // set `.onsniselect` callback.
+  // set `.onsniselect` callback. SNI contexts that are matched natively
+  // do not need it.
   if (options.isServer &&
       options.SNICallback &&
       (options.SNICallback !== SNICallback ||
-       (options.server && options.server._contexts.length))) {
+       (options.server &&
+        options.server._contexts.length >
+          options.server[kNativeSNIContexts]))) {
     assert(typeof options.SNICallback === 'function');
     this._SNICallback = options.SNICallback;
     ssl.enableCertCb();
@@ -761,6 +787,30 @@ TLSSocket.prototype._init = function(socket, wrap) {
     ssl.setALPNProtocols(ssl._secureContext.alpnBuffer);
   }
 
+  if (options.ktls !== undefined) {
+    if (typeof options.ktls !== 'boolean')
+      throw new ERR_INVALID_ARG_TYPE('options.ktls', 'boolean', options.ktls);
+    if (options.ktls)
+      ssl.enableKTLS();
+  }
+
+  if (options.dynamicRecordSize !== undefined) {
+    if (typeof options.dynamicRecordSize !== 'boolean') {
+      throw new ERR_INVALID_ARG_TYPE('options.dynamicRecordSize', 'boolean',
+                                     options.dynamicRecordSize);
+    }
+    if (options.dynamicRecordSize)
+      ssl.enableDynamicRecordSize();
+  }
+
+  if (options.coalesceWrites !== undefined) {
+    if (typeof options.coalesceWrites !== 'boolean') {
+      throw new ERR_INVALID_ARG_TYPE('options.coalesceWrites', 'boolean',
+                                     options.coalesceWrites);
+    }
+    this[kCoalesceWrites] = options.coalesceWrites;
+  }
+
   if (options.pskCallback && ssl.enablePskCallback) {
     if (typeof options.pskCallback !== 'function') {
       throw new ERR_INVALID_ARG_TYPE('pskCallback',
@@ -860,6 +910,21 @@ TLSSocket.prototype.renegotiate = function(options, callback) {
   return true;
 };
 
+// With `coalesceWrites`, the socket is corked until the next tick on the first
+// write, so that all the writes of the current tick are passed to SSL_write()
+// together and are sent in as few records as possible.
+TLSSocket.prototype.write = function write(chunk, encoding, cb) {
+  if (this[kCoalesceWrites] && this.writableCorked === 0) {
+    this.cork();
+    process.nextTick(uncorkNT, this);
+  }
+  return net.Socket.prototype.write.call(this, chunk, encoding, cb);
+};
+
+function uncorkNT(socket) {
+  socket.uncork();
+}
+
 TLSSocket.prototype.setMaxSendFragment = function setMaxSendFragment(size) {
   return this._handle.setMaxSendFragment(size) === 1;
 };
@@ -993,6 +1058,7 @@ function makeSocketMethodProxy(name) {
   'getSession',
   'getTLSTicket',
   'isSessionReused',
+  'isKTLSEnabled',
   'enableTrace',
 ].forEach((method) => {
   TLSSocket.prototype[method] = makeSocketMethodProxy(method);
@@ -1053,6 +1119,9 @@ function tlsConnectionListener(rawSocket) {
     ALPNProtocols: this.ALPNProtocols,
     SNICallback: this[kSNICallback] || SNICallback,
     enableTrace: this[kEnableTrace],
+    ktls: this[kKTLS],
+    dynamicRecordSize: this[kDynamicRecordSize],
+    coalesceWrites: this[kCoalesceWrites],
     pauseOnConnect: this.pauseOnConnect,
     pskCallback: this[kPskCallback],
     pskIdentityHint: this[kPskIdentityHint],
@@ -1113,6 +1182,8 @@ function tlsConnectionListener(rawSocket) {
 // - clientCertEngine: string.
 // - ca: string or array of strings.
 // - sessionTimeout: integer.
+// - sharedSessionCache: string.
+// - sharedSessionCacheSize: integer.
 //
 // emit 'secureConnection'
 //   function (tlsSocket) { }
@@ -1162,6 +1233,8 @@ function Server(options, listener) {
   this[kSNICallback] = options.SNICallback;
   this[kPskCallback] = options.pskCallback;
   this[kPskIdentityHint] = options.pskIdentityHint;
+  this[kOCSPStapleCallback] = options.OCSPStapleCallback;
+  this[kOCSPStapleTimer] = null;
 
   if (typeof this[kHandshakeTimeout] !== 'number') {
     throw new ERR_INVALID_ARG_TYPE(
@@ -1184,6 +1257,11 @@ function Server(options, listener) {
       options.pskIdentityHint
     );
   }
+  if (this[kOCSPStapleCallback] &&
+      typeof this[kOCSPStapleCallback] !== 'function') {
+    throw new ERR_INVALID_ARG_TYPE(
+      'options.OCSPStapleCallback', 'function', options.OCSPStapleCallback);
+  }
 
   // constructor call
   net.Server.call(this, options, tlsConnectionListener);
@@ -1192,7 +1270,18 @@ function Server(options, listener) {
     this.on('secureConnection', listener);
   }
 
+  if (this[kOCSPStapleCallback]) {
+    this.on('listening', refreshOCSPStaple);
+    this.on('close', () => {
+      clearTimeout(this[kOCSPStapleTimer]);
+      this[kOCSPStapleTimer] = null;
+    });
+  }
+
   this[kEnableTrace] = options.enableTrace;
+  this[kKTLS] = options.ktls;
+  this[kDynamicRecordSize] = options.dynamicRecordSize;
+  this[kCoalesceWrites] = options.coalesceWrites;
 }
 
 ObjectSetPrototypeOf(Server.prototype, net.Server.prototype);
@@ -1315,13 +1404,80 @@ Server.prototype.setSecureContext = function(options) {
   if (this.sessionTimeout)
     this._sharedCreds.context.setSessionTimeout(this.sessionTimeout);
 
+  if (options.sharedSessionCache !== undefined) {
+    validateString(options.sharedSessionCache, 'options.sharedSessionCache');
+    const size = options.sharedSessionCacheSize === undefined ?
+      kDefaultSharedSessionCacheSize : options.sharedSessionCacheSize;
+    validateUint32(size, 'options.sharedSessionCacheSize', true);
+    this.sharedSessionCache = options.sharedSessionCache;
+    this.sharedSessionCacheSize = size;
+  }
+
+  if (this.sharedSessionCache !== undefined) {
+    this._sharedCreds.context.setSessionCache(this.sharedSessionCache,
+                                              this.sharedSessionCacheSize);
+  }
+
   if (options.ticketKeys) {
     this.ticketKeys = options.ticketKeys;
     this.setTicketKeys(this.ticketKeys);
   }
+
+  if (this[kOCSPStapleCallback] && this.listening)
+    refreshOCSPStaple.call(this);
+
+  // The contexts from addContext() are added to the new context too.
+  this[kNativeSNIContexts] = 0;
+  for (const [, context, servername] of this._contexts) {
+    if (!addNativeSNIContext(this, servername, context))
+      break;
+  }
 };
 
 
+// Asks the OCSPStapleCallback for a new OCSP response for the certificate of
+// the server, which is then stapled natively to the handshakes that request
+// one, without calling into JS for every handshake.
+function refreshOCSPStaple() {
+  clearTimeout(this[kOCSPStapleTimer]);
+  this[kOCSPStapleTimer] = null;
+
+  const context = this._sharedCreds.context;
+  let once = false;
+  this[kOCSPStapleCallback](
+    context.getCertificate(),
+    context.getIssuer(),
+    (err, response) => {
+      debug('server OCSPStapleCallback done', 'response?', !!response,
+            'err?', err);
+      if (once)
+        throw new ERR_MULTIPLE_CALLBACK();
+      once = true;
+
+      // The context was replaced by setSecureContext(), or the server was
+      // closed, while the response was being fetched.
+      if (context !== this._sharedCreds.context || !this.listening)
+        return;
+
+      // After an error, the previous response is kept. It is stapled until
+      // its nextUpdate time.
+      let delay = kOCSPStapleRetryDelay;
+      if (!err) {
+        if (response != null)
+          validateBuffer(response, 'response');
+        const remaining = context.setOCSPResponse(response || null);
+        if (remaining === -1)
+          delay = kOCSPStapleRefreshDelay;
+        else if (remaining !== undefined)
+          delay = MathMax(remaining / 2, kOCSPStapleRetryDelay);
+      }
+      this[kOCSPStapleTimer] =
+        setTimeout(refreshOCSPStaple.bind(this),
+                   MathMin(delay, kMaxTimerDelay)).unref();
+    });
+}
+
+
 Server.prototype._getServerData = function() {
   return {
     ticketKeys: this.getTicketKeys().toString('hex')
@@ -1395,9 +1551,25 @@ Server.prototype.addContext = function(servername, context) {
                       servername.replace(/([.^$+?\-\\[\]{}])/g, '\\$1')
                                 .replace(/\*/g, '[^.]*') +
                       '$');
-  this._contexts.push([re, tls.createSecureContext(context).context]);
+  const secureContext = tls.createSecureContext(context).context;
+  this._contexts.push([re, secureContext, servername]);
+  if (this[kNativeSNIContexts] === this._contexts.length - 1)
+    addNativeSNIContext(this, servername, secureContext);
 };
 
+// Adds an SNI context that is selected natively, during the handshake, so
+// that the SNICallback does not need to be called for it. Only the contexts
+// before the first one that can't be matched natively are added, so that the
+// first matching context is still the one that is used.
+function addNativeSNIContext(server, servername, context) {
+  if (typeof servername !== 'string' ||
+      !server._sharedCreds.context.addSNIContext(servername, context)) {
+    return false;
+  }
+  server[kNativeSNIContexts]++;
+  return true;
+}
+
 Server.prototype[EE.captureRejectionSymbol] = function(
   err, event, sock) {
 
@@ -1571,6 +1743,9 @@ exports.connect = function connect(...args) {
     ALPNProtocols: options.ALPNProtocols,
     requestOCSP: options.requestOCSP,
     enableTrace: options.enableTrace,
+    ktls: options.ktls,
+    dynamicRecordSize: options.dynamicRecordSize,
+    coalesceWrites: options.coalesceWrites,
     pskCallback: options.pskCallback,
   });
 
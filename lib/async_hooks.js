@@ -3,6 +3,7 @@
 const {
   NumberIsSafeInteger,
   ReflectApply,
+  SafeMap,
   Symbol,
 } = primordials;
 
@@ -26,6 +27,9 @@ const {
   getHookArrays,
   enableHooks,
   disableHooks,
+  enableAsyncContext,
+  disableAsyncContext,
+  inheritAsyncContextFrame,
   executionAsyncResource,
   // Internal Embedder API
   newAsyncId,
@@ -42,7 +46,7 @@ const {
 const {
   async_id_symbol, trigger_async_id_symbol,
   init_symbol, before_symbol, after_symbol, destroy_symbol,
-  promise_resolve_symbol
+  promise_resolve_symbol, async_context_frame_symbol
 } = internal_async_hooks.symbols;
 
 // Get constants
@@ -159,6 +163,7 @@ class AsyncResource {
     const asyncId = newAsyncId();
     this[async_id_symbol] = asyncId;
     this[trigger_async_id_symbol] = triggerAsyncId;
+    inheritAsyncContextFrame(this);
 
     if (initHooksExist()) {
       if (enabledHooksExist() && type.length === 0) {
@@ -210,6 +215,80 @@ class AsyncResource {
 }
 
 
+// AsyncLocalStorage //
+
+// The stores of all AsyncLocalStorage instances are kept in a single frame
+// (a Map from instance to store) on each async resource. New resources copy
+// the frame of the current execution async resource when they are created,
+// without going through async hooks. Frames are never modified once they
+// are in use, run() and exit() install a modified copy instead.
+class AsyncLocalStorage {
+  constructor() {
+    this.enabled = false;
+  }
+
+  disable() {
+    if (this.enabled) {
+      this.enabled = false;
+      disableAsyncContext();
+    }
+  }
+
+  getStore() {
+    if (!this.enabled)
+      return undefined;
+    const frame = executionAsyncResource()[async_context_frame_symbol];
+    return frame === undefined ? undefined : frame.get(this);
+  }
+
+  enterWith(store) {
+    this._enable();
+    const resource = executionAsyncResource();
+    resource[async_context_frame_symbol] =
+      this._createFrame(resource[async_context_frame_symbol], store);
+  }
+
+  run(store, callback, ...args) {
+    this._enable();
+    return this._runInFrame(store, callback, args);
+  }
+
+  exit(callback, ...args) {
+    if (!this.enabled)
+      return ReflectApply(callback, null, args);
+    return this._runInFrame(undefined, callback, args);
+  }
+
+  _runInFrame(store, callback, args) {
+    const resource = executionAsyncResource();
+    const outerFrame = resource[async_context_frame_symbol];
+    resource[async_context_frame_symbol] =
+      this._createFrame(outerFrame, store);
+    try {
+      return ReflectApply(callback, null, args);
+    } finally {
+      resource[async_context_frame_symbol] = outerFrame;
+    }
+  }
+
+  _createFrame(frame, store) {
+    const newFrame = new SafeMap(frame);
+    if (store === undefined)
+      newFrame.delete(this);
+    else
+      newFrame.set(this, store);
+    return newFrame;
+  }
+
+  _enable() {
+    if (!this.enabled) {
+      this.enabled = true;
+      enableAsyncContext();
+    }
+  }
+}
+
+
 // Placing all exports down here because the exported classes won't export
 // otherwise.
 module.exports = {
@@ -220,4 +299,5 @@ module.exports = {
   executionAsyncResource,
   // Embedder API
   AsyncResource,
+  AsyncLocalStorage,
 };
@@ -26,6 +26,7 @@ const {
   ArrayIsArray,
   Error,
   MathFloor,
+  MathMax,
   MathMin,
   MathTrunc,
   NumberIsNaN,
@@ -37,25 +38,31 @@ const {
   ObjectGetOwnPropertyDescriptor,
   ObjectGetPrototypeOf,
   ObjectSetPrototypeOf,
+  Symbol,
+  SymbolIterator,
   SymbolSpecies,
   SymbolToPrimitive,
   Uint8ArrayPrototype,
 } = primordials;
 
 const {
+  allocAligned: _allocAligned,
   byteLengthUtf8,
   compare: _compare,
   compareOffset,
   createFromString,
   fill: bindingFill,
+  indexOfAny: _indexOfAny,
   indexOfBuffer,
   indexOfNumber,
   indexOfString,
+  Searcher: BindingSearcher,
   swap16: _swap16,
   swap32: _swap32,
   swap64: _swap64,
   kMaxLength,
   kStringMaxLength,
+  toExternalString: _toExternalString,
   zeroFill: bindingZeroFill
 } = internalBinding('buffer');
 const {
@@ -391,6 +398,21 @@ Buffer.allocUnsafeSlow = function allocUnsafeSlow(size) {
   return createUnsafeBuffer(size);
 };
 
+/**
+ * Creates a new zero-filled Buffer whose memory is aligned to a multiple of
+ * `alignment` bytes, as needed for I/O on files opened with O_DIRECT.
+ * allocAligned(size[, alignment])
+ */
+Buffer.allocAligned = function allocAligned(size, alignment = 4096) {
+  assertSize(size);
+  validateInt32(alignment, 'alignment', 1);
+  if ((alignment & (alignment - 1)) !== 0) {
+    throw new ERR_INVALID_ARG_VALUE('alignment', alignment,
+                                    'must be a power of two');
+  }
+  return _allocAligned(size, alignment);
+};
+
 // If --zero-fill-buffers command line argument is set, a zero-filled
 // buffer is returned.
 function SlowBuffer(length) {
@@ -657,6 +679,20 @@ const encodingOps = {
                     encodingsMap.base64,
                     dir)
   },
+  base64url: {
+    encoding: 'base64url',
+    encodingVal: encodingsMap.base64url,
+    byteLength: (string) => base64ByteLength(string, string.length),
+    write: (buf, string, offset, len) =>
+      buf.base64urlWrite(string, offset, len),
+    slice: (buf, start, end) => buf.base64urlSlice(start, end),
+    indexOf: (buf, val, byteOffset, dir) =>
+      indexOfBuffer(buf,
+                    fromStringFast(val, encodingOps.base64url),
+                    byteOffset,
+                    encodingsMap.base64url,
+                    dir)
+  },
   hex: {
     encoding: 'hex',
     encodingVal: encodingsMap.hex,
@@ -711,6 +747,10 @@ function getEncodingOps(encoding) {
       if (encoding === 'hex' || encoding.toLowerCase() === 'hex')
         return encodingOps.hex;
       break;
+    case 9:
+      if (encoding === 'base64url' || encoding.toLowerCase() === 'base64url')
+        return encodingOps.base64url;
+      break;
   }
 }
 
@@ -764,6 +804,31 @@ Buffer.prototype.copy =
     return _copy(this, target, targetStart, sourceStart, sourceEnd);
   };
 
+// Below this length, copying the data is cheaper than setting up an external
+// string.
+const kMinExternalStringLength = 1024;
+
+Buffer.prototype.toExternalString = function toExternalString(encoding) {
+  let latin1 = false;
+  if (encoding !== undefined) {
+    const normalized = normalizeEncoding(encoding);
+    if (normalized !== 'utf8' && normalized !== 'ascii' &&
+        normalized !== 'latin1') {
+      throw new ERR_INVALID_ARG_VALUE(
+        'encoding', encoding, 'must be \'utf8\', \'ascii\' or \'latin1\'');
+    }
+    encoding = normalized;
+    latin1 = normalized === 'latin1';
+  }
+
+  if (this.length >= kMinExternalStringLength) {
+    const str = _toExternalString(this, latin1);
+    if (str !== undefined)
+      return str;
+  }
+  return this.toString(encoding);
+};
+
 // No need to verify that "buf.length <= MAX_UINT32" since it's a read-only
 // property of a typed array.
 // This behaves neither like String nor Uint8Array in that we set start/end
@@ -953,6 +1018,137 @@ Buffer.prototype.includes = function includes(val, byteOffset, encoding) {
   return this.indexOf(val, byteOffset, encoding) !== -1;
 };
 
+// Coerces the byteOffset of indexOfAny() and Searcher#indexOf() like
+// indexOf() does, except that there is no encoding argument to skip.
+function toForwardByteOffset(byteOffset) {
+  if (byteOffset > 0x7fffffff) {
+    byteOffset = 0x7fffffff;
+  } else if (byteOffset < -0x80000000) {
+    byteOffset = -0x80000000;
+  }
+  byteOffset = +byteOffset;
+  return NumberIsNaN(byteOffset) ? 0 : byteOffset;
+}
+
+Buffer.prototype.indexOfAny = function indexOfAny(values, byteOffset) {
+  if (typeof values === 'string') {
+    values = fromStringFast(values, encodingOps.latin1);
+  } else if (ArrayIsArray(values)) {
+    for (let i = 0; i < values.length; i++)
+      validateInt32(values[i], `values[${i}]`, 0, 255);
+    values = fromArrayLike(values);
+  } else if (!isUint8Array(values)) {
+    throw new ERR_INVALID_ARG_TYPE(
+      'values', ['string', 'Buffer', 'Uint8Array', 'Array'], values);
+  }
+  return _indexOfAny(this, values, toForwardByteOffset(byteOffset));
+};
+
+const kSearcher = Symbol('kSearcher');
+
+class Searcher {
+  constructor(pattern, encoding) {
+    if (typeof pattern === 'string') {
+      pattern = Buffer.from(pattern, encoding);
+    } else if (!isUint8Array(pattern)) {
+      throw new ERR_INVALID_ARG_TYPE(
+        'pattern', ['string', 'Buffer', 'Uint8Array'], pattern);
+    }
+    if (pattern.length === 0)
+      throw new ERR_INVALID_ARG_VALUE('pattern', pattern, 'must not be empty');
+    this[kSearcher] = new BindingSearcher(pattern);
+  }
+
+  indexOf(buffer, byteOffset) {
+    if (!isUint8Array(buffer)) {
+      throw new ERR_INVALID_ARG_TYPE(
+        'buffer', ['Buffer', 'Uint8Array'], buffer);
+    }
+    return this[kSearcher].indexOf(buffer, toForwardByteOffset(byteOffset));
+  }
+}
+
+const kChunks = Symbol('kChunks');
+const kLength = Symbol('kLength');
+
+// An immutable list of Buffers that is only copied into one when a caller
+// needs contiguous memory. Writable streams write the chunks with a single
+// writev, and hashes are updated one chunk at a time.
+class Rope {
+  constructor(chunks = [], encoding) {
+    if (!ArrayIsArray(chunks))
+      throw new ERR_INVALID_ARG_TYPE('chunks', 'Array', chunks);
+    const list = [];
+    let length = 0;
+    for (let i = 0; i < chunks.length; i++) {
+      let chunk = chunks[i];
+      if (chunk instanceof Rope) {
+        const nested = chunk[kChunks];
+        for (let j = 0; j < nested.length; j++)
+          list.push(nested[j]);
+        length += chunk[kLength];
+        continue;
+      }
+      if (typeof chunk === 'string') {
+        chunk = Buffer.from(chunk, encoding);
+      } else if (!isUint8Array(chunk)) {
+        throw new ERR_INVALID_ARG_TYPE(
+          `chunks[${i}]`, ['string', 'Buffer', 'Uint8Array', 'Rope'], chunk);
+      } else if (!(chunk instanceof Buffer)) {
+        chunk = new FastBuffer(chunk.buffer, chunk.byteOffset, chunk.length);
+      }
+      if (chunk.length === 0)
+        continue;
+      list.push(chunk);
+      length += chunk.length;
+    }
+    this[kChunks] = list;
+    this[kLength] = length;
+  }
+
+  get length() {
+    return this[kLength];
+  }
+
+  slice(start = 0, end = this[kLength]) {
+    const length = this[kLength];
+    start = adjustOffset(start, length);
+    end = adjustOffset(end, length);
+    const chunks = this[kChunks];
+    const list = [];
+    let offset = 0;
+    for (let i = 0; i < chunks.length && offset < end; i++) {
+      const chunk = chunks[i];
+      const chunkEnd = offset + chunk.length;
+      if (chunkEnd > start) {
+        list.push(chunk.subarray(MathMax(start - offset, 0),
+                                 MathMin(end, chunkEnd) - offset));
+      }
+      offset = chunkEnd;
+    }
+    return new Rope(list);
+  }
+
+  // The result shares memory with the chunks, and becomes the only chunk of
+  // the rope so that it is not copied again.
+  toBuffer() {
+    const chunks = this[kChunks];
+    if (chunks.length === 0)
+      return new FastBuffer();
+    if (chunks.length > 1)
+      this[kChunks] = [Buffer.concat(chunks, this[kLength])];
+    return this[kChunks][0];
+  }
+
+  toString(encoding) {
+    return this.toBuffer().toString(encoding);
+  }
+
+  *[SymbolIterator]() {
+    yield* this[kChunks];
+  }
+}
+
 // Usage:
 //    buffer.fill(number[, offset[, end]])
 //    buffer.fill(buffer[, offset[, end]])
@@ -1197,6 +1393,8 @@ if (internalBinding('config').hasIntl) {
 
 module.exports = {
   Buffer,
+  Rope,
+  Searcher,
   SlowBuffer,
   transcode,
   // Legacy
@@ -59,6 +59,12 @@ const {
 
 const MAX_BUFFER = 1024 * 1024;
 
+const coverageEnvVars = [
+  'NODE_V8_COVERAGE',
+  'NODE_V8_COVERAGE_BINARY',
+  'NODE_V8_COVERAGE_INTERVAL',
+];
+
 function fork(modulePath /* , args, options */) {
   validateString(modulePath, 'modulePath');
 
@@ -514,9 +520,14 @@ function normalizeSpawnArguments(file, args, options) {
 
   // process.env.NODE_V8_COVERAGE always propagates, making it possible to
   // collect coverage for programs that spawn with white-listed environment.
-  if (process.env.NODE_V8_COVERAGE &&
-      !ObjectPrototypeHasOwnProperty(options.env || {}, 'NODE_V8_COVERAGE')) {
-    env.NODE_V8_COVERAGE = process.env.NODE_V8_COVERAGE;
+  // The variables that configure the collection propagate with it.
+  if (process.env.NODE_V8_COVERAGE) {
+    for (const key of coverageEnvVars) {
+      if (process.env[key] !== undefined &&
+          !ObjectPrototypeHasOwnProperty(options.env || {}, key)) {
+        env[key] = process.env[key];
+      }
+    }
   }
 
   // Prototype values are intentionally included.
@@ -47,7 +47,8 @@ const { getFipsCrypto, setFipsCrypto } = internalBinding('crypto');
 const {
   randomBytes,
   randomFill,
-  randomFillSync
+  randomFillSync,
+  randomUUID
 } = require('internal/crypto/random');
 const {
   pbkdf2,
@@ -58,8 +59,10 @@ const {
   scryptSync
 } = require('internal/crypto/scrypt');
 const {
+  createKeyPairPool,
   generateKeyPair,
-  generateKeyPairSync
+  generateKeyPairSync,
+  KeyPairPool
 } = require('internal/crypto/keygen');
 const {
   createSecretKey,
@@ -71,9 +74,14 @@ const {
   DiffieHellman,
   DiffieHellmanGroup,
   ECDH,
-  diffieHellman
+  diffieHellman,
+  diffieHellmanBatch
 } = require('internal/crypto/diffiehellman');
 const {
+  aeadOpen,
+  aeadOpenBatch,
+  aeadSeal,
+  aeadSealBatch,
   Cipher,
   Cipheriv,
   Decipher,
@@ -87,11 +95,13 @@ const {
   Sign,
   signOneShot,
   Verify,
+  verifyBatch,
   verifyOneShot
 } = require('internal/crypto/sig');
 const {
   Hash,
-  Hmac
+  Hmac,
+  hash
 } = require('internal/crypto/hash');
 const {
   getCiphers,
@@ -152,6 +162,10 @@ function createVerify(algorithm, options) {
 
 module.exports = {
   // Methods
+  aeadOpen,
+  aeadOpenBatch,
+  aeadSeal,
+  aeadSealBatch,
   createCipheriv,
   createDecipheriv,
   createDiffieHellman,
@@ -159,16 +173,19 @@ module.exports = {
   createECDH,
   createHash,
   createHmac,
+  createKeyPairPool,
   createPrivateKey,
   createPublicKey,
   createSecretKey,
   createSign,
   createVerify,
   diffieHellman,
+  diffieHellmanBatch,
   getCiphers,
   getCurves,
   getDiffieHellman: createDiffieHellmanGroup,
   getHashes,
+  hash,
   pbkdf2,
   pbkdf2Sync,
   generateKeyPair,
@@ -180,6 +197,7 @@ module.exports = {
   randomBytes,
   randomFill,
   randomFillSync,
+  randomUUID,
   scrypt,
   scryptSync,
   sign: signOneShot,
@@ -190,6 +208,7 @@ module.exports = {
   setFips: !fipsMode ? setFipsDisabled :
     fipsForced ? setFipsForced : setFipsCrypto,
   verify: verifyOneShot,
+  verifyBatch,
 
   // Classes
   Certificate,
@@ -203,6 +222,7 @@ module.exports = {
   Hash,
   Hmac,
   KeyObject,
+  KeyPairPool,
   Sign,
   Verify
 };
@@ -36,10 +36,13 @@ const {
 } = require('internal/dgram');
 const { guessHandleType } = internalBinding('util');
 const {
+  isIP,
   isLegalPort,
 } = require('internal/net');
 const {
   ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_ARG_VALUE,
+  ERR_INVALID_CALLBACK,
   ERR_MISSING_ARGS,
   ERR_SOCKET_ALREADY_BOUND,
   ERR_SOCKET_BAD_BUFFER_SIZE,
@@ -53,6 +56,8 @@ const {
 } = errors.codes;
 const {
   isInt32,
+  validateInt32,
+  validateInteger,
   validateString,
   validateNumber
 } = require('internal/validators');
@@ -92,7 +97,10 @@ const exceptionWithHostPort = errors.exceptionWithHostPort;
 
 function Socket(type, listener) {
   EventEmitter.call(this);
+  let gro;
+  let gsoSegmentSize;
   let lookup;
+  let recvBatch;
   let recvBufferSize;
   let sendBufferSize;
 
@@ -101,11 +109,14 @@ function Socket(type, listener) {
     options = type;
     type = options.type;
     lookup = options.lookup;
+    gro = !!options.gro;
+    gsoSegmentSize = options.gsoSegmentSize;
+    recvBatch = !!options.recvBatch;
     recvBufferSize = options.recvBufferSize;
     sendBufferSize = options.sendBufferSize;
   }
 
-  const handle = newHandle(type, lookup);
+  const handle = newHandle(type, lookup, recvBatch);
   handle[owner_symbol] = this;
 
   this[async_id_symbol] = handle.getAsyncId();
@@ -122,6 +133,9 @@ function Socket(type, listener) {
     queue: undefined,
     reuseAddr: options && options.reuseAddr, // Use UV_UDP_REUSEADDR if true.
     ipv6Only: options && options.ipv6Only,
+    gro,
+    gsoSegmentSize,
+    recvBatch,
     recvBufferSize,
     sendBufferSize
   };
@@ -138,7 +152,7 @@ function createSocket(type, listener) {
 function startListening(socket) {
   const state = socket[kStateSymbol];
 
-  state.handle.onmessage = onMessage;
+  state.handle.onmessage = state.recvBatch ? onMessageBatch : onMessage;
   // Todo: handle errors
   state.handle.recvStart();
   state.receiving = true;
@@ -150,6 +164,12 @@ function startListening(socket) {
   if (state.sendBufferSize)
     bufferSize(socket, state.sendBufferSize, SEND_BUFFER);
 
+  if (state.gsoSegmentSize)
+    socket.setGSOSegmentSize(state.gsoSegmentSize);
+
+  if (state.gro)
+    socket.setGRO(true);
+
   socket.emit('listening');
 }
 
@@ -699,6 +719,141 @@ function doSend(ex, self, ip, list, address, port, callback) {
   }
 }
 
+// sendBatch(messages[, callback]) where each message is
+// { msg, port, address }. port and address are omitted for connected sockets.
+Socket.prototype.sendBatch = function(messages, callback) {
+  if (!ArrayIsArray(messages))
+    throw new ERR_INVALID_ARG_TYPE('messages', 'Array', messages);
+  if (callback !== undefined && typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK(callback);
+
+  const state = this[kStateSymbol];
+  const connected = state.connectState === CONNECT_STATE_CONNECTED;
+  const family = this.type === 'udp4' ? 4 : 6;
+  const count = messages.length;
+  const list = new Array(count * 3);
+
+  for (let i = 0; i < count; i++) {
+    const message = messages[i];
+    if (message === null || typeof message !== 'object') {
+      throw new ERR_INVALID_ARG_TYPE(`messages[${i}]`, 'Object', message);
+    }
+
+    let msg = message.msg;
+    if (typeof msg === 'string') {
+      msg = Buffer.from(msg);
+    } else if (!isUint8Array(msg)) {
+      throw new ERR_INVALID_ARG_TYPE(`messages[${i}].msg`,
+                                     ['Buffer', 'Uint8Array', 'string'],
+                                     msg);
+    }
+    list[i * 3] = msg;
+
+    if (connected) {
+      if (message.port !== undefined || message.address !== undefined)
+        throw new ERR_SOCKET_DGRAM_IS_CONNECTED();
+    } else {
+      list[i * 3 + 1] = validatePort(message.port);
+      if (isIP(message.address) !== family) {
+        throw new ERR_INVALID_ARG_VALUE(`messages[${i}].address`,
+                                        message.address,
+                                        `must be an IPv${family} address`);
+      }
+      list[i * 3 + 2] = message.address;
+    }
+  }
+
+  healthCheck(this);
+
+  if (state.bindState === BIND_STATE_UNBOUND)
+    this.bind({ port: 0, exclusive: true }, null);
+
+  // If the socket hasn't been bound yet, push the outbound packets onto the
+  // send queue and send after binding is complete.
+  if (state.bindState !== BIND_STATE_BOUND) {
+    enqueue(this, () => doSendBatch(this, list, count, callback));
+    return;
+  }
+
+  defaultTriggerAsyncIdScope(
+    this[async_id_symbol],
+    doSendBatch,
+    this, list, count, callback
+  );
+};
+
+function doSendBatch(self, list, count, callback) {
+  const state = self[kStateSymbol];
+
+  if (!state.handle)
+    return;
+
+  const sent = count === 0 ? 0 : state.handle.sendBatch(list, count);
+
+  if (sent < 0) {
+    // Don't emit as error, same as send().
+    if (callback) {
+      const ex = exceptionWithHostPort(sent, 'send', list[2], list[1]);
+      process.nextTick(callback, ex);
+    }
+    return;
+  }
+
+  // The datagrams that could not be sent right away are queued one request
+  // each. libuv flushes its send queue with sendmmsg() where available.
+  const batch = {
+    callback,
+    error: null,
+    pending: count - sent,
+    sent
+  };
+
+  for (let i = sent; i < count; i++) {
+    const chunk = [list[i * 3]];
+    const port = list[i * 3 + 1];
+    const address = list[i * 3 + 2];
+    const req = new SendWrap();
+    req.list = chunk;  // Keep reference alive.
+    req.address = address;
+    req.port = port;
+    req.batch = batch;
+    req.oncomplete = afterSendBatch;
+
+    let err;
+    if (port)
+      err = state.handle.send(req, chunk, 1, port, address, true);
+    else
+      err = state.handle.send(req, chunk, 1, true);
+
+    if (err >= 1) {
+      // Synchronous finish, see doSend().
+      batch.sent++;
+      batch.pending--;
+    } else if (err) {
+      if (batch.error === null)
+        batch.error = exceptionWithHostPort(err, 'send', address, port);
+      batch.pending--;
+    }
+  }
+
+  if (batch.pending === 0 && callback)
+    process.nextTick(callback, batch.error, batch.sent);
+}
+
+function afterSendBatch(err) {
+  const batch = this.batch;
+
+  if (err) {
+    if (batch.error === null)
+      batch.error = exceptionWithHostPort(err, 'send', this.address, this.port);
+  } else {
+    batch.sent++;
+  }
+
+  if (--batch.pending === 0 && batch.callback)
+    batch.callback(batch.error, batch.sent);
+}
+
 function afterSend(err, sent) {
   if (err) {
     err = exceptionWithHostPort(err, 'send', this.address, this.port);
@@ -787,6 +942,36 @@ Socket.prototype.setTTL = function(ttl) {
 };
 
 
+Socket.prototype.setGSOSegmentSize = function(size) {
+  validateInteger(size, 'size', 0, 65535);
+
+  const err = this[kStateSymbol].handle.setSegmentSize(size);
+  if (err) {
+    throw errnoException(err, 'setGSOSegmentSize');
+  }
+
+  return size;
+};
+
+
+Socket.prototype.setGRO = function(flag) {
+  const err = this[kStateSymbol].handle.setGRO(!!flag);
+  if (err) {
+    throw errnoException(err, 'setGRO');
+  }
+};
+
+
+Socket.prototype.setBusyPoll = function(microseconds) {
+  validateInt32(microseconds, 'microseconds', 0);
+
+  const err = this[kStateSymbol].handle.setBusyPoll(microseconds);
+  if (err) {
+    throw errnoException(err, 'setBusyPoll');
+  }
+};
+
+
 Socket.prototype.setMulticastTTL = function(ttl) {
   validateNumber(ttl, 'ttl');
 
@@ -925,6 +1110,25 @@ function onMessage(nread, handle, buf, rinfo) {
 }
 
 
+function onMessageBatch(nread, handle, bufs, rinfos) {
+  const self = handle[owner_symbol];
+  if (nread < 0) {
+    return self.emit('error', errnoException(nread, 'recvmmsg'));
+  }
+  const messages = new Array(nread);
+  for (let i = 0; i < nread; i++) {
+    const rinfo = rinfos[i];
+    rinfo.size = bufs[i].length; // compatibility
+    messages[i] = { msg: bufs[i], rinfo };
+  }
+  self.emit('messages', messages);
+  if (self.listenerCount('message') > 0) {
+    for (let i = 0; i < nread; i++)
+      self.emit('message', messages[i].msg, messages[i].rinfo);
+  }
+}
+
+
 Socket.prototype.ref = function() {
   const handle = this[kStateSymbol].handle;
 
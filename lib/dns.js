@@ -40,6 +40,11 @@ const {
   validateHints,
   emitInvalidHostnameWarning,
 } = require('internal/dns/utils');
+const {
+  clearLookupCache,
+  lookupCached,
+  setLookupCache,
+} = require('internal/dns/lookup_cache');
 const {
   ERR_INVALID_ARG_TYPE,
   ERR_INVALID_CALLBACK,
@@ -146,6 +151,13 @@ function lookup(hostname, options, callback) {
   req.hostname = hostname;
   req.oncomplete = all ? onlookupall : onlookup;
 
+  // The lookup cache keeps the answers in IPv4-first order, so it can only
+  // stand in for lookups that would sort them that way.
+  if (hints === 0 && !verbatim &&
+      lookupCached(toASCII(hostname), family, req.oncomplete.bind(req))) {
+    return {};
+  }
+
   const err = cares.getaddrinfo(
     req, toASCII(hostname), family, hints, verbatim
   );
@@ -283,6 +295,8 @@ function defaultResolverSetServers(servers) {
 module.exports = {
   lookup,
   lookupService,
+  setLookupCache,
+  clearLookupCache,
 
   Resolver,
   setServers: defaultResolverSetServers,
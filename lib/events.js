@@ -25,6 +25,7 @@ const {
   Array,
   Boolean,
   Error,
+  FunctionPrototypeCall,
   MathMin,
   NumberIsNaN,
   ObjectCreate,
@@ -58,6 +59,7 @@ const {
 const {
   inspect
 } = require('internal/util/inspect');
+const { kEmitOne } = require('internal/util');
 
 const kCapture = Symbol('kCapture');
 const kErrorMonitor = Symbol('events.errorMonitor');
@@ -346,6 +348,43 @@ EventEmitter.prototype.emit = function emit(type, ...args) {
   return true;
 };
 
+const originalEmit = EventEmitter.prototype.emit;
+
+// emitOne(emitter, type, arg) is emitter.emit(type, arg) for the events that
+// core objects emit most often, such as 'data' on every read of a stream. It
+// saves collecting the arguments of emit() into an array and spreading them
+// again. `type` must not be 'error'.
+function emitOne(emitter, type, arg) {
+  // emit() may have been replaced, e.g. by the domain module.
+  if (emitter.emit !== originalEmit)
+    return emitter.emit(type, arg);
+
+  const events = emitter._events;
+  if (events === undefined)
+    return false;
+  const handler = events[type];
+  if (handler === undefined)
+    return false;
+
+  if (typeof handler === 'function') {
+    const result = FunctionPrototypeCall(handler, emitter, arg);
+    if (result !== undefined && result !== null)
+      addCatch(emitter, result, type, [arg]);
+  } else {
+    const len = handler.length;
+    const listeners = arrayClone(handler, len);
+    for (let i = 0; i < len; ++i) {
+      const result = FunctionPrototypeCall(listeners[i], emitter, arg);
+      if (result !== undefined && result !== null)
+        addCatch(emitter, result, type, [arg]);
+    }
+  }
+
+  return true;
+}
+
+ObjectDefineProperty(EventEmitter, kEmitOne, { value: emitOne });
+
 function _addListener(target, type, listener, prepend) {
   let m;
   let events;
@@ -29,6 +29,8 @@
 const kIoMaxLength = 2 ** 31 - 1;
 
 const {
+  Array,
+  ArrayIsArray,
   Map,
   MathMax,
   NumberIsSafeInteger,
@@ -68,7 +70,8 @@ const {
   uvException
 } = require('internal/errors');
 
-const { FSReqCallback, statValues } = binding;
+const { FSReqCallback, kFsStatsFieldsNumber, statValues } = binding;
+const { UV_ENOENT, UV_ENOTDIR } = internalBinding('uv');
 const { toPathIfFileURL } = require('internal/url');
 const internalUtil = require('internal/util');
 const {
@@ -132,6 +135,7 @@ let FileWriteStream;
 
 const isWindows = process.platform === 'win32';
 const isOSX = process.platform === 'darwin';
+const isLinux = process.platform === 'linux';
 
 
 function showTruncateDeprecation() {
@@ -252,32 +256,11 @@ function existsSync(path) {
   return ctx.errno === undefined;
 }
 
-function readFileAfterOpen(err, fd) {
-  const context = this.context;
-
-  if (err) {
-    context.callback(err);
-    return;
-  }
-
-  context.fd = fd;
-
-  const req = new FSReqCallback();
-  req.oncomplete = readFileAfterStat;
-  req.context = context;
-  binding.fstat(fd, false, req);
-}
-
-function readFileAfterStat(err, stats) {
-  const context = this.context;
-
-  if (err)
-    return context.close(err);
-
-  const size = context.size = isFileType(stats, S_IFREG) ? stats[8] : 0;
+function readFileStart(context, size) {
+  context.size = size;
 
   if (size > kIoMaxLength) {
-    err = new ERR_FS_FILE_TOO_LARGE(size);
+    const err = new ERR_FS_FILE_TOO_LARGE(size);
     return context.close(err);
   }
 
@@ -293,6 +276,21 @@ function readFileAfterStat(err, stats) {
   context.read();
 }
 
+// Small regular files are read completely by binding.readFile(). Anything
+// else comes back as [fd, size] and is read in chunks by the ReadFileContext.
+function readFileAfterReadFile(err, result) {
+  const context = this.context;
+
+  if (err)
+    return context.callback(err);
+
+  if (!ArrayIsArray(result))
+    return context.callback(null, result);
+
+  context.fd = result[0];
+  readFileStart(context, result[1]);
+}
+
 function readFile(path, options, callback) {
   callback = maybeCallback(callback || options);
   options = getOptions(options, { flag: 'r' });
@@ -303,21 +301,12 @@ function readFile(path, options, callback) {
 
   const req = new FSReqCallback();
   req.context = context;
-  req.oncomplete = readFileAfterOpen;
+  req.oncomplete = readFileAfterReadFile;
 
-  if (context.isUserFd) {
-    process.nextTick(function tick() {
-      req.oncomplete(null, path);
-    });
-    return;
-  }
-
-  path = getValidatedPath(path);
+  if (!context.isUserFd)
+    path = pathModule.toNamespacedPath(getValidatedPath(path));
   const flagsNumber = stringToFlags(options.flags);
-  binding.open(pathModule.toNamespacedPath(path),
-               flagsNumber,
-               0o666,
-               req);
+  binding.readFile(path, flagsNumber, options.encoding, req);
 }
 
 function tryStatSync(fd, isUserFd) {
@@ -537,6 +526,44 @@ function readSync(fd, buffer, offset, length, position) {
   return result;
 }
 
+// usage:
+// fs.readv(fd, buffers[, position], callback);
+function readv(fd, buffers, position, callback) {
+  function wrapper(err, read) {
+    callback(err, read || 0, buffers);
+  }
+
+  validateInt32(fd, 'fd', /* min */ 0);
+  validateBufferArray(buffers);
+
+  const req = new FSReqCallback();
+  req.oncomplete = wrapper;
+
+  callback = maybeCallback(callback || position);
+
+  if (typeof position !== 'number')
+    position = null;
+
+  return binding.readBuffers(fd, buffers, position, req);
+}
+
+ObjectDefineProperty(readv, internalUtil.customPromisifyArgs,
+                     { value: ['bytesRead', 'buffers'], enumerable: false });
+
+function readvSync(fd, buffers, position) {
+  validateInt32(fd, 'fd', 0);
+  validateBufferArray(buffers);
+
+  const ctx = {};
+
+  if (typeof position !== 'number')
+    position = null;
+
+  const result = binding.readBuffers(fd, buffers, position, undefined, ctx);
+  handleErrorFromBinding(ctx);
+  return result;
+}
+
 // usage:
 //  fs.write(fd, buffer[, offset[, length[, position]]], callback);
 // OR
@@ -936,6 +963,63 @@ function stat(path, options = { bigint: false }, callback) {
   binding.stat(pathModule.toNamespacedPath(path), options.bigint, req);
 }
 
+function statManyImpl(paths, options, callback, followLinks) {
+  if (typeof callback !== 'function') {
+    throw new ERR_INVALID_CALLBACK(callback);
+  }
+  if (!ArrayIsArray(paths)) {
+    throw new ERR_INVALID_ARG_TYPE('paths', 'Array', paths);
+  }
+  const validated = new Array(paths.length);
+  const names = new Array(paths.length);
+  for (let i = 0; i < paths.length; i++) {
+    validated[i] = getValidatedPath(paths[i], `paths[${i}]`);
+    names[i] = pathModule.toNamespacedPath(validated[i]);
+  }
+  if (paths.length === 0) {
+    process.nextTick(callback, null, []);
+    return;
+  }
+  const syscall = followLinks ? 'stat' : 'lstat';
+  const throwIfNoEntry = options.throwIfNoEntry !== false;
+
+  const req = new FSReqCallback(options.bigint);
+  req.oncomplete = (err, result) => {
+    if (err) return callback(err);
+    const { 0: stats, 1: errors } = result;
+    const results = new Array(errors.length);
+    for (let i = 0; i < errors.length; i++) {
+      const errno = errors[i];
+      if (errno === 0) {
+        results[i] = getStatsFromBinding(stats, i * kFsStatsFieldsNumber);
+      } else if (!throwIfNoEntry &&
+                 (errno === UV_ENOENT || errno === UV_ENOTDIR)) {
+        results[i] = undefined;
+      } else {
+        return callback(uvException({ errno, syscall, path: validated[i] }));
+      }
+    }
+    callback(null, results);
+  };
+  binding.statMany(names, options.bigint, followLinks, req);
+}
+
+function lstatMany(paths, options = { bigint: false }, callback) {
+  if (typeof options === 'function') {
+    callback = options;
+    options = {};
+  }
+  statManyImpl(paths, options, callback, false);
+}
+
+function statMany(paths, options = { bigint: false }, callback) {
+  if (typeof options === 'function') {
+    callback = options;
+    options = {};
+  }
+  statManyImpl(paths, options, callback, true);
+}
+
 function fstatSync(fd, options = { bigint: false }) {
   validateInt32(fd, 'fd', 0);
   const ctx = { fd };
@@ -1371,7 +1455,8 @@ function watch(filename, options, listener) {
 
   if (options.persistent === undefined) options.persistent = true;
   if (options.recursive === undefined) options.recursive = false;
-  if (options.recursive && !(isOSX || isWindows))
+  if (options.debounce === undefined) options.debounce = 0;
+  if (options.recursive && !(isOSX || isWindows || isLinux))
     throw new ERR_FEATURE_UNAVAILABLE_ON_PLATFORM('watch recursively');
   if (!watchers)
     watchers = require('internal/fs/watchers');
@@ -1379,7 +1464,8 @@ function watch(filename, options, listener) {
   watcher[watchers.kFSWatchStart](filename,
                                   options.persistent,
                                   options.recursive,
-                                  options.encoding);
+                                  options.encoding,
+                                  options.debounce);
 
   if (listener) {
     watcher.addListener('change', listener);
@@ -1421,7 +1507,8 @@ function watchFile(filename, options, listener) {
       watchers = require('internal/fs/watchers');
     stat = new watchers.StatWatcher(options.bigint);
     stat[watchers.kFSStatWatcherStart](filename,
-                                       options.persistent, options.interval);
+                                       options.persistent, options.interval,
+                                       options.batch === true);
     statWatchers.set(filename, stat);
   }
 
@@ -1896,6 +1983,7 @@ module.exports = fs = {
   link,
   linkSync,
   lstat,
+  lstatMany,
   lstatSync,
   mkdir,
   mkdirSync,
@@ -1909,6 +1997,8 @@ module.exports = fs = {
   readdirSync,
   read,
   readSync,
+  readv,
+  readvSync,
   readFile,
   readFileSync,
   readlink,
@@ -1920,6 +2010,7 @@ module.exports = fs = {
   rmdir,
   rmdirSync,
   stat,
+  statMany,
   statSync,
   symlink,
   symlinkSync,
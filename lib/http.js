@@ -36,6 +36,10 @@ const {
   Server,
   ServerResponse
 } = require('_http_server');
+const {
+  WebSocketReceiver,
+  WebSocketSender
+} = require('internal/websocket');
 let maxHeaderSize;
 
 function createServer(opts, requestListener) {
@@ -62,6 +66,8 @@ module.exports = {
   OutgoingMessage,
   Server,
   ServerResponse,
+  WebSocketReceiver,
+  WebSocketSender,
   createServer,
   get,
   request
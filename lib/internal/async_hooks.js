@@ -37,7 +37,9 @@ const {
   async_hook_fields,
   async_id_fields,
   execution_async_resources,
-  owner_symbol
+  top_level_resource: topLevelResource,
+  owner_symbol,
+  async_context_frame_symbol
 } = async_wrap;
 // Store the pair executionAsyncId and triggerAsyncId in a std::stack on
 // Environment::AsyncHooks::async_ids_stack_ tracks the resource responsible for
@@ -46,7 +48,8 @@ const {
 // after() callback.
 const {
   pushAsyncContext: pushAsyncContext_,
-  popAsyncContext: popAsyncContext_
+  popAsyncContext: popAsyncContext_,
+  executionAsyncResource: executionAsyncResource_
 } = async_wrap;
 // For performance reasons, only track Promises when a hook is enabled.
 const { enablePromiseHook, disablePromiseHook } = async_wrap;
@@ -84,7 +87,8 @@ const { enqueueMicrotask } = internalBinding('task_queue');
 // for a given step, that step can bail out early.
 const { kInit, kBefore, kAfter, kDestroy, kTotals, kPromiseResolve,
         kCheck, kExecutionAsyncId, kAsyncIdCounter, kTriggerAsyncId,
-        kDefaultTriggerAsyncId, kStackLength } = async_wrap.constants;
+        kDefaultTriggerAsyncId, kStackLength,
+        kUsesAsyncContext } = async_wrap.constants;
 
 // Used in AsyncHook and AsyncResource.
 const async_id_symbol = Symbol('asyncId');
@@ -100,13 +104,13 @@ const emitDestroyNative = emitHookFactory(destroy_symbol, 'emitDestroyNative');
 const emitPromiseResolveNative =
     emitHookFactory(promise_resolve_symbol, 'emitPromiseResolveNative');
 
-const topLevelResource = {};
-
 function executionAsyncResource() {
   const index = async_hook_fields[kStackLength] - 1;
   if (index === -1) return topLevelResource;
+  // Resources that were pushed from C++ are not in the JS array.
   const resource = execution_async_resources[index];
-  return resource;
+  if (resource !== undefined) return resource;
+  return executionAsyncResource_(index);
 }
 
 // Used to fatally abort the process if a callback throws.
@@ -262,10 +266,33 @@ function disableHooks() {
 }
 
 function disablePromiseHookIfNecessary() {
-  if (!wantPromiseHook)
+  if (!wantPromiseHook && async_hook_fields[kUsesAsyncContext] === 0)
     disablePromiseHook();
 }
 
+// Async context frames hold the stores of all AsyncLocalStorage instances.
+// The frame of the current execution async resource is copied to every new
+// resource, natively in AsyncWrap::AsyncReset() and by the JS resources
+// themselves, so that no async hooks have to be called to propagate it.
+function enableAsyncContext() {
+  async_hook_fields[kUsesAsyncContext]++;
+  // Promises need a PromiseWrap to carry the frame.
+  enablePromiseHook();
+}
+
+function disableAsyncContext() {
+  async_hook_fields[kUsesAsyncContext]--;
+  enqueueMicrotask(disablePromiseHookIfNecessary);
+}
+
+// Keep in sync with AsyncHooks::InheritAsyncContextFrame() in src/env.cc.
+function inheritAsyncContextFrame(resource) {
+  if (async_hook_fields[kUsesAsyncContext] === 0)
+    return;
+  resource[async_context_frame_symbol] =
+    executionAsyncResource()[async_context_frame_symbol];
+}
+
 // Internal Embedder API //
 
 // Increment the internal id counter and return the value. Important that the
@@ -413,7 +440,9 @@ function popAsyncContext(asyncId) {
   const offset = stackLength - 1;
   async_id_fields[kExecutionAsyncId] = async_wrap.async_ids_stack[2 * offset];
   async_id_fields[kTriggerAsyncId] = async_wrap.async_ids_stack[2 * offset + 1];
-  execution_async_resources.pop();
+  // The array may end below `offset` when the resource was pushed from C++.
+  if (execution_async_resources.length > offset)
+    execution_async_resources.length = offset;
   async_hook_fields[kStackLength] = offset;
   return offset > 0;
 }
@@ -436,13 +465,16 @@ module.exports = {
   symbols: {
     async_id_symbol, trigger_async_id_symbol,
     init_symbol, before_symbol, after_symbol, destroy_symbol,
-    promise_resolve_symbol, owner_symbol
+    promise_resolve_symbol, owner_symbol, async_context_frame_symbol
   },
   constants: {
     kInit, kBefore, kAfter, kDestroy, kTotals, kPromiseResolve
   },
   enableHooks,
   disableHooks,
+  enableAsyncContext,
+  disableAsyncContext,
+  inheritAsyncContextFrame,
   clearDefaultTriggerAsyncId,
   clearAsyncIdStack,
   hasAsyncIdStack,
@@ -83,6 +83,11 @@ const rawMethods = internalBinding('process_methods');
   process.cpuUsage = wrapped.cpuUsage;
   process.resourceUsage = wrapped.resourceUsage;
   process.memoryUsage = wrapped.memoryUsage;
+  ObjectDefineProperty(process, 'memoryStats', {
+    get: wrapped.getMemoryStats,
+    enumerable: true,
+    configurable: true
+  });
   process.kill = wrapped.kill;
   process.exit = wrapped.exit;
 
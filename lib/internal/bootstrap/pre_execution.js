@@ -223,11 +223,10 @@ function setupInspectorHooks() {
   // notification in the inspector agent if it's sent in the middle of
   // bootstrap, and process the notification later here.
   if (internalBinding('config').hasInspector) {
-    const {
-      enable,
-      disable
-    } = require('internal/inspector_async_hook');
-    internalBinding('inspector').registerAsyncHook(enable, disable);
+    // The hooks are only loaded once the inspector asks for them.
+    internalBinding('inspector').registerAsyncHook(
+      () => require('internal/inspector_async_hook').enable(),
+      () => require('internal/inspector_async_hook').disable());
   }
 }
 
@@ -421,11 +420,18 @@ function initializeESMLoader() {
     setImportModuleDynamicallyCallback,
     setInitializeImportMetaObjectCallback
   } = internalBinding('module_wrap');
-  const esm = require('internal/process/esm_loader');
   // Setup per-isolate callbacks that locate data or callbacks that we keep
-  // track of for different ESM modules.
-  setInitializeImportMetaObjectCallback(esm.initializeImportMetaObject);
-  setImportModuleDynamicallyCallback(esm.importModuleDynamicallyCallback);
+  // track of for different ESM modules. The ESM loader is only loaded once
+  // these are called, to keep it out of the startup of CommonJS
+  // applications.
+  setInitializeImportMetaObjectCallback((wrap, meta) => {
+    const esm = require('internal/process/esm_loader');
+    return esm.initializeImportMetaObject(wrap, meta);
+  });
+  setImportModuleDynamicallyCallback((wrap, specifier) => {
+    const esm = require('internal/process/esm_loader');
+    return esm.importModuleDynamicallyCallback(wrap, specifier);
+  });
 }
 
 function initializeFrozenIntrinsics() {
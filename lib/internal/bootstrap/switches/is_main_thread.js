@@ -1,6 +1,9 @@
 'use strict';
 
-const { ObjectDefineProperty } = primordials;
+const {
+  ObjectDefineProperty,
+  ReflectApply,
+} = primordials;
 const rawMethods = internalBinding('process_methods');
 
 // TODO(joyeecheung): deprecate and remove these underscore methods
@@ -34,14 +37,71 @@ process.on('removeListener', stopListeningIfSignal);
 
 const { guessHandleType } = internalBinding('util');
 
+// Corks `stream` on the first write of a tick and uncorks it once the tick is
+// over, so that all writes of the tick reach the terminal with one writev().
+// Only one stream is corked at a time: a write to another stream flushes the
+// corked one first, so that stdout and stderr output stays in order. Writes
+// that are still corked when the process exits are flushed on 'exit'.
+let corkedStdio = null;
+let stdioFlushScheduled = false;
+let stdioExitHandlerAdded = false;
+
+function uncorkStdio() {
+  if (corkedStdio !== null) {
+    const stream = corkedStdio;
+    corkedStdio = null;
+    stream.uncork();
+  }
+}
+
+function flushStdio() {
+  stdioFlushScheduled = false;
+  uncorkStdio();
+}
+
+function coalesceWrites(stream) {
+  const write = stream.write;
+  stream.write = function() {
+    if (corkedStdio !== stream) {
+      uncorkStdio();
+      corkedStdio = stream;
+      stream.cork();
+      if (!stdioFlushScheduled) {
+        stdioFlushScheduled = true;
+        process.nextTick(flushStdio);
+      }
+    }
+    return ReflectApply(write, this, arguments);
+  };
+  if (!stdioExitHandlerAdded) {
+    stdioExitHandlerAdded = true;
+    process.on('exit', uncorkStdio);
+  }
+}
+
 function createWritableStdioStream(fd) {
   let stream;
+  const type = guessHandleType(fd);
+  const buffered =
+    require('internal/options').getOptionValue('--buffered-stdio');
+  if ((type === 'FILE' || type === 'PIPE') &&
+      !(process.channel && process.channel.fd === fd) && buffered) {
+    const BufferedWriteStream = require('internal/fs/buffered_write_stream');
+    stream = new BufferedWriteStream(fd);
+    stream._type = type === 'FILE' ? 'fs' : 'pipe';
+    stream.fd = fd;
+    stream._isStdio = true;
+    return stream;
+  }
+
   // Note stream._type is used for test-module-load-list.js
-  switch (guessHandleType(fd)) {
+  switch (type) {
     case 'TTY':
       const tty = require('tty');
       stream = new tty.WriteStream(fd);
       stream._type = 'tty';
+      if (buffered)
+        coalesceWrites(stream);
       break;
 
     case 'FILE':
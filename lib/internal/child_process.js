@@ -32,11 +32,11 @@ const { Process } = internalBinding('process_wrap');
 const {
   WriteWrap,
   kReadBytesOrError,
-  kArrayBufferOffset,
   kLastWriteWasAsync,
   streamBaseState
 } = internalBinding('stream_wrap');
 const { Pipe, constants: PipeConstants } = internalBinding('pipe_wrap');
+const { StreamPipe } = internalBinding('stream_pipe');
 const { TCP } = internalBinding('tcp_wrap');
 const { TTY } = internalBinding('tty_wrap');
 const { UDP } = internalBinding('udp_wrap');
@@ -314,6 +314,24 @@ function createSocket(pipe, readable) {
 }
 
 
+// Copies the output of the child from `stream.handle` into the StreamBase
+// handle of `stream.pipeTo` without passing through JavaScript. The
+// destination is not ended when the child's output ends.
+function pipeToStream(subprocess, stream) {
+  const { handle } = stream;
+  handle.onread = onPipedStdioRead;
+  const pipe = new StreamPipe(handle, stream.pipeTo._handle, false);
+  pipe.onunpipe = () => {
+    handle.close(() => maybeClose(subprocess));
+  };
+  pipe.start();
+}
+
+// The piped output has ended, or could not be read any more. Either way the
+// pipe closes itself, so there is nothing left to do here.
+function onPipedStdioRead() {}
+
+
 function getHandleWrapType(stream) {
   if (stream instanceof Pipe) return 'pipe';
   if (stream instanceof TTY) return 'tty';
@@ -417,6 +435,16 @@ ChildProcess.prototype.spawn = function(options) {
       continue;
     }
 
+    if (stream.pipeTo !== undefined) {
+      if (this.pid !== 0) {
+        this._closesNeeded++;
+        pipeToStream(this, stream);
+      } else {
+        stream.handle.close();
+      }
+      continue;
+    }
+
     // The stream is already cloned and piped, thus stop its readable side,
     // otherwise we might attempt to read from the stream when at the same time
     // the child process does.
@@ -573,26 +601,25 @@ function setupChannel(target, channel, serializationMode) {
 
   if (serialization === undefined)
     serialization = require('internal/child_process/serialization');
-  const {
-    initMessageChannel,
-    parseChannelMessages,
-    writeChannelMessage
-  } = serialization[serializationMode];
+  const { writeChannelMessage } = serialization[serializationMode];
 
   let pendingHandle = null;
-  initMessageChannel(channel);
+  channel.buffering = false;
   channel.pendingHandle = null;
-  channel.onread = function(arrayBuffer) {
+  // The channel is split into messages natively, and every read results in
+  // an array of the messages that it completed.
+  channel.readMessages(serializationMode === 'advanced' ?
+    PipeConstants.MESSAGES_ADVANCED : PipeConstants.MESSAGES_JSON);
+  channel.onread = function(messages) {
     const recvHandle = channel.pendingHandle;
     channel.pendingHandle = null;
-    if (arrayBuffer) {
-      const nread = streamBaseState[kReadBytesOrError];
-      const offset = streamBaseState[kArrayBufferOffset];
-      const pool = new Uint8Array(arrayBuffer, offset, nread);
+    if (messages) {
+      // The size of the incomplete message that is left, if any.
+      this.buffering = streamBaseState[kReadBytesOrError] > 0;
       if (recvHandle)
         pendingHandle = recvHandle;
 
-      for (const message of parseChannelMessages(channel, pool)) {
+      for (const message of messages) {
         // There will be at most one NODE_HANDLE message in every chunk we
         // read because SCM_RIGHTS messages don't get coalesced. Make sure
         // that we deliver the handle with the right message however.
@@ -1015,6 +1042,16 @@ function getValidStdio(stdio, sync) {
         handle: handle,
         _stdio: stdio
       });
+    } else if (!sync && i > 0 && stdio._handle && stdio._handle.isStreamBase) {
+      // Streams without a file descriptor of their own, such as TLS sockets,
+      // are written to natively from a new pipe.
+      acc.push({
+        type: 'pipe',
+        readable: false,
+        writable: true,
+        handle: new Pipe(PipeConstants.SOCKET),
+        pipeTo: stdio
+      });
     } else if (isArrayBufferView(stdio) || typeof stdio === 'string') {
       if (!sync) {
         cleanup();
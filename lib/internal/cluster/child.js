@@ -7,10 +7,12 @@ const {
 
 const assert = require('internal/assert');
 const path = require('path');
+const net = require('net');
 const EventEmitter = require('events');
 const { owner_symbol } = require('internal/async_hooks').symbols;
 const Worker = require('internal/cluster/worker');
 const { internal, sendHelper } = require('internal/cluster/utils');
+const { constants: TCPConstants } = internalBinding('tcp_wrap');
 const cluster = new EventEmitter();
 const handles = new Map();
 const indexes = new Map();
@@ -95,6 +97,8 @@ cluster._getServer = function(obj, options, cb) {
 
     if (handle)
       shared(reply, handle, indexesKey, cb);  // Shared listen socket.
+    else if (reply.reusePort)
+      reusePort(reply, message, indexesKey, cb);  // SO_REUSEPORT.
     else
       rr(reply, indexesKey, cb);              // Round-robin.
   });
@@ -126,6 +130,52 @@ function shared(message, handle, indexesKey, cb) {
   cb(message.errno, handle);
 }
 
+// SO_REUSEPORT. The worker binds a listen socket of its own to the port that
+// the master reserved, the kernel distributes connections across workers.
+function reusePort(message, query, indexesKey, cb) {
+  if (message.errno)
+    return cb(message.errno, null);
+
+  const key = message.key;
+  const flags = query.flags | TCPConstants.UV_TCP_REUSEPORT;
+  let err = 0;
+  let handle = net._createServerHandle(query.address,
+                                       message.port,
+                                       query.addressType,
+                                       query.fd,
+                                       flags);
+
+  if (typeof handle === 'number') {
+    err = handle;
+    handle = null;
+  } else if (message.cpuSteering) {
+    err = handle.setReusePortCpuSteering();
+    if (err) {
+      handle.close();
+      handle = null;
+    }
+  }
+
+  if (err) {
+    send({ act: 'close', key });
+    indexes.delete(indexesKey);
+    return cb(err, null);
+  }
+
+  // Let the master know when the handle is closed, same as shared().
+  const close = handle.close;
+
+  handle.close = function() {
+    send({ act: 'close', key });
+    handles.delete(key);
+    indexes.delete(indexesKey);
+    return close.apply(handle, arguments);
+  };
+  assert(handles.has(key) === false);
+  handles.set(key, handle);
+  cb(0, handle);
+}
+
 // Round-robin. Master distributes handles across workers.
 function rr(message, indexesKey, cb) {
   if (message.errno)
@@ -10,6 +10,7 @@ const assert = require('internal/assert');
 const { fork } = require('child_process');
 const path = require('path');
 const EventEmitter = require('events');
+const ReusePortHandle = require('internal/cluster/reuse_port_handle');
 const RoundRobinHandle = require('internal/cluster/round_robin_handle');
 const SharedHandle = require('internal/cluster/shared_handle');
 const Worker = require('internal/cluster/worker');
@@ -19,6 +20,8 @@ const cluster = new EventEmitter();
 const intercom = new EventEmitter();
 const SCHED_NONE = 1;
 const SCHED_RR = 2;
+const SCHED_REUSEPORT = 3;
+const { UV_ENOTSUP } = internalBinding('uv');
 const { isLegalPort } = require('internal/net');
 const [ minPort, maxPort ] = [ 1024, 65535 ];
 
@@ -32,6 +35,7 @@ cluster.workers = {};
 cluster.settings = {};
 cluster.SCHED_NONE = SCHED_NONE;  // Leave it to the operating system.
 cluster.SCHED_RR = SCHED_RR;      // Master distributes connections.
+cluster.SCHED_REUSEPORT = SCHED_REUSEPORT;  // Kernel distributes connections.
 
 let ids = 0;
 let debugPortOffset = 1;
@@ -40,7 +44,8 @@ let initialized = false;
 // XXX(bnoordhuis) Fold cluster.schedulingPolicy into cluster.settings?
 let schedulingPolicy = {
   'none': SCHED_NONE,
-  'rr': SCHED_RR
+  'rr': SCHED_RR,
+  'reuseport': SCHED_REUSEPORT
 }[process.env.NODE_CLUSTER_SCHED_POLICY];
 
 if (schedulingPolicy === undefined) {
@@ -77,7 +82,8 @@ cluster.setupMaster = function(options) {
 
   initialized = true;
   schedulingPolicy = cluster.schedulingPolicy;  // Freeze policy.
-  assert(schedulingPolicy === SCHED_NONE || schedulingPolicy === SCHED_RR,
+  assert(schedulingPolicy === SCHED_NONE || schedulingPolicy === SCHED_RR ||
+         schedulingPolicy === SCHED_REUSEPORT,
          `Bad cluster.schedulingPolicy: ${schedulingPolicy}`);
 
   process.nextTick(setupSettingsNT, settings);
@@ -294,10 +300,16 @@ function queryServer(worker, message) {
     // UDP is exempt from round-robin connection balancing for what should
     // be obvious reasons: it's connectionless. There is nothing to send to
     // the workers except raw datagrams and that's pointless.
-    if (schedulingPolicy !== SCHED_RR ||
+    if (schedulingPolicy === SCHED_NONE ||
         message.addressType === 'udp4' ||
         message.addressType === 'udp6') {
       constructor = SharedHandle;
+    } else if (schedulingPolicy === SCHED_REUSEPORT &&
+               (message.addressType === 4 || message.addressType === 6) &&
+               !(message.fd >= 0)) {
+      // Pipes and inherited file descriptors can't share a port the
+      // SO_REUSEPORT way, they stay with round-robin.
+      constructor = ReusePortHandle;
     }
 
     handle = new constructor(key,
@@ -306,6 +318,22 @@ function queryServer(worker, message) {
                              message.addressType,
                              message.fd,
                              message.flags);
+
+    if (constructor === ReusePortHandle) {
+      if (handle.errno === UV_ENOTSUP) {
+        // The platform doesn't balance connections across SO_REUSEPORT
+        // sockets, fall back to round-robin.
+        handle = new RoundRobinHandle(key,
+                                      address,
+                                      message.port,
+                                      message.addressType,
+                                      message.fd,
+                                      message.flags);
+      } else {
+        handle.cpuSteering = cluster.settings.reusePortCpuSteering === true;
+      }
+    }
+
     handles.set(key, handle);
   }
 
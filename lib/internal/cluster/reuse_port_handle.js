@@ -0,0 +1,67 @@
+'use strict';
+const assert = require('internal/assert');
+const net = require('net');
+const { constants } = internalBinding('tcp_wrap');
+
+module.exports = ReusePortHandle;
+
+// Every worker binds and listens on a socket of its own with SO_REUSEPORT
+// and the kernel spreads the incoming connections across them. The master
+// only holds on to a bound but not listening socket that keeps the port
+// reserved, so that all workers end up on the same port when port 0 is used.
+function ReusePortHandle(key, address, port, addressType, fd, flags) {
+  this.key = key;
+  this.workers = [];
+  this.handle = null;
+  this.errno = 0;
+  this.port = port;
+  this.cpuSteering = false;
+
+  const rval = net._createServerHandle(address, port, addressType, fd,
+                                       flags | constants.UV_TCP_REUSEPORT);
+
+  if (typeof rval === 'number') {
+    this.errno = rval;
+    return;
+  }
+
+  const out = {};
+  const err = rval.getsockname(out);
+
+  if (err) {
+    rval.close();
+    this.errno = err;
+  } else {
+    this.handle = rval;
+    this.port = out.port;
+  }
+}
+
+ReusePortHandle.prototype.add = function(worker, send) {
+  assert(!this.workers.includes(worker));
+  this.workers.push(worker);
+  send(this.errno, {
+    reusePort: true,
+    port: this.port,
+    cpuSteering: this.cpuSteering
+  }, null);
+};
+
+ReusePortHandle.prototype.remove = function(worker) {
+  const index = this.workers.indexOf(worker);
+
+  if (index === -1)
+    return false; // The worker wasn't using this handle.
+
+  this.workers.splice(index, 1);
+
+  if (this.workers.length !== 0)
+    return false;
+
+  if (this.handle !== null) {
+    this.handle.close();
+    this.handle = null;
+  }
+
+  return true;
+};
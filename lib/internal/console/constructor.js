@@ -36,7 +36,7 @@ const { previewEntries } = internalBinding('util');
 const { Buffer: { isBuffer } } = require('buffer');
 const {
   inspect,
-  formatWithOptions
+  formatWithOptionsInternal
 } = require('internal/util/inspect');
 const {
   isTypedArray, isSet, isMap, isSetIterator, isMapIterator,
@@ -284,12 +284,12 @@ Console.prototype[kGetInspectOptions] = function(stream) {
 
 Console.prototype[kFormatForStdout] = function(args) {
   const opts = this[kGetInspectOptions](this._stdout);
-  return formatWithOptions(opts, ...args);
+  return formatWithOptionsInternal(opts, args);
 };
 
 Console.prototype[kFormatForStderr] = function(args) {
   const opts = this[kGetInspectOptions](this._stderr);
-  return formatWithOptions(opts, ...args);
+  return formatWithOptionsInternal(opts, args);
 };
 
 const consoleMethods = {
@@ -1,6 +1,7 @@
 'use strict';
 
 const {
+  Array,
   ObjectSetPrototypeOf,
 } = primordials;
 
@@ -10,24 +11,37 @@ const {
 } = internalBinding('constants').crypto;
 
 const {
+  ERR_CRYPTO_INVALID_KEY_OBJECT_TYPE,
   ERR_CRYPTO_INVALID_STATE,
   ERR_INVALID_ARG_TYPE,
   ERR_INVALID_OPT_VALUE
 } = require('internal/errors').codes;
-const { validateEncoding, validateString } = require('internal/validators');
+const {
+  validateArray,
+  validateEncoding,
+  validateObject,
+  validateString,
+  validateUint32
+} = require('internal/validators');
 
 const {
+  isKeyObject,
   preparePrivateKey,
   preparePublicOrPrivateKey,
   prepareSecretKey
 } = require('internal/crypto/keys');
 const {
+  checkNoAsyncUpdate,
+  getAsyncUpdatesOption,
   getDefaultEncoding,
+  kAsyncUpdates,
   kHandle,
-  getArrayBufferView
+  getArrayBufferView,
+  scheduleAsyncUpdate
 } = require('internal/crypto/util');
 
 const { isArrayBufferView } = require('internal/util/types');
+const { FastBuffer } = require('internal/buffer');
 
 const {
   CipherBase,
@@ -103,6 +117,7 @@ function createCipherBase(cipher, credential, options, decipher, iv) {
     this[kHandle].initiv(cipher, credential, iv, authTagLength);
   }
   this._decoder = null;
+  this[kAsyncUpdates] = getAsyncUpdatesOption(options);
 
   LazyTransform.call(this, options);
 }
@@ -132,6 +147,8 @@ ObjectSetPrototypeOf(Cipher.prototype, LazyTransform.prototype);
 ObjectSetPrototypeOf(Cipher, LazyTransform);
 
 Cipher.prototype._transform = function _transform(chunk, encoding, callback) {
+  if (this[kAsyncUpdates] && scheduleAsyncUpdate(this, chunk, callback))
+    return;
   this.push(this[kHandle].update(chunk, encoding));
   callback();
 };
@@ -157,6 +174,7 @@ Cipher.prototype.update = function update(data, inputEncoding, outputEncoding) {
   }
 
   validateEncoding(data, inputEncoding);
+  checkNoAsyncUpdate(this, 'update');
 
   const ret = this[kHandle].update(data, inputEncoding);
 
@@ -171,6 +189,7 @@ Cipher.prototype.update = function update(data, inputEncoding, outputEncoding) {
 
 Cipher.prototype.final = function final(outputEncoding) {
   outputEncoding = outputEncoding || getDefaultEncoding();
+  checkNoAsyncUpdate(this, 'final');
   const ret = this[kHandle].final();
 
   if (outputEncoding && outputEncoding !== 'buffer') {
@@ -183,12 +202,14 @@ Cipher.prototype.final = function final(outputEncoding) {
 
 
 Cipher.prototype.setAutoPadding = function setAutoPadding(ap) {
+  checkNoAsyncUpdate(this, 'setAutoPadding');
   if (!this[kHandle].setAutoPadding(!!ap))
     throw new ERR_CRYPTO_INVALID_STATE('setAutoPadding');
   return this;
 };
 
 Cipher.prototype.getAuthTag = function getAuthTag() {
+  checkNoAsyncUpdate(this, 'getAuthTag');
   const ret = this[kHandle].getAuthTag();
   if (ret === undefined)
     throw new ERR_CRYPTO_INVALID_STATE('getAuthTag');
@@ -202,6 +223,7 @@ function setAuthTag(tagbuf) {
                                    ['Buffer', 'TypedArray', 'DataView'],
                                    tagbuf);
   }
+  checkNoAsyncUpdate(this, 'setAuthTag');
   if (!this[kHandle].setAuthTag(tagbuf))
     throw new ERR_CRYPTO_INVALID_STATE('setAuthTag');
   return this;
@@ -215,6 +237,7 @@ Cipher.prototype.setAAD = function setAAD(aadbuf, options) {
   }
 
   const plaintextLength = getUIntOption(options, 'plaintextLength');
+  checkNoAsyncUpdate(this, 'setAAD');
   if (!this[kHandle].setAAD(aadbuf, plaintextLength))
     throw new ERR_CRYPTO_INVALID_STATE('setAAD');
   return this;
@@ -268,7 +291,78 @@ ObjectSetPrototypeOf(Decipheriv.prototype, LazyTransform.prototype);
 ObjectSetPrototypeOf(Decipheriv, LazyTransform);
 addCipherPrototypeFunctions(Decipheriv);
 
+function getAeadKeyHandle(key) {
+  if (!isKeyObject(key))
+    throw new ERR_INVALID_ARG_TYPE('key', 'KeyObject', key);
+  if (key.type !== 'secret')
+    throw new ERR_CRYPTO_INVALID_KEY_OBJECT_TYPE(key.type, 'secret');
+  return key[kHandle];
+}
+
+function getAeadAuthTagLength(options) {
+  if (options === undefined)
+    return 16;
+  validateObject(options, 'options');
+  const { authTagLength = 16 } = options;
+  validateUint32(authTagLength, 'options.authTagLength');
+  return authTagLength;
+}
+
+function aeadOneShot(method, algorithm, key, iv, data, options) {
+  validateString(algorithm, 'algorithm');
+  const handle = getAeadKeyHandle(key);
+  iv = getArrayBufferView(iv, 'iv');
+  data = getArrayBufferView(data, 'data');
+  const authTagLength = getAeadAuthTagLength(options);
+  let aad = options !== undefined ? options.aad : undefined;
+  aad = aad === undefined ? new FastBuffer() : getArrayBufferView(aad, 'aad');
+  return handle[method](algorithm, iv, data, aad, authTagLength);
+}
+
+function aeadBatch(method, algorithm, key, records, options) {
+  validateString(algorithm, 'algorithm');
+  const handle = getAeadKeyHandle(key);
+  validateArray(records, 'records');
+  const authTagLength = getAeadAuthTagLength(options);
+
+  const ivs = new Array(records.length);
+  const inputs = new Array(records.length);
+  let aads;
+  for (let i = 0; i < records.length; i++) {
+    const record = records[i];
+    validateObject(record, `records[${i}]`);
+    ivs[i] = getArrayBufferView(record.iv, `records[${i}].iv`);
+    inputs[i] = getArrayBufferView(record.data, `records[${i}].data`);
+    if (record.aad !== undefined) {
+      if (aads === undefined)
+        aads = new Array(records.length);
+      aads[i] = getArrayBufferView(record.aad, `records[${i}].aad`);
+    }
+  }
+  return handle[method](algorithm, ivs, inputs, aads, authTagLength);
+}
+
+function aeadSeal(algorithm, key, iv, plaintext, options) {
+  return aeadOneShot('aeadSeal', algorithm, key, iv, plaintext, options);
+}
+
+function aeadOpen(algorithm, key, iv, ciphertext, options) {
+  return aeadOneShot('aeadOpen', algorithm, key, iv, ciphertext, options);
+}
+
+function aeadSealBatch(algorithm, key, records, options) {
+  return aeadBatch('aeadSealBatch', algorithm, key, records, options);
+}
+
+function aeadOpenBatch(algorithm, key, records, options) {
+  return aeadBatch('aeadOpenBatch', algorithm, key, records, options);
+}
+
 module.exports = {
+  aeadOpen,
+  aeadOpenBatch,
+  aeadSeal,
+  aeadSealBatch,
   Cipher,
   Cipheriv,
   Decipher,
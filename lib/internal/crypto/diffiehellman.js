@@ -1,6 +1,9 @@
 'use strict';
 
 const {
+  Array,
+  ArrayIsArray,
+  MathMin,
   ObjectDefineProperty,
   Set
 } = primordials;
@@ -12,8 +15,10 @@ const {
   ERR_CRYPTO_INCOMPATIBLE_KEY,
   ERR_CRYPTO_INVALID_KEY_OBJECT_TYPE,
   ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_CALLBACK,
   ERR_INVALID_OPT_VALUE
 } = require('internal/errors').codes;
+const { AsyncWrap, Providers } = internalBinding('async_wrap');
 const { validateString } = require('internal/validators');
 const { isArrayBufferView } = require('internal/util/types');
 const { KeyObject } = require('internal/crypto/keys');
@@ -27,6 +32,7 @@ const {
   DiffieHellmanGroup: _DiffieHellmanGroup,
   ECDH: _ECDH,
   ECDHConvertKey: _ECDHConvertKey,
+  diffieHellmanBatch: _diffieHellmanBatch,
   statelessDH
 } = internalBinding('crypto');
 const {
@@ -240,9 +246,9 @@ function getFormat(format) {
 
 const dhEnabledKeyTypes = new Set(['dh', 'ec', 'x448', 'x25519']);
 
-function diffieHellman(options) {
-  if (typeof options !== 'object')
-    throw new ERR_INVALID_ARG_TYPE('options', 'object', options);
+function validateDiffieHellmanKeys(options, name) {
+  if (options === null || typeof options !== 'object')
+    throw new ERR_INVALID_ARG_TYPE(name, 'object', options);
 
   const { privateKey, publicKey } = options;
   if (!(privateKey instanceof KeyObject))
@@ -265,13 +271,60 @@ function diffieHellman(options) {
     throw new ERR_CRYPTO_INCOMPATIBLE_KEY('key types for Diffie-Hellman',
                                           `${privateType} and ${publicType}`);
   }
+}
+
+function diffieHellman(options) {
+  validateDiffieHellmanKeys(options, 'options');
+  return statelessDH(options.privateKey[kHandle], options.publicKey[kHandle]);
+}
+
+// diffieHellmanBatch() hands this many items at a time to the threadpool, so
+// that large batches are spread over the threadpool's threads.
+const kDiffieHellmanBatchChunkSize = 64;
+
+function diffieHellmanBatch(items, callback) {
+  if (!ArrayIsArray(items))
+    throw new ERR_INVALID_ARG_TYPE('items', 'Array', items);
+  if (typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK(callback);
+
+  const count = items.length;
+  const chunks = [];
+  for (let start = 0; start < count; start += kDiffieHellmanBatchChunkSize) {
+    const end = MathMin(start + kDiffieHellmanBatchChunkSize, count);
+    const privateKeys = [];
+    const publicKeys = [];
+    for (let i = start; i < end; i++) {
+      validateDiffieHellmanKeys(items[i], `items[${i}]`);
+      privateKeys.push(items[i].privateKey[kHandle]);
+      publicKeys.push(items[i].publicKey[kHandle]);
+    }
+    chunks.push({ privateKeys, publicKeys, start });
+  }
 
-  return statelessDH(privateKey[kHandle], publicKey[kHandle]);
+  const secrets = new Array(count);
+  if (count === 0) {
+    process.nextTick(callback, null, secrets);
+    return;
+  }
+
+  let pending = chunks.length;
+  for (const { privateKeys, publicKeys, start } of chunks) {
+    const wrap = new AsyncWrap(Providers.DIFFIEHELLMANBATCHREQUEST);
+    wrap.ondone = (chunkSecrets) => {
+      for (let i = 0; i < chunkSecrets.length; i++)
+        secrets[start + i] = chunkSecrets[i];
+      if (--pending === 0)
+        callback.call(wrap, null, secrets);
+    };
+    _diffieHellmanBatch(privateKeys, publicKeys, wrap);
+  }
 }
 
 module.exports = {
   DiffieHellman,
   DiffieHellmanGroup,
   ECDH,
-  diffieHellman
+  diffieHellman,
+  diffieHellmanBatch
 };
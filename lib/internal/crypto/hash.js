@@ -7,12 +7,18 @@ const {
 
 const {
   Hash: _Hash,
-  Hmac: _Hmac
+  Hmac: _Hmac,
+  hash: _hash
 } = internalBinding('crypto');
+const { AsyncWrap, Providers } = internalBinding('async_wrap');
 
 const {
+  checkNoAsyncUpdate,
+  getAsyncUpdatesOption,
   getDefaultEncoding,
+  kAsyncUpdates,
   kHandle,
+  scheduleAsyncUpdate,
   toBuf
 } = require('internal/crypto/util');
 
@@ -20,20 +26,29 @@ const {
   prepareSecretKey
 } = require('internal/crypto/keys');
 
-const { Buffer } = require('buffer');
+const { Buffer, Rope } = require('buffer');
 
 const {
   ERR_CRYPTO_HASH_FINALIZED,
   ERR_CRYPTO_HASH_UPDATE_FAILED,
-  ERR_INVALID_ARG_TYPE
+  ERR_CRYPTO_INVALID_DIGEST,
+  ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_CALLBACK,
+  ERR_UNKNOWN_ENCODING
 } = require('internal/errors').codes;
 const { validateEncoding, validateString, validateUint32 } =
   require('internal/validators');
 const { isArrayBufferView } = require('internal/util/types');
+const { normalizeEncoding } = require('internal/util');
 const LazyTransform = require('internal/streams/lazy_transform');
 const kState = Symbol('kState');
 const kFinalized = Symbol('kFinalized');
 
+// Inputs smaller than this are hashed on the main thread even if a callback
+// is passed to hash(), since dispatching them to the threadpool would cost
+// more than the digest itself.
+const kHashThreadpoolThreshold = 64 * 1024;
+
 function Hash(algorithm, options) {
   if (!(this instanceof Hash))
     return new Hash(algorithm, options);
@@ -47,6 +62,7 @@ function Hash(algorithm, options) {
   this[kState] = {
     [kFinalized]: false
   };
+  this[kAsyncUpdates] = getAsyncUpdatesOption(options);
   LazyTransform.call(this, options);
 }
 
@@ -57,11 +73,14 @@ Hash.prototype.copy = function copy(options) {
   const state = this[kState];
   if (state[kFinalized])
     throw new ERR_CRYPTO_HASH_FINALIZED();
+  checkNoAsyncUpdate(this, 'copy');
 
   return new Hash(this[kHandle], options);
 };
 
 Hash.prototype._transform = function _transform(chunk, encoding, callback) {
+  if (this[kAsyncUpdates] && scheduleAsyncUpdate(this, chunk, callback))
+    return;
   this[kHandle].update(chunk, encoding);
   callback();
 };
@@ -78,6 +97,15 @@ Hash.prototype.update = function update(data, encoding) {
   if (state[kFinalized])
     throw new ERR_CRYPTO_HASH_FINALIZED();
 
+  if (data instanceof Rope) {
+    checkNoAsyncUpdate(this, 'update');
+    for (const chunk of data) {
+      if (!this[kHandle].update(chunk))
+        throw new ERR_CRYPTO_HASH_UPDATE_FAILED();
+    }
+    return this;
+  }
+
   if (typeof data !== 'string' && !isArrayBufferView(data)) {
     throw new ERR_INVALID_ARG_TYPE('data',
                                    ['string',
@@ -88,6 +116,7 @@ Hash.prototype.update = function update(data, encoding) {
   }
 
   validateEncoding(data, encoding);
+  checkNoAsyncUpdate(this, 'update');
 
   if (!this[kHandle].update(data, encoding))
     throw new ERR_CRYPTO_HASH_UPDATE_FAILED();
@@ -99,6 +128,7 @@ Hash.prototype.digest = function digest(outputEncoding) {
   const state = this[kState];
   if (state[kFinalized])
     throw new ERR_CRYPTO_HASH_FINALIZED();
+  checkNoAsyncUpdate(this, 'digest');
   outputEncoding = outputEncoding || getDefaultEncoding();
 
   // Explicit conversion for backward compatibility.
@@ -118,6 +148,7 @@ function Hmac(hmac, key, options) {
   this[kState] = {
     [kFinalized]: false
   };
+  this[kAsyncUpdates] = getAsyncUpdatesOption(options);
   LazyTransform.call(this, options);
 }
 
@@ -129,6 +160,7 @@ Hmac.prototype.update = Hash.prototype.update;
 Hmac.prototype.digest = function digest(outputEncoding) {
   const state = this[kState];
   outputEncoding = outputEncoding || getDefaultEncoding();
+  checkNoAsyncUpdate(this, 'digest');
 
   if (state[kFinalized]) {
     const buf = Buffer.from('');
@@ -144,7 +176,58 @@ Hmac.prototype.digest = function digest(outputEncoding) {
 Hmac.prototype._flush = Hash.prototype._flush;
 Hmac.prototype._transform = Hash.prototype._transform;
 
+function hash(algorithm, data, outputEncoding, callback) {
+  if (typeof outputEncoding === 'function') {
+    callback = outputEncoding;
+    outputEncoding = undefined;
+  }
+  validateString(algorithm, 'algorithm');
+  if (typeof data !== 'string' && !isArrayBufferView(data)) {
+    throw new ERR_INVALID_ARG_TYPE('data',
+                                   ['string',
+                                    'Buffer',
+                                    'TypedArray',
+                                    'DataView'],
+                                   data);
+  }
+  if (outputEncoding === undefined) {
+    outputEncoding = 'hex';
+  } else {
+    validateString(outputEncoding, 'outputEncoding');
+    if (outputEncoding !== 'buffer' &&
+        normalizeEncoding(outputEncoding) === undefined) {
+      throw new ERR_UNKNOWN_ENCODING(outputEncoding);
+    }
+  }
+  if (callback !== undefined && typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK(callback);
+
+  if (callback === undefined ||
+      (typeof data === 'string' ? data.length : data.byteLength) <
+        kHashThreadpoolThreshold) {
+    const ret = _hash(algorithm, data, outputEncoding);
+    if (ret === undefined)
+      throw new ERR_CRYPTO_INVALID_DIGEST(algorithm);
+    if (callback === undefined)
+      return ret;
+    process.nextTick(callback, null, ret);
+    return;
+  }
+
+  if (typeof data === 'string')
+    data = Buffer.from(data, 'utf8');
+  const wrap = new AsyncWrap(Providers.HASHREQUEST);
+  wrap.data = data;  // Retains data while the request is in flight.
+  wrap.ondone = (err, digest) => {
+    wrap.data = null;
+    callback.call(wrap, err, digest);
+  };
+  if (_hash(algorithm, data, outputEncoding, wrap) === undefined)
+    throw new ERR_CRYPTO_INVALID_DIGEST(algorithm);
+}
+
 module.exports = {
   Hash,
-  Hmac
+  Hmac,
+  hash
 };
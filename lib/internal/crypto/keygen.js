@@ -2,6 +2,7 @@
 
 const {
   ObjectDefineProperty,
+  Symbol,
 } = primordials;
 
 const { AsyncWrap, Providers } = internalBinding('async_wrap');
@@ -26,15 +27,22 @@ const {
   PublicKeyObject,
   PrivateKeyObject
 } = require('internal/crypto/keys');
+const EventEmitter = require('events');
 const { customPromisifyArgs } = require('internal/util');
-const { isUint32, validateString } = require('internal/validators');
+const {
+  isUint32,
+  validateObject,
+  validateString,
+  validateUint32
+} = require('internal/validators');
 const {
   ERR_INCOMPATIBLE_OPTION_PAIR,
   ERR_INVALID_ARG_TYPE,
   ERR_INVALID_ARG_VALUE,
   ERR_INVALID_CALLBACK,
   ERR_INVALID_OPT_VALUE,
-  ERR_MISSING_OPTION
+  ERR_MISSING_OPTION,
+  ERR_OUT_OF_RANGE
 } = require('internal/errors').codes;
 
 const { isArrayBufferView } = require('internal/util/types');
@@ -310,4 +318,91 @@ function check(type, options, callback) {
   return impl;
 }
 
-module.exports = { generateKeyPair, generateKeyPairSync };
+const kImpl = Symbol('kImpl');
+const kKeyPairs = Symbol('kKeyPairs');
+const kPending = Symbol('kPending');
+const kClosed = Symbol('kClosed');
+const kRefill = Symbol('kRefill');
+
+// Keeps between lowWaterMark and highWaterMark key pairs generated ahead of
+// time, so that take() returns one without waiting. Up to `concurrency` keys
+// are generated at the same time, each on a different threadpool thread.
+class KeyPairPool extends EventEmitter {
+  constructor(type, options, poolOptions = {}) {
+    super();
+    this[kImpl] = check(type, options);
+
+    validateObject(poolOptions, 'poolOptions');
+    const {
+      lowWaterMark = 2,
+      highWaterMark = 8,
+      concurrency = 2
+    } = poolOptions;
+    validateUint32(lowWaterMark, 'poolOptions.lowWaterMark');
+    validateUint32(highWaterMark, 'poolOptions.highWaterMark', true);
+    validateUint32(concurrency, 'poolOptions.concurrency', true);
+    if (lowWaterMark > highWaterMark) {
+      throw new ERR_OUT_OF_RANGE('poolOptions.lowWaterMark',
+                                 `<= ${highWaterMark}`, lowWaterMark);
+    }
+    this.lowWaterMark = lowWaterMark;
+    this.highWaterMark = highWaterMark;
+    this.concurrency = concurrency;
+
+    this[kKeyPairs] = [];
+    this[kPending] = 0;
+    this[kClosed] = false;
+    this[kRefill]();
+  }
+
+  get size() {
+    return this[kKeyPairs].length;
+  }
+
+  take() {
+    const keyPair = this[kKeyPairs].length > 0 ? this[kKeyPairs].shift() : null;
+    if (this[kKeyPairs].length < this.lowWaterMark)
+      this[kRefill]();
+    return keyPair;
+  }
+
+  close() {
+    this[kClosed] = true;
+    this[kKeyPairs] = [];
+  }
+
+  // Once started, refilling continues until the pool holds highWaterMark key
+  // pairs, or a key cannot be generated.
+  [kRefill]() {
+    while (!this[kClosed] &&
+           this[kPending] < this.concurrency &&
+           this[kKeyPairs].length + this[kPending] < this.highWaterMark) {
+      this[kPending]++;
+      const wrap = new AsyncWrap(Providers.KEYPAIRGENREQUEST);
+      wrap.ondone = (ex, publicKey, privateKey) => {
+        this[kPending]--;
+        if (this[kClosed])
+          return;
+        if (ex)
+          return this.emit('error', ex);
+        this[kKeyPairs].push({
+          publicKey: wrapKey(publicKey, PublicKeyObject),
+          privateKey: wrapKey(privateKey, PrivateKeyObject)
+        });
+        this[kRefill]();
+      };
+      handleError(this[kImpl](wrap));
+    }
+  }
+}
+
+function createKeyPairPool(type, options, poolOptions) {
+  return new KeyPairPool(type, options, poolOptions);
+}
+
+module.exports = {
+  createKeyPairPool,
+  generateKeyPair,
+  generateKeyPairSync,
+  KeyPairPool
+};
@@ -1,6 +1,7 @@
 'use strict';
 
 const {
+  Array,
   MathMin,
   NumberIsNaN,
 } = primordials;
@@ -13,13 +14,73 @@ const {
   ERR_INVALID_CALLBACK,
   ERR_OUT_OF_RANGE
 } = require('internal/errors').codes;
-const { validateNumber } = require('internal/validators');
+const {
+  validateBoolean,
+  validateNumber,
+  validateObject
+} = require('internal/validators');
 const { isArrayBufferView } = require('internal/util/types');
 const { FastBuffer } = require('internal/buffer');
 
 const kMaxUint32 = 2 ** 32 - 1;
 const kMaxPossibleLength = MathMin(kMaxLength, kMaxUint32);
 
+// Small synchronous requests, such as randomBytes(16) and randomUUID(), are
+// served from a cache of CSPRNG output instead of calling into C++ for each
+// of them. Once half of the cache is used up, a spare one is filled on the
+// threadpool, so that switching to a fresh cache does not normally block.
+// Bytes are zeroed in the cache as soon as they have been handed out.
+const kEntropyCacheSize = 4096;
+const kMaxEntropyCacheRequest = 256;
+
+let entropyCache;
+let entropyCacheOffset = kEntropyCacheSize;
+let spareEntropyCache;
+let spareEntropyCacheReady = false;
+let refillingEntropyCache = false;
+
+function refillSpareEntropyCache() {
+  if (spareEntropyCache === undefined)
+    spareEntropyCache = new FastBuffer(kEntropyCacheSize);
+  refillingEntropyCache = true;
+  const wrap = new AsyncWrap(Providers.RANDOMBYTESREQUEST);
+  wrap.ondone = (ex) => {
+    refillingEntropyCache = false;
+    // On errors, the next refill happens synchronously and throws.
+    spareEntropyCacheReady = !ex;
+  };
+  _randomBytes(spareEntropyCache, 0, kEntropyCacheSize, wrap);
+}
+
+// Fills |target|, a Uint8Array of at most kMaxEntropyCacheRequest bytes, from
+// the entropy cache.
+function fillFromEntropyCache(target) {
+  const size = target.length;
+  if (entropyCacheOffset + size > kEntropyCacheSize) {
+    if (spareEntropyCacheReady) {
+      const cache = entropyCache;
+      entropyCache = spareEntropyCache;
+      spareEntropyCache = cache;
+      spareEntropyCacheReady = false;
+    } else {
+      if (entropyCache === undefined)
+        entropyCache = new FastBuffer(kEntropyCacheSize);
+      handleError(_randomBytes(entropyCache, 0, kEntropyCacheSize));
+    }
+    entropyCacheOffset = 0;
+  }
+
+  const end = entropyCacheOffset + size;
+  entropyCache.copy(target, 0, entropyCacheOffset, end);
+  entropyCache.fill(0, entropyCacheOffset, end);
+  entropyCacheOffset = end;
+
+  if (entropyCacheOffset >= kEntropyCacheSize / 2 &&
+      !spareEntropyCacheReady && !refillingEntropyCache) {
+    refillSpareEntropyCache();
+  }
+}
+
 function assertOffset(offset, elementSize, length) {
   validateNumber(offset, 'offset');
   offset *= elementSize;
@@ -55,7 +116,13 @@ function randomBytes(size, cb) {
 
   const buf = new FastBuffer(size);
 
-  if (!cb) return handleError(_randomBytes(buf, 0, size), buf);
+  if (!cb) {
+    if (size <= kMaxEntropyCacheRequest) {
+      fillFromEntropyCache(buf);
+      return buf;
+    }
+    return handleError(_randomBytes(buf, 0, size), buf);
+  }
 
   const wrap = new AsyncWrap(Providers.RANDOMBYTESREQUEST);
   wrap.ondone = (ex) => {  // Retains buf while request is in flight.
@@ -81,6 +148,11 @@ function randomFillSync(buf, offset = 0, size) {
     size = assertSize(size, elementSize, offset, buf.byteLength);
   }
 
+  if (size <= kMaxEntropyCacheRequest) {
+    fillFromEntropyCache(
+      new FastBuffer(buf.buffer, buf.byteOffset + offset, size));
+    return buf;
+  }
   return handleError(_randomBytes(buf, offset, size), buf);
 }
 
@@ -119,6 +191,42 @@ function randomFill(buf, offset, size, cb) {
   _randomBytes(buf, offset, size, wrap);
 }
 
+let kHexBytes;
+
+function randomUUID(options) {
+  if (options !== undefined)
+    validateObject(options, 'options');
+  const {
+    disableEntropyCache = false
+  } = options || {};
+  validateBoolean(disableEntropyCache, 'options.disableEntropyCache');
+
+  const bytes = new FastBuffer(16);
+  if (disableEntropyCache)
+    handleError(_randomBytes(bytes, 0, 16));
+  else
+    fillFromEntropyCache(bytes);
+
+  // Version 4 and variant 1, see RFC 4122, section 4.4.
+  bytes[6] = (bytes[6] & 0x0f) | 0x40;
+  bytes[8] = (bytes[8] & 0x3f) | 0x80;
+
+  if (kHexBytes === undefined) {
+    kHexBytes = new Array(256);
+    for (let i = 0; i < 256; i++)
+      kHexBytes[i] = (i < 16 ? '0' : '') + i.toString(16);
+  }
+
+  return kHexBytes[bytes[0]] + kHexBytes[bytes[1]] +
+         kHexBytes[bytes[2]] + kHexBytes[bytes[3]] + '-' +
+         kHexBytes[bytes[4]] + kHexBytes[bytes[5]] + '-' +
+         kHexBytes[bytes[6]] + kHexBytes[bytes[7]] + '-' +
+         kHexBytes[bytes[8]] + kHexBytes[bytes[9]] + '-' +
+         kHexBytes[bytes[10]] + kHexBytes[bytes[11]] +
+         kHexBytes[bytes[12]] + kHexBytes[bytes[13]] +
+         kHexBytes[bytes[14]] + kHexBytes[bytes[15]];
+}
+
 function handleError(ex, buf) {
   if (ex) throw ex;
   return buf;
@@ -127,5 +235,6 @@ function handleError(ex, buf) {
 module.exports = {
   randomBytes,
   randomFill,
-  randomFillSync
+  randomFillSync,
+  randomUUID
 };
@@ -1,12 +1,17 @@
 'use strict';
 
 const {
+  ArrayIsArray,
+  MathMin,
   ObjectSetPrototypeOf,
 } = primordials;
 
 const {
+  ERR_CRYPTO_INVALID_DIGEST,
+  ERR_CRYPTO_INVALID_KEY_OBJECT_TYPE,
   ERR_CRYPTO_SIGN_KEY_REQUIRED,
   ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_CALLBACK,
   ERR_INVALID_OPT_VALUE
 } = require('internal/errors').codes;
 const { validateString } = require('internal/validators');
@@ -16,14 +21,17 @@ const {
   kSigEncDER,
   kSigEncP1363,
   signOneShot: _signOneShot,
+  verifyBatch: _verifyBatch,
   verifyOneShot: _verifyOneShot
 } = internalBinding('crypto');
+const { AsyncWrap, Providers } = internalBinding('async_wrap');
 const {
   getDefaultEncoding,
   kHandle,
   getArrayBufferView,
 } = require('internal/crypto/util');
 const {
+  KeyObject,
   preparePrivateKey,
   preparePublicOrPrivateKey
 } = require('internal/crypto/keys');
@@ -222,9 +230,90 @@ function verifyOneShot(algorithm, data, key, signature) {
                         data, algorithm, rsaPadding, pssSaltLength, dsaSigEnc);
 }
 
+// verifyBatch() hands this many items at a time to the threadpool, so that
+// large batches are spread over the threadpool's threads.
+const kVerifyBatchChunkSize = 256;
+
+function getBatchKey(key, name) {
+  const keyObject = key instanceof KeyObject ? key :
+    key !== null && typeof key === 'object' ? key.key : undefined;
+  if (!(keyObject instanceof KeyObject))
+    throw new ERR_INVALID_ARG_TYPE(name, 'KeyObject', key);
+  if (keyObject.type === 'secret') {
+    throw new ERR_CRYPTO_INVALID_KEY_OBJECT_TYPE(keyObject.type,
+                                                 'private or public');
+  }
+  return keyObject[kHandle];
+}
+
+function verifyBatch(items, algorithm, callback) {
+  if (!ArrayIsArray(items))
+    throw new ERR_INVALID_ARG_TYPE('items', 'Array', items);
+  if (algorithm != null)
+    validateString(algorithm, 'algorithm');
+  if (typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK(callback);
+
+  const count = items.length;
+  const results = new Uint8Array(count);
+  const chunks = [];
+  for (let start = 0; start < count; start += kVerifyBatchChunkSize) {
+    const end = MathMin(start + kVerifyBatchChunkSize, count);
+    const keys = [];
+    const signatures = [];
+    const data = [];
+    const params = [];
+    for (let i = start; i < end; i++) {
+      const item = items[i];
+      if (item === null || typeof item !== 'object')
+        throw new ERR_INVALID_ARG_TYPE(`items[${i}]`, 'Object', item);
+      const { key } = item;
+      keys.push(getBatchKey(key, `items[${i}].key`));
+      if (!isArrayBufferView(item.signature)) {
+        throw new ERR_INVALID_ARG_TYPE(`items[${i}].signature`,
+                                       ['Buffer', 'TypedArray', 'DataView'],
+                                       item.signature);
+      }
+      signatures.push(item.signature);
+      if (!isArrayBufferView(item.data)) {
+        throw new ERR_INVALID_ARG_TYPE(`items[${i}].data`,
+                                       ['Buffer', 'TypedArray', 'DataView'],
+                                       item.data);
+      }
+      data.push(item.data);
+      params.push(getPadding(key), getSaltLength(key),
+                  getDSASignatureEncoding(key));
+    }
+    chunks.push({ keys, signatures, data, params, start, end });
+  }
+
+  if (count === 0) {
+    process.nextTick(callback, null, results);
+    return;
+  }
+
+  let pending = chunks.length;
+  for (const chunk of chunks) {
+    const wrap = new AsyncWrap(Providers.VERIFYBATCHREQUEST);
+    wrap.chunk = chunk;  // Retains the inputs while the request is in flight.
+    wrap.ondone = () => {
+      wrap.chunk = null;
+      if (--pending === 0)
+        callback.call(wrap, null, results);
+    };
+    const ok = _verifyBatch(algorithm, chunk.keys, chunk.signatures,
+                            chunk.data, chunk.params,
+                            results.subarray(chunk.start, chunk.end), wrap);
+    // Only the first chunk can fail, since all of them use the same algorithm.
+    if (ok === undefined)
+      throw new ERR_CRYPTO_INVALID_DIGEST(algorithm);
+  }
+}
+
 module.exports = {
   Sign,
   signOneShot,
   Verify,
+  verifyBatch,
   verifyOneShot
 };
@@ -11,6 +11,7 @@ const {
   setEngine: _setEngine,
   timingSafeEqual: _timingSafeEqual
 } = internalBinding('crypto');
+const { AsyncWrap, Providers } = internalBinding('async_wrap');
 
 const {
   ENGINE_METHOD_ALL
@@ -20,11 +21,12 @@ const {
   hideStackFrames,
   codes: {
     ERR_CRYPTO_ENGINE_UNKNOWN,
+    ERR_CRYPTO_INVALID_STATE,
     ERR_CRYPTO_TIMING_SAFE_EQUAL_LENGTH,
     ERR_INVALID_ARG_TYPE,
   }
 } = require('internal/errors');
-const { validateString } = require('internal/validators');
+const { validateBoolean, validateString } = require('internal/validators');
 const { Buffer } = require('buffer');
 const {
   cachedResult,
@@ -35,6 +37,11 @@ const {
 } = require('internal/util/types');
 
 const kHandle = Symbol('kHandle');
+const kAsyncUpdates = Symbol('kAsyncUpdates');
+const kAsyncUpdatePending = Symbol('kAsyncUpdatePending');
+
+// Chunks smaller than this are not worth a trip to the threadpool.
+const kAsyncUpdateThreshold = 16 * 1024;
 
 var defaultEncoding = 'buffer';
 
@@ -107,13 +114,54 @@ const getArrayBufferView = hideStackFrames((buffer, name, encoding) => {
   return buffer;
 });
 
+function getAsyncUpdatesOption(options) {
+  if (options == null || options.asyncUpdates === undefined)
+    return false;
+  validateBoolean(options.asyncUpdates, 'options.asyncUpdates');
+  return options.asyncUpdates;
+}
+
+// Used by the _transform() methods of Hash, Hmac and Cipher objects that were
+// created with `asyncUpdates: true`. Feeds `chunk` to the context on the
+// threadpool, pushes the output, if any, and then calls `callback`. Returns
+// false if `chunk` has to be processed synchronously instead. Since streams
+// only pass one chunk at a time to _transform(), updates of one context are
+// serialized.
+function scheduleAsyncUpdate(self, chunk, callback) {
+  if (!isArrayBufferView(chunk) || chunk.byteLength < kAsyncUpdateThreshold)
+    return false;
+  const wrap = new AsyncWrap(Providers.CRYPTOUPDATEREQUEST);
+  wrap.chunk = chunk;  // Retains chunk while the request is in flight.
+  wrap.ondone = (err, output) => {
+    self[kAsyncUpdatePending] = false;
+    if (output !== undefined)
+      self.push(output);
+    callback(err);
+  };
+  if (!self[kHandle].updateAsync(chunk, wrap))
+    return false;
+  self[kAsyncUpdatePending] = true;
+  return true;
+}
+
+// The context must not be used by the main thread while an update is running
+// on the threadpool.
+function checkNoAsyncUpdate(self, operation) {
+  if (self[kAsyncUpdatePending] === true)
+    throw new ERR_CRYPTO_INVALID_STATE(operation);
+}
+
 module.exports = {
+  checkNoAsyncUpdate,
   getArrayBufferView,
+  getAsyncUpdatesOption,
   getCiphers,
   getCurves,
   getDefaultEncoding,
   getHashes,
+  kAsyncUpdates,
   kHandle,
+  scheduleAsyncUpdate,
   setDefaultEncoding,
   setEngine,
   timingSafeEqual,
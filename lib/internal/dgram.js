@@ -5,7 +5,10 @@ const {
 } = primordials;
 
 const { codes } = require('internal/errors');
-const { UDP } = internalBinding('udp_wrap');
+const {
+  constants: { UV_UDP_RECVMMSG },
+  UDP,
+} = internalBinding('udp_wrap');
 const { guessHandleType } = internalBinding('util');
 const { isInt32 } = require('internal/validators');
 const { UV_EINVAL } = internalBinding('uv');
@@ -23,7 +26,7 @@ function lookup6(lookup, address, callback) {
   return lookup(address || '::1', 6, callback);
 }
 
-function newHandle(type, lookup) {
+function newHandle(type, lookup, recvBatch) {
   if (lookup === undefined) {
     if (dns === undefined) {
       dns = require('dns');
@@ -34,20 +37,23 @@ function newHandle(type, lookup) {
     throw new ERR_INVALID_ARG_TYPE('lookup', 'Function', lookup);
   }
 
+  const flags = recvBatch ? UV_UDP_RECVMMSG : 0;
+
   if (type === 'udp4') {
-    const handle = new UDP();
+    const handle = new UDP(flags);
 
     handle.lookup = lookup4.bind(handle, lookup);
     return handle;
   }
 
   if (type === 'udp6') {
-    const handle = new UDP();
+    const handle = new UDP(flags);
 
     handle.lookup = lookup6.bind(handle, lookup);
     handle.bind = handle.bind6;
     handle.connect = handle.connect6;
     handle.send = handle.send6;
+    handle.sendBatch = handle.sendBatch6;
     return handle;
   }
 
@@ -0,0 +1,171 @@
+'use strict';
+
+const {
+  Array,
+  MathMin,
+  SafeMap,
+} = primordials;
+
+const {
+  getaddrinfo,
+  lookupCacheConfigure,
+  lookupCacheGet,
+  lookupCacheSet,
+  lookupCacheClear,
+  kLookupCacheDisabled,
+  kLookupCacheMiss,
+  kLookupCacheStale,
+  GetAddrInfoReqWrap,
+  QueryReqWrap,
+} = internalBinding('cares_wrap');
+const { UV_EAI_NODATA, UV_EAI_NONAME } = internalBinding('uv');
+const { getDefaultResolver } = require('internal/dns/utils');
+const {
+  validateObject,
+  validateUint32,
+} = require('internal/validators');
+
+// The cache itself lives in cares_wrap and is shared by all threads. This
+// file decides how entries are filled: /etc/hosts entries are returned as
+// they are, since they have no TTL; other names are resolved with the default
+// Resolver so that the TTLs of the A and AAAA records are known. Names that
+// the DNS servers do not answer for fall back to getaddrinfo(), and only its
+// "not found" answers are cached.
+
+// Callbacks of the lookups that are waiting for the same name, keyed by
+// family and name.
+const pending = new SafeMap();
+
+function setLookupCache(options) {
+  if (options === false) {
+    lookupCacheConfigure(0, 0, 0, 0);
+    lookupCacheClear();
+    return;
+  }
+  if (options === undefined)
+    options = {};
+  validateObject(options, 'options');
+  const {
+    maxTtl = 300,
+    negativeTtl = 30,
+    staleTtl = 30,
+    maxEntries = 1000,
+  } = options;
+  validateUint32(maxTtl, 'options.maxTtl');
+  validateUint32(negativeTtl, 'options.negativeTtl');
+  validateUint32(staleTtl, 'options.staleTtl');
+  validateUint32(maxEntries, 'options.maxEntries', true);
+  lookupCacheConfigure(maxTtl * 1000, negativeTtl * 1000, staleTtl * 1000,
+                       maxEntries);
+}
+
+function clearLookupCache() {
+  lookupCacheClear();
+}
+
+// Calls back with the addresses of the A and AAAA records, IPv4 first, and
+// the lowest of their TTLs. Errors are ignored as long as one of the queries
+// returns addresses.
+function query(hostname, family, callback) {
+  const handle = getDefaultResolver()._handle;
+  const bindings = family === 4 ? ['queryA'] :
+    family === 6 ? ['queryAaaa'] : ['queryA', 'queryAaaa'];
+  const results = new Array(bindings.length);
+  let remaining = bindings.length;
+
+  function done() {
+    let addresses = [];
+    let ttl = Infinity;
+    for (const result of results) {
+      if (result === undefined)
+        continue;
+      addresses = addresses.concat(result.addresses);
+      for (const recordTtl of result.ttls)
+        ttl = MathMin(ttl, recordTtl);
+    }
+    callback(addresses, addresses.length > 0 ? ttl : 0);
+  }
+
+  bindings.forEach((bindingName, i) => {
+    const req = new QueryReqWrap();
+    req.oncomplete = (err, addresses, ttls) => {
+      if (!err)
+        results[i] = { addresses, ttls };
+      if (--remaining === 0)
+        done();
+    };
+    if (handle[bindingName](req, hostname) !== 0 && --remaining === 0)
+      process.nextTick(done);
+  });
+}
+
+function resolve(hostname, family, callback) {
+  const hosts = getDefaultResolver()._handle.getHostByNameFile(hostname,
+                                                               family);
+  if (hosts.length > 0) {
+    process.nextTick(callback, 0, hosts);
+    return;
+  }
+
+  query(hostname, family, (addresses, ttl) => {
+    if (addresses.length > 0) {
+      lookupCacheSet(hostname, family, addresses, ttl);
+      callback(0, addresses);
+      return;
+    }
+
+    const req = new GetAddrInfoReqWrap();
+    req.oncomplete = (err, addresses) => {
+      if (err === UV_EAI_NONAME || err === UV_EAI_NODATA)
+        lookupCacheSet(hostname, family, err, 0);
+      callback(err, addresses);
+    };
+    const err = getaddrinfo(req, hostname, family, 0, false);
+    if (err)
+      callback(err);
+  });
+}
+
+function refresh(hostname, family, key) {
+  const callbacks = [];
+  pending.set(key, callbacks);
+  resolve(hostname, family, (err, addresses) => {
+    pending.delete(key);
+    for (const callback of callbacks)
+      callback(err, err ? undefined : addresses.slice());
+  });
+  return callbacks;
+}
+
+// Looks up `hostname`, which must already be in ASCII form, in the cache.
+// Returns false when the cache is disabled. Otherwise, `callback` is called
+// asynchronously with an error code and the list of addresses.
+function lookupCached(hostname, family, callback) {
+  hostname = hostname.toLowerCase();
+  const result = [];
+  const status = lookupCacheGet(hostname, family, result);
+  if (status === kLookupCacheDisabled)
+    return false;
+
+  const key = `${family}:${hostname}`;
+  if (status === kLookupCacheMiss) {
+    const callbacks = pending.get(key) || refresh(hostname, family, key);
+    callbacks.push(callback);
+    return true;
+  }
+
+  if (status === kLookupCacheStale && !pending.has(key))
+    refresh(hostname, family, key);
+  const [cached] = result;
+  if (typeof cached === 'number')
+    process.nextTick(callback, cached);
+  else
+    process.nextTick(callback, 0, cached);
+  return true;
+}
+
+module.exports = {
+  clearLookupCache,
+  lookupCached,
+  setLookupCache,
+};
@@ -12,6 +12,7 @@ const {
   validateHints,
   emitInvalidHostnameWarning,
 } = require('internal/dns/utils');
+const { lookupCached } = require('internal/dns/lookup_cache');
 const { codes, dnsException } = require('internal/errors');
 const { toASCII } = require('internal/idna');
 const { isIP, isLegalPort } = require('internal/net');
@@ -94,6 +95,11 @@ function createLookupPromise(family, hostname, all, hints, verbatim) {
     req.resolve = resolve;
     req.reject = reject;
 
+    if (hints === 0 && !verbatim &&
+        lookupCached(toASCII(hostname), family, req.oncomplete.bind(req))) {
+      return;
+    }
+
     const err = getaddrinfo(req, toASCII(hostname), family, hints, verbatim);
 
     if (err) {
@@ -1134,6 +1134,7 @@ E('ERR_INVALID_URL_SCHEME',
       `of scheme ${expected[0]}`;
     return `The URL must be ${res}`;
   }, TypeError);
+E('ERR_INVALID_WEBSOCKET_FRAME', 'Invalid WebSocket frame: %s', Error);
 E('ERR_IPC_CHANNEL_CLOSED', 'Channel closed', Error);
 E('ERR_IPC_DISCONNECTED', 'IPC channel is already disconnected', Error);
 E('ERR_IPC_ONE_PIPE', 'Child process can have only one IPC pipe', Error);
@@ -1368,6 +1369,7 @@ E('ERR_WORKER_PATH',
   'The worker script filename must be an absolute path or a relative ' +
   'path starting with \'./\' or \'../\'. Received "%s"',
   TypeError);
+E('ERR_WORKER_POOL_CLOSED', 'The WorkerPool has been closed', Error);
 E('ERR_WORKER_UNSERIALIZABLE_ERROR',
   'Serializing an uncaught exception failed', Error);
 E('ERR_WORKER_UNSUPPORTED_EXTENSION',
@@ -1,30 +1,72 @@
 'use strict';
 
 const {
+  MathMin,
   ReflectApply,
 } = primordials;
 
+// Number of free() calls after which an adaptive FreeList lets its peak decay
+// towards the number of objects that are currently in use.
+const kDecayInterval = 1000;
+
 class FreeList {
-  constructor(name, max, ctor) {
+  // If `adaptive` is true, the list only keeps as many objects as are needed
+  // to go back to the recent peak number of objects in use at the same time,
+  // and never more than `max`.
+  constructor(name, max, ctor, adaptive = false) {
     this.name = name;
     this.ctor = ctor;
     this.max = max;
     this.list = [];
+    this.adaptive = adaptive;
+    this.inUse = 0;
+    this.peak = 0;
+    this.hits = 0;
+    this.misses = 0;
+    this.discarded = 0;
+    this.frees = 0;
   }
 
   alloc() {
-    return this.list.length > 0 ?
-      this.list.pop() :
-      ReflectApply(this.ctor, this, arguments);
+    if (this.adaptive && ++this.inUse > this.peak)
+      this.peak = this.inUse;
+    if (this.list.length > 0) {
+      this.hits++;
+      return this.list.pop();
+    }
+    this.misses++;
+    return ReflectApply(this.ctor, this, arguments);
   }
 
   free(obj) {
-    if (this.list.length < this.max) {
+    let max = this.max;
+    if (this.adaptive) {
+      if (this.inUse > 0)
+        this.inUse--;
+      if (++this.frees % kDecayInterval === 0)
+        this.peak -= (this.peak - this.inUse) >>> 1;
+      max = MathMin(max, this.peak - this.inUse);
+    }
+    if (this.list.length < max) {
       this.list.push(obj);
       return true;
     }
+    this.discarded++;
     return false;
   }
+
+  stats() {
+    return {
+      name: this.name,
+      size: this.list.length,
+      max: this.max,
+      inUse: this.inUse,
+      peak: this.peak,
+      hits: this.hits,
+      misses: this.misses,
+      discarded: this.discarded,
+    };
+  }
 }
 
 module.exports = FreeList;
@@ -0,0 +1,44 @@
+'use strict';
+
+const {
+  ObjectSetPrototypeOf,
+  Symbol,
+} = primordials;
+
+const { BufferedWriter } = internalBinding('fs');
+const { Writable } = require('stream');
+const { uvException } = require('internal/errors');
+
+// Maximum number of bytes that wait for the writer thread before write()
+// blocks until it caught up.
+const kCapacity = 16 * 1024 * 1024;
+
+const kWriter = Symbol('kWriter');
+
+// Used for stdout and stderr with --buffered-stdio. The data is copied and
+// written to the fd by a thread, so that the event loop does not wait for a
+// slow file or pipe. Everything is written out before the process exits.
+function BufferedWriteStream(fd) {
+  Writable.call(this, { autoDestroy: true });
+
+  this.fd = fd;
+  this.readable = false;
+  this[kWriter] = new BufferedWriter(fd, kCapacity);
+  // Data that is written in later 'exit' listeners is written synchronously.
+  process.on('exit', () => this[kWriter].close());
+}
+
+ObjectSetPrototypeOf(BufferedWriteStream.prototype, Writable.prototype);
+ObjectSetPrototypeOf(BufferedWriteStream, Writable);
+
+BufferedWriteStream.prototype._write = function(chunk, encoding, cb) {
+  const err = this[kWriter].write(chunk);
+  cb(err === 0 ? null : uvException({ errno: err, syscall: 'write' }));
+};
+
+BufferedWriteStream.prototype._destroy = function(err, cb) {
+  this[kWriter].close();
+  cb(err);
+};
+
+module.exports = BufferedWriteStream;
@@ -1,6 +1,7 @@
 'use strict';
 
 const {
+  NumberIsSafeInteger,
   ObjectDefineProperty,
   Symbol,
   SymbolAsyncIterator,
@@ -13,7 +14,8 @@ const {
   codes: {
     ERR_DIR_CLOSED,
     ERR_INVALID_CALLBACK,
-    ERR_MISSING_ARGS
+    ERR_MISSING_ARGS,
+    ERR_OUT_OF_RANGE
   }
 } = require('internal/errors');
 
@@ -26,6 +28,8 @@ const {
   handleErrorFromBinding
 } = require('internal/fs/utils');
 const {
+  validateBoolean,
+  validateNumber,
   validateUint32
 } = require('internal/validators');
 
@@ -35,6 +39,7 @@ const kDirBufferedEntries = Symbol('kDirBufferedEntries');
 const kDirClosed = Symbol('kDirClosed');
 const kDirOptions = Symbol('kDirOptions');
 const kDirReadImpl = Symbol('kDirReadImpl');
+const kDirReadFromHandle = Symbol('kDirReadFromHandle');
 const kDirReadPromisified = Symbol('kDirReadPromisified');
 const kDirClosePromisified = Symbol('kDirClosePromisified');
 
@@ -55,6 +60,18 @@ class Dir {
 
     validateUint32(this[kDirOptions].bufferSize, 'options.bufferSize', true);
 
+    const { recursive = false, maxDepth = Infinity } = this[kDirOptions];
+    validateBoolean(recursive, 'options.recursive');
+    validateNumber(maxDepth, 'options.maxDepth');
+    if (maxDepth < 0 ||
+        (maxDepth !== Infinity && !NumberIsSafeInteger(maxDepth))) {
+      throw new ERR_OUT_OF_RANGE('options.maxDepth',
+                                 'a non-negative integer or Infinity',
+                                 maxDepth);
+    }
+    this[kDirOptions].recursive = recursive;
+    this[kDirOptions].maxDepth = maxDepth;
+
     this[kDirReadPromisified] =
         internalUtil.promisify(this[kDirReadImpl]).bind(this, false);
     this[kDirClosePromisified] = internalUtil.promisify(this.close).bind(this);
@@ -98,11 +115,24 @@ class Dir {
       getDirent(this[kDirPath], result[0], result[1], callback);
     };
 
-    this[kDirHandle].read(
-      this[kDirOptions].encoding,
-      this[kDirOptions].bufferSize,
-      req
-    );
+    this[kDirReadFromHandle](req);
+  }
+
+  [kDirReadFromHandle](req, ctx) {
+    const { encoding, bufferSize, recursive, maxDepth } = this[kDirOptions];
+    if (recursive) {
+      // The whole subtree is walked on the threadpool, subdirectories are
+      // never opened from JS.
+      return this[kDirHandle].walk(
+        pathModule.toNamespacedPath(this[kDirPath]),
+        encoding,
+        bufferSize,
+        maxDepth === Infinity ? -1 : maxDepth,
+        req,
+        ctx
+      );
+    }
+    return this[kDirHandle].read(encoding, bufferSize, req, ctx);
   }
 
   readSync(options) {
@@ -116,12 +146,7 @@ class Dir {
     }
 
     const ctx = { path: this[kDirPath] };
-    const result = this[kDirHandle].read(
-      this[kDirOptions].encoding,
-      this[kDirOptions].bufferSize,
-      undefined,
-      ctx
-    );
+    const result = this[kDirReadFromHandle](undefined, ctx);
     handleErrorFromBinding(ctx);
 
     if (result === null) {
@@ -4,10 +4,19 @@
 // See https://github.com/libuv/libuv/pull/1501.
 const kIoMaxLength = 2 ** 31 - 1;
 
+// Maximum number of bytes filehandle.pipeTo() hands to the kernel per request,
+// so that copying large files does not hold on to a threadpool thread for too
+// long at a time.
+const kPipeToChunkLength = 64 * 1024 * 1024;
+
+// Default number of bytes filehandle.readLines() reads at a time.
+const kReadLinesChunkSize = 1024 * 1024;
+
 const {
   MathMax,
   MathMin,
   NumberIsSafeInteger,
+  PromiseReject,
   Symbol,
 } = primordials;
 
@@ -19,8 +28,10 @@ const {
   S_IFREG
 } = internalBinding('constants').fs;
 const binding = internalBinding('fs');
-const { Buffer } = require('buffer');
+const { Buffer, kMaxLength } = require('buffer');
+const { splitLines } = internalBinding('buffer');
 const {
+  ERR_FEATURE_UNAVAILABLE_ON_PLATFORM,
   ERR_FS_FILE_TOO_LARGE,
   ERR_INVALID_ARG_TYPE,
   ERR_INVALID_ARG_VALUE,
@@ -35,6 +46,7 @@ const {
   getStatsFromBinding,
   getValidatedPath,
   getValidMode,
+  handleErrorFromBinding,
   nullCheck,
   preprocessSymlinkDestination,
   stringToFlags,
@@ -59,14 +71,27 @@ const { promisify } = require('internal/util');
 
 const kHandle = Symbol('kHandle');
 const kFd = Symbol('kFd');
+const kMappedBy = Symbol('kMappedBy');
+const kSyncRunning = Symbol('kSyncRunning');
+const kSyncNext = Symbol('kSyncNext');
 const { kUsePromises } = binding;
 
+const kMapAdvice = {
+  __proto__: null,
+  normal: binding.kMapAdviceNormal,
+  sequential: binding.kMapAdviceSequential,
+  random: binding.kMapAdviceRandom,
+  willneed: binding.kMapAdviceWillNeed,
+};
+
 const getDirectoryEntriesPromise = promisify(getDirents);
 
 class FileHandle {
   constructor(filehandle) {
     this[kHandle] = filehandle;
     this[kFd] = filehandle.fd;
+    this[kSyncRunning] = undefined;
+    this[kSyncNext] = undefined;
   }
 
   getAsyncId() {
@@ -97,14 +122,34 @@ class FileHandle {
     return fsync(this);
   }
 
+  syncBatch() {
+    return syncBatch(this);
+  }
+
+  map(options) {
+    return map(this, options);
+  }
+
+  pipeTo(destination, options) {
+    return pipeTo(this, destination, options);
+  }
+
   read(buffer, offset, length, position) {
     return read(this, buffer, offset, length, position);
   }
 
+  readv(buffers, position) {
+    return readv(this, buffers, position);
+  }
+
   readFile(options) {
     return readFile(this, options);
   }
 
+  readLines(options) {
+    return readLines(this, options);
+  }
+
   stat(options) {
     return fstat(this, options);
   }
@@ -113,6 +158,10 @@ class FileHandle {
     return ftruncate(this, len);
   }
 
+  unmap(buffer) {
+    return unmap(this, buffer);
+  }
+
   utimes(atime, mtime) {
     return futimes(this, atime, mtime);
   }
@@ -222,6 +271,90 @@ async function open(path, flags, mode) {
                                  flagsNumber, mode, kUsePromises));
 }
 
+async function map(handle, options) {
+  validateFileHandle(handle);
+  if (binding.mapFile === undefined)
+    throw new ERR_FEATURE_UNAVAILABLE_ON_PLATFORM('filehandle.map()');
+  options = getOptions(options, {});
+  const { offset = 0, advice = 'normal' } = options;
+  let { length } = options;
+  validateInteger(offset, 'options.offset', 0);
+  const adviceValue = kMapAdvice[advice];
+  if (adviceValue === undefined) {
+    throw new ERR_INVALID_ARG_VALUE(
+      'options.advice', advice,
+      "must be one of 'normal', 'sequential', 'random' or 'willneed'");
+  }
+
+  // Accessing a page past the end of the file raises SIGBUS.
+  const stats = await binding.fstat(handle.fd, false, kUsePromises);
+  const available = MathMax(0, stats[8/* size */] - offset);
+  if (length === undefined)
+    length = available;
+  validateInteger(length, 'options.length', 0,
+                  MathMin(available, kMaxLength));
+
+  let buffer;
+  if (length === 0) {
+    // mmap() refuses empty mappings.
+    buffer = Buffer.alloc(0);
+  } else {
+    const ctx = {};
+    buffer = binding.mapFile(handle.fd, offset, length, adviceValue,
+                             undefined, ctx);
+    handleErrorFromBinding(ctx);
+  }
+  buffer.buffer[kMappedBy] = handle;
+  return buffer;
+}
+
+async function unmap(handle, buffer) {
+  validateFileHandle(handle);
+  if (!isArrayBufferView(buffer) || buffer.buffer[kMappedBy] !== handle) {
+    throw new ERR_INVALID_ARG_VALUE(
+      'buffer', buffer, 'must have been returned by filehandle.map()');
+  }
+  buffer.buffer[kMappedBy] = undefined;
+  binding.unmapFile(buffer.buffer);
+}
+
+async function pipeTo(handle, destination, options) {
+  validateFileHandle(handle);
+  const { Socket } = require('net');
+  if (!(destination instanceof FileHandle) &&
+      !(destination instanceof Socket)) {
+    throw new ERR_INVALID_ARG_TYPE('destination', ['FileHandle', 'net.Socket'],
+                                   destination);
+  }
+  const { offset = 0, length = Infinity } = getOptions(options, {});
+  validateInteger(offset, 'options.offset', 0);
+  if (length !== Infinity)
+    validateInteger(length, 'options.length', 0);
+
+  if (destination instanceof Socket) {
+    const { sendFile } = require('internal/stream_base_commons');
+    return sendFile(destination,
+                    handle.fd,
+                    offset,
+                    length === Infinity ? -1 : length);
+  }
+
+  // The data is copied inside the kernel, without going through JS Buffers.
+  let bytesCopied = 0;
+  while (bytesCopied < length) {
+    const chunkLength = MathMin(length - bytesCopied, kPipeToChunkLength);
+    const bytes = await binding.copyFileRange(destination.fd,
+                                              handle.fd,
+                                              offset + bytesCopied,
+                                              chunkLength,
+                                              kUsePromises);
+    if (bytes === 0)
+      break;
+    bytesCopied += bytes;
+  }
+  return bytesCopied;
+}
+
 async function read(handle, buffer, offset, length, position) {
   validateFileHandle(handle);
   validateBuffer(buffer);
@@ -253,6 +386,58 @@ async function read(handle, buffer, offset, length, position) {
   return { bytesRead, buffer };
 }
 
+// Reads large blocks on the threadpool, and splits each of them into lines in
+// a single call into C++. Bytes after the last newline of a block are kept
+// until the rest of their line has been read.
+async function* readLines(handle, options) {
+  validateFileHandle(handle);
+  options = getOptions(options, {});
+  const { highWaterMark = kReadLinesChunkSize } = options;
+  validateInteger(highWaterMark, 'options.highWaterMark', 1, kIoMaxLength);
+
+  let pending = [];
+  for (;;) {
+    const buffer = Buffer.allocUnsafe(highWaterMark);
+    const bytesRead = (await binding.read(handle.fd, buffer, 0, highWaterMark,
+                                          -1, kUsePromises)) || 0;
+    if (bytesRead === 0)
+      break;
+    let chunk = buffer.slice(0, bytesRead);
+    const last = chunk.lastIndexOf(10 /* '\n' */);
+    if (last === -1) {
+      pending.push(chunk);
+      continue;
+    }
+    if (pending.length > 0) {
+      pending.push(chunk);
+      chunk = Buffer.concat(pending);
+      pending = [];
+    }
+    const end = chunk.length - (bytesRead - last - 1);
+    if (end < chunk.length)
+      pending.push(chunk.slice(end));
+    yield splitLines(chunk, 0, end);
+  }
+  if (pending.length > 0) {
+    const rest = Buffer.concat(pending);
+    const end = rest[rest.length - 1] === 13 /* '\r' */ ?
+      rest.length - 1 : rest.length;
+    yield [rest.utf8Slice(0, end)];
+  }
+}
+
+async function readv(handle, buffers, position) {
+  validateFileHandle(handle);
+  validateBufferArray(buffers);
+
+  if (typeof position !== 'number')
+    position = null;
+
+  const bytesRead = (await binding.readBuffers(handle.fd, buffers, position,
+                                               kUsePromises)) || 0;
+  return { bytesRead, buffers };
+}
+
 async function write(handle, buffer, offset, length, position) {
   validateFileHandle(handle);
 
@@ -335,6 +520,38 @@ async function fsync(handle) {
   return binding.fsync(handle.fd, kUsePromises);
 }
 
+// Group commit: all callers that arrive while a sync is running share the one
+// that starts after it, because the running sync may have been issued before
+// their writes completed.
+function syncBatch(handle) {
+  try {
+    validateFileHandle(handle);
+  } catch (err) {
+    return PromiseReject(err);
+  }
+  if (handle[kSyncNext] !== undefined)
+    return handle[kSyncNext];
+  if (handle[kSyncRunning] === undefined)
+    return startSyncBatch(handle);
+
+  const start = () => {
+    handle[kSyncNext] = undefined;
+    return startSyncBatch(handle);
+  };
+  return handle[kSyncNext] = handle[kSyncRunning].then(start, start);
+}
+
+function startSyncBatch(handle) {
+  const running = binding.fdatasync(handle.fd, kUsePromises);
+  const done = () => {
+    if (handle[kSyncRunning] === running)
+      handle[kSyncRunning] = undefined;
+  };
+  handle[kSyncRunning] = running;
+  running.then(done, done);
+  return running;
+}
+
 async function mkdir(path, options) {
   if (typeof options === 'number' || typeof options === 'string') {
     options = { mode: options };
@@ -551,5 +768,7 @@ module.exports = {
     readFile,
   },
 
-  FileHandle
+  FileHandle,
+  kFd,
+  kHandle
 };
@@ -14,6 +14,8 @@ const { FSReqCallback, close, read } = internalBinding('fs');
 // used else wise.
 // Use up to 512kb per read otherwise to partition reading big files to prevent
 // blocking other threads in case the available threads are all in use.
+// Regular files up to kReadFileBufferLength are read by a single binding call
+// instead, see kReadFileFastPathMaxLength in src/node_file.cc.
 const kReadFileUnknownBufferLength = 64 * 1024;
 const kReadFileBufferLength = 512 * 1024;
 
@@ -16,7 +16,10 @@ const {
   ERR_STREAM_DESTROYED
 } = require('internal/errors').codes;
 const internalUtil = require('internal/util');
-const { validateNumber } = require('internal/validators');
+const {
+  validateBoolean,
+  validateNumber
+} = require('internal/validators');
 const fs = require('fs');
 const { Buffer } = require('buffer');
 const {
@@ -27,9 +30,12 @@ const { Readable, Writable } = require('stream');
 const { toPathIfFileURL } = require('internal/url');
 const kIoDone = Symbol('kIoDone');
 const kIsPerformingIO = Symbol('kIsPerformingIO');
+const kLastReadFilled = Symbol('kLastReadFilled');
 
 const kMinPoolSpace = 128;
 const kFs = Symbol('kFs');
+const kCoalesceWrites = Symbol('kCoalesceWrites');
+const kCoalescing = Symbol('kCoalescing');
 
 let pool;
 // It can happen that we expect to read a large chunk of data, and reserve
@@ -109,6 +115,7 @@ function ReadStream(path, options) {
   this.bytesRead = 0;
   this.closed = false;
   this[kIsPerformingIO] = false;
+  this[kLastReadFilled] = false;
 
   if (this.start !== undefined) {
     checkPosition(this.start, 'start');
@@ -171,6 +178,24 @@ function _openReadFs(stream) {
   });
 }
 
+// Now that we know how much data a read actually put into a pool
+// reservation, re-wind the pool's 'used' field if we can, and otherwise allow
+// the remainder of our reservation to be used as a new pool later.
+function releasePoolReservation(thisPool, start, reserved, filled) {
+  if (start + reserved === thisPool.used && thisPool === pool) {
+    const newUsed = thisPool.used + filled - reserved;
+    thisPool.used = roundUpToMultipleOf8(newUsed);
+  } else {
+    // Round down to the next lowest multiple of 8 to ensure the new pool
+    // fragment start and end positions are aligned to an 8 byte boundary.
+    const alignedEnd = (start + reserved) & ~7;
+    const alignedStart = roundUpToMultipleOf8(start + filled);
+    if (alignedEnd - alignedStart >= kMinPoolSpace) {
+      poolFragments.push(thisPool.slice(alignedStart, alignedEnd));
+    }
+  }
+}
+
 ReadStream.prototype._read = function(n) {
   if (typeof this.fd !== 'number') {
     return this.once('open', function() {
@@ -185,68 +210,87 @@ ReadStream.prototype._read = function(n) {
     allocNewPool(this.readableHighWaterMark);
   }
 
+  if (this.pos !== undefined)
+    n = MathMin(this.end - this.pos + 1, n);
+  else
+    n = MathMin(this.end - this.bytesRead + 1, n);
+
+  // Already read everything we were supposed to read!
+  // treat as EOF.
+  if (n <= 0)
+    return this.push(null);
+
   // Grab another reference to the pool in the case that while we're
   // in the thread pool another read() finishes up the pool, and
   // allocates a new one.
   const thisPool = pool;
-  let toRead = MathMin(pool.length - pool.used, n);
+  const toRead = MathMin(pool.length - pool.used, n);
   const start = pool.used;
 
-  if (this.pos !== undefined)
-    toRead = MathMin(this.end - this.pos + 1, toRead);
-  else
-    toRead = MathMin(this.end - this.bytesRead + 1, toRead);
+  pool.used = roundUpToMultipleOf8(pool.used + toRead);
 
-  // Already read everything we were supposed to read!
-  // treat as EOF.
-  if (toRead <= 0)
-    return this.push(null);
+  // If what is left of the pool can't hold the whole read, continue into a
+  // fresh pool and fill both slabs with a single readv() request instead of
+  // coming back for the rest. A short previous read usually means we are at
+  // the end of the file, so don't reserve a second slab in that case.
+  let spillPool = null;
+  let spillRead = 0;
+  if (toRead < n &&
+      this[kLastReadFilled] &&
+      typeof this[kFs].readv === 'function') {
+    allocNewPool(this.readableHighWaterMark);
+    spillPool = pool;
+    spillRead = MathMin(pool.length, n - toRead);
+    pool.used = roundUpToMultipleOf8(spillRead);
+  }
+
+  const onread = (er, bytesRead) => {
+    this[kIsPerformingIO] = false;
+    // Tell ._destroy() that it's safe to close the fd now.
+    if (this.destroyed) return this.emit(kIoDone, er);
+
+    if (er) {
+      if (this.autoClose) {
+        this.destroy();
+      }
+      this.emit('error', er);
+      return;
+    }
+
+    this[kLastReadFilled] = bytesRead === toRead + spillRead;
+
+    const firstRead = MathMin(bytesRead, toRead);
+    releasePoolReservation(thisPool, start, toRead, firstRead);
+    if (spillPool !== null) {
+      releasePoolReservation(spillPool, 0, spillRead, bytesRead - firstRead);
+    }
+
+    if (bytesRead === 0) {
+      this.push(null);
+      return;
+    }
+
+    this.bytesRead += bytesRead;
+    this.push(thisPool.slice(start, start + firstRead));
+    if (bytesRead > toRead)
+      this.push(spillPool.slice(0, bytesRead - toRead));
+  };
 
   // the actual read.
   this[kIsPerformingIO] = true;
-  this[kFs].read(
-    this.fd, pool, pool.used, toRead, this.pos, (er, bytesRead) => {
-      this[kIsPerformingIO] = false;
-      // Tell ._destroy() that it's safe to close the fd now.
-      if (this.destroyed) return this.emit(kIoDone, er);
-
-      if (er) {
-        if (this.autoClose) {
-          this.destroy();
-        }
-        this.emit('error', er);
-      } else {
-        let b = null;
-        // Now that we know how much data we have actually read, re-wind the
-        // 'used' field if we can, and otherwise allow the remainder of our
-        // reservation to be used as a new pool later.
-        if (start + toRead === thisPool.used && thisPool === pool) {
-          const newUsed = thisPool.used + bytesRead - toRead;
-          thisPool.used = roundUpToMultipleOf8(newUsed);
-        } else {
-          // Round down to the next lowest multiple of 8 to ensure the new pool
-          // fragment start and end positions are aligned to an 8 byte boundary.
-          const alignedEnd = (start + toRead) & ~7;
-          const alignedStart = roundUpToMultipleOf8(start + bytesRead);
-          if (alignedEnd - alignedStart >= kMinPoolSpace) {
-            poolFragments.push(thisPool.slice(alignedStart, alignedEnd));
-          }
-        }
-
-        if (bytesRead > 0) {
-          this.bytesRead += bytesRead;
-          b = thisPool.slice(start, start + bytesRead);
-        }
-
-        this.push(b);
-      }
-    });
+  if (spillPool !== null) {
+    this[kFs].readv(this.fd,
+                    [thisPool.slice(start, start + toRead),
+                     spillPool.slice(0, spillRead)],
+                    this.pos,
+                    onread);
+  } else {
+    this[kFs].read(this.fd, thisPool, start, toRead, this.pos, onread);
+  }
 
-  // Move the pool positions, and internal position for reading.
+  // Move the internal position for reading.
   if (this.pos !== undefined)
-    this.pos += toRead;
-
-  pool.used = roundUpToMultipleOf8(pool.used + toRead);
+    this.pos += toRead + spillRead;
 };
 
 ReadStream.prototype._destroy = function(err, cb) {
@@ -329,8 +373,15 @@ function WriteStream(path, options) {
     this._writev = null;
   }
 
+  if (options.coalesceWrites !== undefined)
+    validateBoolean(options.coalesceWrites, 'options.coalesceWrites');
+
   Writable.call(this, options);
 
+  // Coalescing relies on _writev() to write the gathered chunks at once.
+  this[kCoalesceWrites] = !!options.coalesceWrites && this._writev !== null;
+  this[kCoalescing] = false;
+
   // Path will be ignored when fd is specified, so it can be falsy
   this.path = toPathIfFileURL(path);
   this.fd = options.fd === undefined ? null : options.fd;
@@ -397,6 +448,29 @@ function _openWriteFs(stream) {
 }
 
 
+// With coalesceWrites, the first write of a tick corks the stream, so that
+// the chunks written during the rest of the tick are buffered and passed to
+// a single _writev() when the stream is uncorked on the next tick, or as
+// soon as they reach the highWaterMark.
+WriteStream.prototype.write = function(chunk, encoding, cb) {
+  if (this[kCoalesceWrites] && !this[kCoalescing] && !this.writableEnded) {
+    this[kCoalescing] = true;
+    this.cork();
+    process.nextTick(flushCoalescedWrites, this);
+  }
+  const ret = Writable.prototype.write.call(this, chunk, encoding, cb);
+  if (this[kCoalescing] && this.writableLength >= this.writableHighWaterMark)
+    flushCoalescedWrites(this);
+  return ret;
+};
+
+function flushCoalescedWrites(stream) {
+  if (!stream[kCoalescing])
+    return;
+  stream[kCoalescing] = false;
+  stream.uncork();
+}
+
 WriteStream.prototype._write = function(data, encoding, cb) {
   if (typeof this.fd !== 'number') {
     return this.once('open', function() {
@@ -1,18 +1,27 @@
 'use strict';
 
 const {
+  Array,
+  ArrayPrototypePush,
+  BigUint64Array,
+  Float64Array,
   ObjectDefineProperty,
   ObjectSetPrototypeOf,
+  SafeMap,
+  SafeSet,
   Symbol,
 } = primordials;
 
 const errors = require('internal/errors');
 const {
+  FSReqCallback,
   kFsStatsFieldsNumber,
+  statMany,
   StatWatcher: _StatWatcher
 } = internalBinding('fs');
-const { FSEvent } = internalBinding('fs_event_wrap');
+const { FSEvent, RecursiveFSEvent } = internalBinding('fs_event_wrap');
 const { UV_ENOSPC } = internalBinding('uv');
+const { AsyncResource } = require('async_hooks');
 const { EventEmitter } = require('events');
 const {
   getStatsFromBinding,
@@ -24,6 +33,7 @@ const {
 } = require('internal/async_hooks');
 const { toNamespacedPath } = require('path');
 const { validateUint32 } = require('internal/validators');
+const { clearTimeout, setTimeout } = require('timers');
 const assert = require('internal/assert');
 
 const kOldStatus = Symbol('kOldStatus');
@@ -32,6 +42,218 @@ const kUseBigint = Symbol('kUseBigint');
 const kFSWatchStart = Symbol('kFSWatchStart');
 const kFSStatWatcherStart = Symbol('kFSStatWatcherStart');
 
+// The fields that uv_fs_poll compares to decide whether a file has changed.
+// Access times, link counts and block counts are left out.
+const kChangeFields = [
+  0/* dev */, 1/* mode */, 3/* uid */, 4/* gid */, 7/* ino */, 8/* size */,
+  12/* mtime sec */, 13/* mtime nsec */, 14/* ctime sec */,
+  15/* ctime nsec */, 16/* birthtime sec */, 17/* birthtime nsec */,
+];
+
+// Batched StatWatchers with the same interval and stats type share a
+// StatPollGroup, which stats all of their files in a single statMany() job
+// per interval instead of running one threadpool stat per file.
+const statPollGroups = new SafeMap();
+
+class StatPollGroup {
+  constructor(key, interval, bigint) {
+    this.key = key;
+    this.interval = interval;
+    this.bigint = bigint;
+    this.handles = new SafeSet();
+    // Handles that were added since the last job started, whose first stat
+    // is not left until the next interval.
+    this.pending = [];
+    this.timer = null;
+    this.refed = false;
+  }
+
+  static get(interval, bigint) {
+    const key = `${interval}:${bigint}`;
+    let group = statPollGroups.get(key);
+    if (group === undefined) {
+      group = new StatPollGroup(key, interval, bigint);
+      statPollGroups.set(key, group);
+    }
+    return group;
+  }
+
+  add(handle) {
+    this.handles.add(handle);
+    if (ArrayPrototypePush(this.pending, handle) === 1)
+      process.nextTick(pollPending, this);
+    if (this.timer === null)
+      this.timer = setTimeout(pollAll, this.interval, this);
+    this.updateRef();
+  }
+
+  delete(handle) {
+    this.handles.delete(handle);
+    if (this.handles.size > 0) {
+      this.updateRef();
+      return;
+    }
+    if (this.timer !== null) {
+      clearTimeout(this.timer);
+      this.timer = null;
+    }
+    statPollGroups.delete(this.key);
+  }
+
+  // The group keeps the event loop alive as long as one of its handles does.
+  updateRef() {
+    let refed = false;
+    for (const handle of this.handles) {
+      if (handle.refed) {
+        refed = true;
+        break;
+      }
+    }
+    this.refed = refed;
+    if (this.timer !== null) {
+      if (refed)
+        this.timer.ref();
+      else
+        this.timer.unref();
+    }
+  }
+
+  poll(handles, onDone) {
+    const paths = new Array(handles.length);
+    for (let i = 0; i < handles.length; i++)
+      paths[i] = handles[i].path;
+    const req = new FSReqCallback(this.bigint);
+    req.oncomplete = (err, result) => {
+      if (!err) {
+        const { 0: stats, 1: errors } = result;
+        for (let i = 0; i < handles.length; i++) {
+          if (handles[i].group === this)
+            handles[i].update(errors[i], stats, i * kFsStatsFieldsNumber);
+        }
+      }
+      if (onDone !== undefined)
+        onDone(this);
+    };
+    statMany(paths, this.bigint, true, req);
+  }
+}
+
+function pollPending(group) {
+  const handles = [];
+  for (const handle of group.pending) {
+    if (handle.group === group)
+      ArrayPrototypePush(handles, handle);
+  }
+  group.pending = [];
+  if (handles.length > 0)
+    group.poll(handles);
+}
+
+function pollAll(group) {
+  group.timer = null;
+  if (group.handles.size === 0)
+    return;
+  group.pending = [];
+  group.poll([...group.handles], rearm);
+}
+
+function rearm(group) {
+  if (group.handles.size === 0 || group.timer !== null)
+    return;
+  group.timer = setTimeout(pollAll, group.interval, group);
+  if (!group.refed)
+    group.timer.unref();
+}
+
+// A handle with the interface of the StatWatcher binding whose file is
+// polled by a StatPollGroup. It reports changes the way uv_fs_poll does.
+class BatchedStatWatcher extends AsyncResource {
+  constructor(bigint) {
+    super('STATWATCHER');
+    this.bigint = !!bigint;
+    this.group = null;
+    this.path = null;
+    this.refed = true;
+    // 0 until the first stat, then 1, or the error of the last stat.
+    this.status = 0;
+    this.stats = null;
+    this.onchange = null;
+  }
+
+  start(path, interval) {
+    this.path = path;
+    this.group = StatPollGroup.get(interval, this.bigint);
+    this.group.add(this);
+  }
+
+  update(err, stats, offset) {
+    if (err !== 0) {
+      if (this.status !== err) {
+        this.status = err;
+        this.emitChange(err, null, 0);
+      }
+      return;
+    }
+    const changed = this.status < 0 ||
+      (this.status > 0 && !this.isUnchanged(stats, offset));
+    const previous = this.stats;
+    this.stats = stats.slice(offset, offset + kFsStatsFieldsNumber);
+    this.status = 1;
+    if (changed)
+      this.emitChange(0, stats, offset, previous);
+  }
+
+  isUnchanged(stats, offset) {
+    for (let i = 0; i < kChangeFields.length; i++) {
+      const field = kChangeFields[i];
+      if (stats[offset + field] !== this.stats[field])
+        return false;
+    }
+    return true;
+  }
+
+  // Passes the current stats followed by the previous ones, the layout that
+  // the StatWatcher binding uses. The stats of a file that could not be
+  // stat-ed are zeroed.
+  emitChange(status, stats, offset, previous = this.stats) {
+    const TypedArray = this.bigint ? BigUint64Array : Float64Array;
+    const both = new TypedArray(2 * kFsStatsFieldsNumber);
+    if (stats !== null)
+      both.set(stats.subarray(offset, offset + kFsStatsFieldsNumber));
+    if (previous !== null)
+      both.set(previous, kFsStatsFieldsNumber);
+    this.runInAsyncScope(this.onchange, this, status, both);
+  }
+
+  close() {
+    if (this.group === null)
+      return;
+    this.group.delete(this);
+    this.group = null;
+    this.emitDestroy();
+  }
+
+  ref() {
+    this.refed = true;
+    if (this.group !== null)
+      this.group.updateRef();
+  }
+
+  unref() {
+    this.refed = false;
+    if (this.group !== null)
+      this.group.updateRef();
+  }
+
+  hasRef() {
+    return this.refed;
+  }
+
+  getAsyncId() {
+    return this.asyncId();
+  }
+}
+
 function emitStop(self) {
   self.emit('stop');
 }
@@ -67,11 +289,14 @@ function onchange(newStatus, stats) {
 // This method is a noop if the watcher has already been started.
 StatWatcher.prototype[kFSStatWatcherStart] = function(filename,
                                                       persistent,
-                                                      interval) {
+                                                      interval,
+                                                      batch) {
   if (this._handle !== null)
     return;
 
-  this._handle = new _StatWatcher(this[kUseBigint]);
+  this._handle = batch ?
+    new BatchedStatWatcher(this[kUseBigint]) :
+    new _StatWatcher(this[kUseBigint]);
   this._handle[owner_symbol] = this;
   this._handle.onchange = onchange;
   if (!persistent)
@@ -150,6 +375,29 @@ function FSWatcher() {
 ObjectSetPrototypeOf(FSWatcher.prototype, EventEmitter.prototype);
 ObjectSetPrototypeOf(FSWatcher, EventEmitter);
 
+// Called by a RecursiveFSEvent with a batch of changes, as a flat array of
+// event types and filenames.
+function onchanges(changes) {
+  const watcher = this[owner_symbol];
+  if (watcher.listenerCount('changes') > 0) {
+    const list = [];
+    for (let i = 0; i < changes.length; i += 2)
+      list.push({ eventType: changes[i], filename: changes[i + 1] });
+    watcher.emit('changes', list);
+  }
+  for (let i = 0; i < changes.length; i += 2) {
+    // A listener may have closed the watcher.
+    if (watcher._handle !== this)
+      return;
+    watcher.emit('change', changes[i], changes[i + 1]);
+  }
+}
+
+function isFSEventHandle(handle) {
+  return handle instanceof FSEvent ||
+    (RecursiveFSEvent !== undefined && handle instanceof RecursiveFSEvent);
+}
+
 // At the moment if filename is undefined, we
 // 1. Throw an Error if it's the first time Symbol('kFSWatchStart') is called
 // 2. Return silently if Symbol('kFSWatchStart') has already been called
@@ -159,21 +407,38 @@ ObjectSetPrototypeOf(FSWatcher, EventEmitter);
 FSWatcher.prototype[kFSWatchStart] = function(filename,
                                               persistent,
                                               recursive,
-                                              encoding) {
+                                              encoding,
+                                              debounce = 0) {
   if (this._handle === null) {  // closed
     return;
   }
-  assert(this._handle instanceof FSEvent, 'handle must be a FSEvent');
+  assert(isFSEventHandle(this._handle), 'handle must be a FSEvent');
   if (this._handle.initialized) {  // already started
     return;
   }
 
   filename = getValidatedPath(filename, 'filename');
+  validateUint32(debounce, 'options.debounce');
 
-  const err = this._handle.start(toNamespacedPath(filename),
-                                 persistent,
-                                 recursive,
-                                 encoding);
+  let err;
+  if (recursive && RecursiveFSEvent !== undefined) {
+    // Directory trees are watched natively on Linux, where libuv only
+    // watches single directories.
+    const handle = new RecursiveFSEvent();
+    handle[owner_symbol] = this;
+    handle.onchange = this._handle.onchange;
+    handle.onchanges = onchanges;
+    this._handle = handle;
+    err = handle.start(toNamespacedPath(filename),
+                       persistent,
+                       encoding,
+                       debounce);
+  } else {
+    err = this._handle.start(toNamespacedPath(filename),
+                             persistent,
+                             recursive,
+                             encoding);
+  }
   if (err) {
     const error = errors.uvException({
       errno: err,
@@ -199,7 +464,7 @@ FSWatcher.prototype.close = function() {
   if (this._handle === null) {  // closed
     return;
   }
-  assert(this._handle instanceof FSEvent, 'handle must be a FSEvent');
+  assert(isFSEventHandle(this._handle), 'handle must be a FSEvent');
   if (!this._handle.initialized) {  // not started
     return;
   }
@@ -94,7 +94,9 @@ const {
   },
   hideStackFrames
 } = require('internal/errors');
-const { validateNumber,
+const { validateBoolean,
+        validateInt32,
+        validateNumber,
         validateString,
         validateUint32,
         isUint32,
@@ -2255,7 +2257,7 @@ function onPipedFileHandleRead() {
 }
 
 function processRespondWithFD(self, fd, headers, offset = 0, length = -1,
-                              streamOptions = 0) {
+                              streamOptions = 0, readAhead = 1) {
   const state = self[kState];
   state.flags |= STREAM_FLAGS_HEADERS_SENT;
 
@@ -2281,11 +2283,23 @@ function processRespondWithFD(self, fd, headers, offset = 0, length = -1,
   }
 
   defaultTriggerAsyncIdScope(self[async_id_symbol], startFilePipe,
-                             self, fd, offset, length);
+                             self, fd, offset, length, readAhead);
 }
 
-function startFilePipe(self, fd, offset, length) {
-  const handle = new FileHandle(fd, offset, length);
+function startFilePipe(self, fd, offset, length, readAhead) {
+  // Sessions on top of a plain TCP socket or pipe can have the file data
+  // written to the socket directly. The native side keeps its own
+  // descriptor for that.
+  if (self[kHandle].sendFile(fd, offset, length) === 0) {
+    if (self.ownsFd)
+      fs.close(fd, (err) => { if (err) self.destroy(err); });
+    trackWriteState(self, 1);
+    return;
+  }
+
+  // With readAhead > 1, up to that many reads of the file are kept in flight
+  // so that the next chunk is usually ready by the time the stream wants it.
+  const handle = new FileHandle(fd, offset, length, readAhead);
   handle.onread = onPipedFileHandleRead;
   handle.stream = self;
 
@@ -2333,7 +2347,8 @@ function doSendFD(session, options, fd, headers, streamOptions, err, stat) {
   processRespondWithFD(this, fd, headers,
                        statOptions.offset | 0,
                        statOptions.length | 0,
-                       streamOptions);
+                       streamOptions,
+                       options.readAhead);
 }
 
 function doSendFileFD(session, options, fd, headers, streamOptions, err, stat) {
@@ -2402,7 +2417,8 @@ function doSendFileFD(session, options, fd, headers, streamOptions, err, stat) {
   processRespondWithFD(this, fd, headers,
                        options.offset | 0,
                        statOptions.length | 0,
-                       streamOptions);
+                       streamOptions,
+                       options.readAhead);
 }
 
 function afterOpen(session, options, headers, streamOptions, err, fd) {
@@ -2594,6 +2610,9 @@ class ServerHttp2Stream extends Http2Stream {
     if (options.length !== undefined && typeof options.length !== 'number')
       throw new ERR_INVALID_OPT_VALUE('length', options.length);
 
+    if (options.readAhead !== undefined)
+      validateInt32(options.readAhead, 'options.readAhead', 1, 64);
+
     if (options.statCheck !== undefined &&
         typeof options.statCheck !== 'function') {
       throw new ERR_INVALID_OPT_VALUE('statCheck', options.statCheck);
@@ -2634,7 +2653,8 @@ class ServerHttp2Stream extends Http2Stream {
     processRespondWithFD(this, fd, headers,
                          options.offset,
                          options.length,
-                         streamOptions);
+                         streamOptions,
+                         options.readAhead);
   }
 
   // Initiate a file response on this Http2Stream. The path is passed to
@@ -2659,6 +2679,9 @@ class ServerHttp2Stream extends Http2Stream {
     if (options.length !== undefined && typeof options.length !== 'number')
       throw new ERR_INVALID_OPT_VALUE('length', options.length);
 
+    if (options.readAhead !== undefined)
+      validateInt32(options.readAhead, 'options.readAhead', 1, 64);
+
     if (options.statCheck !== undefined &&
         typeof options.statCheck !== 'function') {
       throw new ERR_INVALID_OPT_VALUE('statCheck', options.statCheck);
@@ -2689,6 +2712,23 @@ class ServerHttp2Stream extends Http2Stream {
             afterOpen.bind(this, session, options, headers, streamOptions));
   }
 
+  // Sets the extensible priority (RFC 9218) of the stream, overriding the
+  // one the client sent in the `priority` request header. This only has an
+  // effect if the server was created with the extensiblePriorities option.
+  setExtensiblePriority(options) {
+    if (this.destroyed || this.closed)
+      throw new ERR_HTTP2_INVALID_STREAM();
+
+    assertIsObject(options, 'options');
+    const { urgency = 3, incremental = false } = options;
+    validateInt32(urgency, 'options.urgency', 0, 7);
+    validateBoolean(incremental, 'options.incremental');
+
+    debugStreamObj(this, 'setting extensible priority');
+    this[kUpdateTimer]();
+    this[kHandle].extensiblePriority(urgency, incremental);
+  }
+
   // Sends a block of informational headers. In theory, the HTTP/2 spec
   // allows sending a HEADER block at any time during a streams lifecycle,
   // but the HTTP request/response semantics defined in HTTP/2 places limits
@@ -2862,6 +2902,15 @@ function initializeOptions(options) {
     );
   }
 
+  if (options.coalesceWrites !== undefined)
+    validateBoolean(options.coalesceWrites, 'options.coalesceWrites');
+  if (options.adaptiveWindowSize !== undefined)
+    validateBoolean(options.adaptiveWindowSize, 'options.adaptiveWindowSize');
+  if (options.extensiblePriorities !== undefined) {
+    validateBoolean(options.extensiblePriorities,
+                    'options.extensiblePriorities');
+  }
+
   // Used only with allowHTTP1
   options.Http1IncomingMessage = options.Http1IncomingMessage ||
     http.IncomingMessage;
@@ -3002,6 +3051,11 @@ function connect(authority, options, listener) {
   assertIsObject(options, 'options');
   options = { ...options };
 
+  if (options.coalesceWrites !== undefined)
+    validateBoolean(options.coalesceWrites, 'options.coalesceWrites');
+  if (options.adaptiveWindowSize !== undefined)
+    validateBoolean(options.adaptiveWindowSize, 'options.adaptiveWindowSize');
+
   if (typeof authority === 'string')
     authority = new URL(authority);
 
@@ -187,6 +187,8 @@ const IDX_SESSION_STATE_REMOTE_WINDOW_SIZE = 5;
 const IDX_SESSION_STATE_OUTBOUND_QUEUE_SIZE = 6;
 const IDX_SESSION_STATE_HD_DEFLATE_DYNAMIC_TABLE_SIZE = 7;
 const IDX_SESSION_STATE_HD_INFLATE_DYNAMIC_TABLE_SIZE = 8;
+const IDX_SESSION_STATE_HEADER_STRING_CACHE_HITS = 9;
+const IDX_SESSION_STATE_HEADER_STRING_CACHE_MISSES = 10;
 const IDX_STREAM_STATE = 0;
 const IDX_STREAM_STATE_WEIGHT = 1;
 const IDX_STREAM_STATE_SUM_DEPENDENCY_WEIGHT = 2;
@@ -203,7 +205,10 @@ const IDX_OPTIONS_MAX_HEADER_LIST_PAIRS = 5;
 const IDX_OPTIONS_MAX_OUTSTANDING_PINGS = 6;
 const IDX_OPTIONS_MAX_OUTSTANDING_SETTINGS = 7;
 const IDX_OPTIONS_MAX_SESSION_MEMORY = 8;
-const IDX_OPTIONS_FLAGS = 9;
+const IDX_OPTIONS_COALESCE_WRITES = 9;
+const IDX_OPTIONS_ADAPTIVE_WINDOW_SIZE = 10;
+const IDX_OPTIONS_EXTENSIBLE_PRIORITIES = 11;
+const IDX_OPTIONS_FLAGS = 12;
 
 function updateOptionsBuffer(options) {
   let flags = 0;
@@ -252,6 +257,20 @@ function updateOptionsBuffer(options) {
     optionsBuffer[IDX_OPTIONS_MAX_SESSION_MEMORY] =
       MathMax(1, options.maxSessionMemory);
   }
+  if (typeof options.coalesceWrites === 'boolean') {
+    flags |= (1 << IDX_OPTIONS_COALESCE_WRITES);
+    optionsBuffer[IDX_OPTIONS_COALESCE_WRITES] = options.coalesceWrites ? 1 : 0;
+  }
+  if (typeof options.adaptiveWindowSize === 'boolean') {
+    flags |= (1 << IDX_OPTIONS_ADAPTIVE_WINDOW_SIZE);
+    optionsBuffer[IDX_OPTIONS_ADAPTIVE_WINDOW_SIZE] =
+      options.adaptiveWindowSize ? 1 : 0;
+  }
+  if (typeof options.extensiblePriorities === 'boolean') {
+    flags |= (1 << IDX_OPTIONS_EXTENSIBLE_PRIORITIES);
+    optionsBuffer[IDX_OPTIONS_EXTENSIBLE_PRIORITIES] =
+      options.extensiblePriorities ? 1 : 0;
+  }
   optionsBuffer[IDX_OPTIONS_FLAGS] = flags;
 }
 
@@ -387,7 +406,11 @@ function getSessionState(session) {
     deflateDynamicTableSize:
       sessionState[IDX_SESSION_STATE_HD_DEFLATE_DYNAMIC_TABLE_SIZE],
     inflateDynamicTableSize:
-      sessionState[IDX_SESSION_STATE_HD_INFLATE_DYNAMIC_TABLE_SIZE]
+      sessionState[IDX_SESSION_STATE_HD_INFLATE_DYNAMIC_TABLE_SIZE],
+    headerStringCacheHits:
+      sessionState[IDX_SESSION_STATE_HEADER_STRING_CACHE_HITS],
+    headerStringCacheMisses:
+      sessionState[IDX_SESSION_STATE_HEADER_STRING_CACHE_MISSES]
   };
 }
 
@@ -25,7 +25,7 @@ function onreadstop() { return this[owner_symbol].readStop(); }
 
 function onshutdown(req) { return this[owner_symbol].doShutdown(req); }
 
-function onwrite(req, bufs) { return this[owner_symbol].doWrite(req, bufs); }
+function onwrite(req, buf) { return this[owner_symbol].doWrite(req, buf); }
 
 /* This class serves as a wrapper for when the C++ side of Node wants access
  * to a standard JS stream. For example, TLS or HTTP do not operate on network
@@ -155,40 +155,47 @@ class JSStreamSocket extends Socket {
     handle.finishShutdown(req, errCode);
   }
 
-  doWrite(req, bufs) {
+  // `buf` holds all buffers of the write request.
+  doWrite(req, buf) {
     assert(this[kCurrentWriteRequest] === null);
     assert(this[kCurrentShutdownRequest] === null);
 
     const handle = this._handle;
     const self = this;
 
-    let pending = bufs.length;
+    let finished = false;
+    let sync = true;
 
-    this.stream.cork();
-    // Use `var` over `let` for performance optimization.
-    for (var i = 0; i < bufs.length; ++i)
-      this.stream.write(bufs[i], done);
-    this.stream.uncork();
+    const written = this.stream.write(buf, done);
+    sync = false;
 
-    // Only set the request here, because the `write()` calls could throw.
+    // Only set the request here, because the `write()` call could throw.
     this[kCurrentWriteRequest] = req;
 
-    function done(err) {
-      if (!err && --pending !== 0)
-        return;
-
-      // Ensure that this is called once in case of error
-      pending = 0;
+    // If the stream accepted the data without asking us to wait, the write
+    // completes without waiting for the data to be flushed, so that the C++
+    // side can go on writing. Later errors are emitted by the stream.
+    if (written)
+      process.nextTick(finish, 0);
 
+    function done(err) {
       let errCode = 0;
       if (err) {
         errCode = uv[`UV_${err.code}`] || uv.UV_EPIPE;
       }
 
-      // Ensure that write was dispatched
-      setImmediate(() => {
-        self.finishWrite(handle, errCode);
-      });
+      // Ensure that the write completes asynchronously.
+      if (sync)
+        process.nextTick(finish, errCode);
+      else
+        finish(errCode);
+    }
+
+    function finish(errCode) {
+      if (finished)
+        return;
+      finished = true;
+      self.finishWrite(handle, errCode);
     }
 
     return 0;
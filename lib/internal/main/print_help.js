@@ -42,6 +42,10 @@ const envVars = new Map([
     'certificate validation' }],
   ['NODE_V8_COVERAGE', { helpText: 'directory to output v8 coverage JSON ' +
     'to' }],
+  ['NODE_V8_COVERAGE_BINARY', { helpText: 'set to 1 to record only whether ' +
+    'code was executed in v8 coverage' }],
+  ['NODE_V8_COVERAGE_INTERVAL', { helpText: 'write v8 coverage in chunks ' +
+    'every ms milliseconds' }],
   ['UV_THREADPOOL_SIZE', { helpText: 'sets the number of threads used in ' +
     'libuv\'s threadpool' }]
 ].concat(hasIntl ? [
@@ -23,6 +23,7 @@
 
 const {
   ArrayIsArray,
+  ArrayPrototypeJoin,
   Error,
   JSONParse,
   Map,
@@ -38,6 +39,7 @@ const {
   ObjectSetPrototypeOf,
   ReflectSet,
   SafeMap,
+  SafeWeakMap,
   String,
   StringPrototypeIndexOf,
   StringPrototypeMatch,
@@ -52,15 +54,21 @@ const {
 } = require('internal/source_map/source_map_cache');
 const { pathToFileURL, fileURLToPath, URL } = require('internal/url');
 const { deprecate, emitExperimentalWarning } = require('internal/util');
-const vm = require('vm');
 const assert = require('internal/assert');
 const fs = require('fs');
 const internalFS = require('internal/fs/utils');
 const path = require('path');
 const { emitWarningSync } = require('internal/process/warning');
 const {
+  clearModuleResolutionCache,
+  getCachedModulePath,
+  getModuleResolutionCacheGeneration,
+  internalModuleArchiveCodeCache,
+  internalModuleArchiveStat,
+  internalModuleReadArchive,
   internalModuleReadJSON,
-  internalModuleStat
+  internalModuleStat,
+  setCachedModulePath
 } = internalBinding('fs');
 const { safeGetenv } = internalBinding('credentials');
 const {
@@ -73,10 +81,15 @@ const { getOptionValue } = require('internal/options');
 const enableSourceMaps = getOptionValue('--enable-source-maps');
 const preserveSymlinks = getOptionValue('--preserve-symlinks');
 const preserveSymlinksMain = getOptionValue('--preserve-symlinks-main');
+const hasModuleArchive = getOptionValue('--module-archive') !== '';
 const manifest = getOptionValue('--experimental-policy') ?
   require('internal/process/policy').manifest :
   null;
-const { compileFunction } = internalBinding('contextify');
+const {
+  compileFunction,
+  createFunctionCachedData
+} = internalBinding('contextify');
+const compileCache = require('internal/modules/compile_cache');
 
 // Whether any user-provided CJS modules had been loaded (executed).
 // Used for internal assertions.
@@ -92,11 +105,36 @@ const { validateString } = require('internal/validators');
 const pendingDeprecation = getOptionValue('--pending-deprecation');
 
 module.exports = {
-  wrapSafe, Module, toRealPath, readPackageScope,
+  wrapSafe, Module, toRealPath, readPackageScope, getLoadedExports,
   get hasLoadedAnyUserCJSModule() { return hasLoadedAnyUserCJSModule; }
 };
 
 let asyncESM, ModuleJob, ModuleWrap, kInstantiated;
+// The exports of the modules that were loaded before the ESM loader, as of
+// the end of their evaluation.
+const exportsBeforeESMLoader = new SafeWeakMap();
+
+// The ESM loader is only loaded once it is used, to keep it out of the
+// startup of CommonJS applications.
+function lazyAsyncESM() {
+  if (asyncESM === undefined) {
+    asyncESM = require('internal/process/esm_loader');
+    ModuleJob = require('internal/modules/esm/module_job');
+  }
+  return asyncESM;
+}
+
+// Returns the exports of a loaded module, as of the end of its evaluation.
+function getLoadedExports(module) {
+  if (exportsBeforeESMLoader.has(module))
+    return exportsBeforeESMLoader.get(module);
+  return module.exports;
+}
+
+function isESMLoaderLoaded() {
+  return asyncESM !== undefined ||
+    NativeModule.map.get('internal/process/esm_loader').loaded;
+}
 
 const {
   CHAR_FORWARD_SLASH,
@@ -173,6 +211,9 @@ Module.builtinModules = builtinModules;
 
 Module._cache = ObjectCreate(null);
 Module._pathCache = ObjectCreate(null);
+// Used to detect when Module._pathCache is replaced, which discards the
+// results that are shared with other threads as well.
+let currentPathCache = Module._pathCache;
 Module._extensions = ObjectCreate(null);
 let modulePaths = [];
 Module.globalPaths = [];
@@ -355,7 +396,23 @@ function tryFile(requestPath, isMain) {
   return rc === 0 && toRealPath(requestPath);
 }
 
+// Reads a module from the module archive, or from disk if the archive does
+// not contain it.
+function readSource(filename) {
+  if (hasModuleArchive) {
+    const source = internalModuleReadArchive(path.toNamespacedPath(filename));
+    if (source !== undefined)
+      return source;
+  }
+  return fs.readFileSync(filename, 'utf8');
+}
+
 function toRealPath(requestPath) {
+  // Files in the module archive do not exist on disk.
+  if (hasModuleArchive &&
+      internalModuleArchiveStat(path.toNamespacedPath(requestPath)) !== -1) {
+    return path.resolve(requestPath);
+  }
   return fs.realpathSync(requestPath, {
     [internalFS.realpathCacheKey]: realpathCache
   });
@@ -653,6 +710,32 @@ Module._findPath = function(request, paths, isMain) {
   if (entry)
     return entry;
 
+  // The results are shared with the other threads of the process, under a
+  // key that includes the options and extensions that they depend on.
+  // Policies can differ between threads, so they opt out of sharing.
+  let sharedCacheKey;
+  let sharedCacheGeneration;
+  if (!manifest) {
+    if (Module._pathCache !== currentPathCache) {
+      currentPathCache = Module._pathCache;
+      clearModuleResolutionCache();
+    }
+    const preserve = isMain ? preserveSymlinksMain : preserveSymlinks;
+    sharedCacheKey = `${isMain ? 'main' : ''}:${preserve}:` +
+      ArrayPrototypeJoin(ObjectKeys(Module._extensions), ',') + '\x00' +
+      cacheKey;
+    const filename = getCachedModulePath(sharedCacheKey);
+    if (filename !== undefined) {
+      if (stat(filename) === 0) {
+        Module._pathCache[cacheKey] = filename;
+        return filename;
+      }
+      // The file system has changed since the module was resolved.
+      clearModuleResolutionCache();
+    }
+    sharedCacheGeneration = getModuleResolutionCacheGeneration();
+  }
+
   let exts;
   let trailingSlash = request.length > 0 &&
     request.charCodeAt(request.length - 1) === CHAR_FORWARD_SLASH;
@@ -709,6 +792,8 @@ Module._findPath = function(request, paths, isMain) {
 
     if (filename) {
       Module._pathCache[cacheKey] = filename;
+      if (sharedCacheKey !== undefined)
+        setCachedModulePath(sharedCacheGeneration, sharedCacheKey, filename);
       return filename;
     }
   }
@@ -1055,7 +1140,12 @@ Module.prototype.load = function(filename) {
   Module._extensions[extension](this, filename);
   this.loaded = true;
 
-  const ESMLoader = asyncESM.ESMLoader;
+  if (!isESMLoaderLoaded()) {
+    // Used by the commonjs translator if the module is imported later on.
+    exportsBeforeESMLoader.set(this, this.exports);
+    return;
+  }
+  const ESMLoader = lazyAsyncESM().ESMLoader;
   const url = `${pathToFileURL(filename)}`;
   const module = ESMLoader.moduleMap.get(url);
   // Create module entry at load time to snapshot exports correctly
@@ -1107,16 +1197,27 @@ let hasPausedEntry = false;
 function wrapSafe(filename, content, cjsModuleInstance) {
   if (patched) {
     const wrapper = Module.wrap(content);
+    const vm = require('vm');
     return vm.runInThisContext(wrapper, {
       filename,
       lineOffset: 0,
       displayErrors: true,
       importModuleDynamically: async (specifier) => {
-        const loader = asyncESM.ESMLoader;
+        const loader = lazyAsyncESM().ESMLoader;
         return loader.import(specifier, normalizeReferrerURL(filename));
       },
     });
   }
+  // The code caches in the module archive take precedence.
+  let cachedData = hasModuleArchive ?
+    internalModuleArchiveCodeCache(path.toNamespacedPath(filename), content) :
+    undefined;
+  let cacheEntry;
+  if (cachedData === undefined) {
+    cacheEntry = compileCache.lookup('cjs', content);
+    if (cacheEntry !== undefined)
+      cachedData = cacheEntry.cachedData;
+  }
   let compiled;
   try {
     compiled = compileFunction(
@@ -1124,7 +1225,7 @@ function wrapSafe(filename, content, cjsModuleInstance) {
       filename,
       0,
       0,
-      undefined,
+      cachedData,
       false,
       undefined,
       [],
@@ -1142,10 +1243,16 @@ function wrapSafe(filename, content, cjsModuleInstance) {
     throw err;
   }
 
+  if (cacheEntry !== undefined &&
+      (cachedData === undefined || compiled.cachedDataRejected)) {
+    const fn = compiled.function;
+    compileCache.save(cacheEntry, () => createFunctionCachedData(fn));
+  }
+
   const { callbackMap } = internalBinding('module_wrap');
   callbackMap.set(compiled.cacheKey, {
     importModuleDynamically: async (specifier) => {
-      const loader = asyncESM.ESMLoader;
+      const loader = lazyAsyncESM().ESMLoader;
       return loader.import(specifier, normalizeReferrerURL(filename));
     }
   });
@@ -1222,14 +1329,14 @@ Module._extensions['.js'] = function(module, filename) {
       throw new ERR_REQUIRE_ESM(filename, parentPath, packageJsonPath);
     }
   }
-  const content = fs.readFileSync(filename, 'utf8');
+  const content = readSource(filename);
   module._compile(content, filename);
 };
 
 
 // Native extension for .json
 Module._extensions['.json'] = function(module, filename) {
-  const content = fs.readFileSync(filename, 'utf8');
+  const content = readSource(filename);
 
   if (manifest) {
     const moduleURL = pathToFileURL(filename);
@@ -1362,7 +1469,4 @@ Module.syncBuiltinESMExports = function syncBuiltinESMExports() {
 // Backwards compatibility
 Module.Module = Module;
 
-// We have to load the esm things after module.exports!
-asyncESM = require('internal/process/esm_loader');
-ModuleJob = require('internal/modules/esm/module_job');
 ({ ModuleWrap, kInstantiated } = internalBinding('module_wrap'));
@@ -0,0 +1,190 @@
+'use strict';
+
+// On-disk cache of the V8 code caches of user modules and of vm sources
+// that opt into it, enabled with --compile-cache-dir. Sources whose code
+// cache is found are compiled with it, the code caches of the other sources
+// are written once the application has warmed up, or when the process exits.
+
+const {
+  MathImul,
+  NumberPrototypeToString,
+  SafeMap,
+  StringPrototypeCharCodeAt,
+  StringPrototypePadStart,
+} = primordials;
+
+const fs = require('fs');
+const path = require('path');
+const { getOptionValue } = require('internal/options');
+
+// The code caches are written once the application has run for this long,
+// so that they include the functions that were compiled lazily.
+const kWarmUpTime = 1000;
+
+let cacheDir;
+// Maps the cache keys of modules that have been compiled without a code
+// cache to functions that produce one.
+const pendingEntries = new SafeMap();
+let flushScheduled = false;
+let exitHandlerInstalled = false;
+
+function hex(value) {
+  return StringPrototypePadStart(
+    NumberPrototypeToString(value >>> 0, 16), 8, '0');
+}
+
+function getCacheDir() {
+  if (cacheDir === undefined) {
+    const dir = getOptionValue('--compile-cache-dir');
+    if (dir === '') {
+      cacheDir = null;
+    } else {
+      // Code caches are only accepted by the V8 version and flags that
+      // created them, so they are kept apart.
+      const { cachedDataVersionTag } = internalBinding('v8');
+      cacheDir = path.resolve(dir, `v8-${hex(cachedDataVersionTag())}`);
+    }
+  }
+  return cacheDir;
+}
+
+function isEnabled() {
+  return getCacheDir() !== null;
+}
+
+let createHash;
+
+// `salt` holds anything besides the source that the code cache depends on,
+// such as the filename and compile options. V8 only checks the length of
+// the source before it consumes a code cache, so the key has to tell apart
+// any two sources for which a wrong code cache would be accepted.
+function getCacheKey(kind, source, salt = '') {
+  // The length prefix keeps the salt from running into the source.
+  const input = `${salt.length}:${salt}\n${source}`;
+  if (process.versions.openssl) {
+    if (createHash === undefined)
+      createHash = require('crypto').createHash;
+    return `${kind}-${createHash('sha256').update(input).digest('hex')}`;
+  }
+  // Without crypto support, fall back to a pair of 32-bit hashes, and keep
+  // the length of the source in the key so that a collision still needs a
+  // source of the same length.
+  let h1 = 0x811c9dc5;
+  let h2 = source.length;
+  for (let i = 0; i < input.length; i++) {
+    const c = StringPrototypeCharCodeAt(input, i);
+    h1 = MathImul(h1 ^ c, 0x01000193);
+    h2 = MathImul(h2 ^ c, 0x5bd1e995);
+    h2 ^= h2 >>> 15;
+  }
+  return `${kind}-${hex(source.length)}-${hex(h1)}${hex(h2)}`;
+}
+
+// Returns undefined if the cache is disabled. Otherwise, returns an entry
+// for the module, whose `cachedData` is undefined if there is no code cache
+// for it yet.
+function lookup(kind, source) {
+  return read(getCacheKey(kind, source));
+}
+
+// Like lookup(), for a key returned by getCacheKey().
+function read(key) {
+  const dir = getCacheDir();
+  if (dir === null)
+    return undefined;
+  let cachedData;
+  try {
+    cachedData = fs.readFileSync(path.join(dir, key));
+  } catch {
+    // The module has not been cached yet.
+  }
+  return { key, cachedData };
+}
+
+// Writes the code cache returned by `produceCachedData()` for the entry
+// once the application has warmed up.
+function save(entry, produceCachedData) {
+  if (getCacheDir() === null)
+    return;
+  pendingEntries.set(entry.key, produceCachedData);
+  if (!flushScheduled) {
+    flushScheduled = true;
+    const { setTimeout } = require('timers');
+    setTimeout(flush, kWarmUpTime).unref();
+  }
+  if (!exitHandlerInstalled) {
+    exitHandlerInstalled = true;
+    process.once('exit', flushSync);
+  }
+}
+
+function takePendingEntries() {
+  const entries = [];
+  for (const { 0: key, 1: produceCachedData } of pendingEntries) {
+    let data;
+    try {
+      data = produceCachedData();
+    } catch {
+      continue;
+    }
+    if (data !== undefined && data.length > 0)
+      entries.push({ file: path.join(cacheDir, key), data });
+  }
+  pendingEntries.clear();
+  return entries;
+}
+
+// Files are written under a temporary name and then renamed, so that
+// concurrent processes never read partially written code caches.
+function getTemporaryPath(file) {
+  const { threadId } = internalBinding('worker');
+  return `${file}.${process.pid}-${threadId}.tmp`;
+}
+
+function flush() {
+  flushScheduled = false;
+  const entries = takePendingEntries();
+  if (entries.length === 0)
+    return;
+  fs.mkdir(cacheDir, { recursive: true }, (err) => {
+    if (err)
+      return;
+    for (const { file, data } of entries) {
+      const tmp = getTemporaryPath(file);
+      fs.writeFile(tmp, data, (err) => {
+        if (err)
+          fs.unlink(tmp, () => {});
+        else
+          fs.rename(tmp, file, () => {});
+      });
+    }
+  });
+}
+
+function flushSync() {
+  const entries = takePendingEntries();
+  if (entries.length === 0)
+    return;
+  try {
+    fs.mkdirSync(cacheDir, { recursive: true });
+  } catch {
+    return;
+  }
+  for (const { file, data } of entries) {
+    const tmp = getTemporaryPath(file);
+    try {
+      fs.writeFileSync(tmp, data);
+      fs.renameSync(tmp, file);
+    } catch {
+      try { fs.unlinkSync(tmp); } catch {}
+    }
+  }
+}
+
+module.exports = {
+  getCacheKey,
+  isEnabled,
+  lookup,
+  read,
+  save,
+};
@@ -1,23 +1,61 @@
 'use strict';
 
+const {
+  ArrayIsArray,
+} = primordials;
+
 const { Buffer } = require('buffer');
 
 const fs = require('fs');
-const { URL } = require('url');
+const { toNamespacedPath } = require('path');
+const { URL, fileURLToPath } = require('url');
+const { getOptionValue } = require('internal/options');
 const { promisify } = require('internal/util');
 const {
   ERR_INVALID_URL,
   ERR_INVALID_URL_SCHEME,
 } = require('internal/errors').codes;
 const readFileAsync = promisify(fs.readFile);
+const closeAsync = promisify(fs.close);
+const hasModuleArchive = getOptionValue('--module-archive') !== '';
+const {
+  internalModuleReadArchive,
+  kUsePromises,
+  readFile: readFileBinding,
+} = internalBinding('fs');
+const { O_RDONLY } = internalBinding('constants').fs;
 
 const DATA_URL_PATTERN = /^[^/]+\/[^,;]+(?:[^,]*?)(;base64)?,([\s\S]*)$/;
 
+// Reads a module file in a single threadpool job and resolves a promise
+// directly, instead of going through the callback-based fs.readFile(). The
+// dependencies of a module are fetched concurrently, so this is called many
+// times in a row while modules are compiled as their reads complete.
+async function readModuleFile(path) {
+  const result =
+    await readFileBinding(path, O_RDONLY, undefined, kUsePromises);
+  if (!ArrayIsArray(result))
+    return result;
+  // Files that are too large to be read in one go are read in chunks.
+  const fd = result[0];
+  try {
+    return await readFileAsync(fd);
+  } finally {
+    await closeAsync(fd);
+  }
+}
+
 async function defaultGetSource(url, { format } = {}, defaultGetSource) {
   const parsed = new URL(url);
   if (parsed.protocol === 'file:') {
+    const path = toNamespacedPath(fileURLToPath(parsed));
+    if (hasModuleArchive) {
+      const source = internalModuleReadArchive(path);
+      if (source !== undefined)
+        return { source };
+    }
     return {
-      source: await readFileAsync(parsed)
+      source: await readModuleFile(path)
     };
   } else if (parsed.protocol === 'data:') {
     const match = DATA_URL_PATTERN.exec(parsed.pathname);
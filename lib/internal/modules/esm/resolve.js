@@ -1,35 +1,39 @@
 'use strict';
 
 const {
-  SafeMap,
+  RegExpPrototypeTest,
 } = primordials;
 
-const internalFS = require('internal/fs/utils');
 const { NativeModule } = require('internal/bootstrap/loaders');
-const { realpathSync } = require('fs');
 const { getOptionValue } = require('internal/options');
-const { sep } = require('path');
 
 const preserveSymlinks = getOptionValue('--preserve-symlinks');
 const preserveSymlinksMain = getOptionValue('--preserve-symlinks-main');
 const typeFlag = getOptionValue('--input-type');
 const { resolve: moduleWrapResolve } = internalBinding('module_wrap');
-const { URL, pathToFileURL, fileURLToPath } = require('internal/url');
+const { URL, pathToFileURL } = require('internal/url');
 const { ERR_INPUT_TYPE_NOT_ALLOWED,
         ERR_UNSUPPORTED_ESM_URL_SCHEME } = require('internal/errors').codes;
 
-const realpathCache = new SafeMap();
+// Only specifiers that start with a scheme can parse as absolute URLs. The URL
+// parser skips leading C0 controls and spaces, and tabs and newlines anywhere.
+// eslint-disable-next-line no-control-regex
+const schemeRegExp = /^[\x00-\x20]*[A-Za-z][A-Za-z0-9+\-.\t\n\r]*:/;
 
 function defaultResolve(specifier, { parentURL } = {}, defaultResolve) {
   let parsed;
-  try {
-    parsed = new URL(specifier);
-    if (parsed.protocol === 'data:') {
-      return {
-        url: specifier
-      };
-    }
-  } catch {}
+  // Most specifiers are relative or bare, so skip the exception that parsing
+  // them as URLs would throw.
+  if (RegExpPrototypeTest(schemeRegExp, specifier)) {
+    try {
+      parsed = new URL(specifier);
+      if (parsed.protocol === 'data:') {
+        return {
+          url: specifier
+        };
+      }
+    } catch {}
+  }
   if (parsed && parsed.protocol === 'nodejs:')
     return { url: specifier };
   if (parsed && parsed.protocol !== 'file:' && parsed.protocol !== 'data:')
@@ -58,19 +62,12 @@ function defaultResolve(specifier, { parentURL } = {}, defaultResolve) {
       throw new ERR_INPUT_TYPE_NOT_ALLOWED();
   }
 
-  let url = moduleWrapResolve(specifier, parentURL);
-
-  if (isMain ? !preserveSymlinksMain : !preserveSymlinks) {
-    const urlPath = fileURLToPath(url);
-    const real = realpathSync(urlPath, {
-      [internalFS.realpathCacheKey]: realpathCache
-    });
-    const old = url;
-    url = pathToFileURL(real + (urlPath.endsWith(sep) ? '/' : ''));
-    url.search = old.search;
-    url.hash = old.hash;
-  }
+  // The native resolver also resolves symbolic links in the path of the result,
+  // unless they are preserved.
+  const url = moduleWrapResolve(specifier, parentURL,
+                                isMain ? !preserveSymlinksMain :
+                                  !preserveSymlinks);
 
-  return { url: `${url}` };
+  return { url };
 }
 exports.defaultResolve = defaultResolve;
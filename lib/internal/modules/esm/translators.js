@@ -13,7 +13,10 @@ const {
   stripBOM,
   loadNativeModule
 } = require('internal/modules/cjs/helpers');
-const CJSModule = require('internal/modules/cjs/loader').Module;
+const {
+  Module: CJSModule,
+  getLoadedExports,
+} = require('internal/modules/cjs/loader');
 const internalURLModule = require('internal/url');
 const { defaultGetSource } = require(
   'internal/modules/esm/get_source');
@@ -25,6 +28,7 @@ const { fileURLToPath, URL } = require('url');
 const { debuglog } = require('internal/util/debuglog');
 const { emitExperimentalWarning } = require('internal/util');
 const { ERR_UNKNOWN_BUILTIN_MODULE } = require('internal/errors').codes;
+const compileCache = require('internal/modules/compile_cache');
 const { maybeCacheSourceMap } = require('internal/source_map/source_map_cache');
 const moduleWrap = internalBinding('module_wrap');
 const { ModuleWrap } = moduleWrap;
@@ -69,6 +73,26 @@ function initializeImportMeta(meta, { url }) {
   meta.url = url;
 }
 
+function compileModule(url, source) {
+  const cacheEntry = compileCache.lookup('esm', source);
+  if (cacheEntry === undefined)
+    return new ModuleWrap(url, undefined, source, 0, 0);
+  if (cacheEntry.cachedData !== undefined) {
+    try {
+      return new ModuleWrap(url, undefined, source, 0, 0,
+                            cacheEntry.cachedData);
+    } catch (err) {
+      if (err.code !== 'ERR_VM_MODULE_CACHED_DATA_REJECTED')
+        throw err;
+    }
+  }
+  const module = new ModuleWrap(url, undefined, source, 0, 0);
+  // The code cache of a module can only be created before it is evaluated.
+  const cachedData = module.createCachedData();
+  compileCache.save(cacheEntry, () => cachedData);
+  return module;
+}
+
 // Strategy for loading a standard JavaScript module
 translators.set('module', async function moduleStrategy(url) {
   let { source } = await this._getSource(
@@ -78,7 +102,7 @@ translators.set('module', async function moduleStrategy(url) {
     source, { url, format: 'module' }, defaultTransformSource));
   maybeCacheSourceMap(url, source);
   debug(`Translating StandardModule ${url}`);
-  const module = new ModuleWrap(url, undefined, source, 0, 0);
+  const module = compileModule(url, source);
   moduleWrap.callbackMap.set(module, {
     initializeImportMeta,
     importModuleDynamically,
@@ -101,7 +125,7 @@ translators.set('commonjs', function commonjsStrategy(url, isMain) {
     isWindows ? StringPrototypeReplace(pathname, winSepRegEx, '\\') : pathname
   ];
   if (module && module.loaded) {
-    const exports = module.exports;
+    const exports = getLoadedExports(module);
     return new ModuleWrap(url, undefined, ['default'], function() {
       this.setExport('default', exports);
     });
@@ -55,6 +55,11 @@ function evalModule(source, print) {
   });
 }
 
+// The ESM loader is only loaded once it is used.
+function getESMLoader() {
+  return require('internal/process/esm_loader').ESMLoader;
+}
+
 function evalScript(name, body, breakFirstLine, print) {
   const CJSModule = require('internal/modules/cjs/loader').Module;
   const { kVmBreakFirstLineSymbol } = require('internal/util');
@@ -68,7 +73,7 @@ function evalScript(name, body, breakFirstLine, print) {
   module.paths = CJSModule._nodeModulePaths(cwd);
 
   global.kVmBreakFirstLineSymbol = kVmBreakFirstLineSymbol;
-  global.asyncESM = require('internal/process/esm_loader');
+  global.getESMLoader = getESMLoader;
 
   const baseUrl = pathToFileURL(module.filename).href;
 
@@ -78,16 +83,16 @@ function evalScript(name, body, breakFirstLine, print) {
     global.module = module;
     global.__dirname = __dirname;
     global.require = require;
-    const { kVmBreakFirstLineSymbol, asyncESM } = global;
+    const { kVmBreakFirstLineSymbol, getESMLoader } = global;
     delete global.kVmBreakFirstLineSymbol;
-    delete global.asyncESM;
+    delete global.getESMLoader;
     return require("vm").runInThisContext(
       ${JSONStringify(body)}, {
         filename: ${JSONStringify(name)},
         displayErrors: true,
         [kVmBreakFirstLineSymbol]: ${!!breakFirstLine},
         async importModuleDynamically (specifier) {
-          const loader = await asyncESM.ESMLoader;
+          const loader = await getESMLoader();
           return loader.import(specifier, ${JSONStringify(baseUrl)});
         }
       });\n`;
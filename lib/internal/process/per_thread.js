@@ -37,6 +37,9 @@ function assert(x, msg) {
   if (!x) throw new ERR_ASSERTION(msg || 'assertion error');
 }
 
+// How often process.memoryStats is updated, in milliseconds.
+const kMemoryStatsInterval = 5000;
+
 // The execution of this function itself should not cause any side effects.
 function wrapProcessMethods(binding) {
   const {
@@ -44,7 +47,9 @@ function wrapProcessMethods(binding) {
     hrtimeBigInt: _hrtimeBigInt,
     cpuUsage: _cpuUsage,
     memoryUsage: _memoryUsage,
-    resourceUsage: _resourceUsage
+    rss,
+    resourceUsage: _resourceUsage,
+    MemoryStatsSampler
   } = binding;
 
   function _rawDebug(...args) {
@@ -146,7 +151,7 @@ function wrapProcessMethods(binding) {
     return hrBigintValues[0];
   }
 
-  const memValues = new Float64Array(5);
+  const memValues = new Float64Array(7);
   function memoryUsage() {
     _memoryUsage(memValues);
     return {
@@ -154,10 +159,33 @@ function wrapProcessMethods(binding) {
       heapTotal: memValues[1],
       heapUsed: memValues[2],
       external: memValues[3],
-      arrayBuffers: memValues[4]
+      arrayBuffers: memValues[4],
+      bufferPoolReserved: memValues[5],
+      bufferPoolUsed: memValues[6]
     };
   }
 
+  memoryUsage.rss = rss;
+
+  // process.memoryStats is sampled by a native timer once it was first
+  // accessed, so that reading its properties does not call into C++.
+  let memoryStats;
+  function getMemoryStats() {
+    if (memoryStats === undefined) {
+      const sampler = new MemoryStatsSampler(kMemoryStatsInterval);
+      const { fields } = sampler;
+      sampler.start();
+      memoryStats = ObjectFreeze({
+        get rss() { return fields[0]; },
+        get heapTotal() { return fields[1]; },
+        get heapUsed() { return fields[2]; },
+        get external() { return fields[3]; },
+        get arrayBuffers() { return fields[4]; }
+      });
+    }
+    return memoryStats;
+  }
+
   function exit(code) {
     if (code || code === 0)
       process.exitCode = code;
@@ -231,6 +259,7 @@ function wrapProcessMethods(binding) {
     cpuUsage,
     resourceUsage,
     memoryUsage,
+    getMemoryStats,
     kill,
     exit
   };
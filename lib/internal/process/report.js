@@ -1,15 +1,26 @@
 'use strict';
 const {
-  ERR_INVALID_ARG_TYPE,
-  ERR_SYNTHETIC
-} = require('internal/errors').codes;
+  codes: {
+    ERR_INVALID_ARG_TYPE,
+    ERR_INVALID_CALLBACK,
+    ERR_SYNTHETIC
+  },
+  uvException
+} = require('internal/errors');
 const { validateSignalName, validateString } = require('internal/validators');
 const nr = internalBinding('report');
 const {
   JSONParse,
 } = primordials;
 const report = {
-  writeReport(file, err) {
+  writeReport(file, err, callback) {
+    if (typeof file === 'function') {
+      callback = file;
+      file = err = undefined;
+    } else if (typeof err === 'function') {
+      callback = err;
+      err = undefined;
+    }
     if (typeof file === 'object' && file !== null) {
       err = file;
       file = undefined;
@@ -21,7 +32,18 @@ const report = {
       throw new ERR_INVALID_ARG_TYPE('err', 'Object', err);
     }
 
-    return nr.writeReport('JavaScript API', 'API', file, err.stack);
+    if (callback === undefined)
+      return nr.writeReport('JavaScript API', 'API', file, err.stack);
+
+    if (typeof callback !== 'function')
+      throw new ERR_INVALID_CALLBACK(callback);
+    const req = new nr.ReportWriteReq();
+    req.oncomplete = (errno, syscall, filename) => {
+      if (errno !== 0)
+        return callback(uvException({ errno, syscall, path: filename }));
+      callback(null, filename);
+    };
+    nr.writeReport('JavaScript API', 'API', file, err.stack, req);
   },
   getReport(err) {
     if (err === undefined)
@@ -74,6 +96,15 @@ const report = {
     removeSignalHandler();
     addSignalHandler();
   },
+  get excludeHandles() {
+    return nr.shouldExcludeHandles();
+  },
+  set excludeHandles(exclude) {
+    if (typeof exclude !== 'boolean')
+      throw new ERR_INVALID_ARG_TYPE('exclude', 'boolean', exclude);
+
+    nr.setExcludeHandles(exclude);
+  },
   get reportOnUncaughtException() {
     return nr.shouldReportOnUncaughtException();
   },
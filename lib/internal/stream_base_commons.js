@@ -2,12 +2,15 @@
 
 const {
   Array,
+  MathMin,
+  Promise,
   Symbol,
 } = primordials;
 
 const { Buffer } = require('buffer');
 const { FastBuffer } = require('internal/buffer');
 const {
+  SendFileWrap,
   WriteWrap,
   kReadBytesOrError,
   kArrayBufferOffset,
@@ -18,7 +21,8 @@ const {
 const { UV_EOF } = internalBinding('uv');
 const {
   codes: {
-    ERR_INVALID_CALLBACK
+    ERR_INVALID_CALLBACK,
+    ERR_STREAM_DESTROYED
   },
   errnoException
 } = require('internal/errors');
@@ -36,11 +40,16 @@ const kUpdateTimer = Symbol('kUpdateTimer');
 const kAfterAsyncWrite = Symbol('kAfterAsyncWrite');
 const kHandle = Symbol('kHandle');
 const kSession = Symbol('kSession');
+const kSendFileRequest = Symbol('kSendFileRequest');
+
+// Chunk size used to copy file data when the handle cannot use sendfile(2).
+const kSendFileBufferLength = 64 * 1024;
 
 const debug = require('internal/util/debuglog').debuglog('stream');
 const kBuffer = Symbol('kBuffer');
 const kBufferGen = Symbol('kBufferGen');
 const kBufferCb = Symbol('kBufferCb');
+const kLines = Symbol('kLines');
 
 function handleWriteReq(req, data, encoding) {
   const { handle } = req;
@@ -146,6 +155,97 @@ function writeGeneric(self, data, encoding, cb) {
   return req;
 }
 
+// `request` is `{ fd, offset, length, bytesWritten }`, where a `length` of
+// -1 means up to the end of the file. Handles that support it send the data
+// with sendfile(2); others, such as TLS sockets, copy it through a Buffer.
+function sendFileGeneric(self, request, cb) {
+  const handle = self[kHandle];
+  if (typeof handle.sendFile !== 'function')
+    return sendFileBuffered(self, request, cb);
+
+  const req = new SendFileWrap();
+  req.handle = handle;
+  req.oncomplete = onSendFileComplete;
+  req.request = request;
+  req.callback = cb;
+  const err = handle.sendFile(req, request.fd, request.offset, request.length);
+  if (err !== 0)
+    self.destroy(errnoException(err, 'sendfile'), cb);
+}
+
+function onSendFileComplete(status, bytes) {
+  const stream = this.handle[owner_symbol];
+  this.request.bytesWritten += bytes;
+
+  if (stream.destroyed) {
+    // Closing the handle cancels the transfer, unless it had completed.
+    this.callback(status < 0 ? new ERR_STREAM_DESTROYED('write') : null);
+    return;
+  }
+
+  if (status < 0) {
+    stream.destroy(errnoException(status, 'sendfile'), this.callback);
+    return;
+  }
+
+  stream[kUpdateTimer]();
+  this.callback(null);
+}
+
+// Queues sending a file range on a net.Socket like any other write, so that
+// it is ordered with the writes around it. The write is a zero-length chunk
+// that carries the request; Socket.prototype._writeGeneric() recognizes it.
+// Resolves with the number of bytes sent.
+function sendFile(socket, fd, offset, length) {
+  return new Promise((resolve, reject) => {
+    const request = { fd, offset, length, bytesWritten: 0 };
+    const chunk = new FastBuffer();
+    chunk[kSendFileRequest] = request;
+    socket.write(chunk, (err) => {
+      if (err)
+        reject(err);
+      else
+        resolve(request.bytesWritten);
+    });
+  });
+}
+
+function sendFileBuffered(self, request, cb) {
+  const { read } = require('fs');
+  const buffer = Buffer.allocUnsafe(request.length < 0 ?
+    kSendFileBufferLength :
+    MathMin(request.length, kSendFileBufferLength));
+
+  function readChunk() {
+    const length = request.length < 0 ?
+      buffer.length :
+      MathMin(buffer.length, request.length - request.bytesWritten);
+    if (length === 0)
+      return cb();
+    read(request.fd, buffer, 0, length, request.offset + request.bytesWritten,
+         onRead);
+  }
+
+  function onRead(err, bytesRead) {
+    if (err)
+      return cb(err);
+    if (bytesRead === 0)
+      return cb();
+    if (self.destroyed || !self[kHandle])
+      return cb(new ERR_STREAM_DESTROYED('write'));
+    // The buffer is reused once the write has completed.
+    const chunk = new FastBuffer(buffer.buffer, buffer.byteOffset, bytesRead);
+    writeGeneric(self, chunk, 'buffer', (err) => {
+      if (err)
+        return cb(err);
+      request.bytesWritten += bytesRead;
+      readChunk();
+    });
+  }
+
+  readChunk();
+}
+
 function afterWriteDispatched(self, req, err, cb) {
   req.bytes = streamBaseState[kBytesWritten];
   req.async = !!streamBaseState[kLastWriteWasAsync];
@@ -180,6 +280,10 @@ function onStreamRead(arrayBuffer) {
         if (isUint8Array(nextBuf))
           stream[kBuffer] = ret = nextBuf;
       }
+    } else if (stream[kLines]) {
+      // The native line splitter passes an array of lines instead.
+      const lines = arrayBuffer;
+      result = (lines.length === 0 || stream[kBufferCb](lines) !== false);
     } else {
       const offset = streamBaseState[kArrayBufferOffset];
       const buf = new FastBuffer(arrayBuffer, offset, nread);
@@ -257,14 +361,18 @@ module.exports = {
   createWriteWrap,
   writevGeneric,
   writeGeneric,
+  sendFile,
+  sendFileGeneric,
   onStreamRead,
   kAfterAsyncWrite,
   kMaybeDestroy,
   kUpdateTimer,
   kHandle,
   kSession,
+  kSendFileRequest,
   setStreamTimeout,
   kBuffer,
   kBufferCb,
-  kBufferGen
+  kBufferGen,
+  kLines
 };
@@ -20,6 +20,7 @@ const kEnded = Symbol('ended');
 const kLastPromise = Symbol('lastPromise');
 const kHandlePromise = Symbol('handlePromise');
 const kStream = Symbol('stream');
+const kBatch = Symbol('batch');
 
 let Readable;
 
@@ -27,10 +28,16 @@ function createIterResult(value, done) {
   return { value, done };
 }
 
+// In batch mode, every result is an array of all chunks that were buffered.
+function readChunk(iter) {
+  const stream = iter[kStream];
+  return iter[kBatch] ? stream.readv() : stream.read();
+}
+
 function readAndResolve(iter) {
   const resolve = iter[kLastResolve];
   if (resolve !== null) {
-    const data = iter[kStream].read();
+    const data = readChunk(iter);
     // We defer if data is null. We can be expecting either 'end' or 'error'.
     if (data !== null) {
       iter[kLastPromise] = null;
@@ -124,7 +131,7 @@ const ReadableStreamAsyncIteratorPrototype = ObjectSetPrototypeOf({
     } else {
       // Fast path needed to support multiple this.push()
       // without triggering the next() queue.
-      const data = this[kStream].read();
+      const data = readChunk(this);
       if (data !== null) {
         return PromiseResolve(createIterResult(data, false));
       }
@@ -146,7 +153,7 @@ const ReadableStreamAsyncIteratorPrototype = ObjectSetPrototypeOf({
   },
 }, AsyncIteratorPrototype);
 
-const createReadableStreamAsyncIterator = (stream) => {
+const createReadableStreamAsyncIterator = (stream, batch = false) => {
   if (typeof stream.read !== 'function') {
     // v1 stream
 
@@ -161,6 +168,7 @@ const createReadableStreamAsyncIterator = (stream) => {
 
   const iterator = ObjectCreate(ReadableStreamAsyncIteratorPrototype, {
     [kStream]: { value: stream, writable: true },
+    [kBatch]: { value: batch },
     [kLastResolve]: { value: null, writable: true },
     [kLastReject]: { value: null, writable: true },
     [kError]: { value: null, writable: true },
@@ -172,7 +180,7 @@ const createReadableStreamAsyncIterator = (stream) => {
     // closure at every run.
     [kHandlePromise]: {
       value: (resolve, reject) => {
-        const data = iterator[kStream].read();
+        const data = readChunk(iterator);
         if (data) {
           iterator[kLastPromise] = null;
           iterator[kLastResolve] = null;
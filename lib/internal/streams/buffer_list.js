@@ -1,11 +1,18 @@
 'use strict';
 
 const {
+  Array,
   SymbolIterator,
 } = primordials;
 
 const { Buffer } = require('buffer');
 const { inspect } = require('internal/util/inspect');
+const { joinStrings } = internalBinding('string_decoder');
+const { kStringMaxLength } = internalBinding('buffer');
+
+// Below this length, V8 creates flat strings when concatenating anyway, or
+// flattening the result later is cheaper than the call into C++.
+const kNativeJoinMinLength = 1024;
 
 module.exports = class BufferList {
   constructor() {
@@ -49,9 +56,36 @@ module.exports = class BufferList {
     this.length = 0;
   }
 
+  // Removes all entries and returns their data as an array.
+  drain() {
+    const ret = new Array(this.length);
+    let i = 0;
+    for (let p = this.head; p; p = p.next)
+      ret[i++] = p.data;
+    this.clear();
+    return ret;
+  }
+
   join(s) {
     if (this.length === 0)
       return '';
+    if (s === '' && this.length > 1) {
+      // Join decoded chunks into a flat string in one go.
+      const strings = [];
+      let length = 0;
+      for (let p = this.head; p; p = p.next) {
+        if (typeof p.data !== 'string')
+          break;
+        strings.push(p.data);
+        length += p.data.length;
+      }
+      // Results that are too long are left to the concatenation below, which
+      // throws the usual error.
+      if (strings.length === this.length && length >= kNativeJoinMinLength &&
+          length <= kStringMaxLength) {
+        return joinStrings(strings);
+      }
+    }
     let p = this.head;
     let ret = '' + p.data;
     while (p = p.next)
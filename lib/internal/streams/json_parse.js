@@ -0,0 +1,50 @@
+'use strict';
+
+const {
+  SymbolAsyncIterator,
+} = primordials;
+
+const { Buffer } = require('buffer');
+const { JSONStreamParser } = internalBinding('json_parser');
+const {
+  ERR_INVALID_ARG_TYPE,
+} = require('internal/errors').codes;
+const { isArrayBufferView } = require('internal/util/types');
+const {
+  validateObject,
+  validateUint32,
+} = require('internal/validators');
+
+async function* readValues(source, parser) {
+  for await (const chunk of source) {
+    let values;
+    if (typeof chunk === 'string') {
+      values = parser.push(Buffer.from(chunk));
+    } else if (isArrayBufferView(chunk)) {
+      values = parser.push(chunk);
+    } else {
+      throw new ERR_INVALID_ARG_TYPE(
+        'chunk', ['string', 'Buffer', 'TypedArray', 'DataView'], chunk);
+    }
+    for (let i = 0; i < values.length; i++)
+      yield values[i];
+  }
+  const values = parser.end();
+  for (let i = 0; i < values.length; i++)
+    yield values[i];
+}
+
+// Returns an async iterator over the values that are `depth` containers deep
+// in the JSON text read from `source`. Each value is yielded as soon as it
+// has been read completely, and all values that a chunk completes are parsed
+// by a single native call.
+function parseJSON(source, options = {}) {
+  if (source == null || typeof source[SymbolAsyncIterator] !== 'function')
+    throw new ERR_INVALID_ARG_TYPE('source', 'AsyncIterable', source);
+  validateObject(options, 'options');
+  const { depth = 1 } = options;
+  validateUint32(depth, 'options.depth');
+  return readValues(source, new JSONStreamParser(depth));
+}
+
+module.exports = parseJSON;
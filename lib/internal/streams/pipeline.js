@@ -24,6 +24,9 @@ const {
 let EE;
 let PassThrough;
 let createReadableStreamAsyncIterator;
+let Pipe;
+let StreamPipe;
+let TCP;
 
 function destroyer(stream, reading, writing, callback) {
   callback = once(callback);
@@ -52,6 +55,118 @@ function destroyer(stream, reading, writing, callback) {
   };
 }
 
+// Returns the handle of a socket that is connected over TCP or a pipe, if it
+// can be piped natively. Data that a readable socket has already buffered is
+// written to the destination before the native pipe starts.
+function getPipeableHandle(stream, reading) {
+  const handle = stream._handle;
+  if (handle == null || stream.connecting || stream.destroyed)
+    return;
+  if (TCP === undefined) {
+    ({ Pipe } = internalBinding('pipe_wrap'));
+    ({ TCP } = internalBinding('tcp_wrap'));
+  }
+  if (!(handle instanceof TCP) && !(handle instanceof Pipe))
+    return;
+  // Timeouts are only refreshed by reads and writes in JS.
+  if (stream.timeout)
+    return;
+
+  if (reading) {
+    const state = stream._readableState;
+    // Data that is consumed in JS as well would not reach it.
+    if (state.ended || state.decoder !== null ||
+        stream.listenerCount('data') > 0) {
+      return;
+    }
+  } else {
+    const state = stream._writableState;
+    if (state.length !== 0 || state.ending || state.corked)
+      return;
+  }
+  return handle;
+}
+
+// Pipes `source` into `destination` with a native StreamPipe if both are
+// sockets, so that no JS runs for each chunk. The StreamPipe does not end
+// `destination` itself, so that it ends through JS, as with pipe().
+function pipeNatively(source, destination) {
+  const sourceHandle = getPipeableHandle(source, true);
+  const destinationHandle =
+    sourceHandle && getPipeableHandle(destination, false);
+  if (destinationHandle === undefined)
+    return false;
+
+  if (StreamPipe === undefined)
+    ({ StreamPipe } = internalBinding('stream_pipe'));
+  // This is passed on to the handle before the StreamPipe is created, so it
+  // is written first.
+  if (source.readableLength > 0)
+    destination.write(source.read());
+  const pipe = new StreamPipe(sourceHandle, destinationHandle, false);
+  pipe.onunpipe = () => {
+    if (destination.destroyed)
+      return;
+    // If the source did not end, writing to the destination failed.
+    if (source._readableState.ended)
+      destination.end();
+    else
+      destination.destroy();
+  };
+  pipe.start();
+  return true;
+}
+
+// Pipes `source` through the zlib or brotli stream `transform` into
+// `destination` natively, if both ends are sockets that can be piped natively.
+// `transform` never emits 'end' or 'finish' then, because no data passes
+// through it in JS; it is closed once all data has been written.
+function pipeThroughNatively(source, transform, destination, wrap, destroys,
+                             finish) {
+  const handle = transform != null ? transform._handle : undefined;
+  if (handle == null || typeof handle.startPipe !== 'function')
+    return false;
+  const readableState = transform._readableState;
+  const writableState = transform._writableState;
+  if (transform.destroyed || transform.bytesWritten !== 0 ||
+      readableState.length !== 0 || readableState.ended ||
+      writableState.length !== 0 || writableState.ending ||
+      transform.listenerCount('data') > 0) {
+    return false;
+  }
+  // Buffered data would have to pass through `transform` in JS.
+  if (source.readableLength !== 0)
+    return false;
+  const sourceHandle = getPipeableHandle(source, true);
+  const destinationHandle =
+    sourceHandle && getPipeableHandle(destination, false);
+  if (destinationHandle === undefined)
+    return false;
+
+  wrap(source, true, false, false);
+  wrap(destination, false, true, true);
+  destroys.push((err) => destroyImpl.destroyer(transform, err));
+  transform.on('error', finish);
+
+  handle.onunpipe = (status) => {
+    if (destination.destroyed)
+      return;
+    if (status === 0) {
+      // The source ended, or the compressed data did.
+      if (!source._readableState.ended)
+        source.resume();
+      destination.end();
+      transform.destroy();
+    } else {
+      destination.destroy();
+    }
+  };
+  handle.startPipe(sourceHandle, destinationHandle,
+                   transform._defaultFlushFlag, transform._finishFlushFlag,
+                   transform._chunkSize);
+  return true;
+}
+
 function popCallback(streams) {
   // Streams should never be an empty array. It should always contain at least
   // a single stream. Therefore optimize for the average case instead of
@@ -156,6 +271,13 @@ function pipeline(...streams) {
     }));
   }
 
+  if (streams.length === 3 &&
+      isReadable(streams[0]) && isWritable(streams[2]) &&
+      pipeThroughNatively(streams[0], streams[1], streams[2], wrap, destroys,
+                          finish)) {
+    return streams[2];
+  }
+
   let ret;
   for (let i = 0; i < streams.length; i++) {
     const stream = streams[i];
@@ -216,7 +338,8 @@ function pipeline(...streams) {
       }
     } else if (isStream(stream)) {
       if (isReadable(ret)) {
-        ret.pipe(stream);
+        if (!pipeNatively(ret, stream))
+          ret.pipe(stream);
       } else {
         ret = makeAsyncIterable(ret);
         pump(ret, stream, finish);
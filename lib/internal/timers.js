@@ -71,9 +71,18 @@
 // Timeout lists and the object map lookup of a specific list by the duration of
 // timers within (or creation of a new list). However, these operations combined
 // have shown to be trivial in comparison to other timers architectures.
+//
+// That stops being true when there are very many distinct durations, e.g. for
+// per-request timeouts with added jitter, because every duration gets a list
+// of its own. Timers created with `setCoarseTimeout()` therefore have their
+// duration rounded up to one of relatively few values, see coarseDuration(),
+// so that they share lists with timers of a similar duration.
 
 const {
+  MathCeil,
+  MathClz32,
   MathMax,
+  MathMin,
   MathTrunc,
   NumberMIN_SAFE_INTEGER,
   ObjectCreate,
@@ -92,6 +101,7 @@ const {
   newAsyncId,
   initHooksExist,
   destroyHooksExist,
+  inheritAsyncContextFrame,
   // The needed emit*() functions.
   emitInit,
   emitBefore,
@@ -123,6 +133,9 @@ const kHasOutstanding = 2;
 // Timeout values > TIMEOUT_MAX are set to 1.
 const TIMEOUT_MAX = 2 ** 31 - 1;
 
+// The number of significant bits that coarse durations keep.
+const kCoarseBits = 6;
+
 let timerListId = NumberMIN_SAFE_INTEGER;
 
 const kRefed = Symbol('refed');
@@ -149,6 +162,7 @@ function initAsyncResource(resource, type) {
   const asyncId = resource[async_id_symbol] = newAsyncId();
   const triggerAsyncId =
     resource[trigger_async_id_symbol] = getDefaultTriggerAsyncId();
+  inheritAsyncContextFrame(resource);
   if (initHooksExist())
     emitInit(asyncId, type, triggerAsyncId, resource);
 }
@@ -359,6 +373,19 @@ function insert(item, msecs, start = getLibuvNow()) {
   L.append(list, item);
 }
 
+// Rounds a duration up so that only its `kCoarseBits` most significant bits
+// can be set. This delays a timer by less than 1/32 of its duration, and
+// leaves at most 32 distinct durations between each power of two, e.g.
+// durations between 16384 and 32767 ms are rounded up to multiples of 512 ms.
+function coarseDuration(msecs) {
+  msecs = MathTrunc(msecs);
+  const shift = 32 - MathClz32(msecs) - kCoarseBits;
+  if (shift <= 0)
+    return msecs;
+  const step = 2 ** shift;
+  return MathMin(MathCeil(msecs / step) * step, TIMEOUT_MAX);
+}
+
 function setUnrefTimeout(callback, after) {
   // Type checking identical to setTimeout()
   if (typeof callback !== 'function') {
@@ -595,6 +622,7 @@ module.exports = {
   trigger_async_id_symbol,
   Timeout,
   kRefed,
+  coarseDuration,
   initAsyncResource,
   setUnrefTimeout,
   getTimerDuration,
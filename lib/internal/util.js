@@ -170,6 +170,11 @@ function slowCases(enc) {
         `${enc}`.toLowerCase() === 'utf-16le')
         return 'utf16le';
       break;
+    case 9:
+      if (enc === 'base64url' || enc === 'BASE64URL' ||
+        `${enc}`.toLowerCase() === 'base64url')
+        return 'base64url';
+      break;
     default:
       if (enc === '') return 'utf8';
   }
@@ -435,5 +440,7 @@ module.exports = {
   // Used by the buffer module to capture an internal reference to the
   // default isEncoding implementation, just in case userland overrides it.
   kIsEncodingSymbol: Symbol('kIsEncodingSymbol'),
+  // Used by streams to get EventEmitter's internal emitOne() helper.
+  kEmitOne: Symbol('kEmitOne'),
   kVmBreakFirstLineSymbol: Symbol('kVmBreakFirstLineSymbol')
 };
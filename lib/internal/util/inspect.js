@@ -1764,7 +1764,7 @@ function tryStringify(arg) {
 }
 
 function format(...args) {
-  return formatWithOptionsInternal(undefined, ...args);
+  return formatWithOptionsInternal(undefined, args);
 }
 
 function formatWithOptions(inspectOptions, ...args) {
@@ -1772,10 +1772,38 @@ function formatWithOptions(inspectOptions, ...args) {
     throw new ERR_INVALID_ARG_TYPE(
       'inspectOptions', 'object', inspectOptions);
   }
-  return formatWithOptionsInternal(inspectOptions, ...args);
+  return formatWithOptionsInternal(inspectOptions, args);
 }
 
-function formatWithOptionsInternal(inspectOptions, ...args) {
+// Whether inspect() would style primitives with these options.
+function usesStylize(inspectOptions) {
+  if (inspectOptions === undefined)
+    return !!inspectDefaultOptions.colors;
+  if (inspectOptions.stylize !== undefined)
+    return true;
+  return inspectOptions.colors !== undefined ?
+    !!inspectOptions.colors : !!inspectDefaultOptions.colors;
+}
+
+// Returns what inspect() returns for a primitive other than a string when
+// colors are off, or undefined for strings and objects.
+function formatPlainPrimitive(value) {
+  switch (typeof value) {
+    case 'number':
+      return formatNumber(stylizeNoColor, value);
+    case 'boolean':
+    case 'undefined':
+      return `${value}`;
+    case 'bigint':
+      return formatBigInt(stylizeNoColor, value);
+    case 'symbol':
+      return SymbolPrototypeToString(value);
+    case 'object':
+      return value === null ? 'null' : undefined;
+  }
+}
+
+function formatWithOptionsInternal(inspectOptions, args) {
   const first = args[0];
   let a = 0;
   let str = '';
@@ -1885,10 +1913,21 @@ function formatWithOptionsInternal(inspectOptions, ...args) {
     }
   }
 
+  // Primitives are formatted here rather than through inspect(), which would
+  // first build its context from the options.
+  let plain;
   while (a < args.length) {
     const value = args[a];
     str += join;
-    str += typeof value !== 'string' ? inspect(value, inspectOptions) : value;
+    if (typeof value === 'string') {
+      str += value;
+    } else {
+      if (plain === undefined)
+        plain = !usesStylize(inspectOptions);
+      const primitive = plain ? formatPlainPrimitive(value) : undefined;
+      str += primitive !== undefined ?
+        primitive : inspect(value, inspectOptions);
+    }
     join = ' ';
     a++;
   }
@@ -2004,6 +2043,7 @@ module.exports = {
   inspect,
   format,
   formatWithOptions,
+  formatWithOptionsInternal,
   getStringWidth,
   inspectDefaultOptions,
   stripVTControlCharacters
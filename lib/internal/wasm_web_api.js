@@ -0,0 +1,74 @@
+'use strict';
+
+const {
+  NumberPrototypeToString,
+} = primordials;
+
+const { Buffer } = require('buffer');
+const {
+  codes: {
+    ERR_INVALID_ARG_TYPE
+  }
+} = require('internal/errors');
+const { FileHandle } = require('internal/fs/promises');
+const compileCache = require('internal/modules/compile_cache');
+const { hash } = internalBinding('wasm_web_api');
+
+const kChunkSize = 64 * 1024;
+
+let createHash;
+
+// V8 only checks that a cached module was created by the same V8 version and
+// flags, not that it was compiled from the same bytes, so modules are looked
+// up by a SHA-256 of their bytes, like the other compile cache entries.
+function getCacheKey(bytes) {
+  if (process.versions.openssl) {
+    if (createHash === undefined)
+      createHash = require('crypto').createHash;
+    return `wasm-${createHash('sha256').update(bytes).digest('hex')}`;
+  }
+  return `wasm-${NumberPrototypeToString(bytes.length, 16)}-${hash(bytes)}`;
+}
+
+// Feeds the bytes read from the current position of the FileHandle to the
+// compiler as they arrive.
+async function streamChunks(fileHandle, streaming) {
+  const buffer = Buffer.allocUnsafe(kChunkSize);
+  for (;;) {
+    const { bytesRead } =
+      await fileHandle.read(buffer, 0, kChunkSize, null);
+    if (bytesRead === 0)
+      break;
+    // The chunk is copied by V8, so the buffer can be reused.
+    streaming.push(buffer.subarray(0, bytesRead));
+  }
+  streaming.finish();
+}
+
+// Reads the whole module first, so that it can be looked up in the compile
+// cache by the hash of its bytes. Modules that are not in the cache are
+// serialized once they have been compiled by the top tier.
+async function streamCached(fileHandle, streaming) {
+  const bytes = await fileHandle.readFile();
+  const entry = compileCache.read(getCacheKey(bytes));
+  if (entry.cachedData === undefined ||
+      !streaming.setCompiledModuleBytes(entry.cachedData)) {
+    streaming.keepCompiledModule();
+    compileCache.save(entry, () => streaming.serialize());
+  }
+  streaming.push(bytes);
+  streaming.finish();
+}
+
+// The implementation of WebAssembly.compileStreaming() and
+// WebAssembly.instantiateStreaming(), whose source must be a FileHandle.
+function compileStreaming(source, streaming) {
+  if (!(source instanceof FileHandle))
+    throw new ERR_INVALID_ARG_TYPE('source', 'FileHandle', source);
+  const stream = compileCache.isEnabled() ? streamCached : streamChunks;
+  stream(source, streaming).catch((err) => streaming.abort(err));
+}
+
+module.exports = {
+  compileStreaming
+};
@@ -0,0 +1,218 @@
+'use strict';
+
+const {
+  ObjectDefineProperty,
+  Symbol,
+} = primordials;
+
+const EventEmitter = require('events');
+const { Buffer } = require('buffer');
+const {
+  codes: {
+    ERR_INVALID_ARG_TYPE,
+    ERR_INVALID_ARG_VALUE,
+    ERR_INVALID_WEBSOCKET_FRAME
+  }
+} = require('internal/errors');
+const {
+  validateBoolean,
+  validateInteger,
+  validateObject
+} = require('internal/validators');
+const { isArrayBufferView } = require('internal/util/types');
+const { owner_symbol } = require('internal/async_hooks').symbols;
+const binding = internalBinding('websocket');
+
+const kHandle = Symbol('kHandle');
+const kThreshold = Symbol('kThreshold');
+const kDeflate = Symbol('kDeflate');
+
+const kContinuation = 0x0;
+const kText = 0x1;
+const kBinary = 0x2;
+const kClose = 0x8;
+const kPing = 0x9;
+const kPong = 0xa;
+
+const kDefaultMaxPayload = 100 * 1024 * 1024;
+
+function getDeflateOptions(perMessageDeflate) {
+  if (perMessageDeflate === false)
+    return null;
+  if (perMessageDeflate === true)
+    perMessageDeflate = {};
+  validateObject(perMessageDeflate, 'options.perMessageDeflate');
+  const {
+    noContextTakeover = false,
+    windowBits = 15,
+    threshold = 1024
+  } = perMessageDeflate;
+  validateBoolean(noContextTakeover,
+                  'options.perMessageDeflate.noContextTakeover');
+  validateInteger(windowBits, 'options.perMessageDeflate.windowBits', 9, 15);
+  validateInteger(threshold, 'options.perMessageDeflate.threshold', 0);
+  return { noContextTakeover, windowBits, threshold };
+}
+
+function onmessage(opcode, data) {
+  const receiver = this[owner_symbol];
+  switch (opcode) {
+    case kText:
+    case kBinary:
+      receiver.emit('message', data, opcode === kBinary);
+      break;
+    case kPing:
+      receiver.emit('ping', data);
+      break;
+    case kPong:
+      receiver.emit('pong', data);
+      break;
+    case kClose:
+      if (data.length === 0)
+        receiver.emit('close', 1005, '');
+      else
+        receiver.emit('close', data.readUInt16BE(0), data.toString('utf8', 2));
+      break;
+  }
+}
+
+function onerror(message, closeCode) {
+  const err = new ERR_INVALID_WEBSOCKET_FRAME(message);
+  err.closeCode = closeCode;
+  this[owner_symbol].emit('error', err);
+}
+
+// Reads WebSocket frames from a socket natively, after the opening handshake
+// has completed. Messages are unmasked, reassembled from their fragments and
+// decompressed before they are emitted.
+class WebSocketReceiver extends EventEmitter {
+  constructor(socket, options = {}) {
+    super();
+    validateObject(options, 'options');
+    const {
+      isServer = true,
+      maxPayload = kDefaultMaxPayload,
+      perMessageDeflate = false,
+      head
+    } = options;
+    validateBoolean(isServer, 'options.isServer');
+    validateInteger(maxPayload, 'options.maxPayload', 0);
+    const deflate = getDeflateOptions(perMessageDeflate);
+    if (head !== undefined && !isArrayBufferView(head)) {
+      throw new ERR_INVALID_ARG_TYPE(
+        'options.head', ['Buffer', 'TypedArray', 'DataView'], head);
+    }
+
+    const handle = socket != null ? socket._handle : undefined;
+    if (handle == null || typeof handle.readStart !== 'function' ||
+        socket._readableState.decoder !== null) {
+      throw new ERR_INVALID_ARG_VALUE(
+        'socket', socket, 'must be a connected socket without an encoding');
+    }
+
+    this[kHandle] = new binding.WebSocketReceiver(
+      handle, isServer, maxPayload, deflate !== null,
+      deflate !== null && deflate.noContextTakeover);
+    this[kHandle][owner_symbol] = this;
+    this[kHandle].onmessage = onmessage;
+    this[kHandle].onerror = onerror;
+
+    // Data that was read before the receiver was attached is parsed once
+    // listeners have been added.
+    const buffered = [];
+    if (head !== undefined && head.byteLength > 0)
+      buffered.push(head);
+    let chunk;
+    while ((chunk = socket.read()) !== null)
+      buffered.push(chunk);
+    if (buffered.length > 0) {
+      process.nextTick(() => {
+        for (const chunk of buffered)
+          this[kHandle].push(chunk);
+      });
+    }
+    socket.resume();
+  }
+
+  // Stops reading frames from the socket, which is read in JS again.
+  detach() {
+    this[kHandle].detach();
+  }
+}
+
+// Builds WebSocket frames, each in a single Buffer that can be written to a
+// socket as it is.
+class WebSocketSender {
+  constructor(options = {}) {
+    validateObject(options, 'options');
+    const { mask = false, perMessageDeflate = false } = options;
+    validateBoolean(mask, 'options.mask');
+    const deflate = getDeflateOptions(perMessageDeflate);
+    this[kDeflate] = deflate !== null;
+    this[kThreshold] = deflate !== null ? deflate.threshold : 0;
+    this[kHandle] = new binding.WebSocketSender(
+      mask,
+      deflate !== null,
+      deflate !== null && deflate.noContextTakeover,
+      deflate !== null ? deflate.windowBits : 15);
+  }
+
+  frame(data, options = {}) {
+    const isString = typeof data === 'string';
+    if (!isString && !isArrayBufferView(data)) {
+      throw new ERR_INVALID_ARG_TYPE(
+        'data', ['string', 'Buffer', 'TypedArray', 'DataView'], data);
+    }
+    validateObject(options, 'options');
+    const {
+      opcode = isString ? kText : kBinary,
+      fin = true
+    } = options;
+    let { compress } = options;
+    if (opcode !== kContinuation && opcode !== kText && opcode !== kBinary &&
+        opcode !== kClose && opcode !== kPing && opcode !== kPong) {
+      throw new ERR_INVALID_ARG_VALUE('options.opcode', opcode);
+    }
+    validateBoolean(fin, 'options.fin');
+
+    const length = isString ? Buffer.byteLength(data) : data.byteLength;
+    const isData = opcode === kText || opcode === kBinary;
+    if (opcode >= kClose && (!fin || length > 125)) {
+      throw new ERR_INVALID_ARG_VALUE(
+        'data', data,
+        'must be at most 125 bytes in an unfragmented control frame');
+    }
+    // Only unfragmented messages are compressed.
+    const canCompress = this[kDeflate] && fin && isData;
+    if (compress === undefined) {
+      compress = canCompress && length >= this[kThreshold];
+    } else {
+      validateBoolean(compress, 'options.compress');
+      if (compress && !canCompress) {
+        throw new ERR_INVALID_ARG_VALUE(
+          'options.compress', compress,
+          'is only supported for unfragmented messages with ' +
+          'perMessageDeflate enabled');
+      }
+    }
+    return this[kHandle].frame(data, opcode, fin, compress);
+  }
+}
+
+ObjectDefineProperty(WebSocketSender, 'opcodes', {
+  enumerable: true,
+  value: {
+    CONTINUATION: kContinuation,
+    TEXT: kText,
+    BINARY: kBinary,
+    CLOSE: kClose,
+    PING: kPing,
+    PONG: kPong
+  }
+});
+
+module.exports = {
+  WebSocketReceiver,
+  WebSocketSender,
+  mask: binding.mask
+};
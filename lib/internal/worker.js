@@ -8,7 +8,9 @@ const {
   ObjectCreate,
   ObjectEntries,
   Promise,
+  PromiseAll,
   PromiseResolve,
+  SafeSet,
   Symbol,
   SymbolFor,
 } = primordials;
@@ -24,9 +26,16 @@ const {
   ERR_WORKER_UNSERIALIZABLE_ERROR,
   ERR_WORKER_UNSUPPORTED_EXTENSION,
   ERR_WORKER_INVALID_EXEC_ARGV,
+  ERR_WORKER_POOL_CLOSED,
   ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_ARG_VALUE,
 } = errorCodes;
-const { validateString } = require('internal/validators');
+const {
+  validateInt32,
+  validateInteger,
+  validateObject,
+  validateString,
+} = require('internal/validators');
 const { getOptionValue } = require('internal/options');
 
 const workerIo = require('internal/worker/io');
@@ -54,7 +63,15 @@ const {
   kMaxYoungGenerationSizeMb,
   kMaxOldGenerationSizeMb,
   kCodeRangeSizeMb,
-  kTotalResourceLimitCount
+  kTotalResourceLimitCount,
+  kHeapTotal,
+  kHeapUsed,
+  kHeapSizeLimit,
+  kExternalMemory,
+  kCpuTime,
+  kLoopIdleTime,
+  kLoopActiveTime,
+  kTotalResourceUsageFieldCount
 } = internalBinding('worker');
 
 const kHandle = Symbol('kHandle');
@@ -65,6 +82,21 @@ const kOnMessage = Symbol('kOnMessage');
 const kOnCouldNotSerializeErr = Symbol('kOnCouldNotSerializeErr');
 const kOnErrorMessage = Symbol('kOnErrorMessage');
 const kParentSideStdio = Symbol('kParentSideStdio');
+const kSpawn = Symbol('kSpawn');
+const kLoadScript = Symbol('kLoadScript');
+const kChildPublicPort = Symbol('kChildPublicPort');
+const kHasStdin = Symbol('kHasStdin');
+const kPooled = Symbol('kPooled');
+const kPoolOptions = Symbol('kPoolOptions');
+const kPoolSize = Symbol('kPoolSize');
+const kIdleWorkers = Symbol('kIdleWorkers');
+const kClosed = Symbol('kClosed');
+const kRefill = Symbol('kRefill');
+const kSpawnIdle = Symbol('kSpawnIdle');
+const kOnIdleExit = Symbol('kOnIdleExit');
+
+// An upper bound that catches obviously wrong pool sizes.
+const kMaxWorkerPoolSize = 1024;
 
 const SHARE_ENV = SymbolFor('nodejs.worker_threads.SHARE_ENV');
 const debug = require('internal/util/debuglog').debuglog('worker');
@@ -80,34 +112,50 @@ if (isMainThread) {
   };
 }
 
+// Validates the script-related options of a Worker and returns the
+// absolute path of `filename` (or the code to evaluate).
+function resolveWorkerScript(filename, options) {
+  validateString(filename, 'filename');
+  if (options.argv && !ArrayIsArray(options.argv)) {
+    throw new ERR_INVALID_ARG_TYPE('options.argv', 'Array', options.argv);
+  }
+  if (options.eval)
+    return filename;
+
+  if (!path.isAbsolute(filename) && !/^\.\.?[\\/]/.test(filename)) {
+    throw new ERR_WORKER_PATH(filename);
+  }
+  filename = path.resolve(filename);
+
+  const ext = path.extname(filename);
+  if (ext !== '.js' && ext !== '.mjs' && ext !== '.cjs') {
+    throw new ERR_WORKER_UNSUPPORTED_EXTENSION(ext);
+  }
+  return filename;
+}
+
 class Worker extends EventEmitter {
   constructor(filename, options = {}) {
     super();
     debug(`[${threadId}] create new worker`, filename, options);
-    validateString(filename, 'filename');
+    if (filename === kPooled) {
+      // Start a thread that bootstraps itself and then waits for a script
+      // to be passed to [kLoadScript]().
+      this[kSpawn](null, options);
+      return;
+    }
+    filename = resolveWorkerScript(filename, options);
+    const url = options.eval ? null : pathToFileURL(filename);
+    this[kSpawn](url, options);
+    this[kLoadScript](filename, options);
+  }
+
+  [kSpawn](url, options) {
     if (options.execArgv && !ArrayIsArray(options.execArgv)) {
       throw new ERR_INVALID_ARG_TYPE('options.execArgv',
                                      'Array',
                                      options.execArgv);
     }
-    let argv;
-    if (options.argv) {
-      if (!ArrayIsArray(options.argv)) {
-        throw new ERR_INVALID_ARG_TYPE('options.argv', 'Array', options.argv);
-      }
-      argv = options.argv.map(String);
-    }
-    if (!options.eval) {
-      if (!path.isAbsolute(filename) && !/^\.\.?[\\/]/.test(filename)) {
-        throw new ERR_WORKER_PATH(filename);
-      }
-      filename = path.resolve(filename);
-
-      const ext = path.extname(filename);
-      if (ext !== '.js' && ext !== '.mjs' && ext !== '.cjs') {
-        throw new ERR_WORKER_UNSUPPORTED_EXTENSION(ext);
-      }
-    }
 
     let env;
     if (typeof options.env === 'object' && options.env !== null) {
@@ -123,12 +171,23 @@ class Worker extends EventEmitter {
         options.env);
     }
 
-    const url = options.eval ? null : pathToFileURL(filename);
+    const priority = options.backgroundTaskPriority;
+    if (priority !== undefined && priority !== 'normal' && priority !== 'low') {
+      throw new ERR_INVALID_ARG_VALUE('options.backgroundTaskPriority',
+                                      priority,
+                                      "must be 'normal' or 'low'");
+    }
+
+    if (options.cpu !== undefined)
+      validateInt32(options.cpu, 'options.cpu', 0);
+
     // Set up the C++ handle for the worker, as well as some internal wiring.
     this[kHandle] = new WorkerImpl(url,
                                    env === process.env ? null : env,
                                    options.execArgv,
-                                   parseResourceLimits(options.resourceLimits));
+                                   parseResourceLimits(options.resourceLimits),
+                                   priority === 'low',
+                                   options.cpu);
     if (this[kHandle].invalidExecArgv) {
       throw new ERR_WORKER_INVALID_EXEC_ARGV(this[kHandle].invalidExecArgv);
     }
@@ -164,6 +223,19 @@ class Worker extends EventEmitter {
     this[kPublicPort] = port1;
     this[kPublicPort].on('message', (message) => this.emit('message', message));
     setupPortReferencing(this[kPublicPort], this, 'message');
+    this[kChildPublicPort] = port2;
+    this[kHasStdin] = !!options.stdin;
+    // Actually start the new thread now that everything is in place. It
+    // bootstraps itself and then waits for the LOAD_SCRIPT message.
+    this[kHandle].startThread();
+  }
+
+  [kLoadScript](filename, options) {
+    let argv;
+    if (options.argv)
+      argv = options.argv.map(String);
+    const publicPort = this[kChildPublicPort];
+    this[kChildPublicPort] = null;
     this[kPort].postMessage({
       argv,
       type: messageTypes.LOAD_SCRIPT,
@@ -171,14 +243,12 @@ class Worker extends EventEmitter {
       doEval: !!options.eval,
       cwdCounter: cwdCounter || workerIo.sharedCwdCounter,
       workerData: options.workerData,
-      publicPort: port2,
+      publicPort,
       manifestSrc: getOptionValue('--experimental-policy') ?
         require('internal/process/policy').src :
         null,
-      hasStdin: !!options.stdin
-    }, [port2]);
-    // Actually start the new thread now that everything is in place.
-    this[kHandle].startThread();
+      hasStdin: this[kHasStdin]
+    }, [publicPort]);
   }
 
   [kOnExit](code, customErr) {
@@ -232,6 +302,11 @@ class Worker extends EventEmitter {
     this[kHandle] = null;
     this[kPort] = null;
     this[kPublicPort] = null;
+    if (this[kChildPublicPort]) {
+      // This was a pooled Worker that never received a script.
+      this[kChildPublicPort].close();
+      this[kChildPublicPort] = null;
+    }
 
     const { stdout, stderr } = this[kParentSideStdio];
 
@@ -315,6 +390,27 @@ class Worker extends EventEmitter {
     return makeResourceLimits(this[kHandle].getResourceLimits());
   }
 
+  getResourceUsage() {
+    if (this[kHandle] === null) throw new ERR_WORKER_NOT_RUNNING();
+
+    const fields = resourceUsageArray;
+    this[kHandle].getResourceUsage(fields);
+    const idle = fields[kLoopIdleTime];
+    const active = fields[kLoopActiveTime];
+    return {
+      heapTotal: fields[kHeapTotal],
+      heapUsed: fields[kHeapUsed],
+      heapSizeLimit: fields[kHeapSizeLimit],
+      external: fields[kExternalMemory],
+      cpuTime: fields[kCpuTime],
+      eventLoopUtilization: {
+        idle,
+        active,
+        utilization: idle + active > 0 ? active / (idle + active) : 0
+      }
+    };
+  }
+
   getHeapSnapshot() {
     const heapSnapshotTaker = this[kHandle] && this[kHandle].takeHeapSnapshot();
     return new Promise((resolve, reject) => {
@@ -327,6 +423,73 @@ class Worker extends EventEmitter {
   }
 }
 
+// Keeps a number of Worker threads that have finished bootstrapping and
+// are waiting for a script, so that run() does not have to wait for a new
+// thread to start up. Idle threads do not keep the event loop alive.
+class WorkerPool {
+  constructor(options = {}) {
+    validateObject(options, 'options');
+    const { size = 1 } = options;
+    validateInteger(size, 'options.size', 0, kMaxWorkerPoolSize);
+    this[kPoolOptions] = { ...options };
+    this[kPoolSize] = size;
+    this[kIdleWorkers] = new SafeSet();
+    this[kClosed] = false;
+    this[kRefill]();
+  }
+
+  get idleCount() {
+    return this[kIdleWorkers].size;
+  }
+
+  run(filename, options = {}) {
+    if (this[kClosed])
+      throw new ERR_WORKER_POOL_CLOSED();
+    validateObject(options, 'options');
+    filename = resolveWorkerScript(filename, options);
+
+    let worker;
+    for (const idle of this[kIdleWorkers]) {
+      worker = idle;
+      break;
+    }
+    if (worker === undefined) {
+      worker = this[kSpawnIdle]();
+    }
+    this[kIdleWorkers].delete(worker);
+    worker.removeListener('exit', worker[kOnIdleExit]);
+    worker[kOnIdleExit] = undefined;
+    worker.ref();
+    worker[kLoadScript](filename, options);
+
+    // Start a replacement in the background.
+    process.nextTick(() => this[kRefill]());
+    return worker;
+  }
+
+  close() {
+    this[kClosed] = true;
+    const idle = [...this[kIdleWorkers]];
+    this[kIdleWorkers].clear();
+    return PromiseAll(idle.map((worker) => worker.terminate()));
+  }
+
+  [kRefill]() {
+    while (!this[kClosed] && this[kIdleWorkers].size < this[kPoolSize])
+      this[kIdleWorkers].add(this[kSpawnIdle]());
+  }
+
+  [kSpawnIdle]() {
+    const worker = new Worker(kPooled, this[kPoolOptions]);
+    worker.unref();
+    // Idle Workers can only exit due to errors during bootstrap or because
+    // the pool is closed; in either case they are not replaced immediately.
+    worker[kOnIdleExit] = () => this[kIdleWorkers].delete(worker);
+    worker.on('exit', worker[kOnIdleExit]);
+    return worker;
+  }
+}
+
 function pipeWithoutWarning(source, dest) {
   const sourceMaxListeners = source._maxListeners;
   const destMaxListeners = dest._maxListeners;
@@ -339,6 +502,7 @@ function pipeWithoutWarning(source, dest) {
   dest._maxListeners = destMaxListeners;
 }
 
+const resourceUsageArray = new Float64Array(kTotalResourceUsageFieldCount);
 const resourceLimitsArray = new Float64Array(kTotalResourceLimitCount);
 function parseResourceLimits(obj) {
   const ret = resourceLimitsArray;
@@ -370,4 +534,5 @@ module.exports = {
     !isMainThread ? makeResourceLimits(resourceLimitsRaw) : {},
   threadId,
   Worker,
+  WorkerPool,
 };
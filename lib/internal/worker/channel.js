@@ -0,0 +1,64 @@
+'use strict';
+
+/* global SharedArrayBuffer */
+
+const {
+  ObjectFreeze,
+} = primordials;
+
+const {
+  SharedChannel,
+  kHeaderSize
+} = internalBinding('shared_channel');
+const {
+  ERR_INVALID_ARG_VALUE,
+} = require('internal/errors').codes;
+const { isSharedArrayBuffer } = require('internal/util/types');
+const {
+  validateInteger,
+  validateObject,
+} = require('internal/validators');
+
+const kDefaultChannelSize = 1024 * 1024;
+const kMinChannelSize = 4096;
+const kMaxChannelSize = 2 ** 30;
+
+let net;
+
+function createChannel(options = {}) {
+  validateObject(options, 'options');
+  const { size = kDefaultChannelSize } = options;
+  validateInteger(size, 'options.size', 1, kMaxChannelSize);
+
+  // The ring capacity is always a power of two, so that positions in the
+  // rings can be computed with a mask.
+  let capacity = kMinChannelSize;
+  while (capacity < size)
+    capacity *= 2;
+
+  const buffer = new SharedArrayBuffer(kHeaderSize + 2 * capacity);
+  return [
+    ObjectFreeze({ buffer, side: 0 }),
+    ObjectFreeze({ buffer, side: 1 }),
+  ];
+}
+
+function openChannel(endpoint) {
+  validateObject(endpoint, 'endpoint');
+  const { buffer, side } = endpoint;
+  if (!isSharedArrayBuffer(buffer) || (side !== 0 && side !== 1))
+    throw new ERR_INVALID_ARG_VALUE('endpoint', endpoint);
+
+  if (net === undefined)
+    net = require('net');
+  return new net.Socket({
+    handle: new SharedChannel(buffer, side),
+    readable: true,
+    writable: true
+  });
+}
+
+module.exports = {
+  createChannel,
+  openChannel
+};
@@ -1,18 +1,26 @@
 'use strict';
 
 const {
+  ArrayIsArray,
+  ArrayPrototypeMap,
+  ArrayPrototypeSlice,
   ObjectAssign,
   ObjectCreate,
   ObjectDefineProperty,
   ObjectGetOwnPropertyDescriptors,
   ObjectGetPrototypeOf,
+  ObjectKeys,
+  ObjectPrototype,
   ObjectSetPrototypeOf,
+  ReflectApply,
+  SafeMap,
   Symbol,
 } = primordials;
 
 const {
   handle_onclose: handleOnCloseSymbol,
   oninit: onInitSymbol,
+  onmessages: onMessagesSymbol,
   no_message_symbol: noMessageSymbol
 } = internalBinding('symbols');
 const {
@@ -21,7 +29,11 @@ const {
   drainMessagePort,
   moveMessagePortToContext,
   receiveMessageOnPort: receiveMessageOnPort_,
-  stopMessagePort
+  setMessagePortBatchLimit,
+  setWrapTransferredHandleFunction,
+  stopMessagePort,
+  kTransferredFileHandle,
+  kTransferredTCP
 } = internalBinding('messaging');
 const {
   threadId,
@@ -30,6 +42,8 @@ const {
 
 const { Readable, Writable } = require('stream');
 const EventEmitter = require('events');
+const { errnoException } = require('internal/errors');
+const { isArrayBuffer } = require('internal/util/types');
 const { inspect } = require('internal/util/inspect');
 const debug = require('internal/util/debuglog').debuglog('worker');
 
@@ -42,6 +56,10 @@ const kWritableCallbacks = Symbol('kWritableCallbacks');
 const kStartedReading = Symbol('kStartedReading');
 const kStdioWantsMoreDataCallback = Symbol('kStdioWantsMoreDataCallback');
 
+// The maximum number of messages that are passed to a single 'messages'
+// event, so that the latency of individual messages stays bounded.
+const kMessageBatchLimit = 1000;
+
 const messageTypes = {
   UP_AND_RUNNING: 'upAndRunning',
   COULD_NOT_SERIALIZE_ERROR: 'couldNotSerializeError',
@@ -78,6 +96,18 @@ MessagePort.prototype[kOnMessageListener] = function onmessage(event) {
   this.emit('message', event.data);
 };
 
+// While there are 'messages' listeners, the native side passes arrays of
+// messages to this method instead of calling `onmessage` for each one.
+function onmessages(messages) {
+  this.emit('messages', messages);
+}
+
+ObjectDefineProperty(MessagePort.prototype, onMessagesSymbol, {
+  enumerable: false,
+  writable: false,
+  value: onmessages
+});
+
 // This is for compatibility with the Web's MessagePort API. It makes sense to
 // provide it as an `EventEmitter` in Node.js, but if somebody overrides
 // `onmessage`, we'll switch over to the Web API model.
@@ -101,7 +131,7 @@ ObjectDefineProperty(MessagePort.prototype, 'onmessage', {
 
 // This is called from inside the `MessagePort` constructor.
 function oninit() {
-  setupPortReferencing(this, this, 'message');
+  setupPortReferencing(this, this, 'message', 'messages');
 }
 
 ObjectDefineProperty(MessagePort.prototype, onInitSymbol, {
@@ -127,6 +157,137 @@ MessagePort.prototype.close = function(cb) {
   MessagePortPrototype.close.call(this);
 };
 
+// FileHandles and net.Sockets are JS objects around the native handles that
+// can actually be transferred, so the native handles take their place in the
+// transfer list and in the message itself.
+MessagePort.prototype.postMessage = function postMessage(...args) {
+  let transferList = args[1];
+  if (transferList !== null && typeof transferList === 'object' &&
+      !ArrayIsArray(transferList)) {
+    transferList = transferList.transfer;
+  }
+  const handles = getTransferredHandles(transferList);
+  if (handles === undefined)
+    return ReflectApply(MessagePortPrototype.postMessage, this, args);
+
+  ReflectApply(MessagePortPrototype.postMessage, this, [
+    replaceTransferredHandles(args[0], handles, new SafeMap()),
+    ArrayPrototypeMap(transferList, (entry) => {
+      return handles.has(entry) ? handles.get(entry) : entry;
+    })
+  ]);
+  // The native handles have given up their file descriptors at this point.
+  for (const wrapper of handles.keys())
+    detachTransferredHandle(wrapper);
+};
+
+let net;
+let FileHandle;
+let kFileHandleFd;
+let kFileHandle;
+
+function loadHandleWrappers() {
+  if (net !== undefined) return;
+  net = require('net');
+  ({
+    FileHandle,
+    kFd: kFileHandleFd,
+    kHandle: kFileHandle
+  } = require('internal/fs/promises'));
+}
+
+// Returns a map from the FileHandles and net.Sockets in `transferList` to
+// their native handles, or undefined if there are none.
+function getTransferredHandles(transferList) {
+  if (!ArrayIsArray(transferList)) return;
+  let handles;
+  for (let i = 0; i < transferList.length; i++) {
+    const entry = transferList[i];
+    if (entry === null || typeof entry !== 'object' ||
+        isArrayBuffer(entry) || entry instanceof MessagePort) {
+      continue;
+    }
+    loadHandleWrappers();
+    let handle;
+    if (entry instanceof net.Socket)
+      handle = entry._handle;
+    else if (entry instanceof FileHandle)
+      handle = entry[kFileHandle];
+    // Closed sockets are left for the native side to reject.
+    if (handle == null) continue;
+    if (handles === undefined)
+      handles = new SafeMap();
+    handles.set(entry, handle);
+  }
+  return handles;
+}
+
+// Returns `value` with the wrappers in `handles` replaced by their native
+// handles. Plain objects and arrays that contain wrappers are copied rather
+// than modified.
+function replaceTransferredHandles(value, handles, seen) {
+  if (value === null || typeof value !== 'object')
+    return value;
+  if (handles.has(value))
+    return handles.get(value);
+  if (seen.has(value))
+    return seen.get(value);
+  const proto = ObjectGetPrototypeOf(value);
+  const isArray = ArrayIsArray(value);
+  if (!isArray && proto !== ObjectPrototype && proto !== null)
+    return value;
+
+  seen.set(value, value);
+  let copy = value;
+  const keys = ObjectKeys(value);
+  for (let i = 0; i < keys.length; i++) {
+    const key = keys[i];
+    const replaced = replaceTransferredHandles(value[key], handles, seen);
+    if (replaced === value[key]) continue;
+    if (copy === value) {
+      copy = isArray ? ArrayPrototypeSlice(value) :
+        ObjectAssign(ObjectCreate(proto), value);
+      seen.set(value, copy);
+    }
+    copy[key] = replaced;
+  }
+  return copy;
+}
+
+function detachTransferredHandle(wrapper) {
+  if (wrapper instanceof FileHandle) {
+    wrapper[kFileHandleFd] = -1;
+    return;
+  }
+  // The handle has been closed already; this only updates the JS state and
+  // emits 'close'.
+  wrapper._handle = null;
+  wrapper.destroy();
+}
+
+// This is called for each FileHandle, socket or pipe that is received by
+// the current thread, in order to wrap it in a new JS object.
+function wrapTransferredHandle(type, fd) {
+  loadHandleWrappers();
+  if (type === kTransferredFileHandle)
+    return new FileHandle(new (internalBinding('fs').FileHandle)(fd));
+
+  let handle;
+  if (type === kTransferredTCP) {
+    const { TCP, constants } = internalBinding('tcp_wrap');
+    handle = new TCP(constants.SOCKET);
+  } else {
+    const { Pipe, constants } = internalBinding('pipe_wrap');
+    handle = new Pipe(constants.SOCKET);
+  }
+  const err = handle.open(fd);
+  if (err)
+    throw errnoException(err, 'open');
+  return new net.Socket({ handle, readable: true, writable: true });
+}
+
+setWrapTransferredHandleFunction(wrapTransferredHandle);
+
 ObjectDefineProperty(MessagePort.prototype, inspect.custom, {
   enumerable: false,
   writable: false,
@@ -148,20 +309,34 @@ ObjectDefineProperty(MessagePort.prototype, inspect.custom, {
   }
 });
 
-function setupPortReferencing(port, eventEmitter, eventName) {
+function setupPortReferencing(port, eventEmitter, eventName, batchEventName) {
   // Keep track of whether there are any workerMessage listeners:
   // If there are some, ref() the channel so it keeps the event loop alive.
   // If there are none or all are removed, unref() the channel so the worker
   // can shutdown gracefully.
+  // Listeners for `batchEventName`, if given, count as well, and switch the
+  // port to delivering arrays of messages to that event only.
+  const listenerCount = () => {
+    let count = eventEmitter.listenerCount(eventName);
+    if (batchEventName !== undefined)
+      count += eventEmitter.listenerCount(batchEventName);
+    return count;
+  };
   port.unref();
   eventEmitter.on('newListener', (name) => {
-    if (name === eventName && eventEmitter.listenerCount(eventName) === 0) {
+    if (name !== eventName && name !== batchEventName) return;
+    if (name === batchEventName && eventEmitter.listenerCount(name) === 0)
+      setMessagePortBatchLimit(port, kMessageBatchLimit);
+    if (listenerCount() === 0) {
       port.ref();
       MessagePortPrototype.start.call(port);
     }
   });
   eventEmitter.on('removeListener', (name) => {
-    if (name === eventName && eventEmitter.listenerCount(eventName) === 0) {
+    if (name !== eventName && name !== batchEventName) return;
+    if (name === batchEventName && eventEmitter.listenerCount(name) === 0)
+      setMessagePortBatchLimit(port, 0);
+    if (listenerCount() === 0) {
       stopMessagePort(port);
       port.unref();
     }
@@ -0,0 +1,154 @@
+'use strict';
+
+const {
+  Array,
+  ArrayIsArray,
+  Map,
+  ObjectKeys,
+  SafeMap,
+  SharedArrayBuffer,
+  Symbol,
+  Uint8Array,
+} = primordials;
+
+const {
+  ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_ARG_VALUE,
+} = require('internal/errors').codes;
+const { isSharedArrayBuffer } = require('internal/util/types');
+const { validateObject } = require('internal/validators');
+const {
+  DefaultDeserializer,
+  deserialize,
+  serialize,
+  serializeMany,
+} = require('v8');
+
+// Layout of the SharedArrayBuffer of a store:
+//
+//   uint32 (big-endian)  byte length of the index
+//   index                v8.serialize([keys, offsets, lengths])
+//   values               v8.serializeMany(values)
+//
+// Offsets are relative to the start of the values. Every thread that opens
+// the store only deserializes the index, and each value when it is looked up.
+
+const kBuffer = Symbol('kBuffer');
+const kDeserializer = Symbol('kDeserializer');
+const kIndex = Symbol('kIndex');
+const kOffsets = Symbol('kOffsets');
+const kLengths = Symbol('kLengths');
+
+function readUint32(bytes, offset) {
+  return bytes[offset] * 2 ** 24 + bytes[offset + 1] * 2 ** 16 +
+         bytes[offset + 2] * 2 ** 8 + bytes[offset + 3];
+}
+
+function invalidStore(buffer) {
+  return new ERR_INVALID_ARG_VALUE('buffer', buffer,
+                                   'is not the buffer of a SharedStore');
+}
+
+class SharedStore {
+  constructor(buffer) {
+    if (!isSharedArrayBuffer(buffer))
+      throw new ERR_INVALID_ARG_TYPE('buffer', 'SharedArrayBuffer', buffer);
+    const bytes = new Uint8Array(buffer);
+    if (bytes.length < 4)
+      throw invalidStore(buffer);
+    const indexLength = readUint32(bytes, 0);
+    const valuesStart = 4 + indexLength;
+    if (valuesStart > bytes.length)
+      throw invalidStore(buffer);
+
+    const [keys, offsets, lengths] =
+      deserialize(new Uint8Array(buffer, 4, indexLength));
+    if (!ArrayIsArray(keys) || !ArrayIsArray(offsets) ||
+        !ArrayIsArray(lengths) || offsets.length !== keys.length ||
+        lengths.length !== keys.length) {
+      throw invalidStore(buffer);
+    }
+    const index = new SafeMap();
+    for (let i = 0; i < keys.length; i++) {
+      offsets[i] += valuesStart;
+      if ((offsets[i] >>> 0) !== offsets[i] ||
+          (lengths[i] >>> 0) !== lengths[i] ||
+          offsets[i] + lengths[i] > bytes.length) {
+        throw invalidStore(buffer);
+      }
+      index.set(keys[i], i);
+    }
+
+    this[kBuffer] = buffer;
+    this[kDeserializer] = new DefaultDeserializer(bytes);
+    this[kIndex] = index;
+    this[kOffsets] = offsets;
+    this[kLengths] = lengths;
+  }
+
+  static from(entries) {
+    let keys;
+    let values;
+    if (entries instanceof Map) {
+      keys = [...entries.keys()];
+      values = [...entries.values()];
+    } else {
+      validateObject(entries, 'entries');
+      keys = ObjectKeys(entries);
+      values = keys.map((key) => entries[key]);
+    }
+    for (const key of keys) {
+      if (typeof key !== 'string') {
+        throw new ERR_INVALID_ARG_VALUE('entries', entries,
+                                        'must only have string keys');
+      }
+    }
+
+    const data = serializeMany(values);
+    const offsets = new Array(keys.length);
+    const lengths = new Array(keys.length);
+    let offset = 0;
+    for (let i = 0; i < keys.length; i++) {
+      lengths[i] = readUint32(data, offset);
+      offsets[i] = offset + 4;
+      offset += 4 + lengths[i];
+    }
+
+    const index = serialize([keys, offsets, lengths]);
+    const buffer = new SharedArrayBuffer(4 + index.length + data.length);
+    const bytes = new Uint8Array(buffer);
+    bytes[0] = index.length >>> 24;
+    bytes[1] = index.length >>> 16;
+    bytes[2] = index.length >>> 8;
+    bytes[3] = index.length;
+    bytes.set(index, 4);
+    bytes.set(data, 4 + index.length);
+    return new SharedStore(buffer);
+  }
+
+  get buffer() {
+    return this[kBuffer];
+  }
+
+  get size() {
+    return this[kIndex].size;
+  }
+
+  has(key) {
+    return this[kIndex].has(key);
+  }
+
+  get(key) {
+    const i = this[kIndex].get(key);
+    if (i === undefined)
+      return undefined;
+    return this[kDeserializer]._readValueAt(this[kOffsets][i],
+                                            this[kLengths][i]);
+  }
+
+  keys() {
+    return this[kIndex].keys();
+  }
+}
+
+module.exports = { SharedStore };
@@ -0,0 +1,90 @@
+'use strict';
+
+const {
+  NumberIsNaN,
+  Promise,
+  PromiseResolve,
+} = primordials;
+
+const {
+  AtomicsWaiter,
+  notify: notifyWaiters
+} = internalBinding('atomics_waiter');
+const {
+  ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_ARG_VALUE,
+  ERR_OUT_OF_RANGE,
+} = require('internal/errors').codes;
+const { isInt32Array, isSharedArrayBuffer } = require('internal/util/types');
+const {
+  validateInt32,
+  validateInteger,
+  validateNumber,
+} = require('internal/validators');
+const { setTimeout, clearTimeout } = require('timers');
+
+// Returns the byte offset of the element at `index` within the underlying
+// SharedArrayBuffer.
+function getByteOffset(typedArray, index) {
+  if (!isInt32Array(typedArray))
+    throw new ERR_INVALID_ARG_TYPE('typedArray', 'Int32Array', typedArray);
+  if (!isSharedArrayBuffer(typedArray.buffer)) {
+    throw new ERR_INVALID_ARG_VALUE('typedArray', typedArray,
+                                    'must be backed by a SharedArrayBuffer');
+  }
+  validateInteger(index, 'index', 0, typedArray.length - 1);
+  return typedArray.byteOffset + index * 4;
+}
+
+function validateCount(value, name) {
+  validateNumber(value, name);
+  if (NumberIsNaN(value) || value < 0)
+    throw new ERR_OUT_OF_RANGE(name, '>= 0', value);
+}
+
+function waitAsync(typedArray, index, value, timeout = Infinity) {
+  const byteOffset = getByteOffset(typedArray, index);
+  validateInt32(value, 'value');
+  validateCount(timeout, 'timeout');
+
+  const waiter = new AtomicsWaiter(typedArray.buffer, byteOffset);
+  if (!waiter.wait(value)) {
+    waiter.close();
+    return PromiseResolve('not-equal');
+  }
+
+  return new Promise((resolve) => {
+    let timer;
+    waiter.oncomplete = () => {
+      if (timer !== undefined)
+        clearTimeout(timer);
+      waiter.close();
+      resolve('ok');
+    };
+    if (timeout !== Infinity) {
+      timer = setTimeout(() => {
+        // If cancelling fails, another thread has already woken the waiter
+        // up, and `oncomplete` is about to be called.
+        if (!waiter.cancel())
+          return;
+        waiter.close();
+        resolve('timed-out');
+      }, timeout);
+    }
+  });
+}
+
+function notify(typedArray, index, count = Infinity) {
+  const byteOffset = getByteOffset(typedArray, index);
+  validateCount(count, 'count');
+
+  const woken = Atomics.notify(typedArray, index, count);
+  if (woken >= count)
+    return woken;
+  return woken + notifyWaiters(typedArray.buffer, byteOffset, count - woken);
+}
+
+module.exports = {
+  notify,
+  waitAsync
+};
@@ -26,6 +26,7 @@ const {
   Boolean,
   Error,
   Number,
+  NumberIsInteger,
   NumberIsNaN,
   ObjectDefineProperty,
   ObjectSetPrototypeOf,
@@ -36,7 +37,7 @@ const EventEmitter = require('events');
 const stream = require('stream');
 const { inspect } = require('internal/util/inspect');
 const debug = require('internal/util/debuglog').debuglog('net');
-const { deprecate } = require('internal/util');
+const { deprecate, normalizeEncoding } = require('internal/util');
 const {
   isIP,
   isIPv4,
@@ -49,7 +50,8 @@ const assert = require('internal/assert');
 const {
   UV_EADDRINUSE,
   UV_EINVAL,
-  UV_ENOTCONN
+  UV_ENOTCONN,
+  UV_ENOTSUP
 } = internalBinding('uv');
 
 const { Buffer } = require('buffer');
@@ -73,6 +75,8 @@ const {
 const {
   writevGeneric,
   writeGeneric,
+  sendFileGeneric,
+  kSendFileRequest,
   onStreamRead,
   kAfterAsyncWrite,
   kHandle,
@@ -80,7 +84,8 @@ const {
   setStreamTimeout,
   kBuffer,
   kBufferCb,
-  kBufferGen
+  kBufferGen,
+  kLines
 } = require('internal/stream_base_commons');
 const {
   codes: {
@@ -100,7 +105,12 @@ const {
   uvExceptionWithHostPort
 } = require('internal/errors');
 const { isUint8Array } = require('internal/util/types');
-const { validateInt32, validateString } = require('internal/validators');
+const {
+  validateBoolean,
+  validateInt32,
+  validateString,
+  validateUint32
+} = require('internal/validators');
 const kLastWriteQueueSize = Symbol('lastWriteQueueSize');
 const {
   DTRACE_NET_SERVER_CONNECTION,
@@ -111,7 +121,7 @@ const {
 let cluster;
 let dns;
 
-const { clearTimeout } = require('timers');
+const { clearTimeout, setTimeout } = require('timers');
 const { kTimeout } = require('internal/timers');
 
 const DEFAULT_IPV4_ADDR = '0.0.0.0';
@@ -119,8 +129,11 @@ const DEFAULT_IPV6_ADDR = '::';
 
 function noop() {}
 
-function getFlags(ipv6Only) {
-  return ipv6Only === true ? TCPConstants.UV_TCP_IPV6ONLY : 0;
+function getFlags(ipv6Only, reusePort) {
+  let flags = ipv6Only === true ? TCPConstants.UV_TCP_IPV6ONLY : 0;
+  if (reusePort === true)
+    flags |= TCPConstants.UV_TCP_REUSEPORT;
+  return flags;
 }
 
 function createHandle(fd, is_server) {
@@ -250,14 +263,44 @@ function initSocketHandle(self) {
         self[kBuffer] = userBuf;
       }
       self._handle.useUserBuffer(userBuf);
+    } else if (self[kLines]) {
+      const { delimiter, encoding, maxLineLength } = self[kLines];
+      self._handle.useLineSplitter(delimiter, encoding, maxLineLength);
     }
   }
 }
 
+// Lines that are longer than this fail the read with ENOBUFS, so that a peer
+// that never sends a delimiter cannot make the socket buffer without bound.
+const kDefaultMaxLineLength = 1024 * 1024;
+
+function toLineSplitterOptions(onread) {
+  let { delimiter, encoding } = onread;
+  const { maxLineLength = kDefaultMaxLineLength } = onread;
+  if (typeof delimiter === 'string' && delimiter.length === 1)
+    delimiter = delimiter.charCodeAt(0);
+  if (!NumberIsInteger(delimiter) || delimiter < 0 || delimiter > 255) {
+    throw new ERR_INVALID_ARG_VALUE('options.onread.delimiter',
+                                    onread.delimiter,
+                                    'must be a single byte');
+  }
+  if (encoding !== undefined && encoding !== 'buffer') {
+    const normalized = normalizeEncoding(encoding);
+    if (normalized === undefined)
+      throw new ERR_INVALID_ARG_VALUE('options.onread.encoding', encoding);
+    encoding = normalized;
+  }
+  validateUint32(maxLineLength, 'options.onread.maxLineLength', true);
+  return { delimiter, encoding, maxLineLength };
+}
+
 
 const kBytesRead = Symbol('kBytesRead');
 const kBytesWritten = Symbol('kBytesWritten');
 const kSetNoDelay = Symbol('kSetNoDelay');
+const kSetKeepAlive = Symbol('kSetKeepAlive');
+const kSetKeepAliveInitialDelay = Symbol('kSetKeepAliveInitialDelay');
+const kConnectAttempts = Symbol('kConnectAttempts');
 
 function Socket(options) {
   if (!(this instanceof Socket)) return new Socket(options);
@@ -272,11 +315,15 @@ function Socket(options) {
   this._parent = null;
   this._host = null;
   this[kSetNoDelay] = false;
+  this[kSetKeepAlive] = false;
+  this[kSetKeepAliveInitialDelay] = 0;
+  this[kConnectAttempts] = null;
   this[kLastWriteQueueSize] = 0;
   this[kTimeout] = null;
   this[kBuffer] = null;
   this[kBufferCb] = null;
   this[kBufferGen] = null;
+  this[kLines] = null;
 
   if (typeof options === 'number')
     options = { fd: options }; // Legacy interface.
@@ -314,6 +361,11 @@ function Socket(options) {
         this[kBuffer] = onread.buffer;
       }
       this[kBufferCb] = onread.callback;
+    } else if (onread !== null && typeof onread === 'object' &&
+               onread.delimiter !== undefined &&
+               typeof onread.callback === 'function') {
+      this[kLines] = toLineSplitterOptions(onread);
+      this[kBufferCb] = onread.callback;
     }
     if (options.fd !== undefined) {
       const { fd } = options;
@@ -505,8 +557,68 @@ Socket.prototype.setKeepAlive = function(setting, msecs) {
     return this;
   }
 
-  if (this._handle.setKeepAlive)
+  if (this._handle.setKeepAlive) {
+    this[kSetKeepAlive] = !!setting;
+    this[kSetKeepAliveInitialDelay] = ~~(msecs / 1000);
     this._handle.setKeepAlive(setting, ~~(msecs / 1000));
+  }
+
+  return this;
+};
+
+
+Socket.prototype.setBusyPoll = function(microseconds) {
+  validateInt32(microseconds, 'microseconds', 0);
+
+  // The socket does not exist until it connects.
+  if (!this._handle || this.connecting) {
+    this.once('connect', () => this.setBusyPoll(microseconds));
+    return this;
+  }
+
+  if (this._handle.setBusyPoll) {
+    const err = this._handle.setBusyPoll(microseconds);
+    if (err)
+      throw errnoException(err, 'setBusyPoll');
+  }
+
+  return this;
+};
+
+
+Socket.prototype.setRecvLowWatermark = function(bytes) {
+  validateInt32(bytes, 'bytes', 1);
+
+  // The socket does not exist until it connects.
+  if (!this._handle || this.connecting) {
+    this.once('connect', () => this.setRecvLowWatermark(bytes));
+    return this;
+  }
+
+  if (this._handle.setRecvLowWatermark) {
+    const err = this._handle.setRecvLowWatermark(bytes);
+    if (err)
+      throw errnoException(err, 'setRecvLowWatermark');
+  }
+
+  return this;
+};
+
+
+Socket.prototype.setZeroCopyThreshold = function(bytes) {
+  validateInt32(bytes, 'bytes', 0);
+
+  // The socket does not exist until it connects.
+  if (!this._handle || this.connecting) {
+    this.once('connect', () => this.setZeroCopyThreshold(bytes));
+    return this;
+  }
+
+  if (this._handle.setZeroCopyThreshold) {
+    const err = this._handle.setZeroCopyThreshold(bytes);
+    if (err)
+      throw errnoException(err, 'setZeroCopyThreshold');
+  }
 
   return this;
 };
@@ -593,7 +705,7 @@ Socket.prototype.end = function(data, encoding, callback) {
 
 
 Socket.prototype.pause = function() {
-  if (this[kBuffer] && !this.connecting && this._handle &&
+  if ((this[kBuffer] || this[kLines]) && !this.connecting && this._handle &&
       this._handle.reading) {
     this._handle.reading = false;
     if (!this.destroyed) {
@@ -607,7 +719,7 @@ Socket.prototype.pause = function() {
 
 
 Socket.prototype.resume = function() {
-  if (this[kBuffer] && !this.connecting && this._handle &&
+  if ((this[kBuffer] || this[kLines]) && !this.connecting && this._handle &&
       !this._handle.reading) {
     tryReadStart(this);
   }
@@ -616,7 +728,7 @@ Socket.prototype.resume = function() {
 
 
 Socket.prototype.read = function(n) {
-  if (this[kBuffer] && !this.connecting && this._handle &&
+  if ((this[kBuffer] || this[kLines]) && !this.connecting && this._handle &&
       !this._handle.reading) {
     tryReadStart(this);
   }
@@ -655,6 +767,16 @@ Socket.prototype._destroy = function(exception, cb) {
 
   this.readable = this.writable = false;
 
+  const attempts = this[kConnectAttempts];
+  if (attempts !== null) {
+    this[kConnectAttempts] = null;
+    clearTimeout(attempts.timer);
+    for (const handle of attempts.handles) {
+      if (handle !== this._handle)
+        handle.close();
+    }
+  }
+
   for (let s = this; s !== null; s = s._parent) {
     clearTimeout(s[kTimeout]);
   }
@@ -778,6 +900,11 @@ Socket.prototype._writeGeneric = function(writev, data, encoding, cb) {
 
   this._unrefTimer();
 
+  if (!writev && data[kSendFileRequest] !== undefined) {
+    sendFileGeneric(this, data[kSendFileRequest], cb);
+    return;
+  }
+
   let req;
   if (writev)
     req = writevGeneric(this, data, cb);
@@ -789,10 +916,33 @@ Socket.prototype._writeGeneric = function(writev, data, encoding, cb) {
 
 
 Socket.prototype._writev = function(chunks, cb) {
+  // A file range has to be sent on its own, see sendFile() in
+  // internal/stream_base_commons.
+  for (let i = 0; i < chunks.length; i++) {
+    if (chunks[i].chunk[kSendFileRequest] !== undefined) {
+      writeChunksInOrder(this, chunks, 0, cb);
+      return;
+    }
+  }
   this._writeGeneric(true, chunks, '', cb);
 };
 
 
+function writeChunksInOrder(socket, chunks, index, cb) {
+  if (index === chunks.length) {
+    cb();
+    return;
+  }
+  const { chunk, encoding } = chunks[index];
+  socket._writeGeneric(false, chunk, encoding, (err) => {
+    if (err)
+      cb(err);
+    else
+      writeChunksInOrder(socket, chunks, index + 1, cb);
+  });
+}
+
+
 Socket.prototype._write = function(data, encoding, cb) {
   this._writeGeneric(false, data, encoding, cb);
 };
@@ -1004,6 +1154,21 @@ function lookupAndConnect(self, options) {
   }
   port |= 0;
 
+  const {
+    autoSelectFamily = false,
+    autoSelectFamilyAttemptTimeout = 250,
+    fastOpen = false
+  } = options;
+  validateBoolean(autoSelectFamily, 'options.autoSelectFamily');
+  validateInt32(autoSelectFamilyAttemptTimeout,
+                'options.autoSelectFamilyAttemptTimeout', 10);
+  validateBoolean(fastOpen, 'options.fastOpen');
+
+  // With Fast Open, connect() completes before the handshake, so the first
+  // of the raced connection attempts would always win.
+  if (fastOpen && !autoSelectFamily)
+    enableFastOpenConnect(self._handle);
+
   // If host is an IP, skip performing a lookup
   const addressType = isIP(host);
   if (addressType) {
@@ -1040,6 +1205,24 @@ function lookupAndConnect(self, options) {
   debug('connect: dns options', dnsopts);
   self._host = host;
   const lookup = options.lookup || dns.lookup;
+
+  if (autoSelectFamily &&
+      dnsopts.family !== 4 &&
+      dnsopts.family !== 6 &&
+      !localAddress) {
+    defaultTriggerAsyncIdScope(self[async_id_symbol], function() {
+      lookup(host, { ...dnsopts, all: true },
+             function emitLookup(err, addresses, addressType) {
+               // Custom lookup functions may not support `all`.
+               if (!err && !ArrayIsArray(addresses))
+                 addresses = [{ address: addresses, family: addressType }];
+               lookupAllDone(self, err, addresses, host, port,
+                             autoSelectFamilyAttemptTimeout);
+             });
+    });
+    return;
+  }
+
   defaultTriggerAsyncIdScope(self[async_id_symbol], function() {
     lookup(host, dnsopts, function emitLookup(err, ip, addressType) {
       self.emit('lookup', err, ip, addressType, host);
@@ -1072,6 +1255,174 @@ function lookupAndConnect(self, options) {
 }
 
 
+function lookupAllDone(self, err, addresses, host, port, timeout) {
+  if (!err && addresses.length === 0)
+    err = new ERR_INVALID_ADDRESS_FAMILY(undefined, host, port);
+  if (err) {
+    self.emit('lookup', err, undefined, undefined, host);
+  } else {
+    self.emit('lookup', null, addresses[0].address, addresses[0].family, host);
+  }
+
+  if (!self.connecting) return;
+
+  if (!err) {
+    for (const { family } of addresses) {
+      if (family !== 4 && family !== 6) {
+        err = new ERR_INVALID_ADDRESS_FAMILY(family, host, port);
+        break;
+      }
+    }
+  }
+  if (err) {
+    process.nextTick(connectErrorNT, self, err);
+    return;
+  }
+
+  self._unrefTimer();
+  defaultTriggerAsyncIdScope(self[async_id_symbol], () => {
+    self[kConnectAttempts] = {
+      addresses: interleaveAddresses(addresses),
+      index: 0,
+      port,
+      timeout,
+      handles: [],
+      errors: [],
+      timer: null
+    };
+    connectAttempt(self);
+  });
+}
+
+// Alternates the address families, starting with the family of the first
+// address (RFC 8305, section 4).
+function interleaveAddresses(addresses) {
+  const preferred = addresses.filter((a) => a.family === addresses[0].family);
+  const others = addresses.filter((a) => a.family !== addresses[0].family);
+  const result = [];
+  for (let i = 0; i < preferred.length || i < others.length; i++) {
+    if (i < preferred.length)
+      result.push(preferred[i]);
+    if (i < others.length)
+      result.push(others[i]);
+  }
+  return result;
+}
+
+// With TCP Fast Open, the data of the first write is sent along with the SYN
+// to servers that the kernel has a Fast Open cookie for. Where this is not
+// supported, the connection is made as usual.
+function enableFastOpenConnect(handle) {
+  if (typeof handle.setFastOpenConnect === 'function')
+    handle.setFastOpenConnect();
+}
+
+// Starts a connection to the next address. Attempts run in parallel: the
+// next one starts after `timeout` milliseconds or as soon as this one fails,
+// and the first connection wins (RFC 8305, section 5). The first attempt uses
+// the socket's own handle, the others use handles of their own.
+function connectAttempt(self) {
+  const attempts = self[kConnectAttempts];
+  const { address, family } = attempts.addresses[attempts.index++];
+  const { port } = attempts;
+  let handle = self._handle;
+  if (attempts.index > 1) {
+    handle = new TCP(TCPConstants.SOCKET);
+    handle[owner_symbol] = self;
+    if (!self._handle.hasRef())
+      handle.unref();
+  }
+
+  debug('connect: attempt %d to %s:%d', attempts.index, address, port);
+  const req = new TCPConnectWrap();
+  req.oncomplete = afterConnectAttempt;
+  req.address = address;
+  req.port = port;
+  const err = family === 4 ?
+    handle.connect(req, address, port) :
+    handle.connect6(req, address, port);
+  if (err) {
+    const ex = exceptionWithHostPort(err, 'connect', address, port);
+    connectAttemptFailed(self, handle, ex);
+    return;
+  }
+
+  attempts.handles.push(handle);
+  if (attempts.index < attempts.addresses.length) {
+    attempts.timer = setTimeout(connectAttemptTimeout, attempts.timeout, self,
+                                attempts);
+    attempts.timer.unref();
+  }
+}
+
+function connectAttemptTimeout(self, attempts) {
+  if (self[kConnectAttempts] === attempts)
+    connectAttempt(self);
+}
+
+function connectAttemptFailed(self, handle, ex) {
+  const attempts = self[kConnectAttempts];
+  attempts.errors.push(ex);
+  if (handle !== self._handle)
+    handle.close();
+
+  if (attempts.index < attempts.addresses.length) {
+    clearTimeout(attempts.timer);
+    connectAttempt(self);
+  } else if (attempts.handles.length === 0) {
+    // Report the error for the preferred address.
+    self[kConnectAttempts] = null;
+    self.destroy(attempts.errors[0]);
+  }
+}
+
+function afterConnectAttempt(status, handle, req, readable, writable) {
+  const self = handle[owner_symbol];
+  const attempts = self[kConnectAttempts];
+  // The attempt was abandoned, because another one won or the socket was
+  // destroyed.
+  if (attempts === null || self.destroyed)
+    return;
+  const index = attempts.handles.indexOf(handle);
+  if (index === -1)
+    return;
+  attempts.handles.splice(index, 1);
+
+  if (status !== 0) {
+    const ex = exceptionWithHostPort(status, 'connect', req.address, req.port);
+    connectAttemptFailed(self, handle, ex);
+    return;
+  }
+
+  self[kConnectAttempts] = null;
+  clearTimeout(attempts.timer);
+  for (const other of attempts.handles) {
+    if (other !== self._handle)
+      other.close();
+  }
+
+  if (handle !== self._handle) {
+    const oldHandle = self._handle;
+    self._handle = handle;
+    handle.onread = onStreamRead;
+    self[async_id_symbol] = getNewAsyncId(handle);
+    if (isUint8Array(self[kBuffer])) {
+      handle.useUserBuffer(self[kBuffer]);
+    } else if (self[kLines]) {
+      const { delimiter, encoding, maxLineLength } = self[kLines];
+      handle.useLineSplitter(delimiter, encoding, maxLineLength);
+    }
+    if (self[kSetNoDelay])
+      handle.setNoDelay(true);
+    if (self[kSetKeepAlive])
+      handle.setKeepAlive(true, self[kSetKeepAliveInitialDelay]);
+    oldHandle.onread = noop;
+    oldHandle.close();
+  }
+
+  afterConnect(status, handle, req, readable, writable);
+}
+
 function connectErrorNT(self, err) {
   self.destroy(err);
 }
@@ -1198,6 +1549,20 @@ function Server(options, connectionListener) {
 
   this.allowHalfOpen = options.allowHalfOpen || false;
   this.pauseOnConnect = !!options.pauseOnConnect;
+
+  if (options.acceptBatchSize !== undefined)
+    validateUint32(options.acceptBatchSize, 'options.acceptBatchSize');
+  this.acceptBatchSize = options.acceptBatchSize || 0;
+
+  if (options.fastOpenQueueLength !== undefined) {
+    validateInt32(options.fastOpenQueueLength,
+                  'options.fastOpenQueueLength', 0);
+  }
+  this.fastOpenQueueLength = options.fastOpenQueueLength || 0;
+
+  if (options.deferAccept !== undefined)
+    validateInt32(options.deferAccept, 'options.deferAccept', 0);
+  this.deferAccept = options.deferAccept || 0;
 }
 ObjectSetPrototypeOf(Server.prototype, EventEmitter.prototype);
 ObjectSetPrototypeOf(Server, EventEmitter);
@@ -1247,12 +1612,13 @@ function createServerHandle(address, port, addressType, fd, flags) {
       if (err) {
         handle.close();
         // Fallback to ipv4
-        return createServerHandle(DEFAULT_IPV4_ADDR, port);
+        return createServerHandle(DEFAULT_IPV4_ADDR, port, 4, fd, flags);
       }
     } else if (addressType === 6) {
       err = handle.bind6(address, port, flags);
     } else {
-      err = handle.bind(address, port);
+      // IPv6-only mode doesn't apply to IPv4 sockets.
+      err = handle.bind(address, port, flags & ~TCPConstants.UV_TCP_IPV6ONLY);
     }
   }
 
@@ -1305,10 +1671,31 @@ function setupListenHandle(address, port, addressType, backlog, fd, flags) {
   this._handle.onconnection = onconnection;
   this._handle[owner_symbol] = this;
 
+  // Handles received from the cluster master in round-robin mode don't
+  // accept connections themselves and can't batch them.
+  if (this.acceptBatchSize > 1 &&
+      typeof this._handle.setAcceptBatchSize === 'function') {
+    this._handle.onconnection = onconnectionBatch;
+    this._handle.setAcceptBatchSize(this.acceptBatchSize);
+  }
+
+  // TCP Fast Open and TCP_DEFER_ACCEPT are ignored where they are not
+  // supported, and for IPC servers.
+  let err = 0;
+  if (this.fastOpenQueueLength > 0 &&
+      typeof this._handle.setFastOpen === 'function') {
+    err = this._handle.setFastOpen(this.fastOpenQueueLength);
+  }
+  if ((err === 0 || err === UV_ENOTSUP) && this.deferAccept > 0 &&
+      typeof this._handle.setDeferAccept === 'function') {
+    err = this._handle.setDeferAccept(this.deferAccept);
+  }
+
   // Use a backlog of 512 entries. We pass 511 to the listen() call because
   // the kernel does: backlogsize = roundup_pow_of_two(backlogsize + 1);
   // which will thus give us a backlog of 512 entries.
-  const err = this._handle.listen(backlog || 511);
+  if (err === 0 || err === UV_ENOTSUP)
+    err = this._handle.listen(backlog || 511);
 
   if (err) {
     const ex = uvExceptionWithHostPort(err, 'listen', address, port);
@@ -1351,7 +1738,8 @@ function emitListeningNT(self) {
 
 function listenInCluster(server, address, port, addressType,
                          backlog, fd, exclusive, flags) {
-  exclusive = !!exclusive;
+  // Every listener with SO_REUSEPORT has a socket of its own.
+  exclusive = !!exclusive || (flags & TCPConstants.UV_TCP_REUSEPORT) !== 0;
 
   if (cluster === undefined) cluster = require('cluster');
 
@@ -1409,7 +1797,7 @@ Server.prototype.listen = function(...args) {
     toNumber(args.length > 2 && args[2]);  // (port, host, backlog)
 
   options = options._handle || options.handle || options;
-  const flags = getFlags(options.ipv6Only);
+  const flags = getFlags(options.ipv6Only, options.reusePort);
   // (handle[, backlog][, cb]) where handle is an object with a handle
   if (options instanceof TCP) {
     this._handle = options;
@@ -1446,9 +1834,11 @@ Server.prototype.listen = function(...args) {
       lookupAndListen(this, options.port | 0, options.host, backlog,
                       options.exclusive, flags);
     } else { // Undefined host, listens on unspecified address
-      // Default addressType 4 will be used to search for master server
+      // Default addressType 4 will be used to search for master server.
+      // ipv6Only only applies to an explicit host.
       listenInCluster(this, null, options.port | 0, 4,
-                      backlog, undefined, options.exclusive);
+                      backlog, undefined, options.exclusive,
+                      flags & TCPConstants.UV_TCP_REUSEPORT);
     }
     return this;
   }
@@ -1560,6 +1950,24 @@ function onconnection(err, clientHandle) {
 }
 
 
+function onconnectionBatch(err, clientHandles) {
+  if (err) {
+    onconnection.call(this, err);
+    return;
+  }
+
+  let i = 0;
+  try {
+    for (; i < clientHandles.length; i++)
+      onconnection.call(this, 0, clientHandles[i]);
+  } finally {
+    // Don't leak the rest of the batch if a 'connection' listener threw.
+    for (i++; i < clientHandles.length; i++)
+      clientHandles[i].close();
+  }
+}
+
+
 Server.prototype.getConnections = function(cb) {
   const self = this;
 
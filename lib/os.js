@@ -22,6 +22,7 @@
 'use strict';
 
 const {
+  Float64Array,
   ObjectDefineProperties,
   SymbolToPrimitive,
 } = primordials;
@@ -32,14 +33,19 @@ const isWindows = process.platform === 'win32';
 
 const {
   codes: {
+    ERR_INVALID_ARG_TYPE,
+    ERR_INVALID_ARG_VALUE,
     ERR_SYSTEM_ERROR
   },
   hideStackFrames
 } = require('internal/errors');
 const { validateInt32 } = require('internal/validators');
+const { isFloat64Array } = require('internal/util/types');
 
 const {
+  getAvailableParallelism,
   getCPUs,
+  getCPUTimes,
   getFreeMem,
   getHomeDirectory: _getHomeDirectory,
   getHostname: _getHostname,
@@ -110,6 +116,28 @@ function cpus() {
   return result;
 }
 
+// Returns the times of all CPUs as a Float64Array with five entries per CPU,
+// or the difference to |previous|, which is then updated to the current
+// times so that it can be passed again.
+function cpuUsage(previous) {
+  const current = getCPUTimes() || new Float64Array(0);
+  if (previous === undefined)
+    return current;
+
+  if (!isFloat64Array(previous))
+    throw new ERR_INVALID_ARG_TYPE('previous', 'Float64Array', previous);
+  if (previous.length !== current.length) {
+    throw new ERR_INVALID_ARG_VALUE('previous', previous,
+                                    'does not match the number of CPUs');
+  }
+  for (let i = 0; i < current.length; i++) {
+    const time = current[i];
+    current[i] = time - previous[i];
+    previous[i] = time;
+  }
+  return current;
+}
+
 function arch() {
   return process.arch;
 }
@@ -265,7 +293,9 @@ function userInfo(options) {
 
 module.exports = {
   arch,
+  availableParallelism: getAvailableParallelism,
   cpus,
+  cpuUsage,
   endianness,
   freemem: getFreeMem,
   getPriority,
@@ -125,6 +125,28 @@ function _format(sep, pathObject) {
   return dir === pathObject.root ? `${dir}${base}` : `${dir}${sep}${base}`;
 }
 
+// Returns whether path[0, end) is made of separators and segments that are
+// neither empty nor '.' or '..', except for an empty first or last segment.
+// normalizeString() would return such a path unchanged, which is the common
+// case for the paths that module resolution and file servers produce.
+function isNormalizedPosix(path, end) {
+  let segmentStart = 0;
+  for (let i = 0; i <= end; ++i) {
+    if (i < end && path.charCodeAt(i) !== CHAR_FORWARD_SLASH)
+      continue;
+    const length = i - segmentStart;
+    if (length === 0) {
+      if (i !== 0 && i !== end)
+        return false;
+    } else if (length <= 2 && path.charCodeAt(segmentStart) === CHAR_DOT &&
+               (length === 1 || path.charCodeAt(i - 1) === CHAR_DOT)) {
+      return false;
+    }
+    segmentStart = i + 1;
+  }
+  return true;
+}
+
 const win32 = {
   // path.resolve([from ...], to)
   resolve(...args) {
@@ -988,6 +1010,14 @@ const posix = {
       resolvedAbsolute = path.charCodeAt(0) === CHAR_FORWARD_SLASH;
     }
 
+    // Every path was followed by a separator above, drop the last one.
+    const end = resolvedPath.length - 1;
+    if (resolvedAbsolute && end > 1 &&
+        resolvedPath.charCodeAt(end - 1) !== CHAR_FORWARD_SLASH &&
+        isNormalizedPosix(resolvedPath, end)) {
+      return resolvedPath.slice(0, end);
+    }
+
     // At this point the path should be resolved to a full absolute path, but
     // handle relative paths to be safe (might happen when process.cwd() fails)
 
@@ -1006,6 +1036,8 @@ const posix = {
 
     if (path.length === 0)
       return '.';
+    if (isNormalizedPosix(path, path.length))
+      return path;
 
     const isAbsolute = path.charCodeAt(0) === CHAR_FORWARD_SLASH;
     const trailingSeparator =
@@ -3,8 +3,10 @@
 const {
   ArrayIsArray,
   Boolean,
+  Float64Array,
   Map,
   NumberIsSafeInteger,
+  NumberMAX_SAFE_INTEGER,
   ObjectDefineProperties,
   ObjectDefineProperty,
   ObjectKeys,
@@ -14,19 +16,26 @@ const {
 
 const {
   ELDHistogram: _ELDHistogram,
+  ThreadPoolHistogram: _ThreadPoolHistogram,
+  LoopPhaseHistogram: _LoopPhaseHistogram,
+  RecordableHistogram,
   PerformanceEntry,
   mark: _mark,
   clearMark: _clearMark,
   measure: _measure,
   milestones,
   observerCounts,
+  phaseNames,
+  phases,
   setupObservers,
   timeOrigin,
   timeOriginTimestamp,
   timerify,
   constants,
+  gcTotals,
   installGarbageCollectionTracking,
-  removeGarbageCollectionTracking
+  removeGarbageCollectionTracking,
+  loopIdleTime
 } = internalBinding('performance');
 
 const {
@@ -43,7 +52,30 @@ const {
   NODE_PERFORMANCE_MILESTONE_LOOP_START,
   NODE_PERFORMANCE_MILESTONE_LOOP_EXIT,
   NODE_PERFORMANCE_MILESTONE_BOOTSTRAP_COMPLETE,
-  NODE_PERFORMANCE_MILESTONE_ENVIRONMENT
+  NODE_PERFORMANCE_MILESTONE_ENVIRONMENT,
+
+  NODE_THREADPOOL_WORK_KIND_FS,
+  NODE_THREADPOOL_WORK_KIND_DNS,
+  NODE_THREADPOOL_WORK_KIND_ZLIB,
+  NODE_THREADPOOL_WORK_KIND_CRYPTO,
+  NODE_THREADPOOL_WORK_KIND_KDF,
+  NODE_THREADPOOL_WORK_KIND_NAPI,
+  NODE_THREADPOOL_WORK_WAIT,
+  NODE_THREADPOOL_WORK_RUN,
+
+  NODE_LOOP_PHASE_TIMERS,
+  NODE_LOOP_PHASE_POLL,
+  NODE_LOOP_PHASE_CHECK,
+
+  NODE_GC_TOTALS_KIND_MINOR,
+  NODE_GC_TOTALS_KIND_MAJOR,
+  NODE_GC_TOTALS_KIND_INCREMENTAL,
+  NODE_GC_TOTALS_KIND_WEAKCB,
+  NODE_GC_TOTALS_FIELD_COUNT,
+  NODE_GC_TOTALS_FIELD_DURATION,
+  NODE_GC_TOTALS_FIELD_COLLECTED,
+  NODE_GC_TOTALS_FIELD_PROMOTED,
+  NODE_GC_TOTALS_FIELD_INVALID
 } = constants;
 
 const { AsyncResource } = require('async_hooks');
@@ -59,8 +91,10 @@ const {
   ERR_INVALID_PERFORMANCE_MARK
 } = require('internal/errors').codes;
 
+const { validateInteger } = require('internal/validators');
 const { setImmediate } = require('timers');
 const kHandle = Symbol('handle');
+const kHistograms = Symbol('histograms');
 const kMap = Symbol('map');
 const kCallback = Symbol('callback');
 const kTypes = Symbol('types');
@@ -74,6 +108,9 @@ const kGetEntries = Symbol('get-entries');
 const kIndex = Symbol('index');
 const kMarks = Symbol('marks');
 const kCount = Symbol('count');
+const kEnabled = Symbol('enabled');
+const kBaseline = Symbol('baseline');
+const kAccumulated = Symbol('accumulated');
 
 const observers = {};
 const observerableTypes = [
@@ -163,6 +200,21 @@ function getMilestoneTimestamp(milestoneIdx) {
   return ns / 1e6 - timeOrigin;
 }
 
+function getPhases() {
+  const result = {};
+  for (let i = 0; i < phaseNames.length; i++) {
+    const start = phases[i * 2];
+    const end = phases[i * 2 + 1];
+    if (start === -1 || end === -1)
+      continue;
+    result[phaseNames[i]] = {
+      startTime: start / 1e6 - timeOrigin,
+      duration: (end - start) / 1e6
+    };
+  }
+  return result;
+}
+
 class PerformanceNodeTiming extends PerformanceEntry {
   get name() {
     return 'node';
@@ -204,6 +256,14 @@ class PerformanceNodeTiming extends PerformanceEntry {
     return getMilestoneTimestamp(NODE_PERFORMANCE_MILESTONE_BOOTSTRAP_COMPLETE);
   }
 
+  get phases() {
+    return getPhases();
+  }
+
+  get idleTime() {
+    return loopIdleTime();
+  }
+
   [kInspect]() {
     return {
       name: 'node',
@@ -215,7 +275,9 @@ class PerformanceNodeTiming extends PerformanceEntry {
       bootstrapComplete: this.bootstrapComplete,
       environment: this.environment,
       loopStart: this.loopStart,
-      loopExit: this.loopExit
+      loopExit: this.loopExit,
+      phases: this.phases,
+      idleTime: this.idleTime
     };
   }
 }
@@ -414,6 +476,10 @@ class Performance {
     }
   }
 
+  eventLoopUtilization(util1, util2) {
+    return eventLoopUtilization(util1, util2);
+  }
+
   timerify(fn) {
     if (typeof fn !== 'function') {
       throw new ERR_INVALID_ARG_TYPE('fn', 'Function', fn);
@@ -454,6 +520,28 @@ class Performance {
 
 const performance = new Performance();
 
+function eventLoopUtilization(util1, util2) {
+  const loopStart = nodeTiming.loopStart;
+  if (loopStart <= 0)
+    return { idle: 0, active: 0, utilization: 0 };
+
+  if (util2) {
+    const idle = util1.idle - util2.idle;
+    const active = util1.active - util2.active;
+    return { idle, active, utilization: active / (idle + active) };
+  }
+
+  const idle = nodeTiming.idleTime;
+  const active = performance.now() - loopStart - idle;
+  if (!util1)
+    return { idle, active, utilization: active / (idle + active) };
+
+  const idleDelta = idle - util1.idle;
+  const activeDelta = active - util1.active;
+  const utilization = activeDelta / (idleDelta + activeDelta);
+  return { idle: idleDelta, active: activeDelta, utilization };
+}
+
 function getObserversList(type) {
   let list = observers[type];
   if (list === undefined) {
@@ -557,17 +645,14 @@ function sortedInsert(list, entry) {
   list.splice(location, 0, entry);
 }
 
-class ELDHistogram {
+class Histogram {
   constructor(handle) {
     this[kHandle] = handle;
     this[kMap] = new Map();
   }
 
   reset() { this[kHandle].reset(); }
-  enable() { return this[kHandle].enable(); }
-  disable() { return this[kHandle].disable(); }
 
-  get exceeds() { return this[kHandle].exceeds(); }
   get min() { return this[kHandle].min(); }
   get max() { return this[kHandle].max(); }
   get mean() { return this[kHandle].mean(); }
@@ -594,12 +679,186 @@ class ELDHistogram {
       max: this.max,
       mean: this.mean,
       stddev: this.stddev,
-      percentiles: this.percentiles,
+      percentiles: this.percentiles
+    };
+  }
+}
+
+class ELDHistogram extends Histogram {
+  enable() { return this[kHandle].enable(); }
+  disable() { return this[kHandle].disable(); }
+
+  get exceeds() { return this[kHandle].exceeds(); }
+
+  [kInspect]() {
+    return {
+      ...super[kInspect](),
       exceeds: this.exceeds
     };
   }
 }
 
+const threadpoolWorkKinds = {
+  fs: NODE_THREADPOOL_WORK_KIND_FS,
+  dns: NODE_THREADPOOL_WORK_KIND_DNS,
+  zlib: NODE_THREADPOOL_WORK_KIND_ZLIB,
+  crypto: NODE_THREADPOOL_WORK_KIND_CRYPTO,
+  kdf: NODE_THREADPOOL_WORK_KIND_KDF,
+  napi: NODE_THREADPOOL_WORK_KIND_NAPI
+};
+
+class ThreadpoolMonitor {
+  constructor() {
+    const histograms = {};
+    for (const name of ObjectKeys(threadpoolWorkKinds)) {
+      const kind = threadpoolWorkKinds[name];
+      histograms[name] = {
+        wait: new Histogram(
+          new _ThreadPoolHistogram(kind, NODE_THREADPOOL_WORK_WAIT)),
+        run: new Histogram(
+          new _ThreadPoolHistogram(kind, NODE_THREADPOOL_WORK_RUN))
+      };
+    }
+    this[kHistograms] = histograms;
+  }
+
+  enable() { return forEachThreadpoolHistogram(this, 'enable'); }
+  disable() { return forEachThreadpoolHistogram(this, 'disable'); }
+  reset() { forEachThreadpoolHistogram(this, 'reset'); }
+
+  get fs() { return this[kHistograms].fs; }
+  get dns() { return this[kHistograms].dns; }
+  get zlib() { return this[kHistograms].zlib; }
+  get crypto() { return this[kHistograms].crypto; }
+  get kdf() { return this[kHistograms].kdf; }
+  get napi() { return this[kHistograms].napi; }
+
+  [kInspect]() {
+    return this[kHistograms];
+  }
+}
+
+function forEachThreadpoolHistogram(monitor, method) {
+  let changed = false;
+  for (const name of ObjectKeys(threadpoolWorkKinds)) {
+    const { wait, run } = monitor[kHistograms][name];
+    // Evaluate both so that wait and run are always toggled together.
+    const waitChanged = wait[kHandle][method]();
+    const runChanged = run[kHandle][method]();
+    changed = waitChanged || runChanged || changed;
+  }
+  return changed;
+}
+
+const loopPhases = {
+  timers: NODE_LOOP_PHASE_TIMERS,
+  poll: NODE_LOOP_PHASE_POLL,
+  check: NODE_LOOP_PHASE_CHECK
+};
+
+class EventLoopPhaseMonitor {
+  constructor() {
+    const histograms = {};
+    for (const name of ObjectKeys(loopPhases)) {
+      histograms[name] =
+        new Histogram(new _LoopPhaseHistogram(loopPhases[name]));
+    }
+    this[kHistograms] = histograms;
+  }
+
+  enable() { return forEachLoopPhaseHistogram(this, 'enable'); }
+  disable() { return forEachLoopPhaseHistogram(this, 'disable'); }
+  reset() { forEachLoopPhaseHistogram(this, 'reset'); }
+
+  get timers() { return this[kHistograms].timers; }
+  get poll() { return this[kHistograms].poll; }
+  get check() { return this[kHistograms].check; }
+
+  [kInspect]() {
+    return this[kHistograms];
+  }
+}
+
+function forEachLoopPhaseHistogram(monitor, method) {
+  let changed = false;
+  for (const name of ObjectKeys(loopPhases))
+    changed = monitor[kHistograms][name][kHandle][method]() || changed;
+  return changed;
+}
+
+const gcTotalsKinds = {
+  minor: NODE_GC_TOTALS_KIND_MINOR,
+  major: NODE_GC_TOTALS_KIND_MAJOR,
+  incremental: NODE_GC_TOTALS_KIND_INCREMENTAL,
+  weakcb: NODE_GC_TOTALS_KIND_WEAKCB
+};
+
+// The native totals are shared by all monitors and only grow while at least
+// one of them is enabled, so each monitor keeps the difference to the totals
+// at the time it was enabled.
+class GarbageCollectionMonitor {
+  constructor() {
+    this[kEnabled] = false;
+    this[kBaseline] = new Float64Array(gcTotals.length);
+    this[kAccumulated] = new Float64Array(gcTotals.length);
+  }
+
+  enable() {
+    if (this[kEnabled])
+      return false;
+    installGarbageCollectionTracking(true);
+    this[kEnabled] = true;
+    this[kBaseline].set(gcTotals);
+    return true;
+  }
+
+  disable() {
+    if (!this[kEnabled])
+      return false;
+    const accumulated = this[kAccumulated];
+    for (let i = 0; i < accumulated.length; i++)
+      accumulated[i] += gcTotals[i] - this[kBaseline][i];
+    removeGarbageCollectionTracking(true);
+    this[kEnabled] = false;
+    return true;
+  }
+
+  reset() {
+    this[kAccumulated].fill(0);
+    this[kBaseline].set(gcTotals);
+  }
+
+  get minor() { return getGCTotals(this, NODE_GC_TOTALS_KIND_MINOR); }
+  get major() { return getGCTotals(this, NODE_GC_TOTALS_KIND_MAJOR); }
+  get incremental() {
+    return getGCTotals(this, NODE_GC_TOTALS_KIND_INCREMENTAL);
+  }
+  get weakcb() { return getGCTotals(this, NODE_GC_TOTALS_KIND_WEAKCB); }
+
+  [kInspect]() {
+    const totals = {};
+    for (const name of ObjectKeys(gcTotalsKinds))
+      totals[name] = getGCTotals(this, gcTotalsKinds[name]);
+    return totals;
+  }
+}
+
+function getGCTotals(monitor, kind) {
+  const index = kind * NODE_GC_TOTALS_FIELD_INVALID;
+  const field = (offset) => {
+    let value = monitor[kAccumulated][index + offset];
+    if (monitor[kEnabled])
+      value += gcTotals[index + offset] - monitor[kBaseline][index + offset];
+    return value;
+  };
+  return {
+    count: field(NODE_GC_TOTALS_FIELD_COUNT),
+    duration: field(NODE_GC_TOTALS_FIELD_DURATION),
+    collected: field(NODE_GC_TOTALS_FIELD_COLLECTED),
+    promoted: field(NODE_GC_TOTALS_FIELD_PROMOTED)
+  };
+}
+
 function monitorEventLoopDelay(options = {}) {
   if (typeof options !== 'object' || options === null) {
     throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
@@ -615,10 +874,59 @@ function monitorEventLoopDelay(options = {}) {
   return new ELDHistogram(new _ELDHistogram(resolution));
 }
 
+// RecordableHistogram objects are the native objects themselves, so that they
+// can be cloned into messages to other threads.
+ObjectDefineProperty(RecordableHistogram.prototype, kInspect, {
+  configurable: true,
+  writable: true,
+  value() {
+    return {
+      count: this.count,
+      min: this.min,
+      max: this.max,
+      mean: this.mean,
+      exceeds: this.exceeds,
+      stddev: this.stddev,
+      percentiles: this.percentiles
+    };
+  }
+});
+
+function createHistogram(options = {}) {
+  if (typeof options !== 'object' || options === null) {
+    throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
+  }
+  const {
+    lowest = 1,
+    highest = NumberMAX_SAFE_INTEGER,
+    figures = 3
+  } = options;
+  validateInteger(lowest, 'options.lowest', 1);
+  validateInteger(highest, 'options.highest', 2 * lowest);
+  validateInteger(figures, 'options.figures', 1, 5);
+  return new RecordableHistogram(lowest, highest, figures);
+}
+
+function monitorThreadpool() {
+  return new ThreadpoolMonitor();
+}
+
+function monitorEventLoopPhases() {
+  return new EventLoopPhaseMonitor();
+}
+
+function monitorGarbageCollection() {
+  return new GarbageCollectionMonitor();
+}
+
 module.exports = {
   performance,
   PerformanceObserver,
-  monitorEventLoopDelay
+  createHistogram,
+  monitorEventLoopDelay,
+  monitorEventLoopPhases,
+  monitorGarbageCollection,
+  monitorThreadpool
 };
 
 ObjectDefineProperty(module.exports, 'constants', {
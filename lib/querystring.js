@@ -31,6 +31,7 @@ const {
 } = primordials;
 
 const { Buffer } = require('buffer');
+const { parseQueryString } = internalBinding('url');
 const {
   encodeStr,
   hexTable,
@@ -266,6 +267,14 @@ function parse(qs, sep, eq, options) {
   }
   const customDecode = (decode !== qsUnescape);
 
+  // The native parser handles ASCII input with the default separators and
+  // decoder, and returns undefined for anything else.
+  if (!customDecode && (!sep || sep === '&') && (!eq || eq === '=')) {
+    const result = parseQueryString(qs, pairs);
+    if (result !== undefined)
+      return result;
+  }
+
   let lastPos = 0;
   let sepIdx = 0;
   let eqIdx = 0;
@@ -37,6 +37,11 @@ Stream.PassThrough = require('_stream_passthrough');
 
 Stream.pipeline = pipeline;
 Stream.finished = eos;
+// Loaded lazily, since `stream` is loaded during bootstrap when stdio is a
+// stream.
+Stream.parseJSON = function parseJSON(source, options) {
+  return require('internal/streams/json_parse')(source, options);
+};
 
 // Backwards-compat with node 0.4.x
 Stream.Stream = Stream;
@@ -34,6 +34,7 @@ const L = require('internal/linkedlist');
 const {
   async_id_symbol,
   Timeout,
+  coarseDuration,
   decRefCount,
   immediateInfoFields: {
     kCount,
@@ -157,6 +158,28 @@ setTimeout[customPromisify] = function(after, value) {
   });
 };
 
+function setCoarseTimeout(callback, after, ...args) {
+  if (typeof callback !== 'function') {
+    throw new ERR_INVALID_CALLBACK(callback);
+  }
+
+  const timeout = new Timeout(callback, after,
+                              args.length > 0 ? args : undefined, false, true);
+  timeout._idleTimeout = coarseDuration(timeout._idleTimeout);
+  insert(timeout, timeout._idleTimeout);
+
+  return timeout;
+}
+
+setCoarseTimeout[customPromisify] = function(after, value) {
+  const args = value !== undefined ? [value] : value;
+  return new Promise((resolve) => {
+    const timeout = new Timeout(resolve, after, args, false, true);
+    timeout._idleTimeout = coarseDuration(timeout._idleTimeout);
+    insert(timeout, timeout._idleTimeout);
+  });
+};
+
 function clearTimeout(timer) {
   if (timer && timer._onTimeout) {
     timer._onTimeout = null;
@@ -302,6 +325,7 @@ function clearImmediate(immediate) {
 
 module.exports = {
   setTimeout,
+  setCoarseTimeout,
   clearTimeout,
   setImmediate,
   clearImmediate,
@@ -386,7 +386,8 @@ Url.prototype.parse = function parse(url, parseQueryString, slashesDenoteHost) {
 
       // Use lenient mode (`true`) to try to support even non-compliant
       // URLs.
-      this.hostname = toASCII(this.hostname, true);
+      if (needsToASCII(this.hostname))
+        this.hostname = toASCII(this.hostname, true);
     }
 
     const p = this.port ? ':' + this.port : '';
@@ -469,6 +470,18 @@ Url.prototype.parse = function parse(url, parseQueryString, slashesDenoteHost) {
   return this;
 };
 
+// toASCII() returns lower case ASCII hostnames without Punycode labels as
+// they are, so that most hostnames do not need to be passed to it.
+function needsToASCII(hostname) {
+  if (hostname.startsWith('xn--') || hostname.includes('.xn--'))
+    return true;
+  for (let i = 0; i < hostname.length; ++i) {
+    if (hostname.charCodeAt(i) > 127)
+      return true;
+  }
+  return false;
+}
+
 function getHostname(self, rest, hostname) {
   for (let i = 0; i < hostname.length; ++i) {
     const code = hostname.charCodeAt(i);
@@ -17,6 +17,7 @@
 const {
   Array,
   ArrayBuffer,
+  ArrayBufferIsView,
   Error,
   Float32Array,
   Float64Array,
@@ -32,7 +33,10 @@ const {
 } = primordials;
 
 const { Buffer } = require('buffer');
-const { validateString } = require('internal/validators');
+const {
+  validateArray,
+  validateString,
+} = require('internal/validators');
 const {
   Serializer: _Serializer,
   Deserializer: _Deserializer
@@ -44,17 +48,41 @@ const { FastBuffer } = require('internal/buffer');
 const { getValidatedPath } = require('internal/fs/utils');
 const { toNamespacedPath } = require('path');
 const {
+  HeapSnapshotWriteWrap,
   createHeapSnapshotStream,
   triggerHeapSnapshot
 } = internalBinding('heap_utils');
 const { HeapSnapshotStream } = require('internal/heap_utils');
-
-function writeHeapSnapshot(filename) {
+const {
+  codes: {
+    ERR_BUFFER_OUT_OF_BOUNDS,
+    ERR_INVALID_ARG_TYPE,
+    ERR_INVALID_CALLBACK,
+  },
+  uvException
+} = require('internal/errors');
+
+function writeHeapSnapshot(filename, callback) {
+  if (typeof filename === 'function') {
+    callback = filename;
+    filename = undefined;
+  }
   if (filename !== undefined) {
     filename = getValidatedPath(filename);
     filename = toNamespacedPath(filename);
   }
-  return triggerHeapSnapshot(filename);
+  if (callback === undefined)
+    return triggerHeapSnapshot(filename);
+
+  if (typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK(callback);
+  const req = new HeapSnapshotWriteWrap();
+  req.oncomplete = (err, syscall, path) => {
+    if (err !== 0)
+      return callback(uvException({ errno: err, syscall, path }));
+    callback(null, path);
+  };
+  triggerHeapSnapshot(filename, req);
 }
 
 function getHeapSnapshot() {
@@ -79,6 +107,7 @@ const {
   updateHeapStatisticsArrayBuffer,
   updateHeapSpaceStatisticsArrayBuffer,
   updateHeapCodeStatisticsArrayBuffer,
+  memoryLimit,
 
   // Properties for heap statistics buffer extraction.
   kTotalHeapSizeIndex,
@@ -139,7 +168,8 @@ function getHeapStatistics() {
     'peak_malloced_memory': buffer[kPeakMallocedMemoryIndex],
     'does_zap_garbage': buffer[kDoesZapGarbageIndex],
     'number_of_native_contexts': buffer[kNumberOfNativeContextsIndex],
-    'number_of_detached_contexts': buffer[kNumberOfDetachedContextsIndex]
+    'number_of_detached_contexts': buffer[kNumberOfDetachedContextsIndex],
+    'memory_limit': memoryLimit
   };
 }
 
@@ -275,6 +305,42 @@ function deserialize(buffer) {
   return der.readValue();
 }
 
+// Serializes every value as v8.serialize() would, into a single Buffer in
+// which each value is preceded by its length as a big-endian uint32.
+function serializeMany(values) {
+  validateArray(values, 'values');
+  const ser = new DefaultSerializer();
+  return ser._writeValues(values);
+}
+
+function* readValues(der, bytes) {
+  let offset = 0;
+  while (offset < bytes.length) {
+    if (bytes.length - offset < 4)
+      throw new ERR_BUFFER_OUT_OF_BOUNDS();
+    const length = bytes[offset] * 2 ** 24 + bytes[offset + 1] * 2 ** 16 +
+                   bytes[offset + 2] * 2 ** 8 + bytes[offset + 3];
+    offset += 4;
+    if (bytes.length - offset < length)
+      throw new ERR_BUFFER_OUT_OF_BOUNDS();
+    const value = der._readValueAt(offset, length);
+    offset += length;
+    yield value;
+  }
+}
+
+// Returns an iterator over the values in a buffer created by serializeMany().
+// Values are only deserialized when they are reached.
+function deserializeMany(buffer) {
+  if (!ArrayBufferIsView(buffer)) {
+    throw new ERR_INVALID_ARG_TYPE(
+      'buffer', ['Buffer', 'TypedArray', 'DataView'], buffer);
+  }
+  const bytes = new Uint8Array(buffer.buffer, buffer.byteOffset,
+                               buffer.byteLength);
+  return readValues(new DefaultDeserializer(buffer), bytes);
+}
+
 module.exports = {
   cachedDataVersionTag,
   getHeapSnapshot,
@@ -287,6 +353,8 @@ module.exports = {
   DefaultSerializer,
   DefaultDeserializer,
   deserialize,
+  deserializeMany,
   serialize,
+  serializeMany,
   writeHeapSnapshot,
 };
@@ -23,6 +23,8 @@
 
 const {
   ArrayPrototypeForEach,
+  ObjectDefineProperties,
+  ObjectGetOwnPropertyDescriptors,
   Symbol,
 } = primordials;
 
@@ -30,10 +32,15 @@ const {
   ContextifyScript,
   makeContext,
   isContext: _isContext,
+  getContextGlobal: _getContextGlobal,
+  getCompileCacheEntry,
+  setCompileCacheEntry,
+  createFunctionCachedData,
   compileFunction: _compileFunction
 } = internalBinding('contextify');
 const {
   ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_ARG_VALUE,
 } = require('internal/errors').codes;
 const {
   isArrayBufferView,
@@ -48,8 +55,31 @@ const {
   validateObject,
 } = require('internal/validators');
 const { kVmBreakFirstLineSymbol } = require('internal/util');
+const diskCache = require('internal/modules/compile_cache');
 const kParsingContext = Symbol('script parsing context');
 
+// Returns the code cache for a source from the process-wide compile cache,
+// or from the on-disk cache if --compile-cache-dir is set.
+function lookupCompileCache(kind, code, salt) {
+  const key = diskCache.getCacheKey(kind, code, salt);
+  let cachedData = getCompileCacheEntry(key);
+  if (cachedData === undefined) {
+    const entry = diskCache.read(key);
+    if (entry !== undefined && entry.cachedData !== undefined) {
+      cachedData = entry.cachedData;
+      setCompileCacheEntry(key, cachedData);
+    }
+  }
+  return { key, cachedData };
+}
+
+function storeCompileCache(entry, cachedData) {
+  if (cachedData === undefined)
+    return;
+  setCompileCacheEntry(entry.key, cachedData);
+  diskCache.save(entry, () => cachedData);
+}
+
 class Script extends ContextifyScript {
   constructor(code, options = {}) {
     code = `${code}`;
@@ -65,6 +95,7 @@ class Script extends ContextifyScript {
       columnOffset = 0,
       cachedData,
       produceCachedData = false,
+      compileCache = false,
       importModuleDynamically,
       [kParsingContext]: parsingContext,
     } = options;
@@ -83,6 +114,16 @@ class Script extends ContextifyScript {
       throw new ERR_INVALID_ARG_TYPE('options.produceCachedData', 'boolean',
                                      produceCachedData);
     }
+    validateBoolean(compileCache, 'options.compileCache');
+
+    // Explicitly passed cached data takes precedence over the compile cache.
+    let cacheEntry;
+    let data = cachedData;
+    if (compileCache && cachedData === undefined) {
+      cacheEntry = lookupCompileCache(
+        'vm-script', code, `${filename}:${lineOffset}:${columnOffset}`);
+      data = cacheEntry.cachedData;
+    }
 
     // Calling `ReThrow()` on a native TryCatch does not generate a new
     // abort-on-uncaught-exception check. A dummy try/catch in JS land
@@ -92,13 +133,18 @@ class Script extends ContextifyScript {
             filename,
             lineOffset,
             columnOffset,
-            cachedData,
+            data,
             produceCachedData,
             parsingContext);
     } catch (e) {
       throw e; /* node-do-not-add-exception-line */
     }
 
+    if (cacheEntry !== undefined &&
+        (data === undefined || this.cachedDataRejected)) {
+      storeCompileCache(cacheEntry, this.createCachedData());
+    }
+
     if (importModuleDynamically !== undefined) {
       if (typeof importModuleDynamically !== 'function') {
         throw new ERR_INVALID_ARG_TYPE('options.importModuleDynamically',
@@ -206,8 +252,8 @@ function isContext(object) {
 }
 
 let defaultContextNameIndex = 1;
-function createContext(contextObject = {}, options = {}) {
-  if (isContext(contextObject)) {
+function createContext(contextObject, options = {}) {
+  if (contextObject !== undefined && isContext(contextObject)) {
     return contextObject;
   }
 
@@ -216,7 +262,9 @@ function createContext(contextObject = {}, options = {}) {
   const {
     name = `VM Context ${defaultContextNameIndex++}`,
     origin,
-    codeGeneration
+    codeGeneration,
+    ownGlobal = false,
+    mode = 'attached'
   } = options;
 
   validateString(name, 'options.name');
@@ -233,10 +281,40 @@ function createContext(contextObject = {}, options = {}) {
     validateBoolean(wasm, 'options.codeGeneration.wasm');
   }
 
-  makeContext(contextObject, name, origin, strings, wasm);
+  if (mode !== 'attached' && mode !== 'detached') {
+    throw new ERR_INVALID_ARG_VALUE('options.mode', mode,
+                                    "must be 'attached' or 'detached'");
+  }
+  const detached = mode === 'detached';
+
+  validateBoolean(ownGlobal, 'options.ownGlobal');
+  if (ownGlobal) {
+    if (contextObject !== undefined) {
+      throw new ERR_INVALID_ARG_VALUE(
+        'options.ownGlobal', ownGlobal,
+        'requires contextObject to be undefined');
+    }
+    // The context's own global object is returned.
+    return makeContext(undefined, name, origin, strings, wasm, false);
+  }
+
+  if (contextObject === undefined)
+    contextObject = {};
+  makeContext(contextObject, name, origin, strings, wasm, detached);
+  if (detached) {
+    // The properties of a detached sandbox are copied once. Afterwards,
+    // they are only copied through getContextGlobal().
+    ObjectDefineProperties(_getContextGlobal(contextObject),
+                           ObjectGetOwnPropertyDescriptors(contextObject));
+  }
   return contextObject;
 }
 
+function getContextGlobal(contextifiedObject) {
+  validateContext(contextifiedObject);
+  return _getContextGlobal(contextifiedObject);
+}
+
 function createScript(code, options) {
   return new Script(code, options);
 }
@@ -305,6 +383,7 @@ function compileFunction(code, params, options = {}) {
     produceCachedData = false,
     parsingContext = undefined,
     contextExtensions = [],
+    compileCache = false,
   } = options;
 
   validateString(filename, 'options.filename');
@@ -331,19 +410,34 @@ function compileFunction(code, params, options = {}) {
     const name = `options.contextExtensions[${i}]`;
     validateObject(extension, name, { nullable: true });
   });
+  validateBoolean(compileCache, 'options.compileCache');
+
+  let cacheEntry;
+  let data = cachedData;
+  if (compileCache && cachedData === undefined) {
+    const salt = `${filename}:${lineOffset}:${columnOffset}:` +
+                 `${contextExtensions.length}:${params}`;
+    cacheEntry = lookupCompileCache('vm-function', code, salt);
+    data = cacheEntry.cachedData;
+  }
 
   const result = _compileFunction(
     code,
     filename,
     lineOffset,
     columnOffset,
-    cachedData,
+    data,
     produceCachedData,
     parsingContext,
     contextExtensions,
     params
   );
 
+  if (cacheEntry !== undefined &&
+      (data === undefined || result.cachedDataRejected)) {
+    storeCompileCache(cacheEntry, createFunctionCachedData(result.function));
+  }
+
   if (produceCachedData) {
     result.function.cachedDataProduced = result.cachedDataProduced;
   }
@@ -364,6 +458,7 @@ module.exports = {
   runInNewContext,
   runInThisContext,
   isContext,
+  getContextGlobal,
   compileFunction,
 };
 
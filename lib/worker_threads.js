@@ -5,7 +5,8 @@ const {
   SHARE_ENV,
   resourceLimits,
   threadId,
-  Worker
+  Worker,
+  WorkerPool
 } = require('internal/worker');
 
 const {
@@ -15,16 +16,34 @@ const {
   receiveMessageOnPort
 } = require('internal/worker/io');
 
+const {
+  createChannel,
+  openChannel
+} = require('internal/worker/channel');
+
+const {
+  notify,
+  waitAsync
+} = require('internal/worker/wait_async');
+
+const { SharedStore } = require('internal/worker/shared_store');
+
 module.exports = {
+  createChannel,
   isMainThread,
   MessagePort,
   MessageChannel,
   moveMessagePortToContext,
+  notify,
+  openChannel,
   receiveMessageOnPort,
   resourceLimits,
   threadId,
   SHARE_ENV,
+  SharedStore,
+  waitAsync,
   Worker,
+  WorkerPool,
   parentPort: null,
   workerData: null,
 };
@@ -25,6 +25,7 @@ const {
   Error,
   MathMax,
   NumberIsFinite,
+  NumberIsInteger,
   NumberIsNaN,
   ObjectDefineProperties,
   ObjectDefineProperty,
@@ -32,6 +33,7 @@ const {
   ObjectGetPrototypeOf,
   ObjectKeys,
   ObjectSetPrototypeOf,
+  SafeMap,
   Symbol,
 } = primordials;
 
@@ -40,6 +42,7 @@ const {
     ERR_BROTLI_INVALID_PARAM,
     ERR_BUFFER_TOO_LARGE,
     ERR_INVALID_ARG_TYPE,
+    ERR_INVALID_ARG_VALUE,
     ERR_OUT_OF_RANGE,
     ERR_ZLIB_INITIALIZATION_FAILED,
   },
@@ -62,6 +65,7 @@ const {
 const { owner_symbol } = require('internal/async_hooks').symbols;
 
 const kFlushFlag = Symbol('kFlushFlag');
+const kHandle = Symbol('kHandle');
 
 const constants = internalBinding('constants').zlib;
 const {
@@ -590,6 +594,34 @@ function _close(engine, callback) {
   engine._handle = null;
 }
 
+// A preset dictionary that can be shared by many zlib streams. The native
+// side keeps a single copy of it and reuses the state of streams that are
+// done, so that creating many short-lived streams with the same dictionary
+// does not require re-initializing zlib each time.
+//
+// The convenience methods use a pool without a dictionary in the same way,
+// since their streams never outlive the call.
+let oneShotStatePool;
+let creatingOneShotEngine = false;
+
+class Dictionary {
+  constructor(data) {
+    if (!isArrayBufferView(data)) {
+      if (isAnyArrayBuffer(data)) {
+        data = Buffer.from(data);
+      } else {
+        throw new ERR_INVALID_ARG_TYPE(
+          'data',
+          ['Buffer', 'TypedArray', 'DataView', 'ArrayBuffer'],
+          data
+        );
+      }
+    }
+    this[kHandle] = new binding.StatePool(data);
+    this.byteLength = data.byteLength;
+  }
+}
+
 const zlibDefaultOpts = {
   flush: Z_NO_FLUSH,
   finishFlush: Z_FINISH,
@@ -635,16 +667,24 @@ function Zlib(opts, mode) {
     if (dictionary !== undefined && !isArrayBufferView(dictionary)) {
       if (isAnyArrayBuffer(dictionary)) {
         dictionary = Buffer.from(dictionary);
+      } else if (dictionary instanceof Dictionary) {
+        dictionary = dictionary[kHandle];
       } else {
         throw new ERR_INVALID_ARG_TYPE(
           'options.dictionary',
-          ['Buffer', 'TypedArray', 'DataView', 'ArrayBuffer'],
+          ['Buffer', 'TypedArray', 'DataView', 'ArrayBuffer', 'Dictionary'],
           dictionary
         );
       }
     }
   }
 
+  if (dictionary === undefined && creatingOneShotEngine) {
+    if (oneShotStatePool === undefined)
+      oneShotStatePool = new binding.StatePool();
+    dictionary = oneShotStatePool;
+  }
+
   const handle = new binding.Zlib(mode);
   // Ideally, we could let ZlibBase() set up _writeState. I haven't been able
   // to come up with a good solution that doesn't break our internal API,
@@ -716,6 +756,8 @@ ObjectSetPrototypeOf(Inflate.prototype, Zlib.prototype);
 ObjectSetPrototypeOf(Inflate, Zlib);
 
 function Gzip(opts) {
+  if (opts && opts.parallel !== undefined)
+    return new ParallelGzip(opts);
   if (!(this instanceof Gzip))
     return new Gzip(opts);
   Zlib.call(this, opts, GZIP);
@@ -723,6 +765,182 @@ function Gzip(opts) {
 ObjectSetPrototypeOf(Gzip.prototype, Zlib.prototype);
 ObjectSetPrototypeOf(Gzip, Zlib);
 
+// Compresses blocks of kParallelBlockSize bytes on up to `parallel` threads
+// at once, see ParallelDeflate in node_zlib.cc. The output is a regular gzip
+// member, but slightly larger than that of Gzip, because every block starts
+// with a new deflate block and ends with a sync flush marker.
+const kParallelBlockSize = 128 * 1024;
+const kParallelDictionarySize = 32 * 1024;
+let parallelStatePool;
+
+function ParallelGzip(opts) {
+  const parallel = checkRangesOrGetDefault(
+    opts.parallel, 'options.parallel', 1, 1024, 1);
+  if (!NumberIsInteger(parallel))
+    throw new ERR_OUT_OF_RANGE('options.parallel', 'an integer', parallel);
+  const level = checkRangesOrGetDefault(
+    opts.level, 'options.level',
+    Z_MIN_LEVEL, Z_MAX_LEVEL, Z_DEFAULT_COMPRESSION);
+  const memLevel = checkRangesOrGetDefault(
+    opts.memLevel, 'options.memLevel',
+    Z_MIN_MEMLEVEL, Z_MAX_MEMLEVEL, Z_DEFAULT_MEMLEVEL);
+  const strategy = checkRangesOrGetDefault(
+    opts.strategy, 'options.strategy',
+    Z_DEFAULT_STRATEGY, Z_FIXED, Z_DEFAULT_STRATEGY);
+  if (opts.dictionary !== undefined) {
+    throw new ERR_INVALID_ARG_VALUE(
+      'options.dictionary', opts.dictionary,
+      'is not supported together with options.parallel');
+  }
+
+  if (opts.encoding || opts.objectMode || opts.writableObjectMode) {
+    opts = { ...opts };
+    opts.encoding = null;
+    opts.objectMode = false;
+    opts.writableObjectMode = false;
+  }
+  Transform.call(this, opts);
+
+  if (parallelStatePool === undefined)
+    parallelStatePool = new binding.StatePool();
+  this._handle = new binding.ParallelDeflate(
+    parallelStatePool, level, memLevel, strategy, parallelOnBlock);
+  this._handle[owner_symbol] = this;
+  this._parallel = parallel;
+  this._level = level;
+  this._strategy = strategy;
+  this._info = opts.info;
+  this.bytesWritten = 0;
+
+  this._pending = [];
+  this._pendingLength = 0;
+  this._previousBlock = undefined;
+  this._nextBlockId = 0;
+  this._nextOutputId = 0;
+  this._blocksInFlight = 0;
+  this._results = new SafeMap();
+  this._writeCallback = null;
+  this._flushCallback = null;
+  this._crc = 0;
+}
+ObjectSetPrototypeOf(ParallelGzip.prototype, Transform.prototype);
+ObjectSetPrototypeOf(ParallelGzip, Transform);
+
+ParallelGzip.prototype._submitBlock = function(block, last) {
+  const dictionary = this._previousBlock === undefined ? undefined :
+    this._previousBlock.subarray(
+      MathMax(0, this._previousBlock.length - kParallelDictionarySize));
+  const id = this._nextBlockId++;
+  const err = this._handle.compress(id, block, dictionary, last);
+  if (err !== codes.Z_OK) {
+    this.destroy(parallelBlockError(err));
+    return;
+  }
+  this._results.set(id, block.length);
+  this._previousBlock = block;
+  this._blocksInFlight++;
+};
+
+ParallelGzip.prototype._transform = function(chunk, encoding, cb) {
+  this.bytesWritten += chunk.length;
+  this._pending.push(chunk);
+  this._pendingLength += chunk.length;
+  while (this._pendingLength >= kParallelBlockSize) {
+    const pending = this._pending.length === 1 ?
+      this._pending[0] : Buffer.concat(this._pending, this._pendingLength);
+    const block = pending.subarray(0, kParallelBlockSize);
+    const rest = pending.subarray(kParallelBlockSize);
+    this._pending = rest.length > 0 ? [rest] : [];
+    this._pendingLength = rest.length;
+    this._submitBlock(block, false);
+  }
+  if (this._blocksInFlight < this._parallel)
+    cb();
+  else
+    this._writeCallback = cb;
+};
+
+ParallelGzip.prototype._flush = function(cb) {
+  this._submitBlock(Buffer.concat(this._pending, this._pendingLength), true);
+  this._pending = [];
+  this._pendingLength = 0;
+  this._flushCallback = cb;
+};
+
+ParallelGzip.prototype._destroy = function(err, callback) {
+  this._handle = null;
+  this._results.clear();
+  callback(err);
+};
+
+ParallelGzip.prototype.close = function(callback) {
+  if (callback)
+    process.nextTick(callback);
+  this.destroy();
+};
+
+function gzipHeader(level, strategy) {
+  let xfl = 0;
+  if (level === 9)
+    xfl = 2;
+  else if (level === 1 || strategy >= constants.Z_HUFFMAN_ONLY)
+    xfl = 4;
+  // ID1, ID2, CM = deflate, no flags, no mtime, XFL, OS = Unix.
+  return Buffer.from([0x1f, 0x8b, 8, 0, 0, 0, 0, 0, xfl, 3]);
+}
+
+function parallelBlockError(errno) {
+  // eslint-disable-next-line no-restricted-syntax
+  const error = new Error('zlib: Failed to compress block');
+  error.errno = errno;
+  error.code = codes[errno];
+  return error;
+}
+
+function parallelOnBlock(id, errno, output, crc) {
+  const self = this[owner_symbol];
+  if (self._handle === null)
+    return;
+  if (errno !== codes.Z_OK) {
+    self.destroy(parallelBlockError(errno));
+    return;
+  }
+  self._blocksInFlight--;
+  // Until it is done, a block's entry holds its input length.
+  self._results.set(id, { output, crc, length: self._results.get(id) });
+
+  let result;
+  while ((result = self._results.get(self._nextOutputId)) !== undefined &&
+         typeof result === 'object') {
+    self._results.delete(self._nextOutputId);
+    if (self._nextOutputId === 0) {
+      self.push(gzipHeader(self._level, self._strategy));
+      self._crc = result.crc;
+    } else {
+      self._crc = binding.crc32Combine(self._crc, result.crc, result.length);
+    }
+    self._nextOutputId++;
+    if (result.output.length > 0)
+      self.push(result.output);
+  }
+
+  if (self._flushCallback !== null &&
+      self._nextOutputId === self._nextBlockId) {
+    const trailer = Buffer.allocUnsafe(8);
+    trailer.writeUInt32LE(self._crc, 0);
+    trailer.writeUInt32LE(self.bytesWritten % 2 ** 32, 4);
+    self.push(trailer);
+    const cb = self._flushCallback;
+    self._flushCallback = null;
+    cb();
+  } else if (self._writeCallback !== null &&
+             self._blocksInFlight < self._parallel) {
+    const cb = self._writeCallback;
+    self._writeCallback = null;
+    cb();
+  }
+}
+
 function Gunzip(opts) {
   if (!(this instanceof Gunzip))
     return new Gunzip(opts);
@@ -756,10 +974,24 @@ function Unzip(opts) {
 ObjectSetPrototypeOf(Unzip.prototype, Zlib.prototype);
 ObjectSetPrototypeOf(Unzip, Zlib);
 
+function createOneShotEngine(ctor, opts) {
+  creatingOneShotEngine = true;
+  try {
+    return new ctor(opts);
+  } finally {
+    creatingOneShotEngine = false;
+  }
+}
+
 function createConvenienceMethod(ctor, sync) {
   if (sync) {
     return function syncBufferWrapper(buffer, opts) {
-      return zlibBufferSync(new ctor(opts), buffer);
+      if (ctor === Gzip && opts && opts.parallel !== undefined) {
+        throw new ERR_INVALID_ARG_VALUE(
+          'options.parallel', opts.parallel,
+          'is not supported by synchronous methods');
+      }
+      return zlibBufferSync(createOneShotEngine(ctor, opts), buffer);
     };
   } else {
     return function asyncBufferWrapper(buffer, opts, callback) {
@@ -767,7 +999,7 @@ function createConvenienceMethod(ctor, sync) {
         callback = opts;
         opts = {};
       }
-      return zlibBuffer(new ctor(opts), buffer, callback);
+      return zlibBuffer(createOneShotEngine(ctor, opts), buffer, callback);
     };
   }
 }
@@ -854,6 +1086,7 @@ ObjectDefineProperty(binding.Zlib.prototype, 'jsref', {
 });
 
 module.exports = {
+  Dictionary,
   Deflate,
   Inflate,
   Gzip,
@@ -102,6 +102,7 @@
       'lib/internal/child_process/serialization.js',
       'lib/internal/cluster/child.js',
       'lib/internal/cluster/master.js',
+      'lib/internal/cluster/reuse_port_handle.js',
       'lib/internal/cluster/round_robin_handle.js',
       'lib/internal/cluster/shared_handle.js',
       'lib/internal/cluster/utils.js',
@@ -121,6 +122,7 @@
       'lib/internal/crypto/util.js',
       'lib/internal/constants.js',
       'lib/internal/dgram.js',
+      'lib/internal/dns/lookup_cache.js',
       'lib/internal/dns/promises.js',
       'lib/internal/dns/utils.js',
       'lib/internal/dtrace.js',
@@ -130,6 +132,7 @@
       'lib/internal/fixed_queue.js',
       'lib/internal/freelist.js',
       'lib/internal/freeze_intrinsics.js',
+      'lib/internal/fs/buffered_write_stream.js',
       'lib/internal/fs/dir.js',
       'lib/internal/fs/promises.js',
       'lib/internal/fs/read_file_context.js',
@@ -157,6 +160,7 @@
       'lib/internal/modules/run_main.js',
       'lib/internal/modules/cjs/helpers.js',
       'lib/internal/modules/cjs/loader.js',
+      'lib/internal/modules/compile_cache.js',
       'lib/internal/modules/esm/loader.js',
       'lib/internal/modules/esm/create_dynamic_module.js',
       'lib/internal/modules/esm/get_format.js',
@@ -211,14 +215,20 @@
       'lib/internal/validators.js',
       'lib/internal/stream_base_commons.js',
       'lib/internal/vm/module.js',
+      'lib/internal/wasm_web_api.js',
+      'lib/internal/websocket.js',
       'lib/internal/worker.js',
+      'lib/internal/worker/channel.js',
       'lib/internal/worker/io.js',
+      'lib/internal/worker/shared_store.js',
+      'lib/internal/worker/wait_async.js',
       'lib/internal/watchdog.js',
       'lib/internal/streams/lazy_transform.js',
       'lib/internal/streams/async_iterator.js',
       'lib/internal/streams/buffer_list.js',
       'lib/internal/streams/duplexpair.js',
       'lib/internal/streams/from.js',
+      'lib/internal/streams/json_parse.js',
       'lib/internal/streams/legacy.js',
       'lib/internal/streams/destroy.js',
       'lib/internal/streams/state.js',
@@ -525,6 +535,8 @@
         'src/api/utils.cc',
 
         'src/async_wrap.cc',
+        'src/base64.cc',
+        'src/buffer_pool.cc',
         'src/cares_wrap.cc',
         'src/connect_wrap.cc',
         'src/connection_wrap.cc',
@@ -542,6 +554,7 @@
         'src/module_wrap.cc',
         'src/node.cc',
         'src/node_api.cc',
+        'src/node_atomics_waiter.cc',
         'src/node_binding.cc',
         'src/node_buffer.cc',
         'src/node_config.cc',
@@ -556,9 +569,11 @@
         'src/node_http_parser.cc',
         'src/node_http2.cc',
         'src/node_i18n.cc',
+        'src/node_json_parser.cc',
         'src/node_main_instance.cc',
         'src/node_messaging.cc',
         'src/node_metadata.cc',
+        'src/node_module_archive.cc',
         'src/node_native_module.cc',
         'src/node_native_module_env.cc',
         'src/node_options.cc',
@@ -570,6 +585,8 @@
         'src/node_process_methods.cc',
         'src/node_process_object.cc',
         'src/node_serdes.cc',
+        'src/node_shared_channel.cc',
+        'src/node_snapshot_builder.cc',
         'src/node_stat_watcher.cc',
         'src/node_symbols.cc',
         'src/node_task_queue.cc',
@@ -579,7 +596,9 @@
         'src/node_util.cc',
         'src/node_v8.cc',
         'src/node_wasi.cc',
+        'src/node_wasm_web_api.cc',
         'src/node_watchdog.cc',
+        'src/node_websocket.cc',
         'src/node_worker.cc',
         'src/node_zlib.cc',
         'src/pipe_wrap.cc',
@@ -594,12 +613,14 @@
         'src/tcp_wrap.cc',
         'src/timers.cc',
         'src/tracing/agent.cc',
+        'src/tracing/binary_trace_writer.cc',
         'src/tracing/node_trace_buffer.cc',
         'src/tracing/node_trace_writer.cc',
         'src/tracing/trace_event.cc',
         'src/tracing/traced_value.cc',
         'src/tty_wrap.cc',
         'src/udp_wrap.cc',
+        'src/utf8.cc',
         'src/util.cc',
         'src/uv.cc',
         # headers to make for a more pleasant IDE experience
@@ -609,6 +630,7 @@
         'src/base_object.h',
         'src/base_object-inl.h',
         'src/base64.h',
+        'src/buffer_pool.h',
         'src/connect_wrap.h',
         'src/connection_wrap.h',
         'src/debug_utils.h',
@@ -625,6 +647,7 @@
         'src/node.h',
         'src/node_api.h',
         'src/node_api_types.h',
+        'src/node_atomics_waiter.h',
         'src/node_binding.h',
         'src/node_buffer.h',
         'src/node_constants.h',
@@ -643,6 +666,7 @@
         'src/node_mem-inl.h',
         'src/node_messaging.h',
         'src/node_metadata.h',
+        'src/node_module_archive.h',
         'src/node_mutex.h',
         'src/node_native_module.h',
         'src/node_native_module_env.h',
@@ -655,6 +679,8 @@
         'src/node_process.h',
         'src/node_revert.h',
         'src/node_root_certs.h',
+        'src/node_shared_channel.h',
+        'src/node_snapshot_builder.h',
         'src/node_stat_watcher.h',
         'src/node_union_bytes.h',
         'src/node_url.h',
@@ -677,6 +703,7 @@
         'src/string_search.h',
         'src/tcp_wrap.h',
         'src/tracing/agent.h',
+        'src/tracing/binary_trace_writer.h',
         'src/tracing/node_trace_buffer.h',
         'src/tracing/node_trace_writer.h',
         'src/tracing/trace_event.h',
@@ -684,6 +711,7 @@
         'src/tracing/traced_value.h',
         'src/tty_wrap.h',
         'src/udp_wrap.h',
+        'src/utf8.h',
         'src/util.h',
         'src/util-inl.h',
         # Dependency headers
@@ -820,10 +848,14 @@
             'src/node_crypto.cc',
             'src/node_crypto_bio.cc',
             'src/node_crypto_clienthello.cc',
+            'src/node_crypto_scrypt.cc',
+            'src/node_crypto_session_cache.cc',
             'src/node_crypto.h',
             'src/node_crypto_bio.h',
             'src/node_crypto_clienthello.h',
             'src/node_crypto_clienthello-inl.h',
+            'src/node_crypto_scrypt.h',
+            'src/node_crypto_session_cache.h',
             'src/node_crypto_groups.h',
             'src/tls_wrap.cc',
             'src/tls_wrap.h'
@@ -1118,12 +1150,14 @@
         'test/cctest/test_aliased_buffer.cc',
         'test/cctest/test_base64.cc',
         'test/cctest/test_base_object_ptr.cc',
+        'test/cctest/test_node_mem.cc',
         'test/cctest/test_node_postmortem_metadata.cc',
         'test/cctest/test_environment.cc',
         'test/cctest/test_linked_binding.cc',
         'test/cctest/test_per_process.cc',
         'test/cctest/test_platform.cc',
         'test/cctest/test_traced_value.cc',
+        'test/cctest/test_utf8.cc',
         'test/cctest/test_util.cc',
         'test/cctest/test_url.cc',
       ],
@@ -1184,6 +1218,86 @@
       ],
     }, # cctest
 
+    {
+      'target_name': 'bench_native',
+      'type': 'executable',
+
+      'dependencies': [
+        '<(node_lib_target_name)',
+        'deps/histogram/histogram.gyp:histogram',
+        'deps/uvwasi/uvwasi.gyp:uvwasi',
+        'node_dtrace_header',
+        'node_dtrace_ustack',
+        'node_dtrace_provider',
+      ],
+
+      'includes': [
+        'node.gypi'
+      ],
+
+      'include_dirs': [
+        'src',
+        'tools/msvs/genfiles',
+        'deps/v8/include',
+        'deps/cares/include',
+        'deps/llhttp/include',
+        'deps/uv/include',
+        'deps/uvwasi/include',
+        'test/bench_native',
+      ],
+
+      'defines': [ 'NODE_WANT_INTERNALS=1' ],
+
+      'sources': [
+        'src/node_snapshot_stub.cc',
+        'src/node_code_cache_stub.cc',
+        'test/bench_native/bench_native.h',
+        'test/bench_native/bench_native_main.cc',
+        'test/bench_native/bench_histogram.cc',
+        'test/bench_native/bench_http_parser.cc',
+        'test/bench_native/bench_string_bytes.cc',
+        'test/bench_native/bench_url.cc',
+      ],
+
+      'conditions': [
+        [ 'node_use_openssl=="true"', {
+          'defines': [
+            'HAVE_OPENSSL=1',
+          ],
+          'sources': [
+            'test/bench_native/bench_node_bio.cc',
+          ],
+        }],
+        ['v8_enable_inspector==1', {
+          'defines': [
+            'HAVE_INSPECTOR=1',
+          ],
+        }, {
+           'defines': [
+             'HAVE_INSPECTOR=0',
+           ]
+        }],
+        ['OS=="solaris"', {
+          'ldflags': [ '-I<(SHARED_INTERMEDIATE_DIR)' ]
+        }],
+        [ 'OS=="win" and node_shared=="true"', {
+          'type': 'none',
+        }],
+        [ 'node_shared=="true"', {
+          'xcode_settings': {
+            'OTHER_LDFLAGS': [ '-Wl,-rpath,@loader_path', ],
+          },
+        }],
+        ['OS=="win"', {
+          'libraries': [
+            'Dbghelp.lib',
+            'winmm.lib',
+            'Ws2_32.lib',
+          ],
+        }],
+      ],
+    }, # bench_native
+
     # TODO(joyeecheung): do not depend on node_lib,
     # instead create a smaller static library node_lib_base that does
     # just enough for node_native_module.cc and the cache builder to
@@ -1264,8 +1378,6 @@
         'src/node_snapshot_stub.cc',
         'src/node_code_cache_stub.cc',
         'tools/snapshot/node_mksnapshot.cc',
-        'tools/snapshot/snapshot_builder.cc',
-        'tools/snapshot/snapshot_builder.h',
       ],
 
       'conditions': [
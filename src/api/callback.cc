@@ -1,6 +1,7 @@
 #include "node.h"
 #include "async_wrap-inl.h"
 #include "env-inl.h"
+#include "node_dtrace.h"
 #include "v8.h"
 
 namespace node {
@@ -49,7 +50,8 @@ InternalCallbackScope::InternalCallbackScope(Environment* env,
     async_context_(asyncContext),
     object_(object),
     skip_hooks_(flags & kSkipAsyncHooks),
-    skip_task_queues_(flags & kSkipTaskQueues) {
+    skip_task_queues_(flags & kSkipTaskQueues),
+    batch_task_queues_(flags & kBatchTaskQueues) {
   CHECK_NOT_NULL(env);
   env->PushAsyncCallbackScope();
 
@@ -58,6 +60,10 @@ InternalCallbackScope::InternalCallbackScope(Environment* env,
     return;
   }
 
+  // A callback that runs during the poll phase means that the event loop is
+  // no longer idle.
+  env->performance_state()->MarkLoopIdleEnd();
+
   HandleScope handle_scope(env->isolate());
   // If you hit this assertion, you forgot to enter the v8::Context first.
   CHECK_EQ(Environment::GetCurrent(env->isolate()), env);
@@ -101,6 +107,13 @@ void InternalCallbackScope::Close() {
     return;
   }
 
+  env_->scratch_arena()->Reset();
+
+  if (batch_task_queues_ && env_->tick_batch_active()) {
+    env_->set_tick_batch_pending();
+    return;
+  }
+
   TickInfo* tick_info = env_->tick_info();
 
   if (!env_->can_call_into_js()) return;
@@ -118,9 +131,13 @@ void InternalCallbackScope::Close() {
     CHECK_EQ(env_->trigger_async_id(), 0);
   }
 
-  if (!tick_info->has_tick_scheduled() && !tick_info->has_rejection_to_warn()) {
+  // Most callbacks do not schedule a tick, so this is the common way out.
+  if (LIKELY(!tick_info->has_tick_scheduled() &&
+             !tick_info->has_rejection_to_warn())) {
+    env_->callback_scope_stats()->fast_closes++;
     return;
   }
+  env_->callback_scope_stats()->slow_closes++;
 
   HandleScope handle_scope(env_->isolate());
   Local<Object> process = env_->process_object();
@@ -143,18 +160,21 @@ MaybeLocal<Value> InternalMakeCallback(Environment* env,
                                        const Local<Function> callback,
                                        int argc,
                                        Local<Value> argv[],
-                                       async_context asyncContext) {
+                                       async_context asyncContext,
+                                       int flags) {
   CHECK(!recv.IsEmpty());
 #ifdef DEBUG
   for (int i = 0; i < argc; i++)
     CHECK(!argv[i].IsEmpty());
 #endif
 
-  InternalCallbackScope scope(env, recv, asyncContext);
+  InternalCallbackScope scope(env, recv, asyncContext, flags);
   if (scope.Failed()) {
     return MaybeLocal<Value>();
   }
 
+  NODE_USDT_PROBE(CALLBACK_START, env,
+                  static_cast<int64_t>(asyncContext.async_id));
   Local<Function> domain_cb = env->domain_callback();
   MaybeLocal<Value> ret;
   if (asyncContext.async_id != 0 || domain_cb.IsEmpty()) {
@@ -165,6 +185,8 @@ MaybeLocal<Value> InternalMakeCallback(Environment* env,
     std::copy(&argv[0], &argv[argc], args.begin() + 1);
     ret = domain_cb->Call(env->context(), recv, args.size(), &args[0]);
   }
+  NODE_USDT_PROBE(CALLBACK_DONE, env,
+                  static_cast<int64_t>(asyncContext.async_id));
 
   if (ret.IsEmpty()) {
     scope.MarkAsFailed();
@@ -63,6 +63,8 @@ enum encoding ParseEncoding(const char* encoding,
     return ASCII;
   } else if (StringEqualNoCase(encoding, "base64")) {
     return BASE64;
+  } else if (StringEqualNoCase(encoding, "base64url")) {
+    return BASE64URL;
   } else if (StringEqualNoCase(encoding, "ucs2")) {
     return UCS2;
   } else if (StringEqualNoCase(encoding, "ucs-2")) {
@@ -7,6 +7,11 @@
 #include "node_v8_platform-inl.h"
 #include "uv.h"
 
+#include <cmath>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 namespace node {
 using errors::TryCatchScope;
 using v8::Array;
@@ -86,19 +91,24 @@ static void HostCleanupFinalizationGroupCallback(
   env->RegisterFinalizationGroupForCleanup(group);
 }
 
+NodeArrayBufferAllocator::NodeArrayBufferAllocator()
+    : pool_(per_process::cli_options->buffer_pool_huge_pages) {}
+
 void* NodeArrayBufferAllocator::Allocate(size_t size) {
-  void* ret;
-  if (zero_fill_field_ || per_process::cli_options->zero_fill_all_buffers)
-    ret = UncheckedCalloc(size);
-  else
-    ret = UncheckedMalloc(size);
+  const bool zero_fill =
+      zero_fill_field_ || per_process::cli_options->zero_fill_all_buffers;
+  void* ret = pool_.Allocate(size, zero_fill);
+  if (ret == nullptr)
+    ret = zero_fill ? UncheckedCalloc(size) : UncheckedMalloc(size);
   if (LIKELY(ret != nullptr))
     total_mem_usage_.fetch_add(size, std::memory_order_relaxed);
   return ret;
 }
 
 void* NodeArrayBufferAllocator::AllocateUninitialized(size_t size) {
-  void* ret = node::UncheckedMalloc(size);
+  void* ret = pool_.Allocate(size, false);
+  if (ret == nullptr)
+    ret = node::UncheckedMalloc(size);
   if (LIKELY(ret != nullptr))
     total_mem_usage_.fetch_add(size, std::memory_order_relaxed);
   return ret;
@@ -106,15 +116,41 @@ void* NodeArrayBufferAllocator::AllocateUninitialized(size_t size) {
 
 void* NodeArrayBufferAllocator::Reallocate(
     void* data, size_t old_size, size_t size) {
-  void* ret = UncheckedRealloc<char>(static_cast<char*>(data), size);
-  if (LIKELY(ret != nullptr) || UNLIKELY(size == 0))
+  const size_t block_size =
+      BufferPool::IsPoolSize(old_size) ? pool_.BlockSize(data) : 0;
+  if (block_size == 0 && !BufferPool::IsPoolSize(size)) {
+    void* ret = UncheckedRealloc<char>(static_cast<char*>(data), size);
+    if (LIKELY(ret != nullptr) || UNLIKELY(size == 0))
+      total_mem_usage_.fetch_add(size - old_size, std::memory_order_relaxed);
+    return ret;
+  }
+
+  // Pool blocks can be resized in place as long as the new size does not
+  // leave most of the block unused.
+  if (block_size != 0 && BufferPool::IsPoolSize(size) &&
+      size <= block_size && size > block_size / 2) {
     total_mem_usage_.fetch_add(size - old_size, std::memory_order_relaxed);
+    return data;
+  }
+
+  // Otherwise, move the data between the pool and malloc(). This calls the
+  // non-virtual implementations so that subclasses do not see the move as
+  // separate allocations.
+  if (size == 0) {
+    NodeArrayBufferAllocator::Free(data, old_size);
+    return nullptr;
+  }
+  void* ret = NodeArrayBufferAllocator::AllocateUninitialized(size);
+  if (ret == nullptr) return nullptr;
+  memcpy(ret, data, std::min(old_size, size));
+  NodeArrayBufferAllocator::Free(data, old_size);
   return ret;
 }
 
 void NodeArrayBufferAllocator::Free(void* data, size_t size) {
   total_mem_usage_.fetch_sub(size, std::memory_order_relaxed);
-  free(data);
+  if (!BufferPool::IsPoolSize(size) || !pool_.Free(data))
+    free(data);
 }
 
 DebuggingArrayBufferAllocator::~DebuggingArrayBufferAllocator() {
@@ -209,12 +245,148 @@ void FreeArrayBufferAllocator(ArrayBufferAllocator* allocator) {
   delete allocator;
 }
 
+#ifdef __linux__
+// Finds the cgroup of the process in the hierarchy of `controller`, or in the
+// cgroup v2 hierarchy if `controller` is empty, and returns its directory.
+// /proc/self/cgroup has one line per hierarchy, in the form
+// "<id>:<controller>[,<controller>...]:<path>", with no controllers for v2.
+static bool GetCgroupDirectory(const std::string& controller,
+                               std::string* directory) {
+  FILE* fp = fopen("/proc/self/cgroup", "re");
+  if (fp == nullptr)
+    return false;
+  char line[4096];
+  bool found = false;
+  while (!found && fgets(line, sizeof(line), fp) != nullptr) {
+    const char* controllers = strchr(line, ':');
+    const char* path = controllers ? strchr(controllers + 1, ':') : nullptr;
+    if (path == nullptr)
+      continue;
+    const std::string list(controllers + 1, path);
+    if (controller.empty()) {
+      found = list.empty();
+    } else {
+      found = ("," + list + ",").find("," + controller + ",") !=
+              std::string::npos;
+    }
+    if (found) {
+      *directory = "/sys/fs/cgroup";
+      if (!controller.empty())
+        *directory += "/" + controller;
+      *directory += path + 1;
+      while (!directory->empty() &&
+             (directory->back() == '\n' || directory->back() == '/')) {
+        directory->pop_back();
+      }
+    }
+  }
+  fclose(fp);
+  return found;
+}
+
+// Reads the first line of a file in the cgroup filesystem.
+static bool ReadCgroupFile(const std::string& path, std::string* contents) {
+  FILE* fp = fopen(path.c_str(), "re");
+  if (fp == nullptr)
+    return false;
+  char line[256];
+  const bool ok = fgets(line, sizeof(line), fp) != nullptr;
+  fclose(fp);
+  if (ok)
+    *contents = line;
+  return ok;
+}
+
+// libuv only reads the memory limit of cgroup v1. With cgroup v2, the limit
+// is in memory.max, which contains "max" if there is no limit.
+static uint64_t GetCgroupV2MemoryLimit() {
+  std::string directory;
+  std::string contents;
+  if (!GetCgroupDirectory("", &directory) ||
+      !ReadCgroupFile(directory + "/memory.max", &contents)) {
+    return 0;
+  }
+  return strtoull(contents.c_str(), nullptr, 10);
+}
+
+// Returns the number of CPUs that the CFS bandwidth quota of the cgroup lets
+// the process use, rounded up, or 0 if there is no quota. With cgroup v2,
+// cpu.max contains "<quota> <period>", where the quota is "max" if there is
+// none. With cgroup v1, the quota is in cpu.cfs_quota_us and is -1 if there
+// is none.
+static unsigned int GetCgroupCpuQuota() {
+  std::string directory;
+  std::string quota;
+  std::string period;
+  if (GetCgroupDirectory("", &directory) &&
+      ReadCgroupFile(directory + "/cpu.max", &quota)) {
+    const size_t space = quota.find(' ');
+    if (space == std::string::npos)
+      return 0;
+    period = quota.substr(space + 1);
+  } else if (!GetCgroupDirectory("cpu", &directory) ||
+             !ReadCgroupFile(directory + "/cpu.cfs_quota_us", &quota) ||
+             !ReadCgroupFile(directory + "/cpu.cfs_period_us", &period)) {
+    return 0;
+  }
+  const double quota_us = strtod(quota.c_str(), nullptr);
+  const double period_us = strtod(period.c_str(), nullptr);
+  if (quota_us <= 0 || period_us <= 0)
+    return 0;
+  return static_cast<unsigned int>(std::ceil(quota_us / period_us));
+}
+#endif  // __linux__
+
+uint64_t GetAvailableMemory() {
+  static const uint64_t available_memory = []() {
+    uint64_t constrained_memory = uv_get_constrained_memory();
+#ifdef __linux__
+    if (constrained_memory == 0)
+      constrained_memory = GetCgroupV2MemoryLimit();
+#endif
+    // Without a limit, cgroup v1 reports a value close to 2^63.
+    return constrained_memory > 0 ?
+        std::min(uv_get_total_memory(), constrained_memory) :
+        uv_get_total_memory();
+  }();
+  return available_memory;
+}
+
+unsigned int GetAvailableParallelism() {
+  static const unsigned int available_parallelism = []() {
+    unsigned int cpus = 0;
+#ifdef __linux__
+    // The CPUs of the cpuset of the process, unless it was restricted further.
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+      cpus = CPU_COUNT(&set);
+    const unsigned int quota = GetCgroupCpuQuota();
+    if (quota > 0 && (cpus == 0 || quota < cpus))
+      cpus = quota;
+#endif
+    if (cpus == 0) {
+      uv_cpu_info_t* cpu_infos;
+      int count;
+      if (uv_cpu_info(&cpu_infos, &count) == 0) {
+        cpus = count;
+        uv_free_cpu_info(cpu_infos, count);
+      }
+    }
+    return std::max(cpus, 1u);
+  }();
+  return available_parallelism;
+}
+
 void SetIsolateCreateParamsForNode(Isolate::CreateParams* params) {
-  const uint64_t constrained_memory = uv_get_constrained_memory();
-  const uint64_t total_memory = constrained_memory > 0 ?
-      std::min(uv_get_total_memory(), constrained_memory) :
-      uv_get_total_memory();
-  if (total_memory > 0) {
+  const uint64_t total_memory = GetAvailableMemory();
+  if (total_memory == 0)
+    return;
+  const uint64_t percentage = per_process::cli_options->heap_memory_percentage;
+  if (percentage > 0) {
+    // Let V8 split the heap into the young and the old generation.
+    params->constraints.ConfigureDefaultsFromHeapSize(
+        0, static_cast<size_t>(total_memory / 100 * percentage));
+  } else {
     // V8 defaults to 700MB or 1.4GB on 32 and 64 bit platforms respectively.
     // This default is based on browser use-cases. Tell V8 to configure the
     // heap based on the actual physical memory.
@@ -250,6 +422,10 @@ void SetIsolateMiscHandlers(v8::Isolate* isolate, const IsolateSettings& s) {
     s.allow_wasm_code_generation_callback : AllowWasmCodeGenerationCallback;
   isolate->SetAllowWasmCodeGenerationCallback(allow_wasm_codegen_cb);
 
+  // WebAssembly.compileStreaming() is only installed in contexts that are
+  // created after this has been set.
+  isolate->SetWasmStreamingCallback(wasm_web_api::StartStreamingCompilation);
+
   auto* promise_reject_cb = s.promise_reject_callback ?
     s.promise_reject_callback : task_queue::PromiseRejectCallback;
   isolate->SetPromiseRejectCallback(promise_reject_cb);
@@ -28,6 +28,7 @@
 
 #include "v8.h"
 
+using v8::Array;
 using v8::Context;
 using v8::DontDelete;
 using v8::EscapableHandleScope;
@@ -407,6 +408,32 @@ void AsyncWrap::PopAsyncContext(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// executionAsyncResource(index) returns a resource of the execution stack that
+// was pushed from C++, and therefore is not in execution_async_resources.
+static void ExecutionAsyncResource(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsUint32());
+  Local<Value> resource = env->async_hooks()->execution_async_resource(
+      args[0].As<Uint32>()->Value());
+  if (!resource.IsEmpty())
+    args.GetReturnValue().Set(resource);
+}
+
+
+// getCallbackScopeStats() returns [fastCloses, slowCloses], see
+// Environment::CallbackScopeStats.
+static void GetCallbackScopeStats(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Environment::CallbackScopeStats* stats = env->callback_scope_stats();
+  Local<Value> values[] = {
+    Number::New(env->isolate(), static_cast<double>(stats->fast_closes)),
+    Number::New(env->isolate(), static_cast<double>(stats->slow_closes))
+  };
+  args.GetReturnValue().Set(
+      Array::New(env->isolate(), values, arraysize(values)));
+}
+
+
 void AsyncWrap::AsyncReset(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsObject());
 
@@ -466,6 +493,10 @@ void AsyncWrap::Initialize(Local<Object> target,
   env->SetMethod(target, "setupHooks", SetupHooks);
   env->SetMethod(target, "pushAsyncContext", PushAsyncContext);
   env->SetMethod(target, "popAsyncContext", PopAsyncContext);
+  env->SetMethodNoSideEffect(target, "executionAsyncResource",
+                             ExecutionAsyncResource);
+  env->SetMethodNoSideEffect(target, "getCallbackScopeStats",
+                             GetCallbackScopeStats);
   env->SetMethod(target, "queueDestroyAsyncId", QueueDestroyAsyncId);
   env->SetMethod(target, "enablePromiseHook", EnablePromiseHook);
   env->SetMethod(target, "disablePromiseHook", DisablePromiseHook);
@@ -506,6 +537,10 @@ void AsyncWrap::Initialize(Local<Object> target,
                          "execution_async_resources",
                          env->async_hooks()->execution_async_resources());
 
+  FORCE_SET_TARGET_FIELD(target,
+                         "top_level_resource",
+                         env->async_hooks()->top_level_resource());
+
   target->Set(context,
               env->async_ids_stack_string(),
               env->async_hooks()->async_ids_stack().GetJSArray()).Check();
@@ -514,6 +549,11 @@ void AsyncWrap::Initialize(Local<Object> target,
               FIXED_ONE_BYTE_STRING(env->isolate(), "owner_symbol"),
               env->owner_symbol()).Check();
 
+  target->Set(context,
+              FIXED_ONE_BYTE_STRING(env->isolate(),
+                                    "async_context_frame_symbol"),
+              env->async_context_frame_symbol()).Check();
+
   Local<Object> constants = Object::New(isolate);
 #define SET_HOOKS_CONSTANT(name)                                              \
   FORCE_SET_TARGET_FIELD(                                                     \
@@ -531,6 +571,7 @@ void AsyncWrap::Initialize(Local<Object> target,
   SET_HOOKS_CONSTANT(kAsyncIdCounter);
   SET_HOOKS_CONSTANT(kDefaultTriggerAsyncId);
   SET_HOOKS_CONSTANT(kStackLength);
+  SET_HOOKS_CONSTANT(kUsesAsyncContext);
 #undef SET_HOOKS_CONSTANT
   FORCE_SET_TARGET_FIELD(target, "constants", constants);
 
@@ -593,6 +634,17 @@ AsyncWrap::AsyncWrap(Environment* env, Local<Object> object)
   : BaseObject(env, object) {
 }
 
+AsyncWrap::AsyncWrap(Environment* env,
+                     Local<Object> object,
+                     ProviderType provider,
+                     NoCleanupHook no_cleanup_hook)
+    : BaseObject(env, object, no_cleanup_hook) {
+  CHECK_NE(provider, PROVIDER_NONE);
+  provider_type_ = provider;
+  AsyncReset(kInvalidAsyncId, false);
+  init_hook_ran_ = true;
+}
+
 // This method is necessary to work around one specific problem:
 // Before the init() hook runs, if there is one, the BaseObject() constructor
 // registers this object with the Environment for finilization and debugging
@@ -680,6 +732,14 @@ void AsyncWrap::AsyncReset(Local<Object> resource, double execution_async_id,
     resource_.Reset(env()->isolate(), resource);
   }
 
+  // Propagate the AsyncLocalStorage stores without calling into JS.
+  if (env()->async_hooks()->fields()[AsyncHooks::kUsesAsyncContext] > 0) {
+    HandleScope handle_scope(env()->isolate());
+    env()->async_hooks()->InheritAsyncContextFrame(resource);
+    if (resource != object())
+      env()->async_hooks()->InheritAsyncContextFrame(object());
+  }
+
   switch (provider_type()) {
 #define V(PROVIDER)                                                           \
     case PROVIDER_ ## PROVIDER:                                               \
@@ -702,7 +762,9 @@ void AsyncWrap::AsyncReset(Local<Object> resource, double execution_async_id,
       UNREACHABLE();
   }
 
-  if (silent) return;
+  // Looking up the provider string is not needed if there are no init hooks.
+  if (silent || env()->async_hooks()->fields()[AsyncHooks::kInit] == 0)
+    return;
 
   EmitAsyncInit(env(), resource,
                 env()->async_hooks()->provider_string(provider_type()),
@@ -747,7 +809,8 @@ MaybeLocal<Value> AsyncWrap::MakeCallback(const Local<Function> cb,
   ProviderType provider = provider_type();
   async_context context { get_async_id(), get_trigger_async_id() };
   MaybeLocal<Value> ret = InternalMakeCallback(
-      env(), object(), cb, argc, argv, context);
+      env(), object(), cb, argc, argv, context,
+      InternalCallbackScope::kBatchTaskQueues);
 
   // This is a static call with cached values because the `this` object may
   // no longer be alive at this point.
@@ -33,6 +33,7 @@ namespace node {
 
 #define NODE_ASYNC_NON_CRYPTO_PROVIDER_TYPES(V)                               \
   V(NONE)                                                                     \
+  V(ATOMICSWAITER)                                                            \
   V(DIRHANDLE)                                                                \
   V(DNSCHANNEL)                                                               \
   V(ELDHISTOGRAM)                                                             \
@@ -51,6 +52,7 @@ namespace node {
   V(HTTPINCOMINGMESSAGE)                                                      \
   V(HTTPCLIENTREQUEST)                                                        \
   V(JSSTREAM)                                                                 \
+  V(MEMORYSTATSSAMPLER)                                                       \
   V(MESSAGEPORT)                                                              \
   V(PIPECONNECTWRAP)                                                          \
   V(PIPESERVERWRAP)                                                           \
@@ -58,17 +60,21 @@ namespace node {
   V(PROCESSWRAP)                                                              \
   V(PROMISE)                                                                  \
   V(QUERYWRAP)                                                                \
+  V(REPORTWRITEREQ)                                                           \
   V(SHUTDOWNWRAP)                                                             \
+  V(SHAREDCHANNEL)                                                            \
   V(SIGNALWRAP)                                                               \
   V(STATWATCHER)                                                              \
   V(STREAMPIPE)                                                               \
   V(TCPCONNECTWRAP)                                                           \
   V(TCPSERVERWRAP)                                                            \
   V(TCPWRAP)                                                                  \
+  V(TIMERWHEEL)                                                               \
   V(TTYWRAP)                                                                  \
   V(UDPSENDWRAP)                                                              \
   V(UDPWRAP)                                                                  \
   V(SIGINTWATCHDOG)                                                           \
+  V(WEBSOCKETRECEIVER)                                                        \
   V(WORKER)                                                                   \
   V(WORKERHEAPSNAPSHOT)                                                       \
   V(WRITEWRAP)                                                                \
@@ -77,9 +83,14 @@ namespace node {
 #if HAVE_OPENSSL
 #define NODE_ASYNC_CRYPTO_PROVIDER_TYPES(V)                                   \
   V(PBKDF2REQUEST)                                                            \
+  V(CRYPTOUPDATEREQUEST)                                                      \
+  V(DIFFIEHELLMANBATCHREQUEST)                                                \
+  V(HASHREQUEST)                                                              \
   V(KEYPAIRGENREQUEST)                                                        \
   V(RANDOMBYTESREQUEST)                                                       \
   V(SCRYPTREQUEST)                                                            \
+  V(VERIFYBATCHREQUEST)                                                       \
+  V(SECURECONTEXTLOADREQUEST)                                                 \
   V(TLSWRAP)
 #else
 #define NODE_ASYNC_CRYPTO_PROVIDER_TYPES(V)
@@ -119,6 +130,12 @@ class AsyncWrap : public BaseObject {
   // to call set_provider_type() and AsyncReset() before use.
   AsyncWrap(Environment* env, v8::Local<v8::Object> object);
 
+  // Used by ReqWrap, see BaseObject::NoCleanupHook.
+  AsyncWrap(Environment* env,
+            v8::Local<v8::Object> object,
+            ProviderType provider,
+            NoCleanupHook no_cleanup_hook);
+
   ~AsyncWrap() override;
 
   AsyncWrap() = delete;
@@ -0,0 +1,280 @@
+#include "base64.h"
+
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NODE_BASE64_X86 1
+#include <immintrin.h>
+#endif
+
+namespace node {
+namespace {
+
+// The vectorized kernels follow the approach described by Wojciech Muła and
+// Daniel Lemire in "Faster Base64 Encoding and Decoding Using AVX2
+// Instructions" (https://arxiv.org/abs/1704.00605): bytes are moved into
+// place with a shuffle, the 6-bit indices are split out with multiplications,
+// and indices are translated to and from ASCII with a few comparisons
+// instead of a table lookup per byte.
+//
+// Decoding accepts both the standard and the URL-safe alphabet, like
+// unbase64_table does. A vector that contains anything else, such as
+// whitespace or padding, ends the vectorized part, and the scalar code in
+// base64.h takes over.
+
+#ifdef NODE_BASE64_X86
+
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+// Translates 6-bit indices into ASCII. |shift| maps the result of the range
+// computation to the offset to add, see below.
+SSSE3_TARGET inline __m128i EncodeLookup(__m128i indices, __m128i shift) {
+  // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12.
+  __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  range = _mm_or_si128(range, _mm_and_si128(less, _mm_set1_epi8(13)));
+  return _mm_add_epi8(indices, _mm_shuffle_epi8(shift, range));
+}
+
+SSSE3_TARGET inline __m128i EncodeShift(Base64Mode mode) {
+  const char plus = mode == Base64Mode::URL ? '-' : '+';
+  const char slash = mode == Base64Mode::URL ? '_' : '/';
+  return _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                       '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                       '0' - 52, plus - 62, slash - 63, 'A', 0, 0);
+}
+
+// Spreads the 12 low bytes of |in| into 16 6-bit indices.
+SSSE3_TARGET inline __m128i EncodeSplit(__m128i in) {
+  in = _mm_shuffle_epi8(
+      in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+  const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+  const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+  const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(t1, t3);
+}
+
+SSSE3_TARGET size_t EncodeSSSE3(const char* src,
+                                size_t slen,
+                                char* dst,
+                                Base64Mode mode) {
+  const __m128i shift = EncodeShift(mode);
+  size_t i = 0;
+  // Every iteration loads 16 bytes, but only consumes 12 of them.
+  for (; i + 16 <= slen; i += 12, dst += 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     EncodeLookup(EncodeSplit(in), shift));
+  }
+  return i;
+}
+
+// Returns false if |in| contains a character that is in neither alphabet.
+// Otherwise, stores the 6-bit values of its characters in |values|.
+SSSE3_TARGET inline bool DecodeLookup(__m128i in, __m128i* values) {
+  const __m128i upper =
+      _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)),
+                    _mm_cmplt_epi8(in, _mm_set1_epi8('Z' + 1)));
+  const __m128i lower =
+      _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)),
+                    _mm_cmplt_epi8(in, _mm_set1_epi8('z' + 1)));
+  const __m128i digit =
+      _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)),
+                    _mm_cmplt_epi8(in, _mm_set1_epi8('9' + 1)));
+  const __m128i plus = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('+')),
+                                    _mm_cmpeq_epi8(in, _mm_set1_epi8('-')));
+  const __m128i slash = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('/')),
+                                     _mm_cmpeq_epi8(in, _mm_set1_epi8('_')));
+  const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                                     _mm_or_si128(digit,
+                                                  _mm_or_si128(plus, slash)));
+  if (_mm_movemask_epi8(valid) != 0xffff)
+    return false;
+
+  __m128i v = _mm_and_si128(upper, _mm_sub_epi8(in, _mm_set1_epi8('A')));
+  v = _mm_or_si128(v, _mm_and_si128(
+      lower, _mm_sub_epi8(in, _mm_set1_epi8('a' - 26))));
+  v = _mm_or_si128(v, _mm_and_si128(
+      digit, _mm_add_epi8(in, _mm_set1_epi8(52 - '0'))));
+  v = _mm_or_si128(v, _mm_and_si128(plus, _mm_set1_epi8(62)));
+  *values = _mm_or_si128(v, _mm_and_si128(slash, _mm_set1_epi8(63)));
+  return true;
+}
+
+// Packs 16 6-bit values into 12 bytes at the start of the result.
+SSSE3_TARGET inline __m128i DecodePack(__m128i values) {
+  const __m128i merged =
+      _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+  const __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+  return _mm_shuffle_epi8(
+      packed,
+      _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+SSSE3_TARGET size_t DecodeSSSE3(char* dst,
+                                size_t dstlen,
+                                const char* src,
+                                size_t srclen) {
+  size_t i = 0;
+  size_t k = 0;
+  // Every iteration stores exactly the 12 bytes that it produces, so that
+  // nothing past the decoded data is written when decoding stops early.
+  while (i + 16 <= srclen && k + 12 <= dstlen) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i values;
+    if (!DecodeLookup(in, &values))
+      break;
+    const __m128i packed = DecodePack(values);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + k), packed);
+    const uint32_t last = _mm_cvtsi128_si32(_mm_srli_si128(packed, 8));
+    memcpy(dst + k + 8, &last, sizeof(last));
+    i += 16;
+    k += 12;
+  }
+  return i;
+}
+
+// The AVX2 versions do the same on two 128-bit lanes at once.
+
+AVX2_TARGET size_t EncodeAVX2(const char* src,
+                              size_t slen,
+                              char* dst,
+                              Base64Mode mode) {
+  const __m256i shift = _mm256_broadcastsi128_si256(EncodeShift(mode));
+  const __m256i split_shuffle = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+  size_t i = 0;
+  // Every iteration loads 28 bytes, but only consumes 24 of them.
+  for (; i + 28 <= slen; i += 24, dst += 32) {
+    const __m128i lo =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i hi =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+    __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    in = _mm256_shuffle_epi8(in, split_shuffle);
+    const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    const __m256i indices = _mm256_or_si256(t1, t3);
+
+    __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    range = _mm256_or_si256(range,
+                            _mm256_and_si256(less, _mm256_set1_epi8(13)));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst),
+        _mm256_add_epi8(indices, _mm256_shuffle_epi8(shift, range)));
+  }
+  return i + EncodeSSSE3(src + i, slen - i, dst, mode);
+}
+
+AVX2_TARGET inline __m256i InRange(__m256i in, char lo, char hi) {
+  return _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8(lo - 1)),
+                          _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), in));
+}
+
+AVX2_TARGET size_t DecodeAVX2(char* dst,
+                              size_t dstlen,
+                              const char* src,
+                              size_t srclen) {
+  size_t i = 0;
+  size_t k = 0;
+  // Every iteration stores exactly the 24 bytes that it produces.
+  while (i + 32 <= srclen && k + 24 <= dstlen) {
+    const __m256i in =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i upper = InRange(in, 'A', 'Z');
+    const __m256i lower = InRange(in, 'a', 'z');
+    const __m256i digit = InRange(in, '0', '9');
+    const __m256i plus =
+        _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('+')),
+                        _mm256_cmpeq_epi8(in, _mm256_set1_epi8('-')));
+    const __m256i slash =
+        _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('/')),
+                        _mm256_cmpeq_epi8(in, _mm256_set1_epi8('_')));
+    const __m256i valid =
+        _mm256_or_si256(_mm256_or_si256(upper, lower),
+                        _mm256_or_si256(digit, _mm256_or_si256(plus, slash)));
+    if (_mm256_movemask_epi8(valid) != -1)
+      break;
+
+    __m256i v =
+        _mm256_and_si256(upper, _mm256_sub_epi8(in, _mm256_set1_epi8('A')));
+    v = _mm256_or_si256(v, _mm256_and_si256(
+        lower, _mm256_sub_epi8(in, _mm256_set1_epi8('a' - 26))));
+    v = _mm256_or_si256(v, _mm256_and_si256(
+        digit, _mm256_add_epi8(in, _mm256_set1_epi8(52 - '0'))));
+    v = _mm256_or_si256(v, _mm256_and_si256(plus, _mm256_set1_epi8(62)));
+    v = _mm256_or_si256(v, _mm256_and_si256(slash, _mm256_set1_epi8(63)));
+
+    const __m256i merged =
+        _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+    __m256i packed =
+        _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+    packed = _mm256_shuffle_epi8(packed, _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                      -1, -1, -1, -1)));
+    // Move the 12 bytes of the upper lane next to those of the lower one.
+    packed = _mm256_permutevar8x32_epi32(
+        packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k),
+                     _mm256_castsi256_si128(packed));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + k + 16),
+                     _mm256_extracti128_si256(packed, 1));
+    i += 32;
+    k += 24;
+  }
+  return i + DecodeSSSE3(dst + k, dstlen - k, src + i, srclen - i);
+}
+
+#undef SSSE3_TARGET
+#undef AVX2_TARGET
+
+#endif  // NODE_BASE64_X86
+
+struct Base64Kernels {
+  size_t (*encode)(const char* src, size_t slen, char* dst, Base64Mode mode);
+  size_t (*decode)(char* dst, size_t dstlen, const char* src, size_t srclen);
+};
+
+Base64Kernels SelectKernels() {
+#ifdef NODE_BASE64_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return { EncodeAVX2, DecodeAVX2 };
+  if (__builtin_cpu_supports("ssse3"))
+    return { EncodeSSSE3, DecodeSSSE3 };
+#endif
+  return { nullptr, nullptr };
+}
+
+const Base64Kernels& GetKernels() {
+  static const Base64Kernels kernels = SelectKernels();
+  return kernels;
+}
+
+}  // anonymous namespace
+
+size_t base64_encode_vector(const char* src,
+                            size_t slen,
+                            char* dst,
+                            Base64Mode mode) {
+  const Base64Kernels& kernels = GetKernels();
+  return kernels.encode != nullptr ? kernels.encode(src, slen, dst, mode) : 0;
+}
+
+size_t base64_decode_vector(char* dst,
+                            size_t dstlen,
+                            const char* src,
+                            size_t srclen) {
+  const Base64Kernels& kernels = GetKernels();
+  return kernels.decode != nullptr ?
+      kernels.decode(dst, dstlen, src, srclen) : 0;
+}
+
+}  // namespace node
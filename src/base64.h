@@ -10,8 +10,17 @@
 
 namespace node {
 //// Base 64 ////
-static inline constexpr size_t base64_encoded_size(size_t size) {
-  return ((size + 2 - ((size + 2) % 3)) / 3 * 4);
+
+enum class Base64Mode {
+  NORMAL,
+  URL
+};
+
+static inline constexpr size_t base64_encoded_size(
+    size_t size, Base64Mode mode = Base64Mode::NORMAL) {
+  // base64url output is not padded.
+  return mode == Base64Mode::NORMAL ? ((size + 2 - ((size + 2) % 3)) / 3 * 4)
+                                    : (size / 3 * 4 + (size % 3 * 4 + 2) / 3);
 }
 
 // Doesn't check for padding at the end.  Can be 1-2 bytes over.
@@ -49,6 +58,21 @@ size_t base64_decoded_size(const TypeName* src, size_t size) {
 extern const int8_t unbase64_table[256];
 
 
+// SIMD kernels, see base64.cc. Both return how much of |src| they have
+// processed when they stop, which is a multiple of 3 input bytes (encoding)
+// or of 4 characters (decoding). Whatever is left, including anything that
+// is not a base64 or base64url character, is handled by the scalar code
+// below. They return 0 if the CPU has no supported vector extension.
+size_t base64_encode_vector(const char* src,
+                            size_t slen,
+                            char* dst,
+                            Base64Mode mode);
+size_t base64_decode_vector(char* dst,
+                            size_t dstlen,
+                            const char* src,
+                            size_t srclen);
+
+
 inline static int8_t unbase64(uint8_t x) {
   return unbase64_table[x];
 }
@@ -94,6 +118,11 @@ size_t base64_decode_fast(char* const dst, const size_t dstlen,
   size_t max_i = srclen / 4 * 4;
   size_t i = 0;
   size_t k = 0;
+  if (sizeof(TypeName) == 1) {
+    i = base64_decode_vector(
+        dst, max_k, reinterpret_cast<const char*>(src), max_i);
+    k = i / 4 * 3;
+  }
   while (i < max_i && k < max_k) {
     const uint32_t v =
         unbase64(src[i + 0]) << 24 |
@@ -105,6 +134,14 @@ size_t base64_decode_fast(char* const dst, const size_t dstlen,
       if (!base64_decode_group_slow(dst, dstlen, src, srclen, &i, &k))
         return k;
       max_i = i + (srclen - i) / 4 * 4;  // Align max_i again.
+      if (sizeof(TypeName) == 1 && k < max_k) {
+        // Continue with the vector code, e.g. after a line break.
+        const size_t n = base64_decode_vector(
+            dst + k, max_k - k, reinterpret_cast<const char*>(src + i),
+            max_i - i);
+        i += n;
+        k += n / 4 * 3;
+      }
     } else {
       dst[k + 0] = ((v >> 22) & 0xFC) | ((v >> 20) & 0x03);
       dst[k + 1] = ((v >> 12) & 0xF0) | ((v >> 10) & 0x0F);
@@ -130,26 +167,32 @@ size_t base64_decode(char* const dst, const size_t dstlen,
 static size_t base64_encode(const char* src,
                             size_t slen,
                             char* dst,
-                            size_t dlen) {
+                            size_t dlen,
+                            Base64Mode mode = Base64Mode::NORMAL) {
   // We know how much we'll write, just make sure that there's space.
-  CHECK(dlen >= base64_encoded_size(slen) &&
+  CHECK(dlen >= base64_encoded_size(slen, mode) &&
         "not enough space provided for base64 encode");
 
-  dlen = base64_encoded_size(slen);
+  dlen = base64_encoded_size(slen, mode);
 
   unsigned a;
   unsigned b;
   unsigned c;
-  unsigned i;
-  unsigned k;
-  unsigned n;
-
-  static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-                              "abcdefghijklmnopqrstuvwxyz"
-                              "0123456789+/";
-
-  i = 0;
-  k = 0;
+  size_t i;
+  size_t k;
+  size_t n;
+
+  static const char normal_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                     "abcdefghijklmnopqrstuvwxyz"
+                                     "0123456789+/";
+  static const char url_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                  "abcdefghijklmnopqrstuvwxyz"
+                                  "0123456789-_";
+  const char* const table =
+      mode == Base64Mode::NORMAL ? normal_table : url_table;
+
+  i = base64_encode_vector(src, slen, dst, mode);
+  k = i / 3 * 4;
   n = slen / 3 * 3;
 
   while (i < n) {
@@ -172,8 +215,10 @@ static size_t base64_encode(const char* src,
         a = src[i + 0] & 0xff;
         dst[k + 0] = table[a >> 2];
         dst[k + 1] = table[(a & 3) << 4];
-        dst[k + 2] = '=';
-        dst[k + 3] = '=';
+        if (mode == Base64Mode::NORMAL) {
+          dst[k + 2] = '=';
+          dst[k + 3] = '=';
+        }
         break;
 
       case 2:
@@ -182,7 +227,8 @@ static size_t base64_encode(const char* src,
         dst[k + 0] = table[a >> 2];
         dst[k + 1] = table[((a & 3) << 4) | (b >> 4)];
         dst[k + 2] = table[(b & 0x0f) << 2];
-        dst[k + 3] = '=';
+        if (mode == Base64Mode::NORMAL)
+          dst[k + 3] = '=';
         break;
     }
   }
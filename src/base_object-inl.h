@@ -40,17 +40,24 @@
 namespace node {
 
 BaseObject::BaseObject(Environment* env, v8::Local<v8::Object> object)
+    : BaseObject(env, object, NoCleanupHook()) {
+  env->AddCleanupHook(this);
+}
+
+BaseObject::BaseObject(Environment* env,
+                       v8::Local<v8::Object> object,
+                       NoCleanupHook)
     : persistent_handle_(env->isolate(), object), env_(env) {
   CHECK_EQ(false, object.IsEmpty());
   CHECK_GT(object->InternalFieldCount(), 0);
   object->SetAlignedPointerInInternalField(0, static_cast<void*>(this));
-  env->AddCleanupHook(DeleteMe, static_cast<void*>(this));
   env->modify_base_object_count(1);
 }
 
 BaseObject::~BaseObject() {
   env()->modify_base_object_count(-1);
-  env()->RemoveCleanupHook(DeleteMe, static_cast<void*>(this));
+  // Removes this object from the Environment's cleanup queue.
+  cleanup_queue_.Remove();
 
   if (UNLIKELY(has_pointer_data())) {
     PointerData* metadata = pointer_data();
@@ -97,6 +97,13 @@ class BaseObject : public MemoryRetainer {
   inline void Detach();
 
  protected:
+  // Creates an object without a cleanup hook. The Environment needs to delete
+  // it on teardown in another way, as it does for ReqWraps.
+  struct NoCleanupHook {};
+  inline BaseObject(Environment* env,
+                    v8::Local<v8::Object> object,
+                    NoCleanupHook);
+
   virtual inline void OnGCCollect();
 
  private:
@@ -110,6 +117,7 @@ class BaseObject : public MemoryRetainer {
   // refer to `doc/guides/node-postmortem-support.md`
   friend int GenDebugSymbols();
   friend class CleanupHookCallback;
+  friend class Environment;
   template <typename T, bool kIsWeak>
   friend class BaseObjectPtrImpl;
 
@@ -146,6 +154,10 @@ class BaseObject : public MemoryRetainer {
 
   Environment* env_;
   PointerData* pointer_data_ = nullptr;
+  // Instead of a CleanupHookCallback, BaseObjects are kept in a list in the
+  // Environment, so that adding and removing them does not allocate.
+  ListNode<BaseObject> cleanup_queue_;
+  uint64_t cleanup_hook_order_ = 0;
 };
 
 // Global alias for FromJSObject() to avoid churn.
@@ -0,0 +1,191 @@
+#include "buffer_pool.h"
+#include "util.h"
+
+#include <cstring>
+
+#ifdef __POSIX__
+#include <sys/mman.h>
+#endif
+
+namespace node {
+
+BufferPool::BufferPool(bool use_huge_pages)
+    : use_huge_pages_(use_huge_pages) {}
+
+BufferPool::~BufferPool() {
+  // Blocks that are still in use at this point belong to backing stores that
+  // outlive the allocator, which the embedder API does not allow.
+  for (const auto& entry : chunks_) {
+    Chunk* chunk = entry.second;
+#ifdef __POSIX__
+    CHECK_EQ(munmap(chunk->base, kChunkSize), 0);
+#endif
+    delete chunk;
+  }
+}
+
+size_t BufferPool::ClassSize(size_t index) {
+  // 8 KB, 12 KB, 16 KB, 24 KB, ..., 768 KB, 1 MB.
+  const size_t base = kMinSize << (index / 2);
+  return index % 2 == 0 ? base : base + base / 2;
+}
+
+size_t BufferPool::ClassIndex(size_t size) {
+  DCHECK(IsPoolSize(size));
+  size_t index = 0;
+  while (ClassSize(index) < size) index++;
+  DCHECK_LT(index, kClassCount);
+  return index;
+}
+
+BufferPool::Chunk* BufferPool::FindChunk(const void* data) {
+  const uintptr_t base =
+      reinterpret_cast<uintptr_t>(data) & ~(uintptr_t{kChunkSize} - 1);
+  auto it = chunks_.find(base);
+  return it == chunks_.end() ? nullptr : it->second;
+}
+
+BufferPool::Chunk* BufferPool::NewChunk(size_t index) {
+#ifdef __POSIX__
+  // Over-allocate so that an aligned chunk can be cut out of the mapping.
+  const size_t length = 2 * kChunkSize;
+  void* mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED) return nullptr;
+  char* start = static_cast<char*>(mapping);
+  char* base = reinterpret_cast<char*>(RoundUp(
+      reinterpret_cast<uintptr_t>(start), uintptr_t{kChunkSize}));
+  if (base != start)
+    CHECK_EQ(munmap(start, base - start), 0);
+  if (base + kChunkSize != start + length)
+    CHECK_EQ(munmap(base + kChunkSize, start + length - base - kChunkSize), 0);
+#ifdef MADV_HUGEPAGE
+  // Failure only means that the chunk is backed by regular pages.
+  if (use_huge_pages_)
+    madvise(base, kChunkSize, MADV_HUGEPAGE);
+#endif
+
+  Chunk* chunk = new Chunk();
+  chunk->base = base;
+  chunk->size_class = index;
+  chunk->capacity = kChunkSize / ClassSize(index);
+  chunk->carved = 0;
+  chunk->in_use = 0;
+  chunks_[reinterpret_cast<uintptr_t>(base)] = chunk;
+  return chunk;
+#else
+  return nullptr;
+#endif
+}
+
+void BufferPool::DeleteChunk(Chunk* chunk) {
+  CHECK_EQ(chunk->in_use, 0);
+  if (chunk->linked) Unlink(chunk);
+  chunks_.erase(reinterpret_cast<uintptr_t>(chunk->base));
+#ifdef __POSIX__
+  CHECK_EQ(munmap(chunk->base, kChunkSize), 0);
+#endif
+  delete chunk;
+}
+
+void BufferPool::Link(Chunk* chunk) {
+  DCHECK(!chunk->linked);
+  SizeClass* size_class = &classes_[chunk->size_class];
+  chunk->prev = nullptr;
+  chunk->next = size_class->available;
+  if (chunk->next != nullptr) chunk->next->prev = chunk;
+  size_class->available = chunk;
+  chunk->linked = true;
+}
+
+void BufferPool::Unlink(Chunk* chunk) {
+  DCHECK(chunk->linked);
+  SizeClass* size_class = &classes_[chunk->size_class];
+  if (chunk->prev != nullptr)
+    chunk->prev->next = chunk->next;
+  else
+    size_class->available = chunk->next;
+  if (chunk->next != nullptr) chunk->next->prev = chunk->prev;
+  chunk->prev = chunk->next = nullptr;
+  chunk->linked = false;
+}
+
+void* BufferPool::Allocate(size_t size, bool zero_fill) {
+  if (!IsPoolSize(size)) return nullptr;
+  const size_t index = ClassIndex(size);
+  const size_t block_size = ClassSize(index);
+
+  Mutex::ScopedLock lock(mutex_);
+  SizeClass* size_class = &classes_[index];
+  Chunk* chunk = size_class->available;
+  if (chunk == nullptr) {
+    chunk = NewChunk(index);
+    if (chunk == nullptr) return nullptr;
+    Link(chunk);
+  }
+
+  if (chunk->in_use == 0 && chunk->carved > 0)
+    size_class->empty_chunks--;
+
+  char* data;
+  bool recycled;
+  if (chunk->free_list != nullptr) {
+    Block* block = chunk->free_list;
+    chunk->free_list = block->next;
+    data = reinterpret_cast<char*>(block);
+    recycled = true;
+  } else {
+    // Blocks that have never been handed out are still zero-filled pages
+    // that do not even need to be touched before they are used.
+    data = chunk->base + chunk->carved * block_size;
+    chunk->carved++;
+    recycled = false;
+  }
+  chunk->in_use++;
+  if (chunk->in_use == chunk->capacity)
+    Unlink(chunk);
+  used_ += block_size;
+
+  if (zero_fill && recycled)
+    memset(data, 0, size);
+  return data;
+}
+
+bool BufferPool::Free(void* data) {
+  if (!kSupported || data == nullptr) return false;
+
+  Mutex::ScopedLock lock(mutex_);
+  Chunk* chunk = FindChunk(data);
+  if (chunk == nullptr) return false;
+
+  SizeClass* size_class = &classes_[chunk->size_class];
+  Block* block = static_cast<Block*>(data);
+  block->next = chunk->free_list;
+  chunk->free_list = block;
+  if (!chunk->linked) Link(chunk);
+  chunk->in_use--;
+  used_ -= ClassSize(chunk->size_class);
+
+  if (chunk->in_use == 0) {
+    if (size_class->empty_chunks > 0)
+      DeleteChunk(chunk);
+    else
+      size_class->empty_chunks++;
+  }
+  return true;
+}
+
+size_t BufferPool::BlockSize(const void* data) {
+  if (!kSupported || data == nullptr) return 0;
+
+  Mutex::ScopedLock lock(mutex_);
+  Chunk* chunk = FindChunk(data);
+  return chunk == nullptr ? 0 : ClassSize(chunk->size_class);
+}
+
+BufferPool::Stats BufferPool::GetStats() {
+  Mutex::ScopedLock lock(mutex_);
+  return Stats { chunks_.size() * kChunkSize, used_ };
+}
+
+}  // namespace node
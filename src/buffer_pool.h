@@ -0,0 +1,112 @@
+#ifndef SRC_BUFFER_POOL_H_
+#define SRC_BUFFER_POOL_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "node_mutex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace node {
+
+// A size-class slab allocator for the backing stores of medium-sized
+// ArrayBuffers, i.e. the range that is too large for the JS-land Buffer pool
+// and small enough to be allocated over and over again (network reads,
+// compression output, file chunks, ...).
+//
+// Memory is obtained from the OS in aligned chunks of kChunkSize bytes, each
+// of which is split into blocks of a single size class. Because chunks are
+// aligned, the chunk of any pointer can be found without a header in front of
+// the block, and pointers that were not handed out by the pool (e.g. malloc()
+// memory adopted through Buffer::New()) are recognized as such.
+//
+// Blocks that are freed are recycled for the next allocation of the same
+// class; chunks that become completely unused are returned to the OS, except
+// for one per size class that is kept around for reuse.
+//
+// All methods may be called from any thread.
+class BufferPool {
+ public:
+  static constexpr size_t kMinSize = 8 * 1024;
+  static constexpr size_t kMaxSize = 1024 * 1024;
+  static constexpr size_t kChunkSize = 2 * 1024 * 1024;
+
+  struct Stats {
+    size_t reserved;  // Bytes obtained from the OS.
+    size_t used;      // Bytes in blocks that are currently handed out.
+  };
+
+  explicit BufferPool(bool use_huge_pages);
+  ~BufferPool();
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+
+  static inline bool IsPoolSize(size_t size) {
+    return kSupported && size >= kMinSize && size <= kMaxSize;
+  }
+
+  // Returns nullptr if the pool cannot provide a block of this size; the
+  // caller is expected to fall back to malloc() in that case.
+  void* Allocate(size_t size, bool zero_fill);
+  // Returns false if |data| was not allocated by this pool.
+  bool Free(void* data);
+  // Returns the usable size of the block at |data|, or 0 if |data| was not
+  // allocated by this pool.
+  size_t BlockSize(const void* data);
+
+  Stats GetStats();
+
+ private:
+#ifdef __POSIX__
+  static constexpr bool kSupported = true;
+#else
+  static constexpr bool kSupported = false;
+#endif
+  static constexpr size_t kClassCount = 15;
+
+  struct Block {
+    Block* next;
+  };
+
+  struct Chunk {
+    char* base;
+    uint32_t size_class;
+    uint32_t capacity;  // Number of blocks that fit into the chunk.
+    uint32_t carved;    // Number of blocks that have ever been handed out.
+    uint32_t in_use;
+    Block* free_list = nullptr;
+    // Chunks that have blocks available are linked per size class.
+    Chunk* prev = nullptr;
+    Chunk* next = nullptr;
+    bool linked = false;
+  };
+
+  struct SizeClass {
+    Chunk* available = nullptr;
+    uint32_t empty_chunks = 0;
+  };
+
+  static size_t ClassIndex(size_t size);
+  static size_t ClassSize(size_t index);
+
+  Chunk* FindChunk(const void* data);
+  Chunk* NewChunk(size_t index);
+  void DeleteChunk(Chunk* chunk);
+  void Link(Chunk* chunk);
+  void Unlink(Chunk* chunk);
+
+  const bool use_huge_pages_;
+  Mutex mutex_;
+  SizeClass classes_[kClassCount];
+  std::unordered_map<uintptr_t, Chunk*> chunks_;
+  size_t used_ = 0;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_BUFFER_POOL_H_
@@ -29,10 +29,13 @@
 #include "util-inl.h"
 #include "uv.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <memory>
+#include <string>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 
 #ifdef __POSIX__
@@ -66,8 +69,10 @@ using v8::Int32;
 using v8::Integer;
 using v8::Local;
 using v8::Null;
+using v8::Number;
 using v8::Object;
 using v8::String;
+using v8::Uint32;
 using v8::Value;
 
 namespace {
@@ -225,16 +230,21 @@ class GetAddrInfoReqWrap : public ReqWrap<uv_getaddrinfo_t> {
   SET_SELF_SIZE(GetAddrInfoReqWrap)
 
   bool verbatim() const { return verbatim_; }
+  uint64_t queued_at() const { return queued_at_; }
 
  private:
   const bool verbatim_;
+  // Set while perf_hooks.monitorThreadpool() is enabled.
+  const uint64_t queued_at_;
 };
 
 GetAddrInfoReqWrap::GetAddrInfoReqWrap(Environment* env,
                                        Local<Object> req_wrap_obj,
                                        bool verbatim)
     : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_GETADDRINFOREQWRAP)
-    , verbatim_(verbatim) {
+    , verbatim_(verbatim)
+    , queued_at_(env->performance_state()->threadpool_monitored() ?
+                     PERFORMANCE_NOW() : 0) {
 }
 
 
@@ -245,11 +255,32 @@ class GetNameInfoReqWrap : public ReqWrap<uv_getnameinfo_t> {
   SET_NO_MEMORY_INFO()
   SET_MEMORY_INFO_NAME(GetNameInfoReqWrap)
   SET_SELF_SIZE(GetNameInfoReqWrap)
+
+  uint64_t queued_at() const { return queued_at_; }
+
+ private:
+  // Set while perf_hooks.monitorThreadpool() is enabled.
+  const uint64_t queued_at_;
 };
 
 GetNameInfoReqWrap::GetNameInfoReqWrap(Environment* env,
                                        Local<Object> req_wrap_obj)
-    : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_GETNAMEINFOREQWRAP) {
+    : ReqWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_GETNAMEINFOREQWRAP)
+    , queued_at_(env->performance_state()->threadpool_monitored() ?
+                     PERFORMANCE_NOW() : 0) {
+}
+
+// uv_getaddrinfo() and uv_getnameinfo() requests are queued by libuv itself,
+// so only their total time is known.
+template <typename ReqWrapT>
+static void RecordLookup(ReqWrapT* req_wrap) {
+  if (req_wrap->queued_at() == 0)
+    return;
+  req_wrap->env()->performance_state()->RecordThreadPoolWork(
+      performance::NODE_THREADPOOL_WORK_KIND_DNS,
+      req_wrap->queued_at(),
+      0,
+      PERFORMANCE_NOW());
 }
 
 
@@ -1808,6 +1839,7 @@ void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
   std::unique_ptr<GetAddrInfoReqWrap> req_wrap {
       static_cast<GetAddrInfoReqWrap*>(req->data)};
   Environment* env = req_wrap->env();
+  RecordLookup(req_wrap.get());
 
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
@@ -1878,6 +1910,7 @@ void AfterGetNameInfo(uv_getnameinfo_t* req,
   std::unique_ptr<GetNameInfoReqWrap> req_wrap {
       static_cast<GetNameInfoReqWrap*>(req->data)};
   Environment* env = req_wrap->env();
+  RecordLookup(req_wrap.get());
 
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
@@ -2144,6 +2177,46 @@ void SetServers(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(err);
 }
 
+// Returns the /etc/hosts entries for a name, the way uv_getaddrinfo() would
+// see them, without going through the threadpool. Used by dns.lookup() when
+// the lookup cache is enabled, before asking the DNS servers.
+void GetHostByNameFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  ChannelWrap* channel;
+  ASSIGN_OR_RETURN_UNWRAP(&channel, args.Holder());
+
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsInt32());
+  node::Utf8Value name(env->isolate(), args[0]);
+  const int family = args[1].As<Int32>()->Value();
+
+  std::vector<Local<Value>> addresses;
+  auto add = [&] (int af) {
+    struct hostent* host;
+    if (ares_gethostbyname_file(channel->cares_channel(),
+                                *name,
+                                af,
+                                &host) != ARES_SUCCESS) {
+      return;
+    }
+    for (uint32_t i = 0; host->h_addr_list[i] != nullptr; ++i) {
+      char ip[INET6_ADDRSTRLEN];
+      if (uv_inet_ntop(host->h_addrtype, host->h_addr_list[i], ip, sizeof(ip)))
+        continue;
+      addresses.push_back(OneByteString(env->isolate(), ip));
+    }
+    ares_free_hostent(host);
+  };
+
+  if (family != 6)
+    add(AF_INET);
+  if (family != 4)
+    add(AF_INET6);
+
+  args.GetReturnValue().Set(
+      Array::New(env->isolate(), addresses.data(), addresses.size()));
+}
+
 void Cancel(const FunctionCallbackInfo<Value>& args) {
   ChannelWrap* channel;
   ASSIGN_OR_RETURN_UNWRAP(&channel, args.Holder());
@@ -2165,6 +2238,209 @@ void StrError(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// A process-wide cache of dns.lookup() answers, shared by all threads and
+// enabled through dns.setLookupCache(). Answers are kept for the TTL of their
+// DNS records, capped at max_ttl, and failures for negative_ttl. After that,
+// an entry can still be served for stale_ttl; the first lookup that sees it
+// stale is told to refresh it in the background.
+enum LookupCacheStatus {
+  kLookupCacheDisabled,
+  kLookupCacheMiss,
+  kLookupCacheHit,
+  kLookupCacheStale
+};
+
+class LookupCache {
+ public:
+  // All durations are in milliseconds. max_entries == 0 disables the cache.
+  void Configure(uint64_t max_ttl,
+                 uint64_t negative_ttl,
+                 uint64_t stale_ttl,
+                 size_t max_entries) {
+    Mutex::ScopedLock lock(mutex_);
+    max_ttl_ = max_ttl;
+    negative_ttl_ = negative_ttl;
+    stale_ttl_ = stale_ttl;
+    max_entries_ = max_entries;
+    const uint64_t now = Now();
+    while (entries_.size() > max_entries_)
+      Evict(now);
+  }
+
+  LookupCacheStatus Get(const std::string& key,
+                        std::vector<std::string>* addresses,
+                        int* error) {
+    Mutex::ScopedLock lock(mutex_);
+    if (max_entries_ == 0)
+      return kLookupCacheDisabled;
+    auto it = entries_.find(key);
+    if (it == entries_.end())
+      return kLookupCacheMiss;
+    Entry& entry = it->second;
+    const uint64_t now = Now();
+    if (now >= entry.stale_until) {
+      entries_.erase(it);
+      return kLookupCacheMiss;
+    }
+    *addresses = entry.addresses;
+    *error = entry.error;
+    if (now < entry.expires || entry.refreshing)
+      return kLookupCacheHit;
+    entry.refreshing = true;
+    return kLookupCacheStale;
+  }
+
+  // ttl is in seconds, as found in DNS records. It is ignored for failures.
+  void Set(const std::string& key,
+           std::vector<std::string>&& addresses,
+           int error,
+           uint64_t ttl) {
+    Mutex::ScopedLock lock(mutex_);
+    if (max_entries_ == 0 || (error != 0 && negative_ttl_ == 0))
+      return;
+    const uint64_t now = Now();
+    if (entries_.size() >= max_entries_ && entries_.count(key) == 0)
+      Evict(now);
+    Entry& entry = entries_[key];
+    entry.addresses = std::move(addresses);
+    entry.error = error;
+    entry.expires =
+        now + (error != 0 ? negative_ttl_ : std::min(ttl * 1000, max_ttl_));
+    entry.stale_until = entry.expires + stale_ttl_;
+    entry.refreshing = false;
+  }
+
+  void Clear() {
+    Mutex::ScopedLock lock(mutex_);
+    entries_.clear();
+  }
+
+ private:
+  struct Entry {
+    std::vector<std::string> addresses;
+    int error;
+    uint64_t expires;
+    uint64_t stale_until;
+    bool refreshing;
+  };
+
+  static uint64_t Now() { return uv_hrtime() / 1000000; }
+
+  // Makes room for one entry, by dropping the entries that can no longer be
+  // served or, if there are none, the one that would be dropped first.
+  void Evict(uint64_t now) {
+    auto first = entries_.end();
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (now >= it->second.stale_until) {
+        it = entries_.erase(it);
+        continue;
+      }
+      if (first == entries_.end() ||
+          it->second.stale_until < first->second.stale_until) {
+        first = it;
+      }
+      ++it;
+    }
+    if (entries_.size() >= max_entries_ && first != entries_.end())
+      entries_.erase(first);
+  }
+
+  Mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  uint64_t max_ttl_ = 0;
+  uint64_t negative_ttl_ = 0;
+  uint64_t stale_ttl_ = 0;
+  size_t max_entries_ = 0;
+};
+
+LookupCache lookup_cache;
+
+std::string LookupCacheKey(Environment* env,
+                           Local<Value> hostname,
+                           Local<Value> family) {
+  CHECK(hostname->IsString());
+  CHECK(family->IsInt32());
+  node::Utf8Value name(env->isolate(), hostname);
+  std::string key = std::to_string(family.As<Int32>()->Value());
+  key += ':';
+  key.append(*name, name.length());
+  return key;
+}
+
+void LookupCacheConfigure(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsNumber());
+  CHECK(args[1]->IsNumber());
+  CHECK(args[2]->IsNumber());
+  CHECK(args[3]->IsUint32());
+  lookup_cache.Configure(args[0].As<Number>()->Value(),
+                         args[1].As<Number>()->Value(),
+                         args[2].As<Number>()->Value(),
+                         args[3].As<Uint32>()->Value());
+}
+
+// lookupCacheGet(hostname, family, result) returns a LookupCacheStatus.
+// For hits, result[0] is set to the array of addresses, or to the error code
+// of a cached failure.
+void LookupCacheGet(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[2]->IsArray());
+  std::vector<std::string> addresses;
+  int error = 0;
+  const LookupCacheStatus status =
+      lookup_cache.Get(LookupCacheKey(env, args[0], args[1]),
+                       &addresses,
+                       &error);
+
+  if (status == kLookupCacheHit || status == kLookupCacheStale) {
+    Local<Value> result;
+    if (error != 0) {
+      result = Integer::New(env->isolate(), error);
+    } else {
+      std::vector<Local<Value>> values;
+      values.reserve(addresses.size());
+      for (const std::string& address : addresses)
+        values.push_back(OneByteString(env->isolate(), address.c_str()));
+      result = Array::New(env->isolate(), values.data(), values.size());
+    }
+    args[2].As<Array>()->Set(env->context(), 0, result).Check();
+  }
+
+  args.GetReturnValue().Set(status);
+}
+
+// lookupCacheSet(hostname, family, addresses or error code, ttl in seconds)
+void LookupCacheSet(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[3]->IsUint32());
+  std::vector<std::string> addresses;
+  int error = 0;
+  if (args[2]->IsInt32()) {
+    error = args[2].As<Int32>()->Value();
+    CHECK_NE(error, 0);
+  } else {
+    CHECK(args[2]->IsArray());
+    Local<Array> array = args[2].As<Array>();
+    addresses.reserve(array->Length());
+    for (uint32_t i = 0; i < array->Length(); i++) {
+      Local<Value> address;
+      if (!array->Get(env->context(), i).ToLocal(&address))
+        return;
+      node::Utf8Value value(env->isolate(), address);
+      addresses.emplace_back(*value, value.length());
+    }
+  }
+
+  lookup_cache.Set(LookupCacheKey(env, args[0], args[1]),
+                   std::move(addresses),
+                   error,
+                   args[3].As<Uint32>()->Value());
+}
+
+void LookupCacheClear(const FunctionCallbackInfo<Value>& args) {
+  lookup_cache.Clear();
+}
+
+
 void Initialize(Local<Object> target,
                 Local<Value> unused,
                 Local<Context> context,
@@ -2177,6 +2453,15 @@ void Initialize(Local<Object> target,
 
   env->SetMethod(target, "strerror", StrError);
 
+  env->SetMethod(target, "lookupCacheConfigure", LookupCacheConfigure);
+  env->SetMethod(target, "lookupCacheGet", LookupCacheGet);
+  env->SetMethod(target, "lookupCacheSet", LookupCacheSet);
+  env->SetMethod(target, "lookupCacheClear", LookupCacheClear);
+  NODE_DEFINE_CONSTANT(target, kLookupCacheDisabled);
+  NODE_DEFINE_CONSTANT(target, kLookupCacheMiss);
+  NODE_DEFINE_CONSTANT(target, kLookupCacheHit);
+  NODE_DEFINE_CONSTANT(target, kLookupCacheStale);
+
   target->Set(env->context(), FIXED_ONE_BYTE_STRING(env->isolate(), "AF_INET"),
               Integer::New(env->isolate(), AF_INET)).Check();
   target->Set(env->context(), FIXED_ONE_BYTE_STRING(env->isolate(), "AF_INET6"),
@@ -2238,6 +2523,7 @@ void Initialize(Local<Object> target,
   env->SetProtoMethod(channel_wrap, "queryNaptr", Query<QueryNaptrWrap>);
   env->SetProtoMethod(channel_wrap, "querySoa", Query<QuerySoaWrap>);
   env->SetProtoMethod(channel_wrap, "getHostByAddr", Query<GetHostByAddrWrap>);
+  env->SetProtoMethod(channel_wrap, "getHostByNameFile", GetHostByNameFile);
 
   env->SetProtoMethodNoSideEffect(channel_wrap, "getServers", GetServers);
   env->SetProtoMethod(channel_wrap, "setServers", SetServers);
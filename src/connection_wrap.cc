@@ -10,6 +10,7 @@
 
 namespace node {
 
+using v8::Array;
 using v8::Boolean;
 using v8::Context;
 using v8::HandleScope;
@@ -46,6 +47,10 @@ void ConnectionWrap<WrapType, UVType>::OnConnection(uv_stream_t* handle,
 
   Local<Value> client_handle;
 
+  // Don't reorder connections and errors in batch mode.
+  if (status != 0)
+    wrap_data->FlushConnections();
+
   if (status == 0) {
     // Instantiate the client javascript object and handle.
     Local<Object> client_obj;
@@ -63,6 +68,24 @@ void ConnectionWrap<WrapType, UVType>::OnConnection(uv_stream_t* handle,
     if (uv_accept(handle, client))
       return;
 
+    if (wrap_data->accept_batch_size_ > 1) {
+      wrap_data->pending_connections_.emplace_back(wrap);
+      if (wrap_data->pending_connections_.size() >=
+          wrap_data->accept_batch_size_) {
+        wrap_data->FlushConnections();
+      } else if (!wrap_data->accept_flush_scheduled_) {
+        // Native immediates run after the poll phase, by which time libuv
+        // has accepted everything that was pending on the listen socket.
+        wrap_data->accept_flush_scheduled_ = true;
+        env->SetImmediate(
+            [wrap = BaseObjectPtr<WrapType>(wrap_data)](Environment* env) {
+          wrap->accept_flush_scheduled_ = false;
+          wrap->FlushConnections();
+        });
+      }
+      return;
+    }
+
     // Successful accept. Call the onconnection callback in JavaScript land.
     client_handle = client_obj;
   } else {
@@ -74,6 +97,38 @@ void ConnectionWrap<WrapType, UVType>::OnConnection(uv_stream_t* handle,
 }
 
 
+template <typename WrapType, typename UVType>
+void ConnectionWrap<WrapType, UVType>::FlushConnections() {
+  if (pending_connections_.empty())
+    return;
+
+  std::vector<BaseObjectPtr<WrapType>> connections;
+  connections.swap(pending_connections_);
+
+  // The server was closed while connections were queued up.
+  if (IsHandleClosing()) {
+    for (const BaseObjectPtr<WrapType>& connection : connections)
+      connection->Close();
+    return;
+  }
+
+  Environment* env = this->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  std::vector<Local<Value>> handles;
+  handles.reserve(connections.size());
+  for (const BaseObjectPtr<WrapType>& connection : connections)
+    handles.push_back(connection->object());
+
+  Local<Value> argv[] = {
+    Integer::New(env->isolate(), 0),
+    Array::New(env->isolate(), handles.data(), handles.size())
+  };
+  MakeCallback(env->onconnection_string(), arraysize(argv), argv);
+}
+
+
 template <typename WrapType, typename UVType>
 void ConnectionWrap<WrapType, UVType>::AfterConnect(uv_connect_t* req,
                                                     int status) {
@@ -133,5 +188,9 @@ template void ConnectionWrap<PipeWrap, uv_pipe_t>::AfterConnect(
 template void ConnectionWrap<TCPWrap, uv_tcp_t>::AfterConnect(
     uv_connect_t* handle, int status);
 
+template void ConnectionWrap<PipeWrap, uv_pipe_t>::FlushConnections();
+
+template void ConnectionWrap<TCPWrap, uv_tcp_t>::FlushConnections();
+
 
 }  // namespace node
@@ -5,6 +5,8 @@
 
 #include "stream_wrap.h"
 
+#include <vector>
+
 namespace node {
 
 class Environment;
@@ -20,7 +22,17 @@ class ConnectionWrap : public LibuvStreamWrap {
                  v8::Local<v8::Object> object,
                  ProviderType provider);
 
+  // Hands the connections accepted so far to JS in a single callback.
+  void FlushConnections();
+
   UVType handle_;
+
+  // When greater than one, accepted connections are queued and passed to
+  // the onconnection callback as an array, once per event loop iteration or
+  // whenever accept_batch_size_ connections are pending.
+  uint32_t accept_batch_size_ = 0;
+  bool accept_flush_scheduled_ = false;
+  std::vector<BaseObjectPtr<WrapType>> pending_connections_;
 };
 
 }  // namespace node
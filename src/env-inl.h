@@ -52,6 +52,10 @@ inline bool IsolateData::uses_node_allocator() const {
   return uses_node_allocator_;
 }
 
+inline bool IsolateData::from_snapshot() const {
+  return from_snapshot_;
+}
+
 inline v8::ArrayBuffer::Allocator* IsolateData::allocator() const {
   return allocator_;
 }
@@ -69,6 +73,8 @@ inline AsyncHooks::AsyncHooks()
       fields_(env()->isolate(), kFieldsCount),
       async_id_fields_(env()->isolate(), kUidFieldsCount) {
   clear_async_id_stack();
+  top_level_resource_.Reset(env()->isolate(),
+                            v8::Object::New(env()->isolate()));
 
   // Always perform async_hooks checks, not just when async_hooks is enabled.
   // TODO(AndreasMadsen): Consider removing this for LTS releases.
@@ -117,6 +123,10 @@ inline v8::Local<v8::Array> AsyncHooks::execution_async_resources() {
   return PersistentToLocal::Strong(execution_async_resources_);
 }
 
+inline v8::Local<v8::Object> AsyncHooks::top_level_resource() {
+  return PersistentToLocal::Strong(top_level_resource_);
+}
+
 inline v8::Local<v8::String> AsyncHooks::provider_string(int idx) {
   return providers_[idx].Get(env()->isolate());
 }
@@ -151,8 +161,9 @@ inline void AsyncHooks::push_async_context(double async_id,
   async_id_fields_[kExecutionAsyncId] = async_id;
   async_id_fields_[kTriggerAsyncId] = trigger_async_id;
 
-  auto resources = execution_async_resources();
-  USE(resources->Set(env()->context(), offset, resource));
+  if (native_execution_async_resources_.size() <= offset)
+    native_execution_async_resources_.resize(offset + 1);
+  native_execution_async_resources_[offset] = resource;
 }
 
 // Remember to keep this code aligned with popAsyncContext() in JS.
@@ -185,8 +196,16 @@ inline bool AsyncHooks::pop_async_context(double async_id) {
   async_id_fields_[kTriggerAsyncId] = async_ids_stack_[2 * offset + 1];
   fields_[kStackLength] = offset;
 
-  auto resources = execution_async_resources();
-  USE(resources->Delete(env()->context(), offset));
+  if (LIKELY(offset < native_execution_async_resources_.size()))
+    native_execution_async_resources_[offset].Clear();
+  // The resource was pushed from JS, e.g. when this is called while handling
+  // an exception.
+  v8::Local<v8::Array> resources = execution_async_resources();
+  if (UNLIKELY(resources->Length() > offset)) {
+    USE(resources->Set(env()->context(),
+                       env()->length_string(),
+                       v8::Integer::NewFromUnsigned(env()->isolate(), offset)));
+  }
 
   return fields_[kStackLength] > 0;
 }
@@ -195,7 +214,15 @@ inline bool AsyncHooks::pop_async_context(double async_id) {
 inline void AsyncHooks::clear_async_id_stack() {
   auto isolate = env()->isolate();
   v8::HandleScope handle_scope(isolate);
-  execution_async_resources_.Reset(isolate, v8::Array::New(isolate));
+  // Once JS holds on to the array, it is truncated rather than replaced.
+  if (execution_async_resources_.IsEmpty()) {
+    execution_async_resources_.Reset(isolate, v8::Array::New(isolate));
+  } else {
+    USE(execution_async_resources()->Set(env()->context(),
+                                         env()->length_string(),
+                                         v8::Integer::New(isolate, 0)));
+  }
+  native_execution_async_resources_.clear();
 
   async_id_fields_[kExecutionAsyncId] = 0;
   async_id_fields_[kTriggerAsyncId] = 0;
@@ -239,6 +266,18 @@ inline void Environment::PopAsyncCallbackScope() {
   async_callback_scope_depth_--;
 }
 
+inline bool Environment::tick_batch_active() const {
+  return tick_batch_active_;
+}
+
+inline void Environment::set_tick_batch_pending() {
+  tick_batch_pending_ = true;
+}
+
+inline Environment::CallbackScopeStats* Environment::callback_scope_stats() {
+  return &callback_scope_stats_;
+}
+
 inline ImmediateInfo::ImmediateInfo(v8::Isolate* isolate)
     : fields_(isolate, kFieldsCount) {}
 
@@ -599,6 +638,22 @@ inline void Environment::set_http_parser_buffer_in_use(bool in_use) {
   http_parser_buffer_in_use_ = in_use;
 }
 
+inline char* Environment::stream_read_buffer() const {
+  return stream_read_buffer_;
+}
+
+inline void Environment::set_stream_read_buffer(char* buffer) {
+  stream_read_buffer_ = buffer;
+}
+
+inline bool Environment::stream_read_buffer_in_use() const {
+  return stream_read_buffer_in_use_;
+}
+
+inline void Environment::set_stream_read_buffer_in_use(bool in_use) {
+  stream_read_buffer_in_use_ = in_use;
+}
+
 inline http2::Http2State* Environment::http2_state() const {
   return http2_state_.get();
 }
@@ -631,6 +686,10 @@ inline AliasedBigUint64Array* Environment::fs_stats_field_bigint_array() {
   return &fs_stats_field_bigint_array_;
 }
 
+inline ScratchArena* Environment::scratch_arena() {
+  return &scratch_arena_;
+}
+
 inline std::vector<std::unique_ptr<fs::FileHandleReadWrap>>&
 Environment::file_handle_read_wrap_freelist() {
   return file_handle_read_wrap_freelist_;
@@ -1233,6 +1292,11 @@ void Environment::RemoveCleanupHook(void (*fn)(void*), void* arg) {
   cleanup_hooks_.erase(search);
 }
 
+void Environment::AddCleanupHook(BaseObject* object) {
+  object->cleanup_hook_order_ = cleanup_hook_counter_++;
+  base_object_cleanup_queue_.PushFront(object);
+}
+
 inline void Environment::RegisterFinalizationGroupForCleanup(
     v8::Local<v8::FinalizationGroup> group) {
   cleanup_finalization_groups_.emplace_back(isolate(), group);
@@ -1249,20 +1313,10 @@ bool CleanupHookCallback::Equal::operator()(
   return a.fn_ == b.fn_ && a.arg_ == b.arg_;
 }
 
-BaseObject* CleanupHookCallback::GetBaseObject() const {
-  if (fn_ == BaseObject::DeleteMe)
-    return static_cast<BaseObject*>(arg_);
-  else
-    return nullptr;
-}
-
 template <typename T>
 void Environment::ForEachBaseObject(T&& iterator) {
-  for (const auto& hook : cleanup_hooks_) {
-    BaseObject* obj = hook.GetBaseObject();
-    if (obj != nullptr)
-      iterator(obj);
-  }
+  for (BaseObject* obj : base_object_cleanup_queue_)
+    iterator(obj);
 }
 
 void Environment::modify_base_object_count(int64_t delta) {
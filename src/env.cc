@@ -19,12 +19,14 @@
 
 #include <algorithm>
 #include <atomic>
+#include <climits>
 #include <cstdio>
 #include <memory>
 
 namespace node {
 
 using errors::TryCatchScope;
+using v8::Array;
 using v8::ArrayBuffer;
 using v8::Boolean;
 using v8::Context;
@@ -165,6 +167,7 @@ IsolateData::IsolateData(Isolate* isolate,
       node_allocator_(node_allocator == nullptr ? nullptr
                                                 : node_allocator->GetImpl()),
       uses_node_allocator_(allocator_ == node_allocator_),
+      from_snapshot_(indexes != nullptr),
       platform_(platform) {
   CHECK_NOT_NULL(allocator_);
 
@@ -355,6 +358,7 @@ Environment::Environment(IsolateData* isolate_data,
   performance_state_->Mark(
       performance::NODE_PERFORMANCE_MILESTONE_V8_START,
       performance::performance_v8_start);
+  performance_state_->CopyProcessPhases(is_main_thread());
 
   if (*TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED(
           TRACING_CATEGORY_NODE1(environment)) != 0) {
@@ -417,6 +421,10 @@ Environment::~Environment() {
   }
 
   delete[] http_parser_buffer_;
+  // If a read is still pending, the buffer is leaked rather than freed
+  // underneath it.
+  if (!stream_read_buffer_in_use_)
+    Free(stream_read_buffer_, kStreamReadBufferSize);
 
   TRACE_EVENT_NESTABLE_ASYNC_END0(
     TRACING_CATEGORY_NODE1(environment), "Environment", this);
@@ -450,6 +458,37 @@ void Environment::InitializeLibuv(bool start_profiler_idle_notifier) {
 
   uv_check_start(immediate_check_handle(), CheckImmediate);
 
+  if (options()->loop_busy_poll > 0) {
+    // This is not supported on all platforms, in which case the loop blocks
+    // as usual.
+    USE(uv_loop_configure(event_loop(),
+                          UV_LOOP_BUSY_POLL,
+                          static_cast<unsigned int>(
+                              std::min<uint64_t>(options()->loop_busy_poll,
+                                                 UINT_MAX))));
+  }
+
+  if (options()->loop_edge_triggered)
+    USE(uv_loop_configure(event_loop(), UV_LOOP_EDGE_TRIGGERED));
+
+  // The poll check handle is started after the immediate check handle, so
+  // that it runs first and the end of the poll phase does not include the
+  // immediates.
+  uv_prepare_init(event_loop(), &poll_prepare_handle_);
+  uv_check_init(event_loop(), &poll_check_handle_);
+  uv_prepare_start(&poll_prepare_handle_, [](uv_prepare_t* handle) {
+    Environment* env = ContainerOf(&Environment::poll_prepare_handle_, handle);
+    env->performance_state()->MarkLoopPollStart();
+    env->tick_batch_active_ = env->options()->experimental_batch_ticks;
+  });
+  uv_check_start(&poll_check_handle_, [](uv_check_t* handle) {
+    Environment* env = ContainerOf(&Environment::poll_check_handle_, handle);
+    env->performance_state()->MarkLoopPollEnd();
+    env->FlushTickBatch();
+  });
+  uv_unref(reinterpret_cast<uv_handle_t*>(&poll_prepare_handle_));
+  uv_unref(reinterpret_cast<uv_handle_t*>(&poll_check_handle_));
+
   // Inform V8's CPU profiler when we're idle.  The profiler is sampling-based
   // but not all samples are created equal; mark the wall clock time spent in
   // epoll_wait() and friends so profiling tools can filter it out.  The samples
@@ -528,6 +567,14 @@ void Environment::RegisterHandleCleanups() {
       reinterpret_cast<uv_handle_t*>(&idle_check_handle_),
       close_and_finish,
       nullptr);
+  RegisterHandleCleanup(
+      reinterpret_cast<uv_handle_t*>(&poll_prepare_handle_),
+      close_and_finish,
+      nullptr);
+  RegisterHandleCleanup(
+      reinterpret_cast<uv_handle_t*>(&poll_check_handle_),
+      close_and_finish,
+      nullptr);
   RegisterHandleCleanup(
       reinterpret_cast<uv_handle_t*>(&task_queues_async_),
       close_and_finish,
@@ -600,7 +647,10 @@ void Environment::RunCleanup() {
                               "RunCleanup", this);
   CleanupHandles();
 
-  while (!cleanup_hooks_.empty()) {
+  while (!cleanup_hooks_.empty() || !base_object_cleanup_queue_.IsEmpty()) {
+    // Hooks that are added while this round runs are run in the next one.
+    const uint64_t round_end = cleanup_hook_counter_;
+
     // Copy into a vector, since we can't sort an unordered_set in-place.
     std::vector<CleanupHookCallback> callbacks(
         cleanup_hooks_.begin(), cleanup_hooks_.end());
@@ -614,18 +664,57 @@ void Environment::RunCleanup() {
       return a.insertion_order_counter_ > b.insertion_order_counter_;
     });
 
-    for (const CleanupHookCallback& cb : callbacks) {
-      if (cleanup_hooks_.count(cb) == 0) {
-        // This hook was removed from the `cleanup_hooks_` set during another
-        // hook that was run earlier. Nothing to do here.
-        continue;
+    // Merge the callbacks with the BaseObject cleanup queue, which is already
+    // sorted in descending order.
+    size_t next_callback = 0;
+    for (;;) {
+      // Skip the hooks that were removed during another hook that was run
+      // earlier.
+      while (next_callback < callbacks.size() &&
+             cleanup_hooks_.count(callbacks[next_callback]) == 0) {
+        next_callback++;
+      }
+      BaseObject* next_object = nullptr;
+      for (BaseObject* obj : base_object_cleanup_queue_) {
+        if (obj->cleanup_hook_order_ < round_end) {
+          next_object = obj;
+          break;
+        }
       }
 
-      cb.fn_(cb.arg_);
-      cleanup_hooks_.erase(cb);
+      if (next_object != nullptr &&
+          (next_callback == callbacks.size() ||
+           next_object->cleanup_hook_order_ >
+               callbacks[next_callback].insertion_order_counter_)) {
+        next_object->cleanup_queue_.Remove();
+        BaseObject::DeleteMe(next_object);
+      } else if (next_callback < callbacks.size()) {
+        const CleanupHookCallback& cb = callbacks[next_callback++];
+        cb.fn_(cb.arg_);
+        cleanup_hooks_.erase(cb);
+      } else {
+        break;
+      }
     }
     CleanupHandles();
   }
+
+  // ReqWraps have no cleanup hooks. The ones that are left are deleted once
+  // the objects that may own them are gone. Deleting one may delete others,
+  // so the queue is walked again each time.
+  for (;;) {
+    BaseObject* request = nullptr;
+    for (ReqWrapBase* req_wrap : req_wrap_queue_) {
+      BaseObject* obj = req_wrap->GetAsyncWrap();
+      if (!obj->has_pointer_data() || !obj->pointer_data()->is_detached) {
+        request = obj;
+        break;
+      }
+    }
+    if (request == nullptr) break;
+    // Detaches the request instead if a BaseObjectPtr still refers to it.
+    BaseObject::DeleteMe(request);
+  }
 }
 
 void Environment::RunBeforeExitCallbacks() {
@@ -757,6 +846,8 @@ void Environment::RunTimers(uv_timer_t* handle) {
   Environment* env = Environment::from_timer_handle(handle);
   TraceEventScope trace_scope(TRACING_CATEGORY_NODE1(environment),
                               "RunTimers", env);
+  performance::LoopPhaseScope phase_scope(env->performance_state(),
+                                          performance::NODE_LOOP_PHASE_TIMERS);
 
   if (!env->can_call_into_js())
     return;
@@ -815,10 +906,23 @@ void Environment::RunTimers(uv_timer_t* handle) {
 }
 
 
+void Environment::FlushTickBatch() {
+  tick_batch_active_ = false;
+  if (!tick_batch_pending_) return;
+  tick_batch_pending_ = false;
+
+  HandleScope handle_scope(isolate());
+  Context::Scope context_scope(context());
+  // Closing the scope processes the nextTick and microtask queues.
+  InternalCallbackScope scope(this, process_object(), {0, 0});
+}
+
 void Environment::CheckImmediate(uv_check_t* handle) {
   Environment* env = Environment::from_immediate_check_handle(handle);
   TraceEventScope trace_scope(TRACING_CATEGORY_NODE1(environment),
                               "CheckImmediate", env);
+  performance::LoopPhaseScope phase_scope(env->performance_state(),
+                                          performance::NODE_LOOP_PHASE_CHECK);
 
   HandleScope scope(env->isolate());
   Context::Scope context_scope(env->context());
@@ -962,6 +1066,36 @@ void AsyncHooks::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("async_id_fields", async_id_fields_);
 }
 
+void AsyncHooks::InheritAsyncContextFrame(Local<Object> resource) {
+  Environment* env = this->env();
+  Local<Context> context = env->context();
+  const uint32_t offset = fields_[kStackLength];
+  Local<Value> current = offset > 0 ?
+      execution_async_resource(offset - 1) :
+      top_level_resource().As<Value>();
+  if (current.IsEmpty() || !current->IsObject() || current == resource) return;
+
+  Local<Value> frame;
+  if (!current.As<Object>()->Get(context, env->async_context_frame_symbol())
+          .ToLocal(&frame)) {
+    return;
+  }
+  USE(resource->Set(context, env->async_context_frame_symbol(), frame));
+}
+
+Local<Value> AsyncHooks::execution_async_resource(uint32_t index) {
+  Local<Array> resources = execution_async_resources();
+  Local<Value> resource;
+  if (index < resources->Length() &&
+      resources->Get(env()->context(), index).ToLocal(&resource) &&
+      !resource->IsUndefined()) {
+    return resource;
+  }
+  if (index < native_execution_async_resources_.size())
+    return native_execution_async_resources_[index];
+  return Local<Value>();
+}
+
 void AsyncHooks::grow_async_ids_stack() {
   async_ids_stack_.reserve(async_ids_stack_.Length() * 3);
 
@@ -1022,13 +1156,8 @@ void MemoryTracker::TrackField(const char* edge_name,
   // callback.
   MemoryRetainerNode* n =
       PushNode("CleanupHookCallback", sizeof(value), edge_name);
-  // TODO(joyeecheung): at the moment only arguments of type BaseObject will be
-  // identified and tracked here (based on their deleters),
-  // but we may convert and track other known types here.
-  BaseObject* obj = value.GetBaseObject();
-  if (obj != nullptr && obj->IsDoneInitializing()) {
-    TrackField("arg", obj);
-  }
+  // TODO(joyeecheung): the arguments of cleanup hooks are not identified or
+  // tracked here at the moment, but we may convert and track known types here.
   CHECK_EQ(CurrentNode(), n);
   CHECK_NE(n->size_, 0);
   PopNode();
@@ -1069,7 +1198,19 @@ void Environment::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("fs_stats_field_array", fs_stats_field_array_);
   tracker->TrackField("fs_stats_field_bigint_array",
                       fs_stats_field_bigint_array_);
+  tracker->TrackFieldWithSize("scratch_arena", scratch_arena_.capacity(),
+                              "ScratchArena");
   tracker->TrackField("cleanup_hooks", cleanup_hooks_);
+  for (BaseObject* obj : base_object_cleanup_queue_) {
+    if (obj->IsDoneInitializing())
+      tracker->TrackField("base_object", obj);
+  }
+  // ReqWraps have no cleanup hooks, so they are tracked through their queue.
+  for (ReqWrapBase* req_wrap : req_wrap_queue_) {
+    AsyncWrap* wrap = req_wrap->GetAsyncWrap();
+    if (wrap->IsDoneInitializing())
+      tracker->TrackField("req_wrap", wrap);
+  }
   tracker->TrackField("async_hooks", async_hooks_);
   tracker->TrackField("immediate_info", immediate_info_);
   tracker->TrackField("tick_info", tick_info_);
@@ -161,9 +161,11 @@ constexpr size_t kFsStatsBufferLength =
 // Symbols are per-isolate primitives but Environment proxies them
 // for the sake of convenience.
 #define PER_ISOLATE_SYMBOL_PROPERTIES(V)                                       \
+  V(async_context_frame_symbol, "async_context_frame")                         \
   V(handle_onclose_symbol, "handle_onclose")                                   \
   V(no_message_symbol, "no_message_symbol")                                    \
   V(oninit_symbol, "oninit")                                                   \
+  V(onmessages_symbol, "onmessages")                                           \
   V(owner_symbol, "owner")                                                     \
   V(onpskexchange_symbol, "onpskexchange")                                     \
 
@@ -269,6 +271,7 @@ constexpr size_t kFsStatsBufferLength =
   V(issuercert_string, "issuerCertificate")                                    \
   V(kill_signal_string, "killSignal")                                          \
   V(kind_string, "kind")                                                       \
+  V(length_string, "length")                                                   \
   V(library_string, "library")                                                 \
   V(mac_string, "mac")                                                         \
   V(main_string, "main")                                                       \
@@ -288,6 +291,7 @@ constexpr size_t kFsStatsBufferLength =
   V(ocsp_request_string, "OCSPRequest")                                        \
   V(oncertcb_string, "oncertcb")                                               \
   V(onchange_string, "onchange")                                               \
+  V(onchanges_string, "onchanges")                                             \
   V(onclienthello_string, "onclienthello")                                     \
   V(oncomplete_string, "oncomplete")                                           \
   V(onconnection_string, "onconnection")                                       \
@@ -304,6 +308,7 @@ constexpr size_t kFsStatsBufferLength =
   V(onreadstop_string, "onreadstop")                                           \
   V(onshutdown_string, "onshutdown")                                           \
   V(onsignal_string, "onsignal")                                               \
+  V(ontimeout_string, "ontimeout")                                             \
   V(onunpipe_string, "onunpipe")                                               \
   V(onwrite_string, "onwrite")                                                 \
   V(openssl_error_stack, "opensslErrorStack")                                  \
@@ -401,7 +406,7 @@ constexpr size_t kFsStatsBufferLength =
   V(async_wrap_object_ctor_template, v8::FunctionTemplate)                     \
   V(compiled_fn_entry_template, v8::ObjectTemplate)                            \
   V(dir_instance_template, v8::ObjectTemplate)                                 \
-  V(fd_constructor_template, v8::ObjectTemplate)                               \
+  V(fd_constructor_template, v8::FunctionTemplate)                             \
   V(fdclose_constructor_template, v8::ObjectTemplate)                          \
   V(filehandlereadwrap_template, v8::ObjectTemplate)                           \
   V(fsreqpromise_constructor_template, v8::ObjectTemplate)                     \
@@ -413,9 +418,11 @@ constexpr size_t kFsStatsBufferLength =
   V(message_port_constructor_template, v8::FunctionTemplate)                   \
   V(pipe_constructor_template, v8::FunctionTemplate)                           \
   V(promise_wrap_template, v8::ObjectTemplate)                                 \
+  V(recordable_histogram_constructor_template, v8::FunctionTemplate)           \
   V(sab_lifetimepartner_constructor_template, v8::FunctionTemplate)            \
   V(script_context_constructor_template, v8::FunctionTemplate)                 \
   V(secure_context_constructor_template, v8::FunctionTemplate)                 \
+  V(sendfile_wrap_template, v8::ObjectTemplate)                                \
   V(shutdown_wrap_template, v8::ObjectTemplate)                                \
   V(streambaseoutputstream_constructor_template, v8::ObjectTemplate)           \
   V(tcp_constructor_template, v8::FunctionTemplate)                            \
@@ -469,7 +476,10 @@ constexpr size_t kFsStatsBufferLength =
   V(tls_wrap_constructor_function, v8::Function)                               \
   V(trace_category_state_function, v8::Function)                               \
   V(udp_constructor_function, v8::Function)                                    \
-  V(url_constructor_function, v8::Function)
+  V(url_constructor_function, v8::Function)                                    \
+  V(wasm_streaming_compilation_impl, v8::Function)                             \
+  V(wasm_streaming_object_constructor, v8::Function)                           \
+  V(wrap_transferred_handle_function, v8::Function)
 
 class Environment;
 
@@ -492,6 +502,9 @@ class IsolateData : public MemoryRetainer {
 
   inline bool uses_node_allocator() const;
   inline v8::ArrayBuffer::Allocator* allocator() const;
+  // Whether the isolate was deserialized from a snapshot that contains the
+  // contexts listed in NodeMainInstance.
+  inline bool from_snapshot() const;
   inline NodeArrayBufferAllocator* node_allocator() const;
 
 #define VP(PropertyName, StringValue) V(v8::Private, PropertyName)
@@ -508,6 +521,7 @@ class IsolateData : public MemoryRetainer {
 #undef VP
 
   std::unordered_map<nghttp2_rcbuf*, v8::Eternal<v8::String>> http2_static_strs;
+  std::vector<v8::Eternal<v8::String>> http_parser_static_strs;
   inline v8::Isolate* isolate() const;
   IsolateData(const IsolateData&) = delete;
   IsolateData& operator=(const IsolateData&) = delete;
@@ -536,6 +550,7 @@ class IsolateData : public MemoryRetainer {
   v8::ArrayBuffer::Allocator* const allocator_;
   NodeArrayBufferAllocator* const node_allocator_;
   const bool uses_node_allocator_;
+  const bool from_snapshot_;
   MultiIsolatePlatform* platform_;
   std::shared_ptr<PerIsolateOptions> options_;
 };
@@ -641,6 +656,7 @@ class AsyncHooks : public MemoryRetainer {
     kTotals,
     kCheck,
     kStackLength,
+    kUsesAsyncContext,
     kFieldsCount,
   };
 
@@ -656,6 +672,10 @@ class AsyncHooks : public MemoryRetainer {
   inline AliasedFloat64Array& async_id_fields();
   inline AliasedFloat64Array& async_ids_stack();
   inline v8::Local<v8::Array> execution_async_resources();
+  inline v8::Local<v8::Object> top_level_resource();
+  // The resource at `index` of the execution stack, whether it was pushed
+  // from JS or from C++.
+  v8::Local<v8::Value> execution_async_resource(uint32_t index);
 
   inline v8::Local<v8::String> provider_string(int idx);
 
@@ -667,6 +687,10 @@ class AsyncHooks : public MemoryRetainer {
   inline bool pop_async_context(double async_id);
   inline void clear_async_id_stack();  // Used in fatal exceptions.
 
+  // Copies the async context frame, i.e. the AsyncLocalStorage stores, of
+  // the current execution async resource to `resource`. Keep this aligned
+  // with inheritAsyncContextFrame() in JS.
+  void InheritAsyncContextFrame(v8::Local<v8::Object> resource);
   AsyncHooks(const AsyncHooks&) = delete;
   AsyncHooks& operator=(const AsyncHooks&) = delete;
   AsyncHooks(AsyncHooks&&) = delete;
@@ -710,7 +734,14 @@ class AsyncHooks : public MemoryRetainer {
 
   void grow_async_ids_stack();
 
+  // The resources pushed from JS. Resources that are pushed from C++, mostly
+  // by InternalCallbackScope, are kept in native_execution_async_resources_
+  // instead, which saves setting and deleting an array element per callback.
+  // Their handles belong to the callers, which outlive the scopes.
   v8::Global<v8::Array> execution_async_resources_;
+  std::vector<v8::Local<v8::Value>> native_execution_async_resources_;
+  // The execution async resource when the stack is empty.
+  v8::Global<v8::Object> top_level_resource_;
 };
 
 class ImmediateInfo : public MemoryRetainer {
@@ -819,8 +850,6 @@ class CleanupHookCallback {
                            const CleanupHookCallback& b) const;
   };
 
-  inline BaseObject* GetBaseObject() const;
-
  private:
   friend class Environment;
   void (*fn_)(void*);
@@ -862,6 +891,19 @@ class Environment : public MemoryRetainer {
   inline void PushAsyncCallbackScope();
   inline void PopAsyncCallbackScope();
 
+  // How often the outermost InternalCallbackScope was closed without calling
+  // into JS to process the nextTick queue, and how often it was not.
+  struct CallbackScopeStats {
+    uint64_t fast_closes = 0;
+    uint64_t slow_closes = 0;
+  };
+  inline CallbackScopeStats* callback_scope_stats();
+
+  // With --experimental-batch-ticks, the task queues of the callbacks that
+  // run during the poll phase are processed once when it ends.
+  inline bool tick_batch_active() const;
+  inline void set_tick_batch_pending();
+
   enum Flags {
     kNoFlags = 0,
     kIsMainThread = 1 << 0,
@@ -988,6 +1030,9 @@ class Environment : public MemoryRetainer {
 
   std::set<std::string> native_modules_with_cache;
   std::set<std::string> native_modules_without_cache;
+  // Time spent compiling each built-in module, in nanoseconds. Only recorded
+  // with --trace-bootstrap-modules.
+  std::unordered_map<std::string, uint64_t> native_module_compile_times;
 
   std::unordered_multimap<int, loader::ModuleWrap*> hash_to_module_map;
   std::unordered_map<uint32_t, loader::ModuleWrap*> id_to_module_map;
@@ -1001,6 +1046,8 @@ class Environment : public MemoryRetainer {
 
   std::unordered_map<std::string, const loader::PackageConfig>
       package_json_cache;
+  // Maps the paths of resolved ES modules to their real paths.
+  std::unordered_map<std::string, std::string> module_realpath_cache;
 
   inline double* heap_statistics_buffer() const;
   inline void set_heap_statistics_buffer(
@@ -1019,6 +1066,15 @@ class Environment : public MemoryRetainer {
   inline bool http_parser_buffer_in_use() const;
   inline void set_http_parser_buffer_in_use(bool in_use);
 
+  // A buffer that stream reads are performed into, so that reads which are
+  // much smaller than the suggested size do not each allocate their own
+  // backing store. See EmitToJSStreamListener::OnStreamAlloc().
+  static constexpr size_t kStreamReadBufferSize = 64 * 1024;
+  inline char* stream_read_buffer() const;
+  inline void set_stream_read_buffer(char* buffer);
+  inline bool stream_read_buffer_in_use() const;
+  inline void set_stream_read_buffer_in_use(bool in_use);
+
   inline http2::Http2State* http2_state() const;
   inline void set_http2_state(std::unique_ptr<http2::Http2State> state);
 
@@ -1032,6 +1088,10 @@ class Environment : public MemoryRetainer {
   inline std::vector<std::unique_ptr<fs::FileHandleReadWrap>>&
       file_handle_read_wrap_freelist();
 
+  // Scratch memory for native calls. It is reset when the outermost
+  // InternalCallbackScope is closed.
+  inline ScratchArena* scratch_arena();
+
   inline performance::performance_state* performance_state();
   inline std::unordered_map<std::string, uint64_t>* performance_marks();
 
@@ -1174,6 +1234,8 @@ class Environment : public MemoryRetainer {
 
   typedef ListHead<HandleWrap, &HandleWrap::handle_wrap_queue_> HandleWrapQueue;
   typedef ListHead<ReqWrapBase, &ReqWrapBase::req_wrap_queue_> ReqWrapQueue;
+  typedef ListHead<BaseObject, &BaseObject::cleanup_queue_>
+      BaseObjectCleanupQueue;
 
   inline HandleWrapQueue* handle_wrap_queue() { return &handle_wrap_queue_; }
   inline ReqWrapQueue* req_wrap_queue() { return &req_wrap_queue_; }
@@ -1220,6 +1282,8 @@ class Environment : public MemoryRetainer {
 
   inline void AddCleanupHook(void (*fn)(void*), void* arg);
   inline void RemoveCleanupHook(void (*fn)(void*), void* arg);
+  // Deletes `object` on teardown. It is removed again by ~BaseObject().
+  inline void AddCleanupHook(BaseObject* object);
   void RunCleanup();
 
   static void BuildEmbedderGraph(v8::Isolate* isolate,
@@ -1288,6 +1352,9 @@ class Environment : public MemoryRetainer {
   uv_idle_t immediate_idle_handle_;
   uv_prepare_t idle_prepare_handle_;
   uv_check_t idle_check_handle_;
+  // Measure the event loop utilization, see performance_state.
+  uv_prepare_t poll_prepare_handle_;
+  uv_check_t poll_check_handle_;
   uv_async_t task_queues_async_;
   int64_t task_queues_async_refs_ = 0;
   bool profiler_idle_notifier_started_ = false;
@@ -1303,6 +1370,9 @@ class Environment : public MemoryRetainer {
   bool emit_err_name_warning_ = true;
   bool emit_filehandle_warning_ = true;
   size_t async_callback_scope_depth_ = 0;
+  CallbackScopeStats callback_scope_stats_;
+  bool tick_batch_active_ = false;
+  bool tick_batch_pending_ = false;
   std::vector<double> destroy_async_id_list_;
 
 #if HAVE_INSPECTOR
@@ -1382,6 +1452,8 @@ class Environment : public MemoryRetainer {
 
   char* http_parser_buffer_ = nullptr;
   bool http_parser_buffer_in_use_ = false;
+  char* stream_read_buffer_ = nullptr;
+  bool stream_read_buffer_in_use_ = false;
   std::unique_ptr<http2::Http2State> http2_state_;
 
   bool debug_enabled_[static_cast<int>(DebugCategory::CATEGORY_COUNT)] = {
@@ -1393,6 +1465,8 @@ class Environment : public MemoryRetainer {
   std::vector<std::unique_ptr<fs::FileHandleReadWrap>>
       file_handle_read_wrap_freelist_;
 
+  ScratchArena scratch_arena_;
+
   worker::Worker* worker_context_ = nullptr;
 
   std::list<node_module> extra_linked_bindings_;
@@ -1461,11 +1535,14 @@ class Environment : public MemoryRetainer {
   Environment** interrupt_data_ = nullptr;
   void RequestInterruptFromV8();
   static void CheckImmediate(uv_check_t* handle);
+  void FlushTickBatch();
 
   // Use an unordered_set, so that we have efficient insertion and removal.
   std::unordered_set<CleanupHookCallback,
                      CleanupHookCallback::Hash,
                      CleanupHookCallback::Equal> cleanup_hooks_;
+  // Most recently added first.
+  BaseObjectCleanupQueue base_object_cleanup_queue_;
   uint64_t cleanup_hook_counter_ = 0;
   bool started_cleanup_ = false;
 
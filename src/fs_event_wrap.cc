@@ -25,9 +25,20 @@
 #include "handle_wrap.h"
 #include "string_bytes.h"
 
+#ifdef __linux__
+#include <dirent.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#endif  // __linux__
 
 namespace node {
 
+using v8::Array;
 using v8::Context;
 using v8::DontDelete;
 using v8::DontEnum;
@@ -37,11 +48,13 @@ using v8::HandleScope;
 using v8::Integer;
 using v8::Local;
 using v8::MaybeLocal;
+using v8::Null;
 using v8::Object;
 using v8::PropertyAttribute;
 using v8::ReadOnly;
 using v8::Signature;
 using v8::String;
+using v8::Uint32;
 using v8::Value;
 
 namespace {
@@ -73,6 +86,10 @@ class FSEventWrap: public HandleWrap {
   enum encoding encoding_ = kDefaultEncoding;
 };
 
+#ifdef __linux__
+void InitializeRecursiveFSEvent(Environment* env, Local<Object> target);
+#endif
+
 
 FSEventWrap::FSEventWrap(Environment* env, Local<Object> object)
     : HandleWrap(env,
@@ -119,6 +136,10 @@ void FSEventWrap::Initialize(Local<Object> target,
   target->Set(env->context(),
               fsevent_string,
               t->GetFunction(context).ToLocalChecked()).Check();
+
+#ifdef __linux__
+  InitializeRecursiveFSEvent(env, target);
+#endif
 }
 
 
@@ -229,6 +250,408 @@ void FSEventWrap::OnEvent(uv_fs_event_t* handle, const char* filename,
   wrap->MakeCallback(env->onchange_string(), arraysize(argv), argv);
 }
 
+#ifdef __linux__
+// libuv watches a single directory per uv_fs_event_t on Linux. This watches a
+// whole directory tree with one inotify instance instead, and adds a watch
+// for each directory as it appears. Events are coalesced per file and
+// delivered to JS in batches, once the debounce timer has expired.
+class RecursiveFSEventWrap : public HandleWrap {
+ public:
+  static void Initialize(Environment* env, Local<Object> target);
+  static void New(const FunctionCallbackInfo<Value>& args);
+  static void Start(const FunctionCallbackInfo<Value>& args);
+  static void GetInitialized(const FunctionCallbackInfo<Value>& args);
+
+  void Close(Local<Value> close_callback = Local<Value>()) override;
+
+  SET_NO_MEMORY_INFO()
+  SET_MEMORY_INFO_NAME(RecursiveFSEventWrap)
+  SET_SELF_SIZE(RecursiveFSEventWrap)
+
+ private:
+  static const encoding kDefaultEncoding = UTF8;
+  static const uint32_t kWatchMask = IN_ATTRIB | IN_CREATE | IN_MODIFY |
+                                     IN_DELETE | IN_DELETE_SELF |
+                                     IN_MOVE_SELF | IN_MOVED_FROM |
+                                     IN_MOVED_TO;
+
+  struct Change {
+    bool rename;
+    // A change without a filename means that events have been dropped by
+    // the kernel, and the whole tree may have changed.
+    bool has_filename;
+    std::string filename;
+  };
+
+  RecursiveFSEventWrap(Environment* env, Local<Object> object);
+  ~RecursiveFSEventWrap() override;
+
+  int AddWatches(const std::string& dir, bool report);
+  void RemoveWatches(const std::string& dir);
+  void Queue(bool rename, std::string filename);
+  void ReadEvents();
+  void Flush();
+  void Fail(int status);
+
+  static void OnPoll(uv_poll_t* handle, int status, int events);
+  static void OnTimer(uv_timer_t* timer);
+
+  uv_poll_t handle_;
+  // The timer is allocated separately, so that it can be closed
+  // independently of the poll handle that owns this object.
+  uv_timer_t* timer_ = nullptr;
+  int fd_ = -1;
+  std::string root_;
+  uint32_t debounce_ = 0;
+  enum encoding encoding_ = kDefaultEncoding;
+  // Maps watch descriptors to the paths of their directories, relative to
+  // the root.
+  std::unordered_map<int, std::string> watches_;
+  std::vector<Change> changes_;
+  std::unordered_map<std::string, size_t> change_index_;
+};
+
+
+RecursiveFSEventWrap::RecursiveFSEventWrap(Environment* env,
+                                           Local<Object> object)
+    : HandleWrap(env,
+                 object,
+                 reinterpret_cast<uv_handle_t*>(&handle_),
+                 AsyncWrap::PROVIDER_FSEVENTWRAP) {
+  MarkAsUninitialized();
+}
+
+
+RecursiveFSEventWrap::~RecursiveFSEventWrap() {
+  if (fd_ != -1)
+    CHECK_EQ(close(fd_), 0);
+}
+
+
+void RecursiveFSEventWrap::Initialize(Environment* env,
+                                      Local<Object> target) {
+  auto class_name =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "RecursiveFSEvent");
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  t->SetClassName(class_name);
+
+  t->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  env->SetProtoMethod(t, "start", Start);
+  env->SetProtoMethod(t, "close", HandleWrap::Close);
+
+  Local<FunctionTemplate> get_initialized_templ =
+      FunctionTemplate::New(env->isolate(),
+                            GetInitialized,
+                            env->as_callback_data(),
+                            Signature::New(env->isolate(), t));
+
+  t->PrototypeTemplate()->SetAccessorProperty(
+      FIXED_ONE_BYTE_STRING(env->isolate(), "initialized"),
+      get_initialized_templ,
+      Local<FunctionTemplate>(),
+      static_cast<PropertyAttribute>(ReadOnly | DontDelete | DontEnum));
+
+  target->Set(env->context(),
+              class_name,
+              t->GetFunction(env->context()).ToLocalChecked()).Check();
+}
+
+
+void RecursiveFSEventWrap::New(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args.IsConstructCall());
+  Environment* env = Environment::GetCurrent(args);
+  new RecursiveFSEventWrap(env, args.This());
+}
+
+
+void RecursiveFSEventWrap::GetInitialized(
+    const FunctionCallbackInfo<Value>& args) {
+  RecursiveFSEventWrap* wrap = Unwrap<RecursiveFSEventWrap>(args.This());
+  CHECK_NOT_NULL(wrap);
+  args.GetReturnValue().Set(!wrap->IsHandleClosing());
+}
+
+
+// wrap.start(filename, persistent, encoding, debounce)
+void RecursiveFSEventWrap::Start(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  RecursiveFSEventWrap* wrap = Unwrap<RecursiveFSEventWrap>(args.This());
+  CHECK_NOT_NULL(wrap);
+  CHECK(wrap->IsHandleClosing());  // Check that Start() has not been called.
+
+  CHECK_GE(args.Length(), 4);
+  BufferValue path(env->isolate(), args[0]);
+  CHECK_NOT_NULL(*path);
+  CHECK(args[3]->IsUint32());
+
+  wrap->root_ = *path;
+  wrap->encoding_ = ParseEncoding(env->isolate(), args[2], kDefaultEncoding);
+  wrap->debounce_ = args[3].As<Uint32>()->Value();
+
+  wrap->fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (wrap->fd_ == -1)
+    return args.GetReturnValue().Set(uv_translate_sys_error(errno));
+
+  int err = uv_poll_init(env->event_loop(), &wrap->handle_, wrap->fd_);
+  if (err != 0) {
+    CHECK_EQ(close(wrap->fd_), 0);
+    wrap->fd_ = -1;
+    return args.GetReturnValue().Set(err);
+  }
+
+  wrap->timer_ = new uv_timer_t();
+  CHECK_EQ(uv_timer_init(env->event_loop(), wrap->timer_), 0);
+  wrap->timer_->data = wrap;
+  wrap->MarkAsInitialized();
+
+  err = wrap->AddWatches("", false);
+  if (err == 0)
+    err = uv_poll_start(&wrap->handle_, UV_READABLE, OnPoll);
+  if (err != 0) {
+    wrap->Close();
+    return args.GetReturnValue().Set(err);
+  }
+
+  // Check for persistent argument
+  if (!args[1]->IsTrue()) {
+    uv_unref(reinterpret_cast<uv_handle_t*>(&wrap->handle_));
+    uv_unref(reinterpret_cast<uv_handle_t*>(wrap->timer_));
+  }
+
+  args.GetReturnValue().Set(0);
+}
+
+
+void RecursiveFSEventWrap::Close(Local<Value> close_callback) {
+  if (timer_ != nullptr) {
+    uv_close(reinterpret_cast<uv_handle_t*>(timer_), [](uv_handle_t* handle) {
+      delete reinterpret_cast<uv_timer_t*>(handle);
+    });
+    timer_ = nullptr;
+  }
+  HandleWrap::Close(close_callback);
+}
+
+
+// Adds watches for the directory at |dir|, relative to the root, and for all
+// of its subdirectories. When |report| is true, the entries that are found are
+// queued as changes, because they may have been created before their parent
+// directory was watched.
+int RecursiveFSEventWrap::AddWatches(const std::string& dir, bool report) {
+  std::vector<std::string> pending { dir };
+  while (!pending.empty()) {
+    std::string rel = std::move(pending.back());
+    pending.pop_back();
+    std::string full = rel.empty() ? root_ : root_ + '/' + rel;
+
+    // Symbolic links to directories inside the tree are not followed.
+    uint32_t mask = kWatchMask;
+    if (!rel.empty())
+      mask |= IN_ONLYDIR | IN_DONT_FOLLOW;
+    int wd = inotify_add_watch(fd_, full.c_str(), mask);
+    if (wd == -1) {
+      // Directories that were removed in the meantime are skipped.
+      if (!rel.empty() && (errno == ENOENT || errno == ENOTDIR))
+        continue;
+      return uv_translate_sys_error(errno);
+    }
+    watches_[wd] = rel;
+
+    DIR* d = opendir(full.c_str());
+    if (d == nullptr)
+      continue;
+    while (const dirent* ent = readdir(d)) {
+      if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0)
+        continue;
+      std::string child = rel.empty() ? ent->d_name : rel + '/' + ent->d_name;
+      bool is_dir = ent->d_type == DT_DIR;
+      if (ent->d_type == DT_UNKNOWN) {
+        struct stat s;
+        is_dir = lstat((root_ + '/' + child).c_str(), &s) == 0 &&
+                 S_ISDIR(s.st_mode);
+      }
+      if (report)
+        Queue(true, child);
+      if (is_dir)
+        pending.emplace_back(std::move(child));
+    }
+    closedir(d);
+  }
+  return 0;
+}
+
+
+// Removes the watches of a directory that has been moved out of its place in
+// the tree, along with those of its subdirectories.
+void RecursiveFSEventWrap::RemoveWatches(const std::string& dir) {
+  const std::string prefix = dir + '/';
+  for (auto it = watches_.begin(); it != watches_.end();) {
+    const std::string& path = it->second;
+    if (path == dir || path.compare(0, prefix.size(), prefix) == 0) {
+      inotify_rm_watch(fd_, it->first);
+      it = watches_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+
+// Coalesces the changes of a file until the next batch is delivered. A
+// rename implies a change, like in FSEventWrap::OnEvent().
+void RecursiveFSEventWrap::Queue(bool rename, std::string filename) {
+  auto it = change_index_.find(filename);
+  if (it != change_index_.end()) {
+    changes_[it->second].rename |= rename;
+    return;
+  }
+  change_index_.emplace(filename, changes_.size());
+  changes_.push_back({ rename, true, std::move(filename) });
+}
+
+
+void RecursiveFSEventWrap::OnPoll(uv_poll_t* handle, int status, int events) {
+  RecursiveFSEventWrap* wrap =
+      ContainerOf(&RecursiveFSEventWrap::handle_, handle);
+  if (status != 0)
+    return wrap->Fail(status);
+  wrap->ReadEvents();
+}
+
+
+void RecursiveFSEventWrap::ReadEvents() {
+  alignas(inotify_event) char buf[16 * 1024];
+  for (;;) {
+    ssize_t size = read(fd_, buf, sizeof(buf));
+    if (size == -1) {
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        break;
+      return Fail(uv_translate_sys_error(errno));
+    }
+
+    for (char* p = buf; p < buf + size;) {
+      const inotify_event* event = reinterpret_cast<inotify_event*>(p);
+      p += sizeof(*event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        changes_.push_back({ true, false, std::string() });
+        continue;
+      }
+
+      auto it = watches_.find(event->wd);
+      if (it == watches_.end())
+        continue;
+      if (event->mask & IN_IGNORED) {
+        watches_.erase(it);
+        continue;
+      }
+
+      std::string filename;
+      if (event->len > 0) {
+        filename = it->second.empty() ?
+            event->name : it->second + '/' + event->name;
+      } else if (it->second.empty()) {
+        // An event on the root itself, which is reported with its basename,
+        // like libuv does.
+        size_t slash = root_.find_last_of('/');
+        filename = slash == std::string::npos ?
+            root_ : root_.substr(slash + 1);
+      } else {
+        // Events on subdirectories themselves are also reported to their
+        // parent directories.
+        continue;
+      }
+
+      const bool is_dir = event->mask & IN_ISDIR;
+      if (is_dir && (event->mask & IN_MOVED_FROM))
+        RemoveWatches(filename);
+      if (is_dir && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+        Queue(true, filename);
+        int err = AddWatches(filename, true);
+        if (err != 0)
+          return Fail(err);
+        continue;
+      }
+      Queue(!(event->mask & (IN_MODIFY | IN_ATTRIB)), std::move(filename));
+    }
+  }
+
+  if (!changes_.empty() && !uv_is_active(
+          reinterpret_cast<uv_handle_t*>(timer_))) {
+    uv_timer_start(timer_, OnTimer, debounce_, 0);
+  }
+}
+
+
+void RecursiveFSEventWrap::OnTimer(uv_timer_t* timer) {
+  static_cast<RecursiveFSEventWrap*>(timer->data)->Flush();
+}
+
+
+// Delivers the queued changes as a flat array of event types and filenames.
+void RecursiveFSEventWrap::Flush() {
+  Environment* env = this->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  std::vector<Local<Value>> values;
+  values.reserve(changes_.size() * 2);
+  for (const Change& change : changes_) {
+    values.push_back(change.rename ? env->rename_string() :
+                                     env->change_string());
+    if (!change.has_filename) {
+      values.push_back(Null(env->isolate()));
+      continue;
+    }
+    Local<Value> error;
+    Local<Value> filename;
+    // Filenames that cannot be decoded are passed as Buffers.
+    if (!StringBytes::Encode(env->isolate(),
+                             change.filename.c_str(),
+                             encoding_,
+                             &error).ToLocal(&filename)) {
+      filename = StringBytes::Encode(env->isolate(),
+                                     change.filename.data(),
+                                     change.filename.size(),
+                                     BUFFER,
+                                     &error).ToLocalChecked();
+    }
+    values.push_back(filename);
+  }
+  changes_.clear();
+  change_index_.clear();
+
+  Local<Value> argv[] = {
+    Array::New(env->isolate(), values.data(), values.size())
+  };
+  MakeCallback(env->onchanges_string(), arraysize(argv), argv);
+}
+
+
+void RecursiveFSEventWrap::Fail(int status) {
+  Environment* env = this->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  uv_poll_stop(&handle_);
+  Local<Value> argv[] = {
+    Integer::New(env->isolate(), status),
+    String::Empty(env->isolate()),
+    Null(env->isolate())
+  };
+  MakeCallback(env->onchange_string(), arraysize(argv), argv);
+}
+
+
+void InitializeRecursiveFSEvent(Environment* env, Local<Object> target) {
+  RecursiveFSEventWrap::Initialize(env, target);
+}
+#endif  // __linux__
+
 }  // anonymous namespace
 }  // namespace node
 
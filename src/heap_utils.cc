@@ -1,7 +1,9 @@
 #include "diagnosticfilename-inl.h"
 #include "env-inl.h"
 #include "memory_tracker-inl.h"
+#include "node_internals.h"
 #include "stream_base-inl.h"
+#include "threadpoolwork-inl.h"
 #include "util-inl.h"
 
 using v8::Array;
@@ -14,14 +16,17 @@ using v8::FunctionTemplate;
 using v8::Global;
 using v8::HandleScope;
 using v8::HeapSnapshot;
+using v8::Integer;
 using v8::Isolate;
 using v8::JSON;
 using v8::Local;
 using v8::MaybeLocal;
+using v8::NewStringType;
 using v8::Number;
 using v8::Object;
 using v8::ObjectTemplate;
 using v8::String;
+using v8::Undefined;
 using v8::Value;
 
 namespace node {
@@ -206,9 +211,13 @@ void BuildEmbedderGraph(const FunctionCallbackInfo<Value>& args) {
 }
 
 namespace {
+// Collects the chunks of a snapshot into large writes to a file descriptor.
+// It does not use the isolate, so that it can run on the threadpool.
 class FileOutputStream : public v8::OutputStream {
  public:
-  explicit FileOutputStream(FILE* stream) : stream_(stream) {}
+  explicit FileOutputStream(uv_file fd) : fd_(fd) {
+    buffer_.reserve(kBufferSize);
+  }
 
   int GetChunkSize() override {
     return 65536;  // big chunks == faster
@@ -217,17 +226,142 @@ class FileOutputStream : public v8::OutputStream {
   void EndOfStream() override {}
 
   WriteResult WriteAsciiChunk(char* data, int size) override {
-    const size_t len = static_cast<size_t>(size);
-    size_t off = 0;
+    if (buffer_.size() + size > kBufferSize && !Flush())
+      return kAbort;
+    buffer_.insert(buffer_.end(), data, data + size);
+    return kContinue;
+  }
+
+  // Writes out what is buffered. Returns false, and keeps the error, if the
+  // write fails.
+  bool Flush() {
+    size_t offset = 0;
+    while (error_ == 0 && offset < buffer_.size()) {
+      uv_buf_t buf = uv_buf_init(buffer_.data() + offset,
+                                 buffer_.size() - offset);
+      uv_fs_t req;
+      const int written = uv_fs_write(nullptr, &req, fd_, &buf, 1, -1, nullptr);
+      uv_fs_req_cleanup(&req);
+      if (written < 0)
+        error_ = written;
+      else
+        offset += written;
+    }
+    buffer_.clear();
+    return error_ == 0;
+  }
+
+  int error() const { return error_; }
+
+ private:
+  static constexpr size_t kBufferSize = 4 * 1024 * 1024;
+
+  uv_file fd_;
+  std::vector<char> buffer_;
+  int error_ = 0;
+};
+
+// Serializes `snapshot` into the file at `path`. Returns 0 on success, or a
+// libuv error code, in which case `syscall` is set to the call that failed.
+int WriteSnapshotFile(const HeapSnapshot* snapshot,
+                      const char* path,
+                      const char** syscall) {
+  uv_fs_t req;
+  const int fd = uv_fs_open(nullptr,
+                            &req,
+                            path,
+                            O_WRONLY | O_CREAT | O_TRUNC,
+                            0666,
+                            nullptr);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0) {
+    *syscall = "open";
+    return fd;
+  }
+
+  FileOutputStream stream(fd);
+  snapshot->Serialize(&stream, HeapSnapshot::kJSON);
+  stream.Flush();
+  int err = stream.error();
+  if (err != 0)
+    *syscall = "write";
+
+  const int close_err = uv_fs_close(nullptr, &req, fd, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (err == 0 && close_err != 0) {
+    err = close_err;
+    *syscall = "close";
+  }
+  return err;
+}
+
+// Serializes a snapshot into a file on the threadpool, for
+// v8.writeHeapSnapshot() with a callback. Only taking the snapshot blocks the
+// thread that owns the isolate, the snapshot is immutable once it is taken.
+class HeapSnapshotWriteWrap : public AsyncWrap, public ThreadPoolWork {
+ public:
+  HeapSnapshotWriteWrap(Environment* env, Local<Object> obj)
+      : AsyncWrap(env, obj, AsyncWrap::PROVIDER_HEAPSNAPSHOT),
+        ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_KIND_FS) {}
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    CHECK(args.IsConstructCall());
+    Environment* env = Environment::GetCurrent(args);
+    new HeapSnapshotWriteWrap(env, args.This());
+  }
+
+  void Start(HeapSnapshotPointer&& snapshot, std::string&& path) {
+    snapshot_ = std::move(snapshot);
+    path_ = std::move(path);
+    ScheduleWork();
+  }
+
+  void DoThreadPoolWork() override {
+    error_ = WriteSnapshotFile(snapshot_.get(), path_.c_str(), &syscall_);
+  }
 
-    while (off < len && !feof(stream_) && !ferror(stream_))
-      off += fwrite(data + off, 1, len - off, stream_);
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<HeapSnapshotWriteWrap> self(this);
+    Environment* env = AsyncWrap::env();
+    snapshot_.reset();
+    if (!env->can_call_into_js())
+      return;
+    if (status != 0) {
+      error_ = status;
+      syscall_ = "write";
+    }
 
-    return off == len ? kContinue : kAbort;
+    Isolate* isolate = env->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env->context());
+    Local<Value> argv[] = {
+      Integer::New(isolate, error_),
+      OneByteString(isolate, syscall_),
+      Undefined(isolate)
+    };
+    if (!String::NewFromUtf8(isolate, path_.c_str(), NewStringType::kNormal)
+             .ToLocal(&argv[2])) {
+      return;
+    }
+    MakeCallback(env->oncomplete_string(), arraysize(argv), argv);
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackField("path", path_);
+    if (snapshot_ != nullptr) {
+      tracker->TrackFieldWithSize(
+          "snapshot", sizeof(*snapshot_), "HeapSnapshot");
+    }
   }
 
+  SET_MEMORY_INFO_NAME(HeapSnapshotWriteWrap)
+  SET_SELF_SIZE(HeapSnapshotWriteWrap)
+
  private:
-  FILE* stream_;
+  HeapSnapshotPointer snapshot_;
+  std::string path_;
+  int error_ = 0;
+  const char* syscall_ = "";
 };
 
 class HeapSnapshotStream : public AsyncWrap,
@@ -310,20 +444,15 @@ class HeapSnapshotStream : public AsyncWrap,
   HeapSnapshotPointer snapshot_;
 };
 
-inline void TakeSnapshot(Isolate* isolate, v8::OutputStream* out) {
-  HeapSnapshotPointer snapshot {
+inline HeapSnapshotPointer TakeSnapshot(Isolate* isolate) {
+  return HeapSnapshotPointer {
       isolate->GetHeapProfiler()->TakeHeapSnapshot() };
-  snapshot->Serialize(out, HeapSnapshot::kJSON);
 }
 
 inline bool WriteSnapshot(Isolate* isolate, const char* filename) {
-  FILE* fp = fopen(filename, "w");
-  if (fp == nullptr)
-    return false;
-  FileOutputStream stream(fp);
-  TakeSnapshot(isolate, &stream);
-  fclose(fp);
-  return true;
+  const char* syscall;
+  return WriteSnapshotFile(
+      TakeSnapshot(isolate).get(), filename, &syscall) == 0;
 }
 
 }  // namespace
@@ -368,28 +497,39 @@ void CreateHeapSnapshotStream(const FunctionCallbackInfo<Value>& args) {
     args.GetReturnValue().Set(stream->object());
 }
 
+// When a HeapSnapshotWriteWrap is passed as the second argument, the
+// snapshot is written on the threadpool and the wrap's oncomplete callback is
+// called with (err, syscall, filename).
 void TriggerHeapSnapshot(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   Isolate* isolate = args.GetIsolate();
 
-  Local<Value> filename_v = args[0];
+  HeapSnapshotWriteWrap* wrap = nullptr;
+  if (args[1]->IsObject())
+    ASSIGN_OR_RETURN_UNWRAP(&wrap, args[1].As<Object>());
 
+  Local<Value> filename_v = args[0];
+  std::string filename;
   if (filename_v->IsUndefined()) {
     DiagnosticFilename name(env, "Heap", "heapsnapshot");
-    if (!WriteSnapshot(isolate, *name))
+    filename = *name;
+    if (!String::NewFromUtf8(isolate, *name, v8::NewStringType::kNormal)
+             .ToLocal(&filename_v)) {
       return;
-    if (String::NewFromUtf8(isolate, *name, v8::NewStringType::kNormal)
-            .ToLocal(&filename_v)) {
-      args.GetReturnValue().Set(filename_v);
     }
-    return;
+  } else {
+    BufferValue path(isolate, filename_v);
+    CHECK_NOT_NULL(*path);
+    filename = *path;
   }
 
-  BufferValue path(isolate, filename_v);
-  CHECK_NOT_NULL(*path);
-  if (!WriteSnapshot(isolate, *path))
+  if (wrap != nullptr) {
+    wrap->Start(TakeSnapshot(isolate), std::move(filename));
     return;
-  return args.GetReturnValue().Set(filename_v);
+  }
+  if (!WriteSnapshot(isolate, filename.c_str()))
+    return;
+  args.GetReturnValue().Set(filename_v);
 }
 
 void Initialize(Local<Object> target,
@@ -401,6 +541,18 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "buildEmbedderGraph", BuildEmbedderGraph);
   env->SetMethod(target, "triggerHeapSnapshot", TriggerHeapSnapshot);
   env->SetMethod(target, "createHeapSnapshotStream", CreateHeapSnapshotStream);
+
+  Local<FunctionTemplate> write_wrap =
+      env->NewFunctionTemplate(HeapSnapshotWriteWrap::New);
+  write_wrap->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  write_wrap->InstanceTemplate()->SetInternalFieldCount(1);
+  Local<String> write_wrap_string =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "HeapSnapshotWriteWrap");
+  write_wrap->SetClassName(write_wrap_string);
+  target->Set(env->context(),
+              write_wrap_string,
+              write_wrap->GetFunction(env->context()).ToLocalChecked())
+      .Check();
 }
 
 }  // namespace heap
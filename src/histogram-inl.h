@@ -24,6 +24,18 @@ inline bool Histogram::Record(int64_t value) {
   return hdr_record_value(histogram_, value);
 }
 
+inline bool Histogram::RecordValues(int64_t value, int64_t count) {
+  return hdr_record_values(histogram_, value, count);
+}
+
+inline int64_t Histogram::Add(const Histogram& other) {
+  return hdr_add(histogram_, other.histogram_);
+}
+
+inline int64_t Histogram::Count() const {
+  return histogram_->total_count;
+}
+
 inline int64_t Histogram::Min() {
   return hdr_min(histogram_);
 }
@@ -56,6 +68,14 @@ inline void Histogram::Percentiles(std::function<void(double, double)> fn) {
   }
 }
 
+inline void Histogram::RecordedValues(
+    std::function<void(int64_t, int64_t)> fn) const {
+  hdr_iter iter;
+  hdr_iter_recorded_init(&iter, histogram_);
+  while (hdr_iter_next(&iter))
+    fn(iter.value, iter.count);
+}
+
 }  // namespace node
 
 #endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
@@ -15,13 +15,24 @@ class Histogram {
   inline virtual ~Histogram();
 
   inline bool Record(int64_t value);
+  inline bool RecordValues(int64_t value, int64_t count);
+  // Adds all values of `other` to this histogram, and returns the number of
+  // them that could not be recorded because they are out of range.
+  inline int64_t Add(const Histogram& other);
   inline void Reset();
+  inline int64_t Count() const;
   inline int64_t Min();
   inline int64_t Max();
   inline double Mean();
   inline double Stddev();
   inline double Percentile(double percentile);
   inline void Percentiles(std::function<void(double, double)> fn);
+  // Calls `fn` with each distinct value and how often it was recorded.
+  inline void RecordedValues(std::function<void(int64_t, int64_t)> fn) const;
+
+  int64_t lowest() const { return histogram_->lowest_trackable_value; }
+  int64_t highest() const { return histogram_->highest_trackable_value; }
+  int figures() const { return histogram_->significant_figures; }
 
   size_t GetMemorySize() const {
     return hdr_get_memory_size(histogram_);
@@ -205,6 +205,14 @@ class ThreadSafeDelegate : public InspectorSessionDelegate {
     });
   }
 
+  void SendBufferToFrontend(std::unique_ptr<StringBuffer> message) override {
+    delegate_.Call(
+        [m = std::move(message)]
+        (InspectorSessionDelegate* delegate) mutable {
+      delegate->SendBufferToFrontend(std::move(m));
+    });
+  }
+
  private:
   std::shared_ptr<MainThreadHandle> thread_;
   AnotherThreadObjectReference<InspectorSessionDelegate> delegate_;
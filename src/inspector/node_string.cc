@@ -10,6 +10,38 @@ namespace StringUtil {
 
 size_t kNotFound = std::string::npos;
 
+namespace {
+
+class JsonPlatform : public json::Platform {
+ public:
+  bool StrToD(const char* str, double* result) const override {
+    bool ok;
+    *result = toDouble(str, std::strlen(str), &ok);
+    return ok;
+  }
+
+  // Unlike fromDouble(), this needs to round-trip, since it is used for
+  // the values that V8 itself produced.
+  std::unique_ptr<char[]> DToStr(double value) const override {
+    std::string str;
+    for (int precision = 15; precision <= 17; precision++) {
+      std::ostringstream stream;
+      stream.imbue(std::locale("C"));  // Ignore locale
+      stream.precision(precision);
+      stream << value;
+      str = stream.str();
+      bool ok;
+      if (toDouble(str.data(), str.length(), &ok) == value && ok)
+        break;
+    }
+    std::unique_ptr<char[]> result(new char[str.length() + 1]);
+    memcpy(result.get(), str.c_str(), str.length() + 1);
+    return result;
+  }
+};
+
+}  // namespace
+
 // NOLINTNEXTLINE(runtime/references) V8 API requirement
 void builderAppendQuotedString(StringBuilder& builder, const String& string) {
   builder.put('"');
@@ -123,6 +155,26 @@ size_t CharacterCount(const String& s) {
   return utf16.countChar32();
 }
 
+bool IsCBORMessage(v8_inspector::StringView message) {
+  return message.is8Bit() && message.length() >= 2 &&
+         message.characters8()[0] == 0xd8 && message.characters8()[1] == 0x5a;
+}
+
+bool ConvertJSONToCBOR(const std::string& json, std::string* cbor) {
+  JsonPlatform platform;
+  span<uint8_t> chars(reinterpret_cast<const uint8_t*>(json.data()),
+                      json.length());
+  return json::ConvertJSONToCBOR(platform, chars, cbor).ok();
+}
+
+bool ConvertCBORToJSON(v8_inspector::StringView cbor, std::string* json) {
+  if (!IsCBORMessage(cbor))
+    return false;
+  JsonPlatform platform;
+  span<uint8_t> bytes(cbor.characters8(), cbor.length());
+  return json::ConvertCBORToJSON(platform, bytes, json).ok();
+}
+
 }  // namespace StringUtil
 }  // namespace protocol
 }  // namespace inspector
@@ -76,6 +76,15 @@ String fromUTF16(const uint16_t* data, size_t length);
 const uint8_t* CharactersUTF8(const String& s);
 size_t CharacterCount(const String& s);
 
+// Whether |message| is a CBOR encoded protocol message. V8 switches a session
+// to CBOR encoded responses once it has received a CBOR encoded command.
+bool IsCBORMessage(v8_inspector::StringView message);
+// Transcode protocol messages between JSON and CBOR, so that this can happen
+// on the inspector IO thread instead of the main thread. Both return false
+// if the message is malformed.
+bool ConvertJSONToCBOR(const std::string& json, std::string* cbor);
+bool ConvertCBORToJSON(v8_inspector::StringView cbor, std::string* json);
+
 // Unimplemented. The generated code will fall back to CharactersUTF8().
 inline uint8_t* CharactersLatin1(const String& s) { return nullptr; }
 inline const uint16_t* CharactersUTF16(const String& s) { return nullptr; }
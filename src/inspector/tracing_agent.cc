@@ -2,16 +2,77 @@
 #include "main_thread_interface.h"
 #include "node_internals.h"
 #include "node_v8_platform-inl.h"
+#include "tracing/trace_event.h"
 #include "v8.h"
 
+#include <atomic>
 #include <set>
 #include <sstream>
+#include <unordered_map>
 
 namespace node {
 namespace inspector {
 namespace protocol {
 
+using SamplingRates = std::unordered_map<std::string, double>;
+
+// State that is shared between the TracingAgent on the main thread and the
+// InspectorTraceWriter on the tracing thread.
+class TraceStreamState {
+ public:
+  void SetSamplingRate(const std::string& category, double rate) {
+    Mutex::ScopedLock lock(mutex_);
+    if (rate >= 1)
+      sampling_rates_.erase(category);
+    else
+      sampling_rates_[category] = rate;
+    sampling_rates_generation_++;
+  }
+
+  uint64_t sampling_rates_generation() const {
+    return sampling_rates_generation_;
+  }
+
+  SamplingRates GetSamplingRates(uint64_t* generation) {
+    Mutex::ScopedLock lock(mutex_);
+    *generation = sampling_rates_generation_;
+    return sampling_rates_;
+  }
+
+  void Start(int max_pending_chunks) {
+    max_pending_chunks_ = max_pending_chunks;
+    pending_chunks_ = 0;
+    dropped_events_ = 0;
+  }
+
+  bool CanSendChunk() const {
+    int max_pending_chunks = max_pending_chunks_;
+    return max_pending_chunks == 0 || pending_chunks_ < max_pending_chunks;
+  }
+
+  void OnChunkSent() { pending_chunks_++; }
+
+  void OnEventDropped() { dropped_events_++; }
+
+  int TakeDroppedEventCount() { return dropped_events_.exchange(0); }
+
+  void OnChunkAcknowledged() {
+    int pending = pending_chunks_;
+    while (pending > 0 &&
+           !pending_chunks_.compare_exchange_weak(pending, pending - 1)) {}
+  }
+
+ private:
+  Mutex mutex_;  // Protects sampling_rates_.
+  SamplingRates sampling_rates_;
+  std::atomic<uint64_t> sampling_rates_generation_ {0};
+  std::atomic<int> max_pending_chunks_ {0};
+  std::atomic<int> pending_chunks_ {0};
+  std::atomic<int> dropped_events_ {0};
+};
+
 namespace {
+using v8::platform::tracing::TraceObject;
 using v8::platform::tracing::TraceWriter;
 
 class DeletableFrontendWrapper : public Deletable {
@@ -82,11 +143,18 @@ class SendMessageRequest : public Request {
 class InspectorTraceWriter : public node::tracing::AsyncTraceWriter {
  public:
   explicit InspectorTraceWriter(int frontend_object_id,
-                                std::shared_ptr<MainThreadHandle> main_thread)
-      : frontend_object_id_(frontend_object_id), main_thread_(main_thread) {}
+                                std::shared_ptr<MainThreadHandle> main_thread,
+                                std::shared_ptr<TraceStreamState> state)
+      : frontend_object_id_(frontend_object_id), main_thread_(main_thread),
+        state_(state) {}
 
-  void AppendTraceEvent(
-      v8::platform::tracing::TraceObject* trace_event) override {
+  void AppendTraceEvent(TraceObject* trace_event) override {
+    if (!Sample(trace_event))
+      return;
+    if (!state_->CanSendChunk()) {
+      state_->OnEventDropped();
+      return;
+    }
     if (!json_writer_)
       json_writer_.reset(TraceWriter::CreateJSONTraceWriter(stream_, "value"));
     json_writer_->AppendTraceEvent(trace_event);
@@ -96,27 +164,95 @@ class InspectorTraceWriter : public node::tracing::AsyncTraceWriter {
     if (!json_writer_)
       return;
     json_writer_.reset();
+    std::string params = stream_.str();
+    int dropped_events = state_->TakeDroppedEventCount();
+    if (dropped_events > 0) {
+      // Add the count to the object that the JSON writer has closed.
+      params.pop_back();
+      params += ",\"droppedEventCount\":" + std::to_string(dropped_events) +
+                "}";
+    }
     std::ostringstream result(
         "{\"method\":\"NodeTracing.dataCollected\",\"params\":",
         std::ostringstream::ate);
-    result << stream_.str();
+    result << params;
     result << "}";
+    state_->OnChunkSent();
     main_thread_->Post(std::make_unique<SendMessageRequest>(frontend_object_id_,
                                                             result.str()));
     stream_.str("");
   }
 
  private:
+  struct CategorySampler {
+    double rate;
+    double credit;
+  };
+
+  bool Sample(TraceObject* trace_event) {
+    if (state_->sampling_rates_generation() != sampling_rates_generation_) {
+      sampling_rates_ = state_->GetSamplingRates(&sampling_rates_generation_);
+      samplers_.clear();
+    }
+    if (sampling_rates_.empty())
+      return true;
+    // Begin and end events without an id have to match up on their thread.
+    char phase = trace_event->phase();
+    if (phase == TRACE_EVENT_PHASE_BEGIN || phase == TRACE_EVENT_PHASE_END ||
+        phase == TRACE_EVENT_PHASE_METADATA) {
+      return true;
+    }
+    CategorySampler* sampler = GetSampler(trace_event->category_enabled_flag());
+    if (sampler->rate >= 1)
+      return true;
+    if (trace_event->flags() & TRACE_EVENT_FLAG_HAS_ID) {
+      // Spread sequential ids evenly before mapping them onto [0, 1).
+      uint64_t hash = trace_event->id() * 0x9e3779b97f4a7c15;
+      return static_cast<double>(hash >> 11) / (uint64_t{1} << 53) <
+             sampler->rate;
+    }
+    sampler->credit += sampler->rate;
+    if (sampler->credit < 1)
+      return false;
+    sampler->credit -= 1;
+    return true;
+  }
+
+  // A category group such as "node,node.async_hooks" gets the lowest rate of
+  // the categories it consists of.
+  CategorySampler* GetSampler(const uint8_t* category_enabled_flag) {
+    auto it = samplers_.find(category_enabled_flag);
+    if (it != samplers_.end())
+      return &it->second;
+    double rate = 1;
+    std::istringstream group(
+        tracing::TracingController::GetCategoryGroupName(
+            category_enabled_flag));
+    std::string category;
+    while (std::getline(group, category, ',')) {
+      auto rate_it = sampling_rates_.find(category);
+      if (rate_it != sampling_rates_.end() && rate_it->second < rate)
+        rate = rate_it->second;
+    }
+    return &samplers_.emplace(category_enabled_flag,
+                              CategorySampler { rate, 0 }).first->second;
+  }
+
   std::unique_ptr<TraceWriter> json_writer_;
   std::ostringstream stream_;
   int frontend_object_id_;
   std::shared_ptr<MainThreadHandle> main_thread_;
+  std::shared_ptr<TraceStreamState> state_;
+  uint64_t sampling_rates_generation_ = 0;
+  SamplingRates sampling_rates_;
+  std::unordered_map<const uint8_t*, CategorySampler> samplers_;
 };
 }  // namespace
 
 TracingAgent::TracingAgent(Environment* env,
                            std::shared_ptr<MainThreadHandle> main_thread)
-    : env_(env), main_thread_(main_thread) {}
+    : env_(env), main_thread_(main_thread),
+      stream_state_(std::make_shared<TraceStreamState>()) {}
 
 TracingAgent::~TracingAgent() {
   trace_writer_.reset();
@@ -153,12 +289,18 @@ DispatchResponse TracingAgent::start(
   if (categories_set.empty())
     return DispatchResponse::Error("At least one category should be enabled");
 
+  int max_pending_chunks = traceConfig->getMaxPendingChunks(0);
+  if (max_pending_chunks < 0)
+    return DispatchResponse::Error("maxPendingChunks should not be negative");
+  stream_state_->Start(max_pending_chunks);
+
   tracing::AgentWriterHandle* writer = GetTracingAgentWriter();
   if (writer != nullptr) {
     trace_writer_ =
         writer->agent()->AddClient(categories_set,
                                    std::make_unique<InspectorTraceWriter>(
-                                       frontend_object_id_, main_thread_),
+                                       frontend_object_id_, main_thread_,
+                                       stream_state_),
                                    tracing::Agent::kIgnoreDefaultCategories);
   }
   return DispatchResponse::OK();
@@ -166,7 +308,24 @@ DispatchResponse TracingAgent::start(
 
 DispatchResponse TracingAgent::stop() {
   trace_writer_.reset();
-  frontend_->tracingComplete();
+  int dropped_events = stream_state_->TakeDroppedEventCount();
+  if (dropped_events > 0)
+    frontend_->tracingComplete(dropped_events);
+  else
+    frontend_->tracingComplete();
+  return DispatchResponse::OK();
+}
+
+DispatchResponse TracingAgent::setSamplingRate(const String& category,
+                                               double rate) {
+  if (!(rate >= 0 && rate <= 1))
+    return DispatchResponse::Error("rate should be between 0 and 1");
+  stream_state_->SetSamplingRate(category, rate);
+  return DispatchResponse::OK();
+}
+
+DispatchResponse TracingAgent::acknowledgeData() {
+  stream_state_->OnChunkAcknowledged();
   return DispatchResponse::OK();
 }
 
@@ -14,6 +14,8 @@ class MainThreadHandle;
 
 namespace protocol {
 
+class TraceStreamState;
+
 class TracingAgent : public NodeTracing::Backend {
  public:
   explicit TracingAgent(Environment*, std::shared_ptr<MainThreadHandle>);
@@ -26,10 +28,15 @@ class TracingAgent : public NodeTracing::Backend {
   DispatchResponse stop() override;
   DispatchResponse getCategories(
       std::unique_ptr<protocol::Array<String>>* categories) override;
+  DispatchResponse setSamplingRate(const String& category,
+                                   double rate) override;
+  DispatchResponse acknowledgeData() override;
 
  private:
   Environment* env_;
   std::shared_ptr<MainThreadHandle> main_thread_;
+  // Shared with the trace writer, which runs on the tracing thread.
+  std::shared_ptr<TraceStreamState> stream_state_;
   tracing::AgentWriterHandle trace_writer_;
   int frontend_object_id_;
   std::shared_ptr<NodeTracing::Frontend> frontend_;
@@ -265,7 +265,7 @@ class ChannelImpl final : public v8_inspector::V8Inspector::Channel,
     std::string raw_message = protocol::StringUtil::StringViewToUtf8(message);
     std::unique_ptr<protocol::DictionaryValue> value =
         protocol::DictionaryValue::cast(protocol::StringUtil::parseMessage(
-            raw_message, false));
+            raw_message, protocol::StringUtil::IsCBORMessage(message)));
     int call_id;
     std::string method;
     node_dispatcher_->parseCommand(value.get(), &call_id, &method);
@@ -300,22 +300,18 @@ class ChannelImpl final : public v8_inspector::V8Inspector::Channel,
   void sendResponse(
       int callId,
       std::unique_ptr<v8_inspector::StringBuffer> message) override {
-    sendMessageToFrontend(message->string());
+    delegate_->SendBufferToFrontend(std::move(message));
   }
 
   void sendNotification(
       std::unique_ptr<v8_inspector::StringBuffer> message) override {
-    sendMessageToFrontend(message->string());
+    delegate_->SendBufferToFrontend(std::move(message));
   }
 
   void flushProtocolNotifications() override { }
 
-  void sendMessageToFrontend(const StringView& message) {
-    delegate_->SendMessageToFrontend(message);
-  }
-
   void sendMessageToFrontend(const std::string& message) {
-    sendMessageToFrontend(Utf8ToStringView(message)->string());
+    delegate_->SendBufferToFrontend(Utf8ToStringView(message));
   }
 
   using Serializable = protocol::Serializable;
@@ -463,6 +459,11 @@ bool IsFilePath(const std::string& path) {
 
 }  // namespace
 
+void InspectorSessionDelegate::SendBufferToFrontend(
+    std::unique_ptr<StringBuffer> message) {
+  SendMessageToFrontend(message->string());
+}
+
 class NodeInspectorClient : public V8InspectorClient {
  public:
   explicit NodeInspectorClient(node::Environment* env, bool is_main)
@@ -13,6 +13,7 @@
 #include <memory>
 
 namespace v8_inspector {
+class StringBuffer;
 class StringView;
 }  // namespace v8_inspector
 
@@ -38,6 +39,10 @@ class InspectorSessionDelegate {
   virtual ~InspectorSessionDelegate() = default;
   virtual void SendMessageToFrontend(const v8_inspector::StringView& message)
                                      = 0;
+  // Same as SendMessageToFrontend(), but lets delegates that pass the message
+  // on to another thread take over the buffer instead of copying it.
+  virtual void SendBufferToFrontend(
+      std::unique_ptr<v8_inspector::StringBuffer> message);
 };
 
 class Agent {
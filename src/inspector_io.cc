@@ -79,11 +79,17 @@ class RequestToServer {
       case TransportAction::kStop:
         server->Stop();
         break;
-      case TransportAction::kSendMessage:
-        server->Send(
-            session_id_,
-            protocol::StringUtil::StringViewToUtf8(message_->string()));
+      case TransportAction::kSendMessage: {
+        // Responses to CBOR encoded commands are CBOR encoded as well, and
+        // are converted back to JSON here rather than on the main thread.
+        std::string json;
+        if (!protocol::StringUtil::ConvertCBORToJSON(message_->string(),
+                                                     &json)) {
+          json = protocol::StringUtil::StringViewToUtf8(message_->string());
+        }
+        server->Send(session_id_, json);
         break;
+      }
     }
   }
 
@@ -199,6 +205,11 @@ class IoSessionDelegate : public InspectorSessionDelegate {
                          StringBuffer::create(message));
   }
 
+  void SendBufferToFrontend(std::unique_ptr<StringBuffer> message) override {
+    request_queue_->Post(id_, TransportAction::kSendMessage,
+                         std::move(message));
+  }
+
  private:
   std::shared_ptr<RequestQueue> request_queue_;
   int id_;
@@ -349,8 +360,19 @@ void InspectorIoDelegate::StartSession(int session_id,
 void InspectorIoDelegate::MessageReceived(int session_id,
                                           const std::string& message) {
   auto session = sessions_.find(session_id);
-  if (session != sessions_.end())
+  if (session == sessions_.end())
+    return;
+  // Dispatch commands CBOR encoded, so that V8 neither has to parse them nor
+  // serialize its responses to JSON on the main thread. Malformed messages
+  // are passed on as they are so that V8 reports the error.
+  std::string cbor;
+  if (protocol::StringUtil::ConvertJSONToCBOR(message, &cbor)) {
+    session->second->Dispatch(
+        StringView(reinterpret_cast<const uint8_t*>(cbor.data()),
+                   cbor.length()));
+  } else {
     session->second->Dispatch(Utf8ToStringView(message)->string());
+  }
 }
 
 void InspectorIoDelegate::EndSession(int session_id) {
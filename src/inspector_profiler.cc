@@ -6,19 +6,30 @@
 #include "node_file.h"
 #include "node_errors.h"
 #include "node_internals.h"
+#include "threadpoolwork-inl.h"
 #include "util-inl.h"
 #include "v8-inspector.h"
+#include "zlib.h"
 
+#include <algorithm>
+#include <fstream>
+#include <functional>
 #include <sstream>
+#include <unordered_map>
 
 namespace node {
 namespace profiler {
 
 using errors::TryCatchScope;
+using v8::AllocationProfile;
 using v8::Context;
+using v8::CpuProfile;
+using v8::CpuProfileNode;
+using v8::CpuProfiler;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::HandleScope;
+using v8::HeapProfiler;
 using v8::Isolate;
 using v8::Local;
 using v8::MaybeLocal;
@@ -74,7 +85,11 @@ static void WriteResult(Environment* env,
 
 void V8ProfilerConnection::V8ProfilerSessionDelegate::SendMessageToFrontend(
     const v8_inspector::StringView& message) {
-  Environment* env = connection_->env();
+  connection_->OnMessage(message);
+}
+
+void V8ProfilerConnection::OnMessage(const v8_inspector::StringView& message) {
+  Environment* env = this->env();
   Isolate* isolate = env->isolate();
   HandleScope handle_scope(isolate);
   Context::Scope context_scope(env->context());
@@ -82,13 +97,12 @@ void V8ProfilerConnection::V8ProfilerSessionDelegate::SendMessageToFrontend(
   // TODO(joyeecheung): always parse the message so that we can use the id to
   // identify ending messages as well as printing the message in the debug
   // output when there is an error.
-  const char* type = connection_->type();
   Debug(env,
         DebugCategory::INSPECTOR_PROFILER,
         "Receive %s profile message, ending = %s\n",
-        type,
-        connection_->ending() ? "true" : "false");
-  if (!connection_->ending()) {
+        type(),
+        ending() ? "true" : "false");
+  if (!ending()) {
     return;
   }
 
@@ -99,11 +113,11 @@ void V8ProfilerConnection::V8ProfilerSessionDelegate::SendMessageToFrontend(
                               NewStringType::kNormal,
                               message.length())
            .ToLocal(&message_str)) {
-    fprintf(stderr, "Failed to convert %s profile message\n", type);
+    fprintf(stderr, "Failed to convert %s profile message\n", type());
     return;
   }
 
-  connection_->WriteProfile(message_str);
+  WriteProfile(message_str);
 }
 
 static bool EnsureDirectory(const std::string& directory, const char* type) {
@@ -123,6 +137,84 @@ static bool EnsureDirectory(const std::string& directory, const char* type) {
   return true;
 }
 
+// Returns the file name of the `n`th profile that is written periodically,
+// e.g. Heap.<...>.heapprofile becomes Heap.<...>.1.heapprofile for the first.
+static std::string NumberedFilename(std::string filename,
+                                    const std::string& extension,
+                                    uint32_t n) {
+  size_t pos = filename.size();
+  if (filename.size() >= extension.size() &&
+      filename.compare(filename.size() - extension.size(),
+                       extension.size(),
+                       extension) == 0) {
+    pos -= extension.size();
+  }
+  filename.insert(pos, "." + std::to_string(n));
+  return filename;
+}
+
+// Writes `data` to a temporary file first, so that profiles that are written
+// periodically only ever appear complete. Returns 0 or an errno value.
+static int WriteProfileFile(const std::string& path, const std::string& data) {
+  std::string tmp_path = path + ".tmp";
+  FILE* file = fopen(tmp_path.c_str(), "wb");
+  if (file == nullptr)
+    return errno;
+  int err = 0;
+  if (fwrite(data.data(), 1, data.size(), file) != data.size())
+    err = errno;
+  if (fclose(file) != 0 && err == 0)
+    err = errno;
+  if (err == 0 && rename(tmp_path.c_str(), path.c_str()) != 0)
+    err = errno;
+  if (err != 0)
+    remove(tmp_path.c_str());
+  return err;
+}
+
+// Serializes a profile that is written periodically and writes it to disk on
+// the threadpool.
+class ProfileDumpWork : public ThreadPoolWork {
+ public:
+  ProfileDumpWork(Environment* env,
+                  const char* type,
+                  std::string&& path,
+                  std::function<std::string()>&& serialize)
+      : ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_KIND_FS),
+        type_(type),
+        path_(std::move(path)),
+        serialize_(std::move(serialize)) {}
+
+  void DoThreadPoolWork() override {
+    error_ = WriteProfileFile(path_, serialize_());
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<ProfileDumpWork> self(this);
+    if (error_ != 0) {
+      fprintf(stderr, "%s: Failed to write %s profile %s\n",
+              strerror(error_), type_, path_.c_str());
+      return;
+    }
+    Debug(env(), DebugCategory::INSPECTOR_PROFILER,
+          "Written %s profile to %s\n", type_, path_.c_str());
+  }
+
+ private:
+  const char* type_;
+  std::string path_;
+  std::function<std::string()> serialize_;
+  int error_ = 0;
+};
+
+static void ScheduleProfileDump(Environment* env,
+                                const char* type,
+                                std::string&& path,
+                                std::function<std::string()>&& serialize) {
+  (new ProfileDumpWork(env, type, std::move(path), std::move(serialize)))
+      ->ScheduleWork();
+}
+
 std::string V8CoverageConnection::GetFilename() const {
   std::string thread_id = std::to_string(env()->thread_id());
   std::string pid = std::to_string(uv_os_getpid());
@@ -203,20 +295,171 @@ void V8ProfilerConnection::WriteProfile(Local<String> message) {
   WriteResult(env_, path.c_str(), result_s);
 }
 
-void V8CoverageConnection::WriteProfile(Local<String> message) {
+// Coverage that is taken periodically is written in chunks, i.e. one file per
+// Profiler.takePreciseCoverage response. A chunk is converted and written in
+// the threadpool. If the process exits before that happens, End() writes it
+// instead, so `mutex` is held while the chunk is written.
+struct CoverageChunk {
+  Mutex mutex;
+  std::u16string message;
+  std::string path;
+  bool written = false;
+  // Only accessed on the main thread, set when the threadpool work is done.
+  bool done = false;
+};
+
+template <typename Char>
+static std::string ToUtf8(const Char* data, size_t length) {
+  std::string out;
+  out.reserve(length);
+  for (size_t i = 0; i < length; i++) {
+    uint32_t c = data[i];
+    if (c >= 0xd800 && c < 0xe000) {
+      if (c < 0xdc00 && i + 1 < length &&
+          data[i + 1] >= 0xdc00 && data[i + 1] < 0xe000) {
+        c = 0x10000 + ((c - 0xd800) << 10) + (data[++i] - 0xdc00);
+      } else {
+        c = 0xfffd;
+      }
+    }
+    if (c < 0x80) {
+      out += static_cast<char>(c);
+    } else if (c < 0x800) {
+      out += static_cast<char>(0xc0 | (c >> 6));
+      out += static_cast<char>(0x80 | (c & 0x3f));
+    } else if (c < 0x10000) {
+      out += static_cast<char>(0xe0 | (c >> 12));
+      out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+      out += static_cast<char>(0x80 | (c & 0x3f));
+    } else {
+      out += static_cast<char>(0xf0 | (c >> 18));
+      out += static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+      out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+      out += static_cast<char>(0x80 | (c & 0x3f));
+    }
+  }
+  return out;
+}
+
+static std::string ToUtf8(const StringView& message) {
+  return message.is8Bit() ?
+      ToUtf8(message.characters8(), message.length()) :
+      ToUtf8(message.characters16(), message.length());
+}
+
+// Returns the `result` of a Profiler.takePreciseCoverage response, i.e.
+// {"result":[...]}, which is the object that is written. The response is not
+// parsed, since it is serialized by the inspector as {"id":...,"result":...}.
+// Returns an empty string if the response is an error.
+static std::string GetCoverageResult(const std::string& message) {
+  const char key[] = "\"result\":";
+  size_t start = message.find(key);
+  size_t end = message.find_last_of('}');
+  if (start == std::string::npos || end == std::string::npos)
+    return std::string();
+  start = message.find_first_not_of(" \t\r\n", start + sizeof(key) - 1);
+  end = message.find_last_not_of(" \t\r\n", end - 1);
+  if (start == std::string::npos || end == std::string::npos ||
+      end <= start || message[start] != '{' || message[end] != '}') {
+    return std::string();
+  }
+  return message.substr(start, end - start + 1);
+}
+
+static int WriteCoverageChunk(CoverageChunk* chunk) {
+  std::string result =
+      GetCoverageResult(ToUtf8(chunk->message.data(), chunk->message.size()));
+  chunk->message = std::u16string();
+  if (result.empty())
+    return EINVAL;
+  return WriteProfileFile(chunk->path, result);
+}
+
+class CoverageChunkWork : public ThreadPoolWork {
+ public:
+  CoverageChunkWork(Environment* env, std::shared_ptr<CoverageChunk> chunk)
+      : ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_KIND_FS),
+        chunk_(std::move(chunk)) {}
+
+  void DoThreadPoolWork() override {
+    Mutex::ScopedLock lock(chunk_->mutex);
+    if (chunk_->written)
+      return;
+    error_ = WriteCoverageChunk(chunk_.get());
+    chunk_->written = true;
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<CoverageChunkWork> self(this);
+    chunk_->done = true;
+    if (error_ != 0) {
+      fprintf(stderr, "%s: Failed to write coverage %s\n",
+              strerror(error_), chunk_->path.c_str());
+      return;
+    }
+    Debug(env(), DebugCategory::INSPECTOR_PROFILER,
+          "Written coverage to %s\n", chunk_->path.c_str());
+  }
+
+ private:
+  std::shared_ptr<CoverageChunk> chunk_;
+  int error_ = 0;
+};
+
+void V8CoverageConnection::OnMessage(const StringView& message) {
+  Debug(env(),
+        DebugCategory::INSPECTOR_PROFILER,
+        "Receive %s profile message, ending = %s\n",
+        type(),
+        ending_ ? "true" : "false");
+  if (ending_) {
+    WriteFinalCoverage(message);
+  } else if (collecting_) {
+    WriteChunk(message);
+  }
+}
+
+void V8CoverageConnection::WriteChunk(const StringView& message) {
+  std::string directory = GetDirectory();
+  if (!EnsureDirectory(directory, type()))
+    return;
+
+  // Only the message is copied here, the rest happens in the threadpool.
+  auto chunk = std::make_shared<CoverageChunk>();
+  if (message.is8Bit()) {
+    chunk->message.assign(message.characters8(),
+                          message.characters8() + message.length());
+  } else {
+    chunk->message.assign(
+        reinterpret_cast<const char16_t*>(message.characters16()),
+        message.length());
+  }
+  chunk->path = directory + kPathSeparator +
+      NumberedFilename(filename_, ".json", ++chunk_count_);
+
+  pending_chunks_.erase(
+      std::remove_if(pending_chunks_.begin(), pending_chunks_.end(),
+                     [](const std::shared_ptr<CoverageChunk>& chunk) {
+                       return chunk->done;
+                     }),
+      pending_chunks_.end());
+  pending_chunks_.push_back(chunk);
+  (new CoverageChunkWork(env(), std::move(chunk)))->ScheduleWork();
+}
+
+void V8CoverageConnection::WriteFinalCoverage(const StringView& message) {
   Isolate* isolate = env_->isolate();
   Local<Context> context = env_->context();
   HandleScope handle_scope(isolate);
   Context::Scope context_scope(context);
 
-  // Get message.result from the response.
-  Local<Object> result;
-  if (!ParseProfile(env_, message, type()).ToLocal(&result)) {
-    return;
-  }
-  // Generate the profile output from the subclass.
-  Local<Object> profile;
-  if (!GetProfile(result).ToLocal(&profile)) {
+  // The result is written as it is, without parsing it into a JS object and
+  // serializing that again, which would take a lot of time and memory for
+  // large programs.
+  std::string result = GetCoverageResult(ToUtf8(message));
+  if (result.empty()) {
+    fprintf(stderr, "Failed to get 'result' from %s profile message\n",
+            type());
     return;
   }
 
@@ -239,14 +482,15 @@ void V8CoverageConnection::WriteProfile(Local<String> message) {
   }
   // Avoid writing to disk if no source-map data:
   if (!source_map_cache_v->IsUndefined()) {
-    profile->Set(context, FIXED_ONE_BYTE_STRING(isolate, "source-map-cache"),
-                source_map_cache_v).ToChecked();
-  }
-
-  Local<String> result_s;
-  if (!v8::JSON::Stringify(context, profile).ToLocal(&result_s)) {
-    fprintf(stderr, "Failed to stringify %s profile result\n", type());
-    return;
+    Local<String> source_map_cache_s;
+    if (!v8::JSON::Stringify(context, source_map_cache_v)
+             .ToLocal(&source_map_cache_s)) {
+      fprintf(stderr, "Failed to stringify %s source map cache\n", type());
+      return;
+    }
+    Utf8Value source_map_cache(isolate, source_map_cache_s);
+    result.insert(result.size() - 1, ",\"source-map-cache\":");
+    result.insert(result.size() - 1, source_map_cache.ToString());
   }
 
   // Create the directory if necessary.
@@ -256,11 +500,18 @@ void V8CoverageConnection::WriteProfile(Local<String> message) {
     return;
   }
 
-  std::string filename = GetFilename();
+  std::string filename = taking() ? filename_ : GetFilename();
   DCHECK(!filename.empty());
   std::string path = directory + kPathSeparator + filename;
 
-  WriteResult(env_, path.c_str(), result_s);
+  int err = WriteProfileFile(path, result);
+  if (err != 0) {
+    fprintf(stderr, "%s: Failed to write file %s\n", strerror(err),
+            path.c_str());
+    return;
+  }
+  Debug(env(), DebugCategory::INSPECTOR_PROFILER,
+        "Written result to %s\n", path.c_str());
 }
 
 MaybeLocal<Object> V8CoverageConnection::GetProfile(Local<Object> result) {
@@ -271,16 +522,54 @@ std::string V8CoverageConnection::GetDirectory() const {
   return env()->coverage_directory();
 }
 
+void V8CoverageConnection::TakeCoverage() {
+  collecting_ = true;
+  DispatchMessage("Profiler.takePreciseCoverage");
+  collecting_ = false;
+}
+
 void V8CoverageConnection::Start() {
   DispatchMessage("Profiler.enable");
   DispatchMessage("Profiler.startPreciseCoverage",
-                  R"({ "callCount": true, "detailed": true })");
+                  binary_ ? R"({ "callCount": false, "detailed": true })" :
+                            R"({ "callCount": true, "detailed": true })");
+  if (!taking())
+    return;
+
+  filename_ = GetFilename();
+  CHECK_EQ(0, uv_timer_init(env()->event_loop(), &take_timer_));
+  CHECK_EQ(0, uv_timer_start(&take_timer_, [](uv_timer_t* timer) {
+    V8CoverageConnection* connection =
+        ContainerOf(&V8CoverageConnection::take_timer_, timer);
+    connection->TakeCoverage();
+  }, take_interval_, take_interval_));
+  uv_unref(reinterpret_cast<uv_handle_t*>(&take_timer_));
+  env()->RegisterHandleCleanup(
+      reinterpret_cast<uv_handle_t*>(&take_timer_),
+      [](Environment* env, uv_handle_t* handle, void* arg) {
+        env->CloseHandle(handle, [](uv_handle_t* handle) {});
+      },
+      nullptr);
 }
 
 void V8CoverageConnection::End() {
   CHECK_EQ(ending_, false);
   ending_ = true;
   DispatchMessage("Profiler.takePreciseCoverage");
+
+  // The counters were reset when the pending chunks were taken, so they are
+  // written now if the threadpool has not gotten to them yet.
+  for (const std::shared_ptr<CoverageChunk>& chunk : pending_chunks_) {
+    Mutex::ScopedLock lock(chunk->mutex);
+    if (chunk->written)
+      continue;
+    int err = WriteCoverageChunk(chunk.get());
+    chunk->written = true;
+    if (err != 0) {
+      fprintf(stderr, "%s: Failed to write coverage %s\n",
+              strerror(err), chunk->path.c_str());
+    }
+  }
 }
 
 std::string V8CpuProfilerConnection::GetDirectory() const {
@@ -307,7 +596,239 @@ MaybeLocal<Object> V8CpuProfilerConnection::GetProfile(Local<Object> result) {
   return profile_v.As<Object>();
 }
 
+namespace {
+
+// The parts of a v8::CpuProfile that are written in pprof format, copied so
+// that they can be serialized off the main thread.
+struct CpuProfileCopy {
+  struct Node {
+    std::string function_name;
+    std::string url;
+    int line;
+    size_t parent;
+    unsigned hit_count;
+  };
+
+  // nodes[0] is the root, and parents come before their children.
+  std::vector<Node> nodes;
+  int64_t time_nanos;
+  int64_t duration_nanos;
+  uint64_t period_nanos;
+};
+
+// Writes the protocol buffer wire format, see
+// https://developers.google.com/protocol-buffers/docs/encoding
+class ProtobufWriter {
+ public:
+  void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      data_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    data_.push_back(static_cast<char>(value));
+  }
+
+  void WriteInt(uint32_t field, uint64_t value) {
+    WriteVarint(field << 3);
+    WriteVarint(value);
+  }
+
+  void WriteBytes(uint32_t field, const std::string& value) {
+    WriteVarint(field << 3 | 2);
+    WriteVarint(value.size());
+    data_ += value;
+  }
+
+  void WritePacked(uint32_t field, const std::vector<uint64_t>& values) {
+    ProtobufWriter packed;
+    for (uint64_t value : values)
+      packed.WriteVarint(value);
+    WriteBytes(field, packed.data());
+  }
+
+  const std::string& data() const { return data_; }
+
+ private:
+  std::string data_;
+};
+
+// Serializes `profile` as a gzipped pprof profile, see
+// https://github.com/google/pprof/blob/master/proto/profile.proto
+std::string SerializePprof(const CpuProfileCopy& profile) {
+  std::vector<const std::string*> strings;
+  std::unordered_map<std::string, uint64_t> string_ids;
+  auto string_id = [&](const std::string& str) {
+    auto it = string_ids.emplace(str, strings.size());
+    if (it.second)
+      strings.push_back(&it.first->first);
+    return it.first->second;
+  };
+  string_id("");
+
+  ProtobufWriter out;
+  auto write_value_type = [&](uint32_t field, const char* type,
+                              const char* unit) {
+    ProtobufWriter value_type;
+    value_type.WriteInt(1, string_id(type));
+    value_type.WriteInt(2, string_id(unit));
+    out.WriteBytes(field, value_type.data());
+  };
+  write_value_type(1, "samples", "count");
+  write_value_type(1, "cpu", "nanoseconds");
+
+  // Every node other than the root is a location, with the index of the node
+  // as its id. Nodes in the same function share one function entry.
+  std::unordered_map<std::string, uint64_t> function_ids;
+  std::vector<uint64_t> node_functions(profile.nodes.size());
+  for (size_t i = 1; i < profile.nodes.size(); i++) {
+    const CpuProfileCopy::Node& node = profile.nodes[i];
+    const std::string& name = node.function_name.empty() ?
+        "(anonymous)" : node.function_name;
+    std::string key = name + '\0' + node.url + '\0' + std::to_string(node.line);
+    auto it = function_ids.emplace(key, function_ids.size() + 1);
+    node_functions[i] = it.first->second;
+    if (it.second) {
+      ProtobufWriter function;
+      function.WriteInt(1, it.first->second);
+      function.WriteInt(2, string_id(name));
+      function.WriteInt(3, string_id(name));
+      function.WriteInt(4, string_id(node.url));
+      function.WriteInt(5, node.line);
+      out.WriteBytes(5, function.data());
+    }
+
+    ProtobufWriter line;
+    line.WriteInt(1, node_functions[i]);
+    line.WriteInt(2, node.line);
+    ProtobufWriter location;
+    location.WriteInt(1, i);
+    location.WriteBytes(4, line.data());
+    out.WriteBytes(4, location.data());
+  }
+
+  // There is one sample for every node that was hit, with its stack.
+  std::vector<uint64_t> location_ids;
+  for (size_t i = 1; i < profile.nodes.size(); i++) {
+    const CpuProfileCopy::Node& node = profile.nodes[i];
+    if (node.hit_count == 0)
+      continue;
+    location_ids.clear();
+    for (size_t j = i; j != 0; j = profile.nodes[j].parent)
+      location_ids.push_back(j);
+    ProtobufWriter sample;
+    sample.WritePacked(1, location_ids);
+    sample.WritePacked(2, { node.hit_count,
+                            node.hit_count * profile.period_nanos });
+    out.WriteBytes(2, sample.data());
+  }
+
+  for (const std::string* str : strings)
+    out.WriteBytes(6, *str);
+  out.WriteInt(9, profile.time_nanos);
+  out.WriteInt(10, profile.duration_nanos);
+  write_value_type(11, "cpu", "nanoseconds");
+  out.WriteInt(12, profile.period_nanos);
+
+  const std::string& data = out.data();
+  z_stream stream = {};
+  // 16 makes zlib write a gzip header.
+  CHECK_EQ(Z_OK, deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                              16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY));
+  std::string compressed(deflateBound(&stream, data.size()), '\0');
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = data.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+  stream.avail_out = compressed.size();
+  CHECK_EQ(Z_STREAM_END, deflate(&stream, Z_FINISH));
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  return compressed;
+}
+
+}  // anonymous namespace
+
+void V8CpuProfilerConnection::StartRotatingProfile() {
+  Isolate* isolate = env()->isolate();
+  HandleScope handle_scope(isolate);
+  rotate_start_time_ = GetCurrentTimeInMicroseconds();
+  cpu_profiler_->StartProfiling(
+      FIXED_ONE_BYTE_STRING(isolate, "node:cpu-prof-rotate"), false);
+}
+
+std::function<std::string()> V8CpuProfilerConnection::StopRotatingProfile() {
+  Isolate* isolate = env()->isolate();
+  HandleScope handle_scope(isolate);
+  CpuProfile* profile = cpu_profiler_->StopProfiling(
+      FIXED_ONE_BYTE_STRING(isolate, "node:cpu-prof-rotate"));
+  if (profile == nullptr)
+    return nullptr;
+
+  auto copy = std::make_shared<CpuProfileCopy>();
+  copy->time_nanos = static_cast<int64_t>(rotate_start_time_ * 1000);
+  copy->duration_nanos =
+      (profile->GetEndTime() - profile->GetStartTime()) * 1000;
+  copy->period_nanos = env()->cpu_prof_interval() * 1000;
+  std::vector<std::pair<const CpuProfileNode*, size_t>> stack = {
+    { profile->GetTopDownRoot(), 0 }
+  };
+  while (!stack.empty()) {
+    const CpuProfileNode* node = stack.back().first;
+    size_t parent = stack.back().second;
+    stack.pop_back();
+    size_t index = copy->nodes.size();
+    copy->nodes.push_back({
+      node->GetFunctionNameStr(),
+      node->GetScriptResourceNameStr(),
+      std::max(node->GetLineNumber(), 0),
+      parent,
+      node->GetHitCount()
+    });
+    for (int i = 0; i < node->GetChildrenCount(); i++)
+      stack.emplace_back(node->GetChild(i), index);
+  }
+  profile->Delete();
+
+  return [copy]() { return SerializePprof(*copy); };
+}
+
+std::string V8CpuProfilerConnection::GetRotatingProfilePath() {
+  return GetDirectory() + kPathSeparator +
+      NumberedFilename(GetFilename(), ".pb.gz", ++rotate_count_);
+}
+
 void V8CpuProfilerConnection::Start() {
+  if (rotating()) {
+    cpu_profiler_ = CpuProfiler::New(env()->isolate());
+    cpu_profiler_->SetSamplingInterval(env()->cpu_prof_interval());
+    StartRotatingProfile();
+
+    CHECK_EQ(0, uv_timer_init(env()->event_loop(), &rotate_timer_));
+    CHECK_EQ(0, uv_timer_start(&rotate_timer_, [](uv_timer_t* timer) {
+      V8CpuProfilerConnection* connection =
+          ContainerOf(&V8CpuProfilerConnection::rotate_timer_, timer);
+      std::function<std::string()> serialize =
+          connection->StopRotatingProfile();
+      connection->StartRotatingProfile();
+      if (!serialize ||
+          !EnsureDirectory(connection->GetDirectory(), connection->type())) {
+        return;
+      }
+      ScheduleProfileDump(connection->env(),
+                          connection->type(),
+                          connection->GetRotatingProfilePath(),
+                          std::move(serialize));
+    }, rotate_interval_, rotate_interval_));
+    uv_unref(reinterpret_cast<uv_handle_t*>(&rotate_timer_));
+    env()->RegisterHandleCleanup(
+        reinterpret_cast<uv_handle_t*>(&rotate_timer_),
+        [](Environment* env, uv_handle_t* handle, void* arg) {
+          env->CloseHandle(handle, [](uv_handle_t* handle) {});
+        },
+        nullptr);
+    return;
+  }
+
   DispatchMessage("Profiler.enable");
   DispatchMessage("Profiler.start");
   std::string params = R"({ "interval": )";
@@ -319,6 +840,24 @@ void V8CpuProfilerConnection::Start() {
 void V8CpuProfilerConnection::End() {
   CHECK_EQ(ending_, false);
   ending_ = true;
+  if (rotating()) {
+    // The last profile is written right away, since the process is exiting.
+    std::function<std::string()> serialize = StopRotatingProfile();
+    cpu_profiler_->Dispose();
+    cpu_profiler_ = nullptr;
+    if (!serialize || !EnsureDirectory(GetDirectory(), type()))
+      return;
+    std::string path = GetRotatingProfilePath();
+    int err = WriteProfileFile(path, serialize());
+    if (err != 0) {
+      fprintf(stderr, "%s: Failed to write CPU profile %s\n",
+              strerror(err), path.c_str());
+      return;
+    }
+    Debug(env(), DebugCategory::INSPECTOR_PROFILER,
+          "Written result to %s\n", path.c_str());
+    return;
+  }
   DispatchMessage("Profiler.stop");
 }
 
@@ -346,7 +885,136 @@ MaybeLocal<Object> V8HeapProfilerConnection::GetProfile(Local<Object> result) {
   return profile_v.As<Object>();
 }
 
+static void WriteJSONString(std::ostream& out, Isolate* isolate,
+                            Local<String> value) {
+  out << '"';
+  if (!value.IsEmpty()) {
+    Utf8Value str(isolate, value);
+    for (size_t i = 0; i < str.length(); i++) {
+      const unsigned char c = str[i];
+      if (c == '"' || c == '\\') {
+        out << '\\' << c;
+      } else if (c < 0x20) {
+        char escaped[7];
+        snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        out << escaped;
+      } else {
+        out << c;
+      }
+    }
+  }
+  out << '"';
+}
+
+// Writes the same JSON as the HeapProfiler.getSamplingProfile inspector
+// method, but node by node into `out`.
+static void WriteProfileNode(std::ostream& out,
+                             Isolate* isolate,
+                             const AllocationProfile::Node* node) {
+  size_t self_size = 0;
+  for (const AllocationProfile::Allocation& allocation : node->allocations)
+    self_size += allocation.size * allocation.count;
+  out << R"({"callFrame":{"functionName":)";
+  WriteJSONString(out, isolate, node->name);
+  out << R"(,"scriptId":")" << node->script_id << R"(","url":)";
+  WriteJSONString(out, isolate, node->script_name);
+  out << R"(,"lineNumber":)" << node->line_number - 1
+      << R"(,"columnNumber":)" << node->column_number - 1
+      << R"(},"selfSize":)" << self_size
+      << R"(,"id":)" << node->node_id
+      << R"(,"children":[)";
+  for (size_t i = 0; i < node->children.size(); i++) {
+    if (i > 0) out << ',';
+    WriteProfileNode(out, isolate, node->children[i]);
+  }
+  out << "]}";
+}
+
+static bool WriteAllocationProfile(std::ostream& out, Isolate* isolate) {
+  // AllocationProfile::Node contains Local handles.
+  HandleScope handle_scope(isolate);
+  std::unique_ptr<AllocationProfile> profile(
+      isolate->GetHeapProfiler()->GetAllocationProfile());
+  if (!profile)
+    return false;
+  out << R"({"head":)";
+  WriteProfileNode(out, isolate, profile->GetRootNode());
+  out << R"(,"samples":[)";
+  bool first = true;
+  for (const AllocationProfile::Sample& sample : profile->GetSamples()) {
+    if (!first) out << ',';
+    first = false;
+    out << R"({"size":)" << sample.size * sample.count
+        << R"(,"nodeId":)" << sample.node_id
+        << R"(,"ordinal":)" << sample.sample_id << '}';
+  }
+  out << "]}";
+  return true;
+}
+
+void V8HeapProfilerConnection::WriteDump() {
+  std::ostringstream out;
+  if (!WriteAllocationProfile(out, env()->isolate()))
+    return;
+
+  std::string directory = GetDirectory();
+  if (!EnsureDirectory(directory, type()))
+    return;
+  std::string path = directory + kPathSeparator +
+      NumberedFilename(GetFilename(), ".heapprofile", ++dump_count_);
+
+  std::string data = out.str();
+  ScheduleProfileDump(env(), type(), std::move(path),
+                      [data = std::move(data)]() mutable {
+    return std::move(data);
+  });
+}
+
+void V8HeapProfilerConnection::WriteFinalDump() {
+  std::string directory = GetDirectory();
+  DCHECK(!directory.empty());
+  if (!EnsureDirectory(directory, type()))
+    return;
+  std::string path = directory + kPathSeparator + GetFilename();
+
+  // The file is written while the profile is serialized, so that no string
+  // with the whole profile is needed.
+  std::ofstream out(path, std::ios::out | std::ios::binary);
+  if (!out.is_open() || !WriteAllocationProfile(out, env()->isolate())) {
+    fprintf(stderr, "Failed to write heap profile %s\n", path.c_str());
+    return;
+  }
+  out.close();
+  if (out.fail()) {
+    fprintf(stderr, "Failed to write heap profile %s\n", path.c_str());
+    return;
+  }
+  Debug(env(), DebugCategory::INSPECTOR_PROFILER,
+        "Written result to %s\n", path.c_str());
+}
+
 void V8HeapProfilerConnection::Start() {
+  if (dumping()) {
+    // Use the same settings as HeapProfiler.startSampling.
+    env()->isolate()->GetHeapProfiler()->StartSamplingHeapProfiler(
+        env()->heap_prof_interval(), 128, HeapProfiler::kSamplingForceGC);
+
+    CHECK_EQ(0, uv_timer_init(env()->event_loop(), &dump_timer_));
+    CHECK_EQ(0, uv_timer_start(&dump_timer_, [](uv_timer_t* timer) {
+      V8HeapProfilerConnection* connection =
+          ContainerOf(&V8HeapProfilerConnection::dump_timer_, timer);
+      connection->WriteDump();
+    }, dump_interval_, dump_interval_));
+    uv_unref(reinterpret_cast<uv_handle_t*>(&dump_timer_));
+    env()->RegisterHandleCleanup(
+        reinterpret_cast<uv_handle_t*>(&dump_timer_),
+        [](Environment* env, uv_handle_t* handle, void* arg) {
+          env->CloseHandle(handle, [](uv_handle_t* handle) {});
+        },
+        nullptr);
+    return;
+  }
+
   DispatchMessage("HeapProfiler.enable");
   std::string params = R"({ "samplingInterval": )";
   params += std::to_string(env()->heap_prof_interval());
@@ -357,6 +1025,11 @@ void V8HeapProfilerConnection::Start() {
 void V8HeapProfilerConnection::End() {
   CHECK_EQ(ending_, false);
   ending_ = true;
+  if (dumping()) {
+    WriteFinalDump();
+    env()->isolate()->GetHeapProfiler()->StopSamplingHeapProfiler();
+    return;
+  }
   DispatchMessage("HeapProfiler.stopSampling");
 }
 
@@ -410,23 +1083,39 @@ void StartProfilers(Environment* env) {
       isolate, FIXED_ONE_BYTE_STRING(isolate, "NODE_V8_COVERAGE"))
       .FromMaybe(Local<String>());
   if (!coverage_str.IsEmpty() && coverage_str->Length() > 0) {
+    uint64_t take_interval = 0;
+    Local<String> interval_str = env->env_vars()->Get(
+        isolate, FIXED_ONE_BYTE_STRING(isolate, "NODE_V8_COVERAGE_INTERVAL"))
+        .FromMaybe(Local<String>());
+    if (!interval_str.IsEmpty()) {
+      Utf8Value interval(isolate, interval_str);
+      take_interval = strtoull(*interval, nullptr, 10);
+    }
+    Local<String> binary_str = env->env_vars()->Get(
+        isolate, FIXED_ONE_BYTE_STRING(isolate, "NODE_V8_COVERAGE_BINARY"))
+        .FromMaybe(Local<String>());
+    const bool binary = !binary_str.IsEmpty() &&
+        Utf8Value(isolate, binary_str).ToString() == "1";
     CHECK_NULL(env->coverage_connection());
-    env->set_coverage_connection(std::make_unique<V8CoverageConnection>(env));
+    env->set_coverage_connection(
+        std::make_unique<V8CoverageConnection>(env, take_interval, binary));
     env->coverage_connection()->Start();
   }
   if (env->options()->cpu_prof) {
     const std::string& dir = env->options()->cpu_prof_dir;
     env->set_cpu_prof_interval(env->options()->cpu_prof_interval);
     env->set_cpu_prof_dir(dir.empty() ? GetCwd(env) : dir);
+    const uint64_t rotate_interval = env->options()->cpu_prof_rotate_interval;
     if (env->options()->cpu_prof_name.empty()) {
-      DiagnosticFilename filename(env, "CPU", "cpuprofile");
+      DiagnosticFilename filename(
+          env, "CPU", rotate_interval > 0 ? "pb.gz" : "cpuprofile");
       env->set_cpu_prof_name(*filename);
     } else {
       env->set_cpu_prof_name(env->options()->cpu_prof_name);
     }
     CHECK_NULL(env->cpu_profiler_connection());
     env->set_cpu_profiler_connection(
-        std::make_unique<V8CpuProfilerConnection>(env));
+        std::make_unique<V8CpuProfilerConnection>(env, rotate_interval));
     env->cpu_profiler_connection()->Start();
   }
   if (env->options()->heap_prof) {
@@ -440,7 +1129,8 @@ void StartProfilers(Environment* env) {
       env->set_heap_prof_name(env->options()->heap_prof_name);
     }
     env->set_heap_profiler_connection(
-        std::make_unique<profiler::V8HeapProfilerConnection>(env));
+        std::make_unique<profiler::V8HeapProfilerConnection>(
+            env, env->options()->heap_prof_dump_interval));
     env->heap_profiler_connection()->Start();
   }
 }
@@ -8,6 +8,12 @@
 #endif
 
 #include "inspector_agent.h"
+#include "v8-profiler.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace node {
 // Forward declaration to break recursive dependency chain with src/env.h.
@@ -41,6 +47,10 @@ class V8ProfilerConnection {
   // the commands we use here.
   size_t DispatchMessage(const char* method, const char* params = nullptr);
 
+  // Handle a message from the inspector. By default, the profile is written
+  // from the response that arrives once the profile is ending.
+  virtual void OnMessage(const v8_inspector::StringView& message);
+
   // Use DispatchMessage() to dispatch necessary inspector messages
   // to start and end the profiling.
   virtual void Start() = 0;
@@ -69,9 +79,17 @@ class V8ProfilerConnection {
   Environment* env_ = nullptr;
 };
 
+struct CoverageChunk;
+
 class V8CoverageConnection : public V8ProfilerConnection {
  public:
-  explicit V8CoverageConnection(Environment* env) : V8ProfilerConnection(env) {}
+  // If `take_interval` is not 0, the coverage collected so far is taken and
+  // written every `take_interval` milliseconds, which resets the counters.
+  // If `binary` is true, only whether blocks were executed is recorded.
+  V8CoverageConnection(Environment* env, uint64_t take_interval, bool binary)
+      : V8ProfilerConnection(env),
+        take_interval_(take_interval),
+        binary_(binary) {}
 
   void Start() override;
   void End() override;
@@ -82,18 +100,35 @@ class V8CoverageConnection : public V8ProfilerConnection {
   std::string GetDirectory() const override;
   std::string GetFilename() const override;
   v8::MaybeLocal<v8::Object> GetProfile(v8::Local<v8::Object> result) override;
-  void WriteProfile(v8::Local<v8::String> message) override;
+  void OnMessage(const v8_inspector::StringView& message) override;
   void WriteSourceMapCache();
 
  private:
+  bool taking() const { return take_interval_ > 0; }
+  void TakeCoverage();
+  void WriteChunk(const v8_inspector::StringView& message);
+  void WriteFinalCoverage(const v8_inspector::StringView& message);
+
   std::unique_ptr<inspector::InspectorSession> session_;
   bool ending_ = false;
+  bool collecting_ = false;
+  uint64_t take_interval_;
+  bool binary_;
+  // The name of the final file when coverage is taken periodically, from
+  // which the names of the chunks are derived.
+  std::string filename_;
+  uint32_t chunk_count_ = 0;
+  // Chunks that are queued in the threadpool.
+  std::vector<std::shared_ptr<CoverageChunk>> pending_chunks_;
+  uv_timer_t take_timer_;
 };
 
 class V8CpuProfilerConnection : public V8ProfilerConnection {
  public:
-  explicit V8CpuProfilerConnection(Environment* env)
-      : V8ProfilerConnection(env) {}
+  // If `rotate_interval` is not 0, a new profile is started every
+  // `rotate_interval` milliseconds, and each one is written in pprof format.
+  V8CpuProfilerConnection(Environment* env, uint64_t rotate_interval)
+      : V8ProfilerConnection(env), rotate_interval_(rotate_interval) {}
 
   void Start() override;
   void End() override;
@@ -106,14 +141,31 @@ class V8CpuProfilerConnection : public V8ProfilerConnection {
   v8::MaybeLocal<v8::Object> GetProfile(v8::Local<v8::Object> result) override;
 
  private:
+  // Rotating profiles are taken with v8::CpuProfiler directly instead of
+  // through the inspector protocol, and serialized on the threadpool.
+  bool rotating() const { return rotate_interval_ > 0; }
+  void StartRotatingProfile();
+  // Stops the current profile, and returns a function that serializes it.
+  // The function does not need to run on the main thread.
+  std::function<std::string()> StopRotatingProfile();
+  std::string GetRotatingProfilePath();
+
   std::unique_ptr<inspector::InspectorSession> session_;
   bool ending_ = false;
+  uint64_t rotate_interval_;
+  uint32_t rotate_count_ = 0;
+  // Wall clock time in microseconds at which the current profile started.
+  double rotate_start_time_ = 0;
+  v8::CpuProfiler* cpu_profiler_ = nullptr;
+  uv_timer_t rotate_timer_;
 };
 
 class V8HeapProfilerConnection : public V8ProfilerConnection {
  public:
-  explicit V8HeapProfilerConnection(Environment* env)
-      : V8ProfilerConnection(env) {}
+  // If `dump_interval` is not 0, the profile is also written every
+  // `dump_interval` milliseconds until the profiler ends.
+  V8HeapProfilerConnection(Environment* env, uint64_t dump_interval)
+      : V8ProfilerConnection(env), dump_interval_(dump_interval) {}
 
   void Start() override;
   void End() override;
@@ -126,8 +178,18 @@ class V8HeapProfilerConnection : public V8ProfilerConnection {
   v8::MaybeLocal<v8::Object> GetProfile(v8::Local<v8::Object> result) override;
 
  private:
+  // When dumping periodically, the profile is taken from V8 and written
+  // natively instead of going through the inspector protocol, which would
+  // build the whole profile as one JSON string on the main thread.
+  bool dumping() const { return dump_interval_ > 0; }
+  void WriteDump();
+  void WriteFinalDump();
+
   std::unique_ptr<inspector::InspectorSession> session_;
   bool ending_ = false;
+  uint64_t dump_interval_;
+  uint32_t dump_count_ = 0;
+  uv_timer_t dump_timer_;
 };
 
 }  // namespace profiler
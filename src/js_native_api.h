@@ -531,6 +531,17 @@ NAPI_EXTERN napi_status napi_detach_arraybuffer(napi_env env,
 NAPI_EXTERN napi_status napi_is_detached_arraybuffer(napi_env env,
                                                      napi_value value,
                                                      bool* result);
+
+// Functions with a typed fast path
+NAPI_EXTERN napi_status
+napi_create_fast_function(napi_env env,
+                          const char* utf8name,
+                          size_t length,
+                          const napi_fast_signature* signature,
+                          napi_fast_callback fast_cb,
+                          napi_callback cb,
+                          void* data,
+                          napi_value* result);
 #endif  // NAPI_EXPERIMENTAL
 
 EXTERN_C_END
@@ -134,6 +134,33 @@ typedef enum {
   napi_key_keep_numbers,
   napi_key_numbers_to_strings
 } napi_key_conversion;
+
+typedef enum {
+  napi_fast_void,
+  napi_fast_bool,
+  napi_fast_int32,
+  napi_fast_uint32,
+  napi_fast_int64,
+  napi_fast_double
+} napi_fast_type;
+
+typedef union {
+  bool bool_value;
+  int32_t int32_value;
+  uint32_t uint32_value;
+  int64_t int64_value;
+  double double_value;
+} napi_fast_value;
+
+typedef struct {
+  napi_fast_type return_type;
+  size_t arg_count;
+  const napi_fast_type* arg_types;
+} napi_fast_signature;
+
+typedef void (*napi_fast_callback)(void* data,
+                                   const napi_fast_value* args,
+                                   napi_fast_value* result);
 #endif
 
 #endif  // SRC_JS_NATIVE_API_TYPES_H_
@@ -565,6 +565,110 @@ class FunctionCallbackWrapper
   }
 };
 
+// The bundle of functions created by napi_create_fast_function(). When the
+// function is not constructed and its arguments have the declared types,
+// `fast_cb` is called with the unboxed arguments; it does not get a napi_env,
+// so none of the napi_env bookkeeping is needed. All other calls go to the
+// regular callback.
+struct FastCallbackBundle : public CallbackBundle {
+  static constexpr size_t kMaxArgs = 16;
+
+  napi_fast_callback fast_cb;
+  napi_fast_type return_type;
+  size_t arg_count;
+  napi_fast_type arg_types[kMaxArgs];
+};
+
+class FastFunctionCallbackWrapper {
+ public:
+  static void Invoke(const v8::FunctionCallbackInfo<v8::Value>& info) {
+    FastCallbackBundle* bundle = static_cast<FastCallbackBundle*>(
+        reinterpret_cast<CallbackBundle*>(
+            info.Data().As<v8::External>()->Value()));
+
+    napi_fast_value args[FastCallbackBundle::kMaxArgs];
+    if (info.IsConstructCall() ||
+        static_cast<size_t>(info.Length()) < bundle->arg_count ||
+        !ReadArgs(info, bundle, args)) {
+      FunctionCallbackWrapper::Invoke(info);
+      return;
+    }
+
+    napi_fast_value result;
+    bundle->fast_cb(bundle->cb_data, args, &result);
+
+    v8::ReturnValue<v8::Value> return_value = info.GetReturnValue();
+    switch (bundle->return_type) {
+      case napi_fast_void:
+        break;
+      case napi_fast_bool:
+        return_value.Set(result.bool_value);
+        break;
+      case napi_fast_int32:
+        return_value.Set(result.int32_value);
+        break;
+      case napi_fast_uint32:
+        return_value.Set(result.uint32_value);
+        break;
+      case napi_fast_int64:
+        return_value.Set(static_cast<double>(result.int64_value));
+        break;
+      case napi_fast_double:
+        return_value.Set(result.double_value);
+        break;
+    }
+  }
+
+ private:
+  // Returns false if an argument does not have the declared type. Numbers are
+  // only accepted as integers if they are integers in the declared range, so
+  // that nothing is converted implicitly.
+  static bool ReadArgs(const v8::FunctionCallbackInfo<v8::Value>& info,
+                       const FastCallbackBundle* bundle,
+                       napi_fast_value* args) {
+    for (size_t i = 0; i < bundle->arg_count; i++) {
+      v8::Local<v8::Value> arg = info[i];
+      switch (bundle->arg_types[i]) {
+        case napi_fast_bool:
+          if (!arg->IsBoolean())
+            return false;
+          args[i].bool_value = arg.As<v8::Boolean>()->Value();
+          break;
+        case napi_fast_int32:
+          if (!arg->IsInt32())
+            return false;
+          args[i].int32_value = arg.As<v8::Int32>()->Value();
+          break;
+        case napi_fast_uint32:
+          if (!arg->IsUint32())
+            return false;
+          args[i].uint32_value = arg.As<v8::Uint32>()->Value();
+          break;
+        case napi_fast_int64: {
+          if (!arg->IsNumber())
+            return false;
+          double value = arg.As<v8::Number>()->Value();
+          // 2^53 - 1, the largest integer that is exact as a double.
+          if (std::trunc(value) != value ||
+              std::fabs(value) > 9007199254740991.0) {
+            return false;
+          }
+          args[i].int64_value = static_cast<int64_t>(value);
+          break;
+        }
+        case napi_fast_double:
+          if (!arg->IsNumber())
+            return false;
+          args[i].double_value = arg.As<v8::Number>()->Value();
+          break;
+        default:
+          UNREACHABLE();
+      }
+    }
+    return true;
+  }
+};
+
 class GetterCallbackWrapper
     : public CallbackWrapperBase<v8::PropertyCallbackInfo<v8::Value>,
                                  &CallbackBundle::function_or_getter> {
@@ -657,6 +761,12 @@ v8::Local<v8::Value> CreateFunctionCallbackData(napi_env env,
   return cbdata;
 }
 
+static void DeleteFastCallbackBundle(napi_env env, void* data, void* hint) {
+  FastCallbackBundle* bundle =
+      static_cast<FastCallbackBundle*>(static_cast<CallbackBundle*>(data));
+  delete bundle;
+}
+
 enum WrapType {
   retrievable,
   anonymous
@@ -805,6 +915,76 @@ napi_status napi_create_function(napi_env env,
   return GET_RETURN_STATUS(env);
 }
 
+napi_status napi_create_fast_function(napi_env env,
+                                      const char* utf8name,
+                                      size_t length,
+                                      const napi_fast_signature* signature,
+                                      napi_fast_callback fast_cb,
+                                      napi_callback cb,
+                                      void* callback_data,
+                                      napi_value* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, result);
+  CHECK_ARG(env, signature);
+  CHECK_ARG(env, fast_cb);
+  CHECK_ARG(env, cb);
+  RETURN_STATUS_IF_FALSE(env,
+      signature->arg_count <= v8impl::FastCallbackBundle::kMaxArgs,
+      napi_invalid_arg);
+  RETURN_STATUS_IF_FALSE(env,
+      signature->arg_count == 0 || signature->arg_types != nullptr,
+      napi_invalid_arg);
+  RETURN_STATUS_IF_FALSE(env,
+      signature->return_type >= napi_fast_void &&
+      signature->return_type <= napi_fast_double,
+      napi_invalid_arg);
+  for (size_t i = 0; i < signature->arg_count; i++) {
+    RETURN_STATUS_IF_FALSE(env,
+        signature->arg_types[i] > napi_fast_void &&
+        signature->arg_types[i] <= napi_fast_double,
+        napi_invalid_arg);
+  }
+
+  v8::Isolate* isolate = env->isolate;
+  v8::EscapableHandleScope scope(isolate);
+
+  v8impl::FastCallbackBundle* bundle = new v8impl::FastCallbackBundle();
+  bundle->env = env;
+  bundle->cb_data = callback_data;
+  bundle->function_or_getter = cb;
+  bundle->setter = nullptr;
+  bundle->fast_cb = fast_cb;
+  bundle->return_type = signature->return_type;
+  bundle->arg_count = signature->arg_count;
+  std::copy(signature->arg_types,
+            signature->arg_types + signature->arg_count,
+            bundle->arg_types);
+  v8impl::CallbackBundle* base = bundle;
+  v8::Local<v8::Value> cbdata = v8::External::New(isolate, base);
+  v8impl::Reference::New(env, cbdata, 0, true,
+                         v8impl::DeleteFastCallbackBundle, base, nullptr);
+
+  v8::Local<v8::Context> context = env->context();
+  v8::MaybeLocal<v8::Function> maybe_function =
+      v8::Function::New(context,
+                        v8impl::FastFunctionCallbackWrapper::Invoke,
+                        cbdata);
+  CHECK_MAYBE_EMPTY(env, maybe_function, napi_generic_failure);
+
+  v8::Local<v8::Function> return_value =
+      scope.Escape(maybe_function.ToLocalChecked());
+
+  if (utf8name != nullptr) {
+    v8::Local<v8::String> name_string;
+    CHECK_NEW_FROM_UTF8_LEN(env, name_string, utf8name, length);
+    return_value->SetName(name_string);
+  }
+
+  *result = v8impl::JsValueFromV8LocalValue(return_value);
+
+  return GET_RETURN_STATUS(env);
+}
+
 napi_status napi_define_class(napi_env env,
                               const char* utf8name,
                               size_t length,
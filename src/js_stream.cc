@@ -11,7 +11,6 @@ namespace node {
 
 using errors::TryCatchScope;
 
-using v8::Array;
 using v8::Context;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
@@ -56,6 +55,11 @@ bool JSStream::IsClosing() {
 
 
 int JSStream::ReadStart() {
+  // TLSWrap and other consumers call this whenever they want more data, so
+  // only call into JS when the state actually changes.
+  if (reading_)
+    return 0;
+
   HandleScope scope(env()->isolate());
   Context::Scope context_scope(env()->context());
   TryCatchScope try_catch(env());
@@ -66,11 +70,16 @@ int JSStream::ReadStart() {
     if (try_catch.HasCaught() && !try_catch.HasTerminated())
       errors::TriggerUncaughtException(env()->isolate(), try_catch);
   }
+  if (value_int == 0)
+    reading_ = true;
   return value_int;
 }
 
 
 int JSStream::ReadStop() {
+  if (!reading_)
+    return 0;
+
   HandleScope scope(env()->isolate());
   Context::Scope context_scope(env()->context());
   TryCatchScope try_catch(env());
@@ -81,6 +90,8 @@ int JSStream::ReadStop() {
     if (try_catch.HasCaught() && !try_catch.HasTerminated())
       errors::TriggerUncaughtException(env()->isolate(), try_catch);
   }
+  if (value_int == 0)
+    reading_ = false;
   return value_int;
 }
 
@@ -116,15 +127,21 @@ int JSStream::DoWrite(WriteWrap* w,
   HandleScope scope(env()->isolate());
   Context::Scope context_scope(env()->context());
 
-  MaybeStackBuffer<Local<Value>, 16> bufs_arr(count);
+  // Pass all buffers to JS as a single Buffer, so that they are written to
+  // the JS stream with one write() call.
+  size_t length = 0;
+  for (size_t i = 0; i < count; i++)
+    length += bufs[i].len;
+  AllocatedBuffer data = env()->AllocateManaged(length);
+  size_t offset = 0;
   for (size_t i = 0; i < count; i++) {
-    bufs_arr[i] =
-        Buffer::Copy(env(), bufs[i].base, bufs[i].len).ToLocalChecked();
+    memcpy(data.data() + offset, bufs[i].base, bufs[i].len);
+    offset += bufs[i].len;
   }
 
   Local<Value> argv[] = {
     w->object(),
-    Array::New(env()->isolate(), bufs_arr.out(), count)
+    data.ToBuffer().ToLocalChecked()
   };
 
   TryCatchScope try_catch(env());
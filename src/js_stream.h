@@ -43,6 +43,9 @@ class JSStream : public AsyncWrap, public StreamBase {
 
   template <class Wrap>
   static void Finish(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+ private:
+  bool reading_ = false;
 };
 
 }  // namespace node
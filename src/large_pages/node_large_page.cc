@@ -21,8 +21,10 @@
 // SPDX-License-Identifier: MIT
 
 #include "node_large_page.h"
+#include "node_mutex.h"
 #include "util.h"
 #include "uv.h"
+#include "v8-platform.h"
 
 #include <fcntl.h>  // _O_RDWR
 #include <sys/types.h>
@@ -35,7 +37,9 @@
 #endif
 #include <unistd.h>  // readlink
 
+#include <algorithm>
 #include <cerrno>   // NOLINT(build/include)
+#include <cinttypes>
 #include <climits>  // PATH_MAX
 #include <clocale>
 #include <csignal>
@@ -46,6 +50,8 @@
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <random>
 #include <sstream>
 #include <vector>
 
@@ -425,6 +431,189 @@ int MapStaticCodeToLargePages() {
   return MoveTextRegionToLargePages(r);
 }
 
+#if defined(__linux__)
+// A page allocator for the V8 heap that works like V8's own POSIX page
+// allocator, except that it marks all of its memory with MADV_HUGEPAGE and
+// places new allocations right after the previous one. Adjacent allocations
+// are merged into one mapping by the kernel, so that small heap pages end up
+// in ranges that can be backed by transparent huge pages. Only the start of
+// the heap is randomized.
+class LargePageAllocator : public v8::PageAllocator {
+ public:
+  LargePageAllocator() : page_size_(sysconf(_SC_PAGESIZE)) {
+    std::random_device random_device;
+    SetRandomMmapSeed(static_cast<int64_t>(random_device()) << 32 |
+                      random_device());
+  }
+
+  size_t AllocatePageSize() override { return page_size_; }
+  size_t CommitPageSize() override { return page_size_; }
+
+  void SetRandomMmapSeed(int64_t seed) override {
+    std::mt19937_64 random(seed);
+    Mutex::ScopedLock lock(mutex_);
+    // Use the same range of addresses as V8 does on x64.
+    next_address_ = hugepage_align_down(random() & uint64_t{0x3FFFFFFFF000});
+  }
+
+  void* GetRandomMmapAddr() override {
+    Mutex::ScopedLock lock(mutex_);
+    return reinterpret_cast<void*>(next_address_);
+  }
+
+  void* AllocatePages(void* hint, size_t length, size_t alignment,
+                      Permission permissions) override {
+    alignment = std::max(alignment, page_size_);
+    // Allocate more than needed, and unmap what is left around the aligned
+    // range.
+    const size_t request_length = length + alignment - page_size_;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (permissions == kNoAccess)
+      flags |= MAP_NORESERVE;
+    void* result = mmap(hint, request_length, GetProtection(permissions),
+                        flags, -1, 0);
+    if (result == MAP_FAILED)
+      return nullptr;
+
+    const uintptr_t base = reinterpret_cast<uintptr_t>(result);
+    const uintptr_t start = (base + alignment - 1) & ~(alignment - 1);
+    const uintptr_t end = start + length;
+    if (start > base)
+      CHECK_EQ(0, munmap(result, start - base));
+    if (base + request_length > end)
+      CHECK_EQ(0, munmap(reinterpret_cast<void*>(end),
+                         base + request_length - end));
+    // Failure only means that the kernel does not support huge pages.
+    madvise(reinterpret_cast<void*>(start), length, MADV_HUGEPAGE);
+
+    Mutex::ScopedLock lock(mutex_);
+    regions_[start] = length;
+    reserved_ += length;
+    next_address_ = end;
+    return reinterpret_cast<void*>(start);
+  }
+
+  bool FreePages(void* address, size_t length) override {
+    if (munmap(address, length) != 0)
+      return false;
+    Mutex::ScopedLock lock(mutex_);
+    regions_.erase(reinterpret_cast<uintptr_t>(address));
+    reserved_ -= length;
+    return true;
+  }
+
+  bool ReleasePages(void* address, size_t length, size_t new_length) override {
+    if (munmap(static_cast<char*>(address) + new_length,
+               length - new_length) != 0) {
+      return false;
+    }
+    Mutex::ScopedLock lock(mutex_);
+    regions_[reinterpret_cast<uintptr_t>(address)] = new_length;
+    reserved_ -= length - new_length;
+    return true;
+  }
+
+  bool SetPermissions(void* address, size_t length,
+                      Permission permissions) override {
+    if (mprotect(address, length, GetProtection(permissions)) != 0)
+      return false;
+    // Give the memory back to the OS, like V8 does when decommitting.
+    if (permissions == kNoAccess)
+      return DiscardSystemPages(address, length);
+    return true;
+  }
+
+  bool DiscardSystemPages(void* address, size_t size) override {
+#if defined(MADV_FREE)
+    if (madvise(address, size, MADV_FREE) == 0)
+      return true;
+#endif
+    return madvise(address, size, MADV_DONTNEED) == 0;
+  }
+
+  size_t reserved() {
+    Mutex::ScopedLock lock(mutex_);
+    return reserved_;
+  }
+
+  // Sums up the AnonHugePages of all mappings that contain heap memory.
+  size_t GetLargePageMemory() {
+    std::map<uintptr_t, size_t> regions;
+    {
+      Mutex::ScopedLock lock(mutex_);
+      regions = regions_;
+    }
+
+    std::ifstream ifs("/proc/self/smaps");
+    std::string line;
+    bool in_heap = false;
+    size_t total = 0;
+    while (std::getline(ifs, line)) {
+      uintptr_t start, end;
+      size_t kb;
+      if (sscanf(line.c_str(), "%" SCNxPTR "-%" SCNxPTR, &start, &end) == 2) {
+        // The region that starts last before the end of the mapping is the
+        // only one that can overlap it.
+        auto it = regions.lower_bound(end);
+        in_heap = false;
+        if (it != regions.begin()) {
+          --it;
+          in_heap = it->first + it->second > start;
+        }
+      } else if (in_heap &&
+                 sscanf(line.c_str(), "AnonHugePages: %zu kB", &kb) == 1) {
+        total += kb * 1024;
+      }
+    }
+    return total;
+  }
+
+ private:
+  static int GetProtection(Permission permissions) {
+    switch (permissions) {
+      case kNoAccess: return PROT_NONE;
+      case kRead: return PROT_READ;
+      case kReadWrite: return PROT_READ | PROT_WRITE;
+      case kReadWriteExecute: return PROT_READ | PROT_WRITE | PROT_EXEC;
+      case kReadExecute: return PROT_READ | PROT_EXEC;
+    }
+    UNREACHABLE();
+  }
+
+  const size_t page_size_;
+  Mutex mutex_;
+  uintptr_t next_address_ = 0;
+  // Maps the start of every allocation to its length.
+  std::map<uintptr_t, size_t> regions_;
+  size_t reserved_ = 0;
+};
+
+static LargePageAllocator* large_page_allocator = nullptr;
+#endif  // defined(__linux__)
+
+v8::PageAllocator* GetLargePageAllocator() {
+#if defined(__linux__)
+  // Used by V8 until the process exits, so it is never freed.
+  if (large_page_allocator == nullptr)
+    large_page_allocator = new LargePageAllocator();
+  return large_page_allocator;
+#else
+  return nullptr;
+#endif
+}
+
+bool GetLargePageHeapStatistics(size_t* reserved, size_t* large_pages) {
+#if defined(__linux__)
+  if (large_page_allocator == nullptr)
+    return false;
+  *reserved = large_page_allocator->reserved();
+  *large_pages = large_page_allocator->GetLargePageMemory();
+  return true;
+#else
+  return false;
+#endif
+}
+
 bool IsLargePagesEnabled() {
 #if defined(__linux__)
   return IsTransparentHugePagesEnabled();
@@ -25,10 +25,24 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include <cstddef>
+
+namespace v8 {
+class PageAllocator;
+}  // namespace v8
 
 namespace node {
 bool IsLargePagesEnabled();
 int MapStaticCodeToLargePages();
+
+// Returns a page allocator for the V8 heap, including the code space, that
+// asks the OS to back its memory with large pages, or nullptr if that is not
+// supported on this platform.
+v8::PageAllocator* GetLargePageAllocator();
+// Returns false if the large page allocator is not in use. Otherwise, sets
+// `reserved` to the amount of memory it has reserved and `large_pages` to
+// how much of that is currently backed by large pages.
+bool GetLargePageHeapStatistics(size_t* reserved, size_t* large_pages);
 }  // namespace node
 
 #endif  // NODE_WANT_INTERNALS
@@ -5,6 +5,7 @@
 #include "node_contextify.h"
 #include "node_errors.h"
 #include "node_internals.h"
+#include "node_module_archive.h"
 #include "node_process.h"
 #include "node_url.h"
 #include "node_watchdog.h"
@@ -22,6 +23,8 @@ using errors::TryCatchScope;
 using node::contextify::ContextifyContext;
 using node::url::URL;
 using node::url::URL_FLAGS_FAILED;
+using node::url::URL_FLAGS_HAS_FRAGMENT;
+using node::url::URL_FLAGS_HAS_QUERY;
 using v8::Array;
 using v8::ArrayBufferView;
 using v8::Context;
@@ -576,14 +579,36 @@ inline DescriptorType CheckDescriptorAtFile(uv_file fd) {
 // Should be directory based -> if path/to/dir doesn't exist
 // then the cache should early-fail any path/to/dir/file check.
 DescriptorType CheckDescriptorAtPath(const std::string& path) {
+  if (const ModuleArchive* archive = ModuleArchive::Get()) {
+    switch (archive->GetPathType(path)) {
+      case ModuleArchive::PathType::kFile: return FILE;
+      case ModuleArchive::PathType::kDirectory: return DIRECTORY;
+      case ModuleArchive::PathType::kNone: break;
+    }
+  }
+#ifdef _WIN32
   Maybe<uv_file> fd = OpenDescriptor(path);
   if (fd.IsNothing()) return NONE;
   DescriptorType type = CheckDescriptorAtFile(fd.FromJust());
   CloseDescriptor(fd.FromJust());
   return type;
+#else
+  // A single stat() instead of open(), fstat() and close(), since this runs
+  // for every candidate path of every specifier.
+  uv_fs_t fs_req;
+  const int rc = uv_fs_stat(nullptr, &fs_req, path.c_str(), nullptr);
+  const uint64_t mode = fs_req.statbuf.st_mode;
+  uv_fs_req_cleanup(&fs_req);
+  if (rc != 0) return NONE;
+  return (mode & S_IFMT) == S_IFDIR ? DIRECTORY : FILE;
+#endif
 }
 
 Maybe<std::string> ReadIfFile(const std::string& path) {
+  ModuleArchive::Entry entry;
+  const ModuleArchive* archive = ModuleArchive::Get();
+  if (archive != nullptr && archive->Find(path, &entry))
+    return Just(std::string(entry.data, entry.length));
   Maybe<uv_file> fd = OpenDescriptor(path);
   if (fd.IsNothing()) return Nothing<std::string>();
   DescriptorType type = CheckDescriptorAtFile(fd.FromJust());
@@ -1326,6 +1351,47 @@ Maybe<URL> PackageResolve(Environment* env,
   return Nothing<URL>();
 }
 
+// Resolves the symbolic links in the path of a file: URL, like realpathSync()
+// does for the CommonJS loader, and keeps the query and fragment. Files in the
+// module archive do not exist on disk and are left alone.
+Maybe<URL> RealpathResolution(Environment* env, const URL& resolved) {
+  if (resolved.protocol() != "file:")
+    return Just(resolved);
+  const std::string path = resolved.ToFilePath();
+  const ModuleArchive* archive = ModuleArchive::Get();
+  if (path.empty() ||
+      (archive != nullptr &&
+       archive->GetPathType(path) != ModuleArchive::PathType::kNone)) {
+    return Just(resolved);
+  }
+
+  auto it = env->module_realpath_cache.find(path);
+  if (it == env->module_realpath_cache.end()) {
+    uv_fs_t req;
+    const int err = uv_fs_realpath(nullptr, &req, path.c_str(), nullptr);
+    if (err != 0) {
+      uv_fs_req_cleanup(&req);
+      env->ThrowUVException(err, "realpath", nullptr, path.c_str());
+      return Nothing<URL>();
+    }
+    std::string real(static_cast<const char*>(req.ptr));
+    uv_fs_req_cleanup(&req);
+    if (path.back() == '/' && real.back() != '/')
+      real += '/';
+    it = env->module_realpath_cache.emplace(path, std::move(real)).first;
+  }
+
+  URL real_url = URL::FromFilePath(it->second);
+  std::string suffix;
+  if (resolved.flags() & URL_FLAGS_HAS_QUERY)
+    suffix += "?" + resolved.query();
+  if (resolved.flags() & URL_FLAGS_HAS_FRAGMENT)
+    suffix += "#" + resolved.fragment();
+  if (suffix.empty())
+    return Just(real_url);
+  return Just(URL(real_url.path() + suffix, &real_url));
+}
+
 }  // anonymous namespace
 
 Maybe<URL> Resolve(Environment* env,
@@ -1350,8 +1416,8 @@ Maybe<URL> Resolve(Environment* env,
 void ModuleWrap::Resolve(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
-  // module.resolve(specifier, url)
-  CHECK_EQ(args.Length(), 2);
+  // module.resolve(specifier, url, realpath)
+  CHECK_EQ(args.Length(), 3);
 
   CHECK(args[0]->IsString());
   Utf8Value specifier_utf8(env->isolate(), args[0]);
@@ -1374,12 +1440,18 @@ void ModuleWrap::Resolve(const FunctionCallbackInfo<Value>& args) {
     return;
   }
 
+  if (args[2]->IsTrue())
+    result = RealpathResolution(env, result.FromJust());
+  if (result.IsNothing()) {
+    return;
+  }
+
   URL resolution = result.FromJust();
   CHECK(!(resolution.flags() & URL_FLAGS_FAILED));
 
-  Local<Value> resolution_obj;
-  if (resolution.ToObject(env).ToLocal(&resolution_obj))
-    args.GetReturnValue().Set(resolution_obj);
+  Local<Value> href;
+  if (ToV8Value(env->context(), resolution.href()).ToLocal(&href))
+    args.GetReturnValue().Set(href);
 }
 
 void ModuleWrap::GetPackageType(const FunctionCallbackInfo<Value>& args) {
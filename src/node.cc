@@ -31,11 +31,13 @@
 #include "node_internals.h"
 #include "node_main_instance.h"
 #include "node_metadata.h"
+#include "node_module_archive.h"
 #include "node_native_module_env.h"
 #include "node_options-inl.h"
 #include "node_perf.h"
 #include "node_process.h"
 #include "node_revert.h"
+#include "node_snapshot_builder.h"
 #include "node_v8_platform-inl.h"
 #include "node_version.h"
 
@@ -126,6 +128,8 @@ namespace node {
 
 using native_module::NativeModuleEnv;
 
+using v8::Array;
+using v8::Context;
 using v8::EscapableHandleScope;
 using v8::Function;
 using v8::FunctionCallbackInfo;
@@ -173,6 +177,8 @@ MaybeLocal<Value> ExecuteBootstrapper(Environment* env,
                                       std::vector<Local<String>>* parameters,
                                       std::vector<Local<Value>>* arguments) {
   EscapableHandleScope scope(env->isolate());
+  TRACE_EVENT1(TRACING_CATEGORY_NODE1(bootstrap),
+               "ExecuteBootstrapper", "id", id);
   MaybeLocal<Function> maybe_fn =
       NativeModuleEnv::LookupAndCompile(env->context(), id, parameters, env);
 
@@ -265,12 +271,16 @@ MaybeLocal<Value> Environment::BootstrapInternalLoaders() {
       primordials()};
 
   // Bootstrap internal loaders
+  performance_state()->MarkPhaseStart(
+      performance::NODE_PERFORMANCE_PHASE_BOOTSTRAP_LOADERS);
   Local<Value> loader_exports;
   if (!ExecuteBootstrapper(
            this, "internal/bootstrap/loaders", &loaders_params, &loaders_args)
            .ToLocal(&loader_exports)) {
     return MaybeLocal<Value>();
   }
+  performance_state()->MarkPhaseEnd(
+      performance::NODE_PERFORMANCE_PHASE_BOOTSTRAP_LOADERS);
   CHECK(loader_exports->IsObject());
   Local<Object> loader_exports_obj = loader_exports.As<Object>();
   Local<Value> internal_binding_loader =
@@ -288,6 +298,8 @@ MaybeLocal<Value> Environment::BootstrapInternalLoaders() {
 
 MaybeLocal<Value> Environment::BootstrapNode() {
   EscapableHandleScope scope(isolate_);
+  performance_state()->MarkPhaseStart(
+      performance::NODE_PERFORMANCE_PHASE_BOOTSTRAP_NODE);
 
   Local<Object> global = context()->Global();
   // TODO(joyeecheung): this can be done in JS land now.
@@ -342,6 +354,8 @@ MaybeLocal<Value> Environment::BootstrapNode() {
     return MaybeLocal<Value>();
   }
 
+  performance_state()->MarkPhaseEnd(
+      performance::NODE_PERFORMANCE_PHASE_BOOTSTRAP_NODE);
   return scope.EscapeMaybe(result);
 }
 
@@ -371,10 +385,72 @@ MaybeLocal<Value> Environment::RunBootstrapping() {
   return scope.Escape(result);
 }
 
+// Prints process.moduleLoadList, along with the time spent compiling each
+// built-in module. Modules without a compile time were loaded while the
+// startup snapshot was built.
+static void PrintBootstrapModules(Environment* env) {
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+  HandleScope handle_scope(isolate);
+
+  Local<Value> list;
+  if (!env->process_object()->Get(
+          context, FIXED_ONE_BYTE_STRING(isolate, "moduleLoadList"))
+              .ToLocal(&list) ||
+      !list->IsArray()) {
+    return;
+  }
+
+  static constexpr char kNativeModulePrefix[] = "NativeModule ";
+  static constexpr size_t kNativeModulePrefixLength =
+      sizeof(kNativeModulePrefix) - 1;
+  Local<Array> modules = list.As<Array>();
+  std::string report;
+  size_t compiled = 0;
+  uint64_t total_time = 0;
+  for (uint32_t i = 0; i < modules->Length(); i++) {
+    Local<Value> entry;
+    if (!modules->Get(context, i).ToLocal(&entry))
+      return;
+    node::Utf8Value name(isolate, entry);
+    report += "  ";
+    report += *name;
+
+    if (strncmp(*name, kNativeModulePrefix, kNativeModulePrefixLength) == 0) {
+      auto it = env->native_module_compile_times.find(
+          *name + kNativeModulePrefixLength);
+      if (it == env->native_module_compile_times.end()) {
+        report += " (snapshot)";
+      } else {
+        char time[32];
+        snprintf(time, sizeof(time), " %.3f ms", it->second / 1e6);
+        report += time;
+        compiled++;
+        total_time += it->second;
+      }
+    }
+    report += '\n';
+  }
+
+  fprintf(stderr,
+          "(node:%d) Modules loaded before user code, %zu compiled in "
+          "%.3f ms:\n%s",
+          uv_os_getpid(),
+          compiled,
+          total_time / 1e6,
+          report.c_str());
+  fflush(stderr);
+}
+
 void MarkBootstrapComplete(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
-  env->performance_state()->Mark(
-      performance::NODE_PERFORMANCE_MILESTONE_BOOTSTRAP_COMPLETE);
+  performance::performance_state* state = env->performance_state();
+  const uint64_t now = PERFORMANCE_NOW();
+  state->Mark(performance::NODE_PERFORMANCE_MILESTONE_BOOTSTRAP_COMPLETE, now);
+  state->MarkPhaseEnd(performance::NODE_PERFORMANCE_PHASE_PRE_EXECUTION, now);
+  state->MarkPhaseStart(performance::NODE_PERFORMANCE_PHASE_RUN_MAIN, now);
+  if (env->options()->trace_bootstrap_modules)
+    PrintBootstrapModules(env);
 }
 
 MaybeLocal<Value> StartExecution(Environment* env, const char* main_script_id) {
@@ -397,8 +473,15 @@ MaybeLocal<Value> StartExecution(Environment* env, const char* main_script_id) {
           ->GetFunction(env->context())
           .ToLocalChecked()};
 
-  return scope.EscapeMaybe(
-      ExecuteBootstrapper(env, main_script_id, &parameters, &arguments));
+  env->performance_state()->MarkPhaseStart(
+      performance::NODE_PERFORMANCE_PHASE_PRE_EXECUTION);
+  MaybeLocal<Value> result =
+      ExecuteBootstrapper(env, main_script_id, &parameters, &arguments);
+  // Asynchronous work that the main script starts, such as loading an ES
+  // module graph, is not included.
+  env->performance_state()->MarkPhaseEnd(
+      performance::NODE_PERFORMANCE_PHASE_RUN_MAIN);
+  return scope.EscapeMaybe(result);
 }
 
 MaybeLocal<Value> StartMainThreadExecution(Environment* env) {
@@ -790,6 +873,7 @@ int InitializeNodeWithArgs(std::vector<std::string>* argv,
   V8::SetFlagsFromString(NODE_V8_OPTIONS, sizeof(NODE_V8_OPTIONS) - 1);
 #endif
 
+  const uint64_t option_parsing_start = PERFORMANCE_NOW();
   HandleEnvOptions(per_process::cli_options->per_isolate->per_env);
 
 #if !defined(NODE_WITHOUT_NODE_OPTIONS)
@@ -817,6 +901,9 @@ int InitializeNodeWithArgs(std::vector<std::string>* argv,
                                           errors,
                                           kDisallowedInEnvironment);
   if (exit_code != 0) return exit_code;
+  performance::MarkProcessPhase(
+      performance::NODE_PERFORMANCE_PHASE_OPTION_PARSING,
+      option_parsing_start);
 
   // Set the process.title immediately after processing argv if --title is set.
   if (!per_process::cli_options->title.empty())
@@ -848,12 +935,14 @@ int InitializeNodeWithArgs(std::vector<std::string>* argv,
 
   // Initialize ICU.
   // If icu_data_dir is empty here, it will load the 'minimal' data.
+  const uint64_t icu_init_start = PERFORMANCE_NOW();
   if (!i18n::InitializeICUDirectory(per_process::cli_options->icu_data_dir)) {
     errors->push_back("could not initialize ICU "
                       "(check NODE_ICU_DATA or --icu-data-dir parameters)\n");
     return 9;
   }
-  per_process::metadata.versions.InitializeIntlVersions();
+  performance::MarkProcessPhase(performance::NODE_PERFORMANCE_PHASE_ICU_INIT,
+                                icu_init_start);
 #endif
 
   NativeModuleEnv::InitializeCodeCache();
@@ -950,8 +1039,20 @@ InitializationResult InitializeOncePerProcess(int argc, char** argv) {
       fprintf(stderr, "Large pages are not enabled.\n");
     }
   }
+  if (per_process::cli_options->use_largepages_heap != "off") {
+    // The allocator is handed to V8 when the platform is initialized.
+    if (!node::IsLargePagesEnabled() ||
+        node::GetLargePageAllocator() == nullptr) {
+      if (per_process::cli_options->use_largepages_heap != "silent") {
+        fprintf(stderr,
+                "Large pages are not available for the V8 heap.\n");
+      }
+      per_process::cli_options->use_largepages_heap = "off";
+    }
+  }
 #else
-  if (per_process::cli_options->use_largepages == "on") {
+  if (per_process::cli_options->use_largepages == "on" ||
+      per_process::cli_options->use_largepages_heap == "on") {
     fprintf(stderr, "Mapping to large pages is not supported.\n");
   }
 #endif  // NODE_ENABLE_LARGE_CODE_PAGES
@@ -991,10 +1092,19 @@ InitializationResult InitializeOncePerProcess(int argc, char** argv) {
   V8::SetEntropySource(crypto::EntropySource);
 #endif  // HAVE_OPENSSL
 
-  per_process::v8_platform.Initialize(
-      per_process::cli_options->v8_thread_pool_size);
+  const uint64_t v8_platform_init_start = PERFORMANCE_NOW();
+  int64_t v8_thread_pool_size = per_process::cli_options->v8_thread_pool_size;
+  // By default, use 4 threads, or fewer if the process can use fewer CPUs.
+  if (v8_thread_pool_size == 0) {
+    v8_thread_pool_size = std::min<int64_t>(4, GetAvailableParallelism());
+  }
+  per_process::v8_platform.Initialize(v8_thread_pool_size);
   V8::Initialize();
   performance::performance_v8_start = PERFORMANCE_NOW();
+  performance::MarkProcessPhase(
+      performance::NODE_PERFORMANCE_PHASE_V8_PLATFORM_INIT,
+      v8_platform_init_start,
+      performance::performance_v8_start);
   per_process::v8_initialized = true;
   return result;
 }
@@ -1018,14 +1128,63 @@ int Start(int argc, char** argv) {
     return result.exit_code;
   }
 
+  const std::string& snapshot_blob_path =
+      per_process::cli_options->snapshot_blob;
+  if (per_process::cli_options->build_snapshot) {
+    if (result.args.size() < 2) {
+      fprintf(stderr, "%s: --build-snapshot requires an entry script\n",
+              result.args.at(0).c_str());
+      result.exit_code = 9;
+    } else {
+      result.exit_code = SnapshotBuilder::GenerateBlob(result.args,
+                                                       result.exec_args,
+                                                       result.args[1],
+                                                       snapshot_blob_path);
+    }
+    TearDownOncePerProcess();
+    return result.exit_code;
+  }
+
+  const std::string& module_archive_path =
+      per_process::cli_options->module_archive;
+  if (!module_archive_path.empty()) {
+    std::string error;
+    if (!ModuleArchive::Load(module_archive_path, &error)) {
+      fprintf(stderr, "%s: Cannot load module archive %s: %s\n",
+              result.args.at(0).c_str(),
+              module_archive_path.c_str(),
+              error.c_str());
+      TearDownOncePerProcess();
+      return 9;
+    }
+  }
+
   {
     Isolate::CreateParams params;
     const std::vector<size_t>* indexes = nullptr;
     std::vector<intptr_t> external_references;
+    // Must outlive the Isolate that is created from it.
+    SnapshotData snapshot_data;
 
     bool force_no_snapshot =
         per_process::cli_options->per_isolate->no_node_snapshot;
-    if (!force_no_snapshot) {
+    if (!snapshot_blob_path.empty()) {
+      std::string error;
+      if (!SnapshotBuilder::ReadBlob(snapshot_blob_path,
+                                     &snapshot_data,
+                                     &error)) {
+        fprintf(stderr, "%s: Cannot load snapshot blob %s: %s\n",
+                result.args.at(0).c_str(),
+                snapshot_blob_path.c_str(),
+                error.c_str());
+        TearDownOncePerProcess();
+        return 9;
+      }
+      external_references.push_back(reinterpret_cast<intptr_t>(nullptr));
+      params.external_references = external_references.data();
+      params.snapshot_blob = &snapshot_data.blob;
+      indexes = &snapshot_data.isolate_data_indexes;
+    } else if (!force_no_snapshot) {
       v8::StartupData* blob = NodeMainInstance::GetEmbeddedSnapshotBlob();
       if (blob != nullptr) {
         // TODO(joyeecheung): collect external references and set it in
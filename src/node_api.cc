@@ -10,6 +10,7 @@
 #include "util-inl.h"
 
 #include <memory>
+#include <vector>
 
 struct node_napi_env__ : public napi_env__ {
   explicit node_napi_env__(v8::Local<v8::Context> context):
@@ -121,7 +122,10 @@ class ThreadSafeFunction : public node::AsyncResource {
                      node_napi_env env_,
                      void* finalize_data_,
                      napi_finalize finalize_cb_,
-                     napi_threadsafe_function_call_js call_js_cb_):
+                     napi_threadsafe_function_call_js call_js_cb_,
+                     size_t max_batch_size_ = 1,
+                     napi_threadsafe_function_call_js_batch
+                         call_js_batch_cb_ = nullptr):
                      AsyncResource(env_->isolate,
                                    resource,
                                    *v8::String::Utf8Value(env_->isolate, name)),
@@ -129,10 +133,12 @@ class ThreadSafeFunction : public node::AsyncResource {
       is_closing(false),
       context(context_),
       max_queue_size(max_queue_size_),
+      max_batch_size(max_batch_size_),
       env(env_),
       finalize_data(finalize_data_),
       finalize_cb(finalize_cb_),
       call_js_cb(call_js_cb_ == nullptr ? CallJs : call_js_cb_),
+      call_js_batch_cb(call_js_batch_cb_),
       handles_closing(false) {
     ref.Reset(env->isolate, func);
     node::AddEnvironmentCleanupHook(env->isolate, Cleanup, this);
@@ -166,7 +172,9 @@ class ThreadSafeFunction : public node::AsyncResource {
         return napi_closing;
       }
     } else {
-      if (uv_async_send(&async) != 0) {
+      // The loop thread keeps draining the queue until it is empty, so only
+      // the call that makes it non-empty needs to wake it up.
+      if (queue.empty() && uv_async_send(&async) != 0) {
         return napi_generic_failure;
       }
       queue.push(data);
@@ -211,8 +219,15 @@ class ThreadSafeFunction : public node::AsyncResource {
   }
 
   void EmptyQueueAndDelete() {
-    for (; !queue.empty() ; queue.pop()) {
-      call_js_cb(nullptr, nullptr, context, queue.front());
+    if (call_js_batch_cb != nullptr) {
+      while (!queue.empty()) {
+        TakeBatch();
+        call_js_batch_cb(nullptr, nullptr, context, batch.data(), batch.size());
+      }
+    } else {
+      for (; !queue.empty() ; queue.pop()) {
+        call_js_cb(nullptr, nullptr, context, queue.front());
+      }
     }
     delete this;
   }
@@ -265,8 +280,17 @@ class ThreadSafeFunction : public node::AsyncResource {
     return napi_ok;
   }
 
+  // Removes up to max_batch_size items from the queue and stores them in
+  // batch. The caller must hold the mutex.
+  void TakeBatch() {
+    batch.clear();
+    while (!queue.empty() && batch.size() < max_batch_size) {
+      batch.push_back(queue.front());
+      queue.pop();
+    }
+  }
+
   void DispatchOne() {
-    void* data = nullptr;
     bool popped_value = false;
     bool idle_stop_failed = false;
 
@@ -277,13 +301,16 @@ class ThreadSafeFunction : public node::AsyncResource {
       } else {
         size_t size = queue.size();
         if (size > 0) {
-          data = queue.front();
-          queue.pop();
+          TakeBatch();
           popped_value = true;
-          if (size == max_queue_size && max_queue_size > 0) {
-            cond->Signal(lock);
+          if (size >= max_queue_size && max_queue_size > 0) {
+            if (batch.size() > 1) {
+              cond->Broadcast(lock);
+            } else {
+              cond->Signal(lock);
+            }
           }
-          size--;
+          size -= batch.size();
         }
 
         if (size == 0) {
@@ -318,7 +345,12 @@ class ThreadSafeFunction : public node::AsyncResource {
           js_callback = v8impl::JsValueFromV8LocalValue(js_cb);
         }
         env->CallIntoModuleThrow([&](napi_env env) {
-          call_js_cb(env, js_callback, context, data);
+          if (call_js_batch_cb != nullptr) {
+            call_js_batch_cb(
+                env, js_callback, context, batch.data(), batch.size());
+          } else {
+            call_js_cb(env, js_callback, context, batch[0]);
+          }
         });
       }
     }
@@ -434,6 +466,7 @@ class ThreadSafeFunction : public node::AsyncResource {
   // means we don't need the mutex to read them.
   void* context;
   size_t max_queue_size;
+  size_t max_batch_size;
 
   // These are variables accessed only from the loop thread.
   v8impl::Persistent<v8::Function> ref;
@@ -441,6 +474,8 @@ class ThreadSafeFunction : public node::AsyncResource {
   void* finalize_data;
   napi_finalize finalize_cb;
   napi_threadsafe_function_call_js call_js_cb;
+  napi_threadsafe_function_call_js_batch call_js_batch_cb;
+  std::vector<void*> batch;
   bool handles_closing;
 };
 
@@ -801,6 +836,75 @@ napi_status napi_get_buffer_info(napi_env env,
   return napi_clear_last_error(env);
 }
 
+// A buffer pool is a strong reference to a single external ArrayBuffer. The
+// Buffers handed out by the pool are views on it, so they share its one
+// finalizer instead of getting one each.
+napi_status napi_create_buffer_pool(napi_env env,
+                                    void* data,
+                                    size_t byte_length,
+                                    napi_finalize finalize_cb,
+                                    void* finalize_hint,
+                                    napi_buffer_pool* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, result);
+
+  napi_value arraybuffer;
+  napi_status status = napi_create_external_arraybuffer(
+      env, data, byte_length, finalize_cb, finalize_hint, &arraybuffer);
+  if (status != napi_ok) return status;
+
+  napi_ref ref;
+  status = napi_create_reference(env, arraybuffer, 1, &ref);
+  if (status != napi_ok) return status;
+
+  *result = reinterpret_cast<napi_buffer_pool>(ref);
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_create_buffer_from_pool(napi_env env,
+                                         napi_buffer_pool pool,
+                                         size_t byte_offset,
+                                         size_t length,
+                                         void** data,
+                                         napi_value* result) {
+  NAPI_PREAMBLE(env);
+  CHECK_ARG(env, pool);
+  CHECK_ARG(env, result);
+
+  napi_value arraybuffer;
+  napi_status status = napi_get_reference_value(
+      env, reinterpret_cast<napi_ref>(pool), &arraybuffer);
+  if (status != napi_ok) return status;
+
+  v8::Local<v8::ArrayBuffer> ab =
+      v8impl::V8LocalValueFromJsValue(arraybuffer).As<v8::ArrayBuffer>();
+  size_t byte_length = ab->ByteLength();
+  RETURN_STATUS_IF_FALSE(env,
+      byte_offset <= byte_length && length <= byte_length - byte_offset,
+      napi_invalid_arg);
+
+  auto maybe = node::Buffer::New(env->isolate, ab, byte_offset, length);
+
+  CHECK_MAYBE_EMPTY(env, maybe, napi_generic_failure);
+
+  v8::Local<v8::Object> buffer = maybe.ToLocalChecked();
+
+  *result = v8impl::JsValueFromV8LocalValue(buffer);
+
+  if (data != nullptr) {
+    *data = node::Buffer::Data(buffer);
+  }
+
+  return GET_RETURN_STATUS(env);
+}
+
+napi_status napi_delete_buffer_pool(napi_env env, napi_buffer_pool pool) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, pool);
+
+  return napi_delete_reference(env, reinterpret_cast<napi_ref>(pool));
+}
+
 napi_status napi_get_node_version(napi_env env,
                                   const napi_node_version** result) {
   CHECK_ENV(env);
@@ -843,7 +947,8 @@ class Work : public node::AsyncResource, public node::ThreadPoolWork {
     : AsyncResource(env->isolate,
                     async_resource,
                     *v8::String::Utf8Value(env->isolate, async_resource_name)),
-      ThreadPoolWork(env->node_env()),
+      ThreadPoolWork(env->node_env(),
+                     node::performance::NODE_THREADPOOL_WORK_KIND_NAPI),
       _env(env),
       _data(data),
       _execute(execute),
@@ -1055,6 +1160,73 @@ napi_create_threadsafe_function(napi_env env,
   return napi_set_last_error(env, status);
 }
 
+napi_status
+napi_create_threadsafe_function_batched(
+    napi_env env,
+    napi_value func,
+    napi_value async_resource,
+    napi_value async_resource_name,
+    size_t max_queue_size,
+    size_t max_batch_size,
+    size_t initial_thread_count,
+    void* thread_finalize_data,
+    napi_finalize thread_finalize_cb,
+    void* context,
+    napi_threadsafe_function_call_js_batch call_js_cb,
+    napi_threadsafe_function* result) {
+  CHECK_ENV(env);
+  CHECK_ARG(env, async_resource_name);
+  CHECK_ARG(env, call_js_cb);
+  RETURN_STATUS_IF_FALSE(env, max_batch_size > 0, napi_invalid_arg);
+  RETURN_STATUS_IF_FALSE(env, initial_thread_count > 0, napi_invalid_arg);
+  CHECK_ARG(env, result);
+
+  napi_status status = napi_ok;
+
+  v8::Local<v8::Function> v8_func;
+  if (func != nullptr) {
+    CHECK_TO_FUNCTION(env, v8_func, func);
+  }
+
+  v8::Local<v8::Context> v8_context = env->context();
+
+  v8::Local<v8::Object> v8_resource;
+  if (async_resource == nullptr) {
+    v8_resource = v8::Object::New(env->isolate);
+  } else {
+    CHECK_TO_OBJECT(env, v8_context, v8_resource, async_resource);
+  }
+
+  v8::Local<v8::String> v8_name;
+  CHECK_TO_STRING(env, v8_context, v8_name, async_resource_name);
+
+  v8impl::ThreadSafeFunction* ts_fn =
+      new v8impl::ThreadSafeFunction(v8_func,
+                                     v8_resource,
+                                     v8_name,
+                                     initial_thread_count,
+                                     context,
+                                     max_queue_size,
+                                     reinterpret_cast<node_napi_env>(env),
+                                     thread_finalize_data,
+                                     thread_finalize_cb,
+                                     nullptr,
+                                     max_batch_size,
+                                     call_js_cb);
+
+  if (ts_fn == nullptr) {
+    status = napi_generic_failure;
+  } else {
+    // Init deletes ts_fn upon failure.
+    status = ts_fn->Init();
+    if (status == napi_ok) {
+      *result = reinterpret_cast<napi_threadsafe_function>(ts_fn);
+    }
+  }
+
+  return napi_set_last_error(env, status);
+}
+
 napi_status
 napi_get_threadsafe_function_context(napi_threadsafe_function func,
                                      void** result) {
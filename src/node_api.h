@@ -234,6 +234,40 @@ napi_ref_threadsafe_function(napi_env env, napi_threadsafe_function func);
 
 #endif  // NAPI_VERSION >= 4
 
+#ifdef NAPI_EXPERIMENTAL
+
+NAPI_EXTERN napi_status napi_create_buffer_pool(napi_env env,
+                                                void* data,
+                                                size_t byte_length,
+                                                napi_finalize finalize_cb,
+                                                void* finalize_hint,
+                                                napi_buffer_pool* result);
+NAPI_EXTERN napi_status napi_create_buffer_from_pool(napi_env env,
+                                                     napi_buffer_pool pool,
+                                                     size_t byte_offset,
+                                                     size_t length,
+                                                     void** data,
+                                                     napi_value* result);
+NAPI_EXTERN napi_status napi_delete_buffer_pool(napi_env env,
+                                                napi_buffer_pool pool);
+
+NAPI_EXTERN napi_status
+napi_create_threadsafe_function_batched(
+    napi_env env,
+    napi_value func,
+    napi_value async_resource,
+    napi_value async_resource_name,
+    size_t max_queue_size,
+    size_t max_batch_size,
+    size_t initial_thread_count,
+    void* thread_finalize_data,
+    napi_finalize thread_finalize_cb,
+    void* context,
+    napi_threadsafe_function_call_js_batch call_js_cb,
+    napi_threadsafe_function* result);
+
+#endif  // NAPI_EXPERIMENTAL
+
 EXTERN_C_END
 
 #endif  // SRC_NODE_API_H_
@@ -9,6 +9,9 @@ typedef struct napi_async_work__* napi_async_work;
 #if NAPI_VERSION >= 4
 typedef struct napi_threadsafe_function__* napi_threadsafe_function;
 #endif  // NAPI_VERSION >= 4
+#ifdef NAPI_EXPERIMENTAL
+typedef struct napi_buffer_pool__* napi_buffer_pool;
+#endif  // NAPI_EXPERIMENTAL
 
 #if NAPI_VERSION >= 4
 typedef enum {
@@ -34,6 +37,14 @@ typedef void (*napi_threadsafe_function_call_js)(napi_env env,
                                                  void* data);
 #endif  // NAPI_VERSION >= 4
 
+#ifdef NAPI_EXPERIMENTAL
+typedef void (*napi_threadsafe_function_call_js_batch)(napi_env env,
+                                                       napi_value js_callback,
+                                                       void* context,
+                                                       void** data,
+                                                       size_t count);
+#endif  // NAPI_EXPERIMENTAL
+
 typedef struct {
   uint32_t major;
   uint32_t minor;
@@ -0,0 +1,191 @@
+#include "node_atomics_waiter.h"
+
+#include "async_wrap-inl.h"
+#include "base_object-inl.h"
+#include "env-inl.h"
+#include "memory_tracker-inl.h"
+#include "node_mutex.h"
+#include "util-inl.h"
+
+#include <list>
+#include <unordered_map>
+
+namespace node {
+namespace worker {
+
+using v8::BackingStore;
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::HandleScope;
+using v8::Local;
+using v8::Number;
+using v8::Object;
+using v8::SharedArrayBuffer;
+using v8::String;
+using v8::Value;
+
+namespace {
+
+// All waiters of this process, keyed by the address that they are waiting
+// on. Waiters are only woken up while the mutex is held, and are removed
+// from the list before their async handle is closed.
+Mutex waiters_mutex;
+std::unordered_map<const void*, std::list<AtomicsWaiter*>> waiters;
+
+// Reads the SharedArrayBuffer and byte offset arguments of New() and
+// Notify(), which have already been validated in JS land.
+std::shared_ptr<BackingStore> GetBackingStore(
+    const FunctionCallbackInfo<Value>& args, size_t* byte_offset) {
+  CHECK(args[0]->IsSharedArrayBuffer());
+  CHECK(args[1]->IsUint32());
+  std::shared_ptr<BackingStore> backing_store =
+      args[0].As<SharedArrayBuffer>()->GetBackingStore();
+  *byte_offset = args[1].As<v8::Uint32>()->Value();
+  CHECK_EQ(*byte_offset % sizeof(int32_t), 0);
+  CHECK_LE(*byte_offset + sizeof(int32_t), backing_store->ByteLength());
+  return backing_store;
+}
+
+}  // anonymous namespace
+
+AtomicsWaiter::AtomicsWaiter(Environment* env,
+                             Local<Object> wrap,
+                             std::shared_ptr<BackingStore> backing_store,
+                             size_t byte_offset)
+    : HandleWrap(env,
+                 wrap,
+                 reinterpret_cast<uv_handle_t*>(&async_),
+                 AsyncWrap::PROVIDER_ATOMICSWAITER),
+      backing_store_(std::move(backing_store)),
+      address_(reinterpret_cast<std::atomic<int32_t>*>(
+          static_cast<char*>(backing_store_->Data()) + byte_offset)) {
+  auto onwake = [](uv_async_t* handle) {
+    AtomicsWaiter* waiter = ContainerOf(&AtomicsWaiter::async_, handle);
+    waiter->OnWake();
+  };
+  CHECK_EQ(uv_async_init(env->event_loop(), &async_, onwake), 0);
+}
+
+AtomicsWaiter::~AtomicsWaiter() {
+  Mutex::ScopedLock lock(waiters_mutex);
+  Unregister();
+}
+
+bool AtomicsWaiter::Unregister() {
+  if (!waiting_) return false;
+  waiting_ = false;
+  auto it = waiters.find(address_);
+  CHECK_NE(it, waiters.end());
+  it->second.remove(this);
+  if (it->second.empty())
+    waiters.erase(it);
+  return true;
+}
+
+void AtomicsWaiter::OnWake() {
+  HandleScope handle_scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+  MakeCallback(env()->oncomplete_string(), 0, nullptr);
+}
+
+void AtomicsWaiter::Close(Local<Value> close_callback) {
+  {
+    Mutex::ScopedLock lock(waiters_mutex);
+    Unregister();
+  }
+  HandleWrap::Close(close_callback);
+}
+
+void AtomicsWaiter::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackFieldWithSize("backing_store", sizeof(int32_t));
+}
+
+void AtomicsWaiter::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  size_t byte_offset;
+  std::shared_ptr<BackingStore> backing_store =
+      GetBackingStore(args, &byte_offset);
+  new AtomicsWaiter(env, args.This(), std::move(backing_store), byte_offset);
+}
+
+void AtomicsWaiter::Wait(const FunctionCallbackInfo<Value>& args) {
+  AtomicsWaiter* waiter;
+  ASSIGN_OR_RETURN_UNWRAP(&waiter, args.Holder());
+  CHECK(args[0]->IsInt32());
+  int32_t expected = args[0].As<v8::Int32>()->Value();
+  CHECK(!waiter->waiting_);
+  CHECK(!waiter->IsHandleClosing());
+
+  // Comparing while holding the mutex means that a notification, which is
+  // sent after the value has been changed, cannot get lost.
+  Mutex::ScopedLock lock(waiters_mutex);
+  if (waiter->address_->load() != expected)
+    return args.GetReturnValue().Set(false);
+  waiters[waiter->address_].push_back(waiter);
+  waiter->waiting_ = true;
+  args.GetReturnValue().Set(true);
+}
+
+void AtomicsWaiter::Cancel(const FunctionCallbackInfo<Value>& args) {
+  AtomicsWaiter* waiter;
+  ASSIGN_OR_RETURN_UNWRAP(&waiter, args.Holder());
+  Mutex::ScopedLock lock(waiters_mutex);
+  args.GetReturnValue().Set(waiter->Unregister());
+}
+
+void AtomicsWaiter::Notify(const FunctionCallbackInfo<Value>& args) {
+  size_t byte_offset;
+  std::shared_ptr<BackingStore> backing_store =
+      GetBackingStore(args, &byte_offset);
+  CHECK(args[2]->IsNumber());
+  double count = args[2].As<Number>()->Value();
+  const void* address =
+      static_cast<char*>(backing_store->Data()) + byte_offset;
+
+  uint32_t woken = 0;
+  Mutex::ScopedLock lock(waiters_mutex);
+  auto it = waiters.find(address);
+  if (it != waiters.end()) {
+    std::list<AtomicsWaiter*>& list = it->second;
+    while (!list.empty() && woken < count) {
+      AtomicsWaiter* waiter = list.front();
+      list.pop_front();
+      waiter->waiting_ = false;
+      uv_async_send(&waiter->async_);
+      woken++;
+    }
+    if (list.empty())
+      waiters.erase(it);
+  }
+  args.GetReturnValue().Set(woken);
+}
+
+void AtomicsWaiter::Initialize(Local<Object> target,
+                               Local<Value> unused,
+                               Local<Context> context,
+                               void* priv) {
+  Environment* env = Environment::GetCurrent(context);
+
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+  Local<String> waiter_string =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "AtomicsWaiter");
+  t->SetClassName(waiter_string);
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  t->Inherit(HandleWrap::GetConstructorTemplate(env));
+  env->SetProtoMethod(t, "wait", Wait);
+  env->SetProtoMethod(t, "cancel", Cancel);
+
+  target->Set(context,
+              waiter_string,
+              t->GetFunction(context).ToLocalChecked()).Check();
+
+  env->SetMethod(target, "notify", Notify);
+}
+
+}  // namespace worker
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_INTERNAL(atomics_waiter,
+                                   node::worker::AtomicsWaiter::Initialize)
@@ -0,0 +1,68 @@
+#ifndef SRC_NODE_ATOMICS_WAITER_H_
+#define SRC_NODE_ATOMICS_WAITER_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "handle_wrap.h"
+#include "v8.h"
+
+#include <atomic>
+#include <memory>
+
+namespace node {
+namespace worker {
+
+// Waits for a notification on a 32-bit location in a SharedArrayBuffer
+// without blocking the event loop, similar to Atomics.waitAsync(). The
+// waiter is registered in a process-wide list of waiters for the location,
+// and another thread wakes it up through its libuv async handle, which then
+// calls `oncomplete` on the event loop thread.
+class AtomicsWaiter : public HandleWrap {
+ public:
+  static void Initialize(v8::Local<v8::Object> target,
+                         v8::Local<v8::Value> unused,
+                         v8::Local<v8::Context> context,
+                         void* priv);
+
+  ~AtomicsWaiter() override;
+
+  void Close(
+      v8::Local<v8::Value> close_callback = v8::Local<v8::Value>()) override;
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(AtomicsWaiter)
+  SET_SELF_SIZE(AtomicsWaiter)
+
+ private:
+  AtomicsWaiter(Environment* env,
+                v8::Local<v8::Object> wrap,
+                std::shared_ptr<v8::BackingStore> backing_store,
+                size_t byte_offset);
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  // Starts waiting if the location still holds the expected value, and
+  // returns whether it did.
+  static void Wait(const v8::FunctionCallbackInfo<v8::Value>& args);
+  // Stops waiting, and returns whether the waiter had not been woken up yet.
+  static void Cancel(const v8::FunctionCallbackInfo<v8::Value>& args);
+  // Wakes up at most `count` waiters for a location, in the order in which
+  // they started waiting, and returns how many were woken up.
+  static void Notify(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  void OnWake();
+  // Removes this waiter from the list of waiters. Must be called with the
+  // list's mutex held.
+  bool Unregister();
+
+  uv_async_t async_;
+  std::shared_ptr<v8::BackingStore> backing_store_;
+  std::atomic<int32_t>* const address_;
+  bool waiting_ = false;
+};
+
+}  // namespace worker
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_ATOMICS_WAITER_H_
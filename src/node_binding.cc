@@ -43,6 +43,7 @@
 // __attribute__((constructor)) like mechanism in GCC.
 #define NODE_BUILTIN_STANDARD_MODULES(V)                                       \
   V(async_wrap)                                                                \
+  V(atomics_waiter)                                                            \
   V(buffer)                                                                    \
   V(cares_wrap)                                                                \
   V(config)                                                                    \
@@ -58,6 +59,7 @@
   V(http_parser)                                                               \
   V(inspector)                                                                 \
   V(js_stream)                                                                 \
+  V(json_parser)                                                               \
   V(messaging)                                                                 \
   V(module_wrap)                                                               \
   V(native_module)                                                             \
@@ -68,6 +70,7 @@
   V(process_wrap)                                                              \
   V(process_methods)                                                           \
   V(serdes)                                                                    \
+  V(shared_channel)                                                            \
   V(signal_wrap)                                                               \
   V(spawn_sync)                                                                \
   V(stream_pipe)                                                               \
@@ -86,8 +89,10 @@
   V(uv)                                                                        \
   V(v8)                                                                        \
   V(wasi)                                                                      \
+  V(wasm_web_api)                                                              \
   V(worker)                                                                    \
   V(watchdog)                                                                  \
+  V(websocket)                                                                 \
   V(zlib)
 
 #define NODE_BUILTIN_MODULES(V)                                                \
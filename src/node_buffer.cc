@@ -24,14 +24,25 @@
 #include "node_errors.h"
 #include "node_internals.h"
 
+#include "base_object-inl.h"
 #include "env-inl.h"
+#include "memory_tracker-inl.h"
 #include "string_bytes.h"
 #include "string_search.h"
+#include "utf8.h"
 #include "util-inl.h"
 #include "v8.h"
 
+#include <algorithm>
 #include <cstring>
 #include <climits>
+#include <memory>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NODE_BUFFER_X86 1
+#include <immintrin.h>
+#endif
 
 #define THROW_AND_RETURN_UNLESS_BUFFER(env, obj)                            \
   THROW_AND_RETURN_IF_NOT_BUFFER(env, obj, "argument")                      \
@@ -46,12 +57,14 @@
 namespace node {
 namespace Buffer {
 
+using v8::Array;
 using v8::ArrayBuffer;
 using v8::ArrayBufferView;
 using v8::BackingStore;
 using v8::Context;
 using v8::EscapableHandleScope;
 using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
 using v8::Global;
 using v8::HandleScope;
 using v8::Int32;
@@ -202,6 +215,117 @@ inline MUST_USE_RESULT Maybe<bool> ParseArrayIndex(Environment* env,
   return Just(true);
 }
 
+#ifdef NODE_BUFFER_X86
+
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+// Byte swaps within groups of kBytes bytes are a single shuffle. The kernels
+// return the number of bytes they have swapped, which is a multiple of the
+// vector size; the rest is left to the scalar SwapBytes* functions.
+template <size_t kBytes>
+SSSE3_TARGET inline __m128i SwapMask() {
+  alignas(16) char mask[16];
+  for (size_t i = 0; i < sizeof(mask); i++)
+    mask[i] = (i / kBytes) * kBytes + kBytes - 1 - i % kBytes;
+  return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+}
+
+template <size_t kBytes>
+SSSE3_TARGET size_t SwapBytesSSSE3(char* data, size_t nbytes) {
+  const __m128i mask = SwapMask<kBytes>();
+  size_t i = 0;
+  for (; i + 32 <= nbytes; i += 32) {
+    __m128i* p = reinterpret_cast<__m128i*>(data + i);
+    const __m128i a = _mm_loadu_si128(p);
+    const __m128i b = _mm_loadu_si128(p + 1);
+    _mm_storeu_si128(p, _mm_shuffle_epi8(a, mask));
+    _mm_storeu_si128(p + 1, _mm_shuffle_epi8(b, mask));
+  }
+  for (; i + 16 <= nbytes; i += 16) {
+    __m128i* p = reinterpret_cast<__m128i*>(data + i);
+    _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask));
+  }
+  return i;
+}
+
+template <size_t kBytes>
+AVX2_TARGET size_t SwapBytesAVX2(char* data, size_t nbytes) {
+  // vpshufb shuffles within 128-bit lanes, so both lanes use the same mask.
+  alignas(16) char mask_bytes[16];
+  for (size_t i = 0; i < sizeof(mask_bytes); i++)
+    mask_bytes[i] = (i / kBytes) * kBytes + kBytes - 1 - i % kBytes;
+  const __m256i mask = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(mask_bytes)));
+  size_t i = 0;
+  for (; i + 64 <= nbytes; i += 64) {
+    __m256i* p = reinterpret_cast<__m256i*>(data + i);
+    const __m256i a = _mm256_loadu_si256(p);
+    const __m256i b = _mm256_loadu_si256(p + 1);
+    _mm256_storeu_si256(p, _mm256_shuffle_epi8(a, mask));
+    _mm256_storeu_si256(p + 1, _mm256_shuffle_epi8(b, mask));
+  }
+  for (; i + 32 <= nbytes; i += 32) {
+    __m256i* p = reinterpret_cast<__m256i*>(data + i);
+    _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), mask));
+  }
+  return i;
+}
+
+#undef SSSE3_TARGET
+#undef AVX2_TARGET
+
+#endif  // NODE_BUFFER_X86
+
+struct BufferKernels {
+  size_t (*swap16)(char* data, size_t nbytes);
+  size_t (*swap32)(char* data, size_t nbytes);
+  size_t (*swap64)(char* data, size_t nbytes);
+};
+
+BufferKernels SelectKernels() {
+#ifdef NODE_BUFFER_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return { SwapBytesAVX2<2>, SwapBytesAVX2<4>, SwapBytesAVX2<8> };
+  if (__builtin_cpu_supports("ssse3"))
+    return { SwapBytesSSSE3<2>, SwapBytesSSSE3<4>, SwapBytesSSSE3<8> };
+#endif
+  return { nullptr, nullptr, nullptr };
+}
+
+const BufferKernels& GetKernels() {
+  static const BufferKernels kernels = SelectKernels();
+  return kernels;
+}
+
+// Repeats the first |pattern_length| bytes of |data| until |length| bytes are
+// filled. The pattern is first doubled up to a block that fits into the L1
+// cache, which is then copied over and over again, so that filling large
+// buffers only reads from memory that is already cached.
+void FillPattern(char* data, size_t pattern_length, size_t length) {
+  static constexpr size_t kBlockSize = 4096;
+  size_t in_there = pattern_length;
+  while (in_there < kBlockSize && in_there < length - in_there) {
+    memcpy(data + in_there, data, in_there);
+    in_there *= 2;
+  }
+
+  size_t offset = in_there;
+#ifdef __SSE2__
+  // Patterns that tile a vector are stored without reading them back.
+  if (16 % pattern_length == 0 && in_there >= 16) {
+    const __m128i pattern = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data));
+    for (; offset + 16 <= length; offset += 16)
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(data + offset), pattern);
+  }
+#endif
+  for (; offset + in_there <= length; offset += in_there)
+    memcpy(data + offset, data, in_there);
+  memcpy(data + offset, data, length - offset);
+}
+
 }  // anonymous namespace
 
 // Buffer methods
@@ -665,18 +789,7 @@ void Fill(const FunctionCallbackInfo<Value>& args) {
   if (str_length == 0)
     return args.GetReturnValue().Set(-1);
 
-  size_t in_there = str_length;
-  char* ptr = ts_obj_data + start + str_length;
-
-  while (in_there < fill_length - in_there) {
-    memcpy(ptr, ts_obj_data + start, in_there);
-    ptr += in_there;
-    in_there *= 2;
-  }
-
-  if (in_there < fill_length) {
-    memcpy(ptr, ts_obj_data + start, fill_length - in_there);
-  }
+  FillPattern(ts_obj_data + start, str_length, fill_length);
 }
 
 
@@ -1061,12 +1174,194 @@ void IndexOfNumber(const FunctionCallbackInfo<Value>& args) {
                                 : -1);
 }
 
+void IndexOfAny(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[1]->IsArrayBufferView());
+  CHECK(args[2]->IsNumber());
+
+  THROW_AND_RETURN_UNLESS_BUFFER(Environment::GetCurrent(args), args[0]);
+  ArrayBufferViewContents<uint8_t> buffer(args[0]);
+  ArrayBufferViewContents<uint8_t> set(args[1]);
+  int64_t offset_i64 = args[2].As<Integer>()->Value();
+
+  int64_t opt_offset = IndexOfOffset(buffer.length(), offset_i64, 1, true);
+  if (opt_offset <= -1 || buffer.length() == 0 || set.length() == 0) {
+    return args.GetReturnValue().Set(-1);
+  }
+
+  size_t result = stringsearch::FindFirstOf(buffer.data(),
+                                            buffer.length(),
+                                            static_cast<size_t>(opt_offset),
+                                            set.data(),
+                                            set.length());
+  args.GetReturnValue().Set(
+      result == buffer.length() ? -1 : static_cast<double>(result));
+}
+
+// splitLines(buffer, start, end)
+// Returns the lines in buffer[start, end) as an array of UTF-8 strings. Lines
+// end at '\n', which is not part of the line, and neither is a '\r' before
+// it. Bytes after the last '\n' are not returned.
+void SplitLines(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
+  ArrayBufferViewContents<char> buffer(args[0]);
+
+  size_t start = 0;
+  size_t end = 0;
+  THROW_AND_RETURN_IF_OOB(ParseArrayIndex(env, args[1], 0, &start));
+  THROW_AND_RETURN_IF_OOB(ParseArrayIndex(env, args[2], buffer.length(), &end));
+  if (end < start) end = start;
+  THROW_AND_RETURN_IF_OOB(Just(end <= buffer.length()));
+
+  const char* data = buffer.data();
+  std::vector<Local<Value>> lines;
+  while (start < end) {
+    const char* newline =
+        static_cast<const char*>(memchr(data + start, '\n', end - start));
+    if (newline == nullptr)
+      break;
+    size_t line_end = newline - data;
+    const size_t next = line_end + 1;
+    if (line_end > start && data[line_end - 1] == '\r')
+      line_end--;
+
+    Local<Value> error;
+    MaybeLocal<Value> line = StringBytes::Encode(
+        isolate, data + start, line_end - start, UTF8, &error);
+    if (line.IsEmpty()) {
+      CHECK(!error.IsEmpty());
+      isolate->ThrowException(error);
+      return;
+    }
+    lines.push_back(line.ToLocalChecked());
+    start = next;
+  }
+  args.GetReturnValue().Set(Array::New(isolate, lines.data(), lines.size()));
+}
+
+// A pattern whose search tables are kept around between searches, for
+// patterns that are searched for many times, such as multipart boundaries.
+class Searcher : public BaseObject {
+ public:
+  Searcher(Environment* env, Local<Object> wrap, std::vector<uint8_t>&& pattern)
+      : BaseObject(env, wrap),
+        pattern_(std::move(pattern)),
+        search_(stringsearch::Vector<const uint8_t>(
+            pattern_.data(), pattern_.size(), true)) {
+    MakeWeak();
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args.IsConstructCall());
+    CHECK(args[0]->IsArrayBufferView());
+    ArrayBufferViewContents<uint8_t> pattern(args[0]);
+    CHECK_GT(pattern.length(), 0);
+    new Searcher(env, args.This(), std::vector<uint8_t>(
+        pattern.data(), pattern.data() + pattern.length()));
+  }
+
+  static void IndexOf(const FunctionCallbackInfo<Value>& args) {
+    Searcher* searcher;
+    ASSIGN_OR_RETURN_UNWRAP(&searcher, args.Holder());
+    CHECK(args[1]->IsNumber());
+    THROW_AND_RETURN_UNLESS_BUFFER(searcher->env(), args[0]);
+    ArrayBufferViewContents<uint8_t> haystack(args[0]);
+    int64_t offset_i64 = args[1].As<Integer>()->Value();
+
+    const size_t pattern_length = searcher->pattern_.size();
+    int64_t opt_offset =
+        IndexOfOffset(haystack.length(), offset_i64, pattern_length, true);
+    if (opt_offset <= -1 || haystack.length() < pattern_length) {
+      return args.GetReturnValue().Set(-1);
+    }
+
+    size_t result = searcher->search_.Search(
+        stringsearch::Vector<const uint8_t>(
+            haystack.data(), haystack.length(), true),
+        static_cast<size_t>(opt_offset));
+    args.GetReturnValue().Set(
+        result == haystack.length() ? -1 : static_cast<double>(result));
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("pattern", pattern_.size());
+  }
+
+  SET_MEMORY_INFO_NAME(Searcher)
+  SET_SELF_SIZE(Searcher)
+
+ private:
+  const std::vector<uint8_t> pattern_;
+  stringsearch::StringSearch<uint8_t> search_;
+};
+
+
+// A one-byte string that points into the memory of a Buffer. Holding on to
+// the backing store keeps that memory alive for as long as the string is.
+class BufferExternalString : public String::ExternalOneByteStringResource {
+ public:
+  BufferExternalString(std::shared_ptr<BackingStore> backing_store,
+                       size_t offset,
+                       size_t length)
+      : backing_store_(std::move(backing_store)),
+        data_(static_cast<const char*>(backing_store_->Data()) + offset),
+        length_(length) {}
+
+  const char* data() const override { return data_; }
+  size_t length() const override { return length_; }
+
+ private:
+  const std::shared_ptr<BackingStore> backing_store_;
+  const char* const data_;
+  const size_t length_;
+};
+
+// toExternalString(buffer, latin1)
+// Returns undefined if the contents do not decode to the same characters in
+// the requested encoding as in Latin-1, i.e. are not ASCII-only for UTF-8 and
+// ASCII.
+void ToExternalString(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
+  Local<ArrayBufferView> view = args[0].As<ArrayBufferView>();
+  const bool latin1 = args[1]->IsTrue();
+
+  const size_t length = view->ByteLength();
+  if (length > static_cast<size_t>(String::kMaxLength))
+    return;
+
+  std::shared_ptr<BackingStore> backing_store =
+      view->Buffer()->GetBackingStore();
+  const size_t offset = view->ByteOffset();
+  if (!latin1) {
+    Utf8Info info;
+    const char* data = static_cast<const char*>(backing_store->Data()) + offset;
+    if (!utf8_validate(data, length, &info) || info.utf16_length != length)
+      return;
+  }
+
+  BufferExternalString* resource =
+      new BufferExternalString(std::move(backing_store), offset, length);
+  Local<String> ret;
+  if (!String::NewExternalOneByte(env->isolate(), resource).ToLocal(&ret)) {
+    delete resource;
+    return;
+  }
+  args.GetReturnValue().Set(ret);
+}
+
 
 void Swap16(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
   SPREAD_BUFFER_ARG(args[0], ts_obj);
-  SwapBytes16(ts_obj_data, ts_obj_length);
+  size_t done = 0;
+  if (GetKernels().swap16 != nullptr)
+    done = GetKernels().swap16(ts_obj_data, ts_obj_length);
+  SwapBytes16(ts_obj_data + done, ts_obj_length - done);
   args.GetReturnValue().Set(args[0]);
 }
 
@@ -1075,7 +1370,10 @@ void Swap32(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
   SPREAD_BUFFER_ARG(args[0], ts_obj);
-  SwapBytes32(ts_obj_data, ts_obj_length);
+  size_t done = 0;
+  if (GetKernels().swap32 != nullptr)
+    done = GetKernels().swap32(ts_obj_data, ts_obj_length);
+  SwapBytes32(ts_obj_data + done, ts_obj_length - done);
   args.GetReturnValue().Set(args[0]);
 }
 
@@ -1084,7 +1382,10 @@ void Swap64(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
   SPREAD_BUFFER_ARG(args[0], ts_obj);
-  SwapBytes64(ts_obj_data, ts_obj_length);
+  size_t done = 0;
+  if (GetKernels().swap64 != nullptr)
+    done = GetKernels().swap64(ts_obj_data, ts_obj_length);
+  SwapBytes64(ts_obj_data + done, ts_obj_length - done);
   args.GetReturnValue().Set(args[0]);
 }
 
@@ -1153,6 +1454,52 @@ void SetBufferPrototype(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// allocAligned(size, alignment)
+// Allocates a zero-filled Buffer whose memory starts at a multiple of
+// |alignment|, which has to be a power of two. Files opened with O_DIRECT
+// need such buffers, which the ArrayBuffer::Allocator cannot provide.
+void AllocAligned(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsNumber());
+  CHECK(args[1]->IsUint32());
+  const size_t size = static_cast<size_t>(args[0].As<Number>()->Value());
+  const size_t alignment =
+      std::max<size_t>(args[1].As<Uint32>()->Value(), sizeof(void*));
+  CHECK_LE(size, kMaxLength);
+  CHECK_EQ(alignment & (alignment - 1), 0);
+
+  // Zero-sized allocations do not have to return a distinct pointer.
+  const size_t allocation_size = std::max<size_t>(size, 1);
+  void* data;
+#ifdef _WIN32
+  data = _aligned_malloc(allocation_size, alignment);
+#else
+  if (posix_memalign(&data, alignment, allocation_size) != 0)
+    data = nullptr;
+#endif
+  if (data == nullptr)
+    return THROW_ERR_MEMORY_ALLOCATION_FAILED(env);
+  memset(data, 0, size);
+
+  std::unique_ptr<BackingStore> backing = ArrayBuffer::NewBackingStore(
+      data,
+      size,
+      [](void* data, size_t length, void* deleter_data) {
+#ifdef _WIN32
+        _aligned_free(data);
+#else
+        free(data);
+#endif
+      },
+      nullptr);
+  Local<ArrayBuffer> ab = ArrayBuffer::New(env->isolate(), std::move(backing));
+
+  Local<Object> buffer;
+  if (Buffer::New(env, ab, 0, size).ToLocal(&buffer))
+    args.GetReturnValue().Set(buffer);
+}
+
+
 void Initialize(Local<Object> target,
                 Local<Value> unused,
                 Local<Context> context,
@@ -1160,6 +1507,7 @@ void Initialize(Local<Object> target,
   Environment* env = Environment::GetCurrent(context);
 
   env->SetMethod(target, "setBufferPrototype", SetBufferPrototype);
+  env->SetMethod(target, "allocAligned", AllocAligned);
   env->SetMethodNoSideEffect(target, "createFromString", CreateFromString);
 
   env->SetMethodNoSideEffect(target, "byteLengthUtf8", ByteLengthUtf8);
@@ -1170,6 +1518,19 @@ void Initialize(Local<Object> target,
   env->SetMethodNoSideEffect(target, "indexOfBuffer", IndexOfBuffer);
   env->SetMethodNoSideEffect(target, "indexOfNumber", IndexOfNumber);
   env->SetMethodNoSideEffect(target, "indexOfString", IndexOfString);
+  env->SetMethodNoSideEffect(target, "indexOfAny", IndexOfAny);
+  env->SetMethodNoSideEffect(target, "toExternalString", ToExternalString);
+  env->SetMethodNoSideEffect(target, "splitLines", SplitLines);
+
+  Local<FunctionTemplate> searcher = env->NewFunctionTemplate(Searcher::New);
+  searcher->InstanceTemplate()->SetInternalFieldCount(1);
+  Local<String> searcher_string =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "Searcher");
+  searcher->SetClassName(searcher_string);
+  env->SetProtoMethodNoSideEffect(searcher, "indexOf", Searcher::IndexOf);
+  target->Set(env->context(),
+              searcher_string,
+              searcher->GetFunction(env->context()).ToLocalChecked()).Check();
 
   env->SetMethod(target, "swap16", Swap16);
   env->SetMethod(target, "swap32", Swap32);
@@ -1188,6 +1549,7 @@ void Initialize(Local<Object> target,
 
   env->SetMethodNoSideEffect(target, "asciiSlice", StringSlice<ASCII>);
   env->SetMethodNoSideEffect(target, "base64Slice", StringSlice<BASE64>);
+  env->SetMethodNoSideEffect(target, "base64urlSlice", StringSlice<BASE64URL>);
   env->SetMethodNoSideEffect(target, "latin1Slice", StringSlice<LATIN1>);
   env->SetMethodNoSideEffect(target, "hexSlice", StringSlice<HEX>);
   env->SetMethodNoSideEffect(target, "ucs2Slice", StringSlice<UCS2>);
@@ -1195,6 +1557,7 @@ void Initialize(Local<Object> target,
 
   env->SetMethod(target, "asciiWrite", StringWrite<ASCII>);
   env->SetMethod(target, "base64Write", StringWrite<BASE64>);
+  env->SetMethod(target, "base64urlWrite", StringWrite<BASE64URL>);
   env->SetMethod(target, "latin1Write", StringWrite<LATIN1>);
   env->SetMethod(target, "hexWrite", StringWrite<HEX>);
   env->SetMethod(target, "ucs2Write", StringWrite<UCS2>);
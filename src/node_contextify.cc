@@ -23,13 +23,18 @@
 
 #include "memory_tracker-inl.h"
 #include "node_internals.h"
+#include "node_main_instance.h"
 #include "node_watchdog.h"
 #include "base_object-inl.h"
 #include "node_context_data.h"
 #include "node_errors.h"
 #include "module_wrap.h"
+#include "node_mutex.h"
 #include "util-inl.h"
 
+#include <list>
+#include <unordered_map>
+
 namespace node {
 namespace contextify {
 
@@ -92,6 +97,13 @@ using v8::WeakCallbackType;
 //
 // For every `set` of a global property, the interceptor callback defines or
 // changes the property both on the sandbox and the global proxy.
+//
+// Contexts that are created without a sandbox object use their own global
+// proxy as the sandbox instead, so they do not need interceptors. Neither do
+// contexts whose sandbox is detached, i.e. only copied to and from the
+// global object explicitly in JS. When the isolate was deserialized from a
+// snapshot, these contexts are deserialized from it as well, rather than
+// running the per-context scripts again.
 
 namespace {
 
@@ -101,6 +113,79 @@ Local<Name> Uint32ToName(Local<Context> context, uint32_t index) {
       .ToLocalChecked();
 }
 
+// A process-wide cache of the code caches of vm.Script and
+// vm.compileFunction() sources, keyed by a hash of the source, the filename
+// and the compile options. It is shared by all threads, and the least
+// recently used entries are evicted once it grows beyond kMaxSize bytes.
+class CompileCache {
+ public:
+  static constexpr size_t kMaxSize = 32 * 1024 * 1024;
+
+  std::shared_ptr<std::string> Get(const std::string& key) {
+    Mutex::ScopedLock lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end())
+      return nullptr;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+  }
+
+  void Set(const std::string& key, std::shared_ptr<std::string> data) {
+    if (data->size() > kMaxSize)
+      return;
+    Mutex::ScopedLock lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      size_ -= it->second->second->size();
+      lru_.erase(it->second);
+      entries_.erase(it);
+    }
+    size_ += data->size();
+    lru_.emplace_front(key, std::move(data));
+    entries_.emplace(key, lru_.begin());
+    while (size_ > kMaxSize) {
+      auto& last = lru_.back();
+      size_ -= last.second->size();
+      entries_.erase(last.first);
+      lru_.pop_back();
+    }
+  }
+
+ private:
+  using Entry = std::pair<std::string, std::shared_ptr<std::string>>;
+
+  Mutex mutex_;
+  size_t size_ = 0;
+  std::list<Entry> lru_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> entries_;
+};
+
+CompileCache compile_cache;
+
+// getCompileCacheEntry(key) returns a copy of the cached data, if any.
+void GetCompileCacheEntry(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  Utf8Value key(env->isolate(), args[0]);
+  std::shared_ptr<std::string> data = compile_cache.Get(key.ToString());
+  if (!data)
+    return;
+  Local<Object> buf;
+  if (Buffer::Copy(env, data->data(), data->size()).ToLocal(&buf))
+    args.GetReturnValue().Set(buf);
+}
+
+// setCompileCacheEntry(key, cachedData)
+void SetCompileCacheEntry(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsArrayBufferView());
+  Utf8Value key(env->isolate(), args[0]);
+  ArrayBufferViewContents<char> data(args[1]);
+  compile_cache.Set(key.ToString(),
+                    std::make_shared<std::string>(data.data(), data.length()));
+}
+
 }  // anonymous namespace
 
 ContextifyContext::ContextifyContext(
@@ -151,6 +236,68 @@ MaybeLocal<Context> ContextifyContext::CreateV8Context(
     Local<Object> sandbox_obj,
     const ContextOptions& options) {
   EscapableHandleScope scope(env->isolate());
+  Local<Context> ctx;
+  if (sandbox_obj.IsEmpty()) {
+    if (!CreateOwnGlobalContext(env).ToLocal(&ctx))
+      return MaybeLocal<Context>();
+    sandbox_obj = ctx->Global();
+  } else {
+    if (options.detached) {
+      if (!CreateOwnGlobalContext(env).ToLocal(&ctx))
+        return MaybeLocal<Context>();
+    } else if (!CreateInterceptedContext(env, sandbox_obj).ToLocal(&ctx)) {
+      return MaybeLocal<Context>();
+    }
+    // We need to tie the lifetime of the sandbox object with the lifetime of
+    // newly created context. We do this by making them hold references to
+    // each other. The context can directly hold a reference to the sandbox as
+    // an embedder data field. However, we cannot hold a reference to a
+    // v8::Context directly in an Object, we instead hold onto the new
+    // context's global object instead (which then has a reference to the
+    // context).
+    sandbox_obj->SetPrivate(env->context(),
+                            env->contextify_global_private_symbol(),
+                            ctx->Global());
+  }
+
+  ctx->SetSecurityToken(env->context()->GetSecurityToken());
+  ctx->SetEmbedderData(ContextEmbedderIndex::kSandboxObject, sandbox_obj);
+
+  Utf8Value name_val(env->isolate(), options.name);
+  ctx->AllowCodeGenerationFromStrings(options.allow_code_gen_strings->IsTrue());
+  ctx->SetEmbedderData(ContextEmbedderIndex::kAllowWasmCodeGeneration,
+                       options.allow_code_gen_wasm);
+
+  ContextInfo info(*name_val);
+
+  if (!options.origin.IsEmpty()) {
+    Utf8Value origin_val(env->isolate(), options.origin);
+    info.origin = *origin_val;
+  }
+
+  env->AssignToContext(ctx, info);
+
+  return scope.Escape(ctx);
+}
+
+MaybeLocal<Context> ContextifyContext::CreateOwnGlobalContext(
+    Environment* env) {
+  if (!env->isolate_data()->from_snapshot())
+    return NewContext(env->isolate());
+
+  Local<Context> ctx;
+  if (!Context::FromSnapshot(env->isolate(),
+                             NodeMainInstance::kVmContextIndex)
+           .ToLocal(&ctx)) {
+    return MaybeLocal<Context>();
+  }
+  InitializeContextRuntime(ctx);
+  return ctx;
+}
+
+MaybeLocal<Context> ContextifyContext::CreateInterceptedContext(
+    Environment* env,
+    Local<Object> sandbox_obj) {
   Local<FunctionTemplate> function_template =
       FunctionTemplate::New(env->isolate());
 
@@ -186,40 +333,7 @@ MaybeLocal<Context> ContextifyContext::CreateV8Context(
   object_template->SetHandler(config);
   object_template->SetHandler(indexed_config);
 
-  Local<Context> ctx = NewContext(env->isolate(), object_template);
-
-  if (ctx.IsEmpty()) {
-    return MaybeLocal<Context>();
-  }
-
-  ctx->SetSecurityToken(env->context()->GetSecurityToken());
-
-  // We need to tie the lifetime of the sandbox object with the lifetime of
-  // newly created context. We do this by making them hold references to each
-  // other. The context can directly hold a reference to the sandbox as an
-  // embedder data field. However, we cannot hold a reference to a v8::Context
-  // directly in an Object, we instead hold onto the new context's global
-  // object instead (which then has a reference to the context).
-  ctx->SetEmbedderData(ContextEmbedderIndex::kSandboxObject, sandbox_obj);
-  sandbox_obj->SetPrivate(env->context(),
-                          env->contextify_global_private_symbol(),
-                          ctx->Global());
-
-  Utf8Value name_val(env->isolate(), options.name);
-  ctx->AllowCodeGenerationFromStrings(options.allow_code_gen_strings->IsTrue());
-  ctx->SetEmbedderData(ContextEmbedderIndex::kAllowWasmCodeGeneration,
-                       options.allow_code_gen_wasm);
-
-  ContextInfo info(*name_val);
-
-  if (!options.origin.IsEmpty()) {
-    Utf8Value origin_val(env->isolate(), options.origin);
-    info.origin = *origin_val;
-  }
-
-  env->AssignToContext(ctx, info);
-
-  return scope.Escape(ctx);
+  return NewContext(env->isolate(), object_template);
 }
 
 
@@ -232,23 +346,33 @@ void ContextifyContext::Init(Environment* env, Local<Object> target) {
 
   env->SetMethod(target, "makeContext", MakeContext);
   env->SetMethod(target, "isContext", IsContext);
+  env->SetMethod(target, "getContextGlobal", GetContextGlobal);
   env->SetMethod(target, "compileFunction", CompileFunction);
+  env->SetMethodNoSideEffect(
+      target, "createFunctionCachedData", CreateFunctionCachedData);
+  env->SetMethodNoSideEffect(
+      target, "getCompileCacheEntry", GetCompileCacheEntry);
+  env->SetMethod(target, "setCompileCacheEntry", SetCompileCacheEntry);
 }
 
 
-// makeContext(sandbox, name, origin, strings, wasm);
+// makeContext(sandbox, name, origin, strings, wasm, detached);
+// If `sandbox` is undefined, the new context's global proxy is contextified
+// and returned instead.
 void ContextifyContext::MakeContext(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
-  CHECK_EQ(args.Length(), 5);
-  CHECK(args[0]->IsObject());
-  Local<Object> sandbox = args[0].As<Object>();
-
-  // Don't allow contextifying a sandbox multiple times.
-  CHECK(
-      !sandbox->HasPrivate(
-          env->context(),
-          env->contextify_context_private_symbol()).FromJust());
+  CHECK_EQ(args.Length(), 6);
+  CHECK(args[0]->IsObject() || args[0]->IsUndefined());
+  Local<Object> sandbox;
+  if (args[0]->IsObject()) {
+    sandbox = args[0].As<Object>();
+    // Don't allow contextifying a sandbox multiple times.
+    CHECK(
+        !sandbox->HasPrivate(
+            env->context(),
+            env->contextify_context_private_symbol()).FromJust());
+  }
 
   ContextOptions options;
 
@@ -266,6 +390,9 @@ void ContextifyContext::MakeContext(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[4]->IsBoolean());
   options.allow_code_gen_wasm = args[4].As<Boolean>();
 
+  CHECK(args[5]->IsBoolean());
+  options.detached = args[5]->IsTrue();
+
   TryCatchScope try_catch(env);
   auto context_ptr = std::make_unique<ContextifyContext>(env, sandbox, options);
 
@@ -278,10 +405,12 @@ void ContextifyContext::MakeContext(const FunctionCallbackInfo<Value>& args) {
   if (context_ptr->context().IsEmpty())
     return;
 
+  sandbox = context_ptr->sandbox();
   sandbox->SetPrivate(
       env->context(),
       env->contextify_context_private_symbol(),
       External::New(env->isolate(), context_ptr.release()));
+  args.GetReturnValue().Set(sandbox);
 }
 
 
@@ -298,6 +427,20 @@ void ContextifyContext::IsContext(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// getContextGlobal(sandbox) returns the global proxy of a contextified
+// sandbox's context.
+void ContextifyContext::GetContextGlobal(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(args[0]->IsObject());
+  ContextifyContext* contextify_context =
+      ContextFromContextifiedSandbox(env, args[0].As<Object>());
+  CHECK_NOT_NULL(contextify_context);
+  args.GetReturnValue().Set(contextify_context->global_proxy());
+}
+
+
 void ContextifyContext::WeakCallback(
     const WeakCallbackInfo<ContextifyContext>& data) {
   ContextifyContext* context = data.GetParameter();
@@ -1137,6 +1280,15 @@ void ContextifyContext::CompileFunction(
           .IsNothing())
     return;
 
+  if (options == ScriptCompiler::kConsumeCodeCache) {
+    if (result
+            ->Set(parsing_context,
+                  env->cached_data_rejected_string(),
+                  Boolean::New(isolate, source.GetCachedData()->rejected))
+            .IsNothing())
+      return;
+  }
+
   if (produce_cached_data) {
     const std::unique_ptr<ScriptCompiler::CachedData> cached_data(
         ScriptCompiler::CreateCodeCacheForFunction(fn));
@@ -1164,6 +1316,25 @@ void ContextifyContext::CompileFunction(
   args.GetReturnValue().Set(result);
 }
 
+// Creates the code cache for a function returned by compileFunction(). Unlike
+// the `produceCachedData` option, this can be called after the function has
+// run, so that the cache also contains the functions that were compiled
+// lazily in the meantime.
+void ContextifyContext::CreateFunctionCachedData(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsFunction());
+  std::unique_ptr<ScriptCompiler::CachedData> cached_data(
+      ScriptCompiler::CreateCodeCacheForFunction(args[0].As<Function>()));
+  if (!cached_data)
+    return;
+  MaybeLocal<Object> buf = Buffer::Copy(
+      env,
+      reinterpret_cast<const char*>(cached_data->data),
+      cached_data->length);
+  args.GetReturnValue().Set(buf.ToLocalChecked());
+}
+
 void CompiledFnEntry::WeakCallback(
     const WeakCallbackInfo<CompiledFnEntry>& data) {
   CompiledFnEntry* entry = data.GetParameter();
@@ -15,6 +15,9 @@ struct ContextOptions {
   v8::Local<v8::String> origin;
   v8::Local<v8::Boolean> allow_code_gen_strings;
   v8::Local<v8::Boolean> allow_code_gen_wasm;
+  // Whether the sandbox object is detached from the context's global object,
+  // which then does not need interceptors.
+  bool detached = false;
 };
 
 class ContextifyContext {
@@ -26,9 +29,15 @@ class ContextifyContext {
   static void CleanupHook(void* arg);
 
   v8::MaybeLocal<v8::Object> CreateDataWrapper(Environment* env);
+  // If |sandbox_obj| is empty, the context's global proxy is used as the
+  // sandbox.
   v8::MaybeLocal<v8::Context> CreateV8Context(Environment* env,
                                               v8::Local<v8::Object> sandbox_obj,
                                               const ContextOptions& options);
+  v8::MaybeLocal<v8::Context> CreateOwnGlobalContext(Environment* env);
+  v8::MaybeLocal<v8::Context> CreateInterceptedContext(
+      Environment* env,
+      v8::Local<v8::Object> sandbox_obj);
   static void Init(Environment* env, v8::Local<v8::Object> target);
 
   static ContextifyContext* ContextFromContextifiedSandbox(
@@ -59,8 +68,12 @@ class ContextifyContext {
  private:
   static void MakeContext(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void IsContext(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void GetContextGlobal(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void CompileFunction(
       const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void CreateFunctionCachedData(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void WeakCallback(
       const v8::WeakCallbackInfo<ContextifyContext>& data);
   static void PropertyGetterCallback(
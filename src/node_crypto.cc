@@ -24,6 +24,7 @@
 #include "node_crypto_bio.h"
 #include "node_crypto_clienthello-inl.h"
 #include "node_crypto_groups.h"
+#include "node_crypto_scrypt.h"
 #include "node_errors.h"
 #include "node_mutex.h"
 #include "node_process.h"
@@ -47,6 +48,7 @@
 #include <openssl/pem.h>
 #include <openssl/x509v3.h>
 #include <openssl/hmac.h>
+#include <openssl/ocsp.h>
 #include <openssl/rand.h>
 #include <openssl/pkcs12.h>
 
@@ -55,7 +57,11 @@
 #include <cstring>
 
 #include <algorithm>
+#include <atomic>
+#include <list>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -92,6 +98,7 @@ using v8::Local;
 using v8::Maybe;
 using v8::MaybeLocal;
 using v8::NewStringType;
+using v8::Number;
 using v8::Nothing;
 using v8::Null;
 using v8::Object;
@@ -136,6 +143,9 @@ static const char system_cert_path[] = NODE_OPENSSL_SYSTEM_CERT_PATH;
 
 static X509_STORE* root_cert_store;
 
+// Set from NODE_EXTRA_CA_CERTS at startup, but only read once the root
+// certificate store is first needed.
+static std::string extra_root_certs_file;  // NOLINT(runtime/string)
 static bool extra_root_certs_loaded = false;
 
 // Just to generate static methods
@@ -382,31 +392,45 @@ struct CryptoErrorVector : public std::vector<std::string> {
 };
 
 
-void ThrowCryptoError(Environment* env,
-                      unsigned long err,  // NOLINT(runtime/int)
-                      // Default, only used if there is no SSL `err` which can
-                      // be used to create a long-style message string.
-                      const char* message = nullptr) {
+// Creates the exception that ThrowCryptoError() throws, from an error that was
+// already popped off the error queue and the |errors| left behind it. This
+// allows errors that occurred on another thread to be reported.
+MaybeLocal<Value> CryptoErrorToException(
+    Environment* env,
+    unsigned long err,  // NOLINT(runtime/int)
+    const CryptoErrorVector& errors,
+    const char* message = nullptr) {
   char message_buffer[128] = {0};
   if (err != 0 || message == nullptr) {
     ERR_error_string_n(err, message_buffer, sizeof(message_buffer));
     message = message_buffer;
   }
-  HandleScope scope(env->isolate());
   Local<String> exception_string =
       String::NewFromUtf8(env->isolate(), message, NewStringType::kNormal)
       .ToLocalChecked();
-  CryptoErrorVector errors;
-  errors.Capture();
   Local<Value> exception;
   if (!errors.ToException(env, exception_string).ToLocal(&exception))
-    return;
+    return MaybeLocal<Value>();
   Local<Object> obj;
   if (!exception->ToObject(env->context()).ToLocal(&obj))
-    return;
+    return MaybeLocal<Value>();
   if (error::Decorate(env, obj, err).IsNothing())
-    return;
-  env->isolate()->ThrowException(exception);
+    return MaybeLocal<Value>();
+  return exception;
+}
+
+
+void ThrowCryptoError(Environment* env,
+                      unsigned long err,  // NOLINT(runtime/int)
+                      // Default, only used if there is no SSL `err` which can
+                      // be used to create a long-style message string.
+                      const char* message = nullptr) {
+  HandleScope scope(env->isolate());
+  CryptoErrorVector errors;
+  errors.Capture();
+  Local<Value> exception;
+  if (CryptoErrorToException(env, err, errors, message).ToLocal(&exception))
+    env->isolate()->ThrowException(exception);
 }
 
 
@@ -490,6 +514,10 @@ void SecureContext::Initialize(Environment* env, Local<Object> target) {
   env->SetProtoMethod(t, "setOptions", SetOptions);
   env->SetProtoMethod(t, "setSessionIdContext", SetSessionIdContext);
   env->SetProtoMethod(t, "setSessionTimeout", SetSessionTimeout);
+  env->SetProtoMethod(t, "setSessionCache", SetSessionCache);
+  env->SetProtoMethod(t, "setOCSPResponse", SetOCSPResponse);
+  env->SetProtoMethod(t, "addSNIContext", AddSNIContext);
+  env->SetProtoMethod(t, "loadCredentials", LoadCredentials);
   env->SetProtoMethod(t, "close", Close);
   env->SetProtoMethod(t, "loadPKCS12", LoadPKCS12);
 #ifndef OPENSSL_NO_ENGINE
@@ -537,6 +565,163 @@ void SecureContext::New(const FunctionCallbackInfo<Value>& args) {
   new SecureContext(env, args.This());
 }
 
+// Chains that verified successfully, so that connections which present the
+// same chain again, as with mutual TLS between the same services, skip the
+// signature checks. Enabled with --tls-verify-cache-ttl. Entries are keyed by
+// the id of the store that the chain was verified against, whether the peer
+// is a client or a server, and the digests of the certificates the peer sent.
+// A store gets a new id when its certificates or CRLs change, and entries
+// expire after the TTL or when a certificate of the chain expires.
+class VerifiedChainCache {
+ public:
+  static constexpr size_t kMaxEntries = 4096;
+
+  // Returns true if `key` is in the cache and has not expired.
+  bool Lookup(const std::string& key, uint64_t now) {
+    Mutex::ScopedLock lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->second <= now) {
+      misses_++;
+      return false;
+    }
+    hits_++;
+    return true;
+  }
+
+  void Insert(const std::string& key, uint64_t expiry, uint64_t now) {
+    Mutex::ScopedLock lock(mutex_);
+    if (entries_.size() >= kMaxEntries) {
+      for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second <= now)
+          it = entries_.erase(it);
+        else
+          ++it;
+      }
+      if (entries_.size() >= kMaxEntries)
+        entries_.clear();
+    }
+    entries_[key] = expiry;
+  }
+
+  uint64_t StoreId(X509_STORE* store) {
+    Mutex::ScopedLock lock(mutex_);
+    if (store_id_index_ == -1) {
+      store_id_index_ =
+          X509_STORE_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    }
+    uint64_t id = reinterpret_cast<uintptr_t>(
+        X509_STORE_get_ex_data(store, store_id_index_));
+    if (id == 0) {
+      id = next_store_id_++;
+      X509_STORE_set_ex_data(store, store_id_index_,
+                             reinterpret_cast<void*>(id));
+    }
+    return id;
+  }
+
+  // Called when the contents of `store` change, so that the chains that were
+  // verified against it are not used anymore.
+  void InvalidateStore(X509_STORE* store) {
+    Mutex::ScopedLock lock(mutex_);
+    if (store_id_index_ != -1)
+      X509_STORE_set_ex_data(store, store_id_index_, nullptr);
+  }
+
+  void GetStats(uint64_t* hits, uint64_t* misses) {
+    Mutex::ScopedLock lock(mutex_);
+    *hits = hits_;
+    *misses = misses_;
+  }
+
+ private:
+  Mutex mutex_;
+  std::unordered_map<std::string, uint64_t> entries_;
+  int store_id_index_ = -1;
+  uint64_t next_store_id_ = 1;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+};
+
+static VerifiedChainCache verified_chain_cache;
+
+static bool AppendCertDigest(X509* cert, std::string* key) {
+  unsigned char md[EVP_MAX_MD_SIZE];
+  unsigned int md_size;
+  if (!X509_digest(cert, EVP_sha256(), md, &md_size))
+    return false;
+  key->append(reinterpret_cast<const char*>(md), md_size);
+  return true;
+}
+
+// Replaces X509_verify_cert() for the contexts that cache verified chains.
+static int VerifyChainCallback(X509_STORE_CTX* ctx, void* arg) {
+  const uint64_t ttl = per_process::cli_options->tls_verify_cache_ttl;
+  X509* leaf = X509_STORE_CTX_get0_cert(ctx);
+  STACK_OF(X509)* untrusted = X509_STORE_CTX_get0_untrusted(ctx);
+  SSL* ssl = static_cast<SSL*>(X509_STORE_CTX_get_ex_data(
+      ctx, SSL_get_ex_data_X509_STORE_CTX_idx()));
+  if (ttl == 0 || leaf == nullptr || ssl == nullptr)
+    return X509_verify_cert(ctx);
+
+  const uint64_t id =
+      verified_chain_cache.StoreId(X509_STORE_CTX_get0_store(ctx));
+  std::string key(reinterpret_cast<const char*>(&id), sizeof(id));
+  key += SSL_is_server(ssl) ? 's' : 'c';
+  bool ok = AppendCertDigest(leaf, &key);
+  for (int i = 0; ok && i < sk_X509_num(untrusted); i++) {
+    X509* cert = sk_X509_value(untrusted, i);
+    if (cert != leaf)
+      ok = AppendCertDigest(cert, &key);
+  }
+  if (!ok) {
+    ERR_clear_error();
+    return X509_verify_cert(ctx);
+  }
+
+  uint64_t now = uv_hrtime();
+  if (verified_chain_cache.Lookup(key, now))
+    return 1;
+
+  // VerifyCallback() lets the verification continue after errors, so the
+  // result is in the error of the context rather than the return value.
+  int ret = X509_verify_cert(ctx);
+  if (ret <= 0 || X509_STORE_CTX_get_error(ctx) != X509_V_OK)
+    return ret;
+
+  uint64_t expiry = now + ttl * 1000000;
+  STACK_OF(X509)* chain = X509_STORE_CTX_get0_chain(ctx);
+  for (int i = 0; i < sk_X509_num(chain); i++) {
+    int days;
+    int seconds;
+    if (!ASN1_TIME_diff(&days, &seconds, nullptr,
+                        X509_get0_notAfter(sk_X509_value(chain, i)))) {
+      ERR_clear_error();
+      return ret;
+    }
+    const int64_t remaining = days * int64_t{86400} + seconds;
+    if (remaining <= 0)
+      return ret;
+    if (static_cast<uint64_t>(remaining) < (expiry - now) / 1000000000)
+      expiry = now + remaining * 1000000000;
+  }
+  verified_chain_cache.Insert(key, expiry, now);
+  return ret;
+}
+
+static void GetVerifiedChainCacheStats(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  uint64_t hits;
+  uint64_t misses;
+  verified_chain_cache.GetStats(&hits, &misses);
+  Local<Value> stats[] = {
+    Number::New(env->isolate(), static_cast<double>(hits)),
+    Number::New(env->isolate(), static_cast<double>(misses))
+  };
+  args.GetReturnValue().Set(
+      Array::New(env->isolate(), stats, arraysize(stats)));
+}
+
 // A maxVersion of 0 means "any", but OpenSSL may support TLS versions that
 // Node.js doesn't, so pin the max to what we do support.
 const int MAX_SUPPORTED_VERSION = TLS1_3_VERSION;
@@ -643,6 +828,10 @@ void SecureContext::Init(const FunctionCallbackInfo<Value>& args) {
 
   sc->ctx_.reset(SSL_CTX_new(method));
   SSL_CTX_set_app_data(sc->ctx_.get(), sc);
+  if (per_process::cli_options->tls_verify_cache_ttl > 0) {
+    SSL_CTX_set_cert_verify_callback(sc->ctx_.get(), VerifyChainCallback,
+                                     nullptr);
+  }
 
   // Disable SSLv2 in the case when method == TLS_method() and the
   // cipher list contains SSLv2 ciphers (not the default, should be rare.)
@@ -892,10 +1081,12 @@ int SSL_CTX_use_certificate_chain(SSL_CTX* ctx,
 // sent to the peer in the Certificate message.
 //
 // Taken from OpenSSL - edited for style.
-int SSL_CTX_use_certificate_chain(SSL_CTX* ctx,
-                                  BIOPointer&& in,
-                                  X509Pointer* cert,
-                                  X509Pointer* issuer) {
+//
+// Parsing is split from using the chain, so that it can happen off the main
+// thread, see SecureContextLoadJob.
+static int ReadCertificateChain(BIOPointer&& in,
+                                X509Pointer* cert,
+                                StackOfX509* extra) {
   // Just to ensure that `ERR_peek_last_error` below will return only errors
   // that we are interested in
   ERR_clear_error();
@@ -934,6 +1125,21 @@ int SSL_CTX_use_certificate_chain(SSL_CTX* ctx,
     return 0;
   }
 
+  *cert = std::move(x);
+  *extra = std::move(extra_certs);
+  return 1;
+}
+
+
+int SSL_CTX_use_certificate_chain(SSL_CTX* ctx,
+                                  BIOPointer&& in,
+                                  X509Pointer* cert,
+                                  X509Pointer* issuer) {
+  X509Pointer x;
+  StackOfX509 extra_certs;
+  if (!ReadCertificateChain(std::move(in), &x, &extra_certs))
+    return 0;
+
   return SSL_CTX_use_certificate_chain(ctx,
                                        std::move(x),
                                        extra_certs.get(),
@@ -1027,6 +1233,18 @@ void GetRootCertificates(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+static void AddCACertToContext(SecureContext* sc, X509* x509) {
+  X509_STORE* cert_store = SSL_CTX_get_cert_store(sc->ctx_.get());
+  if (cert_store == root_cert_store) {
+    cert_store = NewRootCertStore();
+    SSL_CTX_set_cert_store(sc->ctx_.get(), cert_store);
+  }
+  X509_STORE_add_cert(cert_store, x509);
+  verified_chain_cache.InvalidateStore(cert_store);
+  SSL_CTX_add_client_CA(sc->ctx_.get(), x509);
+}
+
+
 void SecureContext::AddCACert(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -1042,15 +1260,9 @@ void SecureContext::AddCACert(const FunctionCallbackInfo<Value>& args) {
   if (!bio)
     return;
 
-  X509_STORE* cert_store = SSL_CTX_get_cert_store(sc->ctx_.get());
   while (X509* x509 = PEM_read_bio_X509_AUX(
       bio.get(), nullptr, NoPasswordCallback, nullptr)) {
-    if (cert_store == root_cert_store) {
-      cert_store = NewRootCertStore();
-      SSL_CTX_set_cert_store(sc->ctx_.get(), cert_store);
-    }
-    X509_STORE_add_cert(cert_store, x509);
-    SSL_CTX_add_client_CA(sc->ctx_.get(), x509);
+    AddCACertToContext(sc, x509);
     X509_free(x509);
   }
 }
@@ -1087,6 +1299,7 @@ void SecureContext::AddCRL(const FunctionCallbackInfo<Value>& args) {
   X509_STORE_add_crl(cert_store, crl.get());
   X509_STORE_set_flags(cert_store,
                        X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL);
+  verified_chain_cache.InvalidateStore(cert_store);
 }
 
 
@@ -1118,24 +1331,31 @@ static unsigned long AddCertsFromFile(  // NOLINT(runtime/int)
 
 
 void UseExtraCaCerts(const std::string& file) {
+  extra_root_certs_file = file;
+}
+
+
+// Creates the shared root certificate store, including the extra
+// certificates from NODE_EXTRA_CA_CERTS. Parsing them is deferred until a
+// SecureContext uses the root certificates, so that processes that never
+// use TLS do not pay for it.
+static void InitRootCertStore() {
   ClearErrorOnReturn clear_error_on_return;
 
-  if (root_cert_store == nullptr) {
-    root_cert_store = NewRootCertStore();
-
-    if (!file.empty()) {
-      unsigned long err = AddCertsFromFile(  // NOLINT(runtime/int)
-                                           root_cert_store,
-                                           file.c_str());
-      if (err) {
-        fprintf(stderr,
-                "Warning: Ignoring extra certs from `%s`, load failed: %s\n",
-                file.c_str(),
-                ERR_error_string(err, nullptr));
-      } else {
-        extra_root_certs_loaded = true;
-      }
-    }
+  root_cert_store = NewRootCertStore();
+  if (extra_root_certs_file.empty())
+    return;
+
+  unsigned long err = AddCertsFromFile(  // NOLINT(runtime/int)
+                                       root_cert_store,
+                                       extra_root_certs_file.c_str());
+  if (err) {
+    fprintf(stderr,
+            "Warning: Ignoring extra certs from `%s`, load failed: %s\n",
+            extra_root_certs_file.c_str(),
+            ERR_error_string(err, nullptr));
+  } else {
+    extra_root_certs_loaded = true;
   }
 }
 
@@ -1151,8 +1371,14 @@ void SecureContext::AddRootCerts(const FunctionCallbackInfo<Value>& args) {
   ASSIGN_OR_RETURN_UNWRAP(&sc, args.Holder());
   ClearErrorOnReturn clear_error_on_return;
 
-  if (root_cert_store == nullptr) {
-    root_cert_store = NewRootCertStore();
+  {
+    // The store is parsed once and shared by the SecureContexts of all
+    // threads, Workers may get here concurrently.
+    static Mutex root_cert_store_mutex;
+    Mutex::ScopedLock lock(root_cert_store_mutex);
+    if (root_cert_store == nullptr) {
+      InitRootCertStore();
+    }
   }
 
   // Increment reference count so global store is not deleted along with CTX.
@@ -1388,6 +1614,171 @@ void SecureContext::SetSessionTimeout(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+void SecureContext::SetSessionCache(const FunctionCallbackInfo<Value>& args) {
+  SecureContext* sc;
+  ASSIGN_OR_RETURN_UNWRAP(&sc, args.Holder());
+  Environment* env = sc->env();
+
+  CHECK_EQ(args.Length(), 2);
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsUint32());
+
+  const node::Utf8Value name(env->isolate(), args[0]);
+  const uint32_t max_entries = args[1].As<Uint32>()->Value();
+  CHECK_GT(max_entries, 0);
+
+  sc->session_cache_ = SessionCache::Get(*name, max_entries);
+  SSL_CTX_sess_set_remove_cb(sc->ctx_.get(), SessionCacheRemoveCallback);
+}
+
+
+// Sets the OCSP response that is stapled to the handshakes of this context,
+// or removes it when called with null. Returns the number of milliseconds
+// until the earliest nextUpdate time in the response, or -1 if it has none.
+void SecureContext::SetOCSPResponse(const FunctionCallbackInfo<Value>& args) {
+  SecureContext* sc;
+  ASSIGN_OR_RETURN_UNWRAP(&sc, args.Holder());
+  Environment* env = sc->env();
+  ClearErrorOnReturn clear_error_on_return;
+
+  sc->ocsp_response_.clear();
+  if (args[0]->IsNull())
+    return;
+
+  CHECK(args[0]->IsArrayBufferView());
+  ArrayBufferViewContents<unsigned char> buf(args[0].As<ArrayBufferView>());
+  const unsigned char* p = buf.data();
+  DeleteFnPtr<OCSP_RESPONSE, OCSP_RESPONSE_free> response(
+      d2i_OCSP_RESPONSE(nullptr, &p, buf.length()));
+  if (!response ||
+      OCSP_response_status(response.get()) != OCSP_RESPONSE_STATUS_SUCCESSFUL) {
+    return THROW_ERR_INVALID_ARG_VALUE(env, "Invalid OCSP response");
+  }
+  DeleteFnPtr<OCSP_BASICRESP, OCSP_BASICRESP_free> basic(
+      OCSP_response_get1_basic(response.get()));
+  if (!basic)
+    return THROW_ERR_INVALID_ARG_VALUE(env, "Invalid OCSP response");
+
+  int64_t remaining = -1;
+  for (int i = 0; i < OCSP_resp_count(basic.get()); i++) {
+    ASN1_GENERALIZEDTIME* next_update = nullptr;
+    OCSP_single_get0_status(OCSP_resp_get0(basic.get(), i),
+                            nullptr, nullptr, nullptr, &next_update);
+    if (next_update == nullptr)
+      continue;
+    int days;
+    int seconds;
+    if (!ASN1_TIME_diff(&days, &seconds, nullptr, next_update))
+      return THROW_ERR_INVALID_ARG_VALUE(env, "Invalid OCSP response");
+    const int64_t ms =
+        std::max<int64_t>(0, (days * int64_t{86400} + seconds) * 1000);
+    if (remaining == -1 || ms < remaining)
+      remaining = ms;
+  }
+
+  sc->ocsp_response_.assign(buf.data(), buf.data() + buf.length());
+  sc->ocsp_response_expiry_ = remaining == -1 ?
+      UINT64_MAX : uv_hrtime() + remaining * 1000000;
+  args.GetReturnValue().Set(static_cast<double>(remaining));
+}
+
+
+// Returns whether `servername` matches `pattern`, in which * matches any
+// number of characters other than dots.
+static bool MatchesServername(const char* pattern, const char* servername) {
+  for (; *pattern != '\0'; pattern++, servername++) {
+    if (*pattern == '*') {
+      for (const char* end = servername;; end++) {
+        if (MatchesServername(pattern + 1, end))
+          return true;
+        if (*end == '\0' || *end == '.')
+          return false;
+      }
+    }
+    if (*servername != *pattern)
+      return false;
+  }
+  return *servername == '\0';
+}
+
+
+// Adds a context that TLSWrap::SelectSNIContextCallback() selects for the
+// servernames that match `servername`, with the same wildcards as
+// server.addContext(). Returns false, without adding it, for names that
+// can not be matched natively in the same way as the regular expression that
+// server.addContext() uses.
+void SecureContext::AddSNIContext(const FunctionCallbackInfo<Value>& args) {
+  SecureContext* sc;
+  ASSIGN_OR_RETURN_UNWRAP(&sc, args.Holder());
+  Environment* env = sc->env();
+
+  CHECK(args[0]->IsString());
+  CHECK(env->secure_context_constructor_template()->HasInstance(args[1]));
+  SecureContext* context;
+  ASSIGN_OR_RETURN_UNWRAP(&context, args[1].As<Object>());
+
+  node::Utf8Value servername_value(env->isolate(), args[0]);
+  std::string servername = servername_value.ToString();
+  for (const char c : servername) {
+    if (c < 0x21 || c > 0x7e || c == '(' || c == ')' || c == '|')
+      return args.GetReturnValue().Set(false);
+  }
+
+  SNIContext entry { sc->sni_count_++, BaseObjectPtr<SecureContext>(context) };
+  const size_t wildcard = servername.find('*');
+  if (wildcard == std::string::npos) {
+    sc->sni_names_.emplace(servername, std::move(entry));
+  } else if (wildcard == 0 && servername.size() > 1 && servername[1] == '.' &&
+             servername.find('*', 1) == std::string::npos) {
+    sc->sni_suffixes_.emplace(servername.substr(1), std::move(entry));
+  } else {
+    sc->sni_patterns_.emplace_back(servername, std::move(entry));
+  }
+  args.GetReturnValue().Set(true);
+}
+
+
+SecureContext* SecureContext::FindSNIContext(const char* servername) const {
+  const SNIContext* found = nullptr;
+  const std::string name(servername);
+  auto it = sni_names_.find(name);
+  if (it != sni_names_.end())
+    found = &it->second;
+
+  const size_t dot = name.find('.');
+  if (dot != std::string::npos) {
+    it = sni_suffixes_.find(name.substr(dot));
+    if (it != sni_suffixes_.end() &&
+        (found == nullptr || it->second.index < found->index)) {
+      found = &it->second;
+    }
+  }
+
+  for (const auto& pattern : sni_patterns_) {
+    if (found != nullptr && pattern.second.index > found->index)
+      break;
+    if (MatchesServername(pattern.first.c_str(), servername)) {
+      found = &pattern.second;
+      break;
+    }
+  }
+
+  return found == nullptr ? nullptr : found->context.get();
+}
+
+
+void SecureContext::SessionCacheRemoveCallback(SSL_CTX* ctx,
+                                               SSL_SESSION* sess) {
+  SecureContext* sc = static_cast<SecureContext*>(SSL_CTX_get_app_data(ctx));
+  if (sc == nullptr || !sc->session_cache_)
+    return;
+
+  unsigned int id_length;
+  const unsigned char* id = SSL_SESSION_get_id(sess, &id_length);
+  sc->session_cache_->Remove(id, id_length);
+}
+
+
 void SecureContext::Close(const FunctionCallbackInfo<Value>& args) {
   SecureContext* sc;
   ASSIGN_OR_RETURN_UNWRAP(&sc, args.Holder());
@@ -1461,6 +1852,7 @@ void SecureContext::LoadPKCS12(const FunctionCallbackInfo<Value>& args) {
         SSL_CTX_set_cert_store(sc->ctx_.get(), cert_store);
       }
       X509_STORE_add_cert(cert_store, ca);
+      verified_chain_cache.InvalidateStore(cert_store);
       SSL_CTX_add_client_CA(sc->ctx_.get(), ca);
     }
     ret = true;
@@ -1780,6 +2172,9 @@ SSL_SESSION* SSLWrap<Base>::GetSessionCallback(SSL* s,
   Base* w = static_cast<Base*>(SSL_get_app_data(s));
 
   *copy = 0;
+  // A session loaded from the 'resumeSession' event takes precedence.
+  if (!w->next_sess_ && w->session_cache_)
+    return w->session_cache_->Lookup(key, len);
   return w->next_sess_.release();
 }
 
@@ -1791,6 +2186,9 @@ int SSLWrap<Base>::NewSessionCallback(SSL* s, SSL_SESSION* sess) {
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
 
+  if (w->is_server() && w->session_cache_)
+    w->session_cache_->Insert(sess, SecureContext::kMaxSessionSize);
+
   if (!w->session_callbacks_)
     return 0;
 
@@ -2586,9 +2984,10 @@ void SSLWrap<Base>::SetMaxSendFragment(
   Base* w;
   ASSIGN_OR_RETURN_UNWRAP(&w, args.Holder());
 
-  int rv = SSL_set_max_send_fragment(
-      w->ssl_.get(),
-      args[0]->Int32Value(w->ssl_env()->context()).FromJust());
+  const int size = args[0]->Int32Value(w->ssl_env()->context()).FromJust();
+  int rv = SSL_set_max_send_fragment(w->ssl_.get(), size);
+  if (rv == 1)
+    w->max_send_fragment_ = size;
   args.GetReturnValue().Set(rv);
 }
 #endif  // SSL_set_max_send_fragment
@@ -2895,8 +3294,22 @@ int SSLWrap<Base>::TLSExtStatusCallback(SSL* s, void* arg) {
     return 1;
   } else {
     // Outgoing response
-    if (w->ocsp_response_.IsEmpty())
-      return SSL_TLSEXT_ERR_NOACK;
+    if (w->ocsp_response_.IsEmpty()) {
+      // Without a response from an 'OCSPRequest' listener, staple the one of
+      // the context, as long as it is current.
+      SecureContext* sc = static_cast<SecureContext*>(
+          SSL_CTX_get_app_data(SSL_get_SSL_CTX(s)));
+      if (sc == nullptr || sc->ocsp_response_.empty() ||
+          uv_hrtime() >= sc->ocsp_response_expiry_) {
+        return SSL_TLSEXT_ERR_NOACK;
+      }
+      const size_t len = sc->ocsp_response_.size();
+      unsigned char* data = MallocOpenSSL<unsigned char>(len);
+      memcpy(data, sc->ocsp_response_.data(), len);
+      if (!SSL_set_tlsext_status_ocsp_resp(s, data, len))
+        OPENSSL_free(data);
+      return SSL_TLSEXT_ERR_OK;
+    }
 
     Local<ArrayBufferView> obj = PersistentToLocal::Default(env->isolate(),
                                                             w->ocsp_response_);
@@ -3558,6 +3971,80 @@ static NonCopyableMaybe<PrivateKeyEncodingConfig> GetPrivateKeyEncodingFromJs(
   return NonCopyableMaybe<PrivateKeyEncodingConfig>(std::move(result));
 }
 
+// Parsing a key, in particular an RSA key, takes tens of microseconds, and
+// many callers pass the same PEM or DER key to sign(), verify(),
+// publicEncrypt() etc. over and over instead of creating a KeyObject once.
+// Keys that were parsed successfully are therefore kept in a small
+// process-wide LRU cache. Entries are looked up by a SHA-256 digest of the
+// input and of everything that influences how it is parsed, including the
+// passphrase, so the cache never holds the inputs themselves.
+class ParsedKeyCache {
+ public:
+  static constexpr size_t kMaxEntries = 128;
+
+  enum Kind : char {
+    kPrivate = 'P',
+    kPublicOrPrivate = 'p'
+  };
+
+  // Returns an empty string if the digest could not be computed, in which
+  // case the key is parsed without the cache.
+  static std::string MakeKey(Kind kind,
+                             const PrivateKeyEncodingConfig& config,
+                             const ByteSource& data) {
+    const int type = config.type_.IsJust() ? config.type_.FromJust() : -1;
+    const int header[] = { kind, config.format_, type };
+    const size_t passphrase_size = config.passphrase_.size();
+
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int md_len;
+    EVPMDPointer mdctx(EVP_MD_CTX_new());
+    if (!mdctx ||
+        EVP_DigestInit_ex(mdctx.get(), EVP_sha256(), nullptr) != 1 ||
+        EVP_DigestUpdate(mdctx.get(), header, sizeof(header)) != 1 ||
+        EVP_DigestUpdate(mdctx.get(), &passphrase_size,
+                         sizeof(passphrase_size)) != 1 ||
+        EVP_DigestUpdate(mdctx.get(), config.passphrase_.get(),
+                         passphrase_size) != 1 ||
+        EVP_DigestUpdate(mdctx.get(), data.get(), data.size()) != 1 ||
+        EVP_DigestFinal_ex(mdctx.get(), md, &md_len) != 1) {
+      return std::string();
+    }
+    return std::string(reinterpret_cast<const char*>(md), md_len);
+  }
+
+  ManagedEVPPKey Get(const std::string& key) {
+    Mutex::ScopedLock lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end())
+      return ManagedEVPPKey();
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+  }
+
+  void Put(const std::string& key, const ManagedEVPPKey& pkey) {
+    Mutex::ScopedLock lock(mutex_);
+    if (index_.find(key) != index_.end())
+      return;
+    lru_.emplace_front(key, pkey);
+    index_.emplace(key, lru_.begin());
+    if (lru_.size() > kMaxEntries) {
+      index_.erase(lru_.back().first);
+      lru_.pop_back();
+    }
+  }
+
+ private:
+  typedef std::pair<std::string, ManagedEVPPKey> Entry;
+
+  Mutex mutex_;
+  // Most recently used entry first.
+  std::list<Entry> lru_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+static ParsedKeyCache parsed_key_cache;
+
 static ManagedEVPPKey GetPrivateKeyFromJs(
     const FunctionCallbackInfo<Value>& args,
     unsigned int* offset,
@@ -3565,16 +4052,28 @@ static ManagedEVPPKey GetPrivateKeyFromJs(
   if (args[*offset]->IsString() || Buffer::HasInstance(args[*offset])) {
     Environment* env = Environment::GetCurrent(args);
     ByteSource key = ByteSource::FromStringOrBuffer(env, args[(*offset)++]);
-    NonCopyableMaybe<PrivateKeyEncodingConfig> config =
+    NonCopyableMaybe<PrivateKeyEncodingConfig> config_ =
         GetPrivateKeyEncodingFromJs(args, offset, kKeyContextInput);
-    if (config.IsEmpty())
+    if (config_.IsEmpty())
       return ManagedEVPPKey();
 
+    PrivateKeyEncodingConfig config = config_.Release();
+    const std::string cache_key =
+        ParsedKeyCache::MakeKey(ParsedKeyCache::kPrivate, config, key);
+    if (!cache_key.empty()) {
+      ManagedEVPPKey cached = parsed_key_cache.Get(cache_key);
+      if (cached)
+        return cached;
+    }
+
     EVPKeyPointer pkey;
     ParseKeyResult ret =
-        ParsePrivateKey(&pkey, config.Release(), key.get(), key.size());
-    return GetParsedKey(env, std::move(pkey), ret,
-                        "Failed to read private key");
+        ParsePrivateKey(&pkey, config, key.get(), key.size());
+    ManagedEVPPKey result = GetParsedKey(env, std::move(pkey), ret,
+                                         "Failed to read private key");
+    if (result && !cache_key.empty())
+      parsed_key_cache.Put(cache_key, result);
+    return result;
   } else {
     CHECK(args[*offset]->IsObject() && allow_key_object);
     KeyObject* key;
@@ -3596,8 +4095,16 @@ static ManagedEVPPKey GetPublicOrPrivateKeyFromJs(
     if (config_.IsEmpty())
       return ManagedEVPPKey();
 
-    ParseKeyResult ret;
     PrivateKeyEncodingConfig config = config_.Release();
+    const std::string cache_key =
+        ParsedKeyCache::MakeKey(ParsedKeyCache::kPublicOrPrivate, config, data);
+    if (!cache_key.empty()) {
+      ManagedEVPPKey cached = parsed_key_cache.Get(cache_key);
+      if (cached)
+        return cached;
+    }
+
+    ParseKeyResult ret;
     EVPKeyPointer pkey;
     if (config.format_ == kKeyFormatPEM) {
       // For PEM, we can easily determine whether it is a public or private key
@@ -3633,8 +4140,11 @@ static ManagedEVPPKey GetPublicOrPrivateKeyFromJs(
       }
     }
 
-    return GetParsedKey(env, std::move(pkey), ret,
-                        "Failed to read asymmetric key");
+    ManagedEVPPKey result = GetParsedKey(env, std::move(pkey), ret,
+                                         "Failed to read asymmetric key");
+    if (result && !cache_key.empty())
+      parsed_key_cache.Put(cache_key, result);
+    return result;
   } else {
     CHECK(args[*offset]->IsObject());
     KeyObject* key = Unwrap<KeyObject>(args[*offset].As<Object>());
@@ -3757,6 +4267,10 @@ Local<Function> KeyObject::Initialize(Environment* env, Local<Object> target) {
   env->SetProtoMethodNoSideEffect(t, "getAsymmetricKeyType",
                                   GetAsymmetricKeyType);
   env->SetProtoMethod(t, "export", Export);
+  env->SetProtoMethod(t, "aeadSeal", AeadSeal);
+  env->SetProtoMethod(t, "aeadOpen", AeadOpen);
+  env->SetProtoMethod(t, "aeadSealBatch", AeadSealBatch);
+  env->SetProtoMethod(t, "aeadOpenBatch", AeadOpenBatch);
 
   auto function = t->GetFunction(env->context()).ToLocalChecked();
   target->Set(env->context(),
@@ -3967,6 +4481,7 @@ void CipherBase::Initialize(Environment* env, Local<Object> target) {
   env->SetProtoMethod(t, "init", Init);
   env->SetProtoMethod(t, "initiv", InitIv);
   env->SetProtoMethod(t, "update", Update);
+  env->SetProtoMethod(t, "updateAsync", UpdateAsync);
   env->SetProtoMethod(t, "final", Final);
   env->SetProtoMethod(t, "setAutoPadding", SetAutoPadding);
   env->SetProtoMethodNoSideEffect(t, "getAuthTag", GetAuthTag);
@@ -4581,43 +5096,292 @@ void CipherBase::Final(const FunctionCallbackInfo<Value>& args) {
 }
 
 
-void Hmac::Initialize(Environment* env, Local<Object> target) {
-  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+// The one-shot AEAD functions keep one EVP_CIPHER_CTX per cipher on the
+// KeyObject. The context is initialized with the key once, which performs the
+// key expansion, and each call only resets the IV, so that encrypting a small
+// record takes a single call into C++ and no allocations besides the output.
+EVP_CIPHER_CTX* KeyObject::GetAeadContext(Local<Value> cipher_name,
+                                          unsigned int auth_tag_len) {
+  CHECK_EQ(key_type_, kKeyTypeSecret);
 
-  t->InstanceTemplate()->SetInternalFieldCount(1);
+  const node::Utf8Value cipher_type(env()->isolate(), cipher_name);
+  const EVP_CIPHER* const cipher = EVP_get_cipherbyname(*cipher_type);
+  const int nid = cipher != nullptr ? EVP_CIPHER_nid(cipher) : NID_undef;
+  bool valid_tag_len;
+  switch (nid) {
+    case NID_aes_128_gcm:
+    case NID_aes_192_gcm:
+    case NID_aes_256_gcm:
+      valid_tag_len = IsValidGCMTagLength(auth_tag_len);
+      break;
+    case NID_chacha20_poly1305:
+      valid_tag_len = auth_tag_len >= 1 && auth_tag_len <= 16;
+      break;
+    default:
+      THROW_ERR_CRYPTO_UNKNOWN_CIPHER(env());
+      return nullptr;
+  }
+  if (!valid_tag_len) {
+    char msg[50];
+    snprintf(msg, sizeof(msg),
+        "Invalid authentication tag length: %u", auth_tag_len);
+    env()->ThrowError(msg);
+    return nullptr;
+  }
 
-  env->SetProtoMethod(t, "init", HmacInit);
-  env->SetProtoMethod(t, "update", HmacUpdate);
-  env->SetProtoMethod(t, "digest", HmacDigest);
+  auto it = aead_contexts_.find(nid);
+  if (it != aead_contexts_.end())
+    return it->second.get();
 
-  target->Set(env->context(),
-              FIXED_ONE_BYTE_STRING(env->isolate(), "Hmac"),
-              t->GetFunction(env->context()).ToLocalChecked()).Check();
-}
+  if (static_cast<size_t>(EVP_CIPHER_key_length(cipher)) !=
+          symmetric_key_len_) {
+    env()->ThrowError("Invalid key length");
+    return nullptr;
+  }
 
+  DeleteFnPtr<EVP_CIPHER_CTX, EVP_CIPHER_CTX_free> ctx(EVP_CIPHER_CTX_new());
+  if (!ctx ||
+      !EVP_CipherInit_ex(ctx.get(), cipher, nullptr,
+                         reinterpret_cast<unsigned char*>(
+                             symmetric_key_.get()),
+                         nullptr, 1)) {
+    ThrowCryptoError(env(), ERR_get_error(), "Failed to initialize cipher");
+    return nullptr;
+  }
 
-void Hmac::New(const FunctionCallbackInfo<Value>& args) {
-  Environment* env = Environment::GetCurrent(args);
-  new Hmac(env, args.This());
+  EVP_CIPHER_CTX* const result = ctx.get();
+  aead_contexts_.emplace(nid, std::move(ctx));
+  return result;
 }
 
-
-void Hmac::HmacInit(const char* hash_type, const char* key, int key_len) {
-  HandleScope scope(env()->isolate());
-
-  const EVP_MD* md = EVP_get_digestbyname(hash_type);
-  if (md == nullptr) {
-    return env()->ThrowError("Unknown message digest");
-  }
-  if (key_len == 0) {
-    key = "";
+static bool IsValidAeadIvLength(EVP_CIPHER_CTX* ctx, size_t iv_len) {
+  if (EVP_CIPHER_CTX_nid(ctx) == NID_chacha20_poly1305)
+    return iv_len >= 1 && iv_len <= 12;
+  return iv_len >= 1 && iv_len <= INT_MAX;
+}
+
+// Encrypts |in| and appends the authentication tag, or checks and removes the
+// tag at the end of |in| and decrypts the rest. Returns false on internal
+// errors and if authentication fails.
+static bool AeadCrypt(Environment* env,
+                      EVP_CIPHER_CTX* ctx,
+                      bool encrypt,
+                      const ArrayBufferViewContents<unsigned char>& iv,
+                      const ArrayBufferViewContents<unsigned char>& aad,
+                      const ArrayBufferViewContents<unsigned char>& in,
+                      unsigned int auth_tag_len,
+                      AllocatedBuffer* out) {
+  size_t in_len = in.length();
+  if (!encrypt) {
+    if (in_len < auth_tag_len)
+      return false;
+    in_len -= auth_tag_len;
   }
-  ctx_.reset(HMAC_CTX_new());
-  if (!ctx_ || !HMAC_Init_ex(ctx_.get(), key, key_len, md, nullptr)) {
-    ctx_.reset();
-    return ThrowCryptoError(env(), ERR_get_error());
+  if (in_len > INT_MAX || aad.length() > INT_MAX) {
+    return false;
   }
-}
+
+  if (!EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_IVLEN, iv.length(),
+                           nullptr) ||
+      !EVP_CipherInit_ex(ctx, nullptr, nullptr, nullptr, iv.data(),
+                         encrypt ? 1 : 0)) {
+    return false;
+  }
+
+  if (!encrypt &&
+      !EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, auth_tag_len,
+                           const_cast<unsigned char*>(in.data() + in_len))) {
+    return false;
+  }
+
+  int len;
+  if (aad.length() > 0 &&
+      !EVP_CipherUpdate(ctx, nullptr, &len, aad.data(), aad.length())) {
+    return false;
+  }
+
+  *out = env->AllocateManaged(encrypt ? in_len + auth_tag_len : in_len);
+  unsigned char* data = reinterpret_cast<unsigned char*>(out->data());
+  len = 0;
+  if (in_len > 0 && !EVP_CipherUpdate(ctx, data, &len, in.data(), in_len))
+    return false;
+  CHECK_EQ(static_cast<size_t>(len), in_len);
+
+  // Neither GCM nor ChaCha20-Poly1305 buffer any data, Final() only computes
+  // or verifies the authentication tag.
+  int final_len;
+  if (!EVP_CipherFinal_ex(ctx, data + len, &final_len))
+    return false;
+  CHECK_EQ(final_len, 0);
+
+  return !encrypt ||
+         EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, auth_tag_len,
+                             data + in_len) == 1;
+}
+
+void KeyObject::AeadOneShot(const FunctionCallbackInfo<Value>& args,
+                            bool encrypt) {
+  Environment* env = Environment::GetCurrent(args);
+  KeyObject* key;
+  ASSIGN_OR_RETURN_UNWRAP(&key, args.Holder());
+  MarkPopErrorOnReturn mark_pop_error_on_return;
+
+  // cipher, iv, data, aad, authTagLength
+  CHECK_EQ(args.Length(), 5);
+  CHECK(args[1]->IsArrayBufferView());
+  CHECK(args[2]->IsArrayBufferView());
+  CHECK(args[3]->IsArrayBufferView());
+  CHECK(args[4]->IsUint32());
+
+  const unsigned int auth_tag_len = args[4].As<Uint32>()->Value();
+  EVP_CIPHER_CTX* ctx = key->GetAeadContext(args[0], auth_tag_len);
+  if (ctx == nullptr)
+    return;
+
+  ArrayBufferViewContents<unsigned char> iv(args[1]);
+  ArrayBufferViewContents<unsigned char> in(args[2]);
+  ArrayBufferViewContents<unsigned char> aad(args[3]);
+  if (!IsValidAeadIvLength(ctx, iv.length()))
+    return env->ThrowError("Invalid IV length");
+
+  AllocatedBuffer out;
+  if (!AeadCrypt(env, ctx, encrypt, iv, aad, in, auth_tag_len, &out)) {
+    return ThrowCryptoError(env, ERR_get_error(), encrypt ?
+        "Unsupported state" :
+        "Unsupported state or unable to authenticate data");
+  }
+
+  args.GetReturnValue().Set(out.ToBuffer().ToLocalChecked());
+}
+
+// Same as AeadOneShot(), but for arrays of IVs, inputs and optional AADs.
+// When opening, records that fail to authenticate result in null entries
+// instead of an exception, so that one bad record does not discard the
+// whole batch.
+void KeyObject::AeadBatch(const FunctionCallbackInfo<Value>& args,
+                          bool encrypt) {
+  Environment* env = Environment::GetCurrent(args);
+  KeyObject* key;
+  ASSIGN_OR_RETURN_UNWRAP(&key, args.Holder());
+  MarkPopErrorOnReturn mark_pop_error_on_return;
+
+  // cipher, ivs, inputs, aads, authTagLength
+  CHECK_EQ(args.Length(), 5);
+  CHECK(args[1]->IsArray());
+  CHECK(args[2]->IsArray());
+  CHECK(args[3]->IsArray() || args[3]->IsUndefined());
+  CHECK(args[4]->IsUint32());
+
+  Local<Array> ivs = args[1].As<Array>();
+  Local<Array> inputs = args[2].As<Array>();
+  const uint32_t count = inputs->Length();
+  CHECK_EQ(ivs->Length(), count);
+  Local<Array> aads;
+  if (args[3]->IsArray()) {
+    aads = args[3].As<Array>();
+    CHECK_EQ(aads->Length(), count);
+  }
+
+  const unsigned int auth_tag_len = args[4].As<Uint32>()->Value();
+  EVP_CIPHER_CTX* ctx = key->GetAeadContext(args[0], auth_tag_len);
+  if (ctx == nullptr)
+    return;
+
+  Local<Context> context = env->context();
+  std::vector<Local<Value>> results(count);
+  for (uint32_t i = 0; i < count; i++) {
+    Local<Value> iv_value;
+    Local<Value> in_value;
+    Local<Value> aad_value;
+    if (!ivs->Get(context, i).ToLocal(&iv_value) ||
+        !inputs->Get(context, i).ToLocal(&in_value) ||
+        (!aads.IsEmpty() && !aads->Get(context, i).ToLocal(&aad_value))) {
+      return;
+    }
+    CHECK(iv_value->IsArrayBufferView());
+    CHECK(in_value->IsArrayBufferView());
+
+    ArrayBufferViewContents<unsigned char> iv(iv_value);
+    ArrayBufferViewContents<unsigned char> in(in_value);
+    if (!IsValidAeadIvLength(ctx, iv.length()))
+      return env->ThrowError("Invalid IV length");
+    ArrayBufferViewContents<unsigned char> aad;
+    if (!aad_value.IsEmpty() && !aad_value->IsUndefined()) {
+      CHECK(aad_value->IsArrayBufferView());
+      aad.Read(aad_value.As<ArrayBufferView>());
+    }
+
+    AllocatedBuffer out;
+    if (AeadCrypt(env, ctx, encrypt, iv, aad, in, auth_tag_len, &out)) {
+      if (!out.ToBuffer().ToLocal(&results[i]))
+        return;
+    } else if (encrypt) {
+      return ThrowCryptoError(env, ERR_get_error(), "Unsupported state");
+    } else {
+      ERR_clear_error();
+      results[i] = Null(env->isolate());
+    }
+  }
+
+  args.GetReturnValue().Set(
+      Array::New(env->isolate(), results.data(), results.size()));
+}
+
+void KeyObject::AeadSeal(const FunctionCallbackInfo<Value>& args) {
+  AeadOneShot(args, true);
+}
+
+void KeyObject::AeadOpen(const FunctionCallbackInfo<Value>& args) {
+  AeadOneShot(args, false);
+}
+
+void KeyObject::AeadSealBatch(const FunctionCallbackInfo<Value>& args) {
+  AeadBatch(args, true);
+}
+
+void KeyObject::AeadOpenBatch(const FunctionCallbackInfo<Value>& args) {
+  AeadBatch(args, false);
+}
+
+
+void Hmac::Initialize(Environment* env, Local<Object> target) {
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+
+  env->SetProtoMethod(t, "init", HmacInit);
+  env->SetProtoMethod(t, "update", HmacUpdate);
+  env->SetProtoMethod(t, "updateAsync", HmacUpdateAsync);
+  env->SetProtoMethod(t, "digest", HmacDigest);
+
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "Hmac"),
+              t->GetFunction(env->context()).ToLocalChecked()).Check();
+}
+
+
+void Hmac::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  new Hmac(env, args.This());
+}
+
+
+void Hmac::HmacInit(const char* hash_type, const char* key, int key_len) {
+  HandleScope scope(env()->isolate());
+
+  const EVP_MD* md = EVP_get_digestbyname(hash_type);
+  if (md == nullptr) {
+    return env()->ThrowError("Unknown message digest");
+  }
+  if (key_len == 0) {
+    key = "";
+  }
+  ctx_.reset(HMAC_CTX_new());
+  if (!ctx_ || !HMAC_Init_ex(ctx_.get(), key, key_len, md, nullptr)) {
+    ctx_.reset();
+    return ThrowCryptoError(env(), ERR_get_error());
+  }
+}
 
 
 void Hmac::HmacInit(const FunctionCallbackInfo<Value>& args) {
@@ -4706,6 +5470,7 @@ void Hash::Initialize(Environment* env, Local<Object> target) {
   t->InstanceTemplate()->SetInternalFieldCount(1);
 
   env->SetProtoMethod(t, "update", HashUpdate);
+  env->SetProtoMethod(t, "updateAsync", HashUpdateAsync);
   env->SetProtoMethod(t, "digest", HashDigest);
 
   target->Set(env->context(),
@@ -6198,7 +6963,12 @@ bool ECDH::IsKeyPairValid() {
 // this object. This makes proper reporting of memory usage impossible.
 struct CryptoJob : public ThreadPoolWork {
   std::unique_ptr<AsyncWrap> async_wrap;
-  inline explicit CryptoJob(Environment* env) : ThreadPoolWork(env) {}
+  inline explicit CryptoJob(
+      Environment* env,
+      performance::ThreadPoolWorkKind kind =
+          performance::NODE_THREADPOOL_WORK_KIND_CRYPTO)
+      : ThreadPoolWork(env, kind) {
+  }
   inline void AfterThreadPoolWork(int status) final;
   virtual void AfterThreadPoolWork() = 0;
   static inline void Run(std::unique_ptr<CryptoJob> job, Local<Value> wrap);
@@ -6234,6 +7004,403 @@ inline void CopyBuffer(Local<Value> buf, std::vector<char>* vec) {
 }
 
 
+// The updateAsync(data, wrap) methods of Hash, Hmac and CipherBase feed |data|
+// to the context on the threadpool and call wrap.ondone(err[, output]) when
+// done. |data| must be retained by the wrap object. They return false, without
+// scheduling anything, if the update has to be made synchronously instead.
+// The job keeps the context alive until it has finished.
+struct Hash::UpdateJob : public CryptoJob {
+  BaseObjectPtr<Hash> hash;
+  const char* data;
+  size_t size;
+
+  inline UpdateJob(Environment* env, Hash* hash)
+      : CryptoJob(env), hash(hash) {}
+
+  inline void DoThreadPoolWork() override {
+    EVP_DigestUpdate(hash->mdctx_.get(), data, size);
+  }
+
+  inline void AfterThreadPoolWork() override {
+    hash->async_update_pending_ = false;
+    Local<Value> arg = Null(env()->isolate());
+    async_wrap->MakeCallback(env()->ondone_string(), 1, &arg);
+  }
+};
+
+
+void Hash::HashUpdateAsync(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Hash* hash;
+  ASSIGN_OR_RETURN_UNWRAP(&hash, args.Holder());
+  CHECK(args[0]->IsArrayBufferView());  // data; wrap object retains ref.
+  CHECK(args[1]->IsObject());  // wrap object
+  CHECK(!hash->async_update_pending_);
+
+  if (!hash->mdctx_)
+    return args.GetReturnValue().Set(false);
+
+  std::unique_ptr<UpdateJob> job(new UpdateJob(env, hash));
+  job->data = Buffer::Data(args[0]);
+  job->size = Buffer::Length(args[0]);
+  hash->async_update_pending_ = true;
+  UpdateJob::Run(std::move(job), args[1]);
+  args.GetReturnValue().Set(true);
+}
+
+
+struct Hmac::UpdateJob : public CryptoJob {
+  BaseObjectPtr<Hmac> hmac;
+  const unsigned char* data;
+  size_t size;
+
+  inline UpdateJob(Environment* env, Hmac* hmac)
+      : CryptoJob(env), hmac(hmac) {}
+
+  inline void DoThreadPoolWork() override {
+    HMAC_Update(hmac->ctx_.get(), data, size);
+  }
+
+  inline void AfterThreadPoolWork() override {
+    hmac->async_update_pending_ = false;
+    Local<Value> arg = Null(env()->isolate());
+    async_wrap->MakeCallback(env()->ondone_string(), 1, &arg);
+  }
+};
+
+
+void Hmac::HmacUpdateAsync(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Hmac* hmac;
+  ASSIGN_OR_RETURN_UNWRAP(&hmac, args.Holder());
+  CHECK(args[0]->IsArrayBufferView());  // data; wrap object retains ref.
+  CHECK(args[1]->IsObject());  // wrap object
+  CHECK(!hmac->async_update_pending_);
+
+  if (!hmac->ctx_)
+    return args.GetReturnValue().Set(false);
+
+  std::unique_ptr<UpdateJob> job(new UpdateJob(env, hmac));
+  job->data = reinterpret_cast<const unsigned char*>(Buffer::Data(args[0]));
+  job->size = Buffer::Length(args[0]);
+  hmac->async_update_pending_ = true;
+  UpdateJob::Run(std::move(job), args[1]);
+  args.GetReturnValue().Set(true);
+}
+
+
+struct CipherBase::UpdateJob : public CryptoJob {
+  BaseObjectPtr<CipherBase> cipher;
+  const unsigned char* data;
+  int size;
+  AllocatedBuffer out;
+  int out_len = 0;
+  bool ok = false;
+  CryptoErrorVector errors;
+
+  inline UpdateJob(Environment* env, CipherBase* cipher)
+      : CryptoJob(env), cipher(cipher) {}
+
+  inline void DoThreadPoolWork() override {
+    out_len = out.size();
+    ok = EVP_CipherUpdate(cipher->ctx_.get(),
+                          reinterpret_cast<unsigned char*>(out.data()),
+                          &out_len,
+                          data,
+                          size) == 1;
+    if (!ok)
+      errors.Capture();
+  }
+
+  inline void AfterThreadPoolWork() override {
+    cipher->async_update_pending_ = false;
+    Local<Value> argv[] = {
+      Null(env()->isolate()),
+      Undefined(env()->isolate())
+    };
+    if (ok) {
+      CHECK_LE(static_cast<size_t>(out_len), out.size());
+      out.Resize(out_len);
+      argv[1] = out.ToBuffer().ToLocalChecked();
+    } else {
+      Local<String> message = FIXED_ONE_BYTE_STRING(
+          env()->isolate(), "Trying to add data in unsupported state");
+      argv[0] = errors.ToException(env(), message).ToLocalChecked();
+    }
+    async_wrap->MakeCallback(env()->ondone_string(), arraysize(argv), argv);
+  }
+};
+
+
+void CipherBase::UpdateAsync(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CipherBase* cipher;
+  ASSIGN_OR_RETURN_UNWRAP(&cipher, args.Holder());
+  CHECK(args[0]->IsArrayBufferView());  // data; wrap object retains ref.
+  CHECK(args[1]->IsObject());  // wrap object
+  CHECK(!cipher->async_update_pending_);
+
+  if (!cipher->ctx_)
+    return args.GetReturnValue().Set(false);
+  MarkPopErrorOnReturn mark_pop_error_on_return;
+
+  // CCM messages are limited in length and are usually passed in a single
+  // update, and the output size for key wrapping is only known to OpenSSL;
+  // leave both to the synchronous path.
+  EVP_CIPHER_CTX* ctx = cipher->ctx_.get();
+  const int mode = EVP_CIPHER_CTX_mode(ctx);
+  const size_t len = Buffer::Length(args[0]);
+  const int block_size = EVP_CIPHER_CTX_block_size(ctx);
+  if (mode == EVP_CIPH_CCM_MODE || mode == EVP_CIPH_WRAP_MODE ||
+      len > static_cast<size_t>(INT_MAX - block_size)) {
+    return args.GetReturnValue().Set(false);
+  }
+
+  if (cipher->kind_ == kDecipher && cipher->IsAuthenticatedMode()) {
+    CHECK(cipher->MaybePassAuthTagToOpenSSL());
+  }
+
+  std::unique_ptr<UpdateJob> job(new UpdateJob(env, cipher));
+  job->data = reinterpret_cast<const unsigned char*>(Buffer::Data(args[0]));
+  job->size = static_cast<int>(len);
+  job->out = env->AllocateManaged(len + block_size);
+  cipher->async_update_pending_ = true;
+  UpdateJob::Run(std::move(job), args[1]);
+  args.GetReturnValue().Set(true);
+}
+
+
+// Parses the CA certificates, certificate chains and private keys that would
+// otherwise be parsed on the main thread by addCACert(), setCert() and
+// setKey(). Parsing is the expensive part, so only that happens on the
+// threadpool. The results are added to the SSL_CTX on the main thread, in the
+// same order as the synchronous methods would add them.
+struct SecureContextLoadJob : public CryptoJob {
+  struct KeyInput {
+    std::vector<char> pem;
+    // NUL-terminated, for PasswordCallback.
+    std::vector<char> passphrase;
+  };
+
+  struct CertificateChain {
+    X509Pointer cert;
+    StackOfX509 extra_certs;
+  };
+
+  BaseObjectPtr<SecureContext> sc;
+  std::vector<std::vector<char>> ca_pems;
+  std::vector<std::vector<char>> cert_pems;
+  std::vector<KeyInput> key_inputs;
+
+  std::vector<X509Pointer> ca_certs;
+  std::vector<CertificateChain> chains;
+  std::vector<EVPKeyPointer> keys;
+
+  bool ok = false;
+  unsigned long err = 0;  // NOLINT(runtime/int)
+  const char* err_message = nullptr;
+  CryptoErrorVector errors;
+
+  inline explicit SecureContextLoadJob(Environment* env) : CryptoJob(env) {}
+
+  inline ~SecureContextLoadJob() override {
+    Cleanse();
+  }
+
+  inline void DoThreadPoolWork() override {
+    ERR_clear_error();
+    ok = Parse();
+    Cleanse();
+    if (!ok) {
+      err = ERR_get_error();
+      errors.Capture();
+    }
+    // Do not leave errors behind for the next job on this thread.
+    ERR_clear_error();
+  }
+
+  inline bool Parse() {
+    for (const std::vector<char>& pem : ca_pems) {
+      BIOPointer bio(BIO_new_mem_buf(pem.data(), pem.size()));
+      if (!bio)
+        return false;
+      while (X509* x509 = PEM_read_bio_X509_AUX(
+          bio.get(), nullptr, NoPasswordCallback, nullptr)) {
+        ca_certs.emplace_back(x509);
+      }
+    }
+    // Like addCACert(), ignore the error for the missing next PEM block.
+    ERR_clear_error();
+
+    for (const std::vector<char>& pem : cert_pems) {
+      BIOPointer bio(BIO_new_mem_buf(pem.data(), pem.size()));
+      if (!bio)
+        return false;
+      CertificateChain chain;
+      if (!ReadCertificateChain(std::move(bio),
+                                &chain.cert,
+                                &chain.extra_certs)) {
+        err_message = "SSL_CTX_use_certificate_chain";
+        return false;
+      }
+      chains.push_back(std::move(chain));
+    }
+
+    for (KeyInput& input : key_inputs) {
+      BIOPointer bio(BIO_new_mem_buf(input.pem.data(), input.pem.size()));
+      if (!bio)
+        return false;
+      EVPKeyPointer key(
+          PEM_read_bio_PrivateKey(bio.get(),
+                                  nullptr,
+                                  PasswordCallback,
+                                  input.passphrase.empty() ?
+                                      nullptr : input.passphrase.data()));
+      if (!key) {
+        err_message = "PEM_read_bio_PrivateKey";
+        return false;
+      }
+      keys.push_back(std::move(key));
+    }
+
+    return true;
+  }
+
+  inline bool Apply() {
+    SSL_CTX* ctx = sc->ctx_.get();
+    CHECK_NOT_NULL(ctx);
+
+    for (X509Pointer& x509 : ca_certs)
+      AddCACertToContext(sc.get(), x509.get());
+
+    for (CertificateChain& chain : chains) {
+      sc->cert_.reset();
+      sc->issuer_.reset();
+      if (!SSL_CTX_use_certificate_chain(ctx,
+                                         std::move(chain.cert),
+                                         chain.extra_certs.get(),
+                                         &sc->cert_,
+                                         &sc->issuer_)) {
+        err_message = "SSL_CTX_use_certificate_chain";
+        return false;
+      }
+    }
+
+    for (EVPKeyPointer& key : keys) {
+      if (!SSL_CTX_use_PrivateKey(ctx, key.get())) {
+        err_message = "SSL_CTX_use_PrivateKey";
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  inline void AfterThreadPoolWork() override {
+    Local<Value> arg = ToResult();
+    async_wrap->MakeCallback(env()->ondone_string(), 1, &arg);
+  }
+
+  inline Local<Value> ToResult() {
+    if (ok) {
+      ERR_clear_error();
+      ok = Apply();
+      if (ok) {
+        ERR_clear_error();
+        return Undefined(env()->isolate());
+      }
+      err = ERR_get_error();
+      errors.Capture();
+    }
+
+    Local<Value> exception;
+    if (!CryptoErrorToException(env(), err, errors, err_message)
+             .ToLocal(&exception)) {
+      return Undefined(env()->isolate());
+    }
+    return exception;
+  }
+
+  inline void Cleanse() {
+    for (KeyInput& input : key_inputs) {
+      OPENSSL_cleanse(input.pem.data(), input.pem.size());
+      OPENSSL_cleanse(input.passphrase.data(), input.passphrase.size());
+    }
+    key_inputs.clear();
+  }
+};
+
+
+static void CopyPEM(Isolate* isolate,
+                    Local<Value> value,
+                    std::vector<char>* vec) {
+  if (value->IsString()) {
+    const node::Utf8Value pem(isolate, value);
+    vec->assign(*pem, *pem + pem.length());
+  } else {
+    CopyBuffer(value, vec);
+  }
+}
+
+
+void SecureContext::LoadCredentials(const FunctionCallbackInfo<Value>& args) {
+  SecureContext* sc;
+  ASSIGN_OR_RETURN_UNWRAP(&sc, args.Holder());
+  Environment* env = sc->env();
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+
+  CHECK(args[0]->IsArray());  // ca
+  CHECK(args[1]->IsArray());  // cert
+  CHECK(args[2]->IsArray());  // key
+  CHECK(args[3]->IsArray());  // passphrase, one per key
+  CHECK(args[4]->IsObject());  // wrap object
+
+  Local<Array> ca = args[0].As<Array>();
+  Local<Array> cert = args[1].As<Array>();
+  Local<Array> key = args[2].As<Array>();
+  Local<Array> passphrase = args[3].As<Array>();
+  CHECK_EQ(key->Length(), passphrase->Length());
+
+  std::unique_ptr<SecureContextLoadJob> job(new SecureContextLoadJob(env));
+  job->sc.reset(sc);
+
+  Local<Value> value;
+  for (uint32_t i = 0; i < ca->Length(); i++) {
+    if (!ca->Get(context, i).ToLocal(&value))
+      return;
+    job->ca_pems.emplace_back();
+    CopyPEM(isolate, value, &job->ca_pems.back());
+  }
+
+  for (uint32_t i = 0; i < cert->Length(); i++) {
+    if (!cert->Get(context, i).ToLocal(&value))
+      return;
+    job->cert_pems.emplace_back();
+    CopyPEM(isolate, value, &job->cert_pems.back());
+  }
+
+  for (uint32_t i = 0; i < key->Length(); i++) {
+    job->key_inputs.emplace_back();
+    SecureContextLoadJob::KeyInput& input = job->key_inputs.back();
+    if (!key->Get(context, i).ToLocal(&value))
+      return;
+    CopyPEM(isolate, value, &input.pem);
+    if (!passphrase->Get(context, i).ToLocal(&value))
+      return;
+    if (value->IsString()) {
+      const node::Utf8Value pass(isolate, value);
+      input.passphrase.assign(*pass, *pass + pass.length() + 1);
+    } else {
+      CHECK(value->IsUndefined());
+    }
+  }
+
+  SecureContextLoadJob::Run(std::move(job), args[4]);
+}
+
+
+
 struct RandomBytesJob : public CryptoJob {
   unsigned char* data;
   size_t size;
@@ -6291,7 +7458,8 @@ struct PBKDF2Job : public CryptoJob {
   Maybe<bool> success;
 
   inline explicit PBKDF2Job(Environment* env)
-      : CryptoJob(env), success(Nothing<bool>()) {}
+      : CryptoJob(env, performance::NODE_THREADPOOL_WORK_KIND_KDF),
+        success(Nothing<bool>()) {}
 
   inline ~PBKDF2Job() override {
     Cleanse();
@@ -6361,12 +7529,40 @@ struct ScryptJob : public CryptoJob {
   uint64_t maxmem;
   CryptoErrorVector errors;
 
-  inline explicit ScryptJob(Environment* env) : CryptoJob(env) {}
+  // Only used when the lanes run in parallel, see RunInParallel().
+  std::vector<unsigned char> blocks;
+  std::atomic<uint32_t> lane_groups_running{0};
+  std::atomic<bool> lanes_failed{false};
+  uint32_t lane_groups_pending = 0;
+  bool lanes_cancelled = false;
+
+  inline explicit ScryptJob(Environment* env)
+      : CryptoJob(env, performance::NODE_THREADPOOL_WORK_KIND_KDF) {}
 
   inline ~ScryptJob() override {
     Cleanse();
+    OPENSSL_cleanse(blocks.data(), blocks.size());
+  }
+
+  // EVP_PBE_scrypt() computes the p lanes one after the other, reusing the
+  // same scratch memory. Running them concurrently needs that memory once per
+  // concurrently running group of lanes, so the number of groups is limited
+  // by maxmem. Returns 1 if the lanes should not run in parallel.
+  inline uint32_t ParallelLaneGroups() const {
+    const uint64_t block_size = scrypt::BlockSize(r, p);
+    if (p < 2 || maxmem <= block_size)
+      return 1;
+    const uint64_t groups = (maxmem - block_size) / scrypt::LaneMemory(N, r);
+    return static_cast<uint32_t>(std::max<uint64_t>(
+        1, std::min<uint64_t>(groups, p)));
   }
 
+  static inline void RunInParallel(std::unique_ptr<ScryptJob> job,
+                                   Local<Value> wrap,
+                                   uint32_t groups);
+  inline void RunLanes(uint32_t first, uint32_t count);
+  inline void OnLaneGroupDone(int status);
+
   inline bool Validate() {
     if (1 == EVP_PBE_scrypt(nullptr, 0, nullptr, 0, N, r, p, maxmem,
                             nullptr, 0)) {
@@ -6405,6 +7601,100 @@ struct ScryptJob : public CryptoJob {
 };
 
 
+// Runs a consecutive range of the lanes of a ScryptJob on the threadpool.
+struct ScryptLaneGroup : public ThreadPoolWork {
+  ScryptJob* job;
+  uint32_t first;
+  uint32_t count;
+
+  inline ScryptLaneGroup(Environment* env,
+                         ScryptJob* job,
+                         uint32_t first,
+                         uint32_t count)
+      : ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_KIND_KDF),
+        job(job),
+        first(first),
+        count(count) {}
+
+  inline void DoThreadPoolWork() override {
+    job->RunLanes(first, count);
+  }
+
+  inline void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<ScryptLaneGroup> self(this);
+    job->OnLaneGroupDone(status);
+  }
+};
+
+
+// Derives B on the main thread, which takes a single PBKDF2 iteration, and
+// then runs each group of lanes as separate threadpool work. The group that
+// finishes last derives the key from B.
+void ScryptJob::RunInParallel(std::unique_ptr<ScryptJob> job,
+                              Local<Value> wrap,
+                              uint32_t groups) {
+  job->blocks.resize(scrypt::BlockSize(job->r, job->p));
+  auto salt_data = reinterpret_cast<const unsigned char*>(job->salt.data());
+  if (!PKCS5_PBKDF2_HMAC(job->pass.data(), job->pass.size(),
+                         salt_data, job->salt.size(), 1, EVP_sha256(),
+                         job->blocks.size(), job->blocks.data())) {
+    ERR_clear_error();
+    return Run(std::move(job), wrap);
+  }
+
+  CHECK(wrap->IsObject());
+  CHECK_NULL(job->async_wrap);
+  job->async_wrap.reset(Unwrap<AsyncWrap>(wrap.As<Object>()));
+  CHECK_EQ(false, job->async_wrap->persistent().IsWeak());
+
+  const uint32_t lanes_per_group = (job->p + groups - 1) / groups;
+  groups = (job->p + lanes_per_group - 1) / lanes_per_group;
+  job->lane_groups_running = groups;
+  job->lane_groups_pending = groups;
+  for (uint32_t first = 0; first < job->p; first += lanes_per_group) {
+    const uint32_t count = std::min(lanes_per_group, job->p - first);
+    (new ScryptLaneGroup(job->env(), job.get(), first, count))->ScheduleWork();
+  }
+  job.release();
+}
+
+
+void ScryptJob::RunLanes(uint32_t first, uint32_t count) {
+  if (!scrypt::RunLanes(blocks.data(), first, count, N, r))
+    lanes_failed = true;
+  if (--lane_groups_running != 0 || lanes_failed)
+    return;
+
+  if (!PKCS5_PBKDF2_HMAC(pass.data(), pass.size(), blocks.data(),
+                         blocks.size(), 1, EVP_sha256(), keybuf_size,
+                         keybuf_data)) {
+    errors.Capture();
+    if (errors.empty())
+      errors.push_back("Failed to derive key");
+  }
+  Cleanse();
+}
+
+
+void ScryptJob::OnLaneGroupDone(int status) {
+  CHECK(status == 0 || status == UV_ECANCELED);
+  if (status == UV_ECANCELED)
+    lanes_cancelled = true;
+  if (--lane_groups_pending != 0)
+    return;
+
+  std::unique_ptr<ScryptJob> job(this);
+  if (lanes_cancelled)
+    return;
+  if (lanes_failed)
+    errors.push_back("Failed to allocate memory for scrypt");
+  HandleScope handle_scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+  CHECK_EQ(false, async_wrap->persistent().IsWeak());
+  AfterThreadPoolWork();
+}
+
+
 void Scrypt(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   CHECK(args[0]->IsArrayBufferView());  // keybuf; wrap object retains ref.
@@ -6434,7 +7724,12 @@ void Scrypt(const FunctionCallbackInfo<Value>& args) {
     if (result->IsUndefined()) result = Null(args.GetIsolate());
     return args.GetReturnValue().Set(result);
   }
-  if (args[7]->IsObject()) return ScryptJob::Run(std::move(job), args[7]);
+  if (args[7]->IsObject()) {
+    const uint32_t groups = job->ParallelLaneGroups();
+    if (groups > 1)
+      return ScryptJob::RunInParallel(std::move(job), args[7], groups);
+    return ScryptJob::Run(std::move(job), args[7]);
+  }
   env->PrintSyncTrace();
   job->DoThreadPoolWork();
   args.GetReturnValue().Set(job->ToResult());
@@ -6442,6 +7737,257 @@ void Scrypt(const FunctionCallbackInfo<Value>& args) {
 #endif  // OPENSSL_NO_SCRYPT
 
 
+inline MaybeLocal<Value> EncodeDigest(Environment* env,
+                                      const unsigned char* md_value,
+                                      unsigned int md_len,
+                                      enum encoding encoding) {
+  Local<Value> error;
+  MaybeLocal<Value> rc =
+      StringBytes::Encode(env->isolate(),
+                          reinterpret_cast<const char*>(md_value),
+                          md_len,
+                          encoding,
+                          &error);
+  if (rc.IsEmpty()) {
+    CHECK(!error.IsEmpty());
+    env->isolate()->ThrowException(error);
+  }
+  return rc;
+}
+
+
+struct HashJob : public CryptoJob {
+  const EVP_MD* md;
+  // Points into a Buffer that the wrap object retains.
+  const unsigned char* data;
+  size_t size;
+  enum encoding encoding;
+  unsigned char md_value[EVP_MAX_MD_SIZE];
+  unsigned int md_len = 0;
+  CryptoErrorVector errors;
+
+  inline explicit HashJob(Environment* env) : CryptoJob(env) {}
+
+  inline void DoThreadPoolWork() override {
+    if (EVP_Digest(data, size, md_value, &md_len, md, nullptr) != 1)
+      errors.Capture();
+  }
+
+  inline void AfterThreadPoolWork() override {
+    Local<Value> argv[] = {
+      Null(env()->isolate()),
+      Undefined(env()->isolate())
+    };
+    if (!errors.empty()) {
+      argv[0] = errors.ToException(env()).ToLocalChecked();
+    } else {
+      // A digest is at most EVP_MAX_MD_SIZE bytes long, so encoding it
+      // cannot fail.
+      argv[1] = EncodeDigest(env(), md_value, md_len, encoding)
+          .ToLocalChecked();
+    }
+    async_wrap->MakeCallback(env()->ondone_string(), arraysize(argv), argv);
+  }
+};
+
+
+// hash(algorithm, data, outputEncoding[, wrap]) computes a digest in a single
+// EVP_Digest() call, without creating a Hash object and its EVP_MD_CTX.
+// Returns undefined if the algorithm is not supported.
+void HashOneShot(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());  // algorithm
+  CHECK(args[1]->IsString() || args[1]->IsArrayBufferView());  // data
+  CHECK(args[2]->IsString());  // outputEncoding
+  CHECK(args[3]->IsObject() || args[3]->IsUndefined());  // wrap object
+
+  const node::Utf8Value hash_type(env->isolate(), args[0]);
+  const EVP_MD* md = EVP_get_digestbyname(*hash_type);
+  if (md == nullptr)
+    return;
+  enum encoding encoding = ParseEncoding(env->isolate(), args[2], HEX);
+
+  if (args[3]->IsObject()) {
+    // Strings are converted to Buffers in JS before they are handed to the
+    // threadpool.
+    CHECK(args[1]->IsArrayBufferView());
+    std::unique_ptr<HashJob> job(new HashJob(env));
+    job->md = md;
+    job->data = reinterpret_cast<const unsigned char*>(Buffer::Data(args[1]));
+    job->size = Buffer::Length(args[1]);
+    job->encoding = encoding;
+    args.GetReturnValue().Set(true);
+    return HashJob::Run(std::move(job), args[3]);
+  }
+
+  unsigned char md_value[EVP_MAX_MD_SIZE];
+  unsigned int md_len;
+  int ret;
+  if (args[1]->IsString()) {
+    StringBytes::InlineDecoder decoder;
+    if (decoder.Decode(env, args[1].As<String>(), UTF8).IsNothing())
+      return;
+    ret = EVP_Digest(decoder.out(), decoder.size(), md_value, &md_len, md,
+                     nullptr);
+  } else {
+    ArrayBufferViewContents<char> buf(args[1].As<ArrayBufferView>());
+    ret = EVP_Digest(buf.data(), buf.length(), md_value, &md_len, md,
+                     nullptr);
+  }
+  if (ret != 1)
+    return ThrowCryptoError(env, ERR_get_error());
+
+  Local<Value> rc;
+  if (EncodeDigest(env, md_value, md_len, encoding).ToLocal(&rc))
+    args.GetReturnValue().Set(rc);
+}
+
+
+// Verifies a batch of signatures with already parsed keys. All EVP_PKEYs are
+// shared with their KeyObjects, and a single EVP_MD_CTX is reused for the
+// whole batch. results[i] is set to 1 for every valid signature, and to 0
+// otherwise, including when the key cannot be used with the algorithm.
+struct VerifyBatchJob : public CryptoJob {
+  struct Item {
+    ManagedEVPPKey key;
+    // Empty if the signature could not be converted to DER.
+    ByteSource signature;
+    // Points into a Buffer that the wrap object retains.
+    const unsigned char* data;
+    size_t size;
+    int padding;
+    Maybe<int> salt_len = Nothing<int>();
+  };
+
+  const EVP_MD* md;
+  std::vector<Item> items;
+  // Points into a Buffer that the wrap object retains.
+  unsigned char* results;
+
+  inline explicit VerifyBatchJob(Environment* env) : CryptoJob(env) {}
+
+  inline void DoThreadPoolWork() override {
+    ClearErrorOnReturn clear_error_on_return;
+    EVPMDPointer mdctx(EVP_MD_CTX_new());
+    for (size_t i = 0; i < items.size(); i++) {
+      results[i] = mdctx && Verify(mdctx.get(), items[i]) ? 1 : 0;
+      if (mdctx)
+        EVP_MD_CTX_reset(mdctx.get());
+    }
+  }
+
+  inline bool Verify(EVP_MD_CTX* mdctx, const Item& item) const {
+    if (!item.signature)
+      return false;
+    EVP_PKEY_CTX* pkctx = nullptr;
+    if (EVP_DigestVerifyInit(mdctx, &pkctx, md, nullptr, item.key.get()) != 1)
+      return false;
+    if (!ApplyRSAOptions(item.key, pkctx, item.padding, item.salt_len))
+      return false;
+    return EVP_DigestVerify(
+        mdctx,
+        reinterpret_cast<const unsigned char*>(item.signature.get()),
+        item.signature.size(),
+        item.data,
+        item.size) == 1;
+  }
+
+  inline void AfterThreadPoolWork() override {
+    async_wrap->MakeCallback(env()->ondone_string(), 0, nullptr);
+  }
+};
+
+
+// verifyBatch(algorithm, keys, signatures, data, params, results, wrap), where
+// keys holds native KeyObjects and params holds [padding, saltLength,
+// dsaEncoding] for every item, with undefined for the defaults. Returns
+// undefined if the algorithm is not supported.
+void VerifyBatch(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Local<Context> context = env->context();
+  CHECK(args[1]->IsArray());  // keys
+  CHECK(args[2]->IsArray());  // signatures; wrap object retains ref.
+  CHECK(args[3]->IsArray());  // data; wrap object retains ref.
+  CHECK(args[4]->IsArray());  // params
+  CHECK(args[5]->IsArrayBufferView());  // results; wrap object retains ref.
+  CHECK(args[6]->IsObject());  // wrap object
+
+  Local<Array> keys = args[1].As<Array>();
+  Local<Array> signatures = args[2].As<Array>();
+  Local<Array> data = args[3].As<Array>();
+  Local<Array> params = args[4].As<Array>();
+  const uint32_t count = keys->Length();
+  CHECK_EQ(signatures->Length(), count);
+  CHECK_EQ(data->Length(), count);
+  CHECK_EQ(params->Length(), 3 * count);
+  CHECK_LE(count, Buffer::Length(args[5]));
+
+  std::unique_ptr<VerifyBatchJob> job(new VerifyBatchJob(env));
+  if (args[0]->IsNullOrUndefined()) {
+    job->md = nullptr;
+  } else {
+    const node::Utf8Value sign_type(env->isolate(), args[0]);
+    job->md = EVP_get_digestbyname(*sign_type);
+    if (job->md == nullptr)
+      return;
+  }
+  job->results = reinterpret_cast<unsigned char*>(Buffer::Data(args[5]));
+  job->items.reserve(count);
+
+  for (uint32_t i = 0; i < count; i++) {
+    Local<Value> key_v, sig_v, data_v, padding_v, salt_len_v, dsa_enc_v;
+    if (!keys->Get(context, i).ToLocal(&key_v) ||
+        !signatures->Get(context, i).ToLocal(&sig_v) ||
+        !data->Get(context, i).ToLocal(&data_v) ||
+        !params->Get(context, 3 * i).ToLocal(&padding_v) ||
+        !params->Get(context, 3 * i + 1).ToLocal(&salt_len_v) ||
+        !params->Get(context, 3 * i + 2).ToLocal(&dsa_enc_v)) {
+      return;
+    }
+    CHECK(key_v->IsObject());
+    CHECK(sig_v->IsArrayBufferView());
+    CHECK(data_v->IsArrayBufferView());
+    CHECK(dsa_enc_v->IsInt32());
+
+    KeyObject* key = Unwrap<KeyObject>(key_v.As<Object>());
+    CHECK_NOT_NULL(key);
+    CHECK_NE(key->GetKeyType(), kKeyTypeSecret);
+
+    VerifyBatchJob::Item item;
+    item.key = key->GetAsymmetricKey();
+    item.data = reinterpret_cast<const unsigned char*>(Buffer::Data(data_v));
+    item.size = Buffer::Length(data_v);
+
+    item.padding = GetDefaultSignPadding(item.key);
+    if (!padding_v->IsUndefined()) {
+      CHECK(padding_v->IsInt32());
+      item.padding = padding_v.As<Int32>()->Value();
+    }
+    if (!salt_len_v->IsUndefined()) {
+      CHECK(salt_len_v->IsInt32());
+      item.salt_len = Just<int>(salt_len_v.As<Int32>()->Value());
+    }
+
+    DSASigEnc dsa_sig_enc =
+        static_cast<DSASigEnc>(dsa_enc_v.As<Int32>()->Value());
+    if (dsa_sig_enc == kSigEncP1363 &&
+        GetBytesOfRS(item.key) != kNoDsaSignature) {
+      // The converted signature is owned by the ByteSource.
+      ArrayBufferViewContents<char> sig(sig_v);
+      item.signature = ConvertSignatureToDER(item.key, sig);
+    } else {
+      item.signature = ByteSource::Foreign(Buffer::Data(sig_v),
+                                           Buffer::Length(sig_v));
+    }
+
+    job->items.emplace_back(std::move(item));
+  }
+
+  args.GetReturnValue().Set(true);
+  VerifyBatchJob::Run(std::move(job), args[6]);
+}
+
+
 class KeyPairGenerationConfig {
  public:
   virtual EVPKeyCtxPointer Setup() = 0;
@@ -7218,6 +8764,113 @@ void StatelessDiffieHellman(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// Derives a batch of shared secrets from already parsed keys, whose EVP_PKEYs
+// are shared with their KeyObjects. The callback receives an array with a
+// Buffer for every secret, or null if it could not be derived.
+struct DiffieHellmanBatchJob : public CryptoJob {
+  struct Item {
+    ManagedEVPPKey our_key;
+    ManagedEVPPKey their_key;
+    ByteSource secret;
+  };
+
+  std::vector<Item> items;
+
+  inline explicit DiffieHellmanBatchJob(Environment* env) : CryptoJob(env) {}
+
+  inline void DoThreadPoolWork() override {
+    ClearErrorOnReturn clear_error_on_return;
+    for (Item& item : items)
+      item.secret = Derive(item);
+  }
+
+  static inline ByteSource Derive(const Item& item) {
+    size_t size;
+    EVPKeyCtxPointer ctx(EVP_PKEY_CTX_new(item.our_key.get(), nullptr));
+    if (!ctx ||
+        EVP_PKEY_derive_init(ctx.get()) <= 0 ||
+        EVP_PKEY_derive_set_peer(ctx.get(), item.their_key.get()) <= 0 ||
+        EVP_PKEY_derive(ctx.get(), nullptr, &size) <= 0) {
+      return ByteSource();
+    }
+
+    char* data = MallocOpenSSL<char>(size);
+    ByteSource secret = ByteSource::Allocated(data, size);
+    size_t secret_size = size;
+    if (EVP_PKEY_derive(ctx.get(), reinterpret_cast<unsigned char*>(data),
+                        &secret_size) <= 0) {
+      return ByteSource();
+    }
+    // See ZeroPadDiffieHellmanSecret().
+    if (secret_size != size) {
+      CHECK_LT(secret_size, size);
+      const size_t padding = size - secret_size;
+      memmove(data + padding, data, secret_size);
+      memset(data, 0, padding);
+    }
+    return secret;
+  }
+
+  inline void AfterThreadPoolWork() override {
+    Isolate* isolate = env()->isolate();
+    std::vector<Local<Value>> secrets;
+    secrets.reserve(items.size());
+    for (const Item& item : items) {
+      Local<Value> secret = Null(isolate);
+      if (item.secret &&
+          !Buffer::Copy(env(), item.secret.get(), item.secret.size())
+              .ToLocal(&secret)) {
+        return;
+      }
+      secrets.push_back(secret);
+    }
+    Local<Value> arg = Array::New(isolate, secrets.data(), secrets.size());
+    async_wrap->MakeCallback(env()->ondone_string(), 1, &arg);
+  }
+};
+
+
+// diffieHellmanBatch(privateKeys, publicKeys, wrap), where both arrays hold
+// native KeyObjects of matching types.
+void DiffieHellmanBatch(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Local<Context> context = env->context();
+  CHECK(args[0]->IsArray());  // privateKeys
+  CHECK(args[1]->IsArray());  // publicKeys
+  CHECK(args[2]->IsObject());  // wrap object
+
+  Local<Array> private_keys = args[0].As<Array>();
+  Local<Array> public_keys = args[1].As<Array>();
+  const uint32_t count = private_keys->Length();
+  CHECK_EQ(public_keys->Length(), count);
+
+  std::unique_ptr<DiffieHellmanBatchJob> job(new DiffieHellmanBatchJob(env));
+  job->items.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    Local<Value> our_key_v, their_key_v;
+    if (!private_keys->Get(context, i).ToLocal(&our_key_v) ||
+        !public_keys->Get(context, i).ToLocal(&their_key_v)) {
+      return;
+    }
+    CHECK(our_key_v->IsObject());
+    CHECK(their_key_v->IsObject());
+    KeyObject* our_key = Unwrap<KeyObject>(our_key_v.As<Object>());
+    KeyObject* their_key = Unwrap<KeyObject>(their_key_v.As<Object>());
+    CHECK_NOT_NULL(our_key);
+    CHECK_NOT_NULL(their_key);
+    CHECK_EQ(our_key->GetKeyType(), kKeyTypePrivate);
+    CHECK_NE(their_key->GetKeyType(), kKeyTypeSecret);
+
+    DiffieHellmanBatchJob::Item item;
+    item.our_key = our_key->GetAsymmetricKey();
+    item.their_key = their_key->GetAsymmetricKey();
+    job->items.emplace_back(std::move(item));
+  }
+
+  DiffieHellmanBatchJob::Run(std::move(job), args[2]);
+}
+
+
 void TimingSafeEqual(const FunctionCallbackInfo<Value>& args) {
   ArrayBufferViewContents<char> buf1(args[0]);
   ArrayBufferViewContents<char> buf2(args[1]);
@@ -7229,6 +8882,7 @@ void TimingSafeEqual(const FunctionCallbackInfo<Value>& args) {
 }
 
 void InitCryptoOnce() {
+  const uint64_t start = PERFORMANCE_NOW();
 #ifndef OPENSSL_IS_BORINGSSL
   OPENSSL_INIT_SETTINGS* settings = OPENSSL_INIT_new();
 
@@ -7271,6 +8925,9 @@ void InitCryptoOnce() {
 #endif  // !OPENSSL_NO_ENGINE
 
   NodeBIO::GetMethod();
+
+  performance::MarkProcessPhase(
+      performance::NODE_PERFORMANCE_PHASE_OPENSSL_INIT, start);
 }
 
 
@@ -7333,6 +8990,7 @@ void Initialize(Local<Object> target,
   uv_once(&init_once, InitCryptoOnce);
 
   Environment* env = Environment::GetCurrent(context);
+  env->performance_state()->CopyProcessPhases(env->is_main_thread());
   SecureContext::Initialize(env, target);
   env->set_crypto_key_object_constructor(KeyObject::Initialize(env, target));
   CipherBase::Initialize(env, target);
@@ -7346,6 +9004,8 @@ void Initialize(Local<Object> target,
   env->SetMethodNoSideEffect(target, "certVerifySpkac", VerifySpkac);
   env->SetMethodNoSideEffect(target, "certExportPublicKey", ExportPublicKey);
   env->SetMethodNoSideEffect(target, "certExportChallenge", ExportChallenge);
+  env->SetMethodNoSideEffect(target, "getVerifiedChainCacheStats",
+                             GetVerifiedChainCacheStats);
   env->SetMethodNoSideEffect(target, "getRootCertificates",
                              GetRootCertificates);
   // Exposed for testing purposes only.
@@ -7363,6 +9023,7 @@ void Initialize(Local<Object> target,
 #endif
 
   env->SetMethod(target, "pbkdf2", PBKDF2);
+  env->SetMethod(target, "hash", HashOneShot);
   env->SetMethod(target, "generateKeyPairRSA", GenerateKeyPairRSA);
   env->SetMethod(target, "generateKeyPairRSAPSS", GenerateKeyPairRSAPSS);
   env->SetMethod(target, "generateKeyPairDSA", GenerateKeyPairDSA);
@@ -7387,9 +9048,11 @@ void Initialize(Local<Object> target,
   NODE_DEFINE_CONSTANT(target, kSigEncDER);
   NODE_DEFINE_CONSTANT(target, kSigEncP1363);
   env->SetMethodNoSideEffect(target, "statelessDH", StatelessDiffieHellman);
+  env->SetMethod(target, "diffieHellmanBatch", DiffieHellmanBatch);
   env->SetMethod(target, "randomBytes", RandomBytes);
   env->SetMethod(target, "signOneShot", SignOneShot);
   env->SetMethod(target, "verifyOneShot", VerifyOneShot);
+  env->SetMethod(target, "verifyBatch", VerifyBatch);
   env->SetMethodNoSideEffect(target, "timingSafeEqual", TimingSafeEqual);
   env->SetMethodNoSideEffect(target, "getSSLCiphers", GetSSLCiphers);
   env->SetMethodNoSideEffect(target, "getCiphers", GetCiphers);
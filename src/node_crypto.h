@@ -26,6 +26,7 @@
 
 // ClientHelloParser
 #include "node_crypto_clienthello.h"
+#include "node_crypto_session_cache.h"
 
 #include "env.h"
 #include "base_object.h"
@@ -40,6 +41,10 @@
 #include <openssl/ec.h>
 #include <openssl/rsa.h>
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace node {
 namespace crypto {
 
@@ -104,6 +109,16 @@ class SecureContext : public BaseObject {
   bool client_cert_engine_provided_ = false;
   std::unique_ptr<ENGINE, std::function<void(ENGINE*)>> private_key_engine_;
 #endif  // !OPENSSL_NO_ENGINE
+  std::shared_ptr<SessionCache> session_cache_;
+  // DER encoded OCSP response that is stapled when no 'OCSPRequest' listener
+  // provides one, and the uv_hrtime() at which it stops being current.
+  std::vector<unsigned char> ocsp_response_;
+  uint64_t ocsp_response_expiry_ = 0;
+
+  // Returns the context that was added for `servername` with AddSNIContext(),
+  // or nullptr. Like the default SNICallback, the one that was added first
+  // wins when several match.
+  SecureContext* FindSNIContext(const char* servername) const;
 
   static const int kMaxSessionSize = 10 * 1024;
 
@@ -142,6 +157,10 @@ class SecureContext : public BaseObject {
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetSessionTimeout(
       const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetSessionCache(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetOCSPResponse(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void AddSNIContext(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void LoadCredentials(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetMinProto(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetMaxProto(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetMinProto(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -163,6 +182,8 @@ class SecureContext : public BaseObject {
   template <bool primary>
   static void GetCertificate(const v8::FunctionCallbackInfo<v8::Value>& args);
 
+  static void SessionCacheRemoveCallback(SSL_CTX* ctx, SSL_SESSION* sess);
+
   static int TicketKeyCallback(SSL* ssl,
                                unsigned char* name,
                                unsigned char* iv,
@@ -186,11 +207,35 @@ class SecureContext : public BaseObject {
   inline void Reset() {
     if (ctx_ != nullptr) {
       env()->isolate()->AdjustAmountOfExternalAllocatedMemory(-kExternalSize);
+      // SSL_CTX_free() passes every session of the context to the remove
+      // callback, and those must stay in the cache that others still share.
+      if (session_cache_)
+        SSL_CTX_sess_set_remove_cb(ctx_.get(), nullptr);
     }
     ctx_.reset();
     cert_.reset();
     issuer_.reset();
+    session_cache_.reset();
+    ocsp_response_.clear();
+    sni_names_.clear();
+    sni_suffixes_.clear();
+    sni_patterns_.clear();
   }
+
+ private:
+  struct SNIContext {
+    // The order in which the context was added.
+    size_t index;
+    BaseObjectPtr<SecureContext> context;
+  };
+
+  // Names without wildcards.
+  std::unordered_map<std::string, SNIContext> sni_names_;
+  // Names of the form *.example.com, by their suffix, e.g. .example.com.
+  std::unordered_map<std::string, SNIContext> sni_suffixes_;
+  // All other names with wildcards, which are matched one by one.
+  std::vector<std::pair<std::string, SNIContext>> sni_patterns_;
+  size_t sni_count_ = 0;
 };
 
 // SSLWrap implicitly depends on the inheriting class' handle having an
@@ -211,7 +256,8 @@ class SSLWrap {
         awaiting_new_session_(false),
         cert_cb_(nullptr),
         cert_cb_arg_(nullptr),
-        cert_cb_running_(false) {
+        cert_cb_running_(false),
+        session_cache_(sc->session_cache_) {
     ssl_.reset(SSL_new(sc->ctx_.get()));
     CHECK(ssl_);
     env_->isolate()->AdjustAmountOfExternalAllocatedMemory(kExternalSize);
@@ -305,6 +351,8 @@ class SSLWrap {
   SSLPointer ssl_;
   bool session_callbacks_;
   bool awaiting_new_session_;
+  // Last value passed to setMaxSendFragment().
+  int max_send_fragment_ = SSL3_RT_MAX_PLAIN_LENGTH;
 
   // SSL_set_cert_cb
   CertCb cert_cb_;
@@ -315,6 +363,9 @@ class SSLWrap {
 
   v8::Global<v8::ArrayBufferView> ocsp_response_;
   BaseObjectPtr<SecureContext> sni_context_;
+  // Captured at construction, so that sessions are still stored in the
+  // original context's cache after SNI switched to another SecureContext.
+  std::shared_ptr<SessionCache> session_cache_;
 
   friend class SecureContext;
 };
@@ -461,6 +512,17 @@ class KeyObject : public BaseObject {
   v8::MaybeLocal<v8::Value> ExportPrivateKey(
       const PrivateKeyEncodingConfig& config) const;
 
+  static void AeadSeal(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void AeadOpen(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void AeadSealBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void AeadOpenBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void AeadOneShot(const v8::FunctionCallbackInfo<v8::Value>& args,
+                          bool encrypt);
+  static void AeadBatch(const v8::FunctionCallbackInfo<v8::Value>& args,
+                        bool encrypt);
+  EVP_CIPHER_CTX* GetAeadContext(v8::Local<v8::Value> cipher_name,
+                                 unsigned int auth_tag_len);
+
   KeyObject(Environment* env,
             v8::Local<v8::Object> wrap,
             KeyType key_type)
@@ -475,6 +537,9 @@ class KeyObject : public BaseObject {
   std::unique_ptr<char, std::function<void(char*)>> symmetric_key_;
   unsigned int symmetric_key_len_;
   ManagedEVPPKey asymmetric_key_;
+  // Initialized cipher contexts for the one-shot AEAD functions, by NID.
+  std::unordered_map<int, DeleteFnPtr<EVP_CIPHER_CTX, EVP_CIPHER_CTX_free>>
+      aead_contexts_;
 };
 
 class CipherBase : public BaseObject {
@@ -535,6 +600,7 @@ class CipherBase : public BaseObject {
   static void Init(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void InitIv(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Update(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void UpdateAsync(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Final(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetAutoPadding(const v8::FunctionCallbackInfo<v8::Value>& args);
 
@@ -555,6 +621,9 @@ class CipherBase : public BaseObject {
   }
 
  private:
+  // Runs EVP_CipherUpdate() for updateAsync() on the threadpool.
+  struct UpdateJob;
+
   DeleteFnPtr<EVP_CIPHER_CTX, EVP_CIPHER_CTX_free> ctx_;
   const CipherKind kind_;
   AuthTagState auth_tag_state_;
@@ -562,6 +631,9 @@ class CipherBase : public BaseObject {
   char auth_tag_[EVP_GCM_TLS_TAG_LEN];
   bool pending_auth_failed_;
   int max_message_size_;
+  // At most one updateAsync() is in flight per context, and JS does not call
+  // any other method while it is.
+  bool async_update_pending_ = false;
 };
 
 class Hmac : public BaseObject {
@@ -580,6 +652,7 @@ class Hmac : public BaseObject {
   static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void HmacInit(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void HmacUpdate(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void HmacUpdateAsync(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void HmacDigest(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   Hmac(Environment* env, v8::Local<v8::Object> wrap)
@@ -589,7 +662,11 @@ class Hmac : public BaseObject {
   }
 
  private:
+  // Runs HMAC_Update() for updateAsync() on the threadpool.
+  struct UpdateJob;
+
   DeleteFnPtr<HMAC_CTX, HMAC_CTX_free> ctx_;
+  bool async_update_pending_ = false;
 };
 
 class Hash : public BaseObject {
@@ -607,6 +684,7 @@ class Hash : public BaseObject {
  protected:
   static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void HashUpdate(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void HashUpdateAsync(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void HashDigest(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   Hash(Environment* env, v8::Local<v8::Object> wrap)
@@ -623,10 +701,14 @@ class Hash : public BaseObject {
   }
 
  private:
+  // Runs EVP_DigestUpdate() for updateAsync() on the threadpool.
+  struct UpdateJob;
+
   EVPMDPointer mdctx_;
   bool has_md_;
   unsigned int md_len_;
   unsigned char* md_value_;
+  bool async_update_pending_ = false;
 };
 
 class SignBase : public BaseObject {
@@ -0,0 +1,126 @@
+#include "node_crypto_scrypt.h"
+
+#include <openssl/crypto.h>
+
+#include <cstring>
+
+namespace node {
+namespace crypto {
+namespace scrypt {
+
+namespace {
+
+inline uint32_t Rotl(uint32_t a, int b) {
+  return (a << b) | (a >> (32 - b));
+}
+
+// The Salsa20/8 core, RFC 7914 section 3.
+void Salsa208(uint32_t B[16]) {
+  uint32_t x[16];
+  memcpy(x, B, sizeof(x));
+  for (int i = 8; i > 0; i -= 2) {
+    // Columns.
+    x[4] ^= Rotl(x[0] + x[12], 7);   x[8] ^= Rotl(x[4] + x[0], 9);
+    x[12] ^= Rotl(x[8] + x[4], 13);  x[0] ^= Rotl(x[12] + x[8], 18);
+    x[9] ^= Rotl(x[5] + x[1], 7);    x[13] ^= Rotl(x[9] + x[5], 9);
+    x[1] ^= Rotl(x[13] + x[9], 13);  x[5] ^= Rotl(x[1] + x[13], 18);
+    x[14] ^= Rotl(x[10] + x[6], 7);  x[2] ^= Rotl(x[14] + x[10], 9);
+    x[6] ^= Rotl(x[2] + x[14], 13);  x[10] ^= Rotl(x[6] + x[2], 18);
+    x[3] ^= Rotl(x[15] + x[11], 7);  x[7] ^= Rotl(x[3] + x[15], 9);
+    x[11] ^= Rotl(x[7] + x[3], 13);  x[15] ^= Rotl(x[11] + x[7], 18);
+    // Rows.
+    x[1] ^= Rotl(x[0] + x[3], 7);    x[2] ^= Rotl(x[1] + x[0], 9);
+    x[3] ^= Rotl(x[2] + x[1], 13);   x[0] ^= Rotl(x[3] + x[2], 18);
+    x[6] ^= Rotl(x[5] + x[4], 7);    x[7] ^= Rotl(x[6] + x[5], 9);
+    x[4] ^= Rotl(x[7] + x[6], 13);   x[5] ^= Rotl(x[4] + x[7], 18);
+    x[11] ^= Rotl(x[10] + x[9], 7);  x[8] ^= Rotl(x[11] + x[10], 9);
+    x[9] ^= Rotl(x[8] + x[11], 13);  x[10] ^= Rotl(x[9] + x[8], 18);
+    x[12] ^= Rotl(x[15] + x[14], 7); x[13] ^= Rotl(x[12] + x[15], 9);
+    x[14] ^= Rotl(x[13] + x[12], 13); x[15] ^= Rotl(x[14] + x[13], 18);
+  }
+  for (int i = 0; i < 16; i++)
+    B[i] += x[i];
+}
+
+// scryptBlockMix, RFC 7914 section 4. |in| and |out| hold 32 * r words.
+void BlockMix(uint32_t* out, const uint32_t* in, uint32_t r) {
+  uint32_t X[16];
+  memcpy(X, in + (2 * r - 1) * 16, sizeof(X));
+  for (uint32_t i = 0; i < 2 * r; i++) {
+    for (int j = 0; j < 16; j++)
+      X[j] ^= in[i * 16 + j];
+    Salsa208(X);
+    // Even blocks go to the first half of the output, odd ones to the second.
+    memcpy(out + (i / 2 + (i & 1) * r) * 16, X, sizeof(X));
+  }
+}
+
+// scryptROMix, RFC 7914 section 5. |B| holds 128 * r bytes, |X| and |T| 32 * r
+// words and |V| 32 * r * N words.
+void ROMix(unsigned char* B,
+           uint32_t N,
+           uint32_t r,
+           uint32_t* X,
+           uint32_t* T,
+           uint32_t* V) {
+  const size_t words = 32 * static_cast<size_t>(r);
+
+  for (size_t i = 0; i < words; i++) {
+    const unsigned char* p = B + 4 * i;
+    X[i] = static_cast<uint32_t>(p[0]) |
+           static_cast<uint32_t>(p[1]) << 8 |
+           static_cast<uint32_t>(p[2]) << 16 |
+           static_cast<uint32_t>(p[3]) << 24;
+  }
+
+  uint32_t* pV = V;
+  memcpy(pV, X, words * sizeof(*X));
+  for (uint32_t i = 1; i < N; i++, pV += words)
+    BlockMix(pV + words, pV, r);
+  BlockMix(X, pV, r);
+
+  for (uint32_t i = 0; i < N; i++) {
+    // Integerify() only needs the low 32 bits because N < 2^32.
+    const uint32_t j = X[16 * (2 * r - 1)] % N;
+    pV = V + words * j;
+    for (size_t k = 0; k < words; k++)
+      T[k] = X[k] ^ pV[k];
+    BlockMix(X, T, r);
+  }
+
+  for (size_t i = 0; i < words; i++) {
+    unsigned char* p = B + 4 * i;
+    p[0] = X[i] & 0xff;
+    p[1] = (X[i] >> 8) & 0xff;
+    p[2] = (X[i] >> 16) & 0xff;
+    p[3] = (X[i] >> 24) & 0xff;
+  }
+}
+
+}  // anonymous namespace
+
+bool RunLanes(unsigned char* B,
+              uint32_t first,
+              uint32_t count,
+              uint32_t N,
+              uint32_t r) {
+  // X, T and V in a single allocation, like EVP_PBE_scrypt() does.
+  const uint64_t size = LaneMemory(N, r);
+  if (size > SIZE_MAX)
+    return false;
+  uint32_t* X = static_cast<uint32_t*>(OPENSSL_malloc(size));
+  if (X == nullptr)
+    return false;
+  uint32_t* T = X + 32 * static_cast<size_t>(r);
+  uint32_t* V = T + 32 * static_cast<size_t>(r);
+
+  for (uint32_t lane = first; lane < first + count; lane++)
+    ROMix(B + BlockSize(r, lane), N, r, X, T, V);
+
+  OPENSSL_clear_free(X, size);
+  return true;
+}
+
+}  // namespace scrypt
+}  // namespace crypto
+}  // namespace node
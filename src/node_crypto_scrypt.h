@@ -0,0 +1,50 @@
+#ifndef SRC_NODE_CRYPTO_SCRYPT_H_
+#define SRC_NODE_CRYPTO_SCRYPT_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstddef>
+#include <cstdint>
+
+namespace node {
+namespace crypto {
+
+// The parts of scrypt (RFC 7914) that OpenSSL does not expose, so that the
+// p independent lanes of a single derivation can run on different threads.
+// A derivation consists of
+//
+//   B = PBKDF2-HMAC-SHA256(password, salt, 1, p * 128 * r)
+//   B[i] = scryptROMix(r, B[i], N) for each lane i < p
+//   DK = PBKDF2-HMAC-SHA256(password, B, 1, dkLen)
+//
+// where the first and last step are cheap and the ROMix lanes are where all
+// of the time and memory is spent.
+namespace scrypt {
+
+// The size of B, i.e. of all lanes together.
+inline size_t BlockSize(uint32_t r, uint32_t p) {
+  return static_cast<size_t>(p) * 128 * r;
+}
+
+// The memory that RunLanes() needs in addition to B, computed the same way
+// as EVP_PBE_scrypt() does for its maxmem check.
+inline uint64_t LaneMemory(uint32_t N, uint32_t r) {
+  return static_cast<uint64_t>(32) * r * (static_cast<uint64_t>(N) + 2) *
+         sizeof(uint32_t);
+}
+
+// Runs scryptROMix on lanes [first, first + count) of |B|, one after the
+// other. Returns false if the scratch memory could not be allocated.
+bool RunLanes(unsigned char* B,
+              uint32_t first,
+              uint32_t count,
+              uint32_t N,
+              uint32_t r);
+
+}  // namespace scrypt
+}  // namespace crypto
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_CRYPTO_SCRYPT_H_
@@ -0,0 +1,123 @@
+#include "node_crypto_session_cache.h"
+
+#include <functional>
+
+namespace node {
+namespace crypto {
+
+namespace {
+Mutex session_caches_mutex;
+std::unordered_map<std::string, std::weak_ptr<SessionCache>> session_caches;
+}  // anonymous namespace
+
+std::shared_ptr<SessionCache> SessionCache::Get(const std::string& name,
+                                                size_t max_entries) {
+  Mutex::ScopedLock lock(session_caches_mutex);
+
+  std::shared_ptr<SessionCache> cache;
+  auto it = session_caches.find(name);
+  if (it != session_caches.end())
+    cache = it->second.lock();
+
+  if (!cache) {
+    // Drop registrations whose caches are already gone while we hold the
+    // lock anyway, so that short-lived names do not accumulate.
+    for (auto i = session_caches.begin(); i != session_caches.end();) {
+      if (i->second.expired())
+        i = session_caches.erase(i);
+      else
+        ++i;
+    }
+    cache = std::make_shared<SessionCache>(max_entries);
+    session_caches[name] = cache;
+  }
+
+  return cache;
+}
+
+SessionCache::SessionCache(size_t max_entries)
+    : max_entries_(max_entries),
+      max_entries_per_shard_(
+          (max_entries + kShardCount - 1) / kShardCount) {}
+
+SessionCache::Shard& SessionCache::ShardFor(const std::string& key) {
+  return shards_[std::hash<std::string>()(key) % kShardCount];
+}
+
+void SessionCache::Insert(SSL_SESSION* sess, size_t max_session_size) {
+  unsigned int id_length;
+  const unsigned char* id = SSL_SESSION_get_id(sess, &id_length);
+  if (id_length == 0)
+    return;
+
+  int size = i2d_SSL_SESSION(sess, nullptr);
+  if (size <= 0 || static_cast<size_t>(size) > max_session_size)
+    return;
+
+  // Serialize outside of the lock.
+  std::vector<unsigned char> data(size);
+  unsigned char* p = data.data();
+  i2d_SSL_SESSION(sess, &p);
+
+  std::string key(reinterpret_cast<const char*>(id), id_length);
+  Shard& shard = ShardFor(key);
+
+  Mutex::ScopedLock lock(shard.mutex);
+  auto it = shard.index.find(key);
+  if (it != shard.index.end()) {
+    it->second->second = std::move(data);
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return;
+  }
+
+  shard.lru.emplace_front(key, std::move(data));
+  shard.index.emplace(std::move(key), shard.lru.begin());
+
+  while (shard.lru.size() > max_entries_per_shard_) {
+    shard.index.erase(shard.lru.back().first);
+    shard.lru.pop_back();
+  }
+}
+
+SSL_SESSION* SessionCache::Lookup(const unsigned char* id,
+                                  unsigned int id_length) {
+  std::string key(reinterpret_cast<const char*>(id), id_length);
+  Shard& shard = ShardFor(key);
+  std::vector<unsigned char> data;
+
+  {
+    Mutex::ScopedLock lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end())
+      return nullptr;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    data = it->second->second;
+  }
+
+  const unsigned char* p = data.data();
+  return d2i_SSL_SESSION(nullptr, &p, data.size());
+}
+
+void SessionCache::Remove(const unsigned char* id, unsigned int id_length) {
+  std::string key(reinterpret_cast<const char*>(id), id_length);
+  Shard& shard = ShardFor(key);
+
+  Mutex::ScopedLock lock(shard.mutex);
+  auto it = shard.index.find(key);
+  if (it == shard.index.end())
+    return;
+  shard.lru.erase(it->second);
+  shard.index.erase(it);
+}
+
+size_t SessionCache::size() const {
+  size_t total = 0;
+  for (const Shard& shard : shards_) {
+    Mutex::ScopedLock lock(shard.mutex);
+    total += shard.lru.size();
+  }
+  return total;
+}
+
+}  // namespace crypto
+}  // namespace node
@@ -0,0 +1,79 @@
+#ifndef SRC_NODE_CRYPTO_SESSION_CACHE_H_
+#define SRC_NODE_CRYPTO_SESSION_CACHE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "node_mutex.h"
+#include "openssl/ssl.h"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace node {
+namespace crypto {
+
+// A server-side TLS session cache that is shared by every SecureContext in
+// the process that refers to it by the same name, including SecureContexts
+// that belong to different Worker threads. Sessions are stored serialized,
+// so that no OpenSSL object is ever shared between threads, and are looked
+// up synchronously from OpenSSL's get_session_cb without calling into JS.
+//
+// The cache is split into kShardCount independently locked shards, selected
+// by a hash of the session id, so that concurrent handshakes on different
+// threads rarely contend on the same lock. Each shard evicts its least
+// recently used entry once it holds more than its share of max_entries.
+class SessionCache {
+ public:
+  static constexpr size_t kShardCount = 16;
+
+  // Returns the cache registered under |name|, creating it with room for
+  // |max_entries| sessions if it does not exist yet. The cache is destroyed
+  // once the last SecureContext that uses it is gone.
+  static std::shared_ptr<SessionCache> Get(const std::string& name,
+                                           size_t max_entries);
+
+  explicit SessionCache(size_t max_entries);
+
+  SessionCache(const SessionCache&) = delete;
+  SessionCache& operator=(const SessionCache&) = delete;
+
+  // Stores a copy of |sess|. Sessions without an id, or whose serialized
+  // form is larger than max_session_size, are ignored.
+  void Insert(SSL_SESSION* sess, size_t max_session_size);
+
+  // Returns a new SSL_SESSION owned by the caller, or nullptr on a miss.
+  SSL_SESSION* Lookup(const unsigned char* id, unsigned int id_length);
+
+  void Remove(const unsigned char* id, unsigned int id_length);
+
+  size_t size() const;
+  inline size_t max_entries() const { return max_entries_; }
+
+ private:
+  struct Shard {
+    using Entry = std::pair<std::string, std::vector<unsigned char>>;
+
+    mutable Mutex mutex;
+    // Most recently used entry first.
+    std::list<Entry> lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+  };
+
+  Shard& ShardFor(const std::string& key);
+
+  const size_t max_entries_;
+  const size_t max_entries_per_shard_;
+  Shard shards_[kShardCount];
+};
+
+}  // namespace crypto
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_CRYPTO_SESSION_CACHE_H_
@@ -1,7 +1,9 @@
 #include "node_dir.h"
 #include "node_file-inl.h"
+#include "node_buffer.h"
 #include "node_process.h"
 #include "memory_tracker-inl.h"
+#include "threadpoolwork-inl.h"
 #include "util.h"
 
 #include "tracing/trace_event.h"
@@ -96,6 +98,7 @@ void DirHandle::MemoryInfo(MemoryTracker* tracker) const {
 // will crash the process immediately.
 inline void DirHandle::GCClose() {
   if (closed_) return;
+  CloseWalk();
   uv_fs_t req;
   int ret = uv_fs_closedir(nullptr, &req, dir_, nullptr);
   uv_fs_req_cleanup(&req);
@@ -153,6 +156,20 @@ void DirHandle::Close(const FunctionCallbackInfo<Value>& args) {
   dir->closed_ = true;
 
   FSReqBase* req_wrap_async = GetReqWrap(env, args[0]);
+  if (dir->walking_) {
+    // The directory is closed in AfterWalkJob(). A synchronous close()
+    // reports success right away, as closedir() does not fail for a
+    // valid handle.
+    dir->close_pending_ = true;
+    if (req_wrap_async != nullptr) {
+      req_wrap_async->Init("closedir", nullptr, 0, UTF8);
+      req_wrap_async->SetReturnValue(args);
+      dir->close_req_.reset(req_wrap_async);
+    }
+    return;
+  }
+
+  dir->CloseWalk();
   if (req_wrap_async != nullptr) {  // close(req)
     AsyncCall(env, req_wrap_async, args, "closedir", UTF8, AfterClose,
               uv_fs_closedir, dir->dir());
@@ -230,6 +247,28 @@ static void AfterDirRead(uv_fs_t* req) {
   req_wrap->Resolve(js_array);
 }
 
+// Fails a read that is made while a WalkStep() runs on the threadpool, the
+// way that AsyncCall() and SyncCall() report errors.
+static void FailBusy(Environment* env,
+                     FSReqBase* req_wrap_async,
+                     Local<Value> ctx,
+                     enum encoding encoding) {
+  if (req_wrap_async != nullptr) {
+    req_wrap_async->Init("readdir", nullptr, 0, encoding);
+    uv_fs_t* req = req_wrap_async->req();
+    req->result = UV_EBUSY;
+    req->path = nullptr;
+    AfterDirRead(req);  // Rejects, and deletes req_wrap_async.
+    return;
+  }
+  Local<Object> ctx_obj = ctx.As<Object>();
+  ctx_obj->Set(env->context(),
+               env->errno_string(),
+               Integer::New(env->isolate(), UV_EBUSY)).Check();
+  ctx_obj->Set(env->context(),
+               env->syscall_string(),
+               OneByteString(env->isolate(), "readdir")).Check();
+}
 
 void DirHandle::Read(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
@@ -246,13 +285,17 @@ void DirHandle::Read(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[1]->IsNumber());
   uint64_t buffer_size = args[1].As<Number>()->Value();
 
+  FSReqBase* req_wrap_async = GetReqWrap(env, args[2]);
+  if (dir->walking_) {
+    return FailBusy(env, req_wrap_async, args[argc - 1], encoding);
+  }
+
   if (buffer_size != dir->dirents_.size()) {
     dir->dirents_.resize(buffer_size);
     dir->dir_->nentries = buffer_size;
     dir->dir_->dirents = dir->dirents_.data();
   }
 
-  FSReqBase* req_wrap_async = GetReqWrap(env, args[2]);
   if (req_wrap_async != nullptr) {  // dir.read(encoding, bufferSize, req)
     AsyncCall(env, req_wrap_async, args, "readdir", encoding,
               AfterDirRead, uv_fs_readdir, dir->dir());
@@ -292,6 +335,316 @@ void DirHandle::Read(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+#ifdef _WIN32
+constexpr char kWalkPathSeparator = '\\';
+#else
+constexpr char kWalkPathSeparator = '/';
+#endif
+
+// Works out the type of an entry that readdir() could not tell us about.
+static int DirentTypeFromLstat(const std::string& path) {
+  int type = UV_DIRENT_UNKNOWN;
+#ifdef __POSIX__
+  uv_fs_t req;
+  if (uv_fs_lstat(nullptr, &req, path.c_str(), nullptr) == 0) {
+    switch (req.statbuf.st_mode & S_IFMT) {
+      case S_IFREG: type = UV_DIRENT_FILE; break;
+      case S_IFDIR: type = UV_DIRENT_DIR; break;
+      case S_IFLNK: type = UV_DIRENT_LINK; break;
+      case S_IFIFO: type = UV_DIRENT_FIFO; break;
+      case S_IFSOCK: type = UV_DIRENT_SOCKET; break;
+      case S_IFCHR: type = UV_DIRENT_CHAR; break;
+      case S_IFBLK: type = UV_DIRENT_BLOCK; break;
+    }
+  }
+  uv_fs_req_cleanup(&req);
+#endif
+  return type;
+}
+
+void DirHandle::CloseWalk() {
+  if (walk_current_ == nullptr || walk_current_ == dir_) return;
+  uv_fs_t req;
+  uv_fs_closedir(nullptr, &req, walk_current_, nullptr);
+  uv_fs_req_cleanup(&req);
+  walk_current_ = nullptr;
+}
+
+void DirHandle::AfterWalkJob() {
+  CHECK(walking_);
+  walking_ = false;
+  if (!close_pending_) return;
+  close_pending_ = false;
+
+  CloseWalk();
+  if (close_req_) {
+    FSReqBase* req_wrap = close_req_.release();
+    const int err = req_wrap->Dispatch(uv_fs_closedir, dir_, AfterClose);
+    if (err < 0) {
+      uv_fs_t* req = req_wrap->req();
+      req->result = err;
+      req->path = nullptr;
+      AfterClose(req);  // Rejects, and deletes req_wrap.
+    }
+  } else {
+    uv_fs_t req;
+    uv_fs_closedir(nullptr, &req, dir_, nullptr);
+    uv_fs_req_cleanup(&req);
+  }
+}
+
+int DirHandle::WalkStep(size_t max_entries) {
+  CHECK_GT(max_entries, 0);
+  CHECK_LE(max_entries, dirents_.size());
+  walk_entries_.clear();
+
+  while (walk_err_ == 0 && walk_entries_.size() < max_entries) {
+    if (walk_current_ == nullptr) {
+      if (walk_pending_.empty())
+        break;  // Done.
+
+      std::pair<std::string, int64_t> next = std::move(walk_pending_.back());
+      walk_pending_.pop_back();
+      const std::string path = walk_root_ + kWalkPathSeparator + next.first;
+
+      uv_fs_t req;
+      const int err = uv_fs_opendir(nullptr, &req, path.c_str(), nullptr);
+      uv_dir_t* dir = static_cast<uv_dir_t*>(req.ptr);
+      uv_fs_req_cleanup(&req);
+      if (err < 0) {
+        walk_err_ = err;
+        walk_syscall_ = "opendir";
+        walk_path_ = path;
+        break;
+      }
+      walk_current_ = dir;
+      walk_prefix_ = next.first + kWalkPathSeparator;
+      walk_depth_ = next.second;
+    }
+
+    walk_current_->dirents = dirents_.data();
+    walk_current_->nentries = max_entries - walk_entries_.size();
+
+    uv_fs_t req;
+    const int count = uv_fs_readdir(nullptr, &req, walk_current_, nullptr);
+    if (count < 0) {
+      uv_fs_req_cleanup(&req);
+      walk_err_ = count;
+      walk_syscall_ = "readdir";
+      walk_path_ = walk_root_;
+      if (!walk_prefix_.empty()) {
+        walk_path_ += kWalkPathSeparator;
+        walk_path_.append(walk_prefix_, 0, walk_prefix_.size() - 1);
+      }
+      CloseWalk();
+      walk_current_ = nullptr;
+      break;
+    }
+
+    for (int i = 0; i < count; i++) {
+      WalkEntry entry { walk_prefix_ + dirents_[i].name, dirents_[i].type };
+      if (entry.type == UV_DIRENT_UNKNOWN) {
+        entry.type =
+            DirentTypeFromLstat(walk_root_ + kWalkPathSeparator + entry.name);
+      }
+      if (entry.type == UV_DIRENT_DIR &&
+          (walk_max_depth_ < 0 || walk_depth_ < walk_max_depth_)) {
+        walk_pending_.emplace_back(entry.name, walk_depth_ + 1);
+      }
+      walk_entries_.emplace_back(std::move(entry));
+    }
+    uv_fs_req_cleanup(&req);
+
+    if (count == 0) {
+      // This directory is exhausted. The root directory is only closed
+      // together with the handle.
+      CloseWalk();
+      walk_current_ = nullptr;
+    }
+  }
+
+  // Errors are reported once the entries read before them have been handed
+  // out, and the walk carries on with the next directory after that.
+  if (walk_entries_.empty() && walk_err_ != 0) {
+    const int err = walk_err_;
+    walk_err_ = 0;
+    return err;
+  }
+  return 0;
+}
+
+static MaybeLocal<Value> WalkEntriesToArray(
+    Environment* env,
+    const std::vector<DirHandle::WalkEntry>& ents,
+    enum encoding encoding,
+    Local<Value>* err_out) {
+  if (ents.empty())
+    return Null(env->isolate());
+
+  MaybeStackBuffer<Local<Value>, 64> entries(ents.size() * 2);
+
+  // Return an array of all read filenames, relative to the walk root.
+  size_t j = 0;
+  for (const DirHandle::WalkEntry& ent : ents) {
+    Local<Value> filename;
+    Local<Value> error;
+    if (!StringBytes::Encode(env->isolate(),
+                             ent.name.data(),
+                             ent.name.size(),
+                             encoding,
+                             &error).ToLocal(&filename)) {
+      *err_out = error;
+      return MaybeLocal<Value>();
+    }
+
+    entries[j++] = filename;
+    entries[j++] = Integer::New(env->isolate(), ent.type);
+  }
+
+  return Array::New(env->isolate(), entries.out(), j);
+}
+
+// Runs one DirHandle::WalkStep() on the threadpool.
+class DirWalkJob final : public ThreadPoolWork {
+ public:
+  DirWalkJob(Environment* env,
+             DirHandle* dir,
+             FSReqBase* req_wrap,
+             size_t max_entries)
+      : ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_KIND_FS),
+        dir_(dir),
+        req_wrap_(req_wrap),
+        max_entries_(max_entries) {}
+
+  void DoThreadPoolWork() override {
+    err_ = dir_->WalkStep(max_entries_);
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    CHECK(status == 0 || status == UV_ECANCELED);
+    std::unique_ptr<DirWalkJob> job(this);
+    dir_->AfterWalkJob();
+    if (status == UV_ECANCELED) return;
+
+    Isolate* isolate = env()->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env()->context());
+
+    if (err_ < 0) {
+      req_wrap_->Reject(UVException(isolate,
+                                    err_,
+                                    dir_->walk_syscall(),
+                                    nullptr,
+                                    dir_->walk_path().c_str()));
+      return;
+    }
+
+    Local<Value> error;
+    Local<Value> result;
+    if (!WalkEntriesToArray(env(),
+                            dir_->walk_entries(),
+                            req_wrap_->encoding(),
+                            &error).ToLocal(&result)) {
+      return req_wrap_->Reject(error);
+    }
+    req_wrap_->Resolve(result);
+  }
+
+ private:
+  BaseObjectPtr<DirHandle> dir_;
+  std::unique_ptr<FSReqBase> req_wrap_;
+  const size_t max_entries_;
+  int err_ = 0;
+};
+
+// dir.walk(path, encoding, bufferSize, maxDepth, req | undefined, ctx)
+// Like dir.read(), but descends into subdirectories of path (the directory
+// the handle was opened for) up to maxDepth levels deep, or without limit if
+// maxDepth is negative. Entries are named relative to path. Unlike read(),
+// entries of unknown type are resolved with lstat() on the threadpool.
+void DirHandle::Walk(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  const int argc = args.Length();
+  CHECK_GE(argc, 5);
+
+  DirHandle* dir;
+  ASSIGN_OR_RETURN_UNWRAP(&dir, args.Holder());
+
+  BufferValue path(isolate, args[0]);
+  CHECK_NOT_NULL(*path);
+
+  const enum encoding encoding = ParseEncoding(isolate, args[1], UTF8);
+
+  CHECK(args[2]->IsNumber());
+  uint64_t buffer_size = args[2].As<Number>()->Value();
+  CHECK_GT(buffer_size, 0);
+
+  CHECK(args[3]->IsNumber());
+  const int64_t max_depth = args[3].As<Number>()->Value();
+
+  FSReqBase* req_wrap_async = GetReqWrap(env, args[4]);
+  if (dir->walking_) {
+    return FailBusy(env, req_wrap_async, args[argc - 1], encoding);
+  }
+
+  if (!dir->walk_started_) {
+    dir->walk_started_ = true;
+    dir->walk_root_ = path.ToString();
+    dir->walk_max_depth_ = max_depth;
+    dir->walk_current_ = dir->dir_;
+  }
+
+  if (buffer_size > dir->dirents_.size())
+    dir->dirents_.resize(buffer_size);
+
+  if (req_wrap_async != nullptr) {
+    // dir.walk(path, encoding, bufferSize, maxDepth, req)
+    req_wrap_async->Init("readdir", nullptr, 0, encoding);
+    req_wrap_async->SetReturnValue(args);
+    auto job = std::make_unique<DirWalkJob>(
+        env, dir, req_wrap_async, buffer_size);
+    dir->walking_ = true;
+    job->ScheduleWork();
+    job.release();  // Deleted in AfterThreadPoolWork().
+  } else {  // dir.walk(path, encoding, bufferSize, maxDepth, undefined, ctx)
+    CHECK_EQ(argc, 6);
+    env->PrintSyncTrace();
+    FS_DIR_SYNC_TRACE_BEGIN(readdir);
+    const int err = dir->WalkStep(buffer_size);
+    FS_DIR_SYNC_TRACE_END(readdir);
+
+    Local<Object> ctx = args[5].As<Object>();
+    if (err < 0) {
+      const std::string& walk_path = dir->walk_path();
+      ctx->Set(env->context(),
+               env->errno_string(),
+               Integer::New(isolate, err)).Check();
+      ctx->Set(env->context(),
+               env->syscall_string(),
+               OneByteString(isolate, dir->walk_syscall())).Check();
+      ctx->Set(env->context(),
+               env->path_string(),
+               Buffer::Copy(env, walk_path.data(), walk_path.size())
+                   .ToLocalChecked()).Check();
+      return;
+    }
+
+    Local<Value> error;
+    Local<Value> result;
+    if (!WalkEntriesToArray(env,
+                            dir->walk_entries(),
+                            encoding,
+                            &error).ToLocal(&result)) {
+      USE(ctx->Set(env->context(), env->error_string(), error));
+      return;
+    }
+
+    args.GetReturnValue().Set(result);
+  }
+}
+
 void AfterOpenDir(uv_fs_t* req) {
   FSReqBase* req_wrap = FSReqBase::from_req(req);
   FSReqAfterScope after(req_wrap, req);
@@ -356,6 +709,7 @@ void Initialize(Local<Object> target,
   Local<FunctionTemplate> dir = env->NewFunctionTemplate(DirHandle::New);
   dir->Inherit(AsyncWrap::GetConstructorTemplate(env));
   env->SetProtoMethod(dir, "read", DirHandle::Read);
+  env->SetProtoMethod(dir, "walk", DirHandle::Walk);
   env->SetProtoMethod(dir, "close", DirHandle::Close);
   Local<ObjectTemplate> dirt = dir->InstanceTemplate();
   dirt->SetInternalFieldCount(DirHandle::kDirHandleFieldCount);
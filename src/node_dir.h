@@ -5,6 +5,11 @@
 
 #include "node_file.h"
 
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace node {
 
 namespace fs_dir {
@@ -19,10 +24,31 @@ class DirHandle : public AsyncWrap {
 
   static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Read(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Walk(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Close(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   inline uv_dir_t* dir() { return dir_; }
 
+  struct WalkEntry {
+    std::string name;  // Relative to the directory the walk started in.
+    int type;          // uv_dirent_type_t
+  };
+
+  // Reads up to max_entries entries of a recursive walk into walk_entries().
+  // Returns 0 on success, or a libuv error code, in which case walk_syscall()
+  // and walk_path() describe the failed operation. An empty walk_entries()
+  // on success means that the walk is done. Does not touch JS and is run on
+  // the threadpool for asynchronous reads.
+  int WalkStep(size_t max_entries);
+  inline const std::vector<WalkEntry>& walk_entries() const {
+    return walk_entries_;
+  }
+  inline const char* walk_syscall() const { return walk_syscall_; }
+  inline const std::string& walk_path() const { return walk_path_; }
+  // Called on the event loop once a WalkStep() on the threadpool is done.
+  // Runs a close() that was made in the meantime.
+  void AfterWalkJob();
+
   void MemoryInfo(MemoryTracker* tracker) const override;
   SET_MEMORY_INFO_NAME(DirHandle)
   SET_SELF_SIZE(DirHandle)
@@ -37,12 +63,37 @@ class DirHandle : public AsyncWrap {
 
   // Synchronous close that emits a warning
   void GCClose();
+  // Closes the subdirectory that a recursive walk is currently reading.
+  void CloseWalk();
 
   uv_dir_t* dir_;
   // Multiple entries are read through a single libuv call.
   std::vector<uv_dirent_t> dirents_;
   bool closing_ = false;
   bool closed_ = false;
+
+  // Set while a WalkStep() runs on the threadpool. It uses dir_, dirents_
+  // and the walk state below without synchronization, so reads fail with
+  // UV_EBUSY in the meantime and closing the directory is postponed. The
+  // request of a postponed asynchronous close() is kept in close_req_.
+  bool walking_ = false;
+  bool close_pending_ = false;
+  std::unique_ptr<fs::FSReqBase> close_req_;
+
+  // State of a recursive walk. Directories that still have to be visited
+  // are kept as (path relative to walk_root_, depth) pairs, so that only
+  // one directory besides dir_ is open at any time.
+  bool walk_started_ = false;
+  std::string walk_root_;
+  int64_t walk_max_depth_ = -1;  // -1 means no limit.
+  uv_dir_t* walk_current_ = nullptr;
+  std::string walk_prefix_;
+  int64_t walk_depth_ = 0;
+  std::vector<std::pair<std::string, int64_t>> walk_pending_;
+  std::vector<WalkEntry> walk_entries_;
+  int walk_err_ = 0;
+  const char* walk_syscall_ = nullptr;
+  std::string walk_path_;
 };
 
 }  // namespace fs_dir
@@ -73,6 +73,23 @@ typedef struct {
 
 }  // extern "C"
 
+// Probes that are fired from C++ in several translation units. This needs a
+// "dtrace -h" header that can be used from any object file, which is the case
+// for systemtap on Linux and for macOS, but not for "dtrace -G" on illumos.
+// On Linux, the _ENABLED() check reads a semaphore that a tracer sets when
+// it attaches, so the arguments are evaluated only while someone is
+// listening.
+#if defined(HAVE_DTRACE) && (defined(__linux__) || defined(__APPLE__))
+#include "node_provider.h"
+#define NODE_USDT_PROBE(probe, ...)                                           \
+  do {                                                                        \
+    if (NODE_##probe##_ENABLED())                                             \
+      NODE_##probe(__VA_ARGS__);                                              \
+  } while (0)
+#else
+#define NODE_USDT_PROBE(probe, ...) do {} while (0)
+#endif
+
 namespace node {
 
 class Environment;
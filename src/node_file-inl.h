@@ -3,6 +3,7 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include "node_dtrace.h"
 #include "node_file.h"
 #include "req_wrap-inl.h"
 
@@ -239,6 +240,9 @@ FSReqBase* AsyncDestCall(Environment* env, FSReqBase* req_wrap,
     after(uv_req);  // after may delete req_wrap if there is an error
     req_wrap = nullptr;
   } else {
+    NODE_USDT_PROBE(FS_START, req_wrap, syscall);
+    if (env->performance_state()->threadpool_monitored())
+      req_wrap->set_queued_at(PERFORMANCE_NOW());
     req_wrap->SetReturnValue(args);
   }
 
@@ -23,6 +23,8 @@
 #include "aliased_buffer.h"
 #include "memory_tracker-inl.h"
 #include "node_buffer.h"
+#include "node_module_archive.h"
+#include "node_mutex.h"
 #include "node_process.h"
 #include "node_stat_watcher.h"
 #include "util-inl.h"
@@ -33,6 +35,7 @@
 #include "stream_base-inl.h"
 #include "string_bytes.h"
 #include "string_search.h"
+#include "threadpoolwork-inl.h"
 
 #include <fcntl.h>
 #include <sys/types.h>
@@ -45,13 +48,22 @@
 # include <io.h>
 #endif
 
+#ifdef __POSIX__
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 namespace node {
 
 namespace fs {
 
 using v8::Array;
+using v8::ArrayBuffer;
+using v8::BackingStore;
 using v8::Context;
 using v8::EscapableHandleScope;
 using v8::Function;
@@ -131,6 +143,7 @@ FileHandle::FileHandle(Environment* env, Local<Object> obj, int fd)
 
 FileHandle* FileHandle::New(Environment* env, int fd, Local<Object> obj) {
   if (obj.IsEmpty() && !env->fd_constructor_template()
+                            ->InstanceTemplate()
                             ->NewInstance(env->context())
                             .ToLocal(&obj)) {
     return nullptr;
@@ -150,6 +163,20 @@ void FileHandle::New(const FunctionCallbackInfo<Value>& args) {
     handle->read_offset_ = args[1]->IntegerValue(env->context()).FromJust();
   if (args[2]->IsNumber())
     handle->read_length_ = args[2]->IntegerValue(env->context()).FromJust();
+  if (args[3]->IsUint32() && handle->read_offset_ >= 0) {
+    constexpr uint32_t kMaxReadAhead = 64;
+    handle->read_ahead_ =
+        std::min(std::max(args[3].As<Uint32>()->Value(), 1u), kMaxReadAhead);
+#ifdef POSIX_FADV_SEQUENTIAL
+    // Let the kernel read ahead too, more than it does for random access.
+    if (handle->read_ahead_ > 1) {
+      posix_fadvise(handle->fd_,
+                    handle->read_offset_,
+                    std::max<int64_t>(handle->read_length_, 0),
+                    POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+  }
 }
 
 FileHandle::~FileHandle() {
@@ -167,6 +194,7 @@ int FileHandle::DoWrite(WriteWrap* w,
 
 void FileHandle::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("current_read", current_read_);
+  tracker->TrackField("read_ahead_queue", read_ahead_queue_);
 }
 
 // Close the file descriptor if it hasn't already been closed. A process
@@ -295,23 +323,12 @@ MaybeLocal<Promise> FileHandle::ClosePromise() {
       return MaybeLocal<Promise>();
     }
     CloseReq* req = new CloseReq(env(), close_req_obj, promise, object());
-    auto AfterClose = uv_fs_callback_t{[](uv_fs_t* req) {
-      std::unique_ptr<CloseReq> close(CloseReq::from_req(req));
-      CHECK_NOT_NULL(close);
-      close->file_handle()->AfterClose();
-      Isolate* isolate = close->env()->isolate();
-      if (req->result < 0) {
-        HandleScope handle_scope(isolate);
-        close->Reject(UVException(isolate, req->result, "close"));
-      } else {
-        close->Resolve();
-      }
-    }};
-    int ret = req->Dispatch(uv_fs_close, fd_, AfterClose);
-    if (ret < 0) {
-      req->Reject(UVException(isolate, ret, "close"));
-      delete req;
-    }
+    // Reads that are still in flight could otherwise end up reading from
+    // another file that reuses the descriptor.
+    if (ReadAheadInFlight())
+      deferred_close_ = req;
+    else
+      DispatchClose(req);
   } else {
     // Already closed. Just reject the promise immediately
     resolver->Reject(context, UVException(isolate, UV_EBADF, "close"))
@@ -320,6 +337,27 @@ MaybeLocal<Promise> FileHandle::ClosePromise() {
   return scope.Escape(promise);
 }
 
+void FileHandle::DispatchClose(CloseReq* req) {
+  auto AfterClose = uv_fs_callback_t{[](uv_fs_t* req) {
+    std::unique_ptr<CloseReq> close(CloseReq::from_req(req));
+    CHECK_NOT_NULL(close);
+    close->file_handle()->AfterClose();
+    Isolate* isolate = close->env()->isolate();
+    if (req->result < 0) {
+      HandleScope handle_scope(isolate);
+      close->Reject(UVException(isolate, req->result, "close"));
+    } else {
+      close->Resolve();
+    }
+  }};
+  int ret = req->Dispatch(uv_fs_close, fd_, AfterClose);
+  if (ret < 0) {
+    HandleScope handle_scope(env()->isolate());
+    req->Reject(UVException(env()->isolate(), ret, "close"));
+    delete req;
+  }
+}
+
 void FileHandle::Close(const FunctionCallbackInfo<Value>& args) {
   FileHandle* fd;
   ASSIGN_OR_RETURN_UNWRAP(&fd, args.Holder());
@@ -336,6 +374,12 @@ void FileHandle::ReleaseFD(const FunctionCallbackInfo<Value>& args) {
   fd->AfterClose();
 }
 
+int FileHandle::Release() {
+  int fd = fd_;
+  AfterClose();
+  return fd;
+}
+
 
 void FileHandle::AfterClose() {
   closing_ = false;
@@ -347,6 +391,7 @@ void FileHandle::AfterClose() {
 
 void FileHandleReadWrap::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("buffer", buffer_);
+  tracker->TrackFieldWithSize("data", data_.size);
   tracker->TrackField("file_handle", this->file_handle_);
 }
 
@@ -354,46 +399,71 @@ FileHandleReadWrap::FileHandleReadWrap(FileHandle* handle, Local<Object> obj)
   : ReqWrap(handle->env(), obj, AsyncWrap::PROVIDER_FSREQCALLBACK),
     file_handle_(handle) {}
 
+std::unique_ptr<FileHandleReadWrap> FileHandle::NewReadWrap() {
+  // Create a new FileHandleReadWrap or re-use one.
+  // Either way, we need these two scopes for AsyncReset() or otherwise
+  // for creating the new instance.
+  HandleScope handle_scope(env()->isolate());
+  AsyncHooks::DefaultTriggerAsyncIdScope trigger_scope(this);
+
+  auto& freelist = env()->file_handle_read_wrap_freelist();
+  if (freelist.size() > 0) {
+    std::unique_ptr<FileHandleReadWrap> read_wrap =
+        std::move(freelist.back());
+    freelist.pop_back();
+    read_wrap->AsyncReset();
+    read_wrap->file_handle_ = this;
+    return read_wrap;
+  }
+  Local<Object> wrap_obj;
+  if (!env()
+           ->filehandlereadwrap_template()
+           ->NewInstance(env()->context())
+           .ToLocal(&wrap_obj)) {
+    return nullptr;
+  }
+  return std::make_unique<FileHandleReadWrap>(this, wrap_obj);
+}
+
+void FileHandle::RecycleReadWrap(
+    std::unique_ptr<FileHandleReadWrap> read_wrap) {
+  // Push the read wrap back to the freelist, or let it be destroyed
+  // once we’re exiting the current scope.
+  constexpr size_t wanted_freelist_fill = 100;
+  auto& freelist = env()->file_handle_read_wrap_freelist();
+  if (freelist.size() < wanted_freelist_fill) {
+    read_wrap->Reset();
+    read_wrap->data_ = MallocedBuffer<char>();
+    read_wrap->done_ = false;
+    freelist.emplace_back(std::move(read_wrap));
+  }
+}
+
 int FileHandle::ReadStart() {
   if (!IsAlive() || IsClosing())
     return UV_EOF;
 
   reading_ = true;
 
-  if (current_read_)
+  if (read_ahead_ > 1 && read_offset_ >= 0) {
+    // When called from a listener during ReadAhead(), the loop there goes on.
+    if (!in_read_ahead_)
+      ReadAhead();
     return 0;
+  }
 
-  std::unique_ptr<FileHandleReadWrap> read_wrap;
+  if (current_read_)
+    return 0;
 
   if (read_length_ == 0) {
     EmitRead(UV_EOF);
     return 0;
   }
 
-  {
-    // Create a new FileHandleReadWrap or re-use one.
-    // Either way, we need these two scopes for AsyncReset() or otherwise
-    // for creating the new instance.
-    HandleScope handle_scope(env()->isolate());
-    AsyncHooks::DefaultTriggerAsyncIdScope trigger_scope(this);
-
-    auto& freelist = env()->file_handle_read_wrap_freelist();
-    if (freelist.size() > 0) {
-      read_wrap = std::move(freelist.back());
-      freelist.pop_back();
-      read_wrap->AsyncReset();
-      read_wrap->file_handle_ = this;
-    } else {
-      Local<Object> wrap_obj;
-      if (!env()
-               ->filehandlereadwrap_template()
-               ->NewInstance(env()->context())
-               .ToLocal(&wrap_obj)) {
-        return UV_EBUSY;
-      }
-      read_wrap = std::make_unique<FileHandleReadWrap>(this, wrap_obj);
-    }
-  }
+  std::unique_ptr<FileHandleReadWrap> read_wrap = NewReadWrap();
+  if (!read_wrap)
+    return UV_EBUSY;
+
   int64_t recommended_read = 65536;
   if (read_length_ >= 0 && read_length_ <= recommended_read)
     recommended_read = read_length_;
@@ -426,14 +496,7 @@ int FileHandle::ReadStart() {
 
     uv_fs_req_cleanup(req);
 
-    // Push the read wrap back to the freelist, or let it be destroyed
-    // once we’re exiting the current scope.
-    constexpr size_t wanted_freelist_fill = 100;
-    auto& freelist = handle->env()->file_handle_read_wrap_freelist();
-    if (freelist.size() < wanted_freelist_fill) {
-      read_wrap->Reset();
-      freelist.emplace_back(std::move(read_wrap));
-    }
+    handle->RecycleReadWrap(std::move(read_wrap));
 
     if (result >= 0) {
       // Read at most as many bytes as we originally planned to.
@@ -465,6 +528,149 @@ int FileHandle::ReadStart() {
   return 0;
 }
 
+// Hands the data of the completed reads at the front of the queue to the
+// listener, until it tells us to stop.
+void FileHandle::HandOutReadAhead() {
+  while (!read_ahead_queue_.empty() && read_ahead_queue_.front()->done_) {
+    FileHandleReadWrap* read_wrap = read_ahead_queue_.front().get();
+    if (read_ahead_ended_) {
+      RecycleReadWrap(std::move(read_ahead_queue_.front()));
+      read_ahead_queue_.pop_front();
+      continue;
+    }
+    if (!reading_)
+      break;
+
+    // Reading 0 bytes from a file always means EOF, or that we reached
+    // the end of the requested range.
+    if (read_wrap->result_ <= 0) {
+      const int result = read_wrap->result_ == 0 ?
+          static_cast<int>(UV_EOF) : static_cast<int>(read_wrap->result_);
+      read_ahead_ended_ = true;
+      read_length_ = 0;
+      RecycleReadWrap(std::move(read_ahead_queue_.front()));
+      read_ahead_queue_.pop_front();
+      EmitRead(result);
+      continue;
+    }
+
+    // Copy the data into as many buffers as the listener hands out, until
+    // it tells us to stop.
+    const size_t result = static_cast<size_t>(read_wrap->result_);
+    while (reading_ && read_wrap->consumed_ < result) {
+      const size_t left = result - read_wrap->consumed_;
+      uv_buf_t buffer = EmitAlloc(left);
+      const size_t length = std::min(left, buffer.len);
+      memcpy(buffer.base, read_wrap->data_.data + read_wrap->consumed_, length);
+      read_wrap->consumed_ += length;
+      EmitRead(length, buffer);
+    }
+    if (read_wrap->consumed_ < result)
+      break;
+
+    if (result < read_wrap->length_) {
+      // A short read that is not necessarily at the end of the file. Read
+      // the rest of its range before handing out the data of later reads.
+      read_wrap->offset_ += result;
+      read_wrap->length_ -= result;
+      DispatchReadAhead(read_wrap);
+      break;
+    }
+
+    RecycleReadWrap(std::move(read_ahead_queue_.front()));
+    read_ahead_queue_.pop_front();
+  }
+}
+
+void FileHandle::ReadAhead() {
+  in_read_ahead_ = true;
+  do {
+    HandOutReadAhead();
+    while (reading_ && !read_ahead_ended_ &&
+           read_ahead_queue_.size() < read_ahead_ && QueueReadAhead()) {}
+    // Reads that could not be dispatched are complete right away.
+  } while (reading_ && !read_ahead_queue_.empty() &&
+           read_ahead_queue_.front()->done_);
+
+  if (reading_ && read_ahead_queue_.empty() && read_length_ == 0 &&
+      !read_ahead_ended_) {
+    read_ahead_ended_ = true;
+    EmitRead(UV_EOF);
+  }
+  in_read_ahead_ = false;
+
+  if (ReadAheadInFlight()) {
+    if (!read_ahead_strong_) {
+      read_ahead_strong_ = true;
+      ClearWeak();
+    }
+    return;
+  }
+  if (read_ahead_strong_) {
+    read_ahead_strong_ = false;
+    MakeWeak();
+  }
+  if (deferred_close_ != nullptr) {
+    CloseReq* req = deferred_close_;
+    deferred_close_ = nullptr;
+    DispatchClose(req);
+  }
+}
+
+bool FileHandle::ReadAheadInFlight() const {
+  for (const auto& read_wrap : read_ahead_queue_) {
+    if (!read_wrap->done_)
+      return true;
+  }
+  return false;
+}
+
+bool FileHandle::QueueReadAhead() {
+  if (read_length_ == 0 || !IsAlive() || IsClosing())
+    return false;
+  std::unique_ptr<FileHandleReadWrap> read_wrap = NewReadWrap();
+  if (!read_wrap)
+    return false;
+
+  size_t length = 65536;
+  if (read_length_ >= 0 && static_cast<uint64_t>(read_length_) < length)
+    length = static_cast<size_t>(read_length_);
+  read_wrap->data_ = MallocedBuffer<char>(length);
+  read_wrap->offset_ = read_offset_;
+  read_wrap->length_ = length;
+  read_offset_ += length;
+  if (read_length_ >= 0)
+    read_length_ -= length;
+
+  DispatchReadAhead(read_wrap.get());
+  read_ahead_queue_.emplace_back(std::move(read_wrap));
+  return true;
+}
+
+void FileHandle::DispatchReadAhead(FileHandleReadWrap* read_wrap) {
+  read_wrap->Reset();
+  read_wrap->consumed_ = 0;
+  read_wrap->result_ = 0;
+  read_wrap->done_ = false;
+  uv_buf_t buffer = uv_buf_init(read_wrap->data_.data, read_wrap->length_);
+  const int err = read_wrap->Dispatch(uv_fs_read,
+                                      fd_,
+                                      &buffer,
+                                      1,
+                                      read_wrap->offset_,
+                                      uv_fs_callback_t{[](uv_fs_t* req) {
+    FileHandleReadWrap* read_wrap = FileHandleReadWrap::from_req(req);
+    read_wrap->result_ = req->result;
+    read_wrap->done_ = true;
+    uv_fs_req_cleanup(req);
+    read_wrap->file_handle_->ReadAhead();
+  }});
+  if (err < 0) {
+    read_wrap->result_ = err;
+    read_wrap->done_ = true;
+  }
+}
+
 int FileHandle::ReadStop() {
   reading_ = false;
   return 0;
@@ -528,6 +734,15 @@ FSReqAfterScope::FSReqAfterScope(FSReqBase* wrap, uv_fs_t* req)
       handle_scope_(wrap->env()->isolate()),
       context_scope_(wrap->env()->context()) {
   CHECK_EQ(wrap_->req(), req);
+  NODE_USDT_PROBE(FS_DONE, wrap_, wrap_->syscall(),
+                  static_cast<int64_t>(req->result));
+  if (wrap_->queued_at() != 0) {
+    wrap_->env()->performance_state()->RecordThreadPoolWork(
+        performance::NODE_THREADPOOL_WORK_KIND_FS,
+        wrap_->queued_at(),
+        0,
+        PERFORMANCE_NOW());
+  }
 }
 
 FSReqAfterScope::~FSReqAfterScope() {
@@ -806,22 +1021,140 @@ void Close(const FunctionCallbackInfo<Value>& args) {
 }
 
 
-// Used to speed up module loading.  Returns the contents of the file as
-// a string or undefined when the file cannot be opened or "main" is not found
-// in the file.
-static void InternalModuleReadJSON(const FunctionCallbackInfo<Value>& args) {
-  Environment* env = Environment::GetCurrent(args);
-  Isolate* isolate = env->isolate();
-  uv_loop_t* loop = env->event_loop();
+namespace {
 
-  CHECK(args[0]->IsString());
-  node::Utf8Value path(isolate, args[0]);
+// The results of module resolution that are shared by all threads of the
+// process, so that Workers do not repeat the file system lookups that the
+// main thread has already done. Clearing the cache starts a new generation,
+// and results that were computed during an earlier generation are dropped.
+// package.json files are only cached while they exist, along with the size
+// and modification time they had when they were read, so that a cheap stat()
+// tells whether an entry is still current.
+class ModuleResolutionCache {
+ public:
+  enum PackageJsonState { kMissing, kNoRelevantFields, kContents };
 
-  if (strlen(*path) != path.length())
-    return;  // Contains a nul byte.
+  struct PackageJson {
+    PackageJsonState state = kMissing;
+    std::string contents;
+    uint64_t size = 0;
+    uv_timespec_t mtime {};
+  };
+
+  uint64_t generation() {
+    Mutex::ScopedLock lock(mutex_);
+    return generation_;
+  }
+
+  bool GetPackageJson(const std::string& path, PackageJson* entry) {
+    Mutex::ScopedLock lock(mutex_);
+    auto it = package_jsons_.find(path);
+    if (it == package_jsons_.end())
+      return false;
+    *entry = it->second;
+    return true;
+  }
+
+  void SetPackageJson(uint64_t generation,
+                      const std::string& path,
+                      const PackageJson& entry) {
+    Mutex::ScopedLock lock(mutex_);
+    if (generation != generation_)
+      return;
+    // The file may be created later, like for negative stat() results.
+    if (entry.state == kMissing)
+      package_jsons_.erase(path);
+    else
+      package_jsons_[path] = entry;
+  }
+
+  bool GetPath(const std::string& key, std::string* filename) {
+    Mutex::ScopedLock lock(mutex_);
+    auto it = paths_.find(key);
+    if (it == paths_.end())
+      return false;
+    *filename = it->second;
+    return true;
+  }
+
+  void SetPath(uint64_t generation,
+               const std::string& key,
+               const std::string& filename) {
+    Mutex::ScopedLock lock(mutex_);
+    if (generation == generation_)
+      paths_.emplace(key, filename);
+  }
+
+  void Clear() {
+    Mutex::ScopedLock lock(mutex_);
+    generation_++;
+    package_jsons_.clear();
+    paths_.clear();
+  }
+
+ private:
+  Mutex mutex_;
+  uint64_t generation_ = 0;
+  std::unordered_map<std::string, PackageJson> package_jsons_;
+  std::unordered_map<std::string, std::string> paths_;
+};
+
+ModuleResolutionCache module_resolution_cache;
+
+// Only the package.json files that contain the fields that the module
+// loader looks at are returned to JavaScript.
+void ScanPackageJson(const char* data,
+                     size_t length,
+                     ModuleResolutionCache::PackageJson* entry) {
+  size_t start = 0;
+  if (length >= 3 && 0 == memcmp(data, "\xEF\xBB\xBF", 3)) {
+    start = 3;  // Skip UTF-8 BOM.
+  }
+
+  const size_t size = length - start;
+  const char* p = data + start;
+  const char* pe = p + size;
+  const char* pos[2];
+  const char** ppos = &pos[0];
+
+  while (p < pe) {
+    char c = *p++;
+    if (c == '"') goto quote;  // Keeps code flat and inner loop small.
+    if (c == '\\' && p < pe && *p == '"') p++;
+    continue;
+quote:
+    *ppos++ = p;
+    if (ppos < &pos[2]) continue;
+    ppos = &pos[0];
+
+    const char* s = &pos[0][0];
+    const char* se = &pos[1][-1];  // Exclude quote.
+    size_t n = se - s;
+
+    if (n == 4) {
+      if (0 == memcmp(s, "main", 4)) break;
+      if (0 == memcmp(s, "name", 4)) break;
+      if (0 == memcmp(s, "type", 4)) break;
+    } else if (n == 7) {
+      if (0 == memcmp(s, "exports", 7)) break;
+    }
+  }
+
+  if (p < pe) {
+    entry->state = ModuleResolutionCache::kContents;
+    entry->contents.assign(data + start, size);
+  } else {
+    entry->state = ModuleResolutionCache::kNoRelevantFields;
+  }
+}
+
+void ReadPackageJson(uv_loop_t* loop,
+                     const char* path,
+                     ModuleResolutionCache::PackageJson* entry) {
+  entry->state = ModuleResolutionCache::kMissing;
 
   uv_fs_t open_req;
-  const int fd = uv_fs_open(loop, &open_req, *path, O_RDONLY, 0, nullptr);
+  const int fd = uv_fs_open(loop, &open_req, path, O_RDONLY, 0, nullptr);
   uv_fs_req_cleanup(&open_req);
 
   if (fd < 0) {
@@ -834,6 +1167,14 @@ static void InternalModuleReadJSON(const FunctionCallbackInfo<Value>& args) {
     uv_fs_req_cleanup(&close_req);
   });
 
+  uv_fs_t stat_req;
+  const int err = uv_fs_fstat(loop, &stat_req, fd, nullptr);
+  entry->size = stat_req.statbuf.st_size;
+  entry->mtime = stat_req.statbuf.st_mtim;
+  uv_fs_req_cleanup(&stat_req);
+  if (err < 0)
+    return;
+
   const size_t kBlockSize = 32 << 10;
   std::vector<char> chars;
   int64_t offset = 0;
@@ -856,52 +1197,106 @@ static void InternalModuleReadJSON(const FunctionCallbackInfo<Value>& args) {
     offset += numchars;
   } while (static_cast<size_t>(numchars) == kBlockSize);
 
-  size_t start = 0;
-  if (offset >= 3 && 0 == memcmp(&chars[0], "\xEF\xBB\xBF", 3)) {
-    start = 3;  // Skip UTF-8 BOM.
-  }
+  ScanPackageJson(chars.data(), offset, entry);
+}
 
-  const size_t size = offset - start;
-  char* p = &chars[start];
-  char* pe = &chars[size];
-  char* pos[2];
-  char** ppos = &pos[0];
+// Whether the file has not changed since |entry| was read from it.
+bool IsPackageJsonCurrent(uv_loop_t* loop,
+                          const char* path,
+                          const ModuleResolutionCache::PackageJson& entry) {
+  uv_fs_t req;
+  const int err = uv_fs_stat(loop, &req, path, nullptr);
+  const bool current = err == 0 &&
+                       req.statbuf.st_size == entry.size &&
+                       req.statbuf.st_mtim.tv_sec == entry.mtime.tv_sec &&
+                       req.statbuf.st_mtim.tv_nsec == entry.mtime.tv_nsec;
+  uv_fs_req_cleanup(&req);
+  return current;
+}
 
-  while (p < pe) {
-    char c = *p++;
-    if (c == '"') goto quote;  // Keeps code flat and inner loop small.
-    if (c == '\\' && p < pe && *p == '"') p++;
-    continue;
-quote:
-    *ppos++ = p;
-    if (ppos < &pos[2]) continue;
-    ppos = &pos[0];
+}  // anonymous namespace
 
-    char* s = &pos[0][0];
-    char* se = &pos[1][-1];  // Exclude quote.
-    size_t n = se - s;
+// Used to speed up module loading.  Returns the contents of the file as
+// a string or undefined when the file cannot be opened or "main" is not found
+// in the file. The results are shared by all threads of the process.
+static void InternalModuleReadJSON(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
 
-    if (n == 4) {
-      if (0 == memcmp(s, "main", 4)) break;
-      if (0 == memcmp(s, "name", 4)) break;
-      if (0 == memcmp(s, "type", 4)) break;
-    } else if (n == 7) {
-      if (0 == memcmp(s, "exports", 7)) break;
-    }
+  CHECK(args[0]->IsString());
+  node::Utf8Value path(isolate, args[0]);
+
+  if (strlen(*path) != path.length())
+    return;  // Contains a nul byte.
+
+  const std::string key(*path, path.length());
+  ModuleResolutionCache::PackageJson entry;
+  ModuleArchive::Entry archived;
+  const ModuleArchive* archive = ModuleArchive::Get();
+  if (archive != nullptr && archive->Find(key, &archived)) {
+    ScanPackageJson(archived.data, archived.length, &entry);
+  } else if (!module_resolution_cache.GetPackageJson(key, &entry) ||
+             !IsPackageJsonCurrent(env->event_loop(), *path, entry)) {
+    const uint64_t generation = module_resolution_cache.generation();
+    entry = ModuleResolutionCache::PackageJson();
+    ReadPackageJson(env->event_loop(), *path, &entry);
+    module_resolution_cache.SetPackageJson(generation, key, entry);
   }
 
-  Local<String> return_value;
-  if (p < pe) {
-    return_value =
-        String::NewFromUtf8(isolate,
-                            &chars[start],
-                            v8::NewStringType::kNormal,
-                            size).ToLocalChecked();
-  } else {
-    return_value = env->empty_object_string();
+  switch (entry.state) {
+    case ModuleResolutionCache::kMissing:
+      return;
+    case ModuleResolutionCache::kNoRelevantFields:
+      args.GetReturnValue().Set(env->empty_object_string());
+      return;
+    case ModuleResolutionCache::kContents:
+      args.GetReturnValue().Set(
+          String::NewFromUtf8(isolate,
+                              entry.contents.data(),
+                              v8::NewStringType::kNormal,
+                              entry.contents.size()).ToLocalChecked());
+      return;
   }
+}
+
+// Returns the filename that Module._findPath() has resolved for `key` in any
+// thread of the process, or undefined.
+static void GetCachedModulePath(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  node::Utf8Value key(env->isolate(), args[0]);
 
-  args.GetReturnValue().Set(return_value);
+  std::string filename;
+  if (!module_resolution_cache.GetPath(*key, &filename))
+    return;
+  args.GetReturnValue().Set(
+      String::NewFromUtf8(env->isolate(),
+                          filename.data(),
+                          v8::NewStringType::kNormal,
+                          filename.size()).ToLocalChecked());
+}
+
+// setCachedModulePath(generation, key, filename)
+static void SetCachedModulePath(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsNumber());
+  CHECK(args[1]->IsString());
+  CHECK(args[2]->IsString());
+  const uint64_t generation = args[0].As<Number>()->Value();
+  node::Utf8Value key(env->isolate(), args[1]);
+  node::Utf8Value filename(env->isolate(), args[2]);
+  module_resolution_cache.SetPath(generation, *key, *filename);
+}
+
+static void GetModuleResolutionCacheGeneration(
+    const FunctionCallbackInfo<Value>& args) {
+  args.GetReturnValue().Set(
+      static_cast<double>(module_resolution_cache.generation()));
+}
+
+static void ClearModuleResolutionCache(
+    const FunctionCallbackInfo<Value>& args) {
+  module_resolution_cache.Clear();
 }
 
 // Used to speed up module loading.  Returns 0 if the path refers to
@@ -913,6 +1308,17 @@ static void InternalModuleStat(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsString());
   node::Utf8Value path(env->isolate(), args[0]);
 
+  if (const ModuleArchive* archive = ModuleArchive::Get()) {
+    switch (archive->GetPathType(*path)) {
+      case ModuleArchive::PathType::kFile:
+        return args.GetReturnValue().Set(0);
+      case ModuleArchive::PathType::kDirectory:
+        return args.GetReturnValue().Set(1);
+      case ModuleArchive::PathType::kNone:
+        break;
+    }
+  }
+
   uv_fs_t req;
   int rc = uv_fs_stat(env->event_loop(), &req, *path, nullptr);
   if (rc == 0) {
@@ -924,6 +1330,85 @@ static void InternalModuleStat(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(rc);
 }
 
+// Returns 0 if the path refers to a file in the module archive, 1 when it's
+// a directory in the archive, or -1 if it is not part of the archive.
+static void InternalModuleArchiveStat(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(args[0]->IsString());
+  node::Utf8Value path(env->isolate(), args[0]);
+
+  int rc = -1;
+  if (const ModuleArchive* archive = ModuleArchive::Get()) {
+    switch (archive->GetPathType(*path)) {
+      case ModuleArchive::PathType::kFile:
+        rc = 0;
+        break;
+      case ModuleArchive::PathType::kDirectory:
+        rc = 1;
+        break;
+      case ModuleArchive::PathType::kNone:
+        break;
+    }
+  }
+  args.GetReturnValue().Set(rc);
+}
+
+// Returns the contents of a file in the module archive as a string, or
+// undefined if the file is not part of the archive.
+static void InternalModuleReadArchive(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(args[0]->IsString());
+  node::Utf8Value path(env->isolate(), args[0]);
+
+  const ModuleArchive* archive = ModuleArchive::Get();
+  ModuleArchive::Entry entry;
+  if (archive == nullptr || !archive->Find(*path, &entry))
+    return;
+
+  Local<String> contents;
+  if (String::NewFromUtf8(env->isolate(),
+                          entry.data,
+                          v8::NewStringType::kNormal,
+                          entry.length).ToLocal(&contents)) {
+    args.GetReturnValue().Set(contents);
+  }
+}
+
+// internalModuleArchiveCodeCache(path, source) returns a copy of the code
+// cache that is stored in the module archive for a file, or undefined. V8
+// does not verify that code caches match the source, so `source` has to be
+// the contents of the file.
+static void InternalModuleArchiveCodeCache(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsString());
+  node::Utf8Value path(env->isolate(), args[0]);
+
+  const ModuleArchive* archive = ModuleArchive::Get();
+  ModuleArchive::Entry entry;
+  if (archive == nullptr ||
+      !archive->Find(*path, &entry) ||
+      entry.cached_data == nullptr) {
+    return;
+  }
+
+  node::Utf8Value source(env->isolate(), args[1]);
+  if (source.length() != entry.length ||
+      memcmp(*source, entry.data, entry.length) != 0) {
+    return;
+  }
+
+  Local<Object> buffer;
+  if (Buffer::Copy(env, entry.cached_data, entry.cached_data_length)
+          .ToLocal(&buffer)) {
+    args.GetReturnValue().Set(buffer);
+  }
+}
+
 static void Stat(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -1015,6 +1500,119 @@ static void FStat(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+// Runs a batch of stat() or lstat() calls in a single threadpool job, so that
+// callers that stat many files in a row (module resolution, static file
+// servers, build tools) pay for one request and one wakeup per batch instead
+// of per file.
+class StatManyJob final : public ThreadPoolWork {
+ public:
+  StatManyJob(Environment* env,
+              FSReqBase* req_wrap,
+              std::vector<std::string>&& paths,
+              bool follow_links)
+      : ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_KIND_FS),
+        req_wrap_(req_wrap),
+        paths_(std::move(paths)),
+        follow_links_(follow_links),
+        stats_(paths_.size()),
+        errors_(paths_.size()) {}
+
+  void DoThreadPoolWork() override;
+  void AfterThreadPoolWork(int status) override;
+
+ private:
+  template <typename AliasedBufferT>
+  Local<Value> FillStatsArrays(const AliasedInt32Array& errors);
+
+  std::unique_ptr<FSReqBase> req_wrap_;
+  std::vector<std::string> paths_;
+  const bool follow_links_;
+  std::vector<uv_stat_t> stats_;
+  std::vector<int> errors_;
+};
+
+void StatManyJob::DoThreadPoolWork() {
+  for (size_t i = 0; i < paths_.size(); i++) {
+    uv_fs_t req;
+    const int err = follow_links_ ?
+        uv_fs_stat(nullptr, &req, paths_[i].c_str(), nullptr) :
+        uv_fs_lstat(nullptr, &req, paths_[i].c_str(), nullptr);
+    if (err == 0)
+      stats_[i] = req.statbuf;
+    errors_[i] = err;
+    uv_fs_req_cleanup(&req);
+  }
+}
+
+template <typename AliasedBufferT>
+Local<Value> StatManyJob::FillStatsArrays(const AliasedInt32Array& errors) {
+  static constexpr size_t kFieldsNumber =
+      static_cast<size_t>(FsStatsOffset::kFsStatsFieldsNumber);
+  Isolate* isolate = env()->isolate();
+  AliasedBufferT stats(isolate, paths_.size() * kFieldsNumber);
+  for (size_t i = 0; i < paths_.size(); i++) {
+    if (errors_[i] == 0)
+      FillStatsArray(&stats, &stats_[i], i * kFieldsNumber);
+  }
+  Local<Value> values[] = { stats.GetJSArray(), errors.GetJSArray() };
+  return Array::New(isolate, values, arraysize(values));
+}
+
+void StatManyJob::AfterThreadPoolWork(int status) {
+  CHECK(status == 0 || status == UV_ECANCELED);
+  std::unique_ptr<StatManyJob> job(this);
+  if (status == UV_ECANCELED) return;
+
+  HandleScope handle_scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+
+  AliasedInt32Array errors(env()->isolate(), errors_.size());
+  for (size_t i = 0; i < errors_.size(); i++)
+    errors[i] = errors_[i];
+
+  req_wrap_->Resolve(req_wrap_->use_bigint() ?
+      FillStatsArrays<AliasedBigUint64Array>(errors) :
+      FillStatsArrays<AliasedFloat64Array>(errors));
+}
+
+/* fs.statMany(paths, use_bigint, follow_links, req)
+ * Resolves with [stats, errors]: the stats of paths[i] are stored at offset
+ * i * kFsStatsFieldsNumber in the same layout FillStatsArray() uses, and
+ * errors[i] is the error code of the stat() call for paths[i], or 0.
+ */
+static void StatMany(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  const int argc = args.Length();
+  CHECK_GE(argc, 4);
+
+  CHECK(args[0]->IsArray());
+  Local<Array> paths_array = args[0].As<Array>();
+  CHECK_GT(paths_array->Length(), 0);
+
+  std::vector<std::string> paths(paths_array->Length());
+  for (uint32_t i = 0; i < paths.size(); i++) {
+    Local<Value> value;
+    if (!paths_array->Get(env->context(), i).ToLocal(&value))
+      return;
+    BufferValue path(env->isolate(), value);
+    CHECK_NOT_NULL(*path);
+    paths[i] = path.ToString();
+  }
+
+  bool use_bigint = args[1]->IsTrue();
+  bool follow_links = args[2]->IsTrue();
+
+  FSReqBase* req_wrap_async = GetReqWrap(env, args[3], use_bigint);
+  CHECK_NOT_NULL(req_wrap_async);
+  req_wrap_async->SetReturnValue(args);
+
+  auto job = std::make_unique<StatManyJob>(
+      env, req_wrap_async, std::move(paths), follow_links);
+  job->ScheduleWork();
+  job.release();  // Deleted in AfterThreadPoolWork().
+}
+
 static void Symlink(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   Isolate* isolate = env->isolate();
@@ -1972,6 +2570,432 @@ static void Read(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// Wrapper for readv(2).
+//
+// bytesRead = fs.readv(fd, buffers[, position], callback)
+// 0 fd        integer. file descriptor
+// 1 buffers   array of buffers to read
+// 2 position  if integer, position to read at in the file.
+//             if null, read from the current position
+static void ReadBuffers(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  const int argc = args.Length();
+  CHECK_GE(argc, 3);
+
+  CHECK(args[0]->IsInt32());
+  const int fd = args[0].As<Int32>()->Value();
+
+  CHECK(args[1]->IsArray());
+  Local<Array> buffers = args[1].As<Array>();
+
+  int64_t pos = GetOffset(args[2]);  // -1 if not a valid JS int
+
+  MaybeStackBuffer<uv_buf_t> iovs(buffers->Length());
+
+  // Init uv buffers from ArrayBufferViews
+  for (uint32_t i = 0; i < iovs.length(); i++) {
+    Local<Value> buffer = buffers->Get(env->context(), i).ToLocalChecked();
+    CHECK(Buffer::HasInstance(buffer));
+    iovs[i] = uv_buf_init(Buffer::Data(buffer), Buffer::Length(buffer));
+  }
+
+  FSReqBase* req_wrap_async = GetReqWrap(env, args[3]);
+  if (req_wrap_async != nullptr) {  // readBuffers(fd, buffers, pos, req)
+    AsyncCall(env, req_wrap_async, args, "read", UTF8, AfterInteger,
+              uv_fs_read, fd, *iovs, iovs.length(), pos);
+  } else {  // readBuffers(fd, buffers, undefined, ctx)
+    CHECK_EQ(argc, 5);
+    FSReqWrapSync req_wrap_sync;
+    FS_SYNC_TRACE_BEGIN(read);
+    int bytesRead = SyncCall(env, /* ctx */ args[4], &req_wrap_sync, "read",
+                             uv_fs_read, fd, *iovs, iovs.length(), pos);
+    FS_SYNC_TRACE_END(read, "bytesRead", bytesRead);
+    args.GetReturnValue().Set(bytesRead);
+  }
+}
+
+
+// Wrapper for sendfile(2) between two file descriptors. On Linux, libuv
+// copies between files with copy_file_range(2) where possible, which keeps
+// the data inside the kernel and can share extents on file systems that
+// support reflinks.
+//
+// Used by filehandle.pipeTo().
+//
+// bytesCopied = copyFileRange(outFd, inFd, inOffset, length, req)
+// 0 outFd     integer. file descriptor to write to, at its current position
+// 1 inFd      integer. file descriptor to read from
+// 2 inOffset  integer. position to read at in inFd; does not move the
+//             position of inFd
+// 3 length    integer. maximum number of bytes to copy
+static void CopyFileRange(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  const int argc = args.Length();
+  CHECK_GE(argc, 5);
+
+  CHECK(args[0]->IsInt32());
+  const int out_fd = args[0].As<Int32>()->Value();
+
+  CHECK(args[1]->IsInt32());
+  const int in_fd = args[1].As<Int32>()->Value();
+
+  CHECK(IsSafeJsInt(args[2]));
+  const int64_t in_offset = args[2].As<Integer>()->Value();
+  CHECK_GE(in_offset, 0);
+
+  CHECK(IsSafeJsInt(args[3]));
+  const int64_t length = args[3].As<Integer>()->Value();
+  CHECK_GE(length, 0);
+
+  FSReqBase* req_wrap_async = GetReqWrap(env, args[4]);
+  if (req_wrap_async != nullptr) {  // copyFileRange(out, in, off, len, req)
+    AsyncCall(env, req_wrap_async, args, "sendfile", UTF8, AfterInteger,
+              uv_fs_sendfile, out_fd, in_fd, in_offset, length);
+  } else {  // copyFileRange(out, in, off, len, undefined, ctx)
+    CHECK_EQ(argc, 6);
+    FSReqWrapSync req_wrap_sync;
+    FS_SYNC_TRACE_BEGIN(sendfile);
+    int bytesCopied = SyncCall(env, args[5], &req_wrap_sync, "sendfile",
+                               uv_fs_sendfile, out_fd, in_fd, in_offset,
+                               length);
+    FS_SYNC_TRACE_END(sendfile, "bytesCopied", bytesCopied);
+    args.GetReturnValue().Set(bytesCopied);
+  }
+}
+
+
+#ifdef __POSIX__
+// Values of the advice argument of mapFile().
+enum MapAdvice : int32_t {
+  kMapAdviceNormal,
+  kMapAdviceSequential,
+  kMapAdviceRandom,
+  kMapAdviceWillNeed
+};
+
+// Memory mapping of files, used by filehandle.map().
+//
+// buffer = mapFile(fd, offset, length, advice, undefined, ctx)
+// 0 fd      integer. file descriptor opened for reading
+// 1 offset  integer. position in the file to map from, need not be aligned
+// 2 length  integer. number of bytes to map, > 0
+// 3 advice  integer. one of the kMapAdvice* constants, passed to madvise(2)
+//
+// The mapping is private, so that writes to the Buffer copy the touched
+// pages instead of crashing the process or reaching the file, and backs the
+// ArrayBuffer of the returned Buffer.
+// It is unmapped when the ArrayBuffer is garbage collected, or when it is
+// detached by unmapFile().
+static void MapFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  const int argc = args.Length();
+  CHECK_EQ(argc, 6);
+
+  CHECK(args[0]->IsInt32());
+  const int fd = args[0].As<Int32>()->Value();
+
+  CHECK(IsSafeJsInt(args[1]));
+  const int64_t offset = args[1].As<Integer>()->Value();
+  CHECK_GE(offset, 0);
+
+  CHECK(IsSafeJsInt(args[2]));
+  const int64_t length = args[2].As<Integer>()->Value();
+  CHECK_GT(length, 0);
+  CHECK_LE(static_cast<uint64_t>(length), Buffer::kMaxLength);
+
+  CHECK(args[3]->IsInt32());
+  int advice;
+  switch (args[3].As<Int32>()->Value()) {
+    case kMapAdviceSequential: advice = MADV_SEQUENTIAL; break;
+    case kMapAdviceRandom: advice = MADV_RANDOM; break;
+    case kMapAdviceWillNeed: advice = MADV_WILLNEED; break;
+    default: advice = MADV_NORMAL; break;
+  }
+
+  // mmap() wants a page aligned offset, map from the start of the page and
+  // have the Buffer start further into the ArrayBuffer.
+  static const int64_t page_size = sysconf(_SC_PAGESIZE);
+  const int64_t aligned_offset = offset - offset % page_size;
+  const size_t delta = static_cast<size_t>(offset - aligned_offset);
+  const size_t map_length = static_cast<size_t>(length) + delta;
+
+  env->PrintSyncTrace();
+  FS_SYNC_TRACE_BEGIN(mmap);
+  // Pages past the end of the file raise SIGBUS when they are accessed, so
+  // refuse to map them in the first place.
+  struct stat st;
+  void* addr = MAP_FAILED;
+  int err;
+  if (fstat(fd, &st) != 0) {
+    err = uv_translate_sys_error(errno);
+  } else if (offset + length > st.st_size) {
+    err = UV_EINVAL;
+  } else {
+    addr = mmap(nullptr, map_length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                aligned_offset);
+    err = addr == MAP_FAILED ? uv_translate_sys_error(errno) : 0;
+  }
+  FS_SYNC_TRACE_END(mmap);
+
+  if (err != 0) {
+    Local<Object> ctx = args[5].As<Object>();
+    ctx->Set(env->context(),
+             env->errno_string(),
+             Integer::New(isolate, err)).Check();
+    ctx->Set(env->context(),
+             env->syscall_string(),
+             OneByteString(isolate, "mmap")).Check();
+    return;
+  }
+
+  // Only a hint, failing to apply it is not an error.
+  USE(madvise(addr, map_length, advice));
+
+  std::unique_ptr<BackingStore> backing = ArrayBuffer::NewBackingStore(
+      addr,
+      map_length,
+      [](void* data, size_t length, void* deleter_data) {
+        CHECK_EQ(munmap(data, length), 0);
+      },
+      nullptr);
+  Local<ArrayBuffer> ab = ArrayBuffer::New(isolate, std::move(backing));
+
+  Local<Object> buffer;
+  if (!Buffer::New(env, ab, delta, static_cast<size_t>(length))
+           .ToLocal(&buffer)) {
+    return;
+  }
+  args.GetReturnValue().Set(buffer);
+}
+
+// unmapFile(arrayBuffer)
+// Detaches an ArrayBuffer created by mapFile(), which releases the mapping
+// right away instead of waiting for garbage collection. All views on it
+// become zero-length.
+static void UnmapFile(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsArrayBuffer());
+  Local<ArrayBuffer> ab = args[0].As<ArrayBuffer>();
+  CHECK(ab->IsDetachable());
+  ab->Detach();
+}
+#endif  // __POSIX__
+
+
+// Largest regular file that fs.readFile() reads in a single threadpool job.
+// Keep in sync with kReadFileBufferLength in
+// lib/internal/fs/read_file_context.js.
+constexpr uint64_t kReadFileFastPathMaxLength = 512 * 1024;
+
+// Does the whole of fs.readFile() for small regular files in one threadpool
+// job: open (unless an fd was passed), fstat, a single allocation sized from
+// the stat result, read until EOF, and close. Anything else (non-regular files,
+// files that report a size of 0 like those in procfs, or files bigger than
+// kReadFileFastPathMaxLength) is handed back to JS with the fd still open, so
+// that it keeps being read in chunks and does not hold on to a threadpool
+// thread for too long.
+class ReadFileJob final : public ThreadPoolWork {
+ public:
+  ReadFileJob(Environment* env,
+              FSReqBase* req_wrap,
+              std::string&& path,
+              uv_file fd,
+              int flags,
+              enum encoding encoding)
+      : ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_KIND_FS),
+        req_wrap_(req_wrap),
+        path_(std::move(path)),
+        fd_(fd),
+        is_user_fd_(fd >= 0),
+        flags_(flags),
+        encoding_(encoding) {}
+
+  ~ReadFileJob() override { free(data_); }
+
+  void DoThreadPoolWork() override;
+  void AfterThreadPoolWork(int status) override;
+
+ private:
+  void Fail(const char* syscall, int err);
+
+  std::unique_ptr<FSReqBase> req_wrap_;
+  std::string path_;
+  uv_file fd_;
+  const bool is_user_fd_;
+  const int flags_;
+  const enum encoding encoding_;
+
+  // Results, written on the threadpool thread.
+  const char* syscall_ = nullptr;
+  int err_ = 0;
+  bool done_ = false;
+  uint64_t size_ = 0;
+  char* data_ = nullptr;
+  size_t length_ = 0;
+};
+
+void ReadFileJob::Fail(const char* syscall, int err) {
+  syscall_ = syscall;
+  err_ = err;
+  if (!is_user_fd_ && fd_ >= 0) {
+    uv_fs_t req;
+    uv_fs_close(nullptr, &req, fd_, nullptr);
+    uv_fs_req_cleanup(&req);
+  }
+}
+
+void ReadFileJob::DoThreadPoolWork() {
+  uv_fs_t req;
+  int err;
+
+  if (!is_user_fd_) {
+    err = uv_fs_open(nullptr, &req, path_.c_str(), flags_, 0666, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (err < 0)
+      return Fail("open", err);
+    fd_ = err;
+  }
+
+  err = uv_fs_fstat(nullptr, &req, fd_, nullptr);
+  const bool is_regular = (req.statbuf.st_mode & S_IFMT) == S_IFREG;
+  const uint64_t size = req.statbuf.st_size;
+  uv_fs_req_cleanup(&req);
+  if (err < 0)
+    return Fail("fstat", err);
+
+  size_ = is_regular ? size : 0;
+  if (!is_regular || size == 0 || size > kReadFileFastPathMaxLength)
+    return;  // Let JS read it in chunks.
+
+  data_ = UncheckedMalloc(size);
+  if (data_ == nullptr)
+    return Fail("read", UV_ENOMEM);
+
+  // The file may shrink while it is being read; like the JS implementation,
+  // stop at EOF, or once the size reported by fstat() has been read.
+  while (length_ < size) {
+    uv_buf_t buf = uv_buf_init(data_ + length_, size - length_);
+    err = uv_fs_read(nullptr, &req, fd_, &buf, 1, -1, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (err < 0)
+      return Fail("read", err);
+    if (err == 0)
+      break;
+    length_ += err;
+  }
+
+  done_ = true;
+
+  if (!is_user_fd_) {
+    err = uv_fs_close(nullptr, &req, fd_, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (err < 0) {
+      syscall_ = "close";
+      err_ = err;
+    }
+  }
+}
+
+void ReadFileJob::AfterThreadPoolWork(int status) {
+  CHECK(status == 0 || status == UV_ECANCELED);
+  std::unique_ptr<ReadFileJob> job(this);
+  if (status == UV_ECANCELED) {
+    // Nobody is going to read from a descriptor that was left open for JS.
+    if (!is_user_fd_ && fd_ >= 0 && err_ == 0 && !done_) {
+      uv_fs_t req;
+      uv_fs_close(nullptr, &req, fd_, nullptr);
+      uv_fs_req_cleanup(&req);
+    }
+    return;
+  }
+
+  Isolate* isolate = env()->isolate();
+  HandleScope handle_scope(isolate);
+  Context::Scope context_scope(env()->context());
+
+  if (err_ < 0) {
+    req_wrap_->Reject(UVException(isolate,
+                                  err_,
+                                  syscall_,
+                                  nullptr,
+                                  is_user_fd_ ? nullptr : path_.c_str()));
+    return;
+  }
+
+  if (!done_) {
+    Local<Value> values[] = {
+      Integer::New(isolate, fd_),
+      Number::New(isolate, static_cast<double>(size_))
+    };
+    req_wrap_->Resolve(Array::New(isolate, values, arraysize(values)));
+    return;
+  }
+
+  Local<Value> value;
+  if (encoding_ == BUFFER && length_ == 0) {
+    if (!Buffer::New(env(), static_cast<size_t>(0)).ToLocal(&value))
+      return;
+  } else if (encoding_ == BUFFER) {
+    // The Buffer takes ownership of the data, even if creating it fails.
+    char* data = data_;
+    data_ = nullptr;
+    Local<Object> buffer;
+    if (!Buffer::New(env(), data, length_, true).ToLocal(&buffer))
+      return;
+    value = buffer;
+  } else {
+    Local<Value> error;
+    if (!StringBytes::Encode(isolate, data_, length_, encoding_, &error)
+             .ToLocal(&value)) {
+      CHECK(!error.IsEmpty());
+      req_wrap_->Reject(error);
+      return;
+    }
+  }
+  req_wrap_->Resolve(value);
+}
+
+/* fs.readFile(path | fd, flags, encoding, req)
+ * Reads a whole file in one threadpool job, see ReadFileJob.
+ * Resolves with the contents as a Buffer or a string, or with [fd, size] when
+ * the file has to be read in chunks by JS.
+ */
+static void ReadFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  const int argc = args.Length();
+  CHECK_GE(argc, 4);
+
+  std::string path;
+  uv_file fd = -1;
+  if (args[0]->IsInt32()) {
+    fd = args[0].As<Int32>()->Value();
+    CHECK_GE(fd, 0);
+  } else {
+    BufferValue path_value(env->isolate(), args[0]);
+    CHECK_NOT_NULL(*path_value);
+    path = path_value.ToString();
+  }
+
+  CHECK(args[1]->IsInt32());
+  const int flags = args[1].As<Int32>()->Value();
+
+  const enum encoding encoding = ParseEncoding(env->isolate(), args[2], BUFFER);
+
+  FSReqBase* req_wrap_async = GetReqWrap(env, args[3]);
+  CHECK_NOT_NULL(req_wrap_async);
+  req_wrap_async->SetReturnValue(args);
+
+  auto job = std::make_unique<ReadFileJob>(
+      env, req_wrap_async, std::move(path), fd, flags, encoding);
+  job->ScheduleWork();
+  job.release();  // Deleted in AfterThreadPoolWork().
+}
+
+
 /* fs.chmod(path, mode);
  * Wrapper for chmod(1) / EIO_CHMOD
  */
@@ -2223,6 +3247,134 @@ static void Mkdtemp(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+BufferedWriter::BufferedWriter(Environment* env, Local<Object> obj,
+                               uv_file fd, size_t capacity)
+    : BaseObject(env, obj), fd_(fd), capacity_(capacity) {
+  MakeWeak();
+  thread_running_ = uv_thread_create(&thread_, ThreadMain, this) == 0;
+}
+
+BufferedWriter::~BufferedWriter() {
+  Stop();
+}
+
+void BufferedWriter::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsInt32());
+  CHECK(args[1]->IsNumber());
+  const uv_file fd = args[0].As<Int32>()->Value();
+  const size_t capacity = static_cast<size_t>(args[1].As<Number>()->Value());
+  new BufferedWriter(env, args.This(), fd, capacity);
+}
+
+// Returns 0, or the error of an earlier write that failed.
+void BufferedWriter::Write(const FunctionCallbackInfo<Value>& args) {
+  BufferedWriter* writer;
+  ASSIGN_OR_RETURN_UNWRAP(&writer, args.Holder());
+  CHECK(args[0]->IsArrayBufferView());
+  ArrayBufferViewContents<char> data(args[0]);
+
+  {
+    Mutex::ScopedLock lock(writer->mutex_);
+    if (writer->thread_running_ && !writer->stopping_) {
+      // Past the capacity, wait for the writer thread rather than keep
+      // buffering, so that memory use stays bounded.
+      while (!writer->pending_.empty() &&
+             writer->pending_.size() + data.length() > writer->capacity_) {
+        writer->idle_cond_.Wait(lock);
+      }
+      writer->pending_.append(data.data(), data.length());
+      writer->data_cond_.Signal(lock);
+      args.GetReturnValue().Set(writer->TakeError());
+      return;
+    }
+  }
+
+  // Without a thread, write synchronously.
+  writer->WriteAll(std::string(data.data(), data.length()));
+  Mutex::ScopedLock lock(writer->mutex_);
+  args.GetReturnValue().Set(writer->TakeError());
+}
+
+// Writes the remaining data and stops the thread. Later writes are
+// synchronous.
+void BufferedWriter::Close(const FunctionCallbackInfo<Value>& args) {
+  BufferedWriter* writer;
+  ASSIGN_OR_RETURN_UNWRAP(&writer, args.Holder());
+  writer->Stop();
+  Mutex::ScopedLock lock(writer->mutex_);
+  args.GetReturnValue().Set(writer->TakeError());
+}
+
+void BufferedWriter::MemoryInfo(MemoryTracker* tracker) const {
+  Mutex::ScopedLock lock(mutex_);
+  tracker->TrackFieldWithSize("pending", pending_.capacity());
+}
+
+void BufferedWriter::ThreadMain(void* data) {
+  BufferedWriter* writer = static_cast<BufferedWriter*>(data);
+  std::string chunk;
+  Mutex::ScopedLock lock(writer->mutex_);
+  for (;;) {
+    while (writer->pending_.empty() && !writer->stopping_)
+      writer->data_cond_.Wait(lock);
+    if (writer->pending_.empty())
+      return;
+    // Take everything that was written in the meantime, and let the event
+    // loop add to an empty buffer while this thread waits for the kernel.
+    chunk.swap(writer->pending_);
+    writer->idle_cond_.Broadcast(lock);
+    {
+      Mutex::ScopedUnlock unlock(lock);
+      writer->WriteAll(chunk);
+      chunk.clear();
+    }
+  }
+}
+
+void BufferedWriter::WriteAll(const std::string& data) {
+  size_t offset = 0;
+  while (offset < data.size()) {
+    uv_buf_t buf = uv_buf_init(const_cast<char*>(data.data()) + offset,
+                               data.size() - offset);
+    uv_fs_t req;
+    const int written = uv_fs_write(nullptr, &req, fd_, &buf, 1, -1, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (written == UV_EAGAIN) {
+      // The pipe is full and in non-blocking mode.
+      uv_sleep(1);
+      continue;
+    }
+    if (written < 0) {
+      Mutex::ScopedLock lock(mutex_);
+      if (error_ == 0)
+        error_ = written;
+      return;
+    }
+    offset += written;
+  }
+}
+
+int BufferedWriter::TakeError() {
+  const int error = error_;
+  error_ = 0;
+  return error;
+}
+
+void BufferedWriter::Stop() {
+  {
+    Mutex::ScopedLock lock(mutex_);
+    if (!thread_running_)
+      return;
+    stopping_ = true;
+    data_cond_.Signal(lock);
+  }
+  CHECK_EQ(uv_thread_join(&thread_), 0);
+  Mutex::ScopedLock lock(mutex_);
+  thread_running_ = false;
+}
+
 void Initialize(Local<Object> target,
                 Local<Value> unused,
                 Local<Context> context,
@@ -2235,6 +3387,17 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "open", Open);
   env->SetMethod(target, "openFileHandle", OpenFileHandle);
   env->SetMethod(target, "read", Read);
+  env->SetMethod(target, "readBuffers", ReadBuffers);
+  env->SetMethod(target, "readFile", ReadFile);
+  env->SetMethod(target, "copyFileRange", CopyFileRange);
+#ifdef __POSIX__
+  env->SetMethod(target, "mapFile", MapFile);
+  env->SetMethod(target, "unmapFile", UnmapFile);
+  NODE_DEFINE_CONSTANT(target, kMapAdviceNormal);
+  NODE_DEFINE_CONSTANT(target, kMapAdviceSequential);
+  NODE_DEFINE_CONSTANT(target, kMapAdviceRandom);
+  NODE_DEFINE_CONSTANT(target, kMapAdviceWillNeed);
+#endif
   env->SetMethod(target, "fdatasync", Fdatasync);
   env->SetMethod(target, "fsync", Fsync);
   env->SetMethod(target, "rename", Rename);
@@ -2244,9 +3407,27 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "readdir", ReadDir);
   env->SetMethod(target, "internalModuleReadJSON", InternalModuleReadJSON);
   env->SetMethod(target, "internalModuleStat", InternalModuleStat);
+  env->SetMethod(target,
+                 "internalModuleArchiveStat",
+                 InternalModuleArchiveStat);
+  env->SetMethod(target,
+                 "internalModuleReadArchive",
+                 InternalModuleReadArchive);
+  env->SetMethod(target,
+                 "internalModuleArchiveCodeCache",
+                 InternalModuleArchiveCodeCache);
+  env->SetMethod(target, "getCachedModulePath", GetCachedModulePath);
+  env->SetMethod(target, "setCachedModulePath", SetCachedModulePath);
+  env->SetMethod(target,
+                 "getModuleResolutionCacheGeneration",
+                 GetModuleResolutionCacheGeneration);
+  env->SetMethod(target,
+                 "clearModuleResolutionCache",
+                 ClearModuleResolutionCache);
   env->SetMethod(target, "stat", Stat);
   env->SetMethod(target, "lstat", LStat);
   env->SetMethod(target, "fstat", FStat);
+  env->SetMethod(target, "statMany", StatMany);
   env->SetMethod(target, "link", Link);
   env->SetMethod(target, "symlink", Symlink);
   env->SetMethod(target, "readlink", ReadLink);
@@ -2288,6 +3469,18 @@ void Initialize(Local<Object> target,
 
   StatWatcher::Initialize(env, target);
 
+  Local<FunctionTemplate> bw = env->NewFunctionTemplate(BufferedWriter::New);
+  bw->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(bw, "write", BufferedWriter::Write);
+  env->SetProtoMethod(bw, "close", BufferedWriter::Close);
+  Local<String> bufferedWriterString =
+      FIXED_ONE_BYTE_STRING(isolate, "BufferedWriter");
+  bw->SetClassName(bufferedWriterString);
+  target
+      ->Set(context, bufferedWriterString,
+            bw->GetFunction(env->context()).ToLocalChecked())
+      .Check();
+
   // Create FunctionTemplate for FSReqCallback
   Local<FunctionTemplate> fst = env->NewFunctionTemplate(NewFSReqCallback);
   fst->InstanceTemplate()->SetInternalFieldCount(1);
@@ -2336,7 +3529,7 @@ void Initialize(Local<Object> target,
       ->Set(context, handleString,
             fd->GetFunction(env->context()).ToLocalChecked())
       .Check();
-  env->set_fd_constructor_template(fdt);
+  env->set_fd_constructor_template(fd);
 
   // Create FunctionTemplate for FileHandle::CloseReq
   Local<FunctionTemplate> fdclose = FunctionTemplate::New(isolate);
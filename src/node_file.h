@@ -5,7 +5,9 @@
 
 #include "node.h"
 #include "aliased_buffer.h"
+#include "node_mutex.h"
 #include "stream_base.h"
+#include <deque>
 #include <iostream>
 
 namespace node {
@@ -66,6 +68,8 @@ class FSReqBase : public ReqWrap<uv_fs_t> {
   const char* data() const { return has_data_ ? *buffer_ : nullptr; }
   enum encoding encoding() const { return encoding_; }
   bool use_bigint() const { return use_bigint_; }
+  uint64_t queued_at() const { return queued_at_; }
+  void set_queued_at(uint64_t queued_at) { queued_at_ = queued_at; }
 
   FSContinuationData* continuation_data() const {
     return continuation_data_.get();
@@ -89,6 +93,8 @@ class FSReqBase : public ReqWrap<uv_fs_t> {
   bool has_data_ = false;
   const char* syscall_ = nullptr;
   bool use_bigint_ = false;
+  // Set while perf_hooks.monitorThreadpool() is enabled.
+  uint64_t queued_at_ = 0;
 
   // Typically, the content of buffer_ is something like a file name, so
   // something around 64 bytes should be enough.
@@ -195,6 +201,15 @@ class FileHandleReadWrap final : public ReqWrap<uv_fs_t> {
   FileHandle* file_handle_;
   uv_buf_t buffer_;
 
+  // Used by reads ahead of the consumer, which read into memory of their own
+  // and hand it over once all reads before them have been handed over.
+  MallocedBuffer<char> data_;
+  int64_t offset_ = -1;
+  size_t length_ = 0;
+  size_t consumed_ = 0;
+  ssize_t result_ = 0;
+  bool done_ = false;
+
   friend class FileHandle;
 };
 
@@ -217,6 +232,9 @@ class FileHandle final : public AsyncWrap, public StreamBase {
 
   // Releases ownership of the FD.
   static void ReleaseFD(const v8::FunctionCallbackInfo<v8::Value>& args);
+  // Releases ownership of the FD and returns it, e.g. so that it can be
+  // transferred to another thread.
+  int Release();
 
   // StreamBase interface:
   int ReadStart() override;
@@ -287,6 +305,18 @@ class FileHandle final : public AsyncWrap, public StreamBase {
 
   // Asynchronous close
   v8::MaybeLocal<v8::Promise> ClosePromise();
+  void DispatchClose(CloseReq* req);
+
+  std::unique_ptr<FileHandleReadWrap> NewReadWrap();
+  void RecycleReadWrap(std::unique_ptr<FileHandleReadWrap> read_wrap);
+
+  // Keeps up to read_ahead_ reads in flight when the offset to read from is
+  // known, and hands their data to the listener in order.
+  void ReadAhead();
+  void HandOutReadAhead();
+  bool QueueReadAhead();
+  void DispatchReadAhead(FileHandleReadWrap* read_wrap);
+  bool ReadAheadInFlight() const;
 
   int fd_;
   bool closing_ = false;
@@ -296,6 +326,60 @@ class FileHandle final : public AsyncWrap, public StreamBase {
 
   bool reading_ = false;
   std::unique_ptr<FileHandleReadWrap> current_read_ = nullptr;
+
+  uint32_t read_ahead_ = 1;
+  // Reads ahead of the consumer, in the order of their offsets.
+  std::deque<std::unique_ptr<FileHandleReadWrap>> read_ahead_queue_;
+  // Set once EOF or an error has been handed to the listener. Reads that are
+  // still in flight then are dropped when they complete.
+  bool read_ahead_ended_ = false;
+  bool in_read_ahead_ = false;
+  // The threadpool reads into buffers owned by this object, so it must not
+  // be garbage collected while reads are in flight, and closing the file
+  // descriptor waits until they have completed.
+  bool read_ahead_strong_ = false;
+  CloseReq* deferred_close_ = nullptr;
+};
+
+// Writes data to a file descriptor from a thread of its own, so that the
+// event loop does not wait when the file or pipe is slow to take the data.
+// Write() copies the data and only blocks when more than `capacity` bytes
+// are waiting, Close() waits until all of them have been written.
+class BufferedWriter final : public BaseObject {
+ public:
+  BufferedWriter(Environment* env, v8::Local<v8::Object> obj,
+                 uv_file fd, size_t capacity);
+  ~BufferedWriter() override;
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Write(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Close(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(BufferedWriter)
+  SET_SELF_SIZE(BufferedWriter)
+
+  BufferedWriter(const BufferedWriter&) = delete;
+  BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+ private:
+  static void ThreadMain(void* data);
+  void WriteAll(const std::string& data);
+  // Returns the first error since the last call, as a negative errno.
+  int TakeError();
+  void Stop();
+
+  const uv_file fd_;
+  const size_t capacity_;
+  uv_thread_t thread_;
+  bool thread_running_ = false;
+
+  Mutex mutex_;
+  ConditionVariable data_cond_;
+  ConditionVariable idle_cond_;
+  std::string pending_;
+  bool stopping_ = false;
+  int error_ = 0;
 };
 
 int MKDirpSync(uv_loop_t* loop,
@@ -12,6 +12,12 @@
 
 #include <algorithm>
 
+#ifdef __linux__
+#include <fcntl.h>  // fcntl()
+#include <sys/stat.h>  // fstat()
+#include <unistd.h>  // close()
+#endif
+
 namespace node {
 
 using v8::ArrayBuffer;
@@ -21,6 +27,8 @@ using v8::Boolean;
 using v8::Context;
 using v8::Float64Array;
 using v8::Function;
+using v8::Global;
+using v8::Int32;
 using v8::Integer;
 using v8::NewStringType;
 using v8::Number;
@@ -38,6 +46,11 @@ namespace {
 
 const char zero_bytes_256[256] = {};
 
+// Payload of the PINGs that measure the bandwidth-delay product of the
+// connection for the adaptiveWindowSize option, so that their
+// acknowledgements can be told apart from those for Http2Session.ping().
+const uint8_t kBdpPingPayload[8] = { 'n', 'o', 'd', 'e', 'b', 'd', 'p', 0 };
+
 inline Http2Stream* GetStream(Http2Session* session,
                               int32_t id,
                               nghttp2_data_source* source) {
@@ -49,6 +62,59 @@ inline Http2Stream* GetStream(Http2Session* session,
   return stream;
 }
 
+// Returns the id of the idle stream that anchors the streams of the given
+// extensible priority urgency. These are the highest ids that a client can
+// use, so they remain idle for the lifetime of any realistic session.
+inline int32_t UrgencyAnchorId(uint8_t urgency) {
+  return INT32_MAX - 2 * urgency;
+}
+
+inline bool IsUrgencyAnchor(int32_t id) {
+  return id % 2 == 1 &&
+         id > INT32_MAX - 2 * EXTENSIBLE_PRIORITY_URGENCY_LEVELS;
+}
+
+// Parses the value of a `priority` header, a Structured Fields Dictionary
+// such as `u=1, i` (RFC 9218, Section 4). Other members, parameters, and
+// values that are not valid are ignored and leave the previous values of
+// |urgency| and |incremental| in place.
+void ParsePriorityHeader(const uint8_t* value,
+                         size_t length,
+                         uint8_t* urgency,
+                         bool* incremental) {
+  const uint8_t* end = value + length;
+  const uint8_t* p = value;
+  for (;;) {
+    const uint8_t* member_end =
+        static_cast<const uint8_t*>(memchr(p, ',', end - p));
+    if (member_end == nullptr)
+      member_end = end;
+    while (p < member_end && (*p == ' ' || *p == '\t'))
+      p++;
+    const uint8_t* q = member_end;
+    while (q > p && (q[-1] == ' ' || q[-1] == '\t'))
+      q--;
+    const uint8_t* params = static_cast<const uint8_t*>(memchr(p, ';', q - p));
+    if (params != nullptr)
+      q = params;
+
+    const size_t size = q - p;
+    if (size == 3 && p[0] == 'u' && p[1] == '=' && p[2] >= '0' &&
+        p[2] < '0' + EXTENSIBLE_PRIORITY_URGENCY_LEVELS) {
+      *urgency = p[2] - '0';
+    } else if (size == 1 && p[0] == 'i') {
+      *incremental = true;
+    } else if (size == 4 && memcmp(p, "i=?", 3) == 0 &&
+               (p[3] == '0' || p[3] == '1')) {
+      *incremental = p[3] == '1';
+    }
+
+    if (member_end == end)
+      break;
+    p = member_end + 1;
+  }
+}
+
 }  // anonymous namespace
 
 // These configure the callbacks required by nghttp2 itself. There are
@@ -201,6 +267,25 @@ Http2Options::Http2Options(Environment* env, nghttp2_session_type type) {
   if (flags & (1 << IDX_OPTIONS_MAX_SESSION_MEMORY)) {
     SetMaxSessionMemory(buffer[IDX_OPTIONS_MAX_SESSION_MEMORY] * 1e6);
   }
+
+  // Coalescing writes defers sending data that is generated while receiving
+  // data until the end of the current event loop iteration, so that the data
+  // generated for many streams is written at once.
+  if (flags & (1 << IDX_OPTIONS_COALESCE_WRITES)) {
+    SetCoalesceWrites(buffer[IDX_OPTIONS_COALESCE_WRITES] != 0);
+  }
+
+  // Adaptive windows grow the receive windows beyond their initial size
+  // when the connection can carry more data per round trip.
+  if (flags & (1 << IDX_OPTIONS_ADAPTIVE_WINDOW_SIZE)) {
+    SetAdaptiveWindowSize(buffer[IDX_OPTIONS_ADAPTIVE_WINDOW_SIZE] != 0);
+  }
+
+  // Extensible priorities schedule the streams of a server session by the
+  // urgency and incremental parameters of their `priority` request headers.
+  if (flags & (1 << IDX_OPTIONS_EXTENSIBLE_PRIORITIES)) {
+    SetExtensiblePriorities(buffer[IDX_OPTIONS_EXTENSIBLE_PRIORITIES] != 0);
+  }
 }
 
 void Http2Session::Http2Settings::Init() {
@@ -510,6 +595,63 @@ void Http2Session::StopTrackingRcbuf(nghttp2_rcbuf* buf) {
   StopTrackingMemory(buf);
 }
 
+// Header names and values longer than this are not cached.
+constexpr size_t kMaxCachedHeaderStringLength = 256;
+constexpr size_t kHeaderStringCacheSize = 128;
+
+MaybeLocal<String> Http2Session::GetHeaderString(nghttp2_rcbuf* buf,
+                                                 bool is_name) {
+  // Strings for HPACK static table entries are already per-isolate.
+  if (nghttp2_rcbuf_is_static(buf)) {
+    header_string_cache_hits_++;
+    return is_name ? ExternalHeader::New<true>(this, buf) :
+                     ExternalHeader::New<false>(this, buf);
+  }
+
+  auto it = header_string_cache_.find(buf);
+  if (it != header_string_cache_.end()) {
+    header_string_cache_hits_++;
+    // The cache holds its own reference.
+    nghttp2_rcbuf_decref(buf);
+    header_string_lru_.splice(header_string_lru_.begin(),
+                              header_string_lru_,
+                              it->second);
+    return it->second->second.Get(env()->isolate());
+  }
+
+  header_string_cache_misses_++;
+  const size_t length = nghttp2_rcbuf_get_buf(buf).len;
+  if (length == 0 || length > kMaxCachedHeaderStringLength) {
+    return is_name ? ExternalHeader::New<true>(this, buf) :
+                     ExternalHeader::New<false>(this, buf);
+  }
+
+  nghttp2_rcbuf_incref(buf);
+  Local<String> str;
+  if (!(is_name ? ExternalHeader::New<true>(this, buf) :
+                  ExternalHeader::New<false>(this, buf)).ToLocal(&str)) {
+    nghttp2_rcbuf_decref(buf);
+    return MaybeLocal<String>();
+  }
+
+  header_string_lru_.emplace_front(buf, Global<String>(env()->isolate(), str));
+  header_string_cache_.emplace(buf, header_string_lru_.begin());
+  if (header_string_lru_.size() > kHeaderStringCacheSize) {
+    HeaderStringCacheEntry& oldest = header_string_lru_.back();
+    header_string_cache_.erase(oldest.first);
+    nghttp2_rcbuf_decref(oldest.first);
+    header_string_lru_.pop_back();
+  }
+  return str;
+}
+
+void Http2Session::ClearHeaderStringCache() {
+  for (HeaderStringCacheEntry& entry : header_string_lru_)
+    nghttp2_rcbuf_decref(entry.first);
+  header_string_lru_.clear();
+  header_string_cache_.clear();
+}
+
 void Http2Session::CheckAllocatedSize(size_t previous_size) const {
   CHECK_GE(current_nghttp2_memory_, previous_size);
 }
@@ -545,6 +687,10 @@ Http2Session::Http2Session(Environment* env,
   max_outstanding_settings_ = opts.GetMaxOutstandingSettings();
 
   padding_strategy_ = opts.GetPaddingStrategy();
+  coalesce_writes_ = opts.GetCoalesceWrites();
+  adaptive_window_ = opts.GetAdaptiveWindowSize();
+  extensible_priorities_ =
+      type == NGHTTP2_SESSION_SERVER && opts.GetExtensiblePriorities();
 
   bool hasGetPaddingCallback =
       padding_strategy_ != PADDING_STRATEGY_NONE;
@@ -582,6 +728,9 @@ Http2Session::Http2Session(Environment* env,
 Http2Session::~Http2Session() {
   CHECK_EQ(flags_ & SESSION_STATE_HAS_SCOPE, 0);
   Debug(this, "freeing nghttp2 session");
+  // Release the cache's rcbuf references while the allocator that tracks
+  // them is still around.
+  ClearHeaderStringCache();
   nghttp2_session_del(session_);
   CHECK_EQ(current_nghttp2_memory_, 0);
   js_fields_->~SessionJSFields();
@@ -818,7 +967,9 @@ ssize_t Http2Session::ConsumeHTTP2Data() {
     return ret;
 
   // Send any data that was queued up while processing the received data.
-  if (!IsDestroyed()) {
+  // When coalescing writes, the Http2Scope in OnStreamRead() schedules the
+  // write for the end of the event loop iteration instead.
+  if (!IsDestroyed() && !coalesce_writes_) {
     SendPendingData();
   }
   return ret;
@@ -892,6 +1043,20 @@ int Http2Session::OnHeaderCallback(nghttp2_session* handle,
     stream->SubmitRstStream(NGHTTP2_ENHANCE_YOUR_CALM);
     return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
   }
+
+  if (session->extensible_priorities_ &&
+      stream->headers_category() == NGHTTP2_HCAT_REQUEST) {
+    nghttp2_vec header_name = nghttp2_rcbuf_get_buf(name);
+    if (header_name.len == 8 &&
+        memcmp(header_name.base, "priority", 8) == 0) {
+      nghttp2_vec header_value = nghttp2_rcbuf_get_buf(value);
+      uint8_t urgency = stream->urgency();
+      bool incremental = stream->incremental();
+      ParsePriorityHeader(header_value.base, header_value.len,
+                          &urgency, &incremental);
+      stream->set_extensible_priority(urgency, incremental);
+    }
+  }
   return 0;
 }
 
@@ -1009,6 +1174,14 @@ int Http2Session::OnFrameSent(nghttp2_session* handle,
                               void* user_data) {
   Http2Session* session = static_cast<Http2Session*>(user_data);
   session->statistics_.frame_sent += 1;
+  // Pushed streams only exist in nghttp2 once their PUSH_PROMISE is sent.
+  if (session->extensible_priorities_ &&
+      frame->hd.type == NGHTTP2_PUSH_PROMISE) {
+    Http2Stream* stream =
+        session->FindStream(frame->push_promise.promised_stream_id);
+    if (stream != nullptr && !stream->IsDestroyed())
+      session->UpdateExtensiblePriority(stream);
+  }
   return 0;
 }
 
@@ -1093,6 +1266,9 @@ int Http2Session::OnDataChunkReceived(nghttp2_session* handle,
 
   stream->statistics_.received_bytes += len;
 
+  if (session->adaptive_window_)
+    session->OnAdaptiveWindowData(stream, len);
+
   // Repeatedly ask the stream's owner for memory, and copy the read data
   // into those buffers.
   // The typical case is actually the exception here; Http2StreamListeners
@@ -1126,8 +1302,10 @@ int Http2Session::OnDataChunkReceived(nghttp2_session* handle,
       stream->inbound_consumed_data_while_paused_ += avail;
 
     // If we have a gathered a lot of data for output, try sending it now.
-    if (session->outgoing_length_ > 4096 ||
-        stream->available_outbound_length_ > 4096) {
+    const size_t max_pending = session->coalesce_writes_ ?
+        MAX_COALESCED_OUTGOING_LENGTH : 4096;
+    if (session->outgoing_length_ > max_pending ||
+        stream->available_outbound_length_ > max_pending) {
       session->SendPendingData();
     }
   } while (len != 0);
@@ -1249,6 +1427,11 @@ void Http2Session::HandleHeadersFrame(const nghttp2_frame* frame) {
   if (stream->IsDestroyed())
     return;
 
+  if (extensible_priorities_ &&
+      stream->headers_category() == NGHTTP2_HCAT_REQUEST) {
+    UpdateExtensiblePriority(stream);
+  }
+
   std::vector<nghttp2_header> headers(stream->move_headers());
   DecrementCurrentSessionMemory(stream->current_headers_length_);
   stream->current_headers_length_ = 0;
@@ -1265,10 +1448,8 @@ void Http2Session::HandleHeadersFrame(const nghttp2_frame* frame) {
   for (size_t i = 0; i < headers_size; ++i) {
     const nghttp2_header& item = headers[i];
     // The header name and value are passed as external one-byte strings
-    headers_v[i * 2] =
-        ExternalHeader::New<true>(this, item.name).ToLocalChecked();
-    headers_v[i * 2 + 1] =
-        ExternalHeader::New<false>(this, item.value).ToLocalChecked();
+    headers_v[i * 2] = GetHeaderString(item.name, true).ToLocalChecked();
+    headers_v[i * 2 + 1] = GetHeaderString(item.value, false).ToLocalChecked();
   }
 
   Local<Value> args[5] = {
@@ -1418,6 +1599,12 @@ void Http2Session::HandlePingFrame(const nghttp2_frame* frame) {
   Local<Value> arg;
   bool ack = frame->hd.flags & NGHTTP2_FLAG_ACK;
   if (ack) {
+    if (bdp_ping_outstanding_ &&
+        memcmp(frame->ping.opaque_data, kBdpPingPayload, 8) == 0) {
+      OnAdaptiveWindowPingAck();
+      return;
+    }
+
     BaseObjectPtr<Http2Ping> ping = PopPing();
 
     if (!ping) {
@@ -1443,6 +1630,173 @@ void Http2Session::HandlePingFrame(const nghttp2_frame* frame) {
   MakeCallback(env()->http2session_on_ping_function(), 1, &arg);
 }
 
+// Called for every chunk of DATA that is received with the adaptiveWindowSize
+// option. Starts a new measurement of the bandwidth-delay product if none is
+// running, and brings the receive window of |stream| to the current
+// estimate.
+void Http2Session::OnAdaptiveWindowData(Http2Stream* stream, size_t length) {
+  bdp_bytes_received_ += length;
+  if (!bdp_ping_outstanding_ &&
+      adaptive_window_size_ < MAX_ADAPTIVE_WINDOW_SIZE &&
+      nghttp2_submit_ping(session_, NGHTTP2_FLAG_NONE, kBdpPingPayload) == 0) {
+    bdp_ping_outstanding_ = true;
+    bdp_ping_sent_at_ = uv_hrtime();
+    bdp_bytes_received_ = 0;
+  }
+
+  const int32_t size = GetAdaptiveStreamWindowSize();
+  const int32_t current =
+      nghttp2_session_get_stream_effective_local_window_size(session_,
+                                                             stream->id());
+  if (current >= 0 && current != size) {
+    Debug(this, "setting window size of stream %d to %d", stream->id(), size);
+    CHECK_NE(nghttp2_session_set_local_window_size(session_,
+                                                   NGHTTP2_FLAG_NONE,
+                                                   stream->id(),
+                                                   size),
+             NGHTTP2_ERR_NOMEM);
+  }
+}
+
+// The bytes received between sending a BDP PING and receiving its
+// acknowledgement are what the peer could send in one round trip. If that
+// came close to the window size, the window rather than the link was the
+// limit, so the estimate is doubled.
+void Http2Session::OnAdaptiveWindowPingAck() {
+  bdp_ping_outstanding_ = false;
+  const uint64_t sample = bdp_bytes_received_;
+  Debug(this, "received %d bytes during a round trip of %d us",
+        sample, (uv_hrtime() - bdp_ping_sent_at_) / 1000);
+
+  const int32_t initial = nghttp2_session_get_local_settings(
+      session_, NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE);
+  const int32_t current = std::max(adaptive_window_size_, initial);
+  if (sample * 3 < static_cast<uint64_t>(current) * 2)
+    return;
+
+  // Powers of two keep the window sizes from changing for every chunk when
+  // they are limited by GetAdaptiveStreamWindowSize().
+  int32_t size = NGHTTP2_INITIAL_WINDOW_SIZE + 1;
+  while (size < MAX_ADAPTIVE_WINDOW_SIZE &&
+         static_cast<uint64_t>(size) < sample * 2)
+    size *= 2;
+  if (size <= adaptive_window_size_)
+    return;
+  adaptive_window_size_ = size;
+  Debug(this, "adaptive window size is now %d", size);
+
+  // Data is consumed on the connection level as soon as it is received, so
+  // the connection window does not need to take session memory into account.
+  if (nghttp2_session_get_effective_local_window_size(session_) < size) {
+    CHECK_NE(nghttp2_session_set_local_window_size(session_,
+                                                   NGHTTP2_FLAG_NONE,
+                                                   0,
+                                                   size),
+             NGHTTP2_ERR_NOMEM);
+  }
+}
+
+// Returns the current estimate, halved as often as necessary to stay within
+// half of the session memory that is still available, so that data buffered
+// for streams that are not being read does not exceed maxSessionMemory.
+int32_t Http2Session::GetAdaptiveStreamWindowSize() {
+  const int32_t initial = nghttp2_session_get_local_settings(
+      session_, NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE);
+  const uint64_t used = GetCurrentSessionMemory();
+  const uint64_t available =
+      used < max_session_memory_ ? (max_session_memory_ - used) / 2 : 0;
+  int32_t size = adaptive_window_size_;
+  while (size > initial && static_cast<uint64_t>(size) > available)
+    size /= 2;
+  return std::max(size, initial);
+}
+
+// Makes sure that the anchor streams of all urgency levels exist. nghttp2
+// discards the oldest idle streams when it keeps too many of them, for
+// example after the peer sent PRIORITY frames for idle streams, so missing
+// anchors are created again. Returns false if that is not possible.
+bool Http2Session::EnsureUrgencyAnchors() {
+  bool complete = true;
+  for (uint8_t urgency = 0;
+       urgency < EXTENSIBLE_PRIORITY_URGENCY_LEVELS && complete;
+       urgency++) {
+    complete = nghttp2_session_find_stream(
+        session_, UrgencyAnchorId(urgency)) != nullptr;
+  }
+  if (complete)
+    return true;
+
+  for (uint8_t urgency = 0;
+       urgency < EXTENSIBLE_PRIORITY_URGENCY_LEVELS;
+       urgency++) {
+    const int32_t id = UrgencyAnchorId(urgency);
+    nghttp2_priority_spec spec;
+    if (urgency == 0) {
+      nghttp2_priority_spec_init(&spec, 0, NGHTTP2_MAX_WEIGHT, 0);
+    } else {
+      nghttp2_priority_spec_init(
+          &spec, UrgencyAnchorId(urgency - 1), NGHTTP2_MIN_WEIGHT, 0);
+    }
+    int ret = nghttp2_session_find_stream(session_, id) == nullptr ?
+        nghttp2_session_create_idle_stream(session_, id, &spec) :
+        nghttp2_session_change_stream_priority(session_, id, &spec);
+    CHECK_NE(ret, NGHTTP2_ERR_NOMEM);
+    if (ret != 0) {
+      Debug(this, "unable to create urgency anchor %d: %d", id, ret);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Places |stream| below the anchor of its urgency level. A non-incremental
+// stream depends on the previous non-incremental stream of that level
+// instead, if there is one, so that it is sent once that one is blocked or
+// done, rather than sharing the bandwidth with it.
+void Http2Session::UpdateExtensiblePriority(Http2Stream* stream) {
+  const int32_t id = stream->id();
+  nghttp2_stream* handle = nghttp2_session_find_stream(session_, id);
+  if (handle == nullptr || !EnsureUrgencyAnchors())
+    return;
+
+  // Streams that depend on this one are moved to its parent first, so that
+  // the order of the remaining streams of its previous level is kept.
+  nghttp2_stream* parent = nghttp2_stream_get_parent(handle);
+  const int32_t parent_id =
+      parent != nullptr ? nghttp2_stream_get_stream_id(parent) : 0;
+  nghttp2_stream* child = nghttp2_stream_get_first_child(handle);
+  while (child != nullptr) {
+    nghttp2_stream* next = nghttp2_stream_get_next_sibling(child);
+    nghttp2_priority_spec spec;
+    nghttp2_priority_spec_init(
+        &spec, parent_id, nghttp2_stream_get_weight(child), 0);
+    CHECK_NE(nghttp2_session_change_stream_priority(
+                 session_, nghttp2_stream_get_stream_id(child), &spec),
+             NGHTTP2_ERR_NOMEM);
+    child = next;
+  }
+  for (int32_t& last : last_sequential_stream_) {
+    if (last == id)
+      last = IsUrgencyAnchor(parent_id) ? 0 : parent_id;
+  }
+
+  const uint8_t urgency = stream->urgency();
+  int32_t dependency = UrgencyAnchorId(urgency);
+  if (!stream->incremental()) {
+    int32_t& last = last_sequential_stream_[urgency];
+    if (last != 0 && nghttp2_session_find_stream(session_, last) != nullptr)
+      dependency = last;
+    last = id;
+  }
+  Debug(this, "stream %d has urgency %d%s and depends on %d", id, urgency,
+        stream->incremental() ? " (incremental)" : "", dependency);
+
+  nghttp2_priority_spec spec;
+  nghttp2_priority_spec_init(&spec, dependency, NGHTTP2_MAX_WEIGHT, 0);
+  CHECK_NE(nghttp2_session_change_stream_priority(session_, id, &spec),
+           NGHTTP2_ERR_NOMEM);
+}
+
 // Called by OnFrameReceived when a complete SETTINGS frame has been received.
 void Http2Session::HandleSettingsFrame(const nghttp2_frame* frame) {
   bool ack = frame->hd.flags & NGHTTP2_FLAG_ACK;
@@ -1489,8 +1843,11 @@ void Http2Session::OnStreamAfterWrite(WriteWrap* w, int status) {
   // Inform all pending writes about their completion.
   ClearOutgoing(status);
 
+  // When files are being sent, the stream may have gone away before the
+  // write finishes, see SendOutgoingWithFiles().
   if ((flags_ & SESSION_STATE_READING_STOPPED) &&
       !(flags_ & SESSION_STATE_WRITE_IN_PROGRESS) &&
+      stream_ != nullptr &&
       nghttp2_session_want_read(session_)) {
     flags_ &= ~SESSION_STATE_READING_STOPPED;
     stream_->ReadStart();
@@ -1607,6 +1964,19 @@ void Http2Session::CopyDataIntoOutgoing(const uint8_t* src, size_t src_length) {
   outgoing_storage_.resize(offset + src_length);
   memcpy(&outgoing_storage_[offset], src, src_length);
 
+  // Consecutive copies end up next to each other in outgoing_storage_, so
+  // they can share a single uv_buf_t. This keeps the number of buffers passed
+  // to writev() down when many small frames are sent at once.
+  if (!outgoing_buffers_.empty()) {
+    nghttp2_stream_write& last = outgoing_buffers_.back();
+    if (last.buf.base == nullptr && last.req_wrap == nullptr &&
+        !last.file) {
+      last.buf.len += src_length;
+      outgoing_length_ += src_length;
+      return;
+    }
+  }
+
   // Store with a base of `nullptr` initially, since future resizes
   // of the outgoing_buffers_ vector may invalidate the pointer.
   // The correct base pointers will be set later, before writing to the
@@ -1674,9 +2044,13 @@ uint8_t Http2Session::SendPendingData() {
   // (Those are marked by having .base == nullptr.)
   size_t offset = 0;
   size_t i = 0;
+  bool has_files = false;
   for (const nghttp2_stream_write& write : outgoing_buffers_) {
     statistics_.data_sent += write.buf.len;
-    if (write.buf.base == nullptr) {
+    if (write.file) {
+      has_files = true;
+      bufs[i++] = write.buf;
+    } else if (write.buf.base == nullptr) {
       bufs[i++] = uv_buf_init(
           reinterpret_cast<char*>(outgoing_storage_.data() + offset),
           write.buf.len);
@@ -1690,6 +2064,11 @@ uint8_t Http2Session::SendPendingData() {
 
   CHECK_EQ(flags_ & SESSION_STATE_WRITE_IN_PROGRESS, 0);
   flags_ |= SESSION_STATE_WRITE_IN_PROGRESS;
+  if (has_files) {
+    SendOutgoingWithFiles(*bufs, count);
+    MaybeStopReading();
+    return 0;
+  }
   StreamWriteResult res = underlying_stream()->Write(*bufs, count);
   if (!res.async) {
     flags_ &= ~SESSION_STATE_WRITE_IN_PROGRESS;
@@ -1701,6 +2080,55 @@ uint8_t Http2Session::SendPendingData() {
   return 0;
 }
 
+// Writes the outgoing data when some of its DATA frames are to be sent from
+// files, see Http2Stream::SendFile(). The remaining buffers, including the
+// headers of those frames, are sent from memory in between.
+void Http2Session::SendOutgoingWithFiles(const uv_buf_t* bufs, size_t count) {
+#ifdef __linux__
+  CHECK(CanSendFile());
+  std::vector<LibuvStreamWrap::SendFileSegment> segments;
+  segments.reserve(count);
+  uint64_t length = 0;
+  for (size_t i = 0; i < count; i++) {
+    const nghttp2_stream_write& write = outgoing_buffers_[i];
+    if (write.file) {
+      segments.push_back({ write.file->fd(),
+                           write.file_offset,
+                           static_cast<int64_t>(write.buf.len),
+                           nullptr });
+    } else {
+      segments.push_back({ -1, 0, static_cast<int64_t>(bufs[i].len),
+                           bufs[i].base });
+    }
+    length += bufs[i].len;
+  }
+
+  BaseObjectPtr<Http2Session> strong_ref{this};
+  int err = sendfile_stream_->SendFile(
+      std::move(segments),
+      [this, strong_ref, length](int status, uint64_t bytes_sent) {
+        HandleScope handle_scope(env()->isolate());
+        Context::Scope context_scope(env()->context());
+        // A file that was truncated after Http2Stream::SendFile() leaves a
+        // DATA frame incomplete, and the connection cannot be used anymore.
+        const bool truncated = status == 0 && bytes_sent != length;
+        OnStreamAfterWrite(nullptr, status);
+        if (truncated && !IsDestroyed()) {
+          Debug(this, "file was truncated while sending it");
+          Local<Value> arg =
+              Integer::New(env()->isolate(), NGHTTP2_ERR_CALLBACK_FAILURE);
+          MakeCallback(env()->http2session_on_error_function(), 1, &arg);
+        }
+      });
+  if (err != 0) {
+    flags_ &= ~SESSION_STATE_WRITE_IN_PROGRESS;
+    ClearOutgoing(err);
+  }
+#else
+  UNREACHABLE();
+#endif
+}
+
 
 // This callback is called from nghttp2 when it wants to send DATA frames for a
 // given Http2Stream, when we set the `NGHTTP2_DATA_FLAG_NO_COPY` flag earlier
@@ -1725,6 +2153,16 @@ int Http2Session::OnSendData(
   }
 
   Debug(session, "nghttp2 has %d bytes to send directly", length);
+  if (stream->file_) {
+    session->PushOutgoingBuffer(nghttp2_stream_write {
+      stream->file_, stream->file_offset_, length
+    });
+    stream->file_offset_ += length;
+    // This was the last frame, see Http2Stream::Provider::Stream::OnRead().
+    if (stream->file_remaining_ == 0)
+      stream->file_.reset();
+    length = 0;
+  }
   while (length > 0) {
     // nghttp2 thinks that there is data available (length > 0), which means
     // we told it so, which means that we *should* have data available.
@@ -1862,6 +2300,12 @@ bool Http2Session::HasWritesOnSocketForStream(Http2Stream* stream) {
 void Http2Session::Consume(Local<Object> stream_obj) {
   StreamBase* stream = StreamBase::FromObject(stream_obj);
   stream->PushStreamListener(this);
+#ifdef __linux__
+  // TLSWrap and JS-backed streams are not LibuvStreamWraps.
+  Local<FunctionTemplate> sw = env()->libuv_stream_wrap_ctor_template();
+  if (!sw.IsEmpty() && sw->HasInstance(stream_obj))
+    sendfile_stream_ = LibuvStreamWrap::From(env(), stream_obj);
+#endif
   Debug(this, "i/o stream consumed");
 }
 
@@ -1980,6 +2424,42 @@ int Http2Stream::DoShutdown(ShutdownWrap* req_wrap) {
   return 1;
 }
 
+int Http2Stream::SendFile(int fd, int64_t offset, int64_t length) {
+#ifdef __linux__
+  if (IsDestroyed() || !IsWritable())
+    return UV_EPIPE;
+  // Data that has been written to the stream before has to go first.
+  if (!session_->CanSendFile() || !queue_.empty() || file_)
+    return UV_ENOTSUP;
+
+  // The length of each DATA frame is fixed before its data is read, so the
+  // amount of data has to be known upfront.
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+    return -errno;
+  if (!S_ISREG(st.st_mode))
+    return UV_ENOTSUP;
+  const int64_t available = std::max<int64_t>(st.st_size - offset, 0);
+  if (length == -1 || length > available)
+    length = available;
+
+  const int file_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+  if (file_fd == -1)
+    return -errno;
+
+  Http2Scope h2scope(this);
+  file_ = std::make_shared<Http2StreamFile>(file_fd);
+  file_offset_ = offset;
+  file_remaining_ = length;
+  flags_ |= NGHTTP2_STREAM_FLAG_SHUT;
+  CHECK_NE(nghttp2_session_resume_data(**session_, id_), NGHTTP2_ERR_NOMEM);
+  Debug(this, "sending %d bytes of file directly", length);
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
 // Destroy the Http2Stream and render it unusable. Actual resources for the
 // Stream will not be freed until the next tick of the Node.js event loop
 // using the SetImmediate queue.
@@ -2006,6 +2486,8 @@ void Http2Stream::Destroy() {
         head.req_wrap->Done(UV_ECANCELED);
       queue_.pop();
     }
+    file_.reset();
+    file_remaining_ = 0;
 
     // We can destroy the stream now if there are no writes for it
     // already on the socket. Otherwise, we'll wait for the garbage collector
@@ -2311,6 +2793,11 @@ ssize_t Http2Stream::Provider::Stream::OnRead(nghttp2_session* handle,
       *flags |= NGHTTP2_DATA_FLAG_NO_COPY;
       stream->DecrementAvailableOutboundLength(amount);
     }
+  } else if (stream->file_remaining_ > 0) {
+    amount = std::min<int64_t>(stream->file_remaining_, length);
+    Debug(session, "sending %d bytes of file for stream %d", amount, id);
+    *flags |= NGHTTP2_DATA_FLAG_NO_COPY;
+    stream->file_remaining_ -= amount;
   }
 
   if (amount == 0 && stream->IsWritable()) {
@@ -2324,7 +2811,8 @@ ssize_t Http2Stream::Provider::Stream::OnRead(nghttp2_session* handle,
     return NGHTTP2_ERR_DEFERRED;
   }
 
-  if (stream->queue_.empty() && !stream->IsWritable()) {
+  if (stream->queue_.empty() && !stream->IsWritable() &&
+      stream->file_remaining_ == 0) {
     Debug(session, "no more data for stream %d", id);
     *flags |= NGHTTP2_DATA_FLAG_EOF;
     if (stream->HasTrailers()) {
@@ -2444,6 +2932,10 @@ void Http2Session::RefreshState(const FunctionCallbackInfo<Value>& args) {
       nghttp2_session_get_hd_deflate_dynamic_table_size(s);
   buffer[IDX_SESSION_STATE_HD_INFLATE_DYNAMIC_TABLE_SIZE] =
       nghttp2_session_get_hd_inflate_dynamic_table_size(s);
+  buffer[IDX_SESSION_STATE_HEADER_STRING_CACHE_HITS] =
+      session->header_string_cache_hits_;
+  buffer[IDX_SESSION_STATE_HEADER_STRING_CACHE_MISSES] =
+      session->header_string_cache_misses_;
 }
 
 
@@ -2602,6 +3094,24 @@ void Http2Stream::Respond(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// Sends a range of a file as the remaining data of the Http2Stream, see
+// Http2Stream::SendFile(int, int64_t, int64_t).
+void Http2Stream::SendFile(const FunctionCallbackInfo<Value>& args) {
+  Http2Stream* stream;
+  ASSIGN_OR_RETURN_UNWRAP(&stream, args.Holder());
+
+  CHECK(args[0]->IsInt32());
+  CHECK(IsSafeJsInt(args[1]));
+  CHECK(IsSafeJsInt(args[2]));
+  const int fd = args[0].As<Int32>()->Value();
+  const int64_t offset = args[1].As<Integer>()->Value();
+  const int64_t length = args[2].As<Integer>()->Value();
+  CHECK_GE(offset, 0);
+  CHECK_GE(length, -1);
+
+  args.GetReturnValue().Set(stream->SendFile(fd, offset, length));
+}
+
 // Submits informational headers on the Http2Stream
 void Http2Stream::Info(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
@@ -2686,6 +3196,23 @@ void Http2Stream::Priority(const FunctionCallbackInfo<Value>& args) {
   Debug(stream, "priority submitted");
 }
 
+// Changes the extensible priority parameters of the stream, and where the
+// session places it, if it uses them.
+void Http2Stream::ExtensiblePriority(const FunctionCallbackInfo<Value>& args) {
+  Http2Stream* stream;
+  ASSIGN_OR_RETURN_UNWRAP(&stream, args.Holder());
+  CHECK(args[0]->IsUint32());
+  const uint32_t urgency = args[0].As<Uint32>()->Value();
+  CHECK_LT(urgency, EXTENSIBLE_PRIORITY_URGENCY_LEVELS);
+
+  stream->set_extensible_priority(urgency, args[1]->IsTrue());
+  Http2Session* session = stream->session();
+  if (session->HasExtensiblePriorities()) {
+    Http2Scope h2scope(stream);
+    session->UpdateExtensiblePriority(stream);
+  }
+}
+
 // A TypedArray shared by C++ and JS land is used to communicate state
 // information about the Http2Stream. This updates the values in that
 // TypedArray so that the state can be read by JS.
@@ -2934,6 +3461,12 @@ void Http2Session::Http2Ping::DetachFromSession() {
   session_ = nullptr;
 }
 
+Http2StreamFile::~Http2StreamFile() {
+#ifdef __linux__
+  CHECK_EQ(close(fd_), 0);
+#endif
+}
+
 void nghttp2_stream_write::MemoryInfo(MemoryTracker* tracker) const {
   if (req_wrap != nullptr)
     tracker->TrackField("req_wrap", req_wrap->GetAsyncWrap());
@@ -3040,10 +3573,13 @@ void Initialize(Local<Object> target,
   env->SetProtoMethod(stream, "id", Http2Stream::GetID);
   env->SetProtoMethod(stream, "destroy", Http2Stream::Destroy);
   env->SetProtoMethod(stream, "priority", Http2Stream::Priority);
+  env->SetProtoMethod(stream, "extensiblePriority",
+                      Http2Stream::ExtensiblePriority);
   env->SetProtoMethod(stream, "pushPromise", Http2Stream::PushPromise);
   env->SetProtoMethod(stream, "info", Http2Stream::Info);
   env->SetProtoMethod(stream, "trailers", Http2Stream::Trailers);
   env->SetProtoMethod(stream, "respond", Http2Stream::Respond);
+  env->SetProtoMethod(stream, "sendFile", Http2Stream::SendFile);
   env->SetProtoMethod(stream, "rstStream", Http2Stream::RstStream);
   env->SetProtoMethod(stream, "refreshState", Http2Stream::RefreshState);
   stream->Inherit(AsyncWrap::GetConstructorTemplate(env));
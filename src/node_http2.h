@@ -11,10 +11,14 @@
 #include "node_mem.h"
 #include "node_perf.h"
 #include "stream_base-inl.h"
+#include "stream_wrap.h"
 #include "string_bytes.h"
 
 #include <algorithm>
+#include <list>
+#include <memory>
 #include <queue>
+#include <unordered_map>
 
 namespace node {
 namespace http2 {
@@ -53,6 +57,18 @@ using performance::PerformanceEntry;
 #define MAX_MAX_HEADER_LIST_SIZE 16777215u
 #define DEFAULT_MAX_HEADER_LIST_PAIRS 128u
 
+// With the coalesceWrites option, pending data is written early once there
+// is more than this much of it.
+#define MAX_COALESCED_OUTGOING_LENGTH 65536
+
+// With the adaptiveWindowSize option, receive windows grow up to this size.
+#define MAX_ADAPTIVE_WINDOW_SIZE (16 * 1024 * 1024)
+
+// The urgency levels of extensible priorities (RFC 9218), and the urgency of
+// requests that do not specify one.
+#define EXTENSIBLE_PRIORITY_URGENCY_LEVELS 8
+#define DEFAULT_EXTENSIBLE_PRIORITY_URGENCY 3
+
 enum nghttp2_session_type {
   NGHTTP2_SESSION_SERVER,
   NGHTTP2_SESSION_CLIENT
@@ -83,13 +99,40 @@ enum nghttp2_stream_options {
   STREAM_OPTION_GET_TRAILERS = 0x2,
 };
 
+// A duplicate of the file descriptor passed to Http2Stream::SendFile(). It is
+// shared by the stream and by the DATA frames that still have to be written,
+// so that it stays open until the last of them has been sent.
+class Http2StreamFile {
+ public:
+  explicit Http2StreamFile(int fd) : fd_(fd) {}
+  ~Http2StreamFile();
+
+  Http2StreamFile(const Http2StreamFile&) = delete;
+  Http2StreamFile& operator=(const Http2StreamFile&) = delete;
+
+  inline int fd() const { return fd_; }
+
+ private:
+  const int fd_;
+};
+
 struct nghttp2_stream_write : public MemoryRetainer {
   WriteWrap* req_wrap = nullptr;
   uv_buf_t buf;
+  // If set, buf.len bytes of this file starting at file_offset are sent
+  // instead of the memory that buf points to.
+  std::shared_ptr<Http2StreamFile> file;
+  int64_t file_offset = 0;
 
   inline explicit nghttp2_stream_write(uv_buf_t buf_) : buf(buf_) {}
   inline nghttp2_stream_write(WriteWrap* req, uv_buf_t buf_) :
       req_wrap(req), buf(buf_) {}
+  inline nghttp2_stream_write(std::shared_ptr<Http2StreamFile> file_,
+                              int64_t offset,
+                              size_t length) :
+      buf(uv_buf_init(nullptr, length)),
+      file(std::move(file_)),
+      file_offset(offset) {}
 
   void MemoryInfo(MemoryTracker* tracker) const override;
   SET_MEMORY_INFO_NAME(nghttp2_stream_write)
@@ -417,6 +460,30 @@ class Http2Options {
     return max_session_memory_;
   }
 
+  void SetCoalesceWrites(bool coalesce) {
+    coalesce_writes_ = coalesce;
+  }
+
+  bool GetCoalesceWrites() {
+    return coalesce_writes_;
+  }
+
+  void SetAdaptiveWindowSize(bool adaptive) {
+    adaptive_window_size_ = adaptive;
+  }
+
+  bool GetAdaptiveWindowSize() {
+    return adaptive_window_size_;
+  }
+
+  void SetExtensiblePriorities(bool extensible) {
+    extensible_priorities_ = extensible;
+  }
+
+  bool GetExtensiblePriorities() {
+    return extensible_priorities_;
+  }
+
  private:
   nghttp2_option* options_;
   uint64_t max_session_memory_ = DEFAULT_MAX_SESSION_MEMORY;
@@ -424,6 +491,9 @@ class Http2Options {
   padding_strategy_type padding_strategy_ = PADDING_STRATEGY_NONE;
   size_t max_outstanding_pings_ = DEFAULT_MAX_PINGS;
   size_t max_outstanding_settings_ = DEFAULT_MAX_SETTINGS;
+  bool coalesce_writes_ = false;
+  bool adaptive_window_size_ = false;
+  bool extensible_priorities_ = false;
 };
 
 class Http2Priority {
@@ -488,6 +558,21 @@ class Http2Stream : public AsyncWrap,
   // Submit a PRIORITY frame for this stream
   int SubmitPriority(nghttp2_priority_spec* prispec, bool silent = false);
 
+  // The extensible priority parameters of this stream. They only take
+  // effect if the session has the extensiblePriorities option.
+  uint8_t urgency() const { return urgency_; }
+  bool incremental() const { return incremental_; }
+  void set_extensible_priority(uint8_t urgency, bool incremental) {
+    urgency_ = urgency;
+    incremental_ = incremental;
+  }
+
+  // Sends |length| bytes of the file |fd| starting at |offset| as the rest
+  // of the stream's DATA, and shuts down the writable side. Returns a libuv
+  // error code if the session cannot send files directly, in which case
+  // the caller has to pipe the file into the stream instead.
+  int SendFile(int fd, int64_t offset, int64_t length);
+
   // Submits an RST_STREAM frame using the given code
   void SubmitRstStream(const uint32_t code);
 
@@ -584,11 +669,13 @@ class Http2Stream : public AsyncWrap,
   static void GetID(const FunctionCallbackInfo<Value>& args);
   static void Destroy(const FunctionCallbackInfo<Value>& args);
   static void Priority(const FunctionCallbackInfo<Value>& args);
+  static void ExtensiblePriority(const FunctionCallbackInfo<Value>& args);
   static void PushPromise(const FunctionCallbackInfo<Value>& args);
   static void RefreshState(const FunctionCallbackInfo<Value>& args);
   static void Info(const FunctionCallbackInfo<Value>& args);
   static void Trailers(const FunctionCallbackInfo<Value>& args);
   static void Respond(const FunctionCallbackInfo<Value>& args);
+  static void SendFile(const FunctionCallbackInfo<Value>& args);
   static void RstStream(const FunctionCallbackInfo<Value>& args);
 
   class Provider;
@@ -627,6 +714,9 @@ class Http2Stream : public AsyncWrap,
   uint32_t current_headers_length_ = 0;  // total number of octets
   std::vector<nghttp2_header> current_headers_;
 
+  uint8_t urgency_ = DEFAULT_EXTENSIBLE_PRIORITY_URGENCY;
+  bool incremental_ = false;
+
   // This keeps track of the amount of data read from the socket while the
   // socket was in paused mode. When `ReadStart()` is called (and not before
   // then), we tell nghttp2 that we consumed that data to get proper
@@ -638,6 +728,13 @@ class Http2Stream : public AsyncWrap,
   std::queue<nghttp2_stream_write> queue_;
   size_t available_outbound_length_ = 0;
 
+  // Set by SendFile(). DATA frames are then taken from this file, starting
+  // at file_offset_, instead of from queue_. file_remaining_ is the number
+  // of bytes that nghttp2 has not been told about yet.
+  std::shared_ptr<Http2StreamFile> file_;
+  int64_t file_offset_ = 0;
+  int64_t file_remaining_ = 0;
+
   Http2StreamListener stream_listener_;
 
   friend class Http2Session;
@@ -737,6 +834,17 @@ class Http2Session : public AsyncWrap,
   void Origin(nghttp2_origin_entry* ov, size_t count);
 
   uint8_t SendPendingData();
+  void SendOutgoingWithFiles(const uv_buf_t* bufs, size_t count);
+
+  // Adaptive receive windows, see the adaptiveWindowSize option.
+  void OnAdaptiveWindowData(Http2Stream* stream, size_t length);
+
+  // Extensible priorities, see the extensiblePriorities option.
+  bool HasExtensiblePriorities() const { return extensible_priorities_; }
+  void UpdateExtensiblePriority(Http2Stream* stream);
+  bool EnsureUrgencyAnchors();
+  void OnAdaptiveWindowPingAck();
+  int32_t GetAdaptiveStreamWindowSize();
 
   // Submits a new request. If the request is a success, assigned
   // will be a pointer to the Http2Stream instance assigned.
@@ -782,6 +890,13 @@ class Http2Session : public AsyncWrap,
   // Indicates whether there currently exist outgoing buffers for this stream.
   bool HasWritesOnSocketForStream(Http2Stream* stream);
 
+  // Whether the underlying stream is a plain socket that file data can be
+  // written to with sendfile(2), see Http2Stream::SendFile().
+  inline bool CanSendFile() {
+    return sendfile_stream_ != nullptr &&
+           static_cast<StreamBase*>(sendfile_stream_) == underlying_stream();
+  }
+
   // Write data from stream_buf_ to the session
   ssize_t ConsumeHTTP2Data();
 
@@ -795,6 +910,7 @@ class Http2Session : public AsyncWrap,
     tracker->TrackFieldWithSize("pending_rst_streams",
                                 pending_rst_streams_.size() * sizeof(int32_t));
     tracker->TrackFieldWithSize("nghttp2_memory", current_nghttp2_memory_);
+    tracker->TrackFieldWithSize("nghttp2_memory_pool", PooledMemory());
   }
 
   SET_MEMORY_INFO_NAME(Http2Session)
@@ -863,6 +979,13 @@ class Http2Session : public AsyncWrap,
   // this session now, and may outlive it.
   void StopTrackingRcbuf(nghttp2_rcbuf* buf);
 
+  // Returns the JS string for a received header name or value, taking over
+  // the reference to |buf|. HPACK decodes repeated headers that are served
+  // from its dynamic table into the same rcbuf, so the string created for
+  // an rcbuf is cached and reused for as long as it is in use.
+  MaybeLocal<v8::String> GetHeaderString(nghttp2_rcbuf* buf, bool is_name);
+  void ClearHeaderStringCache();
+
   // Returns the current session memory including memory allocated by nghttp2,
   // the current outbound storage queue, and pending writes.
   uint64_t GetCurrentSessionMemory() {
@@ -1032,6 +1155,29 @@ class Http2Session : public AsyncWrap,
   std::vector<nghttp2_stream_write> outgoing_buffers_;
   std::vector<uint8_t> outgoing_storage_;
   size_t outgoing_length_ = 0;
+  // If set, pending data is only written once per event loop iteration,
+  // or once more than MAX_COALESCED_OUTGOING_LENGTH bytes are pending.
+  bool coalesce_writes_ = false;
+  // The consumed stream, if it supports LibuvStreamWrap::SendFile().
+  LibuvStreamWrap* sendfile_stream_ = nullptr;
+
+  // With the adaptiveWindowSize option, the bytes received during the round
+  // trip of a PING are an estimate of the bandwidth-delay product (BDP) of
+  // the connection, and the receive windows grow with that estimate.
+  bool adaptive_window_ = false;
+  bool bdp_ping_outstanding_ = false;
+  uint64_t bdp_ping_sent_at_ = 0;
+  uint64_t bdp_bytes_received_ = 0;
+  int32_t adaptive_window_size_ = NGHTTP2_INITIAL_WINDOW_SIZE;
+
+  // With the extensiblePriorities option, streams are placed in the
+  // dependency tree below one idle anchor stream per urgency level. Each
+  // anchor depends on the one of the next more urgent level with the minimum
+  // weight, so that a level is only served when the more urgent ones are
+  // blocked. The last non-incremental stream of each level is remembered so
+  // that the next one can depend on it and is sent after it.
+  bool extensible_priorities_ = false;
+  int32_t last_sequential_stream_[EXTENSIBLE_PRIORITY_URGENCY_LEVELS] = {};
   std::vector<int32_t> pending_rst_streams_;
   // Count streams that have been rejected while being opened. Exceeding a fixed
   // limit will result in the session being destroyed, as an indication of a
@@ -1041,6 +1187,17 @@ class Http2Session : public AsyncWrap,
   // Also use the invalid frame count as a measure for rejecting input frames.
   uint32_t invalid_frame_count_ = 0;
 
+  // Most recently used entry first. Each entry holds a reference to its rcbuf,
+  // so that its address is not reused for another header while cached.
+  using HeaderStringCacheEntry =
+      std::pair<nghttp2_rcbuf*, v8::Global<v8::String>>;
+  std::list<HeaderStringCacheEntry> header_string_lru_;
+  std::unordered_map<nghttp2_rcbuf*,
+                     std::list<HeaderStringCacheEntry>::iterator>
+      header_string_cache_;
+  uint64_t header_string_cache_hits_ = 0;
+  uint64_t header_string_cache_misses_ = 0;
+
   void PushOutgoingBuffer(nghttp2_stream_write&& write);
   void CopyDataIntoOutgoing(const uint8_t* src, size_t src_length);
   void ClearOutgoing(int status);
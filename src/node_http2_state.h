@@ -29,6 +29,8 @@ namespace http2 {
     IDX_SESSION_STATE_OUTBOUND_QUEUE_SIZE,
     IDX_SESSION_STATE_HD_DEFLATE_DYNAMIC_TABLE_SIZE,
     IDX_SESSION_STATE_HD_INFLATE_DYNAMIC_TABLE_SIZE,
+    IDX_SESSION_STATE_HEADER_STRING_CACHE_HITS,
+    IDX_SESSION_STATE_HEADER_STRING_CACHE_MISSES,
     IDX_SESSION_STATE_COUNT
   };
 
@@ -52,6 +54,9 @@ namespace http2 {
     IDX_OPTIONS_MAX_OUTSTANDING_PINGS,
     IDX_OPTIONS_MAX_OUTSTANDING_SETTINGS,
     IDX_OPTIONS_MAX_SESSION_MEMORY,
+    IDX_OPTIONS_COALESCE_WRITES,
+    IDX_OPTIONS_ADAPTIVE_WINDOW_SIZE,
+    IDX_OPTIONS_EXTENSIBLE_PRIORITIES,
     IDX_OPTIONS_FLAGS
   };
 
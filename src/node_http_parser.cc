@@ -26,12 +26,20 @@
 #include "async_wrap-inl.h"
 #include "env-inl.h"
 #include "memory_tracker-inl.h"
+#include "node_dtrace.h"
 #include "stream_base-inl.h"
 #include "v8.h"
 #include "llhttp.h"
 
+#include <cstdio>  // snprintf()
 #include <cstdlib>  // free()
 #include <cstring>  // strdup(), strchr()
+#include <ctime>  // time()
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 
 // This is a binding to llhttp (https://github.com/nodejs/llhttp)
@@ -50,16 +58,20 @@ namespace node {
 namespace {  // NOLINT(build/namespaces)
 
 using v8::Array;
+using v8::ArrayBufferView;
 using v8::Boolean;
 using v8::Context;
+using v8::Eternal;
 using v8::EscapableHandleScope;
 using v8::Exception;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
+using v8::Global;
 using v8::HandleScope;
 using v8::Int32;
 using v8::Integer;
+using v8::Isolate;
 using v8::Local;
 using v8::MaybeLocal;
 using v8::Number;
@@ -74,8 +86,89 @@ const uint32_t kOnHeadersComplete = 1;
 const uint32_t kOnBody = 2;
 const uint32_t kOnMessageComplete = 3;
 const uint32_t kOnExecute = 4;
-// Any more fields than this will be flushed into JS
-const size_t kMaxHeaderFieldsCount = 32;
+const uint32_t kOnMessages = 5;
+// Body pieces shorter than this are collected and passed to JS together.
+const size_t kMaxCoalescedBodyLength = 4096;
+// Headers are passed to JS in a single array. This many of them are
+// collected on the stack before the array is created.
+const size_t kStackHeaderFieldsCount = 32;
+
+// Header names that are looked up in a table of per-isolate strings instead
+// of being created anew for every message. Names are matched exactly, so that
+// `rawHeaders` keeps the spelling that was sent, which is why the common
+// spellings of a name are listed separately.
+#define KNOWN_HEADER_NAMES(V)                                                 \
+  V("accept")                                                                 \
+  V("Accept")                                                                 \
+  V("accept-encoding")                                                        \
+  V("Accept-Encoding")                                                        \
+  V("accept-language")                                                        \
+  V("Accept-Language")                                                        \
+  V("authorization")                                                          \
+  V("Authorization")                                                          \
+  V("cache-control")                                                          \
+  V("Cache-Control")                                                          \
+  V("connection")                                                             \
+  V("Connection")                                                             \
+  V("content-encoding")                                                       \
+  V("Content-Encoding")                                                       \
+  V("content-length")                                                         \
+  V("Content-Length")                                                         \
+  V("content-type")                                                           \
+  V("Content-Type")                                                           \
+  V("cookie")                                                                 \
+  V("Cookie")                                                                 \
+  V("date")                                                                   \
+  V("Date")                                                                   \
+  V("etag")                                                                   \
+  V("ETag")                                                                   \
+  V("expect")                                                                 \
+  V("Expect")                                                                 \
+  V("host")                                                                   \
+  V("Host")                                                                   \
+  V("if-modified-since")                                                      \
+  V("If-Modified-Since")                                                      \
+  V("if-none-match")                                                          \
+  V("If-None-Match")                                                          \
+  V("keep-alive")                                                             \
+  V("Keep-Alive")                                                             \
+  V("last-modified")                                                          \
+  V("Last-Modified")                                                          \
+  V("location")                                                               \
+  V("Location")                                                               \
+  V("origin")                                                                 \
+  V("Origin")                                                                 \
+  V("referer")                                                                \
+  V("Referer")                                                                \
+  V("server")                                                                 \
+  V("Server")                                                                 \
+  V("set-cookie")                                                             \
+  V("Set-Cookie")                                                             \
+  V("transfer-encoding")                                                      \
+  V("Transfer-Encoding")                                                      \
+  V("upgrade")                                                                \
+  V("Upgrade")                                                                \
+  V("user-agent")                                                             \
+  V("User-Agent")                                                             \
+  V("vary")                                                                   \
+  V("Vary")                                                                   \
+  V("x-forwarded-for")                                                        \
+  V("X-Forwarded-For")                                                        \
+  V("x-forwarded-proto")                                                      \
+  V("X-Forwarded-Proto")                                                      \
+  V("x-request-id")                                                           \
+  V("X-Request-Id")
+
+struct KnownHeaderName {
+  const char* name;
+  size_t length;
+};
+
+const KnownHeaderName kKnownHeaderNames[] = {
+#define V(name) { name, sizeof(name) - 1 },
+  KNOWN_HEADER_NAMES(V)
+#undef V
+};
 
 inline bool IsOWS(char c) {
   return c == ' ' || c == '\t';
@@ -161,6 +254,166 @@ struct StringPtr {
   size_t size_;
 };
 
+// Responses that request parsers which consume a stream write to it directly,
+// without passing the request to JS. They are looked up by method and
+// request target, see Server.prototype.setStaticResponse() in
+// lib/_http_server.js.
+class StaticResponses : public BaseObject {
+ public:
+  struct Response {
+    // Keeps |data| alive, and is attached to pending writes of it.
+    Global<Object> buffer;
+    const char* data;
+    size_t length;
+    // The length of the status line and headers, which is all that is sent
+    // in response to HEAD requests.
+    size_t head_length;
+    // The offset of the value of the Date header in |data|, or kNoDate.
+    size_t date_offset;
+    // The second that the Date header in |data| was set for.
+    time_t date_time;
+  };
+
+  static constexpr size_t kNoDate = static_cast<size_t>(-1);
+  // The length of an IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT".
+  static constexpr size_t kDateLength = 29;
+
+  StaticResponses(Environment* env, Local<Object> wrap)
+      : BaseObject(env, wrap) {
+    MakeWeak();
+  }
+
+  SET_NO_MEMORY_INFO()
+  SET_MEMORY_INFO_NAME(StaticResponses)
+  SET_SELF_SIZE(StaticResponses)
+
+  Response* Find(uint8_t method, const StringPtr& target) {
+    if (responses_.empty())
+      return nullptr;
+    auto it = responses_.find(Key(method, target.str_, target.size_));
+    return it == responses_.end() ? nullptr : &it->second;
+  }
+
+  // Brings the Date header of |response| up to date. The current date is
+  // formatted at most once per second, like utcDate() in lib/internal/http.js
+  // does. Writes of the previous buffer may still be pending, so a new one is
+  // created rather than changing it in place.
+  bool UpdateDate(Response* response) {
+    if (response->date_offset == kNoDate)
+      return true;
+    const time_t now = time(nullptr);
+    if (response->date_time == now)
+      return true;
+    if (date_time_ != now) {
+      FormatDate(now, date_);
+      date_time_ = now;
+    }
+
+    Local<Object> buffer;
+    if (!Buffer::Copy(env(), response->data, response->length)
+            .ToLocal(&buffer)) {
+      return false;
+    }
+    char* data = Buffer::Data(buffer);
+    memcpy(data + response->date_offset, date_, kDateLength);
+    response->buffer.Reset(env()->isolate(), buffer);
+    response->data = data;
+    response->date_time = now;
+    return true;
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    new StaticResponses(env, args.This());
+  }
+
+  // responses.set(method, target, buffer, headLength, dateOffset)
+  static void Set(const FunctionCallbackInfo<Value>& args) {
+    StaticResponses* responses;
+    ASSIGN_OR_RETURN_UNWRAP(&responses, args.Holder());
+    CHECK(args[0]->IsUint32());
+    CHECK(args[1]->IsString());
+    CHECK(args[2]->IsArrayBufferView());
+    CHECK(args[3]->IsUint32());
+    CHECK(args[4]->IsInt32());
+
+    const uint32_t method = args[0].As<Uint32>()->Value();
+    Utf8Value target(args.GetIsolate(), args[1]);
+    ArrayBufferViewContents<char> contents(args[2]);
+    const size_t head_length = args[3].As<Uint32>()->Value();
+    const int32_t date_offset = args[4].As<Int32>()->Value();
+    CHECK_LE(method, UINT8_MAX);
+    CHECK_LE(head_length, contents.length());
+    if (date_offset >= 0)
+      CHECK_LE(date_offset + kDateLength, head_length);
+
+    Response& response =
+        responses->responses_[Key(method, *target, target.length())];
+    response.buffer.Reset(args.GetIsolate(), args[2].As<ArrayBufferView>());
+    response.data = contents.data();
+    response.length = contents.length();
+    response.head_length = head_length;
+    response.date_offset = date_offset >= 0 ? date_offset : kNoDate;
+    response.date_time = -1;
+  }
+
+  // responses.delete(method, target)
+  static void Delete(const FunctionCallbackInfo<Value>& args) {
+    StaticResponses* responses;
+    ASSIGN_OR_RETURN_UNWRAP(&responses, args.Holder());
+    CHECK(args[0]->IsUint32());
+    CHECK(args[1]->IsString());
+
+    Utf8Value target(args.GetIsolate(), args[1]);
+    responses->responses_.erase(
+        Key(args[0].As<Uint32>()->Value(), *target, target.length()));
+  }
+
+ private:
+  static std::string Key(uint8_t method, const char* target, size_t length) {
+    std::string key(1, static_cast<char>(method));
+    key.append(target, length);
+    return key;
+  }
+
+  // Writes |time| as an IMF-fixdate, which does not depend on the locale.
+  static void FormatDate(time_t time, char* out) {
+    static const char kDays[][4] = {
+      "Thu", "Fri", "Sat", "Sun", "Mon", "Tue", "Wed"
+    };
+    static const char kMonths[][4] = {
+      "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+      "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+    };
+    const int64_t days = static_cast<int64_t>(time) / 86400;
+    const int64_t seconds = static_cast<int64_t>(time) % 86400;
+    // The civil date of |days| since 1970-01-01, see
+    // http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+    const int64_t z = days + 719468;
+    const int64_t era = z / 146097;
+    const int64_t doe = z - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    const int day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    const int month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    const int year = static_cast<int>(yoe + era * 400 + (month <= 2));
+
+    char date[kDateLength + 1];
+    snprintf(date, sizeof(date), "%s, %02d %s %04d %02d:%02d:%02d GMT",
+             kDays[days % 7], day, kMonths[month - 1], year,
+             static_cast<int>(seconds / 3600),
+             static_cast<int>(seconds / 60 % 60),
+             static_cast<int>(seconds % 60));
+    memcpy(out, date, kDateLength);
+  }
+
+  std::unordered_map<std::string, Response> responses_;
+  // The current date, formatted for the Date header.
+  char date_[kDateLength];
+  time_t date_time_ = -1;
+};
+
 class Parser : public AsyncWrap, public StreamListener {
  public:
   Parser(Environment* env, Local<Object> wrap)
@@ -216,16 +469,12 @@ class Parser : public AsyncWrap, public StreamListener {
     if (num_fields_ == num_values_) {
       // start of new field name
       num_fields_++;
-      if (num_fields_ == kMaxHeaderFieldsCount) {
-        // ran out of space - flush to javascript land
-        Flush();
-        num_fields_ = 1;
-        num_values_ = 0;
-      }
+      if (num_fields_ > fields_.size())
+        fields_.emplace_back();
       fields_[num_fields_ - 1].Reset();
     }
 
-    CHECK_LT(num_fields_, kMaxHeaderFieldsCount);
+    CHECK_LE(num_fields_, fields_.size());
     CHECK_EQ(num_fields_, num_values_ + 1);
 
     fields_[num_fields_ - 1].Update(at, length);
@@ -243,10 +492,12 @@ class Parser : public AsyncWrap, public StreamListener {
     if (num_values_ != num_fields_) {
       // start of new header value
       num_values_++;
+      if (num_values_ > values_.size())
+        values_.emplace_back();
       values_[num_values_ - 1].Reset();
     }
 
-    CHECK_LT(num_values_, arraysize(values_));
+    CHECK_LE(num_values_, values_.size());
     CHECK_EQ(num_values_, num_fields_);
 
     values_[num_values_ - 1].Update(at, length);
@@ -258,6 +509,12 @@ class Parser : public AsyncWrap, public StreamListener {
   int on_headers_complete() {
     header_nread_ = 0;
 
+    if (static_responses_) {
+      if (ServeStaticResponse())
+        return 0;
+      pending_responses_++;
+    }
+
     // Arguments for the on-headers-complete javascript callback. This
     // list needs to be kept in sync with the actual argument list for
     // `parserOnHeadersComplete` in lib/_http_common.js.
@@ -324,6 +581,16 @@ class Parser : public AsyncWrap, public StreamListener {
 
     argv[A_UPGRADE] = Boolean::New(env()->isolate(), parser_.upgrade);
 
+    // Requests that are not upgrades never make the callback skip the body,
+    // so its return value is not needed and the call can be deferred.
+    if (batch_messages_ && !parser_.upgrade && !have_flushed_) {
+      AppendToBatch(kOnHeadersComplete, argv, arraysize(argv));
+      return 0;
+    }
+
+    if (!FlushBatch())
+      return -1;
+
     MaybeLocal<Value> head_response;
     {
       InternalCallbackScope callback_scope(
@@ -346,27 +613,54 @@ class Parser : public AsyncWrap, public StreamListener {
   }
 
 
+  // If coalesce_body_ is set, small pieces of the body, such as the data of
+  // small chunks in a chunked body, are delivered to JS together by
+  // FlushBody(), once per Execute() or message. Larger pieces are delivered
+  // as they are, without copying them.
   int on_body(const char* at, size_t length) {
+    const size_t offset = at - current_buffer_data_;
+    if (coalesce_body_ && length < kMaxCoalescedBodyLength) {
+      body_spans_.emplace_back(offset, length);
+      return 0;
+    }
+
+    if (!FlushBody() || !EmitBody(Local<Object>(), offset, length)) {
+      llhttp_set_error_reason(&parser_, "HPE_JS_EXCEPTION:JS Exception");
+      return HPE_USER;
+    }
+    return 0;
+  }
+
+
+  // Calls kOnBody with `length` bytes at `offset` in `buffer`, or in the
+  // current buffer if `buffer` is empty. Returns false if the callback threw.
+  bool EmitBody(Local<Object> buffer, size_t offset, size_t length) {
     EscapableHandleScope scope(env()->isolate());
 
     Local<Object> obj = object();
     Local<Value> cb = obj->Get(env()->context(), kOnBody).ToLocalChecked();
 
     if (!cb->IsFunction())
-      return 0;
-
-    // We came from consumed stream
-    if (current_buffer_.IsEmpty()) {
-      // Make sure Buffer will be in parent HandleScope
-      current_buffer_ = scope.Escape(Buffer::Copy(
-          env()->isolate(),
-          current_buffer_data_,
-          current_buffer_len_).ToLocalChecked());
+      return true;
+
+    if (!FlushBatch())
+      return false;
+
+    if (buffer.IsEmpty()) {
+      // We came from consumed stream
+      if (current_buffer_.IsEmpty()) {
+        // Make sure Buffer will be in parent HandleScope
+        current_buffer_ = scope.Escape(Buffer::Copy(
+            env()->isolate(),
+            current_buffer_data_,
+            current_buffer_len_).ToLocalChecked());
+      }
+      buffer = current_buffer_;
     }
 
     Local<Value> argv[3] = {
-      current_buffer_,
-      Integer::NewFromUnsigned(env()->isolate(), at - current_buffer_data_),
+      buffer,
+      Integer::NewFromUnsigned(env()->isolate(), offset),
       Integer::NewFromUnsigned(env()->isolate(), length)
     };
 
@@ -376,17 +670,54 @@ class Parser : public AsyncWrap, public StreamListener {
 
     if (r.IsEmpty()) {
       got_exception_ = true;
-      llhttp_set_error_reason(&parser_, "HPE_JS_EXCEPTION:JS Exception");
-      return HPE_USER;
+      return false;
     }
 
-    return 0;
+    return true;
+  }
+
+
+  // Delivers the pieces of the body that on_body() held back. Several pieces
+  // are copied into a single Buffer. Returns false if the callback threw.
+  bool FlushBody() {
+    if (body_spans_.empty())
+      return true;
+
+    if (body_spans_.size() == 1) {
+      const std::pair<size_t, size_t> span = body_spans_[0];
+      body_spans_.clear();
+      return EmitBody(Local<Object>(), span.first, span.second);
+    }
+
+    HandleScope scope(env()->isolate());
+    size_t length = 0;
+    for (const auto& span : body_spans_)
+      length += span.second;
+    AllocatedBuffer body = env()->AllocateManaged(length);
+    size_t offset = 0;
+    for (const auto& span : body_spans_) {
+      memcpy(body.data() + offset,
+             current_buffer_data_ + span.first,
+             span.second);
+      offset += span.second;
+    }
+    body_spans_.clear();
+    return EmitBody(body.ToBuffer().ToLocalChecked(), 0, length);
   }
 
 
   int on_message_complete() {
     HandleScope scope(env()->isolate());
 
+    // Nothing about the message is passed to JS, see ServeStaticResponse().
+    if (static_served_) {
+      static_served_ = false;
+      return 0;
+    }
+
+    if (!FlushBody())
+      return -1;
+
     if (num_fields_)
       Flush();  // Flush trailing HTTP headers.
 
@@ -397,6 +728,11 @@ class Parser : public AsyncWrap, public StreamListener {
     if (!cb->IsFunction())
       return 0;
 
+    if (batch_messages_) {
+      AppendToBatch(kOnMessageComplete, nullptr, 0);
+      return 0;
+    }
+
     MaybeLocal<Value> r;
     {
       InternalCallbackScope callback_scope(
@@ -448,6 +784,19 @@ class Parser : public AsyncWrap, public StreamListener {
     // it needs to be triggered manually.
     parser->EmitTraceEventDestroy();
     parser->EmitDestroy();
+
+    // The parser is kept for reuse. Drop copies of the last message's data,
+    // but keep the header storage itself for the next connection.
+    parser->url_.Reset();
+    parser->status_message_.Reset();
+    for (StringPtr& field : parser->fields_)
+      field.Reset();
+    for (StringPtr& value : parser->values_)
+      value.Reset();
+    parser->num_fields_ = parser->num_values_ = 0;
+    parser->batch_.Reset();
+    parser->batch_length_ = 0;
+    parser->static_responses_.reset();
   }
 
 
@@ -502,6 +851,11 @@ class Parser : public AsyncWrap, public StreamListener {
   static void Initialize(const FunctionCallbackInfo<Value>& args) {
     Environment* env = Environment::GetCurrent(args);
     bool lenient = args[3]->IsTrue();
+    bool batch_messages = args[4]->IsTrue();
+    bool coalesce_body = args[5]->IsTrue();
+    StaticResponses* static_responses = nullptr;
+    if (args[6]->IsObject())
+      static_responses = Unwrap<StaticResponses>(args[6].As<Object>());
 
     uint64_t max_http_header_size = 0;
 
@@ -532,7 +886,18 @@ class Parser : public AsyncWrap, public StreamListener {
 
     parser->set_provider_type(provider);
     parser->AsyncReset(args[1].As<Object>());
-    parser->Init(type, max_http_header_size, lenient);
+    parser->Init(type, max_http_header_size, lenient, batch_messages,
+                 coalesce_body, static_responses);
+  }
+
+  // Called by the server when JS has finished a response, so that requests
+  // for static responses can be answered natively again once there are no
+  // earlier responses left to send.
+  static void FinishResponse(const FunctionCallbackInfo<Value>& args) {
+    Parser* parser;
+    ASSIGN_OR_RETURN_UNWRAP(&parser, args.Holder());
+    if (parser->pending_responses_ > 0)
+      parser->pending_responses_--;
   }
 
   template <bool should_pause>
@@ -630,6 +995,7 @@ class Parser : public AsyncWrap, public StreamListener {
       return;
 
     current_buffer_.Clear();
+    static_served_count_ = 0;
     Local<Value> ret = Execute(buf.base, nread);
 
     // Exception
@@ -646,7 +1012,11 @@ class Parser : public AsyncWrap, public StreamListener {
     current_buffer_len_ = nread;
     current_buffer_data_ = buf.base;
 
-    MakeCallback(cb.As<Function>(), 1, &ret);
+    Local<Value> argv[] = {
+      ret,
+      Integer::NewFromUnsigned(env()->isolate(), static_served_count_)
+    };
+    MakeCallback(cb.As<Function>(), arraysize(argv), argv);
 
     current_buffer_len_ = 0;
     current_buffer_data_ = nullptr;
@@ -665,6 +1035,8 @@ class Parser : public AsyncWrap, public StreamListener {
     // Do not allow re-entering `http_parser_execute()`
     CHECK_EQ(execute_depth_, 0);
 
+    NODE_USDT_PROBE(HTTP_PARSER_EXECUTE_START, this,
+                    static_cast<int64_t>(len));
     execute_depth_++;
     if (data == nullptr) {
       err = llhttp_finish(&parser_);
@@ -672,6 +1044,11 @@ class Parser : public AsyncWrap, public StreamListener {
       err = llhttp_execute(&parser_, data, len);
       Save();
     }
+    if (got_exception_)
+      body_spans_.clear();
+    else
+      FlushBody();
+    FlushBatch();
     execute_depth_--;
 
     // Calculate bytes read and resume after Upgrade/CONNECT pause
@@ -685,6 +1062,8 @@ class Parser : public AsyncWrap, public StreamListener {
         llhttp_resume_after_upgrade(&parser_);
       }
     }
+    NODE_USDT_PROBE(HTTP_PARSER_EXECUTE_DONE, this,
+                    static_cast<int64_t>(nread));
 
     // Apply pending pause
     if (pending_pause_) {
@@ -739,16 +1118,132 @@ class Parser : public AsyncWrap, public StreamListener {
     return scope.Escape(nread_obj);
   }
 
+  // Writes the static response for the current request, if there is one, to
+  // the consumed stream. Requests are left to JS if that has not finished the
+  // responses to earlier requests yet, which would be overtaken otherwise,
+  // and if they have a body, ask for an upgrade or end the connection.
+  bool ServeStaticResponse() {
+    if (stream_ == nullptr || pending_responses_ != 0 || have_flushed_ ||
+        parser_.upgrade || (parser_.flags & F_CHUNKED) ||
+        parser_.content_length != 0 || !llhttp_should_keep_alive(&parser_)) {
+      return false;
+    }
+
+    StaticResponses::Response* response =
+        static_responses_->Find(parser_.method, url_);
+    if (response == nullptr || !static_responses_->UpdateDate(response))
+      return false;
+
+    uv_buf_t buf = uv_buf_init(
+        const_cast<char*>(response->data),
+        parser_.method == HTTP_HEAD ? response->head_length : response->length);
+    StreamWriteResult res = static_cast<StreamBase*>(stream_)->Write(&buf, 1);
+    if (res.err != 0)
+      return false;
+    if (res.async) {
+      res.wrap->object()->Set(env()->context(),
+                              env()->buffer_string(),
+                              response->buffer.Get(env()->isolate())).Check();
+    }
+
+    num_fields_ = 0;
+    num_values_ = 0;
+    static_served_ = true;
+    static_served_count_++;
+    return true;
+  }
+
+  // Returns the per-isolate string for |field| if it is one of
+  // kKnownHeaderNames, and a new string otherwise.
+  Local<String> HeaderNameToString(const StringPtr& field) {
+    for (size_t i = 0; i < arraysize(kKnownHeaderNames); i++) {
+      const KnownHeaderName& known = kKnownHeaderNames[i];
+      if (known.length != field.size_ ||
+          memcmp(known.name, field.str_, field.size_) != 0) {
+        continue;
+      }
+
+      std::vector<Eternal<String>>& static_strs =
+          env()->isolate_data()->http_parser_static_strs;
+      if (static_strs.empty())
+        static_strs.resize(arraysize(kKnownHeaderNames));
+      Eternal<String>& eternal = static_strs[i];
+      if (eternal.IsEmpty()) {
+        Local<String> str = OneByteString(env()->isolate(),
+                                          known.name,
+                                          known.length);
+        eternal.Set(env()->isolate(), str);
+        return str;
+      }
+      return eternal.Get(env()->isolate());
+    }
+
+    return field.ToString(env());
+  }
+
+
   Local<Array> CreateHeaders() {
-    // There could be extra entries but the max size should be fixed
-    Local<Value> headers_v[kMaxHeaderFieldsCount * 2];
+    MaybeStackBuffer<Local<Value>, kStackHeaderFieldsCount * 2> headers_v(
+        num_values_ * 2);
 
     for (size_t i = 0; i < num_values_; ++i) {
-      headers_v[i * 2] = fields_[i].ToString(env());
+      headers_v[i * 2] = HeaderNameToString(fields_[i]);
       headers_v[i * 2 + 1] = values_[i].ToTrimmedString(env());
     }
 
-    return Array::New(env()->isolate(), headers_v, num_values_ * 2);
+    return Array::New(env()->isolate(), headers_v.out(), num_values_ * 2);
+  }
+
+
+  // Queues a kOnHeadersComplete or kOnMessageComplete callback with its
+  // arguments. Queued callbacks are delivered in order through a single call
+  // to kOnMessages by FlushBatch(), which runs before any other callback and
+  // at the end of Execute().
+  void AppendToBatch(uint32_t callback, Local<Value>* argv, size_t argc) {
+    Isolate* isolate = env()->isolate();
+    HandleScope scope(isolate);
+
+    if (batch_.IsEmpty())
+      batch_.Reset(isolate, Array::New(isolate));
+    Local<Array> batch = batch_.Get(isolate);
+
+    batch->Set(env()->context(),
+               batch_length_++,
+               Integer::NewFromUnsigned(isolate, callback)).Check();
+    for (size_t i = 0; i < argc; i++)
+      batch->Set(env()->context(), batch_length_++, argv[i]).Check();
+  }
+
+
+  // Returns false if the kOnMessages callback threw.
+  bool FlushBatch() {
+    if (batch_length_ == 0)
+      return true;
+
+    HandleScope scope(env()->isolate());
+    Local<Value> batch = batch_.Get(env()->isolate());
+    batch_.Reset();
+    batch_length_ = 0;
+
+    Local<Value> cb =
+        object()->Get(env()->context(), kOnMessages).ToLocalChecked();
+    if (!cb->IsFunction())
+      return true;
+
+    MaybeLocal<Value> r;
+    {
+      InternalCallbackScope callback_scope(
+          this, InternalCallbackScope::kSkipTaskQueues);
+      r = cb.As<Function>()->Call(env()->context(), object(), 1, &batch);
+      if (r.IsEmpty()) callback_scope.MarkAsFailed();
+    }
+
+    if (r.IsEmpty()) {
+      got_exception_ = true;
+      return false;
+    }
+
+    return true;
   }
 
 
@@ -756,6 +1251,9 @@ class Parser : public AsyncWrap, public StreamListener {
   void Flush() {
     HandleScope scope(env()->isolate());
 
+    if (!FlushBatch())
+      return;
+
     Local<Object> obj = object();
     Local<Value> cb = obj->Get(env()->context(), kOnHeaders).ToLocalChecked();
 
@@ -779,7 +1277,12 @@ class Parser : public AsyncWrap, public StreamListener {
   }
 
 
-  void Init(llhttp_type_t type, uint64_t max_http_header_size, bool lenient) {
+  void Init(llhttp_type_t type,
+            uint64_t max_http_header_size,
+            bool lenient,
+            bool batch_messages,
+            bool coalesce_body,
+            StaticResponses* static_responses) {
     llhttp_init(&parser_, type, &settings);
     llhttp_set_lenient(&parser_, lenient);
     header_nread_ = 0;
@@ -790,6 +1293,15 @@ class Parser : public AsyncWrap, public StreamListener {
     have_flushed_ = false;
     got_exception_ = false;
     max_http_header_size_ = max_http_header_size;
+    // Only request parsers batch messages, see on_headers_complete().
+    batch_messages_ = batch_messages && type == HTTP_REQUEST;
+    batch_.Reset();
+    batch_length_ = 0;
+    coalesce_body_ = coalesce_body;
+    body_spans_.clear();
+    static_responses_.reset(static_responses);
+    pending_responses_ = 0;
+    static_served_ = false;
   }
 
 
@@ -816,8 +1328,11 @@ class Parser : public AsyncWrap, public StreamListener {
   }
 
   llhttp_t parser_;
-  StringPtr fields_[kMaxHeaderFieldsCount];  // header fields
-  StringPtr values_[kMaxHeaderFieldsCount];  // header values
+  // These only grow, so that a parser that is reused for many messages does
+  // not allocate StringPtrs for every one of them. A deque never moves its
+  // elements, which StringPtr does not support.
+  std::deque<StringPtr> fields_;  // header fields
+  std::deque<StringPtr> values_;  // header values
   StringPtr url_;
   StringPtr status_message_;
   size_t num_fields_;
@@ -831,6 +1346,21 @@ class Parser : public AsyncWrap, public StreamListener {
   bool pending_pause_ = false;
   uint64_t header_nread_ = 0;
   uint64_t max_http_header_size_;
+  bool batch_messages_ = false;
+  Global<Array> batch_;
+  uint32_t batch_length_ = 0;
+  bool coalesce_body_ = false;
+  // Offsets and lengths in the current buffer of the body pieces that have
+  // not been delivered yet.
+  std::vector<std::pair<size_t, size_t>> body_spans_;
+  BaseObjectPtr<StaticResponses> static_responses_;
+  // Requests that were passed to JS and whose responses have not been
+  // finished yet, see ServeStaticResponse().
+  uint32_t pending_responses_ = 0;
+  // Whether the current message was answered with a static response.
+  bool static_served_ = false;
+  // Static responses written by the current OnStreamRead().
+  uint32_t static_served_count_ = 0;
 
   // These are helper functions for filling `http_parser_settings`, which turn
   // a member function of Parser into a C-style HTTP parser callback.
@@ -867,6 +1397,125 @@ const llhttp_settings_t Parser::settings = {
 };
 
 
+// Lookup tables for the characters allowed in header names and values, see
+// checkIsHttpToken() and checkInvalidHeaderChar() in lib/_http_common.js.
+struct HeaderCharTables {
+  constexpr HeaderCharTables() {
+    for (int c = '0'; c <= '9'; c++) token[c] = true;
+    for (int c = 'a'; c <= 'z'; c++) token[c] = true;
+    for (int c = 'A'; c <= 'Z'; c++) token[c] = true;
+    for (const char* c = "!#$%&'*+-.^_`|~"; *c != '\0'; c++)
+      token[static_cast<uint8_t>(*c)] = true;
+
+    value['\t'] = true;
+    for (int c = 0x20; c <= 0x7e; c++) value[c] = true;
+    for (int c = 0x80; c <= 0xff; c++) value[c] = true;
+  }
+
+  bool token[256] = {};
+  bool value[256] = {};
+};
+
+constexpr HeaderCharTables header_char_tables;
+
+// Returns the length of the prefix of |data| that only consists of bytes for
+// which |table| is true.
+inline size_t ValidPrefixLength(const bool* table,
+                                const uint8_t* data,
+                                size_t length) {
+  size_t i = 0;
+  // Unrolled so that the compiler can check several bytes per iteration.
+  for (; i + 4 <= length; i += 4) {
+    if (!(table[data[i]] & table[data[i + 1]] &
+          table[data[i + 2]] & table[data[i + 3]])) {
+      break;
+    }
+  }
+  while (i < length && table[data[i]])
+    i++;
+  return i;
+}
+
+// serializeHeaders(firstLine, fields, validate) serializes the status or
+// request line followed by the [name, value, name, value, ...] pairs in
+// |fields| and the empty line that ends the header section.
+//
+// Returns the result as a string, or the index of the first invalid name or
+// value if |validate| is true. Returns undefined if any of the inputs is not a
+// one-byte string, in which case the caller has to fall back to serializing
+// the headers itself.
+void SerializeHeaders(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsArray());
+  Local<String> first_line = args[0].As<String>();
+  Local<Array> fields = args[1].As<Array>();
+  const bool validate = args[2]->IsTrue();
+  const uint32_t count = fields->Length();
+  CHECK_EQ(count % 2, 0);
+
+  if (!first_line->IsOneByte())
+    return;
+
+  MaybeStackBuffer<Local<String>, kStackHeaderFieldsCount * 2> strings(count);
+  size_t size = first_line->Length() + 2;  // Trailing CRLF.
+  for (uint32_t i = 0; i < count; i++) {
+    Local<Value> field;
+    if (!fields->Get(env->context(), i).ToLocal(&field))
+      return;
+    if (!field->IsString() || !field.As<String>()->IsOneByte())
+      return;
+    strings[i] = field.As<String>();
+    size += strings[i]->Length();
+  }
+  size += count * 2;  // ": " and CRLF for each pair.
+
+  MaybeStackBuffer<uint8_t, 4096> out(size);
+  uint8_t* pos = out.out();
+  pos += first_line->WriteOneByte(
+      isolate, pos, 0, -1, String::NO_NULL_TERMINATION);
+
+  for (uint32_t i = 0; i < count; i += 2) {
+    const size_t name_length = strings[i]->WriteOneByte(
+        isolate, pos, 0, -1, String::NO_NULL_TERMINATION);
+    if (validate &&
+        (name_length == 0 ||
+         ValidPrefixLength(header_char_tables.token, pos, name_length) !=
+             name_length)) {
+      return args.GetReturnValue().Set(i);
+    }
+    pos += name_length;
+    *pos++ = ':';
+    *pos++ = ' ';
+
+    const size_t value_length = strings[i + 1]->WriteOneByte(
+        isolate, pos, 0, -1, String::NO_NULL_TERMINATION);
+    if (validate &&
+        ValidPrefixLength(header_char_tables.value, pos, value_length) !=
+            value_length) {
+      return args.GetReturnValue().Set(i + 1);
+    }
+    pos += value_length;
+    *pos++ = '\r';
+    *pos++ = '\n';
+  }
+
+  *pos++ = '\r';
+  *pos++ = '\n';
+  CHECK_EQ(static_cast<size_t>(pos - out.out()), size);
+
+  Local<String> result;
+  if (String::NewFromOneByte(isolate,
+                             out.out(),
+                             v8::NewStringType::kNormal,
+                             size).ToLocal(&result)) {
+    args.GetReturnValue().Set(result);
+  }
+}
+
+
 void InitializeHttpParser(Local<Object> target,
                           Local<Value> unused,
                           Local<Context> context,
@@ -890,6 +1539,8 @@ void InitializeHttpParser(Local<Object> target,
          Integer::NewFromUnsigned(env->isolate(), kOnMessageComplete));
   t->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "kOnExecute"),
          Integer::NewFromUnsigned(env->isolate(), kOnExecute));
+  t->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "kOnMessages"),
+         Integer::NewFromUnsigned(env->isolate(), kOnMessages));
 
   Local<Array> methods = Array::New(env->isolate());
 #define V(num, name, string)                                                  \
@@ -912,10 +1563,24 @@ void InitializeHttpParser(Local<Object> target,
   env->SetProtoMethod(t, "consume", Parser::Consume);
   env->SetProtoMethod(t, "unconsume", Parser::Unconsume);
   env->SetProtoMethod(t, "getCurrentBuffer", Parser::GetCurrentBuffer);
+  env->SetProtoMethod(t, "finishResponse", Parser::FinishResponse);
 
   target->Set(env->context(),
               FIXED_ONE_BYTE_STRING(env->isolate(), "HTTPParser"),
               t->GetFunction(env->context()).ToLocalChecked()).Check();
+
+  env->SetMethod(target, "serializeHeaders", SerializeHeaders);
+
+  Local<FunctionTemplate> responses =
+      env->NewFunctionTemplate(StaticResponses::New);
+  responses->InstanceTemplate()->SetInternalFieldCount(1);
+  responses->SetClassName(
+      FIXED_ONE_BYTE_STRING(env->isolate(), "StaticResponses"));
+  env->SetProtoMethod(responses, "set", StaticResponses::Set);
+  env->SetProtoMethod(responses, "delete", StaticResponses::Delete);
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "StaticResponses"),
+              responses->GetFunction(env->context()).ToLocalChecked()).Check();
 }
 
 }  // anonymous namespace
@@ -49,6 +49,8 @@
 #include "node_buffer.h"
 #include "node_errors.h"
 #include "node_internals.h"
+#include "string_bytes.h"
+#include "utf8.h"
 #include "util-inl.h"
 #include "v8.h"
 
@@ -210,12 +212,6 @@ class ConverterObject : public BaseObject, Converter {
     int flags = args[2]->Uint32Value(env->context()).ToChecked();
 
     UErrorCode status = U_ZERO_ERROR;
-    MaybeStackBuffer<UChar> result;
-    MaybeLocal<Object> ret;
-    size_t limit = ucnv_getMinCharSize(converter->conv) * input.length();
-    if (limit > 0)
-      result.AllocateSufficientStorage(limit);
-
     UBool flush = (flags & CONVERTER_FLAGS_FLUSH) == CONVERTER_FLAGS_FLUSH;
     auto cleanup = OnScopeLeave([&]() {
       if (flush) {
@@ -228,6 +224,40 @@ class ConverterObject : public BaseObject, Converter {
     const char* source = input.data();
     size_t source_length = input.length();
 
+    // Well-formed UTF-8 that does not continue a sequence from an earlier
+    // call decodes the same way with and without `fatal`, and can be turned
+    // into a string directly instead of going through ICU.
+    if (converter->utf8_ &&
+        ucnv_toUCountPending(converter->conv, &status) == 0 &&
+        utf8_validate(source, source_length)) {
+      if (source_length > 0 &&
+          !converter->ignoreBOM_ &&
+          !converter->bomSeen_) {
+        if (source_length >= 3 && memcmp(source, "\xef\xbb\xbf", 3) == 0) {
+          source += 3;
+          source_length -= 3;
+        }
+        converter->bomSeen_ = true;
+      }
+      Local<Value> error;
+      Local<Value> str;
+      if (!StringBytes::Encode(env->isolate(), source, source_length, UTF8,
+                               &error).ToLocal(&str)) {
+        CHECK(!error.IsEmpty());
+        env->isolate()->ThrowException(error);
+        return;
+      }
+      args.GetReturnValue().Set(str);
+      return;
+    }
+    status = U_ZERO_ERROR;
+
+    MaybeStackBuffer<UChar> result;
+    MaybeLocal<Object> ret;
+    size_t limit = ucnv_getMinCharSize(converter->conv) * input.length();
+    if (limit > 0)
+      result.AllocateSufficientStorage(limit);
+
     UChar* target = *result;
     ucnv_toUnicode(converter->conv,
                    &target, target + (limit * sizeof(UChar)),
@@ -286,6 +316,9 @@ class ConverterObject : public BaseObject, Converter {
 
     switch (ucnv_getType(converter)) {
       case UCNV_UTF8:
+        utf8_ = true;
+        unicode_ = true;
+        break;
       case UCNV_UTF16_BigEndian:
       case UCNV_UTF16_LittleEndian:
         unicode_ = true;
@@ -297,6 +330,7 @@ class ConverterObject : public BaseObject, Converter {
 
  private:
   bool unicode_ = false;     // True if this is a Unicode converter
+  bool utf8_ = false;        // True if this is the UTF-8 converter
   bool ignoreBOM_ = false;   // True if the BOM should be ignored on Unicode
   bool bomSeen_ = false;     // True if the BOM has been seen
 };
@@ -544,9 +578,41 @@ bool InitializeICUDirectory(const std::string& path) {
   return status == U_ZERO_ERROR;
 }
 
+// Returns whether `input` is ASCII and has no label that starts with "xn--".
+// UTS #46 processing without the STD3 rules only lower cases such names, so
+// they do not need to go through ICU.
+static bool IsPlainASCIIDomain(const char* input, size_t length) {
+  bool label_start = true;
+  for (size_t i = 0; i < length; i++) {
+    const unsigned char ch = input[i];
+    if (ch >= 0x80)
+      return false;
+    if (label_start && length - i >= 4 &&
+        ToLower(input[i]) == 'x' && ToLower(input[i + 1]) == 'n' &&
+        input[i + 2] == '-' && input[i + 3] == '-') {
+      return false;
+    }
+    label_start = ch == '.';
+  }
+  return true;
+}
+
+static int32_t ToLowerASCIIDomain(MaybeStackBuffer<char>* buf,
+                                  const char* input,
+                                  size_t length) {
+  buf->AllocateSufficientStorage(length);
+  for (size_t i = 0; i < length; i++)
+    (*buf)[i] = ToLower(input[i]);
+  buf->SetLength(length);
+  return static_cast<int32_t>(length);
+}
+
 int32_t ToUnicode(MaybeStackBuffer<char>* buf,
                   const char* input,
                   size_t length) {
+  if (IsPlainASCIIDomain(input, length))
+    return ToLowerASCIIDomain(buf, input, length);
+
   UErrorCode status = U_ZERO_ERROR;
   uint32_t options = UIDNA_NONTRANSITIONAL_TO_UNICODE;
   UIDNA* uidna = uidna_openUTS46(options, &status);
@@ -591,6 +657,11 @@ int32_t ToASCII(MaybeStackBuffer<char>* buf,
                 const char* input,
                 size_t length,
                 enum idna_mode mode) {
+  // In strict mode, the STD3 rules and the DNS length limits apply to ASCII
+  // names as well.
+  if (mode != IDNA_STRICT && IsPlainASCIIDomain(input, length))
+    return ToLowerASCIIDomain(buf, input, length);
+
   UErrorCode status = U_ZERO_ERROR;
   uint32_t options =                  // CheckHyphens = false; handled later
     UIDNA_CHECK_BIDI |                // CheckBidi = true
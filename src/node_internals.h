@@ -24,10 +24,12 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include "buffer_pool.h"
 #include "env.h"
 #include "node.h"
 #include "node_binding.h"
 #include "node_mutex.h"
+#include "node_perf_common.h"
 #include "tracing/trace_event.h"
 #include "util.h"
 #include "uv.h"
@@ -85,6 +87,10 @@ void GetSockOrPeerName(const v8::FunctionCallbackInfo<v8::Value>& args) {
   args.GetReturnValue().Set(err);
 }
 
+// setBusyPoll(microseconds) of TCP and UDP handles. Sets SO_BUSY_POLL on the
+// socket, so that reads busy poll the device queue when there is no data.
+void SetSocketBusyPoll(const v8::FunctionCallbackInfo<v8::Value>& args);
+
 void PrintStackTrace(v8::Isolate* isolate, v8::Local<v8::StackTrace> stack);
 void PrintCaughtException(v8::Isolate* isolate,
                           v8::Local<v8::Context> context,
@@ -104,8 +110,16 @@ namespace task_queue {
 void PromiseRejectCallback(v8::PromiseRejectMessage message);
 }  // namespace task_queue
 
+namespace wasm_web_api {
+// The callback of WebAssembly.compileStreaming(), which passes the source to
+// the JS implementation set by internalBinding('wasm_web_api').
+void StartStreamingCompilation(const v8::FunctionCallbackInfo<v8::Value>& info);
+}  // namespace wasm_web_api
+
 class NodeArrayBufferAllocator : public ArrayBufferAllocator {
  public:
+  NodeArrayBufferAllocator();
+
   inline uint32_t* zero_fill_field() { return &zero_fill_field_; }
 
   void* Allocate(size_t size) override;  // Defined in src/node.cc
@@ -123,10 +137,12 @@ class NodeArrayBufferAllocator : public ArrayBufferAllocator {
   inline uint64_t total_mem_usage() const {
     return total_mem_usage_.load(std::memory_order_relaxed);
   }
+  inline BufferPool::Stats buffer_pool_stats() { return pool_.GetStats(); }
 
  private:
   uint32_t zero_fill_field_ = 1;  // Boolean but exposed as uint32 to JS land.
   std::atomic<size_t> total_mem_usage_ {0};
+  BufferPool pool_;
 };
 
 class DebuggingArrayBufferAllocator final : public NodeArrayBufferAllocator {
@@ -202,7 +218,8 @@ v8::MaybeLocal<v8::Value> InternalMakeCallback(
     const v8::Local<v8::Function> callback,
     int argc,
     v8::Local<v8::Value> argv[],
-    async_context asyncContext);
+    async_context asyncContext,
+    int flags = 0);
 
 class InternalCallbackScope {
  public:
@@ -214,7 +231,12 @@ class InternalCallbackScope {
     // This should only be used when there is no call into JS in this scope.
     // (The HTTP parser also uses it for some weird backwards
     // compatibility issues, but it shouldn't.)
-    kSkipTaskQueues = 2
+    kSkipTaskQueues = 2,
+    // Indicates that with --experimental-batch-ticks, the nextTick and
+    // microtask queues may be processed once at the end of the poll phase
+    // rather than when this scope is closed. Scopes without it keep the
+    // ordering guarantee of each callback.
+    kBatchTaskQueues = 4
   };
   InternalCallbackScope(Environment* env,
                         v8::Local<v8::Object> object,
@@ -234,6 +256,7 @@ class InternalCallbackScope {
   v8::Local<v8::Object> object_;
   bool skip_hooks_;
   bool skip_task_queues_;
+  bool batch_task_queues_;
   bool failed_ = false;
   bool pushed_ids_ = false;
   bool closed_ = false;
@@ -253,9 +276,14 @@ class DebugSealHandleScope {
 #endif
 };
 
+// Work runs on the libuv thread pool for its `kind`, which only gets its own
+// threads when UV_THREADPOOL_SIZE_<POOL> is set. Otherwise, and for N-API
+// work, the default pool is used.
 class ThreadPoolWork {
  public:
-  explicit inline ThreadPoolWork(Environment* env) : env_(env) {
+  inline ThreadPoolWork(Environment* env,
+                        performance::ThreadPoolWorkKind kind)
+      : env_(env), kind_(kind) {
     CHECK_NOT_NULL(env);
   }
   inline virtual ~ThreadPoolWork() = default;
@@ -269,7 +297,14 @@ class ThreadPoolWork {
   Environment* env() const { return env_; }
 
  private:
+  static inline const char* PoolName(performance::ThreadPoolWorkKind kind);
+
   Environment* env_;
+  performance::ThreadPoolWorkKind kind_;
+  // Set by ScheduleWork() while perf_hooks.monitorThreadpool() is enabled.
+  uint64_t queued_at_ = 0;
+  uint64_t started_at_ = 0;
+  uint64_t finished_at_ = 0;
   uv_work_t work_req_;
 };
 
@@ -317,6 +352,12 @@ void TearDownOncePerProcess();
 void SetIsolateErrorHandlers(v8::Isolate* isolate, const IsolateSettings& s);
 void SetIsolateMiscHandlers(v8::Isolate* isolate, const IsolateSettings& s);
 void SetIsolateCreateParamsForNode(v8::Isolate::CreateParams* params);
+// Returns the memory that is available to the process, which is the smaller of
+// the physical memory and the cgroup memory limit, or 0 if it is unknown.
+uint64_t GetAvailableMemory();
+// Returns the number of CPUs that the process can use, taking its CPU affinity
+// and the CPU quota of its cgroup into account. Always at least 1.
+unsigned int GetAvailableParallelism();
 
 #if HAVE_INSPECTOR
 namespace profiler {
@@ -0,0 +1,250 @@
+#include "base_object-inl.h"
+#include "env-inl.h"
+#include "memory_tracker-inl.h"
+#include "node_buffer.h"
+#include "node_errors.h"
+#include "util-inl.h"
+
+#include <string>
+#include <vector>
+
+namespace node {
+namespace json_parser {
+
+using v8::Array;
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::Isolate;
+using v8::JSON;
+using v8::Local;
+using v8::NewStringType;
+using v8::Object;
+using v8::String;
+using v8::Value;
+
+namespace {
+
+// Splits a stream of JSON text into the values that are nested `depth`
+// containers deep, and parses each of them with JSON::Parse() as soon as it
+// is complete. Only the text of the value that is currently being read is
+// kept in memory. Object keys are skipped, so for objects at depth - 1 only
+// their member values are emitted.
+//
+// The text outside of the emitted values is only checked for balanced
+// brackets; JSON::Parse() validates the emitted values themselves.
+class JSONStreamParser : public BaseObject {
+ public:
+  JSONStreamParser(Environment* env, Local<Object> wrap, uint32_t depth)
+      : BaseObject(env, wrap), depth_(depth) {
+    MakeWeak();
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args);
+  static void Push(const FunctionCallbackInfo<Value>& args);
+  static void End(const FunctionCallbackInfo<Value>& args);
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackField("value", value_);
+    tracker->TrackField("containers", containers_);
+  }
+
+  SET_MEMORY_INFO_NAME(JSONStreamParser)
+  SET_SELF_SIZE(JSONStreamParser)
+
+ private:
+  // Returns false if an exception is pending.
+  bool Feed(const char* data, size_t length, std::vector<Local<Value>>* out);
+  bool Emit(std::vector<Local<Value>>* out);
+  void ThrowSyntaxError(const char* message);
+
+  const uint32_t depth_;
+  // The opening bracket of every container that has not been closed yet.
+  std::string containers_;
+  // The text of the value that is currently being read.
+  std::string value_;
+  bool in_value_ = false;
+  bool in_string_ = false;
+  bool in_escape_ = false;
+  bool in_scalar_ = false;
+  bool expect_key_ = false;
+  bool failed_ = false;
+};
+
+void JSONStreamParser::ThrowSyntaxError(const char* message) {
+  failed_ = true;
+  Isolate* isolate = env()->isolate();
+  isolate->ThrowException(
+      v8::Exception::SyntaxError(OneByteString(isolate, message)));
+}
+
+bool JSONStreamParser::Emit(std::vector<Local<Value>>* out) {
+  Isolate* isolate = env()->isolate();
+  in_value_ = false;
+  Local<String> text;
+  Local<Value> value;
+  if (!String::NewFromUtf8(isolate,
+                           value_.data(),
+                           NewStringType::kNormal,
+                           value_.size()).ToLocal(&text) ||
+      !JSON::Parse(env()->context(), text).ToLocal(&value)) {
+    failed_ = true;
+    return false;
+  }
+  value_.clear();
+  out->push_back(value);
+  return true;
+}
+
+bool JSONStreamParser::Feed(const char* data,
+                            size_t length,
+                            std::vector<Local<Value>>* out) {
+  // Characters that are read outside of emitted values are only appended to
+  // value_ while in_value_ is set.
+  for (size_t i = 0; i < length; i++) {
+    const char c = data[i];
+
+    if (in_string_) {
+      if (in_value_) value_ += c;
+      if (in_escape_) {
+        in_escape_ = false;
+      } else if (c == '\\') {
+        in_escape_ = true;
+      } else if (c == '"') {
+        in_string_ = false;
+        if (in_value_ && containers_.size() == depth_ && !Emit(out))
+          return false;
+      }
+      continue;
+    }
+
+    if (in_scalar_) {
+      if (c != ' ' && c != '\t' && c != '\n' && c != '\r' && c != ',' &&
+          c != ']' && c != '}' && c != ':') {
+        if (in_value_) value_ += c;
+        continue;
+      }
+      in_scalar_ = false;
+      if (in_value_ && containers_.size() == depth_ && !Emit(out))
+        return false;
+    }
+
+    const bool starts_value = !in_value_ && containers_.size() == depth_;
+    switch (c) {
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r':
+        if (in_value_) value_ += c;
+        break;
+      case '"':
+        if (starts_value && !expect_key_) in_value_ = true;
+        if (in_value_) value_ += c;
+        in_string_ = true;
+        break;
+      case '{':
+      case '[':
+        if (starts_value) in_value_ = true;
+        if (in_value_) value_ += c;
+        containers_ += c;
+        expect_key_ = c == '{';
+        break;
+      case '}':
+      case ']':
+        if (containers_.empty() ||
+            containers_.back() != (c == '}' ? '{' : '[')) {
+          ThrowSyntaxError("Unexpected token in JSON");
+          return false;
+        }
+        containers_.pop_back();
+        expect_key_ = false;
+        if (in_value_) {
+          value_ += c;
+          if (containers_.size() == depth_ && !Emit(out))
+            return false;
+        }
+        break;
+      case ',':
+        if (in_value_) value_ += c;
+        expect_key_ = !containers_.empty() && containers_.back() == '{';
+        break;
+      case ':':
+        if (in_value_) value_ += c;
+        expect_key_ = false;
+        break;
+      default:
+        if (starts_value) in_value_ = true;
+        if (in_value_) value_ += c;
+        in_scalar_ = true;
+    }
+  }
+  return true;
+}
+
+void JSONStreamParser::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsUint32());
+  new JSONStreamParser(env, args.This(), args[0].As<v8::Uint32>()->Value());
+}
+
+// Reads a chunk of JSON text and returns the values that it completed.
+void JSONStreamParser::Push(const FunctionCallbackInfo<Value>& args) {
+  JSONStreamParser* parser;
+  ASSIGN_OR_RETURN_UNWRAP(&parser, args.Holder());
+  CHECK(!parser->failed_);
+  CHECK(args[0]->IsArrayBufferView());
+
+  ArrayBufferViewContents<char> chunk(args[0]);
+  std::vector<Local<Value>> values;
+  if (!parser->Feed(chunk.data(), chunk.length(), &values))
+    return;
+  args.GetReturnValue().Set(
+      Array::New(parser->env()->isolate(), values.data(), values.size()));
+}
+
+// Returns the last value if it is a number, true, false, or null at the top
+// level, which only ends with the input. Throws if the input ended inside a
+// value.
+void JSONStreamParser::End(const FunctionCallbackInfo<Value>& args) {
+  JSONStreamParser* parser;
+  ASSIGN_OR_RETURN_UNWRAP(&parser, args.Holder());
+  CHECK(!parser->failed_);
+
+  std::vector<Local<Value>> values;
+  if (parser->in_scalar_) {
+    parser->in_scalar_ = false;
+    if (parser->in_value_ && !parser->Emit(&values))
+      return;
+  }
+  if (parser->in_string_ || !parser->containers_.empty()) {
+    return parser->ThrowSyntaxError("Unexpected end of JSON input");
+  }
+  args.GetReturnValue().Set(
+      Array::New(parser->env()->isolate(), values.data(), values.size()));
+}
+
+void Initialize(Local<Object> target,
+                Local<Value> unused,
+                Local<Context> context,
+                void* priv) {
+  Environment* env = Environment::GetCurrent(context);
+
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(JSONStreamParser::New);
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(t, "push", JSONStreamParser::Push);
+  env->SetProtoMethod(t, "end", JSONStreamParser::End);
+
+  Local<String> parser_string =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "JSONStreamParser");
+  t->SetClassName(parser_string);
+  target->Set(context,
+              parser_string,
+              t->GetFunction(context).ToLocalChecked()).Check();
+}
+
+}  // anonymous namespace
+}  // namespace json_parser
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_INTERNAL(json_parser, node::json_parser::Initialize)
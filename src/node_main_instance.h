@@ -69,6 +69,9 @@ class NodeMainInstance {
   static v8::StartupData* GetEmbeddedSnapshotBlob();
 
   static const size_t kNodeContextIndex = 0;
+  // A context that only ran the per-context scripts, which the vm module
+  // uses for contexts without a sandbox object.
+  static const size_t kVmContextIndex = 1;
   NodeMainInstance(const NodeMainInstance&) = delete;
   NodeMainInstance& operator=(const NodeMainInstance&) = delete;
   NodeMainInstance(NodeMainInstance&&) = delete;
@@ -20,11 +20,64 @@ AllocatorStruct NgLibMemoryManager<Class, AllocatorStruct>::MakeAllocator() {
   };
 }
 
+template <typename Class, typename T>
+NgLibMemoryManager<Class, T>::~NgLibMemoryManager() {
+  for (size_t i = 0; i < kPoolSizeClasses; i++) {
+    for (size_t j = 0; j < free_block_count_[i]; j++)
+      free(free_blocks_[i][j]);
+  }
+}
+
+template <typename Class, typename T>
+size_t NgLibMemoryManager<Class, T>::PooledMemory() const {
+  size_t total = 0;
+  for (size_t i = 0; i < kPoolSizeClasses; i++)
+    total += free_block_count_[i] * (kPoolMinBlockSize << i);
+  return total;
+}
+
+template <typename Class, typename T>
+int NgLibMemoryManager<Class, T>::PoolSizeClass(size_t size) {
+  size_t block_size = kPoolMinBlockSize;
+  for (size_t i = 0; i < kPoolSizeClasses; i++, block_size <<= 1) {
+    if (size <= block_size)
+      return static_cast<int>(i);
+  }
+  return -1;
+}
+
+template <typename Class, typename T>
+char* NgLibMemoryManager<Class, T>::AllocateBlock(size_t* size) {
+  const int size_class = *size > 0 ? PoolSizeClass(*size) : -1;
+  if (size_class == -1)
+    return UncheckedRealloc<char>(nullptr, *size);
+  *size = kPoolMinBlockSize << size_class;
+  if (free_block_count_[size_class] > 0)
+    return free_blocks_[size_class][--free_block_count_[size_class]];
+  return UncheckedMalloc<char>(*size);
+}
+
+template <typename Class, typename T>
+bool NgLibMemoryManager<Class, T>::ReleaseBlock(char* block, size_t size) {
+  // Blocks that were resized with realloc() may have a size that is not one
+  // of the size classes, and are not kept then. Blocks that do have such a
+  // size are at least that large, no matter how they were allocated.
+  const int size_class = PoolSizeClass(size);
+  if (size_class == -1 ||
+      size != kPoolMinBlockSize << size_class ||
+      free_block_count_[size_class] == kPoolDepth) {
+    return false;
+  }
+  free_blocks_[size_class][free_block_count_[size_class]++] = block;
+  return true;
+}
+
 template <typename Class, typename T>
 void* NgLibMemoryManager<Class, T>::ReallocImpl(void* ptr,
                                              size_t size,
                                              void* user_data) {
   Class* manager = static_cast<Class*>(user_data);
+  NgLibMemoryManager* pool = manager;
 
   size_t previous_size = 0;
   char* original_ptr = nullptr;
@@ -49,7 +102,15 @@ void* NgLibMemoryManager<Class, T>::ReallocImpl(void* ptr,
 
   manager->CheckAllocatedSize(previous_size);
 
-  char* mem = UncheckedRealloc(original_ptr, size);
+  char* mem;
+  if (original_ptr == nullptr) {
+    // This may round up `size`, which is then also what is accounted for.
+    mem = pool->AllocateBlock(&size);
+  } else if (size == 0 && pool->ReleaseBlock(original_ptr, previous_size)) {
+    mem = nullptr;
+  } else {
+    mem = UncheckedRealloc(original_ptr, size);
+  }
 
   if (mem != nullptr) {
     // Adjust the memory info counter.
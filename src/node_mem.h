@@ -4,6 +4,7 @@
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
 #include <cstddef>
+#include <cstdint>
 
 namespace node {
 namespace mem {
@@ -26,7 +27,33 @@ class NgLibMemoryManager {
 
   void StopTrackingMemory(void* ptr);
 
+  // The number of bytes in freed blocks that are kept for re-use.
+  size_t PooledMemory() const;
+
+  ~NgLibMemoryManager();
+
  private:
+  // Small allocations are rounded up to one of a few size classes, and freed
+  // blocks of those sizes are kept in a free list of limited depth, so that
+  // libraries that allocate and free many small objects per frame or per
+  // header do not hit the system allocator for each of them. Every block is
+  // still allocated with malloc() on its own, so it can also be realloc()ed
+  // or free()d directly.
+  static constexpr size_t kPoolMinBlockSize = 32;
+  static constexpr size_t kPoolSizeClasses = 6;  // 32 to 1024 bytes.
+  static constexpr size_t kPoolDepth = 16;
+
+  // Returns the index of the smallest size class that fits `size`, or -1.
+  static inline int PoolSizeClass(size_t size);
+  // Allocates a block of at least `*size` bytes, and sets `*size` to the
+  // actual size of the block.
+  inline char* AllocateBlock(size_t* size);
+  // Takes over a block of `size` bytes, and returns whether it was kept.
+  inline bool ReleaseBlock(char* block, size_t size);
+
+  char* free_blocks_[kPoolSizeClasses][kPoolDepth];
+  uint8_t free_block_count_[kPoolSizeClasses] = {};
+
   static void* ReallocImpl(void* ptr, size_t size, void* user_data);
   static void* MallocImpl(size_t size, void* user_data);
   static void FreeImpl(void* ptr, void* user_data);
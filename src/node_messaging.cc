@@ -6,9 +6,16 @@
 #include "node_contextify.h"
 #include "node_buffer.h"
 #include "node_errors.h"
+#include "node_file.h"
+#include "node_perf.h"
 #include "node_process.h"
+#include "stream_wrap.h"
 #include "util-inl.h"
 
+#ifdef __POSIX__
+#include <unistd.h>  // dup()
+#endif
+
 using node::contextify::ContextifyContext;
 using v8::Array;
 using v8::ArrayBuffer;
@@ -17,21 +24,30 @@ using v8::CompiledWasmModule;
 using v8::Context;
 using v8::EscapableHandleScope;
 using v8::Exception;
+using v8::False;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::Global;
 using v8::HandleScope;
+using v8::Int32;
+using v8::Integer;
 using v8::Isolate;
 using v8::Just;
 using v8::Local;
 using v8::Maybe;
 using v8::MaybeLocal;
+using v8::NewStringType;
 using v8::Nothing;
+using v8::Null;
+using v8::Number;
 using v8::Object;
 using v8::SharedArrayBuffer;
 using v8::String;
 using v8::Symbol;
+using v8::True;
+using v8::Uint32;
+using v8::Undefined;
 using v8::Value;
 using v8::ValueDeserializer;
 using v8::ValueSerializer;
@@ -40,6 +56,30 @@ using v8::WasmModuleObject;
 namespace node {
 namespace worker {
 
+TransferredHandle::~TransferredHandle() {
+  if (fd_ < 0) return;
+  uv_fs_t req;
+  uv_fs_close(nullptr, &req, fd_, nullptr);
+  uv_fs_req_cleanup(&req);
+}
+
+TransferredHandle::TransferredHandle(TransferredHandle&& other)
+    : type_(other.type_), fd_(other.Release()) {}
+
+TransferredHandle& TransferredHandle::operator=(TransferredHandle&& other) {
+  if (this == &other) return *this;
+  this->~TransferredHandle();
+  type_ = other.type_;
+  fd_ = other.Release();
+  return *this;
+}
+
+int TransferredHandle::Release() {
+  int fd = fd_;
+  fd_ = -1;
+  return fd;
+}
+
 Message::Message(MallocedBuffer<char>&& buffer)
     : main_message_buf_(std::move(buffer)) {}
 
@@ -49,6 +89,140 @@ bool Message::IsCloseMessage() const {
 
 namespace {
 
+// Primitive values without a transfer list are encoded without going through
+// v8::ValueSerializer, which saves setting up a serializer and deserializer
+// pair for what is often the most common kind of message. The first byte of
+// such a message is one of the tags below, followed by the value starting at
+// kPrimitiveHeaderSize so that it is suitably aligned. Messages written by
+// v8::ValueSerializer always start with its version tag, 0xFF.
+enum PrimitiveTag : uint8_t {
+  kUndefinedTag,
+  kNullTag,
+  kTrueTag,
+  kFalseTag,
+  kInt32Tag,
+  kDoubleTag,
+  kOneByteStringTag,
+  kTwoByteStringTag,
+};
+
+constexpr size_t kPrimitiveHeaderSize = 8;
+
+bool IsPrimitiveMessage(const MallocedBuffer<char>& buffer) {
+  return buffer.size >= kPrimitiveHeaderSize &&
+         static_cast<uint8_t>(buffer.data[0]) <= kTwoByteStringTag;
+}
+
+bool CanSerializeAsPrimitive(Local<Value> value) {
+  return value->IsString() || value->IsNumber() || value->IsBoolean() ||
+         value->IsNullOrUndefined();
+}
+
+MallocedBuffer<char> SerializePrimitive(Isolate* isolate, Local<Value> value) {
+  PrimitiveTag tag;
+  size_t payload_size = 0;
+  if (value->IsString()) {
+    Local<String> string = value.As<String>();
+    if (string->IsOneByte()) {
+      tag = kOneByteStringTag;
+      payload_size = string->Length();
+    } else {
+      tag = kTwoByteStringTag;
+      payload_size = string->Length() * sizeof(uint16_t);
+    }
+  } else if (value->IsInt32()) {
+    tag = kInt32Tag;
+    payload_size = sizeof(int32_t);
+  } else if (value->IsNumber()) {
+    tag = kDoubleTag;
+    payload_size = sizeof(double);
+  } else if (value->IsBoolean()) {
+    tag = value->IsTrue() ? kTrueTag : kFalseTag;
+  } else {
+    tag = value->IsNull() ? kNullTag : kUndefinedTag;
+  }
+
+  MallocedBuffer<char> buffer(kPrimitiveHeaderSize + payload_size);
+  memset(buffer.data, 0, kPrimitiveHeaderSize);
+  buffer.data[0] = tag;
+  char* payload = buffer.data + kPrimitiveHeaderSize;
+  switch (tag) {
+    case kOneByteStringTag:
+      value.As<String>()->WriteOneByte(
+          isolate, reinterpret_cast<uint8_t*>(payload), 0, -1,
+          String::NO_NULL_TERMINATION);
+      break;
+    case kTwoByteStringTag:
+      value.As<String>()->Write(
+          isolate, reinterpret_cast<uint16_t*>(payload), 0, -1,
+          String::NO_NULL_TERMINATION);
+      break;
+    case kInt32Tag: {
+      int32_t number = value.As<Int32>()->Value();
+      memcpy(payload, &number, sizeof(number));
+      break;
+    }
+    case kDoubleTag: {
+      double number = value.As<Number>()->Value();
+      memcpy(payload, &number, sizeof(number));
+      break;
+    }
+    default:
+      break;
+  }
+  return buffer;
+}
+
+MaybeLocal<Value> DeserializePrimitive(Isolate* isolate,
+                                       const MallocedBuffer<char>& buffer) {
+  const char* payload = buffer.data + kPrimitiveHeaderSize;
+  const size_t payload_size = buffer.size - kPrimitiveHeaderSize;
+  switch (static_cast<uint8_t>(buffer.data[0])) {
+    case kUndefinedTag:
+      return Undefined(isolate);
+    case kNullTag:
+      return Null(isolate);
+    case kTrueTag:
+      return True(isolate);
+    case kFalseTag:
+      return False(isolate);
+    case kInt32Tag: {
+      int32_t number;
+      memcpy(&number, payload, sizeof(number));
+      return Integer::New(isolate, number);
+    }
+    case kDoubleTag: {
+      double number;
+      memcpy(&number, payload, sizeof(number));
+      return Number::New(isolate, number);
+    }
+  }
+
+  MaybeLocal<String> string;
+  if (buffer.data[0] == kOneByteStringTag) {
+    string = String::NewFromOneByte(isolate,
+                                    reinterpret_cast<const uint8_t*>(payload),
+                                    NewStringType::kNormal,
+                                    payload_size);
+  } else {
+    CHECK_EQ(buffer.data[0], kTwoByteStringTag);
+    string = String::NewFromTwoByte(isolate,
+                                    reinterpret_cast<const uint16_t*>(payload),
+                                    NewStringType::kNormal,
+                                    payload_size / sizeof(uint16_t));
+  }
+  return string.FromMaybe(Local<String>());
+}
+
+// Host objects are written as one of these tags, followed by their index in
+// the message's list of transferred objects of that kind. Histograms are
+// cloned, and written as a tag followed by their data instead.
+enum HostObjectTag : uint32_t {
+  kMessagePortTag,
+  kHandleTag,
+  kHistogramTag
+};
+
 // This is used to tell V8 how to read transferred host objects, like other
 // `MessagePort`s and `SharedArrayBuffer`s, and make new JS objects out of them.
 class DeserializerDelegate : public ValueDeserializer::Delegate {
@@ -57,18 +231,29 @@ class DeserializerDelegate : public ValueDeserializer::Delegate {
       Message* m,
       Environment* env,
       const std::vector<MessagePort*>& message_ports,
+      const std::vector<Local<Object>>& handles,
       const std::vector<Local<SharedArrayBuffer>>& shared_array_buffers,
       const std::vector<CompiledWasmModule>& wasm_modules)
-      : message_ports_(message_ports),
+      : env_(env),
+        message_ports_(message_ports),
+        handles_(handles),
         shared_array_buffers_(shared_array_buffers),
         wasm_modules_(wasm_modules) {}
 
   MaybeLocal<Object> ReadHostObject(Isolate* isolate) override {
-    // Currently, only MessagePort hosts objects are supported, so identifying
-    // by the index in the message's MessagePort array is sufficient.
+    uint32_t tag;
     uint32_t id;
+    if (!deserializer->ReadUint32(&tag))
+      return MaybeLocal<Object>();
+    if (tag == kHistogramTag)
+      return performance::RecordableHistogram::Deserialize(env_, deserializer);
     if (!deserializer->ReadUint32(&id))
       return MaybeLocal<Object>();
+    if (tag == kHandleTag) {
+      CHECK_LT(id, handles_.size());
+      return handles_[id];
+    }
+    CHECK_EQ(tag, kMessagePortTag);
     CHECK_LE(id, message_ports_.size());
     return message_ports_[id]->object(isolate);
   }
@@ -89,7 +274,9 @@ class DeserializerDelegate : public ValueDeserializer::Delegate {
   ValueDeserializer* deserializer = nullptr;
 
  private:
+  Environment* env_;
   const std::vector<MessagePort*>& message_ports_;
+  const std::vector<Local<Object>>& handles_;
   const std::vector<Local<SharedArrayBuffer>>& shared_array_buffers_;
   const std::vector<CompiledWasmModule>& wasm_modules_;
 };
@@ -103,6 +290,11 @@ MaybeLocal<Value> Message::Deserialize(Environment* env,
   EscapableHandleScope handle_scope(env->isolate());
   Context::Scope context_scope(context);
 
+  if (IsPrimitiveMessage(main_message_buf_)) {
+    return handle_scope.EscapeMaybe(
+        DeserializePrimitive(env->isolate(), main_message_buf_));
+  }
+
   // Create all necessary MessagePort handles.
   std::vector<MessagePort*> ports(message_ports_.size());
   for (uint32_t i = 0; i < message_ports_.size(); ++i) {
@@ -120,6 +312,33 @@ MaybeLocal<Value> Message::Deserialize(Environment* env,
   }
   message_ports_.clear();
 
+  // Let JS code wrap the transferred file descriptors in handles that are
+  // registered with this thread's event loop.
+  std::vector<Local<Object>> handles;
+  if (!handles_.empty()) {
+    Local<Function> wrap_handle = env->wrap_transferred_handle_function();
+    if (wrap_handle.IsEmpty()) {
+      THROW_ERR_INVALID_TRANSFER_OBJECT(
+          env, "Handles cannot be received in this context");
+      return MaybeLocal<Value>();
+    }
+    for (TransferredHandle& handle : handles_) {
+      Local<Value> argv[] = {
+        Integer::NewFromUnsigned(env->isolate(), handle.type()),
+        Integer::New(env->isolate(), handle.fd())
+      };
+      Local<Value> object;
+      if (!wrap_handle->Call(context, Undefined(env->isolate()),
+                             arraysize(argv), argv).ToLocal(&object)) {
+        return MaybeLocal<Value>();
+      }
+      CHECK(object->IsObject());
+      handle.Release();
+      handles.push_back(object.As<Object>());
+    }
+    handles_.clear();
+  }
+
   std::vector<Local<SharedArrayBuffer>> shared_array_buffers;
   // Attach all transferred SharedArrayBuffers to their new Isolate.
   for (uint32_t i = 0; i < shared_array_buffers_.size(); ++i) {
@@ -131,7 +350,7 @@ MaybeLocal<Value> Message::Deserialize(Environment* env,
   shared_array_buffers_.clear();
 
   DeserializerDelegate delegate(
-      this, env, ports, shared_array_buffers, wasm_modules_);
+      this, env, ports, handles, shared_array_buffers, wasm_modules_);
   ValueDeserializer deserializer(
       env->isolate(),
       reinterpret_cast<const uint8_t*>(main_message_buf_.data),
@@ -167,6 +386,10 @@ uint32_t Message::AddWASMModule(CompiledWasmModule&& mod) {
   return wasm_modules_.size() - 1;
 }
 
+void Message::AddHandle(TransferredHandle&& handle) {
+  handles_.emplace_back(std::move(handle));
+}
+
 namespace {
 
 MaybeLocal<Function> GetEmitMessageFunction(Local<Context> context) {
@@ -212,6 +435,27 @@ void ThrowDataCloneException(Local<Context> context, Local<String> message) {
   isolate->ThrowException(exception);
 }
 
+// Returns the kind of handle that `value` is, if it is a FileHandle or a TCP
+// or Pipe handle, all of which can be transferred to other threads.
+Maybe<TransferredHandle::Type> GetTransferredHandleType(Environment* env,
+                                                       Local<Value> value) {
+  if (!value->IsObject())
+    return Nothing<TransferredHandle::Type>();
+  if (!env->fd_constructor_template().IsEmpty() &&
+      env->fd_constructor_template()->HasInstance(value)) {
+    return Just(TransferredHandle::kFileHandle);
+  }
+  if (!env->tcp_constructor_template().IsEmpty() &&
+      env->tcp_constructor_template()->HasInstance(value)) {
+    return Just(TransferredHandle::kTCP);
+  }
+  if (!env->pipe_constructor_template().IsEmpty() &&
+      env->pipe_constructor_template()->HasInstance(value)) {
+    return Just(TransferredHandle::kPipe);
+  }
+  return Nothing<TransferredHandle::Type>();
+}
+
 // This tells V8 how to serialize objects that it does not understand
 // (e.g. C++ objects) into the output buffer, in a way that our own
 // DeserializerDelegate understands how to unpack.
@@ -229,6 +473,24 @@ class SerializerDelegate : public ValueSerializer::Delegate {
       return WriteMessagePort(Unwrap<MessagePort>(object));
     }
 
+    Local<FunctionTemplate> histogram_template =
+        env_->recordable_histogram_constructor_template();
+    if (!histogram_template.IsEmpty() &&
+        histogram_template->HasInstance(object)) {
+      serializer->WriteUint32(kHistogramTag);
+      Unwrap<performance::RecordableHistogram>(object)->Serialize(serializer);
+      return Just(true);
+    }
+
+    BaseObject* handle = Unwrap<BaseObject>(object);
+    for (uint32_t i = 0; i < handles_.size(); i++) {
+      if (handles_[i].object == handle) {
+        serializer->WriteUint32(kHandleTag);
+        serializer->WriteUint32(i);
+        return Just(true);
+      }
+    }
+
     ThrowDataCloneError(env_->clone_unsupported_type_str());
     return Nothing<bool>();
   }
@@ -255,6 +517,63 @@ class SerializerDelegate : public ValueSerializer::Delegate {
     return Just(msg_->AddWASMModule(module->GetCompiledModule()));
   }
 
+  // Record a FileHandle, TCP or Pipe handle from the transfer list.
+  // Stream handles are closed once the message has been serialized, so their
+  // file descriptor is duplicated here already, where failing is still fine.
+  Maybe<bool> AddHandle(Local<Object> object, TransferredHandle::Type type) {
+    BaseObject* handle = Unwrap<BaseObject>(object);
+    for (const HandleToTransfer& entry : handles_) {
+      if (entry.object == handle) {
+        ThrowDataCloneException(
+            context_,
+            FIXED_ONE_BYTE_STRING(env_->isolate(),
+                                  "Transfer list contains duplicate handle"));
+        return Nothing<bool>();
+      }
+    }
+
+    if (type == TransferredHandle::kFileHandle) {
+      fs::FileHandle* file_handle = static_cast<fs::FileHandle*>(handle);
+      if (file_handle == nullptr || !file_handle->IsAlive() ||
+          file_handle->IsClosing()) {
+        ThrowDataCloneException(
+            context_,
+            FIXED_ONE_BYTE_STRING(env_->isolate(),
+                                  "FileHandle in transfer list is closed"));
+        return Nothing<bool>();
+      }
+      handles_.push_back({ handle, TransferredHandle(type, -1) });
+      return Just(true);
+    }
+
+#ifdef _WIN32
+    ThrowDataCloneException(
+        context_,
+        FIXED_ONE_BYTE_STRING(
+            env_->isolate(),
+            "Sockets and pipes cannot be transferred on this platform"));
+    return Nothing<bool>();
+#else
+    LibuvStreamWrap* wrap = static_cast<LibuvStreamWrap*>(handle);
+    uv_os_fd_t fd;
+    if (wrap == nullptr || !wrap->IsAlive() || wrap->IsClosing() ||
+        uv_fileno(reinterpret_cast<uv_handle_t*>(wrap->stream()), &fd) != 0) {
+      ThrowDataCloneException(
+          context_,
+          FIXED_ONE_BYTE_STRING(env_->isolate(),
+                                "Handle in transfer list is not open"));
+      return Nothing<bool>();
+    }
+    int dup_fd = dup(fd);
+    if (dup_fd < 0) {
+      env_->ThrowErrnoException(errno, "dup");
+      return Nothing<bool>();
+    }
+    handles_.push_back({ handle, TransferredHandle(type, dup_fd) });
+    return Just(true);
+#endif  // _WIN32
+  }
+
   void Finish() {
     // Only close the MessagePort handles and actually transfer them
     // once we know that serialization succeeded.
@@ -262,14 +581,32 @@ class SerializerDelegate : public ValueSerializer::Delegate {
       port->Close();
       msg_->AddMessagePort(port->Detach());
     }
+    // The same goes for the handles, which give up their file descriptors.
+    for (HandleToTransfer& entry : handles_) {
+      if (entry.handle.type() == TransferredHandle::kFileHandle) {
+        fs::FileHandle* file_handle =
+            static_cast<fs::FileHandle*>(entry.object);
+        msg_->AddHandle(TransferredHandle(TransferredHandle::kFileHandle,
+                                          file_handle->Release()));
+      } else {
+        static_cast<LibuvStreamWrap*>(entry.object)->Close();
+        msg_->AddHandle(std::move(entry.handle));
+      }
+    }
   }
 
   ValueSerializer* serializer = nullptr;
 
  private:
+  struct HandleToTransfer {
+    BaseObject* object;
+    TransferredHandle handle;
+  };
+
   Maybe<bool> WriteMessagePort(MessagePort* port) {
     for (uint32_t i = 0; i < ports_.size(); i++) {
       if (ports_[i] == port) {
+        serializer->WriteUint32(kMessagePortTag);
         serializer->WriteUint32(i);
         return Just(true);
       }
@@ -284,6 +621,7 @@ class SerializerDelegate : public ValueSerializer::Delegate {
   Message* msg_;
   std::vector<Global<SharedArrayBuffer>> seen_shared_array_buffers_;
   std::vector<MessagePort*> ports_;
+  std::vector<HandleToTransfer> handles_;
 
   friend class worker::Message;
 };
@@ -301,14 +639,21 @@ Maybe<bool> Message::Serialize(Environment* env,
   // Verify that we're not silently overwriting an existing message.
   CHECK(main_message_buf_.is_empty());
 
+  if (transfer_list_v.length() == 0 && CanSerializeAsPrimitive(input)) {
+    main_message_buf_ = SerializePrimitive(env->isolate(), input);
+    return Just(true);
+  }
+
   SerializerDelegate delegate(env, context, this);
   ValueSerializer serializer(env->isolate(), &delegate);
   delegate.serializer = &serializer;
 
   std::vector<Local<ArrayBuffer>> array_buffers;
+  TransferredHandle::Type handle_type;
   for (uint32_t i = 0; i < transfer_list_v.length(); ++i) {
     Local<Value> entry = transfer_list_v[i];
-    // Currently, we support ArrayBuffers and MessagePorts.
+    // Currently, we support ArrayBuffers, MessagePorts, FileHandles and
+    // TCP and Pipe handles.
     if (entry->IsArrayBuffer()) {
       Local<ArrayBuffer> ab = entry.As<ArrayBuffer>();
       // If we cannot render the ArrayBuffer unusable in this Isolate,
@@ -375,6 +720,10 @@ Maybe<bool> Message::Serialize(Environment* env,
       }
       delegate.ports_.push_back(port);
       continue;
+    } else if (GetTransferredHandleType(env, entry).To(&handle_type)) {
+      if (delegate.AddHandle(entry.As<Object>(), handle_type).IsNothing())
+        return Nothing<bool>();
+      continue;
     }
 
     THROW_ERR_INVALID_TRANSFER_OBJECT(env);
@@ -413,6 +762,36 @@ void Message::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("message_ports", message_ports_);
 }
 
+constexpr size_t MessageQueue::kInitialCapacity;
+
+void MessageQueue::push_back(Message&& message) {
+  if (size_ == slots_.size()) {
+    std::vector<Message> slots(std::max(kInitialCapacity, 2 * size_));
+    for (size_t i = 0; i < size_; i++)
+      slots[i] = std::move(slots_[(head_ + i) & (slots_.size() - 1)]);
+    slots_ = std::move(slots);
+    head_ = 0;
+  }
+  slots_[(head_ + size_) & (slots_.size() - 1)] = std::move(message);
+  size_++;
+}
+
+void MessageQueue::pop_front() {
+  CHECK(!empty());
+  // Release the payload of the message right away.
+  slots_[head_] = Message();
+  head_ = (head_ + 1) & (slots_.size() - 1);
+  if (--size_ == 0) {
+    head_ = 0;
+    if (slots_.size() > kMaxRetainedCapacity)
+      slots_ = std::vector<Message>();
+  }
+}
+
+void MessageQueue::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackField("slots", slots_);
+}
+
 MessagePortData::MessagePortData(MessagePort* owner) : owner_(owner) { }
 
 MessagePortData::~MessagePortData() {
@@ -428,10 +807,13 @@ void MessagePortData::MemoryInfo(MemoryTracker* tracker) const {
 void MessagePortData::AddToIncomingQueue(Message&& message) {
   // This function will be called by other threads.
   Mutex::ScopedLock lock(mutex_);
-  incoming_messages_.emplace_back(std::move(message));
+  incoming_messages_.push_back(std::move(message));
 
-  if (owner_ != nullptr) {
+  // If the owner has been notified already, it will pick this message up
+  // before it stops processing the queue.
+  if (owner_ != nullptr && !wakeup_pending_) {
     Debug(owner_, "Adding message to incoming queue");
+    wakeup_pending_ = true;
     owner_->TriggerAsync();
   }
 }
@@ -571,6 +953,7 @@ MessagePort* MessagePort::New(
     port->data_->owner_ = port;
     // If the existing MessagePortData object had pending messages, this is
     // the easiest way to run that queue.
+    port->data_->wakeup_pending_ = true;
     port->TriggerAsync();
   }
   return port;
@@ -610,6 +993,19 @@ MaybeLocal<Value> MessagePort::ReceiveMessage(Local<Context> context,
   return received.Deserialize(env(), context);
 }
 
+bool MessagePort::ClearWakeupPending() {
+  // Messages that have been added since the queue was last checked did not
+  // trigger the uv_async_t, so they need to be looked at again, unless they
+  // would not be received anyway.
+  MessageQueue* queue = &data_->incoming_messages_;
+  if (!queue->empty() && env()->can_call_into_js() &&
+      (receiving_messages_ || queue->front().IsCloseMessage())) {
+    return true;
+  }
+  data_->wakeup_pending_ = false;
+  return false;
+}
+
 void MessagePort::OnMessage() {
   Debug(this, "Running MessagePort::OnMessage()");
   HandleScope handle_scope(env()->isolate());
@@ -622,6 +1018,16 @@ void MessagePort::OnMessage() {
                                 static_cast<size_t>(1000));
   }
 
+  // Every exit from the loop below that does not reschedule OnMessage() lets
+  // senders trigger the uv_async_t again.
+  bool rescheduled = false;
+  auto clear_wakeup = OnScopeLeave([&]() {
+    if (rescheduled || !data_) return;
+    Mutex::ScopedLock lock(data_->mutex_);
+    if (ClearWakeupPending())
+      TriggerAsync();
+  });
+
   // data_ can only ever be modified by the owner thread, so no need to lock.
   // However, the message port may be transferred while it is processing
   // messages, so we need to check that this handle still owns its `data_` field
@@ -635,6 +1041,7 @@ void MessagePort::OnMessage() {
       // noticable, at least on Windows.
       // (That might require more investigation by somebody more familiar with
       // Windows.)
+      rescheduled = true;
       TriggerAsync();
       return;
     }
@@ -653,12 +1060,42 @@ void MessagePort::OnMessage() {
     }
 
     Local<Function> emit_message = PersistentToLocal::Strong(emit_message_fn_);
+    bool receive_failed = false;
+    if (batch_limit_ > 0) {
+      // Deserialize as many of the queued messages as the limits allow and
+      // pass them to JS as one array.
+      std::vector<Local<Value>> batch { payload };
+      while (data_ && batch.size() < batch_limit_ && processing_limit > 0) {
+        if (!ReceiveMessage(context, true).ToLocal(&payload)) {
+          // Deliver the messages that have already been dequeued, and leave
+          // the rest queued, like a failure outside of a batch does.
+          receive_failed = true;
+          break;
+        }
+        if (payload == env()->no_message_symbol()) break;
+        batch.push_back(payload);
+        processing_limit--;
+      }
+      payload = Array::New(env()->isolate(), batch.data(), batch.size());
+
+      Local<Value> emit_messages;
+      if (!object()->Get(context, env()->onmessages_symbol())
+              .ToLocal(&emit_messages)) {
+        return;
+      }
+      CHECK(emit_messages->IsFunction());
+      emit_message = emit_messages.As<Function>();
+    }
+
     if (MakeCallback(emit_message, 1, &payload).IsEmpty()) {
       // Re-schedule OnMessage() execution in case of failure.
-      if (data_)
+      if (data_) {
+        rescheduled = true;
         TriggerAsync();
+      }
       return;
     }
+    if (receive_failed) break;
   }
 }
 
@@ -675,6 +1112,8 @@ std::unique_ptr<MessagePortData> MessagePort::Detach() {
   CHECK(data_);
   Mutex::ScopedLock lock(data_->mutex_);
   data_->owner_ = nullptr;
+  // The next owner notifies itself of pending messages.
+  data_->wakeup_pending_ = false;
   return std::move(data_);
 }
 
@@ -833,8 +1272,10 @@ void MessagePort::Start() {
   Debug(this, "Start receiving messages");
   receiving_messages_ = true;
   Mutex::ScopedLock lock(data_->mutex_);
-  if (!data_->incoming_messages_.empty())
+  if (!data_->incoming_messages_.empty()) {
+    data_->wakeup_pending_ = true;
     TriggerAsync();
+  }
 }
 
 void MessagePort::Stop() {
@@ -861,6 +1302,14 @@ void MessagePort::Stop(const FunctionCallbackInfo<Value>& args) {
   port->Stop();
 }
 
+void MessagePort::SetBatchLimit(const FunctionCallbackInfo<Value>& args) {
+  MessagePort* port;
+  CHECK(args[0]->IsObject());
+  CHECK(args[1]->IsUint32());
+  ASSIGN_OR_RETURN_UNWRAP(&port, args[0].As<Object>());
+  port->batch_limit_ = args[1].As<Uint32>()->Value();
+}
+
 void MessagePort::Drain(const FunctionCallbackInfo<Value>& args) {
   MessagePort* port;
   ASSIGN_OR_RETURN_UNWRAP(&port, args[0].As<Object>());
@@ -975,6 +1424,13 @@ static void MessageChannel(const FunctionCallbackInfo<Value>& args) {
       .Check();
 }
 
+static void SetWrapTransferredHandleFunction(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsFunction());
+  env->set_wrap_transferred_handle_function(args[0].As<Function>());
+}
+
 static void InitMessaging(Local<Object> target,
                           Local<Value> unused,
                           Local<Context> context,
@@ -1000,9 +1456,22 @@ static void InitMessaging(Local<Object> target,
   // the browser equivalents do not provide them.
   env->SetMethod(target, "stopMessagePort", MessagePort::Stop);
   env->SetMethod(target, "drainMessagePort", MessagePort::Drain);
+  env->SetMethod(target, "setMessagePortBatchLimit",
+                 MessagePort::SetBatchLimit);
   env->SetMethod(target, "receiveMessageOnPort", MessagePort::ReceiveMessage);
   env->SetMethod(target, "moveMessagePortToContext",
                  MessagePort::MoveToContext);
+  env->SetMethod(target, "setWrapTransferredHandleFunction",
+                 SetWrapTransferredHandleFunction);
+
+  {
+    constexpr uint32_t kTransferredFileHandle = TransferredHandle::kFileHandle;
+    constexpr uint32_t kTransferredTCP = TransferredHandle::kTCP;
+    constexpr uint32_t kTransferredPipe = TransferredHandle::kPipe;
+    NODE_DEFINE_CONSTANT(target, kTransferredFileHandle);
+    NODE_DEFINE_CONSTANT(target, kTransferredTCP);
+    NODE_DEFINE_CONSTANT(target, kTransferredPipe);
+  }
 
   {
     Local<Function> domexception = GetDOMException(context).ToLocalChecked();
@@ -5,7 +5,7 @@
 
 #include "env.h"
 #include "node_mutex.h"
-#include <list>
+#include <vector>
 
 namespace node {
 namespace worker {
@@ -15,6 +15,37 @@ class MessagePort;
 
 typedef MaybeStackBuffer<v8::Local<v8::Value>, 8> TransferList;
 
+// A file descriptor that is transferred along with a message, e.g. the one
+// underlying a FileHandle or a TCP socket, together with the kind of handle
+// that is created for it on the receiving side. The file descriptor is closed
+// if the message is discarded before it has been received.
+class TransferredHandle {
+ public:
+  enum Type : uint32_t {
+    kFileHandle,
+    kTCP,
+    kPipe
+  };
+
+  TransferredHandle(Type type, int fd) : type_(type), fd_(fd) {}
+  ~TransferredHandle();
+
+  TransferredHandle(TransferredHandle&& other);
+  TransferredHandle& operator=(TransferredHandle&& other);
+  TransferredHandle& operator=(const TransferredHandle&) = delete;
+  TransferredHandle(const TransferredHandle&) = delete;
+
+  Type type() const { return type_; }
+  int fd() const { return fd_; }
+
+  // Give up ownership of the file descriptor.
+  int Release();
+
+ private:
+  Type type_;
+  int fd_;
+};
+
 // Represents a single communication message.
 class Message : public MemoryRetainer {
  public:
@@ -58,6 +89,9 @@ class Message : public MemoryRetainer {
   // Internal method of Message that is called when a new WebAssembly.Module
   // object is encountered in the incoming value's structure.
   uint32_t AddWASMModule(v8::CompiledWasmModule&& mod);
+  // Internal method of Message that is called once serialization finishes
+  // and that transfers ownership of the file descriptor to this message.
+  void AddHandle(TransferredHandle&& handle);
 
   // The MessagePorts that will be transferred, as recorded by Serialize().
   // Used for warning user about posting the target MessagePort to itself,
@@ -77,10 +111,42 @@ class Message : public MemoryRetainer {
   std::vector<std::shared_ptr<v8::BackingStore>> shared_array_buffers_;
   std::vector<std::unique_ptr<MessagePortData>> message_ports_;
   std::vector<v8::CompiledWasmModule> wasm_modules_;
+  std::vector<TransferredHandle> handles_;
 
   friend class MessagePort;
 };
 
+// A first-in, first-out queue of messages that is kept in a ring buffer, so
+// that adding a message does not allocate once the queue has grown to its
+// working size. This is not thread-safe; MessagePortData protects it with
+// its mutex.
+class MessageQueue : public MemoryRetainer {
+ public:
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  Message& front() { return slots_[head_]; }
+  const Message& front() const { return slots_[head_]; }
+
+  void push_back(Message&& message);
+  void pop_front();
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+
+  SET_MEMORY_INFO_NAME(MessageQueue)
+  SET_SELF_SIZE(MessageQueue)
+
+ private:
+  static constexpr size_t kInitialCapacity = 16;
+  // The ring buffer is released again when a queue that has grown beyond
+  // this size becomes empty.
+  static constexpr size_t kMaxRetainedCapacity = 1024;
+
+  // The capacity is always a power of two.
+  std::vector<Message> slots_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
+
 // This contains all data for a `MessagePort` instance that is not tied to
 // a specific Environment/Isolate/event loop, for easier transfer between those.
 class MessagePortData : public MemoryRetainer {
@@ -116,8 +182,12 @@ class MessagePortData : public MemoryRetainer {
   // This mutex protects all fields below it, with the exception of
   // sibling_.
   mutable Mutex mutex_;
-  std::list<Message> incoming_messages_;
+  MessageQueue incoming_messages_;
   MessagePort* owner_ = nullptr;
+  // Whether the owner has been notified of incoming messages and has not
+  // finished processing them yet. While this is set, adding messages to the
+  // queue does not need to trigger the owner's uv_async_t again.
+  bool wakeup_pending_ = false;
   // This mutex protects the sibling_ field and is shared between two entangled
   // MessagePorts. If both mutexes are acquired, this one needs to be
   // acquired first.
@@ -168,6 +238,7 @@ class MessagePort : public HandleWrap {
   static void Start(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Stop(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Drain(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetBatchLimit(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void ReceiveMessage(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   /* static */
@@ -203,11 +274,18 @@ class MessagePort : public HandleWrap {
   void OnClose() override;
   void OnMessage();
   void TriggerAsync();
+  // Called with data_->mutex_ held once OnMessage() stops processing messages.
+  // Returns whether OnMessage() needs to be run again.
+  bool ClearWakeupPending();
   v8::MaybeLocal<v8::Value> ReceiveMessage(v8::Local<v8::Context> context,
                                            bool only_if_receiving);
 
   std::unique_ptr<MessagePortData> data_ = nullptr;
   bool receiving_messages_ = false;
+  // If non-zero, up to this many messages are passed to the object's
+  // `onmessages` symbol method at once, rather than one by one to
+  // emit_message_fn_.
+  size_t batch_limit_ = 0;
   uv_async_t async_;
   v8::Global<v8::Function> emit_message_fn_;
 
@@ -4,6 +4,7 @@
 #include "llhttp.h"
 #include "nghttp2/nghttp2ver.h"
 #include "node.h"
+#include "node_mutex.h"
 #include "util.h"
 #include "uv.h"
 #include "v8.h"
@@ -47,6 +48,13 @@ std::string GetOpenSSLVersion() {
 
 #ifdef NODE_HAVE_I18N_SUPPORT
 void Metadata::Versions::InitializeIntlVersions() {
+  static Mutex mutex;
+  static bool initialized = false;
+  Mutex::ScopedLock lock(mutex);
+  if (initialized)
+    return;
+  initialized = true;
+
   UErrorCode status = U_ZERO_ERROR;
 
   const char* tz_version = icu::TimeZone::getTZDataVersion(status);
@@ -65,8 +65,10 @@ class Metadata {
     Versions();
 
 #ifdef NODE_HAVE_I18N_SUPPORT
-    // Must be called on the main thread after
-    // i18n::InitializeICUDirectory()
+    // Looks up the `cldr` and `tz` versions, which loads parts of the ICU
+    // data. It is called when they are first needed rather than at startup,
+    // and only does something the first time. Must be called after
+    // i18n::InitializeICUDirectory(), and before reading those fields.
     void InitializeIntlVersions();
 #endif  // NODE_HAVE_I18N_SUPPORT
 
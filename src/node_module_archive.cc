@@ -0,0 +1,292 @@
+#include "node_module_archive.h"
+#include "util.h"
+#include "uv.h"
+
+#include <fcntl.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <memory>
+
+#ifdef __POSIX__
+#include <sys/mman.h>
+#endif
+
+namespace node {
+
+namespace {
+
+constexpr char kMagic[] = "NODEMAR1";
+constexpr size_t kMagicLength = sizeof(kMagic) - 1;
+constexpr size_t kHeaderSize = kMagicLength + 2 * sizeof(uint32_t);
+constexpr size_t kIndexEntrySize = 6 * sizeof(uint32_t);
+
+// Set once by ModuleArchive::Load() and never freed, since the archive is
+// used by all threads until the process exits.
+ModuleArchive* loaded_archive = nullptr;
+
+uint32_t ReadUint32(const char* p) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(p);
+  return static_cast<uint32_t>(bytes[0]) |
+         static_cast<uint32_t>(bytes[1]) << 8 |
+         static_cast<uint32_t>(bytes[2]) << 16 |
+         static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+inline bool IsSeparator(char c) {
+#ifdef _WIN32
+  return c == '/' || c == '\\';
+#else
+  return c == '/';
+#endif
+}
+
+int ComparePaths(const char* a, size_t a_length,
+                 const char* b, size_t b_length) {
+  int result = memcmp(a, b, std::min(a_length, b_length));
+  if (result != 0)
+    return result;
+  return a_length < b_length ? -1 : a_length > b_length ? 1 : 0;
+}
+
+// Returns the directory of `path`, with a trailing separator.
+std::string GetMountDirectory(const std::string& path) {
+  size_t end = path.size();
+  while (end > 0 && !IsSeparator(path[end - 1]))
+    end--;
+  return path.substr(0, end);
+}
+
+std::string GetAbsolutePath(const std::string& path) {
+  if (!path.empty() && IsSeparator(path[0]))
+    return path;
+#ifdef _WIN32
+  if (path.size() > 2 && path[1] == ':' && IsSeparator(path[2]))
+    return path;
+#endif
+  char cwd[PATH_MAX_BYTES];
+  size_t cwd_size = sizeof(cwd);
+  if (uv_cwd(cwd, &cwd_size) != 0)
+    return path;
+  return std::string(cwd, cwd_size) + kPathSeparator + path;
+}
+
+}  // anonymous namespace
+
+ModuleArchive::~ModuleArchive() {
+#ifdef __POSIX__
+  if (mapped_)
+    munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+bool ModuleArchive::Load(const std::string& path, std::string* error) {
+  CHECK_NULL(loaded_archive);
+  std::unique_ptr<ModuleArchive> archive(new ModuleArchive());
+
+  uv_fs_t req;
+  const int fd = uv_fs_open(nullptr, &req, path.c_str(), O_RDONLY, 0, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0) {
+    *error = uv_strerror(fd);
+    return false;
+  }
+  auto close_fd = OnScopeLeave([fd]() {
+    uv_fs_t close_req;
+    CHECK_EQ(0, uv_fs_close(nullptr, &close_req, fd, nullptr));
+    uv_fs_req_cleanup(&close_req);
+  });
+
+  int rc = uv_fs_fstat(nullptr, &req, fd, nullptr);
+  const uint64_t size = req.statbuf.st_size;
+  uv_fs_req_cleanup(&req);
+  if (rc != 0) {
+    *error = uv_strerror(rc);
+    return false;
+  }
+  if (size > UINT32_MAX) {
+    *error = "Module archives must be smaller than 4 GB";
+    return false;
+  }
+  archive->size_ = size;
+
+#ifdef __POSIX__
+  if (size > 0) {
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address != MAP_FAILED) {
+      archive->data_ = static_cast<const char*>(address);
+      archive->mapped_ = true;
+    }
+  }
+#endif
+
+  if (!archive->mapped_) {
+    archive->contents_.resize(size);
+    size_t offset = 0;
+    while (offset < size) {
+      uv_buf_t buf = uv_buf_init(archive->contents_.data() + offset,
+                                 size - offset);
+      rc = uv_fs_read(nullptr, &req, fd, &buf, 1, offset, nullptr);
+      uv_fs_req_cleanup(&req);
+      if (rc <= 0) {
+        *error = rc < 0 ? uv_strerror(rc) : "Unexpected end of file";
+        return false;
+      }
+      offset += rc;
+    }
+    archive->data_ = archive->contents_.data();
+  }
+
+  if (!archive->Parse(error))
+    return false;
+
+  archive->roots_.push_back(GetMountDirectory(GetAbsolutePath(path)));
+  if (uv_fs_realpath(nullptr, &req, path.c_str(), nullptr) == 0) {
+    std::string root =
+        GetMountDirectory(static_cast<const char*>(req.ptr));
+    if (root != archive->roots_[0])
+      archive->roots_.push_back(root);
+  }
+  uv_fs_req_cleanup(&req);
+
+  loaded_archive = archive.release();
+  return true;
+}
+
+const ModuleArchive* ModuleArchive::Get() {
+  return loaded_archive;
+}
+
+bool ModuleArchive::Parse(std::string* error) {
+  if (size_ < kHeaderSize || memcmp(data_, kMagic, kMagicLength) != 0) {
+    *error = "Not a module archive";
+    return false;
+  }
+
+  const uint32_t count = ReadUint32(data_ + kMagicLength);
+  if (count > (size_ - kHeaderSize) / kIndexEntrySize) {
+    *error = "Corrupt module archive";
+    return false;
+  }
+
+  index_.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    const char* p = data_ + kHeaderSize + i * kIndexEntrySize;
+    uint32_t fields[6];
+    for (size_t j = 0; j < arraysize(fields); j++)
+      fields[j] = ReadUint32(p + j * sizeof(uint32_t));
+
+    for (size_t j = 0; j < arraysize(fields); j += 2) {
+      if (static_cast<uint64_t>(fields[j]) + fields[j + 1] > size_) {
+        *error = "Corrupt module archive";
+        return false;
+      }
+    }
+
+    IndexEntry entry;
+    entry.path = data_ + fields[0];
+    entry.path_length = fields[1];
+    entry.entry.data = data_ + fields[2];
+    entry.entry.length = fields[3];
+    entry.entry.cached_data = fields[5] > 0 ? data_ + fields[4] : nullptr;
+    entry.entry.cached_data_length = fields[5];
+
+    if (!index_.empty() &&
+        ComparePaths(index_.back().path, index_.back().path_length,
+                     entry.path, entry.path_length) >= 0) {
+      *error = "The index of the module archive is not sorted";
+      return false;
+    }
+    index_.push_back(entry);
+  }
+  return true;
+}
+
+bool ModuleArchive::ToEntryPath(const std::string& path,
+                                std::string* entry_path) const {
+  const char* start = path.c_str();
+  size_t length = path.size();
+#ifdef _WIN32
+  // Strip the prefix of namespaced paths.
+  if (length >= 4 && memcmp(start, "\\\\?\\", 4) == 0) {
+    start += 4;
+    length -= 4;
+  }
+#endif
+  while (length > 0 && IsSeparator(start[length - 1]))
+    length--;
+
+  for (const std::string& root : roots_) {
+    // `root` has a trailing separator, which `path` may lack if it refers to
+    // the mount directory itself.
+    const size_t root_length = root.size() - 1;
+    if (length < root_length || memcmp(start, root.data(), root_length) != 0)
+      continue;
+    if (length == root_length) {
+      entry_path->clear();
+      return true;
+    }
+    if (!IsSeparator(start[root_length]))
+      continue;
+    entry_path->assign(start + root.size(), length - root.size());
+#ifdef _WIN32
+    std::replace(entry_path->begin(), entry_path->end(), '\\', '/');
+#endif
+    return true;
+  }
+  return false;
+}
+
+const ModuleArchive::IndexEntry* ModuleArchive::LowerBound(
+    const std::string& entry_path) const {
+  auto it = std::lower_bound(
+      index_.begin(), index_.end(), entry_path,
+      [](const IndexEntry& entry, const std::string& path) {
+        return ComparePaths(entry.path, entry.path_length,
+                            path.data(), path.size()) < 0;
+      });
+  return index_.data() + (it - index_.begin());
+}
+
+ModuleArchive::PathType ModuleArchive::GetPathType(
+    const std::string& path) const {
+  std::string entry_path;
+  if (!ToEntryPath(path, &entry_path))
+    return PathType::kNone;
+  if (entry_path.empty())
+    return PathType::kDirectory;
+
+  const IndexEntry* end = index_.data() + index_.size();
+  const IndexEntry* it = LowerBound(entry_path);
+  if (it != end &&
+      ComparePaths(it->path, it->path_length,
+                   entry_path.data(), entry_path.size()) == 0) {
+    return PathType::kFile;
+  }
+
+  // Directories are not stored, but exist if they contain any entries.
+  entry_path += '/';
+  it = LowerBound(entry_path);
+  if (it != end && it->path_length > entry_path.size() &&
+      memcmp(it->path, entry_path.data(), entry_path.size()) == 0) {
+    return PathType::kDirectory;
+  }
+  return PathType::kNone;
+}
+
+bool ModuleArchive::Find(const std::string& path, Entry* entry) const {
+  std::string entry_path;
+  if (!ToEntryPath(path, &entry_path) || entry_path.empty())
+    return false;
+
+  const IndexEntry* it = LowerBound(entry_path);
+  if (it == index_.data() + index_.size() ||
+      ComparePaths(it->path, it->path_length,
+                   entry_path.data(), entry_path.size()) != 0) {
+    return false;
+  }
+  *entry = it->entry;
+  return true;
+}
+
+}  // namespace node
@@ -0,0 +1,84 @@
+#ifndef SRC_NODE_MODULE_ARCHIVE_H_
+#define SRC_NODE_MODULE_ARCHIVE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace node {
+
+// A read-only archive of module files that is loaded with --module-archive.
+// The files in the archive are mounted at the directory that contains the
+// archive, and take precedence over the files in that directory when modules
+// are resolved and loaded.
+//
+// Archives consist of a header, an index that is sorted by path, and the
+// contents of the files. All numbers are 32-bit little-endian integers and
+// all offsets are relative to the start of the archive:
+//
+//   magic "NODEMAR1", entry count, reserved (0),
+//   for each entry: path offset, path length, data offset, data length,
+//                   cached data offset, cached data length
+//
+// Paths are relative to the mount directory and use '/' as separator. The
+// cached data of an entry is an optional V8 code cache for the CommonJS
+// module wrapper of the file.
+class ModuleArchive {
+ public:
+  enum class PathType { kNone, kFile, kDirectory };
+
+  struct Entry {
+    const char* data;
+    size_t length;
+    const char* cached_data;
+    size_t cached_data_length;
+  };
+
+  ~ModuleArchive();
+  ModuleArchive(const ModuleArchive&) = delete;
+  ModuleArchive& operator=(const ModuleArchive&) = delete;
+
+  // Loads the archive at `path`, which is used for the rest of the lifetime
+  // of the process. Must be called before any thread uses Get().
+  static bool Load(const std::string& path, std::string* error);
+  // Returns the archive that has been loaded, or nullptr.
+  static const ModuleArchive* Get();
+
+  PathType GetPathType(const std::string& path) const;
+  bool Find(const std::string& path, Entry* entry) const;
+
+ private:
+  struct IndexEntry {
+    const char* path;
+    size_t path_length;
+    Entry entry;
+  };
+
+  ModuleArchive() = default;
+
+  bool Parse(std::string* error);
+  // Converts an absolute path to the path of an entry. Returns false if the
+  // path is outside of the mount directory.
+  bool ToEntryPath(const std::string& path, std::string* entry_path) const;
+  // Returns the first entry whose path is not less than `entry_path`.
+  const IndexEntry* LowerBound(const std::string& entry_path) const;
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  bool mapped_ = false;
+  // Used instead of a memory mapping where that is not available.
+  std::vector<char> contents_;
+  // The mount directory, with a trailing separator, as given and after
+  // resolving symbolic links.
+  std::vector<std::string> roots_;
+  std::vector<IndexEntry> index_;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_MODULE_ARCHIVE_H_
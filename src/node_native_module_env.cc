@@ -123,11 +123,14 @@ void NativeModuleEnv::CompileFunction(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsString());
   node::Utf8Value id_v(env->isolate(), args[0].As<String>());
   const char* id = *id_v;
+  const uint64_t start = uv_hrtime();
   NativeModuleLoader::Result result;
   MaybeLocal<Function> maybe =
       NativeModuleLoader::GetInstance()->CompileAsModule(
           env->context(), id, &result);
   RecordResult(id, result, env);
+  if (env->options()->trace_bootstrap_modules)
+    env->native_module_compile_times[id] = uv_hrtime() - start;
   if (!maybe.IsEmpty()) {
     args.GetReturnValue().Set(maybe.ToLocalChecked());
   }
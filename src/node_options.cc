@@ -71,9 +71,30 @@ void PerProcessOptions::CheckOptions(std::vector<std::string>* errors) {
       use_largepages != "silent") {
     errors->push_back("invalid value for --use-largepages");
   }
+  if (use_largepages_heap != "off" &&
+      use_largepages_heap != "on" &&
+      use_largepages_heap != "silent") {
+    errors->push_back("invalid value for --use-largepages-heap");
+  }
+  if (trace_event_format != "json" && trace_event_format != "binary") {
+    errors->push_back("invalid value for --trace-event-format");
+  }
+  if (heap_memory_percentage > 100) {
+    errors->push_back("--heap-memory-percentage must be at most 100");
+  }
+  if (build_snapshot && snapshot_blob.empty()) {
+    errors->push_back("--build-snapshot must be used together with "
+                      "--snapshot-blob");
+  }
   per_isolate->CheckOptions(errors);
 }
 
+std::shared_ptr<PerIsolateOptions> PerIsolateOptions::Clone() const {
+  auto options = std::make_shared<PerIsolateOptions>(*this);
+  options->per_env = std::make_shared<EnvironmentOptions>(*per_env);
+  return options;
+}
+
 void PerIsolateOptions::CheckOptions(std::vector<std::string>* errors) {
   per_env->CheckOptions(errors);
 #ifdef NODE_REPORT
@@ -117,6 +138,11 @@ void PerIsolateOptions::CheckOptions(std::vector<std::string>* errors) {
         "--report-uncaught-exception option is valid only when "
         "--experimental-report is set");
   }
+
+  if (report_exclude_handles) {
+    errors->push_back("--report-exclude-handles option is valid only when "
+                      "--experimental-report is set");
+  }
 #endif  // NODE_REPORT
 }
 
@@ -185,6 +211,10 @@ void EnvironmentOptions::CheckOptions(std::vector<std::string>* errors) {
     if (cpu_prof_interval != kDefaultCpuProfInterval) {
       errors->push_back("--cpu-prof-interval must be used with --cpu-prof");
     }
+    if (cpu_prof_rotate_interval != 0) {
+      errors->push_back(
+          "--cpu-prof-rotate-interval must be used with --cpu-prof");
+    }
   }
 
   if (!heap_prof) {
@@ -199,6 +229,10 @@ void EnvironmentOptions::CheckOptions(std::vector<std::string>* errors) {
     if (heap_prof_interval != kDefaultHeapProfInterval) {
       errors->push_back("--heap-prof-interval must be used with --heap-prof");
     }
+    if (heap_prof_dump_interval != 0) {
+      errors->push_back(
+          "--heap-prof-dump-interval must be used with --heap-prof");
+    }
   }
   debug_options_.CheckOptions(errors);
 #endif  // HAVE_INSPECTOR
@@ -313,10 +347,25 @@ DebugOptionsParser::DebugOptionsParser() {
 }
 
 EnvironmentOptionsParser::EnvironmentOptionsParser() {
+  AddOption("--buffered-stdio",
+            "write stdout and stderr to files and pipes from a separate "
+            "thread, and to terminals once per tick",
+            &EnvironmentOptions::buffered_stdio,
+            kAllowedInEnvironment);
+  AddOption("--compile-cache-dir",
+            "cache the compiled code of CommonJS and ES modules in the given "
+            "directory",
+            &EnvironmentOptions::compile_cache_dir,
+            kAllowedInEnvironment);
   AddOption("--enable-source-maps",
             "experimental Source Map V3 support",
             &EnvironmentOptions::enable_source_maps,
             kAllowedInEnvironment);
+  AddOption("--experimental-batch-ticks",
+            "process the nextTick and microtask queues once per poll phase "
+            "of the event loop",
+            &EnvironmentOptions::experimental_batch_ticks,
+            kAllowedInEnvironment);
   AddOption("--experimental-json-modules",
             "experimental JSON interop support for the ES Module loader",
             &EnvironmentOptions::experimental_json_modules,
@@ -445,6 +494,10 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "specified sampling interval in microseconds for the V8 CPU "
             "profile generated with --cpu-prof. (default: 1000)",
             &EnvironmentOptions::cpu_prof_interval);
+  AddOption("--cpu-prof-rotate-interval",
+            "start a new V8 CPU profile every <n> milliseconds, and write "
+            "the profiles generated with --cpu-prof in pprof format",
+            &EnvironmentOptions::cpu_prof_rotate_interval);
   AddOption("--cpu-prof-dir",
             "Directory where the V8 profiles generated by --cpu-prof will be "
             "placed. Does not affect --prof.",
@@ -467,7 +520,20 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "specified sampling interval in bytes for the V8 heap "
             "profile generated with --heap-prof. (default: 512 * 1024)",
             &EnvironmentOptions::heap_prof_interval);
+  AddOption("--heap-prof-dump-interval",
+            "write the V8 heap profile generated with --heap-prof to disk "
+            "every <n> milliseconds, in addition to before exit",
+            &EnvironmentOptions::heap_prof_dump_interval);
 #endif  // HAVE_INSPECTOR
+  AddOption("--loop-busy-poll",
+            "poll for I/O without blocking for up to <n> microseconds "
+            "before the event loop blocks (Linux only, default: 0)",
+            &EnvironmentOptions::loop_busy_poll,
+            kAllowedInEnvironment);
+  AddOption("--loop-edge-triggered",
+            "watch TCP sockets for I/O with edge-triggered epoll (Linux only)",
+            &EnvironmentOptions::loop_edge_triggered,
+            kAllowedInEnvironment);
   AddOption("--max-http-header-size",
             "set the maximum size of HTTP headers (default: 8192 (8KB))",
             &EnvironmentOptions::max_http_header_size,
@@ -482,6 +548,11 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "throw an exception on deprecations",
             &EnvironmentOptions::throw_deprecation,
             kAllowedInEnvironment);
+  AddOption("--trace-bootstrap-modules",
+            "print the built-in modules that are loaded before user code "
+            "runs, and the time spent compiling them",
+            &EnvironmentOptions::trace_bootstrap_modules,
+            kAllowedInEnvironment);
   AddOption("--trace-deprecation",
             "show stack traces on deprecations",
             &EnvironmentOptions::trace_deprecation,
@@ -646,6 +717,10 @@ PerIsolateOptionsParser::PerIsolateOptionsParser(
             " (default: current working directory of Node.js process)",
             &PerIsolateOptions::report_directory,
             kAllowedInEnvironment);
+  AddOption("--report-exclude-handles",
+            "do not list the libuv handles in diagnostic reports",
+            &PerIsolateOptions::report_exclude_handles,
+            kAllowedInEnvironment);
 #endif  // NODE_REPORT
 
   Insert(eop, &PerIsolateOptions::get_per_env_options);
@@ -653,6 +728,27 @@ PerIsolateOptionsParser::PerIsolateOptionsParser(
 
 PerProcessOptionsParser::PerProcessOptionsParser(
   const PerIsolateOptionsParser& iop) {
+  AddOption("--build-snapshot",
+            "run the entry script and write a snapshot of the resulting "
+            "heap to the path given by --snapshot-blob",
+            &PerProcessOptions::build_snapshot,
+            kDisallowedInEnvironment);
+  AddOption("--snapshot-blob",
+            "path to a startup snapshot to start from, or to write with "
+            "--build-snapshot",
+            &PerProcessOptions::snapshot_blob,
+            kDisallowedInEnvironment);
+  AddOption("--module-archive",
+            "load modules from the given module archive, which is mounted at "
+            "the directory that contains it",
+            &PerProcessOptions::module_archive,
+            kAllowedInEnvironment);
+  AddOption("--heap-memory-percentage",
+            "size the V8 heap of each thread to this percentage of the "
+            "memory available to the process (its cgroup memory limit, if "
+            "it has one)",
+            &PerProcessOptions::heap_memory_percentage,
+            kAllowedInEnvironment);
   AddOption("--title",
             "the process title to use on startup",
             &PerProcessOptions::title,
@@ -666,8 +762,22 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             "data, it supports ${rotation} and ${pid}.",
             &PerProcessOptions::trace_event_file_pattern,
             kAllowedInEnvironment);
+  AddOption("--trace-event-format",
+            "format of the trace-events data, either 'json' (the default) "
+            "or 'binary'",
+            &PerProcessOptions::trace_event_format,
+            kAllowedInEnvironment);
+  AddOption("--trace-event-flight-recorder",
+            "keep the most recent trace events in memory, and only write "
+            "them when a diagnostic report is generated",
+            &PerProcessOptions::trace_event_flight_recorder,
+            kAllowedInEnvironment);
   AddAlias("--trace-events-enabled", {
     "--trace-event-categories", "v8,node,node.async_hooks" });
+  AddOption("--v8-pool-affinity",
+            "bind each thread of V8's thread pool to a single CPU",
+            &PerProcessOptions::v8_pool_affinity,
+            kAllowedInEnvironment);
   AddOption("--v8-pool-size",
             "set V8's thread pool size",
             &PerProcessOptions::v8_thread_pool_size,
@@ -681,6 +791,11 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             "", /* undocumented, only for debugging */
             &PerProcessOptions::debug_arraybuffer_allocations,
             kAllowedInEnvironment);
+  AddOption("--buffer-pool-huge-pages",
+            "back the native Buffer allocation pool with transparent huge "
+            "pages where the OS supports it",
+            &PerProcessOptions::buffer_pool_huge_pages,
+            kAllowedInEnvironment);
 
 
   // 12.x renamed this inadvertently, so alias it for consistency within the
@@ -723,6 +838,11 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             "use an alternative default TLS cipher list",
             &PerProcessOptions::tls_cipher_list,
             kAllowedInEnvironment);
+  AddOption("--tls-verify-cache-ttl",
+            "reuse the result of verifying a TLS certificate chain for the "
+            "given number of milliseconds (default: 0, disabled)",
+            &PerProcessOptions::tls_verify_cache_ttl,
+            kAllowedInEnvironment);
   AddOption("--use-openssl-ca",
             "use OpenSSL's default CA store"
 #if defined(NODE_OPENSSL_CERT_STORE)
@@ -765,6 +885,12 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             "or 'silent' (map and silently ignore failure)",
             &PerProcessOptions::use_largepages,
             kAllowedInEnvironment);
+  AddOption("--use-largepages-heap",
+            "Back the V8 heap, including generated code, with large pages. "
+            "Options are 'off' (the default value), 'on' (report failure "
+            "to stderr), or 'silent' (silently ignore failure)",
+            &PerProcessOptions::use_largepages_heap,
+            kAllowedInEnvironment);
 
   AddOption("--trace-sigint",
             "enable printing JavaScript stacktrace on SIGINT",
@@ -100,7 +100,9 @@ class DebugOptions : public Options {
 class EnvironmentOptions : public Options {
  public:
   bool abort_on_uncaught_exception = false;
+  bool buffered_stdio = false;
   bool enable_source_maps = false;
+  bool experimental_batch_ticks = false;
   bool experimental_json_modules = false;
   bool experimental_modules = false;
   std::string experimental_specifier_resolution;
@@ -116,6 +118,8 @@ class EnvironmentOptions : public Options {
   bool expose_internals = false;
   bool frozen_intrinsics = false;
   std::string heap_snapshot_signal;
+  uint64_t loop_busy_poll = 0;
+  bool loop_edge_triggered = false;
   uint64_t max_http_header_size = 8 * 1024;
   bool no_deprecation = false;
   bool no_force_async_hooks_checks = false;
@@ -129,17 +133,21 @@ class EnvironmentOptions : public Options {
   std::string cpu_prof_dir;
   static const uint64_t kDefaultCpuProfInterval = 1000;
   uint64_t cpu_prof_interval = kDefaultCpuProfInterval;
+  uint64_t cpu_prof_rotate_interval = 0;
   std::string cpu_prof_name;
   bool cpu_prof = false;
   std::string heap_prof_dir;
   std::string heap_prof_name;
   static const uint64_t kDefaultHeapProfInterval = 512 * 1024;
   uint64_t heap_prof_interval = kDefaultHeapProfInterval;
+  uint64_t heap_prof_dump_interval = 0;
   bool heap_prof = false;
 #endif  // HAVE_INSPECTOR
   std::string redirect_warnings;
+  std::string compile_cache_dir;
   bool test_udp_no_try_send = false;
   bool throw_deprecation = false;
+  bool trace_bootstrap_modules = false;
   bool trace_deprecation = false;
   bool trace_exit = false;
   bool trace_sync_io = false;
@@ -192,12 +200,15 @@ class PerIsolateOptions : public Options {
   bool report_uncaught_exception = false;
   bool report_on_signal = false;
   bool report_on_fatalerror = false;
+  bool report_exclude_handles = false;
   std::string report_signal;
   std::string report_filename;
   std::string report_directory;
 #endif  //  NODE_REPORT
   inline EnvironmentOptions* get_per_env_options();
   void CheckOptions(std::vector<std::string>* errors) override;
+  // Unlike the copy constructor, this does not share `per_env`.
+  std::shared_ptr<PerIsolateOptions> Clone() const;
 };
 
 class PerProcessOptions : public Options {
@@ -207,9 +218,17 @@ class PerProcessOptions : public Options {
   std::string title;
   std::string trace_event_categories;
   std::string trace_event_file_pattern = "node_trace.${rotation}.log";
-  int64_t v8_thread_pool_size = 4;
+  std::string trace_event_format = "json";
+  bool trace_event_flight_recorder = false;
+  uint64_t heap_memory_percentage = 0;
+  int64_t v8_thread_pool_size = 0;
+  bool v8_pool_affinity = false;
+  bool build_snapshot = false;
+  std::string snapshot_blob;
+  std::string module_archive;
   bool zero_fill_all_buffers = false;
   bool debug_arraybuffer_allocations = false;
+  bool buffer_pool_huge_pages = false;
 
   std::vector<std::string> security_reverts;
   bool print_bash_completion = false;
@@ -225,6 +244,7 @@ class PerProcessOptions : public Options {
 #if HAVE_OPENSSL
   std::string openssl_config;
   std::string tls_cipher_list = DEFAULT_CIPHER_LIST_CORE;
+  uint64_t tls_verify_cache_ttl = 0;
 #ifdef NODE_OPENSSL_CERT_STORE
   bool ssl_openssl_cert_store = true;
 #else
@@ -238,6 +258,7 @@ class PerProcessOptions : public Options {
 #endif
 #endif
   std::string use_largepages = "off";
+  std::string use_largepages_heap = "off";
   bool trace_sigint = false;
 
 #ifdef NODE_REPORT
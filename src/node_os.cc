@@ -20,6 +20,7 @@
 // USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "env-inl.h"
+#include "node_internals.h"
 #include "string_bytes.h"
 
 #ifdef __MINGW32__
@@ -33,7 +34,9 @@
 
 #include <array>
 #include <cerrno>
+#include <cstdio>
 #include <cstring>
+#include <vector>
 
 namespace node {
 namespace os {
@@ -142,6 +145,83 @@ static void GetCPUInfo(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+#ifdef __linux__
+// Reads the times of all CPUs from /proc/stat in the same units as
+// uv_cpu_info(). That is all GetCPUTimes() needs, while uv_cpu_info() also
+// reads /proc/cpuinfo and the current frequency of every CPU from sysfs.
+static bool ReadProcStatTimes(std::vector<double>* times) {
+  static const long ticks = sysconf(_SC_CLK_TCK);  // NOLINT(runtime/int)
+  if (ticks <= 0)
+    return false;
+  const double multiplier = 1000.0 / ticks;
+
+  FILE* fp = fopen("/proc/stat", "re");
+  if (fp == nullptr)
+    return false;
+
+  bool ok = true;
+  char line[1024];
+  // The per-CPU lines follow the line with the totals, "cpu  ...".
+  while (fgets(line, sizeof(line), fp) != nullptr &&
+         strncmp(line, "cpu", 3) == 0) {
+    if (line[3] == ' ')
+      continue;
+    unsigned int num;
+    unsigned long long user, nice, sys, idle, iowait, irq;  // NOLINT
+    if (sscanf(line, "cpu%u %llu %llu %llu %llu %llu %llu",  // NOLINT
+               &num, &user, &nice, &sys, &idle, &iowait, &irq) != 7) {
+      ok = false;
+      break;
+    }
+    times->push_back(user * multiplier);
+    times->push_back(nice * multiplier);
+    times->push_back(sys * multiplier);
+    times->push_back(idle * multiplier);
+    times->push_back(irq * multiplier);
+  }
+  fclose(fp);
+  return ok && !times->empty();
+}
+#endif  // __linux__
+
+// Returns a Float64Array with the user, nice, sys, idle and irq times of
+// every CPU, as os.cpus() reports them, without the model and speed.
+static void GetCPUTimes(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  std::vector<double> times;
+
+  bool ok = false;
+#ifdef __linux__
+  ok = ReadProcStatTimes(&times);
+#endif  // __linux__
+  if (!ok) {
+    uv_cpu_info_t* cpu_infos;
+    int count;
+    times.clear();
+    if (uv_cpu_info(&cpu_infos, &count) != 0)
+      return;
+    for (int i = 0; i < count; i++) {
+      const uv_cpu_times_s& cpu_times = cpu_infos[i].cpu_times;
+      times.push_back(cpu_times.user);
+      times.push_back(cpu_times.nice);
+      times.push_back(cpu_times.sys);
+      times.push_back(cpu_times.idle);
+      times.push_back(cpu_times.irq);
+    }
+    uv_free_cpu_info(cpu_infos, count);
+  }
+
+  Local<ArrayBuffer> ab =
+      ArrayBuffer::New(env->isolate(), times.size() * sizeof(double));
+  if (!times.empty()) {
+    memcpy(ab->GetBackingStore()->Data(),
+           times.data(),
+           times.size() * sizeof(double));
+  }
+  args.GetReturnValue().Set(Float64Array::New(ab, 0, times.size()));
+}
+
+
 static void GetFreeMemory(const FunctionCallbackInfo<Value>& args) {
   double amount = uv_get_free_memory();
   if (amount < 0)
@@ -158,6 +238,11 @@ static void GetTotalMemory(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+static void GetAvailableParallelism(const FunctionCallbackInfo<Value>& args) {
+  args.GetReturnValue().Set(node::GetAvailableParallelism());
+}
+
+
 static void GetUptime(const FunctionCallbackInfo<Value>& args) {
   double uptime;
   int err = uv_uptime(&uptime);
@@ -398,6 +483,8 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "getTotalMem", GetTotalMemory);
   env->SetMethod(target, "getFreeMem", GetFreeMemory);
   env->SetMethod(target, "getCPUs", GetCPUInfo);
+  env->SetMethod(target, "getAvailableParallelism", GetAvailableParallelism);
+  env->SetMethod(target, "getCPUTimes", GetCPUTimes);
   env->SetMethod(target, "getOSType", GetOSType);
   env->SetMethod(target, "getOSRelease", GetOSRelease);
   env->SetMethod(target, "getInterfaceAddresses", GetInterfaceAddresses);
@@ -3,23 +3,39 @@
 #include "node_internals.h"
 #include "node_perf.h"
 #include "node_buffer.h"
+#include "node_errors.h"
+#include "node_mutex.h"
 #include "node_process.h"
 #include "util-inl.h"
 
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
 #include <cinttypes>
+#include <cstring>
 
 namespace node {
 namespace performance {
 
 using v8::Array;
+using v8::BigInt;
+using v8::Boolean;
 using v8::Context;
 using v8::DontDelete;
+using v8::Float64Array;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::GCCallbackFlags;
 using v8::GCType;
 using v8::HandleScope;
+using v8::HeapSpaceStatistics;
+using v8::Int32;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
@@ -32,8 +48,11 @@ using v8::Object;
 using v8::PropertyAttribute;
 using v8::ReadOnly;
 using v8::String;
+using v8::Uint32;
 using v8::Uint32Array;
 using v8::Value;
+using v8::ValueDeserializer;
+using v8::ValueSerializer;
 
 // Microseconds in a millisecond, as a float.
 #define MICROS_PER_MILLIS 1e3
@@ -44,6 +63,23 @@ const uint64_t timeOrigin = PERFORMANCE_NOW();
 const double timeOriginTimestamp = GetCurrentTimeInMicroseconds();
 uint64_t performance_v8_start;
 
+namespace {
+
+// The process-wide phases, as start and end timestamps (0 if not recorded).
+// OpenSSL may be initialized by any thread, so access is synchronized.
+Mutex process_phases_mutex;
+uint64_t process_phases[NODE_PERFORMANCE_PHASE_INVALID][2];
+
+}  // anonymous namespace
+
+void MarkProcessPhase(enum PerformancePhase phase,
+                      uint64_t start,
+                      uint64_t end) {
+  Mutex::ScopedLock lock(process_phases_mutex);
+  process_phases[phase][0] = start;
+  process_phases[phase][1] = end;
+}
+
 void performance_state::Mark(enum PerformanceMilestone milestone,
                              uint64_t ts) {
   this->milestones[milestone] = ts;
@@ -53,6 +89,47 @@ void performance_state::Mark(enum PerformanceMilestone milestone,
       TRACE_EVENT_SCOPE_THREAD, ts / 1000);
 }
 
+void performance_state::MarkPhaseStart(enum PerformancePhase phase,
+                                       uint64_t ts) {
+  this->phases[phase * 2] = ts;
+}
+
+void performance_state::MarkPhaseEnd(enum PerformancePhase phase,
+                                     uint64_t ts) {
+  const double start = this->phases[phase * 2];
+  if (start < 0)
+    return;
+  this->phases[phase * 2 + 1] = ts;
+  TRACE_EVENT_NESTABLE_ASYNC_BEGIN_WITH_TIMESTAMP0(
+      TRACING_CATEGORY_NODE1(bootstrap),
+      GetPerformancePhaseName(phase),
+      this, static_cast<uint64_t>(start) / 1000);
+  TRACE_EVENT_NESTABLE_ASYNC_END_WITH_TIMESTAMP0(
+      TRACING_CATEGORY_NODE1(bootstrap),
+      GetPerformancePhaseName(phase),
+      this, ts / 1000);
+}
+
+void performance_state::CopyProcessPhases(bool trace) {
+  Mutex::ScopedLock lock(process_phases_mutex);
+  for (size_t i = 0; i < NODE_PERFORMANCE_PHASE_INVALID; i++) {
+    const uint64_t start = process_phases[i][0];
+    const uint64_t end = process_phases[i][1];
+    if (start == 0 || this->phases[i * 2] >= 0)
+      continue;
+    this->phases[i * 2] = start;
+    this->phases[i * 2 + 1] = end;
+    if (!trace)
+      continue;
+    const char* name =
+        GetPerformancePhaseName(static_cast<PerformancePhase>(i));
+    TRACE_EVENT_NESTABLE_ASYNC_BEGIN_WITH_TIMESTAMP0(
+        TRACING_CATEGORY_NODE1(bootstrap), name, this, start / 1000);
+    TRACE_EVENT_NESTABLE_ASYNC_END_WITH_TIMESTAMP0(
+        TRACING_CATEGORY_NODE1(bootstrap), name, this, end / 1000);
+  }
+}
+
 // Initialize the performance entry object properties
 inline void InitObject(const PerformanceEntry& entry, Local<Object> obj) {
   Environment* env = entry.env();
@@ -232,33 +309,94 @@ void SetupPerformanceObservers(const FunctionCallbackInfo<Value>& args) {
 void PerformanceGCCallback(Environment* env,
                            std::unique_ptr<GCPerformanceEntry> entry) {
   HandleScope scope(env->isolate());
+  Isolate* isolate = env->isolate();
   Local<Context> context = env->context();
 
   AliasedUint32Array& observers = env->performance_state()->observers;
   if (observers[NODE_PERFORMANCE_ENTRY_TYPE_GC]) {
     Local<Object> obj;
     if (!entry->ToObject().ToLocal(&obj)) return;
+    Local<Object> spaces = Object::New(isolate);
+    for (const GCHeapSpaceUsage& space : entry->spaces()) {
+      Local<Object> usage = Object::New(isolate);
+      usage->Set(context,
+                 FIXED_ONE_BYTE_STRING(isolate, "before"),
+                 Number::New(isolate, space.before)).Check();
+      usage->Set(context,
+                 FIXED_ONE_BYTE_STRING(isolate, "after"),
+                 Number::New(isolate, space.after)).Check();
+      spaces->Set(context, OneByteString(isolate, space.name), usage).Check();
+    }
     PropertyAttribute attr =
         static_cast<PropertyAttribute>(ReadOnly | DontDelete);
     obj->DefineOwnProperty(context,
                            env->kind_string(),
-                           Integer::New(env->isolate(), entry->gckind()),
+                           Integer::New(isolate, entry->gckind()),
                            attr).Check();
     obj->DefineOwnProperty(context,
                            env->flags_string(),
-                           Integer::New(env->isolate(), entry->gcflags()),
+                           Integer::New(isolate, entry->gcflags()),
+                           attr).Check();
+    obj->DefineOwnProperty(context,
+                           FIXED_ONE_BYTE_STRING(isolate, "incremental"),
+                           Boolean::New(isolate, entry->incremental()),
+                           attr).Check();
+    obj->DefineOwnProperty(context,
+                           FIXED_ONE_BYTE_STRING(isolate, "promoted"),
+                           Number::New(isolate, entry->promoted()),
+                           attr).Check();
+    obj->DefineOwnProperty(context,
+                           FIXED_ONE_BYTE_STRING(isolate, "heapSpaces"),
+                           spaces,
                            attr).Check();
     PerformanceEntry::Notify(env, entry->kind(), obj);
   }
 }
 
+inline bool IsGCDetailRecorded(performance_state* state) {
+  return state->observers[NODE_PERFORMANCE_ENTRY_TYPE_GC] ||
+         state->gc_totals_count > 0;
+}
+
+// Young generation spaces are emptied by a scavenge, everything that
+// survives it grows one of the other spaces.
+inline bool IsYoungGenerationSpace(const char* name) {
+  return strcmp(name, "new_space") == 0 ||
+         strcmp(name, "new_large_object_space") == 0;
+}
+
+inline GCTotalsKind GetGCTotalsKind(GCType type) {
+  switch (type) {
+    case GCType::kGCTypeScavenge:
+      return NODE_GC_TOTALS_KIND_MINOR;
+    case GCType::kGCTypeMarkSweepCompact:
+      return NODE_GC_TOTALS_KIND_MAJOR;
+    case GCType::kGCTypeIncrementalMarking:
+      return NODE_GC_TOTALS_KIND_INCREMENTAL;
+    case GCType::kGCTypeProcessWeakCallbacks:
+      return NODE_GC_TOTALS_KIND_WEAKCB;
+    default:
+      return NODE_GC_TOTALS_KIND_INVALID;
+  }
+}
+
 // Marks the start of a GC cycle
 void MarkGarbageCollectionStart(Isolate* isolate,
                                 GCType type,
                                 GCCallbackFlags flags,
                                 void* data) {
   Environment* env = static_cast<Environment*>(data);
-  env->performance_state()->performance_last_gc_start_mark = PERFORMANCE_NOW();
+  performance_state* state = env->performance_state();
+  state->performance_last_gc_start_mark = PERFORMANCE_NOW();
+  if (!IsGCDetailRecorded(state))
+    return;
+  const size_t count = isolate->NumberOfHeapSpaces();
+  state->gc_space_used_before.resize(count);
+  HeapSpaceStatistics stats;
+  for (size_t i = 0; i < count; i++) {
+    isolate->GetHeapSpaceStatistics(&stats, i);
+    state->gc_space_used_before[i] = stats.space_used_size();
+  }
 }
 
 // Marks the end of a GC cycle
@@ -268,7 +406,53 @@ void MarkGarbageCollectionEnd(Isolate* isolate,
                               void* data) {
   Environment* env = static_cast<Environment*>(data);
   performance_state* state = env->performance_state();
-  // If no one is listening to gc performance entries, do not create them.
+  const uint64_t now = PERFORMANCE_NOW();
+  // A mark-compact was incremental if incremental marking ran before it.
+  bool incremental = type == GCType::kGCTypeIncrementalMarking;
+  if (incremental) {
+    state->gc_incremental_marking = true;
+  } else if (type == GCType::kGCTypeMarkSweepCompact) {
+    incremental = state->gc_incremental_marking;
+    state->gc_incremental_marking = false;
+  }
+  // If no one is listening to gc performance entries or keeping totals,
+  // do not collect the details.
+  if (!IsGCDetailRecorded(state))
+    return;
+
+  std::vector<GCHeapSpaceUsage> spaces(isolate->NumberOfHeapSpaces());
+  const bool has_before = state->gc_space_used_before.size() == spaces.size();
+  size_t before = 0;
+  size_t after = 0;
+  size_t promoted = 0;
+  HeapSpaceStatistics stats;
+  for (size_t i = 0; i < spaces.size(); i++) {
+    isolate->GetHeapSpaceStatistics(&stats, i);
+    GCHeapSpaceUsage& space = spaces[i];
+    space.name = stats.space_name();
+    space.after = stats.space_used_size();
+    space.before = has_before ? state->gc_space_used_before[i] : space.after;
+    before += space.before;
+    after += space.after;
+    if (type == GCType::kGCTypeScavenge &&
+        !IsYoungGenerationSpace(space.name) &&
+        space.after > space.before) {
+      promoted += space.after - space.before;
+    }
+  }
+
+  const GCTotalsKind kind = GetGCTotalsKind(type);
+  if (state->gc_totals_count > 0 && kind != NODE_GC_TOTALS_KIND_INVALID) {
+    const size_t index = kind * NODE_GC_TOTALS_FIELD_INVALID;
+    AliasedFloat64Array& totals = state->gc_totals;
+    totals[index + NODE_GC_TOTALS_FIELD_COUNT] += 1;
+    totals[index + NODE_GC_TOTALS_FIELD_DURATION] +=
+        (now - state->performance_last_gc_start_mark) / 1e6;
+    if (before > after)
+      totals[index + NODE_GC_TOTALS_FIELD_COLLECTED] += before - after;
+    totals[index + NODE_GC_TOTALS_FIELD_PROMOTED] += promoted;
+  }
+
   if (!state->observers[NODE_PERFORMANCE_ENTRY_TYPE_GC])
     return;
   auto entry = std::make_unique<GCPerformanceEntry>(
@@ -276,7 +460,10 @@ void MarkGarbageCollectionEnd(Isolate* isolate,
       static_cast<PerformanceGCKind>(type),
       static_cast<PerformanceGCFlags>(flags),
       state->performance_last_gc_start_mark,
-      PERFORMANCE_NOW());
+      now,
+      incremental,
+      promoted,
+      std::move(spaces));
   env->SetUnrefImmediate([entry = std::move(entry)](Environment* env) mutable {
     PerformanceGCCallback(env, std::move(entry));
   });
@@ -288,10 +475,17 @@ void GarbageCollectionCleanupHook(void* data) {
   env->isolate()->RemoveGCEpilogueCallback(MarkGarbageCollectionEnd, data);
 }
 
+// The callbacks are shared by gc performance entries and by the totals of
+// perf_hooks.monitorGarbageCollection(), which pass `true`.
 static void InstallGarbageCollectionTracking(
     const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
+  performance_state* state = env->performance_state();
 
+  if (args[0]->IsTrue())
+    state->gc_totals_count++;
+  if (state->gc_tracking_count++ > 0)
+    return;
   env->isolate()->AddGCPrologueCallback(MarkGarbageCollectionStart,
                                         static_cast<void*>(env));
   env->isolate()->AddGCEpilogueCallback(MarkGarbageCollectionEnd,
@@ -302,7 +496,15 @@ static void InstallGarbageCollectionTracking(
 static void RemoveGarbageCollectionTracking(
   const FunctionCallbackInfo<Value> &args) {
   Environment* env = Environment::GetCurrent(args);
+  performance_state* state = env->performance_state();
 
+  if (args[0]->IsTrue()) {
+    CHECK_GT(state->gc_totals_count, 0);
+    state->gc_totals_count--;
+  }
+  CHECK_GT(state->gc_tracking_count, 0);
+  if (--state->gc_tracking_count > 0)
+    return;
   env->RemoveCleanupHook(GarbageCollectionCleanupHook, env);
   GarbageCollectionCleanupHook(env);
 }
@@ -396,24 +598,27 @@ void Notify(const FunctionCallbackInfo<Value>& args) {
 }
 
 
-// Event Loop Timing Histogram
+// Event Loop Timing and Threadpool Histograms
 namespace {
-static void ELDHistogramMin(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename HistogramT>
+static void HistogramMin(const FunctionCallbackInfo<Value>& args) {
+  HistogramT* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   double value = static_cast<double>(histogram->Min());
   args.GetReturnValue().Set(value);
 }
 
-static void ELDHistogramMax(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename HistogramT>
+static void HistogramMax(const FunctionCallbackInfo<Value>& args) {
+  HistogramT* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   double value = static_cast<double>(histogram->Max());
   args.GetReturnValue().Set(value);
 }
 
-static void ELDHistogramMean(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename HistogramT>
+static void HistogramMean(const FunctionCallbackInfo<Value>& args) {
+  HistogramT* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   args.GetReturnValue().Set(histogram->Mean());
 }
@@ -425,23 +630,26 @@ static void ELDHistogramExceeds(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(value);
 }
 
-static void ELDHistogramStddev(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename HistogramT>
+static void HistogramStddev(const FunctionCallbackInfo<Value>& args) {
+  HistogramT* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   args.GetReturnValue().Set(histogram->Stddev());
 }
 
-static void ELDHistogramPercentile(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename HistogramT>
+static void HistogramPercentile(const FunctionCallbackInfo<Value>& args) {
+  HistogramT* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   CHECK(args[0]->IsNumber());
   double percentile = args[0].As<Number>()->Value();
   args.GetReturnValue().Set(histogram->Percentile(percentile));
 }
 
-static void ELDHistogramPercentiles(const FunctionCallbackInfo<Value>& args) {
+template <typename HistogramT>
+static void HistogramPercentiles(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
-  ELDHistogram* histogram;
+  HistogramT* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   CHECK(args[0]->IsMap());
   Local<Map> map = args[0].As<Map>();
@@ -477,6 +685,193 @@ static void ELDHistogramNew(const FunctionCallbackInfo<Value>& args) {
   CHECK_GT(resolution, 0);
   new ELDHistogram(env, args.This(), resolution);
 }
+
+static void ThreadPoolHistogramEnable(
+    const FunctionCallbackInfo<Value>& args) {
+  ThreadPoolHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  args.GetReturnValue().Set(histogram->Enable());
+}
+
+static void ThreadPoolHistogramDisable(
+    const FunctionCallbackInfo<Value>& args) {
+  ThreadPoolHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  args.GetReturnValue().Set(histogram->Disable());
+}
+
+static void ThreadPoolHistogramReset(const FunctionCallbackInfo<Value>& args) {
+  ThreadPoolHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  histogram->Reset();
+}
+
+static void LoopPhaseHistogramEnable(const FunctionCallbackInfo<Value>& args) {
+  LoopPhaseHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  args.GetReturnValue().Set(histogram->Enable());
+}
+
+static void LoopPhaseHistogramDisable(
+    const FunctionCallbackInfo<Value>& args) {
+  LoopPhaseHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  args.GetReturnValue().Set(histogram->Disable());
+}
+
+static void LoopPhaseHistogramReset(const FunctionCallbackInfo<Value>& args) {
+  LoopPhaseHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  histogram->Reset();
+}
+
+static void LoopPhaseHistogramNew(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsUint32());
+  uint32_t phase = args[0].As<Uint32>()->Value();
+  CHECK_LT(phase, NODE_LOOP_PHASE_INVALID);
+  new LoopPhaseHistogram(env, args.This(), static_cast<LoopPhase>(phase));
+}
+
+static void ThreadPoolHistogramNew(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsUint32());
+  CHECK(args[1]->IsUint32());
+  uint32_t kind = args[0].As<Uint32>()->Value();
+  uint32_t phase = args[1].As<Uint32>()->Value();
+  CHECK_LT(kind, NODE_THREADPOOL_WORK_KIND_INVALID);
+  CHECK_LE(phase, NODE_THREADPOOL_WORK_RUN);
+  new ThreadPoolHistogram(env,
+                          args.This(),
+                          static_cast<ThreadPoolWorkKind>(kind),
+                          static_cast<ThreadPoolWorkPhase>(phase));
+}
+
+static void RecordableHistogramExceeds(
+    const FunctionCallbackInfo<Value>& args) {
+  RecordableHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  double value = static_cast<double>(histogram->Exceeds());
+  args.GetReturnValue().Set(value);
+}
+
+static void RecordableHistogramCount(const FunctionCallbackInfo<Value>& args) {
+  RecordableHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  double value = static_cast<double>(histogram->Count());
+  args.GetReturnValue().Set(value);
+}
+
+static void RecordableHistogramPercentile(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  RecordableHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  if (!args[0]->IsNumber()) {
+    return THROW_ERR_INVALID_ARG_TYPE(
+        env, "The \"percentile\" argument must be of type number");
+  }
+  double percentile = args[0].As<Number>()->Value();
+  if (!(percentile > 0 && percentile <= 100)) {
+    return THROW_ERR_OUT_OF_RANGE(
+        env, "The \"percentile\" argument must be > 0 and <= 100");
+  }
+  args.GetReturnValue().Set(histogram->Percentile(percentile));
+}
+
+static void RecordableHistogramPercentiles(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  RecordableHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  Local<Map> map = Map::New(env->isolate());
+  histogram->Percentiles([&](double key, double value) {
+    map->Set(env->context(),
+             Number::New(env->isolate(), key),
+             Number::New(env->isolate(), value)).IsEmpty();
+  });
+  args.GetReturnValue().Set(map);
+}
+
+// This is called for every value, so it only checks its argument and does
+// not allocate anything.
+static void RecordableHistogramRecord(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  RecordableHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  int64_t value;
+  if (args[0]->IsNumber()) {
+    double number = args[0].As<Number>()->Value();
+    if (!(number >= 1 && number <= kMaxSafeJsInteger) ||
+        number != static_cast<double>(static_cast<int64_t>(number))) {
+      return THROW_ERR_OUT_OF_RANGE(
+          env, "The \"value\" argument must be an integer >= 1");
+    }
+    value = static_cast<int64_t>(number);
+  } else if (args[0]->IsBigInt()) {
+    bool lossless;
+    value = args[0].As<BigInt>()->Int64Value(&lossless);
+    if (!lossless || value < 1) {
+      return THROW_ERR_OUT_OF_RANGE(
+          env, "The \"value\" argument must be an integer >= 1");
+    }
+  } else {
+    return THROW_ERR_INVALID_ARG_TYPE(
+        env, "The \"value\" argument must be of type number or bigint");
+  }
+  if (!histogram->Record(value))
+    histogram->Exceed();
+}
+
+static void RecordableHistogramRecordDelta(
+    const FunctionCallbackInfo<Value>& args) {
+  RecordableHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  histogram->RecordDelta();
+}
+
+static void RecordableHistogramAdd(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  RecordableHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  if (!GetRecordableHistogramConstructorTemplate(env)->HasInstance(args[0])) {
+    return THROW_ERR_INVALID_ARG_TYPE(
+        env, "The \"other\" argument must be an instance of "
+             "RecordableHistogram");
+  }
+  RecordableHistogram* other;
+  ASSIGN_OR_RETURN_UNWRAP(&other, args[0].As<Object>());
+  histogram->Add(*other);
+}
+
+static void RecordableHistogramReset(const FunctionCallbackInfo<Value>& args) {
+  RecordableHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  histogram->ResetState();
+}
+
+static bool IsValidHistogramRange(int64_t lowest,
+                                  int64_t highest,
+                                  int64_t figures) {
+  return lowest >= 1 && lowest <= highest / 2 &&
+         figures >= 1 && figures <= 5;
+}
+
+static void RecordableHistogramNew(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  // perf_hooks.createHistogram() validates the range before calling this.
+  if (!args[0]->IsNumber() || !args[1]->IsNumber() || !args[2]->IsNumber())
+    return THROW_ERR_CONSTRUCT_CALL_INVALID(env);
+  int64_t lowest = static_cast<int64_t>(args[0].As<Number>()->Value());
+  int64_t highest = static_cast<int64_t>(args[1].As<Number>()->Value());
+  int64_t figures = static_cast<int64_t>(args[2].As<Number>()->Value());
+  if (!IsValidHistogramRange(lowest, highest, figures))
+    return THROW_ERR_CONSTRUCT_CALL_INVALID(env);
+  new RecordableHistogram(env, args.This(), lowest, highest, figures);
+}
 }  // namespace
 
 ELDHistogram::ELDHistogram(
@@ -547,6 +942,333 @@ bool ELDHistogram::Disable() {
   return true;
 }
 
+ThreadPoolHistogram::ThreadPoolHistogram(
+    Environment* env,
+    Local<Object> wrap,
+    ThreadPoolWorkKind kind,
+    ThreadPoolWorkPhase phase) : BaseObject(env, wrap),
+                                 Histogram(1, 3.6e12),
+                                 kind_(kind),
+                                 phase_(phase) {
+  MakeWeak();
+}
+
+ThreadPoolHistogram::~ThreadPoolHistogram() {
+  Disable();
+}
+
+bool ThreadPoolHistogram::Enable() {
+  if (enabled_) return false;
+  enabled_ = true;
+  performance_state* state = env()->performance_state();
+  state->threadpool_histograms[kind_].push_back(this);
+  state->threadpool_histogram_count++;
+  return true;
+}
+
+bool ThreadPoolHistogram::Disable() {
+  if (!enabled_) return false;
+  enabled_ = false;
+  performance_state* state = env()->performance_state();
+  std::vector<ThreadPoolHistogram*>& histograms =
+      state->threadpool_histograms[kind_];
+  histograms.erase(std::remove(histograms.begin(), histograms.end(), this),
+                   histograms.end());
+  state->threadpool_histogram_count--;
+  return true;
+}
+
+void performance_state::RecordThreadPoolWork(enum ThreadPoolWorkKind kind,
+                                             uint64_t queued,
+                                             uint64_t started,
+                                             uint64_t finished) {
+  for (ThreadPoolHistogram* histogram : threadpool_histograms[kind]) {
+    int64_t delta;
+    if (histogram->phase() == NODE_THREADPOOL_WORK_WAIT) {
+      if (started == 0) continue;
+      delta = started - queued;
+    } else {
+      delta = finished - (started == 0 ? queued : started);
+    }
+    // The histogram cannot record 0, which is what a short run time may
+    // round to on coarse clocks.
+    histogram->Record(std::max<int64_t>(delta, 1));
+  }
+}
+
+LoopPhaseHistogram::LoopPhaseHistogram(
+    Environment* env,
+    Local<Object> wrap,
+    LoopPhase phase) : BaseObject(env, wrap),
+                       Histogram(1, 3.6e12),
+                       phase_(phase) {
+  MakeWeak();
+}
+
+LoopPhaseHistogram::~LoopPhaseHistogram() {
+  Disable();
+}
+
+bool LoopPhaseHistogram::Enable() {
+  if (enabled_) return false;
+  enabled_ = true;
+  performance_state* state = env()->performance_state();
+  state->loop_phase_histograms[phase_].push_back(this);
+  state->loop_phase_histogram_count++;
+  return true;
+}
+
+bool LoopPhaseHistogram::Disable() {
+  if (!enabled_) return false;
+  enabled_ = false;
+  performance_state* state = env()->performance_state();
+  std::vector<LoopPhaseHistogram*>& histograms =
+      state->loop_phase_histograms[phase_];
+  histograms.erase(std::remove(histograms.begin(), histograms.end(), this),
+                   histograms.end());
+  state->loop_phase_histogram_count--;
+  return true;
+}
+
+RecordableHistogram::RecordableHistogram(
+    Environment* env,
+    Local<Object> wrap,
+    int64_t lowest,
+    int64_t highest,
+    int figures) : BaseObject(env, wrap),
+                   Histogram(lowest, highest, figures) {
+  MakeWeak();
+}
+
+void RecordableHistogram::RecordDelta() {
+  uint64_t time = uv_hrtime();
+  if (prev_ > 0) {
+    int64_t delta = time - prev_;
+    if (delta > 0 && !Record(delta))
+      Exceed();
+  }
+  prev_ = time;
+}
+
+void RecordableHistogram::Add(const RecordableHistogram& other) {
+  Exceed(Histogram::Add(other) + other.Exceeds());
+}
+
+// The format is the range of the histogram, the number of exceeding values,
+// and then pairs of a value and how often it was recorded, up to a value of 0.
+void RecordableHistogram::Serialize(ValueSerializer* serializer) const {
+  serializer->WriteUint64(lowest());
+  serializer->WriteUint64(highest());
+  serializer->WriteUint32(figures());
+  serializer->WriteUint64(exceeds_);
+  RecordedValues([&](int64_t value, int64_t count) {
+    serializer->WriteUint64(value);
+    serializer->WriteUint64(count);
+  });
+  serializer->WriteUint64(0);
+}
+
+MaybeLocal<Object> RecordableHistogram::Deserialize(
+    Environment* env, ValueDeserializer* deserializer) {
+  uint64_t lowest, highest, exceeds;
+  uint32_t figures;
+  if (!deserializer->ReadUint64(&lowest) ||
+      !deserializer->ReadUint64(&highest) ||
+      !deserializer->ReadUint32(&figures) ||
+      !deserializer->ReadUint64(&exceeds) ||
+      !IsValidHistogramRange(lowest, highest, figures)) {
+    return MaybeLocal<Object>();
+  }
+
+  Local<Object> obj;
+  if (!GetRecordableHistogramConstructorTemplate(env)
+           ->InstanceTemplate()
+           ->NewInstance(env->context())
+           .ToLocal(&obj)) {
+    return MaybeLocal<Object>();
+  }
+  RecordableHistogram* histogram =
+      new RecordableHistogram(env, obj, lowest, highest, figures);
+  histogram->Exceed(exceeds);
+  for (;;) {
+    uint64_t value, count;
+    if (!deserializer->ReadUint64(&value))
+      return MaybeLocal<Object>();
+    if (value == 0)
+      break;
+    if (!deserializer->ReadUint64(&count))
+      return MaybeLocal<Object>();
+    if (!histogram->RecordValues(value, count))
+      histogram->Exceed(count);
+  }
+  return obj;
+}
+
+Local<FunctionTemplate> GetRecordableHistogramConstructorTemplate(
+    Environment* env) {
+  Local<FunctionTemplate> tmpl =
+      env->recordable_histogram_constructor_template();
+  if (!tmpl.IsEmpty())
+    return tmpl;
+
+  Isolate* isolate = env->isolate();
+  tmpl = env->NewFunctionTemplate(RecordableHistogramNew);
+  tmpl->SetClassName(FIXED_ONE_BYTE_STRING(isolate, "RecordableHistogram"));
+  tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+  Local<v8::Signature> signature = v8::Signature::New(isolate, tmpl);
+  auto set_getter = [&](const char* name, v8::FunctionCallback callback) {
+    tmpl->PrototypeTemplate()->SetAccessorProperty(
+        OneByteString(isolate, name),
+        FunctionTemplate::New(isolate, callback, Local<Value>(), signature),
+        Local<FunctionTemplate>(),
+        ReadOnly);
+  };
+  set_getter("count", RecordableHistogramCount);
+  set_getter("exceeds", RecordableHistogramExceeds);
+  set_getter("min", HistogramMin<RecordableHistogram>);
+  set_getter("max", HistogramMax<RecordableHistogram>);
+  set_getter("mean", HistogramMean<RecordableHistogram>);
+  set_getter("stddev", HistogramStddev<RecordableHistogram>);
+  set_getter("percentiles", RecordableHistogramPercentiles);
+  env->SetProtoMethod(tmpl, "percentile", RecordableHistogramPercentile);
+  env->SetProtoMethod(tmpl, "record", RecordableHistogramRecord);
+  env->SetProtoMethod(tmpl, "recordDelta", RecordableHistogramRecordDelta);
+  env->SetProtoMethod(tmpl, "add", RecordableHistogramAdd);
+  env->SetProtoMethod(tmpl, "reset", RecordableHistogramReset);
+  env->set_recordable_histogram_constructor_template(tmpl);
+  return tmpl;
+}
+
+void performance_state::RecordLoopPhase(enum LoopPhase phase,
+                                        uint64_t duration) {
+  for (LoopPhaseHistogram* histogram : loop_phase_histograms[phase])
+    histogram->Record(std::max<int64_t>(duration, 1));
+}
+
+void performance_state::MarkLoopPollStart() {
+  loop_poll_start = loop_idle_start = PERFORMANCE_NOW();
+  loop_idle_time_at_poll_start = loop_idle_time;
+}
+
+void performance_state::MarkLoopPollEnd() {
+  if (loop_poll_start == 0) return;
+  uint64_t now = PERFORMANCE_NOW();
+  if (loop_idle_start != 0)
+    EndLoopIdle(now);
+  if (loop_phases_monitored()) {
+    RecordLoopPhase(NODE_LOOP_PHASE_POLL,
+                    now - loop_poll_start -
+                        (loop_idle_time - loop_idle_time_at_poll_start));
+  }
+  loop_poll_start = 0;
+}
+
+void performance_state::EndLoopIdle(uint64_t now) {
+  loop_idle_time += now - loop_idle_start;
+  loop_idle_start = 0;
+}
+
+// Returns the time that the event loop has been idle, in milliseconds.
+static void LoopIdleTime(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  double idle_time = env->performance_state()->loop_idle_time / 1e6;
+  args.GetReturnValue().Set(idle_time);
+}
+
+// Hardware counters of the calling thread that the benchmark harness reads
+// around each measured run. They are opened as one group, so that a single
+// read() returns all of them for the same interval.
+#ifdef __linux__
+static const uint64_t kCpuCounters[] = {
+  PERF_COUNT_HW_INSTRUCTIONS,
+  PERF_COUNT_HW_CACHE_MISSES,
+  PERF_COUNT_HW_BRANCH_MISSES
+};
+
+static int OpenCpuCounter(uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  int fd = syscall(__NR_perf_event_open, &attr, 0, -1, group_fd,
+                   PERF_FLAG_FD_CLOEXEC);
+  return fd == -1 ? -errno : fd;
+}
+
+static void CloseCpuCounterFds(const int* fds, size_t count) {
+  for (size_t i = 0; i < count; i++)
+    close(fds[i]);
+}
+#endif  // __linux__
+
+// Returns an array with the file descriptors of the counter group, or a
+// negative error code if the counters are not available.
+static void OpenCpuCounters(const FunctionCallbackInfo<Value>& args) {
+#ifdef __linux__
+  Environment* env = Environment::GetCurrent(args);
+  int fds[arraysize(kCpuCounters)];
+  Local<Value> values[arraysize(kCpuCounters)];
+  for (size_t i = 0; i < arraysize(kCpuCounters); i++) {
+    fds[i] = OpenCpuCounter(kCpuCounters[i], i == 0 ? -1 : fds[0]);
+    if (fds[i] < 0) {
+      int err = fds[i];
+      CloseCpuCounterFds(fds, i);
+      return args.GetReturnValue().Set(err);
+    }
+    values[i] = Integer::New(env->isolate(), fds[i]);
+  }
+  args.GetReturnValue().Set(
+      Array::New(env->isolate(), values, arraysize(values)));
+#else
+  args.GetReturnValue().Set(UV_ENOSYS);
+#endif
+}
+
+// Reads the counter group led by args[0] into the Float64Array args[1].
+// Returns 0 or a negative error code.
+static void ReadCpuCounters(const FunctionCallbackInfo<Value>& args) {
+#ifdef __linux__
+  CHECK(args[0]->IsInt32());
+  CHECK(args[1]->IsFloat64Array());
+  Local<Float64Array> out = args[1].As<Float64Array>();
+  CHECK_EQ(out->Length(), arraysize(kCpuCounters));
+  // With PERF_FORMAT_GROUP, the number of counters precedes their values.
+  uint64_t data[1 + arraysize(kCpuCounters)];
+  ssize_t size;
+  do {
+    size = read(args[0].As<Int32>()->Value(), data, sizeof(data));
+  } while (size == -1 && errno == EINTR);
+  if (size == -1)
+    return args.GetReturnValue().Set(-errno);
+  CHECK_EQ(size, sizeof(data));
+  CHECK_EQ(data[0], arraysize(kCpuCounters));
+  double* values = static_cast<double*>(out->Buffer()->GetContents().Data()) +
+                   out->ByteOffset() / sizeof(double);
+  for (size_t i = 0; i < arraysize(kCpuCounters); i++)
+    values[i] = static_cast<double>(data[i + 1]);
+  args.GetReturnValue().Set(0);
+#else
+  args.GetReturnValue().Set(UV_ENOSYS);
+#endif
+}
+
+static void CloseCpuCounters(const FunctionCallbackInfo<Value>& args) {
+#ifdef __linux__
+  CHECK(args[0]->IsArray());
+  Environment* env = Environment::GetCurrent(args);
+  Local<Array> fds = args[0].As<Array>();
+  for (uint32_t i = 0; i < fds->Length(); i++) {
+    Local<Value> fd = fds->Get(env->context(), i).ToLocalChecked();
+    CHECK(fd->IsInt32());
+    close(fd.As<Int32>()->Value());
+  }
+#endif
+}
+
 void Initialize(Local<Object> target,
                 Local<Value> unused,
                 Local<Context> context,
@@ -561,6 +1283,22 @@ void Initialize(Local<Object> target,
   target->Set(context,
               FIXED_ONE_BYTE_STRING(isolate, "milestones"),
               state->milestones.GetJSArray()).Check();
+  target->Set(context,
+              FIXED_ONE_BYTE_STRING(isolate, "phases"),
+              state->phases.GetJSArray()).Check();
+  target->Set(context,
+              FIXED_ONE_BYTE_STRING(isolate, "gcTotals"),
+              state->gc_totals.GetJSArray()).Check();
+
+  Local<Value> phase_names[] = {
+#define V(_, label) FIXED_ONE_BYTE_STRING(isolate, label),
+    NODE_PERFORMANCE_PHASES(V)
+#undef V
+  };
+  target->Set(context,
+              FIXED_ONE_BYTE_STRING(isolate, "phaseNames"),
+              Array::New(isolate, phase_names, arraysize(phase_names)))
+      .Check();
 
   Local<String> performanceEntryString =
       FIXED_ONE_BYTE_STRING(isolate, "PerformanceEntry");
@@ -584,6 +1322,10 @@ void Initialize(Local<Object> target,
                  "removeGarbageCollectionTracking",
                  RemoveGarbageCollectionTracking);
   env->SetMethod(target, "notify", Notify);
+  env->SetMethod(target, "loopIdleTime", LoopIdleTime);
+  env->SetMethod(target, "openCpuCounters", OpenCpuCounters);
+  env->SetMethod(target, "readCpuCounters", ReadCpuCounters);
+  env->SetMethod(target, "closeCpuCounters", CloseCpuCounters);
 
   Local<Object> constants = Object::New(isolate);
 
@@ -617,6 +1359,30 @@ void Initialize(Local<Object> target,
   NODE_PERFORMANCE_MILESTONES(V)
 #undef V
 
+#define V(name, _)                                                            \
+  NODE_DEFINE_HIDDEN_CONSTANT(constants, NODE_THREADPOOL_WORK_KIND_##name);
+  NODE_THREADPOOL_WORK_KINDS(V)
+#undef V
+
+  NODE_DEFINE_HIDDEN_CONSTANT(constants, NODE_THREADPOOL_WORK_WAIT);
+  NODE_DEFINE_HIDDEN_CONSTANT(constants, NODE_THREADPOOL_WORK_RUN);
+
+#define V(name, _)                                                            \
+  NODE_DEFINE_HIDDEN_CONSTANT(constants, NODE_LOOP_PHASE_##name);
+  NODE_LOOP_PHASES(V)
+#undef V
+
+#define V(name, _)                                                            \
+  NODE_DEFINE_HIDDEN_CONSTANT(constants, NODE_GC_TOTALS_KIND_##name);
+  NODE_GC_TOTALS_KINDS(V)
+#undef V
+
+#define V(name, _)                                                            \
+  NODE_DEFINE_HIDDEN_CONSTANT(constants, NODE_GC_TOTALS_FIELD_##name);
+  NODE_GC_TOTALS_FIELDS(V)
+#undef V
+  NODE_DEFINE_HIDDEN_CONSTANT(constants, NODE_GC_TOTALS_FIELD_INVALID);
+
   PropertyAttribute attr =
       static_cast<PropertyAttribute>(ReadOnly | DontDelete);
 
@@ -642,17 +1408,66 @@ void Initialize(Local<Object> target,
   eldh->SetClassName(eldh_classname);
   eldh->InstanceTemplate()->SetInternalFieldCount(1);
   env->SetProtoMethod(eldh, "exceeds", ELDHistogramExceeds);
-  env->SetProtoMethod(eldh, "min", ELDHistogramMin);
-  env->SetProtoMethod(eldh, "max", ELDHistogramMax);
-  env->SetProtoMethod(eldh, "mean", ELDHistogramMean);
-  env->SetProtoMethod(eldh, "stddev", ELDHistogramStddev);
-  env->SetProtoMethod(eldh, "percentile", ELDHistogramPercentile);
-  env->SetProtoMethod(eldh, "percentiles", ELDHistogramPercentiles);
+  env->SetProtoMethod(eldh, "min", HistogramMin<ELDHistogram>);
+  env->SetProtoMethod(eldh, "max", HistogramMax<ELDHistogram>);
+  env->SetProtoMethod(eldh, "mean", HistogramMean<ELDHistogram>);
+  env->SetProtoMethod(eldh, "stddev", HistogramStddev<ELDHistogram>);
+  env->SetProtoMethod(eldh, "percentile", HistogramPercentile<ELDHistogram>);
+  env->SetProtoMethod(eldh, "percentiles", HistogramPercentiles<ELDHistogram>);
   env->SetProtoMethod(eldh, "enable", ELDHistogramEnable);
   env->SetProtoMethod(eldh, "disable", ELDHistogramDisable);
   env->SetProtoMethod(eldh, "reset", ELDHistogramReset);
   target->Set(context, eldh_classname,
               eldh->GetFunction(env->context()).ToLocalChecked()).Check();
+
+  Local<String> tph_classname =
+      FIXED_ONE_BYTE_STRING(isolate, "ThreadPoolHistogram");
+  Local<FunctionTemplate> tph =
+      env->NewFunctionTemplate(ThreadPoolHistogramNew);
+  tph->SetClassName(tph_classname);
+  tph->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(tph, "min", HistogramMin<ThreadPoolHistogram>);
+  env->SetProtoMethod(tph, "max", HistogramMax<ThreadPoolHistogram>);
+  env->SetProtoMethod(tph, "mean", HistogramMean<ThreadPoolHistogram>);
+  env->SetProtoMethod(tph, "stddev", HistogramStddev<ThreadPoolHistogram>);
+  env->SetProtoMethod(tph,
+                      "percentile",
+                      HistogramPercentile<ThreadPoolHistogram>);
+  env->SetProtoMethod(tph,
+                      "percentiles",
+                      HistogramPercentiles<ThreadPoolHistogram>);
+  env->SetProtoMethod(tph, "enable", ThreadPoolHistogramEnable);
+  env->SetProtoMethod(tph, "disable", ThreadPoolHistogramDisable);
+  env->SetProtoMethod(tph, "reset", ThreadPoolHistogramReset);
+  target->Set(context, tph_classname,
+              tph->GetFunction(env->context()).ToLocalChecked()).Check();
+
+  Local<String> lph_classname =
+      FIXED_ONE_BYTE_STRING(isolate, "LoopPhaseHistogram");
+  Local<FunctionTemplate> lph =
+      env->NewFunctionTemplate(LoopPhaseHistogramNew);
+  lph->SetClassName(lph_classname);
+  lph->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(lph, "min", HistogramMin<LoopPhaseHistogram>);
+  env->SetProtoMethod(lph, "max", HistogramMax<LoopPhaseHistogram>);
+  env->SetProtoMethod(lph, "mean", HistogramMean<LoopPhaseHistogram>);
+  env->SetProtoMethod(lph, "stddev", HistogramStddev<LoopPhaseHistogram>);
+  env->SetProtoMethod(lph,
+                      "percentile",
+                      HistogramPercentile<LoopPhaseHistogram>);
+  env->SetProtoMethod(lph,
+                      "percentiles",
+                      HistogramPercentiles<LoopPhaseHistogram>);
+  env->SetProtoMethod(lph, "enable", LoopPhaseHistogramEnable);
+  env->SetProtoMethod(lph, "disable", LoopPhaseHistogramDisable);
+  env->SetProtoMethod(lph, "reset", LoopPhaseHistogramReset);
+  target->Set(context, lph_classname,
+              lph->GetFunction(env->context()).ToLocalChecked()).Check();
+
+  target->Set(context,
+              FIXED_ONE_BYTE_STRING(isolate, "RecordableHistogram"),
+              GetRecordableHistogramConstructorTemplate(env)
+                  ->GetFunction(env->context()).ToLocalChecked()).Check();
 }
 
 }  // namespace performance
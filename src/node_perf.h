@@ -12,6 +12,7 @@
 #include "uv.h"
 
 #include <string>
+#include <vector>
 
 namespace node {
 
@@ -39,6 +40,17 @@ static inline const char* GetPerformanceMilestoneName(
   }
 }
 
+static inline const char* GetPerformancePhaseName(
+    enum PerformancePhase phase) {
+  switch (phase) {
+#define V(name, label) case NODE_PERFORMANCE_PHASE_##name: return label;
+  NODE_PERFORMANCE_PHASES(V)
+#undef V
+    default:
+      UNREACHABLE();
+  }
+}
+
 static inline PerformanceMilestone ToPerformanceMilestoneEnum(const char* str) {
 #define V(name, label)                                                        \
   if (strcmp(str, label) == 0) return NODE_PERFORMANCE_MILESTONE_##name;
@@ -128,23 +140,44 @@ enum PerformanceGCFlags {
     GCCallbackFlags::kGCCallbackScheduleIdleGarbageCollection
 };
 
+// The used size of a heap space before and after a garbage collection.
+struct GCHeapSpaceUsage {
+  const char* name;
+  size_t before;
+  size_t after;
+};
+
 class GCPerformanceEntry : public PerformanceEntry {
  public:
   GCPerformanceEntry(Environment* env,
                      PerformanceGCKind gckind,
                      PerformanceGCFlags gcflags,
                      uint64_t startTime,
-                     uint64_t endTime) :
+                     uint64_t endTime,
+                     bool incremental,
+                     size_t promoted,
+                     std::vector<GCHeapSpaceUsage>&& spaces) :
                          PerformanceEntry(env, "gc", "gc", startTime, endTime),
                          gckind_(gckind),
-                         gcflags_(gcflags) { }
+                         gcflags_(gcflags),
+                         incremental_(incremental),
+                         promoted_(promoted),
+                         spaces_(std::move(spaces)) { }
 
   PerformanceGCKind gckind() const { return gckind_; }
   PerformanceGCFlags gcflags() const { return gcflags_; }
+  // Whether the collection used incremental marking.
+  bool incremental() const { return incremental_; }
+  // The bytes that a scavenge moved into the old generation.
+  size_t promoted() const { return promoted_; }
+  const std::vector<GCHeapSpaceUsage>& spaces() const { return spaces_; }
 
  private:
   PerformanceGCKind gckind_;
   PerformanceGCFlags gcflags_;
+  bool incremental_;
+  size_t promoted_;
+  std::vector<GCHeapSpaceUsage> spaces_;
 };
 
 class ELDHistogram : public HandleWrap, public Histogram {
@@ -180,6 +213,102 @@ class ELDHistogram : public HandleWrap, public Histogram {
   uv_timer_t timer_;
 };
 
+// Records how long threadpool work of one kind waits in the queue or takes
+// to run, see performance_state::RecordThreadPoolWork().
+class ThreadPoolHistogram : public BaseObject, public Histogram {
+ public:
+  ThreadPoolHistogram(Environment* env,
+                      Local<Object> wrap,
+                      ThreadPoolWorkKind kind,
+                      ThreadPoolWorkPhase phase);
+  ~ThreadPoolHistogram() override;
+
+  bool Enable();
+  bool Disable();
+  ThreadPoolWorkPhase phase() const { return phase_; }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("histogram", GetMemorySize());
+  }
+
+  SET_MEMORY_INFO_NAME(ThreadPoolHistogram)
+  SET_SELF_SIZE(ThreadPoolHistogram)
+
+ private:
+  bool enabled_ = false;
+  ThreadPoolWorkKind kind_;
+  ThreadPoolWorkPhase phase_;
+};
+
+// Records how long one event loop phase takes in each loop iteration, see
+// performance_state::RecordLoopPhase().
+class LoopPhaseHistogram : public BaseObject, public Histogram {
+ public:
+  LoopPhaseHistogram(Environment* env,
+                     Local<Object> wrap,
+                     LoopPhase phase);
+  ~LoopPhaseHistogram() override;
+
+  bool Enable();
+  bool Disable();
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("histogram", GetMemorySize());
+  }
+
+  SET_MEMORY_INFO_NAME(LoopPhaseHistogram)
+  SET_SELF_SIZE(LoopPhaseHistogram)
+
+ private:
+  bool enabled_ = false;
+  LoopPhase phase_;
+};
+
+// A histogram that is created and fed from JS with
+// `perf_hooks.createHistogram()`. Unlike the other histograms, the JS object
+// is this BaseObject itself, so that it can be cloned into a message to
+// another thread.
+class RecordableHistogram : public BaseObject, public Histogram {
+ public:
+  RecordableHistogram(Environment* env,
+                      Local<Object> wrap,
+                      int64_t lowest,
+                      int64_t highest,
+                      int figures);
+
+  void RecordDelta();
+  // Adds the values of `other`, and counts those that are out of range for
+  // this histogram as exceeding it.
+  void Add(const RecordableHistogram& other);
+  void ResetState() {
+    Reset();
+    exceeds_ = 0;
+    prev_ = 0;
+  }
+  void Exceed(int64_t count = 1) { exceeds_ += count; }
+  int64_t Exceeds() const { return exceeds_; }
+
+  // Writes the recorded values into a message, and creates a new histogram
+  // with the same values from it on the receiving side.
+  void Serialize(v8::ValueSerializer* serializer) const;
+  static v8::MaybeLocal<Object> Deserialize(
+      Environment* env, v8::ValueDeserializer* deserializer);
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("histogram", GetMemorySize());
+  }
+
+  SET_MEMORY_INFO_NAME(RecordableHistogram)
+  SET_SELF_SIZE(RecordableHistogram)
+
+ private:
+  int64_t exceeds_ = 0;
+  uint64_t prev_ = 0;
+};
+
+v8::Local<v8::FunctionTemplate> GetRecordableHistogramConstructorTemplate(
+    Environment* env);
+
 }  // namespace performance
 }  // namespace node
 
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace node {
 namespace performance {
@@ -28,6 +29,18 @@ extern uint64_t performance_v8_start;
   V(LOOP_EXIT, "loopExit")                                                    \
   V(BOOTSTRAP_COMPLETE, "bootstrapComplete")
 
+// Startup phases whose start and end are recorded. The first four are
+// process-wide and are copied into the performance state of every
+// Environment, see performance_state::CopyProcessPhases().
+#define NODE_PERFORMANCE_PHASES(V)                                            \
+  V(OPTION_PARSING, "optionParsing")                                          \
+  V(ICU_INIT, "icuInit")                                                      \
+  V(V8_PLATFORM_INIT, "v8PlatformInit")                                       \
+  V(OPENSSL_INIT, "opensslInit")                                              \
+  V(BOOTSTRAP_LOADERS, "bootstrapLoaders")                                    \
+  V(BOOTSTRAP_NODE, "bootstrapNode")                                          \
+  V(PRE_EXECUTION, "preExecution")                                            \
+  V(RUN_MAIN, "runMain")
 
 #define NODE_PERFORMANCE_ENTRY_TYPES(V)                                       \
   V(NODE, "node")                                                             \
@@ -38,6 +51,39 @@ extern uint64_t performance_v8_start;
   V(HTTP2, "http2")                                                           \
   V(HTTP, "http")
 
+#define NODE_THREADPOOL_WORK_KINDS(V)                                         \
+  V(FS, "fs")                                                                 \
+  V(DNS, "dns")                                                               \
+  V(ZLIB, "zlib")                                                             \
+  V(CRYPTO, "crypto")                                                         \
+  V(KDF, "kdf")                                                               \
+  V(NAPI, "napi")
+
+// Event loop phases whose duration perf_hooks.monitorEventLoopPhases() can
+// record. `timers` and `check` are the time spent running timers and
+// immediates, `poll` is the time spent in the poll phase other than waiting
+// for events.
+#define NODE_LOOP_PHASES(V)                                                   \
+  V(TIMERS, "timers")                                                         \
+  V(POLL, "poll")                                                             \
+  V(CHECK, "check")
+
+// Kinds of garbage collection that perf_hooks.monitorGarbageCollection()
+// keeps totals for.
+#define NODE_GC_TOTALS_KINDS(V)                                               \
+  V(MINOR, "minor")                                                           \
+  V(MAJOR, "major")                                                           \
+  V(INCREMENTAL, "incremental")                                               \
+  V(WEAKCB, "weakcb")
+
+// The totals that are kept for each kind of garbage collection. The duration
+// is in milliseconds, the others are in bytes.
+#define NODE_GC_TOTALS_FIELDS(V)                                              \
+  V(COUNT, "count")                                                           \
+  V(DURATION, "duration")                                                     \
+  V(COLLECTED, "collected")                                                   \
+  V(PROMOTED, "promoted")
+
 enum PerformanceMilestone {
 #define V(name, _) NODE_PERFORMANCE_MILESTONE_##name,
   NODE_PERFORMANCE_MILESTONES(V)
@@ -45,6 +91,18 @@ enum PerformanceMilestone {
   NODE_PERFORMANCE_MILESTONE_INVALID
 };
 
+enum PerformancePhase {
+#define V(name, _) NODE_PERFORMANCE_PHASE_##name,
+  NODE_PERFORMANCE_PHASES(V)
+#undef V
+  NODE_PERFORMANCE_PHASE_INVALID
+};
+
+// Records a process-wide phase that does not belong to an Environment.
+void MarkProcessPhase(enum PerformancePhase phase,
+                      uint64_t start,
+                      uint64_t end = PERFORMANCE_NOW());
+
 enum PerformanceEntryType {
 #define V(name, _) NODE_PERFORMANCE_ENTRY_TYPE_##name,
   NODE_PERFORMANCE_ENTRY_TYPES(V)
@@ -52,6 +110,42 @@ enum PerformanceEntryType {
   NODE_PERFORMANCE_ENTRY_TYPE_INVALID
 };
 
+enum ThreadPoolWorkKind {
+#define V(name, _) NODE_THREADPOOL_WORK_KIND_##name,
+  NODE_THREADPOOL_WORK_KINDS(V)
+#undef V
+  NODE_THREADPOOL_WORK_KIND_INVALID
+};
+
+enum ThreadPoolWorkPhase {
+  NODE_THREADPOOL_WORK_WAIT,
+  NODE_THREADPOOL_WORK_RUN
+};
+
+enum LoopPhase {
+#define V(name, _) NODE_LOOP_PHASE_##name,
+  NODE_LOOP_PHASES(V)
+#undef V
+  NODE_LOOP_PHASE_INVALID
+};
+
+enum GCTotalsKind {
+#define V(name, _) NODE_GC_TOTALS_KIND_##name,
+  NODE_GC_TOTALS_KINDS(V)
+#undef V
+  NODE_GC_TOTALS_KIND_INVALID
+};
+
+enum GCTotalsField {
+#define V(name, _) NODE_GC_TOTALS_FIELD_##name,
+  NODE_GC_TOTALS_FIELDS(V)
+#undef V
+  NODE_GC_TOTALS_FIELD_INVALID
+};
+
+class ThreadPoolHistogram;
+class LoopPhaseHistogram;
+
 class performance_state {
  public:
   explicit performance_state(v8::Isolate* isolate) :
@@ -63,6 +157,16 @@ class performance_state {
       offsetof(performance_state_internal, milestones),
       NODE_PERFORMANCE_MILESTONE_INVALID,
       root),
+    phases(
+      isolate,
+      offsetof(performance_state_internal, phases),
+      NODE_PERFORMANCE_PHASE_INVALID * 2,
+      root),
+    gc_totals(
+      isolate,
+      offsetof(performance_state_internal, gc_totals),
+      NODE_GC_TOTALS_KIND_INVALID * NODE_GC_TOTALS_FIELD_INVALID,
+      root),
     observers(
       isolate,
       offsetof(performance_state_internal, observers),
@@ -70,25 +174,119 @@ class performance_state {
       root) {
     for (size_t i = 0; i < milestones.Length(); i++)
       milestones[i] = -1.;
+    for (size_t i = 0; i < phases.Length(); i++)
+      phases[i] = -1.;
   }
 
   AliasedUint8Array root;
   AliasedFloat64Array milestones;
+  // The start and end of each phase, or -1 if it has not happened.
+  AliasedFloat64Array phases;
+  // The totals of perf_hooks.monitorGarbageCollection(), indexed by
+  // kind * NODE_GC_TOTALS_FIELD_INVALID + field.
+  AliasedFloat64Array gc_totals;
   AliasedUint32Array observers;
 
   uint64_t performance_last_gc_start_mark = 0;
+  // The used size of each heap space when the last GC started. This is only
+  // recorded while gc entries are observed or the totals are kept.
+  std::vector<size_t> gc_space_used_before;
+  // Whether incremental marking has run since the last mark-compact.
+  bool gc_incremental_marking = false;
+  // The number of installGarbageCollectionTracking() calls that have not
+  // been undone yet, and how many of them keep totals.
+  size_t gc_tracking_count = 0;
+  size_t gc_totals_count = 0;
 
   void Mark(enum PerformanceMilestone milestone,
             uint64_t ts = PERFORMANCE_NOW());
 
+  void MarkPhaseStart(enum PerformancePhase phase,
+                      uint64_t ts = PERFORMANCE_NOW());
+  // Does nothing unless the start of the phase has been marked.
+  void MarkPhaseEnd(enum PerformancePhase phase,
+                    uint64_t ts = PERFORMANCE_NOW());
+  // Copies the process-wide phases that have been recorded so far. They are
+  // only traced if `trace` is true, so that they appear once per process.
+  void CopyProcessPhases(bool trace);
+
+  // Whether perf_hooks.monitorThreadpool() histograms are enabled. Callers
+  // only take the timestamps passed to RecordThreadPoolWork() when it is.
+  bool threadpool_monitored() const { return threadpool_histogram_count > 0; }
+
+  // `started` is 0 for work that libuv queues itself, such as fs requests
+  // and DNS lookups, in which case only the run time from `queued` to
+  // `finished` is recorded.
+  void RecordThreadPoolWork(enum ThreadPoolWorkKind kind,
+                            uint64_t queued,
+                            uint64_t started,
+                            uint64_t finished);
+
+  std::vector<ThreadPoolHistogram*>
+      threadpool_histograms[NODE_THREADPOOL_WORK_KIND_INVALID];
+  size_t threadpool_histogram_count = 0;
+
+  // The event loop counts as idle from the start of the poll phase until
+  // the first callback runs, or until the poll phase ends if none does.
+  // These are called from the prepare and check handles of the Environment.
+  void MarkLoopPollStart();
+  void MarkLoopPollEnd();
+  // Called whenever a callback starts, see InternalCallbackScope.
+  inline void MarkLoopIdleEnd() {
+    if (loop_idle_start != 0)
+      EndLoopIdle(PERFORMANCE_NOW());
+  }
+
+  // Whether perf_hooks.monitorEventLoopPhases() histograms are enabled.
+  bool loop_phases_monitored() const { return loop_phase_histogram_count > 0; }
+  void RecordLoopPhase(enum LoopPhase phase, uint64_t duration);
+
+  std::vector<LoopPhaseHistogram*>
+      loop_phase_histograms[NODE_LOOP_PHASE_INVALID];
+  size_t loop_phase_histogram_count = 0;
+
+  // Total time that the event loop has been idle, in nanoseconds.
+  uint64_t loop_idle_time = 0;
+
  private:
+  void EndLoopIdle(uint64_t now);
+
+  uint64_t loop_idle_start = 0;
+  uint64_t loop_poll_start = 0;
+  uint64_t loop_idle_time_at_poll_start = 0;
+
   struct performance_state_internal {
     // doubles first so that they are always sizeof(double)-aligned
     double milestones[NODE_PERFORMANCE_MILESTONE_INVALID];
+    double phases[NODE_PERFORMANCE_PHASE_INVALID * 2];
+    double gc_totals[NODE_GC_TOTALS_KIND_INVALID *
+                     NODE_GC_TOTALS_FIELD_INVALID];
     uint32_t observers[NODE_PERFORMANCE_ENTRY_TYPE_INVALID];
   };
 };
 
+// Records the duration of an event loop phase while the phases are
+// monitored.
+class LoopPhaseScope {
+ public:
+  LoopPhaseScope(performance_state* state, enum LoopPhase phase)
+      : state_(state),
+        phase_(phase),
+        start_(state->loop_phases_monitored() ? PERFORMANCE_NOW() : 0) {}
+  ~LoopPhaseScope() {
+    if (start_ != 0 && state_->loop_phases_monitored())
+      state_->RecordLoopPhase(phase_, PERFORMANCE_NOW() - start_);
+  }
+
+  LoopPhaseScope(const LoopPhaseScope&) = delete;
+  LoopPhaseScope& operator=(const LoopPhaseScope&) = delete;
+
+ private:
+  performance_state* state_;
+  enum LoopPhase phase_;
+  uint64_t start_;
+};
+
 }  // namespace performance
 }  // namespace node
 
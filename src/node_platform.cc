@@ -3,10 +3,15 @@
 
 #include "env-inl.h"
 #include "debug_utils-inl.h"
-#include <algorithm>  // find_if(), find(), move()
+#include <algorithm>  // find_if(), find(), max(), move()
 #include <cmath>  // llround()
 #include <memory>  // unique_ptr(), shared_ptr(), make_shared()
 
+#ifdef __linux__
+#include <pthread.h>  // pthread_setaffinity_np()
+#include <sched.h>  // sched_getaffinity()
+#endif  // __linux__
+
 namespace node {
 
 using v8::Isolate;
@@ -18,20 +23,53 @@ using node::tracing::TracingController;
 namespace {
 
 struct PlatformWorkerData {
-  TaskQueue<Task>* task_queue;
+  WorkerThreadsTaskRunner* runner;
   Mutex* platform_workers_mutex;
   ConditionVariable* platform_workers_ready;
   int* pending_platform_workers;
   int id;
+  bool pin_thread;
 };
 
-static void PlatformWorkerThread(void* data) {
+// The runner and queue index of the current platform worker thread, if any.
+thread_local WorkerThreadsTaskRunner* current_runner = nullptr;
+thread_local size_t current_queue = 0;
+// The priority of tasks posted from the current thread.
+thread_local WorkerTaskPriority current_priority = WorkerTaskPriority::kNormal;
+
+}  // namespace
+
+// Consecutive indices are placed on consecutive CPUs, which usually keeps a
+// pool that is not larger than a NUMA node on one node.
+void PinCurrentThread(int id) {
+#ifdef __linux__
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    return;
+  int n = id % CPU_COUNT(&allowed);
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (!CPU_ISSET(cpu, &allowed) || n-- > 0) continue;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    return;
+  }
+#endif  // __linux__
+}
+
+void WorkerThreadsTaskRunner::PlatformWorkerThread(void* data) {
   std::unique_ptr<PlatformWorkerData>
       worker_data(static_cast<PlatformWorkerData*>(data));
 
-  TaskQueue<Task>* pending_worker_tasks = worker_data->task_queue;
+  WorkerThreadsTaskRunner* runner = worker_data->runner;
+  size_t index = worker_data->id;
   TRACE_EVENT_METADATA1("__metadata", "thread_name", "name",
                         "PlatformWorkerThread");
+  if (worker_data->pin_thread)
+    PinCurrentThread(worker_data->id);
+  current_runner = runner;
+  current_queue = index;
 
   // Notify the main thread that the platform worker is ready.
   {
@@ -40,18 +78,19 @@ static void PlatformWorkerThread(void* data) {
     worker_data->platform_workers_ready->Signal(lock);
   }
 
-  while (std::unique_ptr<Task> task = pending_worker_tasks->BlockingPop()) {
+  WorkerTaskPriority priority;
+  while (std::unique_ptr<Task> task = runner->BlockingPop(index, &priority)) {
+    // Tasks posted by this task inherit its priority.
+    current_priority = priority;
     task->Run();
-    pending_worker_tasks->NotifyOfCompletion();
+    runner->NotifyOfCompletion(priority);
   }
 }
 
-}  // namespace
-
 class WorkerThreadsTaskRunner::DelayedTaskScheduler {
  public:
-  explicit DelayedTaskScheduler(TaskQueue<Task>* tasks)
-    : pending_worker_tasks_(tasks) {}
+  explicit DelayedTaskScheduler(WorkerThreadsTaskRunner* runner)
+    : runner_(runner) {}
 
   std::unique_ptr<uv_thread_t> Start() {
     auto start_thread = [](void* data) {
@@ -65,9 +104,12 @@ class WorkerThreadsTaskRunner::DelayedTaskScheduler {
     return t;
   }
 
-  void PostDelayedTask(std::unique_ptr<Task> task, double delay_in_seconds) {
+  void PostDelayedTask(std::unique_ptr<Task> task,
+                       double delay_in_seconds,
+                       WorkerTaskPriority priority) {
     tasks_.Push(std::unique_ptr<Task>(new ScheduleTask(this, std::move(task),
-                                                       delay_in_seconds)));
+                                                       delay_in_seconds,
+                                                       priority)));
     uv_async_send(&flush_tasks_);
   }
 
@@ -115,20 +157,27 @@ class WorkerThreadsTaskRunner::DelayedTaskScheduler {
      DelayedTaskScheduler* scheduler_;
   };
 
+  struct TimerTask {
+    std::unique_ptr<Task> task;
+    WorkerTaskPriority priority;
+  };
+
   class ScheduleTask : public Task {
    public:
     ScheduleTask(DelayedTaskScheduler* scheduler,
                  std::unique_ptr<Task> task,
-                 double delay_in_seconds)
+                 double delay_in_seconds,
+                 WorkerTaskPriority priority)
       : scheduler_(scheduler),
         task_(std::move(task)),
-        delay_in_seconds_(delay_in_seconds) {}
+        delay_in_seconds_(delay_in_seconds),
+        priority_(priority) {}
 
     void Run() override {
       uint64_t delay_millis = llround(delay_in_seconds_ * 1000);
       std::unique_ptr<uv_timer_t> timer(new uv_timer_t());
       CHECK_EQ(0, uv_timer_init(&scheduler_->loop_, timer.get()));
-      timer->data = task_.release();
+      timer->data = new TimerTask { std::move(task_), priority_ };
       CHECK_EQ(0, uv_timer_start(timer.get(), RunTask, delay_millis, 0));
       scheduler_->timers_.insert(timer.release());
     }
@@ -137,16 +186,19 @@ class WorkerThreadsTaskRunner::DelayedTaskScheduler {
     DelayedTaskScheduler* scheduler_;
     std::unique_ptr<Task> task_;
     double delay_in_seconds_;
+    WorkerTaskPriority priority_;
   };
 
   static void RunTask(uv_timer_t* timer) {
     DelayedTaskScheduler* scheduler =
         ContainerOf(&DelayedTaskScheduler::loop_, timer->loop);
-    scheduler->pending_worker_tasks_->Push(scheduler->TakeTimerTask(timer));
+    std::unique_ptr<TimerTask> timer_task = scheduler->TakeTimerTask(timer);
+    scheduler->runner_->PostTask(std::move(timer_task->task),
+                                 timer_task->priority);
   }
 
-  std::unique_ptr<Task> TakeTimerTask(uv_timer_t* timer) {
-    std::unique_ptr<Task> task(static_cast<Task*>(timer->data));
+  std::unique_ptr<TimerTask> TakeTimerTask(uv_timer_t* timer) {
+    std::unique_ptr<TimerTask> task(static_cast<TimerTask*>(timer->data));
     uv_timer_stop(timer);
     uv_close(reinterpret_cast<uv_handle_t*>(timer), [](uv_handle_t* handle) {
       delete reinterpret_cast<uv_timer_t*>(handle);
@@ -156,7 +208,7 @@ class WorkerThreadsTaskRunner::DelayedTaskScheduler {
   }
 
   uv_sem_t ready_;
-  TaskQueue<Task>* pending_worker_tasks_;
+  WorkerThreadsTaskRunner* runner_;
 
   TaskQueue<Task> tasks_;
   uv_loop_t loop_;
@@ -164,21 +216,26 @@ class WorkerThreadsTaskRunner::DelayedTaskScheduler {
   std::unordered_set<uv_timer_t*> timers_;
 };
 
-WorkerThreadsTaskRunner::WorkerThreadsTaskRunner(int thread_pool_size) {
+WorkerThreadsTaskRunner::WorkerThreadsTaskRunner(int thread_pool_size,
+                                                 bool pin_threads) {
   Mutex platform_workers_mutex;
   ConditionVariable platform_workers_ready;
 
   Mutex::ScopedLock lock(platform_workers_mutex);
   int pending_platform_workers = thread_pool_size;
 
-  delayed_task_scheduler_ = std::make_unique<DelayedTaskScheduler>(
-      &pending_worker_tasks_);
+  for (int i = 0; i < std::max(thread_pool_size, 1); i++)
+    queues_.emplace_back(new WorkerQueue());
+  // Leave at least half of the threads to tasks with normal priority.
+  max_low_priority_threads_ = std::max(thread_pool_size / 2, 1);
+
+  delayed_task_scheduler_ = std::make_unique<DelayedTaskScheduler>(this);
   threads_.push_back(delayed_task_scheduler_->Start());
 
   for (int i = 0; i < thread_pool_size; i++) {
     PlatformWorkerData* worker_data = new PlatformWorkerData{
-      &pending_worker_tasks_, &platform_workers_mutex,
-      &platform_workers_ready, &pending_platform_workers, i
+      this, &platform_workers_mutex, &platform_workers_ready,
+      &pending_platform_workers, i, pin_threads
     };
     std::unique_ptr<uv_thread_t> t { new uv_thread_t() };
     if (uv_thread_create(t.get(), PlatformWorkerThread,
@@ -195,21 +252,138 @@ WorkerThreadsTaskRunner::WorkerThreadsTaskRunner(int thread_pool_size) {
   }
 }
 
+void WorkerThreadsTaskRunner::SetCurrentThreadPriority(
+    WorkerTaskPriority priority) {
+  current_priority = priority;
+}
+
 void WorkerThreadsTaskRunner::PostTask(std::unique_ptr<Task> task) {
-  pending_worker_tasks_.Push(std::move(task));
+  PostTask(std::move(task), current_priority);
+}
+
+void WorkerThreadsTaskRunner::PostTask(std::unique_ptr<Task> task,
+                                       WorkerTaskPriority priority) {
+  outstanding_tasks_++;
+  if (priority == WorkerTaskPriority::kLow) {
+    Mutex::ScopedLock lock(low_priority_tasks_.mutex);
+    low_priority_tasks_.tasks.push_back(std::move(task));
+    queued_low_priority_tasks_++;
+  } else {
+    // Tasks that are posted from a worker thread are likely to be related to
+    // what it is currently doing, so keep them on that thread by default.
+    size_t index = current_runner == this ?
+        current_queue : next_queue_++ % queues_.size();
+    WorkerQueue* queue = queues_[index].get();
+    Mutex::ScopedLock lock(queue->mutex);
+    queue->tasks.push_back(std::move(task));
+    queued_tasks_++;
+  }
+  WakeUpIdleThread();
+}
+
+void WorkerThreadsTaskRunner::WakeUpIdleThread() {
+  // This pairs with the check in BlockingPop(): Either that sees the new
+  // state of the queues, or this sees the thread that is about to wait.
+  if (idle_threads_ > 0) {
+    Mutex::ScopedLock lock(idle_mutex_);
+    tasks_available_.Signal(lock);
+  }
+}
+
+bool WorkerThreadsTaskRunner::HasRunnableTasks() const {
+  return queued_tasks_ > 0 ||
+         (queued_low_priority_tasks_ > 0 &&
+          running_low_priority_tasks_ < max_low_priority_threads_);
+}
+
+std::unique_ptr<Task> WorkerThreadsTaskRunner::TryPop(
+    size_t index, WorkerTaskPriority* priority) {
+  *priority = WorkerTaskPriority::kNormal;
+  // Take tasks from the front of the own queue, but from the back of other
+  // threads' queues, i.e. the tasks that their owners would run last.
+  for (size_t i = 0; i < queues_.size(); i++) {
+    WorkerQueue* queue = queues_[(index + i) % queues_.size()].get();
+    Mutex::ScopedLock lock(queue->mutex);
+    if (queue->tasks.empty()) continue;
+    std::unique_ptr<Task> task;
+    if (i == 0) {
+      task = std::move(queue->tasks.front());
+      queue->tasks.pop_front();
+    } else {
+      task = std::move(queue->tasks.back());
+      queue->tasks.pop_back();
+    }
+    queued_tasks_--;
+    return task;
+  }
+
+  // Reserve a slot for running a low priority task before looking for one.
+  size_t running = running_low_priority_tasks_;
+  do {
+    if (running >= max_low_priority_threads_) return nullptr;
+  } while (!running_low_priority_tasks_.compare_exchange_weak(running,
+                                                              running + 1));
+  {
+    Mutex::ScopedLock lock(low_priority_tasks_.mutex);
+    if (!low_priority_tasks_.tasks.empty()) {
+      std::unique_ptr<Task> task = std::move(low_priority_tasks_.tasks.front());
+      low_priority_tasks_.tasks.pop_front();
+      queued_low_priority_tasks_--;
+      *priority = WorkerTaskPriority::kLow;
+      return task;
+    }
+  }
+  running_low_priority_tasks_--;
+  return nullptr;
+}
+
+std::unique_ptr<Task> WorkerThreadsTaskRunner::BlockingPop(
+    size_t index, WorkerTaskPriority* priority) {
+  while (!stopped_) {
+    if (std::unique_ptr<Task> task = TryPop(index, priority))
+      return task;
+
+    Mutex::ScopedLock lock(idle_mutex_);
+    idle_threads_++;
+    while (!HasRunnableTasks() && !stopped_)
+      tasks_available_.Wait(lock);
+    idle_threads_--;
+  }
+  return nullptr;
+}
+
+void WorkerThreadsTaskRunner::NotifyOfCompletion(WorkerTaskPriority priority) {
+  if (priority == WorkerTaskPriority::kLow) {
+    running_low_priority_tasks_--;
+    // Another low priority task may have been waiting for this slot.
+    if (queued_low_priority_tasks_ > 0)
+      WakeUpIdleThread();
+  }
+  if (--outstanding_tasks_ == 0) {
+    Mutex::ScopedLock lock(drain_mutex_);
+    tasks_drained_.Broadcast(lock);
+  }
 }
 
 void WorkerThreadsTaskRunner::PostDelayedTask(std::unique_ptr<Task> task,
                                               double delay_in_seconds) {
-  delayed_task_scheduler_->PostDelayedTask(std::move(task), delay_in_seconds);
+  delayed_task_scheduler_->PostDelayedTask(std::move(task),
+                                          delay_in_seconds,
+                                          current_priority);
 }
 
 void WorkerThreadsTaskRunner::BlockingDrain() {
-  pending_worker_tasks_.BlockingDrain();
+  Mutex::ScopedLock lock(drain_mutex_);
+  while (outstanding_tasks_ > 0)
+    tasks_drained_.Wait(lock);
 }
 
 void WorkerThreadsTaskRunner::Shutdown() {
-  pending_worker_tasks_.Stop();
+  {
+    Mutex::ScopedLock lock(idle_mutex_);
+    stopped_ = true;
+    tasks_available_.Broadcast(lock);
+  }
   delayed_task_scheduler_->Stop();
   for (size_t i = 0; i < threads_.size(); i++) {
     CHECK_EQ(0, uv_thread_join(threads_[i].get()));
@@ -317,14 +491,18 @@ void PerIsolatePlatformData::DecreaseHandleCount() {
 }
 
 NodePlatform::NodePlatform(int thread_pool_size,
-                           TracingController* tracing_controller) {
+                           TracingController* tracing_controller,
+                           bool pin_worker_threads,
+                           v8::PageAllocator* page_allocator)
+    : page_allocator_(page_allocator) {
   if (tracing_controller) {
     tracing_controller_ = tracing_controller;
   } else {
     tracing_controller_ = new TracingController();
   }
   worker_thread_task_runner_ =
-      std::make_shared<WorkerThreadsTaskRunner>(thread_pool_size);
+      std::make_shared<WorkerThreadsTaskRunner>(thread_pool_size,
+                                                pin_worker_threads);
 }
 
 void NodePlatform::RegisterIsolate(Isolate* isolate, uv_loop_t* loop) {
@@ -521,6 +699,10 @@ Platform::StackTracePrinter NodePlatform::GetStackTracePrinter() {
   };
 }
 
+v8::PageAllocator* NodePlatform::GetPageAllocator() {
+  return page_allocator_;
+}
+
 template <class T>
 TaskQueue<T>::TaskQueue()
     : lock_(), tasks_available_(), tasks_drained_(),
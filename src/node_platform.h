@@ -3,6 +3,8 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include <atomic>
+#include <deque>
 #include <queue>
 #include <unordered_map>
 #include <vector>
@@ -112,22 +114,90 @@ class PerIsolatePlatformData :
   std::vector<DelayedTaskPointer> scheduled_delayed_tasks_;
 };
 
+// Binds the current thread to the CPU with the given index among the CPUs
+// that the process may run on, wrapping around if there are fewer. This does
+// nothing on platforms other than Linux.
+void PinCurrentThread(int id);
+
+// The priority of the tasks that V8 posts to the platform's worker threads.
+enum class WorkerTaskPriority {
+  kNormal,
+  // Tasks with low priority only run when no normal tasks are waiting, and
+  // only on some of the worker threads at a time, so that they cannot hold
+  // up the normal tasks for long.
+  kLow
+};
+
 // This acts as the single worker thread task runner for all Isolates.
+// Every platform worker thread has its own queue of tasks, so that threads
+// do not all contend for a single lock when many tasks are posted at once,
+// e.g. by several Isolates that are collecting garbage. Tasks that are posted
+// from a platform worker thread go to its own queue, other tasks are
+// distributed over all queues. Threads that run out of work take tasks from
+// the queues of other threads.
 class WorkerThreadsTaskRunner {
  public:
-  explicit WorkerThreadsTaskRunner(int thread_pool_size);
-
+  // If `pin_threads` is set, each worker thread is bound to a single CPU,
+  // where the operating system supports this.
+  explicit WorkerThreadsTaskRunner(int thread_pool_size,
+                                   bool pin_threads = false);
+
+  // Tasks get the priority that has been set for the current thread, or,
+  // when posted from a worker thread, the priority of the task that is
+  // currently running there.
   void PostTask(std::unique_ptr<v8::Task> task);
+  void PostTask(std::unique_ptr<v8::Task> task, WorkerTaskPriority priority);
   void PostDelayedTask(std::unique_ptr<v8::Task> task,
                        double delay_in_seconds);
 
+  // Set the priority of tasks that are posted from the current thread, e.g.
+  // from the thread that an Isolate runs on.
+  static void SetCurrentThreadPriority(WorkerTaskPriority priority);
+
   void BlockingDrain();
   void Shutdown();
 
   int NumberOfWorkerThreads() const;
 
  private:
-  TaskQueue<v8::Task> pending_worker_tasks_;
+  struct WorkerQueue {
+    Mutex mutex;
+    std::deque<std::unique_ptr<v8::Task>> tasks;
+  };
+
+  static void PlatformWorkerThread(void* data);
+  // Take a task from the queue with the given index, or from any other queue
+  // if that one is empty, and low priority tasks only after that. Blocks
+  // until a task is available or the runner has been stopped, in which case
+  // nullptr is returned.
+  std::unique_ptr<v8::Task> BlockingPop(size_t index,
+                                        WorkerTaskPriority* priority);
+  std::unique_ptr<v8::Task> TryPop(size_t index,
+                                   WorkerTaskPriority* priority);
+  bool HasRunnableTasks() const;
+  void NotifyOfCompletion(WorkerTaskPriority priority);
+  void WakeUpIdleThread();
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::atomic<size_t> next_queue_ {0};
+  // The number of tasks in all queues, and the number of threads that are
+  // waiting for one. Waiting threads are only woken up when there are any.
+  std::atomic<size_t> queued_tasks_ {0};
+  std::atomic<size_t> idle_threads_ {0};
+  // Low priority tasks share a single queue. At most
+  // max_low_priority_threads_ threads run them at the same time.
+  WorkerQueue low_priority_tasks_;
+  std::atomic<size_t> queued_low_priority_tasks_ {0};
+  std::atomic<size_t> running_low_priority_tasks_ {0};
+  size_t max_low_priority_threads_ = 1;
+  std::atomic<bool> stopped_ {false};
+  Mutex idle_mutex_;
+  ConditionVariable tasks_available_;
+
+  // The number of tasks that have been posted but not finished yet.
+  std::atomic<size_t> outstanding_tasks_ {0};
+  Mutex drain_mutex_;
+  ConditionVariable tasks_drained_;
 
   class DelayedTaskScheduler;
   std::unique_ptr<DelayedTaskScheduler> delayed_task_scheduler_;
@@ -138,7 +208,9 @@ class WorkerThreadsTaskRunner {
 class NodePlatform : public MultiIsolatePlatform {
  public:
   NodePlatform(int thread_pool_size,
-               node::tracing::TracingController* tracing_controller);
+               node::tracing::TracingController* tracing_controller,
+               bool pin_worker_threads = false,
+               v8::PageAllocator* page_allocator = nullptr);
   ~NodePlatform() override = default;
 
   void DrainTasks(v8::Isolate* isolate) override;
@@ -175,6 +247,7 @@ class NodePlatform : public MultiIsolatePlatform {
       v8::Isolate* isolate) override;
 
   Platform::StackTracePrinter GetStackTracePrinter() override;
+  v8::PageAllocator* GetPageAllocator() override;
 
  private:
   IsolatePlatformDelegate* ForIsolate(v8::Isolate* isolate);
@@ -187,6 +260,8 @@ class NodePlatform : public MultiIsolatePlatform {
 
   node::tracing::TracingController* tracing_controller_;
   std::shared_ptr<WorkerThreadsTaskRunner> worker_thread_task_runner_;
+  // If this is nullptr, V8 uses its own page allocator.
+  v8::PageAllocator* page_allocator_;
 };
 
 }  // namespace node
@@ -1,6 +1,9 @@
+#include "aliased_buffer.h"
 #include "base_object-inl.h"
 #include "debug_utils-inl.h"
 #include "env-inl.h"
+#include "handle_wrap.h"
+#include "memory_tracker-inl.h"
 #include "node.h"
 #include "node_errors.h"
 #include "node_internals.h"
@@ -9,6 +12,7 @@
 #include "uv.h"
 #include "v8.h"
 
+#include <algorithm>
 #include <vector>
 
 #if HAVE_INSPECTOR
@@ -38,6 +42,7 @@ using v8::Context;
 using v8::Float64Array;
 using v8::Function;
 using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
 using v8::HeapStatistics;
 using v8::Integer;
 using v8::Isolate;
@@ -187,6 +192,124 @@ static void Kill(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(err);
 }
 
+// Returns only the resident set size, which is cheaper than MemoryUsage()
+// because it does not need the heap statistics.
+static void Rss(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  size_t rss;
+  int err = uv_resident_set_memory(&rss);
+  if (err)
+    return env->ThrowUVException(err, "uv_resident_set_memory");
+
+  args.GetReturnValue().Set(static_cast<double>(rss));
+}
+
+namespace {
+
+// Backs process.memoryStats: samples the memory usage of the process every
+// |interval| milliseconds into a Float64Array that is shared with JS, so
+// that reading it does not call into C++ at all. The timer does not keep the
+// event loop alive. JS only holds on to the array, so the sampler is not weak;
+// it lives until the Environment closes its handles.
+class MemoryStatsSampler : public HandleWrap {
+ public:
+  enum Fields {
+    kRss,
+    kHeapTotal,
+    kHeapUsed,
+    kExternal,
+    kArrayBuffers,
+    kFieldsCount
+  };
+
+  static void Initialize(Environment* env, Local<Object> target) {
+    Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+    t->InstanceTemplate()->SetInternalFieldCount(1);
+    Local<String> name =
+        FIXED_ONE_BYTE_STRING(env->isolate(), "MemoryStatsSampler");
+    t->SetClassName(name);
+    t->Inherit(HandleWrap::GetConstructorTemplate(env));
+    env->SetProtoMethod(t, "start", Start);
+    target->Set(env->context(),
+                name,
+                t->GetFunction(env->context()).ToLocalChecked()).Check();
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackField("fields", fields_);
+  }
+
+  SET_MEMORY_INFO_NAME(MemoryStatsSampler)
+  SET_SELF_SIZE(MemoryStatsSampler)
+
+ private:
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    CHECK(args.IsConstructCall());
+    CHECK(args[0]->IsUint32());
+    Environment* env = Environment::GetCurrent(args);
+    uint32_t interval = args[0].As<Uint32>()->Value();
+    new MemoryStatsSampler(env, args.This(), std::max(interval, 1u));
+  }
+
+  MemoryStatsSampler(Environment* env,
+                     Local<Object> object,
+                     uint64_t interval)
+      : HandleWrap(env,
+                   object,
+                   reinterpret_cast<uv_handle_t*>(&timer_),
+                   AsyncWrap::PROVIDER_MEMORYSTATSSAMPLER),
+        fields_(env->isolate(), kFieldsCount),
+        interval_(interval) {
+    CHECK_EQ(uv_timer_init(env->event_loop(), &timer_), 0);
+    object->Set(env->context(),
+                FIXED_ONE_BYTE_STRING(env->isolate(), "fields"),
+                fields_.GetJSArray()).Check();
+  }
+
+  // start(): takes a first sample right away, and then one every interval.
+  static void Start(const FunctionCallbackInfo<Value>& args) {
+    MemoryStatsSampler* sampler;
+    ASSIGN_OR_RETURN_UNWRAP(&sampler, args.Holder());
+    if (sampler->IsHandleClosing())
+      return;
+    sampler->Sample();
+    uv_timer_start(&sampler->timer_, OnTimeout,
+                   sampler->interval_, sampler->interval_);
+    uv_unref(sampler->GetHandle());
+  }
+
+  static void OnTimeout(uv_timer_t* handle) {
+    MemoryStatsSampler* sampler =
+        ContainerOf(&MemoryStatsSampler::timer_, handle);
+    sampler->Sample();
+  }
+
+  void Sample() {
+    // Keep the previous value if the resident set size is not available.
+    size_t rss;
+    if (uv_resident_set_memory(&rss) == 0)
+      fields_[kRss] = rss;
+
+    HeapStatistics v8_heap_stats;
+    env()->isolate()->GetHeapStatistics(&v8_heap_stats);
+    fields_[kHeapTotal] = v8_heap_stats.total_heap_size();
+    fields_[kHeapUsed] = v8_heap_stats.used_heap_size();
+    fields_[kExternal] = v8_heap_stats.external_memory();
+
+    NodeArrayBufferAllocator* array_buffer_allocator =
+        env()->isolate_data()->node_allocator();
+    fields_[kArrayBuffers] = array_buffer_allocator == nullptr ?
+        0 : array_buffer_allocator->total_mem_usage();
+  }
+
+  uv_timer_t timer_;
+  AliasedFloat64Array fields_;
+  const uint64_t interval_;
+};
+
+}  // anonymous namespace
+
 static void MemoryUsage(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -206,7 +329,7 @@ static void MemoryUsage(const FunctionCallbackInfo<Value>& args) {
   // Get the double array pointer from the Float64Array argument.
   CHECK(args[0]->IsFloat64Array());
   Local<Float64Array> array = args[0].As<Float64Array>();
-  CHECK_EQ(array->Length(), 5);
+  CHECK_EQ(array->Length(), 7);
   Local<ArrayBuffer> ab = array->Buffer();
   double* fields = static_cast<double*>(ab->GetBackingStore()->Data());
 
@@ -216,6 +339,15 @@ static void MemoryUsage(const FunctionCallbackInfo<Value>& args) {
   fields[3] = v8_heap_stats.external_memory();
   fields[4] = array_buffer_allocator == nullptr ?
       0 : array_buffer_allocator->total_mem_usage();
+
+  if (array_buffer_allocator != nullptr) {
+    BufferPool::Stats pool_stats = array_buffer_allocator->buffer_pool_stats();
+    fields[5] = pool_stats.reserved;
+    fields[6] = pool_stats.used;
+  } else {
+    fields[5] = 0;
+    fields[6] = 0;
+  }
 }
 
 void RawDebug(const FunctionCallbackInfo<Value>& args) {
@@ -465,6 +597,8 @@ static void InitializeProcessMethods(Local<Object> target,
   env->SetMethod(target, "umask", Umask);
   env->SetMethod(target, "_rawDebug", RawDebug);
   env->SetMethod(target, "memoryUsage", MemoryUsage);
+  env->SetMethod(target, "rss", Rss);
+  MemoryStatsSampler::Initialize(env, target);
   env->SetMethod(target, "cpuUsage", CPUUsage);
   env->SetMethod(target, "hrtime", Hrtime);
   env->SetMethod(target, "hrtimeBigInt", HrtimeBigInt);
@@ -70,6 +70,36 @@ static void GetParentProcessId(Local<Name> property,
   info.GetReturnValue().Set(uv_os_getppid());
 }
 
+#ifdef NODE_HAVE_I18N_SUPPORT
+// process.versions.cldr and process.versions.tz are only looked up when they
+// are first accessed, because that loads parts of the ICU data.
+static bool IsLazyVersion(const char* key) {
+  return strcmp(key, "cldr") == 0 || strcmp(key, "tz") == 0;
+}
+
+static void GetLazyVersion(Local<Name> property,
+                           const PropertyCallbackInfo<Value>& info) {
+  Environment* env = Environment::GetCurrent(info);
+  Metadata::Versions* versions = &per_process::metadata.versions;
+  versions->InitializeIntlVersions();
+  Utf8Value key(env->isolate(), property);
+  const std::string& version =
+      strcmp(*key, "cldr") == 0 ? versions->cldr : versions->tz;
+  Local<Value> value;
+  if (ToV8Value(env->context(), version).ToLocal(&value))
+    info.GetReturnValue().Set(value);
+}
+#else
+static bool IsLazyVersion(const char*) {
+  return false;
+}
+
+static void GetLazyVersion(Local<Name> property,
+                           const PropertyCallbackInfo<Value>& info) {
+  UNREACHABLE();
+}
+#endif  // NODE_HAVE_I18N_SUPPORT
+
 MaybeLocal<Object> CreateProcessObject(Environment* env) {
   Isolate* isolate = env->isolate();
   EscapableHandleScope scope(isolate);
@@ -94,7 +124,13 @@ MaybeLocal<Object> CreateProcessObject(Environment* env) {
   READONLY_PROPERTY(process, "versions", versions);
 
 #define V(key)                                                                 \
-  if (!per_process::metadata.versions.key.empty()) {                           \
+  if (IsLazyVersion(#key)) {                                                   \
+    versions->SetLazyDataProperty(context,                                     \
+                                  FIXED_ONE_BYTE_STRING(isolate, #key),        \
+                                  GetLazyVersion,                              \
+                                  Local<Value>(),                              \
+                                  v8::ReadOnly).Check();                       \
+  } else if (!per_process::metadata.versions.key.empty()) {                    \
     READONLY_STRING_PROPERTY(                                                  \
         versions, #key, per_process::metadata.versions.key);                   \
   }
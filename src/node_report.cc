@@ -3,8 +3,12 @@
 #include "debug_utils-inl.h"
 #include "diagnosticfilename-inl.h"
 #include "node_internals.h"
+#if defined(NODE_ENABLE_LARGE_CODE_PAGES) && NODE_ENABLE_LARGE_CODE_PAGES
+#include "large_pages/node_large_page.h"
+#endif
 #include "node_metadata.h"
 #include "node_mutex.h"
+#include "node_v8_platform-inl.h"
 #include "node_worker.h"
 #include "util.h"
 
@@ -52,8 +56,10 @@ static void WriteNodeReport(Isolate* isolate,
                             const char* trigger,
                             const std::string& filename,
                             std::ostream& out,
-                            Local<String> stackstr);
+                            Local<String> stackstr,
+                            std::vector<DeferredReportSection>* deferred);
 static void PrintVersionInformation(JSONWriter* writer);
+static void PrintMachineInformation(JSONWriter* writer);
 static void PrintJavaScriptStack(JSONWriter* writer,
                                  Isolate* isolate,
                                  Local<String> stackstr,
@@ -77,22 +83,7 @@ std::string TriggerNodeReport(Isolate* isolate,
                               const char* trigger,
                               const std::string& name,
                               Local<String> stackstr) {
-  std::string filename;
-  std::shared_ptr<PerIsolateOptions> options;
-  if (env != nullptr) options = env->isolate_data()->options();
-
-  // Determine the required report filename. In order of priority:
-  //   1) supplied on API 2) configured on startup 3) default generated
-  if (!name.empty()) {
-    // Filename was specified as API parameter.
-    filename = name;
-  } else if (env != nullptr && options->report_filename.length() > 0) {
-    // File name was supplied via start-up option.
-    filename = options->report_filename;
-  } else {
-    filename = *DiagnosticFilename(env != nullptr ? env->thread_id() : 0,
-                                   "report", "json");
-  }
+  std::string filename = GetReportFilename(env, name);
 
   // Open the report file stream for writing. Supports stdout/err,
   // user-specified or (default) generated name
@@ -104,20 +95,17 @@ std::string TriggerNodeReport(Isolate* isolate,
     outstream = &std::cerr;
   } else {
     // Regular file. Append filename to directory path if one was specified
-    if (env != nullptr && options->report_directory.length() > 0) {
-      std::string pathname = options->report_directory;
-      pathname += node::kPathSeparator;
-      pathname += filename;
-      outfile.open(pathname, std::ios::out | std::ios::binary);
-    } else {
-      outfile.open(filename, std::ios::out | std::ios::binary);
-    }
+    outfile.open(GetReportPath(env, filename),
+                 std::ios::out | std::ios::binary);
     // Check for errors on the file open
     if (!outfile.is_open()) {
       std::cerr << "\nFailed to open Node.js report file: " << filename;
 
-      if (env != nullptr && options->report_directory.length() > 0)
-        std::cerr << " directory: " << options->report_directory;
+      if (env != nullptr &&
+          env->isolate_data()->options()->report_directory.length() > 0) {
+        std::cerr << " directory: "
+                  << env->isolate_data()->options()->report_directory;
+      }
 
       std::cerr << " (errno: " << errno << ")" << std::endl;
       return "";
@@ -127,17 +115,47 @@ std::string TriggerNodeReport(Isolate* isolate,
   }
 
   WriteNodeReport(isolate, env, message, trigger, filename, *outstream,
-                  stackstr);
+                  stackstr, nullptr);
 
   // Do not close stdout/stderr, only close files we opened.
   if (outfile.is_open()) {
     outfile.close();
   }
 
+  // Write the recent trace events alongside the report.
+  if (node::per_process::cli_options->trace_event_flight_recorder)
+    node::per_process::v8_platform.DumpTraceBuffer();
+
   std::cerr << "\nNode.js report completed" << std::endl;
   return filename;
 }
 
+std::string GetReportFilename(Environment* env, const std::string& name) {
+  // Determine the required report filename. In order of priority:
+  //   1) supplied on API 2) configured on startup 3) default generated
+  if (!name.empty()) {
+    // Filename was specified as API parameter.
+    return name;
+  } else if (env != nullptr &&
+             env->isolate_data()->options()->report_filename.length() > 0) {
+    // File name was supplied via start-up option.
+    return env->isolate_data()->options()->report_filename;
+  }
+  return *DiagnosticFilename(env != nullptr ? env->thread_id() : 0,
+                             "report", "json");
+}
+
+std::string GetReportPath(Environment* env, const std::string& filename) {
+  if (env == nullptr ||
+      env->isolate_data()->options()->report_directory.empty()) {
+    return filename;
+  }
+  std::string pathname = env->isolate_data()->options()->report_directory;
+  pathname += node::kPathSeparator;
+  pathname += filename;
+  return pathname;
+}
+
 // External function to trigger a report, writing to a supplied stream.
 void GetNodeReport(Isolate* isolate,
                    Environment* env,
@@ -145,7 +163,46 @@ void GetNodeReport(Isolate* isolate,
                    const char* trigger,
                    Local<String> stackstr,
                    std::ostream& out) {
-  WriteNodeReport(isolate, env, message, trigger, "", out, stackstr);
+  WriteNodeReport(isolate, env, message, trigger, "", out, stackstr, nullptr);
+}
+
+ReportSnapshot TakeNodeReportSnapshot(Isolate* isolate,
+                                      Environment* env,
+                                      const char* message,
+                                      const char* trigger,
+                                      const std::string& filename,
+                                      Local<String> stackstr) {
+  ReportSnapshot snapshot;
+  std::ostringstream out;
+  WriteNodeReport(isolate, env, message, trigger, filename, out, stackstr,
+                  &snapshot.deferred);
+  snapshot.json = out.str();
+  return snapshot;
+}
+
+std::string ReportSnapshot::Complete() const {
+  std::ostringstream out;
+  size_t offset = 0;
+  for (const DeferredReportSection& section : deferred) {
+    out.write(json.data() + offset, section.offset - offset);
+    JSONWriter writer(out, section.indentation);
+    section.print(&writer);
+    offset = section.offset;
+  }
+  out.write(json.data() + offset, json.size() - offset);
+  return out.str();
+}
+
+// Prints a section that does not depend on the calling thread or, if
+// `deferred` is not null, only records where it goes.
+static void PrintOrDeferSection(JSONWriter* writer,
+                                std::ostream& out,
+                                std::vector<DeferredReportSection>* deferred,
+                                void (*print)(JSONWriter* writer)) {
+  if (deferred == nullptr)
+    return print(writer);
+  deferred->push_back(DeferredReportSection {
+      static_cast<size_t>(out.tellp()), writer->indentation(), print });
 }
 
 // Internal function to coordinate and write the various
@@ -156,7 +213,8 @@ static void WriteNodeReport(Isolate* isolate,
                             const char* trigger,
                             const std::string& filename,
                             std::ostream& out,
-                            Local<String> stackstr) {
+                            Local<String> stackstr,
+                            std::vector<DeferredReportSection>* deferred) {
   // Obtain the current time and the pid.
   TIME_TYPE tm_struct;
   DiagnosticFilename::LocalTime(&tm_struct);
@@ -238,6 +296,7 @@ static void WriteNodeReport(Isolate* isolate,
 
   // Report Node.js and OS version information
   PrintVersionInformation(&writer);
+  PrintOrDeferSection(&writer, out, deferred, PrintMachineInformation);
   writer.json_objectend();
 
   // Report summary JavaScript stack backtrace
@@ -254,7 +313,9 @@ static void WriteNodeReport(Isolate* isolate,
 
   writer.json_arraystart("libuv");
   if (env != nullptr) {
-    uv_walk(env->event_loop(), WalkHandle, static_cast<void*>(&writer));
+    // Walking the handles can take long for processes with many connections.
+    if (!env->isolate_data()->options()->report_exclude_handles)
+      uv_walk(env->event_loop(), WalkHandle, static_cast<void*>(&writer));
 
     writer.json_start();
     writer.json_keyvalue("type", "loop");
@@ -301,7 +362,7 @@ static void WriteNodeReport(Isolate* isolate,
   writer.json_arrayend();
 
   // Report operating system information
-  PrintSystemInformation(&writer);
+  PrintOrDeferSection(&writer, out, deferred, PrintSystemInformation);
 
   writer.json_objectend();
 
@@ -342,8 +403,10 @@ static void PrintVersionInformation(JSONWriter* writer) {
 
   // Report release metadata.
   PrintRelease(writer);
+}
 
-  // Report operating system and machine information
+// Report operating system and machine information.
+static void PrintMachineInformation(JSONWriter* writer) {
   uv_utsname_t os_info;
 
   if (uv_os_uname(&os_info) == 0) {
@@ -530,6 +593,18 @@ static void PrintGCStatistics(JSONWriter* writer, Isolate* isolate) {
   }
 
   writer->json_objectend();
+
+#if defined(NODE_ENABLE_LARGE_CODE_PAGES) && NODE_ENABLE_LARGE_CODE_PAGES
+  // Only present with --use-largepages-heap.
+  size_t reserved, large_pages;
+  if (node::GetLargePageHeapStatistics(&reserved, &large_pages)) {
+    writer->json_objectstart("largePages");
+    writer->json_keyvalue("reservedMemory", reserved);
+    writer->json_keyvalue("largePageMemory", large_pages);
+    writer->json_objectend();
+  }
+#endif  // NODE_ENABLE_LARGE_CODE_PAGES
+
   writer->json_objectend();
 }
 
@@ -674,6 +749,10 @@ static void PrintComponentVersions(JSONWriter* writer) {
 
   writer->json_objectstart("componentVersions");
 
+#ifdef NODE_HAVE_I18N_SUPPORT
+  node::per_process::metadata.versions.InitializeIntlVersions();
+#endif  // NODE_HAVE_I18N_SUPPORT
+
 #define V(key)                                                                 \
   writer->json_keyvalue(#key, node::per_process::metadata.versions.key);
   NODE_VERSIONS_KEYS(V)
@@ -73,6 +73,13 @@ class JSONWriter {
     for (int i = 0; i < indent_; i++) out_ << ' ';
   }
 
+  // Resumes writing at the given indentation, after a value has been written
+  // by another JSONWriter.
+  JSONWriter(std::ostream& out, int indentation)
+      : out_(out), indent_(indentation), state_(kAfterValue) {}
+
+  int indentation() const { return indent_; }
+
   inline void json_start() {
     if (state_ == kAfterValue) out_ << ',';
     out_ << '\n';
@@ -181,4 +188,39 @@ class JSONWriter {
   int state_ = kObjectStart;
 };
 
+// A section of a report that only describes the process or the machine, and
+// not the thread that triggered the report. It can therefore be printed
+// after the rest of the report was collected, and on another thread.
+struct DeferredReportSection {
+  // Where the section goes in ReportSnapshot::json.
+  size_t offset;
+  int indentation;
+  void (*print)(JSONWriter* writer);
+};
+
+// A report whose deferred sections have not been printed yet.
+struct ReportSnapshot {
+  std::string json;
+  std::vector<DeferredReportSection> deferred;
+
+  // Returns the complete report. This can be called from any thread.
+  std::string Complete() const;
+};
+
+// Collects everything but the deferred sections of a report, see
+// WriteReportAsync() in src/node_report_module.cc.
+ReportSnapshot TakeNodeReportSnapshot(v8::Isolate* isolate,
+                                      node::Environment* env,
+                                      const char* message,
+                                      const char* trigger,
+                                      const std::string& filename,
+                                      v8::Local<v8::String> stackstr);
+
+// Returns the name of the report file, following the same rules as
+// TriggerNodeReport(): `name` if not empty, otherwise the configured or a
+// generated one.
+std::string GetReportFilename(node::Environment* env, const std::string& name);
+// Returns the path that the report file is written to.
+std::string GetReportPath(node::Environment* env, const std::string& filename);
+
 }  // namespace report
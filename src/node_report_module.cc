@@ -1,8 +1,12 @@
-#include "env.h"
+#include "async_wrap-inl.h"
+#include "env-inl.h"
+#include "memory_tracker-inl.h"
 #include "node_errors.h"
 #include "node_internals.h"
 #include "node_options.h"
 #include "node_report.h"
+#include "node_v8_platform-inl.h"
+#include "threadpoolwork-inl.h"
 #include "util-inl.h"
 
 #include "handle_wrap.h"
@@ -15,19 +19,143 @@
 #include <sstream>
 
 namespace report {
+using node::AsyncWrap;
+using node::BaseObject;
 using node::Environment;
+using node::MemoryTracker;
+using node::ThreadPoolWork;
 using node::Utf8Value;
 using v8::Boolean;
 using v8::Context;
 using v8::Function;
 using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
 using v8::HandleScope;
+using v8::Integer;
 using v8::Isolate;
 using v8::Local;
 using v8::Object;
 using v8::String;
 using v8::Value;
 
+// Writes a report on the threadpool, for process.report.writeReport() with a
+// callback. Everything that depends on the state of the thread that triggers
+// the report is collected up front, so that the thread is only blocked for
+// that. The sections that describe the process and the machine are collected
+// and the report is written on the threadpool.
+class ReportWriteReq : public AsyncWrap, public ThreadPoolWork {
+ public:
+  ReportWriteReq(Environment* env, Local<Object> obj)
+      : AsyncWrap(env, obj, AsyncWrap::PROVIDER_REPORTWRITEREQ),
+        ThreadPoolWork(env, node::performance::NODE_THREADPOOL_WORK_KIND_FS) {}
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    CHECK(args.IsConstructCall());
+    Environment* env = Environment::GetCurrent(args);
+    new ReportWriteReq(env, args.This());
+  }
+
+  void Start(ReportSnapshot&& snapshot,
+             std::string&& filename,
+             std::string&& path) {
+    snapshot_ = std::move(snapshot);
+    filename_ = std::move(filename);
+    path_ = std::move(path);
+    ScheduleWork();
+  }
+
+  void DoThreadPoolWork() override {
+    const std::string report = snapshot_.Complete();
+    uv_fs_t req;
+    uv_file fd;
+    if (filename_ == "stdout") {
+      fd = 1;
+    } else if (filename_ == "stderr") {
+      fd = 2;
+    } else {
+      fd = uv_fs_open(nullptr, &req, path_.c_str(),
+                      O_WRONLY | O_CREAT | O_TRUNC, 0666, nullptr);
+      uv_fs_req_cleanup(&req);
+      if (fd < 0) {
+        error_ = fd;
+        syscall_ = "open";
+        return;
+      }
+    }
+
+    size_t offset = 0;
+    while (offset < report.size()) {
+      uv_buf_t buf = uv_buf_init(const_cast<char*>(report.data()) + offset,
+                                 report.size() - offset);
+      const int written = uv_fs_write(nullptr, &req, fd, &buf, 1, -1, nullptr);
+      uv_fs_req_cleanup(&req);
+      if (written < 0) {
+        error_ = written;
+        syscall_ = "write";
+        break;
+      }
+      offset += written;
+    }
+
+    // Do not close stdout/stderr, only close files we opened.
+    if (fd > 2) {
+      uv_fs_close(nullptr, &req, fd, nullptr);
+      uv_fs_req_cleanup(&req);
+    }
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<ReportWriteReq> self(this);
+    Environment* env = AsyncWrap::env();
+    if (status != 0) {
+      error_ = status;
+      syscall_ = "write";
+    }
+    if (error_ == 0) {
+      // Write the recent trace events alongside the report.
+      if (node::per_process::cli_options->trace_event_flight_recorder)
+        node::per_process::v8_platform.DumpTraceBuffer();
+      std::cerr << "\nNode.js report completed" << std::endl;
+    }
+    if (!env->can_call_into_js())
+      return;
+
+    Isolate* isolate = env->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env->context());
+    Local<Value> argv[] = {
+      Integer::New(isolate, error_),
+      node::OneByteString(isolate, syscall_),
+      Local<Value>()
+    };
+    if (!String::NewFromUtf8(isolate,
+                             filename_.c_str(),
+                             v8::NewStringType::kNormal).ToLocal(&argv[2])) {
+      return;
+    }
+    MakeCallback(env->oncomplete_string(), node::arraysize(argv), argv);
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackField("report", snapshot_.json);
+    tracker->TrackField("filename", filename_);
+    tracker->TrackField("path", path_);
+  }
+
+  SET_MEMORY_INFO_NAME(ReportWriteReq)
+  SET_SELF_SIZE(ReportWriteReq)
+
+ private:
+  ReportSnapshot snapshot_;
+  std::string filename_;
+  std::string path_;
+  int error_ = 0;
+  const char* syscall_ = "";
+};
+
+// When a ReportWriteReq is passed as the fifth argument, the report is
+// written on the threadpool and the request's oncomplete callback is called
+// with (err, syscall, filename).
 void WriteReport(const FunctionCallbackInfo<Value>& info) {
   Environment* env = Environment::GetCurrent(info);
   Isolate* isolate = env->isolate();
@@ -35,7 +163,7 @@ void WriteReport(const FunctionCallbackInfo<Value>& info) {
   std::string filename;
   Local<String> stackstr;
 
-  CHECK_EQ(info.Length(), 4);
+  CHECK_GE(info.Length(), 4);
   String::Utf8Value message(isolate, info[0].As<String>());
   String::Utf8Value trigger(isolate, info[1].As<String>());
   stackstr = info[3].As<String>();
@@ -43,6 +171,21 @@ void WriteReport(const FunctionCallbackInfo<Value>& info) {
   if (info[2]->IsString())
     filename = *String::Utf8Value(isolate, info[2]);
 
+  if (info[4]->IsObject()) {
+    ReportWriteReq* req;
+    ASSIGN_OR_RETURN_UNWRAP(&req, info[4].As<Object>());
+    filename = GetReportFilename(env, filename);
+    std::string path = GetReportPath(env, filename);
+    if (filename != "stdout" && filename != "stderr")
+      std::cerr << "\nWriting Node.js report to file: " << filename;
+    req->Start(
+        TakeNodeReportSnapshot(
+            isolate, env, *message, *trigger, filename, stackstr),
+        std::move(filename),
+        std::move(path));
+    return;
+  }
+
   filename = TriggerNodeReport(
       isolate, env, *message, *trigger, filename, stackstr);
   // Return value is the report filename
@@ -153,6 +296,18 @@ static void SetReportOnUncaughtException(
   env->isolate_data()->options()->report_uncaught_exception = info[0]->IsTrue();
 }
 
+static void ShouldExcludeHandles(const FunctionCallbackInfo<Value>& info) {
+  Environment* env = Environment::GetCurrent(info);
+  info.GetReturnValue().Set(
+      env->isolate_data()->options()->report_exclude_handles);
+}
+
+static void SetExcludeHandles(const FunctionCallbackInfo<Value>& info) {
+  Environment* env = Environment::GetCurrent(info);
+  CHECK(info[0]->IsBoolean());
+  env->isolate_data()->options()->report_exclude_handles = info[0]->IsTrue();
+}
+
 static void Initialize(Local<Object> exports,
                        Local<Value> unused,
                        Local<Context> context,
@@ -175,6 +330,18 @@ static void Initialize(Local<Object> exports,
                  ShouldReportOnUncaughtException);
   env->SetMethod(exports, "setReportOnUncaughtException",
                  SetReportOnUncaughtException);
+  env->SetMethod(exports, "shouldExcludeHandles", ShouldExcludeHandles);
+  env->SetMethod(exports, "setExcludeHandles", SetExcludeHandles);
+
+  Local<FunctionTemplate> req = env->NewFunctionTemplate(ReportWriteReq::New);
+  req->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  req->InstanceTemplate()->SetInternalFieldCount(1);
+  Local<String> req_string =
+      node::FIXED_ONE_BYTE_STRING(env->isolate(), "ReportWriteReq");
+  req->SetClassName(req_string);
+  exports->Set(context,
+               req_string,
+               req->GetFunction(context).ToLocalChecked()).Check();
 }
 
 }  // namespace report
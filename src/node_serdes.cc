@@ -4,6 +4,8 @@
 #include "util-inl.h"
 #include "base_object-inl.h"
 
+#include <algorithm>
+
 namespace node {
 
 using v8::Array;
@@ -22,6 +24,7 @@ using v8::Nothing;
 using v8::Object;
 using v8::SharedArrayBuffer;
 using v8::String;
+using v8::Uint32;
 using v8::Value;
 using v8::ValueDeserializer;
 using v8::ValueSerializer;
@@ -40,6 +43,10 @@ class SerializerContext : public BaseObject,
   Maybe<bool> WriteHostObject(Isolate* isolate, Local<Object> object) override;
   Maybe<uint32_t> GetSharedArrayBufferId(
       Isolate* isolate, Local<SharedArrayBuffer> shared_array_buffer) override;
+  void* ReallocateBufferMemory(void* old_buffer,
+                               size_t size,
+                               size_t* actual_size) override;
+  void FreeBufferMemory(void* buffer) override;
 
   static void SetTreatArrayBufferViewsAsHostObjects(
       const FunctionCallbackInfo<Value>& args);
@@ -53,13 +60,30 @@ class SerializerContext : public BaseObject,
   static void WriteUint64(const FunctionCallbackInfo<Value>& args);
   static void WriteDouble(const FunctionCallbackInfo<Value>& args);
   static void WriteRawBytes(const FunctionCallbackInfo<Value>& args);
+  static void WriteValues(const FunctionCallbackInfo<Value>& args);
 
   SET_NO_MEMORY_INFO()
   SET_MEMORY_INFO_NAME(SerializerContext)
   SET_SELF_SIZE(SerializerContext)
 
  private:
+  // The serializer that writeUint32() and friends write to, which is the one
+  // of the current value while WriteValues() is running.
+  ValueSerializer* serializer() {
+    return current_ != nullptr ? current_ : &serializer_;
+  }
+
+  bool GrowValues(size_t size);
+
   ValueSerializer serializer_;
+  bool treat_array_buffer_views_as_host_objects_ = false;
+
+  // WriteValues() uses a new ValueSerializer for every value, but they all
+  // write into the same buffer, each value preceded by its length.
+  ValueSerializer* current_ = nullptr;
+  uint8_t* values_ = nullptr;
+  size_t values_length_ = 0;
+  size_t values_capacity_ = 0;
 };
 
 class DeserializerContext : public BaseObject,
@@ -82,16 +106,22 @@ class DeserializerContext : public BaseObject,
   static void ReadUint64(const FunctionCallbackInfo<Value>& args);
   static void ReadDouble(const FunctionCallbackInfo<Value>& args);
   static void ReadRawBytes(const FunctionCallbackInfo<Value>& args);
+  static void ReadValueAt(const FunctionCallbackInfo<Value>& args);
 
   SET_NO_MEMORY_INFO()
   SET_MEMORY_INFO_NAME(DeserializerContext)
   SET_SELF_SIZE(DeserializerContext)
 
  private:
+  ValueDeserializer* deserializer() {
+    return current_ != nullptr ? current_ : &deserializer_;
+  }
+
   const uint8_t* data_;
   const size_t length_;
 
   ValueDeserializer deserializer_;
+  ValueDeserializer* current_ = nullptr;
 };
 
 SerializerContext::SerializerContext(Environment* env, Local<Object> wrap)
@@ -167,6 +197,39 @@ Maybe<bool> SerializerContext::WriteHostObject(Isolate* isolate,
   return Just(true);
 }
 
+bool SerializerContext::GrowValues(size_t size) {
+  if (size <= values_capacity_) return true;
+  size_t capacity = std::max(size, values_capacity_ * 2);
+  void* values = realloc(values_, capacity);
+  if (values == nullptr) return false;
+  values_ = static_cast<uint8_t*>(values);
+  values_capacity_ = capacity;
+  return true;
+}
+
+void* SerializerContext::ReallocateBufferMemory(void* old_buffer,
+                                                size_t size,
+                                                size_t* actual_size) {
+  if (current_ == nullptr) {
+    return ValueSerializer::Delegate::ReallocateBufferMemory(
+        old_buffer, size, actual_size);
+  }
+
+  // The buffer of the current value starts after its length, at the end of
+  // the values that have already been written.
+  const size_t start = values_length_ + sizeof(uint32_t);
+  if (!GrowValues(start + size)) return nullptr;
+  *actual_size = values_capacity_ - start;
+  return values_ + start;
+}
+
+void SerializerContext::FreeBufferMemory(void* buffer) {
+  // The buffer of the current value is part of values_, which WriteValues()
+  // frees itself.
+  if (current_ == nullptr)
+    ValueSerializer::Delegate::FreeBufferMemory(buffer);
+}
+
 void SerializerContext::New(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -195,6 +258,7 @@ void SerializerContext::SetTreatArrayBufferViewsAsHostObjects(
 
   bool value = args[0]->BooleanValue(ctx->env()->isolate());
   ctx->serializer_.SetTreatArrayBufferViewsAsHostObjects(value);
+  ctx->treat_array_buffer_views_as_host_objects_ = value;
 }
 
 void SerializerContext::ReleaseBuffer(const FunctionCallbackInfo<Value>& args) {
@@ -238,7 +302,7 @@ void SerializerContext::WriteUint32(const FunctionCallbackInfo<Value>& args) {
   Maybe<uint32_t> value = args[0]->Uint32Value(ctx->env()->context());
   if (value.IsNothing()) return;
 
-  ctx->serializer_.WriteUint32(value.FromJust());
+  ctx->serializer()->WriteUint32(value.FromJust());
 }
 
 void SerializerContext::WriteUint64(const FunctionCallbackInfo<Value>& args) {
@@ -252,7 +316,7 @@ void SerializerContext::WriteUint64(const FunctionCallbackInfo<Value>& args) {
 
   uint64_t hi = arg0.FromJust();
   uint64_t lo = arg1.FromJust();
-  ctx->serializer_.WriteUint64((hi << 32) | lo);
+  ctx->serializer()->WriteUint64((hi << 32) | lo);
 }
 
 void SerializerContext::WriteDouble(const FunctionCallbackInfo<Value>& args) {
@@ -262,7 +326,7 @@ void SerializerContext::WriteDouble(const FunctionCallbackInfo<Value>& args) {
   Maybe<double> value = args[0]->NumberValue(ctx->env()->context());
   if (value.IsNothing()) return;
 
-  ctx->serializer_.WriteDouble(value.FromJust());
+  ctx->serializer()->WriteDouble(value.FromJust());
 }
 
 void SerializerContext::WriteRawBytes(const FunctionCallbackInfo<Value>& args) {
@@ -275,7 +339,71 @@ void SerializerContext::WriteRawBytes(const FunctionCallbackInfo<Value>& args) {
   }
 
   ArrayBufferViewContents<char> bytes(args[0]);
-  ctx->serializer_.WriteRawBytes(bytes.data(), bytes.length());
+  ctx->serializer()->WriteRawBytes(bytes.data(), bytes.length());
+}
+
+void SerializerContext::WriteValues(const FunctionCallbackInfo<Value>& args) {
+  SerializerContext* ctx;
+  ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Holder());
+  CHECK(args[0]->IsArray());
+  CHECK_NULL(ctx->current_);
+  Environment* env = ctx->env();
+  Local<Array> values = args[0].As<Array>();
+  const uint32_t count = values->Length();
+
+  ctx->values_length_ = 0;
+  bool ok = true;
+  for (uint32_t i = 0; ok && i < count; i++) {
+    Local<Value> value;
+    if (!values->Get(env->context(), i).ToLocal(&value) ||
+        !ctx->GrowValues(ctx->values_length_ + sizeof(uint32_t))) {
+      ok = false;
+      break;
+    }
+
+    // A ValueSerializer cannot be reset, so every value gets its own one.
+    ValueSerializer serializer(env->isolate(), ctx);
+    serializer.SetTreatArrayBufferViewsAsHostObjects(
+        ctx->treat_array_buffer_views_as_host_objects_);
+    ctx->current_ = &serializer;
+    serializer.WriteHeader();
+    if (serializer.WriteValue(env->context(), value).IsNothing()) {
+      // The partial output is part of values_, so it must not be freed by
+      // the serializer.
+      USE(serializer.Release());
+      ok = false;
+    } else {
+      std::pair<uint8_t*, size_t> ret = serializer.Release();
+      CHECK_LE(ret.second, 0xffffffff);
+      const uint32_t length = static_cast<uint32_t>(ret.second);
+      uint8_t* prefix = ctx->values_ + ctx->values_length_;
+      CHECK_EQ(ret.first, prefix + sizeof(uint32_t));
+      prefix[0] = length >> 24;
+      prefix[1] = length >> 16;
+      prefix[2] = length >> 8;
+      prefix[3] = length;
+      ctx->values_length_ += sizeof(uint32_t) + length;
+    }
+    ctx->current_ = nullptr;
+  }
+
+  uint8_t* data = ctx->values_;
+  const size_t length = ctx->values_length_;
+  ctx->values_ = nullptr;
+  ctx->values_length_ = 0;
+  ctx->values_capacity_ = 0;
+  if (!ok) {
+    free(data);
+    return;
+  }
+
+  auto buf = Buffer::New(env,
+                         reinterpret_cast<char*>(data),
+                         length,
+                         true /* uses_malloc */);
+  if (!buf.IsEmpty()) {
+    args.GetReturnValue().Set(buf.ToLocalChecked());
+  }
 }
 
 DeserializerContext::DeserializerContext(Environment* env,
@@ -348,6 +476,34 @@ void DeserializerContext::ReadValue(const FunctionCallbackInfo<Value>& args) {
   if (!ret.IsEmpty()) args.GetReturnValue().Set(ret.ToLocalChecked());
 }
 
+// Reads the value of `length` bytes at `offset` with a new ValueDeserializer,
+// so that the offsets returned by _readRawBytes() stay relative to the
+// whole buffer.
+void DeserializerContext::ReadValueAt(
+    const FunctionCallbackInfo<Value>& args) {
+  DeserializerContext* ctx;
+  ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Holder());
+  CHECK(args[0]->IsUint32());
+  CHECK(args[1]->IsUint32());
+  CHECK_NULL(ctx->current_);
+  const size_t offset = args[0].As<Uint32>()->Value();
+  const size_t length = args[1].As<Uint32>()->Value();
+  CHECK_LE(offset, ctx->length_);
+  CHECK_LE(length, ctx->length_ - offset);
+
+  Local<Context> context = ctx->env()->context();
+  ValueDeserializer deserializer(
+      ctx->env()->isolate(), ctx->data_ + offset, length, ctx);
+  deserializer.SetExpectInlineWasm(true);
+  ctx->current_ = &deserializer;
+  Local<Value> value;
+  if (deserializer.ReadHeader(context).FromMaybe(false) &&
+      deserializer.ReadValue(context).ToLocal(&value)) {
+    args.GetReturnValue().Set(value);
+  }
+  ctx->current_ = nullptr;
+}
+
 void DeserializerContext::TransferArrayBuffer(
     const FunctionCallbackInfo<Value>& args) {
   DeserializerContext* ctx;
@@ -377,7 +533,7 @@ void DeserializerContext::GetWireFormatVersion(
   DeserializerContext* ctx;
   ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Holder());
 
-  args.GetReturnValue().Set(ctx->deserializer_.GetWireFormatVersion());
+  args.GetReturnValue().Set(ctx->deserializer()->GetWireFormatVersion());
 }
 
 void DeserializerContext::ReadUint32(const FunctionCallbackInfo<Value>& args) {
@@ -385,7 +541,7 @@ void DeserializerContext::ReadUint32(const FunctionCallbackInfo<Value>& args) {
   ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Holder());
 
   uint32_t value;
-  bool ok = ctx->deserializer_.ReadUint32(&value);
+  bool ok = ctx->deserializer()->ReadUint32(&value);
   if (!ok) return ctx->env()->ThrowError("ReadUint32() failed");
   return args.GetReturnValue().Set(value);
 }
@@ -395,7 +551,7 @@ void DeserializerContext::ReadUint64(const FunctionCallbackInfo<Value>& args) {
   ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Holder());
 
   uint64_t value;
-  bool ok = ctx->deserializer_.ReadUint64(&value);
+  bool ok = ctx->deserializer()->ReadUint64(&value);
   if (!ok) return ctx->env()->ThrowError("ReadUint64() failed");
 
   uint32_t hi = static_cast<uint32_t>(value >> 32);
@@ -415,7 +571,7 @@ void DeserializerContext::ReadDouble(const FunctionCallbackInfo<Value>& args) {
   ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Holder());
 
   double value;
-  bool ok = ctx->deserializer_.ReadDouble(&value);
+  bool ok = ctx->deserializer()->ReadDouble(&value);
   if (!ok) return ctx->env()->ThrowError("ReadDouble() failed");
   return args.GetReturnValue().Set(value);
 }
@@ -430,7 +586,7 @@ void DeserializerContext::ReadRawBytes(
   size_t length = length_arg.FromJust();
 
   const void* data;
-  bool ok = ctx->deserializer_.ReadRawBytes(length, &data);
+  bool ok = ctx->deserializer()->ReadRawBytes(length, &data);
   if (!ok) return ctx->env()->ThrowError("ReadRawBytes() failed");
 
   const uint8_t* position = reinterpret_cast<const uint8_t*>(data);
@@ -463,6 +619,7 @@ void Initialize(Local<Object> target,
   env->SetProtoMethod(ser, "writeUint64", SerializerContext::WriteUint64);
   env->SetProtoMethod(ser, "writeDouble", SerializerContext::WriteDouble);
   env->SetProtoMethod(ser, "writeRawBytes", SerializerContext::WriteRawBytes);
+  env->SetProtoMethod(ser, "_writeValues", SerializerContext::WriteValues);
   env->SetProtoMethod(ser,
                       "_setTreatArrayBufferViewsAsHostObjects",
                       SerializerContext::SetTreatArrayBufferViewsAsHostObjects);
@@ -491,6 +648,7 @@ void Initialize(Local<Object> target,
   env->SetProtoMethod(des, "readUint64", DeserializerContext::ReadUint64);
   env->SetProtoMethod(des, "readDouble", DeserializerContext::ReadDouble);
   env->SetProtoMethod(des, "_readRawBytes", DeserializerContext::ReadRawBytes);
+  env->SetProtoMethod(des, "_readValueAt", DeserializerContext::ReadValueAt);
 
   Local<String> deserializerString =
       FIXED_ONE_BYTE_STRING(env->isolate(), "Deserializer");
@@ -0,0 +1,382 @@
+#include "node_shared_channel.h"
+
+#include "env-inl.h"
+#include "memory_tracker-inl.h"
+#include "node_errors.h"
+#include "node_mutex.h"
+#include "stream_base-inl.h"
+#include "util-inl.h"
+
+#include <array>
+#include <unordered_map>
+
+namespace node {
+namespace worker {
+
+using v8::BackingStore;
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::HandleScope;
+using v8::Local;
+using v8::Object;
+using v8::SharedArrayBuffer;
+using v8::String;
+using v8::Value;
+
+static_assert(sizeof(SharedChannelRing) == 192,
+              "SharedChannelRing should span three cache lines");
+
+namespace {
+
+// All open channel ends of this process, keyed by the address of the
+// shared memory and the side of the channel. This is what allows one end
+// to wake up the other one, which is typically running on another thread.
+// Entries are removed before the async handle of an end is closed, and
+// handles are only signalled while the mutex is held.
+Mutex channels_mutex;
+std::unordered_map<const void*, std::array<SharedChannel*, 2>> channels;
+
+}  // anonymous namespace
+
+constexpr size_t SharedChannel::kMaxReadSize;
+
+SharedChannel::SharedChannel(Environment* env,
+                             Local<Object> wrap,
+                             std::shared_ptr<BackingStore> backing_store,
+                             size_t capacity,
+                             uint32_t side)
+    : HandleWrap(env,
+                 wrap,
+                 reinterpret_cast<uv_handle_t*>(&async_),
+                 AsyncWrap::PROVIDER_SHAREDCHANNEL),
+      StreamBase(env),
+      backing_store_(std::move(backing_store)),
+      capacity_(capacity),
+      side_(side) {
+  auto onsignal = [](uv_async_t* handle) {
+    SharedChannel* channel = ContainerOf(&SharedChannel::async_, handle);
+    channel->OnSignal();
+  };
+  CHECK_EQ(uv_async_init(env->event_loop(), &async_, onsignal), 0);
+  StreamBase::AttachToObject(wrap);
+
+  if (ring(side_)->opened.exchange(1) != 0)
+    return;
+  Mutex::ScopedLock lock(channels_mutex);
+  channels[backing_store_->Data()][side_] = this;
+  registered_ = true;
+}
+
+SharedChannel::~SharedChannel() {
+  Detach();
+}
+
+SharedChannelRing* SharedChannel::ring(uint32_t side) const {
+  return static_cast<SharedChannelRing*>(backing_store_->Data()) + side;
+}
+
+char* SharedChannel::ring_data(uint32_t side) const {
+  return static_cast<char*>(backing_store_->Data()) + kHeaderSize +
+         side * capacity_;
+}
+
+void SharedChannel::Signal(const void* key, uint32_t side) {
+  Mutex::ScopedLock lock(channels_mutex);
+  auto it = channels.find(key);
+  if (it == channels.end() || it->second[side] == nullptr)
+    return;
+  uv_async_send(&it->second[side]->async_);
+}
+
+void SharedChannel::Detach() {
+  if (!registered_) return;
+  registered_ = false;
+
+  // Let the other end know that it will neither receive more data from this
+  // end, nor can it send data to it.
+  ring(side_)->ended = 1;
+  ring(1 - side_)->closed = 1;
+
+  const void* key = backing_store_->Data();
+  {
+    Mutex::ScopedLock lock(channels_mutex);
+    auto it = channels.find(key);
+    CHECK_NE(it, channels.end());
+    it->second[side_] = nullptr;
+    if (it->second[1 - side_] == nullptr)
+      channels.erase(it);
+  }
+  Signal(key, 1 - side_);
+}
+
+bool SharedChannel::IsAlive() {
+  return HandleWrap::IsAlive(this);
+}
+
+bool SharedChannel::IsClosing() {
+  return IsHandleClosing();
+}
+
+AsyncWrap* SharedChannel::GetAsyncWrap() {
+  return static_cast<AsyncWrap*>(this);
+}
+
+int SharedChannel::ReadStart() {
+  reading_ = true;
+  // Data may already be waiting; pick it up from the event loop rather than
+  // emitting it synchronously from inside readStart().
+  uv_async_send(&async_);
+  return 0;
+}
+
+int SharedChannel::ReadStop() {
+  reading_ = false;
+  return 0;
+}
+
+void SharedChannel::OnSignal() {
+  HandleScope handle_scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+
+  if (pending_write_ != nullptr)
+    ContinueWrite();
+  if (reading_)
+    ReadAvailable();
+}
+
+void SharedChannel::ReadAvailable() {
+  SharedChannelRing* in = ring(1 - side_);
+  const char* data = ring_data(1 - side_);
+  size_t budget = capacity_;
+
+  while (reading_ && !eof_emitted_ && !IsHandleClosing()) {
+    uint64_t read_index = in->read_index.load(std::memory_order_relaxed);
+    uint64_t write_index = in->write_index.load();
+    if (write_index - read_index > capacity_) {
+      // The header is part of a SharedArrayBuffer that JS code can access,
+      // so it is not trusted.
+      reading_ = false;
+      EmitRead(UV_EPROTO);
+      return;
+    }
+
+    if (write_index == read_index) {
+      if (in->ended) {
+        // Data may have been written right before the other end shut down.
+        if (in->write_index.load() != read_index) continue;
+        eof_emitted_ = true;
+        EmitRead(UV_EOF);
+        return;
+      }
+      in->reader_waiting = 1;
+      // Check once more so that data written concurrently with setting the
+      // flag is not missed.
+      if (in->write_index.load() != read_index || in->ended) continue;
+      return;
+    }
+
+    if (budget == 0) {
+      // Leave the event loop a chance to do other work while the other end
+      // keeps writing.
+      uv_async_send(&async_);
+      return;
+    }
+
+    size_t available = std::min(static_cast<size_t>(write_index - read_index),
+                                std::min(budget, kMaxReadSize));
+    uv_buf_t buf = EmitAlloc(available);
+    size_t nread = std::min(available, static_cast<size_t>(buf.len));
+    size_t offset = read_index & (capacity_ - 1);
+    size_t first = std::min(nread, capacity_ - offset);
+    memcpy(buf.base, data + offset, first);
+    memcpy(buf.base + first, data, nread - first);
+    in->read_index.store(read_index + nread);
+    budget -= nread;
+
+    if (in->writer_waiting.exchange(0))
+      Signal(backing_store_->Data(), 1 - side_);
+    EmitRead(nread, buf);
+  }
+}
+
+void SharedChannel::WriteAvailable(uv_buf_t** bufs, size_t* count) {
+  SharedChannelRing* out = ring(side_);
+  char* data = ring_data(side_);
+  uint64_t write_index = out->write_index.load(std::memory_order_relaxed);
+  uint64_t read_index = out->read_index.load();
+  if (write_index - read_index > capacity_) return;
+  size_t space = capacity_ - (write_index - read_index);
+
+  uv_buf_t* vbufs = *bufs;
+  size_t vcount = *count;
+  size_t written = 0;
+  while (vcount > 0 && space > 0) {
+    size_t n = std::min(space, vbufs[0].len);
+    size_t offset = (write_index + written) & (capacity_ - 1);
+    size_t first = std::min(n, capacity_ - offset);
+    memcpy(data + offset, vbufs[0].base, first);
+    memcpy(data, vbufs[0].base + first, n - first);
+    written += n;
+    space -= n;
+    vbufs[0].base += n;
+    vbufs[0].len -= n;
+    if (vbufs[0].len == 0) {
+      vbufs++;
+      vcount--;
+    }
+  }
+
+  *bufs = vbufs;
+  *count = vcount;
+  if (written == 0) return;
+
+  out->write_index.store(write_index + written);
+  if (out->reader_waiting.exchange(0))
+    Signal(backing_store_->Data(), 1 - side_);
+}
+
+int SharedChannel::DoTryWrite(uv_buf_t** bufs, size_t* count) {
+  if (IsHandleClosing() || ring(side_)->ended)
+    return UV_EBADF;
+  if (ring(side_)->closed)
+    return UV_EPIPE;
+  // Do not overtake a write that is waiting for free space.
+  if (pending_write_ != nullptr)
+    return 0;
+  WriteAvailable(bufs, count);
+  return 0;
+}
+
+int SharedChannel::DoWrite(WriteWrap* w,
+                           uv_buf_t* bufs,
+                           size_t count,
+                           uv_stream_t* send_handle) {
+  CHECK_NULL(send_handle);
+  if (IsHandleClosing() || ring(side_)->ended)
+    return UV_EBADF;
+  if (pending_write_ != nullptr)
+    return UV_EBUSY;
+
+  // The data itself stays alive until the write finishes, but the uv_buf_t
+  // array may not.
+  pending_write_ = w;
+  pending_bufs_.assign(bufs, bufs + count);
+  pending_index_ = 0;
+  ring(side_)->writer_waiting = 1;
+  // The other end may have made room in the meantime; check again from the
+  // event loop, because the write must not complete synchronously.
+  uv_async_send(&async_);
+  return 0;
+}
+
+void SharedChannel::ContinueWrite() {
+  SharedChannelRing* out = ring(side_);
+  WriteWrap* w = pending_write_;
+
+  if (out->closed) {
+    pending_write_ = nullptr;
+    pending_bufs_.clear();
+    w->Done(UV_EPIPE);
+    return;
+  }
+
+  uv_buf_t* bufs = pending_bufs_.data() + pending_index_;
+  size_t count = pending_bufs_.size() - pending_index_;
+  WriteAvailable(&bufs, &count);
+  pending_index_ = pending_bufs_.size() - count;
+
+  if (count == 0) {
+    pending_write_ = nullptr;
+    pending_bufs_.clear();
+    w->Done(0);
+    return;
+  }
+
+  out->writer_waiting = 1;
+  // Space may have been freed after WriteAvailable() looked, but before the
+  // flag was set.
+  if (out->write_index.load() - out->read_index.load() < capacity_)
+    uv_async_send(&async_);
+}
+
+int SharedChannel::DoShutdown(ShutdownWrap* req_wrap) {
+  if (pending_write_ != nullptr)
+    return UV_EBUSY;
+  ring(side_)->ended = 1;
+  Signal(backing_store_->Data(), 1 - side_);
+  return 1;
+}
+
+void SharedChannel::Close(Local<Value> close_callback) {
+  Detach();
+  HandleWrap::Close(close_callback);
+}
+
+void SharedChannel::OnClose() {
+  if (pending_write_ == nullptr) return;
+  WriteWrap* w = pending_write_;
+  pending_write_ = nullptr;
+  pending_bufs_.clear();
+  w->Done(UV_ECANCELED);
+}
+
+void SharedChannel::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackFieldWithSize("backing_store",
+                              kHeaderSize + 2 * capacity_);
+  tracker->TrackField("pending_bufs", pending_bufs_);
+}
+
+void SharedChannel::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsSharedArrayBuffer());
+  CHECK(args[1]->IsUint32());
+
+  Local<SharedArrayBuffer> sab = args[0].As<SharedArrayBuffer>();
+  uint32_t side = args[1].As<v8::Uint32>()->Value();
+  std::shared_ptr<BackingStore> backing_store = sab->GetBackingStore();
+  size_t length = backing_store->ByteLength();
+  size_t capacity = length > kHeaderSize ? (length - kHeaderSize) / 2 : 0;
+  if (side > 1 || capacity == 0 || (capacity & (capacity - 1)) != 0 ||
+      length != kHeaderSize + 2 * capacity) {
+    return THROW_ERR_INVALID_ARG_VALUE(
+        env, "The SharedArrayBuffer is not a valid channel buffer");
+  }
+
+  SharedChannel* channel =
+      new SharedChannel(env, args.This(), backing_store, capacity, side);
+  if (!channel->registered_) {
+    channel->Close();
+    return THROW_ERR_INVALID_ARG_VALUE(
+        env, "This end of the channel has already been opened");
+  }
+}
+
+void SharedChannel::Initialize(Local<Object> target,
+                               Local<Value> unused,
+                               Local<Context> context,
+                               void* priv) {
+  Environment* env = Environment::GetCurrent(context);
+
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+  Local<String> channel_string =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "SharedChannel");
+  t->SetClassName(channel_string);
+  t->InstanceTemplate()
+    ->SetInternalFieldCount(StreamBase::kStreamBaseFieldCount);
+  t->Inherit(HandleWrap::GetConstructorTemplate(env));
+  StreamBase::AddMethods(env, t);
+
+  target->Set(context,
+              channel_string,
+              t->GetFunction(context).ToLocalChecked()).Check();
+
+  NODE_DEFINE_CONSTANT(target, kHeaderSize);
+}
+
+}  // namespace worker
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_INTERNAL(shared_channel,
+                                   node::worker::SharedChannel::Initialize)
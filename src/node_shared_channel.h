@@ -0,0 +1,124 @@
+#ifndef SRC_NODE_SHARED_CHANNEL_H_
+#define SRC_NODE_SHARED_CHANNEL_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "handle_wrap.h"
+#include "stream_base.h"
+#include "v8.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace node {
+namespace worker {
+
+// The state of one direction of a shared channel. It lives at the start of
+// the channel's SharedArrayBuffer, so it is only ever accessed through
+// atomic operations. The indices count bytes and are never wrapped; the
+// position inside the data area is the index modulo the ring capacity.
+struct SharedChannelRing {
+  std::atomic<uint64_t> write_index;
+  char padding1[64 - sizeof(std::atomic<uint64_t>)];
+  std::atomic<uint64_t> read_index;
+  char padding2[64 - sizeof(std::atomic<uint64_t>)];
+  // Set by a reader that found the ring empty and wants to be woken up.
+  std::atomic<uint32_t> reader_waiting;
+  // Set by a writer that found the ring full and wants to be woken up.
+  std::atomic<uint32_t> writer_waiting;
+  // Set once the writing side has shut down or has been closed.
+  std::atomic<uint32_t> ended;
+  // Set once the reading side has been closed.
+  std::atomic<uint32_t> closed;
+  // Set once the writing side has been opened. Each side can only be opened
+  // once, because the flags above are not reset.
+  std::atomic<uint32_t> opened;
+  char padding3[64 - 5 * sizeof(std::atomic<uint32_t>)];
+};
+
+// One end of a channel between two threads that is backed by a single
+// SharedArrayBuffer. The buffer holds two single-producer, single-consumer
+// byte rings, one per direction; the end with side `n` writes to ring `n`
+// and reads from the other one. Data is copied into and out of the shared
+// memory directly, without serialization. The libuv async handle is only
+// signalled when the other end has indicated that it is waiting for data or
+// for free space.
+class SharedChannel : public HandleWrap, public StreamBase {
+ public:
+  static constexpr size_t kHeaderSize = 2 * sizeof(SharedChannelRing);
+  // Upper bound for the amount of data passed on in a single read.
+  static constexpr size_t kMaxReadSize = 64 * 1024;
+
+  static void Initialize(v8::Local<v8::Object> target,
+                         v8::Local<v8::Value> unused,
+                         v8::Local<v8::Context> context,
+                         void* priv);
+
+  ~SharedChannel() override;
+
+  bool IsAlive() override;
+  bool IsClosing() override;
+  int ReadStart() override;
+  int ReadStop() override;
+
+  int DoShutdown(ShutdownWrap* req_wrap) override;
+  int DoTryWrite(uv_buf_t** bufs, size_t* count) override;
+  int DoWrite(WriteWrap* w,
+              uv_buf_t* bufs,
+              size_t count,
+              uv_stream_t* send_handle) override;
+
+  AsyncWrap* GetAsyncWrap() override;
+
+  void Close(
+      v8::Local<v8::Value> close_callback = v8::Local<v8::Value>()) override;
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(SharedChannel)
+  SET_SELF_SIZE(SharedChannel)
+
+ private:
+  SharedChannel(Environment* env,
+                v8::Local<v8::Object> wrap,
+                std::shared_ptr<v8::BackingStore> backing_store,
+                size_t capacity,
+                uint32_t side);
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  inline SharedChannelRing* ring(uint32_t side) const;
+  inline char* ring_data(uint32_t side) const;
+
+  void OnClose() override;
+  void OnSignal();
+  void ReadAvailable();
+  void ContinueWrite();
+  // Copy as much of `bufs` as fits into the outgoing ring and advance
+  // `bufs` and `count` past the data that was written.
+  void WriteAvailable(uv_buf_t** bufs, size_t* count);
+  void Detach();
+
+  // Wake up the end with the given side of the channel backed by `key`,
+  // if it is currently open.
+  static void Signal(const void* key, uint32_t side);
+
+  uv_async_t async_;
+  std::shared_ptr<v8::BackingStore> backing_store_;
+  const size_t capacity_;
+  const uint32_t side_;
+  bool registered_ = false;
+  bool reading_ = false;
+  bool eof_emitted_ = false;
+
+  WriteWrap* pending_write_ = nullptr;
+  std::vector<uv_buf_t> pending_bufs_;
+  size_t pending_index_ = 0;
+};
+
+}  // namespace worker
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_SHARED_CHANNEL_H_
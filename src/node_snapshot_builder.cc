@@ -0,0 +1,319 @@
+#include "node_snapshot_builder.h"
+#include <climits>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include "node_internals.h"
+#include "node_main_instance.h"
+#include "node_v8_platform-inl.h"
+#include "node_version.h"
+
+namespace node {
+
+using v8::Context;
+using v8::HandleScope;
+using v8::Isolate;
+using v8::Local;
+using v8::MicrotasksScope;
+using v8::NewStringType;
+using v8::Script;
+using v8::ScriptCompiler;
+using v8::ScriptOrigin;
+using v8::SnapshotCreator;
+using v8::StartupData;
+using v8::String;
+using v8::TryCatch;
+
+namespace {
+
+// Snapshot files start with this magic number, followed by the version of
+// Node.js and V8 that wrote them, the IsolateData indexes and the V8 startup
+// blob. Numbers are written in the byte order of the host.
+constexpr uint32_t kSnapshotBlobMagic = 0x4e4f4453;  // "NODS"
+// Upper bound for the lengths read from snapshot files, so that corrupt
+// files cannot lead to huge allocations.
+constexpr uint64_t kMaxSnapshotHeaderLength = 1 << 16;
+
+std::string GetSnapshotVersion() {
+  return std::string(NODE_VERSION) + "/v8-" + v8::V8::GetVersion();
+}
+
+template <typename T>
+void WriteValue(std::ostream* out, T value) {
+  out->write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool ReadValue(std::istream* in, T* value) {
+  return static_cast<bool>(
+      in->read(reinterpret_cast<char*>(value), sizeof(*value)));
+}
+
+// Runs the entry script of a user-land snapshot. There is no Environment
+// while the snapshot is being built, so the script only has access to the
+// JavaScript builtins.
+bool RunEntryScript(Isolate* isolate,
+                    Local<Context> context,
+                    const std::string& filename,
+                    const std::string& source) {
+  Context::Scope context_scope(context);
+  TryCatch try_catch(isolate);
+
+  Local<String> source_string;
+  Local<String> filename_string;
+  Local<Script> script;
+  if (!String::NewFromUtf8(isolate,
+                           source.data(),
+                           NewStringType::kNormal,
+                           source.size()).ToLocal(&source_string) ||
+      !String::NewFromUtf8(isolate,
+                           filename.c_str(),
+                           NewStringType::kNormal).ToLocal(&filename_string)) {
+    fprintf(stderr, "Cannot read %s\n", filename.c_str());
+    return false;
+  }
+
+  ScriptOrigin origin(filename_string);
+  ScriptCompiler::Source script_source(source_string, origin);
+  if (!ScriptCompiler::Compile(context, &script_source).ToLocal(&script) ||
+      script->Run(context).IsEmpty()) {
+    PrintCaughtException(isolate, context, try_catch);
+    return false;
+  }
+
+  // Pending microtasks cannot be part of the snapshot, so settle all
+  // promises that the script has created.
+  MicrotasksScope::PerformCheckpoint(isolate);
+  if (try_catch.HasCaught()) {
+    PrintCaughtException(isolate, context, try_catch);
+    return false;
+  }
+  return true;
+}
+
+}  // anonymous namespace
+
+template <typename T>
+void WriteVector(std::stringstream* ss, const T* vec, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    *ss << std::to_string(vec[i]) << (i == size - 1 ? '\n' : ',');
+  }
+}
+
+std::string FormatBlob(v8::StartupData* blob,
+                       const std::vector<size_t>& isolate_data_indexes) {
+  std::stringstream ss;
+
+  ss << R"(#include <cstddef>
+#include "node_main_instance.h"
+#include "v8.h"
+
+// This file is generated by tools/snapshot. Do not edit.
+
+namespace node {
+
+static const char blob_data[] = {
+)";
+  WriteVector(&ss, blob->data, blob->raw_size);
+  ss << R"(};
+
+static const int blob_size = )"
+     << blob->raw_size << R"(;
+static v8::StartupData blob = { blob_data, blob_size };
+)";
+
+  ss << R"(v8::StartupData* NodeMainInstance::GetEmbeddedSnapshotBlob() {
+  return &blob;
+}
+
+static const std::vector<size_t> isolate_data_indexes {
+)";
+  WriteVector(&ss, isolate_data_indexes.data(), isolate_data_indexes.size());
+  ss << R"(};
+
+const std::vector<size_t>* NodeMainInstance::GetIsolateDataIndexes() {
+  return &isolate_data_indexes;
+}
+}  // namespace node
+)";
+
+  return ss.str();
+}
+
+bool SnapshotBuilder::CreateSnapshot(const std::vector<std::string>& args,
+                                     const std::vector<std::string>& exec_args,
+                                     const std::string& entry_file,
+                                     SnapshotData* data) {
+  std::string entry_source;
+  if (!entry_file.empty()) {
+    std::ifstream in(entry_file, std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+      fprintf(stderr, "Cannot open %s\n", entry_file.c_str());
+      return false;
+    }
+    entry_source.assign(std::istreambuf_iterator<char>(in),
+                        std::istreambuf_iterator<char>());
+  }
+
+  // TODO(joyeecheung): collect external references and set it in
+  // params.external_references.
+  std::vector<intptr_t> external_references = {
+      reinterpret_cast<intptr_t>(nullptr)};
+  Isolate* isolate = Isolate::Allocate();
+  per_process::v8_platform.Platform()->RegisterIsolate(isolate,
+                                                       uv_default_loop());
+  std::unique_ptr<NodeMainInstance> main_instance;
+  bool success = true;
+
+  {
+    std::vector<size_t> isolate_data_indexes;
+    SnapshotCreator creator(isolate, external_references.data());
+    {
+      main_instance =
+          NodeMainInstance::Create(isolate,
+                                   uv_default_loop(),
+                                   per_process::v8_platform.Platform(),
+                                   args,
+                                   exec_args);
+      HandleScope scope(isolate);
+      creator.SetDefaultContext(Context::New(isolate));
+      isolate_data_indexes = main_instance->isolate_data()->Serialize(&creator);
+
+      Local<Context> context = NewContext(isolate);
+      if (!entry_file.empty())
+        success = RunEntryScript(isolate, context, entry_file, entry_source);
+      size_t index = creator.AddContext(context);
+      CHECK_EQ(index, NodeMainInstance::kNodeContextIndex);
+
+      Local<Context> vm_context = NewContext(isolate);
+      CHECK(!vm_context.IsEmpty());
+      index = creator.AddContext(vm_context);
+      CHECK_EQ(index, NodeMainInstance::kVmContextIndex);
+    }
+
+    // Must be out of HandleScope.
+    // The compiled code of user-land snapshots is kept, so that the
+    // application does not need to be compiled again when it starts up.
+    StartupData blob = creator.CreateBlob(
+        entry_file.empty() ? SnapshotCreator::FunctionCodeHandling::kClear :
+                             SnapshotCreator::FunctionCodeHandling::kKeep);
+    CHECK(blob.CanBeRehashed());
+    // Must be done while the snapshot creator isolate is entered i.e. the
+    // creator is still alive.
+    main_instance->Dispose();
+    if (success) {
+      data->blob_data.assign(blob.data, blob.data + blob.raw_size);
+      data->blob = { data->blob_data.data(), blob.raw_size };
+      data->isolate_data_indexes = std::move(isolate_data_indexes);
+    }
+    delete[] blob.data;
+  }
+
+  per_process::v8_platform.Platform()->UnregisterIsolate(isolate);
+  return success;
+}
+
+std::string SnapshotBuilder::Generate(
+    const std::vector<std::string> args,
+    const std::vector<std::string> exec_args) {
+  SnapshotData data;
+  CHECK(CreateSnapshot(args, exec_args, "", &data));
+  return FormatBlob(&data.blob, data.isolate_data_indexes);
+}
+
+int SnapshotBuilder::GenerateBlob(const std::vector<std::string>& args,
+                                  const std::vector<std::string>& exec_args,
+                                  const std::string& entry_file,
+                                  const std::string& snapshot_blob_path) {
+  SnapshotData data;
+  if (!CreateSnapshot(args, exec_args, entry_file, &data))
+    return 1;
+
+  std::ofstream out(snapshot_blob_path, std::ios::out | std::ios::binary);
+  if (!out.is_open()) {
+    fprintf(stderr, "Cannot open %s\n", snapshot_blob_path.c_str());
+    return 1;
+  }
+
+  const std::string version = GetSnapshotVersion();
+  WriteValue<uint32_t>(&out, kSnapshotBlobMagic);
+  WriteValue<uint64_t>(&out, version.size());
+  out.write(version.data(), version.size());
+  WriteValue<uint64_t>(&out, data.isolate_data_indexes.size());
+  for (size_t index : data.isolate_data_indexes)
+    WriteValue<uint64_t>(&out, index);
+  WriteValue<uint64_t>(&out, data.blob_data.size());
+  out.write(data.blob_data.data(), data.blob_data.size());
+  out.close();
+
+  if (!out) {
+    fprintf(stderr, "Cannot write %s\n", snapshot_blob_path.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+bool SnapshotBuilder::ReadBlob(const std::string& snapshot_blob_path,
+                               SnapshotData* data,
+                               std::string* error) {
+  std::ifstream in(snapshot_blob_path, std::ios::in | std::ios::binary);
+  if (!in.is_open()) {
+    *error = "Cannot open file";
+    return false;
+  }
+
+  uint32_t magic;
+  uint64_t version_length;
+  if (!ReadValue(&in, &magic) || magic != kSnapshotBlobMagic ||
+      !ReadValue(&in, &version_length) ||
+      version_length > kMaxSnapshotHeaderLength) {
+    *error = "Not a snapshot blob";
+    return false;
+  }
+
+  std::string version(version_length, '\0');
+  if (!in.read(&version[0], version_length)) {
+    *error = "Not a snapshot blob";
+    return false;
+  }
+  if (version != GetSnapshotVersion()) {
+    *error = "The snapshot blob was built by " + version +
+             ", but this is " + GetSnapshotVersion();
+    return false;
+  }
+
+  uint64_t index_count;
+  if (!ReadValue(&in, &index_count) ||
+      index_count > kMaxSnapshotHeaderLength) {
+    *error = "Corrupt snapshot blob";
+    return false;
+  }
+  std::vector<size_t> indexes(index_count);
+  for (size_t& index : indexes) {
+    uint64_t value;
+    if (!ReadValue(&in, &value)) {
+      *error = "Corrupt snapshot blob";
+      return false;
+    }
+    index = value;
+  }
+
+  uint64_t blob_size;
+  if (!ReadValue(&in, &blob_size) || blob_size > INT_MAX) {
+    *error = "Corrupt snapshot blob";
+    return false;
+  }
+  std::vector<char> blob_data(blob_size);
+  if (!in.read(blob_data.data(), blob_size)) {
+    *error = "Corrupt snapshot blob";
+    return false;
+  }
+
+  data->blob_data = std::move(blob_data);
+  data->blob = { data->blob_data.data(), static_cast<int>(blob_size) };
+  data->isolate_data_indexes = std::move(indexes);
+  return true;
+}
+
+}  // namespace node
@@ -0,0 +1,56 @@
+#ifndef SRC_NODE_SNAPSHOT_BUILDER_H_
+#define SRC_NODE_SNAPSHOT_BUILDER_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <string>
+#include <vector>
+#include "v8.h"
+
+namespace node {
+
+// A startup snapshot that has been loaded from a file at runtime.
+struct SnapshotData {
+  // Owns the memory that `blob` points to.
+  std::vector<char> blob_data;
+  v8::StartupData blob = { nullptr, 0 };
+  std::vector<size_t> isolate_data_indexes;
+};
+
+class SnapshotBuilder {
+ public:
+  // Generates the C++ source of the snapshot that is embedded into the
+  // Node.js executable.
+  static std::string Generate(const std::vector<std::string> args,
+                              const std::vector<std::string> exec_args);
+
+  // Runs the script at `entry_file` in the main context, and writes a
+  // snapshot of the resulting heap to `snapshot_blob_path`, so that it can be
+  // loaded with --snapshot-blob. Returns the exit code of the process.
+  static int GenerateBlob(const std::vector<std::string>& args,
+                          const std::vector<std::string>& exec_args,
+                          const std::string& entry_file,
+                          const std::string& snapshot_blob_path);
+
+  // Reads a snapshot written by GenerateBlob(). Returns false and sets
+  // `error` if the file cannot be read or was not written by this version
+  // of Node.js.
+  static bool ReadBlob(const std::string& snapshot_blob_path,
+                       SnapshotData* data,
+                       std::string* error);
+
+ private:
+  // Creates the snapshot, after running the script at `entry_file` in the
+  // main context if it is not empty. Returns false if the script could not
+  // be run, in which case `data` is left untouched.
+  static bool CreateSnapshot(const std::vector<std::string>& args,
+                             const std::vector<std::string>& exec_args,
+                             const std::string& entry_file,
+                             SnapshotData* data);
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_SNAPSHOT_BUILDER_H_
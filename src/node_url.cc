@@ -6,7 +6,9 @@
 
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace node {
@@ -22,8 +24,10 @@ using v8::Int32;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
+using v8::Name;
 using v8::MaybeLocal;
 using v8::NewStringType;
+using v8::Number;
 using v8::Null;
 using v8::Object;
 using v8::String;
@@ -2099,6 +2103,140 @@ void URL::Parse(const char* input,
 }  // NOLINT(readability/fn_size)
 
 namespace {
+// Component offsets of an absolute special URL that ParseSimpleURL()
+// accepted. All of them point into the input, which does not need any
+// percent-encoding or normalization apart from dropping a default port.
+struct simple_url {
+  const char* scheme = nullptr;
+  int32_t flags = URL_FLAGS_SPECIAL | URL_FLAGS_HAS_HOST | URL_FLAGS_HAS_PATH;
+  int port = -1;
+  size_t host_start = 0;
+  size_t host_end = 0;
+  size_t path_end = 0;
+  size_t query_end = 0;
+};
+
+// Returns true if every character is printable ASCII other than space, so
+// that none of them has to be trimmed, stripped or encoded by itself. Checks
+// eight bytes at a time.
+bool IsPrintableASCII(const char* input, size_t len) {
+  constexpr uint64_t kOnes = 0x0101010101010101ull;
+  constexpr uint64_t kHighBits = kOnes * 0x80;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, input + i, sizeof(word));
+    // Bytes above 0x7e have their high bit set after adding 1, bytes below
+    // 0x21 after subtracting 0x21 from them.
+    if ((((word + kOnes) | word) | ((word - kOnes * 0x21) & ~word)) &
+        kHighBits) {
+      return false;
+    }
+  }
+  for (; i < len; i++) {
+    if (input[i] <= ' ' || input[i] > '~')
+      return false;
+  }
+  return true;
+}
+
+// Parses the common case of an absolute URL with a special scheme other than
+// file:, a lowercase domain and no credentials, where the full state machine
+// in URL::Parse() would only copy the components. Returns false if the input
+// needs anything more than that, in which case it has to be parsed by
+// URL::Parse().
+bool ParseSimpleURL(const char* input, size_t len, simple_url* url) {
+  if (!IsPrintableASCII(input, len))
+    return false;
+
+  const char* p = input;
+  const char* end = input + len;
+  int default_port = -1;
+#define V(_, port, name)                                                      \
+  if (url->scheme == nullptr && port != -1 &&                                 \
+      static_cast<size_t>(end - p) > sizeof(name "//") - 1 &&                 \
+      memcmp(p, name "//", sizeof(name "//") - 1) == 0) {                     \
+    url->scheme = name;                                                       \
+    default_port = port;                                                      \
+    p += sizeof(name "//") - 1;                                               \
+  }
+  SPECIALS(V)
+#undef V
+  if (url->scheme == nullptr)
+    return false;
+
+  // Only domains that ToASCII() would leave as they are, and that are not
+  // IPv4 addresses because their last label starts with a letter.
+  url->host_start = p - input;
+  bool alpha_label = false;
+  for (const char* label = p; p < end; p++) {
+    const char ch = *p;
+    if (ch == ':' || ch == '/' || ch == '?' || ch == '#')
+      break;
+    if (ch == '.') {
+      label = p + 1;
+      continue;
+    }
+    if (p == label) {
+      if (end - p >= 4 && memcmp(p, "xn--", 4) == 0)
+        return false;
+      alpha_label = ch >= 'a' && ch <= 'z';
+    }
+    if (!(ch >= 'a' && ch <= 'z') && !IsASCIIDigit(ch) && ch != '-')
+      return false;
+  }
+  url->host_end = p - input;
+  if (!alpha_label)
+    return false;
+
+  if (p < end && *p == ':') {
+    unsigned port = 0;
+    const char* port_start = ++p;
+    for (; p < end && IsASCIIDigit(*p); p++) {
+      port = port * 10 + (*p - '0');
+      if (port > 0xffff)
+        return false;
+    }
+    if (p < end && *p != '/' && *p != '?' && *p != '#')
+      return false;
+    if (p > port_start) {
+      if (static_cast<int>(port) == default_port)
+        url->flags |= URL_FLAGS_IS_DEFAULT_SCHEME_PORT;
+      else
+        url->port = port;
+    }
+  }
+
+  // Dot segments and segments starting with a percent-encoded dot are left
+  // to URL::Parse().
+  for (; p < end && *p != '?' && *p != '#'; p++) {
+    const unsigned char ch = *p;
+    if (ch == '\\' || BitAt(PATH_ENCODE_SET, ch))
+      return false;
+    if ((ch == '.' || ch == '%') && p[-1] == '/')
+      return false;
+  }
+  url->path_end = p - input;
+
+  if (p < end && *p == '?') {
+    url->flags |= URL_FLAGS_HAS_QUERY;
+    for (p++; p < end && *p != '#'; p++) {
+      if (BitAt(QUERY_ENCODE_SET_SPECIAL, *p))
+        return false;
+    }
+  }
+  url->query_end = p - input;
+
+  if (p < end) {
+    url->flags |= URL_FLAGS_HAS_FRAGMENT;
+    for (p++; p < end; p++) {
+      if (BitAt(FRAGMENT_ENCODE_SET, *p))
+        return false;
+    }
+  }
+  return true;
+}
+
 void SetArgs(Environment* env,
              Local<Value> argv[ARG_COUNT],
              const struct url_data& url) {
@@ -2124,6 +2262,51 @@ void SetArgs(Environment* env,
     argv[ARG_PATH] = ToV8Value(env->context(), url.path).ToLocalChecked();
 }
 
+void SetArgs(Environment* env,
+             Local<Value> argv[ARG_COUNT],
+             const char* input,
+             size_t len,
+             const struct simple_url& url) {
+  Isolate* isolate = env->isolate();
+  argv[ARG_FLAGS] = Integer::NewFromUnsigned(isolate, url.flags);
+  argv[ARG_PROTOCOL] = GetSpecial(env, url.scheme);
+  argv[ARG_HOST] = OneByteString(isolate,
+                                 input + url.host_start,
+                                 url.host_end - url.host_start);
+  if (url.port > -1)
+    argv[ARG_PORT] = Integer::New(isolate, url.port);
+
+  // The path is empty or starts with a slash, which is not part of the first
+  // segment.
+  const char* path_start = input + url.path_end;
+  for (const char* p = input + url.host_end; p < input + url.path_end; p++) {
+    if (*p == '/') {
+      path_start = p + 1;
+      break;
+    }
+  }
+  std::vector<Local<Value>> segments;
+  const char* segment = path_start;
+  for (const char* p = path_start; p <= input + url.path_end; p++) {
+    if (p == input + url.path_end || *p == '/') {
+      segments.push_back(OneByteString(isolate, segment, p - segment));
+      segment = p + 1;
+    }
+  }
+  argv[ARG_PATH] = Array::New(isolate, segments.data(), segments.size());
+
+  if (url.flags & URL_FLAGS_HAS_QUERY) {
+    argv[ARG_QUERY] = OneByteString(isolate,
+                                    input + url.path_end + 1,
+                                    url.query_end - url.path_end - 1);
+  }
+  if (url.flags & URL_FLAGS_HAS_FRAGMENT) {
+    argv[ARG_FRAGMENT] = OneByteString(isolate,
+                                       input + url.query_end + 1,
+                                       len - url.query_end - 1);
+  }
+}
+
 void Parse(Environment* env,
            Local<Value> recv,
            const char* input,
@@ -2141,6 +2324,29 @@ void Parse(Environment* env,
   const bool has_context = context_obj->IsObject();
   const bool has_base = base_obj->IsObject();
 
+  // Define the return value placeholders
+  const Local<Value> undef = Undefined(isolate);
+  const Local<Value> null = Null(isolate);
+
+  simple_url simple;
+  if (!has_context && !has_base && state_override == kUnknownState &&
+      ParseSimpleURL(input, len, &simple)) {
+    Local<Value> argv[] = {
+      undef,
+      undef,
+      undef,
+      undef,
+      null,  // host defaults to null
+      null,  // port defaults to null
+      undef,
+      null,  // query defaults to null
+      null,  // fragment defaults to null
+    };
+    SetArgs(env, argv, input, len, simple);
+    cb->Call(context, recv, arraysize(argv), argv).FromMaybe(Local<Value>());
+    return;
+  }
+
   url_data base;
   url_data url;
   if (has_context)
@@ -2154,9 +2360,6 @@ void Parse(Environment* env,
        (url.flags & URL_FLAGS_TERMINATED)))
     return;
 
-  // Define the return value placeholders
-  const Local<Value> undef = Undefined(isolate);
-  const Local<Value> null = Null(isolate);
   if (!(url.flags & URL_FLAGS_FAILED)) {
     Local<Value> argv[] = {
       undef,
@@ -2264,6 +2467,163 @@ void ToUSVString(const FunctionCallbackInfo<Value>& args) {
                              value.length()).ToLocalChecked());
 }
 
+// Returns true if |input| contains a '%' or a '+'. Checks eight bytes at a
+// time.
+bool HasQueryStringEscapes(const char* input, size_t len) {
+  constexpr uint64_t kOnes = 0x0101010101010101ull;
+  constexpr uint64_t kHighBits = kOnes * 0x80;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, input + i, sizeof(word));
+    // A byte of |word| equals |ch| if it is zero after XOR-ing with |ch|.
+    const uint64_t percent = word ^ (kOnes * '%');
+    const uint64_t plus = word ^ (kOnes * '+');
+    if ((((percent - kOnes) & ~percent) | ((plus - kOnes) & ~plus)) &
+        kHighBits) {
+      return true;
+    }
+  }
+  for (; i < len; i++) {
+    if (input[i] == '%' || input[i] == '+')
+      return true;
+  }
+  return false;
+}
+
+// Decodes a key or a value the way querystring.parse() does: '+' is a space,
+// and %XX sequences are decoded as in querystring.unescapeBuffer(), which is
+// what querystring.unescape() falls back to when decodeURIComponent() fails
+// and which gives the same bytes when it does not. If |utf8| is not null, it
+// is set to the UTF-8 representation of the result.
+Local<String> QueryStringDecode(Isolate* isolate,
+                                const char* input,
+                                size_t len,
+                                std::string* scratch,
+                                std::string* utf8 = nullptr) {
+  if (!HasQueryStringEscapes(input, len)) {
+    if (utf8 != nullptr)
+      utf8->assign(input, len);
+    return OneByteString(isolate, input, len);
+  }
+
+  auto at = [&](size_t index) {
+    return input[index] == '+' ? ' ' : input[index];
+  };
+  scratch->clear();
+  bool is_ascii = true;
+  for (size_t i = 0; i < len; i++) {
+    char ch = at(i);
+    if (ch == '%' && i + 2 < len) {
+      ch = at(++i);
+      const unsigned high = hex2bin(ch);
+      if (high == static_cast<unsigned>(-1)) {
+        *scratch += '%';
+      } else {
+        const char next = at(++i);
+        const unsigned low = hex2bin(next);
+        if (low == static_cast<unsigned>(-1)) {
+          *scratch += '%';
+          *scratch += ch;
+          ch = next;
+        } else {
+          ch = static_cast<char>(high * 16 + low);
+          is_ascii = is_ascii && high < 8;
+        }
+      }
+    }
+    *scratch += ch;
+  }
+
+  if (is_ascii) {
+    if (utf8 != nullptr)
+      *utf8 = *scratch;
+    return OneByteString(isolate, scratch->data(), scratch->size());
+  }
+  // Invalid sequences are replaced, so |scratch| may not be the UTF-8
+  // representation of the result.
+  Local<String> result = String::NewFromUtf8(isolate,
+                                             scratch->data(),
+                                             NewStringType::kNormal,
+                                             scratch->size()).ToLocalChecked();
+  if (utf8 != nullptr) {
+    Utf8Value value(isolate, result);
+    utf8->assign(*value, value.length());
+  }
+  return result;
+}
+
+// Implements querystring.parse() with the default separators and decoder
+// for ASCII input. Returns undefined for other input, which then has to be
+// parsed in JS.
+void ParseQueryString(const FunctionCallbackInfo<Value>& args) {
+  Isolate* isolate = args.GetIsolate();
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsNumber());
+  Local<String> qs = args[0].As<String>();
+  // Like in JS, a non-positive maxKeys never reaches 0 and means no limit.
+  double pairs = args[1].As<Number>()->Value();
+
+  if (!qs->ContainsOnlyOneByte())
+    return;
+  MaybeStackBuffer<char, 1024> input(qs->Length());
+  qs->WriteOneByte(isolate,
+                   reinterpret_cast<uint8_t*>(*input),
+                   0,
+                   qs->Length(),
+                   String::NO_NULL_TERMINATION);
+  const char* p = *input;
+  const char* end = p + qs->Length();
+  for (const char* ptr = p; ptr < end; ptr++) {
+    if (static_cast<unsigned char>(*ptr) >= 0x80)
+      return;
+  }
+
+  std::vector<Local<Name>> keys;
+  std::vector<std::vector<Local<Value>>> values;
+  std::unordered_map<std::string, size_t> key_index;
+  std::string scratch;
+  std::string key_utf8;
+  while (p < end) {
+    const char* sep = static_cast<const char*>(memchr(p, '&', end - p));
+    const char* pair_end = sep != nullptr ? sep : end;
+    if (pair_end > p) {
+      const char* eq = static_cast<const char*>(memchr(p, '=', pair_end - p));
+      const char* key_end = eq != nullptr ? eq : pair_end;
+      const char* value_start = eq != nullptr ? eq + 1 : pair_end;
+      Local<String> key =
+          QueryStringDecode(isolate, p, key_end - p, &scratch, &key_utf8);
+      Local<String> value = QueryStringDecode(
+          isolate, value_start, pair_end - value_start, &scratch);
+
+      auto it = key_index.emplace(key_utf8, keys.size());
+      if (it.second) {
+        keys.push_back(key);
+        values.emplace_back(1, value);
+      } else {
+        values[it.first->second].push_back(value);
+      }
+    }
+    if (sep == nullptr || --pairs == 0)
+      break;
+    p = sep + 1;
+  }
+
+  std::vector<Local<Value>> properties;
+  properties.reserve(values.size());
+  for (std::vector<Local<Value>>& list : values) {
+    if (list.size() == 1)
+      properties.push_back(list[0]);
+    else
+      properties.push_back(Array::New(isolate, list.data(), list.size()));
+  }
+  args.GetReturnValue().Set(Object::New(isolate,
+                                        Null(isolate),
+                                        keys.data(),
+                                        properties.data(),
+                                        keys.size()));
+}
+
 void DomainToASCII(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   CHECK_GE(args.Length(), 1);
@@ -2319,6 +2679,7 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "parse", Parse);
   env->SetMethodNoSideEffect(target, "encodeAuth", EncodeAuthSet);
   env->SetMethodNoSideEffect(target, "toUSVString", ToUSVString);
+  env->SetMethodNoSideEffect(target, "parseQueryString", ParseQueryString);
   env->SetMethodNoSideEffect(target, "domainToASCII", DomainToASCII);
   env->SetMethodNoSideEffect(target, "domainToUnicode", DomainToUnicode);
   env->SetMethod(target, "setURLConstructor", SetURLConstructor);
@@ -2333,6 +2694,35 @@ void Initialize(Local<Object> target,
 }
 }  // namespace
 
+std::string URL::href() const {
+  std::string ret = context_.scheme;
+  if (context_.flags & URL_FLAGS_HAS_HOST) {
+    ret += "//";
+    if (!context_.username.empty() || !context_.password.empty()) {
+      ret += context_.username;
+      if (!context_.password.empty())
+        ret += ":" + context_.password;
+      ret += "@";
+    }
+    ret += context_.host;
+    if (context_.port != -1)
+      ret += ":" + std::to_string(context_.port);
+  } else if (context_.scheme == "file:") {
+    ret += "//";
+  }
+  if (context_.flags & URL_FLAGS_CANNOT_BE_BASE) {
+    if (!context_.path.empty())
+      ret += context_.path[0];
+  } else {
+    ret += path();
+  }
+  if (context_.flags & URL_FLAGS_HAS_QUERY)
+    ret += "?" + context_.query;
+  if (context_.flags & URL_FLAGS_HAS_FRAGMENT)
+    ret += "#" + context_.fragment;
+  return ret;
+}
+
 std::string URL::ToFilePath() const {
   if (context_.scheme != "file:") {
     return "";
@@ -2397,11 +2787,20 @@ std::string URL::ToFilePath() const {
 
 URL URL::FromFilePath(const std::string& file_path) {
   URL url("file://");
+  // Escape the characters that pathToFileURL() escapes, which would otherwise
+  // be taken as part of an escape sequence, a path separator, or be dropped.
   std::string escaped_file_path;
   for (size_t i = 0; i < file_path.length(); ++i) {
-    escaped_file_path += file_path[i];
-    if (file_path[i] == '%')
-      escaped_file_path += "25";
+    switch (file_path[i]) {
+      case '%': escaped_file_path += "%25"; break;
+#ifndef _WIN32
+      case '\\': escaped_file_path += "%5C"; break;
+#endif
+      case '\n': escaped_file_path += "%0A"; break;
+      case '\r': escaped_file_path += "%0D"; break;
+      case '\t': escaped_file_path += "%09"; break;
+      default: escaped_file_path += file_path[i];
+    }
   }
   URL::Parse(escaped_file_path.c_str(), escaped_file_path.length(), kPathStart,
              &url.context_, true, nullptr, false);
@@ -160,6 +160,9 @@ class URL {
     return ret;
   }
 
+  // Serialize the URL in the same way as the href getter of the JS URL class.
+  std::string href() const;
+
   // Get the path of the file: URL in a format consumable by native file system
   // APIs. Returns an empty string if something went wrong.
   std::string ToFilePath() const;
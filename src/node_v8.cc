@@ -21,6 +21,7 @@
 
 #include "node.h"
 #include "env-inl.h"
+#include "node_internals.h"
 #include "util-inl.h"
 #include "v8.h"
 
@@ -38,6 +39,7 @@ using v8::Integer;
 using v8::Isolate;
 using v8::Local;
 using v8::NewStringType;
+using v8::Number;
 using v8::Object;
 using v8::ScriptCompiler;
 using v8::String;
@@ -177,6 +179,12 @@ void Initialize(Local<Object> target,
   HEAP_STATISTICS_PROPERTIES(V)
 #undef V
 
+  // The memory that the default heap size limit is derived from.
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "memoryLimit"),
+              Number::New(env->isolate(),
+                          static_cast<double>(GetAvailableMemory()))).Check();
+
   // Export symbols used by v8.getHeapCodeStatistics()
   env->SetMethod(target,
                  "updateHeapCodeStatisticsArrayBuffer",
@@ -6,6 +6,9 @@
 #include <memory>
 
 #include "env-inl.h"
+#if defined(NODE_ENABLE_LARGE_CODE_PAGES) && NODE_ENABLE_LARGE_CODE_PAGES
+#include "large_pages/node_large_page.h"
+#endif
 #include "node.h"
 #include "node_metadata.h"
 #include "node_options.h"
@@ -38,6 +41,10 @@ class NodeTraceStateObserver
     auto trace_process = tracing::TracedValue::Create();
     trace_process->BeginDictionary("versions");
 
+#ifdef NODE_HAVE_I18N_SUPPORT
+    per_process::metadata.versions.InitializeIntlVersions();
+#endif  // NODE_HAVE_I18N_SUPPORT
+
 #define V(key)                                                                 \
   trace_process->SetString(#key, per_process::metadata.versions.key.c_str());
 
@@ -81,7 +88,8 @@ class NodeTraceStateObserver
 struct V8Platform {
 #if NODE_USE_V8_PLATFORM
   inline void Initialize(int thread_pool_size) {
-    tracing_agent_ = std::make_unique<tracing::Agent>();
+    tracing_agent_ = std::make_unique<tracing::Agent>(
+        per_process::cli_options->trace_event_flight_recorder);
     node::tracing::TraceEventHelper::SetAgent(tracing_agent_.get());
     node::tracing::TracingController* controller =
         tracing_agent_->GetTracingController();
@@ -93,8 +101,16 @@ struct V8Platform {
     if (!per_process::cli_options->trace_event_categories.empty()) {
       StartTracingAgent();
     }
+    v8::PageAllocator* page_allocator = nullptr;
+#if defined(NODE_ENABLE_LARGE_CODE_PAGES) && NODE_ENABLE_LARGE_CODE_PAGES
+    if (per_process::cli_options->use_largepages_heap != "off")
+      page_allocator = GetLargePageAllocator();
+#endif
     // Tracing must be initialized before platform threads are created.
-    platform_ = new NodePlatform(thread_pool_size, controller);
+    platform_ = new NodePlatform(thread_pool_size,
+                                 controller,
+                                 per_process::cli_options->v8_pool_affinity,
+                                 page_allocator);
     v8::V8::InitializePlatform(platform_);
   }
 
@@ -125,13 +141,21 @@ struct V8Platform {
                                 std::make_move_iterator(categories.end())),
           std::unique_ptr<tracing::AsyncTraceWriter>(
               new tracing::NodeTraceWriter(
-                  per_process::cli_options->trace_event_file_pattern)),
+                  per_process::cli_options->trace_event_file_pattern,
+                  per_process::cli_options->trace_event_format == "binary" ?
+                      tracing::NodeTraceWriter::kBinary :
+                      tracing::NodeTraceWriter::kJSON)),
           tracing::Agent::kUseDefaultCategories);
     }
   }
 
   inline void StopTracingAgent() { tracing_file_writer_.reset(); }
 
+  inline void DumpTraceBuffer() {
+    if (tracing_agent_)
+      tracing_agent_->DumpTraceBuffer();
+  }
+
   inline tracing::AgentWriterHandle* GetTracingAgentWriter() {
     return &tracing_file_writer_;
   }
@@ -154,6 +178,7 @@ struct V8Platform {
     }
   }
   inline void StopTracingAgent() {}
+  inline void DumpTraceBuffer() {}
 
   inline tracing::AgentWriterHandle* GetTracingAgentWriter() { return nullptr; }
 
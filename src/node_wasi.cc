@@ -15,7 +15,52 @@ namespace wasi {
 static inline bool is_access_oob(size_t mem_size,
                                  uint32_t offset,
                                  uint32_t buf_size) {
-  return offset + buf_size > mem_size;
+  return static_cast<uint64_t>(offset) + buf_size > mem_size;
+}
+
+// Most calls pass only a few iovecs, which are translated without allocating.
+static constexpr size_t kStackIovecs = 16;
+
+static inline uint32_t read_le_uint32(const char* p) {
+  uint32_t value;
+  if (IsLittleEndian()) {
+    memcpy(&value, p, sizeof(value));
+    return value;
+  }
+  return (p[0] & 0xFF) |
+         ((p[1] & 0xFF) << 8) |
+         ((p[2] & 0xFF) << 16) |
+         ((p[3] & 0xFF) << 24);
+}
+
+// Translates the |count| iovecs at |offset| in the WebAssembly memory into
+// |iovs|. The buffers point into the memory itself, so no data is copied.
+template <typename T>
+static uvwasi_errno_t read_iovecs(char* memory,
+                                  size_t mem_size,
+                                  uint32_t offset,
+                                  uint32_t count,
+                                  MaybeStackBuffer<T, kStackIovecs>* iovs) {
+  // The iovec array is checked as a whole, without overflowing its size.
+  if (static_cast<uint64_t>(offset) + static_cast<uint64_t>(count) * 8 >
+      mem_size) {
+    return UVWASI_EOVERFLOW;
+  }
+
+  iovs->AllocateSufficientStorage(count);
+  T* out = iovs->out();
+  const char* iov = memory + offset;
+  for (uint32_t i = 0; i < count; ++i, iov += 8) {
+    uint32_t buf_ptr = read_le_uint32(iov);
+    uint32_t buf_len = read_le_uint32(iov + 4);
+
+    if (is_access_oob(mem_size, buf_ptr, buf_len))
+      return UVWASI_EOVERFLOW;
+
+    out[i].buf = &memory[buf_ptr];
+    out[i].buf_len = buf_len;
+  }
+  return UVWASI_ESUCCESS;
 }
 
 template <typename... Args>
@@ -142,6 +187,7 @@ WASI::~WASI() {
 
 void WASI::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("memory", memory_);
+  tracker->TrackField("memory_buffer", memory_buffer_);
   tracker->TrackFieldWithSize("uvwasi_memory", current_uvwasi_memory_);
 }
 
@@ -629,44 +675,25 @@ void WASI::FdPread(const FunctionCallbackInfo<Value>& args) {
         offset,
         nread_ptr);
   GET_BACKING_STORE_OR_RETURN(wasi, args, &memory, &mem_size);
-  CHECK_BOUNDS_OR_RETURN(args, mem_size, iovs_ptr, iovs_len * 8);
   CHECK_BOUNDS_OR_RETURN(args, mem_size, nread_ptr, 4);
-  uvwasi_iovec_t* iovs = UncheckedCalloc<uvwasi_iovec_t>(iovs_len);
-
-  if (iovs == nullptr) {
-    args.GetReturnValue().Set(UVWASI_ENOMEM);
+  MaybeStackBuffer<uvwasi_iovec_t, kStackIovecs> iovs;
+  uvwasi_errno_t err =
+      read_iovecs(memory, mem_size, iovs_ptr, iovs_len, &iovs);
+  if (err != UVWASI_ESUCCESS) {
+    args.GetReturnValue().Set(err);
     return;
   }
 
-  for (uint32_t i = 0; i < iovs_len; ++i) {
-    uint32_t buf_ptr;
-    uint32_t buf_len;
-
-    wasi->readUInt32(memory, &buf_ptr, iovs_ptr);
-    wasi->readUInt32(memory, &buf_len, iovs_ptr + 4);
-
-    if (is_access_oob(mem_size, buf_ptr, buf_len)) {
-      free(iovs);
-      args.GetReturnValue().Set(UVWASI_EOVERFLOW);
-      return;
-    }
-
-    iovs_ptr += 8;
-    iovs[i].buf = static_cast<void*>(&memory[buf_ptr]);
-    iovs[i].buf_len = buf_len;
-  }
-
   size_t nread;
-  uvwasi_errno_t err = uvwasi_fd_pread(&wasi->uvw_,
-                                       fd,
-                                       iovs,
-                                       iovs_len,
-                                       offset,
-                                       &nread);
+  err = uvwasi_fd_pread(&wasi->uvw_,
+                        fd,
+                        *iovs,
+                        iovs_len,
+                        offset,
+                        &nread);
   if (err == UVWASI_ESUCCESS)
     wasi->writeUInt32(memory, nread, nread_ptr);
 
-  free(iovs);
   args.GetReturnValue().Set(err);
 }
 
@@ -743,44 +770,25 @@ void WASI::FdPwrite(const FunctionCallbackInfo<Value>& args) {
         offset,
         nwritten_ptr);
   GET_BACKING_STORE_OR_RETURN(wasi, args, &memory, &mem_size);
-  CHECK_BOUNDS_OR_RETURN(args, mem_size, iovs_ptr, iovs_len * 8);
   CHECK_BOUNDS_OR_RETURN(args, mem_size, nwritten_ptr, 4);
-  uvwasi_ciovec_t* iovs = UncheckedCalloc<uvwasi_ciovec_t>(iovs_len);
-
-  if (iovs == nullptr) {
-    args.GetReturnValue().Set(UVWASI_ENOMEM);
+  MaybeStackBuffer<uvwasi_ciovec_t, kStackIovecs> iovs;
+  uvwasi_errno_t err =
+      read_iovecs(memory, mem_size, iovs_ptr, iovs_len, &iovs);
+  if (err != UVWASI_ESUCCESS) {
+    args.GetReturnValue().Set(err);
     return;
   }
 
-  for (uint32_t i = 0; i < iovs_len; ++i) {
-    uint32_t buf_ptr;
-    uint32_t buf_len;
-
-    wasi->readUInt32(memory, &buf_ptr, iovs_ptr);
-    wasi->readUInt32(memory, &buf_len, iovs_ptr + 4);
-
-    if (is_access_oob(mem_size, buf_ptr, buf_len)) {
-      free(iovs);
-      args.GetReturnValue().Set(UVWASI_EOVERFLOW);
-      return;
-    }
-
-    iovs_ptr += 8;
-    iovs[i].buf = static_cast<void*>(&memory[buf_ptr]);
-    iovs[i].buf_len = buf_len;
-  }
-
   size_t nwritten;
-  uvwasi_errno_t err = uvwasi_fd_pwrite(&wasi->uvw_,
-                                        fd,
-                                        iovs,
-                                        iovs_len,
-                                        offset,
-                                        &nwritten);
+  err = uvwasi_fd_pwrite(&wasi->uvw_,
+                         fd,
+                         *iovs,
+                         iovs_len,
+                         offset,
+                         &nwritten);
   if (err == UVWASI_ESUCCESS)
     wasi->writeUInt32(memory, nwritten, nwritten_ptr);
 
-  free(iovs);
   args.GetReturnValue().Set(err);
 }
 
@@ -801,43 +809,24 @@ void WASI::FdRead(const FunctionCallbackInfo<Value>& args) {
   ASSIGN_OR_RETURN_UNWRAP(&wasi, args.This());
   Debug(wasi, "fd_read(%d, %d, %d, %d)\n", fd, iovs_ptr, iovs_len, nread_ptr);
   GET_BACKING_STORE_OR_RETURN(wasi, args, &memory, &mem_size);
-  CHECK_BOUNDS_OR_RETURN(args, mem_size, iovs_ptr, iovs_len * 8);
   CHECK_BOUNDS_OR_RETURN(args, mem_size, nread_ptr, 4);
-  uvwasi_iovec_t* iovs = UncheckedCalloc<uvwasi_iovec_t>(iovs_len);
-
-  if (iovs == nullptr) {
-    args.GetReturnValue().Set(UVWASI_ENOMEM);
+  MaybeStackBuffer<uvwasi_iovec_t, kStackIovecs> iovs;
+  uvwasi_errno_t err =
+      read_iovecs(memory, mem_size, iovs_ptr, iovs_len, &iovs);
+  if (err != UVWASI_ESUCCESS) {
+    args.GetReturnValue().Set(err);
     return;
   }
 
-  for (uint32_t i = 0; i < iovs_len; ++i) {
-    uint32_t buf_ptr;
-    uint32_t buf_len;
-
-    wasi->readUInt32(memory, &buf_ptr, iovs_ptr);
-    wasi->readUInt32(memory, &buf_len, iovs_ptr + 4);
-
-    if (is_access_oob(mem_size, buf_ptr, buf_len)) {
-      free(iovs);
-      args.GetReturnValue().Set(UVWASI_EOVERFLOW);
-      return;
-    }
-
-    iovs_ptr += 8;
-    iovs[i].buf = static_cast<void*>(&memory[buf_ptr]);
-    iovs[i].buf_len = buf_len;
-  }
-
   size_t nread;
-  uvwasi_errno_t err = uvwasi_fd_read(&wasi->uvw_,
-                                      fd,
-                                      iovs,
-                                      iovs_len,
-                                      &nread);
+  err = uvwasi_fd_read(&wasi->uvw_,
+                       fd,
+                       *iovs,
+                       iovs_len,
+                       &nread);
   if (err == UVWASI_ESUCCESS)
     wasi->writeUInt32(memory, nread, nread_ptr);
 
-  free(iovs);
   args.GetReturnValue().Set(err);
 }
 
@@ -982,43 +971,24 @@ void WASI::FdWrite(const FunctionCallbackInfo<Value>& args) {
         iovs_len,
         nwritten_ptr);
   GET_BACKING_STORE_OR_RETURN(wasi, args, &memory, &mem_size);
-  CHECK_BOUNDS_OR_RETURN(args, mem_size, iovs_ptr, iovs_len * 8);
   CHECK_BOUNDS_OR_RETURN(args, mem_size, nwritten_ptr, 4);
-  uvwasi_ciovec_t* iovs = UncheckedCalloc<uvwasi_ciovec_t>(iovs_len);
-
-  if (iovs == nullptr) {
-    args.GetReturnValue().Set(UVWASI_ENOMEM);
+  MaybeStackBuffer<uvwasi_ciovec_t, kStackIovecs> iovs;
+  uvwasi_errno_t err =
+      read_iovecs(memory, mem_size, iovs_ptr, iovs_len, &iovs);
+  if (err != UVWASI_ESUCCESS) {
+    args.GetReturnValue().Set(err);
     return;
   }
 
-  for (uint32_t i = 0; i < iovs_len; ++i) {
-    uint32_t buf_ptr;
-    uint32_t buf_len;
-
-    wasi->readUInt32(memory, &buf_ptr, iovs_ptr);
-    wasi->readUInt32(memory, &buf_len, iovs_ptr + 4);
-
-    if (is_access_oob(mem_size, buf_ptr, buf_len)) {
-      free(iovs);
-      args.GetReturnValue().Set(UVWASI_EOVERFLOW);
-      return;
-    }
-
-    iovs_ptr += 8;
-    iovs[i].buf = static_cast<void*>(&memory[buf_ptr]);
-    iovs[i].buf_len = buf_len;
-  }
-
   size_t nwritten;
-  uvwasi_errno_t err = uvwasi_fd_write(&wasi->uvw_,
-                                       fd,
-                                       iovs,
-                                       iovs_len,
-                                       &nwritten);
+  err = uvwasi_fd_write(&wasi->uvw_,
+                        fd,
+                        *iovs,
+                        iovs_len,
+                        &nwritten);
   if (err == UVWASI_ESUCCESS)
     wasi->writeUInt32(memory, nwritten, nwritten_ptr);
 
-  free(iovs);
   args.GetReturnValue().Set(err);
 }
 
@@ -1572,49 +1542,30 @@ void WASI::SockRecv(const FunctionCallbackInfo<Value>& args) {
         ro_datalen_ptr,
         ro_flags_ptr);
   GET_BACKING_STORE_OR_RETURN(wasi, args, &memory, &mem_size);
-  CHECK_BOUNDS_OR_RETURN(args, mem_size, ri_data_ptr, ri_data_len * 8);
   CHECK_BOUNDS_OR_RETURN(args, mem_size, ro_datalen_ptr, 4);
   CHECK_BOUNDS_OR_RETURN(args, mem_size, ro_flags_ptr, 4);
-  uvwasi_iovec_t* ri_data = UncheckedCalloc<uvwasi_iovec_t>(ri_data_len);
-
-  if (ri_data == nullptr) {
-    args.GetReturnValue().Set(UVWASI_ENOMEM);
+  MaybeStackBuffer<uvwasi_iovec_t, kStackIovecs> ri_data;
+  uvwasi_errno_t err =
+      read_iovecs(memory, mem_size, ri_data_ptr, ri_data_len, &ri_data);
+  if (err != UVWASI_ESUCCESS) {
+    args.GetReturnValue().Set(err);
     return;
   }
 
-  for (uint32_t i = 0; i < ri_data_len; ++i) {
-    uint32_t buf_ptr;
-    uint32_t buf_len;
-
-    wasi->readUInt32(memory, &buf_ptr, ri_data_ptr);
-    wasi->readUInt32(memory, &buf_len, ri_data_ptr + 4);
-
-    if (is_access_oob(mem_size, buf_ptr, buf_len)) {
-      free(ri_data);
-      args.GetReturnValue().Set(UVWASI_EOVERFLOW);
-      return;
-    }
-
-    ri_data_ptr += 8;
-    ri_data[i].buf = static_cast<void*>(&memory[buf_ptr]);
-    ri_data[i].buf_len = buf_len;
-  }
-
   size_t ro_datalen;
   uvwasi_roflags_t ro_flags;
-  uvwasi_errno_t err = uvwasi_sock_recv(&wasi->uvw_,
-                                        sock,
-                                        ri_data,
-                                        ri_data_len,
-                                        ri_flags,
-                                        &ro_datalen,
-                                        &ro_flags);
+  err = uvwasi_sock_recv(&wasi->uvw_,
+                         sock,
+                         *ri_data,
+                         ri_data_len,
+                         ri_flags,
+                         &ro_datalen,
+                         &ro_flags);
   if (err == UVWASI_ESUCCESS) {
     wasi->writeUInt32(memory, ro_datalen, ro_datalen_ptr);
     wasi->writeUInt32(memory, ro_flags, ro_flags_ptr);
   }
 
-  free(ri_data);
   args.GetReturnValue().Set(err);
 }
 
@@ -1643,44 +1594,25 @@ void WASI::SockSend(const FunctionCallbackInfo<Value>& args) {
         si_flags,
         so_datalen_ptr);
   GET_BACKING_STORE_OR_RETURN(wasi, args, &memory, &mem_size);
-  CHECK_BOUNDS_OR_RETURN(args, mem_size, si_data_ptr, si_data_len * 8);
   CHECK_BOUNDS_OR_RETURN(args, mem_size, so_datalen_ptr, 4);
-  uvwasi_ciovec_t* si_data = UncheckedCalloc<uvwasi_ciovec_t>(si_data_len);
-
-  if (si_data == nullptr) {
-    args.GetReturnValue().Set(UVWASI_ENOMEM);
+  MaybeStackBuffer<uvwasi_ciovec_t, kStackIovecs> si_data;
+  uvwasi_errno_t err =
+      read_iovecs(memory, mem_size, si_data_ptr, si_data_len, &si_data);
+  if (err != UVWASI_ESUCCESS) {
+    args.GetReturnValue().Set(err);
     return;
   }
 
-  for (uint32_t i = 0; i < si_data_len; ++i) {
-    uint32_t buf_ptr;
-    uint32_t buf_len;
-
-    wasi->readUInt32(memory, &buf_ptr, si_data_ptr);
-    wasi->readUInt32(memory, &buf_len, si_data_ptr + 4);
-
-    if (is_access_oob(mem_size, buf_ptr, buf_len)) {
-      free(si_data);
-      args.GetReturnValue().Set(UVWASI_EOVERFLOW);
-      return;
-    }
-
-    si_data_ptr += 8;
-    si_data[i].buf = static_cast<void*>(&memory[buf_ptr]);
-    si_data[i].buf_len = buf_len;
-  }
-
   size_t so_datalen;
-  uvwasi_errno_t err = uvwasi_sock_send(&wasi->uvw_,
-                                        sock,
-                                        si_data,
-                                        si_data_len,
-                                        si_flags,
-                                        &so_datalen);
+  err = uvwasi_sock_send(&wasi->uvw_,
+                         sock,
+                         *si_data,
+                         si_data_len,
+                         si_flags,
+                         &so_datalen);
   if (err == UVWASI_ESUCCESS)
     wasi->writeUInt32(memory, so_datalen, so_datalen_ptr);
 
-  free(si_data);
   args.GetReturnValue().Set(err);
 }
 
@@ -1705,6 +1637,7 @@ void WASI::_SetMemory(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsObject());
   ASSIGN_OR_RETURN_UNWRAP(&wasi, args.This());
   wasi->memory_.Reset(wasi->env()->isolate(), args[0].As<Object>());
+  wasi->memory_buffer_.Reset();
 }
 
 
@@ -1785,6 +1718,16 @@ void WASI::writeUInt64(char* memory, uint64_t value, uint32_t offset) {
 
 uvwasi_errno_t WASI::backingStore(char** store, size_t* byte_length) {
   Environment* env = this->env();
+
+  // The buffer of the memory is only replaced when the memory grows, which
+  // detaches the previous one. Until then, its contents are used directly.
+  if (!memory_buffer_.IsEmpty() &&
+      PersistentToLocal::Strong(memory_buffer_)->ByteLength() != 0) {
+    *byte_length = memory_byte_length_;
+    *store = memory_data_;
+    return UVWASI_ESUCCESS;
+  }
+
   Local<Object> memory = PersistentToLocal::Strong(this->memory_);
   Local<Value> prop;
 
@@ -1798,6 +1741,9 @@ uvwasi_errno_t WASI::backingStore(char** store, size_t* byte_length) {
   std::shared_ptr<BackingStore> backing_store = ab->GetBackingStore();
   *byte_length = backing_store->ByteLength();
   *store = static_cast<char*>(backing_store->Data());
+  memory_buffer_.Reset(env->isolate(), ab);
+  memory_data_ = *store;
+  memory_byte_length_ = *byte_length;
   return UVWASI_ESUCCESS;
 }
 
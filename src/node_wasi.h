@@ -95,6 +95,11 @@ class WASI : public BaseObject,
   uvwasi_errno_t backingStore(char** store, size_t* byte_length);
   uvwasi_t uvw_;
   v8::Global<v8::Object> memory_;
+  // The current buffer of memory_, which is looked up again once it has been
+  // detached.
+  v8::Global<v8::ArrayBuffer> memory_buffer_;
+  char* memory_data_ = nullptr;
+  size_t memory_byte_length_ = 0;
   uvwasi_mem_t alloc_info_;
   size_t current_uvwasi_memory_ = 0;
 };
@@ -0,0 +1,298 @@
+#include "base_object-inl.h"
+#include "env-inl.h"
+#include "memory_tracker-inl.h"
+#include "node_buffer.h"
+#include "node_errors.h"
+#include "node_internals.h"
+#include "util-inl.h"
+#include "v8.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace node {
+namespace wasm_web_api {
+
+using v8::CompiledWasmModule;
+using v8::Context;
+using v8::Exception;
+using v8::Function;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::Isolate;
+using v8::Local;
+using v8::MaybeLocal;
+using v8::Object;
+using v8::OwnedBuffer;
+using v8::String;
+using v8::Undefined;
+using v8::Value;
+using v8::WasmStreaming;
+
+namespace {
+
+// Receives the module of a streaming compilation once it has been compiled
+// by the top tier, which is when its serialization is worth caching.
+class CompiledModuleClient final : public WasmStreaming::Client {
+ public:
+  explicit CompiledModuleClient(
+      std::shared_ptr<std::unique_ptr<CompiledWasmModule>> compiled_module)
+      : compiled_module_(std::move(compiled_module)) {}
+
+  // V8 calls this from a foreground task on the thread of the isolate.
+  void OnModuleCompiled(CompiledWasmModule compiled_module) override {
+    compiled_module_->reset(
+        new CompiledWasmModule(std::move(compiled_module)));
+  }
+
+ private:
+  std::shared_ptr<std::unique_ptr<CompiledWasmModule>> compiled_module_;
+};
+
+// The JS interface of a v8::WasmStreaming, which is fed by
+// internal/wasm_web_api.
+class WasmStreamingObject : public BaseObject {
+ public:
+  WasmStreamingObject(Environment* env,
+                      Local<Object> wrap,
+                      std::shared_ptr<WasmStreaming> streaming)
+      : BaseObject(env, wrap), streaming_(std::move(streaming)) {
+    MakeWeak();
+  }
+
+  static MaybeLocal<Object> Create(Environment* env,
+                                   std::shared_ptr<WasmStreaming> streaming);
+
+  static void Push(const FunctionCallbackInfo<Value>& args);
+  static void Finish(const FunctionCallbackInfo<Value>& args);
+  static void Abort(const FunctionCallbackInfo<Value>& args);
+  static void SetCompiledModuleBytes(const FunctionCallbackInfo<Value>& args);
+  static void KeepCompiledModule(const FunctionCallbackInfo<Value>& args);
+  static void Serialize(const FunctionCallbackInfo<Value>& args);
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("compiled_module_bytes",
+                                compiled_module_bytes_.size());
+  }
+
+  SET_MEMORY_INFO_NAME(WasmStreamingObject)
+  SET_SELF_SIZE(WasmStreamingObject)
+
+ private:
+  std::shared_ptr<WasmStreaming> streaming_;
+  // V8 reads the cached module when the compilation finishes, so it is kept
+  // alive until then.
+  std::vector<uint8_t> compiled_module_bytes_;
+  std::shared_ptr<std::unique_ptr<CompiledWasmModule>> compiled_module_;
+};
+
+MaybeLocal<Object> WasmStreamingObject::Create(
+    Environment* env, std::shared_ptr<WasmStreaming> streaming) {
+  Local<Function> ctor = env->wasm_streaming_object_constructor();
+  Local<Object> obj;
+  if (!ctor->NewInstance(env->context()).ToLocal(&obj))
+    return MaybeLocal<Object>();
+  new WasmStreamingObject(env, obj, std::move(streaming));
+  return obj;
+}
+
+void WasmStreamingObject::Push(const FunctionCallbackInfo<Value>& args) {
+  WasmStreamingObject* obj;
+  ASSIGN_OR_RETURN_UNWRAP(&obj, args.Holder());
+  CHECK(args[0]->IsArrayBufferView());
+  ArrayBufferViewContents<uint8_t> chunk(args[0]);
+  obj->streaming_->OnBytesReceived(chunk.data(), chunk.length());
+}
+
+void WasmStreamingObject::Finish(const FunctionCallbackInfo<Value>& args) {
+  WasmStreamingObject* obj;
+  ASSIGN_OR_RETURN_UNWRAP(&obj, args.Holder());
+  obj->streaming_->Finish();
+}
+
+void WasmStreamingObject::Abort(const FunctionCallbackInfo<Value>& args) {
+  WasmStreamingObject* obj;
+  ASSIGN_OR_RETURN_UNWRAP(&obj, args.Holder());
+  obj->streaming_->Abort(args[0]);
+}
+
+// Passes a module serialized by an earlier compilation of the same bytes.
+// Returns false if V8 cannot use it, in which case the module is compiled.
+void WasmStreamingObject::SetCompiledModuleBytes(
+    const FunctionCallbackInfo<Value>& args) {
+  WasmStreamingObject* obj;
+  ASSIGN_OR_RETURN_UNWRAP(&obj, args.Holder());
+  CHECK(args[0]->IsArrayBufferView());
+  ArrayBufferViewContents<uint8_t> bytes(args[0]);
+  obj->compiled_module_bytes_.assign(bytes.data(),
+                                     bytes.data() + bytes.length());
+  bool accepted = obj->streaming_->SetCompiledModuleBytes(
+      obj->compiled_module_bytes_.data(), obj->compiled_module_bytes_.size());
+  if (!accepted)
+    obj->compiled_module_bytes_.clear();
+  args.GetReturnValue().Set(accepted);
+}
+
+// Keeps the compiled module, so that serialize() can return it.
+void WasmStreamingObject::KeepCompiledModule(
+    const FunctionCallbackInfo<Value>& args) {
+  WasmStreamingObject* obj;
+  ASSIGN_OR_RETURN_UNWRAP(&obj, args.Holder());
+  CHECK(!obj->compiled_module_);
+  obj->compiled_module_ =
+      std::make_shared<std::unique_ptr<CompiledWasmModule>>();
+  obj->streaming_->SetClient(
+      std::make_shared<CompiledModuleClient>(obj->compiled_module_));
+}
+
+// Returns the serialized module, or undefined if it has not been compiled by
+// the top tier yet.
+void WasmStreamingObject::Serialize(const FunctionCallbackInfo<Value>& args) {
+  WasmStreamingObject* obj;
+  ASSIGN_OR_RETURN_UNWRAP(&obj, args.Holder());
+  if (!obj->compiled_module_ || !*obj->compiled_module_)
+    return;
+  OwnedBuffer serialized = (*obj->compiled_module_)->Serialize();
+  if (serialized.size == 0)
+    return;
+  Local<Object> buf;
+  if (Buffer::Copy(obj->env(),
+                   reinterpret_cast<const char*>(serialized.buffer.get()),
+                   serialized.size).ToLocal(&buf)) {
+    args.GetReturnValue().Set(buf);
+  }
+}
+
+// hash(bytes) returns a 64-bit hash of the bytes as a hex string. It is not
+// cryptographic, and only keys the cache in builds without crypto support.
+void Hash(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsArrayBufferView());
+  ArrayBufferViewContents<uint8_t> bytes(args[0]);
+  const uint8_t* data = bytes.data();
+  const size_t length = bytes.length();
+
+  constexpr uint64_t kMul1 = 0x87c37b91114253d5;
+  constexpr uint64_t kMul2 = 0x4cf5ad432745937f;
+  uint64_t hash = 0x9e3779b97f4a7c15 ^ length;
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    word *= kMul1;
+    word = (word << 31) | (word >> 33);
+    word *= kMul2;
+    hash ^= word;
+    hash = ((hash << 27) | (hash >> 37)) * 5 + 0x52dce729;
+  }
+  uint64_t tail = 0;
+  for (size_t shift = 0; i < length; i++, shift += 8)
+    tail |= static_cast<uint64_t>(data[i]) << shift;
+  hash ^= tail * kMul1;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccd;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53;
+  hash ^= hash >> 33;
+
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016" PRIx64, hash);
+  args.GetReturnValue().Set(OneByteString(env->isolate(), hex));
+}
+
+// Returns the function that compiles the source passed to
+// WebAssembly.compileStreaming(), which is called with the source and a
+// WasmStreamingObject. internal/wasm_web_api, and with it this binding, are
+// only loaded the first time it is needed.
+MaybeLocal<Function> GetImplementation(Environment* env) {
+  if (!env->wasm_streaming_compilation_impl().IsEmpty())
+    return env->wasm_streaming_compilation_impl();
+  if (env->native_module_require().IsEmpty())
+    return MaybeLocal<Function>();
+
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+  Local<Value> id = FIXED_ONE_BYTE_STRING(isolate, "internal/wasm_web_api");
+  Local<Value> exports;
+  Local<Value> impl;
+  if (!env->native_module_require()
+           ->Call(context, Undefined(isolate), 1, &id).ToLocal(&exports) ||
+      !exports.As<Object>()->Get(
+          context,
+          FIXED_ONE_BYTE_STRING(isolate, "compileStreaming")).ToLocal(&impl)) {
+    return MaybeLocal<Function>();
+  }
+  CHECK(impl->IsFunction());
+  env->set_wasm_streaming_compilation_impl(impl.As<Function>());
+  return impl.As<Function>();
+}
+
+}  // anonymous namespace
+
+void StartStreamingCompilation(const FunctionCallbackInfo<Value>& info) {
+  Isolate* isolate = info.GetIsolate();
+  // info.Data() is the v8::WasmStreaming, not the binding data, so the
+  // Environment is found through the current context.
+  Environment* env = Environment::GetCurrent(isolate);
+  std::shared_ptr<WasmStreaming> streaming =
+      WasmStreaming::Unpack(isolate, info.Data());
+
+  Local<Value> unsupported = Exception::TypeError(FIXED_ONE_BYTE_STRING(
+      isolate, "WebAssembly.compileStreaming() is not supported here"));
+  if (env == nullptr) {
+    streaming->Abort(unsupported);
+    return;
+  }
+
+  Local<Context> context = env->context();
+  errors::TryCatchScope try_catch(env);
+  Local<Function> impl;
+  Local<Object> obj;
+  if (GetImplementation(env).ToLocal(&impl) &&
+      WasmStreamingObject::Create(env, streaming).ToLocal(&obj)) {
+    Local<Value> argv[] = { info[0], obj };
+    USE(impl->Call(context, Undefined(isolate), arraysize(argv), argv));
+  } else if (!try_catch.HasCaught()) {
+    // Bootstrap has not finished, or JS land cannot be called anymore.
+    streaming->Abort(unsupported);
+  }
+  if (try_catch.HasCaught() && !try_catch.HasTerminated())
+    streaming->Abort(try_catch.Exception());
+}
+
+namespace {
+
+void Initialize(Local<Object> target,
+                Local<Value> unused,
+                Local<Context> context,
+                void* priv) {
+  Environment* env = Environment::GetCurrent(context);
+
+  Local<FunctionTemplate> t = FunctionTemplate::New(env->isolate());
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(t, "push", WasmStreamingObject::Push);
+  env->SetProtoMethod(t, "finish", WasmStreamingObject::Finish);
+  env->SetProtoMethod(t, "abort", WasmStreamingObject::Abort);
+  env->SetProtoMethod(t, "setCompiledModuleBytes",
+                      WasmStreamingObject::SetCompiledModuleBytes);
+  env->SetProtoMethod(t, "keepCompiledModule",
+                      WasmStreamingObject::KeepCompiledModule);
+  env->SetProtoMethod(t, "serialize", WasmStreamingObject::Serialize);
+  Local<String> class_name =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "WasmStreamingObject");
+  t->SetClassName(class_name);
+  env->set_wasm_streaming_object_constructor(
+      t->GetFunction(context).ToLocalChecked());
+
+  env->SetMethodNoSideEffect(target, "hash", Hash);
+}
+
+}  // anonymous namespace
+}  // namespace wasm_web_api
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_INTERNAL(wasm_web_api,
+                                   node::wasm_web_api::Initialize)
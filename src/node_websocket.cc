@@ -0,0 +1,764 @@
+#include "async_wrap-inl.h"
+#include "base_object-inl.h"
+#include "env-inl.h"
+#include "memory_tracker-inl.h"
+#include "node_buffer.h"
+#include "stream_base-inl.h"
+#include "utf8.h"
+#include "util-inl.h"
+
+#include "zlib.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// WebSocket framing (RFC 6455) with the permessage-deflate extension
+// (RFC 7692). The receiver is a StreamListener that reads frames directly from
+// a socket's StreamBase and emits complete, unmasked and inflated messages to
+// JS. The sender builds complete frames in a single Buffer.
+
+namespace node {
+namespace websocket {
+
+using v8::Context;
+using v8::Function;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Isolate;
+using v8::Local;
+using v8::MaybeLocal;
+using v8::Number;
+using v8::Object;
+using v8::String;
+using v8::Uint32;
+using v8::Value;
+
+namespace {
+
+enum Opcode : uint8_t {
+  kContinuation = 0x0,
+  kText = 0x1,
+  kBinary = 0x2,
+  kClose = 0x8,
+  kPing = 0x9,
+  kPong = 0xa
+};
+
+// Close codes that are sent when a received frame is invalid.
+constexpr int kProtocolError = 1002;
+constexpr int kInvalidPayload = 1007;
+constexpr int kMessageTooBig = 1009;
+
+// Every compressed message ends with these bytes, which are removed by the
+// sender and added back by the receiver.
+constexpr char kDeflateTrailer[] = { 0x00, 0x00, '\xff', '\xff' };
+
+// XORs |length| bytes of |data| with the 4-byte |mask|. The mask is applied
+// 16 or 8 bytes at a time, which keeps the mask aligned with the data.
+void ApplyMask(char* data, size_t length, const uint8_t mask[4]) {
+  uint32_t mask32;
+  memcpy(&mask32, mask, sizeof(mask32));
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128i mask128 = _mm_set1_epi32(mask32);
+  for (; i + 16 <= length; i += 16) {
+    __m128i* p = reinterpret_cast<__m128i*>(data + i);
+    _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), mask128));
+  }
+#endif
+  const uint64_t mask64 = (static_cast<uint64_t>(mask32) << 32) | mask32;
+  for (; i + 8 <= length; i += 8) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    word ^= mask64;
+    memcpy(data + i, &word, sizeof(word));
+  }
+  for (; i < length; i++)
+    data[i] ^= mask[i & 3];
+}
+
+bool IsValidCloseCode(int code) {
+  return (code >= 1000 && code <= 1014 &&
+          code != 1004 && code != 1005 && code != 1006) ||
+         (code >= 3000 && code <= 4999);
+}
+
+// A raw inflate or deflate stream.
+class ZStream {
+ public:
+  ZStream() = default;
+  ZStream(const ZStream&) = delete;
+  ZStream& operator=(const ZStream&) = delete;
+
+  ~ZStream() {
+    if (!initialized_)
+      return;
+    if (inflate_)
+      inflateEnd(&strm_);
+    else
+      deflateEnd(&strm_);
+  }
+
+  bool InitInflate() {
+    inflate_ = true;
+    initialized_ = inflateInit2(&strm_, -15) == Z_OK;
+    return initialized_;
+  }
+
+  bool InitDeflate(int window_bits) {
+    inflate_ = false;
+    initialized_ = deflateInit2(&strm_,
+                                Z_DEFAULT_COMPRESSION,
+                                Z_DEFLATED,
+                                -window_bits,
+                                8,
+                                Z_DEFAULT_STRATEGY) == Z_OK;
+    return initialized_;
+  }
+
+  void Reset() {
+    if (inflate_)
+      inflateReset(&strm_);
+    else
+      deflateReset(&strm_);
+  }
+
+  enum Result { kOk, kInvalid, kTooBig };
+
+  // Appends the result of processing |length| bytes of |data| with a sync
+  // flush to |out|, unless |out| would grow beyond |max_length| bytes.
+  Result Process(const char* data,
+                 size_t length,
+                 size_t max_length,
+                 std::string* out) {
+    strm_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    strm_.avail_in = length;
+    char chunk[16 * 1024];
+    do {
+      strm_.next_out = reinterpret_cast<Bytef*>(chunk);
+      strm_.avail_out = sizeof(chunk);
+      const int err = inflate_ ? inflate(&strm_, Z_SYNC_FLUSH)
+                               : deflate(&strm_, Z_SYNC_FLUSH);
+      if (err != Z_OK && err != Z_BUF_ERROR && err != Z_STREAM_END)
+        return kInvalid;
+      const size_t have = sizeof(chunk) - strm_.avail_out;
+      if (out->size() + have > max_length)
+        return kTooBig;
+      out->append(chunk, have);
+      if (err == Z_STREAM_END) {
+        // The peer ended the deflate stream, so the next message starts a
+        // new one.
+        Reset();
+        break;
+      }
+      if (err == Z_BUF_ERROR && have == 0)
+        break;
+    } while (strm_.avail_in > 0 || strm_.avail_out == 0);
+    return kOk;
+  }
+
+ private:
+  z_stream strm_ = {};
+  bool initialized_ = false;
+  bool inflate_ = true;
+};
+
+// Connections that negotiated no context takeover reset the compression
+// state after every message, so they share one stream per thread instead of
+// keeping one each.
+struct SharedStreams {
+  std::unique_ptr<ZStream> inflater;
+  // Deflate streams by window size, from 9 to 15 bits.
+  std::unique_ptr<ZStream> deflaters[7];
+};
+
+thread_local SharedStreams shared_streams;
+
+ZStream* GetSharedInflater() {
+  std::unique_ptr<ZStream>& inflater = shared_streams.inflater;
+  if (!inflater) {
+    inflater.reset(new ZStream());
+    CHECK(inflater->InitInflate());
+  }
+  return inflater.get();
+}
+
+ZStream* GetSharedDeflater(int window_bits) {
+  std::unique_ptr<ZStream>& deflater =
+      shared_streams.deflaters[window_bits - 9];
+  if (!deflater) {
+    deflater.reset(new ZStream());
+    CHECK(deflater->InitDeflate(window_bits));
+  }
+  return deflater.get();
+}
+
+// Masking keys are taken from a pool of random bytes, which is refilled
+// with a single uv_random() call.
+thread_local uint8_t random_pool[1024];
+thread_local size_t random_pool_offset = sizeof(random_pool);
+
+void GetMaskingKey(uint8_t key[4]) {
+  if (random_pool_offset == sizeof(random_pool)) {
+    CHECK_EQ(0, uv_random(nullptr, nullptr,
+                          random_pool, sizeof(random_pool), 0, nullptr));
+    random_pool_offset = 0;
+  }
+  memcpy(key, random_pool + random_pool_offset, 4);
+  random_pool_offset += 4;
+}
+
+class WebSocketReceiver : public AsyncWrap, public StreamListener {
+ public:
+  WebSocketReceiver(Environment* env,
+                    Local<Object> wrap,
+                    StreamBase* stream,
+                    bool is_server,
+                    size_t max_payload,
+                    bool deflate,
+                    bool no_context_takeover)
+      : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_WEBSOCKETRECEIVER),
+        is_server_(is_server),
+        max_payload_(max_payload),
+        deflate_(deflate),
+        no_context_takeover_(no_context_takeover) {
+    MakeWeak();
+    if (deflate_ && !no_context_takeover_) {
+      inflater_.reset(new ZStream());
+      CHECK(inflater_->InitInflate());
+    }
+    stream->PushStreamListener(this);
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args);
+  static void Push(const FunctionCallbackInfo<Value>& args);
+  static void Detach(const FunctionCallbackInfo<Value>& args);
+
+  uv_buf_t OnStreamAlloc(size_t suggested_size) override {
+    return env()->AllocateManaged(suggested_size).release();
+  }
+
+  void OnStreamRead(ssize_t nread, const uv_buf_t& buf_) override {
+    AllocatedBuffer buf(env(), buf_);
+    if (nread < 0) {
+      PassReadErrorToPreviousListener(nread);
+      return;
+    }
+    if (nread == 0)
+      return;
+    HandleScope handle_scope(env()->isolate());
+    Context::Scope context_scope(env()->context());
+    Feed(buf.data(), nread);
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("pending", pending_.capacity());
+    tracker->TrackFieldWithSize("message", message_.capacity());
+  }
+
+  SET_MEMORY_INFO_NAME(WebSocketReceiver)
+  SET_SELF_SIZE(WebSocketReceiver)
+
+ private:
+  void Feed(char* data, size_t length);
+  // Returns the number of bytes of the frame at |data| that were consumed,
+  // or 0 if the frame is not complete yet. Returns 0 and sets failed_ if the
+  // frame is invalid.
+  size_t ReadFrame(char* data, size_t length);
+  // Returns an error message if a frame with this header must be rejected.
+  const char* ValidateHeader(uint8_t b0,
+                             uint8_t b1,
+                             uint64_t payload_length,
+                             int* close_code);
+  bool OnFrame(uint8_t opcode, bool fin, bool compressed,
+               const char* payload, size_t length);
+  bool EmitMessage(uint8_t opcode, const char* data, size_t length);
+  void Fail(const char* message, int close_code);
+
+  const bool is_server_;
+  const size_t max_payload_;
+  const bool deflate_;
+  const bool no_context_takeover_;
+  std::unique_ptr<ZStream> inflater_;
+  bool failed_ = false;
+  // The start of a frame that is not complete yet.
+  std::string pending_;
+  // The fragments of a message that is not complete yet.
+  std::string message_;
+  bool in_message_ = false;
+  uint8_t message_opcode_ = kText;
+  bool message_compressed_ = false;
+};
+
+void WebSocketReceiver::Fail(const char* message, int close_code) {
+  failed_ = true;
+  pending_.clear();
+  message_.clear();
+  if (stream() != nullptr)
+    stream()->ReadStop();
+  Isolate* isolate = env()->isolate();
+  Local<Value> argv[] = {
+    OneByteString(isolate, message),
+    Integer::New(isolate, close_code)
+  };
+  MakeCallback(env()->onerror_string(), arraysize(argv), argv);
+}
+
+bool WebSocketReceiver::EmitMessage(uint8_t opcode,
+                                    const char* data,
+                                    size_t length) {
+  Local<Object> buffer;
+  if (!Buffer::Copy(env(), data, length).ToLocal(&buffer))
+    return false;
+  Local<Value> argv[] = {
+    Integer::NewFromUnsigned(env()->isolate(), opcode),
+    buffer
+  };
+  MakeCallback(env()->onmessage_string(), arraysize(argv), argv);
+  // The callback may have detached the receiver.
+  return stream() != nullptr && !failed_;
+}
+
+bool WebSocketReceiver::OnFrame(uint8_t opcode,
+                                bool fin,
+                                bool compressed,
+                                const char* payload,
+                                size_t length) {
+  if (opcode == kClose) {
+    if (length == 1) {
+      Fail("Invalid close frame payload length", kProtocolError);
+      return false;
+    }
+    if (length >= 2) {
+      const int code = (static_cast<uint8_t>(payload[0]) << 8) |
+                       static_cast<uint8_t>(payload[1]);
+      if (!IsValidCloseCode(code)) {
+        Fail("Invalid close code", kProtocolError);
+        return false;
+      }
+      if (!utf8_validate(payload + 2, length - 2)) {
+        Fail("Invalid UTF-8 sequence in close reason", kInvalidPayload);
+        return false;
+      }
+    }
+    return EmitMessage(opcode, payload, length);
+  }
+  if (opcode == kPing || opcode == kPong)
+    return EmitMessage(opcode, payload, length);
+
+  if (opcode != kContinuation) {
+    message_opcode_ = opcode;
+    message_compressed_ = compressed;
+  }
+
+  // Messages in a single uncompressed frame are not copied into message_.
+  if (fin && !in_message_ && !message_compressed_) {
+    if (opcode == kText && !utf8_validate(payload, length)) {
+      Fail("Invalid UTF-8 sequence", kInvalidPayload);
+      return false;
+    }
+    return EmitMessage(message_opcode_, payload, length);
+  }
+
+  in_message_ = !fin;
+  message_.append(payload, length);
+  if (!fin)
+    return true;
+
+  std::string inflated;
+  const std::string* message = &message_;
+  if (message_compressed_) {
+    ZStream* inflater =
+        inflater_ ? inflater_.get() : GetSharedInflater();
+    message_.append(kDeflateTrailer, sizeof(kDeflateTrailer));
+    const ZStream::Result result =
+        inflater->Process(message_.data(), message_.size(),
+                          max_payload_, &inflated);
+    if (!inflater_)
+      inflater->Reset();
+    if (result == ZStream::kInvalid) {
+      Fail("Invalid compressed data", kInvalidPayload);
+      return false;
+    }
+    if (result == ZStream::kTooBig) {
+      Fail("Message too big", kMessageTooBig);
+      return false;
+    }
+    message = &inflated;
+  }
+
+  if (message_opcode_ == kText &&
+      !utf8_validate(message->data(), message->size())) {
+    Fail("Invalid UTF-8 sequence", kInvalidPayload);
+    return false;
+  }
+  const bool ok = EmitMessage(message_opcode_, message->data(),
+                              message->size());
+  message_.clear();
+  return ok;
+}
+
+const char* WebSocketReceiver::ValidateHeader(uint8_t b0,
+                                              uint8_t b1,
+                                              uint64_t payload_length,
+                                              int* close_code) {
+  const bool fin = b0 & 0x80;
+  const bool rsv1 = b0 & 0x40;
+  const uint8_t opcode = b0 & 0x0f;
+  const bool masked = b1 & 0x80;
+
+  if (b0 & 0x30)
+    return "RSV2 and RSV3 must be clear";
+  if (masked != is_server_) {
+    return is_server_ ? "Frames from clients must be masked" :
+                        "Frames from servers must not be masked";
+  }
+  if (opcode >= kClose) {
+    if (opcode > kPong)
+      return "Invalid opcode";
+    if (!fin)
+      return "Control frames must not be fragmented";
+    if (payload_length > 125)
+      return "Control frame payload too long";
+    if (rsv1)
+      return "RSV1 must be clear";
+    return nullptr;
+  }
+  if (opcode > kBinary)
+    return "Invalid opcode";
+  if (opcode == kContinuation && !in_message_)
+    return "Unexpected continuation frame";
+  if (opcode != kContinuation && in_message_)
+    return "Expected a continuation frame";
+  if (rsv1 && (!deflate_ || opcode == kContinuation))
+    return "RSV1 must be clear";
+  if (payload_length > max_payload_ - message_.size()) {
+    *close_code = kMessageTooBig;
+    return "Message too big";
+  }
+  return nullptr;
+}
+
+size_t WebSocketReceiver::ReadFrame(char* data, size_t length) {
+  if (length < 2)
+    return 0;
+  const uint8_t b0 = data[0];
+  const uint8_t b1 = data[1];
+  const bool fin = b0 & 0x80;
+  const bool rsv1 = b0 & 0x40;
+  const uint8_t opcode = b0 & 0x0f;
+  const bool masked = b1 & 0x80;
+  uint64_t payload_length = b1 & 0x7f;
+  size_t header_length = 2;
+  if (payload_length == 126) {
+    header_length = 4;
+    if (length < header_length)
+      return 0;
+    payload_length = (static_cast<uint8_t>(data[2]) << 8) |
+                     static_cast<uint8_t>(data[3]);
+  } else if (payload_length == 127) {
+    header_length = 10;
+    if (length < header_length)
+      return 0;
+    payload_length = 0;
+    for (int i = 2; i < 10; i++)
+      payload_length = (payload_length << 8) | static_cast<uint8_t>(data[i]);
+  }
+  if (masked)
+    header_length += 4;
+
+  int close_code = kProtocolError;
+  const char* error = ValidateHeader(b0, b1, payload_length, &close_code);
+  if (error != nullptr) {
+    Fail(error, close_code);
+    return 0;
+  }
+
+  if (length < header_length || length - header_length < payload_length)
+    return 0;
+
+  char* payload = data + header_length;
+  if (masked) {
+    ApplyMask(payload, payload_length,
+              reinterpret_cast<const uint8_t*>(payload - 4));
+  }
+  if (!OnFrame(opcode, fin, rsv1, payload, payload_length))
+    return 0;
+  return header_length + payload_length;
+}
+
+void WebSocketReceiver::Feed(char* data, size_t length) {
+  if (failed_ || stream() == nullptr)
+    return;
+
+  // Prepend the start of a frame from an earlier read.
+  std::string buffered;
+  if (!pending_.empty()) {
+    buffered.swap(pending_);
+    buffered.append(data, length);
+    data = &buffered[0];
+    length = buffered.size();
+  }
+
+  while (length > 0) {
+    const size_t consumed = ReadFrame(data, length);
+    if (failed_ || stream() == nullptr)
+      return;
+    if (consumed == 0)
+      break;
+    data += consumed;
+    length -= consumed;
+  }
+
+  if (buffered.empty()) {
+    pending_.assign(data, length);
+    return;
+  }
+  // Keep the buffer, and with it its capacity, so that a frame that arrives
+  // in many reads is not copied again on every one of them.
+  buffered.erase(0, buffered.size() - length);
+  pending_.swap(buffered);
+}
+
+void WebSocketReceiver::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsObject());
+  StreamBase* stream = StreamBase::FromObject(args[0].As<Object>());
+  CHECK_NOT_NULL(stream);
+  CHECK(args[2]->IsNumber());
+  new WebSocketReceiver(env,
+                        args.This(),
+                        stream,
+                        args[1]->IsTrue(),
+                        args[2].As<Number>()->Value(),
+                        args[3]->IsTrue(),
+                        args[4]->IsTrue());
+}
+
+// Parses data that was read from the stream before the receiver was attached.
+void WebSocketReceiver::Push(const FunctionCallbackInfo<Value>& args) {
+  WebSocketReceiver* receiver;
+  ASSIGN_OR_RETURN_UNWRAP(&receiver, args.Holder());
+  CHECK(args[0]->IsArrayBufferView());
+  ArrayBufferViewContents<char> chunk(args[0]);
+  // Unmasking modifies the data, so it is copied.
+  std::string data(chunk.data(), chunk.length());
+  receiver->Feed(&data[0], data.size());
+}
+
+// Stops reading frames. Data that is read afterwards goes to the stream's
+// previous listener again.
+void WebSocketReceiver::Detach(const FunctionCallbackInfo<Value>& args) {
+  WebSocketReceiver* receiver;
+  ASSIGN_OR_RETURN_UNWRAP(&receiver, args.Holder());
+  if (receiver->stream() != nullptr)
+    receiver->stream()->RemoveStreamListener(receiver);
+  receiver->pending_.clear();
+  receiver->message_.clear();
+}
+
+class WebSocketSender : public BaseObject {
+ public:
+  WebSocketSender(Environment* env,
+                  Local<Object> wrap,
+                  bool mask,
+                  bool deflate,
+                  bool no_context_takeover,
+                  int window_bits)
+      : BaseObject(env, wrap),
+        mask_(mask),
+        deflate_(deflate),
+        no_context_takeover_(no_context_takeover),
+        window_bits_(window_bits) {
+    MakeWeak();
+    if (deflate_ && !no_context_takeover_) {
+      deflater_.reset(new ZStream());
+      CHECK(deflater_->InitDeflate(window_bits_));
+    }
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args);
+  static void Frame(const FunctionCallbackInfo<Value>& args);
+
+  SET_NO_MEMORY_INFO()
+  SET_MEMORY_INFO_NAME(WebSocketSender)
+  SET_SELF_SIZE(WebSocketSender)
+
+ private:
+  const bool mask_;
+  const bool deflate_;
+  const bool no_context_takeover_;
+  const int window_bits_;
+  std::unique_ptr<ZStream> deflater_;
+};
+
+void WebSocketSender::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[3]->IsInt32());
+  const int window_bits = args[3].As<v8::Int32>()->Value();
+  CHECK(window_bits >= 9 && window_bits <= 15);
+  new WebSocketSender(env,
+                      args.This(),
+                      args[0]->IsTrue(),
+                      args[1]->IsTrue(),
+                      args[2]->IsTrue(),
+                      window_bits);
+}
+
+// frame(data, opcode, fin, compress) returns a Buffer that holds a complete
+// frame. `data` is a string, which is encoded as UTF-8, or an
+// ArrayBufferView.
+void WebSocketSender::Frame(const FunctionCallbackInfo<Value>& args) {
+  WebSocketSender* sender;
+  ASSIGN_OR_RETURN_UNWRAP(&sender, args.Holder());
+  Environment* env = sender->env();
+  Isolate* isolate = env->isolate();
+  CHECK(args[1]->IsUint32());
+  const uint8_t opcode = args[1].As<Uint32>()->Value();
+  const bool fin = args[2]->IsTrue();
+  const bool compress = args[3]->IsTrue();
+  CHECK(!compress || (sender->deflate_ && fin && opcode != kContinuation));
+
+  // The payload, if it is not written into the frame directly.
+  std::string payload_storage;
+  const char* payload = nullptr;
+  size_t payload_length;
+  Local<String> string;
+  ArrayBufferViewContents<char> contents;
+  if (args[0]->IsString()) {
+    string = args[0].As<String>();
+    payload_length = string->Utf8Length(isolate);
+  } else {
+    CHECK(args[0]->IsArrayBufferView());
+    contents.Read(args[0].As<v8::ArrayBufferView>());
+    payload = contents.data();
+    payload_length = contents.length();
+  }
+
+  if (compress) {
+    if (payload == nullptr) {
+      payload_storage.resize(payload_length);
+      string->WriteUtf8(isolate, &payload_storage[0], payload_length,
+                        nullptr, String::NO_NULL_TERMINATION);
+      payload = payload_storage.data();
+    }
+    ZStream* deflater = sender->deflater_ ?
+        sender->deflater_.get() : GetSharedDeflater(sender->window_bits_);
+    std::string deflated;
+    CHECK_EQ(deflater->Process(payload, payload_length, SIZE_MAX, &deflated),
+             ZStream::kOk);
+    if (!sender->deflater_)
+      deflater->Reset();
+    // Remove the trailer of the sync flush.
+    CHECK_GE(deflated.size(), sizeof(kDeflateTrailer));
+    deflated.resize(deflated.size() - sizeof(kDeflateTrailer));
+    payload_storage.swap(deflated);
+    payload = payload_storage.data();
+    payload_length = payload_storage.size();
+  }
+
+  size_t header_length = 2;
+  if (payload_length > 0xffff)
+    header_length += 8;
+  else if (payload_length > 125)
+    header_length += 2;
+  if (sender->mask_)
+    header_length += 4;
+
+  AllocatedBuffer frame =
+      env->AllocateManaged(header_length + payload_length);
+  uint8_t* header = reinterpret_cast<uint8_t*>(frame.data());
+  header[0] = (fin ? 0x80 : 0) | (compress ? 0x40 : 0) | opcode;
+  header[1] = sender->mask_ ? 0x80 : 0;
+  size_t offset = 2;
+  if (payload_length > 0xffff) {
+    header[1] |= 127;
+    for (int i = 7; i >= 0; i--)
+      header[offset++] = static_cast<uint64_t>(payload_length) >> (i * 8);
+  } else if (payload_length > 125) {
+    header[1] |= 126;
+    header[offset++] = payload_length >> 8;
+    header[offset++] = payload_length & 0xff;
+  } else {
+    header[1] |= payload_length;
+  }
+  uint8_t key[4];
+  if (sender->mask_) {
+    GetMaskingKey(key);
+    memcpy(header + offset, key, sizeof(key));
+    offset += sizeof(key);
+  }
+
+  char* out = frame.data() + offset;
+  if (payload != nullptr) {
+    memcpy(out, payload, payload_length);
+  } else {
+    string->WriteUtf8(isolate, out, payload_length, nullptr,
+                      String::NO_NULL_TERMINATION);
+  }
+  if (sender->mask_)
+    ApplyMask(out, payload_length, key);
+
+  Local<Object> buffer;
+  if (frame.ToBuffer().ToLocal(&buffer))
+    args.GetReturnValue().Set(buffer);
+}
+
+// mask(buffer, mask) applies the 4-byte `mask` to `buffer` in place.
+void Mask(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsArrayBufferView());
+  CHECK(args[1]->IsArrayBufferView());
+  SPREAD_BUFFER_ARG(args[0], buffer);
+  ArrayBufferViewContents<uint8_t> mask(args[1]);
+  CHECK_GE(mask.length(), 4);
+  ApplyMask(buffer_data, buffer_length, mask.data());
+}
+
+void Initialize(Local<Object> target,
+                Local<Value> unused,
+                Local<Context> context,
+                void* priv) {
+  Environment* env = Environment::GetCurrent(context);
+
+  Local<FunctionTemplate> receiver =
+      env->NewFunctionTemplate(WebSocketReceiver::New);
+  receiver->InstanceTemplate()->SetInternalFieldCount(1);
+  receiver->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  env->SetProtoMethod(receiver, "push", WebSocketReceiver::Push);
+  env->SetProtoMethod(receiver, "detach", WebSocketReceiver::Detach);
+  Local<String> receiver_string =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "WebSocketReceiver");
+  receiver->SetClassName(receiver_string);
+  target->Set(context,
+              receiver_string,
+              receiver->GetFunction(context).ToLocalChecked()).Check();
+
+  Local<FunctionTemplate> sender =
+      env->NewFunctionTemplate(WebSocketSender::New);
+  sender->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(sender, "frame", WebSocketSender::Frame);
+  Local<String> sender_string =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "WebSocketSender");
+  sender->SetClassName(sender_string);
+  target->Set(context,
+              sender_string,
+              sender->GetFunction(context).ToLocalChecked()).Check();
+
+  env->SetMethod(target, "mask", Mask);
+}
+
+}  // anonymous namespace
+}  // namespace websocket
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_INTERNAL(websocket, node::websocket::Initialize)
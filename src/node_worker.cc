@@ -3,8 +3,10 @@
 #include "memory_tracker-inl.h"
 #include "node_errors.h"
 #include "node_buffer.h"
+#include "node_main_instance.h"
 #include "node_options-inl.h"
 #include "node_perf.h"
+#include "node_platform.h"
 #include "util-inl.h"
 #include "async_wrap-inl.h"
 
@@ -12,6 +14,7 @@
 #include "inspector/worker_inspector.h"  // ParentInspectorHandle
 #endif
 
+#include <ctime>
 #include <memory>
 #include <string>
 #include <vector>
@@ -27,6 +30,8 @@ using v8::Float64Array;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
+using v8::HeapStatistics;
+using v8::Int32;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
@@ -44,6 +49,47 @@ using v8::Value;
 namespace node {
 namespace worker {
 
+namespace {
+
+#ifndef NODE_WITHOUT_NODE_OPTIONS
+// Workers with their own options parse the option environment variables of
+// their environment. Those are usually the same for all Workers, so the
+// options that result from the last set of values are kept and copied rather
+// than being parsed again.
+class EnvOptionsCache {
+ public:
+  bool Get(const std::vector<std::string>& env_values,
+           std::shared_ptr<PerIsolateOptions>* options,
+           std::vector<std::string>* errors) {
+    Mutex::ScopedLock lock(mutex_);
+    if (!options_ || env_values != env_values_)
+      return false;
+    *options = options_->Clone();
+    *errors = errors_;
+    return true;
+  }
+
+  void Set(const std::vector<std::string>& env_values,
+           const PerIsolateOptions& options,
+           const std::vector<std::string>& errors) {
+    Mutex::ScopedLock lock(mutex_);
+    env_values_ = env_values;
+    options_ = options.Clone();
+    errors_ = errors;
+  }
+
+ private:
+  Mutex mutex_;
+  std::vector<std::string> env_values_;
+  std::shared_ptr<PerIsolateOptions> options_;
+  std::vector<std::string> errors_;
+};
+
+EnvOptionsCache env_options_cache;
+#endif  // NODE_WITHOUT_NODE_OPTIONS
+
+}  // anonymous namespace
+
 Worker::Worker(Environment* env,
                Local<Object> wrap,
                const std::string& url,
@@ -127,6 +173,10 @@ void Worker::UpdateResourceConstraints(ResourceConstraints* constraints) {
   }
 }
 
+// The embedded snapshot does not reference any external functions yet,
+// but V8 requires a (null-terminated) list when deserializing.
+static const intptr_t kNoExternalReferences[] = { 0 };
+
 // This class contains data that is only relevant to the child thread itself,
 // and only while it is running.
 // (Eventually, the Environment instance should probably also be moved here.)
@@ -142,6 +192,19 @@ class WorkerThreadData {
     SetIsolateCreateParamsForNode(&params);
     params.array_buffer_allocator_shared = allocator;
 
+    // Start from the same snapshot as the main instance, so that the
+    // per-context scripts do not have to be compiled and run for every
+    // Worker.
+    const std::vector<size_t>* indexes = nullptr;
+    v8::StartupData* blob = NodeMainInstance::GetEmbeddedSnapshotBlob();
+    if (blob != nullptr &&
+        !per_process::cli_options->per_isolate->no_node_snapshot) {
+      params.snapshot_blob = blob;
+      params.external_references = kNoExternalReferences;
+      indexes = NodeMainInstance::GetIsolateDataIndexes();
+      deserialize_mode_ = true;
+    }
+
     w->UpdateResourceConstraints(&params.constraints);
 
     Isolate* isolate = Isolate::Allocate();
@@ -152,7 +215,13 @@ class WorkerThreadData {
 
     w->platform_->RegisterIsolate(isolate, &loop_);
     Isolate::Initialize(isolate, params);
-    SetIsolateUpForNode(isolate);
+    IsolateSettings settings;
+    SetIsolateMiscHandlers(isolate, settings);
+    if (!deserialize_mode_) {
+      // If in deserialize mode, delay until after the deserialization is
+      // complete, as NodeMainInstance does.
+      SetIsolateErrorHandlers(isolate, settings);
+    }
 
     isolate->AddNearHeapLimitCallback(Worker::NearHeapLimit, w);
 
@@ -164,10 +233,11 @@ class WorkerThreadData {
       isolate->SetStackLimit(w->stack_base_);
 
       HandleScope handle_scope(isolate);
-      isolate_data_.reset(CreateIsolateData(isolate,
-                                            &loop_,
-                                            w_->platform_,
-                                            allocator.get()));
+      isolate_data_.reset(new IsolateData(isolate,
+                                          &loop_,
+                                          w_->platform_,
+                                          allocator.get(),
+                                          indexes));
       CHECK(isolate_data_);
       if (w_->per_isolate_opts_)
         isolate_data_->set_options(std::move(w_->per_isolate_opts_));
@@ -215,6 +285,7 @@ class WorkerThreadData {
   Worker* const w_;
   uv_loop_t loop_;
   DeleteFnPtr<IsolateData, FreeIsolateData> isolate_data_;
+  bool deserialize_mode_ = false;
 
   friend class Worker;
 };
@@ -237,6 +308,10 @@ void Worker::Run() {
       "__metadata", "thread_name", "name",
       TRACE_STR_COPY(name.c_str()));
   CHECK_NOT_NULL(platform_);
+  if (low_task_priority_)
+    WorkerThreadsTaskRunner::SetCurrentThreadPriority(WorkerTaskPriority::kLow);
+  if (cpu_ >= 0)
+    PinCurrentThread(cpu_);
 
   Debug(this, "Creating isolate for worker with id %llu", thread_id_);
 
@@ -285,7 +360,17 @@ void Worker::Run() {
         // resource constraints, we need something in place to handle it,
         // though.
         TryCatch try_catch(isolate_);
-        context = NewContext(isolate_);
+        if (data.deserialize_mode_) {
+          if (Context::FromSnapshot(isolate_,
+                                    NodeMainInstance::kNodeContextIndex)
+                  .ToLocal(&context)) {
+            InitializeContextRuntime(context);
+            IsolateSettings settings;
+            SetIsolateErrorHandlers(isolate_, settings);
+          }
+        } else {
+          context = NewContext(isolate_);
+        }
         if (context.IsEmpty()) {
           // TODO(addaleax): Inform the target about the actual underlying
           // failure.
@@ -312,6 +397,7 @@ void Worker::Run() {
         env_->set_worker_context(this);
 
         env_->InitializeLibuv(start_profiler_idle_notifier_);
+        StartResourceUsageTracking(env_.get());
       }
       {
         Mutex::ScopedLock lock(mutex_);
@@ -348,6 +434,10 @@ void Worker::Run() {
         bool more;
         env_->performance_state()->Mark(
             node::performance::NODE_PERFORMANCE_MILESTONE_LOOP_START);
+        {
+          Mutex::ScopedLock lock(usage_mutex_);
+          loop_start_ = uv_hrtime();
+        }
         do {
           if (is_stopped()) break;
           uv_run(&data.loop_, UV_RUN_DEFAULT);
@@ -482,13 +572,18 @@ void Worker::New(const FunctionCallbackInfo<Value>& args) {
   if (args[1]->IsObject() || args[2]->IsArray()) {
     per_isolate_opts.reset(new PerIsolateOptions());
 
+    // The values of the environment variables that the options depend on.
+    std::vector<std::string> env_values;
     HandleEnvOptions(
-        per_isolate_opts->per_env, [isolate, &env_vars](const char* name) {
+        per_isolate_opts->per_env,
+        [isolate, &env_vars, &env_values](const char* name) {
           MaybeLocal<String> value =
               env_vars->Get(isolate, OneByteString(isolate, name));
-          return value.IsEmpty() ? std::string{}
-                                 : std::string(*String::Utf8Value(
-                                       isolate, value.ToLocalChecked()));
+          std::string text;
+          if (!value.IsEmpty())
+            text = *String::Utf8Value(isolate, value.ToLocalChecked());
+          env_values.push_back(text);
+          return text;
         });
 
 #ifndef NODE_WITHOUT_NODE_OPTIONS
@@ -497,18 +592,22 @@ void Worker::New(const FunctionCallbackInfo<Value>& args) {
     if (!maybe_node_opts.IsEmpty()) {
       std::string node_options(
           *String::Utf8Value(isolate, maybe_node_opts.ToLocalChecked()));
+      env_values.push_back(node_options);
       std::vector<std::string> errors{};
-      std::vector<std::string> env_argv =
-          ParseNodeOptionsEnvVar(node_options, &errors);
-      // [0] is expected to be the program name, add dummy string.
-      env_argv.insert(env_argv.begin(), "");
-      std::vector<std::string> invalid_args{};
-      options_parser::Parse(&env_argv,
-                            nullptr,
-                            &invalid_args,
-                            per_isolate_opts.get(),
-                            kAllowedInEnvironment,
-                            &errors);
+      if (!env_options_cache.Get(env_values, &per_isolate_opts, &errors)) {
+        std::vector<std::string> env_argv =
+            ParseNodeOptionsEnvVar(node_options, &errors);
+        // [0] is expected to be the program name, add dummy string.
+        env_argv.insert(env_argv.begin(), "");
+        std::vector<std::string> invalid_args{};
+        options_parser::Parse(&env_argv,
+                              nullptr,
+                              &invalid_args,
+                              per_isolate_opts.get(),
+                              kAllowedInEnvironment,
+                              &errors);
+        env_options_cache.Set(env_values, *per_isolate_opts, errors);
+      }
       if (errors.size() > 0 && args[1]->IsObject()) {
         // Only fail for explicitly provided env, this protects from failures
         // when NODE_OPTIONS from parent's env is used (which is the default).
@@ -592,6 +691,10 @@ void Worker::New(const FunctionCallbackInfo<Value>& args) {
   CHECK_EQ(limit_info->Length(), kTotalResourceLimitCount);
   limit_info->CopyContents(worker->resource_limits_,
                            sizeof(worker->resource_limits_));
+
+  worker->low_task_priority_ = args[4]->IsTrue();
+  if (args[5]->IsInt32())
+    worker->cpu_ = args[5].As<Int32>()->Value();
 }
 
 void Worker::StartThread(const FunctionCallbackInfo<Value>& args) {
@@ -678,6 +781,126 @@ Local<Float64Array> Worker::GetResourceLimits(Isolate* isolate) const {
   return Float64Array::New(ab, 0, kTotalResourceLimitCount);
 }
 
+namespace {
+
+// Returns the CPU time used by the current thread, in microseconds.
+double GetCurrentThreadCpuTime() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+#elif defined(_WIN32)
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (GetThreadTimes(GetCurrentThread(),
+                     &creation_time,
+                     &exit_time,
+                     &kernel_time,
+                     &user_time)) {
+    auto to_us = [](const FILETIME& time) {
+      return ((static_cast<uint64_t>(time.dwHighDateTime) << 32) |
+              time.dwLowDateTime) / 10.0;
+    };
+    return to_us(kernel_time) + to_us(user_time);
+  }
+#endif
+  return 0;
+}
+
+// While the event loop is busy, the heap and CPU statistics are refreshed at
+// most this often (in nanoseconds).
+constexpr uint64_t kResourceUsageUpdateInterval = 10 * 1000 * 1000;
+
+}  // anonymous namespace
+
+void Worker::StartResourceUsageTracking(Environment* env) {
+  UpdateResourceUsage();
+  last_usage_update_ = uv_hrtime();
+
+  // The time between the prepare and check phases is the time that the loop
+  // spends waiting for events. The statistics are also refreshed right before
+  // the thread becomes idle, so that they stay accurate while it is.
+  CHECK_EQ(uv_prepare_init(env->event_loop(), &usage_prepare_), 0);
+  CHECK_EQ(uv_prepare_start(&usage_prepare_, [](uv_prepare_t* handle) {
+    Worker* w = ContainerOf(&Worker::usage_prepare_, handle);
+    uint64_t now = uv_hrtime();
+    if (uv_backend_timeout(handle->loop) != 0 ||
+        now - w->last_usage_update_ >= kResourceUsageUpdateInterval) {
+      w->UpdateResourceUsage();
+      w->last_usage_update_ = now;
+    }
+    Mutex::ScopedLock lock(w->usage_mutex_);
+    w->loop_idle_since_ = now;
+  }), 0);
+
+  CHECK_EQ(uv_check_init(env->event_loop(), &usage_check_), 0);
+  CHECK_EQ(uv_check_start(&usage_check_, [](uv_check_t* handle) {
+    Worker* w = ContainerOf(&Worker::usage_check_, handle);
+    uint64_t now = uv_hrtime();
+    Mutex::ScopedLock lock(w->usage_mutex_);
+    if (w->loop_idle_since_ != 0) {
+      w->loop_idle_time_ += now - w->loop_idle_since_;
+      w->loop_idle_since_ = 0;
+    }
+  }), 0);
+
+  uv_handle_t* handles[] = {
+    reinterpret_cast<uv_handle_t*>(&usage_prepare_),
+    reinterpret_cast<uv_handle_t*>(&usage_check_)
+  };
+  for (uv_handle_t* handle : handles) {
+    uv_unref(handle);
+    env->RegisterHandleCleanup(handle, [](Environment* env,
+                                          uv_handle_t* handle,
+                                          void* arg) {
+      env->CloseHandle(handle, [](uv_handle_t* handle) {});
+    }, nullptr);
+  }
+}
+
+void Worker::UpdateResourceUsage() {
+  HeapStatistics heap_stats;
+  isolate_->GetHeapStatistics(&heap_stats);
+  double cpu_time = GetCurrentThreadCpuTime();
+
+  Mutex::ScopedLock lock(usage_mutex_);
+  resource_usage_[kHeapTotal] = heap_stats.total_heap_size();
+  resource_usage_[kHeapUsed] = heap_stats.used_heap_size();
+  resource_usage_[kHeapSizeLimit] = heap_stats.heap_size_limit();
+  resource_usage_[kExternalMemory] = heap_stats.external_memory();
+  resource_usage_[kCpuTime] = cpu_time;
+}
+
+void Worker::GetResourceUsage(const FunctionCallbackInfo<Value>& args) {
+  Worker* w;
+  ASSIGN_OR_RETURN_UNWRAP(&w, args.This());
+
+  CHECK(args[0]->IsFloat64Array());
+  Local<Float64Array> array = args[0].As<Float64Array>();
+  CHECK_EQ(array->Length(), kTotalResourceUsageFieldCount);
+  double* fields = static_cast<double*>(
+      array->Buffer()->GetBackingStore()->Data());
+
+  uint64_t now = uv_hrtime();
+  Mutex::ScopedLock lock(w->usage_mutex_);
+  std::copy(std::begin(w->resource_usage_),
+            std::end(w->resource_usage_),
+            fields);
+
+  // Event loop times are reported in milliseconds, and count from the start
+  // of the loop up to now, including the current idle period, if any.
+  uint64_t idle_time = 0;
+  uint64_t active_time = 0;
+  if (w->loop_start_ != 0) {
+    idle_time = w->loop_idle_time_;
+    if (w->loop_idle_since_ != 0)
+      idle_time += now - w->loop_idle_since_;
+    uint64_t total_time = now - w->loop_start_;
+    active_time = total_time > idle_time ? total_time - idle_time : 0;
+  }
+  fields[kLoopIdleTime] = idle_time / 1e6;
+  fields[kLoopActiveTime] = active_time / 1e6;
+}
+
 void Worker::Exit(int code) {
   Mutex::ScopedLock lock(mutex_);
   Debug(this, "Worker %llu called Exit(%d)", thread_id_, code);
@@ -771,6 +994,7 @@ void InitWorker(Local<Object> target,
     env->SetProtoMethod(w, "unref", Worker::Unref);
     env->SetProtoMethod(w, "getResourceLimits", Worker::GetResourceLimits);
     env->SetProtoMethod(w, "takeHeapSnapshot", Worker::TakeHeapSnapshot);
+    env->SetProtoMethod(w, "getResourceUsage", Worker::GetResourceUsage);
 
     Local<String> workerString =
         FIXED_ONE_BYTE_STRING(env->isolate(), "Worker");
@@ -824,6 +1048,15 @@ void InitWorker(Local<Object> target,
   NODE_DEFINE_CONSTANT(target, kMaxOldGenerationSizeMb);
   NODE_DEFINE_CONSTANT(target, kCodeRangeSizeMb);
   NODE_DEFINE_CONSTANT(target, kTotalResourceLimitCount);
+
+  NODE_DEFINE_CONSTANT(target, kHeapTotal);
+  NODE_DEFINE_CONSTANT(target, kHeapUsed);
+  NODE_DEFINE_CONSTANT(target, kHeapSizeLimit);
+  NODE_DEFINE_CONSTANT(target, kExternalMemory);
+  NODE_DEFINE_CONSTANT(target, kCpuTime);
+  NODE_DEFINE_CONSTANT(target, kLoopIdleTime);
+  NODE_DEFINE_CONSTANT(target, kLoopActiveTime);
+  NODE_DEFINE_CONSTANT(target, kTotalResourceUsageFieldCount);
 }
 
 }  // anonymous namespace
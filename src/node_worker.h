@@ -19,6 +19,17 @@ enum ResourceLimits {
   kTotalResourceLimitCount
 };
 
+enum ResourceUsageFields {
+  kHeapTotal,
+  kHeapUsed,
+  kHeapSizeLimit,
+  kExternalMemory,
+  kCpuTime,
+  kLoopIdleTime,
+  kLoopActiveTime,
+  kTotalResourceUsageFieldCount
+};
+
 // A worker thread, as represented in its parent thread.
 class Worker : public AsyncWrap {
  public:
@@ -61,9 +72,14 @@ class Worker : public AsyncWrap {
       const v8::FunctionCallbackInfo<v8::Value>& args);
   v8::Local<v8::Float64Array> GetResourceLimits(v8::Isolate* isolate) const;
   static void TakeHeapSnapshot(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void GetResourceUsage(const v8::FunctionCallbackInfo<v8::Value>& args);
 
  private:
   void CreateEnvMessagePort(Environment* env);
+  // Installs the loop hooks that keep the resource usage of the thread
+  // up to date. This is only called from the worker thread.
+  void StartResourceUsageTracking(Environment* env);
+  void UpdateResourceUsage();
   static size_t NearHeapLimit(void* data, size_t current_heap_limit,
                               size_t initial_heap_limit);
 
@@ -80,6 +96,20 @@ class Worker : public AsyncWrap {
   std::unique_ptr<inspector::ParentInspectorHandle> inspector_parent_handle_;
 #endif
 
+  // Live resource usage of the thread, which is written by the worker thread
+  // on each event loop iteration and can be read by the parent at any time.
+  // The loop times are uv_hrtime() values, and `loop_idle_since_` is non-zero
+  // while the thread is waiting for events.
+  mutable Mutex usage_mutex_;
+  double resource_usage_[kLoopIdleTime] = {};
+  uint64_t loop_start_ = 0;
+  uint64_t loop_idle_time_ = 0;
+  uint64_t loop_idle_since_ = 0;
+  // Only used on the worker thread:
+  uint64_t last_usage_update_ = 0;
+  uv_prepare_t usage_prepare_;
+  uv_check_t usage_check_;
+
   // This mutex protects access to all variables listed below it.
   mutable Mutex mutex_;
 
@@ -93,6 +123,11 @@ class Worker : public AsyncWrap {
   double resource_limits_[kTotalResourceLimitCount];
   void UpdateResourceConstraints(v8::ResourceConstraints* constraints);
 
+  // Whether the V8 background tasks of this worker run with low priority.
+  bool low_task_priority_ = false;
+  // The index of the CPU to pin the thread of this worker to, or -1.
+  int cpu_ = -1;
+
   // Full size of the thread's stack.
   static constexpr size_t kStackSize = 4 * 1024 * 1024;
   // Stack buffer size that is not available to the JS engine.
@@ -24,7 +24,9 @@
 #include "node_buffer.h"
 
 #include "async_wrap-inl.h"
+#include "base_object-inl.h"
 #include "env-inl.h"
+#include "stream_base-inl.h"
 #include "threadpoolwork-inl.h"
 #include "util-inl.h"
 
@@ -40,11 +42,14 @@
 #include <cstdlib>
 #include <cstring>
 #include <atomic>
+#include <memory>
+#include <vector>
 
 namespace node {
 
 using v8::Array;
 using v8::ArrayBuffer;
+using v8::ArrayBufferView;
 using v8::Context;
 using v8::Function;
 using v8::FunctionCallbackInfo;
@@ -54,10 +59,12 @@ using v8::HandleScope;
 using v8::Int32;
 using v8::Integer;
 using v8::Local;
+using v8::Number;
 using v8::Object;
 using v8::String;
 using v8::Uint32;
 using v8::Uint32Array;
+using v8::Undefined;
 using v8::Value;
 
 namespace {
@@ -121,6 +128,176 @@ struct CompressionError {
   inline bool IsError() const { return code != nullptr; }
 };
 
+// A pool of idle zlib states that streams initialized with it take their
+// z_stream from, and give it back to once they are closed. States are
+// reset and handed to the next stream with the same parameters, so that
+// creating many short-lived streams does not pay for deflateInit2() (about
+// 256 KB of allocations by default) or for inflate's window each time.
+//
+// A pool may also hold a preset dictionary; this is what backs
+// zlib.Dictionary, whose bytes are then stored once instead of being copied
+// into every stream. lib/zlib.js also keeps one pool without a dictionary
+// for the one-shot convenience methods.
+//
+// The states are allocated through this object, and their memory reported
+// to V8 from here rather than by the streams. inflate() may allocate its
+// window on the threadpool, so the counter is atomic and reported whenever
+// a state is acquired or released on the main thread.
+class ZlibStatePool : public BaseObject {
+ public:
+  static constexpr size_t kMaxPooledStates = 8;
+
+  ZlibStatePool(Environment* env,
+                Local<Object> wrap,
+                std::vector<unsigned char>&& dictionary)
+      : BaseObject(env, wrap), dictionary_(std::move(dictionary)) {
+    MakeWeak();
+  }
+
+  ~ZlibStatePool() override {
+    for (PooledState& state : pool_) {
+      if (state.deflate)
+        deflateEnd(state.strm.get());
+      else
+        inflateEnd(state.strm.get());
+    }
+    pool_.clear();
+    ReportMemory();
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args.IsConstructCall());
+    std::vector<unsigned char> dictionary;
+    if (Buffer::HasInstance(args[0])) {
+      const unsigned char* data =
+          reinterpret_cast<unsigned char*>(Buffer::Data(args[0]));
+      dictionary.assign(data, data + Buffer::Length(args[0]));
+    }
+    new ZlibStatePool(env, args.This(), std::move(dictionary));
+  }
+
+  const std::vector<unsigned char>& dictionary() const { return dictionary_; }
+
+  // Returns a deflate or inflate state initialized with the given
+  // parameters, either a pooled one or a new one. |level|, |mem_level| and
+  // |strategy| are ignored for inflate states. Stores zlib's return code in
+  // |err|.
+  std::unique_ptr<z_stream> Acquire(bool deflate,
+                                    int level,
+                                    int window_bits,
+                                    int mem_level,
+                                    int strategy,
+                                    int* err) {
+    if (!deflate)
+      level = mem_level = strategy = 0;
+
+    for (auto it = pool_.begin(); it != pool_.end(); ++it) {
+      if (it->deflate == deflate && it->level == level &&
+          it->window_bits == window_bits && it->mem_level == mem_level &&
+          it->strategy == strategy) {
+        std::unique_ptr<z_stream> strm = std::move(it->strm);
+        pool_.erase(it);
+        *err = Z_OK;
+        ReportMemory();
+        return strm;
+      }
+    }
+
+    std::unique_ptr<z_stream> strm(new z_stream());
+    strm->zalloc = Alloc;
+    strm->zfree = Free;
+    strm->opaque = this;
+    if (deflate) {
+      *err = deflateInit2(strm.get(), level, Z_DEFLATED, window_bits,
+                          mem_level, strategy);
+    } else {
+      *err = inflateInit2(strm.get(), window_bits);
+    }
+    ReportMemory();
+    return strm;
+  }
+
+  // Takes back a state returned by Acquire(). States that are not
+  // |reusable|, e.g. because their parameters were changed, are freed.
+  void Release(std::unique_ptr<z_stream> strm,
+               bool deflate,
+               int level,
+               int window_bits,
+               int mem_level,
+               int strategy,
+               bool reusable) {
+    if (!deflate)
+      level = mem_level = strategy = 0;
+
+    if (reusable && pool_.size() < kMaxPooledStates &&
+        (deflate ? deflateReset(strm.get()) : inflateReset(strm.get())) ==
+            Z_OK) {
+      pool_.push_back({ deflate, level, window_bits, mem_level, strategy,
+                        std::move(strm) });
+    } else if (deflate) {
+      deflateEnd(strm.get());
+    } else {
+      inflateEnd(strm.get());
+    }
+    ReportMemory();
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackField("dictionary", dictionary_);
+    tracker->TrackFieldWithSize("states", memory_);
+  }
+
+  SET_MEMORY_INFO_NAME(ZlibStatePool)
+  SET_SELF_SIZE(ZlibStatePool)
+
+ private:
+  struct PooledState {
+    bool deflate;
+    int level;
+    int window_bits;
+    int mem_level;
+    int strategy;
+    std::unique_ptr<z_stream> strm;
+  };
+
+  // Same layout as CompressionStream::AllocForZlib(), without the deferred
+  // reporting.
+  static void* Alloc(void* data, uInt items, uInt size) {
+    const size_t real_size =
+        MultiplyWithOverflowCheck(static_cast<size_t>(items),
+                                  static_cast<size_t>(size)) + sizeof(size_t);
+    char* memory = UncheckedMalloc(real_size);
+    if (UNLIKELY(memory == nullptr)) return nullptr;
+    *reinterpret_cast<size_t*>(memory) = real_size;
+    static_cast<ZlibStatePool*>(data)->memory_.fetch_add(
+        real_size, std::memory_order_relaxed);
+    return memory + sizeof(size_t);
+  }
+
+  static void Free(void* data, void* pointer) {
+    if (UNLIKELY(pointer == nullptr)) return;
+    char* real_pointer = static_cast<char*>(pointer) - sizeof(size_t);
+    static_cast<ZlibStatePool*>(data)->memory_.fetch_sub(
+        *reinterpret_cast<size_t*>(real_pointer), std::memory_order_relaxed);
+    free(real_pointer);
+  }
+
+  void ReportMemory() {
+    const size_t memory = memory_.load(std::memory_order_relaxed);
+    const int64_t change = static_cast<int64_t>(memory) -
+                           static_cast<int64_t>(reported_memory_);
+    if (change == 0) return;
+    env()->isolate()->AdjustAmountOfExternalAllocatedMemory(change);
+    reported_memory_ = memory;
+  }
+
+  const std::vector<unsigned char> dictionary_;
+  std::vector<PooledState> pool_;
+  std::atomic<size_t> memory_{0};
+  size_t reported_memory_ = 0;
+};
+
 class ZlibContext : public MemoryRetainer {
  public:
   ZlibContext() = default;
@@ -137,7 +314,8 @@ class ZlibContext : public MemoryRetainer {
 
   // Zlib-specific:
   CompressionError Init(int level, int window_bits, int mem_level, int strategy,
-                        std::vector<unsigned char>&& dictionary);
+                        std::vector<unsigned char>&& dictionary,
+                        ZlibStatePool* state_pool);
   void SetAllocationFunctions(alloc_func alloc, free_func free, void* opaque);
   CompressionError SetParams(int level, int strategy);
 
@@ -155,6 +333,10 @@ class ZlibContext : public MemoryRetainer {
   CompressionError ErrorForMessage(const char* message) const;
   CompressionError SetDictionary();
 
+  inline const std::vector<unsigned char>& dictionary() const {
+    return state_pool_ ? state_pool_->dictionary() : dictionary_;
+  }
+
   int err_ = 0;
   int flush_ = 0;
   int level_ = 0;
@@ -164,8 +346,15 @@ class ZlibContext : public MemoryRetainer {
   int window_bits_ = 0;
   unsigned int gzip_id_bytes_read_ = 0;
   std::vector<unsigned char> dictionary_;
-
-  z_stream strm_;
+  BaseObjectPtr<ZlibStatePool> state_pool_;
+  // Whether strm_ was obtained from state_pool_, whether it is a deflate
+  // state (mode_ may change for UNZIP), and whether it can still be reused
+  // by another stream once this one is done with it.
+  bool pooled_state_ = false;
+  bool pooled_deflate_ = false;
+  bool params_changed_ = false;
+
+  std::unique_ptr<z_stream> strm_ { new z_stream() };
 };
 
 // Brotli has different data types for compression and decompression streams,
@@ -244,7 +433,7 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
  public:
   CompressionStream(Environment* env, Local<Object> wrap)
       : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_ZLIB),
-        ThreadPoolWork(env),
+        ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_KIND_ZLIB),
         write_result_(nullptr) {
     MakeWeak();
   }
@@ -257,6 +446,9 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
   }
 
   void Close() {
+    if (piping_)
+      Unpipe(UV_ECANCELED);
+
     if (write_in_progress_) {
       pending_close_ = true;
       return;
@@ -401,6 +593,14 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
     HandleScope handle_scope(env->isolate());
     Context::Scope context_scope(env->context());
 
+    if (pipe_work_) {
+      pipe_work_ = false;
+      AfterPipeWork();
+      if (pending_close_)
+        Close();
+      return;
+    }
+
     if (!CheckError())
       return;
 
@@ -445,6 +645,45 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
       wrap->EmitError(err);
   }
 
+  // startPipe(source, sink, flush, finishFlush, chunkSize)
+  // Transforms the data that is read from the `source` StreamBase and writes
+  // the output to the `sink` StreamBase, without passing through JS. Reading
+  // stops while a chunk is being processed or its output is being written.
+  // `onunpipe(status)` is called once the source has ended and all of its
+  // data has been written, or when piping stopped early.
+  static void StartPipe(const FunctionCallbackInfo<Value>& args) {
+    CompressionStream* ctx;
+    ASSIGN_OR_RETURN_UNWRAP(&ctx, args.Holder());
+    Local<Context> context = ctx->AsyncWrap::env()->context();
+    CHECK(args[0]->IsObject());
+    CHECK(args[1]->IsObject());
+    StreamBase* source = StreamBase::FromObject(args[0].As<Object>());
+    StreamBase* sink = StreamBase::FromObject(args[1].As<Object>());
+    CHECK_NOT_NULL(source);
+    CHECK_NOT_NULL(sink);
+
+    uint32_t flush, finish_flush, chunk_size;
+    if (!args[2]->Uint32Value(context).To(&flush) ||
+        !args[3]->Uint32Value(context).To(&finish_flush) ||
+        !args[4]->Uint32Value(context).To(&chunk_size)) {
+      return;
+    }
+    CHECK_GT(chunk_size, 0);
+
+    CHECK(ctx->init_done_ && "pipe before init");
+    CHECK(!ctx->closed_ && "already finalized");
+    CHECK_EQ(false, ctx->write_in_progress_);
+    CHECK_EQ(false, ctx->piping_);
+    ctx->pipe_flush_ = flush;
+    ctx->pipe_finish_flush_ = finish_flush;
+    ctx->pipe_chunk_size_ = chunk_size;
+    ctx->piping_ = true;
+    ctx->Ref();
+    source->PushStreamListener(&ctx->pipe_readable_listener_);
+    sink->PushStreamListener(&ctx->pipe_writable_listener_);
+    source->ReadStart();
+  }
+
   void MemoryInfo(MemoryTracker* tracker) const override {
     tracker->TrackField("compression context", ctx_);
     tracker->TrackFieldWithSize("zlib_memory",
@@ -525,6 +764,206 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
     }
   }
 
+  class PipeReadableListener final : public StreamListener {
+   public:
+    uv_buf_t OnStreamAlloc(size_t suggested_size) override {
+      CompressionStream* ctx =
+          ContainerOf(&CompressionStream::pipe_readable_listener_, this);
+      return ctx->AsyncWrap::env()->AllocateManaged(suggested_size).release();
+    }
+
+    void OnStreamRead(ssize_t nread, const uv_buf_t& buf_) override {
+      CompressionStream* ctx =
+          ContainerOf(&CompressionStream::pipe_readable_listener_, this);
+      AllocatedBuffer buf(ctx->AsyncWrap::env(), buf_);
+      if (nread == 0)
+        return;
+
+      stream()->ReadStop();
+      if (nread < 0) {
+        // Let the previous listener, which might be JS, see the end of the
+        // stream or the error.
+        StreamListener* previous = previous_listener_;
+        if (nread != UV_EOF) {
+          ctx->Unpipe(static_cast<int>(nread));
+          previous->OnStreamRead(nread, uv_buf_init(nullptr, 0));
+          return;
+        }
+        previous->OnStreamRead(nread, uv_buf_init(nullptr, 0));
+        if (!ctx->piping_)
+          return;
+        ctx->pipe_finishing_ = true;
+        ctx->PipeProcess();
+        return;
+      }
+
+      buf.Resize(nread);
+      ctx->pipe_input_ = std::move(buf);
+      ctx->pipe_input_offset_ = 0;
+      ctx->PipeProcess();
+    }
+
+    void OnStreamDestroy() override {
+      CompressionStream* ctx =
+          ContainerOf(&CompressionStream::pipe_readable_listener_, this);
+      // The source is destroyed once it has ended, which leaves its data to
+      // be finished.
+      ctx->pipe_source_destroyed_ = true;
+      if (!ctx->pipe_finishing_)
+        ctx->Unpipe(UV_EPIPE);
+    }
+  };
+
+  class PipeWritableListener final : public StreamListener {
+   public:
+    uv_buf_t OnStreamAlloc(size_t suggested_size) override {
+      CHECK_NOT_NULL(previous_listener_);
+      return previous_listener_->OnStreamAlloc(suggested_size);
+    }
+
+    void OnStreamRead(ssize_t nread, const uv_buf_t& buf) override {
+      CHECK_NOT_NULL(previous_listener_);
+      previous_listener_->OnStreamRead(nread, buf);
+    }
+
+    void OnStreamAfterWrite(WriteWrap* w, int status) override {
+      CompressionStream* ctx =
+          ContainerOf(&CompressionStream::pipe_writable_listener_, this);
+      if (w == nullptr || w != ctx->pipe_write_) {
+        // This write was not made by the pipe.
+        CHECK_NOT_NULL(previous_listener_);
+        previous_listener_->OnStreamAfterWrite(w, status);
+        return;
+      }
+      ctx->pipe_write_ = nullptr;
+      if (status != 0)
+        return ctx->Unpipe(status);
+      ctx->PipeContinue();
+    }
+
+    void OnStreamDestroy() override {
+      CompressionStream* ctx =
+          ContainerOf(&CompressionStream::pipe_writable_listener_, this);
+      ctx->Unpipe(UV_EPIPE);
+    }
+  };
+
+  // What the pipe does once the output of a chunk has been written.
+  enum class PipeNext { kProcess, kRead, kEnd };
+
+  StreamBase* pipe_source() {
+    return static_cast<StreamBase*>(pipe_readable_listener_.stream());
+  }
+
+  StreamBase* pipe_sink() {
+    return static_cast<StreamBase*>(pipe_writable_listener_.stream());
+  }
+
+  // Processes the rest of pipe_input_ on the thread pool, or finishes the
+  // stream if pipe_finishing_ is set.
+  void PipeProcess() {
+    AllocScope alloc_scope(this);
+    CHECK_EQ(false, write_in_progress_);
+    pipe_output_ = AsyncWrap::env()->AllocateManaged(pipe_chunk_size_);
+    pipe_input_length_ =
+        static_cast<uint32_t>(pipe_input_.size() - pipe_input_offset_);
+    ctx_.SetBuffers(pipe_input_.data() + pipe_input_offset_,
+                    pipe_input_length_,
+                    pipe_output_.data(),
+                    pipe_chunk_size_);
+    ctx_.SetFlush(pipe_finishing_ ? pipe_finish_flush_ : pipe_flush_);
+    write_in_progress_ = true;
+    pipe_work_ = true;
+    Ref();
+    ScheduleWork();
+  }
+
+  void AfterPipeWork() {
+    if (!piping_) {
+      pipe_input_.clear();
+      pipe_output_.clear();
+      return;
+    }
+
+    const CompressionError err = ctx_.GetErrorInfo();
+    if (err.IsError()) {
+      Unpipe(UV_ECANCELED);
+      EmitError(err);
+      return;
+    }
+
+    uint32_t avail_in, avail_out;
+    ctx_.GetAfterWriteOffsets(&avail_in, &avail_out);
+    pipe_input_offset_ += pipe_input_length_ - avail_in;
+    if (avail_out == 0) {
+      // The output buffer was too small.
+      pipe_next_ = PipeNext::kProcess;
+    } else if (avail_in > 0 || pipe_finishing_) {
+      // Either the stream is done, or the compressed data ended before the
+      // input did. The rest of the input is ignored, as in JS.
+      pipe_next_ = PipeNext::kEnd;
+    } else {
+      pipe_next_ = PipeNext::kRead;
+    }
+
+    const size_t have = pipe_chunk_size_ - avail_out;
+    if (have > 0) {
+      AllocatedBuffer output = std::move(pipe_output_);
+      uv_buf_t buf = uv_buf_init(output.data(), have);
+      StreamWriteResult res = pipe_sink()->Write(&buf, 1);
+      if (res.err != 0)
+        return Unpipe(res.err);
+      if (res.async) {
+        pipe_write_ = res.wrap;
+        res.wrap->SetAllocatedStorage(std::move(output));
+        return;
+      }
+    }
+    PipeContinue();
+  }
+
+  void PipeContinue() {
+    switch (pipe_next_) {
+      case PipeNext::kProcess:
+        PipeProcess();
+        break;
+      case PipeNext::kRead:
+        pipe_input_.clear();
+        pipe_source()->ReadStart();
+        break;
+      case PipeNext::kEnd:
+        Unpipe(0);
+        break;
+    }
+  }
+
+  void Unpipe(int status) {
+    if (!piping_)
+      return;
+    piping_ = false;
+
+    // The source removes the listener itself if it is being destroyed.
+    if (!pipe_source_destroyed_) {
+      pipe_source()->ReadStop();
+      pipe_source()->RemoveStreamListener(&pipe_readable_listener_);
+    }
+    pipe_sink()->RemoveStreamListener(&pipe_writable_listener_);
+    if (!write_in_progress_) {
+      pipe_input_.clear();
+      pipe_output_.clear();
+    }
+
+    // This might be called from inside the garbage collector, so the JS
+    // callback is delayed.
+    AsyncWrap::env()->SetImmediate([this, status](Environment* env) {
+      HandleScope handle_scope(env->isolate());
+      Context::Scope context_scope(env->context());
+      Local<Value> arg = Integer::New(env->isolate(), status);
+      MakeCallback(env->onunpipe_string(), 1, &arg);
+      Unref();
+    });
+  }
+
   bool init_done_ = false;
   bool write_in_progress_ = false;
   bool pending_close_ = false;
@@ -535,6 +974,23 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
   std::atomic<ssize_t> unreported_allocations_{0};
   size_t zlib_memory_ = 0;
 
+  // State of startPipe().
+  PipeReadableListener pipe_readable_listener_;
+  PipeWritableListener pipe_writable_listener_;
+  bool piping_ = false;
+  bool pipe_work_ = false;
+  bool pipe_finishing_ = false;
+  bool pipe_source_destroyed_ = false;
+  uint32_t pipe_flush_ = 0;
+  uint32_t pipe_finish_flush_ = 0;
+  uint32_t pipe_chunk_size_ = 0;
+  AllocatedBuffer pipe_input_;
+  size_t pipe_input_offset_ = 0;
+  uint32_t pipe_input_length_ = 0;
+  AllocatedBuffer pipe_output_;
+  WriteWrap* pipe_write_ = nullptr;
+  PipeNext pipe_next_ = PipeNext::kRead;
+
   CompressionContext ctx_;
 };
 
@@ -599,12 +1055,15 @@ class ZlibStream : public CompressionStream<ZlibContext> {
     Local<Function> write_js_callback = args[5].As<Function>();
 
     std::vector<unsigned char> dictionary;
+    ZlibStatePool* state_pool = nullptr;
     if (Buffer::HasInstance(args[6])) {
       unsigned char* data =
           reinterpret_cast<unsigned char*>(Buffer::Data(args[6]));
       dictionary = std::vector<unsigned char>(
           data,
           data + Buffer::Length(args[6]));
+    } else if (args[6]->IsObject()) {
+      ASSIGN_OR_RETURN_UNWRAP(&state_pool, args[6].As<Object>());
     }
 
     wrap->InitStream(write_result, write_js_callback);
@@ -614,7 +1073,7 @@ class ZlibStream : public CompressionStream<ZlibContext> {
         AllocForZlib, FreeForZlib, static_cast<CompressionStream*>(wrap));
     const CompressionError err =
         wrap->context()->Init(level, window_bits, mem_level, strategy,
-                              std::move(dictionary));
+                              std::move(dictionary), state_pool);
     if (err.IsError())
       wrap->EmitError(err);
 
@@ -724,17 +1183,24 @@ void ZlibContext::Close() {
   CHECK_LE(mode_, UNZIP);
 
   int status = Z_OK;
-  if (mode_ == DEFLATE || mode_ == GZIP || mode_ == DEFLATERAW) {
-    status = deflateEnd(&strm_);
+  if (pooled_state_) {
+    state_pool_->Release(std::move(strm_), pooled_deflate_, level_,
+                         window_bits_, mem_level_, strategy_,
+                         !params_changed_);
+    strm_.reset(new z_stream());
+    pooled_state_ = false;
+  } else if (mode_ == DEFLATE || mode_ == GZIP || mode_ == DEFLATERAW) {
+    status = deflateEnd(strm_.get());
   } else if (mode_ == INFLATE || mode_ == GUNZIP || mode_ == INFLATERAW ||
              mode_ == UNZIP) {
-    status = inflateEnd(&strm_);
+    status = inflateEnd(strm_.get());
   }
 
   CHECK(status == Z_OK || status == Z_DATA_ERROR);
   mode_ = NONE;
 
   dictionary_.clear();
+  state_pool_.reset();
 }
 
 
@@ -748,11 +1214,11 @@ void ZlibContext::DoThreadPoolWork() {
     case DEFLATE:
     case GZIP:
     case DEFLATERAW:
-      err_ = deflate(&strm_, flush_);
+      err_ = deflate(strm_.get(), flush_);
       break;
     case UNZIP:
-      if (strm_.avail_in > 0) {
-        next_expected_header_byte = strm_.next_in;
+      if (strm_->avail_in > 0) {
+        next_expected_header_byte = strm_->next_in;
       }
 
       switch (gzip_id_bytes_read_) {
@@ -765,7 +1231,7 @@ void ZlibContext::DoThreadPoolWork() {
             gzip_id_bytes_read_ = 1;
             next_expected_header_byte++;
 
-            if (strm_.avail_in == 1) {
+            if (strm_->avail_in == 1) {
               // The only available byte was already read.
               break;
             }
@@ -798,20 +1264,20 @@ void ZlibContext::DoThreadPoolWork() {
     case INFLATE:
     case GUNZIP:
     case INFLATERAW:
-      err_ = inflate(&strm_, flush_);
+      err_ = inflate(strm_.get(), flush_);
 
       // If data was encoded with dictionary (INFLATERAW will have it set in
       // SetDictionary, don't repeat that here)
       if (mode_ != INFLATERAW &&
           err_ == Z_NEED_DICT &&
-          !dictionary_.empty()) {
+          !dictionary().empty()) {
         // Load it
-        err_ = inflateSetDictionary(&strm_,
-                                    dictionary_.data(),
-                                    dictionary_.size());
+        err_ = inflateSetDictionary(strm_.get(),
+                                    dictionary().data(),
+                                    dictionary().size());
         if (err_ == Z_OK) {
           // And try to decode again
-          err_ = inflate(&strm_, flush_);
+          err_ = inflate(strm_.get(), flush_);
         } else if (err_ == Z_DATA_ERROR) {
           // Both inflateSetDictionary() and inflate() return Z_DATA_ERROR.
           // Make it possible for After() to tell a bad dictionary from bad
@@ -820,17 +1286,17 @@ void ZlibContext::DoThreadPoolWork() {
         }
       }
 
-      while (strm_.avail_in > 0 &&
+      while (strm_->avail_in > 0 &&
              mode_ == GUNZIP &&
              err_ == Z_STREAM_END &&
-             strm_.next_in[0] != 0x00) {
+             strm_->next_in[0] != 0x00) {
         // Bytes remain in input buffer. Perhaps this is another compressed
         // member in the same archive, or just trailing garbage.
         // Trailing zero bytes are okay, though, since they are frequently
         // used for padding.
 
         ResetStream();
-        err_ = inflate(&strm_, flush_);
+        err_ = inflate(strm_.get(), flush_);
       }
       break;
     default:
@@ -841,10 +1307,10 @@ void ZlibContext::DoThreadPoolWork() {
 
 void ZlibContext::SetBuffers(char* in, uint32_t in_len,
                              char* out, uint32_t out_len) {
-  strm_.avail_in = in_len;
-  strm_.next_in = reinterpret_cast<Bytef*>(in);
-  strm_.avail_out = out_len;
-  strm_.next_out = reinterpret_cast<Bytef*>(out);
+  strm_->avail_in = in_len;
+  strm_->next_in = reinterpret_cast<Bytef*>(in);
+  strm_->avail_out = out_len;
+  strm_->next_out = reinterpret_cast<Bytef*>(out);
 }
 
 
@@ -855,14 +1321,14 @@ void ZlibContext::SetFlush(int flush) {
 
 void ZlibContext::GetAfterWriteOffsets(uint32_t* avail_in,
                                        uint32_t* avail_out) const {
-  *avail_in = strm_.avail_in;
-  *avail_out = strm_.avail_out;
+  *avail_in = strm_->avail_in;
+  *avail_out = strm_->avail_out;
 }
 
 
 CompressionError ZlibContext::ErrorForMessage(const char* message) const {
-  if (strm_.msg != nullptr)
-    message = strm_.msg;
+  if (strm_->msg != nullptr)
+    message = strm_->msg;
 
   return CompressionError { message, ZlibStrerror(err_), err_ };
 }
@@ -873,14 +1339,14 @@ CompressionError ZlibContext::GetErrorInfo() const {
   switch (err_) {
   case Z_OK:
   case Z_BUF_ERROR:
-    if (strm_.avail_out != 0 && flush_ == Z_FINISH) {
+    if (strm_->avail_out != 0 && flush_ == Z_FINISH) {
       return ErrorForMessage("unexpected end of file");
     }
   case Z_STREAM_END:
     // normal statuses, not fatal
     break;
   case Z_NEED_DICT:
-    if (dictionary_.empty())
+    if (dictionary().empty())
       return ErrorForMessage("Missing dictionary");
     else
       return ErrorForMessage("Bad dictionary");
@@ -900,12 +1366,12 @@ CompressionError ZlibContext::ResetStream() {
     case DEFLATE:
     case DEFLATERAW:
     case GZIP:
-      err_ = deflateReset(&strm_);
+      err_ = deflateReset(strm_.get());
       break;
     case INFLATE:
     case INFLATERAW:
     case GUNZIP:
-      err_ = inflateReset(&strm_);
+      err_ = inflateReset(strm_.get());
       break;
     default:
       break;
@@ -921,15 +1387,16 @@ CompressionError ZlibContext::ResetStream() {
 void ZlibContext::SetAllocationFunctions(alloc_func alloc,
                                          free_func free,
                                          void* opaque) {
-  strm_.zalloc = alloc;
-  strm_.zfree = free;
-  strm_.opaque = opaque;
+  strm_->zalloc = alloc;
+  strm_->zfree = free;
+  strm_->opaque = opaque;
 }
 
 
 CompressionError ZlibContext::Init(
     int level, int window_bits, int mem_level, int strategy,
-    std::vector<unsigned char>&& dictionary) {
+    std::vector<unsigned char>&& dictionary,
+    ZlibStatePool* state_pool) {
   if (!((window_bits == 0) &&
         (mode_ == INFLATE ||
          mode_ == GUNZIP ||
@@ -971,11 +1438,20 @@ CompressionError ZlibContext::Init(
     window_bits_ *= -1;
   }
 
+  state_pool_.reset(state_pool);
+
   switch (mode_) {
     case DEFLATE:
     case GZIP:
     case DEFLATERAW:
-      err_ = deflateInit2(&strm_,
+      if (state_pool_) {
+        strm_ = state_pool_->Acquire(
+            true, level_, window_bits_, mem_level_, strategy_, &err_);
+        pooled_state_ = err_ == Z_OK;
+        pooled_deflate_ = true;
+        break;
+      }
+      err_ = deflateInit2(strm_.get(),
                           level_,
                           Z_DEFLATED,
                           window_bits_,
@@ -986,7 +1462,14 @@ CompressionError ZlibContext::Init(
     case GUNZIP:
     case INFLATERAW:
     case UNZIP:
-      err_ = inflateInit2(&strm_, window_bits_);
+      if (state_pool_) {
+        strm_ = state_pool_->Acquire(
+            false, level_, window_bits_, mem_level_, strategy_, &err_);
+        pooled_state_ = err_ == Z_OK;
+        pooled_deflate_ = false;
+        break;
+      }
+      err_ = inflateInit2(strm_.get(), window_bits_);
       break;
     default:
       UNREACHABLE();
@@ -996,6 +1479,7 @@ CompressionError ZlibContext::Init(
 
   if (err_ != Z_OK) {
     dictionary_.clear();
+    state_pool_.reset();
     mode_ = NONE;
     return ErrorForMessage(nullptr);
   }
@@ -1005,7 +1489,8 @@ CompressionError ZlibContext::Init(
 
 
 CompressionError ZlibContext::SetDictionary() {
-  if (dictionary_.empty())
+  const std::vector<unsigned char>& dictionary = this->dictionary();
+  if (dictionary.empty())
     return CompressionError {};
 
   err_ = Z_OK;
@@ -1013,16 +1498,16 @@ CompressionError ZlibContext::SetDictionary() {
   switch (mode_) {
     case DEFLATE:
     case DEFLATERAW:
-      err_ = deflateSetDictionary(&strm_,
-                                  dictionary_.data(),
-                                  dictionary_.size());
+      err_ = deflateSetDictionary(strm_.get(),
+                                  dictionary.data(),
+                                  dictionary.size());
       break;
     case INFLATERAW:
       // The other inflate cases will have the dictionary set when inflate()
       // returns Z_NEED_DICT in Process()
-      err_ = inflateSetDictionary(&strm_,
-                                  dictionary_.data(),
-                                  dictionary_.size());
+      err_ = inflateSetDictionary(strm_.get(),
+                                  dictionary.data(),
+                                  dictionary.size());
       break;
     default:
       break;
@@ -1042,7 +1527,8 @@ CompressionError ZlibContext::SetParams(int level, int strategy) {
   switch (mode_) {
     case DEFLATE:
     case DEFLATERAW:
-      err_ = deflateParams(&strm_, level, strategy);
+      err_ = deflateParams(strm_.get(), level, strategy);
+      params_changed_ = true;
       break;
     default:
       break;
@@ -1211,6 +1697,208 @@ CompressionError BrotliDecoderContext::GetErrorInfo() const {
 }
 
 
+// Backs zlib.createGzip({ parallel }). The input is split into blocks in JS,
+// and every block is compressed into raw deflate data by its own threadpool
+// task. Like pigz, each block is primed with the last 32 KB of the previous
+// block's input as a dictionary and, except for the last one, ends with a
+// Z_SYNC_FLUSH, so that concatenating the results in order yields a single
+// valid deflate stream. JS adds the gzip header and trailer; the CRC-32 of
+// every block is computed here and combined with crc32Combine().
+class ParallelDeflate : public AsyncWrap {
+ public:
+  ParallelDeflate(Environment* env,
+                  Local<Object> wrap,
+                  ZlibStatePool* state_pool,
+                  int level,
+                  int mem_level,
+                  int strategy)
+      : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_ZLIB),
+        state_pool_(state_pool),
+        level_(level),
+        mem_level_(mem_level),
+        strategy_(strategy) {
+    MakeWeak();
+  }
+
+  ~ParallelDeflate() override {
+    CHECK_EQ(pending_blocks_, 0);
+  }
+
+  // new ParallelDeflate(statePool, level, memLevel, strategy, onblock)
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args.IsConstructCall());
+    CHECK(args[0]->IsObject());
+    CHECK(args[1]->IsInt32());
+    CHECK(args[2]->IsInt32());
+    CHECK(args[3]->IsInt32());
+    CHECK(args[4]->IsFunction());
+    ZlibStatePool* state_pool;
+    ASSIGN_OR_RETURN_UNWRAP(&state_pool, args[0].As<Object>());
+    ParallelDeflate* wrap = new ParallelDeflate(
+        env, args.This(), state_pool, args[1].As<Int32>()->Value(),
+        args[2].As<Int32>()->Value(), args[3].As<Int32>()->Value());
+    wrap->onblock_.Reset(env->isolate(), args[4].As<Function>());
+  }
+
+  // compress(id, input, dictionary, last) calls onblock(id, err, output, crc)
+  // once the block is done.
+  static void Compress(const FunctionCallbackInfo<Value>& args) {
+    ParallelDeflate* wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+    CHECK(args[0]->IsUint32());
+    CHECK(args[1]->IsArrayBufferView());
+    CHECK(args[2]->IsUndefined() || args[2]->IsArrayBufferView());
+    CHECK(args[3]->IsBoolean());
+
+    int err;
+    std::unique_ptr<z_stream> strm = wrap->state_pool_->Acquire(
+        true, wrap->level_, -Z_MAX_WINDOWBITS, wrap->mem_level_,
+        wrap->strategy_, &err);
+    if (err != Z_OK) {
+      deflateEnd(strm.get());
+      return args.GetReturnValue().Set(err);
+    }
+
+    ArrayBufferViewContents<unsigned char> input(args[1]);
+    ArrayBufferViewContents<unsigned char> dictionary;
+    if (!args[2]->IsUndefined())
+      dictionary.Read(args[2].As<ArrayBufferView>());
+
+    Block* block = new Block(wrap,
+                             std::move(strm),
+                             args[0].As<Uint32>()->Value(),
+                             input,
+                             dictionary,
+                             args[3]->IsTrue());
+    if (wrap->pending_blocks_++ == 0)
+      wrap->ClearWeak();
+    block->ScheduleWork();
+    args.GetReturnValue().Set(Z_OK);
+  }
+
+  static void Crc32Combine(const FunctionCallbackInfo<Value>& args) {
+    CHECK(args[0]->IsUint32());
+    CHECK(args[1]->IsUint32());
+    CHECK(args[2]->IsNumber());
+    const uLong crc = crc32_combine(
+        args[0].As<Uint32>()->Value(),
+        args[1].As<Uint32>()->Value(),
+        static_cast<z_off_t>(args[2].As<Number>()->Value()));
+    args.GetReturnValue().Set(static_cast<uint32_t>(crc));
+  }
+
+  SET_MEMORY_INFO_NAME(ParallelDeflate)
+  SET_SELF_SIZE(ParallelDeflate)
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackField("state_pool", state_pool_);
+  }
+
+ private:
+  class Block : public ThreadPoolWork {
+   public:
+    Block(ParallelDeflate* parent,
+          std::unique_ptr<z_stream> strm,
+          uint32_t id,
+          const ArrayBufferViewContents<unsigned char>& input,
+          const ArrayBufferViewContents<unsigned char>& dictionary,
+          bool last)
+        : ThreadPoolWork(parent->env(),
+                         performance::NODE_THREADPOOL_WORK_KIND_ZLIB),
+          parent_(parent),
+          strm_(std::move(strm)),
+          id_(id),
+          input_(input.data(), input.data() + input.length()),
+          dictionary_(dictionary.data(),
+                      dictionary.data() + dictionary.length()),
+          last_(last) {}
+
+    void DoThreadPoolWork() override {
+      crc_ = crc32(0, input_.data(), input_.size());
+
+      if (!dictionary_.empty()) {
+        err_ = deflateSetDictionary(strm_.get(),
+                                    dictionary_.data(),
+                                    dictionary_.size());
+        if (err_ != Z_OK) return;
+      }
+
+      // The bound does not include the sync flush marker.
+      output_.resize(deflateBound(strm_.get(), input_.size()) + 16);
+      strm_->next_in = input_.data();
+      strm_->avail_in = input_.size();
+      const int flush = last_ ? Z_FINISH : Z_SYNC_FLUSH;
+      for (;;) {
+        const size_t written = strm_->total_out;
+        strm_->next_out = output_.data() + written;
+        strm_->avail_out = output_.size() - written;
+        err_ = deflate(strm_.get(), flush);
+        if (err_ == Z_STREAM_ERROR) return;
+        if (err_ == Z_STREAM_END || strm_->avail_out != 0) break;
+        output_.resize(output_.size() * 2);
+      }
+      output_.resize(strm_->total_out);
+      err_ = Z_OK;
+    }
+
+    void AfterThreadPoolWork(int status) override {
+      std::unique_ptr<Block> self(this);
+      ParallelDeflate* parent = parent_;
+      parent->state_pool_->Release(std::move(strm_), true, parent->level_,
+                                   -Z_MAX_WINDOWBITS, parent->mem_level_,
+                                   parent->strategy_, err_ == Z_OK);
+      auto on_scope_leave = OnScopeLeave([&]() {
+        if (--parent->pending_blocks_ == 0)
+          parent->MakeWeak();
+      });
+
+      if (status == UV_ECANCELED)
+        return;
+      CHECK_EQ(status, 0);
+
+      Environment* env = parent->env();
+      HandleScope handle_scope(env->isolate());
+      Context::Scope context_scope(env->context());
+
+      Local<Value> output = Undefined(env->isolate());
+      if (err_ == Z_OK &&
+          !Buffer::Copy(env,
+                        reinterpret_cast<char*>(output_.data()),
+                        output_.size()).ToLocal(&output)) {
+        return;
+      }
+      Local<Value> argv[] = {
+        Integer::NewFromUnsigned(env->isolate(), id_),
+        Integer::New(env->isolate(), err_),
+        output,
+        Integer::NewFromUnsigned(env->isolate(), crc_)
+      };
+      parent->MakeCallback(PersistentToLocal::Default(env->isolate(),
+                                                      parent->onblock_),
+                           arraysize(argv), argv);
+    }
+
+   private:
+    ParallelDeflate* const parent_;
+    std::unique_ptr<z_stream> strm_;
+    const uint32_t id_;
+    std::vector<unsigned char> input_;
+    const std::vector<unsigned char> dictionary_;
+    const bool last_;
+    std::vector<unsigned char> output_;
+    uint32_t crc_ = 0;
+    int err_ = Z_OK;
+  };
+
+  BaseObjectPtr<ZlibStatePool> state_pool_;
+  const int level_;
+  const int mem_level_;
+  const int strategy_;
+  Global<Function> onblock_;
+  size_t pending_blocks_ = 0;
+};
+
 template <typename Stream>
 struct MakeClass {
   static void Make(Environment* env, Local<Object> target, const char* name) {
@@ -1226,6 +1914,7 @@ struct MakeClass {
     env->SetProtoMethod(z, "init", Stream::Init);
     env->SetProtoMethod(z, "params", Stream::Params);
     env->SetProtoMethod(z, "reset", Stream::Reset);
+    env->SetProtoMethod(z, "startPipe", Stream::StartPipe);
 
     Local<String> zlibString = OneByteString(env->isolate(), name);
     z->SetClassName(zlibString);
@@ -1245,6 +1934,28 @@ void Initialize(Local<Object> target,
   MakeClass<BrotliEncoderStream>::Make(env, target, "BrotliEncoder");
   MakeClass<BrotliDecoderStream>::Make(env, target, "BrotliDecoder");
 
+  Local<FunctionTemplate> parallel =
+      env->NewFunctionTemplate(ParallelDeflate::New);
+  parallel->InstanceTemplate()->SetInternalFieldCount(1);
+  parallel->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  env->SetProtoMethod(parallel, "compress", ParallelDeflate::Compress);
+  Local<String> parallel_string =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "ParallelDeflate");
+  parallel->SetClassName(parallel_string);
+  target->Set(env->context(),
+              parallel_string,
+              parallel->GetFunction(env->context()).ToLocalChecked()).Check();
+  env->SetMethod(target, "crc32Combine", ParallelDeflate::Crc32Combine);
+
+  Local<FunctionTemplate> pool = env->NewFunctionTemplate(ZlibStatePool::New);
+  pool->InstanceTemplate()->SetInternalFieldCount(1);
+  Local<String> pool_string =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "StatePool");
+  pool->SetClassName(pool_string);
+  target->Set(env->context(),
+              pool_string,
+              pool->GetFunction(env->context()).ToLocalChecked()).Check();
+
   target->Set(env->context(),
               FIXED_ONE_BYTE_STRING(env->isolate(), "ZLIB_VERSION"),
               FIXED_ONE_BYTE_STRING(env->isolate(), ZLIB_VERSION)).Check();
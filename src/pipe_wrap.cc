@@ -27,6 +27,7 @@
 #include "handle_wrap.h"
 #include "node.h"
 #include "node_buffer.h"
+#include "node_errors.h"
 #include "connect_wrap.h"
 #include "stream_base-inl.h"
 #include "stream_wrap.h"
@@ -34,19 +35,36 @@
 
 namespace node {
 
+using v8::Array;
+using v8::ArrayBuffer;
 using v8::Context;
+using v8::DataView;
 using v8::EscapableHandleScope;
+using v8::Float32Array;
+using v8::Float64Array;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
+using v8::Int16Array;
 using v8::Int32;
+using v8::Int32Array;
+using v8::Int8Array;
 using v8::Isolate;
+using v8::JSON;
 using v8::Local;
 using v8::MaybeLocal;
+using v8::Message;
+using v8::NewStringType;
 using v8::Object;
 using v8::String;
+using v8::TryCatch;
+using v8::Uint16Array;
+using v8::Uint32Array;
+using v8::Uint8Array;
+using v8::Uint8ClampedArray;
 using v8::Value;
+using v8::ValueDeserializer;
 
 MaybeLocal<Object> PipeWrap::Instantiate(Environment* env,
                                          AsyncWrap* parent,
@@ -82,6 +100,7 @@ void PipeWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "listen", Listen);
   env->SetProtoMethod(t, "connect", Connect);
   env->SetProtoMethod(t, "open", Open);
+  env->SetProtoMethod(t, "readMessages", ReadMessages);
 
 #ifdef _WIN32
   env->SetProtoMethod(t, "setPendingInstances", SetPendingInstances);
@@ -109,6 +128,8 @@ void PipeWrap::Initialize(Local<Object> target,
   NODE_DEFINE_CONSTANT(constants, SOCKET);
   NODE_DEFINE_CONSTANT(constants, SERVER);
   NODE_DEFINE_CONSTANT(constants, IPC);
+  NODE_DEFINE_CONSTANT(constants, MESSAGES_JSON);
+  NODE_DEFINE_CONSTANT(constants, MESSAGES_ADVANCED);
   NODE_DEFINE_CONSTANT(constants, UV_READABLE);
   NODE_DEFINE_CONSTANT(constants, UV_WRITABLE);
   target->Set(context,
@@ -223,6 +244,284 @@ void PipeWrap::Open(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// Makes the IPC channel pass messages to `onread` instead of raw data.
+void PipeWrap::ReadMessages(const FunctionCallbackInfo<Value>& args) {
+  PipeWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  CHECK(wrap->is_named_pipe_ipc());
+  CHECK(args[0]->IsInt32());
+  CHECK_NULL(wrap->message_listener_);
+
+  MessageFormat format =
+      static_cast<MessageFormat>(args[0].As<Int32>()->Value());
+  CHECK(format == MESSAGES_JSON || format == MESSAGES_ADVANCED);
+  wrap->message_listener_ = std::make_unique<MessageListener>(format);
+  wrap->PushStreamListener(wrap->message_listener_.get());
+}
+
+
+namespace {
+
+// Reads the host objects that ChildProcessSerializer in
+// lib/internal/child_process/serialization.js writes: ArrayBufferViews in the
+// format of v8.DefaultSerializer, and other host objects as plain objects.
+class MessageDeserializerDelegate : public ValueDeserializer::Delegate {
+ public:
+  explicit MessageDeserializerDelegate(Environment* env) : env_(env) {}
+
+  MaybeLocal<Object> ReadHostObject(Isolate* isolate) override;
+
+  ValueDeserializer* deserializer = nullptr;
+
+ private:
+  // The order of `arrayBufferViewTypes` in lib/v8.js.
+  enum ArrayBufferViewType {
+    kInt8Array,
+    kUint8Array,
+    kUint8ClampedArray,
+    kInt16Array,
+    kUint16Array,
+    kInt32Array,
+    kUint32Array,
+    kFloat32Array,
+    kFloat64Array,
+    kDataView,
+    kBuffer
+  };
+  static constexpr uint32_t kArrayBufferViewTag = 0;
+  static constexpr uint32_t kNotArrayBufferViewTag = 1;
+
+  MaybeLocal<Object> ReadArrayBufferView(Isolate* isolate);
+
+  Environment* env_;
+};
+
+MaybeLocal<Object> MessageDeserializerDelegate::ReadHostObject(
+    Isolate* isolate) {
+  uint32_t tag;
+  if (!deserializer->ReadUint32(&tag))
+    return ValueDeserializer::Delegate::ReadHostObject(isolate);
+
+  if (tag == kArrayBufferViewTag)
+    return ReadArrayBufferView(isolate);
+
+  Local<Value> value;
+  if (tag != kNotArrayBufferViewTag ||
+      !deserializer->ReadValue(env_->context()).ToLocal(&value)) {
+    return ValueDeserializer::Delegate::ReadHostObject(isolate);
+  }
+  if (!value->IsObject())
+    return ValueDeserializer::Delegate::ReadHostObject(isolate);
+  return value.As<Object>();
+}
+
+MaybeLocal<Object> MessageDeserializerDelegate::ReadArrayBufferView(
+    Isolate* isolate) {
+  uint32_t type;
+  uint32_t byte_length;
+  const void* data;
+  if (!deserializer->ReadUint32(&type) ||
+      !deserializer->ReadUint32(&byte_length) ||
+      !deserializer->ReadRawBytes(byte_length, &data)) {
+    return ValueDeserializer::Delegate::ReadHostObject(isolate);
+  }
+
+  if (type == kBuffer) {
+    Local<Object> buffer;
+    if (!Buffer::Copy(env_, static_cast<const char*>(data), byte_length)
+             .ToLocal(&buffer)) {
+      return MaybeLocal<Object>();
+    }
+    return buffer;
+  }
+
+  // The data is copied, so that it is aligned for every type of view.
+  Local<ArrayBuffer> ab = ArrayBuffer::New(isolate, byte_length);
+  if (byte_length > 0)
+    memcpy(ab->GetBackingStore()->Data(), data, byte_length);
+  switch (type) {
+    case kInt8Array:
+      return Int8Array::New(ab, 0, byte_length);
+    case kUint8Array:
+      return Uint8Array::New(ab, 0, byte_length);
+    case kUint8ClampedArray:
+      return Uint8ClampedArray::New(ab, 0, byte_length);
+    case kInt16Array:
+      return Int16Array::New(ab, 0, byte_length / 2);
+    case kUint16Array:
+      return Uint16Array::New(ab, 0, byte_length / 2);
+    case kInt32Array:
+      return Int32Array::New(ab, 0, byte_length / 4);
+    case kUint32Array:
+      return Uint32Array::New(ab, 0, byte_length / 4);
+    case kFloat32Array:
+      return Float32Array::New(ab, 0, byte_length / 4);
+    case kFloat64Array:
+      return Float64Array::New(ab, 0, byte_length / 8);
+    case kDataView:
+      return DataView::New(ab, 0, byte_length);
+    default:
+      return ValueDeserializer::Delegate::ReadHostObject(isolate);
+  }
+}
+
+}  // anonymous namespace
+
+
+uv_buf_t PipeWrap::MessageListener::OnStreamAlloc(size_t suggested_size) {
+  CHECK_NOT_NULL(previous_listener_);
+  return previous_listener_->OnStreamAlloc(suggested_size);
+}
+
+
+void PipeWrap::MessageListener::OnStreamRead(ssize_t nread,
+                                             const uv_buf_t& buf_) {
+  CHECK_NOT_NULL(stream_);
+  StreamBase* stream = static_cast<StreamBase*>(stream_);
+  Environment* env = stream->stream_env();
+
+  if (nread < 0) {
+    CHECK_NOT_NULL(previous_listener_);
+    previous_listener_->OnStreamRead(nread, buf_);
+    return;
+  }
+
+  // The buffer comes from the previous listener's OnStreamAlloc(), which
+  // either lends out the shared read buffer or allocates a new one.
+  AllocatedBuffer buf(env);
+  if (buf_.base != nullptr && buf_.base == env->stream_read_buffer())
+    env->set_stream_read_buffer_in_use(false);
+  else
+    buf = AllocatedBuffer(env, buf_);
+  if (nread == 0)
+    return;
+
+  // Complete messages are parsed from the read buffer directly; only the
+  // start of an incomplete message is kept around.
+  const char* data = buf_.base;
+  size_t length = nread;
+  if (!incomplete_.empty()) {
+    incomplete_.insert(incomplete_.end(), buf_.base, buf_.base + nread);
+    data = incomplete_.data();
+    length = incomplete_.size();
+  }
+
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  std::vector<Local<Value>> messages;
+  ssize_t consumed;
+  Local<Value> exception;
+  Local<Message> exception_message;
+  {
+    TryCatch try_catch(env->isolate());
+    consumed = ParseMessages(env, data, length, &messages);
+    if (consumed < 0) {
+      consumed = -consumed;
+      exception = try_catch.Exception();
+      exception_message = try_catch.Message();
+    }
+  }
+  CHECK_LE(static_cast<size_t>(consumed), length);
+
+  if (data == incomplete_.data()) {
+    incomplete_.erase(incomplete_.begin(), incomplete_.begin() + consumed);
+  } else {
+    incomplete_.assign(data + consumed, data + length);
+  }
+
+  Local<Array> array =
+      Array::New(env->isolate(), messages.data(), messages.size());
+  if (stream->CallJSOnreadMethodWithValue(incomplete_.size(), array)
+          .IsEmpty()) {
+    return;
+  }
+
+  // Parsing errors are reported in the same way as exceptions thrown from
+  // `onread`.
+  if (!exception.IsEmpty()) {
+    errors::TriggerUncaughtException(
+        env->isolate(), exception, exception_message);
+  }
+}
+
+
+ssize_t PipeWrap::MessageListener::ParseMessages(
+    Environment* env,
+    const char* data,
+    size_t length,
+    std::vector<Local<Value>>* messages) {
+  size_t offset = 0;
+  while (offset < length) {
+    const char* start = data + offset;
+    size_t size;
+    size_t framed_size;
+    if (format_ == MESSAGES_JSON) {
+      // Newline-delimited JSON.
+      const char* end =
+          static_cast<const char*>(memchr(start, '\n', length - offset));
+      if (end == nullptr)
+        break;
+      size = end - start;
+      framed_size = size + 1;
+    } else {
+      // V8-serialized values, prefixed with their size as a big endian
+      // uint32.
+      if (length - offset <= 4)
+        break;
+      const uint8_t* prefix = reinterpret_cast<const uint8_t*>(start);
+      size = (static_cast<uint32_t>(prefix[0]) << 24) |
+             (static_cast<uint32_t>(prefix[1]) << 16) |
+             (static_cast<uint32_t>(prefix[2]) << 8) |
+             static_cast<uint32_t>(prefix[3]);
+      if (length - offset - 4 < size)
+        break;
+      start += 4;
+      framed_size = size + 4;
+    }
+    offset += framed_size;
+
+    MaybeLocal<Value> message = format_ == MESSAGES_JSON ?
+        ParseJSON(env, start, size) : Deserialize(env, start, size);
+    Local<Value> value;
+    if (!message.ToLocal(&value))
+      return -static_cast<ssize_t>(offset);
+    messages->push_back(value);
+  }
+  return offset;
+}
+
+
+MaybeLocal<Value> PipeWrap::MessageListener::ParseJSON(Environment* env,
+                                                       const char* data,
+                                                       size_t length) {
+  // Lines are split at a byte that never occurs inside a multi-byte UTF-8
+  // sequence, so every line can be decoded on its own.
+  Local<String> string;
+  if (!String::NewFromUtf8(env->isolate(),
+                           data,
+                           NewStringType::kNormal,
+                           length).ToLocal(&string)) {
+    return MaybeLocal<Value>();
+  }
+  return JSON::Parse(env->context(), string);
+}
+
+
+MaybeLocal<Value> PipeWrap::MessageListener::Deserialize(Environment* env,
+                                                         const char* data,
+                                                         size_t length) {
+  MessageDeserializerDelegate delegate(env);
+  ValueDeserializer deserializer(env->isolate(),
+                                 reinterpret_cast<const uint8_t*>(data),
+                                 length,
+                                 &delegate);
+  delegate.deserializer = &deserializer;
+  if (deserializer.ReadHeader(env->context()).IsNothing())
+    return MaybeLocal<Value>();
+  return deserializer.ReadValue(env->context());
+}
+
+
 void PipeWrap::Connect(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -27,6 +27,9 @@
 #include "async_wrap.h"
 #include "connection_wrap.h"
 
+#include <memory>
+#include <vector>
+
 namespace node {
 
 class Environment;
@@ -39,6 +42,13 @@ class PipeWrap : public ConnectionWrap<PipeWrap, uv_pipe_t> {
     IPC
   };
 
+  // The formats of the messages on an IPC channel, see
+  // lib/internal/child_process/serialization.js.
+  enum MessageFormat {
+    MESSAGES_JSON,
+    MESSAGES_ADVANCED
+  };
+
   static v8::MaybeLocal<v8::Object> Instantiate(Environment* env,
                                                 AsyncWrap* parent,
                                                 SocketType type);
@@ -62,12 +72,45 @@ class PipeWrap : public ConnectionWrap<PipeWrap, uv_pipe_t> {
   static void Listen(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Connect(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Open(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void ReadMessages(const v8::FunctionCallbackInfo<v8::Value>& args);
 
 #ifdef _WIN32
   static void SetPendingInstances(
       const v8::FunctionCallbackInfo<v8::Value>& args);
 #endif
   static void Fchmod(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  // Splits the data that is read from an IPC channel into messages, and
+  // passes every batch of complete messages to `onread` as an array.
+  // The number of bytes of incomplete messages is passed as the read size.
+  class MessageListener : public StreamListener {
+   public:
+    explicit MessageListener(MessageFormat format) : format_(format) {}
+
+    uv_buf_t OnStreamAlloc(size_t suggested_size) override;
+    void OnStreamRead(ssize_t nread, const uv_buf_t& buf) override;
+
+   private:
+    // Parses the complete messages in `data` into `messages`, and returns
+    // the number of bytes that were consumed. Returns a negative number if a
+    // message could not be parsed; in that case, an exception is pending.
+    ssize_t ParseMessages(Environment* env,
+                          const char* data,
+                          size_t length,
+                          std::vector<v8::Local<v8::Value>>* messages);
+    v8::MaybeLocal<v8::Value> ParseJSON(Environment* env,
+                                        const char* data,
+                                        size_t length);
+    v8::MaybeLocal<v8::Value> Deserialize(Environment* env,
+                                          const char* data,
+                                          size_t length);
+
+    MessageFormat format_;
+    // The start of a message that has not been read completely.
+    std::vector<char> incomplete_;
+  };
+
+  std::unique_ptr<MessageListener> message_listener_;
 };
 
 
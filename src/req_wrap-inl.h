@@ -18,7 +18,7 @@ template <typename T>
 ReqWrap<T>::ReqWrap(Environment* env,
                     v8::Local<v8::Object> object,
                     AsyncWrap::ProviderType provider)
-    : AsyncWrap(env, object, provider),
+    : AsyncWrap(env, object, provider, NoCleanupHook()),
       ReqWrapBase(env) {
   Reset();
 }
@@ -6,6 +6,7 @@
 #include "stream_base.h"
 
 #include "node.h"
+#include "node_dtrace.h"
 #include "env-inl.h"
 #include "v8.h"
 
@@ -116,6 +117,7 @@ inline uv_buf_t StreamResource::EmitAlloc(size_t suggested_size) {
 
 inline void StreamResource::EmitRead(ssize_t nread, const uv_buf_t& buf) {
   DebugSealHandleScope handle_scope(v8::Isolate::GetCurrent());
+  NODE_USDT_PROBE(STREAM_READ, this, static_cast<int64_t>(nread));
   if (nread > 0)
     bytes_read_ += static_cast<uint64_t>(nread);
   listener_->OnStreamRead(nread, buf);
@@ -189,6 +191,7 @@ inline StreamWriteResult StreamBase::Write(
   for (size_t i = 0; i < count; ++i)
     total_bytes += bufs[i].len;
   bytes_written_ += total_bytes;
+  NODE_USDT_PROBE(STREAM_WRITE, this, static_cast<int64_t>(total_bytes));
 
   if (send_handle == nullptr) {
     err = DoTryWrite(&bufs, &count);
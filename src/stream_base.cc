@@ -12,6 +12,7 @@
 #include "v8.h"
 
 #include <climits>  // INT_MAX
+#include <vector>
 
 namespace node {
 
@@ -25,6 +26,7 @@ using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::HandleScope;
 using v8::Integer;
+using v8::Isolate;
 using v8::Local;
 using v8::MaybeLocal;
 using v8::Object;
@@ -59,6 +61,20 @@ int StreamBase::UseUserBuffer(const FunctionCallbackInfo<Value>& args) {
   return 0;
 }
 
+int StreamBase::UseLineSplitter(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsUint32());
+  const uint32_t delimiter = args[0].As<v8::Uint32>()->Value();
+  CHECK_LE(delimiter, 0xff);
+  const enum encoding encoding =
+      ParseEncoding(env_->isolate(), args[1], BUFFER);
+  CHECK(args[2]->IsUint32());
+  const uint32_t max_line_length = args[2].As<v8::Uint32>()->Value();
+
+  PushStreamListener(new LineSplitterJSListener(
+      static_cast<char>(delimiter), encoding, max_line_length));
+  return 0;
+}
+
 int StreamBase::Shutdown(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsObject());
   Local<Object> req_wrap_obj = args[0].As<Object>();
@@ -71,6 +87,25 @@ void StreamBase::SetWriteResult(const StreamWriteResult& res) {
   env_->stream_base_state()[kLastWriteWasAsync] = res.async;
 }
 
+// Returns the contents of |string| if they can be written as they are for
+// |encoding|, without copying them into the write storage first. This is
+// the case for one-byte external strings written as latin1 or ascii, the
+// contents of which do not move and which JS keeps alive through
+// `req._chunks` until the write has finished.
+static inline bool GetDirectStringData(Local<String> string,
+                                       enum encoding encoding,
+                                       uv_buf_t* buf) {
+  if ((encoding != LATIN1 && encoding != ASCII) ||
+      !string->IsExternalOneByte()) {
+    return false;
+  }
+  const String::ExternalOneByteStringResource* resource =
+      string->GetExternalOneByteStringResource();
+  *buf = uv_buf_init(const_cast<char*>(resource->data()), resource->length());
+  return true;
+}
+
+
 int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -87,7 +122,7 @@ int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
   else
     count = chunks->Length() >> 1;
 
-  MaybeStackBuffer<uv_buf_t, 16> bufs(count);
+  MaybeStackBuffer<uv_buf_t, 16> bufs(env->scratch_arena(), count);
 
   size_t storage_size = 0;
   size_t offset;
@@ -105,6 +140,9 @@ int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
       Local<String> string = chunk->ToString(env->context()).ToLocalChecked();
       enum encoding encoding = ParseEncoding(env->isolate(),
           chunks->Get(env->context(), i * 2 + 1).ToLocalChecked());
+      uv_buf_t direct;
+      if (GetDirectStringData(string, encoding, &direct))
+        continue;
       size_t chunk_size;
       if (encoding == UTF8 && string->Length() > 65535 &&
           !StringBytes::Size(env->isolate(), string, encoding).To(&chunk_size))
@@ -125,9 +163,17 @@ int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
     }
   }
 
+  // Like WriteString(), small writes are encoded into stack storage first and
+  // only copied to the heap if they cannot be written synchronously.
+  char stack_storage[16384];  // 16kb
+  const bool try_write = storage_size <= sizeof(stack_storage);
+
   AllocatedBuffer storage;
-  if (storage_size > 0)
+  char* storage_data = stack_storage;
+  if (!try_write) {
     storage = env->AllocateManaged(storage_size);
+    storage_data = storage.data();
+  }
 
   offset = 0;
   if (!all_buffers) {
@@ -141,14 +187,17 @@ int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
         continue;
       }
 
-      // Write string
-      CHECK_LE(offset, storage_size);
-      char* str_storage = storage.data() + offset;
-      size_t str_size = storage.size() - offset;
-
       Local<String> string = chunk->ToString(env->context()).ToLocalChecked();
       enum encoding encoding = ParseEncoding(env->isolate(),
           chunks->Get(env->context(), i * 2 + 1).ToLocalChecked());
+      if (GetDirectStringData(string, encoding, &bufs[i]))
+        continue;
+
+      // Write string
+      CHECK_LE(offset, storage_size);
+      char* str_storage = storage_data + offset;
+      size_t str_size = storage_size - offset;
+
       str_size = StringBytes::Write(env->isolate(),
                                     str_storage,
                                     str_size,
@@ -160,9 +209,59 @@ int StreamBase::Writev(const FunctionCallbackInfo<Value>& args) {
     }
   }
 
-  StreamWriteResult res = Write(*bufs, count, nullptr, req_wrap_obj);
+  uv_buf_t* remaining = *bufs;
+  size_t remaining_count = count;
+  size_t synchronously_written = 0;
+
+  if (try_write) {
+    size_t total_bytes = 0;
+    for (size_t i = 0; i < count; i++)
+      total_bytes += bufs[i].len;
+
+    const int err = DoTryWrite(&remaining, &remaining_count);
+    size_t left = 0;
+    for (size_t i = 0; i < remaining_count; i++)
+      left += remaining[i].len;
+    // Keep track of the bytes written here, because we're taking a shortcut
+    // by using `DoTryWrite()` directly instead of using the utilities
+    // provided by `Write()`.
+    synchronously_written = total_bytes - left;
+    bytes_written_ += synchronously_written;
+
+    // Immediate failure or success
+    if (err != 0 || remaining_count == 0) {
+      SetWriteResult(StreamWriteResult { false, err, nullptr, total_bytes });
+      return err;
+    }
+
+    // Partial write. Whatever is left of the stack storage has to outlive
+    // this call, Buffers and external strings are retained by JS.
+    size_t left_in_storage = 0;
+    for (size_t i = 0; i < remaining_count; i++) {
+      if (remaining[i].base >= stack_storage &&
+          remaining[i].base < stack_storage + sizeof(stack_storage)) {
+        left_in_storage += remaining[i].len;
+      }
+    }
+    if (left_in_storage > 0) {
+      storage = env->AllocateManaged(left_in_storage);
+      offset = 0;
+      for (size_t i = 0; i < remaining_count; i++) {
+        if (remaining[i].base >= stack_storage &&
+            remaining[i].base < stack_storage + sizeof(stack_storage)) {
+          memcpy(storage.data() + offset, remaining[i].base, remaining[i].len);
+          remaining[i].base = storage.data() + offset;
+          offset += remaining[i].len;
+        }
+      }
+    }
+  }
+
+  StreamWriteResult res =
+      Write(remaining, remaining_count, nullptr, req_wrap_obj);
+  res.bytes += synchronously_written;
   SetWriteResult(res);
-  if (res.wrap != nullptr && storage_size > 0) {
+  if (res.wrap != nullptr && storage.size() > 0) {
     res.wrap->SetAllocatedStorage(std::move(storage));
   }
   return res.err;
@@ -331,12 +430,21 @@ MaybeLocal<Value> StreamBase::CallJSOnreadMethod(ssize_t nread,
     }
   }
 
-  env->stream_base_state()[kReadBytesOrError] = nread;
   env->stream_base_state()[kArrayBufferOffset] = offset;
+  return CallJSOnreadMethodWithValue(
+      nread,
+      ab.IsEmpty() ? Undefined(env->isolate()).As<Value>() : ab.As<Value>());
+}
 
-  Local<Value> argv[] = {
-    ab.IsEmpty() ? Undefined(env->isolate()).As<Value>() : ab.As<Value>()
-  };
+
+MaybeLocal<Value> StreamBase::CallJSOnreadMethodWithValue(ssize_t nread,
+                                                          Local<Value> value) {
+  Environment* env = env_;
+
+  DCHECK_EQ(static_cast<int32_t>(nread), nread);
+  env->stream_base_state()[kReadBytesOrError] = nread;
+
+  Local<Value> argv[] = { value };
 
   AsyncWrap* wrap = GetAsyncWrap();
   CHECK_NOT_NULL(wrap);
@@ -394,6 +502,9 @@ void StreamBase::AddMethods(Environment* env, Local<FunctionTemplate> t) {
   env->SetProtoMethod(t,
                       "useUserBuffer",
                       JSMethod<&StreamBase::UseUserBuffer>);
+  env->SetProtoMethod(t,
+                      "useLineSplitter",
+                      JSMethod<&StreamBase::UseLineSplitter>);
   env->SetProtoMethod(t, "writev", JSMethod<&StreamBase::Writev>);
   env->SetProtoMethod(t, "writeBuffer", JSMethod<&StreamBase::WriteBuffer>);
   env->SetProtoMethod(
@@ -474,10 +585,30 @@ void StreamResource::ClearError() {
 }
 
 
+// Most reads are much smaller than the suggested size, so listeners read into
+// the Environment's stream read buffer and decide in OnStreamRead() whether to
+// copy the data out. The buffer is only used by one read at a time; it may
+// be taken when reads are nested, or when the stream reads asynchronously.
+static uv_buf_t AllocateStreamReadBuffer(Environment* env,
+                                         size_t suggested_size) {
+  if (suggested_size <= Environment::kStreamReadBufferSize &&
+      !env->stream_read_buffer_in_use()) {
+    if (env->stream_read_buffer() == nullptr) {
+      env->set_stream_read_buffer(
+          env->AllocateUnchecked(Environment::kStreamReadBufferSize));
+    }
+    if (env->stream_read_buffer() != nullptr) {
+      env->set_stream_read_buffer_in_use(true);
+      return uv_buf_init(env->stream_read_buffer(), suggested_size);
+    }
+  }
+  return env->AllocateManaged(suggested_size).release();
+}
+
 uv_buf_t EmitToJSStreamListener::OnStreamAlloc(size_t suggested_size) {
   CHECK_NOT_NULL(stream_);
   Environment* env = static_cast<StreamBase*>(stream_)->stream_env();
-  return env->AllocateManaged(suggested_size).release();
+  return AllocateStreamReadBuffer(env, suggested_size);
 }
 
 void EmitToJSStreamListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf_) {
@@ -486,7 +617,13 @@ void EmitToJSStreamListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf_) {
   Environment* env = stream->stream_env();
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
-  AllocatedBuffer buf(env, buf_);
+  AllocatedBuffer buf(env);
+  const bool from_read_buffer =
+      buf_.base != nullptr && buf_.base == env->stream_read_buffer();
+  if (from_read_buffer)
+    env->set_stream_read_buffer_in_use(false);
+  else
+    buf = AllocatedBuffer(env, buf_);
 
   if (nread <= 0)  {
     if (nread < 0)
@@ -494,8 +631,23 @@ void EmitToJSStreamListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf_) {
     return;
   }
 
-  CHECK_LE(static_cast<size_t>(nread), buf.size());
-  buf.Resize(nread);
+  CHECK_LE(static_cast<size_t>(nread), buf_.len);
+  if (!from_read_buffer) {
+    buf.Resize(nread);
+  } else if (static_cast<size_t>(nread) <=
+                 Environment::kStreamReadBufferSize / 2) {
+    // Copy small reads into a Buffer of their own size, so that the read
+    // buffer can be used for the next read.
+    buf = env->AllocateManaged(nread);
+    memcpy(buf.data(), buf_.base, nread);
+  } else {
+    // Large reads take the read buffer with them, which saves the copy;
+    // the next read allocates a new one.
+    buf = AllocatedBuffer(
+        env, uv_buf_init(buf_.base, Environment::kStreamReadBufferSize));
+    env->set_stream_read_buffer(nullptr);
+    buf.Resize(nread);
+  }
 
   stream->CallJSOnreadMethod(nread, buf.ToArrayBuffer());
 }
@@ -527,6 +679,130 @@ void CustomBufferJSListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf) {
 }
 
 
+uv_buf_t LineSplitterJSListener::OnStreamAlloc(size_t suggested_size) {
+  CHECK_NOT_NULL(stream_);
+  Environment* env = static_cast<StreamBase*>(stream_)->stream_env();
+  return AllocateStreamReadBuffer(env, suggested_size);
+}
+
+
+void LineSplitterJSListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf_) {
+  CHECK_NOT_NULL(stream_);
+  StreamBase* stream = static_cast<StreamBase*>(stream_);
+  Environment* env = stream->stream_env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  // All data is copied out before JS land is called, so the stream read
+  // buffer can be handed back right away.
+  AllocatedBuffer buf(env);
+  if (buf_.base != nullptr && buf_.base == env->stream_read_buffer())
+    env->set_stream_read_buffer_in_use(false);
+  else
+    buf = AllocatedBuffer(env, buf_);
+
+  if (nread == 0)
+    return;
+
+  if (nread < 0) {
+    if (nread == UV_EOF && !pending_.empty()) {
+      std::string last;
+      last.swap(pending_);
+      last += delimiter_;
+      if (EmitLines(last.data(), last.size()).IsEmpty())
+        return;
+      // The stream may have been destroyed from JS land.
+      if (!stream->IsAlive())
+        return;
+    }
+    stream->CallJSOnreadMethod(nread, Local<ArrayBuffer>());
+    return;
+  }
+
+  CHECK_LE(static_cast<size_t>(nread), buf_.len);
+  EmitLines(buf_.base, nread);
+}
+
+
+MaybeLocal<Value> LineSplitterJSListener::EmitLines(const char* data,
+                                                    size_t length) {
+  StreamBase* stream = static_cast<StreamBase*>(stream_);
+  Environment* env = stream->stream_env();
+  Isolate* isolate = env->isolate();
+
+  // Offsets of the delimiters, relative to the start of |pending_|.
+  std::vector<size_t> ends;
+  size_t line_start = 0;
+  for (const char* p = data;
+       (p = static_cast<const char*>(memchr(p, delimiter_, data + length - p)));
+       p++) {
+    const size_t end = pending_.size() + (p - data);
+    if (end - line_start > max_line_length_)
+      break;
+    ends.push_back(end);
+    line_start = end + 1;
+  }
+  // Everything from |line_start| on is either a line that is too long or
+  // the incomplete last line, which must not grow |pending_| past the limit.
+  if (pending_.size() + length - line_start > max_line_length_) {
+    pending_.clear();
+    stream->CallJSOnreadMethod(UV_ENOBUFS, Local<ArrayBuffer>());
+    return MaybeLocal<Value>();
+  }
+
+  std::vector<Local<Value>> lines;
+  lines.reserve(ends.size());
+  size_t consumed = 0;
+  if (!ends.empty()) {
+    consumed = ends.back() + 1 - pending_.size();
+    if (encoding_ == BUFFER) {
+      // All lines of one read share a single backing store.
+      AllocatedBuffer store = env->AllocateManaged(pending_.size() + consumed);
+      memcpy(store.data(), pending_.data(), pending_.size());
+      memcpy(store.data() + pending_.size(), data, consumed);
+      Local<ArrayBuffer> ab = store.ToArrayBuffer();
+      size_t start = 0;
+      for (size_t end : ends) {
+        Local<v8::Uint8Array> line;
+        if (!Buffer::New(env, ab, start, end - start).ToLocal(&line))
+          return MaybeLocal<Value>();
+        lines.push_back(line);
+        start = end + 1;
+      }
+    } else {
+      const size_t carried = pending_.size();
+      size_t start = 0;
+      for (size_t end : ends) {
+        Local<Value> error;
+        MaybeLocal<Value> line;
+        if (start == 0 && carried > 0) {
+          pending_.append(data, end - carried);
+          line = StringBytes::Encode(
+              isolate, pending_.data(), pending_.size(), encoding_, &error);
+        } else {
+          line = StringBytes::Encode(
+              isolate, data + start - carried, end - start, encoding_, &error);
+        }
+        if (line.IsEmpty()) {
+          pending_.clear();
+          stream->CallJSOnreadMethod(UV_ENOBUFS, Local<ArrayBuffer>());
+          return MaybeLocal<Value>();
+        }
+        lines.push_back(line.ToLocalChecked());
+        start = end + 1;
+      }
+    }
+    pending_.clear();
+  }
+  pending_.append(data + consumed, length - consumed);
+
+  // JS land is also called for reads without complete lines, so that it can
+  // keep track of activity on the stream.
+  return stream->CallJSOnreadMethodWithValue(
+      length, Array::New(isolate, lines.data(), lines.size()));
+}
+
+
 void ReportWritesToJSStreamListener::OnStreamAfterReqFinished(
     StreamReq* req_wrap, int status) {
   StreamBase* stream = static_cast<StreamBase*>(stream_);
@@ -9,6 +9,8 @@
 
 #include "v8.h"
 
+#include <string>
+
 namespace node {
 
 // Forward declarations
@@ -195,6 +197,35 @@ class CustomBufferJSListener : public ReportWritesToJSStreamListener {
 };
 
 
+// An alternative listener that splits incoming data at a delimiter byte and
+// passes arrays of complete lines, without the delimiters, to JS land.
+// Incomplete lines are kept until the next read, or passed on as a last line
+// when the stream ends. Lines longer than |max_line_length| bytes fail the read
+// with UV_ENOBUFS instead. Lines are Buffers if |encoding| is BUFFER, and
+// strings in that encoding otherwise.
+class LineSplitterJSListener : public ReportWritesToJSStreamListener {
+ public:
+  uv_buf_t OnStreamAlloc(size_t suggested_size) override;
+  void OnStreamRead(ssize_t nread, const uv_buf_t& buf) override;
+  void OnStreamDestroy() override { delete this; }
+
+  LineSplitterJSListener(char delimiter,
+                         enum encoding encoding,
+                         size_t max_line_length)
+      : delimiter_(delimiter),
+        encoding_(encoding),
+        max_line_length_(max_line_length) {}
+
+ private:
+  v8::MaybeLocal<v8::Value> EmitLines(const char* data, size_t length);
+
+  const char delimiter_;
+  const enum encoding encoding_;
+  const size_t max_line_length_;
+  std::string pending_;
+};
+
+
 // A generic stream, comparable to JS land’s `Duplex` streams.
 // A stream is always controlled through one `StreamListener` instance.
 class StreamResource {
@@ -295,6 +326,11 @@ class StreamBase : public StreamResource {
       v8::Local<v8::ArrayBuffer> ab,
       size_t offset = 0,
       StreamBaseJSChecks checks = DONT_SKIP_NREAD_CHECKS);
+  // Passes |value| to the onread method, for listeners that process the data
+  // before it is handed to JS land.
+  v8::MaybeLocal<v8::Value> CallJSOnreadMethodWithValue(
+      ssize_t nread,
+      v8::Local<v8::Value> value);
 
   // This is named `stream_env` to avoid name clashes, because a lot of
   // subclasses are also `BaseObject`s.
@@ -343,6 +379,7 @@ class StreamBase : public StreamResource {
   template <enum encoding enc>
   int WriteString(const v8::FunctionCallbackInfo<v8::Value>& args);
   int UseUserBuffer(const v8::FunctionCallbackInfo<v8::Value>& args);
+  int UseLineSplitter(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   static void GetFD(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetExternal(const v8::FunctionCallbackInfo<v8::Value>& args);
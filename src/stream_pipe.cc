@@ -15,8 +15,10 @@ namespace node {
 
 StreamPipe::StreamPipe(StreamBase* source,
                        StreamBase* sink,
-                       Local<Object> obj)
-    : AsyncWrap(source->stream_env(), obj, AsyncWrap::PROVIDER_STREAMPIPE) {
+                       Local<Object> obj,
+                       bool end)
+    : AsyncWrap(source->stream_env(), obj, AsyncWrap::PROVIDER_STREAMPIPE),
+      end_(end) {
   MakeWeak();
 
   CHECK_NOT_NULL(sink);
@@ -25,7 +27,10 @@ StreamPipe::StreamPipe(StreamBase* source,
   source->PushStreamListener(&readable_listener_);
   sink->PushStreamListener(&writable_listener_);
 
-  CHECK(sink->HasWantsWrite());
+  // Sinks that do not ask for data themselves, such as sockets, get data as
+  // fast as they accept it.
+  if (!sink->HasWantsWrite())
+    wanted_data_ = kDefaultChunkSize;
 
   // Set up links between this object and the source/sink objects.
   // In particular, this makes sure that they are garbage collected as a group,
@@ -149,6 +154,7 @@ void StreamPipe::ProcessData(size_t nread, AllocatedBuffer&& buf) {
   } else {
     is_writing_ = true;
     is_reading_ = false;
+    current_write_ = res.wrap;
     res.wrap->SetAllocatedStorage(std::move(buf));
     if (source() != nullptr)
       source()->ReadStop();
@@ -156,12 +162,20 @@ void StreamPipe::ProcessData(size_t nread, AllocatedBuffer&& buf) {
 }
 
 void StreamPipe::ShutdownWritable() {
-  sink()->Shutdown();
+  if (end_)
+    sink()->Shutdown();
 }
 
 void StreamPipe::WritableListener::OnStreamAfterWrite(WriteWrap* w,
                                                       int status) {
   StreamPipe* pipe = ContainerOf(&StreamPipe::writable_listener_, this);
+  if (w != nullptr && w != pipe->current_write_) {
+    // This write was not made by the pipe.
+    CHECK_NOT_NULL(previous_listener_);
+    previous_listener_->OnStreamAfterWrite(w, status);
+    return;
+  }
+  pipe->current_write_ = nullptr;
   pipe->is_writing_ = false;
   if (pipe->is_eof_) {
     HandleScope handle_scope(pipe->env()->isolate());
@@ -179,6 +193,9 @@ void StreamPipe::WritableListener::OnStreamAfterWrite(WriteWrap* w,
     prev->OnStreamAfterWrite(w, status);
     return;
   }
+
+  if (w != nullptr && !pipe->sink()->HasWantsWrite())
+    pipe->writable_listener_.OnStreamWantsWrite(pipe->wanted_data_);
 }
 
 void StreamPipe::WritableListener::OnStreamAfterShutdown(ShutdownWrap* w,
@@ -234,8 +251,9 @@ void StreamPipe::New(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[1]->IsObject());
   StreamBase* source = StreamBase::FromObject(args[0].As<Object>());
   StreamBase* sink = StreamBase::FromObject(args[1].As<Object>());
+  bool end = !args[2]->IsFalse();
 
-  new StreamPipe(source, sink, args.This());
+  new StreamPipe(source, sink, args.This(), end);
 }
 
 void StreamPipe::Start(const FunctionCallbackInfo<Value>& args) {
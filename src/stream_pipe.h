@@ -9,7 +9,10 @@ namespace node {
 
 class StreamPipe : public AsyncWrap {
  public:
-  StreamPipe(StreamBase* source, StreamBase* sink, v8::Local<v8::Object> obj);
+  StreamPipe(StreamBase* source,
+             StreamBase* sink,
+             v8::Local<v8::Object> obj,
+             bool end = true);
   ~StreamPipe() override;
 
   void Unpipe(bool is_in_deletion = false);
@@ -34,12 +37,18 @@ class StreamPipe : public AsyncWrap {
   bool is_closed_ = true;
   bool sink_destroyed_ = false;
   bool source_destroyed_ = false;
+  // Whether the sink is shut down once the source has ended.
+  bool end_ = true;
+  // The write of piped data that is in progress, if any. Other writes on the
+  // sink are reported to the sink's previous listener.
+  WriteWrap* current_write_ = nullptr;
 
   // Set a default value so that when we’re coming from Start(), we know
   // that we don’t want to read just yet.
-  // This will likely need to be changed when supporting streams without
-  // `OnStreamWantsWrite()` support.
+  // Sinks without `OnStreamWantsWrite()` support start out with
+  // `kDefaultChunkSize`, and reading resumes whenever a write has finished.
   size_t wanted_data_ = 0;
+  static constexpr size_t kDefaultChunkSize = 64 * 1024;
 
   void ProcessData(size_t nread, AllocatedBuffer&& buf);
 
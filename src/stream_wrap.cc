@@ -28,11 +28,34 @@
 #include "pipe_wrap.h"
 #include "req_wrap-inl.h"
 #include "tcp_wrap.h"
+#include "threadpoolwork-inl.h"
 #include "udp_wrap.h"
 #include "util-inl.h"
 
+#include <algorithm>  // std::min()
 #include <cstring>  // memcpy()
-#include <climits>  // INT_MAX
+#include <climits>  // INT_MAX, IOV_MAX
+
+#ifdef __linux__
+#include <fcntl.h>  // fcntl()
+#include <linux/errqueue.h>  // sock_extended_err
+#include <netinet/in.h>  // IP_RECVERR, IPV6_RECVERR
+#include <sys/sendfile.h>  // sendfile()
+#include <sys/socket.h>  // send(), sendmsg(), recvmsg()
+#include <unistd.h>  // close()
+
+#include <deque>
+
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+#endif
 
 
 namespace node {
@@ -43,8 +66,11 @@ using v8::EscapableHandleScope;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
+using v8::Int32;
+using v8::Integer;
 using v8::Local;
 using v8::MaybeLocal;
+using v8::Number;
 using v8::Object;
 using v8::ReadOnly;
 using v8::Signature;
@@ -104,6 +130,17 @@ void LibuvStreamWrap::Initialize(Local<Object> target,
               ww->GetFunction(env->context()).ToLocalChecked()).Check();
   env->set_write_wrap_template(ww->InstanceTemplate());
 
+  Local<FunctionTemplate> sfw =
+      BaseObject::MakeLazilyInitializedJSTemplate(env);
+  Local<String> sendFileWrapString =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "SendFileWrap");
+  sfw->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  sfw->SetClassName(sendFileWrapString);
+  target->Set(env->context(),
+              sendFileWrapString,
+              sfw->GetFunction(env->context()).ToLocalChecked()).Check();
+  env->set_sendfile_wrap_template(sfw->InstanceTemplate());
+
   NODE_DEFINE_CONSTANT(target, kReadBytesOrError);
   NODE_DEFINE_CONSTANT(target, kArrayBufferOffset);
   NODE_DEFINE_CONSTANT(target, kBytesWritten);
@@ -127,6 +164,9 @@ LibuvStreamWrap::LibuvStreamWrap(Environment* env,
 }
 
 
+LibuvStreamWrap::~LibuvStreamWrap() {}
+
+
 Local<FunctionTemplate> LibuvStreamWrap::GetConstructorTemplate(
     Environment* env) {
   Local<FunctionTemplate> tmpl = env->libuv_stream_wrap_ctor_template();
@@ -148,6 +188,9 @@ Local<FunctionTemplate> LibuvStreamWrap::GetConstructorTemplate(
         Local<FunctionTemplate>(),
         static_cast<PropertyAttribute>(ReadOnly | DontDelete));
     env->SetProtoMethod(tmpl, "setBlocking", SetBlocking);
+#ifdef __linux__
+    env->SetProtoMethod(tmpl, "sendFile", SendFile);
+#endif
     StreamBase::AddMethods(env, tmpl);
     env->set_libuv_stream_wrap_ctor_template(tmpl);
   }
@@ -214,7 +257,22 @@ void LibuvStreamWrap::OnUvAlloc(size_t suggested_size, uv_buf_t* buf) {
   HandleScope scope(env()->isolate());
   Context::Scope context_scope(env()->context());
 
-  *buf = EmitAlloc(suggested_size);
+  *buf = EmitAlloc(std::min(read_size_, suggested_size));
+}
+
+
+void LibuvStreamWrap::AdaptReadSize(size_t nread, size_t buflen) {
+  if (nread >= buflen) {
+    if (read_size_ < kMaxReadSize)
+      read_size_ *= 2;
+    read_size_shrinking_ = false;
+  } else if (nread <= read_size_ / 2 && read_size_ > kMinReadSize) {
+    if (read_size_shrinking_)
+      read_size_ /= 2;
+    read_size_shrinking_ = !read_size_shrinking_;
+  } else {
+    read_size_shrinking_ = false;
+  }
 }
 
 template <class WrapType>
@@ -259,6 +317,8 @@ void LibuvStreamWrap::OnUvRead(ssize_t nread, const uv_buf_t* buf) {
   if (nread > 0) {
     MaybeLocal<Object> pending_obj;
 
+    AdaptReadSize(nread, buf->len);
+
     if (type == UV_TCP) {
       pending_obj = AcceptHandle<TCPWrap>(env(), this);
     } else if (type == UV_NAMED_PIPE) {
@@ -309,6 +369,293 @@ void LibuvStreamWrap::SetBlocking(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(uv_stream_set_blocking(wrap->stream(), enable));
 }
 
+#ifdef __linux__
+// Sends a list of memory and file segments to the stream, using sendfile(2)
+// for the file parts so that their data never has to be copied into
+// userspace. The send() and sendfile() calls run on the threadpool because
+// reading the files may block. The socket is non-blocking, so when its send
+// buffer is full the request waits on the event loop for it to become
+// writable again, through a uv_poll_t on a duplicate of the socket file
+// descriptor; libuv does not allow a second watcher on the original one.
+class LibuvStreamWrap::SendFileWrap final : public AsyncWrap,
+                                            public ThreadPoolWork {
+ public:
+  SendFileWrap(Environment* env,
+               Local<Object> object,
+               LibuvStreamWrap* stream,
+               int out_fd,
+               std::vector<SendFileSegment>&& segments,
+               SendFileCallback cb)
+      : AsyncWrap(env, object, AsyncWrap::PROVIDER_WRITEWRAP),
+        ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_KIND_FS),
+        stream_(stream),
+        out_fd_(out_fd),
+        segments_(std::move(segments)),
+        cb_(std::move(cb)) {
+    stream_->sendfiles_.insert(this);
+  }
+
+  ~SendFileWrap() override {
+    Close();
+  }
+
+  void DoThreadPoolWork() override;
+  void AfterThreadPoolWork(int status) override;
+
+  // Stops the transfer once the stream has been closed; the duplicate file
+  // descriptor would keep the connection open otherwise. The request
+  // completes with UV_ECANCELED, right away unless a threadpool job is
+  // running, in which case that job is the last one.
+  void Cancel();
+
+  SET_NO_MEMORY_INFO()
+  SET_MEMORY_INFO_NAME(SendFileWrap)
+  SET_SELF_SIZE(SendFileWrap)
+
+ private:
+  // Upper bound for the data sent by one threadpool job, so that a fast
+  // reader does not keep a threadpool thread busy indefinitely.
+  static constexpr int64_t kMaxRoundLength = 8 * 1024 * 1024;
+
+  static void OnWritable(uv_poll_t* poll, int status, int events);
+  void WaitForWritable();
+  void Close();
+  void Done(int status);
+
+  BaseObjectPtr<LibuvStreamWrap> stream_;
+  int out_fd_;
+  // The offset and length of the current segment are advanced as its data
+  // is sent.
+  std::vector<SendFileSegment> segments_;
+  size_t current_ = 0;
+  uint64_t bytes_sent_ = 0;
+  // If empty, the result is passed to the JS oncomplete callback instead.
+  SendFileCallback cb_;
+
+  // Results of the last threadpool job.
+  uint64_t round_bytes_ = 0;
+  bool would_block_ = false;
+  int err_ = 0;
+
+  uv_poll_t* poll_ = nullptr;
+  // Whether the request waits on |poll_| rather than on a threadpool job.
+  bool waiting_ = false;
+  bool cancelled_ = false;
+};
+
+void LibuvStreamWrap::SendFileWrap::DoThreadPoolWork() {
+  round_bytes_ = 0;
+  would_block_ = false;
+  while (current_ < segments_.size() &&
+         round_bytes_ < static_cast<uint64_t>(kMaxRoundLength)) {
+    SendFileSegment& segment = segments_[current_];
+    if (segment.length == 0) {
+      current_++;
+      continue;
+    }
+
+    size_t length = kMaxRoundLength - round_bytes_;
+    if (segment.length > 0 && static_cast<uint64_t>(segment.length) < length)
+      length = segment.length;
+
+    ssize_t n;
+    if (segment.fd == -1) {
+      // Let the kernel put small chunks of memory, such as protocol frame
+      // headers, into the same packet as the data that follows them.
+      int flags = MSG_NOSIGNAL;
+      if (current_ + 1 < segments_.size())
+        flags |= MSG_MORE;
+      do {
+        n = send(out_fd_, segment.data, length, flags);
+      } while (n == -1 && errno == EINTR);
+    } else {
+      off_t offset = segment.offset;
+      do {
+        n = sendfile(out_fd_, segment.fd, &offset, length);
+      } while (n == -1 && errno == EINTR);
+    }
+
+    if (n == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        would_block_ = true;
+      else
+        err_ = -errno;
+      return;
+    }
+
+    if (n == 0) {
+      // End of file.
+      current_ = segments_.size();
+      return;
+    }
+
+    round_bytes_ += n;
+    if (segment.fd == -1)
+      segment.data += n;
+    else
+      segment.offset += n;
+    if (segment.length > 0)
+      segment.length -= n;
+  }
+}
+
+void LibuvStreamWrap::SendFileWrap::AfterThreadPoolWork(int status) {
+  CHECK(status == 0 || status == UV_ECANCELED);
+  bytes_sent_ += round_bytes_;
+  stream_->bytes_written_ += round_bytes_;
+
+  if (status == UV_ECANCELED || cancelled_)
+    return Done(UV_ECANCELED);
+  if (err_ != 0)
+    return Done(err_);
+  if (current_ == segments_.size())
+    return Done(0);
+  if (would_block_)
+    return WaitForWritable();
+  ScheduleWork();
+}
+
+void LibuvStreamWrap::SendFileWrap::WaitForWritable() {
+  int err = 0;
+  if (poll_ == nullptr) {
+    poll_ = new uv_poll_t;
+    err = uv_poll_init(AsyncWrap::env()->event_loop(), poll_, out_fd_);
+    if (err != 0) {
+      delete poll_;
+      poll_ = nullptr;
+      return Done(err);
+    }
+    poll_->data = this;
+    // Like pending writes, keep the event loop alive only if the stream does.
+    if (!uv_has_ref(reinterpret_cast<uv_handle_t*>(stream_->stream())))
+      uv_unref(reinterpret_cast<uv_handle_t*>(poll_));
+  }
+  err = uv_poll_start(poll_, UV_WRITABLE, OnWritable);
+  if (err != 0)
+    return Done(err);
+  waiting_ = true;
+}
+
+void LibuvStreamWrap::SendFileWrap::OnWritable(uv_poll_t* poll,
+                                               int status,
+                                               int events) {
+  SendFileWrap* wrap = static_cast<SendFileWrap*>(poll->data);
+  uv_poll_stop(poll);
+  wrap->waiting_ = false;
+  if (status < 0)
+    return wrap->Done(status);
+  wrap->ScheduleWork();
+}
+
+void LibuvStreamWrap::SendFileWrap::Cancel() {
+  if (cancelled_)
+    return;
+  cancelled_ = true;
+  if (waiting_) {
+    uv_poll_stop(poll_);
+    waiting_ = false;
+    return Done(UV_ECANCELED);
+  }
+  // If the job has not started yet, AfterThreadPoolWork() is called with
+  // UV_ECANCELED; otherwise it sees |cancelled_| once the job has finished.
+  CancelWork();
+}
+
+void LibuvStreamWrap::SendFileWrap::Close() {
+  if (poll_ != nullptr) {
+    uv_close(reinterpret_cast<uv_handle_t*>(poll_), [](uv_handle_t* handle) {
+      delete reinterpret_cast<uv_poll_t*>(handle);
+    });
+    poll_ = nullptr;
+  }
+  // uv_close() has already removed the descriptor from the event loop.
+  if (out_fd_ != -1) {
+    CHECK_EQ(close(out_fd_), 0);
+    out_fd_ = -1;
+  }
+}
+
+void LibuvStreamWrap::SendFileWrap::Done(int status) {
+  Close();
+  stream_->sendfiles_.erase(this);
+
+  Environment* env = AsyncWrap::env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  // Held strongly while sending, see StartSendFile().
+  MakeWeak();
+
+  if (cb_) {
+    SendFileCallback cb = std::move(cb_);
+    cb(status, bytes_sent_);
+    return;
+  }
+
+  Local<Value> argv[] = {
+    Integer::New(env->isolate(), status),
+    Number::New(env->isolate(), static_cast<double>(bytes_sent_))
+  };
+  MakeCallback(env->oncomplete_string(), arraysize(argv), argv);
+}
+
+int LibuvStreamWrap::StartSendFile(Local<Object> req_wrap_obj,
+                                   std::vector<SendFileSegment>&& segments,
+                                   SendFileCallback cb) {
+  if (!IsAlive() || IsClosing())
+    return UV_EBADF;
+  // The data would end up interleaved with pending writes otherwise.
+  if (stream()->write_queue_size != 0)
+    return UV_EBUSY;
+
+  const int fd = GetFD();
+  if (fd == -1)
+    return UV_EBADF;
+  const int out_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+  if (out_fd == -1)
+    return -errno;
+
+  SendFileWrap* req_wrap = new SendFileWrap(env(),
+                                            req_wrap_obj,
+                                            this,
+                                            out_fd,
+                                            std::move(segments),
+                                            std::move(cb));
+  req_wrap->ScheduleWork();
+  return 0;
+}
+
+int LibuvStreamWrap::SendFile(std::vector<SendFileSegment>&& segments,
+                              SendFileCallback cb) {
+  CHECK(cb);
+  Local<Object> req_wrap_obj;
+  if (!env()->sendfile_wrap_template()
+           ->NewInstance(env()->context())
+           .ToLocal(&req_wrap_obj)) {
+    return UV_ENOMEM;
+  }
+  return StartSendFile(req_wrap_obj, std::move(segments), std::move(cb));
+}
+
+void LibuvStreamWrap::SendFile(const FunctionCallbackInfo<Value>& args) {
+  LibuvStreamWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+
+  CHECK(args[0]->IsObject());
+  CHECK(args[1]->IsInt32());
+  CHECK(IsSafeJsInt(args[2]));
+  CHECK(IsSafeJsInt(args[3]));
+  const int in_fd = args[1].As<Int32>()->Value();
+  const int64_t offset = args[2].As<Integer>()->Value();
+  const int64_t length = args[3].As<Integer>()->Value();
+  CHECK_GE(offset, 0);
+  CHECK_GE(length, -1);
+
+  std::vector<SendFileSegment> segments { { in_fd, offset, length, nullptr } };
+  args.GetReturnValue().Set(
+      wrap->StartSendFile(args[0].As<Object>(), std::move(segments), nullptr));
+}
+#endif  // __linux__
+
 typedef SimpleShutdownWrap<ReqWrap<uv_shutdown_t>> LibuvShutdownWrap;
 typedef SimpleWriteWrap<ReqWrap<uv_write_t>> LibuvWriteWrap;
 
@@ -321,6 +668,342 @@ WriteWrap* LibuvStreamWrap::CreateWriteWrap(Local<Object> object) {
 }
 
 
+#ifdef __linux__
+// Writes that are sent with MSG_ZEROCOPY. The kernel numbers the sendmsg()
+// calls that pass that flag on a socket, and reports ranges of those numbers
+// on the socket error queue once it no longer needs their memory, normally in
+// order. A write request completes once all of its calls have been reported,
+// so that the memory it references, such as a Buffer held by the JS request
+// object, stays alive until then. Write requests that are dispatched to libuv
+// while zero-copy writes are outstanding complete in order after them.
+//
+// The error queue makes the socket report POLLERR, which is watched through a
+// uv_poll_t on a duplicate of the socket file descriptor, like SendFileWrap
+// does for writability. The duplicate keeps the socket open after the stream
+// is closed, so that the write requests that are still outstanding then can
+// wait for their reports. The stream, which owns this object, is kept alive
+// while write requests are outstanding.
+class LibuvStreamWrap::ZeroCopyWrites final {
+ public:
+  ZeroCopyWrites(LibuvStreamWrap* stream, int fd, uv_poll_t* poll)
+      : stream_(stream), fd_(fd), poll_(poll) {
+    poll_->data = this;
+  }
+
+  ~ZeroCopyWrites() {
+    CloseHandle();
+  }
+
+  void set_threshold(size_t threshold) { threshold_ = threshold; }
+
+  // Whether a write of |bufs| is large enough to be sent without copying.
+  bool IsLarge(const uv_buf_t* bufs, size_t count) const {
+    if (threshold_ == 0)
+      return false;
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++)
+      total += bufs[i].len;
+    return total >= threshold_;
+  }
+
+  int Write(LibuvWriteWrap* req_wrap,
+            uv_buf_t* bufs,
+            size_t count,
+            uv_stream_t* send_handle);
+  // Returns false if |req_wrap| does not wait for zero-copy writes.
+  bool AfterUvWrite(LibuvWriteWrap* req_wrap, int status);
+  // Closes the watcher once all outstanding write requests have completed.
+  void Close();
+
+ private:
+  struct PendingWrite {
+    LibuvWriteWrap* req_wrap;
+    // One past the number of the last zero-copy sendmsg() call for this write.
+    uint32_t end;
+    bool uv_pending;
+    int status;
+  };
+
+  static void OnErrorQueue(uv_poll_t* poll, int status, int events);
+  bool ReadCompletions();
+  void Complete(uint32_t lo, uint32_t hi);
+  void FinishWrites();
+  void CloseHandle();
+
+  bool outstanding() const { return completed_ != next_; }
+
+  LibuvStreamWrap* const stream_;
+  // Set while |pending_| is not empty.
+  BaseObjectPtr<LibuvStreamWrap> keep_alive_;
+  int fd_;
+  uv_poll_t* poll_;
+  size_t threshold_ = 0;
+  bool closed_ = false;
+
+  // The number of the next zero-copy sendmsg() call, and the number up to
+  // which all calls have been reported. These wrap around, like the kernel's.
+  uint32_t next_ = 0;
+  uint32_t completed_ = 0;
+  // Ranges that were reported ahead of |completed_|.
+  std::vector<std::pair<uint32_t, uint32_t>> early_;
+
+  std::deque<PendingWrite> pending_;
+};
+
+int LibuvStreamWrap::ZeroCopyWrites::Write(LibuvWriteWrap* req_wrap,
+                                           uv_buf_t* bufs,
+                                           size_t count,
+                                           uv_stream_t* send_handle) {
+  uv_stream_t* stream = stream_->stream();
+  const uint32_t first = next_;
+  // Data that libuv has not sent yet has to go out first.
+  if (send_handle == nullptr && IsLarge(bufs, count) && fd_ != -1 &&
+      stream->connect_req == nullptr &&
+      stream->write_queue_size == 0) {
+    const int out_fd = stream_->GetFD();
+    while (count > 0) {
+      msghdr msg {};
+      // uv_buf_t has the same layout as struct iovec on Unix.
+      msg.msg_iov = reinterpret_cast<iovec*>(bufs);
+      msg.msg_iovlen = std::min<size_t>(count, IOV_MAX);
+      ssize_t n;
+      do {
+        n = sendmsg(out_fd, &msg, MSG_ZEROCOPY | MSG_DONTWAIT | MSG_NOSIGNAL);
+      } while (n == -1 && errno == EINTR);
+      if (n == -1) {
+        // ENOBUFS means that too much memory is pinned by outstanding
+        // zero-copy writes; libuv copies the data instead. Other errors are
+        // reported by libuv as usual if some of the data was already sent.
+        if (next_ == first && errno != EAGAIN && errno != EWOULDBLOCK &&
+            errno != ENOBUFS) {
+          return -errno;
+        }
+        break;
+      }
+      next_++;
+
+      // Skip the data that was sent, like DoTryWrite() does.
+      size_t written = n;
+      for (; count > 0; bufs++, count--) {
+        if (bufs[0].len > written) {
+          bufs[0].base += written;
+          bufs[0].len -= written;
+          break;
+        }
+        written -= bufs[0].len;
+      }
+    }
+  }
+
+  const bool sent = next_ != first;
+  if (!sent && pending_.empty()) {
+    return req_wrap->Dispatch(uv_write2,
+                              stream,
+                              bufs,
+                              count,
+                              send_handle,
+                              LibuvStreamWrap::AfterUvWrite);
+  }
+
+  PendingWrite pending { req_wrap, next_, false, 0 };
+  if (count > 0) {
+    int err = req_wrap->Dispatch(uv_write2,
+                                 stream,
+                                 bufs,
+                                 count,
+                                 send_handle,
+                                 LibuvStreamWrap::AfterUvWrite);
+    if (err != 0 && !sent)
+      return err;
+    pending.uv_pending = err == 0;
+    pending.status = err;
+  }
+  pending_.push_back(pending);
+  if (!keep_alive_)
+    keep_alive_.reset(stream_);
+
+  if (sent) {
+    // Like pending writes, keep the event loop alive only if the stream does.
+    if (uv_has_ref(reinterpret_cast<uv_handle_t*>(stream)))
+      uv_ref(reinterpret_cast<uv_handle_t*>(poll_));
+    else
+      uv_unref(reinterpret_cast<uv_handle_t*>(poll_));
+    // Only POLLERR matters, but libuv needs some event to watch. Urgent data
+    // is rare, and stops the watcher if it does not come with completions.
+    CHECK_EQ(uv_poll_start(poll_, UV_PRIORITIZED, OnErrorQueue), 0);
+  }
+  return 0;
+}
+
+bool LibuvStreamWrap::ZeroCopyWrites::AfterUvWrite(LibuvWriteWrap* req_wrap,
+                                                   int status) {
+  for (PendingWrite& pending : pending_) {
+    if (pending.req_wrap != req_wrap)
+      continue;
+    CHECK(pending.uv_pending);
+    pending.uv_pending = false;
+    if (pending.status == 0)
+      pending.status = status;
+    FinishWrites();
+    return true;
+  }
+  return false;
+}
+
+void LibuvStreamWrap::ZeroCopyWrites::OnErrorQueue(uv_poll_t* poll,
+                                                   int status,
+                                                   int events) {
+  ZeroCopyWrites* writes = static_cast<ZeroCopyWrites*>(poll->data);
+  // libuv stops the watcher itself if the socket reports only POLLERR. When
+  // nothing was queued, the socket has a pending error instead, which libuv
+  // reports for the stream, or urgent data; watching it further would spin.
+  if (!writes->ReadCompletions() || !writes->outstanding())
+    uv_poll_stop(poll);
+  else if (status < 0)
+    CHECK_EQ(uv_poll_start(poll, UV_PRIORITIZED, OnErrorQueue), 0);
+
+  Environment* env = writes->stream_->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  writes->FinishWrites();
+}
+
+bool LibuvStreamWrap::ZeroCopyWrites::ReadCompletions() {
+  bool read = false;
+  for (;;) {
+    char control[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+    msghdr msg {};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t n;
+    do {
+      n = recvmsg(fd_, &msg, MSG_ERRQUEUE);
+    } while (n == -1 && errno == EINTR);
+    if (n == -1)
+      return read;
+    read = true;
+
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+         cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+        continue;
+      }
+      sock_extended_err err;
+      memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+      if (err.ee_errno == 0 && err.ee_origin == SO_EE_ORIGIN_ZEROCOPY)
+        Complete(err.ee_info, err.ee_data);
+    }
+  }
+}
+
+void LibuvStreamWrap::ZeroCopyWrites::Complete(uint32_t lo, uint32_t hi) {
+  if (lo != completed_) {
+    early_.emplace_back(lo, hi);
+    return;
+  }
+  completed_ = hi + 1;
+  for (size_t i = 0; i < early_.size();) {
+    if (early_[i].first == completed_) {
+      completed_ = early_[i].second + 1;
+      early_.erase(early_.begin() + i);
+      i = 0;
+    } else {
+      i++;
+    }
+  }
+}
+
+void LibuvStreamWrap::ZeroCopyWrites::FinishWrites() {
+  while (!pending_.empty()) {
+    const PendingWrite& pending = pending_.front();
+    if (pending.uv_pending ||
+        static_cast<int32_t>(pending.end - completed_) > 0) {
+      break;
+    }
+    LibuvWriteWrap* req_wrap = pending.req_wrap;
+    const int status = pending.status;
+    pending_.pop_front();
+    // This may start new writes.
+    req_wrap->Done(status);
+  }
+  if (pending_.empty()) {
+    if (closed_)
+      CloseHandle();
+    // This may delete the stream, and with it this object, once the local
+    // reference goes out of scope.
+    BaseObjectPtr<LibuvStreamWrap> stream = std::move(keep_alive_);
+  }
+}
+
+void LibuvStreamWrap::ZeroCopyWrites::Close() {
+  // libuv cancels its own requests before the stream is closed.
+  for (const PendingWrite& pending : pending_)
+    CHECK(!pending.uv_pending);
+  // The kernel may still read from the memory of writes that it has not
+  // reported yet, even after the socket has been closed.
+  closed_ = true;
+  FinishWrites();
+}
+
+void LibuvStreamWrap::ZeroCopyWrites::CloseHandle() {
+  if (poll_ != nullptr) {
+    uv_close(reinterpret_cast<uv_handle_t*>(poll_), [](uv_handle_t* handle) {
+      delete reinterpret_cast<uv_poll_t*>(handle);
+    });
+    poll_ = nullptr;
+  }
+  // uv_close() has already removed the descriptor from the event loop.
+  if (fd_ != -1) {
+    CHECK_EQ(close(fd_), 0);
+    fd_ = -1;
+  }
+}
+
+int LibuvStreamWrap::SetZeroCopyThreshold(size_t threshold) {
+  if (!zero_copy_) {
+    if (threshold == 0)
+      return 0;
+    if (!IsAlive() || IsClosing())
+      return UV_EBADF;
+
+    const int fd = GetFD();
+    if (fd == -1)
+      return UV_EBADF;
+    const int on = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) != 0)
+      return -errno;
+
+    const int poll_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (poll_fd == -1)
+      return -errno;
+    uv_poll_t* poll = new uv_poll_t;
+    int err = uv_poll_init(env()->event_loop(), poll, poll_fd);
+    if (err != 0) {
+      delete poll;
+      CHECK_EQ(close(poll_fd), 0);
+      return err;
+    }
+    zero_copy_ = std::make_unique<ZeroCopyWrites>(this, poll_fd, poll);
+  }
+  zero_copy_->set_threshold(threshold);
+  return 0;
+}
+#endif  // __linux__
+
+void LibuvStreamWrap::OnClose() {
+#ifdef __linux__
+  // Done() removes each request from the set.
+  std::vector<SendFileWrap*> sendfiles(sendfiles_.begin(), sendfiles_.end());
+  for (SendFileWrap* sendfile : sendfiles)
+    sendfile->Cancel();
+  if (zero_copy_)
+    zero_copy_->Close();
+#endif
+}
+
+
 int LibuvStreamWrap::DoShutdown(ShutdownWrap* req_wrap_) {
   LibuvShutdownWrap* req_wrap = static_cast<LibuvShutdownWrap*>(req_wrap_);
   return req_wrap->Dispatch(uv_shutdown, stream(), AfterUvShutdown);
@@ -347,6 +1030,12 @@ int LibuvStreamWrap::DoTryWrite(uv_buf_t** bufs, size_t* count) {
   uv_buf_t* vbufs = *bufs;
   size_t vcount = *count;
 
+#ifdef __linux__
+  // Leave large writes to DoWrite(), which sends them without copying.
+  if (zero_copy_ && zero_copy_->IsLarge(vbufs, vcount))
+    return 0;
+#endif
+
   err = uv_try_write(stream(), vbufs, vcount);
   if (err == UV_ENOSYS || err == UV_EAGAIN)
     return 0;
@@ -382,6 +1071,10 @@ int LibuvStreamWrap::DoWrite(WriteWrap* req_wrap,
                              size_t count,
                              uv_stream_t* send_handle) {
   LibuvWriteWrap* w = static_cast<LibuvWriteWrap*>(req_wrap);
+#ifdef __linux__
+  if (zero_copy_)
+    return zero_copy_->Write(w, bufs, count, send_handle);
+#endif
   return w->Dispatch(uv_write2,
                      stream(),
                      bufs,
@@ -398,6 +1091,11 @@ void LibuvStreamWrap::AfterUvWrite(uv_write_t* req, int status) {
   CHECK_NOT_NULL(req_wrap);
   HandleScope scope(req_wrap->env()->isolate());
   Context::Scope context_scope(req_wrap->env()->context());
+#ifdef __linux__
+  LibuvStreamWrap* stream = static_cast<LibuvStreamWrap*>(req_wrap->stream());
+  if (stream->zero_copy_ && stream->zero_copy_->AfterUvWrite(req_wrap, status))
+    return;
+#endif
   req_wrap->Done(status);
 }
 
@@ -28,6 +28,11 @@
 #include "handle_wrap.h"
 #include "v8.h"
 
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
 namespace node {
 
 class Environment;
@@ -78,11 +83,42 @@ class LibuvStreamWrap : public HandleWrap, public StreamBase {
 
   static LibuvStreamWrap* From(Environment* env, v8::Local<v8::Object> object);
 
+#ifdef __linux__
+  // One part of the data written by SendFile(): |length| bytes of the file
+  // |fd| starting at |offset| or, if |fd| is -1, |length| bytes of memory
+  // at |data|. For files, a |length| of -1 means up to the end of the file.
+  struct SendFileSegment {
+    int fd;
+    int64_t offset;
+    int64_t length;
+    const char* data;
+  };
+  typedef std::function<void(int status, uint64_t bytes_sent)>
+      SendFileCallback;
+
+  // Writes |segments| in order, sending the file parts with sendfile(2), and
+  // calls |cb| once all of them have been written or an error occurred.
+  // Reaching the end of a file stops the request early. Memory segments
+  // must stay valid, and no other writes may be started on the stream,
+  // until |cb| has been called. If a libuv error code is returned, |cb| is
+  // not called.
+  int SendFile(std::vector<SendFileSegment>&& segments, SendFileCallback cb);
+
+  // Turns on SO_ZEROCOPY for the socket, and sends later writes of at least
+  // |threshold| bytes with MSG_ZEROCOPY. Their write requests complete only
+  // once the kernel reports that it no longer reads from their memory. A
+  // |threshold| of 0 turns this off again for later writes.
+  int SetZeroCopyThreshold(size_t threshold);
+#endif
+
  protected:
   LibuvStreamWrap(Environment* env,
                   v8::Local<v8::Object> object,
                   uv_stream_t* stream,
                   AsyncWrap::ProviderType provider);
+  ~LibuvStreamWrap() override;
+
+  void OnClose() override;
 
   AsyncWrap* GetAsyncWrap() override;
 
@@ -101,16 +137,38 @@ class LibuvStreamWrap : public HandleWrap, public StreamBase {
   static void GetWriteQueueSize(
       const v8::FunctionCallbackInfo<v8::Value>& info);
   static void SetBlocking(const v8::FunctionCallbackInfo<v8::Value>& args);
+#ifdef __linux__
+  class SendFileWrap;
+  static void SendFile(const v8::FunctionCallbackInfo<v8::Value>& args);
+  int StartSendFile(v8::Local<v8::Object> req_wrap_obj,
+                    std::vector<SendFileSegment>&& segments,
+                    SendFileCallback cb);
+  // Cancelled when the stream is closed.
+  std::unordered_set<SendFileWrap*> sendfiles_;
+
+  class ZeroCopyWrites;
+  std::unique_ptr<ZeroCopyWrites> zero_copy_;
+#endif
 
   // Callbacks for libuv
   void OnUvAlloc(size_t suggested_size, uv_buf_t* buf);
   void OnUvRead(ssize_t nread, const uv_buf_t* buf);
+  void AdaptReadSize(size_t nread, size_t buflen);
 
   static void AfterUvWrite(uv_write_t* req, int status);
   static void AfterUvShutdown(uv_shutdown_t* req, int status);
 
   uv_stream_t* const stream_;
 
+  // The size of the buffers that OnUvAlloc() asks for. It doubles after a
+  // read that fills the buffer, and halves after two reads in a row that
+  // would have fit into half of it, so that streams which receive small
+  // messages do not allocate 64 KB for each of them.
+  static constexpr size_t kMinReadSize = 2 * 1024;
+  static constexpr size_t kMaxReadSize = 64 * 1024;
+  size_t read_size_ = 16 * 1024;
+  bool read_size_shrinking_ = false;
+
 #ifdef _WIN32
   // We don't always have an FD that we could look up on the stream_
   // object itself on Windows. However, for some cases, we open handles
@@ -25,6 +25,7 @@
 #include "env-inl.h"
 #include "node_buffer.h"
 #include "node_errors.h"
+#include "utf8.h"
 #include "util.h"
 
 #include <climits>
@@ -33,6 +34,11 @@
 #include <algorithm>
 #include <vector>
 
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NODE_STRING_BYTES_X86 1
+#include <immintrin.h>
+#endif
+
 // When creating strings >= this length v8's gc spins up and consumes
 // most of the execution time. For these cases it's more performant to
 // use external string resources.
@@ -221,6 +227,199 @@ const int8_t unbase64_table[256] =
   };
 
 
+namespace {
+
+// Vectorized kernels for hex encoding and decoding and for finding non-ASCII
+// bytes. Each of them processes as much of its input as fits into whole
+// vectors and returns how far it got; the scalar code below finishes the rest.
+
+#ifdef NODE_STRING_BYTES_X86
+
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+SSSE3_TARGET size_t HexEncodeSSSE3(const char* src, size_t slen, char* dst) {
+  const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                    '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 16 <= slen; i += 16, dst += 32) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i hi =
+        _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+    const __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(in, mask));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16),
+                     _mm_unpackhi_epi8(hi, lo));
+  }
+  return i;
+}
+
+// Translates 16 hex digits into their values. Sets |valid| to false if any
+// of them is not a hex digit.
+SSSE3_TARGET inline __m128i HexDigitValues(__m128i in, __m128i* valid) {
+  const __m128i digit = _mm_sub_epi8(in, _mm_set1_epi8('0'));
+  const __m128i is_digit =
+      _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+  // Setting 0x20 maps 'A'-'F' to 'a'-'f' and no other byte into that range.
+  const __m128i alpha =
+      _mm_sub_epi8(_mm_or_si128(in, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+  const __m128i is_alpha =
+      _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+  *valid = _mm_and_si128(*valid, _mm_or_si128(is_digit, is_alpha));
+  return _mm_or_si128(
+      _mm_and_si128(is_digit, digit),
+      _mm_and_si128(is_alpha, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+}
+
+SSSE3_TARGET size_t HexDecodeSSSE3(char* dst,
+                                   size_t dstlen,
+                                   const char* src,
+                                   size_t srclen) {
+  // Combines each pair of digits into digit0 * 16 + digit1.
+  const __m128i weights = _mm_set1_epi16(0x0110);
+  size_t i = 0;
+  for (; i + 16 <= dstlen && 2 * i + 32 <= srclen; i += 16) {
+    const __m128i* in = reinterpret_cast<const __m128i*>(src + 2 * i);
+    __m128i valid = _mm_set1_epi8(-1);
+    const __m128i lo = HexDigitValues(_mm_loadu_si128(in), &valid);
+    const __m128i hi = HexDigitValues(_mm_loadu_si128(in + 1), &valid);
+    if (_mm_movemask_epi8(valid) != 0xffff)
+      break;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packus_epi16(_mm_maddubs_epi16(lo, weights),
+                                      _mm_maddubs_epi16(hi, weights)));
+  }
+  return i;
+}
+
+SSSE3_TARGET size_t AsciiPrefixSSSE3(const char* src, size_t len) {
+  size_t i = 0;
+  for (; i + 64 <= len; i += 64) {
+    const __m128i* in = reinterpret_cast<const __m128i*>(src + i);
+    const __m128i bits =
+        _mm_or_si128(_mm_or_si128(_mm_loadu_si128(in), _mm_loadu_si128(in + 1)),
+                     _mm_or_si128(_mm_loadu_si128(in + 2),
+                                  _mm_loadu_si128(in + 3)));
+    if (_mm_movemask_epi8(bits) != 0)
+      break;
+  }
+  return i;
+}
+
+AVX2_TARGET size_t HexEncodeAVX2(const char* src, size_t slen, char* dst) {
+  const __m256i lut = _mm256_setr_epi8(
+      '0', '1', '2', '3', '4', '5', '6', '7',
+      '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+      '0', '1', '2', '3', '4', '5', '6', '7',
+      '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+  const __m256i mask = _mm256_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 32 <= slen; i += 32, dst += 64) {
+    const __m256i in =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i hi = _mm256_shuffle_epi8(
+        lut, _mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+    const __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(in, mask));
+    // The unpack instructions work within 128-bit lanes, so the two halves
+    // of the output are in the wrong lanes at this point.
+    const __m256i a = _mm256_unpacklo_epi8(hi, lo);
+    const __m256i b = _mm256_unpackhi_epi8(hi, lo);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                        _mm256_permute2x128_si256(a, b, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32),
+                        _mm256_permute2x128_si256(a, b, 0x31));
+  }
+  return i + HexEncodeSSSE3(src + i, slen - i, dst);
+}
+
+AVX2_TARGET inline __m256i HexDigitValues(__m256i in, __m256i* valid) {
+  const __m256i digit = _mm256_sub_epi8(in, _mm256_set1_epi8('0'));
+  const __m256i is_digit =
+      _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+  const __m256i alpha = _mm256_sub_epi8(
+      _mm256_or_si256(in, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+  const __m256i is_alpha =
+      _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, _mm256_set1_epi8(5)), alpha);
+  *valid = _mm256_and_si256(*valid, _mm256_or_si256(is_digit, is_alpha));
+  return _mm256_or_si256(
+      _mm256_and_si256(is_digit, digit),
+      _mm256_and_si256(is_alpha,
+                       _mm256_add_epi8(alpha, _mm256_set1_epi8(10))));
+}
+
+AVX2_TARGET size_t HexDecodeAVX2(char* dst,
+                                 size_t dstlen,
+                                 const char* src,
+                                 size_t srclen) {
+  const __m256i weights = _mm256_set1_epi16(0x0110);
+  size_t i = 0;
+  for (; i + 32 <= dstlen && 2 * i + 64 <= srclen; i += 32) {
+    const __m256i* in = reinterpret_cast<const __m256i*>(src + 2 * i);
+    __m256i valid = _mm256_set1_epi8(-1);
+    const __m256i lo = HexDigitValues(_mm256_loadu_si256(in), &valid);
+    const __m256i hi = HexDigitValues(_mm256_loadu_si256(in + 1), &valid);
+    if (_mm256_movemask_epi8(valid) != -1)
+      break;
+    // Packing works within lanes as well, which leaves the 64-bit groups
+    // of the result in the order 0, 2, 1, 3.
+    const __m256i packed = _mm256_packus_epi16(
+        _mm256_maddubs_epi16(lo, weights), _mm256_maddubs_epi16(hi, weights));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                        _mm256_permute4x64_epi64(packed, 0xd8));
+  }
+  return i + HexDecodeSSSE3(dst + i, dstlen - i, src + 2 * i, srclen - 2 * i);
+}
+
+AVX2_TARGET size_t AsciiPrefixAVX2(const char* src, size_t len) {
+  size_t i = 0;
+  for (; i + 128 <= len; i += 128) {
+    const __m256i* in = reinterpret_cast<const __m256i*>(src + i);
+    const __m256i bits = _mm256_or_si256(
+        _mm256_or_si256(_mm256_loadu_si256(in), _mm256_loadu_si256(in + 1)),
+        _mm256_or_si256(_mm256_loadu_si256(in + 2),
+                        _mm256_loadu_si256(in + 3)));
+    if (_mm256_movemask_epi8(bits) != 0)
+      break;
+  }
+  return i;
+}
+
+#undef SSSE3_TARGET
+#undef AVX2_TARGET
+
+#endif  // NODE_STRING_BYTES_X86
+
+struct StringBytesKernels {
+  size_t (*hex_encode)(const char* src, size_t slen, char* dst);
+  size_t (*hex_decode)(char* dst,
+                       size_t dstlen,
+                       const char* src,
+                       size_t srclen);
+  size_t (*ascii_prefix)(const char* src, size_t len);
+};
+
+StringBytesKernels SelectKernels() {
+#ifdef NODE_STRING_BYTES_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return { HexEncodeAVX2, HexDecodeAVX2, AsciiPrefixAVX2 };
+  if (__builtin_cpu_supports("ssse3"))
+    return { HexEncodeSSSE3, HexDecodeSSSE3, AsciiPrefixSSSE3 };
+#endif
+  return { nullptr, nullptr, nullptr };
+}
+
+const StringBytesKernels& GetKernels() {
+  static const StringBytesKernels kernels = SelectKernels();
+  return kernels;
+}
+
+}  // anonymous namespace
+
+
 static const int8_t unhex_table[256] =
   { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
@@ -249,8 +448,12 @@ static size_t hex_decode(char* buf,
                          size_t len,
                          const TypeName* src,
                          const size_t srcLen) {
-  size_t i;
-  for (i = 0; i < len && i * 2 + 1 < srcLen; ++i) {
+  size_t i = 0;
+  if (sizeof(TypeName) == 1 && GetKernels().hex_decode != nullptr) {
+    i = GetKernels().hex_decode(
+        buf, len, reinterpret_cast<const char*>(src), srcLen);
+  }
+  for (; i < len && i * 2 + 1 < srcLen; ++i) {
     unsigned a = unhex(src[i * 2 + 0]);
     unsigned b = unhex(src[i * 2 + 1]);
     if (!~a || !~b)
@@ -361,10 +564,20 @@ size_t StringBytes::Write(Isolate* isolate,
       break;
     }
 
+    case BASE64URL:
+      // Fall through, base64_decode() accepts both alphabets.
     case BASE64:
       if (str->IsExternalOneByte()) {
         auto ext = str->GetExternalOneByteStringResource();
         nbytes = base64_decode(buf, buflen, ext->data(), ext->length());
+      } else if (str->IsOneByte()) {
+        // Flatten into one-byte characters, which base64_decode() can
+        // process with vector instructions.
+        const int length = str->Length();
+        MaybeStackBuffer<uint8_t> value(length);
+        str->WriteOneByte(isolate, *value, 0, length,
+                          String::NO_NULL_TERMINATION);
+        nbytes = base64_decode(buf, buflen, *value, length);
       } else {
         String::Value value(isolate, str);
         nbytes = base64_decode(buf, buflen, *value, value.length());
@@ -376,6 +589,12 @@ size_t StringBytes::Write(Isolate* isolate,
       if (str->IsExternalOneByte()) {
         auto ext = str->GetExternalOneByteStringResource();
         nbytes = hex_decode(buf, buflen, ext->data(), ext->length());
+      } else if (str->IsOneByte()) {
+        const int length = str->Length();
+        MaybeStackBuffer<uint8_t> value(length);
+        str->WriteOneByte(isolate, *value, 0, length,
+                          String::NO_NULL_TERMINATION);
+        nbytes = hex_decode(buf, buflen, *value, length);
       } else {
         String::Value value(isolate, str);
         nbytes = hex_decode(buf, buflen, *value, value.length());
@@ -428,6 +647,8 @@ Maybe<size_t> StringBytes::StorageSize(Isolate* isolate,
       data_size = str->Length() * sizeof(uint16_t);
       break;
 
+    case BASE64URL:
+      // Fall through.
     case BASE64:
       data_size = base64_decoded_size_fast(str->Length());
       break;
@@ -469,6 +690,8 @@ Maybe<size_t> StringBytes::Size(Isolate* isolate,
     case UCS2:
       return Just(str->Length() * sizeof(uint16_t));
 
+    case BASE64URL:
+      // Fall through.
     case BASE64: {
       String::Value value(isolate, str);
       return Just(base64_decoded_size(*value, value.length()));
@@ -494,6 +717,12 @@ static bool contains_non_ascii_slow(const char* buf, size_t len) {
 
 
 static bool contains_non_ascii(const char* src, size_t len) {
+  if (GetKernels().ascii_prefix != nullptr) {
+    const size_t n = GetKernels().ascii_prefix(src, len);
+    src += n;
+    len -= n;
+  }
+
   if (len < 16) {
     return contains_non_ascii_slow(src, len);
   }
@@ -593,7 +822,10 @@ static size_t hex_encode(const char* src, size_t slen, char* dst, size_t dlen) {
       "not enough space provided for hex encode");
 
   dlen = slen * 2;
-  for (uint32_t i = 0, k = 0; k < dlen; i += 1, k += 2) {
+  size_t i = 0;
+  if (GetKernels().hex_encode != nullptr)
+    i = GetKernels().hex_encode(src, slen, dst);
+  for (size_t k = i * 2; k < dlen; i += 1, k += 2) {
     static const char hex[] = "0123456789abcdef";
     uint8_t val = static_cast<uint8_t>(src[i]);
     dst[k + 0] = hex[val >> 4];
@@ -654,7 +886,34 @@ MaybeLocal<Value> StringBytes::Encode(Isolate* isolate,
         return ExternOneByteString::NewFromCopy(isolate, buf, buflen, error);
       }
 
-    case UTF8:
+    case UTF8: {
+      // Well-formed input is transcoded with vector instructions where
+      // possible. Pure ASCII is common and is copied straight into a one-byte
+      // string. Everything else takes V8's UTF-8 decoder, which replaces
+      // invalid sequences.
+      Utf8Info info;
+      if (utf8_validate(buf, buflen, &info)) {
+        if (info.utf16_length == buflen)
+          return ExternOneByteString::NewFromCopy(isolate, buf, buflen, error);
+        if (info.latin1) {
+          char* dst = node::UncheckedMalloc(info.utf16_length);
+          if (dst == nullptr) {
+            *error = node::ERR_MEMORY_ALLOCATION_FAILED(isolate);
+            return MaybeLocal<Value>();
+          }
+          size_t written = utf8_to_latin1(buf, buflen, dst);
+          CHECK_EQ(written, info.utf16_length);
+          return ExternOneByteString::New(isolate, dst, written, error);
+        }
+        uint16_t* dst = node::UncheckedMalloc<uint16_t>(info.utf16_length);
+        if (dst == nullptr) {
+          *error = node::ERR_MEMORY_ALLOCATION_FAILED(isolate);
+          return MaybeLocal<Value>();
+        }
+        size_t written = utf8_to_utf16(buf, buflen, dst);
+        CHECK_EQ(written, info.utf16_length);
+        return ExternTwoByteString::New(isolate, dst, written, error);
+      }
       val = String::NewFromUtf8(isolate,
                                 buf,
                                 v8::NewStringType::kNormal,
@@ -664,19 +923,23 @@ MaybeLocal<Value> StringBytes::Encode(Isolate* isolate,
         return MaybeLocal<Value>();
       }
       return val.ToLocalChecked();
+    }
 
     case LATIN1:
       return ExternOneByteString::NewFromCopy(isolate, buf, buflen, error);
 
-    case BASE64: {
-      size_t dlen = base64_encoded_size(buflen);
+    case BASE64:
+    case BASE64URL: {
+      const Base64Mode mode =
+          encoding == BASE64 ? Base64Mode::NORMAL : Base64Mode::URL;
+      size_t dlen = base64_encoded_size(buflen, mode);
       char* dst = node::UncheckedMalloc(dlen);
       if (dst == nullptr) {
         *error = node::ERR_MEMORY_ALLOCATION_FAILED(isolate);
         return MaybeLocal<Value>();
       }
 
-      size_t written = base64_encode(buf, buflen, dst, dlen);
+      size_t written = base64_encode(buf, buflen, dst, dlen, mode);
       CHECK_EQ(written, dlen);
 
       return ExternOneByteString::New(isolate, dst, dlen, error);
@@ -768,4 +1031,18 @@ MaybeLocal<Value> StringBytes::Encode(Isolate* isolate,
   return Encode(isolate, buf, len, encoding, error);
 }
 
+MaybeLocal<Value> StringBytes::NewString(Isolate* isolate,
+                                         char* data,
+                                         size_t length,
+                                         Local<Value>* error) {
+  return ExternOneByteString::New(isolate, data, length, error);
+}
+
+MaybeLocal<Value> StringBytes::NewString(Isolate* isolate,
+                                         uint16_t* data,
+                                         size_t length,
+                                         Local<Value>* error) {
+  return ExternTwoByteString::New(isolate, data, length, error);
+}
+
 }  // namespace node
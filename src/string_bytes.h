@@ -97,6 +97,19 @@ class StringBytes {
                                           enum encoding encoding,
                                           v8::Local<v8::Value>* error);
 
+  // Turn one-byte or host-order two-byte character data into a String,
+  // taking ownership of |data|, which must have been allocated with malloc().
+  // Long strings use |data| as their external storage instead of copying it.
+  static v8::MaybeLocal<v8::Value> NewString(v8::Isolate* isolate,
+                                             char* data,
+                                             size_t length,
+                                             v8::Local<v8::Value>* error);
+
+  static v8::MaybeLocal<v8::Value> NewString(v8::Isolate* isolate,
+                                             uint16_t* data,
+                                             size_t length,
+                                             v8::Local<v8::Value>* error);
+
  private:
   static size_t WriteUCS2(v8::Isolate* isolate,
                           char* buf,
@@ -3,9 +3,12 @@
 
 #include "env-inl.h"
 #include "node_buffer.h"
+#include "node_errors.h"
 #include "string_bytes.h"
 #include "util.h"
 
+#include <vector>
+
 using v8::Array;
 using v8::ArrayBufferView;
 using v8::Context;
@@ -27,21 +30,14 @@ MaybeLocal<String> MakeString(Isolate* isolate,
                               size_t length,
                               enum encoding encoding) {
   Local<Value> error;
-  MaybeLocal<Value> ret;
-  if (encoding == UTF8) {
-    return String::NewFromUtf8(
-        isolate,
-        data,
-        v8::NewStringType::kNormal,
-        length);
-  } else {
-    ret = StringBytes::Encode(
-        isolate,
-        data,
-        length,
-        encoding,
-        &error);
-  }
+  // StringBytes::Encode() also takes care of UTF-8, with a fast path for
+  // well-formed input.
+  MaybeLocal<Value> ret = StringBytes::Encode(
+      isolate,
+      data,
+      length,
+      encoding,
+      &error);
 
   if (ret.IsEmpty()) {
     CHECK(!error.IsEmpty());
@@ -62,7 +58,8 @@ MaybeLocal<String> StringDecoder::DecodeData(Isolate* isolate,
 
   size_t nread = *nread_ptr;
 
-  if (Encoding() == UTF8 || Encoding() == UCS2 || Encoding() == BASE64) {
+  if (Encoding() == UTF8 || Encoding() == UCS2 || Encoding() == BASE64 ||
+      Encoding() == BASE64URL) {
     // See if we want bytes to finish a character from the previous
     // chunk; if so, copy the new bytes to the missing bytes buffer
     // and create a small string from it that is to be prepended to the
@@ -190,7 +187,7 @@ MaybeLocal<String> StringDecoder::DecodeData(Isolate* isolate,
           state_[kBufferedBytes] = 2;
           state_[kMissingBytes] = 2;
         }
-      } else if (Encoding() == BASE64) {
+      } else if (Encoding() == BASE64 || Encoding() == BASE64URL) {
         state_[kBufferedBytes] = nread % 3;
         if (state_[kBufferedBytes] > 0)
           state_[kMissingBytes] = 3 - BufferedBytes();
@@ -276,6 +273,73 @@ void FlushData(const FunctionCallbackInfo<Value>& args) {
     args.GetReturnValue().Set(ret.ToLocalChecked());
 }
 
+int WriteString(Isolate* isolate, Local<String> string, char* out) {
+  return string->WriteOneByte(isolate, reinterpret_cast<uint8_t*>(out),
+                              0, -1, String::NO_NULL_TERMINATION);
+}
+
+int WriteString(Isolate* isolate, Local<String> string, uint16_t* out) {
+  return string->Write(isolate, out, 0, -1, String::NO_NULL_TERMINATION);
+}
+
+// The strings are written into memory that becomes the result, which is
+// external if it is long enough for that to pay off.
+template <typename T>
+MaybeLocal<Value> JoinStringsInto(Isolate* isolate,
+                                  const std::vector<Local<String>>& list,
+                                  size_t length,
+                                  Local<Value>* error) {
+  T* data = UncheckedMalloc<T>(length);
+  if (data == nullptr) {
+    *error = ERR_MEMORY_ALLOCATION_FAILED(isolate);
+    return MaybeLocal<Value>();
+  }
+  T* out = data;
+  for (Local<String> string : list)
+    out += WriteString(isolate, string, out);
+  CHECK_EQ(static_cast<size_t>(out - data), length);
+  return StringBytes::NewString(isolate, data, length, error);
+}
+
+// Joins an array of strings into one flat string. Readable streams with a
+// decoder use this to build the result of read() in a single pass, rather
+// than a cons string that V8 has to flatten on its first use.
+void JoinStrings(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+
+  CHECK(args[0]->IsArray());
+  Local<Array> list = args[0].As<Array>();
+  const uint32_t count = list->Length();
+
+  std::vector<Local<String>> strings(count);
+  size_t length = 0;
+  bool one_byte = true;
+  for (uint32_t i = 0; i < count; i++) {
+    Local<Value> value;
+    if (!list->Get(context, i).ToLocal(&value))
+      return;
+    CHECK(value->IsString());
+    strings[i] = value.As<String>();
+    length += strings[i]->Length();
+    one_byte = one_byte && strings[i]->IsOneByte();
+  }
+  // JS land joins longer strings itself, so that the error is the usual one.
+  CHECK_LE(length, static_cast<size_t>(String::kMaxLength));
+
+  Local<Value> error;
+  MaybeLocal<Value> ret = one_byte ?
+      JoinStringsInto<char>(isolate, strings, length, &error) :
+      JoinStringsInto<uint16_t>(isolate, strings, length, &error);
+  if (ret.IsEmpty()) {
+    CHECK(!error.IsEmpty());
+    isolate->ThrowException(error);
+    return;
+  }
+  args.GetReturnValue().Set(ret.ToLocalChecked());
+}
+
 void InitializeStringDecoder(Local<Object> target,
                              Local<Value> unused,
                              Local<Context> context,
@@ -303,6 +367,7 @@ void InitializeStringDecoder(Local<Object> target,
   ADD_TO_ENCODINGS_ARRAY(ASCII, "ascii");
   ADD_TO_ENCODINGS_ARRAY(UTF8, "utf8");
   ADD_TO_ENCODINGS_ARRAY(BASE64, "base64");
+  ADD_TO_ENCODINGS_ARRAY(BASE64URL, "base64url");
   ADD_TO_ENCODINGS_ARRAY(UCS2, "utf16le");
   ADD_TO_ENCODINGS_ARRAY(HEX, "hex");
   ADD_TO_ENCODINGS_ARRAY(BUFFER, "buffer");
@@ -318,6 +383,7 @@ void InitializeStringDecoder(Local<Object> target,
 
   env->SetMethod(target, "decode", DecodeData);
   env->SetMethod(target, "flush", FlushData);
+  env->SetMethodNoSideEffect(target, "joinStrings", JoinStrings);
 }
 
 }  // anonymous namespace
@@ -12,6 +12,11 @@
 #include <cstring>
 #include <algorithm>
 
+#if defined(__SSE2__) && defined(__GNUC__)
+#define NODE_STRING_SEARCH_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace node {
 namespace stringsearch {
 
@@ -103,6 +108,12 @@ class StringSearch : private StringSearchBase {
         strategy_ = &StringSearch::SingleCharSearch;
         return;
       }
+#ifdef NODE_STRING_SEARCH_SSE2
+      if (sizeof(Char) == 1 && pattern.forward()) {
+        strategy_ = &StringSearch::PairFilterSearch;
+        return;
+      }
+#endif
       strategy_ = &StringSearch::LinearSearch;
       return;
     }
@@ -131,6 +142,9 @@ class StringSearch : private StringSearchBase {
   typedef size_t (StringSearch::*SearchFunction)(Vector, size_t);
   size_t SingleCharSearch(Vector subject, size_t start_index);
   size_t LinearSearch(Vector subject, size_t start_index);
+#ifdef NODE_STRING_SEARCH_SSE2
+  size_t PairFilterSearch(Vector subject, size_t start_index);
+#endif
   size_t InitialSearch(Vector subject, size_t start_index);
   size_t BoyerMooreHorspoolSearch(Vector subject, size_t start_index);
   size_t BoyerMooreSearch(Vector subject, size_t start_index);
@@ -309,6 +323,46 @@ size_t StringSearch<Char>::LinearSearch(
   return subject.length();
 }
 
+#ifdef NODE_STRING_SEARCH_SSE2
+//---------------------------------------------------------------------
+// Vectorized Linear Search Strategy
+//---------------------------------------------------------------------
+
+// Linear search for short byte patterns, searched front to back. Looks for
+// positions where both the first and the last byte of the pattern match,
+// 16 positions at a time, and compares only those against the full pattern.
+// See http://0x80.pl/articles/simd-strfind.html.
+template <typename Char>
+size_t StringSearch<Char>::PairFilterSearch(
+    Vector subject,
+    size_t index) {
+  CHECK_GT(pattern_.length(), 1);
+  DCHECK(subject.forward());
+  const uint8_t* s = reinterpret_cast<const uint8_t*>(subject.start());
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(pattern_.start());
+  const size_t m = pattern_.length();
+  const size_t n = subject.length();
+  const __m128i first = _mm_set1_epi8(p[0]);
+  const __m128i last = _mm_set1_epi8(p[m - 1]);
+
+  size_t i = index;
+  for (; i + m - 1 + 16 <= n; i += 16) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + m - 1));
+    unsigned mask = _mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+    while (mask != 0) {
+      const size_t candidate = i + __builtin_ctz(mask);
+      if (memcmp(s + candidate + 1, p + 1, m - 2) == 0)
+        return candidate;
+      mask &= mask - 1;
+    }
+  }
+  return LinearSearch(subject, i);
+}
+#endif  // NODE_STRING_SEARCH_SSE2
+
 //---------------------------------------------------------------------
 // Boyer-Moore string search
 //---------------------------------------------------------------------
@@ -566,6 +620,60 @@ size_t SearchString(Vector<const Char> subject,
   StringSearch<Char> search(pattern);
   return search.Search(subject, start_index);
 }
+
+// Finds the first byte at or after |index| in |subject| that is one of the
+// |set_length| bytes in |set|. Returns |subject_length| if there is none.
+inline size_t FindFirstOf(const uint8_t* subject,
+                          size_t subject_length,
+                          size_t index,
+                          const uint8_t* set,
+                          size_t set_length) {
+  if (index >= subject_length)
+    return subject_length;
+  if (set_length == 1) {
+    const void* pos =
+        memchr(subject + index, set[0], subject_length - index);
+    return pos != nullptr ?
+        static_cast<const uint8_t*>(pos) - subject : subject_length;
+  }
+
+  bool in_set[256] = {};
+  uint8_t unique[256];
+  size_t unique_length = 0;
+  for (size_t i = 0; i < set_length; i++) {
+    if (!in_set[set[i]]) {
+      in_set[set[i]] = true;
+      unique[unique_length++] = set[i];
+    }
+  }
+
+  size_t i = index;
+#ifdef NODE_STRING_SEARCH_SSE2
+  // Small sets, such as the delimiters of CSV, are compared against 16 bytes
+  // of the subject at once, one byte of the set at a time.
+  static const size_t kMaxVectorSetLength = 16;
+  if (unique_length <= kMaxVectorSetLength) {
+    __m128i needles[kMaxVectorSetLength];
+    for (size_t k = 0; k < unique_length; k++)
+      needles[k] = _mm_set1_epi8(unique[k]);
+    for (; i + 16 <= subject_length; i += 16) {
+      const __m128i in =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(subject + i));
+      __m128i found = _mm_cmpeq_epi8(in, needles[0]);
+      for (size_t k = 1; k < unique_length; k++)
+        found = _mm_or_si128(found, _mm_cmpeq_epi8(in, needles[k]));
+      const int mask = _mm_movemask_epi8(found);
+      if (mask != 0)
+        return i + __builtin_ctz(mask);
+    }
+  }
+#endif  // NODE_STRING_SEARCH_SSE2
+  for (; i < subject_length; i++) {
+    if (in_set[subject[i]])
+      return i;
+  }
+  return subject_length;
+}
 }  // namespace stringsearch
 }  // namespace node
 
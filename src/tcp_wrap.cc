@@ -33,6 +33,16 @@
 
 #include <cstdlib>
 
+#ifdef __linux__
+#include <linux/filter.h>
+#include <sys/socket.h>
+#endif
+#ifndef _WIN32
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>  // close()
+#endif
+
 
 namespace node {
 
@@ -100,6 +110,14 @@ void TCPWrap::Initialize(Local<Object> target,
                       GetSockOrPeerName<TCPWrap, uv_tcp_getpeername>);
   env->SetProtoMethod(t, "setNoDelay", SetNoDelay);
   env->SetProtoMethod(t, "setKeepAlive", SetKeepAlive);
+  env->SetProtoMethod(t, "setReusePortCpuSteering", SetReusePortCpuSteering);
+  env->SetProtoMethod(t, "setAcceptBatchSize", SetAcceptBatchSize);
+  env->SetProtoMethod(t, "setBusyPoll", SetSocketBusyPoll);
+  env->SetProtoMethod(t, "setRecvLowWatermark", SetRecvLowWatermark);
+  env->SetProtoMethod(t, "setFastOpen", SetFastOpen);
+  env->SetProtoMethod(t, "setFastOpenConnect", SetFastOpenConnect);
+  env->SetProtoMethod(t, "setDeferAccept", SetDeferAccept);
+  env->SetProtoMethod(t, "setZeroCopyThreshold", SetZeroCopyThreshold);
 
 #ifdef _WIN32
   env->SetProtoMethod(t, "setSimultaneousAccepts", SetSimultaneousAccepts);
@@ -126,6 +144,7 @@ void TCPWrap::Initialize(Local<Object> target,
   NODE_DEFINE_CONSTANT(constants, SOCKET);
   NODE_DEFINE_CONSTANT(constants, SERVER);
   NODE_DEFINE_CONSTANT(constants, UV_TCP_IPV6ONLY);
+  NODE_DEFINE_CONSTANT(constants, UV_TCP_REUSEPORT);
   target->Set(context,
               env->constants_string(),
               constants).Check();
@@ -192,6 +211,200 @@ void TCPWrap::SetKeepAlive(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+void TCPWrap::SetAcceptBatchSize(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+  CHECK(args[0]->IsUint32());
+  wrap->accept_batch_size_ = args[0].As<Uint32>()->Value();
+  if (wrap->accept_batch_size_ <= 1)
+    wrap->FlushConnections();
+}
+
+
+// Attach a classic BPF program to the SO_REUSEPORT group of the (bound)
+// socket that picks the listener whose index matches the CPU that received
+// the connection. The kernel falls back to its hash based selection when
+// there are fewer listeners than CPUs.
+void TCPWrap::SetReusePortCpuSteering(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&wrap->handle_), &fd);
+  if (err == 0) {
+    struct sock_filter code[] = {
+      { BPF_LD | BPF_W | BPF_ABS, 0, 0,
+        static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU) },
+      { BPF_RET | BPF_A, 0, 0, 0 },
+    };
+    struct sock_fprog prog = { arraysize(code), code };
+    if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF,
+                   &prog, sizeof(prog)) != 0) {
+      err = -errno;
+    }
+  }
+  args.GetReturnValue().Set(err);
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
+
+// Sets SO_RCVLOWAT, so that the socket is only reported readable once that
+// many bytes have been received, or at the end of input.
+void TCPWrap::SetRecvLowWatermark(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+  CHECK(args[0]->IsInt32());
+#if !defined(_WIN32) && defined(SO_RCVLOWAT)
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&wrap->handle_), &fd);
+  if (err == 0) {
+    int bytes = args[0].As<Int32>()->Value();
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVLOWAT, &bytes, sizeof(bytes)) != 0)
+      err = -errno;
+  }
+  args.GetReturnValue().Set(err);
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
+
+// Sends writes of at least that many bytes with MSG_ZEROCOPY, see
+// LibuvStreamWrap::SetZeroCopyThreshold().
+void TCPWrap::SetZeroCopyThreshold(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+  CHECK(args[0]->IsInt32());
+#ifdef __linux__
+  int threshold = args[0].As<Int32>()->Value();
+  CHECK_GE(threshold, 0);
+  args.GetReturnValue().Set(wrap->LibuvStreamWrap::SetZeroCopyThreshold(
+      static_cast<size_t>(threshold)));
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
+
+// Enables TCP Fast Open on a (bound) listening socket, with a queue of at
+// most that many pending Fast Open requests. On macOS the value only turns
+// the option on, and the queue length is a system setting.
+void TCPWrap::SetFastOpen(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+  CHECK(args[0]->IsInt32());
+#if !defined(_WIN32) && defined(TCP_FASTOPEN)
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&wrap->handle_), &fd);
+  if (err == 0) {
+    int qlen = args[0].As<Int32>()->Value();
+    if (setsockopt(fd, IPPROTO_TCP, TCP_FASTOPEN, &qlen, sizeof(qlen)) != 0)
+      err = -errno;
+  }
+  args.GetReturnValue().Set(err);
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
+
+// Makes the socket send the data of its first write along with the SYN when
+// it connects, if the kernel has a Fast Open cookie for the server. Without
+// one, the connection is made as usual.
+void TCPWrap::SetFastOpenConnect(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+#if defined(__linux__) && defined(TCP_FASTOPEN_CONNECT)
+  wrap->fast_open_connect_ = true;
+  args.GetReturnValue().Set(0);
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
+
+// The socket only exists once the handle is bound or connecting, so this
+// creates it if needed. connect() then returns right away, and the SYN goes
+// out with the first write. Errors are not fatal; they only mean that the
+// connection is made without Fast Open.
+void TCPWrap::EnableFastOpenConnect(int family) {
+#if defined(__linux__) && defined(TCP_FASTOPEN_CONNECT)
+  uv_os_fd_t fd;
+  if (uv_fileno(reinterpret_cast<uv_handle_t*>(&handle_), &fd) != 0) {
+    fd = socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+      return;
+    if (uv_tcp_open(&handle_, fd) != 0) {
+      close(fd);
+      return;
+    }
+  }
+  int on = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, &on, sizeof(on));
+#endif
+}
+
+
+// Sets TCP_DEFER_ACCEPT on a listening socket, so that connections are only
+// reported once data has arrived on them, or after about that many seconds.
+void TCPWrap::SetDeferAccept(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+  CHECK(args[0]->IsInt32());
+#if defined(__linux__) && defined(TCP_DEFER_ACCEPT)
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&wrap->handle_), &fd);
+  if (err == 0) {
+    int seconds = args[0].As<Int32>()->Value();
+    if (setsockopt(fd, IPPROTO_TCP, TCP_DEFER_ACCEPT,
+                   &seconds, sizeof(seconds)) != 0) {
+      err = -errno;
+    }
+  }
+  args.GetReturnValue().Set(err);
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
+
+void SetSocketBusyPoll(const FunctionCallbackInfo<Value>& args) {
+  HandleWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+  CHECK(args[0]->IsInt32());
+#if defined(__linux__) && defined(SO_BUSY_POLL)
+  uv_os_fd_t fd;
+  int err = uv_fileno(wrap->GetHandle(), &fd);
+  if (err == 0) {
+    int usec = args[0].As<Int32>()->Value();
+    if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec)) != 0)
+      err = -errno;
+  }
+  args.GetReturnValue().Set(err);
+#else
+  args.GetReturnValue().Set(UV_ENOTSUP);
+#endif
+}
+
+
 #ifdef _WIN32
 void TCPWrap::SetSimultaneousAccepts(const FunctionCallbackInfo<Value>& args) {
   TCPWrap* wrap;
@@ -236,7 +449,7 @@ void TCPWrap::Bind(
   int port;
   unsigned int flags = 0;
   if (!args[1]->Int32Value(env->context()).To(&port)) return;
-  if (family == AF_INET6 &&
+  if (!args[2]->IsUndefined() &&
       !args[2]->Uint32Value(env->context()).To(&flags)) {
     return;
   }
@@ -318,6 +531,10 @@ void TCPWrap::Connect(const FunctionCallbackInfo<Value>& args,
   int err = uv_ip_addr(*ip_address, &addr);
 
   if (err == 0) {
+    if (wrap->fast_open_connect_) {
+      wrap->EnableFastOpenConnect(
+          reinterpret_cast<const sockaddr*>(&addr)->sa_family);
+    }
     AsyncHooks::DefaultTriggerAsyncIdScope trigger_scope(wrap);
     ConnectWrap* req_wrap =
         new ConnectWrap(env, req_wrap_obj, AsyncWrap::PROVIDER_TCPCONNECTWRAP);
@@ -24,23 +24,57 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include "env-inl.h"
 #include "util-inl.h"
+#include "node_dtrace.h"
 #include "node_internals.h"
 
 namespace node {
 
+const char* ThreadPoolWork::PoolName(performance::ThreadPoolWorkKind kind) {
+  switch (kind) {
+    case performance::NODE_THREADPOOL_WORK_KIND_FS:
+      return "fs";
+    case performance::NODE_THREADPOOL_WORK_KIND_DNS:
+      return "dns";
+    case performance::NODE_THREADPOOL_WORK_KIND_ZLIB:
+      return "zlib";
+    case performance::NODE_THREADPOOL_WORK_KIND_CRYPTO:
+      return "crypto";
+    case performance::NODE_THREADPOOL_WORK_KIND_KDF:
+      return "kdf";
+    default:
+      return nullptr;
+  }
+}
+
 void ThreadPoolWork::ScheduleWork() {
   env_->IncreaseWaitingRequestCounter();
-  int status = uv_queue_work(
+  queued_at_ = env_->performance_state()->threadpool_monitored() ?
+      PERFORMANCE_NOW() : 0;
+  NODE_USDT_PROBE(THREADPOOL_ENQUEUE, this, PoolName(kind_));
+  int status = uv_queue_work_pool(
       env_->event_loop(),
       &work_req_,
+      PoolName(kind_),
       [](uv_work_t* req) {
         ThreadPoolWork* self = ContainerOf(&ThreadPoolWork::work_req_, req);
+        NODE_USDT_PROBE(THREADPOOL_START, self, PoolName(self->kind_));
+        if (self->queued_at_ != 0) self->started_at_ = PERFORMANCE_NOW();
         self->DoThreadPoolWork();
+        if (self->queued_at_ != 0) self->finished_at_ = PERFORMANCE_NOW();
       },
       [](uv_work_t* req, int status) {
         ThreadPoolWork* self = ContainerOf(&ThreadPoolWork::work_req_, req);
+        NODE_USDT_PROBE(THREADPOOL_DONE, self, PoolName(self->kind_), status);
         self->env_->DecreaseWaitingRequestCounter();
+        if (self->queued_at_ != 0 && status == 0) {
+          self->env_->performance_state()->RecordThreadPoolWork(
+              self->kind_,
+              self->queued_at_,
+              self->started_at_,
+              self->finished_at_);
+        }
         self->AfterThreadPoolWork(status);
       });
   CHECK_EQ(status, 0);
@@ -1,8 +1,14 @@
+#include "async_wrap-inl.h"
 #include "env-inl.h"
+#include "handle_wrap.h"
+#include "memory_tracker-inl.h"
 #include "util-inl.h"
 #include "v8.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 namespace node {
 namespace {
@@ -11,9 +17,13 @@ using v8::Array;
 using v8::Context;
 using v8::Function;
 using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::HandleScope;
 using v8::Integer;
 using v8::Local;
 using v8::Object;
+using v8::String;
+using v8::Uint32;
 using v8::Value;
 
 void SetupTimers(const FunctionCallbackInfo<Value>& args) {
@@ -43,12 +53,192 @@ void ToggleImmediateRef(const FunctionCallbackInfo<Value>& args) {
   Environment::GetCurrent(args)->ToggleImmediateRef(args[0]->IsTrue());
 }
 
+// A coarse hashed timer wheel that tracks many deadlines with a single
+// uv_timer_t. Entries are identified by small integer ids chosen by JS, and
+// deadlines are kept as plain tick numbers, so that arming or clearing an
+// entry never allocates a JS object. The timer only runs while at least one
+// entry is armed, and JS is only called when deadlines actually expire, with
+// all ids that expired during one tick passed to `ontimeout` at once.
+//
+// Deadlines are rounded up to the next tick, so entries never expire early
+// but may expire up to one `resolution` late.
+class TimerWheel : public HandleWrap {
+ public:
+  static constexpr size_t kSlotCount = 256;
+
+  static void Initialize(Environment* env, Local<Object> target) {
+    Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+    t->InstanceTemplate()->SetInternalFieldCount(1);
+    Local<String> name = FIXED_ONE_BYTE_STRING(env->isolate(), "TimerWheel");
+    t->SetClassName(name);
+    t->Inherit(HandleWrap::GetConstructorTemplate(env));
+
+    env->SetProtoMethod(t, "set", Set);
+    env->SetProtoMethod(t, "clear", Clear);
+
+    target->Set(env->context(), name,
+                t->GetFunction(env->context()).ToLocalChecked()).Check();
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("deadlines",
+                                deadlines_.capacity() * sizeof(uint64_t));
+    size_t slots_size = 0;
+    for (const std::vector<Entry>& slot : slots_)
+      slots_size += slot.capacity() * sizeof(Entry);
+    tracker->TrackFieldWithSize("slots", slots_size);
+  }
+
+  SET_MEMORY_INFO_NAME(TimerWheel)
+  SET_SELF_SIZE(TimerWheel)
+
+ private:
+  typedef std::pair<uint32_t, uint64_t> Entry;  // (id, tick)
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    CHECK(args.IsConstructCall());
+    CHECK(args[0]->IsUint32());
+    Environment* env = Environment::GetCurrent(args);
+    uint32_t resolution = args[0].As<Uint32>()->Value();
+    new TimerWheel(env, args.This(), std::max(resolution, 1u));
+  }
+
+  TimerWheel(Environment* env, Local<Object> object, uint64_t resolution)
+      : HandleWrap(env,
+                   object,
+                   reinterpret_cast<uv_handle_t*>(&timer_),
+                   AsyncWrap::PROVIDER_TIMERWHEEL),
+        resolution_(resolution) {
+    CHECK_EQ(uv_timer_init(env->event_loop(), &timer_), 0);
+  }
+
+  uint64_t NowTick() const {
+    return uv_now(env()->event_loop()) / resolution_;
+  }
+
+  // set(id, msecs): arms (or re-arms) the entry for |id|.
+  static void Set(const FunctionCallbackInfo<Value>& args) {
+    TimerWheel* wheel;
+    ASSIGN_OR_RETURN_UNWRAP(&wheel, args.Holder());
+    CHECK(args[0]->IsUint32());
+    CHECK(args[1]->IsUint32());
+    uint32_t id = args[0].As<Uint32>()->Value();
+    uint64_t msecs = args[1].As<Uint32>()->Value();
+
+    if (wheel->armed_ == 0) {
+      // Nothing was visited while the timer was stopped; start counting
+      // from the current tick again.
+      wheel->current_tick_ = wheel->NowTick();
+    }
+
+    uint64_t deadline = uv_now(wheel->env()->event_loop()) + msecs;
+    uint64_t tick = (deadline + wheel->resolution_ - 1) / wheel->resolution_;
+    tick = std::max(tick, wheel->current_tick_ + 1);
+
+    if (id >= wheel->deadlines_.size())
+      wheel->deadlines_.resize(id + 1, 0);
+    uint64_t& current = wheel->deadlines_[id];
+    if (current == tick)
+      return;
+    if (current == 0)
+      wheel->armed_++;
+    // A previous entry for |id| stays in its slot and is dropped lazily
+    // once it is visited and found not to match |current| anymore.
+    current = tick;
+    wheel->slots_[tick % kSlotCount].emplace_back(id, tick);
+
+    if (wheel->armed_ == 1 && !uv_is_active(wheel->GetHandle())) {
+      uv_timer_start(&wheel->timer_, OnTimeout,
+                     wheel->resolution_, wheel->resolution_);
+    }
+  }
+
+  // clear(id): disarms the entry for |id|, if it is armed.
+  static void Clear(const FunctionCallbackInfo<Value>& args) {
+    TimerWheel* wheel;
+    ASSIGN_OR_RETURN_UNWRAP(&wheel, args.Holder());
+    CHECK(args[0]->IsUint32());
+    uint32_t id = args[0].As<Uint32>()->Value();
+    if (id >= wheel->deadlines_.size() || wheel->deadlines_[id] == 0)
+      return;
+    wheel->deadlines_[id] = 0;
+    if (--wheel->armed_ == 0)
+      wheel->Stop();
+  }
+
+  void Stop() {
+    uv_timer_stop(&timer_);
+    // Everything left in the slots is stale at this point.
+    for (std::vector<Entry>& slot : slots_)
+      slot.clear();
+  }
+
+  static void OnTimeout(uv_timer_t* handle) {
+    TimerWheel* wheel = ContainerOf(&TimerWheel::timer_, handle);
+    wheel->Expire();
+  }
+
+  void Expire() {
+    uint64_t now_tick = NowTick();
+    if (now_tick <= current_tick_)
+      return;
+
+    // If the loop was blocked for longer than a full turn of the wheel,
+    // every slot has to be looked at once, but not more than once.
+    uint64_t steps = std::min<uint64_t>(now_tick - current_tick_, kSlotCount);
+    std::vector<Local<Value>> expired;
+    HandleScope handle_scope(env()->isolate());
+
+    for (uint64_t i = 1; i <= steps; i++) {
+      std::vector<Entry>& slot = slots_[(current_tick_ + i) % kSlotCount];
+      size_t kept = 0;
+      for (const Entry& entry : slot) {
+        if (deadlines_[entry.first] != entry.second)
+          continue;  // Cleared or re-armed since.
+        if (entry.second > now_tick) {
+          slot[kept++] = entry;  // Due in a later turn of the wheel.
+          continue;
+        }
+        deadlines_[entry.first] = 0;
+        armed_--;
+        expired.push_back(Integer::NewFromUnsigned(env()->isolate(),
+                                                   entry.first));
+      }
+      slot.resize(kept);
+    }
+    current_tick_ = now_tick;
+
+    if (armed_ == 0)
+      Stop();
+    if (expired.empty())
+      return;
+
+    Context::Scope context_scope(env()->context());
+    Local<Value> arg = Array::New(env()->isolate(),
+                                  expired.data(),
+                                  expired.size());
+    MakeCallback(env()->ontimeout_string(), 1, &arg);
+  }
+
+  uv_timer_t timer_;
+  const uint64_t resolution_;
+  uint64_t current_tick_ = 0;
+  size_t armed_ = 0;
+  // The tick at which each id expires, or 0 if it is not armed.
+  std::vector<uint64_t> deadlines_;
+  std::vector<Entry> slots_[kSlotCount];
+};
+
+constexpr size_t TimerWheel::kSlotCount;
+
 void Initialize(Local<Object> target,
                        Local<Value> unused,
                        Local<Context> context,
                        void* priv) {
   Environment* env = Environment::GetCurrent(context);
 
+  TimerWheel::Initialize(env, target);
+
   env->SetMethod(target, "getLibuvNow", GetLibuvNow);
   env->SetMethod(target, "setupTimers", SetupTimers);
   env->SetMethod(target, "scheduleTimer", ScheduleTimer);
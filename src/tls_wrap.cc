@@ -32,6 +32,32 @@
 #include "stream_base-inl.h"
 #include "util-inl.h"
 
+#include <openssl/kdf.h>
+
+// Kernel TLS transmit offload, Linux 4.13+. The TLS 1.2 keys are derived
+// here because the bundled OpenSSL doesn't hand them out itself.
+#if defined(__linux__) && defined(__has_include)
+# if __has_include(<linux/tls.h>)
+#  include <linux/tls.h>
+#  include <netinet/tcp.h>
+#  include <sys/socket.h>
+#  include <cerrno>
+#  define HAVE_KTLS 1
+# endif
+#endif
+#ifndef HAVE_KTLS
+# define HAVE_KTLS 0
+#endif
+
+#if HAVE_KTLS
+# ifndef TCP_ULP
+#  define TCP_ULP 31
+# endif
+# ifndef SOL_TLS
+#  define SOL_TLS 282
+# endif
+#endif
+
 namespace node {
 
 using crypto::SecureContext;
@@ -506,6 +532,25 @@ void TLSWrap::ClearOut() {
   char out[kClearOutChunkSize];
   int read;
   for (;;) {
+    // When it's known how much clear text the next SSL_read() returns,
+    // decrypt straight into memory provided by the stream listener. That
+    // saves the copy out of `out` and sizes the buffer to the record.
+    const size_t size = PendingClearTextSize();
+    if (size != 0) {
+      uv_buf_t buf = EmitAlloc(size);
+      read = SSL_read(ssl_.get(), buf.base, buf.len);
+      Debug(this, "Read %d bytes of cleartext output in place", read);
+      // Emitting 0 bytes hands the buffer back to the listener.
+      EmitRead(read > 0 ? read : 0, buf);
+      if (ssl_ == nullptr) {
+        Debug(this, "Returning from read loop, ssl_ == nullptr");
+        return;
+      }
+      if (read <= 0)
+        break;
+      continue;
+    }
+
     read = SSL_read(ssl_.get(), out, sizeof(out));
     Debug(this, "Read %d bytes of cleartext output", read);
 
@@ -535,6 +580,12 @@ void TLSWrap::ClearOut() {
     }
   }
 
+  // With kTLS, whatever OpenSSL writes in response to the records it read
+  // (e.g. refusing a renegotiation) was encrypted with stale keys and can't
+  // go out on the wire.
+  if (ktls_state_ == kKTLSEnabled)
+    crypto::NodeBIO::FromBIO(SSL_get_wbio(ssl_.get()))->Reset();
+
   int flags = SSL_get_shutdown(ssl_.get());
   if (!eof_ && flags & SSL_RECEIVED_SHUTDOWN) {
     eof_ = true;
@@ -566,6 +617,39 @@ void TLSWrap::ClearOut() {
 }
 
 
+size_t TLSWrap::PendingClearTextSize() {
+  if (!SSL_is_init_finished(ssl_.get()))
+    return 0;
+
+  // The rest of a record that was decrypted already.
+  const int pending = SSL_pending(ssl_.get());
+  if (pending > 0)
+    return pending;
+
+  // Part of a record is buffered inside OpenSSL, its size is unknown.
+  if (SSL_has_pending(ssl_.get()))
+    return 0;
+
+  // Otherwise enc_in_ starts with the header of the next record. Only go by
+  // it once the whole record is in, the clear text can't be larger than the
+  // ciphertext.
+  crypto::NodeBIO* enc_in = crypto::NodeBIO::FromBIO(enc_in_);
+  size_t avail = 0;
+  const unsigned char* header =
+      reinterpret_cast<const unsigned char*>(enc_in->Peek(&avail));
+  if (avail < SSL3_RT_HEADER_LENGTH ||
+      header[0] != SSL3_RT_APPLICATION_DATA) {
+    return 0;
+  }
+
+  const size_t length = (header[3] << 8) | header[4];
+  if (enc_in->Length() < SSL3_RT_HEADER_LENGTH + length)
+    return 0;
+
+  return std::min<size_t>(length, kClearOutChunkSize);
+}
+
+
 void TLSWrap::ClearIn() {
   Debug(this, "Trying to write cleartext input");
   // Ignore cycling data if ClientHello wasn't yet parsed
@@ -584,10 +668,15 @@ void TLSWrap::ClearIn() {
     return;
   }
 
+  if (!ReadyForCleartext()) {
+    Debug(this, "Returning from ClearIn(), waiting to switch to kTLS");
+    return;
+  }
+
   AllocatedBuffer data = std::move(pending_cleartext_input_);
   crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
 
-  int written = SSL_write(ssl_.get(), data.data(), data.size());
+  int written = WriteCleartext(data.data(), data.size());
   Debug(this, "Writing %zu bytes, written = %d", data.size(), written);
   CHECK(written == -1 || written == static_cast<int>(data.size()));
 
@@ -619,6 +708,228 @@ void TLSWrap::ClearIn() {
 }
 
 
+bool TLSWrap::ReadyForCleartext() {
+  if (ktls_state_ != kKTLSPending || !established_)
+    return true;
+
+  // The kernel takes over at a record boundary: everything OpenSSL encrypted
+  // during the handshake has to reach the underlying stream first.
+  if (write_size_ != 0 || BIO_pending(enc_out_) != 0)
+    return false;
+
+  ktls_state_ = StartKTLS() ? kKTLSEnabled : kKTLSOff;
+  Debug(this, "kTLS %s", ktls_state_ == kKTLSEnabled ? "enabled" : "disabled");
+  return true;
+}
+
+
+#if HAVE_KTLS
+// TLS 1.2 AEAD records carry the sequence number as the explicit nonce. The
+// Finished message was the first record sent with the new keys, the kernel
+// continues with the second one.
+static const unsigned char kKTLSRecordSeq[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+template <typename T>
+static socklen_t InitKTLSCryptoInfo(T* info,
+                                    uint16_t cipher_type,
+                                    const unsigned char* key,
+                                    const unsigned char* salt) {
+  info->info.version = TLS_1_2_VERSION;
+  info->info.cipher_type = cipher_type;
+  memcpy(info->key, key, sizeof(info->key));
+  memcpy(info->salt, salt, sizeof(info->salt));
+  memcpy(info->iv, kKTLSRecordSeq, sizeof(info->iv));
+  memcpy(info->rec_seq, kKTLSRecordSeq, sizeof(info->rec_seq));
+  return sizeof(*info);
+}
+#endif  // HAVE_KTLS
+
+
+bool TLSWrap::StartKTLS() {
+#if HAVE_KTLS
+  SSL* ssl = ssl_.get();
+  if (SSL_version(ssl) != TLS1_2_VERSION)
+    return false;
+
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (cipher == nullptr)
+    return false;
+
+  uint16_t cipher_type;
+  size_t key_len;
+  switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+    case NID_aes_128_gcm:
+      cipher_type = TLS_CIPHER_AES_GCM_128;
+      key_len = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+      break;
+#ifdef TLS_CIPHER_AES_GCM_256
+    case NID_aes_256_gcm:
+      cipher_type = TLS_CIPHER_AES_GCM_256;
+      key_len = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+      break;
+#endif
+    default:
+      return false;
+  }
+
+  const int fd = GetFD();
+  if (fd < 0)
+    return false;
+
+  // The key block (RFC 5246, section 6.3) of an AEAD cipher suite holds the
+  // client and server write keys, followed by the implicit nonce parts.
+  static const char kLabel[] = "key expansion";
+  static const size_t kSaltLen = TLS_CIPHER_AES_GCM_128_SALT_SIZE;
+  unsigned char master_key[SSL_MAX_MASTER_KEY_LENGTH];
+  unsigned char randoms[2 * SSL3_RANDOM_SIZE];
+  unsigned char key_block[2 * 32 + 2 * kSaltLen];
+  size_t key_block_len = 2 * key_len + 2 * kSaltLen;
+  CHECK_LE(key_block_len, sizeof(key_block));
+
+  const size_t master_key_len =
+      SSL_SESSION_get_master_key(SSL_get_session(ssl),
+                                 master_key,
+                                 sizeof(master_key));
+  SSL_get_server_random(ssl, randoms, SSL3_RANDOM_SIZE);
+  SSL_get_client_random(ssl, randoms + SSL3_RANDOM_SIZE, SSL3_RANDOM_SIZE);
+
+  crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
+  crypto::EVPKeyCtxPointer pctx(EVP_PKEY_CTX_new_id(EVP_PKEY_TLS1_PRF,
+                                                    nullptr));
+  bool ok =
+      pctx &&
+      EVP_PKEY_derive_init(pctx.get()) > 0 &&
+      EVP_PKEY_CTX_set_tls1_prf_md(
+          pctx.get(), SSL_CIPHER_get_handshake_digest(cipher)) > 0 &&
+      EVP_PKEY_CTX_set1_tls1_prf_secret(
+          pctx.get(), master_key, master_key_len) > 0 &&
+      EVP_PKEY_CTX_add1_tls1_prf_seed(
+          pctx.get(), kLabel, sizeof(kLabel) - 1) > 0 &&
+      EVP_PKEY_CTX_add1_tls1_prf_seed(
+          pctx.get(), randoms, sizeof(randoms)) > 0 &&
+      EVP_PKEY_derive(pctx.get(), key_block, &key_block_len) > 0;
+  OPENSSL_cleanse(master_key, sizeof(master_key));
+
+  if (ok) {
+    const bool server = is_server();
+    const unsigned char* key = key_block + (server ? key_len : 0);
+    const unsigned char* salt =
+        key_block + 2 * key_len + (server ? kSaltLen : 0);
+
+    union {
+      tls12_crypto_info_aes_gcm_128 aes_gcm_128;
+#ifdef TLS_CIPHER_AES_GCM_256
+      tls12_crypto_info_aes_gcm_256 aes_gcm_256;
+#endif
+    } crypto_info;
+    socklen_t crypto_info_len;
+    memset(&crypto_info, 0, sizeof(crypto_info));
+#ifdef TLS_CIPHER_AES_GCM_256
+    if (cipher_type == TLS_CIPHER_AES_GCM_256) {
+      crypto_info_len = InitKTLSCryptoInfo(&crypto_info.aes_gcm_256,
+                                           cipher_type, key, salt);
+    } else  // NOLINT(readability/braces)
+#endif
+    {
+      crypto_info_len = InitKTLSCryptoInfo(&crypto_info.aes_gcm_128,
+                                           cipher_type, key, salt);
+    }
+
+    // Without the tls module loaded the first call fails and nothing
+    // changes. A socket with the ULP but no keys behaves like a plain one.
+    ok = setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) == 0 &&
+         setsockopt(fd, SOL_TLS, TLS_TX, &crypto_info, crypto_info_len) == 0;
+    OPENSSL_cleanse(&crypto_info, sizeof(crypto_info));
+  }
+  OPENSSL_cleanse(key_block, sizeof(key_block));
+
+  if (!ok)
+    return false;
+
+  // OpenSSL's write side is done with. Whatever it still produces goes into
+  // a BIO of its own that is never flushed, enc_out_ takes clear text now.
+  CHECK_EQ(BIO_up_ref(enc_out_), 1);
+  ktls_enc_out_.reset(enc_out_);
+  SSL_set0_wbio(ssl, crypto::NodeBIO::New(env()).release());
+  SSL_set_options(ssl, SSL_OP_NO_RENEGOTIATION);
+  return true;
+#else
+  return false;
+#endif  // HAVE_KTLS
+}
+
+
+void TLSWrap::SendKTLSCloseNotify() {
+#if HAVE_KTLS
+  // Don't let the alert overtake application data that is still queued.
+  if (write_size_ != 0 || BIO_pending(enc_out_) != 0)
+    return;
+
+  const int fd = GetFD();
+  if (fd < 0)
+    return;
+
+  unsigned char alert[] = { SSL3_AL_WARNING, SSL_AD_CLOSE_NOTIFY };
+  constexpr size_t kControlSize = CMSG_SPACE(sizeof(unsigned char));
+  union {
+    char buf[kControlSize];
+    struct cmsghdr align;
+  } control;
+  struct iovec iov = { alert, sizeof(alert) };
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof(control.buf);
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(unsigned char));
+  *CMSG_DATA(cmsg) = SSL3_RT_ALERT;
+
+  // Best effort, as is the close_notify alert that OpenSSL sends.
+  ssize_t r;
+  do {
+    r = sendmsg(fd, &msg, MSG_NOSIGNAL);
+  } while (r == -1 && errno == EINTR);
+  Debug(this, "Sent close_notify through kTLS, r = %zd", r);
+#endif  // HAVE_KTLS
+}
+
+
+int TLSWrap::WriteCleartext(const char* data, size_t length) {
+  if (ktls_state_ != kKTLSEnabled) {
+    if (dynamic_record_size_)
+      AdjustRecordSize(length);
+    return SSL_write(ssl_.get(), data, length);
+  }
+
+  crypto::NodeBIO::FromBIO(enc_out_)->Write(data, length);
+  return static_cast<int>(length);
+}
+
+
+void TLSWrap::AdjustRecordSize(size_t length) {
+  const uint64_t now = uv_now(env()->event_loop());
+  if (now - last_cleartext_write_ >= kDynamicRecordIdleTimeout)
+    bytes_since_idle_ = 0;
+  last_cleartext_write_ = now;
+
+  // SSL_write() is all or nothing, so a write that does not fit into what is
+  // left of the small record budget uses full size records as a whole.
+  int size = max_send_fragment_;
+  if (bytes_since_idle_ + length <= kDynamicRecordBoostThreshold &&
+      size > kDynamicRecordSmallSize) {
+    size = kDynamicRecordSmallSize;
+  }
+  bytes_since_idle_ += length;
+
+  SSL_set_max_send_fragment(ssl_.get(), size);
+}
+
+
 std::string TLSWrap::diagnostic_name() const {
   std::string name = "TLSWrap ";
   if (is_server())
@@ -746,18 +1057,21 @@ int TLSWrap::DoWrite(WriteWrap* w,
   AllocatedBuffer data;
   crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
 
+  // Hold on to the data while the switch to kTLS is pending.
+  const bool deferred = !ReadyForCleartext();
+
   int written = 0;
-  if (count != 1) {
+  if (count != 1 || deferred) {
     data = env()->AllocateManaged(length);
     size_t offset = 0;
     for (i = 0; i < count; i++) {
       memcpy(data.data() + offset, bufs[i].base, bufs[i].len);
       offset += bufs[i].len;
     }
-    written = SSL_write(ssl_.get(), data.data(), length);
+    written = deferred ? -1 : WriteCleartext(data.data(), length);
   } else {
     // Only one buffer: try to write directly, only store if it fails
-    written = SSL_write(ssl_.get(), bufs[0].base, bufs[0].len);
+    written = WriteCleartext(bufs[0].base, bufs[0].len);
     if (written == -1) {
       data = env()->AllocateManaged(length);
       memcpy(data.data(), bufs[0].base, bufs[0].len);
@@ -769,7 +1083,9 @@ int TLSWrap::DoWrite(WriteWrap* w,
 
   if (written == -1) {
     int err;
-    Local<Value> arg = GetSSLError(written, &err, &error_);
+    Local<Value> arg;
+    if (!deferred)
+      arg = GetSSLError(written, &err, &error_);
 
     // If we stopped writing because of an error, it's fatal, discard the data.
     if (!arg.IsEmpty()) {
@@ -856,7 +1172,9 @@ int TLSWrap::DoShutdown(ShutdownWrap* req_wrap) {
   Debug(this, "DoShutdown()");
   crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
 
-  if (ssl_ && SSL_shutdown(ssl_.get()) == 0)
+  if (ktls_state_ == kKTLSEnabled)
+    SendKTLSCloseNotify();
+  else if (ssl_ && SSL_shutdown(ssl_.get()) == 0)
     SSL_shutdown(ssl_.get());
 
   shutdown_ = true;
@@ -958,6 +1276,29 @@ void TLSWrap::EnableTrace(
 #endif
 }
 
+void TLSWrap::EnableKTLS(const FunctionCallbackInfo<Value>& args) {
+  TLSWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+
+  // The switch happens before the first clear text is written after the
+  // handshake; when the connection doesn't qualify, nothing changes.
+  if (HAVE_KTLS && wrap->ktls_state_ == kKTLSOff && !wrap->established_)
+    wrap->ktls_state_ = kKTLSPending;
+}
+
+void TLSWrap::EnableDynamicRecordSize(
+    const FunctionCallbackInfo<Value>& args) {
+  TLSWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  wrap->dynamic_record_size_ = true;
+}
+
+void TLSWrap::IsKTLSEnabled(const FunctionCallbackInfo<Value>& args) {
+  TLSWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  args.GetReturnValue().Set(wrap->ktls_state_ == kKTLSEnabled);
+}
+
 void TLSWrap::DestroySSL(const FunctionCallbackInfo<Value>& args) {
   TLSWrap* wrap;
   ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
@@ -973,6 +1314,7 @@ void TLSWrap::DestroySSL(const FunctionCallbackInfo<Value>& args) {
   wrap->SSLWrap<TLSWrap>::DestroySSL();
   wrap->enc_in_ = nullptr;
   wrap->enc_out_ = nullptr;
+  wrap->ktls_enc_out_.reset();
 
   if (wrap->stream_ != nullptr)
     wrap->stream_->RemoveStreamListener(wrap);
@@ -1054,6 +1396,16 @@ int TLSWrap::SelectSNIContextCallback(SSL* s, int* ad, void* arg) {
     return SSL_TLSEXT_ERR_NOACK;
   }
 
+  // Contexts that were added with server.addContext() are selected here,
+  // without waiting for the SNICallback, see loadSNI() in lib/_tls_wrap.js.
+  crypto::SecureContext* sni_context = p->sc_->FindSNIContext(servername);
+  if (sni_context != nullptr &&
+      !object->Set(env->context(),
+                   env->sni_context_string(),
+                   sni_context->object()).FromMaybe(false)) {
+    return SSL_TLSEXT_ERR_NOACK;
+  }
+
   if (!object->Get(env->context(), env->sni_context_string()).ToLocal(&ctx))
     return SSL_TLSEXT_ERR_NOACK;
 
@@ -1242,6 +1594,7 @@ void TLSWrap::Initialize(Local<Object> target,
   env->SetMethod(target, "wrap", TLSWrap::Wrap);
 
   NODE_DEFINE_CONSTANT(target, HAVE_SSL_TRACE);
+  NODE_DEFINE_CONSTANT(target, HAVE_KTLS);
 
   Local<FunctionTemplate> t = BaseObject::MakeLazilyInitializedJSTemplate(env);
   Local<String> tlsWrapString =
@@ -1268,6 +1621,9 @@ void TLSWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "enableSessionCallbacks", EnableSessionCallbacks);
   env->SetProtoMethod(t, "enableKeylogCallback", EnableKeylogCallback);
   env->SetProtoMethod(t, "enableTrace", EnableTrace);
+  env->SetProtoMethod(t, "enableKTLS", EnableKTLS);
+  env->SetProtoMethod(t, "enableDynamicRecordSize", EnableDynamicRecordSize);
+  env->SetProtoMethod(t, "isKTLSEnabled", IsKTLSEnabled);
   env->SetProtoMethod(t, "destroySSL", DestroySSL);
   env->SetProtoMethod(t, "enableCertCb", EnableCertCb);
 
@@ -125,6 +125,34 @@ class TLSWrap : public AsyncWrap,
   void EncOut();  // Write encrypted data from enc_out_ to underlying stream.
   void ClearIn();  // SSL_write() clear data "in" to SSL.
   void ClearOut();  // SSL_read() clear text "out" from SSL.
+  // Size of the clear text that the next SSL_read() returns, or 0 when that
+  // isn't known up front.
+  size_t PendingClearTextSize();
+
+  // Kernel TLS. Once the handshake is done, records are encrypted by the
+  // kernel and the clear text is written to the underlying stream as is.
+  enum KTLSState { kKTLSOff, kKTLSPending, kKTLSEnabled };
+  // Returns false while the switch to kTLS has to wait for the handshake
+  // output to be flushed, clear text must not be passed on until then.
+  bool ReadyForCleartext();
+  bool StartKTLS();
+  void SendKTLSCloseNotify();
+  // SSL_write() or, with kTLS, a plain copy to enc_out_.
+  int WriteCleartext(const char* data, size_t length);
+
+  // Dynamic record sizing. Clear text is sent in records that fit into a
+  // single TCP segment until kDynamicRecordBoostThreshold bytes were sent,
+  // so that the peer can decrypt the first bytes without waiting for a full
+  // 16 KB record. After kDynamicRecordIdleTimeout ms without writes, the
+  // connection starts over with small records.
+  static const int kDynamicRecordSmallSize = 1369;
+  static const size_t kDynamicRecordBoostThreshold =
+      40 * kDynamicRecordSmallSize;
+  static const uint64_t kDynamicRecordIdleTimeout = 1000;
+  // Picks the record size for a write of |length| bytes of clear text.
+  void AdjustRecordSize(size_t length);
+  static void EnableDynamicRecordSize(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
 
   // Call Done() on outstanding WriteWrap request.
   bool InvokeQueued(int status, const char* error_str = nullptr);
@@ -163,6 +191,8 @@ class TLSWrap : public AsyncWrap,
   static void EnableKeylogCallback(
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void EnableTrace(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void EnableKTLS(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void IsKTLSEnabled(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void EnableCertCb(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void DestroySSL(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetServername(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -202,6 +232,12 @@ class TLSWrap : public AsyncWrap,
   bool shutdown_ = false;
   std::string error_;
   int cycle_depth_ = 0;
+  KTLSState ktls_state_ = kKTLSOff;
+  // Keeps enc_out_ alive after kTLS took it away from OpenSSL.
+  crypto::BIOPointer ktls_enc_out_;
+  bool dynamic_record_size_ = false;
+  size_t bytes_since_idle_ = 0;
+  uint64_t last_cleartext_write_ = 0;
 
   // If true - delivered EOF to the js-land, either after `close_notify`, or
   // after the `UV_EOF` on socket.
@@ -49,7 +49,9 @@ using v8::platform::tracing::TraceConfig;
 using v8::platform::tracing::TraceWriter;
 using std::string;
 
-Agent::Agent() : tracing_controller_(new TracingController()) {
+Agent::Agent(bool flight_recorder)
+    : flight_recorder_(flight_recorder),
+      tracing_controller_(new TracingController()) {
   tracing_controller_->Initialize(nullptr);
 
   CHECK_EQ(uv_loop_init(&tracing_loop_), 0);
@@ -87,8 +89,8 @@ void Agent::Start() {
   if (started_)
     return;
 
-  NodeTraceBuffer* trace_buffer_ = new NodeTraceBuffer(
-      NodeTraceBuffer::kBufferChunks, this, &tracing_loop_);
+  trace_buffer_ = new NodeTraceBuffer(
+      NodeTraceBuffer::kBufferChunks, this, &tracing_loop_, flight_recorder_);
   tracing_controller_->Initialize(trace_buffer_);
 
   // This thread should be created *after* async handles are created
@@ -145,6 +147,7 @@ void Agent::StopTracing() {
   // to flush the buffer again on destruction of the V8::Platform.
   tracing_controller_->StopTracing();
   tracing_controller_->Initialize(nullptr);
+  trace_buffer_ = nullptr;
   started_ = false;
 
   // Thread should finish when the tracing loop is stopped.
@@ -212,6 +215,11 @@ void Agent::AddMetadataEvent(std::unique_ptr<TraceObject> event) {
   metadata_events_.push_back(std::move(event));
 }
 
+void Agent::DumpTraceBuffer() {
+  if (trace_buffer_ != nullptr)
+    trace_buffer_->Dump();
+}
+
 void Agent::Flush(bool blocking) {
   {
     Mutex::ScopedLock lock(metadata_events_mutex_);
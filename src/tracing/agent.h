@@ -23,6 +23,7 @@ using v8::platform::tracing::TraceConfig;
 using v8::platform::tracing::TraceObject;
 
 class Agent;
+class NodeTraceBuffer;
 
 class AsyncTraceWriter {
  public:
@@ -83,7 +84,9 @@ class AgentWriterHandle {
 
 class Agent {
  public:
-  Agent();
+  // In flight recorder mode, trace events are only kept in memory, and are
+  // written when DumpTraceBuffer() is called.
+  explicit Agent(bool flight_recorder = false);
   ~Agent();
 
   TracingController* GetTracingController() {
@@ -115,6 +118,9 @@ class Agent {
   void AddMetadataEvent(std::unique_ptr<TraceObject> event);
   // Flushes all writers registered through AddClient().
   void Flush(bool blocking);
+  // Writes the events that are in the trace buffer, which is mostly useful in
+  // flight recorder mode.
+  void DumpTraceBuffer();
 
   TraceConfig* CreateTraceConfig() const;
 
@@ -134,6 +140,9 @@ class Agent {
   uv_loop_t tracing_loop_;
 
   bool started_ = false;
+  const bool flight_recorder_;
+  // Owned by tracing_controller_ while tracing is started.
+  NodeTraceBuffer* trace_buffer_ = nullptr;
   class ScopedSuspendTracing;
 
   // Each individual Writer has one id.
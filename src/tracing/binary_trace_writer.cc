@@ -0,0 +1,152 @@
+#include "tracing/binary_trace_writer.h"
+
+#include "tracing/trace_event_common.h"
+#include "util.h"
+
+#include <cstring>
+#include <memory>
+
+namespace node {
+namespace tracing {
+
+using v8::platform::tracing::TracingController;
+
+namespace {
+
+constexpr char kMagic[] = "NODETRC1";
+
+void AppendVarint(std::string* out, uint64_t value) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+void AppendZigZag(std::string* out, int64_t value) {
+  AppendVarint(out, (static_cast<uint64_t>(value) << 1) ^
+                    static_cast<uint64_t>(value >> 63));
+}
+
+void AppendBytes(std::string* out, const char* data, size_t length) {
+  AppendVarint(out, length);
+  out->append(data, length);
+}
+
+}  // anonymous namespace
+
+BinaryTraceWriter::BinaryTraceWriter(std::ostream& stream) : stream_(stream) {
+  stream_.write(kMagic, sizeof(kMagic) - 1);
+}
+
+uint64_t BinaryTraceWriter::InternString(const char* str) {
+  auto it = strings_.find(str);
+  if (it != strings_.end())
+    return it->second;
+
+  // Ids start at 1, so that 0 can stand for a missing string.
+  const uint64_t id = strings_.size() + 1;
+  strings_.emplace(str, id);
+  std::string record(1, kString);
+  AppendVarint(&record, id);
+  record.append(str);
+  WriteRecord(record);
+  return id;
+}
+
+void BinaryTraceWriter::WriteRecord(const std::string& payload) {
+  std::string size;
+  AppendVarint(&size, payload.size());
+  stream_.write(size.data(), size.size());
+  stream_.write(payload.data(), payload.size());
+}
+
+void BinaryTraceWriter::AppendTraceEvent(TraceObject* trace_event) {
+  // Strings need to be interned before the event, so that their records are
+  // written first.
+  const uint64_t category = InternString(
+      TracingController::GetCategoryGroupName(
+          trace_event->category_enabled_flag()));
+  const uint64_t name = InternString(trace_event->name());
+  const int num_args = trace_event->num_args();
+  const char** arg_names = trace_event->arg_names();
+  uint64_t arg_name_ids[2];
+  CHECK_LE(static_cast<size_t>(num_args), arraysize(arg_name_ids));
+  for (int i = 0; i < num_args; i++)
+    arg_name_ids[i] = InternString(arg_names[i]);
+  const unsigned int flags = trace_event->flags();
+  const uint64_t scope =
+      (flags & TRACE_EVENT_FLAG_HAS_ID) && trace_event->scope() != nullptr ?
+          InternString(trace_event->scope()) : 0;
+
+  std::string* out = &event_;
+  out->clear();
+  out->push_back(kEvent);
+  out->push_back(trace_event->phase());
+  AppendVarint(out, category);
+  AppendVarint(out, name);
+  AppendZigZag(out, trace_event->pid());
+  AppendZigZag(out, trace_event->tid());
+  AppendZigZag(out, trace_event->ts());
+  AppendZigZag(out, trace_event->tts());
+  AppendZigZag(out, trace_event->duration());
+  AppendZigZag(out, trace_event->cpu_duration());
+  AppendVarint(out, flags);
+  if (flags & (TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT))
+    AppendVarint(out, trace_event->bind_id());
+  if (flags & TRACE_EVENT_FLAG_HAS_ID) {
+    AppendVarint(out, scope);
+    AppendVarint(out, trace_event->id());
+  }
+
+  AppendVarint(out, num_args);
+  const uint8_t* arg_types = trace_event->arg_types();
+  TraceObject::ArgValue* arg_values = trace_event->arg_values();
+  std::unique_ptr<v8::ConvertableToTraceFormat>* arg_convertables =
+      trace_event->arg_convertables();
+  for (int i = 0; i < num_args; i++) {
+    AppendVarint(out, arg_name_ids[i]);
+    out->push_back(arg_types[i]);
+    const TraceObject::ArgValue& value = arg_values[i];
+    switch (arg_types[i]) {
+      case TRACE_VALUE_TYPE_BOOL:
+        out->push_back(value.as_bool ? 1 : 0);
+        break;
+      case TRACE_VALUE_TYPE_UINT:
+        AppendVarint(out, value.as_uint);
+        break;
+      case TRACE_VALUE_TYPE_INT:
+        AppendZigZag(out, value.as_int);
+        break;
+      case TRACE_VALUE_TYPE_DOUBLE: {
+        uint64_t bits;
+        memcpy(&bits, &value.as_double, sizeof(bits));
+        for (int j = 0; j < 8; j++)
+          out->push_back(static_cast<char>(bits >> (j * 8)));
+        break;
+      }
+      case TRACE_VALUE_TYPE_POINTER:
+        AppendVarint(out, reinterpret_cast<uintptr_t>(value.as_pointer));
+        break;
+      case TRACE_VALUE_TYPE_STRING:
+      case TRACE_VALUE_TYPE_COPY_STRING: {
+        const char* str =
+            value.as_string != nullptr ? value.as_string : "nullptr";
+        AppendBytes(out, str, strlen(str));
+        break;
+      }
+      case TRACE_VALUE_TYPE_CONVERTABLE: {
+        std::string json;
+        arg_convertables[i]->AppendAsTraceFormat(&json);
+        AppendBytes(out, json.data(), json.size());
+        break;
+      }
+      default:
+        UNREACHABLE();
+    }
+  }
+  WriteRecord(*out);
+}
+
+}  // namespace tracing
+}  // namespace node
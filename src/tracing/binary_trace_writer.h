@@ -0,0 +1,62 @@
+#ifndef SRC_TRACING_BINARY_TRACE_WRITER_H_
+#define SRC_TRACING_BINARY_TRACE_WRITER_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "libplatform/v8-tracing.h"
+
+namespace node {
+namespace tracing {
+
+using v8::platform::tracing::TraceObject;
+using v8::platform::tracing::TraceWriter;
+
+// Serializes trace events into a compact binary format, which is much cheaper
+// to produce than JSON. tools/binary-trace-to-json.js converts it into the
+// JSON trace format.
+//
+// A file starts with the magic "NODETRC1", followed by records. Every record
+// is a varint with the size of its payload, followed by the payload, whose
+// first byte is the type of the record:
+//
+//   kString: varint id, the bytes of the string
+//   kEvent:  phase byte, varint category, varint name, zigzag pid, zigzag tid,
+//            zigzag ts, zigzag tts, zigzag dur, zigzag tdur, varint flags,
+//            [varint bind_id if flags has FLOW_IN or FLOW_OUT],
+//            [varint scope, varint id if flags has HAS_ID],
+//            varint argument count, and for each argument:
+//            varint name, type byte (TRACE_VALUE_TYPE_*), value
+//
+// Names, categories and scopes refer to kString records that come earlier in
+// the same file, and a scope of 0 means that there is none. Argument values
+// are a byte for booleans, 8 little-endian bytes for doubles, a zigzag varint
+// for signed integers, a varint for other numbers, and a varint length
+// followed by the bytes for strings and convertables (which are JSON).
+class BinaryTraceWriter : public TraceWriter {
+ public:
+  enum RecordType : uint8_t { kString = 1, kEvent = 2 };
+
+  explicit BinaryTraceWriter(std::ostream& stream);
+
+  void AppendTraceEvent(TraceObject* trace_event) override;
+  void Flush() override {}
+
+ private:
+  // Returns the id of `str`, and writes a kString record for it first if it
+  // has not been written to this file yet.
+  uint64_t InternString(const char* str);
+  void WriteRecord(const std::string& payload);
+
+  std::ostream& stream_;
+  // Reused for the payload of every event.
+  std::string event_;
+  std::unordered_map<std::string, uint64_t> strings_;
+};
+
+}  // namespace tracing
+}  // namespace node
+
+#endif  // SRC_TRACING_BINARY_TRACE_WRITER_H_
@@ -1,5 +1,6 @@
 #include "tracing/node_trace_buffer.h"
 
+#include <atomic>
 #include <memory>
 #include "util-inl.h"
 
@@ -7,100 +8,103 @@ namespace node {
 namespace tracing {
 
 InternalTraceBuffer::InternalTraceBuffer(size_t max_chunks, uint32_t id,
-                                         Agent* agent)
-    : flushing_(false), max_chunks_(max_chunks),
-      agent_(agent), id_(id) {
-  chunks_.resize(max_chunks);
-}
+                                         bool ring)
+    : max_chunks_(max_chunks), id_(id), ring_(ring) {}
 
-TraceObject* InternalTraceBuffer::AddTraceEvent(uint64_t* handle) {
+TraceObject* InternalTraceBuffer::AddTraceEvent(uint64_t* handle,
+                                                bool* needs_flush) {
   Mutex::ScopedLock scoped_lock(mutex_);
-  // Create new chunk if last chunk is full or there is no chunk.
-  if (total_chunks_ == 0 || chunks_[total_chunks_ - 1]->IsFull()) {
-    auto& chunk = chunks_[total_chunks_++];
-    if (chunk) {
+  // Start a new chunk if the last chunk is full or there is no chunk.
+  if (chunks_.empty() || chunks_.back()->IsFull()) {
+    std::unique_ptr<TraceBufferChunk> chunk;
+    if (!free_chunks_.empty()) {
+      chunk = std::move(free_chunks_.back());
+      free_chunks_.pop_back();
       chunk->Reset(current_chunk_seq_++);
-    } else {
+    } else if (allocated_chunks_ < max_chunks_) {
       chunk = std::make_unique<TraceBufferChunk>(current_chunk_seq_++);
+      allocated_chunks_++;
+    } else if (ring_ && !chunks_.empty()) {
+      // Overwrite the oldest events.
+      chunk = std::move(chunks_.front());
+      chunks_.pop_front();
+      chunk->Reset(current_chunk_seq_++);
+    } else {
+      *needs_flush = true;
+      return nullptr;
     }
+    chunks_.push_back(std::move(chunk));
+    // Flush once half of the chunks are in use, so that there is room for new
+    // events while that happens.
+    *needs_flush = !ring_ && chunks_.size() >= max_chunks_ / 2;
   }
-  auto& chunk = chunks_[total_chunks_ - 1];
+  TraceBufferChunk* chunk = chunks_.back().get();
   size_t event_index;
   TraceObject* trace_object = chunk->AddTraceEvent(&event_index);
-  *handle = MakeHandle(total_chunks_ - 1, chunk->seq(), event_index);
+  *handle = MakeHandle(chunk->seq(), event_index);
   return trace_object;
 }
 
 TraceObject* InternalTraceBuffer::GetEventByHandle(uint64_t handle) {
   Mutex::ScopedLock scoped_lock(mutex_);
-  if (handle == 0) {
-    // A handle value of zero never has a trace event associated with it.
-    return nullptr;
-  }
-  size_t chunk_index, event_index;
-  uint32_t buffer_id, chunk_seq;
-  ExtractHandle(handle, &buffer_id, &chunk_index, &chunk_seq, &event_index);
-  if (buffer_id != id_ || chunk_index >= total_chunks_) {
-    // Either the chunk belongs to the other buffer, or is outside the current
-    // range of chunks loaded in memory (the latter being true suggests that
-    // the chunk has already been flushed and is no longer in memory.)
-    return nullptr;
-  }
-  auto& chunk = chunks_[chunk_index];
-  if (chunk->seq() != chunk_seq) {
-    // Chunk is no longer in memory.
-    return nullptr;
+  handle /= NodeTraceBuffer::kShards;
+  const uint32_t chunk_seq =
+      static_cast<uint32_t>(handle / TraceBufferChunk::kChunkSize);
+  const size_t event_index = handle % TraceBufferChunk::kChunkSize;
+  // Events are usually looked up shortly after they have been added, so
+  // start with the newest chunk.
+  for (auto it = chunks_.rbegin(); it != chunks_.rend(); ++it) {
+    TraceBufferChunk* chunk = it->get();
+    if (chunk->seq() == chunk_seq) {
+      return event_index < chunk->size() ? chunk->GetEventAt(event_index)
+                                         : nullptr;
+    }
   }
-  return chunk->GetEventAt(event_index);
+  // The chunk has already been flushed or reused.
+  return nullptr;
 }
 
-void InternalTraceBuffer::Flush(bool blocking) {
+void InternalTraceBuffer::Flush(Agent* agent) {
+  std::deque<std::unique_ptr<TraceBufferChunk>> chunks;
   {
     Mutex::ScopedLock scoped_lock(mutex_);
-    if (total_chunks_ > 0) {
-      flushing_ = true;
-      for (size_t i = 0; i < total_chunks_; ++i) {
-        auto& chunk = chunks_[i];
-        for (size_t j = 0; j < chunk->size(); ++j) {
-          TraceObject* trace_event = chunk->GetEventAt(j);
-          // Another thread may have added a trace that is yet to be
-          // initialized. Skip such traces.
-          // https://github.com/nodejs/node/issues/21038.
-          if (trace_event->name()) {
-            agent_->AppendTraceEvent(trace_event);
-          }
-        }
+    chunks.swap(chunks_);
+  }
+  // The events are written without holding the lock, so that other threads
+  // can keep adding events in the meantime.
+  for (const auto& chunk : chunks) {
+    for (size_t j = 0; j < chunk->size(); ++j) {
+      TraceObject* trace_event = chunk->GetEventAt(j);
+      // Another thread may have added a trace that is yet to be
+      // initialized. Skip such traces.
+      // https://github.com/nodejs/node/issues/21038.
+      if (trace_event->name()) {
+        agent->AppendTraceEvent(trace_event);
       }
-      total_chunks_ = 0;
-      flushing_ = false;
     }
   }
-  agent_->Flush(blocking);
-}
-
-uint64_t InternalTraceBuffer::MakeHandle(
-    size_t chunk_index, uint32_t chunk_seq, size_t event_index) const {
-  return ((static_cast<uint64_t>(chunk_seq) * Capacity() +
-          chunk_index * TraceBufferChunk::kChunkSize + event_index) << 1) + id_;
+  Mutex::ScopedLock scoped_lock(mutex_);
+  for (auto& chunk : chunks)
+    free_chunks_.push_back(std::move(chunk));
 }
 
-void InternalTraceBuffer::ExtractHandle(
-    uint64_t handle, uint32_t* buffer_id, size_t* chunk_index,
-    uint32_t* chunk_seq, size_t* event_index) const {
-  *buffer_id = static_cast<uint32_t>(handle & 0x1);
-  handle >>= 1;
-  *chunk_seq = static_cast<uint32_t>(handle / Capacity());
-  size_t indices = handle % Capacity();
-  *chunk_index = indices / TraceBufferChunk::kChunkSize;
-  *event_index = indices % TraceBufferChunk::kChunkSize;
+uint64_t InternalTraceBuffer::MakeHandle(uint32_t chunk_seq,
+                                         size_t event_index) const {
+  // Chunk sequence numbers start at 1, so handles are never zero.
+  return (static_cast<uint64_t>(chunk_seq) * TraceBufferChunk::kChunkSize +
+          event_index) * NodeTraceBuffer::kShards + id_;
 }
 
 NodeTraceBuffer::NodeTraceBuffer(size_t max_chunks,
-    Agent* agent, uv_loop_t* tracing_loop)
-    : tracing_loop_(tracing_loop),
-      buffer1_(max_chunks, 0, agent),
-      buffer2_(max_chunks, 1, agent) {
-  current_buf_.store(&buffer1_);
+    Agent* agent, uv_loop_t* tracing_loop, bool flight_recorder)
+    : agent_(agent),
+      flight_recorder_(flight_recorder),
+      tracing_loop_(tracing_loop) {
+  // Use as much memory in total as two buffers of `max_chunks` chunks.
+  for (uint32_t i = 0; i < kShards; i++) {
+    buffers_.emplace_back(new InternalTraceBuffer(
+        2 * max_chunks / kShards, i, flight_recorder));
+  }
 
   flush_signal_.data = this;
   int err = uv_async_init(tracing_loop_, &flush_signal_,
@@ -120,55 +124,55 @@ NodeTraceBuffer::~NodeTraceBuffer() {
   }
 }
 
+InternalTraceBuffer* NodeTraceBuffer::GetBufferForCurrentThread() {
+  // Threads are spread over the buffers in the order in which they first
+  // add a trace event.
+  static std::atomic<size_t> next_buffer {0};
+  static thread_local size_t buffer = next_buffer++ % kShards;
+  return buffers_[buffer].get();
+}
+
 TraceObject* NodeTraceBuffer::AddTraceEvent(uint64_t* handle) {
-  // If the buffer is full, attempt to perform a flush.
-  if (!TryLoadAvailableBuffer()) {
-    // Assign a value of zero as the trace event handle.
-    // This is equivalent to calling InternalTraceBuffer::MakeHandle(0, 0, 0),
-    // and will cause GetEventByHandle to return NULL if passed as an argument.
+  bool needs_flush = false;
+  TraceObject* trace_object =
+      GetBufferForCurrentThread()->AddTraceEvent(handle, &needs_flush);
+  if (needs_flush)
+    uv_async_send(&flush_signal_);  // trigger flush on a separate thread
+  if (trace_object == nullptr) {
+    // A handle value of zero never has a trace event associated with it.
     *handle = 0;
-    return nullptr;
   }
-  return current_buf_.load()->AddTraceEvent(handle);
+  return trace_object;
 }
 
 TraceObject* NodeTraceBuffer::GetEventByHandle(uint64_t handle) {
-  return current_buf_.load()->GetEventByHandle(handle);
+  if (handle == 0)
+    return nullptr;
+  return buffers_[handle % kShards]->GetEventByHandle(handle);
 }
 
 bool NodeTraceBuffer::Flush() {
-  buffer1_.Flush(true);
-  buffer2_.Flush(true);
+  // In flight recorder mode, events are only written by Dump().
+  if (!flight_recorder_)
+    FlushBuffers(true);
   return true;
 }
 
-// Attempts to set current_buf_ such that it references a buffer that can
-// write at least one trace event. If both buffers are unavailable this
-// method returns false; otherwise it returns true.
-bool NodeTraceBuffer::TryLoadAvailableBuffer() {
-  InternalTraceBuffer* prev_buf = current_buf_.load();
-  if (prev_buf->IsFull()) {
-    uv_async_send(&flush_signal_);  // trigger flush on a separate thread
-    InternalTraceBuffer* other_buf = prev_buf == &buffer1_ ?
-      &buffer2_ : &buffer1_;
-    if (!other_buf->IsFull()) {
-      current_buf_.store(other_buf);
-    } else {
-      return false;
-    }
-  }
-  return true;
+void NodeTraceBuffer::Dump() {
+  FlushBuffers(true);
+}
+
+void NodeTraceBuffer::FlushBuffers(bool blocking) {
+  Mutex::ScopedLock scoped_lock(flush_mutex_);
+  for (const auto& buffer : buffers_)
+    buffer->Flush(agent_);
+  agent_->Flush(blocking);
 }
 
 // static
 void NodeTraceBuffer::NonBlockingFlushSignalCb(uv_async_t* signal) {
   NodeTraceBuffer* buffer = static_cast<NodeTraceBuffer*>(signal->data);
-  if (buffer->buffer1_.IsFull() && !buffer->buffer1_.IsFlushing()) {
-    buffer->buffer1_.Flush(false);
-  }
-  if (buffer->buffer2_.IsFull() && !buffer->buffer2_.IsFlushing()) {
-    buffer->buffer2_.Flush(false);
-  }
+  buffer->FlushBuffers(false);
 }
 
 // static
@@ -5,7 +5,9 @@
 #include "node_mutex.h"
 #include "libplatform/v8-tracing.h"
 
-#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
 
 namespace node {
 namespace tracing {
@@ -14,56 +16,63 @@ using v8::platform::tracing::TraceBuffer;
 using v8::platform::tracing::TraceBufferChunk;
 using v8::platform::tracing::TraceObject;
 
-// forward declaration
-class NodeTraceBuffer;
-
+// A part of the trace buffer that is used by a subset of the threads, so that
+// threads do not contend for a single lock when they add trace events.
+// Events are stored in chunks, and the chunks that are in use are ordered
+// from oldest to newest. Events are added to the newest chunk.
 class InternalTraceBuffer {
  public:
-  InternalTraceBuffer(size_t max_chunks, uint32_t id, Agent* agent);
+  InternalTraceBuffer(size_t max_chunks, uint32_t id, bool ring);
 
-  TraceObject* AddTraceEvent(uint64_t* handle);
+  // Returns nullptr if all chunks are in use. Sets `needs_flush` if the
+  // buffer should be flushed soon.
+  TraceObject* AddTraceEvent(uint64_t* handle, bool* needs_flush);
   TraceObject* GetEventByHandle(uint64_t handle);
-  void Flush(bool blocking);
-  bool IsFull() const {
-    return total_chunks_ == max_chunks_ && chunks_[total_chunks_ - 1]->IsFull();
-  }
-  bool IsFlushing() const {
-    return flushing_;
-  }
+  // Writes all events to `agent` and makes their chunks available again.
+  void Flush(Agent* agent);
 
  private:
-  uint64_t MakeHandle(size_t chunk_index, uint32_t chunk_seq,
-                      size_t event_index) const;
-  void ExtractHandle(uint64_t handle, uint32_t* buffer_id, size_t* chunk_index,
-                     uint32_t* chunk_seq, size_t* event_index) const;
-  size_t Capacity() const { return max_chunks_ * TraceBufferChunk::kChunkSize; }
+  uint64_t MakeHandle(uint32_t chunk_seq, size_t event_index) const;
 
   Mutex mutex_;
-  bool flushing_;
-  size_t max_chunks_;
-  Agent* agent_;
-  std::vector<std::unique_ptr<TraceBufferChunk>> chunks_;
-  size_t total_chunks_ = 0;
+  const size_t max_chunks_;
+  const uint32_t id_;
+  // If true, the oldest chunk is reused when all chunks are in use.
+  const bool ring_;
+  std::deque<std::unique_ptr<TraceBufferChunk>> chunks_;
+  std::vector<std::unique_ptr<TraceBufferChunk>> free_chunks_;
+  // Includes chunks that are being flushed.
+  size_t allocated_chunks_ = 0;
   uint32_t current_chunk_seq_ = 1;
-  uint32_t id_;
 };
 
+// Every thread adds trace events to one of kShards InternalTraceBuffers,
+// which are flushed from the tracing thread. In flight recorder mode, the
+// buffers are rings that keep the most recent events in memory, until
+// Dump() is called.
 class NodeTraceBuffer : public TraceBuffer {
  public:
-  NodeTraceBuffer(size_t max_chunks, Agent* agent, uv_loop_t* tracing_loop);
+  NodeTraceBuffer(size_t max_chunks, Agent* agent, uv_loop_t* tracing_loop,
+                  bool flight_recorder = false);
   ~NodeTraceBuffer() override;
 
   TraceObject* AddTraceEvent(uint64_t* handle) override;
   TraceObject* GetEventByHandle(uint64_t handle) override;
   bool Flush() override;
+  // Writes all events that are in memory, also in flight recorder mode.
+  void Dump();
 
   static const size_t kBufferChunks = 1024;
+  static const size_t kShards = 16;
 
  private:
-  bool TryLoadAvailableBuffer();
+  InternalTraceBuffer* GetBufferForCurrentThread();
+  void FlushBuffers(bool blocking);
   static void NonBlockingFlushSignalCb(uv_async_t* signal);
   static void ExitSignalCb(uv_async_t* signal);
 
+  Agent* agent_;
+  const bool flight_recorder_;
   uv_loop_t* tracing_loop_;
   uv_async_t flush_signal_;
   uv_async_t exit_signal_;
@@ -72,9 +81,9 @@ class NodeTraceBuffer : public TraceBuffer {
   Mutex exit_mutex_;
   // Used to wait until async handles have been closed.
   ConditionVariable exit_cond_;
-  std::atomic<InternalTraceBuffer*> current_buf_;
-  InternalTraceBuffer buffer1_;
-  InternalTraceBuffer buffer2_;
+  // Keeps events from different flushes in order.
+  Mutex flush_mutex_;
+  std::vector<std::unique_ptr<InternalTraceBuffer>> buffers_;
 };
 
 }  // namespace tracing
@@ -46,6 +46,12 @@ using v8::Uint32;
 using v8::Undefined;
 using v8::Value;
 
+// recvmmsg() places each datagram in a slot of the maximum datagram size.
+static constexpr size_t kMaxDatagramSize = 64 * 1024;
+static constexpr size_t kRecvBatchSize = 64;
+static constexpr size_t kRecvBatchBufferSize =
+    kRecvBatchSize * kMaxDatagramSize;
+
 class SendWrap : public ReqWrap<uv_udp_send_t> {
  public:
   SendWrap(Environment* env, Local<Object> req_wrap_obj, bool have_callback);
@@ -74,12 +80,13 @@ inline bool SendWrap::have_callback() const {
 }
 
 
-UDPWrap::UDPWrap(Environment* env, Local<Object> object)
+UDPWrap::UDPWrap(Environment* env, Local<Object> object, unsigned int flags)
     : HandleWrap(env,
                  object,
                  reinterpret_cast<uv_handle_t*>(&handle_),
-                 AsyncWrap::PROVIDER_UDPWRAP) {
-  int r = uv_udp_init(env->event_loop(), &handle_);
+                 AsyncWrap::PROVIDER_UDPWRAP),
+      recv_batch_mode_((flags & UV_UDP_RECVMMSG) != 0) {
+  int r = uv_udp_init_ex(env->event_loop(), &handle_, AF_UNSPEC | flags);
   CHECK_EQ(r, 0);  // can't fail anyway
 }
 
@@ -119,6 +126,8 @@ void UDPWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "bind6", Bind6);
   env->SetProtoMethod(t, "connect6", Connect6);
   env->SetProtoMethod(t, "send6", Send6);
+  env->SetProtoMethod(t, "sendBatch", SendBatch);
+  env->SetProtoMethod(t, "sendBatch6", SendBatch6);
   env->SetProtoMethod(t, "disconnect", Disconnect);
   env->SetProtoMethod(t, "recvStart", RecvStart);
   env->SetProtoMethod(t, "recvStop", RecvStop);
@@ -137,6 +146,9 @@ void UDPWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "setMulticastLoopback", SetMulticastLoopback);
   env->SetProtoMethod(t, "setBroadcast", SetBroadcast);
   env->SetProtoMethod(t, "setTTL", SetTTL);
+  env->SetProtoMethod(t, "setSegmentSize", SetSegmentSize);
+  env->SetProtoMethod(t, "setGRO", SetGRO);
+  env->SetProtoMethod(t, "setBusyPoll", SetSocketBusyPoll);
   env->SetProtoMethod(t, "bufferSize", BufferSize);
 
   t->Inherit(HandleWrap::GetConstructorTemplate(env));
@@ -160,6 +172,7 @@ void UDPWrap::Initialize(Local<Object> target,
 
   Local<Object> constants = Object::New(env->isolate());
   NODE_DEFINE_CONSTANT(constants, UV_UDP_IPV6ONLY);
+  NODE_DEFINE_CONSTANT(constants, UV_UDP_RECVMMSG);
   target->Set(context,
               env->constants_string(),
               constants).Check();
@@ -169,7 +182,12 @@ void UDPWrap::Initialize(Local<Object> target,
 void UDPWrap::New(const FunctionCallbackInfo<Value>& args) {
   CHECK(args.IsConstructCall());
   Environment* env = Environment::GetCurrent(args);
-  new UDPWrap(env, args.This());
+  unsigned int flags = 0;
+  if (args[0]->IsUint32()) {
+    flags = args[0].As<Uint32>()->Value();
+    CHECK_EQ(flags & ~UV_UDP_RECVMMSG, 0);
+  }
+  new UDPWrap(env, args.This(), flags);
 }
 
 
@@ -347,9 +365,23 @@ X(SetTTL, uv_udp_set_ttl)
 X(SetBroadcast, uv_udp_set_broadcast)
 X(SetMulticastTTL, uv_udp_set_multicast_ttl)
 X(SetMulticastLoopback, uv_udp_set_multicast_loop)
+X(SetSegmentSize, uv_udp_set_segment_size)
 
 #undef X
 
+void UDPWrap::SetGRO(const FunctionCallbackInfo<Value>& args) {
+  UDPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+  CHECK_EQ(args.Length(), 1);
+  bool on = args[0]->IsTrue();
+  int err = uv_udp_set_gro(&wrap->handle_, on);
+  if (err == 0)
+    wrap->gro_ = on;
+  args.GetReturnValue().Set(err);
+}
+
 void UDPWrap::SetMulticastInterface(const FunctionCallbackInfo<Value>& args) {
   UDPWrap* wrap;
   ASSIGN_OR_RETURN_UNWRAP(&wrap,
@@ -552,6 +584,90 @@ void UDPWrap::Send6(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// Sends as many datagrams as possible right away, using sendmmsg() where
+// libuv supports it. Returns the number of datagrams sent or, if not even the
+// first one could be sent, a negative error code. The JS side queues the
+// remaining datagrams with send().
+void UDPWrap::DoSendBatch(const FunctionCallbackInfo<Value>& args,
+                          int family) {
+  Environment* env = Environment::GetCurrent(args);
+
+  UDPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap,
+                          args.Holder(),
+                          args.GetReturnValue().Set(UV_EBADF));
+
+  // sendBatch(list, count) where list holds count [buffer, port, address]
+  // triples. port and address are undefined for connected sockets.
+  CHECK(args[0]->IsArray());
+  CHECK(args[1]->IsUint32());
+  Local<Array> list = args[0].As<Array>();
+  size_t count = args[1].As<Uint32>()->Value();
+  CHECK_LE(count * 3, list->Length());
+
+  MaybeStackBuffer<uv_buf_t, 64> bufs(count);
+  MaybeStackBuffer<uv_buf_t*, 64> buf_ptrs(count);
+  MaybeStackBuffer<unsigned int, 64> nbufs(count);
+  MaybeStackBuffer<sockaddr_storage, 64> addr_storage(count);
+  MaybeStackBuffer<sockaddr*, 64> addrs(count);
+
+  for (size_t i = 0; i < count; i++) {
+    Local<Value> chunk = list->Get(env->context(), i * 3).ToLocalChecked();
+    Local<Value> port = list->Get(env->context(), i * 3 + 1).ToLocalChecked();
+
+    bufs[i] = uv_buf_init(Buffer::Data(chunk), Buffer::Length(chunk));
+    buf_ptrs[i] = &bufs[i];
+    nbufs[i] = 1;
+    addrs[i] = nullptr;
+
+    if (port->IsUint32()) {
+      node::Utf8Value address(
+          env->isolate(),
+          list->Get(env->context(), i * 3 + 2).ToLocalChecked());
+      int err = sockaddr_for_family(family,
+                                    address.out(),
+                                    port.As<Uint32>()->Value(),
+                                    &addr_storage[i]);
+      if (err != 0)
+        return args.GetReturnValue().Set(err);
+      addrs[i] = reinterpret_cast<sockaddr*>(&addr_storage[i]);
+    }
+  }
+
+  size_t sent = 0;
+  if (!UNLIKELY(env->options()->test_udp_no_try_send)) {
+    while (sent < count) {
+      int err = uv_udp_try_send2(&wrap->handle_,
+                                 count - sent,
+                                 &buf_ptrs[sent],
+                                 &nbufs[sent],
+                                 &addrs[sent],
+                                 0);
+      if (err == UV_EAGAIN || err == UV_ENOSYS)
+        break;
+      if (err < 0) {
+        if (sent == 0)
+          return args.GetReturnValue().Set(err);
+        break;
+      }
+      sent += err;
+    }
+  }
+
+  args.GetReturnValue().Set(static_cast<uint32_t>(sent));
+}
+
+
+void UDPWrap::SendBatch(const FunctionCallbackInfo<Value>& args) {
+  DoSendBatch(args, AF_INET);
+}
+
+
+void UDPWrap::SendBatch6(const FunctionCallbackInfo<Value>& args) {
+  DoSendBatch(args, AF_INET6);
+}
+
+
 void UDPWrap::RecvStart(const FunctionCallbackInfo<Value>& args) {
   UDPWrap* wrap;
   ASSIGN_OR_RETURN_UNWRAP(&wrap,
@@ -594,6 +710,16 @@ void UDPWrap::OnAlloc(uv_handle_t* handle,
                       size_t suggested_size,
                       uv_buf_t* buf) {
   UDPWrap* wrap = static_cast<UDPWrap*>(handle->data);
+  size_t size = wrap->recv_batch_mode_ ? kRecvBatchBufferSize :
+                wrap->gro_ ? kMaxDatagramSize : 0;
+  if (size > 0) {
+    if (wrap->recv_buf_size_ < size) {
+      wrap->recv_buf_.reset(new char[size]);
+      wrap->recv_buf_size_ = size;
+    }
+    *buf = uv_buf_init(wrap->recv_buf_.get(), size);
+    return;
+  }
   *buf = wrap->env()->AllocateManaged(suggested_size).release();
 }
 
@@ -605,7 +731,18 @@ void UDPWrap::OnRecv(uv_udp_t* handle,
   UDPWrap* wrap = static_cast<UDPWrap*>(handle->data);
   Environment* env = wrap->env();
 
-  AllocatedBuffer buf(env, *buf_);
+  if (wrap->recv_batch_mode_) {
+    wrap->OnRecvBatch(nread, buf_, addr, flags);
+    return;
+  }
+
+  // Datagrams that were read into the handle's own receive area, including
+  // the segments that libuv split off a GRO buffer, are copied out of it.
+  bool owned = !(flags & UV_UDP_MMSG_CHUNK) &&
+               buf_->base != wrap->recv_buf_.get();
+  AllocatedBuffer buf(env);
+  if (owned)
+    buf = AllocatedBuffer(env, *buf_);
   if (nread == 0 && addr == nullptr) {
     return;
   }
@@ -626,12 +763,82 @@ void UDPWrap::OnRecv(uv_udp_t* handle,
     return;
   }
 
-  buf.Resize(nread);
-  argv[2] = buf.ToBuffer().ToLocalChecked();
+  if (owned) {
+    buf.Resize(nread);
+    argv[2] = buf.ToBuffer().ToLocalChecked();
+  } else {
+    argv[2] = Buffer::Copy(env, buf_->base, nread).ToLocalChecked();
+  }
   argv[3] = AddressToJS(env, addr);
   wrap->MakeCallback(env->onmessage_string(), arraysize(argv), argv);
 }
 
+// With recvmmsg(), libuv reports every datagram as a UV_UDP_MMSG_CHUNK of the
+// batch buffer, splitting GRO buffers into their segments, and then passes the
+// batch buffer itself back with nread == 0 and addr == nullptr. The collected
+// datagrams are handed to JS at that point, as
+// onmessage(count, handle, buffers, rinfos). A datagram that was read with
+// plain recvmsg() is handed over as a batch of one.
+void UDPWrap::OnRecvBatch(ssize_t nread,
+                          const uv_buf_t* buf,
+                          const struct sockaddr* addr,
+                          unsigned int flags) {
+  Environment* env = this->env();
+
+  if (nread >= 0 && addr != nullptr) {
+    ReceivedDatagram datagram;
+    datagram.data = buf->base;
+    datagram.length = nread;
+    memcpy(&datagram.addr,
+           addr,
+           addr->sa_family == AF_INET6 ? sizeof(sockaddr_in6)
+                                       : sizeof(sockaddr_in));
+    recv_batch_.push_back(datagram);
+    if (flags & UV_UDP_MMSG_CHUNK)
+      return;
+  }
+
+  if (recv_batch_.empty() && nread >= 0)
+    return;
+
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  Local<Object> wrap_obj = object();
+
+  if (!recv_batch_.empty()) {
+    size_t count = recv_batch_.size();
+    MaybeStackBuffer<Local<Value>, 64> buffers(count);
+    MaybeStackBuffer<Local<Value>, 64> rinfos(count);
+    for (size_t i = 0; i < count; i++) {
+      const ReceivedDatagram& datagram = recv_batch_[i];
+      buffers[i] = Buffer::Copy(env, datagram.data, datagram.length)
+          .ToLocalChecked();
+      rinfos[i] = AddressToJS(
+          env, reinterpret_cast<const sockaddr*>(&datagram.addr));
+    }
+    recv_batch_.clear();
+
+    Local<Value> argv[] = {
+      Integer::New(env->isolate(), count),
+      wrap_obj,
+      Array::New(env->isolate(), buffers.out(), count),
+      Array::New(env->isolate(), rinfos.out(), count)
+    };
+    MakeCallback(env->onmessage_string(), arraysize(argv), argv);
+  }
+
+  if (nread < 0) {
+    Local<Value> argv[] = {
+      Integer::New(env->isolate(), nread),
+      wrap_obj,
+      Undefined(env->isolate()),
+      Undefined(env->isolate())
+    };
+    MakeCallback(env->onmessage_string(), arraysize(argv), argv);
+  }
+}
+
 MaybeLocal<Object> UDPWrap::Instantiate(Environment* env,
                                         AsyncWrap* parent,
                                         UDPWrap::SocketType type) {
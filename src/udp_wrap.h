@@ -28,6 +28,9 @@
 #include "uv.h"
 #include "v8.h"
 
+#include <memory>
+#include <vector>
+
 namespace node {
 
 class Environment;
@@ -50,6 +53,8 @@ class UDPWrap: public HandleWrap {
   static void Bind6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Connect6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Send6(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendBatch6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Disconnect(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void RecvStart(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void RecvStop(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -66,6 +71,8 @@ class UDPWrap: public HandleWrap {
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetBroadcast(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetTTL(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetSegmentSize(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetGRO(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void BufferSize(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   static v8::MaybeLocal<v8::Object> Instantiate(Environment* env,
@@ -82,7 +89,7 @@ class UDPWrap: public HandleWrap {
             int (*F)(const typename T::HandleType*, sockaddr*, int*)>
   friend void GetSockOrPeerName(const v8::FunctionCallbackInfo<v8::Value>&);
 
-  UDPWrap(Environment* env, v8::Local<v8::Object> object);
+  UDPWrap(Environment* env, v8::Local<v8::Object> object, unsigned int flags);
 
   static void DoBind(const v8::FunctionCallbackInfo<v8::Value>& args,
                      int family);
@@ -90,6 +97,8 @@ class UDPWrap: public HandleWrap {
                      int family);
   static void DoSend(const v8::FunctionCallbackInfo<v8::Value>& args,
                      int family);
+  static void DoSendBatch(const v8::FunctionCallbackInfo<v8::Value>& args,
+                          int family);
   static void SetMembership(const v8::FunctionCallbackInfo<v8::Value>& args,
                             uv_membership membership);
   static void SetSourceMembership(
@@ -105,8 +114,29 @@ class UDPWrap: public HandleWrap {
                      const uv_buf_t* buf,
                      const struct sockaddr* addr,
                      unsigned int flags);
+  void OnRecvBatch(ssize_t nread,
+                   const uv_buf_t* buf,
+                   const struct sockaddr* addr,
+                   unsigned int flags);
 
   uv_udp_t handle_;
+
+  // Set when the handle was created with UV_UDP_RECVMMSG. Datagrams read by
+  // recvmmsg() are collected in recv_batch_ and handed to JS in one call.
+  struct ReceivedDatagram {
+    const char* data;
+    size_t length;
+    sockaddr_storage addr;
+  };
+  bool recv_batch_mode_ = false;
+  std::vector<ReceivedDatagram> recv_batch_;
+  // Set while UDP GRO is enabled. libuv may then split one read into several
+  // datagrams.
+  bool gro_ = false;
+  // Receive area that is reused for every read in batch or GRO mode. The
+  // datagrams are copied out of it before they are handed to JS.
+  std::unique_ptr<char[]> recv_buf_;
+  size_t recv_buf_size_ = 0;
 };
 
 }  // namespace node
@@ -0,0 +1,514 @@
+#include "utf8.h"
+
+#include <cstring>  // memcpy
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NODE_UTF8_X86 1
+#include <immintrin.h>
+#endif
+
+namespace node {
+namespace {
+
+// The vectorized validator is the "lookup" algorithm by John Keiser and
+// Daniel Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte"
+// (https://arxiv.org/abs/2010.03090), as used by simdjson. Every byte is
+// classified by three table lookups, on the high nibble of the previous
+// byte, the low nibble of the previous byte and the high nibble of the byte
+// itself. Combining them with AND leaves a non-zero value for every way in
+// which a two-byte sequence can be invalid. Checking that the bytes after
+// three- and four-byte leads are continuation bytes takes care of the rest.
+//
+// While doing so, the validator counts the continuation bytes and four-byte
+// leads to compute the UTF-16 length, and tracks the largest byte to find
+// out whether all code points fit into Latin-1.
+
+// Bits for the lookup tables. Each one stands for one kind of error.
+constexpr uint8_t kTooShort = 1 << 0;    // 11______ 0_______
+                                         // 11______ 11______
+constexpr uint8_t kTooLong = 1 << 1;     // 0_______ 10______
+constexpr uint8_t kOverlong3 = 1 << 2;   // 11100000 100_____
+constexpr uint8_t kTooLarge = 1 << 3;    // 11110100 1001____
+                                         // 11110100 101_____
+                                         // 11110101 1001____
+                                         // 11110101 101_____
+                                         // 1111011_ 1001____
+                                         // 1111011_ 101_____
+                                         // 11111___ 1001____
+                                         // 11111___ 101_____
+constexpr uint8_t kSurrogate = 1 << 4;   // 11101101 101_____
+constexpr uint8_t kOverlong2 = 1 << 5;   // 1100000_ 10______
+constexpr uint8_t kTooLarge1000 = 1 << 6;  // 11110101 1000____
+                                           // 1111011_ 1000____
+                                           // 11111___ 1000____
+constexpr uint8_t kOverlong4 = 1 << 6;   // 11110000 1000____
+constexpr uint8_t kTwoConts = 1 << 7;    // 10______ 10______
+// These errors can happen with any low nibble in the first byte.
+constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+#define UTF8_BYTE_1_HIGH                                                      \
+  /* 0_______ ________ <ASCII in byte 1> */                                   \
+  kTooLong, kTooLong, kTooLong, kTooLong,                                     \
+  kTooLong, kTooLong, kTooLong, kTooLong,                                     \
+  /* 10______ ________ <continuation in byte 1> */                            \
+  kTwoConts, kTwoConts, kTwoConts, kTwoConts,                                 \
+  /* 1100____ ________ <two byte lead in byte 1> */                           \
+  kTooShort | kOverlong2,                                                     \
+  /* 1101____ ________ <two byte lead in byte 1> */                           \
+  kTooShort,                                                                  \
+  /* 1110____ ________ <three byte lead in byte 1> */                         \
+  kTooShort | kOverlong3 | kSurrogate,                                        \
+  /* 1111____ ________ <four+ byte lead in byte 1> */                         \
+  kTooShort | kTooLarge | kTooLarge1000 | kOverlong4
+
+#define UTF8_BYTE_1_LOW                                                       \
+  /* ____0000 ________ */                                                     \
+  kCarry | kOverlong3 | kOverlong2 | kOverlong4,                              \
+  /* ____0001 ________ */                                                     \
+  kCarry | kOverlong2,                                                        \
+  /* ____001_ ________ */                                                     \
+  kCarry,                                                                     \
+  kCarry,                                                                     \
+  /* ____0100 ________ */                                                     \
+  kCarry | kTooLarge,                                                         \
+  /* ____0101 ________ */                                                     \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  /* ____011_ ________ */                                                     \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  /* ____1___ ________ */                                                     \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  /* ____1101 ________ */                                                     \
+  kCarry | kTooLarge | kTooLarge1000 | kSurrogate,                            \
+  kCarry | kTooLarge | kTooLarge1000,                                         \
+  kCarry | kTooLarge | kTooLarge1000
+
+#define UTF8_BYTE_2_HIGH                                                      \
+  /* ________ 0_______ <ASCII in byte 2> */                                   \
+  kTooShort, kTooShort, kTooShort, kTooShort,                                 \
+  kTooShort, kTooShort, kTooShort, kTooShort,                                 \
+  /* ________ 1000____ */                                                     \
+  kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 |            \
+      kOverlong4,                                                             \
+  /* ________ 1001____ */                                                     \
+  kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,                 \
+  /* ________ 101_____ */                                                     \
+  kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,                 \
+  kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,                 \
+  /* ________ 11______ */                                                     \
+  kTooShort, kTooShort, kTooShort, kTooShort
+
+// Decodes the character at |src|, which is known to be well-formed.
+// Returns the number of bytes that it takes up.
+inline size_t DecodeOne(const uint8_t* src, uint32_t* code_point) {
+  const uint8_t c = src[0];
+  if (c < 0x80) {
+    *code_point = c;
+    return 1;
+  }
+  if (c < 0xe0) {
+    *code_point = (c & 0x1f) << 6 | (src[1] & 0x3f);
+    return 2;
+  }
+  if (c < 0xf0) {
+    *code_point = (c & 0x0f) << 12 | (src[1] & 0x3f) << 6 | (src[2] & 0x3f);
+    return 3;
+  }
+  *code_point = (c & 0x07) << 18 | (src[1] & 0x3f) << 12 |
+                (src[2] & 0x3f) << 6 | (src[3] & 0x3f);
+  return 4;
+}
+
+bool ValidateScalar(const char* src, size_t len, Utf8Info* info) {
+  const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+  size_t utf16_length = 0;
+  bool latin1 = true;
+  size_t i = 0;
+  while (i < len) {
+    const uint8_t c = s[i];
+    if (c < 0x80) {
+      i++;
+      utf16_length++;
+      continue;
+    }
+
+    size_t n;
+    uint8_t min = 0x80;
+    uint8_t max = 0xbf;
+    if (c >= 0xc2 && c <= 0xdf) {
+      n = 2;
+    } else if (c >= 0xe0 && c <= 0xef) {
+      n = 3;
+      if (c == 0xe0) min = 0xa0;
+      if (c == 0xed) max = 0x9f;
+    } else if (c >= 0xf0 && c <= 0xf4) {
+      n = 4;
+      if (c == 0xf0) min = 0x90;
+      if (c == 0xf4) max = 0x8f;
+    } else {
+      return false;
+    }
+    if (len - i < n || s[i + 1] < min || s[i + 1] > max)
+      return false;
+    for (size_t k = 2; k < n; k++) {
+      if ((s[i + k] & 0xc0) != 0x80)
+        return false;
+    }
+
+    if (c > 0xc3) latin1 = false;
+    utf16_length += n == 4 ? 2 : 1;
+    i += n;
+  }
+
+  if (info != nullptr) {
+    info->utf16_length = utf16_length;
+    info->latin1 = latin1;
+  }
+  return true;
+}
+
+#ifdef NODE_UTF8_X86
+
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+#define AVX2_TARGET __attribute__((target("avx2,popcnt")))
+
+struct Utf8StateSSSE3 {
+  __m128i error;
+  __m128i prev_input;
+  __m128i prev_incomplete;
+  __m128i max;
+  size_t continuations;
+  size_t four_byte_leads;
+};
+
+SSSE3_TARGET inline __m128i HighNibbles(__m128i in) {
+  return _mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(0x0f));
+}
+
+SSSE3_TARGET inline void CheckBlock(Utf8StateSSSE3* state, __m128i input) {
+  const __m128i prev_input = state->prev_input;
+  state->prev_input = input;
+  if (_mm_movemask_epi8(input) == 0) {
+    // ASCII is always valid, but cannot complete a preceding sequence.
+    state->error = _mm_or_si128(state->error, state->prev_incomplete);
+    state->prev_incomplete = _mm_setzero_si128();
+    return;
+  }
+
+  const __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+  const __m128i byte_1_high = _mm_shuffle_epi8(
+      _mm_setr_epi8(UTF8_BYTE_1_HIGH), HighNibbles(prev1));
+  const __m128i byte_1_low = _mm_shuffle_epi8(
+      _mm_setr_epi8(UTF8_BYTE_1_LOW),
+      _mm_and_si128(prev1, _mm_set1_epi8(0x0f)));
+  const __m128i byte_2_high = _mm_shuffle_epi8(
+      _mm_setr_epi8(UTF8_BYTE_2_HIGH), HighNibbles(input));
+  const __m128i special_cases =
+      _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+  // Only bytes after 111_____ and 1111____ keep their high bit here.
+  const __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+  const __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+  const __m128i must_be_continuation = _mm_and_si128(
+      _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0xe0 - 0x80)),
+                   _mm_subs_epu8(prev3, _mm_set1_epi8(0xf0 - 0x80))),
+      _mm_set1_epi8(static_cast<char>(0x80)));
+  state->error = _mm_or_si128(
+      state->error, _mm_xor_si128(must_be_continuation, special_cases));
+
+  // Leads at the end of the block that need bytes from the next one.
+  state->prev_incomplete = _mm_subs_epu8(
+      input, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                           0xf0 - 1, 0xe0 - 1, 0xc0 - 1));
+
+  state->continuations += __builtin_popcount(_mm_movemask_epi8(
+      _mm_cmpgt_epi8(_mm_set1_epi8(-64), input)));
+  const __m128i four = _mm_set1_epi8(static_cast<char>(0xf0));
+  state->four_byte_leads += __builtin_popcount(_mm_movemask_epi8(
+      _mm_cmpeq_epi8(_mm_max_epu8(input, four), input)));
+  state->max = _mm_max_epu8(state->max, input);
+}
+
+SSSE3_TARGET bool ValidateSSSE3(const char* src, size_t len, Utf8Info* info) {
+  Utf8StateSSSE3 state = { _mm_setzero_si128(), _mm_setzero_si128(),
+                           _mm_setzero_si128(), _mm_setzero_si128(), 0, 0 };
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    CheckBlock(&state,
+               _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+  }
+  if (i < len) {
+    // Padding with ASCII makes truncated sequences show up as errors.
+    char tail[16] = {};
+    memcpy(tail, src + i, len - i);
+    CheckBlock(&state, _mm_loadu_si128(reinterpret_cast<__m128i*>(tail)));
+  }
+  const __m128i error = _mm_or_si128(state.error, state.prev_incomplete);
+  if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xffff)
+    return false;
+
+  if (info != nullptr) {
+    info->utf16_length = len - state.continuations + state.four_byte_leads;
+    const __m128i latin1_max = _mm_set1_epi8(static_cast<char>(0xc3));
+    info->latin1 = _mm_movemask_epi8(_mm_cmpeq_epi8(
+        _mm_min_epu8(state.max, latin1_max), state.max)) == 0xffff;
+  }
+  return true;
+}
+
+// Returns the number of bytes at the start of |src| that are ASCII, in
+// multiples of the vector size.
+SSSE3_TARGET size_t AsciiPrefixSSSE3(const char* src, size_t len) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    if (_mm_movemask_epi8(in) != 0)
+      break;
+  }
+  return i;
+}
+
+// Like AsciiPrefixSSSE3(), but also widens the ASCII it finds into |dst|.
+SSSE3_TARGET size_t WidenAsciiSSSE3(const char* src,
+                                    size_t len,
+                                    uint16_t* dst) {
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    if (_mm_movemask_epi8(in) != 0)
+      break;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_unpacklo_epi8(in, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8),
+                     _mm_unpackhi_epi8(in, zero));
+  }
+  return i;
+}
+
+// The AVX2 versions do the same with 32 bytes at once.
+
+struct Utf8StateAVX2 {
+  __m256i error;
+  __m256i prev_input;
+  __m256i prev_incomplete;
+  __m256i max;
+  size_t continuations;
+  size_t four_byte_leads;
+};
+
+AVX2_TARGET inline __m256i Lookup(__m128i table, __m256i indices) {
+  return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(table), indices);
+}
+
+// Shifts |input| by |N| bytes, filling in the last bytes of |prev|.
+template <int N>
+AVX2_TARGET inline __m256i Prev(__m256i input, __m256i prev) {
+  return _mm256_alignr_epi8(
+      input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+}
+
+AVX2_TARGET inline void CheckBlock(Utf8StateAVX2* state, __m256i input) {
+  const __m256i prev_input = state->prev_input;
+  state->prev_input = input;
+  if (_mm256_movemask_epi8(input) == 0) {
+    state->error = _mm256_or_si256(state->error, state->prev_incomplete);
+    state->prev_incomplete = _mm256_setzero_si256();
+    return;
+  }
+
+  const __m256i low_nibbles = _mm256_set1_epi8(0x0f);
+  const __m256i prev1 = Prev<1>(input, prev_input);
+  const __m256i byte_1_high =
+      Lookup(_mm_setr_epi8(UTF8_BYTE_1_HIGH),
+             _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibbles));
+  const __m256i byte_1_low = Lookup(_mm_setr_epi8(UTF8_BYTE_1_LOW),
+                                    _mm256_and_si256(prev1, low_nibbles));
+  const __m256i byte_2_high =
+      Lookup(_mm_setr_epi8(UTF8_BYTE_2_HIGH),
+             _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibbles));
+  const __m256i special_cases = _mm256_and_si256(
+      _mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+  const __m256i prev2 = Prev<2>(input, prev_input);
+  const __m256i prev3 = Prev<3>(input, prev_input);
+  const __m256i must_be_continuation = _mm256_and_si256(
+      _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(0xe0 - 0x80)),
+                      _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xf0 - 0x80))),
+      _mm256_set1_epi8(static_cast<char>(0x80)));
+  state->error = _mm256_or_si256(
+      state->error, _mm256_xor_si256(must_be_continuation, special_cases));
+
+  state->prev_incomplete = _mm256_subs_epu8(
+      input, _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                              -1, -1, -1, -1, -1, -1, -1, -1,
+                              -1, -1, -1, -1, -1, -1, -1, -1,
+                              -1, -1, -1, -1, -1,
+                              0xf0 - 1, 0xe0 - 1, 0xc0 - 1));
+
+  state->continuations += _mm_popcnt_u32(_mm256_movemask_epi8(
+      _mm256_cmpgt_epi8(_mm256_set1_epi8(-64), input)));
+  const __m256i four = _mm256_set1_epi8(static_cast<char>(0xf0));
+  state->four_byte_leads += _mm_popcnt_u32(_mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(_mm256_max_epu8(input, four), input)));
+  state->max = _mm256_max_epu8(state->max, input);
+}
+
+AVX2_TARGET bool ValidateAVX2(const char* src, size_t len, Utf8Info* info) {
+  Utf8StateAVX2 state = { _mm256_setzero_si256(), _mm256_setzero_si256(),
+                          _mm256_setzero_si256(), _mm256_setzero_si256(),
+                          0, 0 };
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    CheckBlock(&state,
+               _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+  }
+  if (i < len) {
+    char tail[32] = {};
+    memcpy(tail, src + i, len - i);
+    CheckBlock(&state,
+               _mm256_loadu_si256(reinterpret_cast<__m256i*>(tail)));
+  }
+  const __m256i error = _mm256_or_si256(state.error, state.prev_incomplete);
+  if (!_mm256_testz_si256(error, error))
+    return false;
+
+  if (info != nullptr) {
+    info->utf16_length = len - state.continuations + state.four_byte_leads;
+    const __m256i latin1_max = _mm256_set1_epi8(static_cast<char>(0xc3));
+    info->latin1 = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+        _mm256_min_epu8(state.max, latin1_max), state.max)) == -1;
+  }
+  return true;
+}
+
+AVX2_TARGET size_t AsciiPrefixAVX2(const char* src, size_t len) {
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    const __m256i in =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    if (_mm256_movemask_epi8(in) != 0)
+      break;
+  }
+  return i + AsciiPrefixSSSE3(src + i, len - i);
+}
+
+AVX2_TARGET size_t WidenAsciiAVX2(const char* src, size_t len, uint16_t* dst) {
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    const __m256i in =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    if (_mm256_movemask_epi8(in) != 0)
+      break;
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i),
+        _mm256_cvtepu8_epi16(_mm256_castsi256_si128(in)));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i + 16),
+        _mm256_cvtepu8_epi16(_mm256_extracti128_si256(in, 1)));
+  }
+  return i + WidenAsciiSSSE3(src + i, len - i, dst + i);
+}
+
+#undef SSSE3_TARGET
+#undef AVX2_TARGET
+
+#endif  // NODE_UTF8_X86
+
+#undef UTF8_BYTE_1_HIGH
+#undef UTF8_BYTE_1_LOW
+#undef UTF8_BYTE_2_HIGH
+
+size_t AsciiPrefixScalar(const char* src, size_t len) {
+  return 0;
+}
+
+size_t WidenAsciiScalar(const char* src, size_t len, uint16_t* dst) {
+  return 0;
+}
+
+struct Utf8Kernels {
+  bool (*validate)(const char* src, size_t len, Utf8Info* info);
+  size_t (*ascii_prefix)(const char* src, size_t len);
+  size_t (*widen_ascii)(const char* src, size_t len, uint16_t* dst);
+};
+
+Utf8Kernels SelectKernels() {
+#ifdef NODE_UTF8_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+    return { ValidateAVX2, AsciiPrefixAVX2, WidenAsciiAVX2 };
+  if (__builtin_cpu_supports("ssse3"))
+    return { ValidateSSSE3, AsciiPrefixSSSE3, WidenAsciiSSSE3 };
+#endif
+  return { ValidateScalar, AsciiPrefixScalar, WidenAsciiScalar };
+}
+
+const Utf8Kernels& GetKernels() {
+  static const Utf8Kernels kernels = SelectKernels();
+  return kernels;
+}
+
+}  // anonymous namespace
+
+bool utf8_validate(const char* src, size_t len, Utf8Info* info) {
+  return GetKernels().validate(src, len, info);
+}
+
+size_t utf8_to_latin1(const char* src, size_t len, char* dst) {
+  const Utf8Kernels& kernels = GetKernels();
+  const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+  size_t i = 0;
+  size_t k = 0;
+  while (i < len) {
+    if (s[i] < 0x80) {
+      // Copy runs of ASCII in bulk.
+      const size_t n = kernels.ascii_prefix(src + i, len - i);
+      memcpy(dst + k, src + i, n);
+      i += n;
+      k += n;
+      for (; i < len && s[i] < 0x80; i++, k++)
+        dst[k] = s[i];
+      continue;
+    }
+    // Only 0xc2 and 0xc3 can start a sequence that fits into Latin-1.
+    dst[k++] = static_cast<char>((s[i] & 0x1f) << 6 | (s[i + 1] & 0x3f));
+    i += 2;
+  }
+  return k;
+}
+
+size_t utf8_to_utf16(const char* src, size_t len, uint16_t* dst) {
+  const Utf8Kernels& kernels = GetKernels();
+  const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+  size_t i = 0;
+  size_t k = 0;
+  while (i < len) {
+    if (s[i] < 0x80) {
+      const size_t n = kernels.widen_ascii(src + i, len - i, dst + k);
+      i += n;
+      k += n;
+      for (; i < len && s[i] < 0x80; i++, k++)
+        dst[k] = s[i];
+      continue;
+    }
+    uint32_t code_point;
+    i += DecodeOne(s + i, &code_point);
+    if (code_point < 0x10000) {
+      dst[k++] = static_cast<uint16_t>(code_point);
+    } else {
+      code_point -= 0x10000;
+      dst[k++] = static_cast<uint16_t>(0xd800 + (code_point >> 10));
+      dst[k++] = static_cast<uint16_t>(0xdc00 + (code_point & 0x3ff));
+    }
+  }
+  return k;
+}
+
+}  // namespace node
@@ -0,0 +1,35 @@
+#ifndef SRC_UTF8_H_
+#define SRC_UTF8_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <cstddef>
+#include <cstdint>
+
+namespace node {
+//// UTF-8 ////
+
+struct Utf8Info {
+  // The number of UTF-16 code units that the input decodes to.
+  size_t utf16_length;
+  // True if no code point is above U+00FF, i.e. the input can be
+  // transcoded into a one-byte string.
+  bool latin1;
+};
+
+// Returns true if |src| is well-formed UTF-8, i.e. it contains no overlong
+// forms, no surrogates, no code points above U+10FFFF and no truncated
+// sequences. In that case, and if |info| is not null, also fills in |info|.
+bool utf8_validate(const char* src, size_t len, Utf8Info* info = nullptr);
+
+// The transcoders expect input for which utf8_validate() returned true,
+// and a destination that is large enough according to the Utf8Info for it.
+// They return the number of characters written.
+size_t utf8_to_latin1(const char* src, size_t len, char* dst);
+size_t utf8_to_utf16(const char* src, size_t len, uint16_t* dst);
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_UTF8_H_
@@ -395,6 +395,38 @@ inline char* Calloc(size_t n) { return Calloc<char>(n); }
 inline char* UncheckedMalloc(size_t n) { return UncheckedMalloc<char>(n); }
 inline char* UncheckedCalloc(size_t n) { return UncheckedCalloc<char>(n); }
 
+size_t ScratchArena::AlignedSize(size_t size) {
+  constexpr size_t kAlignment = alignof(std::max_align_t);
+  CHECK_LE(size, std::numeric_limits<size_t>::max() - kAlignment);
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+void* ScratchArena::Allocate(size_t size) {
+  size = AlignedSize(size);
+  if (size > static_cast<size_t>(limit_ - top_))
+    return AllocateSlow(size);
+  void* ptr = top_;
+  top_ += size;
+  live_++;
+  return ptr;
+}
+
+void ScratchArena::Free(void* ptr, size_t size) {
+  CHECK_GT(live_, 0);
+  live_--;
+  char* start = static_cast<char*>(ptr);
+  if (start + AlignedSize(size) == top_)
+    top_ = start;
+}
+
+void ScratchArena::Reset() {
+  // Nothing to do if nothing has been allocated since the last reset.
+  if (live_ == 0 && next_chunk_ > 0 &&
+      (top_ != chunks_[0].data || chunks_[0].size != kChunkSize)) {
+    ResetSlow();
+  }
+}
+
 // This is a helper in the .cc file so including util-inl.h doesn't include more
 // headers than we really need to.
 void ThrowErrStringTooLong(v8::Isolate* isolate);
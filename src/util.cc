@@ -44,6 +44,7 @@
 #include <sys/types.h>
 #endif
 
+#include <algorithm>
 #include <atomic>
 #include <cstdio>
 #include <cstring>
@@ -273,4 +274,41 @@ std::string DiagnosticFilename::MakeFilename(
   return oss.str();
 }
 
+ScratchArena::~ScratchArena() {
+  for (const Chunk& chunk : chunks_)
+    free(chunk.data);
+}
+
+constexpr size_t ScratchArena::kChunkSize;
+
+void* ScratchArena::AllocateSlow(size_t size) {
+  // Chunks after the current one are empty, so the next one is used if it is
+  // large enough. Otherwise a new chunk is inserted in front of it.
+  if (next_chunk_ == chunks_.size() || chunks_[next_chunk_].size < size) {
+    Chunk chunk;
+    chunk.size = std::max(size, kChunkSize);
+    chunk.data = Malloc(chunk.size);
+    chunks_.insert(chunks_.begin() + next_chunk_, chunk);
+    capacity_ += chunk.size;
+  }
+  const Chunk& chunk = chunks_[next_chunk_++];
+  top_ = chunk.data + size;
+  limit_ = chunk.data + chunk.size;
+  live_++;
+  return chunk.data;
+}
+
+void ScratchArena::ResetSlow() {
+  // Only the first chunk is kept, unless it was made for a large allocation.
+  const size_t keep = chunks_[0].size == kChunkSize ? 1 : 0;
+  for (size_t i = keep; i < chunks_.size(); i++) {
+    free(chunks_[i].data);
+    capacity_ -= chunks_[i].size;
+  }
+  chunks_.resize(keep);
+  next_chunk_ = keep;
+  top_ = keep ? chunks_[0].data : nullptr;
+  limit_ = keep ? chunks_[0].data + chunks_[0].size : nullptr;
+}
+
 }  // namespace node
@@ -48,6 +48,7 @@
 #include <array>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #ifdef __GNUC__
 #define MUST_USE_RESULT __attribute__((warn_unused_result))
@@ -328,8 +329,55 @@ inline bool StringEqualNoCase(const char* a, const char* b);
 // strncasecmp() is locale-sensitive.  Use StringEqualNoCaseN() instead.
 inline bool StringEqualNoCaseN(const char* a, const char* b, size_t length);
 
+// A bump allocator for scratch memory that is only needed for the duration
+// of a native call. Each Environment owns one, so it is only used from one
+// thread and does not contend with other threads for the malloc() arenas.
+// Memory is reclaimed right away when the most recent allocation is freed,
+// and otherwise all at once when the arena is reset once nothing is
+// allocated from it any more.
+class ScratchArena {
+ public:
+  static constexpr size_t kChunkSize = 32 * 1024;
+
+  ScratchArena() = default;
+  ~ScratchArena();
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  // Returns storage for `size` bytes, aligned like malloc().
+  inline void* Allocate(size_t size);
+  // `size` must be the size that was passed to Allocate().
+  inline void Free(void* ptr, size_t size);
+  // Releases all chunks but the first, if nothing is allocated.
+  inline void Reset();
+
+  // The number of bytes held by the arena.
+  size_t capacity() const { return capacity_; }
+  // The number of allocations that have not been freed yet.
+  size_t live_allocations() const { return live_; }
+
+ private:
+  struct Chunk {
+    char* data;
+    size_t size;
+  };
+
+  static inline size_t AlignedSize(size_t size);
+  void* AllocateSlow(size_t size);
+  void ResetSlow();
+
+  std::vector<Chunk> chunks_;
+  // The index of the chunk that is used once the current one is full.
+  size_t next_chunk_ = 0;
+  char* top_ = nullptr;
+  char* limit_ = nullptr;
+  size_t live_ = 0;
+  size_t capacity_ = 0;
+};
+
 // Allocates an array of member type T. For up to kStackStorageSize items,
-// the stack is used, otherwise malloc().
+// the stack is used, otherwise malloc(), or the ScratchArena passed to the
+// constructor.
 template <typename T, size_t kStackStorageSize = 1024>
 class MaybeStackBuffer {
  public:
@@ -377,7 +425,16 @@ class MaybeStackBuffer {
   // Content of the buffer in the range [0, length()) is preserved.
   void AllocateSufficientStorage(size_t storage) {
     CHECK(!IsInvalidated());
-    if (storage > capacity()) {
+    if (storage > capacity() && arena_ != nullptr) {
+      T* new_buf = static_cast<T*>(
+          arena_->Allocate(MultiplyWithOverflowCheck(sizeof(T), storage)));
+      if (length_ > 0)
+        memcpy(new_buf, buf_, length_ * sizeof(buf_[0]));
+      if (IsAllocated())
+        arena_->Free(buf_, capacity_ * sizeof(buf_[0]));
+      buf_ = new_buf;
+      capacity_ = storage;
+    } else if (storage > capacity()) {
       bool was_allocated = IsAllocated();
       T* allocated_ptr = was_allocated ? buf_ : nullptr;
       buf_ = Realloc(allocated_ptr, storage);
@@ -428,6 +485,7 @@ class MaybeStackBuffer {
   // Note: This does not free the buffer.
   void Release() {
     CHECK(IsAllocated());
+    CHECK_NULL(arena_);
     buf_ = buf_st_;
     length_ = 0;
     capacity_ = 0;
@@ -442,8 +500,19 @@ class MaybeStackBuffer {
     AllocateSufficientStorage(storage);
   }
 
+  // Spills into `arena` rather than the heap. The buffer must not outlive
+  // the call that uses it.
+  MaybeStackBuffer(ScratchArena* arena, size_t storage) : MaybeStackBuffer() {
+    arena_ = arena;
+    AllocateSufficientStorage(storage);
+  }
+
   ~MaybeStackBuffer() {
-    if (IsAllocated())
+    if (!IsAllocated())
+      return;
+    if (arena_ != nullptr)
+      arena_->Free(buf_, capacity_ * sizeof(buf_[0]));
+    else
       free(buf_);
   }
 
@@ -452,6 +521,7 @@ class MaybeStackBuffer {
   // capacity of the malloc'ed buf_
   size_t capacity_;
   T* buf_;
+  ScratchArena* arena_ = nullptr;
   T buf_st_[kStackStorageSize];
 };
 
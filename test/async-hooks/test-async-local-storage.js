@@ -0,0 +1,92 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const { AsyncLocalStorage, AsyncResource } = require('async_hooks');
+
+// Test that AsyncLocalStorage stores are passed on to the asynchronous
+// operations that are started while they are set.
+
+const als = new AsyncLocalStorage();
+const other = new AsyncLocalStorage();
+
+assert.strictEqual(als.getStore(), undefined);
+
+als.run('timers', () => {
+  setTimeout(common.mustCall(() => {
+    assert.strictEqual(als.getStore(), 'timers');
+  }), 1);
+  setImmediate(common.mustCall(() => {
+    assert.strictEqual(als.getStore(), 'timers');
+  }));
+});
+
+als.run('nextTick', () => {
+  process.nextTick(common.mustCall(() => {
+    assert.strictEqual(als.getStore(), 'nextTick');
+  }));
+});
+
+// Native resources.
+als.run('fs', () => {
+  fs.stat(__filename, common.mustCall(() => {
+    assert.strictEqual(als.getStore(), 'fs');
+  }));
+});
+
+// Promises.
+als.run('promise', async () => {
+  await new Promise((resolve) => setTimeout(resolve, 1));
+  assert.strictEqual(als.getStore(), 'promise');
+  Promise.resolve().then(common.mustCall(() => {
+    assert.strictEqual(als.getStore(), 'promise');
+  }));
+}).then(common.mustCall());
+
+// AsyncResource.
+{
+  const resource = als.run('resource', () => new AsyncResource('test'));
+  resource.runInAsyncScope(() => {
+    assert.strictEqual(als.getStore(), 'resource');
+  });
+}
+
+// Nested run() and exit() restore the outer store, and instances do not
+// affect each other.
+als.run('outer', () => {
+  other.run('other', () => {
+    const ret = als.run('inner', (a, b) => {
+      assert.strictEqual(als.getStore(), 'inner');
+      assert.strictEqual(other.getStore(), 'other');
+      return a + b;
+    }, 1, 2);
+    assert.strictEqual(ret, 3);
+    als.exit(() => {
+      assert.strictEqual(als.getStore(), undefined);
+      assert.strictEqual(other.getStore(), 'other');
+      setImmediate(common.mustCall(() => {
+        assert.strictEqual(als.getStore(), undefined);
+        assert.strictEqual(other.getStore(), 'other');
+      }));
+    });
+    assert.strictEqual(als.getStore(), 'outer');
+  });
+  assert.throws(() => als.run('throws', () => { throw new Error('boom'); }),
+                /boom/);
+  assert.strictEqual(als.getStore(), 'outer');
+});
+assert.strictEqual(als.getStore(), undefined);
+
+// enterWith() sets the store for the rest of the synchronous execution.
+setImmediate(common.mustCall(() => {
+  als.enterWith('entered');
+  assert.strictEqual(als.getStore(), 'entered');
+  setImmediate(common.mustCall(() => {
+    assert.strictEqual(als.getStore(), 'entered');
+    als.disable();
+    assert.strictEqual(als.getStore(), undefined);
+  }));
+}));
+setImmediate(common.mustCall(() => {
+  assert.strictEqual(als.getStore(), undefined);
+}));
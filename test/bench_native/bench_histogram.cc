@@ -0,0 +1,37 @@
+#include "bench_native.h"
+#include "histogram-inl.h"
+#include "util-inl.h"
+
+#include <vector>
+
+using bench_native::DoNotOptimize;
+using bench_native::State;
+using node::Histogram;
+
+// Records nanosecond durations between 1µs and 10ms, as the event loop delay
+// and loop phase histograms do.
+static void BM_HistogramRecord(State& state) {  // NOLINT(runtime/references)
+  Histogram histogram(1, 3600 * 1e9, static_cast<int>(state.range(0)));
+  std::vector<int64_t> values(1024);
+  uint32_t seed = 1;
+  for (int64_t& value : values) {
+    seed = seed * 1103515245 + 12345;
+    value = 1000 + seed % 10000000;
+  }
+  size_t i = 0;
+  while (state.KeepRunning())
+    DoNotOptimize(histogram.Record(values[i++ & 1023]));
+  DoNotOptimize(histogram.Count());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HistogramRecord)->Arg(1)->Arg(3)->Arg(5);
+
+static void BM_HistogramPercentile(State& state) {  // NOLINT
+  Histogram histogram(1, 3600 * 1e9, 3);
+  for (int64_t value = 1000; value < 10000000; value += 997)
+    histogram.Record(value);
+  while (state.KeepRunning())
+    DoNotOptimize(histogram.Percentile(99));
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HistogramPercentile);
@@ -0,0 +1,107 @@
+#include "bench_native.h"
+#include "llhttp.h"
+
+#include <string>
+
+using bench_native::DoNotOptimize;
+using bench_native::State;
+
+// The parser callbacks only record where the data is, like the Parser in
+// node_http_parser.cc does before it calls into JS, so that this measures
+// llhttp with the settings that Node uses.
+
+namespace {
+
+struct ParseResult {
+  size_t url = 0;
+  size_t header_bytes = 0;
+  size_t headers = 0;
+  size_t body = 0;
+  size_t messages = 0;
+};
+
+ParseResult* Result(llhttp_t* parser) {
+  return static_cast<ParseResult*>(parser->data);
+}
+
+const llhttp_settings_t kSettings = {
+  nullptr,  // on_message_begin
+  [](llhttp_t* parser, const char* at, size_t length) {
+    Result(parser)->url += length;
+    return 0;
+  },
+  nullptr,  // on_status
+  [](llhttp_t* parser, const char* at, size_t length) {
+    Result(parser)->headers++;
+    Result(parser)->header_bytes += length;
+    return 0;
+  },
+  [](llhttp_t* parser, const char* at, size_t length) {
+    Result(parser)->header_bytes += length;
+    return 0;
+  },
+  nullptr,  // on_headers_complete
+  [](llhttp_t* parser, const char* at, size_t length) {
+    Result(parser)->body += length;
+    return 0;
+  },
+  [](llhttp_t* parser) {
+    Result(parser)->messages++;
+    return 0;
+  },
+  nullptr,  // on_chunk_header
+  nullptr,  // on_chunk_complete
+};
+
+const char kRequest[] =
+    "GET /api/v1/users/12345?fields=name,email HTTP/1.1\r\n"
+    "Host: example.org\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:70.0) Gecko/20100101\r\n"
+    "Accept: application/json, text/plain, */*\r\n"
+    "Accept-Language: en-US,en;q=0.5\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Connection: keep-alive\r\n"
+    "Cookie: session=0123456789abcdef; theme=dark\r\n"
+    "\r\n";
+
+const char kChunkedResponse[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: application/json\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n"
+    "1a\r\n{\"id\":12345,\"name\":\"User\",\r\n"
+    "20\r\n\"email\":\"user12345@example.org\"}\r\n"
+    "0\r\n\r\n";
+
+void Parse(State& state,  // NOLINT(runtime/references)
+           llhttp_type_t type,
+           const std::string& input) {
+  ParseResult result;
+  llhttp_t parser;
+  llhttp_init(&parser, type, &kSettings);
+  parser.data = &result;
+  while (state.KeepRunning()) {
+    llhttp_errno_t err = llhttp_execute(&parser, input.data(), input.size());
+    if (err != HPE_OK) abort();
+  }
+  DoNotOptimize(result);
+  state.SetBytesProcessed(state.iterations() * input.size());
+  state.SetItemsProcessed(result.messages);
+}
+
+}  // anonymous namespace
+
+// Parses state.range(0) pipelined requests per iteration.
+static void BM_ParseRequest(State& state) {  // NOLINT(runtime/references)
+  std::string input;
+  for (int64_t i = 0; i < state.range(0); i++)
+    input += kRequest;
+  Parse(state, HTTP_REQUEST, input);
+}
+BENCHMARK(BM_ParseRequest)->Arg(1)->Arg(16);
+
+static void BM_ParseChunkedResponse(State& state) {  // NOLINT
+  Parse(state, HTTP_RESPONSE, kChunkedResponse);
+}
+BENCHMARK(BM_ParseChunkedResponse);
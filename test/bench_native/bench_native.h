@@ -0,0 +1,119 @@
+#ifndef TEST_BENCH_NATIVE_BENCH_NATIVE_H_
+#define TEST_BENCH_NATIVE_BENCH_NATIVE_H_
+
+// A small benchmark harness for C++ internals, with an interface modeled on
+// Google Benchmark:
+//
+//   static void BM_Something(bench_native::State& state) {
+//     std::string input(state.range(0), 'x');
+//     while (state.KeepRunning())
+//       bench_native::DoNotOptimize(Something(input));
+//     state.SetBytesProcessed(state.iterations() * input.size());
+//   }
+//   BENCHMARK(BM_Something)->Arg(64)->Arg(4096);
+//
+// The runner increases the number of iterations until a run takes at least
+// --min_time seconds, and reports the time per iteration of that run.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "v8.h"
+
+namespace bench_native {
+
+class State {
+ public:
+  State(int64_t iterations, int64_t arg)
+      : max_iterations_(iterations), arg_(arg) {}
+
+  // Returns true as long as the benchmark should run another iteration. The
+  // time between the first and the last call is measured.
+  inline bool KeepRunning();
+
+  int64_t range(size_t index = 0) const { return arg_; }
+  int64_t iterations() const { return max_iterations_; }
+
+  void SetBytesProcessed(int64_t bytes) { bytes_processed_ = bytes; }
+  void SetItemsProcessed(int64_t items) { items_processed_ = items; }
+
+  uint64_t elapsed_ns() const { return end_ - start_; }
+  int64_t bytes_processed() const { return bytes_processed_; }
+  int64_t items_processed() const { return items_processed_; }
+
+ private:
+  const int64_t max_iterations_;
+  const int64_t arg_;
+  int64_t completed_ = 0;
+  bool started_ = false;
+  uint64_t start_ = 0;
+  uint64_t end_ = 0;
+  int64_t bytes_processed_ = 0;
+  int64_t items_processed_ = 0;
+};
+
+typedef void (*Function)(State& state);  // NOLINT(runtime/references)
+
+class Benchmark {
+ public:
+  Benchmark(const char* name, Function fn) : name_(name), fn_(fn) {}
+
+  // Adds an argument that the benchmark is run with, as state.range(0).
+  Benchmark* Arg(int64_t arg) {
+    args_.push_back(arg);
+    return this;
+  }
+
+  const std::string& name() const { return name_; }
+  Function fn() const { return fn_; }
+  const std::vector<int64_t>& args() const { return args_; }
+
+ private:
+  std::string name_;
+  Function fn_;
+  std::vector<int64_t> args_;
+};
+
+Benchmark* RegisterBenchmark(const char* name, Function fn);
+
+// An isolate that is entered for the whole run, for benchmarks of code that
+// creates JS values. Benchmarks need to create their own HandleScope.
+v8::Isolate* isolate();
+
+uint64_t Now();
+
+bool State::KeepRunning() {
+  if (!started_) {
+    started_ = true;
+    start_ = Now();
+  }
+  if (completed_ < max_iterations_) {
+    completed_++;
+    return true;
+  }
+  end_ = Now();
+  return false;
+}
+
+// Keeps the compiler from optimizing away the computation of `value`.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");  // NOLINT(readability/braces)
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+}  // namespace bench_native
+
+#define BENCHMARK_CONCAT_(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_(a, b)
+
+#define BENCHMARK(fn)                                                         \
+  static ::bench_native::Benchmark* BENCHMARK_CONCAT(benchmark_, __LINE__) =  \
+      ::bench_native::RegisterBenchmark(#fn, fn)
+
+#endif  // TEST_BENCH_NATIVE_BENCH_NATIVE_H_
@@ -0,0 +1,184 @@
+#include "bench_native.h"
+
+#include "env-inl.h"
+#include "node.h"
+#include "node_internals.h"
+#include "node_platform.h"
+#include "util-inl.h"
+#include "uv.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#if defined(NODE_HAVE_I18N_SUPPORT)
+#include "node_i18n.h"
+#endif
+
+namespace bench_native {
+
+static std::vector<std::unique_ptr<Benchmark>>* benchmarks() {
+  static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+  return &benchmarks;
+}
+
+Benchmark* RegisterBenchmark(const char* name, Function fn) {
+  benchmarks()->emplace_back(new Benchmark(name, fn));
+  return benchmarks()->back().get();
+}
+
+static v8::Isolate* current_isolate = nullptr;
+
+v8::Isolate* isolate() {
+  return current_isolate;
+}
+
+uint64_t Now() {
+  return uv_hrtime();
+}
+
+struct Options {
+  const char* filter = nullptr;
+  double min_time = 0.5;
+  bool csv = false;
+};
+
+// Runs one benchmark with increasing iteration counts, and returns the state
+// of the first run that took at least `min_time` seconds.
+static State Measure(Function fn, int64_t arg, double min_time) {
+  const uint64_t min_ns = static_cast<uint64_t>(min_time * 1e9);
+  int64_t iterations = 1;
+  for (;;) {
+    State state(iterations, arg);
+    fn(state);
+    const uint64_t elapsed = state.elapsed_ns() > 0 ? state.elapsed_ns() : 1;
+    if (elapsed >= min_ns || iterations >= int64_t{1} << 40)
+      return state;
+    // Aim a bit beyond the minimum, but grow by at most 10x at a time so that
+    // a noisy short run does not produce a huge estimate.
+    double factor = 1.4 * min_ns / elapsed;
+    if (factor > 10) factor = 10;
+    if (factor < 2) factor = 2;
+    iterations = static_cast<int64_t>(iterations * factor);
+  }
+}
+
+static void Report(const std::string& name, const State& state, bool csv) {
+  const double ns_per_iteration =
+      static_cast<double>(state.elapsed_ns()) / state.iterations();
+  const double seconds = state.elapsed_ns() / 1e9;
+  const double bytes_per_second = state.bytes_processed() / seconds;
+  const double items_per_second = state.items_processed() / seconds;
+  if (csv) {
+    printf("\"%s\", %" PRId64 ", %f, %f, %f\n", name.c_str(),
+           state.iterations(), ns_per_iteration, bytes_per_second,
+           items_per_second);
+    return;
+  }
+  printf("%-48s %12" PRId64 " %14.2f ns", name.c_str(), state.iterations(),
+         ns_per_iteration);
+  if (state.bytes_processed() > 0)
+    printf(" %10.2f MB/s", bytes_per_second / (1024 * 1024));
+  if (state.items_processed() > 0)
+    printf(" %12.0f items/s", items_per_second);
+  printf("\n");
+  fflush(stdout);
+}
+
+static int RunBenchmarks(const Options& options) {
+  if (options.csv) {
+    printf("\"name\", \"iterations\", \"ns_per_iteration\", "
+           "\"bytes_per_second\", \"items_per_second\"\n");
+  } else {
+    printf("%-48s %12s %17s\n", "benchmark", "iterations", "time");
+  }
+  for (const auto& benchmark : *benchmarks()) {
+    std::vector<int64_t> args = benchmark->args();
+    if (args.empty())
+      args.push_back(0);
+    for (int64_t arg : args) {
+      std::string name = benchmark->name();
+      if (!benchmark->args().empty())
+        name += "/" + std::to_string(arg);
+      if (options.filter != nullptr &&
+          name.find(options.filter) == std::string::npos) {
+        continue;
+      }
+      Report(name, Measure(benchmark->fn(), arg, options.min_time),
+             options.csv);
+    }
+  }
+  return 0;
+}
+
+}  // namespace bench_native
+
+int main(int argc, char** argv) {
+  bench_native::Options options;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--filter=", 9) == 0) {
+      options.filter = argv[i] + 9;
+    } else if (strncmp(argv[i], "--min_time=", 11) == 0) {
+      options.min_time = atof(argv[i] + 11);
+    } else if (strcmp(argv[i], "--format=csv") == 0) {
+      options.csv = true;
+    } else {
+      fprintf(stderr,
+              "usage: %s [--filter=substring] [--min_time=seconds] "
+              "[--format=csv]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  uv_os_unsetenv("NODE_OPTIONS");
+  int exec_argc;
+  const char** exec_argv;
+  int node_argc = 1;
+  const char* argv0 = argv[0];
+  node::Init(&node_argc, &argv0, &exec_argc, &exec_argv);
+#if defined(NODE_HAVE_I18N_SUPPORT)
+  std::string icu_data_dir;
+  node::i18n::InitializeICUDirectory(icu_data_dir);
+#endif
+
+  auto tracing_agent = std::make_unique<node::tracing::Agent>();
+  node::tracing::TraceEventHelper::SetAgent(tracing_agent.get());
+  uv_loop_t loop;
+  CHECK_EQ(0, uv_loop_init(&loop));
+  auto platform = std::make_unique<node::NodePlatform>(
+      4, tracing_agent->GetTracingController());
+  v8::V8::InitializePlatform(platform.get());
+  v8::V8::Initialize();
+
+  int exit_code;
+  {
+    std::unique_ptr<node::ArrayBufferAllocator,
+                    decltype(&node::FreeArrayBufferAllocator)>
+        allocator(node::CreateArrayBufferAllocator(),
+                  &node::FreeArrayBufferAllocator);
+    v8::Isolate* isolate =
+        node::NewIsolate(allocator.get(), &loop, platform.get());
+    CHECK_NOT_NULL(isolate);
+    {
+      v8::Isolate::Scope isolate_scope(isolate);
+      v8::HandleScope handle_scope(isolate);
+      v8::Local<v8::Context> context = v8::Context::New(isolate);
+      v8::Context::Scope context_scope(context);
+      bench_native::current_isolate = isolate;
+      exit_code = bench_native::RunBenchmarks(options);
+      bench_native::current_isolate = nullptr;
+    }
+    platform->DrainTasks(isolate);
+    platform->UnregisterIsolate(isolate);
+    isolate->Dispose();
+  }
+
+  platform->Shutdown();
+  while (uv_loop_alive(&loop))
+    uv_run(&loop, UV_RUN_ONCE);
+  v8::V8::ShutdownPlatform();
+  CHECK_EQ(0, uv_loop_close(&loop));
+  return exit_code;
+}
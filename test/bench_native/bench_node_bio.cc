@@ -0,0 +1,52 @@
+#include "base_object-inl.h"
+#include "bench_native.h"
+#include "env-inl.h"
+#include "memory_tracker-inl.h"
+#include "node_crypto_bio.h"
+#include "util-inl.h"
+
+#include <algorithm>
+#include <string>
+
+using bench_native::DoNotOptimize;
+using bench_native::State;
+using node::crypto::BIOPointer;
+using node::crypto::NodeBIO;
+
+// Writes and reads back state.range(0) bytes per iteration, in TLS record
+// sized pieces, as TLSWrap does with the encrypted data.
+static void BM_NodeBIOWriteRead(State& state) {  // NOLINT(runtime/references)
+  const size_t size = state.range(0);
+  const size_t kRecordSize = 16 * 1024;
+  std::string chunk(kRecordSize, 'x');
+  std::string out(kRecordSize, '\0');
+  BIOPointer bio = NodeBIO::New();
+  NodeBIO* node_bio = NodeBIO::FromBIO(bio.get());
+  while (state.KeepRunning()) {
+    for (size_t written = 0; written < size; written += kRecordSize)
+      node_bio->Write(chunk.data(), std::min(kRecordSize, size - written));
+    while (node_bio->Length() > 0)
+      DoNotOptimize(node_bio->Read(&out[0], out.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_NodeBIOWriteRead)->Arg(1024)->Arg(64 * 1024)->Arg(1024 * 1024);
+
+// Reads the buffered data without copying it, as StreamBase writes do.
+static void BM_NodeBIOPeekMultiple(State& state) {  // NOLINT
+  const size_t size = state.range(0);
+  std::string data(size, 'x');
+  BIOPointer bio = NodeBIO::New();
+  NodeBIO* node_bio = NodeBIO::FromBIO(bio.get());
+  while (state.KeepRunning()) {
+    node_bio->Write(data.data(), data.size());
+    char* out[16];
+    size_t sizes[16];
+    size_t count = 16;
+    size_t length = node_bio->PeekMultiple(out, sizes, &count);
+    DoNotOptimize(out);
+    node_bio->Read(nullptr, length);
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_NodeBIOPeekMultiple)->Arg(1024)->Arg(64 * 1024);
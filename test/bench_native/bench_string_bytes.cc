@@ -0,0 +1,94 @@
+#include "base64.h"
+#include "bench_native.h"
+#include "string_bytes.h"
+#include "util-inl.h"
+
+#include <string>
+
+using bench_native::DoNotOptimize;
+using bench_native::State;
+using node::StringBytes;
+using v8::HandleScope;
+using v8::Isolate;
+using v8::Local;
+using v8::NewStringType;
+using v8::String;
+using v8::Value;
+
+// Printable input, so that the string encodings see the same bytes as base64
+// and hex do.
+static std::string Input(size_t size) {
+  std::string input(size, ' ');
+  for (size_t i = 0; i < size; i++)
+    input[i] = static_cast<char>('a' + i * 7 % 26);
+  return input;
+}
+
+static void BM_Base64Encode(State& state) {  // NOLINT(runtime/references)
+  const std::string input = Input(state.range(0));
+  std::string output(node::base64_encoded_size(input.size()), '\0');
+  while (state.KeepRunning()) {
+    DoNotOptimize(node::base64_encode(input.data(), input.size(), &output[0],
+                                      output.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_Base64Encode)->Arg(32)->Arg(1024)->Arg(64 * 1024);
+
+static void BM_Base64Decode(State& state) {  // NOLINT(runtime/references)
+  const std::string input = Input(state.range(0));
+  std::string encoded(node::base64_encoded_size(input.size()), '\0');
+  node::base64_encode(input.data(), input.size(), &encoded[0],
+                      encoded.size());
+  std::string output(input.size(), '\0');
+  while (state.KeepRunning()) {
+    DoNotOptimize(node::base64_decode(&output[0], output.size(),
+                                      encoded.data(), encoded.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+BENCHMARK(BM_Base64Decode)->Arg(32)->Arg(1024)->Arg(64 * 1024);
+
+// StringBytes::Encode() creates a string from bytes, as in buffer.toString().
+template <node::encoding kEncoding>
+static void BM_StringBytesEncode(State& state) {  // NOLINT(runtime/references)
+  Isolate* isolate = bench_native::isolate();
+  const std::string input = Input(state.range(0));
+  while (state.KeepRunning()) {
+    HandleScope handle_scope(isolate);
+    Local<Value> error;
+    DoNotOptimize(StringBytes::Encode(isolate, input.data(), input.size(),
+                                      kEncoding, &error).ToLocalChecked());
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_StringBytesEncode<node::UTF8>)->Arg(32)->Arg(64 * 1024);
+BENCHMARK(BM_StringBytesEncode<node::LATIN1>)->Arg(32)->Arg(64 * 1024);
+BENCHMARK(BM_StringBytesEncode<node::BASE64>)->Arg(32)->Arg(64 * 1024);
+BENCHMARK(BM_StringBytesEncode<node::HEX>)->Arg(32)->Arg(64 * 1024);
+
+// StringBytes::Write() writes a string into bytes, as in Buffer.from(string).
+// The input of the decoding encodings is the encoded form of the same bytes.
+template <node::encoding kEncoding>
+static void BM_StringBytesWrite(State& state) {  // NOLINT(runtime/references)
+  Isolate* isolate = bench_native::isolate();
+  HandleScope handle_scope(isolate);
+  const std::string input = Input(state.range(0));
+  Local<Value> error;
+  Local<Value> string =
+      kEncoding == node::UTF8 || kEncoding == node::LATIN1 ?
+          String::NewFromUtf8(isolate, input.data(), NewStringType::kNormal,
+                              input.size()).ToLocalChecked().As<Value>() :
+          StringBytes::Encode(isolate, input.data(), input.size(), kEncoding,
+                              &error).ToLocalChecked();
+  std::string output(input.size() + 3, '\0');
+  while (state.KeepRunning()) {
+    DoNotOptimize(StringBytes::Write(isolate, &output[0], output.size(),
+                                     string, kEncoding));
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_StringBytesWrite<node::UTF8>)->Arg(32)->Arg(64 * 1024);
+BENCHMARK(BM_StringBytesWrite<node::LATIN1>)->Arg(32)->Arg(64 * 1024);
+BENCHMARK(BM_StringBytesWrite<node::BASE64>)->Arg(32)->Arg(64 * 1024);
+BENCHMARK(BM_StringBytesWrite<node::HEX>)->Arg(32)->Arg(64 * 1024);
@@ -0,0 +1,23 @@
+'use strict';
+
+const common = require('../common');
+
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+if (!common.enoughTestMem)
+  common.skip('Insufficient memory for macro benchmark test');
+
+const runBenchmark = require('../common/benchmark');
+
+runBenchmark('macro',
+             [
+               'call=unary',
+               'ciphers=aes128',
+               'connections=1',
+               'dur=0.1',
+               'keepalive=1',
+               'messages=1',
+               'method=pipeTo',
+               'size=1024'
+             ]);
@@ -5,7 +5,9 @@ require('../common');
 const runBenchmark = require('../common/benchmark');
 
 runBenchmark('querystring',
-             [ 'n=1',
+             [ 'encoding=plain',
+               'fields=5',
+               'n=1',
                'input="there is nothing to unescape here"',
                'type=noencode'
              ],
@@ -6,7 +6,10 @@ const runBenchmark = require('../common/benchmark');
 
 runBenchmark('streams',
              [
+               'batch=true',
+               'items=1',
                'kind=duplex',
+               'method=parseJSON',
                'n=1',
                'sync=no',
                'writev=no',
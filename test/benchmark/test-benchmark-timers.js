@@ -7,6 +7,7 @@ const runBenchmark = require('../common/benchmark');
 runBenchmark('timers',
              [
                'direction=start',
+               'jitter=1',
                'n=1',
                'type=depth',
              ],
@@ -6,6 +6,8 @@ const runBenchmark = require('../common/benchmark');
 
 runBenchmark('v8',
              [
+               'api=serializeMany',
+               'count=1',
                'method=getHeapStatistics',
                'n=1'
              ],
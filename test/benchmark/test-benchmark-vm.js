@@ -8,6 +8,7 @@ runBenchmark('vm',
              [
                'breakOnSigint=0',
                'withSigintListener=0',
-               'n=1'
+               'n=1',
+               'ownGlobal=0'
              ],
              { NODEJS_BENCHMARK_ZERO_ALLOWED: 1 });
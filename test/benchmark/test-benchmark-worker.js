@@ -13,10 +13,13 @@ const runBenchmark = require('../common/benchmark');
 
 runBenchmark('worker',
              [
+               'len=16',
                'n=1',
                'sendsPerBroadcast=1',
                'workers=1',
-               'payload=string'
+               'payload=string',
+               'sender=worker',
+               'transport=channel'
              ],
              {
                NODEJS_BENCHMARK_ZERO_ALLOWED: 1
@@ -2,6 +2,8 @@
 
 #include <cstddef>
 #include <cstring>
+#include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -125,3 +127,50 @@ TEST(Base64Test, Decode) {
        "dCBjdXBpZGF0YXQgbm9uIHByb2lkZW50LCBzdW50IGluIGN1bHBhIHF1aSBvZmZpY2lh\n"
        "IGRlc2VydW50IG1vbGxpdCBhbmltIGlkIGVzdCBsYWJvcnVtLg", text);
 }
+
+TEST(Base64Test, EncodeURL) {
+  auto test = [](const char* string, const char* base64_string) {
+    const size_t len = strlen(base64_string);
+    EXPECT_EQ(len, node::base64_encoded_size(strlen(string),
+                                             node::Base64Mode::URL));
+    char* const buffer = new char[len + 1];
+    buffer[len] = 0;
+    base64_encode(string, strlen(string), buffer, len, node::Base64Mode::URL);
+    EXPECT_STREQ(base64_string, buffer);
+    delete[] buffer;
+  };
+
+  test("", "");
+  test("a", "YQ");
+  test("ab", "YWI");
+  test("abc", "YWJj");
+  test("\xfb\xff", "-_8");
+  test("\xfb\xff\xbf\xfb\xff\xbf\xfb\xff\xbf\xfb\xff\xbf\xfb\xff\xbf"
+       "\xfb\xff\xbf\xfb\xff\xbf\xfb\xff\xbf\xfb\xff\xbf\xfb\xff\xbf",
+       "-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_-_");
+}
+
+// Long inputs go through the vectorized code, if the CPU supports it.
+TEST(Base64Test, RoundTrip) {
+  for (size_t size = 0; size < 300; size++) {
+    std::vector<char> data(size);
+    for (size_t i = 0; i < size; i++)
+      data[i] = static_cast<char>(i * 7919 + size);
+
+    for (node::Base64Mode mode : { node::Base64Mode::NORMAL,
+                                   node::Base64Mode::URL }) {
+      std::string encoded(node::base64_encoded_size(size, mode), '\0');
+      EXPECT_EQ(encoded.size(), base64_encode(data.data(), size, &encoded[0],
+                                              encoded.size(), mode));
+
+      // Insert a line break to switch between vector and scalar code.
+      if (encoded.size() > 40)
+        encoded.insert(encoded.size() / 2, "\n");
+
+      std::vector<char> decoded(size);
+      EXPECT_EQ(size, base64_decode(decoded.data(), decoded.size(),
+                                    encoded.data(), encoded.size()));
+      EXPECT_EQ(data, decoded);
+    }
+  }
+}
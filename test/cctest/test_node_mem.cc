@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+#include "node.h"
+#include "env-inl.h"
+#include "node_mem-inl.h"
+#include "node_test_fixture.h"
+
+using node::Environment;
+using node::mem::NgLibMemoryManager;
+using v8::HandleScope;
+
+struct TestAllocator {
+  void* mem_user_data;
+  void* (*malloc)(size_t size, void* mem_user_data);
+  void (*free)(void* ptr, void* mem_user_data);
+  void* (*calloc)(size_t nmemb, size_t size, void* mem_user_data);
+  void* (*realloc)(void* ptr, size_t size, void* mem_user_data);
+};
+
+class TestMemoryManager
+    : public NgLibMemoryManager<TestMemoryManager, TestAllocator> {
+ public:
+  explicit TestMemoryManager(Environment* env) : env_(env) {}
+
+  void CheckAllocatedSize(size_t previous_size) const {
+    CHECK_GE(allocated_, previous_size);
+  }
+  void IncreaseAllocatedSize(size_t size) { allocated_ += size; }
+  void DecreaseAllocatedSize(size_t size) { allocated_ -= size; }
+  Environment* env() const { return env_; }
+
+  size_t allocated() const { return allocated_; }
+
+ private:
+  Environment* env_;
+  size_t allocated_ = 0;
+};
+
+class NgLibMemoryManagerTest : public EnvironmentTestFixture {};
+
+TEST_F(NgLibMemoryManagerTest, PooledBlocks) {
+  const HandleScope handle_scope(isolate_);
+  const Argv argv;
+  Env env_{handle_scope, argv};
+
+  TestMemoryManager manager(*env_);
+  TestAllocator allocator = manager.MakeAllocator();
+  void* data = allocator.mem_user_data;
+
+  // Small allocations are rounded up to a size class, including the size
+  // that is stored in front of them.
+  void* a = allocator.malloc(20, data);
+  ASSERT_NE(a, nullptr);
+  EXPECT_EQ(manager.allocated(), 32u);
+  memset(a, 'a', 20);
+
+  // Freed blocks are kept, and handed out again for the same size class.
+  allocator.free(a, data);
+  EXPECT_EQ(manager.allocated(), 0u);
+  EXPECT_EQ(manager.PooledMemory(), 32u);
+  void* b = allocator.calloc(2, 8, data);
+  EXPECT_EQ(b, a);
+  EXPECT_EQ(manager.PooledMemory(), 0u);
+  for (size_t i = 0; i < 16; i++)
+    EXPECT_EQ(static_cast<char*>(b)[i], 0);
+
+  // Pooled blocks can be resized.
+  b = allocator.realloc(b, 100, data);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(manager.allocated(), 100 + sizeof(size_t));
+  allocator.free(b, data);
+  EXPECT_EQ(manager.allocated(), 0u);
+  EXPECT_EQ(manager.PooledMemory(), 0u);
+
+  // Large allocations are not pooled.
+  void* c = allocator.malloc(4096, data);
+  EXPECT_EQ(manager.allocated(), 4096 + sizeof(size_t));
+  allocator.free(c, data);
+  EXPECT_EQ(manager.PooledMemory(), 0u);
+
+  // The number of blocks that are kept per size class is limited.
+  void* blocks[20];
+  for (void*& block : blocks)
+    block = allocator.malloc(200, data);
+  EXPECT_EQ(manager.allocated(), 20 * 256u);
+  for (void* block : blocks)
+    allocator.free(block, data);
+  EXPECT_EQ(manager.allocated(), 0u);
+  EXPECT_EQ(manager.PooledMemory(), 16 * 256u);
+
+  // Blocks whose memory is no longer tracked are not returned to the pool.
+  void* d = allocator.malloc(200, data);
+  EXPECT_EQ(manager.PooledMemory(), 15 * 256u);
+  manager.StopTrackingMemory(d);
+  EXPECT_EQ(manager.allocated(), 0u);
+  allocator.free(d, data);
+  EXPECT_EQ(manager.PooledMemory(), 15 * 256u);
+}
@@ -0,0 +1,93 @@
+#include "utf8.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using node::Utf8Info;
+using node::utf8_to_latin1;
+using node::utf8_to_utf16;
+using node::utf8_validate;
+
+TEST(Utf8Test, Validate) {
+  auto valid = [](const std::string& input) {
+    return utf8_validate(input.data(), input.size());
+  };
+
+  // Every offset within and around the vector sizes.
+  for (size_t pad = 0; pad < 70; pad++) {
+    const std::string prefix(pad, 'a');
+    EXPECT_TRUE(valid(prefix));
+    EXPECT_TRUE(valid(prefix + "\xc2\x80"));
+    EXPECT_TRUE(valid(prefix + "\xdf\xbf"));
+    EXPECT_TRUE(valid(prefix + "\xe0\xa0\x80"));
+    EXPECT_TRUE(valid(prefix + "\xed\x9f\xbf"));
+    EXPECT_TRUE(valid(prefix + "\xee\x80\x80"));
+    EXPECT_TRUE(valid(prefix + "\xef\xbf\xbf"));
+    EXPECT_TRUE(valid(prefix + "\xf0\x90\x80\x80"));
+    EXPECT_TRUE(valid(prefix + "\xf4\x8f\xbf\xbf" + prefix));
+
+    EXPECT_FALSE(valid(prefix + "\x80"));
+    EXPECT_FALSE(valid(prefix + "\xc0\x80"));             // Overlong.
+    EXPECT_FALSE(valid(prefix + "\xc1\xbf"));             // Overlong.
+    EXPECT_FALSE(valid(prefix + "\xe0\x9f\xbf"));         // Overlong.
+    EXPECT_FALSE(valid(prefix + "\xed\xa0\x80"));         // Surrogate.
+    EXPECT_FALSE(valid(prefix + "\xf0\x8f\xbf\xbf"));     // Overlong.
+    EXPECT_FALSE(valid(prefix + "\xf4\x90\x80\x80"));     // Too large.
+    EXPECT_FALSE(valid(prefix + "\xf8\x88\x80\x80\x80"));
+    EXPECT_FALSE(valid(prefix + "\xff" + prefix));
+    EXPECT_FALSE(valid(prefix + "\xc3"));                 // Truncated.
+    EXPECT_FALSE(valid(prefix + "\xe2\x82"));
+    EXPECT_FALSE(valid(prefix + "\xf0\x9f\x98"));
+    EXPECT_FALSE(valid(prefix + "\xe2\x82" + prefix));
+    EXPECT_FALSE(valid(prefix + "\xc3\xa9\xa9"));
+  }
+}
+
+TEST(Utf8Test, Transcode) {
+  auto test = [](const std::string& input,
+                 const std::vector<uint16_t>& expected) {
+    Utf8Info info;
+    ASSERT_TRUE(utf8_validate(input.data(), input.size(), &info));
+    EXPECT_EQ(info.utf16_length, expected.size());
+
+    std::vector<uint16_t> utf16(info.utf16_length);
+    EXPECT_EQ(utf8_to_utf16(input.data(), input.size(), utf16.data()),
+              expected.size());
+    EXPECT_EQ(utf16, expected);
+
+    bool latin1 = true;
+    for (uint16_t c : expected) latin1 = latin1 && c <= 0xff;
+    EXPECT_EQ(info.latin1, latin1);
+    if (latin1) {
+      std::vector<uint8_t> one_byte(info.utf16_length);
+      EXPECT_EQ(utf8_to_latin1(input.data(), input.size(),
+                               reinterpret_cast<char*>(one_byte.data())),
+                expected.size());
+      EXPECT_EQ(std::vector<uint16_t>(one_byte.begin(), one_byte.end()),
+                expected);
+    }
+  };
+
+  test("", {});
+  test("abc", { 'a', 'b', 'c' });
+  test("\xc3\xa9t\xc3\xa9", { 0xe9, 't', 0xe9 });
+  test("\xe2\x82\xac", { 0x20ac });
+  test("\xf0\x9f\x98\x80!", { 0xd83d, 0xde00, '!' });
+
+  // Long runs of ASCII around other characters.
+  std::string input;
+  std::vector<uint16_t> expected;
+  for (int i = 0; i < 100; i++) {
+    input += std::string(i, 'x') + "\xc3\xbf";
+    expected.insert(expected.end(), i, 'x');
+    expected.push_back(0xff);
+  }
+  test(input, expected);
+  input += "\xe4\xb8\xad";
+  expected.push_back(0x4e2d);
+  test(input, expected);
+}
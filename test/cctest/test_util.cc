@@ -253,6 +253,53 @@ TEST(UtilTest, MaybeStackBuffer) {
   }
 }
 
+TEST(UtilTest, ScratchArena) {
+  using node::MaybeStackBuffer;
+  using node::ScratchArena;
+
+  ScratchArena arena;
+  EXPECT_EQ(0U, arena.capacity());
+
+  // The most recent allocation is reclaimed right away.
+  void* first = arena.Allocate(100);
+  EXPECT_EQ(ScratchArena::kChunkSize, arena.capacity());
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(first) %
+                alignof(std::max_align_t));
+  void* second = arena.Allocate(10);
+  arena.Free(second, 10);
+  EXPECT_EQ(second, arena.Allocate(10));
+  arena.Free(first, 100);
+  arena.Free(second, 10);
+  EXPECT_EQ(0U, arena.live_allocations());
+
+  // Allocations that do not fit into a chunk get their own one, which is
+  // released on reset.
+  void* large = arena.Allocate(ScratchArena::kChunkSize * 2);
+  EXPECT_EQ(ScratchArena::kChunkSize * 3, arena.capacity());
+  arena.Reset();
+  EXPECT_EQ(ScratchArena::kChunkSize * 3, arena.capacity());
+  arena.Free(large, ScratchArena::kChunkSize * 2);
+  arena.Reset();
+  EXPECT_EQ(ScratchArena::kChunkSize, arena.capacity());
+
+  // MaybeStackBuffer spills into the arena and keeps its contents.
+  {
+    MaybeStackBuffer<unsigned char, 16> buf(&arena, 10);
+    EXPECT_FALSE(buf.IsAllocated());
+    for (size_t i = 0; i < buf.length(); i++)
+      buf[i] = static_cast<unsigned char>(i);
+    buf.AllocateSufficientStorage(1000);
+    EXPECT_TRUE(buf.IsAllocated());
+    EXPECT_EQ(1U, arena.live_allocations());
+    buf.AllocateSufficientStorage(2000);
+    EXPECT_EQ(1U, arena.live_allocations());
+    for (size_t i = 0; i < 10; i++)
+      EXPECT_EQ(static_cast<unsigned char>(i), buf[i]);
+  }
+  EXPECT_EQ(0U, arena.live_allocations());
+  EXPECT_EQ(ScratchArena::kChunkSize, arena.capacity());
+}
+
 TEST(UtilTest, SPrintF) {
   using node::SPrintF;
 
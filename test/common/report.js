@@ -162,6 +162,8 @@ function _validateContent(report) {
   const heap = report.javascriptHeap;
   const jsHeapFields = ['totalMemory', 'totalCommittedMemory', 'usedMemory',
                         'availableMemory', 'memoryLimit', 'heapSpaces'];
+  if (heap.largePages !== undefined)
+    jsHeapFields.push('largePages');
   checkForUnknownFields(heap, jsHeapFields);
   assert(Number.isSafeInteger(heap.totalMemory));
   assert(Number.isSafeInteger(heap.totalCommittedMemory));
@@ -178,6 +180,12 @@ function _validateContent(report) {
       assert(Number.isSafeInteger(space[field]));
     });
   });
+  if (heap.largePages !== undefined) {
+    checkForUnknownFields(heap.largePages,
+                          ['reservedMemory', 'largePageMemory']);
+    assert(Number.isSafeInteger(heap.largePages.reservedMemory));
+    assert(Number.isSafeInteger(heap.largePages.largePageMemory));
+  }
 
   // Verify the format of the resourceUsage section.
   const usage = report.resourceUsage;
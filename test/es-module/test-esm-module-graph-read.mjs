@@ -0,0 +1,37 @@
+import { mustCall } from '../common/index.mjs';
+import tmpdir from '../common/tmpdir.js';
+import assert from 'assert';
+import fs from 'fs';
+import path from 'path';
+import { pathToFileURL } from 'url';
+
+// Test that module graphs whose files are read concurrently are loaded
+// correctly, including files that are too large to be read in one go.
+
+tmpdir.refresh();
+
+const kDependencies = 50;
+const imports = [];
+for (let i = 0; i < kDependencies; i++) {
+  fs.writeFileSync(path.join(tmpdir.path, `dep${i}.mjs`),
+                   `export default ${i};`);
+  imports.push(`import dep${i} from './dep${i}.mjs';`);
+}
+
+// Larger than the files that are read in a single threadpool job.
+const padding = `/*${' '.repeat(1024 * 1024)}*/`;
+fs.writeFileSync(path.join(tmpdir.path, 'large.mjs'),
+                 `${padding}\nexport default 'large';`);
+
+const names = Array.from({ length: kDependencies }, (_, i) => `dep${i}`);
+fs.writeFileSync(path.join(tmpdir.path, 'main.mjs'), `
+  ${imports.join('\n')}
+  import large from './large.mjs';
+  export default [${names.join(' + ')}, large];
+`);
+
+import(pathToFileURL(path.join(tmpdir.path, 'main.mjs'))).then(
+  mustCall(({ default: result }) => {
+    assert.deepStrictEqual(result,
+                           [kDependencies * (kDependencies - 1) / 2, 'large']);
+  }));
@@ -5,6 +5,7 @@ const { spawn } = require('child_process');
 const assert = require('assert');
 const path = require('path');
 const fs = require('fs');
+const { pathToFileURL } = require('url');
 
 const tmpdir = require('../common/tmpdir');
 tmpdir.refresh();
@@ -17,18 +18,27 @@ const link_relative_path = path.join(tmpDir, 'relative.mjs');
 const link_ignore_extension = path.join(tmpDir,
                                         'ignore_extension.json');
 const link_directory = path.join(tmpDir, 'directory');
+const real_meta = path.join(tmpDir, 'meta file.mjs');
+const link_meta = path.join(tmpDir, 'meta.mjs');
 
 fs.writeFileSync(real, 'export default [];');
+fs.writeFileSync(real_meta, 'export default import.meta.url;');
 fs.writeFileSync(entry, `
 import assert from 'assert';
 import real from './index.mjs';
 import absolute from './absolute.mjs';
 import relative from './relative.mjs';
 import ignoreExtension from './ignore_extension.json';
+import viaDirectory from './directory/index.mjs';
+import metaUrl from './meta.mjs?query#fragment';
 
 assert.strictEqual(absolute, real);
 assert.strictEqual(relative, real);
 assert.strictEqual(ignoreExtension, real);
+assert.strictEqual(viaDirectory, real);
+assert.strictEqual(metaUrl,
+                   ${JSON.stringify(`${pathToFileURL(real_meta)}`)} +
+                   '?query#fragment');
 `);
 
 try {
@@ -36,6 +46,7 @@ try {
   fs.symlinkSync(path.basename(real), link_relative_path);
   fs.symlinkSync(real, link_ignore_extension);
   fs.symlinkSync(path.dirname(real), link_directory, 'dir');
+  fs.symlinkSync(real_meta, link_meta);
 } catch (err) {
   if (err.code !== 'EPERM') throw err;
   common.skip('insufficient privileges for symlinks');
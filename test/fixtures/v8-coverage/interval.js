@@ -0,0 +1,7 @@
+'use strict';
+let calls = 0;
+function tick() {
+  if (++calls < 10)
+    setTimeout(tick, 20);
+}
+tick();
@@ -0,0 +1,35 @@
+'use strict';
+const common = require('../../common');
+const assert = require('assert');
+
+// Testing functions with a typed fast path.
+const test_fast_function =
+  require(`./build/${common.buildType}/test_fast_function`);
+const { add, isEven, getCalls } = test_fast_function;
+
+assert.strictEqual(add.name, 'add');
+
+// Arguments of the declared types take the fast path; extra arguments are
+// ignored.
+assert.strictEqual(add(1, 2), 3);
+assert.strictEqual(add(0.5, -2.25, 'extra'), -1.75);
+assert.deepStrictEqual(getCalls(), { fast: 2, slow: 0 });
+
+// Everything else takes the regular path.
+assert.throws(() => add('1', 2), /Numbers expected/);
+assert.throws(() => add(1), /Numbers expected/);
+assert.strictEqual(typeof new add(1, 2), 'object');
+assert.deepStrictEqual(getCalls(), { fast: 0, slow: 3 });
+
+// Integers are not converted implicitly.
+assert.strictEqual(isEven(4), true);
+assert.strictEqual(isEven(-7), false);
+assert.strictEqual(isEven(2 ** 40), true);
+assert.deepStrictEqual(getCalls(), { fast: 3, slow: 0 });
+assert.strictEqual(isEven(1.5), null);
+assert.strictEqual(isEven(2 ** 60), null);
+assert.strictEqual(isEven(NaN), null);
+assert.strictEqual(isEven(true), null);
+assert.deepStrictEqual(getCalls(), { fast: 0, slow: 4 });
+
+assert.strictEqual(test_fast_function.testInvalidSignature(), true);
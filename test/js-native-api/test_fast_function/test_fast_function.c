@@ -0,0 +1,107 @@
+#define NAPI_EXPERIMENTAL
+#include <js_native_api.h>
+#include "../common.h"
+
+static uint32_t fast_calls = 0;
+static uint32_t slow_calls = 0;
+
+static void AddFast(void* data,
+                    const napi_fast_value* args,
+                    napi_fast_value* result) {
+  fast_calls++;
+  result->double_value = args[0].double_value + args[1].double_value;
+}
+
+static napi_value AddSlow(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value args[2];
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+  slow_calls++;
+
+  napi_valuetype type0, type1;
+  NAPI_CALL(env, napi_typeof(env, args[0], &type0));
+  NAPI_CALL(env, napi_typeof(env, args[1], &type1));
+  NAPI_ASSERT(env, type0 == napi_number && type1 == napi_number,
+      "Wrong argument types. Numbers expected.");
+
+  double a, b;
+  NAPI_CALL(env, napi_get_value_double(env, args[0], &a));
+  NAPI_CALL(env, napi_get_value_double(env, args[1], &b));
+
+  napi_value result;
+  NAPI_CALL(env, napi_create_double(env, a + b, &result));
+  return result;
+}
+
+static void IsEvenFast(void* data,
+                       const napi_fast_value* args,
+                       napi_fast_value* result) {
+  fast_calls++;
+  result->bool_value = args[0].int64_value % 2 == 0;
+}
+
+static napi_value IsEvenSlow(napi_env env, napi_callback_info info) {
+  slow_calls++;
+  napi_value result;
+  NAPI_CALL(env, napi_get_null(env, &result));
+  return result;
+}
+
+static napi_value GetCalls(napi_env env, napi_callback_info info) {
+  napi_value result, value;
+  NAPI_CALL(env, napi_create_object(env, &result));
+  NAPI_CALL(env, napi_create_uint32(env, fast_calls, &value));
+  NAPI_CALL(env, napi_set_named_property(env, result, "fast", value));
+  NAPI_CALL(env, napi_create_uint32(env, slow_calls, &value));
+  NAPI_CALL(env, napi_set_named_property(env, result, "slow", value));
+  fast_calls = slow_calls = 0;
+  return result;
+}
+
+static napi_value TestInvalidSignature(napi_env env, napi_callback_info info) {
+  napi_fast_type arg_types[] = { napi_fast_void };
+  napi_fast_signature signature = { napi_fast_double, 1, arg_types };
+  napi_value fn;
+  napi_status status = napi_create_fast_function(
+      env, NULL, 0, &signature, AddFast, AddSlow, NULL, &fn);
+  NAPI_ASSERT(env, status == napi_invalid_arg,
+      "A void argument should be rejected");
+
+  napi_value result;
+  NAPI_CALL(env, napi_get_boolean(env, true, &result));
+  return result;
+}
+
+EXTERN_C_START
+napi_value Init(napi_env env, napi_value exports) {
+  static const napi_fast_type add_args[] = {
+    napi_fast_double, napi_fast_double
+  };
+  static const napi_fast_signature add_signature = {
+    napi_fast_double, 2, add_args
+  };
+  static const napi_fast_type is_even_args[] = { napi_fast_int64 };
+  static const napi_fast_signature is_even_signature = {
+    napi_fast_bool, 1, is_even_args
+  };
+
+  napi_value fn;
+  NAPI_CALL(env, napi_create_fast_function(
+      env, "add", NAPI_AUTO_LENGTH, &add_signature, AddFast, AddSlow, NULL,
+      &fn));
+  NAPI_CALL(env, napi_set_named_property(env, exports, "add", fn));
+  NAPI_CALL(env, napi_create_fast_function(
+      env, "isEven", NAPI_AUTO_LENGTH, &is_even_signature, IsEvenFast,
+      IsEvenSlow, NULL, &fn));
+  NAPI_CALL(env, napi_set_named_property(env, exports, "isEven", fn));
+
+  napi_property_descriptor descriptors[] = {
+    DECLARE_NAPI_PROPERTY("getCalls", GetCalls),
+    DECLARE_NAPI_PROPERTY("testInvalidSignature", TestInvalidSignature),
+  };
+  NAPI_CALL(env, napi_define_properties(
+      env, exports, sizeof(descriptors) / sizeof(*descriptors), descriptors));
+
+  return exports;
+}
+EXTERN_C_END
@@ -0,0 +1,8 @@
+{
+  "targets": [
+    {
+      "target_name": "test_buffer_pool",
+      "sources": [ "test_buffer_pool.c" ]
+    }
+  ]
+}
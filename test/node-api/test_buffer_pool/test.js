@@ -0,0 +1,40 @@
+'use strict';
+// Flags: --expose-gc
+
+const common = require('../../common');
+const binding = require(`./build/${common.buildType}/test_buffer_pool`);
+const assert = require('assert');
+const setImmediatePromise = require('util').promisify(setImmediate);
+
+(async function() {
+  binding.createPool();
+
+  let first = binding.bufferFromPool(0, 16);
+  let second = binding.bufferFromPool(16, 48);
+  assert.ok(first instanceof Buffer);
+  assert.deepStrictEqual([...first], Array.from({ length: 16 }, (_, i) => i));
+  assert.strictEqual(second[0], 16);
+  assert.strictEqual(second.length, 48);
+  // Both views share the memory of the slab.
+  assert.strictEqual(first.buffer, second.buffer);
+  assert.strictEqual(binding.bufferFromPool(64, 0).length, 0);
+
+  assert.throws(() => binding.bufferFromPool(60, 8), {
+    message: 'Invalid argument'
+  });
+  assert.throws(() => binding.bufferFromPool(65, 0), {
+    message: 'Invalid argument'
+  });
+
+  // The slab is kept alive by the pool and by the Buffers created from it.
+  binding.deletePool();
+  global.gc();
+  await setImmediatePromise();
+  assert.strictEqual(binding.getFinalizeCount(), 0);
+  assert.strictEqual(second[47], 63);
+
+  first = second = null;
+  global.gc();
+  await setImmediatePromise();
+  assert.strictEqual(binding.getFinalizeCount(), 1);
+})().then(common.mustCall());
@@ -0,0 +1,78 @@
+#include <stdlib.h>
+#define NAPI_EXPERIMENTAL
+#include <node_api.h>
+#include "../../js-native-api/common.h"
+
+#define SLAB_SIZE 64
+
+static napi_buffer_pool pool;
+static unsigned char* slab;
+static int finalizeCount = 0;
+
+static void finalizeSlab(napi_env env, void* data, void* finalize_hint) {
+  NAPI_ASSERT_RETURN_VOID(env, data == slab, "invalid data");
+  (void)finalize_hint;
+  free(data);
+  slab = NULL;
+  finalizeCount++;
+}
+
+static napi_value createPool(napi_env env, napi_callback_info info) {
+  int i;
+
+  slab = malloc(SLAB_SIZE);
+  NAPI_ASSERT(env, slab != NULL, "Failed to allocate the slab");
+  for (i = 0; i < SLAB_SIZE; i++) {
+    slab[i] = (unsigned char)i;
+  }
+
+  NAPI_CALL(env, napi_create_buffer_pool(
+      env, slab, SLAB_SIZE, finalizeSlab, NULL, &pool));
+
+  return NULL;
+}
+
+static napi_value bufferFromPool(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value args[2], result;
+  uint32_t offset, length;
+  void* data;
+
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, args, NULL, NULL));
+  NAPI_ASSERT(env, argc == 2, "Wrong number of arguments");
+  NAPI_CALL(env, napi_get_value_uint32(env, args[0], &offset));
+  NAPI_CALL(env, napi_get_value_uint32(env, args[1], &length));
+
+  NAPI_CALL(env, napi_create_buffer_from_pool(
+      env, pool, offset, length, &data, &result));
+  NAPI_ASSERT(env, data == slab + offset, "Wrong data pointer");
+
+  return result;
+}
+
+static napi_value deletePool(napi_env env, napi_callback_info info) {
+  NAPI_CALL(env, napi_delete_buffer_pool(env, pool));
+  return NULL;
+}
+
+static napi_value getFinalizeCount(napi_env env, napi_callback_info info) {
+  napi_value count;
+  NAPI_CALL(env, napi_create_int32(env, finalizeCount, &count));
+  return count;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  napi_property_descriptor methods[] = {
+    DECLARE_NAPI_PROPERTY("createPool", createPool),
+    DECLARE_NAPI_PROPERTY("bufferFromPool", bufferFromPool),
+    DECLARE_NAPI_PROPERTY("deletePool", deletePool),
+    DECLARE_NAPI_PROPERTY("getFinalizeCount", getFinalizeCount),
+  };
+
+  NAPI_CALL(env, napi_define_properties(
+      env, exports, sizeof(methods) / sizeof(methods[0]), methods));
+
+  return exports;
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -0,0 +1,99 @@
+#include <uv.h>
+#define NAPI_EXPERIMENTAL
+#include <node_api.h>
+#include "../../js-native-api/common.h"
+
+#define ARRAY_LENGTH 1000
+
+static uv_thread_t uv_thread;
+static napi_threadsafe_function ts_fn;
+static int ints[ARRAY_LENGTH];
+
+static void data_source_thread(void* data) {
+  int index;
+
+  for (index = 0; index < ARRAY_LENGTH; index++) {
+    ints[index] = index;
+    if (napi_call_threadsafe_function(ts_fn, &ints[index],
+        napi_tsfn_blocking) != napi_ok) {
+      napi_fatal_error("data_source_thread", NAPI_AUTO_LENGTH,
+          "napi_call_threadsafe_function failed", NAPI_AUTO_LENGTH);
+    }
+  }
+
+  if (napi_release_threadsafe_function(ts_fn, napi_tsfn_release) != napi_ok) {
+    napi_fatal_error("data_source_thread", NAPI_AUTO_LENGTH,
+        "napi_release_threadsafe_function failed", NAPI_AUTO_LENGTH);
+  }
+}
+
+// Passes each batch to JavaScript as an array of integers.
+static void call_js_batch(napi_env env,
+                          napi_value cb,
+                          void* context,
+                          void** data,
+                          size_t count) {
+  napi_value argv[1], undefined, value;
+  size_t index;
+
+  if (env == NULL || cb == NULL) return;
+
+  NAPI_CALL_RETURN_VOID(env, napi_create_array_with_length(env, count, argv));
+  for (index = 0; index < count; index++) {
+    NAPI_CALL_RETURN_VOID(env,
+        napi_create_int32(env, *(int*)data[index], &value));
+    NAPI_CALL_RETURN_VOID(env,
+        napi_set_element(env, argv[0], (uint32_t)index, value));
+  }
+  NAPI_CALL_RETURN_VOID(env, napi_get_undefined(env, &undefined));
+  NAPI_CALL_RETURN_VOID(env,
+      napi_call_function(env, undefined, cb, 1, argv, NULL));
+}
+
+// Queues all values from a secondary thread and waits for it to finish, so
+// that the values are delivered in full batches once the loop runs.
+static napi_value StartThread(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2], async_name;
+  uint32_t max_batch_size;
+
+  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL));
+  NAPI_ASSERT(env, argc == 2, "Wrong number of arguments");
+  NAPI_CALL(env, napi_get_value_uint32(env, argv[1], &max_batch_size));
+  NAPI_CALL(env, napi_create_string_utf8(env,
+      "N-API Thread-safe Function Batched Test", NAPI_AUTO_LENGTH,
+      &async_name));
+  NAPI_CALL(env, napi_create_threadsafe_function_batched(env,
+      argv[0], NULL, async_name, 0, max_batch_size, 1, NULL, NULL, NULL,
+      call_js_batch, &ts_fn));
+  NAPI_ASSERT(env, uv_thread_create(&uv_thread, data_source_thread,
+      NULL) == 0, "Thread creation");
+  NAPI_ASSERT(env, uv_thread_join(&uv_thread) == 0, "Thread join");
+  return NULL;
+}
+
+static napi_value Init(napi_env env, napi_value exports) {
+  napi_value js_array_length;
+  napi_property_descriptor properties[] = {
+    {
+      "ARRAY_LENGTH",
+      NULL,
+      NULL,
+      NULL,
+      NULL,
+      NULL,
+      napi_enumerable,
+      NULL
+    },
+    DECLARE_NAPI_PROPERTY("StartThread", StartThread),
+  };
+
+  NAPI_CALL(env, napi_create_uint32(env, ARRAY_LENGTH, &js_array_length));
+  properties[0].value = js_array_length;
+
+  NAPI_CALL(env, napi_define_properties(env, exports,
+    sizeof(properties)/sizeof(properties[0]), properties));
+
+  return exports;
+}
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
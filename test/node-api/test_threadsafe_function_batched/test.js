@@ -0,0 +1,24 @@
+'use strict';
+
+const common = require('../../common');
+const assert = require('assert');
+const binding = require(`./build/${common.buildType}/binding`);
+
+// All values are queued before the event loop gets to run, so they are
+// delivered in order and in batches of exactly `maxBatchSize` items, except
+// for the last one.
+for (const maxBatchSize of [1, 16, 2000]) {
+  const received = [];
+  const batches = Math.ceil(binding.ARRAY_LENGTH / maxBatchSize);
+  binding.StartThread(common.mustCall((values) => {
+    const remaining = binding.ARRAY_LENGTH - received.length;
+    assert.strictEqual(values.length, Math.min(remaining, maxBatchSize));
+    received.push(...values);
+  }, batches), maxBatchSize);
+
+  process.on('exit', () => {
+    assert.deepStrictEqual(received,
+                           Array.from({ length: binding.ARRAY_LENGTH },
+                                      (_, index) => index));
+  });
+}
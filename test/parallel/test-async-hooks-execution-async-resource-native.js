@@ -0,0 +1,35 @@
+// Flags: --expose-internals
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const { executionAsyncResource } = require('async_hooks');
+const { internalBinding } = require('internal/test/binding');
+const { getCallbackScopeStats } = internalBinding('async_wrap');
+
+// Test that executionAsyncResource() returns the resources that are pushed
+// onto the execution stack from C++, and that callbacks which do not schedule
+// a tick close their callback scopes without calling into JS again.
+
+const before = getCallbackScopeStats();
+assert.strictEqual(before.length, 2);
+
+fs.stat(__filename, common.mustCall(() => {
+  const resource = executionAsyncResource();
+  assert.strictEqual(resource.constructor.name, 'FSReqCallback');
+
+  // Resources that are pushed from JS are returned as before.
+  setImmediate(common.mustCall(() => {
+    assert.notStrictEqual(executionAsyncResource(), resource);
+
+    fs.stat(__filename, common.mustCall(() => {
+      const [fast, slow] = getCallbackScopeStats();
+      assert.ok(fast > before[0]);
+      assert.ok(slow >= before[1]);
+      process.nextTick(common.mustCall(() => {
+        assert.ok(getCallbackScopeStats()[1] > slow);
+      }));
+    }));
+  }));
+}));
@@ -0,0 +1,37 @@
+'use strict';
+
+require('../common');
+
+// This tests the statistics that compare-stats.js uses, against values
+// computed with R.
+
+const assert = require('assert');
+
+const {
+  studentTCdf,
+  studentTQuantile,
+  welchTTest
+} = require('../../benchmark/_stats.js');
+
+function assertClose(actual, expected, digits) {
+  assert.ok(Math.abs(actual - expected) < 10 ** -digits,
+            `${actual} is not close to ${expected}`);
+}
+
+// pt(2, 5), pt(-1, 1)
+assertClose(studentTCdf(2, 5), 0.9490303, 7);
+assertClose(studentTCdf(-1, 1), 0.25, 10);
+
+// qt(0.975, 10), qt(0.9995, 2), qt(0.005, 30)
+assertClose(studentTQuantile(0.975, 10), 2.228139, 6);
+assertClose(studentTQuantile(0.9995, 2), 31.59905, 5);
+assertClose(studentTQuantile(0.005, 30), -2.749996, 6);
+assert.strictEqual(studentTQuantile(0.5, 7), 0);
+
+// t.test(1:10, 7:20)
+const range = (from, to) => Array.from({ length: to - from + 1 },
+                                       (_, i) => from + i);
+const { t, df, p } = welchTTest(range(1, 10), range(7, 20));
+assertClose(t, -5.434929, 6);
+assertClose(df, 21.98221, 5);
+assertClose(p, 1.855282e-05, 10);
@@ -49,16 +49,7 @@ const expectedModules = new Set([
   'NativeModule internal/modules/run_main',
   'NativeModule internal/modules/cjs/helpers',
   'NativeModule internal/modules/cjs/loader',
-  'NativeModule internal/modules/esm/create_dynamic_module',
-  'NativeModule internal/modules/esm/get_format',
-  'NativeModule internal/modules/esm/get_source',
-  'NativeModule internal/modules/esm/loader',
-  'NativeModule internal/modules/esm/module_job',
-  'NativeModule internal/modules/esm/module_map',
-  'NativeModule internal/modules/esm/resolve',
-  'NativeModule internal/modules/esm/transform_source',
-  'NativeModule internal/modules/esm/translators',
-  'NativeModule internal/process/esm_loader',
+  'NativeModule internal/modules/compile_cache',
   'NativeModule internal/options',
   'NativeModule internal/priority_queue',
   'NativeModule internal/process/execution',
@@ -76,11 +67,9 @@ const expectedModules = new Set([
   'NativeModule internal/util/inspect',
   'NativeModule internal/util/types',
   'NativeModule internal/validators',
-  'NativeModule internal/vm/module',
   'NativeModule path',
   'NativeModule timers',
   'NativeModule url',
-  'NativeModule vm',
 ]);
 
 if (!common.isMainThread) {
@@ -113,7 +102,6 @@ if (common.hasIntl) {
 }
 
 if (process.features.inspector) {
-  expectedModules.add('NativeModule internal/inspector_async_hook');
   expectedModules.add('NativeModule internal/util/inspector');
 }
 
@@ -0,0 +1,62 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+for (const alignment of [undefined, 1, 8, 512, 4096, 65536]) {
+  const buf = Buffer.allocAligned(100, alignment);
+  assert.ok(buf instanceof Buffer);
+  assert.strictEqual(buf.length, 100);
+  assert.strictEqual(buf.byteOffset, 0);
+  assert.ok(buf.every((byte) => byte === 0));
+}
+assert.strictEqual(Buffer.allocAligned(0).length, 0);
+
+for (const alignment of [3, 100, 4097]) {
+  assert.throws(() => Buffer.allocAligned(16, alignment), {
+    code: 'ERR_INVALID_ARG_VALUE'
+  });
+}
+for (const alignment of [0, -4096]) {
+  assert.throws(() => Buffer.allocAligned(16, alignment), {
+    code: 'ERR_OUT_OF_RANGE'
+  });
+}
+assert.throws(() => Buffer.allocAligned(16, '4096'), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+assert.throws(() => Buffer.allocAligned(-1), {
+  code: 'ERR_INVALID_OPT_VALUE'
+});
+assert.throws(() => Buffer.allocAligned('16'), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+
+// An aligned buffer can be used for unbuffered I/O. Not every file system
+// supports O_DIRECT, tmpfs for example rejects it with EINVAL.
+const { O_DIRECT } = fs.constants;
+if (O_DIRECT !== undefined) {
+  const tmpdir = require('../common/tmpdir');
+  tmpdir.refresh();
+  const file = path.join(tmpdir.path, 'direct');
+  let fd;
+  try {
+    fd = fs.openSync(file, fs.constants.O_RDWR | fs.constants.O_CREAT |
+                           O_DIRECT);
+  } catch (err) {
+    if (err.code !== 'EINVAL')
+      throw err;
+    common.printSkipMessage('O_DIRECT is not supported by the file system');
+  }
+  if (fd !== undefined) {
+    const data = Buffer.allocAligned(4096);
+    data.fill('x');
+    assert.strictEqual(fs.writeSync(fd, data, 0, data.length, 0), 4096);
+    const read = Buffer.allocAligned(4096);
+    assert.strictEqual(fs.readSync(fd, read, 0, read.length, 0), 4096);
+    assert.deepStrictEqual(read, data);
+    fs.closeSync(fd);
+  }
+}
@@ -0,0 +1,82 @@
+'use strict';
+
+require('../common');
+const assert = require('assert');
+const { StringDecoder } = require('string_decoder');
+
+function toBase64Url(base64) {
+  return base64.replace(/\+/g, '-').replace(/\//g, '_').replace(/=+$/, '');
+}
+
+// Lengths around the vector widths used by the encoder and decoder.
+const lengths = [];
+for (let i = 0; i < 100; i++) lengths.push(i);
+lengths.push(1000, 4095, 4096, 4097, 65536 + 7);
+
+for (const length of lengths) {
+  const buf = Buffer.alloc(length);
+  for (let i = 0; i < length; i++) buf[i] = (i * 7919 + length) & 0xff;
+
+  const base64 = buf.toString('base64');
+  const base64url = buf.toString('base64url');
+  assert.strictEqual(base64url, toBase64Url(base64));
+  assert.strictEqual(Buffer.byteLength(base64url, 'base64url'), length);
+
+  // Both encodings accept both alphabets, with and without padding.
+  for (const encoding of ['base64', 'base64url']) {
+    assert.deepStrictEqual(Buffer.from(base64, encoding), buf);
+    assert.deepStrictEqual(Buffer.from(base64url, encoding), buf);
+  }
+
+  // Whitespace anywhere is skipped, also in long inputs.
+  const wrapped = base64.replace(/.{76}/g, '$&\r\n');
+  assert.deepStrictEqual(Buffer.from(wrapped, 'base64'), buf);
+  assert.deepStrictEqual(Buffer.from(` ${base64url}\n`, 'base64url'), buf);
+
+  // Two-byte strings take the scalar path.
+  assert.deepStrictEqual(
+    Buffer.from(`${base64url}\u2028`, 'base64url').slice(0, length), buf);
+
+  const target = Buffer.alloc(length + 4);
+  assert.strictEqual(target.write(base64url, 2, 'base64url'), length);
+  assert.deepStrictEqual(target.slice(2, 2 + length), buf);
+}
+
+assert.strictEqual(Buffer.from([0xfb, 0xff]).toString('base64url'), '-_8');
+assert.strictEqual(Buffer.from('-_8', 'BASE64URL').toString('hex'), 'fbff');
+assert.strictEqual(Buffer.isEncoding('base64url'), true);
+assert.strictEqual(Buffer.isEncoding('Base64Url'), true);
+assert.strictEqual(Buffer.from('abc').indexOf('YmM', 'base64url'), 1);
+
+{
+  const buf = Buffer.alloc(5);
+  buf.fill('-_8', 'base64url');
+  assert.deepStrictEqual(buf, Buffer.from([0xfb, 0xff, 0xfb, 0xff, 0xfb]));
+}
+
+{
+  // Decoding in chunks that do not line up with groups of three bytes.
+  const decoder = new StringDecoder('base64url');
+  assert.strictEqual(decoder.encoding, 'base64url');
+  const data = Buffer.from([0xfb, 0xff, 0xbf, 0x01]);
+  assert.strictEqual(decoder.write(data.slice(0, 1)), '');
+  assert.strictEqual(decoder.write(data.slice(1)), '-_-_');
+  assert.strictEqual(decoder.end(), 'AQ');
+}
+
+{
+  // Trailing whitespace makes the decoded size an overestimate. The bytes
+  // past the decoded data must be left untouched.
+  for (const length of [12, 24, 36, 48, 96, 100]) {
+    const buf = Buffer.alloc(length, 0x5c);
+    for (const encoding of ['base64', 'base64url']) {
+      const string = `${buf.toString(encoding)}${' '.repeat(40)}`;
+      for (const offset of [0, 3]) {
+        const target = Buffer.alloc(offset + length + 40, 0xaa);
+        assert.strictEqual(target.write(string, offset, encoding), length);
+        assert.deepStrictEqual(target.slice(offset, offset + length), buf);
+        assert.ok(target.slice(offset + length).every((b) => b === 0xaa));
+      }
+    }
+  }
+}
@@ -0,0 +1,59 @@
+'use strict';
+// Test hex and ASCII conversions around the widths of their vectorized
+// implementations, so that both the vector and the scalar code are covered.
+
+require('../common');
+const assert = require('assert');
+
+function toHex(buf) {
+  let out = '';
+  for (const byte of buf) out += (byte < 16 ? '0' : '') + byte.toString(16);
+  return out;
+}
+
+const lengths = [];
+for (let i = 0; i < 140; i++) lengths.push(i);
+lengths.push(255, 256, 257, 1024 + 3, 65536 + 31);
+
+for (const length of lengths) {
+  const buf = Buffer.alloc(length);
+  for (let i = 0; i < length; i++) buf[i] = (i * 7919 + length) & 0xff;
+
+  const hex = buf.toString('hex');
+  assert.strictEqual(hex, toHex(buf));
+  assert.deepStrictEqual(Buffer.from(hex, 'hex'), buf);
+  assert.deepStrictEqual(Buffer.from(hex.toUpperCase(), 'hex'), buf);
+
+  // Decoding stops at the first pair that is not valid hex.
+  for (const position of [0, length >> 1, length - 1]) {
+    if (position < 0 || length === 0) continue;
+    for (const c of ['g', 'G', ':', '@', '`', '/', ' ', 'á']) {
+      const bad = hex.slice(0, position * 2) + c + hex.slice(position * 2 + 1);
+      assert.deepStrictEqual(Buffer.from(bad, 'hex'), buf.slice(0, position));
+    }
+  }
+
+  // A target that is smaller than the input.
+  const half = length >> 1;
+  const target = Buffer.alloc(half);
+  assert.strictEqual(target.write(hex, 'hex'), half);
+  assert.deepStrictEqual(target, buf.slice(0, half));
+
+  // ASCII and UTF-8 with and without bytes that have the high bit set.
+  const ascii = Buffer.alloc(length);
+  for (let i = 0; i < length; i++) ascii[i] = 0x20 + (i * 31) % 0x5f;
+  const expected = String.fromCharCode(...ascii);
+  assert.strictEqual(ascii.toString('ascii'), expected);
+  assert.strictEqual(ascii.toString('utf8'), expected);
+  for (const position of [0, length >> 1, length - 1]) {
+    if (position < 0 || length === 0) continue;
+    const copy = Buffer.from(ascii);
+    copy[position] = 0xe1;
+    assert.strictEqual(
+      copy.toString('ascii'),
+      expected.slice(0, position) + 'a' + expected.slice(position + 1));
+    assert.strictEqual(
+      copy.toString('utf8'),
+      expected.slice(0, position) + '�' + expected.slice(position + 1));
+  }
+}
@@ -0,0 +1,66 @@
+'use strict';
+
+require('../common');
+const assert = require('assert');
+
+function reference(buf, set, offset) {
+  for (let i = offset; i < buf.length; i++) {
+    if (set.includes(buf[i])) return i;
+  }
+  return -1;
+}
+
+const csv = Buffer.from('name,"value"\r\n');
+assert.strictEqual(csv.indexOfAny(',"\r\n'), 4);
+assert.strictEqual(csv.indexOfAny(Buffer.from('"')), 5);
+assert.strictEqual(csv.indexOfAny(new Uint8Array([0x22, 0x0d]), 6), 11);
+assert.strictEqual(csv.indexOfAny([0x0a]), 13);
+assert.strictEqual(csv.indexOfAny('xyz'), -1);
+assert.strictEqual(csv.indexOfAny(''), -1);
+assert.strictEqual(csv.indexOfAny([]), -1);
+assert.strictEqual(Buffer.alloc(0).indexOfAny(','), -1);
+
+// byteOffset is coerced like in indexOf().
+assert.strictEqual(csv.indexOfAny('"', -2), -1);
+assert.strictEqual(csv.indexOfAny('\r\n', -3), 12);
+assert.strictEqual(csv.indexOfAny('"', -100), 5);
+assert.strictEqual(csv.indexOfAny('"', 100), -1);
+assert.strictEqual(csv.indexOfAny('"', 'x'), 5);
+assert.strictEqual(csv.indexOfAny('"', null), 5);
+
+// Latin-1 strings.
+assert.strictEqual(Buffer.from([0x41, 0xe9]).indexOfAny('é'), 1);
+
+for (const values of [1, {}, null, undefined]) {
+  assert.throws(() => csv.indexOfAny(values), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+for (const values of [[256], [-1], [1.5]]) {
+  assert.throws(() => csv.indexOfAny(values), {
+    code: 'ERR_OUT_OF_RANGE'
+  });
+}
+
+// Sets of every size up to and beyond the vectorized ones, at every offset
+// within and around a vector.
+{
+  const buf = Buffer.alloc(200);
+  for (let i = 0; i < buf.length; i++) buf[i] = (i * 37) & 0xff;
+  for (let size = 1; size < 40; size++) {
+    const set = [];
+    for (let i = 0; i < size; i++) set.push((i * 101 + 7) & 0xff);
+    // Duplicates do not change the result.
+    set.push(set[0]);
+    for (let offset = 0; offset < 40; offset++) {
+      assert.strictEqual(buf.indexOfAny(set, offset),
+                         reference(buf, set, offset));
+    }
+  }
+  for (let i = 0; i < 40; i++) {
+    const haystack = Buffer.alloc(i + 20, 'a');
+    haystack[i] = 0x2c;
+    assert.strictEqual(haystack.indexOfAny(',\n'), i);
+    assert.strictEqual(haystack.indexOfAny(','), i);
+  }
+}
@@ -0,0 +1,88 @@
+// Flags: --expose-gc --no-concurrent-array-buffer-freeing
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+
+const initial = process.memoryUsage();
+assert.strictEqual(typeof initial.bufferPoolReserved, 'number');
+assert.strictEqual(typeof initial.bufferPoolUsed, 'number');
+assert(initial.bufferPoolReserved >= initial.bufferPoolUsed);
+
+if (common.isWindows)
+  common.skip('the Buffer allocation pool is not available on Windows');
+
+// Sizes around the ends of the pooled range and between size classes.
+const sizes = [
+  8 * 1024 - 1, 8 * 1024, 8 * 1024 + 1, 12 * 1024, 65536, 100000,
+  768 * 1024 + 1, 1024 * 1024, 1024 * 1024 + 1,
+];
+
+function fill(buf, seed) {
+  for (let i = 0; i < buf.length; i += 511) buf[i] = (i + seed) & 0xff;
+}
+
+function verify(buf, seed) {
+  for (let i = 0; i < buf.length; i += 511)
+    assert.strictEqual(buf[i], (i + seed) & 0xff);
+}
+
+{
+  const buffers = [];
+  for (let round = 0; round < 3; round++) {
+    for (const size of sizes) {
+      const buf = Buffer.allocUnsafeSlow(size);
+      fill(buf, buffers.length);
+      buffers.push(buf);
+
+      const zeroed = Buffer.alloc(size);
+      assert(zeroed.every((byte) => byte === 0));
+      buffers.push(zeroed);
+    }
+  }
+
+  const usage = process.memoryUsage();
+  assert(usage.bufferPoolUsed - initial.bufferPoolUsed >=
+         3 * 2 * (8 * 1024 + 12 * 1024 + 65536 + 768 * 1024 + 1024 * 1024));
+  assert(usage.bufferPoolReserved >= usage.bufferPoolUsed);
+
+  buffers.forEach((buf, i) => {
+    if (buf.every((byte) => byte === 0)) return;
+    verify(buf, i);
+  });
+}
+
+// Recycled blocks are handed out zero-filled again when requested.
+for (let i = 0; i < 20; i++) {
+  const dirty = Buffer.allocUnsafeSlow(32 * 1024).fill(0xff);
+  global.gc();
+  assert(Buffer.alloc(32 * 1024).every((byte) => byte === 0));
+  assert.strictEqual(dirty[0], 0xff);
+}
+
+global.gc();
+assert(process.memoryUsage().bufferPoolUsed <=
+       initial.bufferPoolUsed + 256 * 1024);
+
+// Native code that resizes its output buffers moves them between the pool
+// and malloc().
+{
+  const zlib = require('zlib');
+  const input = Buffer.alloc(300 * 1024);
+  fill(input, 3);
+  for (const chunkSize of [1024, 16 * 1024, 64 * 1024]) {
+    const compressed = zlib.deflateSync(input, { chunkSize });
+    assert.deepStrictEqual(zlib.inflateSync(compressed, { chunkSize }), input);
+  }
+}
+
+// Huge pages are only a hint to the OS.
+{
+  const child = spawnSync(process.execPath, [
+    '--buffer-pool-huge-pages',
+    '-p',
+    'Buffer.alloc(512 * 1024, 1).reduce((a, b) => a + b, 0)',
+  ]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.strictEqual(child.stdout.toString().trim(), `${512 * 1024}`);
+}
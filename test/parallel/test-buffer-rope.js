@@ -0,0 +1,84 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const { Rope } = require('buffer');
+const { Writable } = require('stream');
+
+const a = Buffer.from('hello ');
+const rope = new Rope([a, 'wörld', new Uint8Array([33]), '', new Rope(['!'])]);
+assert.strictEqual(rope.length, 14);
+assert.strictEqual(new Rope().length, 0);
+assert.strictEqual(new Rope().toString(), '');
+assert.strictEqual(new Rope(['68656c6c6f'], 'hex').toString(), 'hello');
+
+// The chunks are not copied, and empty ones are dropped.
+const chunks = [...rope];
+assert.strictEqual(chunks.length, 4);
+assert.strictEqual(chunks[0], a);
+assert.ok(chunks.every((chunk) => chunk instanceof Buffer));
+
+assert.strictEqual(rope.slice(3, 9).toString(), 'lo wö');
+assert.strictEqual(rope.slice(-3).toString(), 'd!!');
+assert.strictEqual(rope.slice(6, 6).length, 0);
+assert.strictEqual(rope.slice(9, 3).length, 0);
+assert.strictEqual(rope.slice(100).length, 0);
+assert.strictEqual([...rope.slice(0, 3)][0].buffer, a.buffer);
+
+// toBuffer() flattens once and keeps the result.
+assert.strictEqual(rope.toString(), 'hello wörld!!');
+const flat = rope.toBuffer();
+assert.strictEqual(flat.toString(), 'hello wörld!!');
+assert.strictEqual(rope.toBuffer(), flat);
+assert.deepStrictEqual([...rope], [flat]);
+
+assert.throws(() => new Rope('abc'), { code: 'ERR_INVALID_ARG_TYPE' });
+assert.throws(() => new Rope(['a', 1]), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  message: /"chunks\[1\]"/
+});
+
+// Writable streams get all the chunks in one _writev() call.
+{
+  const input = new Rope(['a', 'b', 'c']);
+  const writable = new Writable({
+    writev: common.mustCall((chunks, cb) => {
+      assert.deepStrictEqual(chunks.map(({ chunk }) => chunk.toString()),
+                             ['a', 'b', 'c']);
+      cb();
+    }),
+    write: common.mustNotCall()
+  });
+  writable.write(input, common.mustCall());
+  writable.write(new Rope(), common.mustCall());
+  writable.end();
+}
+
+// HTTP responses, with and without chunked encoding.
+{
+  const http = require('http');
+  const body = new Rope(['<p>', 'x'.repeat(1000), '</p>']);
+  const server = http.createServer(common.mustCall((req, res) => {
+    if (req.url === '/length')
+      res.setHeader('Content-Length', body.length);
+    res.write(body.slice(0, 10));
+    res.end(body.slice(10));
+  }, 2));
+  server.listen(0, common.mustCall(() => {
+    let pending = 2;
+    for (const path of ['/length', '/chunked']) {
+      http.get({ port: server.address().port, path }, common.mustCall((res) => {
+        assert.strictEqual(res.headers['transfer-encoding'],
+                           path === '/chunked' ? 'chunked' : undefined);
+        let data = '';
+        res.setEncoding('utf8');
+        res.on('data', (chunk) => data += chunk);
+        res.on('end', common.mustCall(() => {
+          assert.strictEqual(data, body.toString());
+          if (--pending === 0)
+            server.close();
+        }));
+      }));
+    }
+  }));
+}
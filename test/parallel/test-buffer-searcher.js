@@ -0,0 +1,56 @@
+'use strict';
+
+require('../common');
+const assert = require('assert');
+const { Searcher } = require('buffer');
+
+const body = Buffer.from('a\r\n--boundary\r\nb\r\n--boundary--');
+const boundary = new Searcher('\r\n--boundary');
+assert.strictEqual(boundary.indexOf(body), 1);
+assert.strictEqual(boundary.indexOf(body, 2), 16);
+assert.strictEqual(boundary.indexOf(body, 17), -1);
+assert.strictEqual(boundary.indexOf(body, -14), 16);
+assert.strictEqual(boundary.indexOf(body, -100), 1);
+assert.strictEqual(boundary.indexOf(body, 'x'), 1);
+assert.strictEqual(boundary.indexOf(Buffer.alloc(0)), -1);
+assert.strictEqual(boundary.indexOf(Buffer.from('\r\n--')), -1);
+
+// The pattern is copied.
+{
+  const pattern = Buffer.from('abc');
+  const searcher = new Searcher(pattern);
+  pattern.fill(0);
+  assert.strictEqual(searcher.indexOf(Buffer.from('xxabc')), 2);
+  assert.strictEqual(
+    new Searcher(new Uint8Array([0x61, 0x62])).indexOf(Buffer.from('xab')), 1);
+  assert.strictEqual(new Searcher('6263', 'hex').indexOf(Buffer.from('abc')),
+                     1);
+}
+
+assert.throws(() => new Searcher(''), { code: 'ERR_INVALID_ARG_VALUE' });
+assert.throws(() => new Searcher(Buffer.alloc(0)), {
+  code: 'ERR_INVALID_ARG_VALUE'
+});
+for (const pattern of [1, {}, null, undefined]) {
+  assert.throws(() => new Searcher(pattern), { code: 'ERR_INVALID_ARG_TYPE' });
+}
+assert.throws(() => boundary.indexOf('string'), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+
+// Reusing searchers against Buffer#indexOf(), with patterns of every length
+// around the ones where the search strategy changes. Short alphabets make for
+// many partial matches.
+for (let length = 1; length < 20; length++) {
+  for (const alphabet of ['ab', 'abc', 'abcdefgh']) {
+    const haystack = Buffer.alloc(500);
+    for (let i = 0; i < haystack.length; i++)
+      haystack[i] = alphabet.charCodeAt((i * 7 + (i >> 3)) % alphabet.length);
+    const pattern = haystack.slice(300, 300 + length);
+    const searcher = new Searcher(pattern);
+    for (let offset = 0; offset < haystack.length; offset += 13) {
+      assert.strictEqual(searcher.indexOf(haystack, offset),
+                         haystack.indexOf(pattern, offset));
+    }
+  }
+}
@@ -0,0 +1,49 @@
+'use strict';
+// swap16/32/64 and fill() with multi-byte patterns use vectorized code for
+// large buffers. Compare them to a byte-by-byte reference for lengths and
+// offsets around the vector widths.
+
+require('../common');
+const assert = require('assert');
+
+function swapReference(buf, width) {
+  const result = Buffer.from(buf);
+  for (let i = 0; i < result.length; i += width)
+    result.subarray(i, i + width).reverse();
+  return result;
+}
+
+const source = Buffer.alloc(4200);
+for (let i = 0; i < source.length; i++)
+  source[i] = (i * 31 + 7) & 0xff;
+
+for (const [method, width] of [['swap16', 2], ['swap32', 4], ['swap64', 8]]) {
+  for (const offset of [0, 1, 3]) {
+    for (const count of [16, 24, 31, 32, 33, 64, 100, 511, 512, 513]) {
+      const length = count * width;
+      const buf = Buffer.from(source.subarray(offset, offset + length));
+      const expected = swapReference(buf, width);
+      assert.deepStrictEqual(buf[method](), expected);
+      assert.deepStrictEqual(buf[method](), source.subarray(offset,
+                                                            offset + length));
+    }
+  }
+}
+
+for (const patternLength of [2, 3, 4, 5, 8, 16, 17, 32, 100]) {
+  const pattern = source.subarray(0, patternLength);
+  for (const length of [patternLength + 1, 31, 4095, 4096, 4097, 10000,
+                        70000]) {
+    const buf = Buffer.alloc(length + 2, 0xee);
+    buf.fill(pattern, 1, length + 1);
+    assert.strictEqual(buf[0], 0xee);
+    assert.strictEqual(buf[length + 1], 0xee);
+    for (let i = 0; i < length; i++) {
+      if (buf[i + 1] !== pattern[i % patternLength])
+        assert.fail(`pattern ${patternLength}, length ${length}, index ${i}`);
+    }
+  }
+}
+
+assert.strictEqual(Buffer.alloc(1 << 20, 'abc').toString('latin1'),
+                   'abc'.repeat((1 << 20) / 3 + 1).slice(0, 1 << 20));
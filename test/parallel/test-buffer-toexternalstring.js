@@ -0,0 +1,43 @@
+// Flags: --expose-gc
+'use strict';
+require('../common');
+const assert = require('assert');
+
+const ascii = Buffer.from('{"key": "value"}\n'.repeat(1000));
+for (const encoding of [undefined, 'utf8', 'UTF-8', 'ascii', 'latin1']) {
+  assert.strictEqual(ascii.toExternalString(encoding), ascii.toString());
+}
+
+// Non-ASCII contents are shared for latin1 only, and copied otherwise.
+const bytes = Buffer.alloc(4096);
+for (let i = 0; i < bytes.length; i++) bytes[i] = i & 0xff;
+for (const encoding of ['utf8', 'ascii', 'latin1', 'binary']) {
+  assert.strictEqual(bytes.toExternalString(encoding),
+                     bytes.toString(encoding));
+}
+const utf8 = Buffer.from('€'.repeat(2000));
+assert.strictEqual(utf8.toExternalString(), utf8.toString());
+
+// Short buffers, slices and empty buffers.
+assert.strictEqual(Buffer.from('abc').toExternalString(), 'abc');
+assert.strictEqual(Buffer.alloc(0).toExternalString(), '');
+assert.strictEqual(ascii.slice(17, 5017).toExternalString(),
+                   ascii.toString('utf8', 17, 5017));
+
+// The string keeps the memory alive after the Buffer is gone.
+{
+  let str = (() => Buffer.alloc(1 << 20, 'x').toExternalString())();
+  global.gc();
+  Buffer.alloc(1 << 20, 'y');
+  assert.strictEqual(str.length, 1 << 20);
+  assert.strictEqual(str, 'x'.repeat(1 << 20));
+  assert.strictEqual(JSON.parse(`"${str}"`).length, 1 << 20);
+  str = null;
+  global.gc();
+}
+
+for (const encoding of ['hex', 'base64', 'utf16le', 'nope']) {
+  assert.throws(() => ascii.toExternalString(encoding), {
+    code: 'ERR_INVALID_ARG_VALUE'
+  });
+}
@@ -0,0 +1,117 @@
+'use strict';
+// Test UTF-8 decoding around the widths of its vectorized validator, for
+// well-formed input, which takes the fast path, and for malformed input,
+// which falls back to replacing invalid sequences.
+
+const common = require('../common');
+const assert = require('assert');
+const { StringDecoder } = require('string_decoder');
+
+const samples = ['a', '\x7f', '\x80', 'é', 'ÿ', 'Ā', '€', '中', '￿',
+                 '😀', '\u{10ffff}'];
+
+const invalid = [
+  [0x80],
+  [0xbf],
+  [0xc0, 0x80],
+  [0xc1, 0xbf],
+  [0xe0, 0x80, 0x80],
+  [0xed, 0xa0, 0x80],
+  [0xf0, 0x80, 0x80, 0x80],
+  [0xf4, 0x90, 0x80, 0x80],
+  [0xf5, 0x80, 0x80, 0x80],
+  [0xff],
+  [0xe2, 0x82],
+  [0xf0, 0x9f, 0x98],
+];
+
+// A reference decoder for well-formed input.
+function decode(buf) {
+  let out = '';
+  for (let i = 0; i < buf.length;) {
+    const c = buf[i];
+    const n = c < 0x80 ? 1 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+    let cp = n === 1 ? c : c & (0x7f >> n);
+    for (let k = 1; k < n; k++) cp = cp << 6 | (buf[i + k] & 0x3f);
+    out += String.fromCodePoint(cp);
+    i += n;
+  }
+  return out;
+}
+
+for (const length of [1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 1000]) {
+  for (const sample of samples) {
+    for (const position of [0, length >> 1, length - 1]) {
+      const str = 'x'.repeat(position) + sample + 'y'.repeat(length - position);
+      const buf = Buffer.from(str);
+      assert.strictEqual(buf.toString(), str);
+      assert.strictEqual(decode(buf), str);
+
+      const decoder = new StringDecoder('utf8');
+      assert.strictEqual(decoder.write(buf) + decoder.end(), str);
+    }
+  }
+
+  for (const bytes of invalid) {
+    for (const position of [0, length >> 1, length]) {
+      const buf = Buffer.concat([
+        Buffer.alloc(position, 'a'),
+        Buffer.from(bytes),
+        Buffer.alloc(length - position, 'b'),
+      ]);
+      const str = buf.toString();
+      assert(str.includes('�'), `${buf.toString('hex')}`);
+      assert.strictEqual(str.slice(0, position), 'a'.repeat(position));
+      assert(str.endsWith('b'.repeat(length - position)));
+    }
+  }
+}
+
+// Mixtures of characters of every length.
+{
+  const chars = Array.from(samples.join('').repeat(100));
+  for (let i = 0; i < 40; i++) {
+    const str = chars.slice(i).join('');
+    assert.strictEqual(Buffer.from(str).toString(), str);
+  }
+}
+
+if (!common.hasIntl) {
+  common.printSkipMessage('missing Intl');
+  return;
+}
+
+{
+  const str = 'héllo wörld € 😀 '.repeat(100);
+  const buf = Buffer.from(str);
+  for (const fatal of [false, true]) {
+    const decoder = new TextDecoder('utf-8', { fatal });
+    assert.strictEqual(decoder.decode(buf), str);
+
+    // The BOM is only skipped at the start of the stream.
+    const bom = Buffer.from([0xef, 0xbb, 0xbf]);
+    assert.strictEqual(decoder.decode(Buffer.concat([bom, buf])), str);
+    assert.strictEqual(decoder.decode(Buffer.concat([bom, buf]),
+                                      { stream: true }), str);
+    assert.strictEqual(decoder.decode(Buffer.concat([bom, buf])),
+                       `\ufeff${str}`);
+    const ignoreBOM = new TextDecoder('utf-8', { fatal, ignoreBOM: true });
+    assert.strictEqual(ignoreBOM.decode(Buffer.concat([bom, buf])),
+                       `\ufeff${str}`);
+
+    // Chunks that split characters take ICU, whole ones do not.
+    let out = '';
+    for (let i = 0; i < buf.length; i += 7)
+      out += decoder.decode(buf.slice(i, i + 7), { stream: true });
+    out += decoder.decode();
+    assert.strictEqual(out, str);
+  }
+
+  const decoder = new TextDecoder('utf-8', { fatal: true });
+  for (const bytes of invalid) {
+    const input = Buffer.concat([buf, Buffer.from(bytes)]);
+    assert.throws(() => decoder.decode(input),
+                  { code: 'ERR_ENCODING_INVALID_ENCODED_DATA' });
+  }
+  assert.strictEqual(decoder.decode(buf), str);
+}
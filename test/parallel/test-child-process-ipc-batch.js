@@ -0,0 +1,47 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { fork } = require('child_process');
+
+// This tests that messages which arrive in bursts, and messages that are
+// split across several reads, are delivered completely and in order.
+
+const count = 1000;
+const large = 'ü'.repeat(256 * 1024);
+
+function makeMessage(i) {
+  return { i, text: i % 100 === 0 ? large : `€${i}` };
+}
+
+if (process.argv[2] === 'child') {
+  const typed = process.argv[3] === 'advanced';
+  for (let i = 0; i < count; i++) {
+    const message = makeMessage(i);
+    if (typed) {
+      message.int16 = new Int16Array([i, -i]);
+      message.view = new DataView(new ArrayBuffer(3));
+      message.buffer = Buffer.from([i & 0xff]);
+    }
+    process.send(message);
+  }
+  return;
+}
+
+for (const serialization of ['json', 'advanced']) {
+  const child = fork(__filename, ['child', serialization], { serialization });
+  let next = 0;
+  child.on('message', common.mustCall((message) => {
+    const i = next++;
+    const expected = makeMessage(i);
+    if (serialization === 'advanced') {
+      expected.int16 = new Int16Array([i, -i]);
+      expected.view = new DataView(new ArrayBuffer(3));
+      expected.buffer = Buffer.from([i & 0xff]);
+    }
+    assert.deepStrictEqual(message, expected);
+  }, count));
+  child.on('exit', common.mustCall((code) => {
+    assert.strictEqual(code, 0);
+    assert.strictEqual(next, count);
+  }));
+}
@@ -0,0 +1,28 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { spawn } = require('child_process');
+
+// This tests that a FileHandle can be passed as stdio to a child process.
+
+const tmpdir = require('../common/tmpdir');
+tmpdir.refresh();
+
+const size = 1024 * 1024;
+const args = ['-e', `process.stdout.write('x'.repeat(${size}))`];
+
+(async function() {
+  const file = path.join(tmpdir.path, 'stdout.txt');
+  const fileHandle = await fs.promises.open(file, 'w');
+  const child = spawn(process.execPath, args, {
+    stdio: ['ignore', fileHandle, 'inherit']
+  });
+  assert.strictEqual(child.stdout, null);
+  child.on('close', common.mustCall(async (code) => {
+    assert.strictEqual(code, 0);
+    await fileHandle.close();
+    assert.strictEqual(fs.readFileSync(file, 'latin1'), 'x'.repeat(size));
+  }));
+})().then(common.mustCall());
@@ -0,0 +1,48 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// This tests that the output of a child process can be written to a stream
+// without a file descriptor of its own, such as a TLS socket.
+
+const assert = require('assert');
+const fixtures = require('../common/fixtures');
+const tls = require('tls');
+const { spawn } = require('child_process');
+
+const size = 1024 * 1024;
+const args = ['-e', `process.stdout.write('x'.repeat(${size}))`];
+
+const server = tls.createServer({
+  key: fixtures.readKey('agent1-key.pem'),
+  cert: fixtures.readKey('agent1-cert.pem')
+}, common.mustCall((socket) => {
+  let received = '';
+  socket.setEncoding('latin1');
+  socket.on('data', (chunk) => received += chunk);
+  socket.on('end', common.mustCall(() => {
+    assert.strictEqual(received, `before${'x'.repeat(size)}after`);
+    socket.end();
+    server.close();
+  }));
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = tls.connect({
+    port: server.address().port,
+    rejectUnauthorized: false
+  }, common.mustCall(() => {
+    client.write('before', common.mustCall(() => {
+      const child = spawn(process.execPath, args, {
+        stdio: ['ignore', client, 'inherit']
+      });
+      assert.strictEqual(child.stdout, null);
+      child.on('close', common.mustCall((code) => {
+        assert.strictEqual(code, 0);
+        // The socket is still usable once the child is done.
+        client.end('after');
+      }));
+    }));
+  }));
+}));
@@ -27,6 +27,8 @@ expect('--no-warnings', 'B\n');
 expect('--no_warnings', 'B\n');
 expect('--trace-warnings', 'B\n');
 expect('--redirect-warnings=_', 'B\n');
+expect('--compile-cache-dir=_', 'B\n');
+expect('--trace-bootstrap-modules', 'B\n');
 expect('--trace-deprecation', 'B\n');
 expect('--trace-sync-io', 'B\n');
 expectNoWorker('--trace-events-enabled', 'B\n');
@@ -37,6 +39,7 @@ expect('--throw-deprecation',
        true);
 expectNoWorker('--zero-fill-buffers', 'B\n');
 expectNoWorker('--v8-pool-size=10', 'B\n');
+expectNoWorker('--v8-pool-affinity', 'B\n');
 expectNoWorker('--trace-event-categories node', 'B\n');
 expectNoWorker(
   // eslint-disable-next-line no-template-curly-in-string
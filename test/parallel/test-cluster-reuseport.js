@@ -0,0 +1,48 @@
+'use strict';
+const common = require('../common');
+if (!common.isLinux)
+  common.skip('SO_REUSEPORT load balancing is only tested on Linux');
+
+const assert = require('assert');
+const cluster = require('cluster');
+const net = require('net');
+
+const WORKERS = 2;
+
+if (cluster.isMaster) {
+  cluster.schedulingPolicy = cluster.SCHED_REUSEPORT;
+  cluster.setupMaster({ reusePortCpuSteering: true });
+
+  const ports = [];
+
+  cluster.on('listening', common.mustCall((worker, address) => {
+    ports.push(address.port);
+    if (ports.length < WORKERS)
+      return;
+
+    // All workers are listening on the same port, on sockets of their own.
+    assert.strictEqual(ports[0], ports[1]);
+    assert.ok(ports[0] > 0);
+
+    const socket = net.connect(ports[0], common.localhostIPv4);
+    socket.setEncoding('utf8');
+    let data = '';
+    socket.on('data', (chunk) => data += chunk);
+    socket.on('end', common.mustCall(() => {
+      assert(/^\d+$/.test(data));
+      assert.ok(cluster.workers[data]);
+      for (const id in cluster.workers)
+        cluster.workers[id].disconnect();
+    }));
+  }, WORKERS));
+
+  for (let i = 0; i < WORKERS; i++)
+    cluster.fork().on('exit', common.mustCall((code) => {
+      assert.strictEqual(code, 0);
+    }));
+} else {
+  const server = net.createServer((socket) => {
+    socket.end(`${cluster.worker.id}`);
+  });
+  server.listen(0, common.localhostIPv4);
+}
@@ -0,0 +1,88 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { spawnSync } = require('child_process');
+const tmpdir = require('../common/tmpdir');
+
+// Test that --compile-cache-dir writes the code caches of CommonJS and ES
+// modules, and that they are used when the modules are loaded again.
+
+tmpdir.refresh();
+const cacheDir = path.join(tmpdir.path, 'cache');
+const cjs = path.join(tmpdir.path, 'entry.js');
+const esm = path.join(tmpdir.path, 'entry.mjs');
+
+fs.writeFileSync(cjs, `
+  function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+  console.log(fib(20));
+`);
+fs.writeFileSync(esm, `
+  import { sep } from 'path';
+  export const double = (x) => x * 2;
+  console.log(double(21), typeof sep);
+`);
+
+function run(entry) {
+  const child = spawnSync(process.execPath, [
+    `--compile-cache-dir=${cacheDir}`, entry
+  ]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  return child.stdout.toString();
+}
+
+function cacheFiles() {
+  const files = [];
+  for (const dir of fs.readdirSync(cacheDir)) {
+    assert.match(dir, /^v8-[0-9a-f]{8}$/);
+    files.push(...fs.readdirSync(path.join(cacheDir, dir)));
+  }
+  return files.sort();
+}
+
+assert.strictEqual(run(cjs), '6765\n');
+assert.strictEqual(run(esm), '42 string\n');
+const files = cacheFiles();
+assert.strictEqual(files.length, 2);
+const key = common.hasCrypto ? '[0-9a-f]{64}' : '[0-9a-f]{8}-[0-9a-f]{16}';
+assert.match(files[0], new RegExp(`^cjs-${key}$`));
+assert.match(files[1], new RegExp(`^esm-${key}$`));
+
+// The cached code produces the same results, and does not change the cache.
+assert.strictEqual(run(cjs), '6765\n');
+assert.strictEqual(run(esm), '42 string\n');
+assert.deepStrictEqual(cacheFiles(), files);
+
+{
+  // Modified modules are compiled from scratch, and cached separately.
+  fs.appendFileSync(cjs, 'console.log("changed");\n');
+  assert.strictEqual(run(cjs), '6765\nchanged\n');
+  assert.strictEqual(cacheFiles().length, 3);
+}
+
+{
+  // So are modules whose source changes without changing its length.
+  const source = fs.readFileSync(cjs, 'utf8');
+  fs.writeFileSync(cjs, source.replace('fib(20)', 'fib(21)'));
+  assert.strictEqual(run(cjs), '10946\nchanged\n');
+  assert.strictEqual(cacheFiles().length, 4);
+}
+
+{
+  // Corrupt cache files are ignored and replaced.
+  const [dir] = fs.readdirSync(cacheDir);
+  const file = path.join(cacheDir, dir, files[1]);
+  fs.writeFileSync(file, 'garbage');
+  assert.strictEqual(run(esm), '42 string\n');
+  assert.notStrictEqual(fs.readFileSync(file, 'latin1'), 'garbage');
+}
+
+{
+  // Without the option, nothing is written.
+  const child = spawnSync(process.execPath, [cjs], {
+    cwd: tmpdir.path
+  });
+  assert.strictEqual(child.status, 0);
+  assert.strictEqual(cacheFiles().length, 4);
+}
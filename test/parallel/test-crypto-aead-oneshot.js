@@ -0,0 +1,120 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// crypto.aeadSeal() and crypto.aeadOpen() produce the same records as
+// Cipheriv and Decipheriv, with the authentication tag appended to the
+// ciphertext.
+
+const assert = require('assert');
+const crypto = require('crypto');
+
+const {
+  aeadOpen,
+  aeadOpenBatch,
+  aeadSeal,
+  aeadSealBatch,
+  createSecretKey
+} = crypto;
+
+function sealWithCipher(algorithm, key, iv, data, aad, authTagLength) {
+  const cipher = crypto.createCipheriv(algorithm, key, iv, { authTagLength });
+  if (aad !== undefined)
+    cipher.setAAD(aad, { plaintextLength: data.length });
+  return Buffer.concat([cipher.update(data), cipher.final(),
+                        cipher.getAuthTag()]);
+}
+
+for (const [algorithm, keyLength] of [['aes-128-gcm', 16],
+                                      ['aes-192-gcm', 24],
+                                      ['aes-256-gcm', 32],
+                                      ['chacha20-poly1305', 32]]) {
+  const rawKey = crypto.randomBytes(keyLength);
+  const key = createSecretKey(rawKey);
+
+  // The cached context is reused for different IVs, AADs, tag lengths and
+  // directions.
+  for (const size of [0, 1, 16, 1000]) {
+    for (const aad of [undefined, crypto.randomBytes(20)]) {
+      for (const authTagLength of [16, 12]) {
+        const iv = crypto.randomBytes(12);
+        const data = crypto.randomBytes(size);
+        const sealed = aeadSeal(algorithm, key, iv, data,
+                                { aad, authTagLength });
+        assert.deepStrictEqual(
+          sealed,
+          sealWithCipher(algorithm, rawKey, iv, data, aad, authTagLength));
+        assert.deepStrictEqual(
+          aeadOpen(algorithm, key, iv, sealed, { aad, authTagLength }),
+          data);
+
+        const tampered = Buffer.from(sealed);
+        tampered[tampered.length - 1] ^= 1;
+        assert.throws(() => {
+          aeadOpen(algorithm, key, iv, tampered, { aad, authTagLength });
+        }, /Unsupported state or unable to authenticate data/);
+      }
+    }
+  }
+
+  // Batches.
+  const records = [];
+  for (let i = 0; i < 5; i++) {
+    records.push({
+      iv: crypto.randomBytes(12),
+      data: crypto.randomBytes(i * 10),
+      aad: i % 2 ? crypto.randomBytes(i) : undefined
+    });
+  }
+  const sealed = aeadSealBatch(algorithm, key, records);
+  assert.strictEqual(sealed.length, records.length);
+  sealed.forEach((record, i) => {
+    assert.deepStrictEqual(
+      aeadOpen(algorithm, key, records[i].iv, record,
+               { aad: records[i].aad }),
+      records[i].data);
+  });
+
+  sealed[2][0] ^= 1;
+  const opened = aeadOpenBatch(
+    algorithm, key, records.map((r, i) => ({ ...r, data: sealed[i] })));
+  assert.deepStrictEqual(
+    opened, records.map((r, i) => (i === 2 ? null : r.data)));
+  assert.deepStrictEqual(aeadSealBatch(algorithm, key, []), []);
+}
+
+{
+  const key = createSecretKey(crypto.randomBytes(32));
+  const iv = crypto.randomBytes(12);
+
+  assert.throws(() => aeadSeal('aes-256-cbc', key, iv, 'data'), {
+    code: 'ERR_CRYPTO_UNKNOWN_CIPHER'
+  });
+  assert.throws(() => aeadSeal('aes-128-gcm', key, iv, 'data'),
+                /Invalid key length/);
+  assert.throws(() => aeadSeal('chacha20-poly1305', key,
+                               Buffer.alloc(13), 'data'),
+                /Invalid IV length/);
+  assert.throws(() => aeadSeal('aes-256-gcm', key, Buffer.alloc(0), 'data'),
+                /Invalid IV length/);
+  assert.throws(() => aeadSeal('aes-256-gcm', key, iv, 'data',
+                               { authTagLength: 5 }),
+                /Invalid authentication tag length: 5/);
+  assert.throws(() => aeadSeal('aes-256-gcm', crypto.randomBytes(32), iv,
+                               'data'), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+  assert.throws(() => aeadOpen('aes-256-gcm', key, iv, Buffer.alloc(15)),
+                /Unsupported state or unable to authenticate data/);
+  assert.throws(() => aeadSealBatch('aes-256-gcm', key, [null]), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+
+  const { privateKey } = crypto.generateKeyPairSync('ec', {
+    namedCurve: 'P-256'
+  });
+  assert.throws(() => aeadSeal('aes-256-gcm', privateKey, iv, 'data'), {
+    code: 'ERR_CRYPTO_INVALID_KEY_OBJECT_TYPE'
+  });
+}
@@ -0,0 +1,95 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// Hash, Hmac and Cipher streams created with `asyncUpdates: true` process
+// large chunks on the threadpool and produce the same output as without.
+
+const assert = require('assert');
+const crypto = require('crypto');
+const { Readable, Writable, pipeline } = require('stream');
+
+const chunks = [
+  crypto.randomBytes(1024 * 1024),
+  crypto.randomBytes(100),  // Small enough to be processed synchronously.
+  crypto.randomBytes(64 * 1024 + 3),
+];
+const data = Buffer.concat(chunks);
+
+function collect(cb) {
+  const received = [];
+  return new Writable({
+    write(chunk, encoding, callback) {
+      received.push(chunk);
+      callback();
+    },
+    final: common.mustCall((callback) => {
+      cb(Buffer.concat(received));
+      callback();
+    })
+  });
+}
+
+function check(transform, expected, input = chunks) {
+  pipeline(Readable.from(input), transform, collect(common.mustCall((out) => {
+    assert.deepStrictEqual(out, expected);
+  })), common.mustCall((err) => assert.ifError(err)));
+}
+
+check(crypto.createHash('sha256', { asyncUpdates: true }),
+      crypto.createHash('sha256').update(data).digest());
+
+check(crypto.createHmac('sha512', 'key', { asyncUpdates: true }),
+      crypto.createHmac('sha512', 'key').update(data).digest());
+
+{
+  const key = crypto.randomBytes(32);
+  const iv = crypto.randomBytes(16);
+  const cipher = crypto.createCipheriv('aes-256-cbc', key, iv);
+  const expected = Buffer.concat([cipher.update(data), cipher.final()]);
+  check(crypto.createCipheriv('aes-256-cbc', key, iv, { asyncUpdates: true }),
+        expected);
+  check(crypto.createDecipheriv('aes-256-cbc', key, iv, { asyncUpdates: true }),
+        data,
+        [expected.slice(0, 1024 * 1024), expected.slice(1024 * 1024)]);
+}
+
+{
+  // Authenticated decryption checks the tag that was set before the first
+  // update.
+  const key = crypto.randomBytes(32);
+  const iv = crypto.randomBytes(12);
+  const cipher = crypto.createCipheriv('aes-256-gcm', key, iv);
+  const ciphertext = Buffer.concat([cipher.update(data), cipher.final()]);
+  const decipher = crypto.createDecipheriv('aes-256-gcm', key, iv,
+                                           { asyncUpdates: true });
+  decipher.setAuthTag(cipher.getAuthTag());
+  check(decipher, data, [ciphertext]);
+}
+
+{
+  // The context cannot be used synchronously while an update is pending.
+  const hash = crypto.createHash('sha256', { asyncUpdates: true });
+  hash.write(chunks[0]);
+  assert.throws(() => hash.update('data'), {
+    code: 'ERR_CRYPTO_INVALID_STATE'
+  });
+  assert.throws(() => hash.digest(), {
+    code: 'ERR_CRYPTO_INVALID_STATE'
+  });
+  assert.throws(() => hash.copy(), {
+    code: 'ERR_CRYPTO_INVALID_STATE'
+  });
+  hash.end(common.mustCall(() => {
+    assert.deepStrictEqual(
+      hash.read(),
+      crypto.createHash('sha256').update(chunks[0]).digest());
+  }));
+}
+
+for (const asyncUpdates of [1, 'true', null]) {
+  assert.throws(() => crypto.createHash('sha256', { asyncUpdates }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
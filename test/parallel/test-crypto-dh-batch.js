@@ -0,0 +1,69 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const crypto = require('crypto');
+
+function makeItems(type, options, count) {
+  const ours = crypto.generateKeyPairSync(type, options);
+  const items = [];
+  for (let i = 0; i < count; i++) {
+    const theirs = crypto.generateKeyPairSync(type, options);
+    items.push({ privateKey: ours.privateKey, publicKey: theirs.publicKey });
+  }
+  return items;
+}
+
+function checkSecrets(items, secrets) {
+  assert(Array.isArray(secrets));
+  assert.strictEqual(secrets.length, items.length);
+  for (let i = 0; i < items.length; i++)
+    assert.deepStrictEqual(secrets[i], crypto.diffieHellman(items[i]));
+}
+
+// More items than fit into a single chunk.
+for (const [type, options, count] of [
+  ['x25519', undefined, 150],
+  ['ec', { namedCurve: 'P-256' }, 10],
+  ['dh', { group: 'modp5' }, 3]
+]) {
+  const items = makeItems(type, options, count);
+  crypto.diffieHellmanBatch(items, common.mustCall((err, secrets) => {
+    assert.ifError(err);
+    checkSecrets(items, secrets);
+  }));
+}
+
+crypto.diffieHellmanBatch([], common.mustCall((err, secrets) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(secrets, []);
+}));
+
+{
+  const x25519 = crypto.generateKeyPairSync('x25519');
+  const x448 = crypto.generateKeyPairSync('x448');
+
+  assert.throws(() => crypto.diffieHellmanBatch({}, common.mustNotCall()), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+  assert.throws(() => crypto.diffieHellmanBatch([], 'callback'), {
+    code: 'ERR_INVALID_CALLBACK'
+  });
+  assert.throws(() => crypto.diffieHellmanBatch([null], common.mustNotCall()), {
+    code: 'ERR_INVALID_ARG_TYPE',
+    message: /"items\[0\]"/
+  });
+  assert.throws(() => crypto.diffieHellmanBatch([
+    { privateKey: x25519.privateKey, publicKey: x25519.publicKey },
+    { privateKey: x25519.privateKey, publicKey: x448.publicKey }
+  ], common.mustNotCall()), {
+    code: 'ERR_CRYPTO_INCOMPATIBLE_KEY'
+  });
+  assert.throws(() => crypto.diffieHellmanBatch([
+    { privateKey: x25519.publicKey, publicKey: x25519.publicKey }
+  ], common.mustNotCall()), {
+    code: 'ERR_CRYPTO_INVALID_KEY_OBJECT_TYPE'
+  });
+}
@@ -0,0 +1,67 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const crypto = require('crypto');
+
+const inputs = [
+  '',
+  'hello world',
+  'äöü ☃',
+  Buffer.from('hello world'),
+  new Uint8Array([1, 2, 3, 4]),
+  new DataView(new ArrayBuffer(16)),
+];
+
+for (const algorithm of ['md5', 'sha1', 'sha256', 'sha512', 'sha3-256']) {
+  for (const data of inputs) {
+    const expected = crypto.createHash(algorithm).update(data).digest();
+    assert.strictEqual(crypto.hash(algorithm, data), expected.toString('hex'));
+    assert.deepStrictEqual(crypto.hash(algorithm, data, 'buffer'), expected);
+    assert.strictEqual(crypto.hash(algorithm, data, 'base64'),
+                       expected.toString('base64'));
+  }
+}
+
+// Small inputs are hashed on the main thread, large ones on the threadpool;
+// the callback is always called asynchronously.
+for (const size of [16, 1024 * 1024]) {
+  const data = Buffer.alloc(size, 'a');
+  const expected = crypto.createHash('sha256').update(data).digest('hex');
+  let sync = true;
+  crypto.hash('sha256', data, common.mustCall((err, digest) => {
+    assert.strictEqual(sync, false);
+    assert.strictEqual(err, null);
+    assert.strictEqual(digest, expected);
+  }));
+  crypto.hash('sha256', data.toString(), 'buffer',
+              common.mustCall((err, digest) => {
+                assert.strictEqual(err, null);
+                assert.strictEqual(digest.toString('hex'), expected);
+              }));
+  sync = false;
+}
+
+assert.throws(() => crypto.hash('unknown', 'data'), {
+  code: 'ERR_CRYPTO_INVALID_DIGEST'
+});
+assert.throws(() => crypto.hash('unknown', Buffer.alloc(1024 * 1024),
+                                common.mustNotCall()), {
+  code: 'ERR_CRYPTO_INVALID_DIGEST'
+});
+for (const data of [undefined, null, 1, {}]) {
+  assert.throws(() => crypto.hash('sha256', data), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+assert.throws(() => crypto.hash(1, 'data'), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+assert.throws(() => crypto.hash('sha256', 'data', 'unknown'), {
+  code: 'ERR_UNKNOWN_ENCODING'
+});
+assert.throws(() => crypto.hash('sha256', 'data', 'hex', 'not a function'), {
+  code: 'ERR_INVALID_CALLBACK'
+});
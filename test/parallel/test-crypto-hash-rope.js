@@ -0,0 +1,24 @@
+'use strict';
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const { Rope } = require('buffer');
+const crypto = require('crypto');
+
+// Hashes and HMACs are updated with the chunks of a rope one by one, which
+// gives the same digest as the concatenated data.
+
+const input = new Rope(['a'.repeat(100), Buffer.alloc(1000, 'b'), 'c']);
+const flat = Buffer.concat([...input]);
+
+assert.strictEqual(
+  crypto.createHash('sha256').update(input).digest('hex'),
+  crypto.createHash('sha256').update(flat).digest('hex'));
+assert.strictEqual(
+  crypto.createHmac('sha256', 'key').update(input).digest('hex'),
+  crypto.createHmac('sha256', 'key').update(flat).digest('hex'));
+assert.strictEqual(
+  crypto.createHash('md5').update(new Rope()).digest('hex'),
+  crypto.createHash('md5').digest('hex'));
@@ -0,0 +1,56 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// Keys that are passed as PEM or DER are cached after they have been parsed.
+// Check that reusing the same input keeps working and that the cache does
+// not bypass passphrase checks or mix up keys that differ in their format.
+
+const assert = require('assert');
+const crypto = require('crypto');
+const fixtures = require('../common/fixtures');
+
+const privatePem = fixtures.readKey('rsa_private.pem', 'ascii');
+const publicPem = fixtures.readKey('rsa_public.pem', 'ascii');
+const encryptedPem = fixtures.readKey('rsa_private_encrypted.pem', 'ascii');
+const data = Buffer.from('Hello world');
+
+for (let i = 0; i < 3; i++) {
+  const signature = crypto.sign('sha256', data, privatePem);
+  assert(crypto.verify('sha256', data, publicPem, signature));
+  assert(crypto.verify('sha256', data, privatePem, signature));
+
+  const ciphertext = crypto.publicEncrypt(publicPem, data);
+  assert.deepStrictEqual(crypto.privateDecrypt(privatePem, ciphertext), data);
+}
+
+{
+  // A successfully parsed encrypted key does not make a wrong or missing
+  // passphrase acceptable.
+  const key = { key: encryptedPem, passphrase: 'password' };
+  const signature = crypto.sign('sha256', data, key);
+  assert(crypto.verify('sha256', data, publicPem, signature));
+  assert.deepStrictEqual(crypto.sign('sha256', data, key), signature);
+
+  assert.throws(() => {
+    crypto.sign('sha256', data, { key: encryptedPem, passphrase: 'wrong' });
+  }, /bad decrypt/);
+  assert.throws(() => {
+    crypto.sign('sha256', data, encryptedPem);
+  }, { code: 'ERR_MISSING_PASSPHRASE' });
+}
+
+{
+  // The same bytes with a different encoding are parsed separately.
+  const der = crypto.createPrivateKey(privatePem).export({
+    type: 'pkcs1',
+    format: 'der'
+  });
+  const key = { key: der, format: 'der', type: 'pkcs1' };
+  const signature = crypto.sign('sha256', data, key);
+  assert(crypto.verify('sha256', data, publicPem, signature));
+  assert.throws(() => {
+    crypto.sign('sha256', data, { key: der, format: 'der', type: 'pkcs8' });
+  }, Error);
+}
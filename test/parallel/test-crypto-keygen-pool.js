@@ -0,0 +1,74 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const { createKeyPairPool, KeyPairPool, KeyObject } = require('crypto');
+
+// The key options are validated when the pool is created.
+assert.throws(() => createKeyPairPool('rsa', {}), {
+  code: 'ERR_INVALID_OPT_VALUE'
+});
+assert.throws(() => createKeyPairPool('ec', { namedCurve: 'P-256' }, {
+  lowWaterMark: 4,
+  highWaterMark: 2
+}), {
+  code: 'ERR_OUT_OF_RANGE'
+});
+assert.throws(() => createKeyPairPool('ec', { namedCurve: 'P-256' }, {
+  concurrency: 0
+}), {
+  code: 'ERR_OUT_OF_RANGE'
+});
+
+{
+  const pool = createKeyPairPool('ec', { namedCurve: 'P-256' }, {
+    lowWaterMark: 2,
+    highWaterMark: 4
+  });
+  assert.ok(pool instanceof KeyPairPool);
+  assert.strictEqual(pool.size, 0);
+  assert.strictEqual(pool.take(), null);
+
+  function waitForSize(size, callback) {
+    if (pool.size === size)
+      return callback();
+    setTimeout(waitForSize, 10, size, callback);
+  }
+
+  waitForSize(4, common.mustCall(() => {
+    // Taking key pairs down to the low water mark does not refill the pool.
+    const { publicKey, privateKey } = pool.take();
+    assert.ok(publicKey instanceof KeyObject);
+    assert.strictEqual(publicKey.type, 'public');
+    assert.strictEqual(privateKey.type, 'private');
+    assert.strictEqual(privateKey.asymmetricKeyType, 'ec');
+    pool.take();
+    assert.strictEqual(pool.size, 2);
+
+    // Below the low water mark it is refilled up to the high water mark.
+    pool.take();
+    waitForSize(4, common.mustCall(() => {
+      pool.close();
+      assert.strictEqual(pool.size, 0);
+      assert.strictEqual(pool.take(), null);
+    }));
+  }));
+}
+
+{
+  // Encoded key pairs.
+  const pool = createKeyPairPool('ed25519', {
+    publicKeyEncoding: { type: 'spki', format: 'pem' },
+    privateKeyEncoding: { type: 'pkcs8', format: 'der' }
+  }, { lowWaterMark: 0, highWaterMark: 1, concurrency: 1 });
+  pool.once('error', common.mustNotCall());
+  setTimeout(function check() {
+    const keyPair = pool.take();
+    if (keyPair === null)
+      return setTimeout(check, 10);
+    assert.strictEqual(typeof keyPair.publicKey, 'string');
+    assert.ok(Buffer.isBuffer(keyPair.privateKey));
+  }, 10);
+}
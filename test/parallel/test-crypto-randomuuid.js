@@ -0,0 +1,69 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const crypto = require('crypto');
+
+const { randomUUID } = crypto;
+
+const kUUID = /^[0-9a-f]{8}-[0-9a-f]{4}-4[0-9a-f]{3}-[89ab][0-9a-f]{3}-[0-9a-f]{12}$/;
+
+{
+  // Enough UUIDs to use up and replace the entropy cache several times,
+  // including with a refill from the threadpool in between.
+  const seen = new Set();
+  for (let i = 0; i < 1000; i++) {
+    for (const disableEntropyCache of [false, true]) {
+      const uuid = randomUUID({ disableEntropyCache });
+      assert(kUUID.test(uuid), uuid);
+      assert(!seen.has(uuid));
+      seen.add(uuid);
+    }
+  }
+  setImmediate(common.mustCall(() => {
+    for (let i = 0; i < 1000; i++) {
+      const uuid = randomUUID();
+      assert(kUUID.test(uuid), uuid);
+      assert(!seen.has(uuid));
+      seen.add(uuid);
+    }
+  }));
+}
+
+{
+  // Small synchronous requests are served from the cache as well, and never
+  // return the same bytes twice.
+  const seen = new Set();
+  for (let i = 0; i < 1000; i++) {
+    const hex = crypto.randomBytes(16).toString('hex');
+    assert(!seen.has(hex));
+    seen.add(hex);
+  }
+
+  const buf = new Uint32Array(8);
+  crypto.randomFillSync(buf, 2, 4);
+  assert.strictEqual(buf[0], 0);
+  assert.strictEqual(buf[1], 0);
+  assert.strictEqual(buf[6], 0);
+  assert.strictEqual(buf[7], 0);
+  assert.notDeepStrictEqual(buf.subarray(2, 6), new Uint32Array(4));
+
+  const view = new DataView(new ArrayBuffer(16), 4);
+  crypto.randomFillSync(view);
+  assert.notDeepStrictEqual(Buffer.from(view.buffer, 4),
+                            Buffer.alloc(12));
+  assert.deepStrictEqual(Buffer.from(view.buffer, 0, 4), Buffer.alloc(4));
+}
+
+for (const options of [null, 1, 'true']) {
+  assert.throws(() => randomUUID(options), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+for (const disableEntropyCache of [null, 1, 'true']) {
+  assert.throws(() => randomUUID({ disableEntropyCache }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
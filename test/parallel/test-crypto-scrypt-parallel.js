@@ -0,0 +1,51 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// When maxmem leaves room for it, the lanes of crypto.scrypt() with p > 1 run
+// as separate threadpool work. The result must not change.
+
+const assert = require('assert');
+const crypto = require('crypto');
+const { monitorThreadpool } = require('perf_hooks');
+
+const monitor = monitorThreadpool();
+monitor.enable();
+
+const cases = [
+  // Room for all lanes at once.
+  { N: 1024, r: 8, p: 16, maxmem: 64 * 1024 * 1024 },
+  // Room for some of them, so that groups of lanes run one after the other.
+  { N: 1024, r: 8, p: 5, maxmem: 3 * 1024 * 1024 + 5 * 1024 },
+  // Room for one lane at a time only.
+  { N: 16384, r: 8, p: 2 },
+  // Odd block sizes.
+  { N: 16, r: 3, p: 7, maxmem: 1024 * 1024 },
+];
+
+let pending = cases.length;
+for (const options of cases) {
+  const expected = crypto.scryptSync('password', 'NaCl', 65, options);
+  crypto.scrypt('password', 'NaCl', 65, options,
+                common.mustCall((err, key) => {
+                  assert.ifError(err);
+                  assert.deepStrictEqual(key, expected);
+                  if (--pending === 0) {
+                    monitor.disable();
+                    assert(monitor.kdf.run.max > 0);
+                    assert.strictEqual(monitor.crypto.run.max, 0);
+                  }
+                }));
+}
+
+// A test vector from RFC 7914.
+crypto.scrypt('password', 'NaCl', 64, {
+  N: 1024, r: 8, p: 16, maxmem: 64 * 1024 * 1024
+}, common.mustCall((err, key) => {
+  assert.ifError(err);
+  assert.strictEqual(
+    key.toString('hex'),
+    'fdbabe1c9d3472007856e7190d01e9fe7c6ad7cbc8237830e77376634b373162' +
+    '2eaf30d92e22a3886ff109279d9830dac727afb94a83ee6d8360cbdfa2cc0640');
+}));
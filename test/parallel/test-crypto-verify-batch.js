@@ -0,0 +1,106 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const crypto = require('crypto');
+
+const rsa = crypto.generateKeyPairSync('rsa', { modulusLength: 1024 });
+const ec = crypto.generateKeyPairSync('ec', { namedCurve: 'P-256' });
+const ed = crypto.generateKeyPairSync('ed25519');
+
+function makeItems(algorithm, { publicKey, privateKey }, options, count) {
+  const items = [];
+  for (let i = 0; i < count; i++) {
+    const data = Buffer.from(`message ${i}`);
+    const signature = crypto.sign(algorithm, data,
+                                  { key: privateKey, ...options });
+    items.push({
+      data,
+      key: options ? { key: publicKey, ...options } : publicKey,
+      signature
+    });
+  }
+  // Every third item does not match its signature.
+  for (let i = 0; i < count; i += 3)
+    items[i].data = Buffer.from('tampered');
+  return items;
+}
+
+function checkResults(items, algorithm, results) {
+  assert(results instanceof Uint8Array);
+  assert.strictEqual(results.length, items.length);
+  for (let i = 0; i < items.length; i++) {
+    const expected = crypto.verify(algorithm, items[i].data, items[i].key,
+                                   items[i].signature);
+    assert.strictEqual(results[i], expected ? 1 : 0);
+    assert.strictEqual(results[i], i % 3 === 0 ? 0 : 1);
+  }
+}
+
+for (const [algorithm, keys, options, count] of [
+  ['sha256', rsa, undefined, 10],
+  ['sha256', rsa, {
+    padding: crypto.constants.RSA_PKCS1_PSS_PADDING,
+    saltLength: 16
+  }, 10],
+  ['sha256', ec, undefined, 600],  // More than one chunk.
+  ['sha384', ec, { dsaEncoding: 'ieee-p1363' }, 10],
+  [null, ed, undefined, 10],
+]) {
+  const items = makeItems(algorithm, keys, options, count);
+  crypto.verifyBatch(items, algorithm, common.mustCall((err, results) => {
+    assert.strictEqual(err, null);
+    checkResults(items, algorithm, results);
+  }));
+}
+
+// Keys that cannot be used with the algorithm, and malformed signatures,
+// fail verification of that item only.
+{
+  const data = Buffer.from('data');
+  const items = [
+    { data, key: ed.publicKey,
+      signature: crypto.sign(null, data, ed.privateKey) },
+    { data, key: { key: ec.publicKey, dsaEncoding: 'ieee-p1363' },
+      signature: Buffer.alloc(3) },
+    { data, key: rsa.publicKey,
+      signature: crypto.sign('sha256', data, rsa.privateKey) },
+  ];
+  crypto.verifyBatch(items, 'sha256', common.mustCall((err, results) => {
+    assert.strictEqual(err, null);
+    assert.deepStrictEqual([...results], [0, 0, 1]);
+  }));
+}
+
+crypto.verifyBatch([], 'sha256', common.mustCall((err, results) => {
+  assert.strictEqual(err, null);
+  assert.strictEqual(results.length, 0);
+}));
+
+{
+  const valid = makeItems('sha256', ec, undefined, 1)[0];
+  assert.throws(() => crypto.verifyBatch([valid], 'nope', common.mustNotCall()),
+                { code: 'ERR_CRYPTO_INVALID_DIGEST' });
+  assert.throws(() => crypto.verifyBatch(valid, 'sha256', common.mustNotCall()),
+                { code: 'ERR_INVALID_ARG_TYPE' });
+  assert.throws(() => crypto.verifyBatch([valid], 'sha256'),
+                { code: 'ERR_INVALID_CALLBACK' });
+  for (const item of [
+    null,
+    { ...valid, key: ec.publicKey.export({ type: 'spki', format: 'pem' }) },
+    { ...valid, data: 'data' },
+    { ...valid, signature: undefined },
+  ]) {
+    assert.throws(() => crypto.verifyBatch([valid, item], 'sha256',
+                                           common.mustNotCall()),
+                  { code: 'ERR_INVALID_ARG_TYPE' });
+  }
+  assert.throws(() => crypto.verifyBatch([{
+    ...valid,
+    key: crypto.createSecretKey(Buffer.alloc(16))
+  }], 'sha256', common.mustNotCall()), {
+    code: 'ERR_CRYPTO_INVALID_KEY_OBJECT_TYPE'
+  });
+}
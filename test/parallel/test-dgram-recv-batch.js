@@ -0,0 +1,45 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+
+const count = 50;
+
+const server = dgram.createSocket({ type: 'udp4', recvBatch: true });
+const client = dgram.createSocket('udp4');
+
+let batched = 0;
+let received = 0;
+
+server.on('messages', common.mustCallAtLeast((messages) => {
+  assert.ok(Array.isArray(messages));
+  assert.ok(messages.length > 0);
+  for (const { msg, rinfo } of messages) {
+    assert.ok(Buffer.isBuffer(msg));
+    assert.strictEqual(msg.toString(), 'ping');
+    assert.strictEqual(rinfo.address, common.localhostIPv4);
+    assert.strictEqual(rinfo.port, client.address().port);
+    assert.strictEqual(rinfo.family, 'IPv4');
+    assert.strictEqual(rinfo.size, msg.length);
+  }
+  batched += messages.length;
+}, 1));
+
+server.on('message', common.mustCall((msg, rinfo) => {
+  assert.strictEqual(msg.toString(), 'ping');
+  assert.strictEqual(rinfo.size, 4);
+  if (++received === count) {
+    assert.strictEqual(batched, count);
+    server.close();
+    client.close();
+  }
+}, count));
+
+server.bind(0, common.mustCall(() => {
+  const { port } = server.address();
+  const messages = [];
+  for (let i = 0; i < count; i++)
+    messages.push({ msg: 'ping', port, address: common.localhostIPv4 });
+  client.sendBatch(messages);
+}));
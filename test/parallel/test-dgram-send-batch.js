@@ -0,0 +1,107 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+
+const count = 100;
+
+{
+  const server = dgram.createSocket('udp4');
+  const client = dgram.createSocket('udp4');
+  const received = [];
+
+  server.on('message', common.mustCall((msg, rinfo) => {
+    assert.strictEqual(rinfo.address, common.localhostIPv4);
+    assert.strictEqual(rinfo.port, client.address().port);
+    received.push(msg.toString());
+    if (received.length === count) {
+      const expected = [];
+      for (let i = 0; i < count; i++)
+        expected.push(`message ${i}`);
+      assert.deepStrictEqual(received.sort(), expected.sort());
+      server.close();
+    }
+  }, count));
+
+  server.bind(0, common.mustCall(() => {
+    const { port } = server.address();
+    const messages = [];
+    for (let i = 0; i < count; i++) {
+      const msg = `message ${i}`;
+      messages.push({
+        msg: i % 2 ? msg : Buffer.from(msg),
+        port,
+        address: common.localhostIPv4
+      });
+    }
+    client.sendBatch(messages, common.mustCall((err, sent) => {
+      assert.ifError(err);
+      assert.strictEqual(sent, count);
+      client.close();
+    }));
+  }));
+}
+
+{
+  // Connected sockets send to their remote endpoint.
+  const server = dgram.createSocket('udp4');
+  server.on('message', common.mustCall((msg) => {
+    assert.strictEqual(msg.toString(), 'connected');
+    server.close();
+  }));
+
+  server.bind(0, common.mustCall(() => {
+    const client = dgram.createSocket('udp4');
+    client.connect(server.address().port, common.mustCall(() => {
+      assert.throws(() => {
+        client.sendBatch([{ msg: 'x', port: 1, address: '127.0.0.1' }]);
+      }, { code: 'ERR_SOCKET_DGRAM_IS_CONNECTED' });
+
+      client.sendBatch([{ msg: 'connected' }], common.mustCall((err, sent) => {
+        assert.ifError(err);
+        assert.strictEqual(sent, 1);
+        client.close();
+      }));
+    }));
+  }));
+}
+
+{
+  const client = dgram.createSocket('udp4');
+
+  [null, undefined, 'foo', {}].forEach((messages) => {
+    assert.throws(() => client.sendBatch(messages), {
+      code: 'ERR_INVALID_ARG_TYPE'
+    });
+  });
+
+  assert.throws(() => client.sendBatch([], 'foo'), {
+    code: 'ERR_INVALID_CALLBACK'
+  });
+
+  assert.throws(() => client.sendBatch([null]), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+
+  assert.throws(() => {
+    client.sendBatch([{ msg: 42, port: 1, address: '127.0.0.1' }]);
+  }, { code: 'ERR_INVALID_ARG_TYPE' });
+
+  assert.throws(() => {
+    client.sendBatch([{ msg: 'x', port: 0, address: '127.0.0.1' }]);
+  }, { code: 'ERR_SOCKET_BAD_PORT' });
+
+  ['localhost', '::1', undefined].forEach((address) => {
+    assert.throws(() => {
+      client.sendBatch([{ msg: 'x', port: 1, address }]);
+    }, { code: 'ERR_INVALID_ARG_VALUE' });
+  });
+
+  // An empty batch completes without sending anything.
+  client.sendBatch([], common.mustCall((err, sent) => {
+    assert.ifError(err);
+    assert.strictEqual(sent, 0);
+    client.close();
+  }));
+}
@@ -0,0 +1,58 @@
+'use strict';
+
+const common = require('../common');
+if (!common.isLinux)
+  common.skip('UDP segmentation offload is only supported on Linux');
+
+const assert = require('assert');
+const dgram = require('dgram');
+
+const segmentSize = 1000;
+const data = Buffer.alloc(segmentSize * 3 + 500);
+for (let i = 0; i < data.length; i++)
+  data[i] = i % 251;
+
+const server = dgram.createSocket('udp4');
+const client = dgram.createSocket('udp4');
+
+server.bind(0, common.localhostIPv4, common.mustCall(() => {
+  try {
+    server.setGRO(true);
+  } catch (err) {
+    if (err.code === 'ENOPROTOOPT' || err.code === 'ENOTSUP') {
+      server.close();
+      client.close();
+      common.printSkipMessage('UDP GRO is not supported by the kernel');
+      return;
+    }
+    throw err;
+  }
+
+  const received = [];
+  server.on('message', common.mustCall((msg, rinfo) => {
+    assert.strictEqual(rinfo.size, msg.length);
+    received.push(msg);
+    if (received.length === 4) {
+      assert.deepStrictEqual(received.map((m) => m.length),
+                             [segmentSize, segmentSize, segmentSize, 500]);
+      assert.deepStrictEqual(Buffer.concat(received), data);
+      server.close();
+      client.close();
+    }
+  }, 4));
+
+  client.bind(0, common.mustCall(() => {
+    assert.throws(() => client.setGSOSegmentSize(65536), {
+      code: 'ERR_OUT_OF_RANGE'
+    });
+    assert.throws(() => client.setGSOSegmentSize('1000'), {
+      code: 'ERR_INVALID_ARG_TYPE'
+    });
+    assert.strictEqual(client.setGSOSegmentSize(segmentSize), segmentSize);
+    client.send(data, server.address().port, common.localhostIPv4,
+                common.mustCall((err, bytes) => {
+                  assert.ifError(err);
+                  assert.strictEqual(bytes, data.length);
+                }));
+  }));
+}));
@@ -0,0 +1,93 @@
+'use strict';
+const common = require('../common');
+const dnstools = require('../common/dns');
+const dns = require('dns');
+const assert = require('assert');
+const dgram = require('dgram');
+const { promisify } = require('util');
+const dnsPromises = dns.promises;
+
+const answers = {
+  A: { type: 'A', address: '1.2.3.4', ttl: 123 },
+  AAAA: { type: 'AAAA', address: '::42', ttl: 60 },
+};
+
+let queries = 0;
+const server = dgram.createSocket('udp4');
+
+server.on('message', (msg, { address, port }) => {
+  const parsed = dnstools.parseDNSPacket(msg);
+  const { domain, type } = parsed.questions[0];
+  assert.strictEqual(domain, 'example.org');
+  queries++;
+
+  server.send(dnstools.writeDNSPacket({
+    id: parsed.id,
+    questions: parsed.questions,
+    answers: [{ domain, ...answers[type] }],
+  }), port, address);
+});
+
+[null, 'a', 1, true].forEach((options) => {
+  assert.throws(() => dns.setLookupCache(options),
+                { code: 'ERR_INVALID_ARG_TYPE' });
+});
+[{ maxTtl: -1 }, { negativeTtl: 1.5 }, { staleTtl: 2 ** 32 },
+ { maxEntries: 0 }].forEach((options) => {
+  assert.throws(() => dns.setLookupCache(options),
+                { code: 'ERR_OUT_OF_RANGE' });
+});
+
+server.bind(0, common.mustCall(async () => {
+  dns.setServers([`127.0.0.1:${server.address().port}`]);
+  dns.setLookupCache();
+
+  // Both records are queried for lookups that accept any family.
+  const lookup = promisify(dns.lookup);
+  assert.deepStrictEqual(await lookup('example.org', { all: true }), [
+    { address: '1.2.3.4', family: 4 },
+    { address: '::42', family: 6 },
+  ]);
+  assert.strictEqual(queries, 2);
+
+  // Later lookups are answered from the cache, whatever the case of the name.
+  assert.deepStrictEqual(await lookup('EXAMPLE.org'),
+                         { address: '1.2.3.4', family: 4 });
+  assert.deepStrictEqual(await dnsPromises.lookup('example.org'),
+                         { address: '1.2.3.4', family: 4 });
+  assert.strictEqual(queries, 2);
+
+  // Each family is cached separately.
+  assert.deepStrictEqual(await dnsPromises.lookup('example.org', 6),
+                         { address: '::42', family: 6 });
+  assert.strictEqual(queries, 3);
+
+  // Concurrent lookups of a name that is not cached share one query.
+  dns.clearLookupCache();
+  const results = await Promise.all([
+    dnsPromises.lookup('example.org', 4),
+    dnsPromises.lookup('example.org', 4),
+  ]);
+  assert.deepStrictEqual(results, [
+    { address: '1.2.3.4', family: 4 },
+    { address: '1.2.3.4', family: 4 },
+  ]);
+  assert.strictEqual(queries, 4);
+
+  // Expired entries are still served for staleTtl, and refreshed in the
+  // background.
+  dns.setLookupCache({ maxTtl: 0, staleTtl: 60 });
+  dns.clearLookupCache();
+  await dnsPromises.lookup('example.org', 4);
+  assert.strictEqual(queries, 5);
+  const refreshed = new Promise((resolve) => {
+    server.once('message', () => setImmediate(resolve));
+  });
+  assert.deepStrictEqual(await dnsPromises.lookup('example.org', 4),
+                         { address: '1.2.3.4', family: 4 });
+  await refreshed;
+  assert.strictEqual(queries, 6);
+
+  dns.setLookupCache(false);
+  server.close();
+}));
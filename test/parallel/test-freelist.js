@@ -28,3 +28,33 @@ assert.strictEqual(flist1.free({ id: 'test5' }), false);
 assert.strictEqual(flist1.alloc().id, 'test3');
 assert.strictEqual(flist1.alloc().id, 'test2');
 assert.strictEqual(flist1.alloc().id, 'test1');
+
+// An adaptive list keeps no more objects than the recent peak in use.
+{
+  const flist2 = new FreeList('flist2', 3, Object, true);
+  const objects = [flist2.alloc(), flist2.alloc()];
+  assert.strictEqual(flist2.peak, 2);
+  assert.strictEqual(flist2.inUse, 2);
+
+  assert(flist2.free(objects.pop()));
+  assert(flist2.free(objects.pop()));
+  assert.strictEqual(flist2.list.length, 2);
+  assert.strictEqual(flist2.free({ id: 'extra' }), false);
+
+  // Never more than `max`, even if more objects were in use.
+  for (let i = 0; i < 4; i++)
+    objects.push(flist2.alloc());
+  for (const obj of objects)
+    flist2.free(obj);
+
+  assert.deepStrictEqual(flist2.stats(), {
+    name: 'flist2',
+    size: 3,
+    max: 3,
+    inUse: 0,
+    peak: 4,
+    hits: 2,
+    misses: 4,
+    discarded: 2,
+  });
+}
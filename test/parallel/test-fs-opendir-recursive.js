@@ -0,0 +1,137 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+const tmpdir = require('../common/tmpdir');
+
+// Test the recursive mode of fs.opendir(), fs.opendirSync() and
+// fs.promises.opendir().
+
+tmpdir.refresh();
+
+const root = path.join(tmpdir.path, 'tree');
+const expected = [];
+function make(relative, isDir) {
+  const full = path.join(root, relative);
+  if (isDir)
+    fs.mkdirSync(full);
+  else
+    fs.writeFileSync(full, relative);
+  expected.push({ name: relative, depth: relative.split(path.sep).length - 1,
+                  isDir });
+}
+
+fs.mkdirSync(root);
+make('a', true);
+make(path.join('a', 'b'), true);
+make(path.join('a', 'b', 'c'), true);
+make(path.join('a', 'b', 'c', 'deep.txt'), false);
+make(path.join('a', 'b', 'file.txt'), false);
+make(path.join('a', 'empty'), true);
+make('top.txt', false);
+for (let i = 0; i < 50; i++)
+  make(path.join('a', `many-${i}`), false);
+
+function expectedNames(maxDepth = Infinity) {
+  return expected.filter((e) => e.depth <= maxDepth)
+                 .map((e) => e.name)
+                 .sort();
+}
+
+function check(dirents, maxDepth) {
+  assert.deepStrictEqual(dirents.map((d) => d.name).sort(),
+                         expectedNames(maxDepth));
+  for (const dirent of dirents) {
+    const entry = expected.find((e) => e.name === dirent.name);
+    assert.strictEqual(dirent.isDirectory(), entry.isDir);
+    assert.strictEqual(dirent.isFile(), !entry.isDir);
+  }
+}
+
+function readAllSync(options) {
+  const dir = fs.opendirSync(root, { recursive: true, ...options });
+  const dirents = [];
+  let dirent;
+  while ((dirent = dir.readSync()) !== null)
+    dirents.push(dirent);
+  dir.closeSync();
+  return dirents;
+}
+
+check(readAllSync());
+check(readAllSync({ bufferSize: 1 }));
+check(readAllSync({ maxDepth: 0 }), 0);
+check(readAllSync({ maxDepth: 1, bufferSize: 7 }), 1);
+
+fs.opendir(root, { recursive: true }, common.mustCall((err, dir) => {
+  assert.ifError(err);
+  const dirents = [];
+  function next() {
+    dir.read(common.mustCall((err, dirent) => {
+      assert.ifError(err);
+      if (dirent === null) {
+        check(dirents);
+        dir.close(common.mustCall(assert.ifError));
+        return;
+      }
+      dirents.push(dirent);
+      next();
+    }));
+  }
+  next();
+}));
+
+async function doPromiseTest() {
+  const dir = await fs.promises.opendir(root, {
+    recursive: true,
+    maxDepth: 2,
+    bufferSize: 3,
+  });
+  const dirents = [];
+  for await (const dirent of dir)
+    dirents.push(dirent);
+  check(dirents, 2);
+}
+doPromiseTest().then(common.mustCall());
+
+{
+  // Closing the handle in the middle of a walk closes the subdirectory that
+  // is being read as well.
+  const dir = fs.opendirSync(root, { recursive: true, bufferSize: 1 });
+  for (let i = 0; i < 10; i++)
+    assert.notStrictEqual(dir.readSync(), null);
+  dir.closeSync();
+}
+
+{
+  // A read that is made while a walk runs on the threadpool fails, and
+  // closing the handle waits for the walk to finish.
+  const dir = fs.opendirSync(root, { recursive: true, bufferSize: 1 });
+  dir.read(common.mustCall((err, dirent) => {
+    assert.ifError(err);
+    assert.notStrictEqual(dirent, null);
+  }));
+  assert.throws(() => dir.readSync(), { code: 'EBUSY', syscall: 'readdir' });
+  dir.close(common.mustCall(assert.ifError));
+}
+
+{
+  const dir = fs.opendirSync(root, { recursive: true, bufferSize: 1 });
+  dir.read(common.mustCall((err, dirent) => {
+    assert.ifError(err);
+    assert.notStrictEqual(dirent, null);
+  }));
+  dir.closeSync();
+}
+
+for (const maxDepth of [-1, 1.5, NaN]) {
+  assert.throws(() => fs.opendirSync(root, { recursive: true, maxDepth }), {
+    code: 'ERR_OUT_OF_RANGE',
+  });
+}
+assert.throws(() => fs.opendirSync(root, { recursive: 'yes' }), {
+  code: 'ERR_INVALID_ARG_TYPE',
+});
@@ -0,0 +1,100 @@
+'use strict';
+
+const common = require('../common');
+
+// The following tests validate filehandle.map() and filehandle.unmap().
+
+if (common.isWindows)
+  common.skip('filehandle.map() is not supported on Windows');
+
+const assert = require('assert');
+const fs = require('fs');
+const { open } = fs.promises;
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+const contents = Buffer.alloc(3 * 65536 + 123);
+for (let i = 0; i < contents.length; i++)
+  contents[i] = i % 241;
+const filename = path.join(tmpdir.path, 'map.bin');
+fs.writeFileSync(filename, contents);
+
+async function validateMap() {
+  const handle = await open(filename, 'r');
+
+  const whole = await handle.map();
+  assert(Buffer.isBuffer(whole));
+  assert.deepStrictEqual(whole, contents);
+
+  // Offsets do not have to be page aligned.
+  for (const advice of ['normal', 'sequential', 'random', 'willneed']) {
+    const part = await handle.map({ offset: 4097, length: 1000, advice });
+    assert.strictEqual(part.length, 1000);
+    assert.deepStrictEqual(part, contents.slice(4097, 5097));
+  }
+
+  const tail = await handle.map({ offset: contents.length - 10 });
+  assert.deepStrictEqual(tail, contents.slice(contents.length - 10));
+
+  const empty = await handle.map({ offset: contents.length + 10 });
+  assert.strictEqual(empty.length, 0);
+  await handle.unmap(empty);
+
+  // The mapping stays valid after the file has been closed.
+  await handle.close();
+  assert.strictEqual(whole[12345], contents[12345]);
+
+  // Explicitly releasing a mapping detaches the ArrayBuffer.
+  await handle.unmap(whole);
+  assert.strictEqual(whole.length, 0);
+  assert.strictEqual(whole.buffer.byteLength, 0);
+  await assert.rejects(handle.unmap(whole), {
+    code: 'ERR_INVALID_ARG_VALUE',
+  });
+}
+
+async function validateErrors() {
+  const handle = await open(filename, 'r');
+
+  await assert.rejects(handle.unmap(Buffer.alloc(10)), {
+    code: 'ERR_INVALID_ARG_VALUE',
+  });
+  await assert.rejects(handle.map({ advice: 'often' }), {
+    code: 'ERR_INVALID_ARG_VALUE',
+  });
+  await assert.rejects(handle.map({ offset: -1 }), {
+    code: 'ERR_OUT_OF_RANGE',
+  });
+  await assert.rejects(handle.map({ length: 1.5 }), {
+    code: 'ERR_OUT_OF_RANGE',
+  });
+  // Ranges past the end of the file cannot be mapped.
+  for (const [offset, length] of [[0, contents.length + 1],
+                                  [contents.length - 10, 11],
+                                  [contents.length + 10, 1]]) {
+    await assert.rejects(handle.map({ offset, length }), {
+      code: 'ERR_OUT_OF_RANGE',
+    });
+  }
+
+  const other = await open(filename, 'r');
+  const buffer = await other.map({ length: 10 });
+  await assert.rejects(handle.unmap(buffer), {
+    code: 'ERR_INVALID_ARG_VALUE',
+  });
+  await other.unmap(buffer);
+  await other.close();
+  await handle.close();
+
+  // Write-only descriptors cannot be mapped.
+  const writeOnly = await open(path.join(tmpdir.path, 'wo.bin'), 'w');
+  await writeOnly.write('x');
+  await assert.rejects(writeOnly.map(), { code: 'EACCES', syscall: 'mmap' });
+  await writeOnly.close();
+}
+
+validateMap()
+  .then(validateErrors)
+  .then(common.mustCall());
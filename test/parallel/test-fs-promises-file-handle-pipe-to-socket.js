@@ -0,0 +1,133 @@
+'use strict';
+
+const common = require('../common');
+
+// The following tests validate filehandle.pipeTo() with a net.Socket
+// destination, which sends the file with sendfile(2) where possible.
+
+const assert = require('assert');
+const fs = require('fs');
+const net = require('net');
+const { open } = fs.promises;
+const path = require('path');
+const fixtures = require('../common/fixtures');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+// Large enough to fill the socket send buffer.
+const contents = Buffer.alloc(8 * 1024 * 1024);
+for (let i = 0; i < contents.length; i++)
+  contents[i] = i % 251;
+const src = path.join(tmpdir.path, 'src');
+fs.writeFileSync(src, contents);
+
+// Sends `head`, the file range and `tail` through the connection created by
+// `listen`, and checks what arrives on the other side.
+async function validate(listen, connect, options, expected) {
+  const handle = await open(src, 'r');
+  const received = [];
+  await new Promise((resolve) => {
+    const server = listen(common.mustCall(async (socket) => {
+      socket.write('head');
+      const sent = await handle.pipeTo(socket, options);
+      assert.strictEqual(sent, expected.length);
+      // Several writes queued while the file is being sent are delivered
+      // after it, in order.
+      socket.write('ta');
+      socket.end('il');
+      server.close();
+    }));
+    server.listen(0, common.mustCall(() => {
+      const client = connect(server.address().port);
+      client.on('data', (chunk) => received.push(chunk));
+      client.on('end', common.mustCall(resolve));
+    }));
+  });
+  await handle.close();
+
+  const data = Buffer.concat(received);
+  assert.strictEqual(data.length, expected.length + 8);
+  assert.strictEqual(data.toString('latin1', 0, 4), 'head');
+  assert(data.slice(4, -4).equals(expected));
+  assert.strictEqual(data.toString('latin1', data.length - 4), 'tail');
+}
+
+function listenTcp(onConnection) {
+  return net.createServer(onConnection);
+}
+
+function connectTcp(port) {
+  return net.connect(port);
+}
+
+async function validateTcp() {
+  await validate(listenTcp, connectTcp, undefined, contents);
+  await validate(listenTcp, connectTcp, { offset: 1000, length: 100000 },
+                 contents.slice(1000, 101000));
+  await validate(listenTcp, connectTcp, { offset: contents.length - 10 },
+                 contents.slice(contents.length - 10));
+  await validate(listenTcp, connectTcp, { length: 0 }, Buffer.alloc(0));
+}
+
+// The TLS cases are skipped when Node is built without crypto.
+/* eslint-disable node-core/crypto-check */
+async function validateTls() {
+  if (!common.hasCrypto)
+    return;
+  const tls = require('tls');
+  const listenTls = (onConnection) => tls.createServer({
+    key: fixtures.readKey('agent1-key.pem'),
+    cert: fixtures.readKey('agent1-cert.pem')
+  }, onConnection);
+  const connectTls = (port) => tls.connect({ port, rejectUnauthorized: false });
+
+  await validate(listenTls, connectTls, { offset: 5, length: 300000 },
+                 contents.slice(5, 300005));
+}
+/* eslint-enable node-core/crypto-check */
+
+async function validateErrors() {
+  const handle = await open(src, 'r');
+  await assert.rejects(handle.pipeTo({}), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+
+  const socket = new net.Socket();
+  socket.destroy();
+  await assert.rejects(handle.pipeTo(socket), Error);
+  await handle.close();
+}
+
+// Destroying the socket stops the transfer and closes the connection, which
+// the peer sees even though it has not read all of the file.
+async function validateDestroy() {
+  // Sparse, and larger than the socket buffers on both sides.
+  const large = path.join(tmpdir.path, 'large');
+  fs.writeFileSync(large, '');
+  fs.truncateSync(large, 64 * 1024 * 1024);
+  const handle = await open(large, 'r');
+  await new Promise((resolve) => {
+    let client;
+    const server = net.createServer(common.mustCall((socket) => {
+      server.close();
+      const promise = handle.pipeTo(socket);
+      setTimeout(() => socket.destroy(), common.platformTimeout(100));
+      assert.rejects(promise, {
+        code: 'ERR_STREAM_DESTROYED'
+      }).then(common.mustCall(() => client.resume()));
+    }));
+    server.listen(0, common.mustCall(() => {
+      client = net.connect(server.address().port);
+      client.pause();
+      client.on('close', common.mustCall(resolve));
+    }));
+  });
+  await handle.close();
+}
+
+validateTcp()
+  .then(validateTls)
+  .then(validateErrors)
+  .then(validateDestroy)
+  .then(common.mustCall());
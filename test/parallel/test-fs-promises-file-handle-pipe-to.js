@@ -0,0 +1,92 @@
+'use strict';
+
+const common = require('../common');
+
+// The following tests validate filehandle.pipeTo(), which copies data
+// between two open files inside the kernel.
+
+const assert = require('assert');
+const fs = require('fs');
+const { open } = fs.promises;
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+const contents = Buffer.alloc(256 * 1024);
+for (let i = 0; i < contents.length; i++)
+  contents[i] = i % 253;
+const src = path.join(tmpdir.path, 'src');
+fs.writeFileSync(src, contents);
+
+let counter = 0;
+function destPath() {
+  return path.join(tmpdir.path, `dest-${counter++}`);
+}
+
+async function validateWholeFile() {
+  const dest = destPath();
+  const source = await open(src, 'r');
+  const destination = await open(dest, 'w');
+  assert.strictEqual(await source.pipeTo(destination), contents.length);
+  await source.close();
+  await destination.close();
+  assert.deepStrictEqual(fs.readFileSync(dest), contents);
+}
+
+async function validateRange() {
+  const dest = destPath();
+  const source = await open(src, 'r');
+  const destination = await open(dest, 'w');
+  await destination.write('head');
+  // Copies are appended at the current position of the destination.
+  assert.strictEqual(
+    await source.pipeTo(destination, { offset: 1000, length: 5000 }), 5000);
+  assert.strictEqual(
+    await source.pipeTo(destination, { offset: contents.length - 10 }), 10);
+  assert.strictEqual(
+    await source.pipeTo(destination, { offset: contents.length + 10 }), 0);
+
+  // The position of the source file is not moved.
+  const { bytesRead, buffer } = await source.read(Buffer.alloc(4), 0, 4, null);
+  assert.strictEqual(bytesRead, 4);
+  assert.deepStrictEqual(buffer, contents.slice(0, 4));
+
+  await source.close();
+  await destination.close();
+  assert.deepStrictEqual(
+    fs.readFileSync(dest),
+    Buffer.concat([Buffer.from('head'),
+                   contents.slice(1000, 6000),
+                   contents.slice(contents.length - 10)]));
+
+}
+
+async function validateErrors() {
+  const source = await open(src, 'r');
+  // Not opened for writing.
+  const destination = await open(path.join(tmpdir.path, 'dest-0'), 'r');
+
+  await assert.rejects(source.pipeTo(destination), (err) => {
+    assert.strictEqual(err.syscall, 'sendfile');
+    if (!common.isWindows)
+      assert.strictEqual(err.code, 'EBADF');
+    return true;
+  });
+  await assert.rejects(source.pipeTo({ fd: 1 }), {
+    code: 'ERR_INVALID_ARG_TYPE',
+  });
+  await assert.rejects(source.pipeTo(destination, { offset: -1 }), {
+    code: 'ERR_OUT_OF_RANGE',
+  });
+  await assert.rejects(source.pipeTo(destination, { length: 1.5 }), {
+    code: 'ERR_OUT_OF_RANGE',
+  });
+  await source.close();
+  await destination.close();
+}
+
+validateWholeFile()
+  .then(validateRange)
+  .then(validateErrors)
+  .then(common.mustCall());
@@ -0,0 +1,59 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { open } = fs.promises;
+const tmpdir = require('../common/tmpdir');
+
+// filehandle.readLines() yields the lines of a file in batches, with the same
+// lines as splitting the contents of the file on '\n' and '\r\n'.
+
+tmpdir.refresh();
+
+async function readLines(contents, options) {
+  const file = path.join(tmpdir.path, 'lines');
+  fs.writeFileSync(file, contents);
+  const filehandle = await open(file, 'r');
+  const lines = [];
+  for await (const batch of filehandle.readLines(options)) {
+    assert(Array.isArray(batch));
+    assert(batch.length > 0);
+    lines.push(...batch);
+  }
+  await filehandle.close();
+  return lines;
+}
+
+async function run() {
+  assert.deepStrictEqual(await readLines(''), []);
+  assert.deepStrictEqual(await readLines('\n'), ['']);
+  assert.deepStrictEqual(await readLines('a'), ['a']);
+  assert.deepStrictEqual(await readLines('a\r\nb\n\nc\r'), ['a', 'b', '', 'c']);
+
+  // Lines that span blocks, and '\r\n' and multi-byte characters that are
+  // split between blocks.
+  const lines = [];
+  for (let i = 0; i < 200; i++)
+    lines.push('x'.repeat(i % 37) + (i % 5 === 0 ? 'é€' : ''));
+  const contents = lines.join('\r\n');
+  for (const highWaterMark of [1, 2, 3, 7, 64, 1024 * 1024]) {
+    assert.deepStrictEqual(await readLines(contents, { highWaterMark }),
+                           lines);
+  }
+  assert.deepStrictEqual(
+    await readLines(`${'y'.repeat(1000)}\n`, { highWaterMark: 16 }),
+    ['y'.repeat(1000)]);
+
+  for (const highWaterMark of [0, 1.5, '1']) {
+    const filehandle = await open(__filename, 'r');
+    await assert.rejects(filehandle.readLines({ highWaterMark }).next(), {
+      code: typeof highWaterMark === 'string' ?
+        'ERR_INVALID_ARG_TYPE' : 'ERR_OUT_OF_RANGE'
+    });
+    await filehandle.close();
+  }
+}
+
+run().then(common.mustCall());
@@ -0,0 +1,37 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const path = require('path');
+const { open } = require('fs').promises;
+const tmpdir = require('../common/tmpdir');
+
+// Concurrent filehandle.syncBatch() calls share fdatasync() calls: the first
+// call starts one right away, all calls made while it runs share the next.
+
+tmpdir.refresh();
+
+async function run() {
+  const filehandle = await open(path.join(tmpdir.path, 'batch'), 'w');
+
+  await filehandle.write('data');
+  const first = filehandle.syncBatch();
+  const batch = [];
+  for (let i = 0; i < 10; i++)
+    batch.push(filehandle.syncBatch());
+  assert.notStrictEqual(batch[0], first);
+  for (const promise of batch)
+    assert.strictEqual(promise, batch[0]);
+
+  assert.strictEqual(await first, undefined);
+  assert.strictEqual(await batch[0], undefined);
+
+  // Once everything settled, the next call starts a new sync.
+  const next = filehandle.syncBatch();
+  assert.notStrictEqual(next, batch[0]);
+  await next;
+
+  await filehandle.close();
+}
+
+run().then(common.mustCall());
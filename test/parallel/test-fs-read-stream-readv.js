@@ -0,0 +1,49 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+// Test that fs.ReadStream fills the tail of a partially used pool and the
+// head of a fresh one with a single readv() call, and that the data comes
+// out intact and in order.
+
+tmpdir.refresh();
+
+const small = path.join(tmpdir.path, 'small.txt');
+const large = path.join(tmpdir.path, 'large.txt');
+fs.writeFileSync(small, Buffer.alloc(100, 'x'));
+const content = Buffer.alloc(5000);
+for (let i = 0; i < content.length; i++)
+  content[i] = i % 251;
+fs.writeFileSync(large, content);
+
+let reads = 0;
+let readvs = 0;
+const countingFs = {
+  open: fs.open,
+  close: fs.close,
+  read(...args) {
+    reads++;
+    return fs.read(...args);
+  },
+  readv(...args) {
+    readvs++;
+    return fs.readv(...args);
+  }
+};
+
+// Leave the shared pool partially used: 4096 bytes allocated, 104 in use.
+fs.createReadStream(small, { highWaterMark: 4096 })
+  .resume()
+  .on('end', common.mustCall(() => {
+    const chunks = [];
+    fs.createReadStream(large, { highWaterMark: 1024, fs: countingFs })
+      .on('data', (chunk) => chunks.push(chunk))
+      .on('end', common.mustCall(() => {
+        assert.deepStrictEqual(Buffer.concat(chunks), content);
+        assert(reads > 0);
+        assert(readvs > 0);
+      }));
+  }));
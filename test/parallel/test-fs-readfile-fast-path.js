@@ -0,0 +1,76 @@
+'use strict';
+const common = require('../common');
+
+// Small regular files are read by fs.readFile() in a single binding call,
+// bigger and non-regular files fall back to the chunked JS read loop. Check
+// that both paths return the same results.
+
+const tmpdir = require('../common/tmpdir');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+tmpdir.refresh();
+
+const kFastPathMaxLength = 512 * 1024;
+
+function makeFile(name, len) {
+  const filename = path.join(tmpdir.path, name);
+  const contents = Buffer.allocUnsafe(len);
+  for (let i = 0; i < len; i++)
+    contents[i] = i % 251;
+  fs.writeFileSync(filename, contents);
+  return { filename, contents };
+}
+
+for (const len of [0, 1, 1024, kFastPathMaxLength, kFastPathMaxLength + 1]) {
+  const { filename, contents } = makeFile(`file-${len}`, len);
+
+  fs.readFile(filename, common.mustCall((err, buf) => {
+    assert.ifError(err);
+    assert(Buffer.isBuffer(buf));
+    assert.deepStrictEqual(buf, contents);
+  }));
+
+  for (const encoding of ['utf8', 'latin1', 'base64', 'hex']) {
+    fs.readFile(filename, encoding, common.mustCall((err, str) => {
+      assert.ifError(err);
+      assert.strictEqual(str, contents.toString(encoding));
+    }));
+  }
+}
+
+{
+  // A user fd is read from its current position and is not closed.
+  const { filename, contents } = makeFile('fd', 100);
+  const fd = fs.openSync(filename, 'r');
+  fs.readSync(fd, Buffer.alloc(10), 0, 10, null);
+  fs.readFile(fd, common.mustCall((err, buf) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(buf, contents.slice(10));
+    fs.fstatSync(fd);
+    fs.closeSync(fd);
+  }));
+}
+
+fs.readFile(path.join(tmpdir.path, 'does-not-exist'), common.mustCall((err) => {
+  assert.strictEqual(err.code, 'ENOENT');
+  assert.strictEqual(err.syscall, 'open');
+  assert.strictEqual(err.path, path.join(tmpdir.path, 'does-not-exist'));
+}));
+
+if (!common.isWindows && !common.isAIX && !common.isFreeBSD) {
+  // Directories are not regular files and take the fallback path.
+  fs.readFile(tmpdir.path, common.mustCall((err) => {
+    assert.strictEqual(err.code, 'EISDIR');
+    assert.strictEqual(err.syscall, 'read');
+  }));
+}
+
+if (common.isLinux) {
+  // Files in procfs report a size of 0 but are not empty.
+  fs.readFile('/proc/self/status', 'utf8', common.mustCall((err, str) => {
+    assert.ifError(err);
+    assert(str.startsWith('Name:'), str);
+  }));
+}
@@ -0,0 +1,89 @@
+'use strict';
+const common = require('../common');
+
+// Test fs.statMany() and fs.lstatMany().
+
+const tmpdir = require('../common/tmpdir');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+tmpdir.refresh();
+
+const files = [];
+for (let i = 0; i < 10; i++) {
+  const filename = path.join(tmpdir.path, `file-${i}`);
+  fs.writeFileSync(filename, 'x'.repeat(i));
+  files.push(filename);
+}
+const missing = path.join(tmpdir.path, 'does-not-exist');
+
+function checkStats(stats, expected) {
+  assert.strictEqual(stats.length, expected.length);
+  for (let i = 0; i < stats.length; i++) {
+    assert.ok(stats[i] instanceof fs.Stats);
+    assert.strictEqual(stats[i].ino, expected[i].ino);
+    assert.strictEqual(stats[i].size, expected[i].size);
+    assert.strictEqual(stats[i].isFile(), expected[i].isFile());
+  }
+}
+
+fs.statMany(files, common.mustCall((err, stats) => {
+  assert.ifError(err);
+  checkStats(stats, files.map((file) => fs.statSync(file)));
+}));
+
+fs.statMany(files, { bigint: true }, common.mustCall((err, stats) => {
+  assert.ifError(err);
+  for (let i = 0; i < files.length; i++) {
+    assert.strictEqual(stats[i].size, BigInt(i));
+    const expected = fs.statSync(files[i], { bigint: true });
+    assert.strictEqual(stats[i].ino, expected.ino);
+  }
+}));
+
+fs.statMany([], common.mustCall((err, stats) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(stats, []);
+}));
+
+fs.statMany([files[0], missing, files[1]], common.mustCall((err, stats) => {
+  assert.strictEqual(err.code, 'ENOENT');
+  assert.strictEqual(err.syscall, 'stat');
+  assert.strictEqual(err.path, missing);
+  assert.strictEqual(stats, undefined);
+}));
+
+fs.statMany([files[0], missing, files[1]], { throwIfNoEntry: false },
+            common.mustCall((err, stats) => {
+              assert.ifError(err);
+              assert.strictEqual(stats.length, 3);
+              assert.strictEqual(stats[0].size, 0);
+              assert.strictEqual(stats[1], undefined);
+              assert.strictEqual(stats[2].size, 1);
+            }));
+
+if (common.canCreateSymLink()) {
+  const link = path.join(tmpdir.path, 'link');
+  fs.symlinkSync(files[5], link);
+  fs.lstatMany([link, files[5]], common.mustCall((err, stats) => {
+    assert.ifError(err);
+    assert.ok(stats[0].isSymbolicLink());
+    assert.ok(stats[1].isFile());
+  }));
+  fs.statMany([link], common.mustCall((err, stats) => {
+    assert.ifError(err);
+    assert.ok(stats[0].isFile());
+    assert.strictEqual(stats[0].size, 5);
+  }));
+}
+
+assert.throws(() => fs.statMany('file', common.mustNotCall()), {
+  code: 'ERR_INVALID_ARG_TYPE',
+});
+assert.throws(() => fs.statMany([files[0], 42], common.mustNotCall()), {
+  code: 'ERR_INVALID_ARG_TYPE',
+});
+assert.throws(() => fs.statMany(files), {
+  code: 'ERR_INVALID_CALLBACK',
+});
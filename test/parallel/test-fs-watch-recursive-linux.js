@@ -0,0 +1,56 @@
+'use strict';
+
+const common = require('../common');
+
+if (!common.isLinux)
+  common.skip('recursive watching is implemented natively only on Linux');
+
+// Test that fs.watch() watches directory trees recursively on Linux, that
+// directories created after the watcher was started are watched, and that
+// changes are delivered in batches.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+const root = path.join(tmpdir.path, 'tree');
+fs.mkdirSync(path.join(root, 'existing'), { recursive: true });
+
+assert.throws(() => fs.watch(root, { recursive: true, debounce: -1 }),
+              { code: 'ERR_OUT_OF_RANGE' });
+assert.throws(() => fs.watch(root, { recursive: true, debounce: '1' }),
+              { code: 'ERR_INVALID_ARG_TYPE' });
+
+const watcher = fs.watch(root, { recursive: true, debounce: 50 });
+const seen = new Set();
+const expected = [
+  path.join('existing', 'file.txt'),
+  path.join('new', 'nested', 'file.txt'),
+];
+
+watcher.on('changes', common.mustCallAtLeast((changes) => {
+  const filenames = new Set();
+  for (const { eventType, filename } of changes) {
+    assert.ok(eventType === 'rename' || eventType === 'change');
+    // Each file appears at most once in a batch.
+    assert.ok(!filenames.has(filename));
+    filenames.add(filename);
+    seen.add(filename);
+  }
+  if (expected.every((filename) => seen.has(filename)))
+    watcher.close();
+}));
+
+watcher.on('change', common.mustCallAtLeast((eventType, filename) => {
+  assert.strictEqual(typeof filename, 'string');
+}));
+
+fs.writeFileSync(path.join(root, 'existing', 'file.txt'), 'a');
+fs.appendFileSync(path.join(root, 'existing', 'file.txt'), 'b');
+fs.mkdirSync(path.join(root, 'new', 'nested'), { recursive: true });
+// Wait for the new directories to be watched.
+setTimeout(() => {
+  fs.writeFileSync(path.join(root, 'new', 'nested', 'file.txt'), 'c');
+}, 100);
@@ -0,0 +1,78 @@
+'use strict';
+
+const common = require('../common');
+
+// Test that fs.watchFile() with `batch: true` reports the same changes as the
+// default poller, for several files polled together.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+const options = { interval: 10, batch: true };
+const files = [];
+for (let i = 0; i < 3; i++) {
+  const file = path.join(tmpdir.path, `file-${i}.txt`);
+  fs.writeFileSync(file, 'a');
+  files.push(file);
+}
+
+let remaining = files.length;
+for (const file of files) {
+  fs.watchFile(file, options, common.mustCall((curr, prev) => {
+    assert.strictEqual(prev.size, 1);
+    assert.strictEqual(curr.size, 3);
+    fs.unwatchFile(file);
+    if (--remaining === 0)
+      onDone();
+  }));
+}
+
+const bigintFile = path.join(tmpdir.path, 'bigint.txt');
+fs.writeFileSync(bigintFile, 'a');
+setTimeout(() => {
+  for (const file of [...files, bigintFile])
+    fs.appendFileSync(file, 'bc');
+}, 100);
+
+// A file that does not exist yet is reported once with zeroed stats, and
+// again once it has been created.
+const enoentFile = path.join(tmpdir.path, 'non-existent-file');
+let created = false;
+fs.watchFile(enoentFile, options, common.mustCall((curr, prev) => {
+  if (!created) {
+    assert.strictEqual(curr.ino, 0);
+    assert.strictEqual(prev.ino, 0);
+    created = true;
+    fs.writeFileSync(enoentFile, 'a');
+  } else {
+    assert.ok(curr.ino > 0);
+    assert.strictEqual(prev.ino, 0);
+    fs.unwatchFile(enoentFile);
+  }
+}, 2));
+
+// Non-persistent watchers do not keep the process alive.
+function onDone() {
+  const watcher = fs.watchFile(files[0], {
+    interval: 10,
+    batch: true,
+    persistent: false
+  }, common.mustNotCall());
+  watcher.on('stop', common.mustNotCall());
+}
+
+// BigInt stats are supported as well.
+fs.watchFile(bigintFile, {
+  interval: 10,
+  batch: true,
+  bigint: true
+}, common.mustCall((curr, prev) => {
+  assert.strictEqual(typeof curr.size, 'bigint');
+  assert.strictEqual(prev.size, 1n);
+  assert.strictEqual(curr.size, 3n);
+  fs.unwatchFile(bigintFile);
+}));
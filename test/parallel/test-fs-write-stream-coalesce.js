@@ -0,0 +1,71 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const path = require('path');
+const fs = require('fs');
+
+const tmpdir = require('../common/tmpdir');
+tmpdir.refresh();
+
+// With coalesceWrites, the chunks written during one tick are written with
+// a single writev() call.
+
+const lines = [];
+for (let i = 0; i < 100; i++)
+  lines.push(`line ${i}\n`);
+
+{
+  const file = path.join(tmpdir.path, 'coalesce0.txt');
+  const stream = fs.createWriteStream(file, {
+    fd: fs.openSync(file, 'a'),
+    coalesceWrites: true,
+    fs: {
+      open: common.mustNotCall(),
+      write: common.mustNotCall(),
+      writev: common.mustCall((fd, chunks, position, cb) => {
+        assert.strictEqual(chunks.length, lines.length);
+        fs.writev(fd, chunks, position, cb);
+      }),
+      close: common.mustCall(fs.close)
+    }
+  });
+  for (const line of lines)
+    assert.strictEqual(stream.write(line), true);
+  stream.end();
+  stream.on('finish', common.mustCall(() => {
+    assert.strictEqual(fs.readFileSync(file, 'utf8'), lines.join(''));
+  }));
+}
+
+// Chunks are written before the end of the tick once they reach the
+// highWaterMark.
+{
+  const file = path.join(tmpdir.path, 'coalesce1.txt');
+  const stream = fs.createWriteStream(file, {
+    fd: fs.openSync(file, 'w'),
+    coalesceWrites: true,
+    highWaterMark: 64,
+    fs: {
+      open: common.mustNotCall(),
+      write: fs.write,
+      writev: common.mustCallAtLeast(fs.writev, 2),
+      close: common.mustCall(fs.close)
+    }
+  });
+  let sawBackpressure = false;
+  for (const line of lines) {
+    if (!stream.write(line))
+      sawBackpressure = true;
+  }
+  assert(sawBackpressure);
+  stream.end();
+  stream.on('finish', common.mustCall(() => {
+    assert.strictEqual(fs.readFileSync(file, 'utf8'), lines.join(''));
+  }));
+}
+
+for (const value of [1, 'true', null]) {
+  assert.throws(() => fs.createWriteStream(path.join(tmpdir.path, 'x'), {
+    coalesceWrites: value
+  }), { code: 'ERR_INVALID_ARG_TYPE' });
+}
@@ -0,0 +1,41 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const os = require('os');
+const v8 = require('v8');
+
+// The heap size limit is derived from the memory available to the process,
+// which is reported as memory_limit, and --heap-memory-percentage sets the
+// part of that memory that the heap can use.
+
+const { memory_limit: memoryLimit } = v8.getHeapStatistics();
+assert(memoryLimit > 0);
+assert(memoryLimit <= os.totalmem());
+
+function heapSizeLimit(...flags) {
+  const child = spawnSync(process.execPath, [
+    ...flags,
+    '-p',
+    'require("v8").getHeapStatistics().heap_size_limit'
+  ], { encoding: 'utf8' });
+  assert.strictEqual(child.status, 0, child.stderr);
+  return +child.stdout;
+}
+
+const limit = memoryLimit / 100 * 10;
+const tolerance = 0.1 * limit;
+const actual = heapSizeLimit('--heap-memory-percentage=10');
+assert(Math.abs(actual - limit) < tolerance, `${actual} is not about ${limit}`);
+
+// V8 flags still take precedence.
+assert.strictEqual(
+  heapSizeLimit('--heap-memory-percentage=10', '--max-old-space-size=100') <
+    150 * 1024 * 1024,
+  true);
+
+const child = spawnSync(process.execPath,
+                        ['--heap-memory-percentage=101', '-e', '0'],
+                        { encoding: 'utf8' });
+assert.strictEqual(child.status, 9);
+assert(child.stderr.includes('--heap-memory-percentage must be at most 100'));
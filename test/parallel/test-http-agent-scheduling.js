@@ -0,0 +1,55 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const http = require('http');
+
+// The `scheduling` option picks the least or the most recently freed socket,
+// and `freeSocketTimeout` destroys sockets that stay in the pool too long.
+
+assert.throws(() => new http.Agent({ scheduling: 'random' }), {
+  code: 'ERR_INVALID_OPT_VALUE'
+});
+assert.throws(() => new http.Agent({ freeSocketTimeout: '10' }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+
+const server = http.createServer((req, res) => {
+  // Delay the second response, so that the sockets are freed in order.
+  setTimeout(() => res.end(), req.url === '/0' ? 0 : 50);
+});
+
+function get(agent, path) {
+  return new Promise((resolve) => {
+    http.get({ port: server.address().port, path, agent }, (res) => {
+      const { localPort } = res.socket;
+      res.resume();
+      res.on('end', () => setImmediate(() => resolve(localPort)));
+    });
+  });
+}
+
+async function testScheduling(scheduling) {
+  const agent = new http.Agent({ keepAlive: true, scheduling });
+  const ports = await Promise.all([get(agent, '/0'), get(agent, '/1')]);
+  const port = await get(agent, '/0');
+  assert.strictEqual(port, scheduling === 'fifo' ? ports[0] : ports[1]);
+  agent.destroy();
+}
+
+async function testFreeSocketTimeout() {
+  const agent = new http.Agent({ keepAlive: true, freeSocketTimeout: 50 });
+  await get(agent, '/0');
+  const name = `localhost:${server.address().port}:`;
+  assert.strictEqual(agent.freeSockets[name].length, 1);
+  const socket = agent.freeSockets[name][0];
+  await new Promise((resolve) => socket.on('close', common.mustCall(resolve)));
+  assert.strictEqual(agent.freeSockets[name], undefined);
+  agent.destroy();
+}
+
+server.listen(0, common.mustCall(async () => {
+  await testScheduling('fifo');
+  await testScheduling('lifo');
+  await testFreeSocketTimeout();
+  server.close();
+}));
@@ -0,0 +1,42 @@
+'use strict';
+
+// This tests the wire format of chunked bodies, for chunks that are framed
+// in a single Buffer as well as for larger ones.
+
+const common = require('../common');
+const assert = require('assert');
+const http = require('http');
+const net = require('net');
+
+const big = Buffer.alloc(3000, 'b');
+
+const server = http.createServer(common.mustCall((req, res) => {
+  res.write('a');
+  res.write(Buffer.from('0123456789abcdef'));
+  res.write('ü'.repeat(200), 'utf8');
+  res.write('xyz', 'latin1');
+  res.write(big);
+  res.end();
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port, () => {
+    client.end('GET / HTTP/1.1\r\nHost: localhost\r\n' +
+               'Connection: close\r\n\r\n');
+  });
+  const chunks = [];
+  client.on('data', (chunk) => chunks.push(chunk));
+  client.on('end', common.mustCall(() => {
+    const response = Buffer.concat(chunks).toString('latin1');
+    const body = response.slice(response.indexOf('\r\n\r\n') + 4);
+    const utf8 = Buffer.from('ü'.repeat(200)).toString('latin1');
+    assert.strictEqual(body,
+                       '1\r\na\r\n' +
+                       '10\r\n0123456789abcdef\r\n' +
+                       `190\r\n${utf8}\r\n` +
+                       '3\r\nxyz\r\n' +
+                       `bb8\r\n${big.toString('latin1')}\r\n` +
+                       '0\r\n\r\n');
+    server.close();
+  }));
+}));
@@ -30,6 +30,7 @@ const kOnHeaders = HTTPParser.kOnHeaders | 0;
 const kOnHeadersComplete = HTTPParser.kOnHeadersComplete | 0;
 const kOnBody = HTTPParser.kOnBody | 0;
 const kOnMessageComplete = HTTPParser.kOnMessageComplete | 0;
+const kOnMessages = HTTPParser.kOnMessages | 0;
 
 // The purpose of this test is not to check HTTP compliance but to test the
 // binding. Tests for pathological http messages should be submitted
@@ -256,8 +257,7 @@ function expectBody(expected) {
     assert.strictEqual(versionMajor, 1);
     assert.strictEqual(versionMinor, 0);
 
-    headers = headers || parser.headers;
-
+    // All headers are passed at once, without calling kOnHeaders.
     assert.strictEqual(headers.length, 2 * 256); // 256 key/value pairs
     for (let i = 0; i < headers.length; i += 2) {
       assert.strictEqual(headers[i], 'X-Filler');
@@ -266,11 +266,55 @@ function expectBody(expected) {
   };
 
   const parser = newParser(REQUEST);
+  parser[kOnHeaders] = mustNotCall('kOnHeaders should not be called');
   parser[kOnHeadersComplete] = mustCall(onHeadersComplete);
   parser.execute(request, 0, request.length);
 }
 
 
+//
+// Test that header names keep their spelling.
+//
+{
+  const request = Buffer.from(
+    'GET / HTTP/1.1\r\n' +
+    'Host: example.com\r\n' +
+    'host: example.org\r\n' +
+    'HOST: example.net\r\n' +
+    'Content-Typ: x\r\n' +
+    'Content-Type: text/plain\r\n' +
+    'content-types: y\r\n' +
+    '\r\n'
+  );
+
+  const expected = [
+    'Host', 'example.com',
+    'host', 'example.org',
+    'HOST', 'example.net',
+    'Content-Typ', 'x',
+    'Content-Type', 'text/plain',
+    'content-types', 'y',
+  ];
+
+  const parser = newParser(REQUEST);
+  parser[kOnHeadersComplete] = mustCall((versionMajor, versionMinor,
+                                         headers) => {
+    assert.deepStrictEqual(headers, expected);
+  });
+  parser.execute(request, 0, request.length);
+
+  // And when they arrive in pieces.
+  const split = newParser(REQUEST);
+  split[kOnHeadersComplete] = mustCall((versionMajor, versionMinor,
+                                        headers) => {
+    assert.deepStrictEqual(headers, expected);
+  });
+  for (let i = 0; i < request.length; ++i) {
+    split.execute(request, i, 1);
+  }
+}
+
+
 //
 // Test request body
 //
@@ -562,6 +606,98 @@ function expectBody(expected) {
   parser.execute(req2, 0, req2.length);
 }
 
+//
+// Test batched delivery of pipelined requests.
+//
+{
+  const request = Buffer.from(
+    'GET /1 HTTP/1.1\r\n' +
+    'Host: a\r\n' +
+    '\r\n' +
+    'GET /2 HTTP/1.1\r\n' +
+    'Host: b\r\n' +
+    '\r\n' +
+    'POST /3 HTTP/1.1\r\n' +
+    'Content-Length: 4\r\n' +
+    '\r\n' +
+    'pong' +
+    'GET /4 HTTP/1.1\r\n' +
+    '\r\n'
+  );
+
+  const calls = [];
+  const parser = new HTTPParser();
+  parser.initialize(REQUEST, {}, 0, false, true);
+  parser[kOnHeadersComplete] = mustNotCall();
+  parser[kOnMessageComplete] = mustNotCall();
+  parser[kOnBody] = mustCall((buf, start, len) => {
+    calls.push(`body ${buf.slice(start, start + len)}`);
+  });
+  parser[kOnMessages] = mustCall((events) => {
+    const batch = [];
+    for (let i = 0; i < events.length;) {
+      if (events[i] === kOnHeadersComplete) {
+        const [versionMajor, versionMinor, headers, method, url] =
+          events.slice(i + 1, i + 10);
+        assert.strictEqual(versionMajor, 1);
+        assert.strictEqual(versionMinor, 1);
+        batch.push(`${methods[method]} ${url} ${headers}`);
+        i += 10;
+      } else {
+        assert.strictEqual(events[i], kOnMessageComplete);
+        batch.push('complete');
+        i += 1;
+      }
+    }
+    calls.push(batch);
+  }, 3);
+
+  parser.execute(request, 0, request.length);
+  assert.deepStrictEqual(calls, [
+    ['GET /1 Host,a', 'complete', 'GET /2 Host,b', 'complete',
+     'POST /3 Content-Length,4'],
+    'body pong',
+    ['complete', 'GET /4 ', 'complete'],
+  ]);
+}
+
+//
+// Test that parsers that coalesce the body deliver small chunks together
+//
+{
+  const big = 'x'.repeat(8192);
+  const request = Buffer.from(
+    'POST /it HTTP/1.1\r\n' +
+    'Transfer-Encoding: chunked\r\n' +
+    '\r\n' +
+    '3\r\n' +
+    '123\r\n' +
+    '6\r\n' +
+    '123456\r\n' +
+    `${big.length.toString(16)}\r\n` +
+    `${big}\r\n` +
+    'A\r\n' +
+    '1234567890\r\n' +
+    '0\r\n' +
+    '\r\n'
+  );
+
+  const body_parts = ['123123456', big, '1234567890'];
+  let body_part = 0;
+
+  const parser = new HTTPParser();
+  parser.initialize(REQUEST, {}, 0, false, false, true);
+  parser[kOnHeadersComplete] = mustCall();
+  parser[kOnBody] = mustCall((buf, start, len) => {
+    const body = String(buf.slice(start, start + len));
+    assert.strictEqual(body, body_parts[body_part++]);
+  }, body_parts.length);
+  parser[kOnMessageComplete] = mustCall(() => {
+    assert.strictEqual(body_part, body_parts.length);
+  });
+  parser.execute(request, 0, request.length);
+}
+
 // Test parser 'this' safety
 // https://github.com/joyent/node/issues/6690
 assert.throws(function() {
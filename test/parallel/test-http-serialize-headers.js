@@ -0,0 +1,79 @@
+// Flags: --expose-internals
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const http = require('http');
+const net = require('net');
+const { internalBinding } = require('internal/test/binding');
+const { serializeHeaders } = internalBinding('http_parser');
+const { _checkIsHttpToken, _checkInvalidHeaderChar } = require('_http_common');
+
+// serializeHeaders() must accept exactly the names and values that the JS
+// validators accept.
+{
+  const firstLine = 'HTTP/1.1 200 OK\r\n';
+  for (let c = 0; c < 256; c++) {
+    const str = String.fromCharCode(c);
+    const name = serializeHeaders(firstLine, [`X${str}`, 'v'], true);
+    if (_checkIsHttpToken(`X${str}`))
+      assert.strictEqual(name, `${firstLine}X${str}: v\r\n\r\n`);
+    else
+      assert.strictEqual(name, 0);
+
+    const value = serializeHeaders(firstLine, ['X', `a${str}b`], true);
+    if (_checkInvalidHeaderChar(`a${str}b`))
+      assert.strictEqual(value, 1);
+    else
+      assert.strictEqual(value, `${firstLine}X: a${str}b\r\n\r\n`);
+  }
+
+  assert.strictEqual(serializeHeaders(firstLine, ['', 'v'], true), 0);
+  assert.strictEqual(serializeHeaders(firstLine, ['a', 'b', 'c', '\n'], true),
+                     3);
+  // Validation is up to the caller otherwise.
+  assert.strictEqual(serializeHeaders(firstLine, ['a b', '\n'], false),
+                     `${firstLine}a b: \n\r\n\r\n`);
+  // Strings that are not one-byte are left to the caller.
+  assert.strictEqual(serializeHeaders(firstLine, ['X', '中文'], true),
+                     undefined);
+}
+
+// End to end, including values that are serialized in JS.
+{
+  // A slice of a two-byte string that only contains one-byte characters.
+  const twoByte = 'abcdefghijklmnopqrstuvwxyz中'.slice(0, 26);
+  const server = http.createServer(common.mustCall((req, res) => {
+    if (req.url === '/array') {
+      res.writeHead(200, [['X-A', 'a'], ['X-B', 42], ['X-C', twoByte]]);
+      res.end();
+      return;
+    }
+    assert.throws(() => res.writeHead(200, { 'X-A': 'a', 'X B': 'b' }), {
+      code: 'ERR_INVALID_HTTP_TOKEN'
+    });
+    assert.throws(() => res.writeHead(200, { 'X-A': 'a\r\nX-B: b' }), {
+      code: 'ERR_INVALID_CHAR'
+    });
+    assert.throws(() => res.writeHead(200, { 'X-A': undefined }), {
+      code: 'ERR_HTTP_INVALID_HEADER_VALUE'
+    });
+    res.setHeader('X-D', ['d1', 'd2']);
+    res.end();
+  }, 2));
+
+  server.listen(0, common.mustCall(() => {
+    const socket = net.connect(server.address().port, common.mustCall(() => {
+      socket.end('GET /array HTTP/1.1\r\nHost: x\r\n\r\n' +
+                 'GET /object HTTP/1.1\r\nHost: x\r\n\r\n');
+    }));
+    let response = '';
+    socket.setEncoding('latin1');
+    socket.on('data', (chunk) => response += chunk);
+    socket.on('end', common.mustCall(() => {
+      assert(response.includes(
+        `\r\nX-A: a\r\nX-B: 42\r\nX-C: ${twoByte}\r\nDate: `));
+      assert(response.includes('\r\nX-D: d1\r\nX-D: d2\r\nDate: '));
+      server.close();
+    }));
+  }));
+}
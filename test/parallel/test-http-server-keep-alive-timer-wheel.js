@@ -0,0 +1,65 @@
+'use strict';
+
+// Idle keep-alive connections share one timer wheel per server. Check that
+// every idle connection is closed once its keep-alive timeout has passed,
+// not earlier, and that a new request cancels the timeout and restores the
+// server's idle timeout on the socket.
+
+const common = require('../common');
+const assert = require('assert');
+const http = require('http');
+const net = require('net');
+
+const request = 'GET / HTTP/1.1\r\nHost: localhost\r\n\r\n';
+
+{
+  const kConnections = 20;
+  const keepAliveTimeout = 100;
+  const server = http.createServer(common.mustCall((req, res) => {
+    res.end('ok');
+  }, kConnections));
+  server.keepAliveTimeout = keepAliveTimeout;
+
+  let closed = 0;
+  server.listen(0, common.mustCall(() => {
+    for (let i = 0; i < kConnections; i++) {
+      const start = process.hrtime.bigint();
+      const socket = net.connect(server.address().port, () => {
+        socket.write(request);
+      });
+      socket.resume();
+      socket.on('close', common.mustCall(() => {
+        const elapsed = Number(process.hrtime.bigint() - start) / 1e6;
+        assert(elapsed >= keepAliveTimeout, `closed after ${elapsed}ms`);
+        if (++closed === kConnections)
+          server.close();
+      }));
+    }
+  }));
+}
+
+{
+  const server = http.createServer(common.mustCall((req, res) => {
+    assert.strictEqual(req.socket.timeout, common.platformTimeout(10000));
+    res.end('ok');
+  }, 2));
+  server.setTimeout(common.platformTimeout(10000));
+  server.keepAliveTimeout = common.platformTimeout(500);
+  server.on('timeout', common.mustNotCall());
+
+  server.listen(0, common.mustCall(() => {
+    const socket = net.connect(server.address().port, () => {
+      socket.write(request);
+      setTimeout(() => {
+        socket.write(request);
+        setTimeout(() => {
+          // The earlier keep-alive timeout did not fire in the meantime.
+          assert(!socket.destroyed);
+          socket.destroy();
+          server.close();
+        }, common.platformTimeout(400));
+      }, common.platformTimeout(300));
+    });
+    socket.resume();
+  }));
+}
@@ -0,0 +1,122 @@
+'use strict';
+
+// Static responses are sent in place of 'request' events, in order with the
+// responses to other requests on the same connection, whether the native
+// parser or a ServerResponse sends them.
+
+const common = require('../common');
+const assert = require('assert');
+const http = require('http');
+const net = require('net');
+
+const server = http.createServer(common.mustCall((req, res) => {
+  if (req.url === '/slow') {
+    setTimeout(() => res.end('slow'), common.platformTimeout(50));
+  } else {
+    assert.strictEqual(req.url, '/health');
+    res.end('dynamic');
+  }
+}, 2));
+
+for (const [args, code] of [
+  [['get', '/health', {}], 'ERR_INVALID_ARG_VALUE'],
+  [['GET', 'has space', {}], 'ERR_INVALID_ARG_VALUE'],
+  [['GET', '', {}], 'ERR_INVALID_ARG_VALUE'],
+  [['GET', '/health', 'ok'], 'ERR_INVALID_ARG_TYPE'],
+  [['GET', '/health', { statusCode: 101 }], 'ERR_OUT_OF_RANGE'],
+  [['GET', '/health', { body: 1 }], 'ERR_INVALID_ARG_TYPE'],
+  [['GET', '/health', { statusCode: 304, body: 'x' }], 'ERR_INVALID_ARG_VALUE'],
+  [['GET', '/health', { headers: { 'Content-Length': 1 } }],
+   'ERR_INVALID_ARG_VALUE'],
+  [['GET', '/health', { headers: { 'a b': 1 } }], 'ERR_INVALID_HTTP_TOKEN'],
+  [['GET', '/health', { headers: { a: 'b\n' } }], 'ERR_INVALID_CHAR'],
+]) {
+  assert.throws(() => server.setStaticResponse(...args), { code });
+}
+
+const health = {
+  headers: { 'Content-Type': 'text/plain', 'X-Check': ['a', 'b'] },
+  body: 'ok'
+};
+assert.strictEqual(server.setStaticResponse('GET', '/health', health), server);
+server.setStaticResponse('HEAD', '/health', health);
+server.setStaticResponse('GET', '/empty', { statusCode: 204 });
+
+// Splits the responses to requests with |methods|.
+function parseResponses(data, methods) {
+  const responses = [];
+  for (const method of methods) {
+    const end = data.indexOf('\r\n\r\n');
+    assert.notStrictEqual(end, -1);
+    const [statusLine, ...lines] = data.slice(0, end).split('\r\n');
+    const headers = {};
+    for (const line of lines) {
+      const [name, value] = line.split(': ');
+      const key = name.toLowerCase();
+      headers[key] = headers[key] ? `${headers[key]}, ${value}` : value;
+    }
+    const length = method === 'HEAD' ? 0 : +(headers['content-length'] || 0);
+    responses.push({
+      status: +statusLine.split(' ')[1],
+      headers,
+      body: data.substr(end + 4, length)
+    });
+    data = data.slice(end + 4 + length);
+  }
+  assert.strictEqual(data, '');
+  return responses;
+}
+
+server.listen(0, common.mustCall(() => {
+  const socket = net.connect(server.address().port);
+  const requests = [
+    'GET /health HTTP/1.1\r\n\r\n',
+    // The responses after this one wait for it.
+    'GET /slow HTTP/1.1\r\n\r\n',
+    'GET /health HTTP/1.1\r\n\r\n',
+    'HEAD /health HTTP/1.1\r\n\r\n',
+    'GET /health HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc',
+    'GET /empty HTTP/1.1\r\nConnection: close\r\n\r\n',
+  ];
+  socket.end(requests.join(''));
+  socket.setEncoding('latin1');
+  let data = '';
+  socket.on('data', (chunk) => data += chunk);
+  socket.on('end', common.mustCall(() => {
+    const responses = parseResponses(
+      data, ['GET', 'GET', 'GET', 'HEAD', 'GET', 'GET']);
+    assert.deepStrictEqual(responses.map((res) => [res.status, res.body]), [
+      [200, 'ok'],
+      [200, 'slow'],
+      [200, 'ok'],
+      [200, ''],
+      [200, 'ok'],
+      [204, ''],
+    ]);
+    for (const i of [0, 2, 3, 4]) {
+      assert.strictEqual(responses[i].headers['content-type'], 'text/plain');
+      assert.strictEqual(responses[i].headers['x-check'], 'a, b');
+      assert.strictEqual(responses[i].headers['content-length'], '2');
+      const { date } = responses[i].headers;
+      assert.match(date, /^\w{3}, \d{2} \w{3} \d{4} \d{2}:\d{2}:\d{2} GMT$/);
+      assert(Math.abs(Date.parse(date) - Date.now()) < 60 * 1000);
+    }
+    assert.strictEqual(responses[5].headers['content-length'], undefined);
+
+    // Once removed, requests go to the 'request' listener again.
+    server.setStaticResponse('GET', '/health', null);
+    http.get({
+      port: server.address().port,
+      path: '/health',
+      agent: false
+    }, common.mustCall((res) => {
+      res.setEncoding('utf8');
+      let body = '';
+      res.on('data', (chunk) => body += chunk);
+      res.on('end', common.mustCall(() => {
+        assert.strictEqual(body, 'dynamic');
+        server.close();
+      }));
+    }));
+  }));
+}));
@@ -0,0 +1,166 @@
+'use strict';
+
+// This tests http.WebSocketReceiver and http.WebSocketSender over a TCP
+// connection.
+
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+const { WebSocketReceiver, WebSocketSender } = require('http');
+const { opcodes } = WebSocketSender;
+
+// Connects a client socket to a server socket and calls fn with both.
+function connect(fn) {
+  const server = net.createServer(common.mustCall((serverSocket) => {
+    server.close();
+    fn(client, serverSocket);
+  }));
+  let client;
+  server.listen(0, common.mustCall(() => {
+    client = net.connect(server.address().port);
+  }));
+}
+
+{
+  const sender = new WebSocketSender();
+  // Unmasked frames with 7-bit, 16-bit and 64-bit payload lengths.
+  assert.deepStrictEqual(sender.frame('hi'),
+                         Buffer.from([0x81, 0x02, 0x68, 0x69]));
+  let frame = sender.frame(Buffer.alloc(300), { opcode: opcodes.BINARY });
+  assert.deepStrictEqual(frame.slice(0, 4), Buffer.from([0x82, 126, 1, 44]));
+  assert.strictEqual(frame.length, 304);
+  frame = sender.frame(Buffer.alloc(70000));
+  assert.deepStrictEqual(
+    frame.slice(0, 10),
+    Buffer.from([0x82, 127, 0, 0, 0, 0, 0, 1, 0x11, 0x70]));
+  assert.strictEqual(frame.length, 70010);
+  frame = sender.frame('a', { fin: false });
+  assert.strictEqual(frame[0], 0x01);
+
+  assert.throws(() => sender.frame('x'.repeat(126), { opcode: opcodes.PING }),
+                { code: 'ERR_INVALID_ARG_VALUE' });
+  assert.throws(() => sender.frame('x', { opcode: 3 }),
+                { code: 'ERR_INVALID_ARG_VALUE' });
+  assert.throws(() => sender.frame('x', { compress: true }),
+                { code: 'ERR_INVALID_ARG_VALUE' });
+  assert.throws(() => sender.frame(1), { code: 'ERR_INVALID_ARG_TYPE' });
+
+  // Masked frames can be unmasked with the key in the header.
+  const masked = new WebSocketSender({ mask: true });
+  const payload = Buffer.from('0123456789abcdefghijklmnopqrstuvwxyz');
+  frame = masked.frame(payload);
+  assert.strictEqual(frame[1], 0x80 | payload.length);
+  const key = frame.slice(2, 6);
+  const data = frame.slice(6);
+  for (let i = 0; i < data.length; i++)
+    data[i] ^= key[i % 4];
+  assert.deepStrictEqual(data, payload);
+}
+
+{
+  // Messages from a client, including fragmented and compressed ones.
+  const deflate = { threshold: 0 };
+  connect(common.mustCall((client, socket) => {
+    const sender =
+      new WebSocketSender({ mask: true, perMessageDeflate: deflate });
+    const receiver =
+      new WebSocketReceiver(socket, { perMessageDeflate: deflate });
+    const messages = [];
+    receiver.on('message', (data, isBinary) => {
+      messages.push([data.toString(), isBinary]);
+    });
+    receiver.on('ping', common.mustCall((data) => {
+      assert.strictEqual(data.toString(), 'ping');
+    }));
+    receiver.on('close', common.mustCall((code, reason) => {
+      assert.strictEqual(code, 1000);
+      assert.strictEqual(reason, 'bye');
+      assert.deepStrictEqual(messages, [
+        ['hello', false],
+        ['x'.repeat(100000), true],
+        ['fragmented', false],
+        ['hello', false],
+        ['ü'.repeat(1000), false]
+      ]);
+      client.destroy();
+      socket.destroy();
+    }));
+    receiver.on('error', common.mustNotCall());
+
+    const close = Buffer.from('\u0003èbye', 'latin1');
+    const frames = Buffer.concat([
+      sender.frame('hello'),
+      sender.frame(Buffer.from('x'.repeat(100000))),
+      sender.frame('frag', { fin: false, compress: false }),
+      sender.frame('ping', { opcode: opcodes.PING }),
+      sender.frame('mented', { opcode: opcodes.CONTINUATION }),
+      sender.frame('hello'),
+      sender.frame('ü'.repeat(1000)),
+      sender.frame(close, { opcode: opcodes.CLOSE })
+    ]);
+    // Frames are split across reads.
+    for (let i = 0; i < frames.length; i += 1000)
+      client.write(frames.slice(i, i + 1000));
+  }));
+}
+
+{
+  // Data that is passed as `head` is parsed first.
+  connect(common.mustCall((client, socket) => {
+    const sender = new WebSocketSender({ mask: true });
+    const frame = sender.frame('head and tail');
+    const receiver = new WebSocketReceiver(socket, { head: frame.slice(0, 5) });
+    receiver.on('message', common.mustCall((data, isBinary) => {
+      assert.strictEqual(data.toString(), 'head and tail');
+      assert.strictEqual(isBinary, false);
+      client.destroy();
+      socket.destroy();
+    }));
+    client.write(frame.slice(5));
+  }));
+}
+
+// Protocol errors.
+[
+  [Buffer.from([0x81, 0x01, 0x61]), 1002],  // Unmasked.
+  [Buffer.from([0xc1, 0x80, 0, 0, 0, 0]), 1002],  // RSV1 without deflate.
+  [Buffer.from([0x83, 0x80, 0, 0, 0, 0]), 1002],  // Reserved opcode.
+  [Buffer.from([0x09, 0x80, 0, 0, 0, 0]), 1002],  // Fragmented ping.
+  [Buffer.from([0x80, 0x80, 0, 0, 0, 0]), 1002],  // Continuation.
+  [Buffer.from([0x81, 0x81, 0, 0, 0, 0, 0xff]), 1007],  // Invalid UTF-8.
+  [Buffer.from([0x88, 0x82, 0, 0, 0, 0, 0x03, 0xed]), 1002],  // Close code.
+  [Buffer.from([0x82, 0xfe, 0x04, 0x01, 0, 0, 0, 0]), 1009],  // Too big.
+].forEach(([frame, closeCode]) => {
+  connect(common.mustCall((client, socket) => {
+    const receiver = new WebSocketReceiver(socket, { maxPayload: 1024 });
+    receiver.on('message', common.mustNotCall());
+    receiver.on('error', common.mustCall((err) => {
+      assert.strictEqual(err.code, 'ERR_INVALID_WEBSOCKET_FRAME');
+      assert.strictEqual(err.closeCode, closeCode);
+      client.destroy();
+      socket.destroy();
+    }));
+    client.write(frame);
+  }));
+});
+
+{
+  // After detach(), data is emitted by the socket again.
+  connect(common.mustCall((client, socket) => {
+    const sender = new WebSocketSender({ mask: true });
+    const receiver = new WebSocketReceiver(socket);
+    receiver.on('message', common.mustCall(() => {
+      receiver.detach();
+      socket.on('data', common.mustCall((data) => {
+        assert.strictEqual(data.toString(), 'raw');
+        client.destroy();
+        socket.destroy();
+      }));
+      client.write('raw');
+    }));
+    client.write(sender.frame('framed'));
+  }));
+}
+
+assert.throws(() => new WebSocketReceiver({}),
+              { code: 'ERR_INVALID_ARG_VALUE' });
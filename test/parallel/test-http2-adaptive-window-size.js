@@ -0,0 +1,59 @@
+'use strict';
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const h2 = require('http2');
+
+// Large uploads to a session with adaptive receive windows arrive intact,
+// including when one of the streams is paused for a while.
+
+for (const value of [1, 'true', null]) {
+  assert.throws(() => h2.createServer({ adaptiveWindowSize: value }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+  assert.throws(() => h2.connect('http://localhost:1',
+                                 { adaptiveWindowSize: value }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+
+const kStreams = 4;
+const body = Buffer.alloc(4 * 1024 * 1024);
+for (let i = 0; i < body.length; i++)
+  body[i] = i % 253;
+
+const server = h2.createServer({ adaptiveWindowSize: true });
+server.on('stream', common.mustCall((stream, headers) => {
+  const chunks = [];
+  if (headers[':path'] === '/0') {
+    stream.pause();
+    setTimeout(() => stream.resume(), 100);
+  }
+  stream.on('data', (chunk) => chunks.push(chunk));
+  stream.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(Buffer.concat(chunks), body);
+    const { effectiveLocalWindowSize } = stream.session.state;
+    assert(effectiveLocalWindowSize >= 65535);
+    stream.respond({ ':status': 200 });
+    stream.end();
+  }));
+}, kStreams));
+
+server.listen(0, common.mustCall(() => {
+  const client = h2.connect(`http://localhost:${server.address().port}`);
+  let remaining = kStreams;
+  for (let i = 0; i < kStreams; i++) {
+    const req = client.request({ ':path': `/${i}`, ':method': 'POST' });
+    req.on('response', common.mustCall());
+    req.resume();
+    req.on('end', common.mustCall(() => {
+      if (--remaining === 0) {
+        client.close();
+        server.close();
+      }
+    }));
+    req.end(body);
+  }
+}));
@@ -0,0 +1,49 @@
+'use strict';
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const h2 = require('http2');
+
+// Sessions that coalesce their writes still deliver every stream correctly,
+// including when many streams respond at the same time.
+
+for (const value of [1, 'true', null]) {
+  assert.throws(() => h2.createServer({ coalesceWrites: value }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+  assert.throws(() => h2.connect('http://localhost:1',
+                                 { coalesceWrites: value }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+
+const kStreams = 100;
+const body = 'x'.repeat(20000);
+
+const server = h2.createServer({ coalesceWrites: true });
+server.on('stream', common.mustCall((stream, headers) => {
+  stream.respond({ ':status': 200 });
+  stream.end(`${headers[':path']} ${body}`);
+}, kStreams));
+
+server.listen(0, common.mustCall(() => {
+  const client = h2.connect(`http://localhost:${server.address().port}`,
+                            { coalesceWrites: true });
+  let remaining = kStreams;
+  for (let i = 0; i < kStreams; i++) {
+    const req = client.request({ ':path': `/${i}` });
+    let data = '';
+    req.setEncoding('utf8');
+    req.on('data', (chunk) => data += chunk);
+    req.on('end', common.mustCall(() => {
+      assert.strictEqual(data, `/${i} ${body}`);
+      if (--remaining === 0) {
+        client.close();
+        server.close();
+      }
+    }));
+    req.end();
+  }
+}));
@@ -0,0 +1,72 @@
+'use strict';
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const h2 = require('http2');
+
+// With extensiblePriorities, the responses of more urgent streams are sent
+// first, no matter in which order they were requested and responded to. The
+// urgency comes from the `priority` request header, or from
+// setExtensiblePriority().
+
+for (const value of [1, 'true', null]) {
+  assert.throws(() => h2.createServer({ extensiblePriorities: value }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+
+const requests = [
+  { path: '/bulk', priority: 'u=7', size: 64 * 1024 },
+  { path: '/style', size: 512 * 1024 },
+  { path: '/page', priority: 'u=0, i', size: 512 * 1024 }
+];
+
+const server = h2.createServer({ extensiblePriorities: true });
+const streams = [];
+server.on('stream', common.mustCall((stream, headers) => {
+  if (headers[':path'] === '/style') {
+    assert.strictEqual(headers.priority, undefined);
+    stream.setExtensiblePriority({ urgency: 1 });
+
+    assert.throws(() => stream.setExtensiblePriority({ urgency: 8 }), {
+      code: 'ERR_OUT_OF_RANGE'
+    });
+    assert.throws(() => stream.setExtensiblePriority({ incremental: 1 }), {
+      code: 'ERR_INVALID_ARG_TYPE'
+    });
+  }
+  streams.push([stream, headers[':path']]);
+  if (streams.length < requests.length)
+    return;
+
+  // Respond to all streams at once, in the order they were requested.
+  for (const [stream, path] of streams) {
+    const { size } = requests.find((request) => request.path === path);
+    stream.respond({ ':status': 200 });
+    stream.end(Buffer.alloc(size));
+  }
+}, requests.length));
+
+server.listen(0, common.mustCall(() => {
+  const client = h2.connect(`http://localhost:${server.address().port}`, {
+    settings: { initialWindowSize: 1024 * 1024 }
+  });
+  const finished = [];
+  for (const { path, priority } of requests) {
+    const headers = { ':path': path };
+    if (priority !== undefined)
+      headers.priority = priority;
+    const req = client.request(headers);
+    req.resume();
+    req.on('end', common.mustCall(() => {
+      finished.push(path);
+      if (finished.length === requests.length) {
+        assert.deepStrictEqual(finished, ['/page', '/style', '/bulk']);
+        client.close();
+        server.close();
+      }
+    }));
+  }
+}));
@@ -0,0 +1,47 @@
+'use strict';
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const h2 = require('http2');
+
+// Header names and values that are received repeatedly through the header
+// compression tables are turned into strings only once per session.
+
+const kRequests = 20;
+
+const server = h2.createServer();
+server.on('stream', common.mustCall((stream, headers) => {
+  assert.strictEqual(headers['x-custom-header'], 'some repeated value');
+  stream.respond({ ':status': 200 });
+  stream.end();
+}, kRequests));
+
+server.listen(0, common.mustCall(() => {
+  const client = h2.connect(`http://localhost:${server.address().port}`);
+  let remaining = kRequests;
+
+  function request() {
+    const req = client.request({
+      ':path': '/',
+      'x-custom-header': 'some repeated value'
+    });
+    req.on('response', common.mustCall());
+    req.resume();
+    req.on('end', common.mustCall(() => {
+      if (--remaining > 0)
+        return request();
+      const { headerStringCacheHits, headerStringCacheMisses } = client.state;
+      assert.strictEqual(typeof headerStringCacheHits, 'number');
+      assert.strictEqual(typeof headerStringCacheMisses, 'number');
+      // Every response header after the first one comes from a table.
+      assert(headerStringCacheHits >= kRequests - 1);
+      assert(headerStringCacheMisses < headerStringCacheHits);
+      client.close();
+      server.close();
+    }));
+    req.end();
+  }
+  request();
+}));
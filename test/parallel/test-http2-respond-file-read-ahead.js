@@ -0,0 +1,104 @@
+// Flags: --expose-gc
+'use strict';
+
+// Files and file ranges that are read ahead of the stream with the readAhead
+// option arrive intact and in order. The session uses TLS, so that the file
+// data is read into memory rather than sent with sendfile(2).
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const http2 = require('http2');
+const fixtures = require('../common/fixtures');
+const Countdown = require('../common/countdown');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+const fname = path.join(tmpdir.path, 'read-ahead.bin');
+const data = Buffer.alloc(2 * 1024 * 1024 + 123);
+for (let i = 0; i < data.length; i++)
+  data[i] = i % 251;
+fs.writeFileSync(fname, data);
+const fd = fs.openSync(fname, 'r');
+// Truncated once the response has been set up, so that reads are still in
+// flight when the file handle reaches EOF and is closed.
+const shrinking = path.join(tmpdir.path, 'read-ahead-shrinking.bin');
+fs.writeFileSync(shrinking, data.slice(0, 1024 * 1024));
+
+const ranges = [
+  [0, -1, 4],
+  [12345, 1024 * 1024, 64],
+  [data.length - 10, -1, 2],
+  [100, 0, 8],
+  [65536, 65536, 3],
+];
+
+const server = http2.createSecureServer({
+  key: fixtures.readKey('agent3-key.pem'),
+  cert: fixtures.readKey('agent3-cert.pem')
+});
+server.on('stream', common.mustCall((stream, headers) => {
+  for (const readAhead of [0, 65, 1.5, '4']) {
+    assert.throws(() => stream.respondWithFD(fd, {}, { readAhead }), {
+      code: typeof readAhead === 'string' ?
+        'ERR_INVALID_ARG_TYPE' : 'ERR_OUT_OF_RANGE'
+    });
+  }
+
+  const index = +headers[':path'].slice(1);
+  if (index === ranges.length) {
+    stream.respondWithFile(fname, {}, { readAhead: 16 });
+    return;
+  }
+  if (index === ranges.length + 1) {
+    stream.respondWithFile(shrinking, {}, {
+      readAhead: 64,
+      statCheck() { fs.truncateSync(shrinking, 1000); }
+    });
+    return;
+  }
+  const [offset, length, readAhead] = ranges[index];
+  stream.respondWithFD(fd, {}, { offset, length, readAhead });
+}, ranges.length + 2));
+server.on('close', common.mustCall(() => fs.closeSync(fd)));
+
+server.listen(0, common.mustCall(() => {
+  const client = http2.connect(`https://localhost:${server.address().port}`, {
+    rejectUnauthorized: false
+  });
+  const countdown = new Countdown(ranges.length + 2, () => {
+    client.close();
+    server.close();
+  });
+
+  function request(index, expected) {
+    const req = client.request({ ':path': `/${index}` });
+    const chunks = [];
+    req.on('data', (chunk) => {
+      chunks.push(chunk);
+      // The file handles reading ahead must stay alive.
+      global.gc();
+    });
+    req.on('end', common.mustCall(() => {
+      assert.deepStrictEqual(Buffer.concat(chunks), expected);
+      countdown.dec();
+    }));
+    req.end();
+  }
+
+  ranges.forEach(([offset, length], index) => {
+    const end = length === -1 ? data.length : offset + length;
+    request(index, data.slice(offset, end));
+  });
+  request(ranges.length, data);
+
+  // The response is shorter than its content-length header.
+  const req = client.request({ ':path': `/${ranges.length + 1}` });
+  req.on('error', () => {});
+  req.resume();
+  req.on('close', common.mustCall(() => countdown.dec()));
+  req.end();
+}));
@@ -0,0 +1,74 @@
+'use strict';
+
+// Large files and file ranges that are sent with sendfile(2) on cleartext
+// sessions arrive intact, including when several streams send at once and
+// when trailers follow the data.
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const http2 = require('http2');
+const Countdown = require('../common/countdown');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+const fname = path.join(tmpdir.path, 'sendfile.bin');
+const data = Buffer.alloc(3 * 1024 * 1024 + 123);
+for (let i = 0; i < data.length; i++)
+  data[i] = i % 251;
+fs.writeFileSync(fname, data);
+const fd = fs.openSync(fname, 'r');
+
+const ranges = [
+  [0, -1],
+  [12345, 1024 * 1024],
+  [data.length - 10, -1],
+  [100, 0],
+];
+
+const server = http2.createServer();
+server.on('stream', common.mustCall((stream, headers) => {
+  const index = +headers[':path'].slice(1);
+  if (index === ranges.length) {
+    stream.respondWithFile(fname, {}, { waitForTrailers: true });
+    stream.on('wantTrailers', common.mustCall(() => {
+      stream.sendTrailers({ 'x-done': 'yes' });
+    }));
+    return;
+  }
+  const [offset, length] = ranges[index];
+  stream.respondWithFD(fd, {}, { offset, length });
+}, ranges.length + 1));
+server.on('close', common.mustCall(() => fs.closeSync(fd)));
+
+server.listen(0, common.mustCall(() => {
+  const client = http2.connect(`http://localhost:${server.address().port}`);
+  const countdown = new Countdown(ranges.length + 1, () => {
+    client.close();
+    server.close();
+  });
+
+  function request(index, expected, onTrailers) {
+    const req = client.request({ ':path': `/${index}` });
+    const chunks = [];
+    req.on('data', (chunk) => chunks.push(chunk));
+    if (onTrailers)
+      req.on('trailers', onTrailers);
+    req.on('end', common.mustCall(() => {
+      assert.deepStrictEqual(Buffer.concat(chunks), expected);
+      countdown.dec();
+    }));
+    req.end();
+  }
+
+  ranges.forEach(([offset, length], index) => {
+    const end = length === -1 ? data.length : offset + length;
+    request(index, data.slice(offset, end));
+  });
+  request(ranges.length, data, common.mustCall((trailers) => {
+    assert.strictEqual(trailers['x-done'], 'yes');
+  }));
+}));
@@ -22,7 +22,10 @@ const IDX_OPTIONS_MAX_HEADER_LIST_PAIRS = 5;
 const IDX_OPTIONS_MAX_OUTSTANDING_PINGS = 6;
 const IDX_OPTIONS_MAX_OUTSTANDING_SETTINGS = 7;
 const IDX_OPTIONS_MAX_SESSION_MEMORY = 8;
-const IDX_OPTIONS_FLAGS = 9;
+const IDX_OPTIONS_COALESCE_WRITES = 9;
+const IDX_OPTIONS_ADAPTIVE_WINDOW_SIZE = 10;
+const IDX_OPTIONS_EXTENSIBLE_PRIORITIES = 11;
+const IDX_OPTIONS_FLAGS = 12;
 
 {
   updateOptionsBuffer({
@@ -34,7 +37,10 @@ const IDX_OPTIONS_FLAGS = 9;
     maxHeaderListPairs: 6,
     maxOutstandingPings: 7,
     maxOutstandingSettings: 8,
-    maxSessionMemory: 9
+    maxSessionMemory: 9,
+    coalesceWrites: true,
+    adaptiveWindowSize: true,
+    extensiblePriorities: true
   });
 
   strictEqual(optionsBuffer[IDX_OPTIONS_MAX_DEFLATE_DYNAMIC_TABLE_SIZE], 1);
@@ -46,6 +52,9 @@ const IDX_OPTIONS_FLAGS = 9;
   strictEqual(optionsBuffer[IDX_OPTIONS_MAX_OUTSTANDING_PINGS], 7);
   strictEqual(optionsBuffer[IDX_OPTIONS_MAX_OUTSTANDING_SETTINGS], 8);
   strictEqual(optionsBuffer[IDX_OPTIONS_MAX_SESSION_MEMORY], 9);
+  strictEqual(optionsBuffer[IDX_OPTIONS_COALESCE_WRITES], 1);
+  strictEqual(optionsBuffer[IDX_OPTIONS_ADAPTIVE_WINDOW_SIZE], 1);
+  strictEqual(optionsBuffer[IDX_OPTIONS_EXTENSIBLE_PRIORITIES], 1);
 
   const flags = optionsBuffer[IDX_OPTIONS_FLAGS];
 
@@ -57,6 +66,9 @@ const IDX_OPTIONS_FLAGS = 9;
   ok(flags & (1 << IDX_OPTIONS_MAX_HEADER_LIST_PAIRS));
   ok(flags & (1 << IDX_OPTIONS_MAX_OUTSTANDING_PINGS));
   ok(flags & (1 << IDX_OPTIONS_MAX_OUTSTANDING_SETTINGS));
+  ok(flags & (1 << IDX_OPTIONS_COALESCE_WRITES));
+  ok(flags & (1 << IDX_OPTIONS_ADAPTIVE_WINDOW_SIZE));
+  ok(flags & (1 << IDX_OPTIONS_EXTENSIBLE_PRIORITIES));
 }
 
 {
@@ -89,4 +101,6 @@ const IDX_OPTIONS_FLAGS = 9;
 
   ok(!(flags & (1 << IDX_OPTIONS_MAX_SEND_HEADER_BLOCK_LENGTH)));
   ok(!(flags & (1 << IDX_OPTIONS_MAX_OUTSTANDING_PINGS)));
+  ok(!(flags & (1 << IDX_OPTIONS_COALESCE_WRITES)));
+  ok(!(flags & (1 << IDX_OPTIONS_ADAPTIVE_WINDOW_SIZE)));
 }
@@ -58,3 +58,17 @@ const wptToASCIITests = require(
     icu.toUnicode(input); // Should not throw.
   }
 }
+
+// ASCII names without Punycode labels are only lower cased, other names
+// still go through the full UTS #46 processing.
+{
+  assert.strictEqual(icu.toASCII('WWW.Example.COM'), 'www.example.com');
+  assert.strictEqual(icu.toUnicode('WWW.Example.COM'), 'www.example.com');
+  assert.strictEqual(icu.toASCII('a..b_c.'), 'a..b_c.');
+  assert.strictEqual(icu.toASCII(''), '');
+  assert.strictEqual(icu.toASCII('XN--MNCHEN-3YA.de'), 'xn--mnchen-3ya.de');
+  assert.strictEqual(icu.toUnicode('www.XN--MNCHEN-3YA.de'), 'www.münchen.de');
+  assert.throws(() => icu.toASCII('a.xn--a.com'), {
+    code: 'ERR_INVALID_ARG_VALUE'
+  });
+}
@@ -0,0 +1,88 @@
+'use strict';
+
+const common = require('../common');
+
+common.skipIfInspectorDisabled();
+common.skipIfWorker(); // https://github.com/nodejs/node/issues/22767
+
+const assert = require('assert');
+const { performance } = require('perf_hooks');
+const { Session } = require('inspector');
+
+const session = new Session();
+
+function post(message, data) {
+  return new Promise((resolve, reject) => {
+    session.post(message, data, (err, result) => {
+      if (err)
+        reject(new Error(JSON.stringify(err)));
+      else
+        resolve(result);
+    });
+  });
+}
+
+// Traces `count` marks and measures with the given sampling rate, and returns
+// the user timing events that were collected.
+async function trace(rate, count, maxPendingChunks) {
+  const events = [];
+  const onData = ({ params }) => events.push(...params.value);
+  session.on('NodeTracing.dataCollected', onData);
+  await post('NodeTracing.setSamplingRate',
+             { category: 'node.perf.usertiming', rate });
+  await post('NodeTracing.start', {
+    traceConfig: { includedCategories: ['node.perf.usertiming'],
+                   maxPendingChunks }
+  });
+  for (let i = 0; i < count; i++) {
+    performance.mark(`mark-${i}`);
+    performance.measure(`measure-${i}`, `mark-${i}`);
+  }
+  await post('NodeTracing.stop');
+  // Let the dataCollected events posted by the tracing thread arrive.
+  await new Promise((resolve) => setTimeout(resolve, 100));
+  session.removeListener('NodeTracing.dataCollected', onData);
+  const byPhase = (phase) => events.filter((event) => event.ph === phase);
+  return {
+    marks: byPhase('R').length,
+    begins: byPhase('b').length,
+    ends: byPhase('e').length
+  };
+}
+
+async function test() {
+  const interval = setInterval(() => {}, 5000);
+  session.connect();
+
+  for (const rate of [-1, 1.5, NaN]) {
+    await assert.rejects(
+      post('NodeTracing.setSamplingRate', { category: 'node', rate }),
+      /rate should be between 0 and 1/);
+  }
+  await assert.rejects(
+    post('NodeTracing.start', {
+      traceConfig: { includedCategories: ['node'], maxPendingChunks: -1 }
+    }),
+    /maxPendingChunks should not be negative/);
+
+  let counts = await trace(0, 20);
+  assert.deepStrictEqual(counts, { marks: 0, begins: 0, ends: 0 });
+
+  // Events without an id are sampled evenly, asynchronous events by their id,
+  // so begin and end events are kept together.
+  counts = await trace(0.5, 20);
+  assert.strictEqual(counts.marks, 10);
+  assert.strictEqual(counts.begins, counts.ends);
+  assert.ok(counts.begins <= 20);
+
+  // A rate of 1 collects everything again, and a small trace fits into a
+  // single pending chunk.
+  counts = await trace(1, 20, 1);
+  assert.deepStrictEqual(counts, { marks: 20, begins: 20, ends: 20 });
+  await post('NodeTracing.acknowledgeData');
+
+  session.disconnect();
+  clearInterval(interval);
+}
+
+test().then(common.mustCall());
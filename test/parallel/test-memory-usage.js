@@ -32,6 +32,10 @@ assert.ok(r.heapTotal > 0);
 assert.ok(r.heapUsed > 0);
 assert.ok(r.external > 0);
 
+assert.strictEqual(typeof process.memoryUsage.rss(), 'number');
+if (!common.isIBMi)
+  assert.ok(process.memoryUsage.rss() > 0);
+
 assert.strictEqual(typeof r.arrayBuffers, 'number');
 if (r.arrayBuffers > 0) {
   const size = 10 * 1024 * 1024;
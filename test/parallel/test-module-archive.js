@@ -0,0 +1,80 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { spawnSync } = require('child_process');
+const tmpdir = require('../common/tmpdir');
+const { pack } = require('../../tools/pack-module-archive');
+
+// Test that CommonJS and ES modules are resolved and loaded from the module
+// archive given by --module-archive, without the files being on disk.
+
+tmpdir.refresh();
+const app = path.join(tmpdir.path, 'app');
+const files = {
+  'main.js': `
+    const dep = require('dep');
+    console.log(dep.name, require('./data.json').value, require('./shadowed'));
+  `,
+  'main.mjs': `
+    import dep from 'dep';
+    import { value } from './lib/value.mjs';
+    console.log(dep.name, value);
+  `,
+  'data.json': '{ "value": 42 }',
+  'shadowed.js': 'module.exports = "from archive";',
+  'lib/value.mjs': 'export const value = 17;',
+  'node_modules/dep/package.json': '{ "main": "lib/index.js" }',
+  'node_modules/dep/lib/index.js': 'exports.name = "dep";',
+};
+for (const [name, contents] of Object.entries(files)) {
+  fs.mkdirSync(path.dirname(path.join(app, name)), { recursive: true });
+  fs.writeFileSync(path.join(app, name), contents);
+}
+
+function run(archive, entry) {
+  return spawnSync(process.execPath, [
+    `--module-archive=${archive}`, path.join(app, entry)
+  ]);
+}
+
+// Archives are mounted at the directory that contains them.
+for (const codeCache of [false, true]) {
+  const name = `app${codeCache ? '-cached' : ''}.mar`;
+  const archive = path.join(tmpdir.path, name);
+  assert.strictEqual(pack(app, archive, { codeCache }),
+                     Object.keys(files).length);
+  fs.renameSync(archive, path.join(app, name));
+}
+
+// Remove the files from disk, except for one that is shadowed by the archive.
+for (const name of Object.keys(files))
+  fs.unlinkSync(path.join(app, name));
+fs.rmdirSync(path.join(app, 'node_modules'), { recursive: true });
+fs.writeFileSync(path.join(app, 'shadowed.js'), 'module.exports = "disk";');
+
+for (const archive of ['app.mar', 'app-cached.mar']) {
+  const cjs = run(path.join(app, archive), 'main.js');
+  assert.strictEqual(cjs.status, 0, cjs.stderr.toString());
+  assert.strictEqual(cjs.stdout.toString(), 'dep 42 from archive\n');
+
+  const esm = run(path.join(app, archive), 'main.mjs');
+  assert.strictEqual(esm.status, 0, esm.stderr.toString());
+  assert.strictEqual(esm.stdout.toString(), 'dep 17\n');
+}
+
+{
+  // Files outside of the archive are loaded from disk.
+  fs.writeFileSync(path.join(app, 'outside.js'), 'console.log("outside");');
+  const child = run(path.join(app, 'app.mar'), 'outside.js');
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.strictEqual(child.stdout.toString(), 'outside\n');
+}
+
+{
+  const child = run(path.join(app, 'shadowed.js'), 'main.js');
+  assert.strictEqual(child.status, 9);
+  assert.match(child.stderr.toString(),
+               /Cannot load module archive .*: Not a module archive/);
+}
@@ -0,0 +1,101 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+function lookup(addresses) {
+  return common.mustCall((hostname, options, callback) => {
+    assert.strictEqual(options.all, true);
+    callback(null, addresses);
+  });
+}
+
+// The IPv6 address is tried first, and the socket falls back to IPv4 when
+// nothing listens there. Data written before the connection was made is sent
+// on the handle that won.
+{
+  const server = net.createServer((socket) => socket.pipe(socket));
+  server.listen(0, '127.0.0.1', common.mustCall(() => {
+    const { port } = server.address();
+    const socket = net.connect({
+      host: 'example.org',
+      port,
+      autoSelectFamily: true,
+      autoSelectFamilyAttemptTimeout: 10,
+      lookup: lookup([
+        { address: '::1', family: 6 },
+        { address: '127.0.0.1', family: 4 }
+      ])
+    });
+    socket.setNoDelay(true);
+    socket.setEncoding('utf8');
+    socket.on('lookup', common.mustCall((err, address, family, host) => {
+      assert.ifError(err);
+      assert.strictEqual(address, '::1');
+      assert.strictEqual(family, 6);
+      assert.strictEqual(host, 'example.org');
+    }));
+    socket.on('connect', common.mustCall(() => {
+      assert.strictEqual(socket.remoteAddress, '127.0.0.1');
+      assert.strictEqual(socket.remotePort, port);
+    }));
+    socket.on('data', common.mustCall((data) => {
+      assert.strictEqual(data, 'hello');
+      socket.end();
+    }));
+    socket.on('close', common.mustCall(() => server.close()));
+    socket.write('hello');
+  }));
+}
+
+// When all attempts fail, the error of the preferred address is reported.
+{
+  const server = net.createServer();
+  server.listen(0, '127.0.0.1', common.mustCall(() => {
+    const { port } = server.address();
+    server.close(common.mustCall(() => {
+      const socket = net.connect({
+        host: 'example.org',
+        port,
+        autoSelectFamily: true,
+        lookup: lookup([
+          { address: '127.0.0.1', family: 4 },
+          { address: '127.0.0.1', family: 4 }
+        ])
+      });
+      socket.on('error', common.mustCall((err) => {
+        assert.strictEqual(err.code, 'ECONNREFUSED');
+        assert.strictEqual(err.address, '127.0.0.1');
+        assert.strictEqual(err.port, port);
+      }));
+    }));
+  }));
+}
+
+// Custom lookup functions that ignore `all` still work.
+{
+  const server = net.createServer((socket) => socket.end());
+  server.listen(0, '127.0.0.1', common.mustCall(() => {
+    const socket = net.connect({
+      host: 'example.org',
+      port: server.address().port,
+      autoSelectFamily: true,
+      lookup: common.mustCall((hostname, options, callback) => {
+        callback(null, '127.0.0.1', 4);
+      })
+    }, common.mustCall(() => {
+      socket.destroy();
+      server.close();
+    }));
+  }));
+}
+
+['true', 1].forEach((autoSelectFamily) => {
+  assert.throws(() => net.connect({ port: 80, autoSelectFamily }),
+                { code: 'ERR_INVALID_ARG_TYPE' });
+});
+[0, 9, 1.5].forEach((autoSelectFamilyAttemptTimeout) => {
+  assert.throws(() => net.connect({ port: 80, autoSelectFamilyAttemptTimeout }),
+                { code: 'ERR_OUT_OF_RANGE' });
+});
@@ -0,0 +1,40 @@
+// Flags: --loop-edge-triggered
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+// Test that TCP sockets that are watched with edge-triggered epoll receive
+// all of the data, also when reading is paused while data is pending, and
+// that the end of input is reported.
+
+const chunk = Buffer.alloc(64 * 1024, 'x');
+const chunks = 64;
+
+const server = net.createServer(common.mustCall((socket) => {
+  let received = 0;
+  let pauses = 0;
+  socket.on('data', (data) => {
+    received += data.length;
+    if (pauses++ < 8) {
+      socket.pause();
+      setTimeout(() => socket.resume(), 1);
+    }
+  });
+  socket.on('end', common.mustCall(() => {
+    assert.strictEqual(received, chunk.length * chunks);
+    socket.end();
+    server.close();
+  }));
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port, common.mustCall(() => {
+    for (let i = 0; i < chunks; i++)
+      client.write(chunk);
+    client.end();
+  }));
+  client.resume();
+  client.on('end', common.mustCall());
+}));
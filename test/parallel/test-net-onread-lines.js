@@ -0,0 +1,132 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+const records = Array.from({ length: 2000 }, (_, i) => {
+  return JSON.stringify({ i, text: 'é€'.repeat(i % 40), pad: 'x'.repeat(i) });
+});
+const payload = Buffer.from(`${records.join('\n')}\npartial`);
+
+function serve(writeChunks, onListening) {
+  net.createServer(common.mustCall(function(socket) {
+    this.close();
+    writeChunks(socket);
+  })).listen(0, onListening);
+}
+
+// Writes that split lines and multi-byte characters at arbitrary points.
+function writeInPieces(socket) {
+  let offset = 0;
+  let size = 1;
+  while (offset < payload.length) {
+    socket.write(payload.slice(offset, offset + size));
+    offset += size;
+    size = (size * 7 + 3) % 40000 + 1;
+  }
+  socket.end();
+}
+
+for (const encoding of [undefined, 'buffer', 'utf8', 'UTF-8', 'latin1']) {
+  serve(writeInPieces, common.mustCall(function() {
+    const lines = [];
+    net.connect({
+      port: this.address().port,
+      onread: {
+        delimiter: '\n',
+        encoding,
+        callback: common.mustCallAtLeast((received) => {
+          assert(Array.isArray(received));
+          assert(received.length > 0);
+          lines.push(...received);
+        })
+      }
+    }).on('data', common.mustNotCall()).on('end', common.mustCall(() => {
+      assert.strictEqual(lines.length, records.length + 1);
+      const expected = [...records, 'partial'];
+      if (encoding === undefined || encoding === 'buffer') {
+        assert(lines.every((line) => Buffer.isBuffer(line)));
+        assert.deepStrictEqual(lines.map((line) => line.toString()), expected);
+      } else if (encoding === 'latin1') {
+        assert.deepStrictEqual(
+          lines,
+          expected.map((line) => Buffer.from(line).toString('latin1')));
+      } else {
+        assert.deepStrictEqual(lines, expected);
+        for (const line of lines.slice(0, -1))
+          JSON.parse(line);
+      }
+    }));
+  }));
+}
+
+// Numeric delimiters, empty lines and a delimiter at the very end.
+serve((socket) => socket.end('a\0\0b\0'), common.mustCall(function() {
+  const lines = [];
+  net.connect({
+    port: this.address().port,
+    onread: {
+      delimiter: 0,
+      encoding: 'ascii',
+      callback: (received) => { lines.push(...received); }
+    }
+  }).on('end', common.mustCall(() => {
+    assert.deepStrictEqual(lines, ['a', '', 'b']);
+  }));
+}));
+
+// Returning false pauses the socket.
+serve(writeInPieces, common.mustCall(function() {
+  let count = 0;
+  const socket = net.connect({
+    port: this.address().port,
+    onread: {
+      delimiter: 10,
+      callback: (received) => {
+        count += received.length;
+        setImmediate(() => socket.resume());
+        return false;
+      }
+    }
+  }).on('end', common.mustCall(() => {
+    assert.strictEqual(count, records.length + 1);
+  }));
+}));
+
+// Lines longer than maxLineLength destroy the socket, whether they are
+// complete or not.
+for (const data of ['abcdefgh\nab\n', 'abcdefgh']) {
+  serve((socket) => {
+    socket.on('error', () => {});
+    socket.end(data);
+  }, common.mustCall(function() {
+    const lines = [];
+    net.connect({
+      port: this.address().port,
+      onread: {
+        delimiter: '\n',
+        encoding: 'latin1',
+        maxLineLength: 4,
+        callback: (received) => { lines.push(...received); }
+      }
+    }).on('error', common.mustCall((err) => {
+      assert.strictEqual(err.code, 'ENOBUFS');
+      assert.deepStrictEqual(lines, []);
+    })).on('end', common.mustNotCall());
+  }));
+}
+
+for (const maxLineLength of [0, -1, 1.5, 2 ** 32, '4']) {
+  assert.throws(() => new net.Socket({
+    onread: { delimiter: '\n', maxLineLength, callback: common.mustNotCall() }
+  }), { code: /^ERR_(OUT_OF_RANGE|INVALID_ARG_TYPE)$/ });
+}
+
+for (const delimiter of ['', 'ab', 'Ā', -1, 256, 1.5, null, {}]) {
+  assert.throws(() => new net.Socket({
+    onread: { delimiter, callback: common.mustNotCall() }
+  }), { code: 'ERR_INVALID_ARG_VALUE' });
+}
+assert.throws(() => new net.Socket({
+  onread: { delimiter: '\n', encoding: 'nope', callback: common.mustNotCall() }
+}), { code: 'ERR_INVALID_ARG_VALUE' });
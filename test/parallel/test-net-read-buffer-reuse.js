@@ -0,0 +1,48 @@
+'use strict';
+// Reads from all sockets of an Environment share one read buffer. Check that
+// data that was handed to JS is never overwritten by later reads, for both
+// small reads (which are copied out) and large reads (which take the buffer).
+
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+const sizes = [1, 100, 4096, 32 * 1024, 32 * 1024 + 1, 64 * 1024, 200 * 1024];
+const connections = 4;
+
+function payload(id) {
+  return Buffer.concat(sizes.map((size, i) => {
+    return Buffer.alloc(size, `${id}:${i};`);
+  }));
+}
+
+const server = net.createServer(common.mustCall((socket) => {
+  socket.once('data', (id) => {
+    // Write in pieces so that reads of different sizes happen on the other
+    // end, interleaved between the connections.
+    const data = payload(id.toString());
+    let offset = 0;
+    for (const size of sizes) {
+      socket.write(data.slice(offset, offset + size));
+      offset += size;
+    }
+    socket.end();
+  });
+}, connections));
+
+server.listen(0, common.mustCall(() => {
+  let pending = connections;
+  for (let id = 0; id < connections; id++) {
+    const chunks = [];
+    const client = net.connect(server.address().port, () => {
+      client.write(`${id}`);
+    });
+    client.on('data', (chunk) => chunks.push(chunk));
+    client.on('end', common.mustCall(() => {
+      assert(chunks.every((chunk) => chunk.length > 0));
+      assert.deepStrictEqual(Buffer.concat(chunks), payload(`${id}`));
+      if (--pending === 0)
+        server.close();
+    }));
+  }
+}));
@@ -0,0 +1,47 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+const CLIENTS = 5;
+const BATCH = 3;
+
+[-1, 1.5, 'foo', null].forEach((acceptBatchSize) => {
+  assert.throws(() => net.createServer({ acceptBatchSize }), {
+    code: /^ERR_(INVALID_ARG_TYPE|OUT_OF_RANGE)$/
+  });
+});
+
+let accepted = 0;
+
+const server = net.createServer({ acceptBatchSize: BATCH }, (socket) => {
+  socket.end('hello');
+  if (++accepted === CLIENTS)
+    server.close();
+});
+
+server.listen(0, common.mustCall(() => {
+  // Connections reach JS as arrays of handles, at most BATCH at a time.
+  const handle = server._handle;
+  const onconnection = handle.onconnection;
+  handle.onconnection = common.mustCallAtLeast((err, handles) => {
+    assert.strictEqual(err, 0);
+    assert(Array.isArray(handles));
+    assert(handles.length >= 1 && handles.length <= BATCH);
+    return onconnection.call(handle, err, handles);
+  }, Math.ceil(CLIENTS / BATCH));
+
+  for (let i = 0; i < CLIENTS; i++) {
+    const client = net.connect(server.address().port);
+    let data = '';
+    client.setEncoding('utf8');
+    client.on('data', (chunk) => data += chunk);
+    client.on('end', common.mustCall(() => {
+      assert.strictEqual(data, 'hello');
+    }));
+  }
+}));
+
+process.on('exit', () => {
+  assert.strictEqual(accepted, CLIENTS);
+});
@@ -0,0 +1,66 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+const net = require('net');
+const { spawnSync } = require('child_process');
+
+// Test socket.setBusyPoll() on TCP and UDP sockets, and that the event loop
+// keeps working when it busy polls with --loop-busy-poll.
+
+const server = net.createServer(common.mustCall((socket) => {
+  socket.end();
+  server.close();
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port);
+
+  assert.throws(() => client.setBusyPoll(-1), { code: 'ERR_OUT_OF_RANGE' });
+  assert.throws(() => client.setBusyPoll('1'),
+                { code: 'ERR_INVALID_ARG_TYPE' });
+
+  // The option is applied once the socket has connected.
+  if (common.isLinux)
+    assert.strictEqual(client.setBusyPoll(0), client);
+  client.on('connect', common.mustCall(() => {
+    if (common.isLinux)
+      assert.strictEqual(client.setBusyPoll(0), client);
+    else
+      assert.throws(() => client.setBusyPoll(0), { code: 'ENOTSUP' });
+  }));
+  client.resume();
+}));
+
+{
+  const socket = dgram.createSocket('udp4');
+  assert.throws(() => socket.setBusyPoll(-1), { code: 'ERR_OUT_OF_RANGE' });
+  socket.bind(0, common.mustCall(() => {
+    if (common.isLinux)
+      socket.setBusyPoll(0);
+    else
+      assert.throws(() => socket.setBusyPoll(0), { code: 'ENOTSUP' });
+    socket.close();
+  }));
+}
+
+{
+  const script = `
+    const server = require('net').createServer((socket) => socket.pipe(socket));
+    server.listen(0, () => {
+      const client = require('net').connect(server.address().port);
+      client.end('ping');
+      client.on('data', (data) => {
+        setTimeout(() => {
+          console.log(data.toString());
+          server.close();
+        }, 10);
+      });
+    });
+  `;
+  const child = spawnSync(process.execPath,
+                          ['--loop-busy-poll=100', '-e', script]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.strictEqual(child.stdout.toString(), 'ping\n');
+}
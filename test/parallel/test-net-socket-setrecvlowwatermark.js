@@ -0,0 +1,57 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+// Test socket.setRecvLowWatermark(), and that streams which adapt the size of
+// their read buffers receive both small messages and bulk data intact.
+
+const small = 100;
+const bulk = Buffer.alloc(1024 * 1024, 'x');
+
+const server = net.createServer(common.mustCall((socket) => {
+  let received = 0;
+  socket.on('data', (data) => {
+    received += data.length;
+  });
+  socket.on('end', common.mustCall(() => {
+    assert.strictEqual(received, small + bulk.length);
+    socket.end();
+    server.close();
+  }));
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port);
+
+  assert.throws(() => client.setRecvLowWatermark(0),
+                { code: 'ERR_OUT_OF_RANGE' });
+  assert.throws(() => client.setRecvLowWatermark('1'),
+                { code: 'ERR_INVALID_ARG_TYPE' });
+  // The option is applied once the socket has connected.
+  if (!common.isWindows)
+    assert.strictEqual(client.setRecvLowWatermark(1), client);
+
+  client.on('connect', common.mustCall(() => {
+    if (common.isWindows) {
+      assert.throws(() => client.setRecvLowWatermark(1024),
+                    { code: 'ENOTSUP' });
+    } else {
+      assert.strictEqual(client.setRecvLowWatermark(1024), client);
+    }
+
+    // Send small messages first, so that the reads shrink, and then bulk
+    // data, so that they grow again.
+    let i = 0;
+    (function writeSmall() {
+      if (i++ === small) {
+        client.end(bulk);
+        return;
+      }
+      client.write('x', writeSmall);
+    })();
+  }));
+  client.resume();
+  client.on('end', common.mustCall());
+}));
@@ -0,0 +1,100 @@
+'use strict';
+
+// Writes at or above the threshold of setZeroCopyThreshold() arrive intact and
+// in order with the writes around them, and their callbacks are called in
+// order once the kernel is done with their data.
+
+const common = require('../common');
+if (!common.isLinux)
+  common.skip('MSG_ZEROCOPY is Linux-only');
+const assert = require('assert');
+const net = require('net');
+
+for (const bytes of [-1, 1.5, '1']) {
+  assert.throws(() => new net.Socket().setZeroCopyThreshold(bytes), {
+    code: typeof bytes === 'string' ?
+      'ERR_INVALID_ARG_TYPE' : 'ERR_OUT_OF_RANGE'
+  });
+}
+
+const chunks = [
+  Buffer.alloc(4 * 1024 * 1024, 'a'),
+  Buffer.from('small'),
+  Buffer.alloc(64 * 1024, 'b'),
+  Buffer.alloc(3 * 1024 * 1024 + 7, 'c'),
+  Buffer.alloc(100, 'd')
+];
+const expected = Buffer.concat(chunks);
+
+const server = net.createServer(common.mustCall((socket) => {
+  const received = [];
+  socket.on('data', (data) => received.push(data));
+  socket.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(Buffer.concat(received), expected);
+    server.close();
+  }));
+}));
+
+let supported = true;
+server.listen(0, common.mustCall(() => {
+  const socket = net.connect(server.address().port, common.localhostIPv4);
+  socket.on('connect', common.mustCall(() => {
+    try {
+      socket.setZeroCopyThreshold(64 * 1024);
+    } catch (err) {
+      if (err.code !== 'ENOPROTOOPT')
+        throw err;
+      common.printSkipMessage('SO_ZEROCOPY is not supported');
+      supported = false;
+    }
+
+    const written = [];
+    chunks.forEach((chunk, i) => {
+      socket.write(chunk, common.mustCall((err) => {
+        assert.ifError(err);
+        written.push(i);
+      }));
+    });
+    socket.end(common.mustCall(() => {
+      assert.deepStrictEqual(written, [0, 1, 2, 3, 4]);
+      if (supported)
+        connectBeforeThreshold(destroyWithWriteOutstanding);
+    }));
+  }));
+}));
+
+// The threshold can be set while the socket is still connecting.
+function connectBeforeThreshold(next) {
+  const server = net.createServer(common.mustCall((socket) => {
+    let length = 0;
+    socket.on('data', (data) => length += data.length);
+    socket.on('end', common.mustCall(() => {
+      assert.strictEqual(length, chunks[0].length);
+      server.close(next);
+    }));
+  }));
+
+  server.listen(0, common.mustCall(() => {
+    const socket = net.connect(server.address().port, common.localhostIPv4);
+    assert.strictEqual(socket.setZeroCopyThreshold(64 * 1024), socket);
+    socket.end(chunks[0], common.mustCall());
+  }));
+}
+
+// A write that the kernel has not reported yet completes even though the
+// socket is destroyed right after it.
+function destroyWithWriteOutstanding() {
+  const server = net.createServer(common.mustCall((socket) => {
+    socket.resume();
+    socket.on('close', common.mustCall(() => server.close()));
+  }));
+
+  server.listen(0, common.mustCall(() => {
+    const socket = net.connect(server.address().port, common.localhostIPv4);
+    socket.setZeroCopyThreshold(64 * 1024);
+    socket.on('connect', common.mustCall(() => {
+      socket.write(chunks[0], common.mustCall());
+      socket.destroy();
+    }));
+  }));
+}
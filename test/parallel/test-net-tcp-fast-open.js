@@ -0,0 +1,61 @@
+'use strict';
+
+// Servers with fastOpenQueueLength and deferAccept, and clients with
+// fastOpen, exchange data as usual. Whether the data is actually sent with
+// the SYN depends on the platform and on system settings, so that is not
+// checked here.
+
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+for (const name of ['fastOpenQueueLength', 'deferAccept']) {
+  for (const value of [-1, 1.5, 2 ** 31, '1']) {
+    assert.throws(() => net.createServer({ [name]: value }), {
+      code: typeof value === 'string' ?
+        'ERR_INVALID_ARG_TYPE' : 'ERR_OUT_OF_RANGE'
+    });
+  }
+}
+
+const server = net.createServer({
+  fastOpenQueueLength: 16,
+  deferAccept: 1
+}, common.mustCall((socket) => {
+  socket.on('data', common.mustCall((data) => {
+    assert.strictEqual(data.toString(), 'hello');
+    socket.end('world');
+  }));
+}, 4));
+
+server.listen(0, common.mustCall(() => {
+  const { port } = server.address();
+
+  assert.throws(() => net.connect({ port, fastOpen: 1 }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+
+  // The first connection gets a Fast Open cookie, if any, and the later ones
+  // can use it. The last one races its attempts, which ignores fastOpen.
+  let remaining = 4;
+  function connect() {
+    const socket = net.connect({
+      port,
+      host: remaining > 1 ? common.localhostIPv4 : 'localhost',
+      fastOpen: true,
+      autoSelectFamily: remaining === 1
+    });
+    socket.write('hello');
+    socket.setEncoding('utf8');
+    let data = '';
+    socket.on('data', (chunk) => data += chunk);
+    socket.on('end', common.mustCall(() => {
+      assert.strictEqual(data, 'world');
+      if (--remaining > 0)
+        connect();
+      else
+        server.close();
+    }));
+  }
+  connect();
+}));
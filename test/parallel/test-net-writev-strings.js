@@ -0,0 +1,64 @@
+// Flags: --expose_externalize_string
+'use strict';
+const common = require('../common');
+
+// Writev of mixed Buffer and string chunks, including external one-byte
+// strings that are written without being copied, must deliver the data
+// unchanged both when the write completes synchronously and when it does
+// not.
+
+const assert = require('assert');
+const net = require('net');
+
+/* eslint-disable no-undef */
+common.allowGlobals(externalizeString, isOneByteString, x);
+
+function external(str) {
+  externalizeString(str);
+  assert.strictEqual(isOneByteString(str), true);
+  return str;
+}
+
+const small = [
+  [external('ümlaut eins, '), 'latin1'],
+  ['ümlaut zwei, ', 'utf8'],
+  [Buffer.from('buffer, '), 'buffer'],
+  [external('external ascii, '), 'ascii'],
+  ['dGhlIGVuZA==', 'base64'],
+];
+// Exceeds the stack storage and the socket buffers.
+const large = [
+  [external(`${'ä'.repeat(1024 * 1024)} latin1`), 'latin1'],
+  ['€'.repeat(64 * 1024), 'utf8'],
+  [Buffer.alloc(1024 * 1024, 'b'), 'buffer'],
+  ['x'.repeat(8 * 1024), 'latin1'],
+];
+
+function expected(chunks) {
+  return Buffer.concat(chunks.map(([chunk, encoding]) => {
+    return Buffer.isBuffer(chunk) ? chunk : Buffer.from(chunk, encoding);
+  }));
+}
+
+function test(chunks, cb) {
+  const server = net.createServer(common.mustCall((socket) => {
+    const received = [];
+    socket.on('data', (data) => received.push(data));
+    socket.on('end', common.mustCall(() => {
+      assert.deepStrictEqual(Buffer.concat(received), expected(chunks));
+      server.close(cb);
+    }));
+  }));
+
+  server.listen(0, common.mustCall(() => {
+    const client = net.connect(server.address().port, common.mustCall(() => {
+      client.cork();
+      for (const [chunk, encoding] of chunks)
+        client.write(chunk, encoding);
+      client.uncork();
+      client.end();
+    }));
+  }));
+}
+
+test(small, common.mustCall(() => test(large, common.mustCall())));
@@ -0,0 +1,37 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const os = require('os');
+
+// os.cpuUsage() returns the same times as os.cpus(), and their differences
+// when it is passed a previous result.
+
+const cpus = os.cpus();
+const usage = os.cpuUsage();
+assert(usage instanceof Float64Array);
+assert.strictEqual(usage.length, cpus.length * 5);
+
+// The times only grow, so the ones of os.cpuUsage() are at least those of
+// the earlier os.cpus() call.
+cpus.forEach(({ times }, i) => {
+  const { user, nice, sys, idle, irq } = times;
+  [user, nice, sys, idle, irq].forEach((time, j) => {
+    assert(usage[i * 5 + j] >= time, `${usage[i * 5 + j]} >= ${time}`);
+  });
+});
+
+const previous = Float64Array.from(usage);
+const delta = os.cpuUsage(usage);
+assert.strictEqual(delta.length, usage.length);
+for (let i = 0; i < delta.length; i++) {
+  assert(delta[i] >= 0);
+  // |usage| was updated to the current times.
+  assert.strictEqual(usage[i], previous[i] + delta[i]);
+}
+
+for (const value of [null, 1, [], new Float32Array(usage.length)]) {
+  assert.throws(() => os.cpuUsage(value), { code: 'ERR_INVALID_ARG_TYPE' });
+}
+assert.throws(() => os.cpuUsage(new Float64Array(usage.length + 1)), {
+  code: 'ERR_INVALID_ARG_VALUE'
+});
@@ -105,6 +105,11 @@ for (const cpu of cpus) {
   assert.strictEqual(typeof cpu.times.irq, 'number');
 }
 
+const availableParallelism = os.availableParallelism();
+assert.ok(Number.isInteger(availableParallelism));
+assert.ok(availableParallelism >= 1);
+assert.ok(availableParallelism <= cpus.length);
+
 const type = os.type();
 is.string(type);
 assert.ok(type.length > 0);
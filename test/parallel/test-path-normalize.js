@@ -70,3 +70,8 @@ assert.strictEqual(
   '../../../../baz'
 );
 assert.strictEqual(path.posix.normalize('foo/bar\\baz'), 'foo/bar\\baz');
+assert.strictEqual(path.posix.normalize('/'), '/');
+assert.strictEqual(path.posix.normalize('/foo/bar/'), '/foo/bar/');
+assert.strictEqual(path.posix.normalize('foo/.bar/..baz'), 'foo/.bar/..baz');
+assert.strictEqual(path.posix.normalize('foo/.'), 'foo');
+assert.strictEqual(path.posix.normalize('//foo'), '/foo');
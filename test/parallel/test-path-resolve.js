@@ -34,7 +34,13 @@ const resolveTests = [
      [['a/b/c/', '../../..'], process.cwd()],
      [['.'], process.cwd()],
      [['/some/dir', '.', '/absolute/'], '/absolute'],
-     [['/foo/tmp.3/', '../tmp.3/cycles/root.js'], '/foo/tmp.3/cycles/root.js']
+     [['/foo/tmp.3/', '../tmp.3/cycles/root.js'], '/foo/tmp.3/cycles/root.js'],
+     [['/'], '/'],
+     [['/a/b'], '/a/b'],
+     [['/a/b/'], '/a/b'],
+     [['/a', 'b/', ''], '/a/b'],
+     [['/a', '.b', '..c', '...'], '/a/.b/..c/...'],
+     [['/a//b'], '/a/b']
     ]
   ]
 ];
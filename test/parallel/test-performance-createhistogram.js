@@ -0,0 +1,116 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const { createHistogram } = require('perf_hooks');
+const { MessageChannel, Worker } = require('worker_threads');
+
+{
+  const h = createHistogram();
+  assert.strictEqual(h.count, 0);
+  assert.strictEqual(h.exceeds, 0);
+
+  h.record(1);
+  h.record(2n);
+  h.record(3);
+  assert.strictEqual(h.count, 3);
+  assert.strictEqual(h.min, 1);
+  assert.strictEqual(h.max, 3);
+  assert.strictEqual(h.mean, 2);
+  assert.strictEqual(h.percentile(50), 2);
+  assert.ok(h.percentiles instanceof Map);
+  assert.strictEqual(h.percentiles.get(100), 3);
+
+  h.reset();
+  assert.strictEqual(h.count, 0);
+
+  [0, -1, 1.5, NaN, 2 ** 53, 0n].forEach((value) => {
+    assert.throws(() => h.record(value), { code: 'ERR_OUT_OF_RANGE' });
+  });
+  ['1', null, undefined, {}].forEach((value) => {
+    assert.throws(() => h.record(value), { code: 'ERR_INVALID_ARG_TYPE' });
+  });
+  [0, 101, NaN].forEach((percentile) => {
+    assert.throws(() => h.percentile(percentile),
+                  { code: 'ERR_OUT_OF_RANGE' });
+  });
+  assert.throws(() => h.percentile('50'), { code: 'ERR_INVALID_ARG_TYPE' });
+  assert.throws(() => h.add({}), { code: 'ERR_INVALID_ARG_TYPE' });
+}
+
+{
+  const h = createHistogram();
+  h.recordDelta();
+  assert.strictEqual(h.count, 0);
+  setTimeout(common.mustCall(() => {
+    h.recordDelta();
+    assert.strictEqual(h.count, 1);
+    assert.ok(h.min >= 1e6);
+  }), 2);
+}
+
+{
+  const h = createHistogram({ lowest: 1, highest: 100, figures: 2 });
+  h.record(50);
+  h.record(1000);
+  assert.strictEqual(h.count, 1);
+  assert.strictEqual(h.exceeds, 1);
+
+  const other = createHistogram();
+  other.record(10);
+  other.record(500);
+  h.add(other);
+  assert.strictEqual(h.count, 2);
+  assert.strictEqual(h.min, 10);
+  assert.strictEqual(h.exceeds, 2);
+}
+
+[null, 'a'].forEach((options) => {
+  assert.throws(() => createHistogram(options),
+                { code: 'ERR_INVALID_ARG_TYPE' });
+});
+[{ lowest: 0 }, { highest: 1 }, { lowest: 10, highest: 15 },
+ { figures: 0 }, { figures: 6 }, { lowest: 1.5 }].forEach((options) => {
+  assert.throws(() => createHistogram(options), { code: 'ERR_OUT_OF_RANGE' });
+});
+
+{
+  // Histograms are cloned into messages, together with all recorded values.
+  const h = createHistogram({ highest: 1000 });
+  h.record(5);
+  h.record(7);
+  h.record(2000);
+  const { port1, port2 } = new MessageChannel();
+  port2.on('message', common.mustCall(({ histogram }) => {
+    assert.notStrictEqual(histogram, h);
+    assert.strictEqual(histogram.constructor, h.constructor);
+    assert.strictEqual(histogram.count, 2);
+    assert.strictEqual(histogram.min, 5);
+    assert.strictEqual(histogram.max, 7);
+    assert.strictEqual(histogram.exceeds, 1);
+    histogram.record(9);
+    assert.strictEqual(h.count, 2);
+    port2.close();
+  }));
+  port1.postMessage({ histogram: h });
+}
+
+{
+  // The values recorded by Workers can be added up in the main thread.
+  const total = createHistogram();
+  const worker = new Worker(`
+    const { createHistogram } = require('perf_hooks');
+    const { parentPort } = require('worker_threads');
+    const h = createHistogram();
+    for (let i = 1; i <= 100; i++)
+      h.record(i);
+    parentPort.postMessage(h);
+  `, { eval: true });
+  worker.on('message', common.mustCall((h) => {
+    total.add(h);
+    total.add(h);
+    assert.strictEqual(total.count, 200);
+    assert.strictEqual(total.min, 1);
+    assert.strictEqual(total.max, 100);
+  }));
+}
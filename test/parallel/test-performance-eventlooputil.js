@@ -0,0 +1,59 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const { performance, monitorEventLoopPhases } = require('perf_hooks');
+
+function busyWait(ms) {
+  const end = performance.now() + ms;
+  while (performance.now() < end);
+}
+
+// The event loop has not started yet.
+assert.deepStrictEqual(performance.eventLoopUtilization(),
+                       { idle: 0, active: 0, utilization: 0 });
+
+const monitor = monitorEventLoopPhases();
+assert(monitor.enable());
+assert(!monitor.enable());
+for (const phase of ['timers', 'poll', 'check']) {
+  assert.strictEqual(typeof monitor[phase].max, 'number');
+  assert.strictEqual(monitor[phase].enable, undefined);
+}
+
+setTimeout(common.mustCall(() => {
+  const start = performance.eventLoopUtilization();
+  // The event loop was idle while it waited for the timer.
+  assert(start.idle >= 40, `${start.idle}`);
+  assert(performance.nodeTiming.idleTime >= start.idle);
+
+  busyWait(50);
+  const busy = performance.eventLoopUtilization(start);
+  assert(busy.active >= 50, `${busy.active}`);
+  assert(busy.idle < busy.active, `${busy.idle} ${busy.active}`);
+  assert(busy.utilization > 0.5 && busy.utilization <= 1,
+         `${busy.utilization}`);
+
+  setImmediate(common.mustCall(() => {
+    busyWait(5);
+    fs.stat(__filename, common.mustCall(() => {
+      busyWait(5);
+      setImmediate(common.mustCall(() => {
+        const end = performance.eventLoopUtilization();
+        const delta = performance.eventLoopUtilization(end, start);
+        assert(delta.active >= 60, `${delta.active}`);
+        assert.strictEqual(delta.utilization,
+                           delta.active / (delta.idle + delta.active));
+
+        assert(monitor.disable());
+        assert(!monitor.disable());
+        assert(monitor.timers.max >= 50e6, `${monitor.timers.max}`);
+        assert(monitor.check.max >= 5e6, `${monitor.check.max}`);
+        assert(monitor.poll.max >= 5e6, `${monitor.poll.max}`);
+        monitor.reset();
+        assert(monitor.timers.max < 50e6, `${monitor.timers.max}`);
+      }));
+    }));
+  }));
+}), 50);
@@ -0,0 +1,67 @@
+// Flags: --expose-gc
+'use strict';
+
+require('../common');
+const assert = require('assert');
+const util = require('util');
+const { monitorGarbageCollection } = require('perf_hooks');
+
+const kinds = ['minor', 'major', 'incremental', 'weakcb'];
+
+function assertTotals(monitor) {
+  for (const kind of kinds) {
+    const totals = monitor[kind];
+    assert.deepStrictEqual(Object.keys(totals),
+                           ['count', 'duration', 'collected', 'promoted']);
+    for (const value of Object.values(totals))
+      assert.ok(value >= 0);
+  }
+}
+
+function allocate() {
+  let list = [];
+  for (let i = 0; i < 1e5; i++) {
+    list.push({ i });
+    if (list.length > 1e4)
+      list = [];
+  }
+}
+
+const monitor = monitorGarbageCollection();
+assertTotals(monitor);
+assert.strictEqual(monitor.major.count, 0);
+
+// Nothing is recorded before the monitor is enabled.
+global.gc();
+assert.strictEqual(monitor.major.count, 0);
+
+assert.strictEqual(monitor.enable(), true);
+assert.strictEqual(monitor.enable(), false);
+global.gc();
+global.gc();
+allocate();
+assert.ok(monitor.major.count >= 2);
+assert.ok(monitor.major.duration > 0);
+assert.ok(monitor.minor.count > 0);
+assertTotals(monitor);
+
+// The totals are kept while the monitor is disabled, even if another monitor
+// is still enabled.
+const other = monitorGarbageCollection();
+other.enable();
+assert.strictEqual(monitor.disable(), true);
+assert.strictEqual(monitor.disable(), false);
+const totals = util.inspect(monitor);
+global.gc();
+assert.strictEqual(util.inspect(monitor), totals);
+assert.strictEqual(other.major.count, 1);
+
+monitor.reset();
+assert.strictEqual(monitor.major.count, 0);
+assert.strictEqual(monitor.minor.count, 0);
+monitor.enable();
+global.gc();
+assert.strictEqual(monitor.major.count, 1);
+assert.strictEqual(other.major.count, 2);
+monitor.disable();
+other.disable();
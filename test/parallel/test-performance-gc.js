@@ -34,6 +34,11 @@ const kinds = [
     assert.strictEqual(entry.flags, NODE_PERFORMANCE_GC_FLAGS_FORCED);
     assert.strictEqual(typeof entry.startTime, 'number');
     assert.strictEqual(typeof entry.duration, 'number');
+    assert.strictEqual(typeof entry.incremental, 'boolean');
+    assert.strictEqual(typeof entry.promoted, 'number');
+    const { before, after } = entry.heapSpaces.old_space;
+    assert.strictEqual(typeof before, 'number');
+    assert.strictEqual(typeof after, 'number');
     obs.disconnect();
   }));
   obs.observe({ entryTypes: ['gc'] });
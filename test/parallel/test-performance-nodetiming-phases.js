@@ -0,0 +1,39 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { performance } = require('perf_hooks');
+const { Worker, isMainThread, parentPort } = require('worker_threads');
+
+// Test that performance.nodeTiming.phases reports the startup phases that
+// have completed, in the order in which they ran.
+
+function checkPhases(phases, expected) {
+  for (const name of expected)
+    assert(name in phases, `${name} is missing`);
+  for (const [name, { startTime, duration }] of Object.entries(phases)) {
+    assert(startTime >= 0, `${name} starts at ${startTime}`);
+    assert(duration >= 0, `${name} took ${duration}`);
+  }
+  assert(phases.optionParsing.startTime <= phases.v8PlatformInit.startTime);
+  assert(phases.v8PlatformInit.startTime <= phases.preExecution.startTime);
+}
+
+if (!isMainThread) {
+  parentPort.postMessage(performance.nodeTiming.phases);
+  return;
+}
+
+// The entry point is still running.
+const phases = performance.nodeTiming.phases;
+checkPhases(phases, ['optionParsing', 'v8PlatformInit', 'preExecution']);
+assert(!('runMain' in phases));
+
+setImmediate(common.mustCall(() => {
+  const { runMain, preExecution } = performance.nodeTiming.phases;
+  assert(runMain.startTime >= preExecution.startTime + preExecution.duration);
+}));
+
+// Workers report the process-wide phases as well as their own.
+new Worker(__filename).on('message', common.mustCall((phases) => {
+  checkPhases(phases, ['optionParsing', 'v8PlatformInit', 'preExecution']);
+}));
@@ -0,0 +1,80 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const zlib = require('zlib');
+const { monitorThreadpool } = require('perf_hooks');
+
+const kinds = ['fs', 'dns', 'zlib', 'crypto', 'kdf', 'napi'];
+
+{
+  const monitor = monitorThreadpool();
+  assert(monitor.enable());
+  assert(!monitor.enable());
+  monitor.reset();
+  assert(monitor.disable());
+  assert(!monitor.disable());
+
+  for (const kind of kinds) {
+    const { wait, run } = monitor[kind];
+    assert.strictEqual(typeof wait.min, 'number');
+    assert.strictEqual(typeof run.max, 'number');
+    assert.strictEqual(wait.enable, undefined);
+    assert.strictEqual(run.exceeds, undefined);
+  }
+
+  [null, 'a', false, {}, []].forEach((i) => {
+    assert.throws(
+      () => monitor.fs.run.percentile(i),
+      {
+        name: 'TypeError',
+        code: 'ERR_INVALID_ARG_TYPE'
+      }
+    );
+  });
+  [-1, 0, 101].forEach((i) => {
+    assert.throws(
+      () => monitor.fs.run.percentile(i),
+      {
+        name: 'RangeError',
+        code: 'ERR_INVALID_ARG_VALUE'
+      }
+    );
+  });
+}
+
+{
+  const monitor = monitorThreadpool();
+  const idle = monitorThreadpool();
+  monitor.enable();
+
+  const done = common.mustCall(() => {
+    monitor.disable();
+
+    // Work that went through a ThreadPoolWork records both phases.
+    const { wait, run } = monitor.zlib;
+    assert(wait.min > 0);
+    assert(run.min > 0);
+    assert(run.max >= run.min);
+    assert(run.percentiles.size > 0);
+    assert(run.percentile(50) > 0);
+
+    // Requests queued by libuv only record their total time.
+    assert(monitor.fs.run.min > 0);
+
+    // A monitor that was never enabled records nothing.
+    assert.strictEqual(idle.zlib.run.max, 0);
+
+    monitor.reset();
+    assert.strictEqual(monitor.zlib.run.max, 0);
+  });
+
+  fs.stat(__filename, common.mustCall((err) => {
+    assert.ifError(err);
+    zlib.deflate(Buffer.alloc(1024), common.mustCall((err) => {
+      assert.ifError(err);
+      done();
+    }));
+  }));
+}
@@ -0,0 +1,37 @@
+// Flags: --experimental-batch-ticks
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+
+// Test that with --experimental-batch-ticks, the nextTick and microtask
+// queues of the I/O callbacks that run in the same poll phase are processed
+// once all of them have run, and before the immediates.
+
+const events = [];
+const count = 4;
+let remaining = count;
+
+for (let i = 0; i < count; i++) {
+  fs.stat(__filename, common.mustCall(() => {
+    events.push(`stat ${i}`);
+    process.nextTick(() => events.push(`tick ${i}`));
+    Promise.resolve().then(() => events.push(`microtask ${i}`));
+    if (--remaining === 0)
+      setImmediate(common.mustCall(check));
+  }));
+}
+
+// Wait for the thread pool to finish all requests, so that their callbacks
+// run in the same poll phase.
+Atomics.wait(new Int32Array(new SharedArrayBuffer(4)), 0, 0, 500);
+
+function check() {
+  const kinds = events.map((event) => event.split(' ')[0]);
+  assert.deepStrictEqual(kinds, [
+    ...new Array(count).fill('stat'),
+    ...new Array(count).fill('tick'),
+    ...new Array(count).fill('microtask'),
+  ]);
+}
@@ -0,0 +1,41 @@
+// Flags: --expose-gc
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+
+// process.memoryStats is sampled in the background, and its timer does not
+// keep the process alive.
+
+const stats = process.memoryStats;
+assert.strictEqual(process.memoryStats, stats);
+assert(Object.isFrozen(stats));
+assert.deepStrictEqual(Object.keys(stats),
+                       ['rss', 'heapTotal', 'heapUsed', 'external',
+                        'arrayBuffers']);
+
+// The first sample is taken when the property is first accessed.
+if (!common.isIBMi)
+  assert(stats.rss > 0);
+assert(stats.heapTotal > 0);
+assert(stats.heapUsed > 0);
+assert(stats.heapUsed <= stats.heapTotal);
+assert(stats.external > 0);
+assert.strictEqual(typeof stats.arrayBuffers, 'number');
+
+// Reading the values does not sample them again.
+const { heapUsed } = stats;
+const garbage = [];
+for (let i = 0; i < 1e4; i++)
+  garbage.push({ i });
+assert.strictEqual(stats.heapUsed, heapUsed);
+
+// The values keep being updated after garbage collection.
+global.gc();
+const retained = [];
+const interval = setInterval(common.mustCallAtLeast(() => {
+  for (let i = 0; i < 1e3; i++)
+    retained.push({ i });
+  global.gc();
+  if (stats.heapUsed !== heapUsed)
+    clearInterval(interval);
+}), 50);
@@ -0,0 +1,45 @@
+'use strict';
+
+// Tests that querystring.parse() gives the same results whether or not the
+// native parser is used. The native parser only handles ASCII input with the
+// default separators and decoder, so a custom decoder that wraps the default
+// one forces the JS implementation.
+
+require('../common');
+const assert = require('assert');
+const qs = require('querystring');
+
+const jsOptions = { decodeURIComponent: (s) => qs.unescape(s) };
+
+const inputs = [
+  'a=1&b=2&c=3',
+  'a=1&a=2&a=3&b=1&a=4',
+  'a&b=&=c&=&&&d',
+  'foo+bar=baz+quux&%2B=%2B%26%3D',
+  'x=%E2%9C%93&y=%C3%A9&z=%F0%9F%98%80',
+  'bad=%zz%4&bad=%%41&bad=%4%41&bad=%C3&bad=%FF%FE&bad=%ED%A0%80',
+  '%C3=1&%FF=2&%FE=3',
+  '__proto__=1&toString=2&constructor=3&hasOwnProperty=4',
+  '0=a&1=b&01=c&4294967295=d&1=e',
+  'a=b=c&d==e',
+  'tail=%41%4',
+  'a=1&',
+  '&',
+  '=',
+];
+
+for (const input of inputs) {
+  for (const maxKeys of [undefined, 0, 1, 2, 3, 1.5]) {
+    const options = maxKeys === undefined ? undefined : { maxKeys };
+    const expected = qs.parse(input, null, null, { ...options, ...jsOptions });
+    const actual = qs.parse(input, null, null, options);
+    assert.deepStrictEqual(actual, expected, `${input} ${maxKeys}`);
+    assert.deepStrictEqual(Object.keys(actual), Object.keys(expected));
+    assert.strictEqual(Object.getPrototypeOf(actual), null);
+  }
+}
+
+// Non-ASCII input is parsed in JS.
+assert.deepStrictEqual(qs.parse('é=%C3%A9&é=ü'),
+                       Object.assign(Object.create(null),
+                                     { 'é': ['é', 'ü'] }));
@@ -0,0 +1,69 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { spawnSync } = require('child_process');
+const tmpdir = require('../common/tmpdir');
+
+// Test that the heap state created by the entry script of a user-land
+// snapshot is available after starting from that snapshot.
+
+tmpdir.refresh();
+const entry = path.join(tmpdir.path, 'entry.js');
+const blob = path.join(tmpdir.path, 'snapshot.blob');
+
+fs.writeFileSync(entry, `
+  globalThis.squares = [];
+  for (let i = 0; i < 1000; i++)
+    squares.push(i * i);
+  globalThis.sumSquares = () => squares.reduce((a, b) => a + b, 0);
+  Promise.resolve(42).then((value) => globalThis.resolved = value);
+`);
+
+{
+  const child = spawnSync(process.execPath, [
+    '--snapshot-blob', blob, '--build-snapshot', entry
+  ]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.ok(fs.statSync(blob).size > 0);
+}
+
+{
+  const child = spawnSync(process.execPath, [
+    '--snapshot-blob', blob, '-p',
+    'JSON.stringify([squares[999], sumSquares(), resolved, typeof require])'
+  ]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.deepStrictEqual(JSON.parse(child.stdout),
+                         [998001, 332833500, 42, 'function']);
+}
+
+{
+  // Errors in the entry script are reported, and no snapshot is written.
+  const failing = path.join(tmpdir.path, 'failing.js');
+  const failingBlob = path.join(tmpdir.path, 'failing.blob');
+  fs.writeFileSync(failing, 'throw new Error("entry failed");');
+  const child = spawnSync(process.execPath, [
+    '--snapshot-blob', failingBlob, '--build-snapshot', failing
+  ]);
+  assert.strictEqual(child.status, 1);
+  assert.match(child.stderr.toString(), /entry failed/);
+  assert.strictEqual(fs.existsSync(failingBlob), false);
+}
+
+{
+  // Files that are not snapshots are rejected.
+  const child = spawnSync(process.execPath, [
+    '--snapshot-blob', entry, '-e', '0'
+  ]);
+  assert.strictEqual(child.status, 9);
+  assert.match(child.stderr.toString(), /Cannot load snapshot blob/);
+}
+
+{
+  const child = spawnSync(process.execPath, ['--build-snapshot', entry]);
+  assert.strictEqual(child.status, 9);
+  assert.match(child.stderr.toString(),
+               /--build-snapshot must be used together with --snapshot-blob/);
+}
@@ -26,5 +26,32 @@ const { spawnSync } = require('child_process');
                      'invalid value for --use-largepages');
 }
 
+{
+  // The heap may or may not be backed by large pages, but everything should
+  // work either way.
+  const code = `
+    const arrays = [];
+    for (let i = 0; i < 1e5; i++) arrays.push(new Array(10).fill(i));
+    const { largePages } = process.report.getReport().javascriptHeap;
+    console.log(largePages === undefined ||
+                largePages.reservedMemory > 0 &&
+                largePages.largePageMemory <= largePages.reservedMemory);
+  `;
+  const child = spawnSync(process.execPath,
+                          [ '--use-largepages-heap=silent', '-e', code ]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.strictEqual(child.signal, null);
+  assert.strictEqual(child.stdout.toString().trim(), 'true');
+}
+
+{
+  const child = spawnSync(process.execPath,
+                          [ '--use-largepages-heap=xyzzy', '-p', '42' ]);
+  assert.strictEqual(child.status, 9);
+  assert.strictEqual(child.signal, null);
+  assert.strictEqual(child.stderr.toString().match(/\S+/g).slice(1).join(' '),
+                     'invalid value for --use-largepages-heap');
+}
+
 // TODO(gabrielschulhof): Make assertions about the stderr, which may or may not
 // contain a message indicating that mapping to large pages has failed.
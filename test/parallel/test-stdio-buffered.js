@@ -0,0 +1,63 @@
+'use strict';
+
+// With --buffered-stdio, stdout and stderr are written to files and pipes
+// from a separate thread. Nothing may be lost or reordered, including the
+// output of 'exit' listeners and of uncaught exceptions.
+
+require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+if (process.argv[2] === 'child') {
+  const line = 'x'.repeat(100);
+  for (let i = 0; i < 20000; i++)
+    console.log(`${i} ${line}`);
+  console.error('to stderr');
+  process.on('exit', () => console.log('exit'));
+  if (process.argv[3] === 'throw')
+    throw new Error('fatal');
+  return;
+}
+
+function check(stdout) {
+  const lines = stdout.split('\n');
+  assert.strictEqual(lines.length, 20002);
+  for (let i = 0; i < 20000; i++)
+    assert.ok(lines[i].startsWith(`${i} `), lines[i]);
+  assert.strictEqual(lines[20000], 'exit');
+  assert.strictEqual(lines[20001], '');
+}
+
+{
+  const child = spawnSync(process.execPath,
+                          ['--buffered-stdio', __filename, 'child'],
+                          { encoding: 'utf8', maxBuffer: Infinity });
+  assert.strictEqual(child.status, 0);
+  check(child.stdout);
+  assert.strictEqual(child.stderr, 'to stderr\n');
+}
+
+{
+  const child = spawnSync(process.execPath,
+                          ['--buffered-stdio', __filename, 'child', 'throw'],
+                          { encoding: 'utf8', maxBuffer: Infinity });
+  assert.strictEqual(child.status, 1);
+  check(child.stdout);
+  assert.ok(child.stderr.startsWith('to stderr\n'), child.stderr);
+  assert.ok(child.stderr.includes('Error: fatal'), child.stderr);
+}
+
+{
+  tmpdir.refresh();
+  const file = path.join(tmpdir.path, 'stdout.txt');
+  const fd = fs.openSync(file, 'w');
+  const child = spawnSync(process.execPath,
+                          ['--buffered-stdio', __filename, 'child'],
+                          { stdio: ['ignore', fd, 'ignore'] });
+  fs.closeSync(fd);
+  assert.strictEqual(child.status, 0);
+  check(fs.readFileSync(file, 'utf8'));
+}
@@ -0,0 +1,86 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const { Readable, parseJSON } = require('stream');
+
+async function collect(chunks, options) {
+  const values = [];
+  for await (const value of parseJSON(Readable.from(chunks), options))
+    values.push(value);
+  return values;
+}
+
+// Splits `text` into chunks of every size from 1 to 7 bytes, so that values,
+// strings, escape sequences and UTF-8 characters are split at every position.
+function* splits(text) {
+  const buffer = Buffer.from(text);
+  for (let size = 1; size <= 7; size++) {
+    const chunks = [];
+    for (let i = 0; i < buffer.length; i += size)
+      chunks.push(buffer.slice(i, i + size));
+    yield chunks;
+  }
+  yield [text];
+}
+
+const items = [
+  1, -2.5e3, 'a "quoted" string with \\ and ü', true, false, null,
+  [], {}, [1, [2, [3]]], { a: { b: ['c', { d: '}]' }] } },
+];
+
+(async () => {
+  // The elements of a top-level array.
+  for (const space of [0, 2]) {
+    const text = JSON.stringify(items, null, space);
+    for (const chunks of splits(text))
+      assert.deepStrictEqual(await collect(chunks), items);
+  }
+
+  // Values at a deeper path; keys are skipped, and only the member values of
+  // objects are emitted.
+  const response = { count: items.length, data: items, next: { page: 2 } };
+  for (const chunks of splits(JSON.stringify(response))) {
+    assert.deepStrictEqual(await collect(chunks, { depth: 2 }),
+                           [...items, 2]);
+  }
+
+  // Depth 0 yields a sequence of top-level values.
+  assert.deepStrictEqual(
+    await collect(['{"a":1} [2]\n"three" 4', ' null'], { depth: 0 }),
+    [{ a: 1 }, [2], 'three', 4, null]);
+  assert.deepStrictEqual(await collect(['12', '34'], { depth: 0 }), [1234]);
+  assert.deepStrictEqual(await collect([]), []);
+
+  // String chunks are accepted as well.
+  assert.deepStrictEqual(await collect(['[1,', '"ü"]']), [1, 'ü']);
+
+  // Values are yielded before the rest of the input has been read.
+  {
+    const readable = new Readable({ read() {} });
+    const iterator = parseJSON(readable)[Symbol.asyncIterator]();
+    readable.push('[{"first": true}, ');
+    assert.deepStrictEqual(await iterator.next(),
+                           { value: { first: true }, done: false });
+    readable.push('2]');
+    readable.push(null);
+    assert.deepStrictEqual(await iterator.next(), { value: 2, done: false });
+    assert.deepStrictEqual(await iterator.next(),
+                           { value: undefined, done: true });
+  }
+
+  for (const text of ['[1, {"a": tru}]', '[1}', '[1, 2', '["abc', '[1]]']) {
+    await assert.rejects(collect([text]), {
+      name: 'SyntaxError'
+    });
+  }
+
+  await assert.rejects(collect([{}]), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+})().then(common.mustCall());
+
+assert.throws(() => parseJSON({}), { code: 'ERR_INVALID_ARG_TYPE' });
+assert.throws(() => parseJSON(Readable.from([]), { depth: -1 }), {
+  code: 'ERR_OUT_OF_RANGE'
+});
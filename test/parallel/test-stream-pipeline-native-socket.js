@@ -0,0 +1,57 @@
+'use strict';
+
+// This tests that stream.pipeline() pipes a socket into another socket
+// natively, including data that has already been read in JS.
+
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+const { pipeline, PassThrough } = require('stream');
+
+const data = Buffer.alloc(4 * 1024 * 1024);
+for (let i = 0; i < data.length; i++)
+  data[i] = i % 251;
+
+const upstream = net.createServer(common.mustCall((socket) => {
+  const chunks = [];
+  socket.on('data', (chunk) => chunks.push(chunk));
+  socket.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(Buffer.concat(chunks), data);
+    socket.end();
+    upstream.close();
+  }));
+}));
+
+const proxy = net.createServer(common.mustCall((socket) => {
+  socket.once('readable', common.mustCall(() => {
+    // Some data has been buffered in JS before the pipe starts.
+    assert.ok(socket.readableLength > 0);
+    const target = net.connect(upstream.address().port);
+    target.on('connect', common.mustCall(() => {
+      pipeline(socket, target, common.mustCall((err) => {
+        assert.ifError(err);
+        proxy.close();
+      }));
+      assert.strictEqual(typeof socket._handle.pipeTarget, 'object');
+      assert.strictEqual(socket.readableLength, 0);
+    }));
+  }));
+}));
+
+upstream.listen(0, common.mustCall(() => {
+  proxy.listen(0, common.mustCall(() => {
+    const client = net.connect(proxy.address().port);
+    client.end(data);
+  }));
+}));
+
+{
+  // Streams that are not sockets are still piped in JS.
+  const source = new PassThrough();
+  const destination = new PassThrough();
+  pipeline(source, destination, common.mustCall((err) => {
+    assert.ifError(err);
+  }));
+  destination.resume();
+  source.end('data');
+}
@@ -0,0 +1,38 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const { Readable } = require('stream');
+
+// Test that 'data' events, which are emitted without going through emit()
+// when possible, still reach emit() when it has been replaced, and that
+// rejections of async listeners are still captured.
+
+{
+  const readable = new Readable({ read() {} });
+  const emit = readable.emit;
+  const chunks = [];
+  readable.emit = common.mustCallAtLeast(function(type, ...args) {
+    if (type === 'data')
+      chunks.push(...args);
+    return emit.call(this, type, ...args);
+  });
+  readable.on('data', common.mustCall(2));
+  readable.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(chunks.map(String), ['a', 'b']);
+  }));
+  readable.push('a');
+  readable.push('b');
+  readable.push(null);
+}
+
+{
+  const readable = new Readable({ read() {}, captureRejections: true });
+  const error = new Error('kaboom');
+  readable.on('data', common.mustCall(async () => { throw error; }));
+  readable.on('data', common.mustCall());
+  readable.on('error', common.mustCall((err) => {
+    assert.strictEqual(err, error);
+  }));
+  readable.push('a');
+}
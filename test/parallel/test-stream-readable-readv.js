@@ -0,0 +1,90 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const { Readable } = require('stream');
+
+{
+  // readv() returns all buffered objects at once.
+  const r = new Readable({ objectMode: true, read() {} });
+  assert.strictEqual(r.readv(), null);
+  r.push(1);
+  r.push({ a: 2 });
+  r.push('3');
+  assert.deepStrictEqual(r.readv(), [1, { a: 2 }, '3']);
+  assert.strictEqual(r.readableLength, 0);
+  assert.strictEqual(r.readv(), null);
+}
+
+{
+  // Buffers are not concatenated.
+  const r = new Readable({ read() {} });
+  const chunks = [Buffer.from('ab'), Buffer.from('cde')];
+  for (const chunk of chunks)
+    r.push(chunk);
+  const result = r.readv();
+  assert.strictEqual(result.length, 2);
+  assert.strictEqual(result[0], chunks[0]);
+  assert.strictEqual(result[1], chunks[1]);
+  assert.strictEqual(r.readableLength, 0);
+}
+
+{
+  // A 'data' event is emitted for each chunk, and 'end' once the stream is
+  // drained.
+  const r = new Readable({ objectMode: true, read() {} });
+  const seen = [];
+  r.on('data', (chunk) => seen.push(chunk));
+  r.pause();
+  r.push('a');
+  r.push('b');
+  r.push(null);
+  r.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(seen, ['a', 'b']);
+  }));
+  assert.deepStrictEqual(r.readv(), ['a', 'b']);
+  assert.strictEqual(r.readv(), null);
+}
+
+{
+  // In batch mode, the async iterator yields arrays of chunks.
+  const values = [];
+  for (let i = 0; i < 100; i++)
+    values.push(i);
+  const r = Readable.from(values);
+  (async () => {
+    const result = [];
+    for await (const chunks of r.iterator({ batch: true })) {
+      assert.ok(Array.isArray(chunks));
+      assert.ok(chunks.length > 0);
+      result.push(...chunks);
+    }
+    assert.deepStrictEqual(result, values);
+  })().then(common.mustCall());
+}
+
+{
+  // Without options, iterator() behaves like Symbol.asyncIterator.
+  const r = Readable.from(['a', 'b']);
+  (async () => {
+    const result = [];
+    for await (const chunk of r.iterator())
+      result.push(chunk);
+    assert.deepStrictEqual(result, ['a', 'b']);
+  })().then(common.mustCall());
+}
+
+{
+  // Errors reject the pending batch.
+  const r = new Readable({ objectMode: true, read() {} });
+  const iterator = r.iterator({ batch: true });
+  assert.rejects(iterator.next(), /kaboom/).then(common.mustCall());
+  r.destroy(new Error('kaboom'));
+}
+
+{
+  const r = new Readable({ read() {} });
+  assert.throws(() => r.iterator(null), { code: 'ERR_INVALID_ARG_TYPE' });
+  assert.throws(() => r.iterator({ batch: 1 }),
+                { code: 'ERR_INVALID_ARG_TYPE' });
+}
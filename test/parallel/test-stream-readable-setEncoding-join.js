@@ -0,0 +1,63 @@
+'use strict';
+// Readable streams with an encoding join the buffered chunks into one string
+// on read(). Check the result for one-byte and two-byte chunks of various
+// sizes, and multi-byte characters that are split between chunks.
+
+require('../common');
+const assert = require('assert');
+const { Readable } = require('stream');
+
+function readAll(chunks, encoding) {
+  const readable = new Readable({ read() {}, highWaterMark: 1 << 30 });
+  readable.setEncoding(encoding);
+  for (const chunk of chunks)
+    readable.push(chunk);
+  return readable.read();
+}
+
+function split(buf, sizes) {
+  const chunks = [];
+  let offset = 0;
+  for (let i = 0; offset < buf.length; i++) {
+    const size = sizes[i % sizes.length];
+    chunks.push(buf.slice(offset, offset + size));
+    offset += size;
+  }
+  return chunks;
+}
+
+const texts = [
+  'a'.repeat(100),
+  'abc'.repeat(1000),
+  'ä'.repeat(1000),
+  `${'x'.repeat(2000)}€${'y'.repeat(2000)}`,
+  '𝌆🙂'.repeat(500),
+];
+
+for (const text of texts) {
+  const data = Buffer.from(text);
+  for (const sizes of [[1], [3, 5], [7, 1000], [4096]]) {
+    const chunks = split(data, sizes);
+    assert.strictEqual(readAll(chunks, 'utf8'), text);
+    assert.strictEqual(readAll(chunks, 'latin1'), data.toString('latin1'));
+    assert.strictEqual(readAll(chunks, 'hex'), data.toString('hex'));
+  }
+}
+
+// Results that are long enough to be external strings.
+for (const text of ['z'.repeat(1 << 20), 'ж'.repeat(1 << 20)]) {
+  const data = Buffer.from(text);
+  assert.strictEqual(readAll(split(data, [65536]), 'utf8'), text);
+}
+
+// Reading part of the buffered data and then the rest.
+{
+  const readable = new Readable({ read() {} });
+  readable.setEncoding('utf8');
+  const text = 'Ünïcödé '.repeat(300);
+  for (const chunk of split(Buffer.from(text), [13]))
+    readable.push(chunk);
+  const head = readable.read(5);
+  assert.strictEqual(head, text.slice(0, 5));
+  assert.strictEqual(readable.read(), text.slice(5));
+}
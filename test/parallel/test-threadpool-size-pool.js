@@ -0,0 +1,38 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// Work on a pool configured with UV_THREADPOOL_SIZE_<POOL> does not occupy
+// the threads of the default pool.
+
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+
+if (process.argv[2] === 'child') {
+  const crypto = require('crypto');
+  const fs = require('fs');
+
+  let hashed = false;
+  // Slow enough that a stat sharing its only thread would have to wait.
+  crypto.scrypt('password', 'salt', 64, { N: 2 ** 16, maxmem: 2 ** 27 },
+                common.mustCall((err) => {
+                  assert.ifError(err);
+                  hashed = true;
+                }));
+  fs.stat(__filename, common.mustCall((err) => {
+    assert.ifError(err);
+    assert.strictEqual(hashed, false);
+  }));
+  return;
+}
+
+const child = spawnSync(process.execPath, [__filename, 'child'], {
+  env: {
+    ...process.env,
+    UV_THREADPOOL_SIZE: '1',
+    UV_THREADPOOL_SIZE_CRYPTO: '1'
+  }
+});
+assert.strictEqual(child.stderr.toString(), '');
+assert.strictEqual(child.status, 0);
@@ -0,0 +1,51 @@
+// Flags: --expose-internals
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { promisify } = require('util');
+const { setCoarseTimeout } = require('timers');
+const { timerListMap } = require('internal/timers');
+
+// Short delays are not changed, and arguments are passed to the callback.
+{
+  const timeout = setCoarseTimeout(common.mustCall((a, b) => {
+    assert.strictEqual(a, 'a');
+    assert.strictEqual(b, 'b');
+  }), 10, 'a', 'b');
+  assert.strictEqual(timeout._idleTimeout, 10);
+}
+
+// Longer delays are rounded up, and timers with similar delays share lists.
+{
+  const before = Object.keys(timerListMap).length;
+  const timeouts = [];
+  for (let delay = 29500; delay < 30500; delay++)
+    timeouts.push(setCoarseTimeout(common.mustNotCall(), delay));
+  assert.strictEqual(Object.keys(timerListMap).length, before + 3);
+  for (const timeout of timeouts) {
+    assert.strictEqual(timeout._idleTimeout % 512, 0);
+    assert.ok(timeout._idleTimeout >= 29500);
+    assert.ok(timeout._idleTimeout < 29500 * (1 + 1 / 32) + 1000);
+    // The rounded delay is kept.
+    timeout.refresh();
+    assert.strictEqual(timeout._idleTimeout % 512, 0);
+    clearTimeout(timeout);
+  }
+}
+
+// The delay never exceeds the maximum.
+{
+  const timeout = setCoarseTimeout(common.mustNotCall(), 2 ** 31 - 1);
+  assert.strictEqual(timeout._idleTimeout, 2 ** 31 - 1);
+  clearTimeout(timeout);
+}
+
+promisify(setCoarseTimeout)(5, 'value').then(common.mustCall((value) => {
+  assert.strictEqual(value, 'value');
+}));
+
+[null, 'a', {}].forEach((callback) => {
+  assert.throws(() => setCoarseTimeout(callback, 10), {
+    code: 'ERR_INVALID_CALLBACK'
+  });
+});
@@ -0,0 +1,49 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto) common.skip('missing crypto');
+const fixtures = require('../common/fixtures');
+
+// Clear text is decrypted straight into buffers sized to the TLS record.
+// Check that records of all sizes, including full and split ones, arrive
+// intact and that no chunk exceeds the maximum record size.
+
+const assert = require('assert');
+const tls = require('tls');
+
+const sizes = [1, 100, 16383, 16384, 16385, 20000, 70000, 1];
+const total = sizes.reduce((a, b) => a + b, 0);
+const expected = Buffer.alloc(total);
+for (let i = 0; i < total; i++)
+  expected[i] = i % 251;
+
+for (const maxVersion of ['TLSv1.2', 'TLSv1.3']) {
+  const server = tls.createServer({
+    key: fixtures.readKey('agent1-key.pem'),
+    cert: fixtures.readKey('agent1-cert.pem'),
+    maxVersion,
+  }, common.mustCall((socket) => {
+    let offset = 0;
+    for (const size of sizes) {
+      socket.write(expected.slice(offset, offset + size));
+      offset += size;
+    }
+    socket.end();
+  }));
+
+  server.listen(0, common.mustCall(() => {
+    const client = tls.connect({
+      port: server.address().port,
+      rejectUnauthorized: false,
+    });
+
+    const chunks = [];
+    client.on('data', (chunk) => {
+      assert(chunk.length > 0 && chunk.length <= 16384);
+      chunks.push(chunk);
+    });
+    client.on('end', common.mustCall(() => {
+      assert.deepStrictEqual(Buffer.concat(chunks), expected);
+      server.close();
+    }));
+  }));
+}
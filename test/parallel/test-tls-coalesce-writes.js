@@ -0,0 +1,55 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// With `coalesceWrites`, the writes of one tick are encrypted together into a
+// single record.
+
+const assert = require('assert');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+
+for (const value of [1, 'yes', null]) {
+  assert.throws(() => new tls.TLSSocket(null, { coalesceWrites: value }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+
+const server = tls.createServer({
+  key: fixtures.readKey('agent1-key.pem'),
+  cert: fixtures.readKey('agent1-cert.pem'),
+  coalesceWrites: true
+}, common.mustCall((socket) => {
+  for (let i = 0; i < 100; i++)
+    socket.write('0123456789');
+  assert.strictEqual(socket.writableCorked, 1);
+  process.nextTick(common.mustCall(() => {
+    assert.strictEqual(socket.writableCorked, 0);
+  }));
+
+  // A socket that was corked by the user stays corked.
+  setImmediate(common.mustCall(() => {
+    socket.cork();
+    socket.write('!');
+    setImmediate(common.mustCall(() => {
+      assert.strictEqual(socket.writableCorked, 1);
+      socket.uncork();
+      socket.end();
+    }));
+  }));
+}));
+
+server.listen(0, common.mustCall(() => {
+  const socket = tls.connect({
+    port: server.address().port,
+    rejectUnauthorized: false
+  });
+  const chunks = [];
+  socket.setEncoding('utf8');
+  socket.on('data', (chunk) => chunks.push(chunk));
+  socket.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(chunks, ['0123456789'.repeat(100), '!']);
+    server.close();
+  }));
+}));
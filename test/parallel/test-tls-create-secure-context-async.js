@@ -0,0 +1,86 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// tls.createSecureContext() with a callback parses the credentials on the
+// threadpool and produces a context that works like a synchronous one.
+
+const assert = require('assert');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+
+const key = fixtures.readKey('agent1-key.pem');
+const cert = fixtures.readKey('agent1-cert.pem');
+const ca = fixtures.readKey('ca1-cert.pem');
+
+assert.throws(() => tls.createSecureContext({}, 'not a function'), {
+  code: 'ERR_INVALID_CALLBACK'
+});
+
+// Type errors of the credentials are thrown synchronously.
+for (const options of [{ ca: 1 }, { cert: true }, { key: [{ pem: 1 }] }]) {
+  assert.throws(() => tls.createSecureContext(options, common.mustNotCall()), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+assert.throws(() => {
+  tls.createSecureContext({ key, passphrase: 1 }, common.mustNotCall());
+}, {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+
+// Parse errors, and keys that do not match the certificate, are reported
+// the same as by the synchronous version.
+for (const options of [
+  { key: 'not a key' },
+  { cert: 'not a cert' },
+  { key: fixtures.readKey('agent2-key.pem'), cert },
+]) {
+  let expected;
+  try {
+    tls.createSecureContext(options);
+  } catch (err) {
+    expected = err;
+  }
+  assert(expected);
+  tls.createSecureContext(options, common.mustCall((err, context) => {
+    assert(err instanceof Error);
+    assert.strictEqual(err.message, expected.message);
+    assert.strictEqual(context, undefined);
+  }));
+}
+
+// Errors of the other options are passed to the callback as well.
+tls.createSecureContext({ key, cert, ciphers: 1 }, common.mustCall((err) => {
+  assert.strictEqual(err.code, 'ERR_INVALID_ARG_TYPE');
+}));
+
+assert.strictEqual(tls.createSecureContext({ key, cert, ca }, common.mustCall(
+  (err, secureContext) => {
+    assert.ifError(err);
+    assert(secureContext instanceof tls.SecureContext);
+
+    const server = tls.createServer({ secureContext }, (socket) => {
+      socket.end('hello');
+    });
+    server.listen(0, common.mustCall(() => {
+      tls.createSecureContext({ ca }, common.mustCall((err, clientContext) => {
+        assert.ifError(err);
+        const socket = tls.connect({
+          port: server.address().port,
+          servername: 'agent1',
+          secureContext: clientContext
+        }, common.mustCall(() => {
+          assert.strictEqual(socket.authorized, true);
+        }));
+        let data = '';
+        socket.setEncoding('utf8');
+        socket.on('data', (chunk) => data += chunk);
+        socket.on('end', common.mustCall(() => {
+          assert.strictEqual(data, 'hello');
+          server.close();
+        }));
+      }));
+    }));
+  })), undefined);
@@ -0,0 +1,57 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// With `dynamicRecordSize`, the first bytes of a connection are sent in
+// records that fit into a single TCP segment, later ones in full records.
+
+const assert = require('assert');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+
+const kSmallRecordSize = 1369;
+const kSmallBytes = 10 * 4000;
+const kLargeBytes = 64 * 1024;
+
+for (const value of [1, 'yes', null]) {
+  assert.throws(() => new tls.TLSSocket(null, { dynamicRecordSize: value }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+
+const server = tls.createServer({
+  key: fixtures.readKey('agent1-key.pem'),
+  cert: fixtures.readKey('agent1-cert.pem'),
+  dynamicRecordSize: true
+}, common.mustCall((socket) => {
+  // Each write is passed to SSL_write() on its own, as none of them is
+  // written before the previous one completed.
+  (function writeSmall(i) {
+    if (i === kSmallBytes / 4000)
+      return socket.end(Buffer.alloc(kLargeBytes, 'b'));
+    socket.write(Buffer.alloc(4000, 'a'), () => writeSmall(i + 1));
+  })(0);
+}));
+
+server.listen(0, common.mustCall(() => {
+  const socket = tls.connect({
+    port: server.address().port,
+    rejectUnauthorized: false
+  });
+  let received = 0;
+  let largest = 0;
+  socket.on('data', (chunk) => {
+    // A chunk never spans records.
+    if (received + chunk.length <= kSmallBytes)
+      assert(chunk.length <= kSmallRecordSize, `${chunk.length}`);
+    else
+      largest = Math.max(largest, chunk.length);
+    received += chunk.length;
+  });
+  socket.on('end', common.mustCall(() => {
+    assert.strictEqual(received, kSmallBytes + kLargeBytes);
+    assert(largest > kSmallRecordSize, `${largest}`);
+    server.close();
+  }));
+}));
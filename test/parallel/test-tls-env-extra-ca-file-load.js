@@ -14,9 +14,12 @@ const binding = internalBinding('crypto');
 
 const { fork } = require('child_process');
 
-// This test ensures that extra certificates are loaded at startup.
+// This test ensures that extra certificates are loaded when the root
+// certificates are first used, and not before.
 if (process.argv[2] !== 'child') {
   if (process.env.CHILD_USE_EXTRA_CA_CERTS === 'yes') {
+    assert.strictEqual(binding.isExtraRootCertsFileLoaded(), false);
+    tls.createServer({});
     assert.strictEqual(binding.isExtraRootCertsFileLoaded(), true);
   } else if (process.env.CHILD_USE_EXTRA_CA_CERTS === 'no') {
     assert.strictEqual(binding.isExtraRootCertsFileLoaded(), false);
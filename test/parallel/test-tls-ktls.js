@@ -0,0 +1,61 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto) common.skip('missing crypto');
+const fixtures = require('../common/fixtures');
+
+// Test the ktls: option for TLS. Whether or not the kernel takes over the
+// encryption of outgoing records, data has to make it through unharmed and
+// the connection has to shut down cleanly.
+
+const assert = require('assert');
+const tls = require('tls');
+
+[1, 'yes', null].forEach((ktls) => {
+  assert.throws(() => new tls.TLSSocket(null, { ktls }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+});
+
+const payload = Buffer.alloc(256 * 1024, 'abcdefghij');
+
+function test(ciphers) {
+  const server = tls.createServer({
+    key: fixtures.readKey('agent1-key.pem'),
+    cert: fixtures.readKey('agent1-cert.pem'),
+    maxVersion: 'TLSv1.2',
+    ciphers,
+    ktls: true,
+  }, common.mustCall((socket) => {
+    assert.strictEqual(socket.isKTLSEnabled(), false);
+    let received = 0;
+    socket.on('data', (chunk) => {
+      assert(chunk.equals(payload.slice(received, received + chunk.length)));
+      received += chunk.length;
+      if (received === payload.length) {
+        socket.end(payload);
+        assert.strictEqual(typeof socket.isKTLSEnabled(), 'boolean');
+      }
+    });
+  }));
+
+  server.listen(0, common.mustCall(() => {
+    const client = tls.connect({
+      port: server.address().port,
+      rejectUnauthorized: false,
+      ktls: true,
+    }, common.mustCall(() => {
+      assert.strictEqual(client.getCipher().name, ciphers);
+      client.write(payload);
+    }));
+
+    const chunks = [];
+    client.on('data', (chunk) => chunks.push(chunk));
+    client.on('end', common.mustCall(() => {
+      assert.deepStrictEqual(Buffer.concat(chunks), payload);
+      server.close();
+    }));
+  }));
+}
+
+test('ECDHE-RSA-AES128-GCM-SHA256');
+test('ECDHE-RSA-AES256-GCM-SHA384');
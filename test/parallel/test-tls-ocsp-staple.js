@@ -0,0 +1,60 @@
+'use strict';
+const common = require('../common');
+
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// Test that the response of the OCSPStapleCallback is stapled to the
+// handshakes that request certificate status, without an 'OCSPRequest'
+// listener, and that it is fetched again when the context changes.
+
+const assert = require('assert');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+
+const options = {
+  key: fixtures.readKey('agent3-key.pem'),
+  cert: fixtures.readKey('agent3-cert.pem')
+};
+const ocspResponse = fixtures.readKey('agent3-ocsp-response.der');
+
+assert.throws(() => tls.createServer({ ...options, OCSPStapleCallback: 42 }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+
+const responses = [ocspResponse, null];
+const server = tls.createServer({
+  ...options,
+  OCSPStapleCallback: common.mustCall((cert, issuer, callback) => {
+    assert.ok(Buffer.isBuffer(cert));
+    // agent3 is not self-signed, and its issuer is not in the context.
+    assert.strictEqual(issuer, null);
+    setImmediate(callback, null, responses.shift());
+  }, 2)
+}, (socket) => socket.end());
+
+function connect() {
+  return new Promise((resolve) => {
+    const socket = tls.connect({
+      port: server.address().port,
+      requestOCSP: true,
+      rejectUnauthorized: false
+    });
+    let response;
+    socket.on('OCSPResponse', common.mustCall((resp) => response = resp));
+    socket.on('close', () => resolve(response));
+    socket.resume();
+  });
+}
+
+server.listen(0, common.mustCall(async () => {
+  await new Promise(setImmediate);
+  assert.deepStrictEqual(await connect(), ocspResponse);
+  assert.deepStrictEqual(await connect(), ocspResponse);
+
+  // Replacing the context fetches a response for it, the callback removes it.
+  server.setSecureContext(options);
+  await new Promise(setImmediate);
+  assert.strictEqual(await connect(), null);
+  server.close();
+}));
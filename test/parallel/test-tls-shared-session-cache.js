@@ -0,0 +1,110 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// Servers that name the same `sharedSessionCache` resume each other's
+// sessions, also across Worker threads, without any JS session handlers.
+
+const assert = require('assert');
+const tls = require('tls');
+const { SSL_OP_NO_TICKET } = require('crypto').constants;
+const { Worker, isMainThread, parentPort } = require('worker_threads');
+const fixtures = require('../common/fixtures');
+
+function createServer(sharedSessionCache) {
+  return tls.createServer({
+    key: fixtures.readKey('agent1-key.pem'),
+    cert: fixtures.readKey('agent1-cert.pem'),
+    maxVersion: 'TLSv1.2',
+    secureOptions: SSL_OP_NO_TICKET,
+    sessionIdContext: 'test-tls-shared-session-cache',
+    sharedSessionCache
+  }, (socket) => socket.end());
+}
+
+if (!isMainThread) {
+  const server = createServer('shared');
+  server.listen(0, () => parentPort.postMessage(server.address().port));
+  parentPort.once('message', () => server.close());
+  return;
+}
+
+function connect(port, session, cb) {
+  let newSession;
+  const socket = tls.connect({
+    port,
+    session,
+    rejectUnauthorized: false
+  }, common.mustCall(() => {
+    const reused = socket.isSessionReused();
+    socket.on('close', common.mustCall(() => cb(reused, newSession)));
+  }));
+  socket.on('session', (sess) => newSession = sess);
+  socket.resume();
+}
+
+for (const value of [1, {}, null]) {
+  assert.throws(() => createServer(value), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+for (const value of [0, -1, 1.5, 2 ** 32]) {
+  assert.throws(() => tls.createServer({ sharedSessionCache: 'x',
+                                         sharedSessionCacheSize: value }), {
+    code: 'ERR_OUT_OF_RANGE'
+  });
+}
+
+const first = createServer('shared');
+const second = createServer('shared');
+const other = createServer('other');
+
+first.listen(0, common.mustCall(() => {
+  second.listen(0, common.mustCall(() => {
+    other.listen(0, common.mustCall(() => {
+      connect(first.address().port, undefined, common.mustCall(step1));
+    }));
+  }));
+}));
+
+function step1(reused, session) {
+  assert.strictEqual(reused, false);
+  assert(session);
+  // A different server with the same cache knows the session.
+  connect(second.address().port, session, common.mustCall((reused) => {
+    assert.strictEqual(reused, true);
+    step2(session);
+  }));
+}
+
+function step2(session) {
+  // A server using another cache does not.
+  connect(other.address().port, session, common.mustCall((reused) => {
+    assert.strictEqual(reused, false);
+    step3(session);
+  }));
+}
+
+function resumeInWorker(session, cb) {
+  const worker = new Worker(__filename);
+  worker.once('message', common.mustCall((port) => {
+    connect(port, session, common.mustCall((reused) => {
+      assert.strictEqual(reused, true);
+      worker.postMessage('close');
+      worker.once('exit', common.mustCall(cb));
+    }));
+  }));
+}
+
+function step3(session) {
+  // A server in a Worker thread shares the cache too, and the session is
+  // still there after that Worker has exited.
+  resumeInWorker(session, common.mustCall(() => {
+    resumeInWorker(session, common.mustCall(() => {
+      first.close();
+      second.close();
+      other.close();
+    }));
+  }));
+}
@@ -0,0 +1,73 @@
+'use strict';
+
+// Contexts that are added with server.addContext() are selected natively,
+// with the same matching and order as the default SNICallback. A custom
+// SNICallback is only called for SNI names that none of them match.
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+
+function loadContext(name) {
+  return {
+    key: fixtures.readKey(`${name}-key.pem`),
+    cert: fixtures.readKey(`${name}-cert.pem`)
+  };
+}
+
+const server = tls.createServer({
+  ...loadContext('agent2'),
+  SNICallback: common.mustCall((servername, callback) => {
+    if (servername === 'dynamic.example.net')
+      callback(null, tls.createSecureContext(loadContext('agent1')));
+    else
+      callback(null, undefined);
+  }, 3)
+});
+
+server.addContext('a.example.com', loadContext('agent1'));
+server.addContext('*.test.com', loadContext('agent3'));
+server.addContext('x*y.example.org', loadContext('agent1'));
+server.addContext('*.example.com', loadContext('agent3'));
+server.addContext('b.example.com', loadContext('agent1'));
+// The contexts are kept when the context of the server is replaced.
+server.setSecureContext(loadContext('agent2'));
+
+const tests = [
+  ['a.example.com', 'agent1'],
+  ['b.test.com', 'agent3'],
+  ['a.b.test.com', 'agent2'],
+  ['xzzy.example.org', 'agent1'],
+  ['x.y.example.org', 'agent2'],
+  // The context that was added first wins.
+  ['b.example.com', 'agent3'],
+  ['dynamic.example.net', 'agent1'],
+];
+
+server.listen(0, common.mustCall(() => {
+  function next() {
+    const test = tests.shift();
+    if (test === undefined)
+      return server.close();
+    const [servername, expected] = test;
+    const client = tls.connect({
+      port: server.address().port,
+      servername,
+      rejectUnauthorized: false
+    }, common.mustCall(() => {
+      assert.strictEqual(client.getPeerCertificate().subject.CN, expected,
+                         servername);
+      client.end();
+    }));
+    client.on('close', common.mustCall(next));
+  }
+  next();
+}));
+
+server.on('secureConnection', common.mustCall((socket) => {
+  assert.strictEqual(typeof socket.servername, 'string');
+}, tests.length));
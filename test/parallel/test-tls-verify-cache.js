@@ -0,0 +1,65 @@
+// Flags: --expose-internals --tls-verify-cache-ttl=60000
+'use strict';
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+const { internalBinding } = require('internal/test/binding');
+const { getVerifiedChainCacheStats } = internalBinding('crypto');
+
+// Test that verified certificate chains are reused, and that a chain is
+// verified again once the CRLs of the context change.
+
+const serverOptions = {
+  key: fixtures.readKey('agent3-key.pem'),
+  cert: fixtures.readKey('agent3-cert.pem'),
+  ca: fixtures.readKey('ca2-cert.pem'),
+  requestCert: true,
+  rejectUnauthorized: false
+};
+
+const authorizations = [];
+const server = tls.createServer(serverOptions, (socket) => {
+  authorizations.push(socket.authorized || socket.authorizationError);
+  socket.end();
+});
+
+function connect() {
+  return new Promise((resolve) => {
+    const socket = tls.connect({
+      port: server.address().port,
+      key: fixtures.readKey('agent4-key.pem'),
+      cert: fixtures.readKey('agent4-cert.pem'),
+      ca: fixtures.readKey('ca2-cert.pem'),
+      checkServerIdentity: () => {}
+    }, common.mustCall(() => {
+      assert.strictEqual(socket.authorized, true);
+      socket.on('end', resolve);
+      socket.resume();
+    }));
+  });
+}
+
+server.listen(0, common.mustCall(async () => {
+  const [hits] = getVerifiedChainCacheStats();
+  await connect();
+  assert.strictEqual(getVerifiedChainCacheStats()[0], hits);
+
+  // Both the client and the server chain are found in the cache.
+  await connect();
+  assert.strictEqual(getVerifiedChainCacheStats()[0], hits + 2);
+
+  // agent4 is revoked by the CRL of ca2.
+  server.setSecureContext({
+    ...serverOptions,
+    crl: fixtures.readKey('ca2-crl.pem')
+  });
+  await connect();
+
+  assert.deepStrictEqual(authorizations, [true, true, 'CERT_REVOKED']);
+  server.close();
+}));
@@ -0,0 +1,38 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+
+// Test that --trace-bootstrap-modules prints the modules that are loaded
+// before user code runs, and that the ESM loader is not one of them.
+
+function trace(...args) {
+  const child = spawnSync(process.execPath,
+                          ['--trace-bootstrap-modules', ...args]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  const lines = child.stderr.toString().split('\n');
+  assert.match(lines[0],
+               /^\(node:\d+\) Modules loaded before user code, \d+ compiled in \d+\.\d{3} ms:$/);
+  return lines.slice(1).filter((line) => line !== '');
+}
+
+{
+  const modules = trace('-e', '0');
+  for (const line of modules)
+    assert.match(line, /^ {2}(Internal Binding \w+|NativeModule \S+( \d+\.\d{3} ms| \(snapshot\))?)$/);
+  assert(modules.some((line) =>
+    /^ {2}NativeModule internal\/modules\/cjs\/loader /.test(line)));
+  for (const lazy of ['internal/process/esm_loader',
+                      'internal/inspector_async_hook']) {
+    assert(!modules.some((line) => line.includes(lazy)), lazy);
+  }
+}
+
+{
+  // Modules that are loaded after user code has started are not reported.
+  const child = spawnSync(process.execPath, [
+    '--trace-bootstrap-modules', '-e', 'import("fs").then(() => {})'
+  ]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert(!child.stderr.toString().includes('internal/process/esm_loader'));
+}
@@ -0,0 +1,62 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+const { convert } = require('../../tools/binary-trace-to-json');
+
+// Test that --trace-event-format=binary records the same trace events as the
+// JSON format, once converted back to JSON.
+
+const CODE = `
+  const { performance } = require('perf_hooks');
+  performance.mark('A');
+  performance.mark('B');
+  performance.measure('A to B', 'A', 'B');
+  setTimeout(() => {}, 1);
+`;
+
+tmpdir.refresh();
+
+function trace(format) {
+  const file = path.join(tmpdir.path, `${format}.log`);
+  const child = cp.spawnSync(process.execPath, [
+    '--trace-event-categories', 'node.perf,node.async_hooks',
+    '--trace-event-file-pattern', file,
+    `--trace-event-format=${format}`,
+    '-e', CODE
+  ], { cwd: tmpdir.path });
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  return fs.readFileSync(file);
+}
+
+// Timing and metadata differ between runs, but the kinds of events should not.
+function getEventNames({ traceEvents }) {
+  return new Set(traceEvents.filter(({ ph }) => ph !== 'M')
+                            .map(({ cat, name }) => `${cat}:${name}`));
+}
+
+const json = JSON.parse(trace('json').toString());
+const binary = trace('binary');
+assert.strictEqual(binary.toString('latin1', 0, 8), 'NODETRC1');
+const converted = convert(binary);
+
+assert(converted.traceEvents.length > 0);
+for (const event of converted.traceEvents) {
+  for (const key of ['pid', 'tid', 'ts', 'tts', 'dur', 'tdur'])
+    assert(Number.isSafeInteger(event[key]), `${key} of ${event.name}`);
+}
+const marks = converted.traceEvents.filter(({ ph }) => ph === 'R');
+assert.deepStrictEqual(marks.map(({ name }) => name), ['A', 'B']);
+
+assert.deepStrictEqual(getEventNames(converted), getEventNames(json));
+
+{
+  const child = cp.spawnSync(process.execPath,
+                             ['--trace-event-format=xml', '-p', '42']);
+  assert.strictEqual(child.status, 9);
+  assert.match(child.stderr.toString(),
+               /invalid value for --trace-event-format/);
+}
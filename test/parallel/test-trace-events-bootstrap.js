@@ -15,6 +15,17 @@ const names = [
   'bootstrapComplete'
 ];
 
+const phases = [
+  'optionParsing',
+  'icuInit',
+  'v8PlatformInit',
+  'opensslInit',
+  'bootstrapLoaders',
+  'bootstrapNode',
+  'preExecution',
+  'runMain'
+];
+
 if (process.argv[2] === 'child') {
   1 + 1;
 } else {
@@ -38,8 +49,13 @@ if (process.argv[2] === 'child') {
         .filter((trace) => trace.cat !== '__metadata');
       traces.forEach((trace) => {
         assert.strictEqual(trace.pid, proc.pid);
-        assert(names.includes(trace.name));
+        assert(names.includes(trace.name) ||
+               phases.includes(trace.name) ||
+               trace.name === 'ExecuteBootstrapper', trace.name);
       });
+      const traced = new Set(traces.map((trace) => trace.name));
+      for (const name of ['optionParsing', 'v8PlatformInit', 'runMain'])
+        assert(traced.has(name), name);
     }));
   }));
 }
@@ -0,0 +1,42 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+// Test that --trace-event-flight-recorder keeps trace events in memory, and
+// only writes them when a diagnostic report is generated.
+
+common.skipIfReportDisabled();
+
+tmpdir.refresh();
+
+function trace(name, code) {
+  const file = path.join(tmpdir.path, `${name}.log`);
+  const child = cp.spawnSync(process.execPath, [
+    '--trace-event-categories', 'node.perf',
+    '--trace-event-file-pattern', file,
+    '--trace-event-flight-recorder',
+    '-e', `
+      const { performance } = require('perf_hooks');
+      performance.mark('A');
+      performance.mark('B');
+      ${code}
+    `
+  ], { cwd: tmpdir.path });
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  if (!fs.existsSync(file))
+    return [];
+  return JSON.parse(fs.readFileSync(file).toString()).traceEvents
+    .filter(({ ph }) => ph !== 'M');
+}
+
+assert.deepStrictEqual(trace('no-report', ''), []);
+
+const events = trace('report', `
+  process.report.writeReport(${JSON.stringify(
+    path.join(tmpdir.path, 'report.json'))});
+`);
+assert.deepStrictEqual(events.map(({ name }) => name), ['A', 'B']);
@@ -456,6 +456,26 @@ assert.strictEqual(
     'foobar'
 );
 
+assert.strictEqual(
+  util.format('%s:', 'a', true, undefined, Symbol('s'), -0, 5n, null, NaN),
+  'a: true undefined Symbol(s) -0 5n null NaN'
+);
+assert.strictEqual(
+  util.formatWithOptions({ colors: false }, 1, null),
+  '1 null'
+);
+assert.strictEqual(
+  util.formatWithOptions({ stylize: (str, type) => `<${type}>` }, 1, null),
+  '<number> <null>'
+);
+{
+  util.inspect.defaultOptions.colors = true;
+  assert.strictEqual(util.format(1, true), '\u001b[33m1\u001b[39m ' +
+                                           '\u001b[33mtrue\u001b[39m');
+  assert.strictEqual(util.formatWithOptions({ colors: false }, 1), '1');
+  util.inspect.defaultOptions.colors = false;
+}
+
 assert.strictEqual(
   util.format(new SharedArrayBuffer(4)),
   'SharedArrayBuffer { [Uint8Contents]: <00 00 00 00>, byteLength: 4 }'
@@ -0,0 +1,64 @@
+'use strict';
+
+// With NODE_V8_COVERAGE_INTERVAL, coverage is also written in numbered chunks
+// while the process runs, and the counts of all files add up to the total.
+// With NODE_V8_COVERAGE_BINARY, the counts are only 0 or 1.
+
+const common = require('../common');
+common.skipIfInspectorDisabled();
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { spawnSync } = require('child_process');
+const fixtures = require('../common/fixtures');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+let dirc = 0;
+
+// Returns the counts of tick() in the fixture from every coverage file.
+function collectTicks(extraEnv) {
+  const coverageDirectory = path.join(tmpdir.path, `cov_${++dirc}`);
+  const output = spawnSync(process.execPath, [
+    fixtures.path('v8-coverage', 'interval.js')
+  ], {
+    env: {
+      ...process.env,
+      NODE_V8_COVERAGE: coverageDirectory,
+      NODE_V8_COVERAGE_INTERVAL: '5',
+      ...extraEnv
+    }
+  });
+  assert.strictEqual(output.status, 0, output.stderr.toString());
+  assert.strictEqual(output.stderr.toString(), '');
+
+  const files = fs.readdirSync(coverageDirectory);
+  assert(files.some((file) => /^coverage-[\d-]+\.json$/.test(file)), files);
+  assert(files.some((file) => /^coverage-[\d-]+\.1\.json$/.test(file)), files);
+  const counts = [];
+  for (const file of files) {
+    assert.match(file, /^coverage-[\d-]+(\.\d+)?\.json$/);
+    const coverage = JSON.parse(
+      fs.readFileSync(path.join(coverageDirectory, file), 'utf8'));
+    for (const script of coverage.result) {
+      if (!script.url.endsWith('/interval.js'))
+        continue;
+      for (const fn of script.functions) {
+        if (fn.functionName === 'tick')
+          counts.push(fn.ranges[0].count);
+      }
+    }
+  }
+  return counts;
+}
+
+{
+  const counts = collectTicks({});
+  assert.strictEqual(counts.reduce((sum, count) => sum + count, 0), 10);
+}
+
+{
+  const counts = collectTicks({ NODE_V8_COVERAGE_BINARY: '1' });
+  assert(counts.every((count) => count === 0 || count === 1), counts);
+  assert(counts.includes(1), counts);
+}
@@ -0,0 +1,36 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+
+// Test that V8 background tasks, which are posted from several Isolates at
+// once and partly from the platform's own worker threads, all get to run,
+// both with and without binding the platform threads to CPUs.
+
+if (process.argv[2] === 'child') {
+  const { Worker } = require('worker_threads');
+  const source = `
+    const retained = [];
+    for (let i = 0; i < 200; i++) {
+      retained.push(new Array(10000).fill({ i }));
+      if (retained.length > 20) retained.shift();
+      if (i % 50 === 0) eval(\`(function f\${i}() { return \${i}; })()\`);
+    }
+  `;
+  for (let i = 0; i < 4; i++)
+    new Worker(source, { eval: true }).on('exit', common.mustCall());
+  eval(source);
+  return;
+}
+
+for (const flags of [[], ['--v8-pool-affinity']]) {
+  const child = spawnSync(process.execPath, [
+    ...flags,
+    '--v8-pool-size=3',
+    '--concurrent-marking',
+    '--parallel-scavenge',
+    __filename,
+    'child',
+  ]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+}
@@ -0,0 +1,99 @@
+'use strict';
+
+require('../common');
+const assert = require('assert');
+const v8 = require('v8');
+
+const values = [
+  undefined,
+  null,
+  42,
+  'a string',
+  'a string with ünicode',
+  { a: 1, b: [2, 3] },
+  [1, 2, 3],
+  new Map([[1, 2]]),
+  Buffer.from('buffer'),
+  new Float64Array([1.5, 2.5]),
+  new Date(0),
+  /regexp/g,
+  { big: 'x'.repeat(100000) },
+];
+
+{
+  const buffer = v8.serializeMany(values);
+  assert.ok(Buffer.isBuffer(buffer));
+
+  // Every value is framed by its length and serialized as v8.serialize()
+  // does it.
+  let offset = 0;
+  for (const value of values) {
+    const length = buffer.readUInt32BE(offset);
+    offset += 4;
+    assert.deepStrictEqual(buffer.slice(offset, offset + length),
+                           v8.serialize(value));
+    offset += length;
+  }
+  assert.strictEqual(offset, buffer.length);
+
+  assert.deepStrictEqual([...v8.deserializeMany(buffer)], values);
+}
+
+{
+  // Values are read lazily.
+  const buffer = v8.serializeMany([1, 2, 3]);
+  const iterator = v8.deserializeMany(buffer);
+  assert.deepStrictEqual(iterator.next(), { value: 1, done: false });
+  assert.deepStrictEqual(iterator.next(), { value: 2, done: false });
+  assert.deepStrictEqual(iterator.next(), { value: 3, done: false });
+  assert.deepStrictEqual(iterator.next(), { value: undefined, done: true });
+}
+
+{
+  // Objects are not shared between values.
+  const shared = { x: 1 };
+  const [a, b] = v8.deserializeMany(v8.serializeMany([shared, shared]));
+  assert.deepStrictEqual(a, shared);
+  assert.deepStrictEqual(b, shared);
+  assert.notStrictEqual(a, b);
+}
+
+{
+  assert.strictEqual(v8.serializeMany([]).length, 0);
+  assert.deepStrictEqual([...v8.deserializeMany(Buffer.alloc(0))], []);
+
+  // Other views of the same bytes work too.
+  const buffer = v8.serializeMany(values);
+  const copy = new Uint8Array(buffer.length + 8);
+  copy.set(buffer, 8);
+  for (const view of [new Uint8Array(copy.buffer, 8),
+                      new DataView(copy.buffer, 8)]) {
+    assert.deepStrictEqual([...v8.deserializeMany(view)], values);
+  }
+}
+
+{
+  const buffer = v8.serializeMany([1, 'two']);
+  for (const length of [2, 6, buffer.length - 1]) {
+    assert.throws(() => [...v8.deserializeMany(buffer.slice(0, length))], {
+      code: 'ERR_BUFFER_OUT_OF_BOUNDS',
+      name: 'RangeError'
+    });
+  }
+}
+
+{
+  // Errors of one value leave the serializer usable.
+  assert.throws(() => v8.serializeMany([1, () => {}]), {
+    name: 'Error',
+    message: /could not be cloned/
+  });
+  assert.deepStrictEqual([...v8.deserializeMany(v8.serializeMany([1]))], [1]);
+}
+
+assert.throws(() => v8.serializeMany('not an array'), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+assert.throws(() => v8.deserializeMany([]), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
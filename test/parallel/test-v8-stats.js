@@ -8,6 +8,7 @@ const keys = [
   'does_zap_garbage',
   'heap_size_limit',
   'malloced_memory',
+  'memory_limit',
   'number_of_detached_contexts',
   'number_of_native_contexts',
   'peak_malloced_memory',
@@ -0,0 +1,59 @@
+'use strict';
+
+// This tests the process-wide compile cache of vm.Script and
+// vm.compileFunction().
+
+const common = require('../common');
+const assert = require('assert');
+const vm = require('vm');
+const { Worker } = require('worker_threads');
+
+const source = `(function() { return ${Math.random()}; })()`;
+
+{
+  // The first compilation populates the cache, the second one consumes it.
+  const first = new vm.Script(source, { compileCache: true });
+  assert.strictEqual(first.cachedDataRejected, undefined);
+  const second = new vm.Script(source, { compileCache: true });
+  assert.strictEqual(second.cachedDataRejected, false);
+  assert.strictEqual(second.runInThisContext(), first.runInThisContext());
+
+  // Other filenames are cached separately.
+  const other = new vm.Script(source, {
+    filename: 'other.js',
+    compileCache: true
+  });
+  assert.strictEqual(other.cachedDataRejected, undefined);
+
+  // Explicit cached data takes precedence.
+  const explicit = new vm.Script(source, {
+    cachedData: Buffer.from('garbage'),
+    compileCache: true
+  });
+  assert.strictEqual(explicit.cachedDataRejected, true);
+}
+
+{
+  const body = `return a + b + ${Math.random()};`;
+  const fn1 = vm.compileFunction(body, ['a', 'b'], { compileCache: true });
+  const fn2 = vm.compileFunction(body, ['a', 'b'], { compileCache: true });
+  assert.strictEqual(fn1(1, 2), fn2(1, 2));
+}
+
+assert.throws(() => new vm.Script('', { compileCache: 1 }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+assert.throws(() => vm.compileFunction('', [], { compileCache: 1 }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+
+// The cache is shared with Workers.
+const worker = new Worker(`
+  const vm = require('vm');
+  const { parentPort, workerData } = require('worker_threads');
+  const script = new vm.Script(workerData, { compileCache: true });
+  parentPort.postMessage(script.cachedDataRejected);
+`, { eval: true, workerData: source });
+worker.on('message', common.mustCall((rejected) => {
+  assert.strictEqual(rejected, false);
+}));
@@ -0,0 +1,45 @@
+'use strict';
+
+require('../common');
+const assert = require('assert');
+const vm = require('vm');
+
+// In detached mode, the sandbox is copied to the global object once.
+{
+  const sandbox = { count: 1, name: 'name' };
+  assert.strictEqual(vm.createContext(sandbox, { mode: 'detached' }), sandbox);
+  assert.ok(vm.isContext(sandbox));
+
+  vm.runInContext('count++; var added = name;', sandbox);
+  assert.strictEqual(sandbox.count, 1);
+  assert.strictEqual(sandbox.added, undefined);
+
+  const global = vm.getContextGlobal(sandbox);
+  assert.notStrictEqual(global, sandbox);
+  assert.strictEqual(vm.runInContext('globalThis', sandbox), global);
+  assert.strictEqual(global.count, 2);
+  assert.strictEqual(global.added, 'name');
+
+  // Changes are copied explicitly.
+  global.count = 10;
+  assert.strictEqual(vm.runInContext('count', sandbox), 10);
+  Object.assign(sandbox, global);
+  assert.strictEqual(sandbox.count, 10);
+  assert.strictEqual(sandbox.added, 'name');
+}
+
+{
+  // The global object of an attached context is not the sandbox.
+  const sandbox = { a: 1 };
+  vm.createContext(sandbox);
+  const global = vm.getContextGlobal(sandbox);
+  assert.strictEqual(vm.runInContext('this', sandbox), global);
+  assert.strictEqual(global.a, 1);
+}
+
+assert.throws(() => vm.createContext({}, { mode: 'other' }), {
+  code: 'ERR_INVALID_ARG_VALUE'
+});
+assert.throws(() => vm.getContextGlobal({}), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
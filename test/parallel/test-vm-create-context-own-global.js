@@ -0,0 +1,48 @@
+'use strict';
+
+require('../common');
+const assert = require('assert');
+const vm = require('vm');
+
+// A context created with `ownGlobal` is contextified through its own global
+// object.
+{
+  const context = vm.createContext(undefined, { ownGlobal: true });
+  assert.ok(vm.isContext(context));
+  assert.strictEqual(vm.runInContext('this', context), context);
+  assert.strictEqual(vm.runInContext('globalThis', context), context);
+
+  vm.runInContext('var x = 1; globalThis.y = 2; z = 3;', context);
+  assert.strictEqual(context.x, 1);
+  assert.strictEqual(context.y, 2);
+  assert.strictEqual(context.z, 3);
+
+  context.w = 4;
+  assert.strictEqual(vm.runInContext('w', context), 4);
+  assert.strictEqual(vm.createContext(context), context);
+
+  // Built-ins belong to the new context.
+  assert.notStrictEqual(vm.runInContext('Object', context), Object);
+  assert.strictEqual(typeof context.Array, 'function');
+
+  // Contexts do not share state.
+  const other = vm.createContext(undefined, { ownGlobal: true });
+  assert.strictEqual(other.x, undefined);
+}
+
+{
+  const context = vm.createContext(undefined, {
+    ownGlobal: true,
+    codeGeneration: { strings: false }
+  });
+  assert.throws(() => vm.runInContext('eval("1")', context), {
+    name: 'EvalError'
+  });
+}
+
+assert.throws(() => vm.createContext({}, { ownGlobal: true }), {
+  code: 'ERR_INVALID_ARG_VALUE'
+});
+assert.throws(() => vm.createContext(undefined, { ownGlobal: 1 }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
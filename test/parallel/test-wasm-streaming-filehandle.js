@@ -0,0 +1,76 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { spawnSync } = require('child_process');
+const fixtures = require('../common/fixtures');
+const tmpdir = require('../common/tmpdir');
+
+// Test that WebAssembly.compileStreaming() and
+// WebAssembly.instantiateStreaming() compile modules from a FileHandle, and
+// that the compiled modules are cached with --compile-cache-dir.
+
+tmpdir.refresh();
+const wasm = fixtures.path('simple.wasm');
+
+(async () => {
+  const filehandle = await fs.promises.open(wasm, 'r');
+  const { instance } = await WebAssembly.instantiateStreaming(filehandle, {});
+  assert.strictEqual(instance.exports.add(10, 20), 30);
+  await filehandle.close();
+
+  // A Promise for a FileHandle is accepted as well.
+  const module = await WebAssembly.compileStreaming(fs.promises.open(wasm));
+  assert.ok(module instanceof WebAssembly.Module);
+
+  await assert.rejects(WebAssembly.compileStreaming(Buffer.alloc(8)),
+                       { code: 'ERR_INVALID_ARG_TYPE' });
+
+  const invalid = path.join(tmpdir.path, 'invalid.wasm');
+  fs.writeFileSync(invalid, 'not a module');
+  const invalidHandle = await fs.promises.open(invalid, 'r');
+  await assert.rejects(WebAssembly.compileStreaming(invalidHandle),
+                       WebAssembly.CompileError);
+  await invalidHandle.close();
+})().then(common.mustCall());
+
+{
+  const cacheDir = path.join(tmpdir.path, 'cache');
+  // The module is serialized once it has been fully optimized, which is
+  // waited for before the process exits.
+  const script = `
+    require('fs').promises.open(${JSON.stringify(wasm)})
+      .then((filehandle) => WebAssembly.instantiateStreaming(filehandle, {}))
+      .then(({ instance }) => {
+        console.log(instance.exports.add(1, 2));
+        setTimeout(() => {}, 500);
+      });
+  `;
+
+  function run() {
+    const child = spawnSync(process.execPath, [
+      `--compile-cache-dir=${cacheDir}`, '-e', script
+    ]);
+    assert.strictEqual(child.status, 0, child.stderr.toString());
+    assert.strictEqual(child.stdout.toString(), '3\n');
+  }
+
+  function cacheFiles() {
+    const files = [];
+    for (const dir of fs.readdirSync(cacheDir))
+      files.push(...fs.readdirSync(path.join(cacheDir, dir)));
+    return files;
+  }
+
+  run();
+  const files = cacheFiles();
+  assert.strictEqual(files.length, 1);
+  const key = common.hasCrypto ? '[0-9a-f]{64}' : '[0-9a-f]+-[0-9a-f]{16}';
+  assert.match(files[0], new RegExp(`^wasm-${key}$`));
+
+  // The cached module is used, and is not written again.
+  run();
+  assert.deepStrictEqual(cacheFiles(), files);
+}
@@ -0,0 +1,36 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { Worker } = require('worker_threads');
+
+// Test that Workers whose V8 background tasks run with low priority still
+// get their garbage collection and compilation work done.
+
+const source = `
+  const { parentPort } = require('worker_threads');
+  const retained = [];
+  for (let i = 0; i < 200; i++) {
+    retained.push(new Array(10000).fill({ i }));
+    if (retained.length > 20) retained.shift();
+  }
+  parentPort.postMessage(retained.length);
+`;
+
+for (const backgroundTaskPriority of ['low', 'normal', undefined]) {
+  const worker = new Worker(source, { eval: true, backgroundTaskPriority });
+  worker.on('message', common.mustCall((length) => {
+    assert.strictEqual(length, 20);
+  }));
+  worker.on('exit', common.mustCall((code) => {
+    assert.strictEqual(code, 0);
+  }));
+}
+
+for (const backgroundTaskPriority of ['high', 0, null]) {
+  assert.throws(() => {
+    new Worker(source, { eval: true, backgroundTaskPriority });
+  }, {
+    code: 'ERR_INVALID_ARG_VALUE',
+    name: 'TypeError'
+  });
+}
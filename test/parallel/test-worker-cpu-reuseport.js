@@ -0,0 +1,65 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+const { Worker } = require('worker_threads');
+
+// Test that Workers pinned to CPUs can each listen on the same port with
+// the `reusePort` option, and accept connections independently.
+
+assert.throws(() => new Worker('', { eval: true, cpu: -1 }),
+              { code: 'ERR_OUT_OF_RANGE' });
+assert.throws(() => new Worker('', { eval: true, cpu: '0' }),
+              { code: 'ERR_INVALID_ARG_TYPE' });
+
+if (!common.isLinux)
+  common.skip('SO_REUSEPORT load balancing is only tested on Linux');
+
+const source = `
+  const net = require('net');
+  const { parentPort, workerData } = require('worker_threads');
+  const server = net.createServer((socket) => {
+    socket.end('ok');
+    server.close();
+  });
+  server.listen({ port: workerData.port, host: '127.0.0.1', reusePort: true },
+                () => parentPort.postMessage(server.address().port));
+`;
+
+// The first server picks the port, and keeps it while the Workers listen.
+const server = net.createServer();
+server.listen({ port: 0, host: '127.0.0.1', reusePort: true },
+              common.mustCall(() => {
+                const { port } = server.address();
+                const workers = [0, 1].map((cpu) => new Worker(source, {
+                  eval: true,
+                  cpu,
+                  workerData: { port }
+                }));
+                let listening = 0;
+                for (const worker of workers) {
+                  worker.on('message', common.mustCall((workerPort) => {
+                    assert.strictEqual(workerPort, port);
+                    if (++listening === workers.length)
+                      server.close(() => connect(port, workers.length));
+                  }));
+                  worker.on('exit', common.mustCall((code) => {
+                    assert.strictEqual(code, 0);
+                  }));
+                }
+              }));
+
+// Connects until both Workers have accepted a connection and closed their
+// servers.
+function connect(port, remaining) {
+  const socket = net.connect(port, '127.0.0.1');
+  socket.setEncoding('utf8');
+  socket.on('data', common.mustCall((data) => {
+    assert.strictEqual(data, 'ok');
+  }));
+  socket.on('close', common.mustCall(() => {
+    if (--remaining > 0)
+      connect(port, remaining);
+  }));
+}
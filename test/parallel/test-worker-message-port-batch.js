@@ -0,0 +1,71 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { MessageChannel, Worker } = require('worker_threads');
+
+// Messages that are queued together are delivered as one 'messages' event.
+{
+  const { port1, port2 } = new MessageChannel();
+  port2.on('messages', common.mustCall((values) => {
+    assert.deepStrictEqual(values, [1, { a: 2 }, 'three']);
+    port2.close();
+  }));
+  port2.on('message', common.mustNotCall());
+  port1.postMessage(1);
+  port1.postMessage({ a: 2 });
+  port1.postMessage('three');
+}
+
+// Batches are limited in size, and switching back to 'message' listeners
+// delivers the remaining messages one by one.
+{
+  const { port1, port2 } = new MessageChannel();
+  const count = 2500;
+  for (let i = 0; i < count; i++)
+    port1.postMessage(i);
+
+  const received = [];
+  const sizes = [];
+  function onMessages(values) {
+    assert(Array.isArray(values));
+    sizes.push(values.length);
+    received.push(...values);
+    if (received.length === 2000) {
+      port2.off('messages', onMessages);
+      port2.on('message', onMessage);
+    }
+  }
+
+  function onMessage(value) {
+    assert.strictEqual(typeof value, 'number');
+    received.push(value);
+    if (received.length === count) {
+      assert.deepStrictEqual(sizes, [1000, 1000]);
+      assert.deepStrictEqual(received,
+                             Array.from({ length: count }, (_, i) => i));
+      port2.close();
+    }
+  }
+  port2.on('messages', onMessages);
+  port2.on('close', common.mustCall());
+}
+
+// `parentPort` in a worker that is sent a lot of messages.
+{
+  const count = 20000;
+  const worker = new Worker(`
+    const { parentPort } = require('worker_threads');
+    let next = 0;
+    parentPort.on('messages', (values) => {
+      for (const value of values) {
+        if (value !== next++)
+          throw new Error(\`Got \${value} instead of \${next - 1}\`);
+      }
+      if (next === ${count})
+        parentPort.close();
+    });
+  `, { eval: true });
+  for (let i = 0; i < count; i++)
+    worker.postMessage(i);
+  worker.on('exit', common.mustCall((code) => assert.strictEqual(code, 0)));
+}
@@ -0,0 +1,39 @@
+'use strict';
+// A worker posts many messages while this thread is receiving them, and
+// this thread stops and restarts receiving in between. All messages have to
+// arrive exactly once and in order, including the ones that were added to
+// the queue while it was being drained.
+
+const common = require('../common');
+const assert = require('assert');
+const { MessageChannel, Worker } = require('worker_threads');
+
+const count = 50000;
+const { port1, port2 } = new MessageChannel();
+
+let next = 0;
+function onMessage(message) {
+  assert.strictEqual(message.index, next++);
+  assert.strictEqual(message.text, `message ${message.index}`);
+  if (next % 7919 === 0) {
+    // Stop receiving for a while; messages keep being queued in the meantime.
+    port2.off('message', onMessage);
+    setTimeout(() => port2.on('message', onMessage), 10);
+  }
+  if (next === count)
+    port2.close();
+}
+port2.on('message', onMessage);
+port2.on('close', common.mustCall(() => {
+  assert.strictEqual(next, count);
+}));
+
+new Worker(`
+  const { workerData: { port, count } } = require('worker_threads');
+  for (let index = 0; index < count; index++)
+    port.postMessage({ index, text: \`message \${index}\` });
+`, {
+  eval: true,
+  workerData: { port: port1, count },
+  transferList: [port1]
+}).on('exit', common.mustCall((code) => assert.strictEqual(code, 0)));
@@ -0,0 +1,63 @@
+'use strict';
+// Primitive messages without a transfer list use their own encoding instead
+// of the V8 serializer. They have to arrive unchanged, also when mixed with
+// other messages and when sent from another thread.
+
+const common = require('../common');
+const assert = require('assert');
+const {
+  MessageChannel, Worker, receiveMessageOnPort
+} = require('worker_threads');
+
+const values = [
+  undefined, null, true, false,
+  0, -0, 1, -1, 2 ** 31 - 1, -(2 ** 31), 2 ** 31, 1.5, -1e300,
+  NaN, Infinity, -Infinity, Number.MIN_VALUE,
+  '', 'a', 'hello world!', 'ä'.repeat(1000), '€', '🙂 x', 'x'.repeat(1e6),
+  'abc\0def', '\ud800',
+  { a: 1 }, [1, 'two'], 10n,
+];
+
+{
+  const { port1, port2 } = new MessageChannel();
+  for (const value of values)
+    port1.postMessage(value);
+  for (const value of values) {
+    const { message } = receiveMessageOnPort(port2);
+    if (typeof value === 'object')
+      assert.deepStrictEqual(message, value);
+    else
+      assert(Object.is(message, value), `${message} is not ${value}`);
+  }
+  assert.strictEqual(receiveMessageOnPort(port2), undefined);
+  port1.close();
+}
+
+// Values that cannot be cloned still throw.
+{
+  const { port1, port2 } = new MessageChannel();
+  assert.throws(() => port1.postMessage(Symbol('x')), {
+    name: 'DataCloneError'
+  });
+  port1.close();
+  port2.close();
+}
+
+{
+  const worker = new Worker(`
+    const { parentPort } = require('worker_threads');
+    parentPort.on('message', (value) => parentPort.postMessage(value));
+  `, { eval: true });
+  let next = 0;
+  worker.on('message', common.mustCall((message) => {
+    const value = values[next++];
+    if (typeof value === 'object')
+      assert.deepStrictEqual(message, value);
+    else
+      assert(Object.is(message, value));
+    if (next === values.length)
+      worker.terminate();
+  }, values.length));
+  for (const value of values)
+    worker.postMessage(value);
+}
@@ -0,0 +1,103 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const net = require('net');
+const { MessageChannel, Worker } = require('worker_threads');
+
+// Test that FileHandles and net.Sockets can be transferred to other threads,
+// where they are driven by the receiving thread's event loop.
+
+{
+  // FileHandles are replaced inside of the message, too.
+  (async () => {
+    const filehandle = await fs.promises.open(__filename);
+    const { port1, port2 } = new MessageChannel();
+    port2.once('message', common.mustCall(async ({ files }) => {
+      const [ received ] = files;
+      assert.ok(received instanceof filehandle.constructor);
+      assert.notStrictEqual(received, filehandle);
+      const { buffer, bytesRead } =
+        await received.read(Buffer.alloc(12), 0, 12);
+      assert.strictEqual(buffer.toString('utf8', 0, bytesRead), "'use strict'");
+      await received.close();
+      port2.close();
+    }));
+    port1.postMessage({ files: [ filehandle ] }, [ filehandle ]);
+    assert.strictEqual(filehandle.fd, -1);
+    await assert.rejects(filehandle.stat(), { code: 'EBADF' });
+  })().then(common.mustCall());
+}
+
+{
+  // A closed FileHandle cannot be transferred.
+  (async () => {
+    const filehandle = await fs.promises.open(__filename);
+    await filehandle.close();
+    const { port1 } = new MessageChannel();
+    assert.throws(() => {
+      port1.postMessage(filehandle, [ filehandle ]);
+    }, {
+      name: 'DataCloneError',
+      message: 'FileHandle in transfer list is closed'
+    });
+    port1.close();
+  })().then(common.mustCall());
+}
+
+if (common.isWindows) {
+  common.printSkipMessage('Transferring sockets is not supported on Windows');
+  return;
+}
+
+{
+  // Accepted connections can be handed to a Worker, which then serves them.
+  const worker = new Worker(`
+    const { parentPort } = require('worker_threads');
+    parentPort.on('message', ({ socket }) => {
+      socket.setEncoding('utf8');
+      socket.once('data', (data) => socket.end(data.toUpperCase()));
+    });
+  `, { eval: true });
+
+  const onconnection = common.mustCall((socket) => {
+    socket.on('close', common.mustCall());
+    worker.postMessage({ socket }, [ socket ]);
+    assert.strictEqual(socket.destroyed, true);
+    server.close();
+  });
+  const server = net.createServer({ pauseOnConnect: true }, onconnection);
+
+  server.listen(0, common.mustCall(() => {
+    const client = net.connect(server.address().port);
+    let response = '';
+    client.setEncoding('utf8');
+    client.on('data', (data) => response += data);
+    client.on('end', common.mustCall(() => {
+      assert.strictEqual(response, 'PING');
+      worker.terminate();
+    }));
+    client.write('ping');
+  }));
+}
+
+{
+  // The same socket cannot be listed twice.
+  const server = net.createServer(common.mustCall((socket) => {
+    const { port1 } = new MessageChannel();
+    assert.throws(() => {
+      port1.postMessage(socket, [ socket, socket._handle ]);
+    }, {
+      name: 'DataCloneError',
+      message: 'Transfer list contains duplicate handle'
+    });
+    assert.strictEqual(socket.destroyed, false);
+    port1.close();
+    socket.destroy();
+    server.close();
+  }));
+
+  server.listen(0, common.mustCall(() => {
+    net.connect(server.address().port).on('error', () => {});
+  }));
+}
@@ -0,0 +1,71 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { Worker } = require('worker_threads');
+const tmpdir = require('../common/tmpdir');
+
+// Test that Workers use the module resolutions of the main thread, and that
+// those are discarded once they no longer match the file system.
+
+tmpdir.refresh();
+const pkgDir = path.join(tmpdir.path, 'node_modules', 'pkg');
+fs.mkdirSync(pkgDir, { recursive: true });
+fs.writeFileSync(path.join(pkgDir, 'package.json'), '{"main": "a.js"}');
+fs.writeFileSync(path.join(pkgDir, 'a.js'), 'module.exports = "a";');
+
+const entry = path.join(tmpdir.path, 'entry.js');
+fs.writeFileSync(entry, `
+  const { parentPort } = require('worker_threads');
+  parentPort.postMessage([require.resolve('pkg'), require('pkg')]);
+`);
+
+function requireInWorker(filename) {
+  return new Promise((resolve) => {
+    new Worker(`
+      const { parentPort, workerData } = require('worker_threads');
+      let result;
+      try {
+        result = require(workerData);
+      } catch (err) {
+        result = err.code;
+      }
+      parentPort.postMessage(result);
+    `, { eval: true, workerData: filename }).once('message', resolve);
+  });
+}
+
+function resolveInWorker() {
+  return new Promise((resolve) => {
+    new Worker(entry).once('message', resolve);
+  });
+}
+
+(async function() {
+  assert.strictEqual(require(path.join(tmpdir.path, 'node_modules', 'pkg')),
+                     'a');
+  assert.deepStrictEqual(await resolveInWorker(),
+                         [path.join(pkgDir, 'a.js'), 'a']);
+
+  // Once the resolved file is gone, Workers resolve the module again.
+  fs.unlinkSync(path.join(pkgDir, 'a.js'));
+  fs.writeFileSync(path.join(pkgDir, 'package.json'), '{"main": "b.js"}');
+  fs.writeFileSync(path.join(pkgDir, 'b.js'), 'module.exports = "b";');
+  assert.deepStrictEqual(await resolveInWorker(),
+                         [path.join(pkgDir, 'b.js'), 'b']);
+
+  // package.json files that were missing or have changed since they were
+  // read are read again.
+  const scopeDir = path.join(tmpdir.path, 'scope');
+  const scopeFile = path.join(scopeDir, 'x.js');
+  fs.mkdirSync(scopeDir);
+  fs.writeFileSync(scopeFile, 'module.exports = "x";');
+  assert.strictEqual(require(scopeFile), 'x');
+
+  fs.writeFileSync(path.join(scopeDir, 'package.json'), '{"type": "module"}');
+  assert.strictEqual(await requireInWorker(scopeFile), 'ERR_REQUIRE_ESM');
+  fs.writeFileSync(path.join(scopeDir, 'package.json'),
+                   '{"type": "commonjs"}');
+  assert.strictEqual(await requireInWorker(scopeFile), 'x');
+})().then(common.mustCall());
@@ -0,0 +1,37 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { Worker } = require('worker_threads');
+
+// Test that Workers with the same environment get the options from their
+// NODE_OPTIONS, and that a different NODE_OPTIONS is not mixed up with the
+// options of earlier Workers.
+
+const code = `
+  require('worker_threads').parentPort.postMessage(
+    [process.noDeprecation === true, process.traceProcessWarnings === true]);
+`;
+
+function run(env) {
+  return new Promise((resolve) => {
+    new Worker(code, { eval: true, env, execArgv: [] })
+      .once('message', resolve);
+  });
+}
+
+(async function() {
+  const deprecation = { NODE_OPTIONS: '--no-deprecation' };
+  assert.deepStrictEqual(await run(deprecation), [true, false]);
+  assert.deepStrictEqual(await run(deprecation), [true, false]);
+  assert.deepStrictEqual(await run({ NODE_OPTIONS: '--trace-warnings' }),
+                         [false, true]);
+  assert.deepStrictEqual(await run({}), [false, false]);
+  assert.deepStrictEqual(await run(deprecation), [true, false]);
+
+  // Errors are reported for every Worker.
+  for (let i = 0; i < 2; i++) {
+    assert.throws(() => {
+      new Worker(code, { eval: true, env: { NODE_OPTIONS: '--foo' } });
+    }, { code: 'ERR_WORKER_INVALID_EXEC_ARGV' });
+  }
+})().then(common.mustCall());
@@ -0,0 +1,55 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { WorkerPool } = require('worker_threads');
+
+// Scripts run on idle threads of the pool, which are replaced after being
+// taken from the pool. Idle threads do not keep the process alive.
+
+const pool = new WorkerPool({ size: 2, env: { POOLED: 'yes' } });
+assert.strictEqual(pool.idleCount, 2);
+
+const code = `
+  const { parentPort, workerData } = require('worker_threads');
+  parentPort.postMessage({
+    value: workerData.value * 2,
+    env: process.env.POOLED,
+    argv: process.argv.slice(2)
+  });
+`;
+
+for (let i = 0; i < 5; i++) {
+  const worker = pool.run(code, {
+    eval: true,
+    workerData: { value: i },
+    argv: ['a', i]
+  });
+  worker.on('online', common.mustCall());
+  worker.on('message', common.mustCall((message) => {
+    assert.deepStrictEqual(message, {
+      value: i * 2,
+      env: 'yes',
+      argv: ['a', `${i}`]
+    });
+  }));
+  worker.on('exit', common.mustCall((code) => {
+    assert.strictEqual(code, 0);
+  }));
+}
+
+assert.throws(() => pool.run('not-a-path.js'), {
+  code: 'ERR_WORKER_PATH'
+});
+assert.throws(() => new WorkerPool({ size: -1 }), {
+  code: 'ERR_OUT_OF_RANGE'
+});
+
+setImmediate(common.mustCall(() => {
+  assert.strictEqual(pool.idleCount, 2);
+  pool.close().then(common.mustCall(() => {
+    assert.strictEqual(pool.idleCount, 0);
+    assert.throws(() => pool.run(code, { eval: true }), {
+      code: 'ERR_WORKER_POOL_CLOSED'
+    });
+  }));
+}));
@@ -0,0 +1,65 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { Worker } = require('worker_threads');
+
+// Test that the resource usage of a Worker can be read from the parent
+// thread while the Worker is running, without messaging it.
+
+const worker = new Worker(`
+  const { parentPort } = require('worker_threads');
+  const retained = [];
+  setImmediate(() => {
+    const start = Date.now();
+    while (Date.now() - start < 100)
+      retained.push({ time: Date.now() });
+    // Report back once the Worker has become idle.
+    setTimeout(() => parentPort.postMessage('busy'), 10);
+  });
+  parentPort.once('message', () => process.exit());
+`, { eval: true });
+
+function checkUsage(usage) {
+  for (const key of ['heapTotal', 'heapUsed', 'heapSizeLimit', 'external']) {
+    assert.strictEqual(typeof usage[key], 'number');
+    assert.ok(usage[key] >= 0, `${key}: ${usage[key]}`);
+  }
+  assert.ok(usage.heapUsed <= usage.heapTotal);
+  const { idle, active, utilization } = usage.eventLoopUtilization;
+  assert.ok(idle >= 0);
+  assert.ok(active >= 0);
+  assert.ok(utilization >= 0 && utilization <= 1, `${utilization}`);
+}
+
+worker.once('online', common.mustCall(() => {
+  checkUsage(worker.getResourceUsage());
+}));
+
+worker.once('message', common.mustCall(() => {
+  const first = worker.getResourceUsage();
+  checkUsage(first);
+  assert.ok(first.heapUsed > 0);
+  // The Worker has been busy for at least 100 ms.
+  assert.ok(first.cpuTime >= 50 * 1000 || common.isAIX,
+            `cpuTime: ${first.cpuTime}`);
+  assert.ok(first.eventLoopUtilization.active >= 50,
+            `active: ${first.eventLoopUtilization.active}`);
+
+  // While the Worker waits for a message, only its idle time grows.
+  setTimeout(common.mustCall(() => {
+    const second = worker.getResourceUsage();
+    checkUsage(second);
+    const idle = second.eventLoopUtilization.idle -
+                 first.eventLoopUtilization.idle;
+    assert.ok(idle >= 50, `idle: ${idle}`);
+    assert.ok(second.eventLoopUtilization.utilization <
+              first.eventLoopUtilization.utilization);
+    worker.postMessage('exit');
+  }), 100);
+}));
+
+worker.on('exit', common.mustCall(() => {
+  assert.throws(() => worker.getResourceUsage(), {
+    code: 'ERR_WORKER_NOT_RUNNING'
+  });
+}));
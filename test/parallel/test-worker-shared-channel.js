@@ -0,0 +1,96 @@
+'use strict';
+// This thread and a worker stream data to each other through a channel that
+// is much smaller than the data, so that both ends have to wait for each
+// other repeatedly. The data has to arrive unchanged in both directions.
+
+const common = require('../common');
+const assert = require('assert');
+const {
+  Worker, createChannel, openChannel
+} = require('worker_threads');
+
+const size = 4096;
+const total = 1024 * 1024;
+
+function makeData(seed) {
+  const data = Buffer.allocUnsafe(total);
+  for (let i = 0; i < total; i++)
+    data[i] = (i * seed) & 0xff;
+  return data;
+}
+
+{
+  const [mine, theirs] = createChannel({ size });
+  const channel = openChannel(mine);
+  assert.throws(() => openChannel(mine), {
+    code: 'ERR_INVALID_ARG_VALUE'
+  });
+
+  const chunks = [];
+  channel.on('data', (chunk) => chunks.push(chunk));
+  channel.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(Buffer.concat(chunks), makeData(7));
+  }));
+  channel.on('close', common.mustCall());
+
+  const data = makeData(13);
+  for (let offset = 0; offset < total; offset += 10000)
+    channel.write(data.slice(offset, offset + 10000));
+  channel.end();
+
+  new Worker(`
+    const assert = require('assert');
+    const { workerData, openChannel } = require('worker_threads');
+    const { endpoint, total } = workerData;
+    const makeData = ${makeData};
+    const channel = openChannel(endpoint);
+    const chunks = [];
+    channel.on('data', (chunk) => chunks.push(chunk));
+    channel.on('end', () => {
+      assert.deepStrictEqual(Buffer.concat(chunks), makeData(13));
+    });
+    const data = makeData(7);
+    for (let offset = 0; offset < total; offset += 10000)
+      channel.write(data.slice(offset, offset + 10000));
+    channel.end();
+  `, {
+    eval: true,
+    workerData: { endpoint: theirs, total }
+  }).on('exit', common.mustCall((code) => assert.strictEqual(code, 0)));
+}
+
+{
+  // Writes fail once the other end has been destroyed.
+  const [end1, end2] = createChannel();
+  const channel1 = openChannel(end1);
+  const channel2 = openChannel(end2);
+  channel2.destroy();
+  channel2.on('close', common.mustCall(() => {
+    channel1.write('hello', common.mustCall((err) => {
+      assert.strictEqual(err.code, 'EPIPE');
+    }));
+    channel1.on('error', common.mustCall());
+  }));
+
+  // Endpoints cannot be opened again after they have been closed.
+  channel2.on('close', common.mustCall(() => {
+    assert.throws(() => openChannel(end2), {
+      code: 'ERR_INVALID_ARG_VALUE'
+    });
+  }));
+}
+
+{
+  for (const size of [0, -1, 1.5, 2 ** 31])
+    assert.throws(() => createChannel({ size }), { code: 'ERR_OUT_OF_RANGE' });
+  assert.throws(() => createChannel({ size: '1' }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+  assert.throws(() => openChannel({ buffer: new ArrayBuffer(8), side: 0 }), {
+    code: 'ERR_INVALID_ARG_VALUE'
+  });
+  const [endpoint] = createChannel();
+  assert.throws(() => openChannel({ ...endpoint, side: 2 }), {
+    code: 'ERR_INVALID_ARG_VALUE'
+  });
+}
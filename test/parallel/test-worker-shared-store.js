@@ -0,0 +1,74 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const { SharedStore, Worker } = require('worker_threads');
+
+const entries = new Map([
+  ['number', 42],
+  ['string', 'a string'],
+  ['object', { a: 1, b: [2, 3] }],
+  ['table', new Float64Array([1.5, 2.5, 3.5])],
+  ['empty', undefined],
+]);
+
+{
+  const store = SharedStore.from(entries);
+  assert.ok(store.buffer instanceof SharedArrayBuffer);
+  assert.strictEqual(store.size, entries.size);
+  assert.deepStrictEqual([...store.keys()], [...entries.keys()]);
+  for (const [key, value] of entries) {
+    assert.ok(store.has(key));
+    assert.deepStrictEqual(store.get(key), value);
+  }
+  assert.strictEqual(store.has('missing'), false);
+  assert.strictEqual(store.get('missing'), undefined);
+
+  // Every lookup returns a new copy.
+  assert.notStrictEqual(store.get('object'), store.get('object'));
+
+  // Opening the same buffer again gives the same entries.
+  const reopened = new SharedStore(store.buffer);
+  for (const [key, value] of entries)
+    assert.deepStrictEqual(reopened.get(key), value);
+}
+
+{
+  const store = SharedStore.from({ x: 1, y: [2] });
+  assert.deepStrictEqual([...store.keys()], ['x', 'y']);
+  assert.deepStrictEqual(store.get('y'), [2]);
+
+  assert.strictEqual(SharedStore.from({}).size, 0);
+}
+
+{
+  // Other threads read the same memory.
+  const store = SharedStore.from(entries);
+  const worker = new Worker(`
+    const assert = require('assert');
+    const { SharedStore, parentPort, workerData } = require('worker_threads');
+    const store = new SharedStore(workerData);
+    assert.strictEqual(store.buffer, workerData);
+    parentPort.postMessage([...store.keys()].map((key) => store.get(key)));
+  `, { eval: true, workerData: store.buffer });
+  worker.on('message', common.mustCall((values) => {
+    assert.deepStrictEqual(values, [...entries.values()]);
+  }));
+  worker.on('exit', common.mustCall((code) => assert.strictEqual(code, 0)));
+}
+
+assert.throws(() => SharedStore.from(new Map([[1, 2]])), {
+  code: 'ERR_INVALID_ARG_VALUE'
+});
+assert.throws(() => SharedStore.from('entries'), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+assert.throws(() => SharedStore.from({ f() {} }), {
+  message: /could not be cloned/
+});
+assert.throws(() => new SharedStore(new ArrayBuffer(8)), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+assert.throws(() => new SharedStore(new SharedArrayBuffer(2)), {
+  code: 'ERR_INVALID_ARG_VALUE'
+});
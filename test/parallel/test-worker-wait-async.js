@@ -0,0 +1,86 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { Worker, notify, waitAsync } = require('worker_threads');
+
+// Test that waitAsync() waits for notifications from other threads without
+// blocking the event loop, and that notify() wakes up both synchronous and
+// asynchronous waiters.
+
+{
+  // The value is compared before waiting.
+  const shared = new Int32Array(new SharedArrayBuffer(8));
+  waitAsync(shared, 1, 42).then(common.mustCall((result) => {
+    assert.strictEqual(result, 'not-equal');
+  }));
+}
+
+{
+  // A wait without a notification times out.
+  const shared = new Int32Array(new SharedArrayBuffer(4));
+  waitAsync(shared, 0, 0, 10).then(common.mustCall((result) => {
+    assert.strictEqual(result, 'timed-out');
+    assert.strictEqual(notify(shared, 0), 0);
+  }));
+}
+
+{
+  // Waiters are woken up by other threads, in the order in which they
+  // started waiting.
+  const shared = new Int32Array(new SharedArrayBuffer(8));
+  const order = [];
+  for (let i = 0; i < 3; i++) {
+    waitAsync(shared, 1, 0).then(common.mustCall((result) => {
+      assert.strictEqual(result, 'ok');
+      order.push(i);
+      if (order.length === 3)
+        assert.deepStrictEqual(order, [0, 1, 2]);
+    }));
+  }
+
+  const worker = new Worker(`
+    const { notify, workerData } = require('worker_threads');
+    Atomics.store(workerData, 1, 1);
+    if (notify(workerData, 1, 1) !== 1 || notify(workerData, 1) !== 2)
+      throw new Error('unexpected number of woken up waiters');
+  `, { eval: true, workerData: shared });
+  worker.on('exit', common.mustCall((code) => {
+    assert.strictEqual(code, 0);
+  }));
+}
+
+{
+  // notify() also wakes up threads that are blocked in Atomics.wait().
+  const shared = new Int32Array(new SharedArrayBuffer(4));
+  const worker = new Worker(`
+    const { parentPort, workerData } = require('worker_threads');
+    parentPort.postMessage('waiting');
+    parentPort.postMessage(Atomics.wait(workerData, 0, 0));
+  `, { eval: true, workerData: shared });
+  worker.once('message', common.mustCall(() => {
+    // Wait until the worker is blocked.
+    const interval = setInterval(() => {
+      if (notify(shared, 0) !== 1) return;
+      clearInterval(interval);
+      worker.once('message', common.mustCall((result) => {
+        assert.strictEqual(result, 'ok');
+      }));
+    }, 5);
+  }));
+}
+
+[
+  [new Int32Array(4), 0, 0],
+  [new Uint32Array(new SharedArrayBuffer(4)), 0, 0],
+  [new Int32Array(new SharedArrayBuffer(4)), 1, 0],
+  [new Int32Array(new SharedArrayBuffer(4)), 0, 2 ** 31],
+  [new Int32Array(new SharedArrayBuffer(4)), 0, 0, -1],
+].forEach((args) => {
+  assert.throws(() => waitAsync(...args), {
+    code: /^ERR_INVALID_ARG_(TYPE|VALUE)$|^ERR_OUT_OF_RANGE$/
+  });
+});
+
+assert.throws(() => notify(new Int32Array(new SharedArrayBuffer(4)), 0, NaN), {
+  code: 'ERR_OUT_OF_RANGE'
+});
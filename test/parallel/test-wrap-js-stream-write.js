@@ -0,0 +1,58 @@
+// Flags: --expose-internals
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const StreamWrap = require('internal/js_stream_socket');
+const { Duplex } = require('stream');
+
+// This test makes sure that all buffers of a write request reach the wrapped
+// stream in a single write(), and that the request completes as soon as the
+// wrapped stream has accepted the data.
+{
+  const chunks = [];
+  let pending = null;
+
+  const stream = new Duplex({
+    read() {},
+    write(chunk, encoding, callback) {
+      chunks.push(chunk);
+      // Keep the write pending.
+      pending = callback;
+    }
+  });
+  const socket = new StreamWrap(stream);
+
+  socket.cork();
+  socket.write('foo');
+  socket.write('bar', common.mustCall((err) => {
+    assert.ifError(err);
+    assert.strictEqual(chunks.length, 1);
+    assert.strictEqual(chunks[0].toString(), 'foobar');
+    assert.strictEqual(typeof pending, 'function');
+    pending();
+  }));
+  socket.uncork();
+}
+
+{
+  // If the wrapped stream asks to wait, the request completes once the data
+  // has been written.
+  let written = false;
+
+  const stream = new Duplex({
+    highWaterMark: 1,
+    read() {},
+    write(chunk, encoding, callback) {
+      setImmediate(() => {
+        written = true;
+        callback();
+      });
+    }
+  });
+  const socket = new StreamWrap(stream);
+
+  socket.write('foobar', common.mustCall((err) => {
+    assert.ifError(err);
+    assert.strictEqual(written, true);
+  }));
+}
@@ -306,7 +306,8 @@ assert.throws(
     code: 'ERR_INVALID_ARG_TYPE',
     name: 'TypeError',
     message: 'The "options.dictionary" property must be an instance of Buffer' +
-             ', TypedArray, DataView, or ArrayBuffer. Received type string ' +
+             ', TypedArray, DataView, ArrayBuffer, or Dictionary. ' +
+             'Received type string ' +
              "('not a buffer')"
   }
 );
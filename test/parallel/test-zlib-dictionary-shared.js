@@ -0,0 +1,108 @@
+'use strict';
+// Test compressing and uncompressing with a shared zlib.Dictionary.
+
+const common = require('../common');
+const assert = require('assert');
+const zlib = require('zlib');
+
+const spdyDict = Buffer.from([
+  'optionsgetheadpostputdeletetraceacceptaccept-charsetaccept-encodingaccept-',
+  'languageauthorizationexpectfromhostif-modified-sinceif-matchif-none-matchi',
+  'f-rangeif-unmodifiedsincemax-forwardsproxy-authorizationrangerefererteuser',
+  '-agent10010120020120220320420520630030130230330430530630740040140240340440',
+  '5406407408409410411412413414415416417500501502503504505accept-rangesageeta',
+  'glocationproxy-authenticatepublicretry-afterservervarywarningwww-authentic',
+  'ateallowcontent-basecontent-encodingcache-controlconnectiondatetrailertran',
+  'sfer-encodingupgradeviawarningcontent-languagecontent-lengthcontent-locati',
+  'oncontent-md5content-rangecontent-typeetagexpireslast-modifiedset-cookieMo',
+  'ndayTuesdayWednesdayThursdayFridaySaturdaySundayJanFebMarAprMayJunJulAugSe',
+  'pOctNovDecchunkedtext/htmlimage/pngimage/jpgimage/gifapplication/xmlapplic',
+  'ation/xhtmltext/plainpublicmax-agecharset=iso-8859-1utf-8gzipdeflateHTTP/1',
+  '.1statusversionurl\0',
+].join(''));
+
+const input = Buffer.from([
+  'HTTP/1.1 200 Ok',
+  'Server: node.js',
+  'Content-Length: 0',
+  '',
+].join('\r\n'));
+
+const dictionary = new zlib.Dictionary(spdyDict);
+assert.strictEqual(dictionary.byteLength, spdyDict.length);
+
+for (const value of ['dictionary', 1, {}, null]) {
+  assert.throws(() => new zlib.Dictionary(value), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+
+// The output is the same as with a plain Buffer dictionary, also when the
+// deflate state is reused by later streams.
+for (const [deflate, inflate] of [
+  [zlib.deflateSync, zlib.inflateSync],
+  [zlib.deflateRawSync, zlib.inflateRawSync],
+]) {
+  const expected = deflate(input, { dictionary: spdyDict });
+  for (let i = 0; i < 20; i++) {
+    const compressed = deflate(input, { dictionary });
+    assert.deepStrictEqual(compressed, expected);
+    assert.deepStrictEqual(inflate(compressed, { dictionary }), input);
+    assert.deepStrictEqual(inflate(compressed, { dictionary: spdyDict }),
+                           input);
+  }
+}
+
+// Streams with different parameters do not share their state.
+{
+  const options = { dictionary, level: 1, strategy: zlib.constants.Z_RLE };
+  const compressed = zlib.deflateSync(input, options);
+  assert.deepStrictEqual(
+    compressed,
+    zlib.deflateSync(input, { ...options, dictionary: spdyDict }));
+  assert.deepStrictEqual(zlib.deflateSync(input, { dictionary }),
+                         zlib.deflateSync(input, { dictionary: spdyDict }));
+}
+
+// A dictionary created from an ArrayBuffer is copied.
+{
+  const data = new Uint8Array(spdyDict).buffer;
+  const copy = new zlib.Dictionary(data);
+  new Uint8Array(data).fill(0);
+  const compressed = zlib.deflateSync(input, { dictionary: copy });
+  assert.deepStrictEqual(zlib.inflateSync(compressed, { dictionary: spdyDict }),
+                         input);
+}
+
+// Asynchronous streams, params() and reset().
+{
+  const deflate = zlib.createDeflate({ dictionary });
+  deflate.params(0, zlib.constants.Z_DEFAULT_STRATEGY, common.mustCall(() => {
+    deflate.reset();
+    deflate.end(input);
+  }));
+  const chunks = [];
+  deflate.on('data', (chunk) => chunks.push(chunk));
+  deflate.on('end', common.mustCall(() => {
+    const compressed = Buffer.concat(chunks);
+    zlib.inflate(compressed, { dictionary }, common.mustCall((err, output) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(output, input);
+      // A stream created after the one that changed its parameters is not
+      // affected by the change.
+      assert.deepStrictEqual(zlib.deflateSync(input, { dictionary }),
+                             zlib.deflateSync(input, { dictionary: spdyDict }));
+    }));
+  }));
+}
+
+// Many concurrent streams sharing one dictionary.
+for (let i = 0; i < 10; i++) {
+  zlib.deflate(input, { dictionary }, common.mustCall((err, compressed) => {
+    assert.ifError(err);
+    zlib.inflate(compressed, { dictionary }, common.mustCall((err, output) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(output, input);
+    }));
+  }));
+}
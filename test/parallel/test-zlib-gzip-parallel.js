@@ -0,0 +1,67 @@
+'use strict';
+// Test zlib.createGzip({ parallel }).
+
+const common = require('../common');
+const assert = require('assert');
+const zlib = require('zlib');
+const { Readable, pipeline } = require('stream');
+
+// Compressible data that is spread over many blocks.
+const data = Buffer.concat(Array.from({ length: 200 }, (_, i) => {
+  return Buffer.from(`line ${i} ${'abcdefghij'.repeat(i % 50)}\n`.repeat(60));
+}));
+assert(data.length > 1024 * 1024);
+
+for (const value of [0, -1, 1.5, 1025, 'x']) {
+  assert.throws(() => zlib.createGzip({ parallel: value }), {
+    code: /^ERR_OUT_OF_RANGE$|^ERR_INVALID_ARG_TYPE$/
+  });
+}
+assert.throws(() => zlib.createGzip({ parallel: 2, dictionary: data }), {
+  code: 'ERR_INVALID_ARG_VALUE'
+});
+assert.throws(() => zlib.gzipSync(data, { parallel: 2 }), {
+  code: 'ERR_INVALID_ARG_VALUE'
+});
+
+function check(input, options, chunkSize) {
+  const chunks = [];
+  for (let i = 0; i < input.length; i += chunkSize)
+    chunks.push(input.slice(i, i + chunkSize));
+  const gzip = zlib.createGzip(options);
+  assert(!(gzip instanceof zlib.Gzip));
+  const output = [];
+  gzip.on('data', (chunk) => output.push(chunk));
+  pipeline(Readable.from(chunks), gzip, common.mustCall((err) => {
+    assert.ifError(err);
+    const compressed = Buffer.concat(output);
+    assert.strictEqual(gzip.bytesWritten, input.length);
+    assert.deepStrictEqual(zlib.gunzipSync(compressed), input);
+    // The blocks being primed with their predecessors keeps the output
+    // close to the size of regular gzip output.
+    const regular = zlib.gzipSync(input, options);
+    assert(compressed.length < regular.length * 1.05 + 64,
+           `${compressed.length} vs. ${regular.length}`);
+  }));
+}
+
+check(data, { parallel: 4 }, 64 * 1024);
+check(data, { parallel: 1 }, 1000);
+check(data, { parallel: 8, level: 9 }, 300 * 1024);
+check(data, { parallel: 3, level: 1, strategy: zlib.constants.Z_RLE }, 4096);
+check(data.slice(0, 100), { parallel: 2 }, 10);
+check(Buffer.alloc(0), { parallel: 2 }, 1);
+
+zlib.gzip(data, { parallel: 4 }, common.mustCall((err, compressed) => {
+  assert.ifError(err);
+  assert.deepStrictEqual(zlib.gunzipSync(compressed), data);
+}));
+
+{
+  // Destroying the stream while blocks are in flight.
+  const gzip = zlib.createGzip({ parallel: 4 });
+  gzip.on('data', common.mustNotCall());
+  gzip.write(data);
+  gzip.destroy();
+  gzip.on('close', common.mustCall());
+}
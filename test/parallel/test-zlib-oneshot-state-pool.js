@@ -0,0 +1,74 @@
+'use strict';
+// The convenience methods reuse zlib states between calls. Check that this
+// does not leak any state from one call into the next.
+
+const common = require('../common');
+const assert = require('assert');
+const zlib = require('zlib');
+
+const inputs = [
+  Buffer.alloc(0),
+  Buffer.from('hello world'),
+  Buffer.from('x'.repeat(20 * 1024)),
+  Buffer.from(Array.from({ length: 10000 }, (_, i) => i % 251)),
+];
+
+function compressWithStream(ctor, input, options) {
+  const engine = new ctor(options);
+  return engine._processChunk(input, engine._finishFlushFlag);
+}
+
+const optionsList = [
+  {},
+  { level: 1 },
+  { level: 9, memLevel: 9, strategy: zlib.constants.Z_FILTERED },
+  { windowBits: 9 },
+];
+
+for (let round = 0; round < 3; round++) {
+  for (const options of optionsList) {
+    for (const input of inputs) {
+      for (const [ctor, compressSync, decompressSync] of [
+        [zlib.Deflate, zlib.deflateSync, zlib.inflateSync],
+        [zlib.DeflateRaw, zlib.deflateRawSync, zlib.inflateRawSync],
+        [zlib.Gzip, zlib.gzipSync, zlib.gunzipSync],
+      ]) {
+        const compressed = compressSync(input, options);
+        assert.deepStrictEqual(compressed,
+                               compressWithStream(ctor, input, options));
+        assert.deepStrictEqual(decompressSync(compressed, options), input);
+        if (ctor !== zlib.DeflateRaw)
+          assert.deepStrictEqual(zlib.unzipSync(compressed), input);
+      }
+    }
+  }
+}
+
+// A failed decompression does not affect later calls.
+{
+  const compressed = zlib.deflateSync(inputs[2]);
+  const corrupt = Buffer.from(compressed);
+  corrupt[corrupt.length >> 1] ^= 0xff;
+  for (let i = 0; i < 3; i++) {
+    assert.throws(() => zlib.inflateSync(corrupt), Error);
+    assert.deepStrictEqual(zlib.inflateSync(compressed), inputs[2]);
+  }
+  // Truncated input.
+  assert.throws(() => zlib.inflateSync(compressed.slice(0, 10), {
+    finishFlush: zlib.constants.Z_FINISH
+  }), { code: 'Z_BUF_ERROR' });
+  assert.deepStrictEqual(zlib.inflateSync(compressed), inputs[2]);
+}
+
+// Asynchronous calls running concurrently.
+for (const input of inputs) {
+  for (let i = 0; i < 4; i++) {
+    zlib.gzip(input, common.mustCall((err, compressed) => {
+      assert.ifError(err);
+      zlib.gunzip(compressed, common.mustCall((err, output) => {
+        assert.ifError(err);
+        assert.deepStrictEqual(output, input);
+      }));
+    }));
+  }
+}
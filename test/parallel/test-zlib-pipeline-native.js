@@ -0,0 +1,48 @@
+'use strict';
+
+// This tests that stream.pipeline() decompresses data natively when it is
+// piped from a socket through a zlib stream into another socket.
+
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+const zlib = require('zlib');
+const { pipeline } = require('stream');
+
+const data = Buffer.alloc(4 * 1024 * 1024);
+for (let i = 0; i < data.length; i++)
+  data[i] = i % 251;
+const compressed = zlib.gzipSync(data);
+
+const upstream = net.createServer(common.mustCall((socket) => {
+  const chunks = [];
+  socket.on('data', (chunk) => chunks.push(chunk));
+  socket.on('end', common.mustCall(() => {
+    assert.deepStrictEqual(Buffer.concat(chunks), data);
+    socket.end();
+    upstream.close();
+  }));
+}));
+
+// The proxy does not read from the socket in JS before the pipe starts.
+const options = { pauseOnConnect: true };
+const proxy = net.createServer(options, common.mustCall((socket) => {
+  const target = net.connect(upstream.address().port);
+  target.on('connect', common.mustCall(() => {
+    const gunzip = zlib.createGunzip();
+    gunzip.on('close', common.mustCall());
+    pipeline(socket, gunzip, target, common.mustCall((err) => {
+      assert.ifError(err);
+      // No data passed through the zlib stream in JS.
+      assert.strictEqual(gunzip.bytesWritten, 0);
+      proxy.close();
+    }));
+  }));
+}));
+
+upstream.listen(0, common.mustCall(() => {
+  proxy.listen(0, common.mustCall(() => {
+    const client = net.connect(proxy.address().port);
+    client.end(compressed);
+  }));
+}));
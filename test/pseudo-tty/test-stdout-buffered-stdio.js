@@ -0,0 +1,31 @@
+// Flags: --buffered-stdio
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+
+// With --buffered-stdio, the writes to a terminal that are made in the same
+// tick are held back until the tick is over and then written together. Writes
+// that are still held back when the process exits are not lost.
+
+assert.strictEqual(process.stdout.writableCorked, 0);
+process.stdout.write('first\n');
+process.stdout.write('second\n');
+assert.strictEqual(process.stdout.writableCorked, 1);
+assert.strictEqual(process.stdout.writableLength, 13);
+
+// Writes to the other stream flush the held back ones first, so that the
+// output stays in order.
+process.stderr.write('to stderr\n');
+assert.strictEqual(process.stdout.writableCorked, 0);
+assert.strictEqual(process.stderr.writableCorked, 1);
+process.stdout.write('after stderr\n');
+assert.strictEqual(process.stderr.writableCorked, 0);
+assert.strictEqual(process.stdout.writableCorked, 1);
+
+process.nextTick(common.mustCall(() => {
+  assert.strictEqual(process.stdout.writableCorked, 0);
+  setImmediate(common.mustCall(() => {
+    process.stdout.write('third\n');
+    process.exit(0);
+  }));
+}));
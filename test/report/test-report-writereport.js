@@ -77,20 +77,48 @@ function validate() {
   fs.unlinkSync(filename);
 }
 
-// Test with an invalid file argument.
-[null, 1, Symbol(), function() {}].forEach((file) => {
+// Test with an invalid file argument. Functions are taken as the callback.
+[null, 1, Symbol()].forEach((file) => {
   assert.throws(() => {
     process.report.writeReport(file);
   }, { code: 'ERR_INVALID_ARG_TYPE' });
 });
 
 // Test with an invalid error argument.
-[null, 1, Symbol(), function() {}, 'foo'].forEach((error) => {
+[null, 1, Symbol(), 'foo'].forEach((error) => {
   assert.throws(() => {
     process.report.writeReport('file', error);
   }, { code: 'ERR_INVALID_ARG_TYPE' });
 });
 
+// Test with an invalid callback argument.
+[null, 1, 'foo', {}].forEach((callback) => {
+  assert.throws(() => {
+    process.report.writeReport('file', new Error(), callback);
+  }, { code: 'ERR_INVALID_CALLBACK' });
+});
+
+{
+  // Test leaving the libuv handles out of the report.
+  const timer = setInterval(() => {}, 1000);
+  assert.strictEqual(process.report.excludeHandles, false);
+  assert.ok(process.report.getReport().libuv.some(
+    (handle) => handle.type === 'timer'));
+  process.report.excludeHandles = true;
+  assert.strictEqual(process.report.excludeHandles, true);
+  const { libuv } = process.report.getReport();
+  assert.strictEqual(libuv.length, 1);
+  assert.strictEqual(libuv[0].type, 'loop');
+  process.report.excludeHandles = false;
+  clearInterval(timer);
+
+  [null, 1, 'true'].forEach((exclude) => {
+    assert.throws(() => {
+      process.report.excludeHandles = exclude;
+    }, { code: 'ERR_INVALID_ARG_TYPE' });
+  });
+}
+
 {
   // Test the special "stdout" filename.
   const args = ['--experimental-report', '-e',
@@ -130,3 +158,46 @@ function validate() {
   const stderr = child.stderr.toString();
   assert(stderr.includes('Failed to open Node.js report file:'));
 }
+
+{
+  // Test writing the report on the threadpool. Each step starts after the
+  // previous report has been written.
+  function writeDefault() {
+    process.report.filename = '';
+    process.report.writeReport(common.mustCall((err, file) => {
+      assert.ifError(err);
+      assert.strictEqual(validate(), path.join(tmpdir.path, file));
+      writeCustom();
+    }));
+  }
+
+  function writeCustom() {
+    const error = new Error('async error');
+    process.report.writeReport('custom-name-4.json', error,
+                               common.mustCall((err, file) => {
+                                 assert.ifError(err);
+                                 checkCustom(file);
+                                 writeMissingDirectory();
+                               }));
+  }
+
+  function checkCustom(file) {
+    assert.strictEqual(file, 'custom-name-4.json');
+    const absolutePath = path.join(tmpdir.path, file);
+    helper.validate(absolutePath);
+    const report = JSON.parse(fs.readFileSync(absolutePath, 'utf8'));
+    assert.strictEqual(report.header.filename, file);
+    assert.strictEqual(report.javascriptStack.message, 'Error: async error');
+    fs.unlinkSync(absolutePath);
+  }
+
+  function writeMissingDirectory() {
+    process.report.directory = path.join(tmpdir.path, 'does', 'not', 'exist');
+    process.report.writeReport(common.mustCall((err) => {
+      assert.strictEqual(err.code, 'ENOENT');
+      assert.strictEqual(err.syscall, 'open');
+    }));
+  }
+
+  writeDefault();
+}
@@ -53,6 +53,8 @@ const { getSystemErrorName } = require('util');
     delete providers.ELDHISTOGRAM;
     delete providers.SIGINTWATCHDOG;
     delete providers.WORKERHEAPSNAPSHOT;
+    if (!process.config.variables.node_report)
+      delete providers.REPORTWRITEREQ;
 
     const objKeys = Object.keys(providers);
     if (objKeys.length > 0)
@@ -106,6 +108,15 @@ function testInitialized(req, ctor_name) {
 }
 
 
+{
+  const JSStream = internalBinding('js_stream').JSStream;
+  const { WebSocketReceiver } = internalBinding('websocket');
+  const receiver =
+    new WebSocketReceiver(new JSStream(), true, 1024, false, false);
+  testInitialized(receiver, 'WebSocketReceiver');
+}
+
+
 {
   // We don't want to expose getAsyncId for promises but we need to construct
   // one so that the corresponding provider type is removed from the
@@ -129,11 +140,41 @@ if (common.hasCrypto) { // eslint-disable-line node-core/crypto-check
     testInitialized(this, 'AsyncWrap');
   }));
 
+  crypto.createHash('sha256', { asyncUpdates: true })
+    .end(Buffer.alloc(1 << 17));
+
+  {
+    const { publicKey, privateKey } = crypto.generateKeyPairSync('ed25519');
+    const data = Buffer.from('data');
+    const signature = crypto.sign(null, data, privateKey);
+    crypto.verifyBatch([{ data, key: publicKey, signature }], null,
+                       common.mustCall(function() {
+                         testInitialized(this, 'AsyncWrap');
+                       }));
+  }
+
+  {
+    const { publicKey, privateKey } = crypto.generateKeyPairSync('x25519');
+    crypto.diffieHellmanBatch([{ privateKey, publicKey }],
+                              common.mustCall(function() {
+                                testInitialized(this, 'AsyncWrap');
+                              }));
+  }
+
+  // Only inputs above a size threshold are hashed on the threadpool.
+  crypto.hash('sha256', Buffer.alloc(1 << 17), common.mustCall(function() {
+    testInitialized(this, 'AsyncWrap');
+  }));
+
   if (typeof internalBinding('crypto').scrypt === 'function') {
     crypto.scrypt('password', 'salt', 8, common.mustCall(function() {
       testInitialized(this, 'AsyncWrap');
     }));
   }
+
+  require('tls').createSecureContext({}, common.mustCall(function() {
+    testInitialized(this, 'AsyncWrap');
+  }));
 }
 
 
@@ -201,6 +242,35 @@ if (common.hasCrypto) { // eslint-disable-line node-core/crypto-check
   testInitialized(new Signal(), 'Signal');
 }
 
+{
+  const { MemoryStatsSampler } = internalBinding('process_methods');
+  const sampler = new MemoryStatsSampler(1000);
+  testInitialized(sampler, 'MemoryStatsSampler');
+  sampler.close();
+}
+
+{
+  const { TimerWheel } = internalBinding('timers');
+  const wheel = new TimerWheel(100);
+  testInitialized(wheel, 'TimerWheel');
+  wheel.close();
+}
+
+{
+  const { SharedChannel, kHeaderSize } = internalBinding('shared_channel');
+  const buffer = new SharedArrayBuffer(kHeaderSize + 2 * 4096);
+  const channel = new SharedChannel(buffer, 0);
+  testInitialized(channel, 'SharedChannel');
+  channel.close();
+}
+
+{
+  const { AtomicsWaiter } = internalBinding('atomics_waiter');
+  const waiter = new AtomicsWaiter(new SharedArrayBuffer(4), 0);
+  testInitialized(waiter, 'AtomicsWaiter');
+  waiter.close();
+}
+
 {
   async function openTest() {
     const fd = await fsPromises.open(__filename, 'r');
@@ -315,3 +385,8 @@ if (process.features.inspector && common.isMainThread) {
   const handle = dirBinding.opendir('./', 'utf8', undefined, {});
   testInitialized(handle, 'DirHandle');
 }
+
+if (process.config.variables.node_report) {
+  const { ReportWriteReq } = internalBinding('report');
+  testInitialized(new ReportWriteReq(), 'ReportWriteReq');
+}
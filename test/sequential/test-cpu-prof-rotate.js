@@ -0,0 +1,126 @@
+'use strict';
+
+// This tests that --cpu-prof-rotate-interval writes numbered profiles in
+// pprof format while the process is running, and the last one before exit.
+
+const common = require('../common');
+
+const fixtures = require('../common/fixtures');
+common.skipIfInspectorDisabled();
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const zlib = require('zlib');
+const { spawnSync } = require('child_process');
+
+const tmpdir = require('../common/tmpdir');
+
+function readVarint(buffer, state) {
+  let value = 0;
+  let shift = 0;
+  let byte;
+  do {
+    byte = buffer[state.offset++];
+    value += (byte & 0x7f) * 2 ** shift;
+    shift += 7;
+  } while (byte & 0x80);
+  return value;
+}
+
+// Returns the fields of a protocol buffer message, as [field, value] pairs,
+// where length-delimited values are Buffers.
+function decodeMessage(buffer) {
+  const fields = [];
+  const state = { offset: 0 };
+  while (state.offset < buffer.length) {
+    const key = readVarint(buffer, state);
+    if ((key & 7) === 0) {
+      fields.push([key >>> 3, readVarint(buffer, state)]);
+    } else {
+      assert.strictEqual(key & 7, 2);
+      const length = readVarint(buffer, state);
+      fields.push([key >>> 3,
+                   buffer.slice(state.offset, state.offset + length)]);
+      state.offset += length;
+    }
+  }
+  assert.strictEqual(state.offset, buffer.length);
+  return fields;
+}
+
+function decodePacked(buffer) {
+  const values = [];
+  const state = { offset: 0 };
+  while (state.offset < buffer.length)
+    values.push(readVarint(buffer, state));
+  return values;
+}
+
+function verifyProfile(file) {
+  const fields = decodeMessage(zlib.gunzipSync(fs.readFileSync(file)));
+  const strings = fields.filter(([field]) => field === 6)
+                        .map(([, value]) => value.toString());
+  assert.strictEqual(strings[0], '');
+  for (const str of ['samples', 'count', 'cpu', 'nanoseconds'])
+    assert.ok(strings.includes(str), str);
+  // Every sample refers to locations that exist.
+  const locations = new Set(
+    fields.filter(([field]) => field === 4)
+          .map(([, value]) => decodeMessage(value)[0][1]));
+  for (const [field, value] of fields) {
+    if (field !== 2) continue;
+    const sample = decodeMessage(value);
+    assert.strictEqual(sample[0][0], 1);
+    for (const id of decodePacked(sample[0][1]))
+      assert.ok(locations.has(id));
+    assert.strictEqual(sample[1][0], 2);
+    const [count, nanoseconds] = decodePacked(sample[1][1]);
+    assert.strictEqual(nanoseconds, count * 1e6);
+  }
+  // The period is the sampling interval in nanoseconds.
+  assert.deepStrictEqual(fields.find(([field]) => field === 12), [12, 1e6]);
+}
+
+{
+  tmpdir.refresh();
+  const output = spawnSync(process.execPath, [
+    '--cpu-prof',
+    '--cpu-prof-rotate-interval', '20',
+    fixtures.path('workload', 'allocation.js'),
+  ], {
+    cwd: tmpdir.path,
+    env: {
+      ...process.env,
+      TEST_ALLOCATION: 300,
+      NODE_DEBUG_NATIVE: 'INSPECTOR_PROFILER'
+    }
+  });
+  if (output.status !== 0) {
+    console.log(output.stderr.toString());
+  }
+  assert.strictEqual(output.status, 0);
+
+  const files = fs.readdirSync(tmpdir.path);
+  assert.ok(files.length >= 2, files);
+  for (const file of files) {
+    assert.match(file, /^CPU\..*\.\d+\.pb\.gz$/);
+    verifyProfile(path.join(tmpdir.path, file));
+  }
+}
+
+{
+  tmpdir.refresh();
+  const output = spawnSync(process.execPath, [
+    '--cpu-prof-rotate-interval', '20',
+    fixtures.path('workload', 'allocation.js'),
+  ], {
+    cwd: tmpdir.path
+  });
+  const stderr = output.stderr.toString().trim();
+  assert.strictEqual(output.status, 9);
+  assert.strictEqual(
+    stderr,
+    `${process.execPath}: --cpu-prof-rotate-interval must be used with ` +
+    '--cpu-prof');
+}
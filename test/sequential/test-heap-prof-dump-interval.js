@@ -0,0 +1,90 @@
+'use strict';
+
+// This tests that --heap-prof-dump-interval writes numbered heap profiles
+// while the process is running, and the final one before exit.
+
+const common = require('../common');
+
+const fixtures = require('../common/fixtures');
+common.skipIfInspectorDisabled();
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { spawnSync } = require('child_process');
+
+const tmpdir = require('../common/tmpdir');
+
+function findFrame(node, func) {
+  if (node.callFrame.functionName === func)
+    return node;
+  for (const child of node.children) {
+    const frame = findFrame(child, func);
+    if (frame)
+      return frame;
+  }
+  return undefined;
+}
+
+function verifyProfile(file) {
+  const profile = JSON.parse(fs.readFileSync(file, 'utf8'));
+  assert.strictEqual(typeof profile.head.callFrame.scriptId, 'string');
+  assert.ok(Array.isArray(profile.samples));
+  for (const sample of profile.samples) {
+    assert.strictEqual(typeof sample.size, 'number');
+    assert.strictEqual(typeof sample.nodeId, 'number');
+  }
+  return profile;
+}
+
+const env = {
+  ...process.env,
+  TEST_ALLOCATION: 500,
+  NODE_DEBUG_NATIVE: 'INSPECTOR_PROFILER'
+};
+
+{
+  tmpdir.refresh();
+  const output = spawnSync(process.execPath, [
+    '--heap-prof',
+    '--heap-prof-interval', '128',
+    '--heap-prof-dump-interval', '20',
+    '--heap-prof-name', 'test.heapprofile',
+    fixtures.path('workload', 'allocation.js'),
+  ], {
+    cwd: tmpdir.path,
+    env
+  });
+  if (output.status !== 0) {
+    console.log(output.stderr.toString());
+  }
+  assert.strictEqual(output.status, 0);
+
+  const files = fs.readdirSync(tmpdir.path);
+  assert.ok(files.includes('test.heapprofile'));
+  assert.ok(files.includes('test.1.heapprofile'), files);
+  for (const file of files) {
+    assert.match(file, /^test(\.\d+)?\.heapprofile$/);
+    verifyProfile(path.join(tmpdir.path, file));
+  }
+
+  const profile = verifyProfile(path.join(tmpdir.path, 'test.heapprofile'));
+  assert.notStrictEqual(findFrame(profile.head, 'runAllocation'), undefined);
+}
+
+{
+  tmpdir.refresh();
+  const output = spawnSync(process.execPath, [
+    '--heap-prof-dump-interval', '20',
+    fixtures.path('workload', 'allocation.js'),
+  ], {
+    cwd: tmpdir.path,
+    env
+  });
+  const stderr = output.stderr.toString().trim();
+  assert.strictEqual(output.status, 9);
+  assert.strictEqual(
+    stderr,
+    `${process.execPath}: --heap-prof-dump-interval must be used with ` +
+    '--heap-prof');
+}
@@ -34,6 +34,26 @@ process.chdir(tmpdir.path);
   });
 });
 
+{
+  writeHeapSnapshot('async.heapdump', common.mustCall((err, filename) => {
+    assert.ifError(err);
+    assert.strictEqual(filename, 'async.heapdump');
+    JSON.parse(fs.readFileSync(filename, 'utf8'));
+  }));
+  writeHeapSnapshot(common.mustCall((err, filename) => {
+    assert.ifError(err);
+    assert.match(filename, /^Heap\..+\.heapsnapshot$/);
+    JSON.parse(fs.readFileSync(filename, 'utf8'));
+  }));
+  writeHeapSnapshot('missing/async.heapdump', common.mustCall((err) => {
+    assert.strictEqual(err.code, 'ENOENT');
+    assert.strictEqual(err.syscall, 'open');
+  }));
+  assert.throws(() => writeHeapSnapshot('async.heapdump', {}), {
+    code: 'ERR_INVALID_CALLBACK'
+  });
+}
+
 {
   let data = '';
   const snapshot = getHeapSnapshot();
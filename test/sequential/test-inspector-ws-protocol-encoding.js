@@ -0,0 +1,56 @@
+'use strict';
+const common = require('../common');
+common.skipIfInspectorDisabled();
+const assert = require('assert');
+const { NodeInstance } = require('../common/inspector-helper.js');
+
+// Commands received over the WebSocket are passed to V8 CBOR encoded, and
+// the responses are converted back to JSON on the inspector IO thread. Check
+// that strings, numbers, large responses and the Node-specific domains all
+// survive the round trip.
+
+async function runTests() {
+  const child = new NodeInstance(['--inspect-brk=0'],
+                                 `let c = 0;
+                                  for (let i = 0; i < 1e6; i++)
+                                    c += Math.sqrt(i);
+                                  console.log(c);`);
+  const session = await child.connectInspectorSession();
+
+  const text = 'héllo ☃ 😀 "quoted"\n';
+  let { result } = await session.send({
+    method: 'Runtime.evaluate',
+    params: { expression: JSON.stringify(text), returnByValue: true }
+  });
+  assert.strictEqual(result.value, text);
+
+  ({ result } = await session.send({
+    method: 'Runtime.evaluate',
+    params: { expression: '[0.1 + 0.2, -1e300, 2 ** 53, 1 / 3]',
+              returnByValue: true }
+  }));
+  assert.deepStrictEqual(result.value, [0.1 + 0.2, -1e300, 2 ** 53, 1 / 3]);
+
+  const { categories } =
+      await session.send({ method: 'NodeTracing.getCategories' });
+  assert.ok(categories.includes('node'));
+
+  session.send([
+    { method: 'Profiler.enable' },
+    { method: 'Profiler.start' },
+    { method: 'Runtime.runIfWaitingForDebugger' }]);
+  while (await child.nextStderrString() !==
+         'Waiting for the debugger to disconnect...');
+
+  const { profile } = await session.send({ method: 'Profiler.stop' });
+  assert.ok(profile.nodes.length > 0);
+  assert.ok(profile.endTime >= profile.startTime);
+
+  await assert.rejects(session.send({ method: 'Profiler.nonExistent' }),
+                       { code: -32601 });
+
+  session.disconnect();
+  assert.strictEqual((await child.expectShutdown()).exitCode, 0);
+}
+
+runTests();
@@ -0,0 +1,189 @@
+'use strict';
+
+// Converts a trace file that was written with `--trace-event-format=binary`
+// into the JSON trace format that `--trace-event-format=json` produces, and
+// that tools such as chrome://tracing understand. The binary format is
+// described in src/tracing/binary_trace_writer.h.
+//
+// Usage: node binary-trace-to-json.js <binary trace file> [<json file>]
+
+const fs = require('fs');
+
+const kMagic = 'NODETRC1';
+const kString = 1;
+const kEvent = 2;
+
+const kFlagHasId = 1 << 1;
+const kFlagFlowIn = 1 << 8;
+const kFlagFlowOut = 1 << 9;
+
+const kTypeBool = 1;
+const kTypeUint = 2;
+const kTypeInt = 3;
+const kTypeDouble = 4;
+const kTypePointer = 5;
+const kTypeString = 6;
+const kTypeCopyString = 7;
+const kTypeConvertable = 8;
+
+class Reader {
+  constructor(buffer, offset, end) {
+    this.buffer = buffer;
+    this.offset = offset;
+    this.end = end;
+  }
+
+  byte() {
+    if (this.offset >= this.end)
+      throw new Error('Unexpected end of trace record');
+    return this.buffer[this.offset++];
+  }
+
+  // Returns a BigInt, since ids and pointers can use all 64 bits.
+  varint() {
+    let value = 0n;
+    let shift = 0n;
+    let byte;
+    do {
+      byte = this.byte();
+      value |= BigInt(byte & 0x7f) << shift;
+      shift += 7n;
+    } while (byte & 0x80);
+    return value;
+  }
+
+  number() {
+    return Number(this.varint());
+  }
+
+  zigzag() {
+    const value = this.varint();
+    return Number((value >> 1n) ^ -(value & 1n));
+  }
+
+  bytes(length = this.number()) {
+    if (this.offset + length > this.end)
+      throw new Error('Unexpected end of trace record');
+    const start = this.offset;
+    this.offset += length;
+    return this.buffer.toString('utf8', start, this.offset);
+  }
+}
+
+function hex(value) {
+  return `0x${value.toString(16)}`;
+}
+
+function readArgValue(reader, type) {
+  switch (type) {
+    case kTypeBool:
+      return reader.byte() !== 0;
+    case kTypeUint:
+      return reader.number();
+    case kTypeInt:
+      return reader.zigzag();
+    case kTypeDouble: {
+      const value = reader.buffer.readDoubleLE(reader.offset);
+      reader.offset += 8;
+      return value;
+    }
+    case kTypePointer:
+      return hex(reader.varint());
+    case kTypeString:
+    case kTypeCopyString:
+      return reader.bytes();
+    case kTypeConvertable:
+      return JSON.parse(reader.bytes());
+    default:
+      throw new Error(`Unknown argument type ${type}`);
+  }
+}
+
+function readEvent(reader, strings) {
+  const string = (id) => {
+    if (!strings.has(id))
+      throw new Error(`Unknown string id ${id}`);
+    return strings.get(id);
+  };
+
+  const phase = String.fromCharCode(reader.byte());
+  const cat = string(reader.number());
+  const name = string(reader.number());
+  const event = {
+    pid: reader.zigzag(),
+    tid: reader.zigzag(),
+    ts: reader.zigzag(),
+    tts: reader.zigzag(),
+    ph: phase,
+    cat,
+    name,
+    dur: reader.zigzag(),
+    tdur: reader.zigzag(),
+  };
+  const flags = reader.number();
+  if (flags & (kFlagFlowIn | kFlagFlowOut)) {
+    event.bind_id = hex(reader.varint());
+    if (flags & kFlagFlowIn)
+      event.flow_in = true;
+    if (flags & kFlagFlowOut)
+      event.flow_out = true;
+  }
+  if (flags & kFlagHasId) {
+    const scope = reader.number();
+    if (scope !== 0)
+      event.scope = string(scope);
+    event.id = hex(reader.varint());
+  }
+  event.args = {};
+  const numArgs = reader.number();
+  for (let i = 0; i < numArgs; i++) {
+    const argName = string(reader.number());
+    event.args[argName] = readArgValue(reader, reader.byte());
+  }
+  return event;
+}
+
+function convert(buffer) {
+  if (buffer.toString('latin1', 0, kMagic.length) !== kMagic)
+    throw new Error('Not a binary trace file');
+
+  const strings = new Map();
+  const traceEvents = [];
+  const reader = new Reader(buffer, kMagic.length, buffer.length);
+  while (reader.offset < buffer.length) {
+    const size = reader.number();
+    const record = new Reader(buffer, reader.offset, reader.offset + size);
+    reader.offset += size;
+    switch (record.byte()) {
+      case kString: {
+        const id = record.number();
+        strings.set(id, record.bytes(record.end - record.offset));
+        break;
+      }
+      case kEvent:
+        traceEvents.push(readEvent(record, strings));
+        break;
+      default:
+        // Skip record types that this version does not know about.
+        break;
+    }
+  }
+  return { traceEvents };
+}
+
+module.exports = { convert };
+
+if (require.main === module) {
+  const args = process.argv.slice(2);
+  if (args.length < 1 || args.length > 2) {
+    console.error(
+      'Usage: node binary-trace-to-json.js <binary trace file> [<json file>]'
+    );
+    process.exit(1);
+  }
+  const json = JSON.stringify(convert(fs.readFileSync(args[0])));
+  if (args.length === 2)
+    fs.writeFileSync(args[1], json);
+  else
+    console.log(json);
+}
@@ -46,6 +46,7 @@ const customTypesMap = {
   'brotli options': 'zlib.html#zlib_class_brotlioptions',
 
   'Buffer': 'buffer.html#buffer_class_buffer',
+  'buffer.Rope': 'buffer.html#buffer_class_buffer_rope',
 
   'ChildProcess': 'child_process.html#child_process_class_childprocess',
 
@@ -59,6 +60,7 @@ const customTypesMap = {
   'Hash': 'crypto.html#crypto_class_hash',
   'Hmac': 'crypto.html#crypto_class_hmac',
   'KeyObject': 'crypto.html#crypto_class_keyobject',
+  'KeyPairPool': 'crypto.html#crypto_class_keypairpool',
   'Sign': 'crypto.html#crypto_class_sign',
   'Verify': 'crypto.html#crypto_class_verify',
   'crypto.constants': 'crypto.html#crypto_crypto_constants_1',
@@ -123,6 +125,7 @@ const customTypesMap = {
     'perf_hooks.html#perf_hooks_class_performanceobserver',
   'PerformanceObserverEntryList':
     'perf_hooks.html#perf_hooks_class_performanceobserverentrylist',
+  'ThreadpoolMonitor': 'perf_hooks.html#perf_hooks_class_threadpoolmonitor',
 
   'readline.Interface': 'readline.html#readline_class_interface',
 
@@ -0,0 +1,110 @@
+'use strict';
+
+// Packs the files in a directory into a module archive that can be loaded
+// with `node --module-archive`. Archives are mounted at the directory that
+// contains them, so the archive is usually written into <directory>, and
+// deployed instead of the files in it.
+//
+// Usage: node pack-module-archive.js [--code-cache] <directory> <archive>
+//
+// With --code-cache, the V8 code cache of every CommonJS module is stored in
+// the archive as well. It is only used by the same version of Node.js.
+
+const fs = require('fs');
+const path = require('path');
+const vm = require('vm');
+
+const kMagic = Buffer.from('NODEMAR1', 'latin1');
+const kHeaderSize = kMagic.length + 8;
+const kIndexEntrySize = 24;
+const kMaxArchiveSize = 2 ** 32 - 1;
+
+// Parameters of the function that the CommonJS loader wraps modules in.
+const kWrapperParams = [
+  'exports', 'require', 'module', '__filename', '__dirname',
+];
+
+function collectFiles(dir, prefix, exclude, files) {
+  for (const dirent of fs.readdirSync(dir, { withFileTypes: true })) {
+    const file = path.join(dir, dirent.name);
+    const entryPath = prefix + dirent.name;
+    if (file === exclude)
+      continue;
+    if (dirent.isDirectory())
+      collectFiles(file, `${entryPath}/`, exclude, files);
+    else if (dirent.isFile())
+      files.push({ file, path: Buffer.from(entryPath) });
+  }
+  return files;
+}
+
+function createCodeCache(file, data) {
+  try {
+    const fn = vm.compileFunction(data.toString(), kWrapperParams, {
+      filename: file,
+      produceCachedData: true
+    });
+    return fn.cachedData;
+  } catch {
+    // ES modules and files that are not JavaScript are stored without a
+    // code cache.
+    return undefined;
+  }
+}
+
+function pack(dir, archive, { codeCache = false } = {}) {
+  dir = path.resolve(dir);
+  archive = path.resolve(archive);
+  const entries = collectFiles(dir, '', archive, []);
+  entries.sort((a, b) => Buffer.compare(a.path, b.path));
+
+  const chunks = [];
+  const index = Buffer.alloc(kIndexEntrySize * entries.length);
+  let offset = kHeaderSize + index.length;
+  function append(buffer) {
+    chunks.push(buffer);
+    const start = offset;
+    offset += buffer.length;
+    if (offset > kMaxArchiveSize)
+      throw new Error('Module archives must be smaller than 4 GB');
+    return start;
+  }
+
+  entries.forEach((entry, i) => {
+    const data = fs.readFileSync(entry.file);
+    const ext = path.extname(entry.file);
+    const cachedData = codeCache && (ext === '.js' || ext === '.cjs') ?
+      createCodeCache(entry.file, data) : undefined;
+    const fields = [
+      append(entry.path), entry.path.length,
+      append(data), data.length,
+      cachedData ? append(cachedData) : 0, cachedData ? cachedData.length : 0,
+    ];
+    fields.forEach((value, j) => {
+      index.writeUInt32LE(value, i * kIndexEntrySize + j * 4);
+    });
+  });
+
+  const header = Buffer.alloc(kHeaderSize);
+  kMagic.copy(header);
+  header.writeUInt32LE(entries.length, kMagic.length);
+  fs.writeFileSync(archive, Buffer.concat([header, index, ...chunks]));
+  return entries.length;
+}
+
+module.exports = { pack };
+
+if (require.main === module) {
+  const args = process.argv.slice(2);
+  const codeCache = args[0] === '--code-cache';
+  if (codeCache)
+    args.shift();
+  if (args.length !== 2) {
+    console.error(
+      'Usage: node pack-module-archive.js [--code-cache] <directory> <archive>'
+    );
+    process.exit(1);
+  }
+  const count = pack(args[0], args[1], { codeCache });
+  console.log(`Packed ${count} files into ${args[1]}`);
+}